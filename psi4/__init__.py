@@ -68,6 +68,9 @@ if "PSI_SCRATCH" in os.environ.keys():
         raise Exception("Passed in scratch is not a directory (%s)." % envvar_scratch)
     core.IOManager.shared_object().set_default_path(envvar_scratch)
 
+if "PSI_EVENT_FILE" in os.environ.keys():
+    core.open_event_file(os.path.expanduser(os.environ["PSI_EVENT_FILE"]))
+
 core.set_datadir(data_dir)
 del psi4_module_loc, pymod, pymod_dir_step, data_dir
 
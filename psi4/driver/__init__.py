@@ -34,6 +34,8 @@ from psi4.driver.inputparser import process_input
 from psi4.driver.p4util.util import *
 from psi4.driver.p4util.fcidump import *
 from psi4.driver.p4util.text import *
+from psi4.driver.p4util.benchmarks import *
+from psi4.driver.p4util.checkpoint import *
 from psi4.driver.qmmm import QMMM
 from psi4.driver.plugin import *
 
@@ -43,10 +45,12 @@ from psi4.driver import diatomic
 from psi4.driver import wrapper_database
 from psi4.driver import wrapper_autofrag
 from psi4.driver import json_wrapper
+from psi4.driver import json_server
 from psi4.driver import frac
 
 from psi4.driver.driver import *
 
 # Single functions
 from psi4.driver.driver_cbs import cbs
+from psi4.driver.procrouting.scf_proc.batch import batch_scf
 from psi4.driver.p4util.python_helpers import set_options, set_module_options, pcm_helper, basis_helper
@@ -49,6 +49,7 @@ from psi4.driver import driver_findif
 from psi4.driver import p4util
 from psi4.driver import qcdb
 from psi4.driver.procrouting import *
+from psi4.driver.procrouting.scf_proc import guess_extrapolation
 from psi4.driver.p4util.exceptions import *
 # never import wrappers or aliases into this file
 
@@ -628,8 +629,13 @@ def gradient(name, **kwargs):
         opt_linkage = kwargs.get('linkage', None)
         if opt_linkage is None:
             raise ValidationError("""Optimize execution mode 'reap' requires a linkage option.""")
+    elif opt_mode == 'parallel':
+        if dertype == 1:
+            raise ValidationError("""Optimize execution mode 'parallel' not valid for analytic gradient calculation.""")
     else:
         raise ValidationError("""Optimize execution mode '%s' not valid.""" % (opt_mode))
+    findif_workers = kwargs.get('nworkers', 1)
+    findif_command = kwargs.get('worker_command', None)
 
     # Does dertype indicate an analytic procedure both exists and is wanted?
     if dertype == 1:
@@ -660,7 +666,20 @@ def gradient(name, **kwargs):
 
         # This version is pretty dependent on the reference geometry being last (as it is now)
         print(""" %d displacements needed ...""" % (ndisp), end='')
-        energies = []
+        energies = [None] * ndisp
+
+        # S/R: Linkage of the sown files; parallel mode uses one that survives a restart of the job
+        findif_label = 'gradient %s' % (lowername)
+        if opt_mode == 'parallel':
+            opt_linkage = driver_findif.displacement_linkage(findif_label + p4util.format_options_for_input(),
+                                                      displacements)
+        sow_linkage = opt_linkage if opt_mode == 'parallel' else os.getpid()
+
+        # Completed displacements of a single job, so it can be restarted
+        checkpoint = driver_findif.FindifCheckpoint(core.get_writer_file_prefix(molecule.name()) + '.findif.json',
+                                                    findif_label, (opt_mode == 'continuous'
+                                                                   and core.get_option('FINDIF', 'FD_CHECKPOINT')))
+        ref_wfn = None
 
         # S/R: Write instructions for sow/reap procedure to output file and reap input file
         if opt_mode == 'sow':
@@ -700,51 +719,76 @@ def gradient(name, **kwargs):
                 fmaster.write(("""retE, retwfn = optimize('%s', **kwargs)\n\n""" % (lowername)).encode('utf-8'))
                 fmaster.write(instructionsM.encode('utf-8'))
 
-        for n, displacement in enumerate(displacements):
-            rfile = 'OPT-%s-%s' % (opt_iter, n + 1)
-
-            # Build string of title banner
-            banners = ''
-            banners += """core.print_out('\\n')\n"""
-            banners += """p4util.banner(' Gradient %d Computation: Displacement %d ')\n""" % (opt_iter, n + 1)
-            banners += """core.print_out('\\n')\n\n"""
-
-            if opt_mode == 'continuous':
-
-                # print progress to file and screen
-                core.print_out('\n')
-                p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
-                print(""" %d""" % (n + 1), end=('\n' if (n + 1 == ndisp) else ''))
-                sys.stdout.flush()
-
-                # Load in displacement into the active molecule
-                moleculeclone.set_geometry(displacement)
-
-                # Perform the energy calculation
-                E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
-                energies.append(core.get_variable('CURRENT ENERGY'))
-
-            # S/R: Write each displaced geometry to an input file
-            elif opt_mode == 'sow':
-                moleculeclone.set_geometry(displacement)
-
-                # S/R: Prepare molecule, options, and kwargs
-                with open('%s.in' % (rfile), 'wb') as freagent:
-                    freagent.write('# This is a psi4 input file auto-generated from the gradient() wrapper.\n\n'.encode('utf-8'))
-                    freagent.write(p4util.format_molecule_for_input(moleculeclone).encode('utf-8'))
-                    freagent.write(p4util.format_options_for_input().encode('utf-8'))
-                    p4util.format_kwargs_for_input(freagent, **kwargs)
-
-                    # S/R: Prepare function call and energy save
-                    freagent.write(("""electronic_energy = energy('%s', **kwargs)\n\n""" % (lowername)).encode('utf-8'))
-                    freagent.write(("""core.print_out('\\nGRADIENT RESULT: computation %d for item %d """ % (os.getpid(), n + 1)).encode('utf-8'))
-                    freagent.write("""yields electronic energy %20.12f\\n' % (electronic_energy))\n\n""".encode('utf-8'))
-
-            # S/R: Read energy from each displaced geometry output file and save in energies array
-            elif opt_mode == 'reap':
-                exec(banners)
-                core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
-                energies.append(p4util.extract_sowreap_from_output(rfile, 'GRADIENT', n, opt_linkage, True))
+        # Parallel mode sows every displacement, runs the inputs through a pool of workers and reaps them
+        passes = ['sow', 'reap'] if opt_mode == 'parallel' else [opt_mode]
+        for pass_mode in passes:
+            if pass_mode == 'reap' and opt_mode == 'parallel':
+                driver_findif.run_sown_displacements('OPT-%s' % (opt_iter), ndisp, 'GRADIENT', opt_linkage,
+                                                     findif_workers, findif_command)
+
+            # The reference geometry goes first in a single job so its orbitals can guess the rest
+            order = driver_findif.displacement_order(ndisp) if pass_mode == 'continuous' else range(ndisp)
+            for count, n in enumerate(order):
+                displacement = displacements[n]
+                rfile = 'OPT-%s-%s' % (opt_iter, n + 1)
+
+                # Build string of title banner
+                banners = ''
+                banners += """core.print_out('\\n')\n"""
+                banners += """p4util.banner(' Gradient %d Computation: Displacement %d ')\n""" % (opt_iter, n + 1)
+                banners += """core.print_out('\\n')\n\n"""
+
+                if pass_mode == 'continuous':
+
+                    # print progress to file and screen
+                    core.print_out('\n')
+                    p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
+                    print(""" %d""" % (count + 1), end=('\n' if (count + 1 == ndisp) else ''))
+                    sys.stdout.flush()
+
+                    # Load in displacement into the active molecule
+                    moleculeclone.set_geometry(displacement)
+
+                    stored = checkpoint.lookup(n, displacement)
+                    if stored is not None:
+                        core.print_out("  Energy of displacement %d taken from the checkpoint.\n" % (n + 1))
+                        energies[n] = stored['energy']
+                        continue
+
+                    # Perform the energy calculation
+                    E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
+                    energies[n] = core.get_variable('CURRENT ENERGY')
+                    checkpoint.store(n, displacement, energies[n])
+
+                    # Orbitals of the undisplaced geometry seed the SCF at the displacements
+                    if n == ndisp - 1:
+                        ref_wfn = wfn
+                        if core.get_option('FINDIF', 'FD_REFERENCE_GUESS'):
+                            guess_extrapolation.set_reference(wfn)
+
+                # S/R: Write each displaced geometry to an input file
+                elif pass_mode == 'sow':
+                    moleculeclone.set_geometry(displacement)
+
+                    # S/R: Prepare molecule, options, and kwargs
+                    with open('%s.in' % (rfile), 'wb') as freagent:
+                        freagent.write('# This is a psi4 input file auto-generated from the gradient() wrapper.\n\n'.encode('utf-8'))
+                        freagent.write(p4util.format_molecule_for_input(moleculeclone).encode('utf-8'))
+                        freagent.write(p4util.format_options_for_input().encode('utf-8'))
+                        p4util.format_kwargs_for_input(freagent, **kwargs)
+
+                        # S/R: Prepare function call and energy save
+                        freagent.write(("""electronic_energy = energy('%s', **kwargs)\n\n""" % (lowername)).encode('utf-8'))
+                        freagent.write(("""core.print_out('\\nGRADIENT RESULT: computation %d for item %d """ % (sow_linkage, n + 1)).encode('utf-8'))
+                        freagent.write("""yields electronic energy %20.12f\\n' % (electronic_energy))\n\n""".encode('utf-8'))
+
+                # S/R: Read energy from each displaced geometry output file and save in energies array
+                elif pass_mode == 'reap':
+                    exec(banners)
+                    core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
+                    energies[n] = p4util.extract_sowreap_from_output(rfile, 'GRADIENT', n, opt_linkage, True)
+
+        guess_extrapolation.clear_reference()
 
         # S/R: Quit sow after writing files. Initialize skeleton wfn to receive grad for reap
         if opt_mode == 'sow':
@@ -753,9 +797,12 @@ def gradient(name, **kwargs):
                 return (None, None)  # any point to building a dummy wfn here?
             else:
                 return None
-        elif opt_mode == 'reap':
-            core.set_variable('CURRENT ENERGY', energies[-1])
+        elif opt_mode in ['reap', 'parallel'] or ref_wfn is None:
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
+        else:
+            wfn = ref_wfn
+        # The reference is computed first in a single job, so the last energy computed is a displacement
+        core.set_variable('CURRENT ENERGY', energies[-1])
 
         # Compute the gradient; last item in 'energies' is undisplaced
         core.set_local_option('FINDIF', 'GRADIENT_WRITE', True)
@@ -763,6 +810,7 @@ def gradient(name, **kwargs):
         grad_psi_matrix = core.Matrix.from_array(G)
         grad_psi_matrix.print_out()
         wfn.set_gradient(grad_psi_matrix)
+        checkpoint.remove()
 
 
     optstash.restore()
@@ -923,7 +971,7 @@ def optimize(name, **kwargs):
         use keyword ``opt_func`` instead of ``func``.
 
     :type mode: string
-    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'``
+    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'`` || ``'parallel'``
 
         For a finite difference of energies optimization, indicates whether
         the calculations required to complete the
@@ -932,6 +980,8 @@ def optimize(name, **kwargs):
         (``'sow'``/``'reap'``). For the latter, run an initial job with
         ``'sow'`` and follow instructions in its output file. For maximum
         flexibility, ``return_wfn`` is always on in ``'reap'`` mode.
+        ``'parallel'`` sows, runs the displacements with ``nworkers`` concurrent
+        jobs and reaps them within this job; see :ref:`sec:sowreap`.
 
     :type dertype: :ref:`dertype <op_py_dertype>`
     :param dertype: ``'gradient'`` || ``'energy'``
@@ -1058,14 +1108,22 @@ def optimize(name, **kwargs):
     full_hess_every = core.get_option('OPTKING', 'FULL_HESS_EVERY')
     steps_since_last_hessian = 0
 
-    if custom_gradient and core.has_option_changed('OPTKING', 'FULL_HESS_EVERY'):
+    # adaptive mode: initial Hessian, then recompute only when the quadratic model fails
+    full_hess_adaptive = core.get_option('OPTKING', 'FULL_HESS_ADAPTIVE')
+    if full_hess_adaptive and full_hess_every == -1:
+        full_hess_every = 0
+    hess_degrade_tolerance = core.get_option('OPTKING', 'FULL_HESS_DEGRADE_TOLERANCE')
+    predicted_step_energy = 0.0
+    previous_energy = None
+
+    if custom_gradient and (core.has_option_changed('OPTKING', 'FULL_HESS_EVERY') or full_hess_adaptive):
         raise ValidationError("Optimize: Does not support custom Hessian's yet.")
     else:
         hessian_with_method = kwargs.get('hessian_with', lowername)
 
     # are we in sow/reap mode?
     opt_mode = kwargs.get('mode', 'continuous').lower()
-    if opt_mode not in ['continuous', 'sow', 'reap']:
+    if opt_mode not in ['continuous', 'sow', 'reap', 'parallel']:
         raise ValidationError("""Optimize execution mode '%s' not valid.""" % (opt_mode))
 
     optstash = p4util.OptionsState(
@@ -1090,6 +1148,7 @@ def optimize(name, **kwargs):
     moleculeclone = molecule.clone()
 
     initial_sym = moleculeclone.schoenflies_symbol()
+    guess_extrapolation.start()
     while n <= core.get_option('OPTKING', 'GEOM_MAXITER'):
         current_sym = moleculeclone.schoenflies_symbol()
         if initial_sym != current_sym:
@@ -1112,6 +1171,7 @@ def optimize(name, **kwargs):
         # Compute the gradient
         G, wfn = gradient(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
         thisenergy = core.get_variable('CURRENT ENERGY')
+        guess_extrapolation.record(wfn)
 
         # above, used to be getting energy as last of energy list from gradient()
         # thisenergy below should ultimately be testing on wfn.energy()
@@ -1146,8 +1206,19 @@ def optimize(name, **kwargs):
         if full_hess_every > -1:
             core.set_global_option('HESSIAN_WRITE', True)
 
+        # judge the Hessian by how well its quadratic model predicted the last step;
+        #   tiny projected changes near convergence are too noisy to judge by
+        hessian_degraded = False
+        if full_hess_adaptive and (previous_energy is not None) and (abs(predicted_step_energy) > 1.0e-7):
+            energy_ratio = (thisenergy - previous_energy) / predicted_step_energy
+            if abs(energy_ratio - 1.0) > hess_degrade_tolerance:
+                hessian_degraded = True
+                core.print_out("""\n  Optimizer: Energy ratio %.3f of last step signals a degraded Hessian; """
+                               """recomputing it with %s.\n""" % (energy_ratio, hessian_with_method))
+
         # compute Hessian as requested; frequency wipes out gradient so stash it
-        if ((full_hess_every > -1) and (n == 1)) or (steps_since_last_hessian + 1 == full_hess_every):
+        if ((full_hess_every > -1) and (n == 1)) or (steps_since_last_hessian + 1 == full_hess_every) or \
+           hessian_degraded:
             G = core.get_gradient()  # TODO
             core.IOManager.shared_object().set_specific_retention(1, True)
             core.IOManager.shared_object().set_specific_path(1, './')
@@ -1164,7 +1235,10 @@ def optimize(name, **kwargs):
 
         # Take step. communicate to/from/within optking through legacy_molecule
         core.set_legacy_molecule(moleculeclone)
+        core.set_variable('OPTKING PREDICTED ENERGY CHANGE', 0.0)
         optking_rval = core.optking()
+        predicted_step_energy = core.get_variable('OPTKING PREDICTED ENERGY CHANGE')
+        previous_energy = thisenergy
         moleculeclone = core.get_legacy_molecule()
         moleculeclone.update_geometry()
         if optking_rval == core.PsiReturnType.EndLoop:
@@ -1184,6 +1258,7 @@ def optimize(name, **kwargs):
             for postcallback in hooks['optimize']['post']:
                 postcallback(lowername, wfn=wfn, **kwargs)
             core.clean()
+            guess_extrapolation.stop()
 
             # S/R: Clean up opt input file
             if opt_mode == 'reap':
@@ -1218,6 +1293,7 @@ def optimize(name, **kwargs):
                 core.opt_clean()
             molecule.set_geometry(moleculeclone.geometry())
             core.clean()
+            guess_extrapolation.stop()
             optstash.restore()
             raise OptimizationConvergenceError("""geometry optimization""", n - 1, wfn)
             return thisenergy
@@ -1236,6 +1312,7 @@ def optimize(name, **kwargs):
         if core.get_option('OPTKING', 'KEEP_INTCOS') == False:
             core.opt_clean()
 
+    guess_extrapolation.stop()
     optstash.restore()
     raise OptimizationConvergenceError("""geometry optimization""", n - 1, wfn)
 
@@ -1324,8 +1401,13 @@ def hessian(name, **kwargs):
         freq_linkage = kwargs.get('linkage', None)
         if freq_linkage is None:
             raise ValidationError("""Frequency execution mode 'reap' requires a linkage option.""")
+    elif freq_mode == 'parallel':
+        if dertype == 2:
+            raise ValidationError("""Frequency execution mode 'parallel' not valid for analytic Hessian calculation.""")
     else:
         raise ValidationError("""Frequency execution mode '%s' not valid.""" % (freq_mode))
+    findif_workers = kwargs.pop('nworkers', 1)
+    findif_command = kwargs.pop('worker_command', None)
 
     # Set method-dependent scf convergence criteria (test on procedures['energy'] since that's guaranteed)
     optstash_conv = driver_util._set_convergence_criterion('energy', lowername, 8, 10, 8, 10, 8)
@@ -1389,8 +1471,21 @@ def hessian(name, **kwargs):
 
         ndisp = len(displacements)
         print(""" %d displacements needed.""" % ndisp)
-        gradients = []
-        energies = []
+        gradients = [None] * ndisp
+        energies = [None] * ndisp
+
+        # S/R: Linkage of the sown files; parallel mode uses one that survives a restart of the job
+        findif_label = 'hessian gradients %s' % (lowername)
+        if freq_mode == 'parallel':
+            freq_linkage = driver_findif.displacement_linkage(findif_label + p4util.format_options_for_input(),
+                                                       displacements)
+        sow_linkage = freq_linkage if freq_mode == 'parallel' else os.getpid()
+
+        # Completed displacements of a single job, so it can be restarted
+        checkpoint = driver_findif.FindifCheckpoint(core.get_writer_file_prefix(molecule.name()) + '.findif.json',
+                                                    findif_label, (freq_mode == 'continuous'
+                                                                   and core.get_option('FINDIF', 'FD_CHECKPOINT')))
+        ref_wfn = None
 
         # S/R: Write instructions for sow/reap procedure to output file and reap input file
         if freq_mode == 'sow':
@@ -1426,61 +1521,87 @@ def hessian(name, **kwargs):
                 fmaster.write(instructionsM.encode('utf-8'))
             core.print_out(instructionsM)
 
-        for n, displacement in enumerate(displacements):
-            rfile = 'FREQ-%s' % (n + 1)
-
-            # Build string of title banner
-            banners = ''
-            banners += """core.print_out('\\n')\n"""
-            banners += """p4util.banner(' Hessian Computation: Gradient Displacement %d ')\n""" % (n + 1)
-            banners += """core.print_out('\\n')\n\n"""
-
-            if freq_mode == 'continuous':
-
-                # print progress to file and screen
-                core.print_out('\n')
-                p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
-                print(""" %d""" % (n + 1), end=('\n' if (n + 1 == ndisp) else ''))
-                sys.stdout.flush()
-
-                # Load in displacement into the active molecule (xyz coordinates only)
-                moleculeclone.set_geometry(displacement)
-
-                # Perform the gradient calculation
-                G, wfn = gradient(lowername, molecule=moleculeclone, return_wfn=True, **kwargs)
-                gradients.append(wfn.gradient())
-                energies.append(core.get_variable('CURRENT ENERGY'))
-
-                # clean may be necessary when changing irreps of displacements
-                core.clean()
-
-            # S/R: Write each displaced geometry to an input file
-            elif freq_mode == 'sow':
-                moleculeclone.set_geometry(displacement)
-
-                # S/R: Prepare molecule, options, kwargs, function call and energy save
-                #      forcexyz in molecule writer S/R enforcement of !reinterpret_coordentry above
-                with open('%s.in' % (rfile), 'wb') as freagent:
-                    freagent.write('# This is a psi4 input file auto-generated from the hessian() wrapper.\n\n')
-                    freagent.write(p4util.format_molecule_for_input(moleculeclone, forcexyz=True).encode('utf-8'))
-                    freagent.write(p4util.format_options_for_input(moleculeclone, **kwargs).encode('utf-8'))
-                    kwargs['return_wfn'] = True
-                    p4util.format_kwargs_for_input(freagent, **kwargs)
-                    freagent.write("""G, wfn = %s('%s', **kwargs)\n\n""" % (gradient.__name__, lowername))
-                    freagent.write("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (os.getpid(), n + 1))
-                    freagent.write("""yields electronic gradient %r\\n' % (p4util.mat2arr(wfn.gradient())))\n\n""")
-                    freagent.write("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (os.getpid(), n + 1))
-                    freagent.write("""yields electronic energy %20.12f\\n' % (get_variable('CURRENT ENERGY')))\n\n""")
-
-            # S/R: Read energy from each displaced geometry output file and save in energies array
-            elif freq_mode == 'reap':
-                exec(banners)
-                core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
-                pygrad = p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True, label='electronic gradient')
-                p4mat = core.Matrix.from_list(pygrad)
-                p4mat.print_out()
-                gradients.append(p4mat)
-                energies.append(p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True))
+        # Parallel mode sows every displacement, runs the inputs through a pool of workers and reaps them
+        passes = ['sow', 'reap'] if freq_mode == 'parallel' else [freq_mode]
+        for pass_mode in passes:
+            if pass_mode == 'reap' and freq_mode == 'parallel':
+                driver_findif.run_sown_displacements('FREQ', ndisp, 'HESSIAN', freq_linkage, findif_workers,
+                                                     findif_command)
+
+            # The reference geometry goes first in a single job so its orbitals can guess the rest
+            order = driver_findif.displacement_order(ndisp) if pass_mode == 'continuous' else range(ndisp)
+            for count, n in enumerate(order):
+                displacement = displacements[n]
+                rfile = 'FREQ-%s' % (n + 1)
+
+                # Build string of title banner
+                banners = ''
+                banners += """core.print_out('\\n')\n"""
+                banners += """p4util.banner(' Hessian Computation: Gradient Displacement %d ')\n""" % (n + 1)
+                banners += """core.print_out('\\n')\n\n"""
+
+                if pass_mode == 'continuous':
+
+                    # print progress to file and screen
+                    core.print_out('\n')
+                    p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
+                    print(""" %d""" % (count + 1), end=('\n' if (count + 1 == ndisp) else ''))
+                    sys.stdout.flush()
+
+                    # Load in displacement into the active molecule (xyz coordinates only)
+                    moleculeclone.set_geometry(displacement)
+
+                    stored = checkpoint.lookup(n, displacement)
+                    if stored is not None:
+                        core.print_out("  Gradient of displacement %d taken from the checkpoint.\n" % (n + 1))
+                        gradients[n] = core.Matrix.from_list(stored['gradient'])
+                        energies[n] = stored['energy']
+                        continue
+
+                    # Perform the gradient calculation
+                    G, wfn = gradient(lowername, molecule=moleculeclone, return_wfn=True, **kwargs)
+                    gradients[n] = wfn.gradient()
+                    energies[n] = core.get_variable('CURRENT ENERGY')
+                    checkpoint.store(n, displacement, energies[n], gradients[n])
+
+                    # Orbitals of the undisplaced geometry seed the SCF at the displacements
+                    if n == ndisp - 1:
+                        ref_wfn = wfn
+                        if core.get_option('FINDIF', 'FD_REFERENCE_GUESS'):
+                            guess_extrapolation.set_reference(wfn)
+
+                    # clean may be necessary when changing irreps of displacements
+                    core.clean()
+
+                # S/R: Write each displaced geometry to an input file
+                elif pass_mode == 'sow':
+                    moleculeclone.set_geometry(displacement)
+
+                    # S/R: Prepare molecule, options, kwargs, function call and energy save
+                    #      forcexyz in molecule writer S/R enforcement of !reinterpret_coordentry above
+                    with open('%s.in' % (rfile), 'wb') as freagent:
+                        freagent.write('# This is a psi4 input file auto-generated from the hessian() wrapper.\n\n'.encode('utf-8'))
+                        freagent.write(p4util.format_molecule_for_input(moleculeclone, forcexyz=True).encode('utf-8'))
+                        freagent.write(p4util.format_options_for_input(moleculeclone, **kwargs).encode('utf-8'))
+                        kwargs['return_wfn'] = True
+                        p4util.format_kwargs_for_input(freagent, **kwargs)
+                        freagent.write(("""G, wfn = %s('%s', **kwargs)\n\n""" % (gradient.__name__, lowername)).encode('utf-8'))
+                        freagent.write(("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (sow_linkage, n + 1)).encode('utf-8'))
+                        freagent.write("""yields electronic gradient %r\\n' % (p4util.mat2arr(wfn.gradient())))\n\n""".encode('utf-8'))
+                        freagent.write(("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (sow_linkage, n + 1)).encode('utf-8'))
+                        freagent.write("""yields electronic energy %20.12f\\n' % (get_variable('CURRENT ENERGY')))\n\n""".encode('utf-8'))
+
+                # S/R: Read energy from each displaced geometry output file and save in energies array
+                elif pass_mode == 'reap':
+                    exec(banners)
+                    core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
+                    pygrad = p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True, label='electronic gradient')
+                    p4mat = core.Matrix.from_list(pygrad)
+                    p4mat.print_out()
+                    gradients[n] = p4mat
+                    energies[n] = p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True)
+
+        guess_extrapolation.clear_reference()
 
         # S/R: Quit sow after writing files. Initialize skeleton wfn to receive grad for reap
         if freq_mode == 'sow':
@@ -1490,14 +1611,17 @@ def hessian(name, **kwargs):
                 return (None, None)
             else:
                 return None
-        elif freq_mode == 'reap':
+        elif freq_mode in ['reap', 'parallel'] or ref_wfn is None:
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
+        else:
+            wfn = ref_wfn
 
         # Assemble Hessian from gradients
         #   Final disp is undisp, so wfn has mol, G, H general to freq calc
         H = driver_findif.compute_hessian_from_gradient(molecule, gradients, irrep)  # TODO or moleculeclone?
         wfn.set_hessian(core.Matrix.from_array(H))
         wfn.set_gradient(G0)
+        checkpoint.remove()
 
         # The last item in the list is the reference energy, return it
         core.set_variable('CURRENT ENERGY', energies[-1])
@@ -1536,7 +1660,20 @@ def hessian(name, **kwargs):
 
         # This version is pretty dependent on the reference geometry being last (as it is now)
         print(' %d displacements needed.' % ndisp)
-        energies = []
+        energies = [None] * ndisp
+
+        # S/R: Linkage of the sown files; parallel mode uses one that survives a restart of the job
+        findif_label = 'hessian energies %s' % (lowername)
+        if freq_mode == 'parallel':
+            freq_linkage = driver_findif.displacement_linkage(findif_label + p4util.format_options_for_input(),
+                                                       displacements)
+        sow_linkage = freq_linkage if freq_mode == 'parallel' else os.getpid()
+
+        # Completed displacements of a single job, so it can be restarted
+        checkpoint = driver_findif.FindifCheckpoint(core.get_writer_file_prefix(molecule.name()) + '.findif.json',
+                                                    findif_label, (freq_mode == 'continuous'
+                                                                   and core.get_option('FINDIF', 'FD_CHECKPOINT')))
+        ref_wfn = None
 
         # S/R: Write instructions for sow/reap procedure to output file and reap input file
         if freq_mode == 'sow':
@@ -1572,52 +1709,77 @@ def hessian(name, **kwargs):
                 fmaster.write(instructionsM.encode('utf-8'))
             core.print_out(instructionsM)
 
-        for n, displacement in enumerate(displacements):
-            rfile = 'FREQ-%s' % (n + 1)
-
-            # Build string of title banner
-            banners = ''
-            banners += """core.print_out('\\n')\n"""
-            banners += """p4util.banner(' Hessian Computation: Energy Displacement %d ')\n""" % (n + 1)
-            banners += """core.print_out('\\n')\n\n"""
-
-            if freq_mode == 'continuous':
-
-                # print progress to file and screen
-                core.print_out('\n')
-                p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
-                print(""" %d""" % (n + 1), end=('\n' if (n + 1 == ndisp) else ''))
-                sys.stdout.flush()
-
-                # Load in displacement into the active molecule
-                moleculeclone.set_geometry(displacement)
-
-                # Perform the energy calculation
-                E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
-                energies.append(core.get_variable('CURRENT ENERGY'))
-
-                # clean may be necessary when changing irreps of displacements
-                core.clean()
-
-            # S/R: Write each displaced geometry to an input file
-            elif freq_mode == 'sow':
-                moleculeclone.set_geometry(displacement)
-
-                # S/R: Prepare molecule, options, kwargs, function call and energy save
-                with open('%s.in' % (rfile), 'wb') as freagent:
-                    freagent.write('# This is a psi4 input file auto-generated from the gradient() wrapper.\n\n')
-                    freagent.write(p4util.format_molecule_for_input(moleculeclone, forcexyz=True).encode('utf-8'))
-                    freagent.write(p4util.format_options_for_input(moleculeclone, **kwargs).encode('utf-8'))
-                    p4util.format_kwargs_for_input(freagent, **kwargs)
-                    freagent.write("""electronic_energy = %s('%s', **kwargs)\n\n""" % (energy.__name__, lowername))
-                    freagent.write("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (os.getpid(), n + 1))
-                    freagent.write("""yields electronic energy %20.12f\\n' % (electronic_energy))\n\n""")
-
-            # S/R: Read energy from each displaced geometry output file and save in energies array
-            elif freq_mode == 'reap':
-                exec(banners)
-                core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
-                energies.append(p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True))
+        # Parallel mode sows every displacement, runs the inputs through a pool of workers and reaps them
+        passes = ['sow', 'reap'] if freq_mode == 'parallel' else [freq_mode]
+        for pass_mode in passes:
+            if pass_mode == 'reap' and freq_mode == 'parallel':
+                driver_findif.run_sown_displacements('FREQ', ndisp, 'HESSIAN', freq_linkage, findif_workers,
+                                                     findif_command)
+
+            # The reference geometry goes first in a single job so its orbitals can guess the rest
+            order = driver_findif.displacement_order(ndisp) if pass_mode == 'continuous' else range(ndisp)
+            for count, n in enumerate(order):
+                displacement = displacements[n]
+                rfile = 'FREQ-%s' % (n + 1)
+
+                # Build string of title banner
+                banners = ''
+                banners += """core.print_out('\\n')\n"""
+                banners += """p4util.banner(' Hessian Computation: Energy Displacement %d ')\n""" % (n + 1)
+                banners += """core.print_out('\\n')\n\n"""
+
+                if pass_mode == 'continuous':
+
+                    # print progress to file and screen
+                    core.print_out('\n')
+                    p4util.banner('Loading displacement %d of %d' % (n + 1, ndisp))
+                    print(""" %d""" % (count + 1), end=('\n' if (count + 1 == ndisp) else ''))
+                    sys.stdout.flush()
+
+                    # Load in displacement into the active molecule
+                    moleculeclone.set_geometry(displacement)
+
+                    stored = checkpoint.lookup(n, displacement)
+                    if stored is not None:
+                        core.print_out("  Energy of displacement %d taken from the checkpoint.\n" % (n + 1))
+                        energies[n] = stored['energy']
+                        continue
+
+                    # Perform the energy calculation
+                    E, wfn = energy(lowername, return_wfn=True, molecule=moleculeclone, **kwargs)
+                    energies[n] = core.get_variable('CURRENT ENERGY')
+                    checkpoint.store(n, displacement, energies[n])
+
+                    # Orbitals of the undisplaced geometry seed the SCF at the displacements
+                    if n == ndisp - 1:
+                        ref_wfn = wfn
+                        if core.get_option('FINDIF', 'FD_REFERENCE_GUESS'):
+                            guess_extrapolation.set_reference(wfn)
+
+                    # clean may be necessary when changing irreps of displacements
+                    core.clean()
+
+                # S/R: Write each displaced geometry to an input file
+                elif pass_mode == 'sow':
+                    moleculeclone.set_geometry(displacement)
+
+                    # S/R: Prepare molecule, options, kwargs, function call and energy save
+                    with open('%s.in' % (rfile), 'wb') as freagent:
+                        freagent.write('# This is a psi4 input file auto-generated from the hessian() wrapper.\n\n'.encode('utf-8'))
+                        freagent.write(p4util.format_molecule_for_input(moleculeclone, forcexyz=True).encode('utf-8'))
+                        freagent.write(p4util.format_options_for_input(moleculeclone, **kwargs).encode('utf-8'))
+                        p4util.format_kwargs_for_input(freagent, **kwargs)
+                        freagent.write(("""electronic_energy = %s('%s', **kwargs)\n\n""" % (energy.__name__, lowername)).encode('utf-8'))
+                        freagent.write(("""core.print_out('\\nHESSIAN RESULT: computation %d for item %d """ % (sow_linkage, n + 1)).encode('utf-8'))
+                        freagent.write("""yields electronic energy %20.12f\\n' % (electronic_energy))\n\n""".encode('utf-8'))
+
+                # S/R: Read energy from each displaced geometry output file and save in energies array
+                elif pass_mode == 'reap':
+                    exec(banners)
+                    core.set_variable('NUCLEAR REPULSION ENERGY', moleculeclone.nuclear_repulsion_energy())
+                    energies[n] = p4util.extract_sowreap_from_output(rfile, 'HESSIAN', n, freq_linkage, True)
+
+        guess_extrapolation.clear_reference()
 
         # S/R: Quit sow after writing files. Initialize skeleton wfn to receive grad for reap
         if freq_mode == 'sow':
@@ -1627,14 +1789,16 @@ def hessian(name, **kwargs):
                 return (None, None)
             else:
                 return None
-        elif freq_mode == 'reap':
-        #    core.set_variable('CURRENT ENERGY', energies[-1])
+        elif freq_mode in ['reap', 'parallel'] or ref_wfn is None:
             wfn = core.Wavefunction.build(molecule, core.get_global_option('BASIS'))
+        else:
+            wfn = ref_wfn
 
         # Assemble Hessian from energies
         H = driver_findif.compute_hessian_from_energy(molecule, energies, irrep)
         wfn.set_hessian(core.Matrix.from_array(H))
         wfn.set_gradient(G0)
+        checkpoint.remove()
 
         # The last item in the list is the reference energy, return it
         core.set_variable('CURRENT ENERGY', energies[-1])
@@ -1688,7 +1852,7 @@ def frequency(name, **kwargs):
         use keyword ``freq_func`` instead of ``func``.
 
     :type mode: string
-    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'``
+    :param mode: |dl| ``'continuous'`` |dr| || ``'sow'`` || ``'reap'`` || ``'parallel'``
 
         For a finite difference of energies or gradients frequency, indicates
         whether the calculations required to complete the frequency are to be run
@@ -1696,6 +1860,8 @@ def frequency(name, **kwargs):
         embarrassingly parallel fashion (``'sow'``/``'reap'``)/ For the latter,
         run an initial job with ``'sow'`` and follow instructions in its output file.
         For maximum flexibility, ``return_wfn`` is always on in ``'reap'`` mode.
+        ``'parallel'`` sows, runs the displacements with ``nworkers`` concurrent
+        jobs and reaps them within this job; see :ref:`sec:sowreap`.
 
     :type dertype: :ref:`dertype <op_py_dertype>`
     :param dertype: |dl| ``'hessian'`` |dr| || ``'gradient'`` || ``'energy'``
@@ -1763,7 +1929,7 @@ def frequency(name, **kwargs):
 
     # are we in sow/reap mode?
     freq_mode = kwargs.get('mode', 'continuous').lower()
-    if freq_mode not in ['continuous', 'sow', 'reap']:
+    if freq_mode not in ['continuous', 'sow', 'reap', 'parallel']:
         raise ValidationError("""Frequency execution mode '%s' not valid.""" % (freq_mode))
 
     # Make sure the molecule the user provided is the active one
@@ -1904,6 +2070,73 @@ def vibanal_wfn(wfn, hess=None, irrep=None, molecule=None, project_trans=True, p
     return vibinfo
 
 
+def batch_vibanal(hessians, molecules, energies=None, project_trans=True, project_rot=True, normal_modes=False):
+    """Harmonic vibrational analysis and thermochemistry of many Hessians at once,
+    e.g., of the conformers of a molecule, through :py:class:`~psi4.core.BatchVibAnalysis`.
+
+    Equivalent to the analysis :py:func:`~psi4.driver.vibanal_wfn` does for one
+    Hessian, but mass-weighting, projection, and diagonalization run in
+    compiled code, one system per thread, and nothing is printed per system
+    or set as a variable. Symmetry labels of the modes are not assigned.
+    |thermo__t|, |thermo__p|, and (if set) |thermo__rotational_symmetry_number|
+    apply to all systems.
+
+    :type hessians: list of :py:class:`~psi4.core.Matrix` or ndarray
+    :param hessians: (3*nat, 3*nat) non-mass-weighted Hessians [Eh/a0/a0].
+
+    :type molecules: list of :py:class:`~psi4.core.Molecule`
+    :param molecules: The molecule of each Hessian, in the same orientation.
+
+    :type energies: list of float
+    :param energies: Electronic energies [Eh]; if given, totals are returned besides corrections.
+
+    :type normal_modes: bool
+    :param normal_modes: Also return the mass-weighted vibrational normal modes.
+
+    :returns: dict -- ndarrays over systems of ``ZPE_corr``, ``E_corr``,
+        ``H_corr``, ``G_corr`` [Eh], ``S_tot``, ``Cv_tot``, ``Cp_tot`` [mEh/K],
+        ``lnq_elec``, ``lnq_trans``, ``lnq_rot``, ``lnq_vib``, ``nimag``, and,
+        with *energies*, ``ZPE_tot``, ``E_tot``, ``H_tot``, ``G_tot``; lists of
+        per-system ``omega`` [cm^-1] (imaginary as negative), ``error`` (empty
+        unless the system could not be analyzed) and, with *normal_modes*, ``q``.
+
+    """
+    if len(hessians) != len(molecules):
+        raise ValidationError('batch_vibanal: {} Hessians for {} molecules'.format(len(hessians), len(molecules)))
+    if energies is not None and len(energies) != len(molecules):
+        raise ValidationError('batch_vibanal: {} energies for {} molecules'.format(len(energies), len(molecules)))
+
+    sigma = 0
+    if core.has_option_changed('THERMO', 'ROTATIONAL_SYMMETRY_NUMBER'):
+        sigma = core.get_option('THERMO', 'ROTATIONAL_SYMMETRY_NUMBER')
+
+    batch = core.BatchVibAnalysis(core.get_option("THERMO", "T"), core.get_option("THERMO", "P"),
+                                  project_trans, project_rot)
+    batch.set_normal_modes(normal_modes)
+    for hess, mol in zip(hessians, molecules):
+        mol.update_geometry()
+        if not isinstance(hess, core.Matrix):
+            hess = core.Matrix.from_array(np.asarray(hess))
+        batch.add_system(hess, mol, sigma)
+    results = batch.compute()
+
+    ret = {}
+    for key, attr in [('ZPE_corr', 'ZPE'), ('E_corr', 'E'), ('H_corr', 'H'), ('G_corr', 'G'), ('S_tot', 'S'),
+                      ('Cv_tot', 'Cv'), ('Cp_tot', 'Cp'), ('lnq_elec', 'lnq_elec'), ('lnq_trans', 'lnq_trans'),
+                      ('lnq_rot', 'lnq_rot'), ('lnq_vib', 'lnq_vib')]:
+        ret[key] = np.asarray([getattr(r, attr) if not r.error else np.nan for r in results])
+    ret['nimag'] = np.asarray([r.nimag for r in results])
+    ret['omega'] = [np.asarray(r.frequencies) if not r.error else None for r in results]
+    ret['error'] = [r.error for r in results]
+    if normal_modes:
+        ret['q'] = [np.asarray(r.normal_modes) if not r.error else None for r in results]
+    if energies is not None:
+        for piece in ['ZPE', 'E', 'H', 'G']:
+            ret[piece + '_tot'] = np.asarray(energies) + ret[piece + '_corr']
+
+    return ret
+
+
 def _hessian_write(wfn):
     if core.get_option('FINDIF', 'HESSIAN_WRITE'):
         filename = core.get_writer_file_prefix(wfn.molecule().name()) + ".hess"
@@ -1935,7 +2168,17 @@ def gdma(wfn, datafile=""):
     >>> grad, wfn = gradient('mp2', return_wfn=True)
     >>> gdma(wfn)
 
+    >>> # [2] Built-in threaded standard DMA, no GDMA add-on needed
+    >>> set gdma_engine native
+    >>> gdma(wfn)
+
     """
+    if core.get_option('GDMA', 'GDMA_ENGINE') == 'NATIVE':
+        if datafile:
+            raise ValidationError("GDMA data files need GDMA_ENGINE EXTERNAL.")
+        core.run_native_dma(wfn)
+        return
+
     # Start by writing a G* checkpoint file, for the GDMA code to read in
     fw = core.FCHKWriter(wfn)
     molname = wfn.molecule().name()
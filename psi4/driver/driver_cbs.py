@@ -29,9 +29,11 @@
 from __future__ import print_function
 from __future__ import absolute_import
 from __future__ import division
+import os
 import re
 import sys
 import math
+import shutil
 
 import numpy as np
 
@@ -745,6 +747,12 @@ def cbs(func, label, **kwargs):
 
     .. include:: ../cbs_eqn.rst
 
+    The required computations are run from the smallest to the largest basis.
+    Unless |scf__guess| has been set, each SCF after the first starts from the
+    orbitals of the previous leg projected onto its basis, and |scf__sad_cache|
+    is enabled so that repeated cbs() calls (e.g., in an optimization) reuse the
+    atomic densities of the first leg.
+
     * Energy Methods
         The presence of a stage_wfn keyword is the indicator to incorporate
         (and check for stage_basis and stage_scheme keywords) and compute
@@ -1101,7 +1109,9 @@ def cbs(func, label, **kwargs):
     optstash = p4util.OptionsState(
         ['BASIS'],
         ['WFN'],
-        ['WRITER_FILE_LABEL'])
+        ['WRITER_FILE_LABEL'],
+        ['SCF', 'GUESS'],
+        ['SCF', 'SAD_CACHE'])
 
     # Define some quantum chemical knowledge, namely what methods are subsumed in others
 
@@ -1473,6 +1483,9 @@ def cbs(func, label, **kwargs):
                                                 core.Matrix(natom, 3),
                                                 core.Matrix(3 * natom, 3 * natom)])))
 
+    #     Run legs small-to-large so each SCF can start from the last basis' orbitals
+    JOBS.sort(key=lambda job: job['f_zeta'])
+
     instructions += """\n    Full listing of computations to be obtained (required and bonus).\n"""
     for mc in JOBS_EXT:
         instructions += """   %12s / %-24s for  %s%s\n""" % \
@@ -1485,6 +1498,14 @@ def cbs(func, label, **kwargs):
     #   needs to be communicated to optimize() so reset by that optstash
     core.set_local_option('SCF', 'GUESS_PERSIST', True)
 
+    # unless the user chose a guess, later legs read the previous leg's orbitals projected onto
+    #   their own basis, and the first leg's atomic densities are cached for the next cbs() call
+    project_guess = not core.has_option_changed('SCF', 'GUESS')
+    if not core.has_option_changed('SCF', 'SAD_CACHE'):
+        core.set_local_option('SCF', 'SAD_CACHE', True)
+    user_guess = core.get_option('SCF', 'GUESS')
+    prev_orbitals = None
+
     Njobs = 0
     # Run necessary computations
     for mc in JOBS:
@@ -1505,8 +1526,17 @@ def cbs(func, label, **kwargs):
             (user_writer_file_label + ('' if user_writer_file_label == '' else '-') + mc['f_wfn'].lower() + '-' + mc['f_basis'].lower())
         exec(commands)
 
+        leg_orbitals = _cbs_orbital_file(molecule)
+        if project_guess:
+            if _cbs_seed_orbitals(prev_orbitals, leg_orbitals, molecule):
+                core.set_local_option('SCF', 'GUESS', 'READ')
+            else:
+                core.set_local_option('SCF', 'GUESS', user_guess)
+
         # Make energy(), etc. call
         response = func(molecule=molecule, **kwargs)
+        if os.path.isfile(leg_orbitals):
+            prev_orbitals = leg_orbitals
         if ptype == 'energy':
             mc['f_energy'] = response
         elif ptype == 'gradient':
@@ -1720,6 +1750,30 @@ def _expand_scheme_orders(scheme, basisname, basiszeta, wfnname, natom):
     return NEED
 
 
+def _cbs_orbital_file(molecule):
+    """Path of the orbital (file 180) guess the SCF of the current cbs() leg writes."""
+    fname = os.path.split(os.path.abspath(core.get_writer_file_prefix(molecule.name())))[1]
+    psi_scratch = core.IOManager.shared_object().get_default_path()
+    return os.path.join(psi_scratch, fname + ".180.npz")
+
+
+def _cbs_seed_orbitals(source, target, molecule):
+    """Copy the orbitals of an earlier leg to where the next leg reads its guess.
+
+    Returns whether a usable guess was placed. Orbitals written in another
+    point group than *molecule* cannot be projected and are skipped.
+
+    """
+    if source is None or source == target or not os.path.isfile(source):
+        return False
+    with np.load(source) as data:
+        if str(data["symmetry"]) != molecule.schoenflies_symbol():
+            return False
+    shutil.copyfile(source, target)
+    core.print_out("""  CBS: seeding SCF guess with orbitals from %s\n""" % os.path.basename(source))
+    return True
+
+
 def _contract_scheme_orders(needdict, datakey='f_energy'):
     """Prepared named arguments for extrapolation functions by
     extracting zetas and values (which one determined by *datakey*) out
@@ -26,8 +26,14 @@
 # @END LICENSE
 #
 
+import json
+import os
+import sys
+import zlib
+
 import numpy as np
 from psi4 import core
+from psi4.driver import p4util
 from psi4.driver.p4util.exceptions import ValidationError
 from psi4.driver.qcdb import molecule
 from psi4.driver.p4util import block_diagonal_array
@@ -415,15 +421,16 @@ def _process_hessian_symmetry_block(H_block, B_block, massweighter, irrep, print
         core.print_out("symmetry-adapted cartesian coordinates.\n")
         core.Matrix.from_array(H_block).print_out()
 
-    evals, evects = np.linalg.eigh(H_block)
-    # Get our eigenvalues and eigenvectors in descending order.
-    idx = evals.argsort()[::-1]
-    evals = evals[idx]
-    evects = evects[:, idx]
+    # The block's normal coordinates are only reported; vibanal diagonalizes the full Hessian.
+    if print_lvl >= 2:
+        evals, evects = np.linalg.eigh(H_block)
+        # Get our eigenvalues and eigenvectors in descending order.
+        idx = evals.argsort()[::-1]
+        evals = evals[idx]
+        evects = evects[:, idx]
 
-    normal_irr = np.dot((B_block * massweighter).T, evects)
+        normal_irr = np.dot((B_block * massweighter).T, evects)
 
-    if print_lvl >= 2:
         core.print_out("\n    Normal coordinates (non-mass-weighted) for irrep {}:\n".format(irrep))
         core.Matrix.from_array(normal_irr).print_out()
 
@@ -455,17 +462,18 @@ def _process_hessian(H_blocks, B_blocks, massweighter, print_lvl):
     """
 
     # We have the Hessian in each irrep! The final task is to perform coordinate transforms.
-    H = block_diagonal_array(*H_blocks)
-    B = np.vstack(B_blocks)
-
     if print_lvl >= 3:
+        H = block_diagonal_array(*H_blocks)
         core.print_out("\n    Force constant matrix for all computed irreps in mass-weighted SALCS.\n")
         core.Matrix.from_array(H).print_out()
 
     # Transform the massweighted Hessian from the CdSalc basis to Cartesians.
     # The Hessian is the matrix not of a linear transformation, but of a (symmetric) bilinear form
     # As such, the change of basis is formula A' = Xt A X, no inverses!
-    Hx = np.dot(np.dot(B.T, H), B)
+    # H is block diagonal by irrep, so accumulate Bh^t Hh Bh rather than multiply through the zero blocks.
+    Hx = np.zeros((B_blocks[0].shape[1], B_blocks[0].shape[1]))
+    for H_h, B_h in zip(H_blocks, B_blocks):
+        Hx += np.dot(B_h.T, np.dot(H_h, B_h))
     if print_lvl >= 3:
         core.print_out("\n    Force constants in mass-weighted Cartesian coordinates.\n")
         core.Matrix.from_array(Hx).print_out()
@@ -736,22 +744,20 @@ def compute_hessian_from_energy(mol, E, freq_irrep_only):
         # ...if offdiagonal elements DON'T exist, reshaping would raise an error.
         if offdiag_energies:
             offdiag_energies = np.reshape(offdiag_energies, (num_unique_off_elts, -1))
-        offdiag_row_index = 0
-
-        for i, salc in enumerate(salcs):
-            for j, salc2 in enumerate(salcs[:i]):
-                offdiag_row = offdiag_energies[offdiag_row_index]
-                if data["num_pts"] == 3:
-                    fc = (+offdiag_row[0] + offdiag_row[1] + 2 * ref_energy - energies[i][0] - energies[i][1] -
-                          energies[j][0] - energies[j][1]) / (2 * data["disp_size"]**2)
-                elif data["num_pts"] == 5:
-                    fc = (-offdiag_row[0] - offdiag_row[1] + 9 * offdiag_row[2] - offdiag_row[3] - offdiag_row[4] +
-                          9 * offdiag_row[5] - offdiag_row[6] - offdiag_row[7] + energies[i][0] - 7 * energies[i][1] -
-                          7 * energies[i][2] + energies[i][3] + energies[j][0] - 7 * energies[j][1] -
-                          7 * energies[j][2] + energies[j][3] + 12 * ref_energy) / (12 * data["disp_size"]**2)
-                H_irr[i, j] = fc
-                H_irr[j, i] = fc
-                offdiag_row_index += 1
+        # Pairs (i, j < i) in the order the displacements were generated, all at once.
+        if num_unique_off_elts:
+            i, j = np.tril_indices(n_salcs, -1)
+            offdiag_row = np.asarray(offdiag_energies).T
+            if data["num_pts"] == 3:
+                fc = (+offdiag_row[0] + offdiag_row[1] + 2 * ref_energy - energies[i, 0] - energies[i, 1] -
+                      energies[j, 0] - energies[j, 1]) / (2 * data["disp_size"]**2)
+            elif data["num_pts"] == 5:
+                fc = (-offdiag_row[0] - offdiag_row[1] + 9 * offdiag_row[2] - offdiag_row[3] - offdiag_row[4] +
+                      9 * offdiag_row[5] - offdiag_row[6] - offdiag_row[7] + energies[i, 0] - 7 * energies[i, 1] -
+                      7 * energies[i, 2] + energies[i, 3] + energies[j, 0] - 7 * energies[j, 1] -
+                      7 * energies[j, 2] + energies[j, 3] + 12 * ref_energy) / (12 * data["disp_size"]**2)
+            H_irr[i, j] = fc
+            H_irr[j, i] = fc
 
         B_pi.append(data["salc_list"].matrix_irrep(h))
         H_pi.append(_process_hessian_symmetry_block(H_irr, B_pi[-1], massweighter, irrep_lbls[h], data["print_lvl"]))
@@ -820,3 +826,104 @@ def hessian_from_energy_geometries(molecule, irrep):
         A list of displaced geometries to compute energies at.
     """
     return _geom_generator(molecule, irrep, "2_0")
+
+
+def displacement_order(ndisp):
+    """Order in which to compute displacements in a single job: the reference geometry (last in the
+    displacement list) first, so its orbitals can seed the SCF at every displaced geometry."""
+    return [ndisp - 1] + list(range(ndisp - 1))
+
+
+def displacement_linkage(label, displacements):
+    """A linkage number for sown displacement files that is stable across restarts of the same job,
+    so outputs from an interrupted run are recognized and reused."""
+    digest = zlib.crc32(label.encode('utf-8'))
+    for geom in displacements:
+        digest = zlib.crc32(np.round(np.asarray(geom), 10).tobytes(), digest)
+    return digest & 0x7fffffff
+
+
+class FindifCheckpoint(object):
+    """Results of completed displacements, stored as JSON next to the output so an interrupted
+    finite-difference job can be restarted without recomputing them.
+
+    Entries are keyed by the displacement index and validated against the displaced geometry.
+    """
+
+    def __init__(self, filename, label, enabled=True):
+        self.filename = filename
+        self.label = label
+        self.enabled = enabled
+        self.points = {}
+        if enabled and os.path.isfile(filename):
+            with open(filename, 'r') as handle:
+                data = json.load(handle)
+            if data.get('label') == label:
+                self.points = data.get('points', {})
+            if self.points:
+                core.print_out("  Finite difference checkpoint %s: %d completed displacements.\n" %
+                               (filename, len(self.points)))
+
+    def lookup(self, n, geom):
+        """Returns the stored dict (``energy``, optionally ``gradient``) for displacement `n`, or None."""
+        entry = self.points.get(str(n))
+        if entry is None:
+            return None
+        if not np.allclose(np.asarray(entry['geometry']), np.asarray(geom), atol=1.e-10, rtol=0.0):
+            return None
+        return entry
+
+    def store(self, n, geom, energy, gradient=None):
+        if not self.enabled:
+            return
+        entry = {'geometry': np.asarray(geom).tolist(), 'energy': energy}
+        if gradient is not None:
+            entry['gradient'] = np.asarray(gradient).tolist()
+        self.points[str(n)] = entry
+
+        scratch = self.filename + '.tmp'
+        with open(scratch, 'w') as handle:
+            json.dump({'label': self.label, 'points': self.points}, handle)
+        os.rename(scratch, self.filename)
+
+    def remove(self):
+        if self.enabled and os.path.isfile(self.filename):
+            os.remove(self.filename)
+
+
+def _sown_job_done(outfile, quantity, n, linkage):
+    """Has the sown job for displacement `n` already written its RESULT line?"""
+    if not os.path.isfile(outfile):
+        return False
+    tag = [quantity, 'RESULT:', 'computation', str(linkage), 'for', 'item', str(n + 1)]
+    with open(outfile, 'r') as handle:
+        for line in handle:
+            if line.split()[:7] == tag:
+                return True
+    return False
+
+
+def run_sown_displacements(prefix, ndisp, quantity, linkage, nworkers=1, command=None):
+    """Run the sown input files ``prefix-1.in`` ... ``prefix-ndisp.in`` with a pool of `nworkers`
+    concurrent jobs started by `command` (see :py:func:`~psi4.driver.p4util.run_psi4_inputs`), skipping
+    those whose output already holds the result (checkpoint/restart).
+    """
+    pending = []
+    for n in range(ndisp):
+        rfile = '%s-%d' % (prefix, n + 1)
+        if _sown_job_done(rfile + '.out', quantity, n, linkage):
+            continue
+        pending.append(n)
+
+    core.print_out("\n  Running %d of %d displacements with %d workers (%d reused from a previous run).\n" %
+                   (len(pending), ndisp, nworkers, ndisp - len(pending)))
+    print(""" running %d displacements with %d workers""" % (len(pending), nworkers))
+    sys.stdout.flush()
+
+    jobs = [('%s-%d.in' % (prefix, n + 1), '%s-%d.out' % (prefix, n + 1)) for n in pending]
+    p4util.run_psi4_inputs(jobs, nworkers, command)
+
+    failed = [n + 1 for n in pending if not _sown_job_done('%s-%d.out' % (prefix, n + 1), quantity, n, linkage)]
+    if failed:
+        raise ValidationError("Finite difference displacements %s failed; rerun to retry only those." %
+                              ', '.join(str(n) for n in failed))
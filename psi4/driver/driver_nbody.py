@@ -28,7 +28,9 @@
 
 from __future__ import print_function
 from __future__ import absolute_import
+import os
 import math
+import json
 import itertools
 
 import numpy as np
@@ -163,6 +165,14 @@ def nbody_gufunc(func, method_string, **kwargs):
 
         If True returns the total data (energy/gradient/etc) of the system,
         otherwise returns interaction data.
+
+    :type nworkers: int
+    :param nworkers: |dl| ``1`` |dr| || ``8`` || etc.
+
+        Number of fragment computations to run concurrently, each as a separate
+        psi4 job started by **worker_command** (see :ref:`sec:sowreap`). Jobs
+        run largest first and share the SAD guess cache. By default the
+        fragments are computed one after another in this job.
     """
 
     # Initialize dictionaries for easy data passing
@@ -175,6 +185,8 @@ def nbody_gufunc(func, method_string, **kwargs):
     metadata['return_total_data'] = kwargs.pop('return_total_data', False)
     metadata['molecule'] = kwargs.pop('molecule', core.get_active_molecule())
     metadata['molecule'].update_geometry()
+    metadata['nworkers'] = kwargs.pop('nworkers', 1)
+    metadata['worker_command'] = kwargs.pop('worker_command', None)
     metadata['kwargs'] = kwargs
     core.clean_variables()
 
@@ -396,6 +408,9 @@ def compute_nbody_components(func, method_string, metadata):
     #molecule = core.get_active_molecule()
     compute_list = metadata['compute_dict']['all']
 
+    if metadata.get('nworkers', 1) > 1:
+        return _compute_nbody_components_concurrent(func, method_string, metadata)
+
     # Now compute the energies
     energies_dict = {}
     ptype_dict = {}
@@ -425,6 +440,104 @@ def compute_nbody_components(func, method_string, metadata):
 
     return {'energies': energies_dict, 'ptype': ptype_dict, 'intermediates': intermediates_dict}
 
+def _nbody_job_cost(pair, fragment_size_dict):
+    """Rough cost of a fragment computation, cubic in the number of atoms carrying basis functions."""
+    return sum(fragment_size_dict[frag] for frag in pair[1])**3
+
+
+def _compute_nbody_components_concurrent(func, method_string, metadata):
+    """Computes requested N-body components as independent psi4 jobs run by a pool of
+    ``metadata['nworkers']`` workers. Same arguments and returns as :py:func:`compute_nbody_components`.
+
+    Jobs are written as ``NBODY-<k>.in`` input files and ordered largest first, so the long
+    computations start early and the small ones fill in the end. Each job writes its result to
+    ``NBODY-<k>.json``; results left by an interrupted run of the same set of jobs are reused.
+    """
+    kwargs = metadata['kwargs']
+    molecule = metadata['molecule']
+    compute_list = metadata['compute_dict']['all']
+
+    fragment_size_dict = {frag: molecule.extract_subsets(frag).natom() for frag in range(1, metadata['max_frag'] + 1)}
+    pairs = set()
+    for n in compute_list.keys():
+        pairs |= compute_list[n]
+    pairs = sorted(pairs, key=lambda pair: (-_nbody_job_cost(pair, fragment_size_dict), str(pair)))
+
+    # Fragment jobs share atomic SAD densities through the on-disk cache
+    options = p4util.format_options_for_input()
+    if not core.has_global_option_changed('SAD_CACHE'):
+        options += """core.set_global_option('SAD_CACHE', True)\n"""
+
+    core.print_out("\n   ==> N-Body: Computing %d complexes with %d workers <==\n\n" % (len(pairs), metadata['nworkers']))
+
+    labels = {}
+    jobs = []
+    for k, pair in enumerate(pairs):
+        rfile = 'NBODY-%d' % (k + 1)
+        labels[pair] = '%s %s %s %s' % (func.__name__, method_string, str(pair), options)
+        if _read_nbody_result(rfile, labels[pair]) is not None:
+            continue
+
+        ghost = list(set(pair[1]) - set(pair[0]))
+        current_mol = molecule.extract_subsets(list(pair[0]), ghost)
+
+        with open('%s.in' % (rfile), 'wb') as freagent:
+            freagent.write('# This is a psi4 input file auto-generated from the nbody driver.\n\n'.encode('utf-8'))
+            freagent.write(p4util.format_molecule_for_input(current_mol, name='nbody').encode('utf-8'))
+            freagent.write(options.encode('utf-8'))
+            p4util.format_kwargs_for_input(freagent, **kwargs)
+            freagent.write(("""ret = %s('%s', **kwargs)\n\n""" % (func.__name__, method_string)).encode('utf-8'))
+            freagent.write("""import os\nimport json\nimport numpy as np\n""".encode('utf-8'))
+            freagent.write(("""nbody_result = {'label': %r, 'energy': core.get_variable('CURRENT ENERGY'),\n"""
+                            """                'ptype': ret if isinstance(ret, float) else np.asarray(ret).tolist()}\n"""
+                            """with open('%s.json.tmp', 'w') as handle:\n"""
+                            """    json.dump(nbody_result, handle)\n"""
+                            """os.rename('%s.json.tmp', '%s.json')\n""" %
+                            (labels[pair], rfile, rfile, rfile)).encode('utf-8'))
+        jobs.append(('%s.in' % (rfile), '%s.out' % (rfile)))
+
+    core.print_out("        %d jobs to run, %d reused from a previous run.\n" % (len(jobs), len(pairs) - len(jobs)))
+    p4util.run_psi4_inputs(jobs, metadata['nworkers'], metadata['worker_command'])
+
+    energies_dict = {}
+    ptype_dict = {}
+    intermediates_dict = {}
+    failed = []
+    for k, pair in enumerate(pairs):
+        rfile = 'NBODY-%d' % (k + 1)
+        result = _read_nbody_result(rfile, labels[pair])
+        if result is None:
+            failed.append(rfile)
+            continue
+
+        if isinstance(result['ptype'], list):
+            ptype_dict[pair] = core.Matrix.from_array(np.array(result['ptype']))
+        else:
+            ptype_dict[pair] = result['ptype']
+        energies_dict[pair] = result['energy']
+        var_key = "N-BODY (%s)@(%s) TOTAL ENERGY" % (', '.join([str(i) for i in pair[0]]),
+                                                      ', '.join([str(i) for i in pair[1]]))
+        intermediates_dict[var_key] = result['energy']
+        core.print_out("\n       N-Body: Complex Energy (fragments = %s, basis = %s: %20.14f)\n" %
+                                                            (str(pair[0]), str(pair[1]), energies_dict[pair]))
+
+    if failed:
+        raise ValidationError("N-Body: fragment jobs %s failed; rerun to retry only those." % ', '.join(failed))
+
+    return {'energies': energies_dict, 'ptype': ptype_dict, 'intermediates': intermediates_dict}
+
+
+def _read_nbody_result(rfile, label):
+    """Returns the result written by fragment job `rfile`, or None if it is missing or belongs to another job."""
+    if not os.path.isfile(rfile + '.json'):
+        return None
+    with open(rfile + '.json', 'r') as handle:
+        result = json.load(handle)
+    if result.get('label') != label:
+        return None
+    return result
+
+
 def assemble_nbody_components(metadata, component_results):
     """Assembles N-body components into interaction quantities according to requested BSSE procedure(s).
 
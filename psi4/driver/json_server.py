@@ -0,0 +1,147 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2018 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""
+Serves JSON input requests from one long-lived psi4 process.
+"""
+
+import json
+import socket
+import sys
+
+from psi4 import core
+from psi4.driver import json_wrapper
+
+
+class JSONServer(object):
+    """Runs :py:func:`~psi4.json_wrapper.run_json` requests back to back
+    in one process.
+
+    Each request is one line of JSON in either schema understood by
+    ``run_json``, answered by one line of JSON. Between requests, options,
+    variables, the active molecule and wavefunction, scratch files, and the
+    memory and thread settings are returned to their state at server
+    start. Content-keyed caches are deliberately kept warm: parsed basis-set
+    files, DFT grids, density-fitting metrics, X2C atomic blocks, the
+    integral engine, and the on-disk SAD_CACHE if the *keywords*
+    argument enables it.
+
+    Parameters
+    ----------
+    keywords : dict, optional
+        Global options applied before every request, which the request's own
+        keywords may override, *e.g.* ``{"sad_cache": True}``.
+
+    """
+
+    def __init__(self, keywords=None):
+        self.keywords = dict(keywords or {})
+        self.memory = core.get_memory()
+        self.nthreads = core.get_num_threads()
+        self.nrequests = 0
+
+    def reset(self):
+        """Returns the process to its server-start state, keeping caches warm."""
+        core.clean_variables()
+        core.clean_options()
+        core.reset_environment()
+        core.set_memory_bytes(self.memory, True)
+        core.set_num_threads(self.nthreads, quiet=True)
+        for key, value in self.keywords.items():
+            core.set_global_option(key.upper(), value)
+
+    def handle(self, line):
+        """Runs one request line and returns the response line, or None to stop."""
+        line = line.strip()
+        if not line:
+            return ""
+
+        try:
+            json_data = json.loads(line)
+        except ValueError as error:
+            return json.dumps({"success": False, "error": "Could not parse request: " + str(error)})
+
+        if json_data.get("shutdown", False):
+            return None
+
+        self.reset()
+        json_data = json_wrapper.run_json(json_data, clean=False, remove_output=True)
+        self.nrequests += 1
+        return json.dumps(json_data)
+
+    def serve_stream(self, instream, outstream):
+        """Answers requests read line by line from *instream* until EOF or a shutdown request."""
+        for line in instream:
+            response = self.handle(line)
+            if response is None:
+                break
+            if response:
+                outstream.write(response + "\n")
+                outstream.flush()
+
+    def serve_socket(self, port, host="localhost"):
+        """Listens on *host*:*port* and answers each connection's requests in turn.
+
+        Requests from different connections are not run concurrently, as
+        psi4 keeps its state process-wide. A shutdown request stops the
+        server.
+
+        """
+        listener = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        listener.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        listener.bind((host, port))
+        listener.listen(1)
+        try:
+            running = True
+            while running:
+                connection, _ = listener.accept()
+                with connection:
+                    stream = connection.makefile("rw")
+                    for line in stream:
+                        response = self.handle(line)
+                        if response is None:
+                            running = False
+                            break
+                        if response:
+                            stream.write(response + "\n")
+                            stream.flush()
+        finally:
+            listener.close()
+
+
+def serve(port=None, host="localhost", keywords=None):
+    """Serves JSON requests from stdin to stdout, or over a TCP socket if *port* is given.
+
+    See :py:class:`JSONServer` for the protocol.
+
+    """
+    server = JSONServer(keywords)
+    if port is None:
+        server.serve_stream(sys.stdin, sys.stdout)
+    else:
+        server.serve_socket(port, host)
+    return server.nrequests
@@ -58,7 +58,7 @@ def _clean_psi_environ(do_clean):
         psi4.core.clean_options()
         core.clean()
 
-def run_json(json_data, clean=True):
+def run_json(json_data, clean=True, remove_output=False):
 
     # Set scratch
     if "scratch_location" in json_data:
@@ -99,6 +99,10 @@ def run_json(json_data, clean=True):
     if return_output:
         with open(outfile, 'r') as f:
             json_data["raw_output"] = f.read()
+
+    if remove_output:
+        os.unlink(outfile)
+    elif return_output:
         atexit.register(os.unlink, outfile)
 
     return json_data
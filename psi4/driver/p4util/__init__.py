@@ -36,3 +36,4 @@ from .numpy_helper import *
 from .p4regex import *
 from .python_helpers import *
 from .solvers import *
+from .checkpoint import *
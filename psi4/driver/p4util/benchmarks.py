@@ -0,0 +1,410 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2018 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""Module with reproducible integral, JK and method performance benchmarks that report in JSON."""
+from __future__ import division
+
+import json
+import os
+import platform
+import time
+
+import numpy as np
+
+from psi4 import core
+from .exceptions import TestComparisonError, ValidationError
+
+__all__ = ["benchmark_suite", "perf_benchmark", "perf_suite"]
+
+# Canonical systems, in increasing size
+_benchmark_molecules = {
+    "water": """
+0 1
+O  0.000000  0.000000  0.117790
+H  0.000000  0.755453 -0.471161
+H  0.000000 -0.755453 -0.471161
+symmetry c1
+""",
+    "benzene": """
+0 1
+C  0.000000  1.396792  0.000000
+C  1.209657  0.698396  0.000000
+C  1.209657 -0.698396  0.000000
+C  0.000000 -1.396792  0.000000
+C -1.209657 -0.698396  0.000000
+C -1.209657  0.698396  0.000000
+H  0.000000  2.484212  0.000000
+H  2.151390  1.242106  0.000000
+H  2.151390 -1.242106  0.000000
+H  0.000000 -2.484212  0.000000
+H -2.151390 -1.242106  0.000000
+H -2.151390  1.242106  0.000000
+symmetry c1
+""",
+}
+
+# Four distinct centers for the per-shell integral timings
+_integral_molecule = """
+0 1
+Ne  1.000000  1.000000  1.000000
+Ne -1.000000 -1.000000  1.000000
+Ne -1.000000  1.000000 -1.000000
+Ne  1.000000 -1.000000 -1.000000
+symmetry c1
+"""
+
+# Heavy-atom system for the ECP integrals
+_ecp_molecule = """
+0 1
+I  0.000000  0.000000  0.000000
+I  0.000000  0.000000  2.666000
+symmetry c1
+"""
+
+# Method benchmarks of the performance suite: molecule, method, and options on top of the defaults
+_perf_molecules = {
+    "water": _benchmark_molecules["water"],
+    "benzene": _benchmark_molecules["benzene"],
+    "water-dimer": """
+0 1
+O  -1.551007  -0.114520   0.000000
+H  -1.934259   0.762503   0.000000
+H  -0.599677   0.040712   0.000000
+--
+0 1
+O   1.350625   0.111469   0.000000
+H   1.680398  -0.373741  -0.758561
+H   1.680398  -0.373741   0.758561
+symmetry c1
+no_reorient
+no_com
+""",
+}
+
+_perf_cases = {
+    "df-scf": ("benzene", "scf", {"basis": "cc-pvdz", "scf_type": "df"}),
+    "direct-scf": ("benzene", "scf", {"basis": "cc-pvdz", "scf_type": "direct"}),
+    "dft-v": ("benzene", "b3lyp", {"basis": "cc-pvdz", "scf_type": "df"}),
+    "df-mp2": ("benzene", "mp2", {"basis": "cc-pvdz", "scf_type": "df", "mp2_type": "df"}),
+    "ccsd-t": ("water", "ccsd(t)", {"basis": "cc-pvdz", "scf_type": "pk"}),
+    "sapt0": ("water-dimer", "sapt0", {"basis": "jun-cc-pvdz", "scf_type": "df"}),
+    "detci-sigma": ("water", "cisd", {"basis": "6-31g**", "scf_type": "pk", "qc_module": "detci"}),
+    "int-transform": ("water", "mp2", {"basis": "cc-pvtz", "scf_type": "pk", "mp2_type": "conv", "qc_module": "occ"}),
+}
+
+
+def _peak_rss_mib():
+    """Memory high-water mark of the process [MiB]; ru_maxrss is in kB on Linux and in bytes on macOS."""
+    try:
+        import resource
+    except ImportError:
+        return 0.0
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return peak / (1024.0 * 1024.0) if platform.system() == "Darwin" else peak / 1024.0
+
+
+def _load_baseline(baseline):
+    """The baseline results as a dict by case, from a dict, a JSON file, or PSI_PERF_BASELINE."""
+    if baseline is None:
+        baseline = os.environ.get("PSI_PERF_BASELINE")
+    if baseline is None or isinstance(baseline, dict):
+        return baseline
+    with open(baseline) as handle:
+        return json.load(handle)
+
+
+def _regressions(result, baseline, tolerance, noise=0.1):
+    """Phases of `result` more than `tolerance` (and `noise` seconds) slower than in `baseline`."""
+    checks = [("total", result["wall"], baseline.get("wall"))]
+    for phase, timing in baseline.get("phases", {}).items():
+        if phase in result["phases"]:
+            checks.append((phase, result["phases"][phase]["wall"], timing["wall"]))
+
+    regressions = []
+    for phase, now, then in checks:
+        if then is not None and now > then * (1.0 + tolerance) and now - then > noise:
+            regressions.append("%s: %s %.3f s, baseline %.3f s" % (result["case"], phase, now, then))
+    return regressions
+
+
+def perf_benchmark(case, nthreads=4, filename=None, baseline=None, tolerance=None, min_fraction=0.01):
+    """
+    Runs one case of the performance suite and reports its time and memory per phase.
+
+    Every case is a fixed method, molecule, and basis (see ``perf_suite``), run from a clean
+    state on a fixed number of threads. Phases are the timers of the profiling layer, as in
+    timer.dat; each one taking at least `min_fraction` of the run is reported. The times of
+    parallel timers (``serial`` false) are summed over threads. Each phase is also written as a
+    ``perf_phase`` event, and the case as a ``perf_benchmark`` event, to the event file if one
+    is open.
+
+    Parameters
+    ----------
+    case : str
+        Name of the case, one of df-scf, direct-scf, dft-v, df-mp2, ccsd-t, sapt0, detci-sigma,
+        int-transform.
+    nthreads : int, optional
+        Threads to run on; restored afterwards.
+    filename : str, optional
+        JSON file to write the result to.
+    baseline : dict or str, optional
+        Results of an earlier run by case, such as a ``perf_suite`` JSON file, to hold this run
+        to; defaults to the file named by PSI_PERF_BASELINE, if set.
+    tolerance : float, optional
+        Fraction by which the whole run, or any phase in the baseline, may be slower than the
+        baseline; defaults to PSI_PERF_TOLERANCE, else 0.25. Differences under 0.1 s are noise.
+    min_fraction : float, optional
+        Smallest share of the wall time a phase must take to be reported.
+
+    Returns
+    -------
+    dict
+        The case, its energy, wall time [s], phases (wall [s], calls and serial per timer),
+        and memory (process peak RSS and peak module grants, in MiB).
+
+    Raises
+    ------
+    TestComparisonError
+        If the run is slower than the baseline.
+
+    """
+    from psi4.driver.driver import energy
+
+    if case not in _perf_cases:
+        raise ValidationError("perf_benchmark: unknown case %s, choose from %s." % (case, ", ".join(_perf_cases)))
+    molname, method, options = _perf_cases[case]
+    if tolerance is None:
+        tolerance = float(os.environ.get("PSI_PERF_TOLERANCE", 0.25))
+
+    # Start each case from the same clean state, but after the process has warmed up
+    core.clean()
+    core.clean_options()
+    core.clean_variables()
+    core.reset_environment()
+    for key, value in options.items():
+        core.set_global_option(key.upper(), value)
+    mol = core.Molecule.from_string(_perf_molecules[molname])
+    mol.update_geometry()
+
+    old_nthreads = core.get_num_threads()
+    core.set_num_threads(nthreads, quiet=True)
+    before = core.timer_totals()
+    start = time.time()
+    try:
+        E = energy(method, molecule=mol)
+    finally:
+        wall = time.time() - start
+        core.set_num_threads(old_nthreads, quiet=True)
+    after = core.timer_totals()
+
+    phases = {}
+    for phase, timing in after.items():
+        calls = timing["calls"] - before.get(phase, {"calls": 0})["calls"]
+        seconds = timing["wall"] - before.get(phase, {"wall": 0.0})["wall"]
+        if calls > 0 and seconds >= min_fraction * wall:
+            phases[phase] = {"wall": seconds, "calls": calls, "serial": timing["serial"]}
+
+    result = {
+        "case": case,
+        "method": method,
+        "molecule": molname,
+        "options": options,
+        "nthreads": nthreads,
+        "energy": E,
+        "wall": wall,
+        "phases": phases,
+        "memory": {
+            "peak_rss_mib": _peak_rss_mib(),
+            "peak_granted_mib": core.memory_peak_granted() / (1024.0 * 1024.0)
+        },
+        "host": platform.node(),
+        "version": core.version(),
+        "git": core.git_version(),
+    }
+
+    for phase, timing in sorted(phases.items()):
+        core.emit_event("perf_phase", {"wall": timing["wall"], "calls": timing["calls"]}, {"case": case, "phase": phase})
+    values = {"wall": wall, "energy": E, "nthreads": nthreads}
+    values.update(result["memory"])
+    core.emit_event("perf_benchmark", values, {"case": case, "method": method, "molecule": molname})
+
+    core.print_out("\n  ==> Performance: %s (%s on %s, %d threads) <==\n\n" % (case, method, molname, nthreads))
+    core.print_out("    %-50s %12.3f s\n" % ("Total", wall))
+    for phase, timing in sorted(phases.items(), key=lambda item: -item[1]["wall"]):
+        core.print_out("    %-50s %12.3f s %8d calls%s\n" % (phase[:50], timing["wall"], timing["calls"],
+                                                            "" if timing["serial"] else " (summed)"))
+    core.print_out("    %-50s %12.1f MiB\n" % ("Peak RSS", result["memory"]["peak_rss_mib"]))
+    core.print_out("    %-50s %12.1f MiB\n\n" % ("Peak module grants", result["memory"]["peak_granted_mib"]))
+
+    if filename is not None:
+        with open(filename, "w") as handle:
+            json.dump(result, handle, indent=2, sort_keys=True)
+
+    baseline = _load_baseline(baseline)
+    if baseline is not None and case in baseline:
+        regressions = _regressions(result, baseline[case], tolerance)
+        if regressions:
+            raise TestComparisonError("Performance regression:\n    " + "\n    ".join(regressions))
+
+    return result
+
+
+def perf_suite(cases=None, nthreads=4, filename="perf.json", baseline=None, tolerance=None):
+    """
+    Runs the performance suite, writing all results as JSON by case; that file can serve as
+    the baseline of later runs. See ``perf_benchmark`` for the parameters.
+
+    Returns
+    -------
+    dict
+        Results by case.
+
+    Raises
+    ------
+    TestComparisonError
+        After all cases have run, if any is slower than the baseline.
+
+    Example
+    -------
+
+    >>> psi4.perf_suite(filename="perf.json")
+    >>> psi4.perf_suite(filename="new.json", baseline="perf.json")
+
+    """
+    baseline = _load_baseline(baseline)
+    results = {}
+    regressions = []
+    for case in (cases if cases is not None else list(_perf_cases.keys())):
+        try:
+            results[case] = perf_benchmark(case, nthreads=nthreads, baseline=baseline, tolerance=tolerance)
+        except TestComparisonError as error:
+            regressions.append(str(error))
+
+    if filename is not None:
+        with open(filename, "w") as handle:
+            json.dump(results, handle, indent=2, sort_keys=True)
+    if regressions:
+        raise TestComparisonError("\n".join(regressions))
+
+    return results
+
+
+def _time_calls(func, min_time):
+    """Seconds per call of `func`, repeated until `min_time` has elapsed (after one warm-up call)."""
+    func()
+    rounds = 0
+    start = time.time()
+    elapsed = 0.0
+    while elapsed < min_time:
+        func()
+        rounds += 1
+        elapsed = time.time() - start
+    return elapsed / rounds
+
+
+def benchmark_suite(filename="benchmark.json", max_am=2, min_time=0.1, basis="CC-PVDZ", molecules=None,
+                    jk_types=("PK", "DIRECT", "DISK_DF", "MEM_DF", "CD")):
+    """
+    Times the integral backends and JK engines on this machine and writes the results as JSON,
+    so runs on different hardware or builds can be compared directly.
+
+    Parameters
+    ----------
+    filename : str, optional
+        JSON file to write; None only returns the results.
+    max_am : int, optional
+        Highest angular momentum for the per-shell integral timings, at most 5 (h, from Ne cc-pV5Z).
+    min_time : float, optional
+        Minimum time [s] spent on each timed quantity.
+    basis : str, optional
+        Orbital basis for the JK timings.
+    molecules : list of str, optional
+        Subset of the canonical molecules (water, benzene) to run the JK engines on.
+    jk_types : iterable of str, optional
+        SCF_TYPE values of the JK engines to time.
+
+    Returns
+    -------
+    dict
+        Timings in seconds: per integral for "integrals", per ECP matrix for "ECP",
+        and per initialize/compute call for "JK".
+
+    Example
+    -------
+
+    >>> psi4.benchmark_suite("bench.json", max_am=3, molecules=["water"])
+
+    """
+    results = {
+        "host": platform.node(),
+        "version": core.version(),
+        "git": core.git_version(),
+        "nthreads": core.get_num_threads(),
+    }
+
+    # => Per-shell integrals and the Boys function, for every compiled-in backend <= #
+    intmol = core.Molecule.from_string(_integral_molecule)
+    intbasis = core.BasisSet.build(intmol, "ORBITAL", "CC-PV5Z", quiet=True)
+    results["integrals"] = json.loads(core.benchmark_integrals_json(intbasis, max_am, min_time))
+
+    # => ECP integrals <= #
+    ecpmol = core.Molecule.from_string(_ecp_molecule)
+    ecpbasis = core.BasisSet.build(ecpmol, "ORBITAL", "DEF2-SVP", quiet=True)
+    if ecpbasis.n_ecp_core() > 0:
+        mints = core.MintsHelper(ecpbasis)
+        results["ECP"] = {"I2/def2-SVP": _time_calls(mints.ao_ecp, min_time)}
+
+    # => JK engines <= #
+    names = molecules if molecules is not None else list(_benchmark_molecules.keys())
+    rng = np.random.RandomState(0)
+    results["JK"] = {}
+    for name in names:
+        mol = core.Molecule.from_string(_benchmark_molecules[name])
+        mol.update_geometry()
+        primary = core.BasisSet.build(mol, "ORBITAL", basis, quiet=True)
+        nocc = sum(mol.Z(A) for A in range(mol.natom())) // 2
+        Cocc = core.Matrix.from_array(rng.rand(primary.nbf(), int(nocc)))
+
+        timings = {}
+        for jk_type in jk_types:
+            start = time.time()
+            jk = core.JK.build(primary, jk_type=jk_type)
+            jk.set_memory(int(core.get_memory() * 0.8 / 8))
+            jk.initialize()
+            init = time.time() - start
+
+            jk.C_left_add(Cocc)
+            timings[jk_type] = {"initialize": init, "compute": _time_calls(jk.compute, min_time)}
+            jk.C_clear()
+            jk.finalize()
+        results["JK"][name + "/" + basis] = timings
+
+    if filename is not None:
+        with open(filename, "w") as handle:
+            json.dump(results, handle, indent=2, sort_keys=True)
+
+    return results
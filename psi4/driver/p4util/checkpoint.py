@@ -0,0 +1,205 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2018 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""Module with the binary wavefunction checkpoint: a NumPy zip archive, one
+member per irrep block, that can be written in the background and read back
+one array at a time."""
+from __future__ import absolute_import
+
+import atexit
+import os
+import threading
+
+import numpy as np
+
+from psi4 import core
+from .exceptions import ValidationError
+
+__all__ = ["write_wfn_checkpoint", "wait_for_wfn_checkpoint", "WavefunctionCheckpoint"]
+
+_schema = "psi4-wfn-checkpoint"
+_version = 1
+
+# Everything an SCF guess needs; written to the file 180 guess as well
+_guess_arrays = ("Ca", "Cb", "Ca_occ", "Cb_occ")
+_all_arrays = _guess_arrays + ("epsilon_a", "epsilon_b", "Da", "Db", "Fa", "Fb")
+
+# Background writes still running, by absolute path
+_pending = {}
+_pending_lock = threading.Lock()
+
+
+def _wfn_array(wfn, name):
+    if name == "Ca_occ":
+        return wfn.Ca_subset("SO", "OCC")
+    if name == "Cb_occ":
+        return wfn.Cb_subset("SO", "OCC")
+    return getattr(wfn, name)()
+
+
+def _savez(filename, data):
+    # Write under a temporary name so that a reader never sees a partial file
+    tmpname = filename + ".tmp"
+    with open(tmpname, "wb") as handle:
+        np.savez(handle, **data)
+    # os.replace is Python 3 only; os.rename also replaces on POSIX
+    getattr(os, "replace", os.rename)(tmpname, filename)
+
+
+def write_wfn_checkpoint(wfn, filename, arrays=None, background=False):
+    """Writes the orbitals, orbital energies, densities and Fock matrices of
+    *wfn*, with the metadata needed to reuse them as a guess, to *filename*.
+
+    :type wfn: :py:class:`~psi4.core.Wavefunction`
+    :param wfn: Wavefunction to save; it is snapshotted before returning.
+
+    :type filename: str
+    :param filename: Checkpoint file; replaced atomically once complete.
+
+    :type arrays: tuple of str
+    :param arrays: Subset of ``Ca``, ``Cb``, ``Ca_occ``, ``Cb_occ``,
+        ``epsilon_a``, ``epsilon_b``, ``Da``, ``Db``, ``Fa`` and ``Fb`` to
+        write; all of them by default.
+
+    :type background: bool
+    :param background: Write from a background thread and return at once.
+        :py:class:`WavefunctionCheckpoint` waits for a pending write of the
+        file it opens; :py:func:`wait_for_wfn_checkpoint` waits explicitly.
+
+    """
+    if arrays is None:
+        arrays = _all_arrays
+    unknown = set(arrays) - set(_all_arrays)
+    if unknown:
+        raise ValidationError("write_wfn_checkpoint: unknown arrays %s." % ", ".join(sorted(unknown)))
+
+    mol = wfn.molecule()
+    basis = wfn.basisset()
+    data = {}
+    data["schema"] = _schema
+    data["version"] = _version
+    data["arrays"] = list(arrays)
+    for name in arrays:
+        # Without a filename np_write returns copies, so the wavefunction may change while this is written
+        data.update(_wfn_array(wfn, name).np_write(None, prefix=name))
+
+    data["reference"] = core.get_option('SCF', 'REFERENCE')
+    data["energy"] = wfn.energy()
+    data["nsoccpi"] = wfn.soccpi().to_tuple()
+    data["ndoccpi"] = wfn.doccpi().to_tuple()
+    data["nalphapi"] = wfn.nalphapi().to_tuple()
+    data["nbetapi"] = wfn.nbetapi().to_tuple()
+    data["nsopi"] = wfn.nsopi().to_tuple()
+    data["nmopi"] = wfn.nmopi().to_tuple()
+    data["symmetry"] = mol.schoenflies_symbol()
+    data["molecule"] = mol.create_psi4_string_from_molecule()
+    data["BasisSet"] = basis.name()
+    data["BasisSet PUREAM"] = basis.has_puream()
+
+    filename = os.path.abspath(filename)
+    wait_for_wfn_checkpoint(filename)
+    if not background:
+        _savez(filename, data)
+        return
+
+    thread = threading.Thread(target=_savez, args=(filename, data), name="wfn checkpoint")
+    with _pending_lock:
+        _pending[filename] = thread
+    thread.start()
+
+
+def wait_for_wfn_checkpoint(filename=None):
+    """Waits for the background write of *filename*, or of every checkpoint
+    if *filename* is None, to complete."""
+    with _pending_lock:
+        if filename is None:
+            threads = list(_pending.values())
+            _pending.clear()
+        else:
+            thread = _pending.pop(os.path.abspath(filename), None)
+            threads = [thread] if thread else []
+    for thread in threads:
+        thread.join()
+
+
+atexit.register(wait_for_wfn_checkpoint)
+
+
+class WavefunctionCheckpoint(object):
+    """Read access to a wavefunction checkpoint or file 180 guess.
+
+    Only the members asked for are read from the file, so taking the
+    occupied orbitals of a large checkpoint does not load its densities.
+    Usable as a context manager.
+
+    """
+
+    def __init__(self, filename):
+        wait_for_wfn_checkpoint(filename)
+        self.filename = filename
+        self._data = np.load(filename)
+        if "schema" in self._data.keys():
+            if str(self._data["schema"]) != _schema or int(self._data["version"]) > _version:
+                self._data.close()
+                raise ValidationError("WavefunctionCheckpoint: %s is not a version %d wavefunction checkpoint." %
+                                      (filename, _version))
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def close(self):
+        self._data.close()
+
+    def __contains__(self, name):
+        return (name in self._data.keys()) or ((name + "Irreps") in self._data.keys())
+
+    def __getitem__(self, name):
+        """Metadata entry *name* as stored, e.g. ``str(ckpt["symmetry"])``."""
+        return self._data[name]
+
+    def arrays(self):
+        """Names of the matrices and vectors in the checkpoint."""
+        return [key[:-len("Irreps")] for key in self._data.keys() if key.endswith("Irreps")]
+
+    def matrix(self, name):
+        """Reads the :py:class:`~psi4.core.Matrix` *name*, e.g. ``Ca``."""
+        if name not in self:
+            raise ValidationError("WavefunctionCheckpoint: %s has no matrix %s." % (self.filename, name))
+        return core.Matrix.np_read(self._data, prefix=name)
+
+    def vector(self, name):
+        """Reads the :py:class:`~psi4.core.Vector` *name*, e.g. ``epsilon_a``."""
+        if name not in self:
+            raise ValidationError("WavefunctionCheckpoint: %s has no vector %s." % (self.filename, name))
+        return core.Vector.np_read(self._data, prefix=name)
+
+    def dimension(self, name):
+        """Reads the per-irrep count *name*, e.g. ``nalphapi``, as a :py:class:`~psi4.core.Dimension`."""
+        return core.Dimension.from_list(self._data[name])
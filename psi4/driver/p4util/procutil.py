@@ -432,3 +432,36 @@ def expand_psivars(pvdefs):
             core.set_variable(pvar, result)
             if verbose >= 2:
                 print("""SUCCESS""")
+
+
+def run_psi4_inputs(jobs, nworkers=1, command=None):
+    """Function to run independent psi4 input files (*jobs*, a list of
+    (input, output) file name pairs) with a pool of *nworkers* concurrent
+    processes. Each job is started by *command*, a template with ``{input}``,
+    ``{output}`` and ``{nthreads}`` fields; the default launches a local
+    psi4 process, while a queue submission that blocks until the job
+    finishes (e.g., ``sbatch --wait ...``) runs the jobs on a cluster. The
+    threads of this job are divided between the workers. Returns the exit
+    status of each job in order.
+
+    """
+    import subprocess
+    import multiprocessing.pool
+
+    nworkers = max(1, min(int(nworkers), len(jobs)))
+    nthreads = max(1, core.get_num_threads() // nworkers)
+    if command is None:
+        command = 'psi4 -n {nthreads} -i {input} -o {output}'
+
+    def run_one(job):
+        return subprocess.call(command.format(input=job[0], output=job[1], nthreads=nthreads), shell=True)
+
+    if not jobs:
+        return []
+
+    pool = multiprocessing.pool.ThreadPool(nworkers)
+    try:
+        return pool.map(run_one, jobs, chunksize=1)
+    finally:
+        pool.close()
+        pool.join()
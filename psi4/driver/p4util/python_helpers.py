@@ -359,7 +359,8 @@ def basis_helper(block, name='', key='BASIS', set_option=True):
 
 
 core.OEProp.valid_methods = [
-    'DIPOLE', 'QUADRUPOLE', 'MULLIKEN_CHARGES', 'LOWDIN_CHARGES', 'WIBERG_LOWDIN_INDICES', 'MAYER_INDICES',
+    'DIPOLE', 'QUADRUPOLE', 'MULLIKEN_CHARGES', 'LOWDIN_CHARGES', 'CHELPG_CHARGES', 'MK_CHARGES', 'RESP_CHARGES',
+    'WIBERG_LOWDIN_INDICES', 'MAYER_INDICES',
     'MAYER_INDICES', 'MO_EXTENTS', 'GRID_FIELD', 'GRID_ESP', 'ESP_AT_NUCLEI', 'NO_OCCUPATIONS'
 ]
 
@@ -101,6 +101,45 @@ def cubeprop(wfn, **kwargs):
     cp.compute_properties()
 
 
+def read_bcube(filename):
+    """Reads a binary cube file written with |globals__cubeprop_file_type|
+    ``BCUBE``.
+
+    :returns: dict with keys ``title`` (str), ``origin`` and ``spacing``
+        (length-3 arrays, bohr), ``atoms`` (list of (Z, xyz) tuples) and
+        ``data``, a float32 array of shape (nx, ny, nz) in cube (x, y, z)
+        order
+
+    """
+    with open(filename, 'rb') as handle:
+        raw = handle.read()
+
+    if raw[:8] != b'PSI4CUBE':
+        raise ValidationError('read_bcube: %s is not a binary cube file.' % filename)
+    version, ntitle = np.frombuffer(raw, dtype=np.int32, count=2, offset=8)
+    if version != 1:
+        raise ValidationError('read_bcube: %s has unknown version %d.' % (filename, version))
+    offset = 16
+    title = raw[offset:offset + ntitle].decode()
+    offset += ntitle
+    natom = int(np.frombuffer(raw, dtype=np.int32, count=1, offset=offset)[0])
+    npts = np.frombuffer(raw, dtype=np.int32, count=3, offset=offset + 4)
+    origin = np.frombuffer(raw, dtype=np.float64, count=3, offset=offset + 16)
+    spacing = np.frombuffer(raw, dtype=np.float64, count=3, offset=offset + 40)
+    offset += 64
+
+    atoms = []
+    for A in range(natom):
+        Z = int(np.frombuffer(raw, dtype=np.int32, count=1, offset=offset)[0])
+        xyz = np.frombuffer(raw, dtype=np.float64, count=3, offset=offset + 4)
+        atoms.append((Z, xyz))
+        offset += 28
+
+    data = np.frombuffer(raw, dtype=np.float32, count=int(np.prod(npts)), offset=offset)
+    return {'title': title, 'origin': origin, 'spacing': spacing, 'atoms': atoms,
+            'data': data.reshape(tuple(npts))}
+
+
 def set_memory(inputval, execute=True):
     """Function to reset the total memory allocation. Takes memory value
     *inputval* as type int, float, or str; int and float are taken literally
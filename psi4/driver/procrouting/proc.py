@@ -42,6 +42,7 @@ import numpy as np
 from psi4 import extras
 from psi4.driver import p4util
 from psi4.driver import qcdb
+from psi4.driver.qcdb.bfs import BFS
 from psi4.driver import constants
 from psi4.driver.p4util.exceptions import *
 from psi4.driver.molutil import *
@@ -53,6 +54,7 @@ from . import empirical_dispersion
 from . import dft_funcs
 from . import mcscf
 from . import response
+from .scf_proc import guess_extrapolation
 
 
 # ATTN NEW ADDITIONS!
@@ -987,6 +989,60 @@ def select_mp4(name, **kwargs):
         return func(name, **kwargs)
 
 
+def _frag_guess_basissets(wfn):
+    """Builds the per-fragment orbital (and SAD fitting) bases for GUESS FRAG.
+
+    Fragments are those of the molecule when it has more than one Real fragment,
+    otherwise the covalently bonded groups detected by :py:func:`qcdb.bfs.BFS`,
+    which are taken as neutral.
+    """
+    mol = wfn.molecule()
+    geom = np.asarray(mol.geometry())
+    real = [at for at in range(mol.natom()) if mol.Z(at) > 0]
+
+    frags = []
+    frag_types = mol.get_fragment_types()
+    if len([ft for ft in frag_types if ft == "Real"]) > 1:
+        charges = mol.get_fragment_charges()
+        mults = mol.get_fragment_multiplicities()
+        for ifr, (start, stop) in enumerate(mol.get_fragments()):
+            if frag_types[ifr] != "Real":
+                continue
+            atoms = [at for at in range(start, stop) if mol.Z(at) > 0]
+            frags.append((atoms, charges[ifr], mults[ifr]))
+    else:
+        elez = [int(mol.Z(at)) for at in real]
+        for bfrag in BFS(geom[real], np.array(elez)):
+            atoms = sorted(real[at] for at in bfrag)
+            nel = sum(int(mol.Z(at)) for at in atoms)
+            frags.append((atoms, 0, 1 + nel % 2))
+
+    frag_bases = []
+    frag_fit_bases = []
+    frag_atoms = []
+    for atoms, charge, mult in frags:
+        if not atoms:
+            continue
+        fmol = core.Molecule.from_arrays(geom=geom[atoms],
+                                         elez=[int(mol.Z(at)) for at in atoms],
+                                         mass=[mol.mass(at) for at in atoms],
+                                         units='Bohr',
+                                         molecular_charge=charge,
+                                         molecular_multiplicity=mult,
+                                         fix_com=True,
+                                         fix_orientation=True,
+                                         fix_symmetry='c1')
+        fmol.update_geometry()
+        frag_bases.append(core.BasisSet.build(fmol, "ORBITAL", core.get_global_option("BASIS"),
+                                              puream=wfn.basisset().has_puream()))
+        if ("DF" in core.get_option("SCF", "SAD_SCF_TYPE")):
+            frag_fit_bases.append(core.BasisSet.build(fmol, "DF_BASIS_SAD", core.get_option("SCF", "DF_BASIS_SAD"),
+                                                      puream=True))
+        frag_atoms.append(atoms)
+
+    return frag_bases, frag_fit_bases, frag_atoms
+
+
 def scf_wavefunction_factory(name, ref_wfn, reference):
     """Builds the correct wavefunction from the provided information
     """
@@ -1025,7 +1081,7 @@ def scf_wavefunction_factory(name, ref_wfn, reference):
             del wfn._disp_functor
 
     # Set the DF basis sets
-    if ("DF" in core.get_global_option("SCF_TYPE")) or \
+    if ("DF" in core.get_global_option("SCF_TYPE")) or (core.get_global_option("SCF_TYPE") in ["COSX", "PS"]) or \
        (core.get_option("SCF", "DF_SCF_GUESS") and (core.get_global_option("SCF_TYPE") == "DIRECT")):
         aux_basis = core.BasisSet.build(wfn.molecule(), "DF_BASIS_SCF",
                                         core.get_option("SCF", "DF_BASIS_SCF"),
@@ -1044,7 +1100,7 @@ def scf_wavefunction_factory(name, ref_wfn, reference):
         wfn.set_basisset("BASIS_RELATIVISTIC", decon_basis)
 
     # Set the multitude of SAD basis sets
-    if (core.get_option("SCF", "GUESS") == "SAD"):
+    if (core.get_option("SCF", "GUESS") in ["SAD", "FRAG"]):
         sad_basis_list = core.BasisSet.build(wfn.molecule(), "ORBITAL",
                                              core.get_global_option("BASIS"),
                                              puream=wfn.basisset().has_puream(),
@@ -1062,6 +1118,14 @@ def scf_wavefunction_factory(name, ref_wfn, reference):
             wfn.set_sad_fitting_basissets(sad_fitting_list)
             optstash.restore()
 
+    if (core.get_option("SCF", "GUESS") == "FRAG"):
+        optstash = p4util.OptionsState(['PUREAM'])
+        core.set_global_option('PUREAM', True)
+        frag_bases, frag_fit_bases, frag_atoms = _frag_guess_basissets(wfn)
+        optstash.restore()
+        wfn.set_frag_basissets(frag_bases, frag_atoms)
+        wfn.set_frag_fitting_basissets(frag_fit_bases)
+
     # Deal with the EXTERN issues
     if hasattr(core, "EXTERN"):
         wfn.set_external_potential(core.EXTERN)
@@ -1069,6 +1133,20 @@ def scf_wavefunction_factory(name, ref_wfn, reference):
     return wfn
 
 
+def _scf_wfn_checkpoint_file(molecule):
+    """Path of the wavefunction checkpoint, |scf__wfn_checkpoint_file| or else in the working directory."""
+    filename = core.get_option("SCF", "WFN_CHECKPOINT_FILE")
+    if not filename:
+        filename = core.get_writer_file_prefix(molecule.name()) + ".wfn.npz"
+    return filename
+
+
+def _guess_file_label(filename):
+    if filename.endswith(".180.npz"):
+        return "file 180"
+    return os.path.basename(filename)
+
+
 def scf_helper(name, post_scf=True, **kwargs):
     """Function serving as helper to SCF, choosing whether to cast
     up or just run SCF with a standard guess. This preserves
@@ -1274,11 +1352,17 @@ def scf_helper(name, post_scf=True, **kwargs):
     fname = os.path.split(os.path.abspath(core.get_writer_file_prefix(scf_molecule.name())))[1]
     psi_scratch = core.IOManager.shared_object().get_default_path()
     read_filename = os.path.join(psi_scratch, fname + ".180.npz")
+    checkpoint_filename = _scf_wfn_checkpoint_file(scf_molecule)
+    if core.get_option('SCF', 'GUESS') == 'READ' and core.has_option_changed('SCF', 'WFN_CHECKPOINT_FILE'):
+        p4util.wait_for_wfn_checkpoint(checkpoint_filename)
+        if os.path.isfile(checkpoint_filename):
+            read_filename = checkpoint_filename
 
     if (core.get_option('SCF', 'GUESS') == 'READ') and os.path.isfile(read_filename):
-        data = np.load(read_filename)
-        Ca_occ = core.Matrix.np_read(data, "Ca_occ")
-        Cb_occ = core.Matrix.np_read(data, "Cb_occ")
+        # Only the occupied orbitals and the metadata are read from the file
+        data = p4util.WavefunctionCheckpoint(read_filename)
+        Ca_occ = data.matrix("Ca_occ")
+        Cb_occ = data.matrix("Cb_occ")
         symmetry = str(data["symmetry"])
         basis_name = str(data["BasisSet"])
 
@@ -1286,11 +1370,11 @@ def scf_helper(name, post_scf=True, **kwargs):
             raise ValidationError("Cannot compute projection of different symmetries.")
 
         if basis_name == scf_wfn.basisset().name():
-            core.print_out("  Reading orbitals from file 180, no projection.\n\n")
+            core.print_out("  Reading orbitals from %s, no projection.\n\n" % _guess_file_label(read_filename))
             scf_wfn.guess_Ca(Ca_occ)
             scf_wfn.guess_Cb(Cb_occ)
         else:
-            core.print_out("  Reading orbitals from file 180, projecting to new basis.\n\n")
+            core.print_out("  Reading orbitals from %s, projecting to new basis.\n\n" % _guess_file_label(read_filename))
 
             puream = int(data["BasisSet PUREAM"])
 
@@ -1300,8 +1384,8 @@ def scf_helper(name, post_scf=True, **kwargs):
             old_basis = core.BasisSet.build(scf_molecule, "ORBITAL", basis_name, puream=puream)
             core.print_out("  Computing basis projection from %s to %s\n\n" % (basis_name, base_wfn.basisset().name()))
 
-            nalphapi = core.Dimension.from_list(data["nalphapi"])
-            nbetapi = core.Dimension.from_list(data["nbetapi"])
+            nalphapi = data.dimension("nalphapi")
+            nbetapi = data.dimension("nbetapi")
             pCa = scf_wfn.basis_projection(Ca_occ, nalphapi, old_basis, base_wfn.basisset())
             pCb = scf_wfn.basis_projection(Cb_occ, nbetapi, old_basis, base_wfn.basisset())
             scf_wfn.guess_Ca(pCa)
@@ -1312,6 +1396,7 @@ def scf_helper(name, post_scf=True, **kwargs):
         new_ref = core.get_option('SCF', 'REFERENCE').replace("KS", "").replace("HF", "")
         if old_ref != new_ref:
             scf_wfn.reset_occ_ = True
+        data.close()
 
 
     elif (core.get_option('SCF', 'GUESS') == 'READ') and not os.path.isfile(read_filename):
@@ -1331,6 +1416,12 @@ def scf_helper(name, post_scf=True, **kwargs):
             scf_wfn.set_sad_fitting_basissets(sad_fitting_list)
 
 
+    if not cast:
+        extrapolated = guess_extrapolation.predict(scf_wfn)
+        if extrapolated is not None:
+            scf_wfn.guess_Ca(extrapolated[0])
+            scf_wfn.guess_Cb(extrapolated[1])
+
     if cast:
         core.print_out("\n  Computing basis projection from %s to %s\n\n" % (ref_wfn.basisset().name(), base_wfn.basisset().name()))
         pCa = ref_wfn.basis_projection(ref_wfn.Ca(), ref_wfn.nalphapi(), ref_wfn.basisset(), scf_wfn.basisset())
@@ -1393,27 +1484,13 @@ def scf_helper(name, post_scf=True, **kwargs):
     # Write out orbitals and basis
     fname = os.path.split(os.path.abspath(core.get_writer_file_prefix(scf_molecule.name())))[1]
     write_filename = os.path.join(psi_scratch, fname + ".180.npz")
-    data = {}
-    data.update(scf_wfn.Ca().np_write(None, prefix="Ca"))
-    data.update(scf_wfn.Cb().np_write(None, prefix="Cb"))
-
-    Ca_occ = scf_wfn.Ca_subset("SO", "OCC")
-    data.update(Ca_occ.np_write(None, prefix="Ca_occ"))
-
-    Cb_occ = scf_wfn.Cb_subset("SO", "OCC")
-    data.update(Cb_occ.np_write(None, prefix="Cb_occ"))
-
-    data["reference"] = core.get_option('SCF', 'REFERENCE')
-    data["nsoccpi"] = scf_wfn.soccpi().to_tuple()
-    data["ndoccpi"] = scf_wfn.doccpi().to_tuple()
-    data["nalphapi"] = scf_wfn.nalphapi().to_tuple()
-    data["nbetapi"] = scf_wfn.nbetapi().to_tuple()
-    data["symmetry"] = scf_molecule.schoenflies_symbol()
-    data["BasisSet"] = scf_wfn.basisset().name()
-    data["BasisSet PUREAM"] = scf_wfn.basisset().has_puream()
-    np.savez(write_filename, **data)
+    p4util.write_wfn_checkpoint(scf_wfn, write_filename, arrays=("Ca", "Cb", "Ca_occ", "Cb_occ"))
     extras.register_numpy_file(write_filename)
 
+    # Write out the full wavefunction checkpoint, while the caller carries on
+    if core.get_option("SCF", "WFN_CHECKPOINT"):
+        p4util.write_wfn_checkpoint(scf_wfn, _scf_wfn_checkpoint_file(scf_molecule), background=True)
+
     if do_timer:
         core.tstop()
 
@@ -1585,7 +1662,7 @@ def run_dfocc(name, **kwargs):
     # Bypass the scf call if a reference wavefunction is given
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
-        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
     else:
         if ref_wfn.molecule().schoenflies_symbol() != 'c1':
             raise ValidationError("""  DFOCC does not make use of molecular symmetry: """
@@ -1663,7 +1740,7 @@ def run_dfocc_gradient(name, **kwargs):
     # Bypass the scf call if a reference wavefunction is given
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
-        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
     else:
         if ref_wfn.molecule().schoenflies_symbol() != 'c1':
             raise ValidationError("""  DFOCC does not make use of molecular symmetry: """
@@ -1720,7 +1797,7 @@ def run_dfocc_property(name, **kwargs):
     # Bypass the scf call if a reference wavefunction is given
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
-        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
     else:
         if ref_wfn.molecule().schoenflies_symbol() != 'c1':
             raise ValidationError("""  DFOCC does not make use of molecular symmetry: """
@@ -1773,7 +1850,7 @@ def run_qchf(name, **kwargs):
     # Bypass the scf call if a reference wavefunction is given
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
-        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
     else:
         if ref_wfn.molecule().schoenflies_symbol() != 'c1':
             raise ValidationError("""  QCHF does not make use of molecular symmetry: """
@@ -2133,10 +2210,14 @@ def run_scf_hessian(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = run_scf(name, **kwargs)
 
-    badref = core.get_option('SCF', 'REFERENCE') in ['UHF', 'ROHF', 'CUHF', 'RKS', 'UKS']
+    badref = core.get_option('SCF', 'REFERENCE') in ['UHF', 'ROHF', 'CUHF', 'UKS']
     badint = core.get_global_option('SCF_TYPE') in [ 'CD', 'OUT_OF_CORE']
     if badref or badint:
-        raise ValidationError("Only RHF Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+        raise ValidationError("Only RHF and RKS Hessians are currently implemented. SCF_TYPE either CD or OUT_OF_CORE not supported")
+
+    ssuper = ref_wfn.functional()
+    if ssuper.needs_xc() and (ssuper.is_gga() or ssuper.is_meta() or ssuper.is_x_lrc() or ssuper.needs_vv10()):
+        raise ValidationError("Analytic RKS Hessians are only implemented for LSDA functionals.")
 
     if hasattr(ref_wfn, "_disp_functor"):
         disp_hess = ref_wfn._disp_functor.compute_hessian(ref_wfn.molecule())
@@ -2943,8 +3024,16 @@ def run_adc(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = scf_helper(name, **kwargs)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+    if core.get_option('ADC', 'ADC_TYPE') == 'DF':
+        core.print_out("  Constructing Basis Sets for ADC...\n\n")
+        aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_ADC",
+                                        core.get_option("ADC", "DF_BASIS_ADC"),
+                                        "RIFIT", core.get_global_option("BASIS"),
+                                        puream=ref_wfn.basisset().has_puream())
+        ref_wfn.set_basisset("DF_BASIS_ADC", aux_basis)
+    else:
+        # Ensure IWL files have been written
+        proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
 
     return core.adc(ref_wfn)
 
@@ -3105,6 +3194,54 @@ def run_dfmp2(name, **kwargs):
     core.tstop()
     return dfmp2_wfn
 
+def run_dfmp2_f12(name, **kwargs):
+    """Function encoding sequence of PSI module calls for
+    a density-fitted MP2-F12/3C(FIX) calculation.
+
+    """
+    optstash = p4util.OptionsState(
+        ['DF_BASIS_MP2'],
+        ['DFMP2', 'CABS_BASIS'],
+        ['SCF_TYPE'])
+
+    # Alter default algorithm
+    if not core.has_global_option_changed('SCF_TYPE'):
+        core.set_global_option('SCF_TYPE', 'DF')
+        core.print_out("""    SCF Algorithm Type (re)set to DF.\n""")
+
+    # Bypass the scf call if a reference wavefunction is given
+    ref_wfn = kwargs.get('ref_wfn', None)
+    if ref_wfn is None:
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
+
+    if core.get_global_option('REFERENCE') != "RHF":
+        raise ValidationError("""MP2-F12 is only available for RHF references.""")
+
+    core.tstart()
+    core.print_out('\n')
+    p4util.banner('DFMP2-F12')
+    core.print_out('\n')
+
+    aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_MP2",
+                                    core.get_option("DFMP2", "DF_BASIS_MP2"),
+                                    "RIFIT", core.get_global_option('BASIS'))
+    ref_wfn.set_basisset("DF_BASIS_MP2", aux_basis)
+
+    # The CABS defaults to the OptRI partner of the orbital basis
+    cabs_name = core.get_option("DFMP2", "CABS_BASIS")
+    if cabs_name == '':
+        cabs_name = core.get_global_option('BASIS') + '-optri'
+    cabs_basis = core.BasisSet.build(ref_wfn.molecule(), "CABS_BASIS", cabs_name,
+                                     "F12", core.get_global_option('BASIS'))
+    ref_wfn.set_basisset("CABS_BASIS", cabs_basis)
+
+    dfmp2_wfn = core.dfmp2_f12(ref_wfn)
+    dfmp2_wfn.compute_energy()
+
+    optstash.restore()
+    core.tstop()
+    return dfmp2_wfn
+
 def run_dfep2(name, **kwargs):
     """Function encoding sequence of PSI module calls for
     a density-fitted MP2 calculation.
@@ -3216,6 +3353,31 @@ def run_dfep2(name, **kwargs):
     return dfep2_wfn
 
 
+def dmrg_integrals(ref_wfn):
+    """Prepares the integrals needed by the DMRG module: the JKFIT basis
+    and the one-electron integrals for DMRG_SCF_TYPE DF, the IWL file otherwise.
+
+    """
+    if core.get_option('DMRG', 'DMRG_SCF_TYPE') == 'DF':
+        scf_aux_basis = core.BasisSet.build(ref_wfn.molecule(), "DF_BASIS_SCF",
+                                            core.get_option("SCF", "DF_BASIS_SCF"),
+                                            "JKFIT", core.get_global_option('BASIS'),
+                                            puream=ref_wfn.basisset().has_puream())
+        ref_wfn.set_basisset("DF_BASIS_SCF", scf_aux_basis)
+
+        mints = core.MintsHelper(ref_wfn.basisset())
+        if core.get_global_option("RELATIVISTIC") in ["X2C", "DKH"]:
+            rel_bas = core.BasisSet.build(ref_wfn.molecule(), "BASIS_RELATIVISTIC",
+                                          core.get_option("SCF", "BASIS_RELATIVISTIC"),
+                                          "DECON", core.get_global_option('BASIS'),
+                                          puream=ref_wfn.basisset().has_puream())
+            mints.set_rel_basisset(rel_bas)
+        mints.one_electron_integrals()
+    else:
+        # Ensure IWL files have been written
+        proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+
+
 def run_dmrgscf(name, **kwargs):
     """Function encoding sequence of PSI module calls for
     an DMRG calculation.
@@ -3230,8 +3392,7 @@ def run_dmrgscf(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = scf_helper(name, **kwargs)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+    dmrg_integrals(ref_wfn)
 
     if 'CASPT2' in name.upper():
         core.set_local_option("DMRG", "DMRG_CASPT2_CALC", True)
@@ -3256,8 +3417,7 @@ def run_dmrgci(name, **kwargs):
     if ref_wfn is None:
         ref_wfn = scf_helper(name, **kwargs)
 
-    # Ensure IWL files have been written
-    proc_util.check_iwl_file_from_scf_type(core.get_global_option('SCF_TYPE'), ref_wfn)
+    dmrg_integrals(ref_wfn)
 
     core.set_local_option('DMRG', 'DMRG_SCF_MAX_ITER', 1)
 
@@ -3317,6 +3477,12 @@ def run_sapt(name, **kwargs):
 
     sapt_dimer, monomerA, monomerB = proc_util.prepare_sapt_molecule(sapt_dimer, sapt_basis)
 
+    # Screening many B's against one A: keep monomer A's SCF between calls.
+    # Only valid in the monomer basis, in the dimer basis A sees B's ghost functions.
+    reuse_monomerA = kwargs.pop('reuse_monomerA', False)
+    if reuse_monomerA and (sapt_basis != 'monomer'):
+        raise ValidationError("SAPT: reuse_monomerA requires sapt_basis='monomer'.")
+
     if (core.get_option('SCF', 'REFERENCE') != 'RHF') and (name.upper() != "SAPT0"):
         raise ValidationError('Only SAPT0 supports a reference different from \"reference rhf\".')
 
@@ -3353,10 +3519,21 @@ def run_sapt(name, **kwargs):
     core.print_out('\n')
     p4util.banner('Monomer A HF')
     core.print_out('\n')
-    monomerA_wfn = scf_helper('RHF', molecule=monomerA, **kwargs)
+    monomerA_key = proc_util.sapt_monomer_key(monomerA) if reuse_monomerA else None
+    cached = proc_util.get_sapt_monomer(monomerA_key) if reuse_monomerA else None
+    if cached is not None:
+        core.print_out('  Reusing the monomer A wavefunction of a previous SAPT computation.\n')
+        monomerA_wfn, monomerA_mp2 = cached
+    else:
+        monomerA_wfn = scf_helper('RHF', molecule=monomerA, **kwargs)
+        monomerA_mp2 = None
     if do_delta_mp2:
-        select_mp2(name, ref_wfn=monomerA_wfn, **kwargs)
-        mp2_corl_interaction_e -= core.get_variable('MP2 CORRELATION ENERGY')
+        if monomerA_mp2 is None:
+            select_mp2(name, ref_wfn=monomerA_wfn, **kwargs)
+            monomerA_mp2 = core.get_variable('MP2 CORRELATION ENERGY')
+        mp2_corl_interaction_e -= monomerA_mp2
+    if reuse_monomerA:
+        proc_util.set_sapt_monomer(monomerA_key, monomerA_wfn, monomerA_mp2)
 
     # Compute Monomer B wavefunction
     if (sapt_basis == 'dimer') and (ri == 'DF'):
@@ -3434,6 +3611,10 @@ def run_sapt(name, **kwargs):
     core.print_out('\n')
     e_sapt = core.sapt(dimer_wfn, monomerA_wfn, monomerB_wfn)
 
+    cost_report = core.get_option('SAPT', 'SAPT_COST_REPORT')
+    if cost_report:
+        proc_util.write_sapt_cost_report(dimer_wfn.variables(), cost_report, name.upper())
+
     from psi4.driver.qcdb.psivardefs import sapt_psivars
     p4util.expand_psivars(sapt_psivars())
     optstash.restore()
@@ -3665,7 +3846,7 @@ def run_fisapt(name, **kwargs):
 
     fisapt_wfn = core.FISAPT(ref_wfn)
     from .sapt import fisapt_proc
-    fisapt_wfn.compute_energy()
+    fisapt_wfn.compute_energy(ref_wfn)
 
     optstash.restore()
     return ref_wfn
@@ -3884,7 +4065,7 @@ def run_fnodfcc(name, **kwargs):
 
     ref_wfn = kwargs.get('ref_wfn', None)
     if ref_wfn is None:
-        ref_wfn = scf_helper(name, use_c1=True, **kwargs)  # C1 certified
+        ref_wfn = scf_helper(name, **kwargs)  # C1 certified
     else:
         if ref_wfn.molecule().schoenflies_symbol() != 'c1':
             raise ValidationError("""  FNOCC does not make use of molecular symmetry: """
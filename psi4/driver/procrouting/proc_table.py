@@ -51,6 +51,7 @@ procedures = {
         'mp3'           : proc.select_mp3,
         'mp2.5'         : proc.select_mp2p5,
         'mp2'           : proc.select_mp2,
+        'mp2-f12'       : proc.run_dfmp2_f12,
         'omp2'          : proc.select_omp2,
         'scs-omp2'      : proc.run_occ,
         'scs(n)-omp2'   : proc.run_occ,
@@ -222,9 +223,12 @@ for key in functionals:
     if not (ssuper.is_c_hybrid() or ssuper.is_c_lrc() or ssuper.needs_vv10()):
         procedures['gradient'][key] = proc.run_scf_gradient
 
-    # Hessians
+    # Hessians (RKS only through LSDA)
     if not ssuper.needs_xc():
         procedures['hessian'][key] = proc.run_scf_hessian
+    elif not (ssuper.is_gga() or ssuper.is_meta() or ssuper.is_x_lrc() or ssuper.is_c_hybrid() or ssuper.is_c_lrc()
+              or ssuper.needs_vv10()):
+        procedures['hessian'][key] = proc.run_scf_hessian
 
 # Integrate CFOUR with driver routines
 for ssuper in interface_cfour.cfour_list():
@@ -29,6 +29,9 @@
 from __future__ import print_function
 from __future__ import absolute_import
 
+import json
+import time
+
 import numpy as np
 
 from psi4 import core
@@ -100,7 +103,7 @@ def check_iwl_file_from_scf_type(scf_type, wfn):
     """
 
 
-    if scf_type in ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT']:
+    if scf_type in ['DF', 'DISK_DF', 'MEM_DF', 'CD', 'PK', 'DIRECT', 'COSX', 'PS']:
         mints = core.MintsHelper(wfn.basisset())
         if core.get_global_option("RELATIVISTIC") in ["X2C", "DKH"]:
             rel_bas = core.BasisSet.build(wfn.molecule(), "BASIS_RELATIVISTIC",
@@ -263,3 +266,126 @@ def prepare_sapt_molecule(sapt_dimer, sapt_basis):
         raise ValidationError("SAPT basis %s not recognized" % sapt_basis)
 
     return (sapt_dimer, monomerA, monomerB)
+
+
+# Monomer wavefunctions kept across SAPT computations, keyed by sapt_monomer_key
+_sapt_monomer_cache = {}
+
+
+def sapt_monomer_key(monomer):
+    """
+    Returns a key identifying the SCF of a SAPT monomer computed in its own
+    (monomer-centered) basis: its geometry, charge/multiplicity and the SCF options.
+    """
+
+    geom = np.round(monomer.geometry().np, 8)
+    atoms = tuple((monomer.label(n), monomer.Z(n)) for n in range(monomer.natom()))
+    options = tuple(str(core.get_global_option(opt)) for opt in
+                    ['BASIS', 'PUREAM', 'SCF_TYPE', 'DF_BASIS_SCF', 'E_CONVERGENCE', 'D_CONVERGENCE'])
+    return (atoms, geom.tobytes(), monomer.molecular_charge(), monomer.multiplicity(),
+            core.get_option('SCF', 'REFERENCE')) + options
+
+
+def get_sapt_monomer(key):
+    """
+    Returns the cached (wavefunction, MP2 correlation energy) entry for *key*, or None.
+    """
+
+    return _sapt_monomer_cache.get(key, None)
+
+
+def set_sapt_monomer(key, wfn, mp2_corl=None):
+    """
+    Caches a SAPT monomer wavefunction (and optionally its MP2 correlation energy) under *key*.
+    """
+
+    _sapt_monomer_cache[key] = (wfn, mp2_corl)
+
+
+def clear_sapt_monomer_cache():
+    """
+    Drops all SAPT monomer wavefunctions kept by ``reuse_monomerA``.
+    """
+
+    _sapt_monomer_cache.clear()
+
+
+# Per-term cost fields, in the order of the "<PREFIX> COST <TERM> <FIELD>" variables
+_sapt_cost_fields = [('WALL TIME', 'wall_time'), ('FLOPS', 'flops'), ('PEAK MEMORY', 'peak_memory_mib'),
+                     ('BYTES READ', 'bytes_read'), ('BYTES WRITTEN', 'bytes_written')]
+
+
+def peak_memory_mib():
+    """
+    Returns the memory high-water mark of the process in MiB, or 0.0 where it is
+    not available.
+    """
+
+    try:
+        import resource
+        import sys
+    except ImportError:
+        return 0.0
+    maxrss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # kB on Linux, bytes on macOS
+    return maxrss / (1024.0 * 1024.0) if sys.platform == 'darwin' else maxrss / 1024.0
+
+
+class SAPTTermCost(object):
+    """
+    Context manager timing one SAPT term the way SAPT::term_start()/term_stop() do
+    on the C++ side. *timer* (default *term*) is the core timer to run. On exit the
+    wall time, *flops* estimate, memory high-water mark and PSIO traffic are stored
+    in *wfn* (if given) and the environment as "<PREFIX> COST <TERM> <FIELD>" variables.
+    """
+
+    def __init__(self, wfn, prefix, term, flops=0.0, timer=None):
+        self.wfn = wfn
+        self.key = ' '.join([prefix, 'COST', term.upper()])
+        self.label = term if timer is None else timer
+        self.flops = float(flops)
+
+    def __enter__(self):
+        core.timer_on(self.label)
+        psio = core.IO.shared_object()
+        self.read0 = psio.bytes_read()
+        self.written0 = psio.bytes_written()
+        self.t0 = time.time()
+        return self
+
+    def __exit__(self, *args):
+        wall = time.time() - self.t0
+        core.timer_off(self.label)
+        psio = core.IO.shared_object()
+        values = [wall, self.flops, peak_memory_mib(),
+                  psio.bytes_read() - self.read0, psio.bytes_written() - self.written0]
+        for (field, _), value in zip(_sapt_cost_fields, values):
+            if self.wfn is not None:
+                self.wfn.set_variable(' '.join([self.key, field]), float(value))
+            core.set_variable(' '.join([self.key, field]), float(value))
+        return False
+
+
+def write_sapt_cost_report(variables, filename, method, prefix='SAPT'):
+    """
+    Collects the "<PREFIX> COST <TERM> <FIELD>" entries of *variables* (a
+    Wavefunction.variables() dict) into a JSON report at *filename*: one object per
+    term sorted by name, plus the method, thread count and memory setting.
+    """
+
+    head = prefix + ' COST '
+    terms = {}
+    for key, value in variables.items():
+        if not key.startswith(head):
+            continue
+        for field, name in _sapt_cost_fields:
+            if key.endswith(' ' + field):
+                terms.setdefault(key[len(head):-len(field) - 1], {})[name] = value
+                break
+
+    report = {'method': method, 'nthreads': core.get_num_threads(),
+              'memory_bytes': core.get_memory(),
+              'terms': [dict(term=term, **fields) for term, fields in sorted(terms.items())]}
+    with open(filename, 'w') as handle:
+        json.dump(report, handle, indent=2)
+    core.print_out("    %s cost report written to %s\n\n" % (prefix, filename))
@@ -31,81 +31,92 @@ import os
 import numpy as np
 
 from psi4 import core
+from ..proc_util import SAPTTermCost, write_sapt_cost_report
 
 
-def fisapt_compute_energy(self):
-    """Computes the FSAPT energy. FISAPT::compute_energy"""
+def fisapt_compute_energy(self, ref_wfn=None):
+    """Computes the FSAPT energy. FISAPT::compute_energy
+
+    When *ref_wfn* is given, the per-term costs ("FISAPT COST <TERM> ..."
+    variables, also set globally) are stored on it as well, and its
+    DF_BASIS_SAPT/DF_BASIS_SCF sizes enter the FLOP estimates.
+    """
 
     # => Header <=
 
     self.print_header()
 
+    def _cost(term, timer, flops=0.0):
+        return SAPTTermCost(ref_wfn, 'FISAPT', term, flops, timer)
+
     # => Zero-th Order Wavefunction <=
 
-    core.timer_on("FISAPT: Setup")
-    self.localize()
-    self.partition()
-    self.overlap()
-    self.kinetic()
-    self.nuclear()
-    self.coulomb()
-    core.timer_off("FISAPT: Setup")
-    core.timer_on("FISAPT: Monomer SCF")
-    self.scf()
-    core.timer_off("FISAPT: Monomer SCF")
+    with _cost("Setup", "FISAPT: Setup"):
+        self.localize()
+        self.partition()
+        self.overlap()
+        self.kinetic()
+        self.nuclear()
+        self.coulomb()
+    with _cost("Monomer SCF", "FISAPT: Monomer SCF"):
+        self.scf()
     self.freeze_core()
     self.unify()
-    core.timer_on("FISAPT: Subsys E")
-    self.dHF()
-    core.timer_off("FISAPT: Subsys E")
+
+    # Leading-order FLOP estimates: JK builds for elst/exch/ind (one CPHF iteration), (ar|bs) for disp
+    matrices = self.matrices()
+    n = matrices["Cocc0A"].rows()
+    oA, oB = matrices["Cocc0A"].cols(), matrices["Cocc0B"].cols()
+    vA, vB = matrices["Cvir0A"].cols(), matrices["Cvir0B"].cols()
+    Q_scf = ref_wfn.get_basisset("DF_BASIS_SCF").nbf() if ref_wfn is not None else 0
+    Q_sapt = ref_wfn.get_basisset("DF_BASIS_SAPT").nbf() if ref_wfn is not None else 0
+    jk_flops = 2.0 * n * n * Q_scf * (oA + oB)
+    disp_flops = 2.0 * oA * vA * oB * vB * Q_sapt
+
+    with _cost("Subsys E", "FISAPT: Subsys E", jk_flops):
+        self.dHF()
 
     # => SAPT0 <=
 
-    core.timer_on("FISAPT:SAPT:elst")
-    self.elst()
-    core.timer_off("FISAPT:SAPT:elst")
-    core.timer_on("FISAPT:SAPT:exch")
-    self.exch()
-    core.timer_off("FISAPT:SAPT:exch")
-    core.timer_on("FISAPT:SAPT:ind")
-    self.ind()
-    core.timer_off("FISAPT:SAPT:ind")
+    with _cost("Elst", "FISAPT:SAPT:elst", jk_flops):
+        self.elst()
+    with _cost("Exch", "FISAPT:SAPT:exch", 2.0 * jk_flops):
+        self.exch()
+    with _cost("Ind", "FISAPT:SAPT:ind", 2.0 * jk_flops):
+        self.ind()
     if not core.get_option("FISAPT", "FISAPT_DO_FSAPT"):
-        core.timer_on("FISAPT:SAPT:disp")
-        self.disp(matrices_, vectors_, true)  # Expensive, only do if needed
-        core.timer_off("FISAPT:SAPT:disp")
+        with _cost("Disp", "FISAPT:SAPT:disp", disp_flops):
+            self.disp(matrices_, vectors_, true)  # Expensive, only do if needed
 
     # => F-SAPT0 <=
 
     if core.get_option("FISAPT", "FISAPT_DO_FSAPT"):
-        core.timer_on("FISAPT:FSAPT:loc")
-        self.flocalize()
-        core.timer_off("FISAPT:FSAPT:loc")
-        core.timer_on("FISAPT:FSAPT:elst")
-        self.felst()
-        core.timer_off("FISAPT:FSAPT:elst")
-        core.timer_on("FISAPT:FSAPT:exch")
-        self.fexch()
-        core.timer_off("FISAPT:FSAPT:exch")
-        core.timer_on("FISAPT:FSAPT:ind")
-        self.find()
-        core.timer_off("FISAPT:FSAPT:ind")
-        core.timer_on("FISAPT:FSAPT:disp")
-        self.fdisp()
-        core.timer_off("FISAPT:FSAPT:disp")
+        with _cost("FSAPT Loc", "FISAPT:FSAPT:loc"):
+            self.flocalize()
+        with _cost("FSAPT Elst", "FISAPT:FSAPT:elst", jk_flops):
+            self.felst()
+        with _cost("FSAPT Exch", "FISAPT:FSAPT:exch", 2.0 * jk_flops):
+            self.fexch()
+        with _cost("FSAPT Ind", "FISAPT:FSAPT:ind", 2.0 * jk_flops):
+            self.find()
+        with _cost("FSAPT Disp", "FISAPT:FSAPT:disp", disp_flops):
+            self.fdisp()
         self.fdrop()
 
     # => Scalar-Field Analysis <=
 
     if core.get_option("FISAPT", "FISAPT_DO_PLOT"):
-        core.timer_on("FISAPT:FSAPT:cubeplot")
-        self.plot()
-        core.timer_off("FISAPT:FSAPT:cubeplot")
+        with _cost("Cubeplot", "FISAPT:FSAPT:cubeplot"):
+            self.plot()
 
     # => Summary <=
 
     self.print_trailer()
 
+    report = core.get_option("FISAPT", "FISAPT_COST_REPORT")
+    if report:
+        write_sapt_cost_report(core.get_variables(), report, 'FISAPT', prefix='FISAPT')
+
 
 def fisapt_fdrop(self):
     """Drop output files from FSAPT calculation. FISAPT::fdrop"""
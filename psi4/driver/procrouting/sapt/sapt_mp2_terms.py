@@ -123,6 +123,10 @@ def df_fdds_dispersion(primary, auxiliary, cache, leg_points=10, leg_lambda=0.3,
     metric = fdds_obj.metric()
     metric_inv = fdds_obj.metric_inv()
 
+    aux_cutoff = core.get_option("SAPT", "SAPT_FDDS_AUX_CUTOFF")
+    if aux_cutoff >= 0.0:
+        return _df_fdds_dispersion_lr(fdds_obj, metric_inv, W_A, W_B, aux_cutoff, leg_points, leg_lambda, do_print)
+
     # Integrate
     core.print_out("\n   => Time Integration <= \n\n")
 
@@ -205,6 +209,84 @@ def df_fdds_dispersion(primary, auxiliary, cache, leg_points=10, leg_lambda=0.3,
     return {"Disp20,FDDS (unc)": Disp20_uc, "Disp20": Disp20_c}
 
 
+def _fdds_coupled_lr(x, H):
+    """
+    Coupled amplitude in the compressed space, x - x H (1 + x H)^-1 x, with H = U^T S^-1 W S^-1 U.
+    """
+
+    x_np = np.asarray(x)
+    xH = np.dot(x_np, np.asarray(H))
+    ret = x_np - np.dot(xH, np.linalg.solve(np.eye(x_np.shape[0]) + xH, x_np))
+    return 0.5 * (ret + ret.T)
+
+
+def _df_fdds_dispersion_lr(fdds_obj, metric_inv, W_A, W_B, aux_cutoff, leg_points, leg_lambda, do_print):
+    """
+    FDDS Disp20 with each monomer's response written as X(w) = U x(w) U^T in its compressed auxiliary basis U.
+    """
+
+    U_A = fdds_obj.form_aux_compression("A", aux_cutoff)
+    U_B = fdds_obj.form_aux_compression("B", aux_cutoff)
+
+    # Frequency-independent kernels in the compressed spaces
+    H_A = core.Matrix.triplet(U_A, core.Matrix.triplet(metric_inv, W_A, metric_inv, False, False, False), U_A, True,
+                              False, False)
+    H_B = core.Matrix.triplet(U_B, core.Matrix.triplet(metric_inv, W_B, metric_inv, False, False, False), U_B, True,
+                              False, False)
+    C_AB = np.asarray(core.Matrix.triplet(U_A, metric_inv, U_B, True, False, False))
+
+    # Integrate
+    core.print_out("\n   => Time Integration <= \n\n")
+
+    val_pack = ("Omega", "Weight", "Disp20,u", "Disp20", "time [s]")
+    core.print_out("% 12s % 12s % 14s % 14s % 10s\n" % val_pack)
+    start_time = time.time()
+
+    total_uc = 0
+    total_c = 0
+
+    for point, weight in zip(*np.polynomial.legendre.leggauss(leg_points)):
+
+        omega = leg_lambda * (1.0 - point) / (1.0 + point)
+        lambda_scale = ((2.0 * leg_lambda) / (point + 1.0)**2)
+
+        x_A = fdds_obj.form_unc_amplitude_lr("A", omega)
+        x_B = fdds_obj.form_unc_amplitude_lr("B", omega)
+
+        x_A_coupled = _fdds_coupled_lr(x_A, H_A)
+        x_B_coupled = _fdds_coupled_lr(x_B, H_B)
+
+        x_A = np.asarray(x_A)
+        x_B = np.asarray(x_B)
+        x_A = 0.5 * (x_A + x_A.T)
+        x_B = 0.5 * (x_B + x_B.T)
+
+        # tr(S^-1 X_A S^-1 X_B) = tr(x_A C x_B C^T)
+        value_uc = np.vdot(np.dot(C_AB.T, np.dot(x_A, C_AB)), x_B)
+        value_c = np.vdot(np.dot(C_AB.T, np.dot(x_A_coupled, C_AB)), x_B_coupled)
+
+        # Tally
+        total_uc += value_uc * weight * lambda_scale
+        total_c += value_c * weight * lambda_scale
+
+        if do_print:
+            tmp_disp_unc = value_uc * weight * lambda_scale
+            tmp_disp = value_c * weight * lambda_scale
+            fdds_time = time.time() - start_time
+
+            val_pack = (omega, weight, tmp_disp_unc, tmp_disp, fdds_time)
+            core.print_out("% 12.3e % 12.3e % 14.3e % 14.3e %10d\n" % val_pack)
+
+    Disp20_uc = -1.0 / (2.0 * np.pi) * total_uc
+    Disp20_c = -1.0 / (2.0 * np.pi) * total_c
+
+    core.print_out("\n")
+    core.print_out(print_sapt_var("Disp20,u", Disp20_uc, short=True) + "\n")
+    core.print_out(print_sapt_var("Disp20", Disp20_c, short=True) + "\n")
+
+    return {"Disp20,FDDS (unc)": Disp20_uc, "Disp20": Disp20_c}
+
+
 def df_mp2_fisapt_dispersion(wfn, primary, auxiliary, cache, do_print=True):
 
     if do_print:
@@ -31,3 +31,4 @@ A helper folder for auxiliary SCF funcitons and iterations.
 """
 
 from . import scf_iterator
+from . import batch
@@ -0,0 +1,130 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2018 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""
+Batched closed-shell SCF energies of many small molecules.
+"""
+
+from psi4 import core
+from psi4.driver.p4util.exceptions import ValidationError
+from psi4.driver.procrouting import dft_funcs
+from psi4.driver.procrouting import empirical_dispersion
+
+
+def batch_scf(molecules, name="hf", basis=None, return_orbitals=False):
+    """Runs the closed-shell SCF energies of many small molecules
+    concurrently, one molecule per thread, through :py:class:`~psi4.core.BatchRHF`.
+
+    For molecules of a few atoms this is much faster than calling
+    :py:func:`~psi4.energy` for each, whose setup and per-iteration
+    overhead dominate at that size. Every molecule is run in C1 symmetry
+    from a core guess; the SCF module's convergence, |globals__scf_type|
+    (``DF`` or ``DIRECT``), and DFT grid options apply to all of them.
+
+    :type molecules: list of :py:class:`~psi4.core.Molecule`
+    :param molecules: Closed-shell molecules; they are not modified.
+
+    :type name: str
+    :param name: ``'hf'``/``'scf'`` or a restricted DFT functional. The
+        functional is built once and shared by all molecules. Empirical
+        dispersion is added afterwards, molecule by molecule.
+
+    :type basis: str
+    :param basis: Orbital basis; defaults to |mints__basis|.
+
+    :type return_orbitals: bool
+    :param return_orbitals: Also return the AO orbital coefficients and energies.
+
+    :returns: list of dict -- One per molecule, in order, with keys
+        ``energy``, ``iterations``, ``converged``, ``error`` (empty unless the
+        molecule could not be run), and with *return_orbitals* ``Ca`` and
+        ``epsilon`` as :py:class:`~psi4.core.Matrix`/:py:class:`~psi4.core.Vector`.
+
+    """
+    scf_type = core.get_global_option("SCF_TYPE")
+    if scf_type in ["DF", "MEM_DF", "DISK_DF"]:
+        density_fitted = True
+    elif scf_type == "DIRECT":
+        density_fitted = False
+    else:
+        raise ValidationError("batch_scf: SCF_TYPE %s is not supported, use DF or DIRECT." % scf_type)
+
+    if basis is None:
+        basis = core.get_global_option("BASIS")
+
+    name = name.lower()
+    functional = None
+    disp_type = None
+    if name not in ["hf", "scf"]:
+        functional, disp_type = dft_funcs.build_superfunctional(name, True)
+
+    disp = None
+    if disp_type:
+        if isinstance(disp_type, dict):
+            if disp_type["type"] != "nl":
+                disp = empirical_dispersion.EmpericalDispersion(functional.name(), disp_type["type"],
+                                                                dashparams=disp_type["params"],
+                                                                citation=disp_type["citation"])
+        else:
+            disp = empirical_dispersion.EmpericalDispersion(disp_type[0], disp_type[1])
+
+    core.prepare_options_for_module("SCF")
+    batch = core.BatchRHF(core.get_options())
+
+    # Basis sets are built here, serially, as building them goes through Python
+    c1_molecules = []
+    for molecule in molecules:
+        mol = molecule.clone()
+        mol.reset_point_group("c1")
+        mol.fix_orientation(True)
+        mol.fix_com(True)
+        mol.update_geometry()
+        c1_molecules.append(mol)
+
+        primary = core.BasisSet.build(mol, "ORBITAL", basis, quiet=True)
+        auxiliary = None
+        if density_fitted:
+            auxiliary = core.BasisSet.build(mol, "DF_BASIS_SCF", core.get_option("SCF", "DF_BASIS_SCF"), "JKFIT",
+                                            basis, puream=primary.has_puream(), quiet=True)
+        batch.add_system(primary, auxiliary, functional)
+
+    results = []
+    for mol, result in zip(c1_molecules, batch.compute()):
+        entry = {
+            "energy": result.energy,
+            "iterations": result.iterations,
+            "converged": result.converged,
+            "error": result.error
+        }
+        if disp and not result.error:
+            entry["energy"] += disp.compute_energy(mol)
+        if return_orbitals:
+            entry["Ca"] = result.Ca
+            entry["epsilon"] = result.epsilon
+        results.append(entry)
+
+    return results
@@ -0,0 +1,176 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2018 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+
+"""
+Guess orbitals extrapolated along a sequence of geometries (optimizations, scans).
+
+The occupied orbitals of the last few geometries are aligned to the newest set by an
+orthogonal Procrustes rotation (removing the arbitrary rotations within the occupied
+space), combined with the always-stable predictor-corrector (ASPC) coefficients of
+Kolafa, J. Comput. Chem. 25, 335 (2004), and Lowdin-orthonormalized in the metric of
+the new geometry. The SCF itself plays the role of the corrector.
+"""
+
+from __future__ import division
+
+from math import factorial
+
+import numpy as np
+
+from psi4 import core
+
+_history = []
+_active = False
+_reference = None
+
+
+def start():
+    """Begin a new geometry sequence; forgets any stored orbitals."""
+    global _active
+    del _history[:]
+    _active = core.get_option('SCF', 'GUESS_EXTRAPOLATION') != 'NONE'
+
+
+def stop():
+    """End the current geometry sequence."""
+    global _active
+    del _history[:]
+    _active = False
+
+
+def active():
+    return _active
+
+
+def _key(wfn):
+    return (wfn.basisset().name(), wfn.molecule().schoenflies_symbol(), wfn.nsopi().to_tuple(), wfn.nalpha(),
+            wfn.nbeta())
+
+
+def _entry(wfn):
+    ref = wfn.reference_wavefunction() if wfn.reference_wavefunction() is not None else wfn
+    if not isinstance(ref, core.HF):
+        return None
+
+    return {
+        'key': _key(ref),
+        'Ca': [np.array(block) for block in ref.Ca_subset("SO", "OCC").nph],
+        'Cb': [np.array(block) for block in ref.Cb_subset("SO", "OCC").nph],
+    }
+
+
+def set_reference(wfn):
+    """Store the occupied orbitals of `wfn` as a fixed guess for nearby geometries of the same point group
+    (finite-difference displacements). Used whenever the extrapolation history is too short."""
+    global _reference
+    _reference = _entry(wfn)
+
+
+def clear_reference():
+    global _reference
+    _reference = None
+
+
+def record(wfn):
+    """Store the converged occupied orbitals of `wfn` (or of its SCF reference) as the newest geometry."""
+    if not _active:
+        return
+    entry = _entry(wfn)
+    if entry is None:
+        return
+
+    if _history and _history[-1]['key'] != entry['key']:
+        del _history[:]
+    _history.append(entry)
+
+    order = core.get_option('SCF', 'GUESS_EXTRAPOLATION_ORDER')
+    del _history[:-(order + 2)]
+
+
+def aspc_coefficients(order):
+    """ASPC predictor weights B_j, j = 1 .. order + 2, newest geometry first."""
+    binom = lambda n, k: factorial(n) // (factorial(k) * factorial(n - k))
+    norm = binom(2 * order + 2, order + 1)
+    return [(-1)**(j + 1) * j * binom(2 * order + 4, order + 2 - j) / norm for j in range(1, order + 3)]
+
+
+def _extrapolate(blocks, S, weights):
+    """Align every stored set to the newest one, combine with `weights`, and orthonormalize in metric S."""
+    C0 = blocks[0]
+    if C0.size == 0:
+        return C0.copy()
+    SC0 = S.dot(C0)
+    C = np.zeros_like(C0)
+    for Cj, w in zip(blocks, weights):
+        U, _, Vt = np.linalg.svd(Cj.T.dot(SC0))
+        C += w * Cj.dot(U.dot(Vt))
+
+    evals, evecs = np.linalg.eigh(C.T.dot(S).dot(C))
+    return C.dot(evecs.dot(np.diag(evals**-0.5)).dot(evecs.T))
+
+
+def _predict_reference(wfn):
+    """Returns the reference orbitals orthonormalized at the geometry of `wfn`, or None if they do not fit."""
+    if _reference is None or _reference['key'] != _key(wfn):
+        return None
+
+    S = core.MintsHelper(wfn.basisset()).so_overlap()
+    guesses = []
+    for spin in ['Ca', 'Cb']:
+        blocks = [_extrapolate([_reference[spin][h]], np.asarray(S.nph[h]), [1.0]) for h in range(S.nirrep())]
+        guess = core.Matrix.from_array(blocks)
+        guess.name = spin + " reference"
+        guesses.append(guess)
+
+    core.print_out("  Using the orbitals of the reference geometry as the guess.\n\n")
+    return guesses[0], guesses[1]
+
+
+def predict(wfn):
+    """Returns extrapolated (Ca_occ, Cb_occ) guesses for `wfn`, or None if the history is too short."""
+    if not _active:
+        return _predict_reference(wfn)
+    if len(_history) < 2 or _history[-1]['key'] != _key(wfn):
+        return _predict_reference(wfn)
+
+    order = min(core.get_option('SCF', 'GUESS_EXTRAPOLATION_ORDER'), len(_history) - 2)
+    weights = aspc_coefficients(order)
+    entries = _history[::-1][:order + 2]
+
+    S = core.MintsHelper(wfn.basisset()).so_overlap()
+    guesses = []
+    for spin in ['Ca', 'Cb']:
+        blocks = [_extrapolate([entry[spin][h] for entry in entries], np.asarray(S.nph[h]), weights)
+                  for h in range(S.nirrep())]
+        guess = core.Matrix.from_array(blocks)
+        guess.name = spin + " extrapolated"
+        guesses.append(guess)
+
+    core.print_out("  Extrapolating guess orbitals from %d previous geometries (ASPC order %d).\n\n" %
+                   (len(entries), order))
+    return guesses[0], guesses[1]
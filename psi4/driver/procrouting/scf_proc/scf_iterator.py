@@ -30,6 +30,8 @@
 The SCF iteration functions
 """
 
+import time
+
 import numpy as np
 
 from psi4.driver import p4util
@@ -70,7 +72,10 @@ def scf_compute_energy(self):
             core.set_global_option('SCF_TYPE', 'DF')
             self.initialize()
             try:
-                self.iterations()
+                if core.get_option('SCF', 'SCF_ADAPTIVE'):
+                    self.iterations(stop_when=_df_guess_done)
+                else:
+                    self.iterations()
             except SCFConvergenceError:
                 self.finalize()
                 raise SCFConvergenceError("""SCF DF preiterations""", self.iteration_, self, 0, 0)
@@ -97,6 +102,9 @@ def scf_compute_energy(self):
     else:
         core.print_out("  Energy converged.\n\n")
 
+    if core.get_option('SCF', 'PRINT') > 1:
+        self.print_iteration_stats()
+
     scf_energy = self.finalize_energy()
     return scf_energy
 
@@ -209,7 +217,13 @@ def scf_initialize(self):
         self.set_energies("Total Energy", self.compute_initial_E())
 
 
-def scf_iterate(self, e_conv=None, d_conv=None):
+def scf_iterate(self, e_conv=None, d_conv=None, stop_when=None):
+    """Runs the SCF iterations until convergence.
+
+    stop_when, if given, is called with the wavefunction after each
+    iteration and ends the iterations early when it returns True.
+
+    """
 
     is_dfjk = core.get_global_option('SCF_TYPE').endswith('DF')
     verbose = core.get_option('SCF', "PRINT")
@@ -229,6 +243,19 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         core.print_out("%s                        Total Energy        Delta E     RMS |[F,P]|\n\n" % ("   "
                                                                                                       if is_dfjk else ""))
 
+    # EFP and PCM contributions are only added here on the Python side
+    if (core.get_option('SCF', 'SCF_NATIVE_ITERATIONS') and stop_when is None and not efp_enabled
+            and not core.get_option('SCF', 'PCM')):
+        if e_conv is None:
+            e_conv = core.get_option("SCF", "E_CONVERGENCE")
+        if d_conv is None:
+            d_conv = core.get_option("SCF", "D_CONVERGENCE")
+
+        converged, Ediff, Drms = self.iterate(e_conv, d_conv)
+        if not converged:
+            raise SCFConvergenceError("""SCF iterations""", self.iteration_, self, Ediff, Drms)
+        return
+
     # SCF iterations!
     SCFE_old = 0.0
     SCFE = 0.0
@@ -238,10 +265,12 @@ def scf_iterate(self, e_conv=None, d_conv=None):
 
         diis_performed = False
         soscf_performed = False
+        diis_time = 0.0
         self.frac_performed_ = False
         #self.MOM_performed_ = False  # redundant from common_init()
 
         self.save_density_and_energy()
+        self.begin_iteration_stats()
 
         if efp_enabled:
             # EFP: Add efp contribution to Fock matrix
@@ -336,6 +365,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
             # Normal convergence procedures if we do not do SOSCF
 
             core.timer_on("HF: DIIS")
+            diis_start = time.perf_counter()
             diis_performed = False
             add_to_diis_subspace = False
 
@@ -351,6 +381,7 @@ def scf_iterate(self, e_conv=None, d_conv=None):
             if diis_performed:
                 status.append("DIIS")
 
+            diis_time = time.perf_counter() - diis_start
             core.timer_off("HF: DIIS")
 
             if verbose > 4 and diis_performed:
@@ -390,6 +421,18 @@ def scf_iterate(self, e_conv=None, d_conv=None):
         # Print out the iteration
         core.print_out("   @%s%s iter %3d: %20.14f   %12.5e   %-11.5e %s\n" %
                        ("DF-" if is_dfjk else "", reference, self.iteration_, SCFE, Ediff, Drms, '/'.join(status)))
+        stats = self.end_iteration_stats(SCFE, Ediff, Drms, diis_time, '/'.join(status))
+        core.emit_event("scf_iteration", {
+            "iteration": self.iteration_,
+            "energy": SCFE,
+            "delta_e": Ediff,
+            "d_rms": Drms,
+            "jk_time": stats.jk_time,
+            "v_time": stats.v_time,
+            "diis_time": stats.diis_time,
+            "screened_fraction": stats.screened_fraction
+        }, {"reference": reference, "status": '/'.join(status)})
+        self.reset_stalled_diis()
 
         # if a an excited MOM is requested but not started, don't stop yet
         if self.MOM_excited_ and not self.MOM_performed_:
@@ -401,7 +444,15 @@ def scf_iterate(self, e_conv=None, d_conv=None):
 
         # Call any postiteration callbacks
 
+        if stop_when is not None and stop_when(self):
+            break
+
         if _converged(Ediff, Drms, e_conv=e_conv, d_conv=d_conv):
+            if self.purify_:
+                # Purification built D only; diagonalize the converged Fock matrix once for the orbitals
+                self.purify_ = False
+                self.form_C()
+                self.form_D()
             break
         if self.iteration_ >= core.get_option('SCF', 'MAXITER'):
             raise SCFConvergenceError("""SCF iterations""", self.iteration_, self, Ediff, Drms)
@@ -623,6 +674,30 @@ def _converged(e_delta, d_rms, e_conv=None, d_conv=None):
     return (abs(e_delta) < e_conv and d_rms < d_conv)
 
 
+def _df_guess_done(self):
+    """Decides from the iteration telemetry whether the DF preiterations of a
+    DIRECT SCF have done all they usefully can (|scf__scf_adaptive|).
+
+    The orbital gradient of the last iterations gives a per-iteration
+    convergence rate. DF is handed over to DIRECT once the next iteration
+    is predicted to fall below |scf__scf_adaptive_df_error|, the error
+    inherent to density fitting, or once convergence has stalled.
+
+    """
+    stats = [s for s in self.iteration_stats() if s.scf_type.endswith('DF')]
+    if len(stats) < 3 or stats[-3].d_rms <= 0.0:
+        return False
+
+    rate = (stats[-1].d_rms / stats[-3].d_rms)**0.5
+    if stats[-1].d_rms * rate < core.get_option('SCF', 'SCF_ADAPTIVE_DF_ERROR'):
+        core.print_out("\n  DF preiterations reached the density-fitting error.\n")
+        return True
+    if rate > 0.9:
+        core.print_out("\n  DF preiterations stalled (orbital gradient ratio %.2f per iteration).\n" % rate)
+        return True
+    return False
+
+
 def _validate_damping():
     """Sanity-checks DAMPING control options
 
@@ -780,6 +780,10 @@ class BasisSet(object):
         names = {}
         summary = []
         bastitles = []
+        # Atoms sharing a label repeat the same file lookups and entry parses, so
+        #   memoize both to keep construction linear in the number of atoms
+        found_files = {}
+        parsed_entries = {}
 
         for at in range(mol.natom()):
             symbol = mol.atom_entry(at).symbol()  # O, He
@@ -849,7 +853,9 @@ class BasisSet(object):
                         names[index] = basstrings[filename[:-4]].split('\n')
                 else:
                     # -- Else seek bas.gbs file in path
-                    fullfilename = search_file(filename, seek['path'])
+                    if (filename, seek['path']) not in found_files:
+                        found_files[(filename, seek['path'])] = search_file(filename, seek['path'])
+                    fullfilename = found_files[(filename, seek['path'])]
                     if fullfilename is None:
                         # -- Else skip to next bas
                         continue
@@ -863,7 +869,9 @@ class BasisSet(object):
                 for entry in seek['entry']:
 
                     # Seek entry in lines, else skip to next entry
-                    shells, msg, ecp_shells, ecp_msg, ecp_ncore = parser.parse(entry, lines)
+                    if (index, entry) not in parsed_entries:
+                        parsed_entries[(index, entry)] = parser.parse(entry, lines)
+                    shells, msg, ecp_shells, ecp_msg, ecp_ncore = parsed_entries[(index, entry)]
                     if shells is None:
                         continue
 
@@ -914,10 +922,18 @@ class BasisSet(object):
             ecpbasisset.ecp_coreinfo = ecp_atom_basis_ncore
 
         # Construct all the one-atom BasisSet-s for mol's CoordEntry-s
+        #   The hash depends only on the shells, so compute it once per label and basis
+        #   unless the one-atom BasisSet-s themselves are wanted
         atom_basis_list = []
+        atom_hashes = {}
         for at in range(mol.natom()):
+            hashkey = (mol.atom_entry(at).label(), mol.atom_entry(at).basisset(key))
+            if not return_atomlist and hashkey in atom_hashes:
+                mol.set_shell_by_number(at, atom_hashes[hashkey], role=key)
+                continue
             oneatombasis = BasisSet(basisset, at)
             oneatombasishash = hashlib.sha1(oneatombasis.print_detail(numbersonly=True).encode('utf-8')).hexdigest()
+            atom_hashes[hashkey] = oneatombasishash
             if return_atomlist:
                 oneatombasis.molecule.set_shell_by_number(0, oneatombasishash, role=key)
                 atom_basis_list.append(oneatombasis)
@@ -39,6 +39,10 @@ from .libmintsgshell import *
 if sys.version_info >= (3,0):
     basestring = str
 
+# Stripped lines of basis files already read, keyed by filename, basisname and
+#   the file's mtime and size so that edited files are re-read
+_loaded_files = {}
+
 class Gaussian94BasisSetParser(object):
     """Class for parsing basis sets from a text file in Gaussian 94
     format. Translated directly from the Psi4 libmints class written
@@ -73,9 +77,15 @@ class Gaussian94BasisSetParser(object):
             infile = open(filename, 'r')
         except IOError:
             raise BasisSetFileNotFound("""BasisSetParser::parse: Unable to open basis set file: %s""" % (filename))
-        if os.stat(filename).st_size == 0:
+        stat = os.stat(filename)
+        if stat.st_size == 0:
             raise ValidationError("""BasisSetParser::parse: given filename '%s' is blank.""" % (filename))
+        cachekey = (filename, basisname, stat.st_mtime, stat.st_size)
+        if cachekey in _loaded_files:
+            infile.close()
+            return list(_loaded_files[cachekey])
         contents = infile.readlines()
+        infile.close()
 
         lines = []
         for text in contents:
@@ -97,7 +107,8 @@ class Gaussian94BasisSetParser(object):
                 if basisname == basis_separator.match(text).group(1):
                     found_basisname = True
 
-        return lines
+        _loaded_files[cachekey] = lines
+        return list(lines)
 
     def parse(self, symbol, dataset):
         """Given a string, parse for the basis set needed for atom.
@@ -375,16 +375,35 @@ def harmonic_analysis(hess, geom, mass, basisset, irrep_labels, project_trans=Tr
         raise ValidationError("""Dimension mismatch among mass ({}), geometry ({}), and Hessian ({})""".format(
             mass.shape, geom.shape, hess.shape))
 
-    def mat_symm_info(a, atol=1e-14, lbl='array', stol=None):
+    def mat_symm_info(a, atol=1e-14, lbl='array', stol=None, evals=None):
         symm = np.allclose(a, a.T, atol=atol)
         herm = np.allclose(a, a.conj().T, atol=atol)
-        ivrt = a.shape[0] - np.linalg.matrix_rank(a, tol=stol)
+        # singular values of a symmetric matrix are its |eigenvalues|, so reuse those
+        #   (or an eigvalsh) in place of the SVD of matrix_rank()
+        if evals is None:
+            evals = np.linalg.eigvalsh(a)
+        sv = np.abs(evals)
+        if stol is None:
+            stol = sv.max() * max(a.shape) * np.finfo(float).eps
+        ivrt = int(np.sum(sv <= stol))
         return """  {:32} Symmetric? {}   Hermitian? {}   Lin Dep Dim? {:2}""".format(lbl + ':', symm, herm, ivrt)
 
-    def vec_in_space(vec, space, tol=1.0e-4):
-        merged = np.vstack((space, vec))
-        u, s, v = np.linalg.svd(merged)
-        return (s[-1] < tol)
+    def vecs_in_space(vecs, space, tol=1.0e-4):
+        """Test each normalized column of `vecs` for lying in the row space of `space`.
+
+        Equivalent to the smallest singular value of `space` stacked with one vector
+        falling below `tol`, but evaluated for all columns at once from the
+        projection onto an orthonormal basis of `space`.
+
+        """
+        u, sv, vh = np.linalg.svd(space, full_matrices=False)
+        basis = vh[sv > max(space.shape) * sv.max() * np.finfo(float).eps] if sv.size else vh[:0]
+        if basis.shape[0] >= space.shape[1]:
+            # a space spanning everything gains no null singular value from another vector
+            return np.zeros(vecs.shape[1], dtype=bool)
+        overlap = np.linalg.norm(np.dot(basis, vecs), axis=0)
+        smallest = np.sqrt(np.clip(1.0 - overlap, 0.0, None))
+        return smallest < tol
 
     vibinfo = {}
     text = []
@@ -420,18 +439,18 @@ def harmonic_analysis(hess, geom, mass, basisset, irrep_labels, project_trans=Tr
         '  projection of translations ({}) and rotations ({}) removed {} degrees of freedom ({})'.
         format(project_trans, project_rot, nrt, nrt_expected))
 
-    P = np.identity(3 * nat)
-    for irt in TRspace:
-        P -= np.outer(irt, irt)
-    text.append(mat_symm_info(P, lbl='total projector') + ' ({})'.format(nrt))
+    # P = 1 - T^t T for orthonormal rows T of TRspace is applied in low-rank form below;
+    #   it is symmetric, idempotent, and removes exactly nrt dimensions
+    text.append("""  {:32} Symmetric? {}   Hermitian? {}   Lin Dep Dim? {:2}""".format(
+        'total projector:', True, True, nrt) + ' ({})'.format(nrt))
 
     # mass-weight & solve
     sqrtmmm = np.repeat(np.sqrt(mass), 3)
     sqrtmmminv = np.divide(1.0, sqrtmmm)
     mwhess = np.einsum('i,ij,j->ij', sqrtmmminv, nmwhess, sqrtmmminv)
-    text.append(mat_symm_info(mwhess, lbl='mass-weighted Hessian') + ' (0)')
 
     pre_force_constant_au = np.linalg.eigvalsh(mwhess)
+    text.append(mat_symm_info(mwhess, lbl='mass-weighted Hessian', evals=pre_force_constant_au) + ' (0)')
 
     idx = np.argsort(pre_force_constant_au)
     pre_force_constant_au = pre_force_constant_au[idx]
@@ -448,12 +467,15 @@ def harmonic_analysis(hess, geom, mass, basisset, irrep_labels, project_trans=Tr
             text.append('  pre-proj  low-frequency mode: {:9.4f}  [cm^-1]'.format(vlf.real, ''))
     text.append('  pre-proj  all modes:' + str(_format_omega(pre_frequency_cm_1, 4)))
 
-    # project & solve
-    mwhess_proj = np.dot(P.T, mwhess).dot(P)
-    text.append(mat_symm_info(mwhess_proj, lbl='projected mass-weighted Hessian') + ' ({})'.format(nrt))
+    # project & solve: P H P = H - T^t (T H) - (H T^t) T + T^t (T H T^t) T, all rank-nrt updates
+    HT = np.dot(mwhess, TRspace.T)
+    THT = np.dot(TRspace, HT)
+    mwhess_proj = mwhess - np.dot(HT, TRspace) - np.dot(TRspace.T, HT.T) + np.dot(TRspace.T, THT).dot(TRspace)
 
     #print('projhess = ', np.array_repr(mwhess_proj))
     force_constant_au, qL = np.linalg.eigh(mwhess_proj)
+    text.append(mat_symm_info(mwhess_proj, lbl='projected mass-weighted Hessian',
+                              evals=force_constant_au) + ' ({})'.format(nrt))
 
     # expected order for vibrations is steepest downhill to steepest uphill
     idx = np.argsort(force_constant_au)
@@ -472,11 +494,14 @@ def harmonic_analysis(hess, geom, mass, basisset, irrep_labels, project_trans=Tr
 
     # look among the symmetry subspaces h for one to which the normco
     #   of vib does *not* add an extra dof to the vector space
+    in_TR = vecs_in_space(qL, TRspace, 1.0e-4)
+    in_Uh = collections.OrderedDict((h, vecs_in_space(qL, U, 1.0e-4)) for h, U in Uh.items())
+
     active = []
     irrep_classification = []
     for idx, vib in enumerate(frequency_cm_1):
 
-        if vec_in_space(qL[:, idx], TRspace, 1.0e-4):
+        if in_TR[idx]:
             active.append('TR')
             irrep_classification.append(None)
 
@@ -484,7 +509,7 @@ def harmonic_analysis(hess, geom, mass, basisset, irrep_labels, project_trans=Tr
             active.append('V')
 
             for h in Uh.keys():
-                if vec_in_space(qL[:, idx], Uh[h], 1.0e-4):
+                if in_Uh[h][idx]:
                     irrep_classification.append(h)
                     break
             else:
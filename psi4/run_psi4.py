@@ -71,6 +71,10 @@ parser.add_argument("-k", "--skip-preprocessor", action='store_true',
                     help="Skips input preprocessing. !Warning! expert option.")
 parser.add_argument("--json", action='store_true',
                     help="Runs a JSON input file. !Warning! experimental option.")
+parser.add_argument("--server", action='store_true',
+                    help="Serves JSON inputs, one per line, from stdin until EOF. !Warning! experimental option.")
+parser.add_argument("--server-port", type=int,
+                    help="With --server, listens on this TCP port of localhost instead of stdin.")
 parser.add_argument("-t", "--test", action='store_true',
                     help="Runs smoke tests.")
 
@@ -191,6 +195,16 @@ if args["test"]:
     psi4.test()
     sys.exit()
 
+# Long-lived JSON server, answering requests until told to stop
+if args["server"]:
+    if args["scratch"] is not None:
+        psi4.core.IOManager.shared_object().set_default_path(os.path.abspath(os.path.expanduser(args["scratch"])))
+    psi4.core.set_num_threads(int(args["nthread"]), quiet=True)
+    psi4.core.set_memory_bytes(524288000, True)
+    psi4.core.be_quiet()
+    psi4.json_server.serve(port=args["server_port"])
+    sys.exit()
+
 if not os.path.isfile(args["input"]):
     raise KeyError("The file %s does not exist." % args["input"])
 args["input"] = os.path.normpath(args["input"])
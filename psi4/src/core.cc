@@ -28,6 +28,7 @@
 
 #include <cstdio>
 #include <sstream>
+#include <algorithm>
 #include <map>
 #include <iomanip>
 #include <sys/stat.h>
@@ -43,16 +44,30 @@
 #include "psi4/liboptions/liboptions_python.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_broker.h"
+#include "psi4/libpsi4util/shared_segment.h"
 
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/cc/ccwave.h"
 #include "psi4/cc/cclambda/cclambda.h"
+#include "psi4/libqt/blas_backend.h"
 #include "psi4/libqt/qt.h"
+#include "psi4/libqt/trace.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/psifiles.h"
 #include "psi4/libmints/writer_file_prefix.h"
+#include "psi4/lib3index/dftensor.h"
+#include "psi4/libmints/x2cint.h"
+#include "read_options_table.h"
+#ifdef USING_PCMSolver
+#include "psi4/libpsipcm/psipcm.h"
+#endif
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
 
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
@@ -113,6 +128,7 @@ SharedWavefunction detci(SharedWavefunction, Options&);
 }
 namespace dfmp2 {
 SharedWavefunction dfmp2(SharedWavefunction, Options&);
+SharedWavefunction dfmp2_f12(SharedWavefunction, Options&);
 }
 namespace dfoccwave {
 SharedWavefunction dfoccwave(SharedWavefunction, Options&);
@@ -130,11 +146,12 @@ namespace mcscf {
 SharedWavefunction mcscf(SharedWavefunction, Options&);
 }
 
-#ifdef USING_gdma
 namespace gdma_interface {
+#ifdef USING_gdma
 SharedWavefunction gdma_interface(SharedWavefunction, Options&, const std::string& datfilename);
-}
 #endif
+SharedWavefunction native_dma(SharedWavefunction, Options&);
+}
 
 // Matrix returns
 namespace scfgrad {
@@ -212,7 +229,82 @@ std::string to_upper(const std::string& key) {
     return nonconst_key;
 }
 
-void py_flush_outfile() {}
+// Last read_options block whose global options are registered (-1 is the prelude, -2 nothing)
+static int global_option_blocks_read = -2;
+
+/// Registers the global options of the read_options blocks up to and including last
+static void load_global_option_blocks(int last) {
+    if (last <= global_option_blocks_read) return;
+    Options& options = Process::environment.options;
+    options.set_global_blocks(global_option_blocks_read + 1, last + 1);
+    options.set_read_globals(true);
+    read_options("", options, true);
+    options.set_read_globals(false);
+    options.set_global_blocks();
+    global_option_blocks_read = last;
+}
+
+/// Global option loader: registers the blocks the precomputed table says key needs ("" for all)
+static void load_global_options(const std::string& key) {
+    if (key.empty()) {
+        load_global_option_blocks(option_block_count - 1);
+        return;
+    }
+    const OptionBlockEntry* end = option_block_table + option_block_table_size;
+    const OptionBlockEntry* entry = std::lower_bound(
+        option_block_table, end, key, [](const OptionBlockEntry& e, const std::string& k) { return k.compare(e.key) > 0; });
+    if (entry != end && key == entry->key) load_global_option_blocks(entry->block);
+}
+
+/// Registers the always needed global options; module blocks follow on first use
+static void register_global_options() {
+    global_option_blocks_read = -2;
+    load_global_option_blocks(-1);
+    Process::environment.options.set_global_loader(load_global_options);
+}
+
+// Every MPI rank runs the same input; only the root writes the output file
+std::string py_rank_outfile_name(const std::string& ofname) {
+#ifdef ENABLE_MPI
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank != 0) return "/dev/null";
+#endif
+    return ofname;
+}
+
+// Flush policy applied to every output file opened from here on
+FlushPolicy outfile_flush_policy = FlushPolicy::Buffered;
+int outfile_flush_interval = 250;
+
+std::shared_ptr<PsiOutStream> py_open_outfile(const std::string& name, std::ios_base::openmode mode) {
+    // Anything still buffered for a previous stream on the same file goes out first
+    if (outfile) outfile->flush();
+    auto stream = std::make_shared<PsiOutStream>(py_rank_outfile_name(name), mode);
+    stream->set_flush_policy(outfile_flush_policy, std::chrono::milliseconds(outfile_flush_interval));
+    return stream;
+}
+
+void py_set_output_flush_policy(const std::string& policy, int interval) {
+    std::string upper = to_upper_copy(policy);
+    if (upper == "IMMEDIATE") {
+        outfile_flush_policy = FlushPolicy::Immediate;
+    } else if (upper == "BUFFERED") {
+        outfile_flush_policy = FlushPolicy::Buffered;
+    } else {
+        throw PSIEXCEPTION("set_output_flush_policy: policy must be IMMEDIATE or BUFFERED, not " + policy + ".");
+    }
+    if (interval <= 0) throw PSIEXCEPTION("set_output_flush_policy: the flush interval must be positive.");
+    outfile_flush_interval = interval;
+
+    // Standard output stays Immediate
+    if (outfile && outfile_name != "stdout")
+        outfile->set_flush_policy(outfile_flush_policy, std::chrono::milliseconds(outfile_flush_interval));
+}
+
+void py_flush_outfile() {
+    if (outfile) outfile->flush();
+}
 
 void py_close_outfile() {
     if (outfile) {
@@ -225,7 +317,7 @@ void py_reopen_outfile() {
         // outfile = stdout;
     } else {
         auto mode =  std::ostream::app;
-        outfile = std::make_shared<PsiOutStream>(outfile_name, mode);
+        outfile = py_open_outfile(outfile_name, mode);
         if (!outfile) throw PSIEXCEPTION("Psi4: Unable to reopen output file.");
     }
 }
@@ -318,6 +410,11 @@ SharedWavefunction py_psi_dfmp2(SharedWavefunction ref_wfn) {
     return dfmp2::dfmp2(ref_wfn, Process::environment.options);
 }
 
+SharedWavefunction py_psi_dfmp2_f12(SharedWavefunction ref_wfn) {
+    py_psi_prepare_options_for_module("DFMP2");
+    return dfmp2::dfmp2_f12(ref_wfn, Process::environment.options);
+}
+
 double py_psi_sapt(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefunction MonomerB) {
     py_psi_prepare_options_for_module("SAPT");
     if (sapt::sapt(Dimer, MonomerA, MonomerB, Process::environment.options) == Success) {
@@ -369,6 +466,12 @@ double py_psi_gdma(SharedWavefunction ref_wfn, const std::string& datfilename) {
 }
 #endif
 
+double py_psi_native_dma(SharedWavefunction ref_wfn) {
+    py_psi_prepare_options_for_module("GDMA");
+    gdma_interface::native_dma(ref_wfn, Process::environment.options);
+    return 0.0;
+}
+
 #ifdef USING_CheMPS2
 SharedWavefunction py_psi_dmrg(SharedWavefunction ref_wfn) {
     py_psi_prepare_options_for_module("DMRG");
@@ -488,7 +591,26 @@ char const* py_psi_git_version() {
 #endif
 }
 
-void py_psi_clean() { PSIOManager::shared_object()->psiclean(); }
+void py_psi_clean() {
+    PSIOManager::shared_object()->psiclean();
+    pool::release_cache();
+    FittingMetric::clear_cache();
+    X2CInt::clear_cache();
+#ifdef USING_PCMSolver
+    PCM::clear_cache();
+#endif
+}
+
+void py_psi_reset_environment() {
+    // Per-job state only; the content-keyed caches cleared by py_psi_clean stay warm for the next job
+    PSIOManager::shared_object()->psiclean();
+    Process::environment.set_molecule(std::shared_ptr<Molecule>());
+    Process::environment.set_legacy_molecule(std::shared_ptr<Molecule>());
+    Process::environment.set_legacy_wavefunction(std::shared_ptr<Wavefunction>());
+    Process::environment.set_parent_symmetry(std::shared_ptr<PointGroup>());
+    Process::environment.set_gradient(SharedMatrix());
+    Process::environment.memory_broker().reset_statistics();
+}
 
 void py_psi_print_options() { Process::environment.options.print(); }
 
@@ -498,8 +620,10 @@ std::vector<std::string> py_psi_get_global_option_list() { return Process::envir
 
 void py_psi_clean_options() {
     Process::environment.options.clear();
+    register_global_options();
+    // Plugin globals come after every module's, as in load_plugin
+    if (!plugins.empty()) Process::environment.options.load_globals();
     Process::environment.options.set_read_globals(true);
-    read_options("", Process::environment.options, true);
     for (std::map<std::string, plugin_info>::iterator it=plugins.begin(); it!=plugins.end(); ++it) {
         // Get the plugin options back into the global space
         it->second.read_options(it->second.name, Process::environment.options);
@@ -507,7 +631,7 @@ void py_psi_clean_options() {
     Process::environment.options.set_read_globals(false);
 }
 
-void py_psi_print_out(std::string s) { (*outfile->stream()) << s; }
+void py_psi_print_out(std::string s) { outfile->Printf(s); }
 
 /**
  * @return whether key describes a convergence threshold or not
@@ -948,6 +1072,16 @@ bool psi4_python_module_initialize() {
         return true;
     }
 
+#ifdef ENABLE_MPI
+    int mpi_initialized = 0;
+    MPI_Initialized(&mpi_initialized);
+    if (!mpi_initialized) {
+        // DirectJK calls MPI from the master thread only
+        int provided;
+        MPI_Init_thread(nullptr, nullptr, MPI_THREAD_FUNNELED, &provided);
+    }
+#endif
+
     // Setup the environment
     Process::environment.initialize();  // Defaults to obtaining the environment from the global environ variable
     Process::environment.set_memory(524288000);
@@ -966,10 +1100,8 @@ bool psi4_python_module_initialize() {
     // Initialize the I/O library
     psio_init();
 
-    // Setup globals options
-    Process::environment.options.set_read_globals(true);
-    read_options("", Process::environment.options, true);
-    Process::environment.options.set_read_globals(false);
+    // Setup globals options; each module's are registered when first looked up
+    register_global_options();
 
 #ifdef INTEL_Fortran_ENABLED
     static int argc = 1;
@@ -993,8 +1125,15 @@ void psi4_python_module_finalize() {
     // There is only one timer:
     timer_done();
 
+    close_event_file();
     outfile = std::shared_ptr<PsiOutStream>();
     psi_file_prefix = nullptr;
+
+#ifdef ENABLE_MPI
+    int mpi_finalized = 0;
+    MPI_Finalized(&mpi_finalized);
+    if (!mpi_finalized) MPI_Finalize();
+#endif
 }
 
 PYBIND11_MODULE(core, core) {
@@ -1028,6 +1167,9 @@ PYBIND11_MODULE(core, core) {
     core.def("git_version", py_psi_git_version, "Returns the git version of this copy of Psi.");
     core.def("clean", py_psi_clean, "Function to remove scratch files. Call between independent jobs.");
     core.def("clean_options", py_psi_clean_options, "Function to reset options to clean state.");
+    core.def("reset_environment", py_psi_reset_environment,
+             "Removes scratch files and forgets the active molecule, wavefunction, and gradient, keeping warm the "
+             "caches that clean() empties. Call between independent jobs of a long-lived process.");
 
     core.def("get_writer_file_prefix", get_writer_file_prefix,
              "Returns the prefix to use for writing files for external programs.");
@@ -1073,6 +1215,17 @@ PYBIND11_MODULE(core, core) {
     core.def("set_memory_bytes", py_psi_set_memory, py::arg("memory"), py::arg("quiet") = false,
              "Sets the memory available to Psi (in bytes).");
     core.def("get_memory", py_psi_get_memory, "Returns the amount of memory available to Psi (in bytes).");
+    core.def("memory_peak_granted", []() { return Process::environment.memory_broker().peak_granted(); },
+             "Returns the most memory (in bytes) granted to modules at once since the last reset_environment.");
+    core.def("print_memory_budgets", []() { Process::environment.memory_broker().print_report(outfile); },
+             "Prints the memory granted to and used by each module, now and at peak.");
+    core.def("set_shared_memory_session", [](const std::string& session) { SharedSegment::set_session(session); },
+             "Shares DF integrals, fitting metrics and DFT collocation with other processes of the named session on "
+             "this node from now on; an empty name stops sharing.");
+    core.def("shared_memory_session", []() { return SharedSegment::session(); },
+             "Returns the current shared-memory session, empty if none.");
+    core.def("unlink_shared_memory_session", &SharedSegment::unlink_session, py::arg("session"),
+             "Removes every shared-memory segment of the named session, returning how many there were.");
     core.def("set_datadir", [](const std::string& pdd) { Process::environment.set_datadir(pdd); },
              "Returns the amount of memory available to Psi (in bytes).");
     core.def("get_datadir", []() { return Process::environment.get_datadir(); },
@@ -1178,6 +1331,43 @@ PYBIND11_MODULE(core, core) {
     core.def("psi_top_srcdir", py_psi_top_srcdir, "Returns the location of the source code.");
 
     core.def("flush_outfile", py_flush_outfile, "Flushes the output file.");
+    core.def("set_output_flush_policy", py_set_output_flush_policy, py::arg("policy"), py::arg("interval") = 250,
+             "Sets how output files are written: IMMEDIATE, at every print, or BUFFERED (the default), "
+             "from a background thread at most interval milliseconds after printing. Applies to the current "
+             "and later output files; standard output is always IMMEDIATE.");
+    core.def("open_event_file", open_event_file, py::arg("filename"),
+             "Starts writing structured events, one JSON object per line, to filename.");
+    core.def("close_event_file", close_event_file, "Writes out and closes the event file, if open.");
+    core.def("event_file_open", event_file_open, "Whether structured events are being written.");
+    core.def("emit_event", &emit_event, py::arg("name"), py::arg("values"),
+             py::arg("labels") = std::map<std::string, std::string>(),
+             "Writes an event with numeric values and string labels to the event file, if one is open.");
+    core.def("timer_trace_start", &trace::start_recording, py::arg("max_events") = 1 << 20,
+             "Records every timed scope (up to max_events per thread) for timer_trace_write.");
+    core.def("timer_trace_stop", &trace::stop_recording, "Stops recording timed scopes.");
+    core.def("timer_trace_write", &trace::write_chrome_trace, py::arg("filename"),
+             "Writes the recorded timed scopes as Chrome-trace JSON (chrome://tracing, Perfetto).");
+    core.def("timer_totals",
+             []() {
+                 py::dict result;
+                 for (const trace::Total& total : trace::totals()) {
+                     py::dict entry;
+                     entry["calls"] = total.calls;
+                     entry["wall"] = total.wtime;
+                     entry["user"] = total.utime;
+                     entry["system"] = total.stime;
+                     entry["serial"] = total.serial;
+                     result[py::str(total.name)] = entry;
+                 }
+                 return result;
+             },
+             "Returns the calls and seconds of every timer so far, summed over threads and call paths, by name.");
+    core.def("blas_backend", &blas::backend, "The BLAS whose thread counts psi4 controls: MKL, OpenBLAS or generic.");
+    core.def("set_gemm_profiling", &blas::set_gemm_profiling, py::arg("on") = true,
+             "Counts the sizes of all GEMMs, per threading region, for print_gemm_histogram.");
+    core.def("print_gemm_histogram", []() { blas::print_gemm_histogram(outfile); },
+             "Prints the GEMM size histograms recorded since set_gemm_profiling.");
+    core.def("reset_gemm_histogram", &blas::reset_gemm_histogram, "Drops the recorded GEMM sizes.");
     core.def("close_outfile", py_close_outfile, "Closes the output file.");
     core.def("reopen_outfile", py_reopen_outfile, "Reopens the output file.");
     core.def("outfile_name", py_get_outfile_name, "Returns the name of the output file.");
@@ -1192,6 +1382,7 @@ PYBIND11_MODULE(core, core) {
     core.def("dcft", py_psi_dcft, "Runs the density cumulant functional theory code.");
     core.def("libfock", py_psi_libfock, "Runs a CPHF calculation, using libfock.");
     core.def("dfmp2", py_psi_dfmp2, "Runs the DF-MP2 code.");
+    core.def("dfmp2_f12", py_psi_dfmp2_f12, "Runs the DF-MP2-F12 code.");
     core.def("mcscf", py_psi_mcscf, "Runs the MCSCF code, (N.B. restricted to certain active spaces).");
     core.def("mrcc_generate_input", py_psi_mrcc_generate_input, "Generates an input for Kallay's MRCC code.");
     core.def("mrcc_load_densities", py_psi_mrcc_load_densities,
@@ -1208,6 +1399,7 @@ PYBIND11_MODULE(core, core) {
     core.def("detci", py_psi_detci, "Runs the determinant-based configuration interaction code.");
     core.def("dmrg", py_psi_dmrg, "Runs the DMRG code.");
     core.def("run_gdma", py_psi_gdma, "Runs the GDMA code.");
+    core.def("run_native_dma", py_psi_native_dma, "Runs the built-in, threaded standard DMA.");
     core.def("fnocc", py_psi_fnocc, "Runs the fno-ccsd(t)/qcisd(t)/mp4/cepa energy code");
     core.def("cchbar", py_psi_cchbar, "Runs the code to generate the similarity transformed Hamiltonian.");
     core.def("cclambda", py_psi_cclambda, "Runs the coupled cluster lambda equations code.");
@@ -1222,12 +1414,12 @@ PYBIND11_MODULE(core, core) {
     core.def("get_options", py_psi_get_options, py::return_value_policy::reference, "Get options");
     core.def("set_output_file", [](const std::string ofname) {
         auto mode = std::ostream::trunc;
-        outfile = std::make_shared<PsiOutStream>(ofname, mode);
+        outfile = py_open_outfile(ofname, mode);
         outfile_name = ofname;
     });
     core.def("set_output_file", [](const std::string ofname, bool append) {
         auto mode = append ? std::ostream::app : std::ostream::trunc;
-        outfile = std::make_shared<PsiOutStream>(ofname, mode);
+        outfile = py_open_outfile(ofname, mode);
         outfile_name = ofname;
     });
     core.def("get_output_file", []() { return outfile_name; });
@@ -27,6 +27,7 @@
  */
 
 #include "psi4/libmints/benchmark.h"
+#include "psi4/libmints/basisset.h"
 #include "psi4/pybind11.h"
 
 void export_benchmarks(py::module& m) {
@@ -36,4 +37,7 @@ void export_benchmarks(py::module& m) {
     m.def("benchmark_disk", &psi::benchmark_disk, "docstring");
     m.def("benchmark_math", &psi::benchmark_math, "docstring");
     m.def("benchmark_integrals", &psi::benchmark_integrals, "docstring");
+    m.def("benchmark_integrals_json", &psi::benchmark_integrals_json,
+          "Times ERIs, derivative ERIs, 3C ERIs and the Boys function per backend; returns JSON",
+          py::arg("basis"), py::arg("max_am"), py::arg("min_time"));
 }
@@ -30,6 +30,7 @@
 
 #include "psi4/libdiis/diisentry.h"
 #include "psi4/libdiis/diismanager.h"
+#include "psi4/libdiis/ediis.h"
 
 using namespace psi;
 
@@ -38,5 +39,22 @@ void export_diis(py::module &m) {
     py::class_<DIISManager, std::shared_ptr<DIISManager> >(m, "DIISManager", "docstring")
         .def(py::init<>())
         .def("reset_subspace", &DIISManager::reset_subspace, "docstring")
-        .def("delete_diis_file", &DIISManager::delete_diis_file, "docstring");
+        .def("delete_diis_file", &DIISManager::delete_diis_file, "docstring")
+        .def("subspace_size", &DIISManager::subspace_size, "Number of vectors currently in the subspace")
+        .def("coefficients", &DIISManager::coefficients, "Coefficients used in the last extrapolation")
+        .def("set_anderson_mixing", &DIISManager::set_anderson_mixing, "Anderson mixing parameter (0.0 is DIIS)");
+
+    py::class_<EnergyDIIS, std::shared_ptr<EnergyDIIS> > ediis(m, "EnergyDIIS", "EDIIS/ADIIS SCF accelerator");
+    py::enum_<EnergyDIIS::Model>(ediis, "Model")
+        .value("EDIIS", EnergyDIIS::EDIIS)
+        .value("ADIIS", EnergyDIIS::ADIIS)
+        .export_values();
+    ediis.def(py::init<int, EnergyDIIS::Model, double>())
+        .def("add_entry", &EnergyDIIS::add_entry, "Add an energy with its densities and Fock matrices")
+        .def("extrapolate", &EnergyDIIS::extrapolate, "Overwrite F with the model-optimal Fock combination")
+        .def("reset_subspace", &EnergyDIIS::reset_subspace, "Forget all entries")
+        .def("subspace_size", &EnergyDIIS::subspace_size, "Number of stored entries")
+        .def("coefficients", &EnergyDIIS::coefficients, "Coefficients used in the last extrapolation")
+        .def_static("minimize_on_simplex", &EnergyDIIS::minimize_on_simplex,
+                    "Minimize g.c + 1/2 c.H.c over the probability simplex");
 }
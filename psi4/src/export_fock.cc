@@ -27,6 +27,7 @@
  */
 
 #include "psi4/pybind11.h"
+#include <pybind11/numpy.h>
 
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/soscf.h"
@@ -58,7 +59,26 @@ void export_fock(py::module &m) {
         .def("set_do_K", &JK::set_do_K)
         .def("set_do_wK", &JK::set_do_wK)
         .def("set_omega", &JK::set_omega)
+        .def("set_rank_cutoff", &JK::set_rank_cutoff,
+             "Relative cutoff for truncating the rank of the densities in DF/CD K builds")
+        .def("C_ranks", &JK::C_ranks,
+             "Number of orbital columns each density of the last compute() was contracted with")
         .def("compute", &JK::compute)
+        .def("compute_batch",
+             [](JK &jk, std::vector<SharedMatrix> Cl, std::vector<SharedMatrix> Cr) {
+                 std::vector<SharedMatrix> J, K, wK;
+                 jk.compute_batch(Cl, Cr, J, K, wK);
+                 return std::make_tuple(J, K, wK);
+             },
+             "Computes (J, K, wK) lists for many C_left/C_right pairs in as few integral passes as memory allows",
+             py::arg("C_left"), py::arg("C_right") = std::vector<SharedMatrix>())
+        .def("batch_densities", &JK::batch_densities, "Number of the given pairs one compute() can take")
+        .def("single_pass_densities", &JK::single_pass_densities,
+             "Does one compute() touch each integral block once for all densities?")
+        .def("fused_K_densities", &JK::fused_K_densities, "Are the K builds done in the same pass as J?")
+        .def("shared_pair_screening", &JK::shared_pair_screening,
+             "Is one screened pair list shared by all densities of a batch?")
+        .def("max_batch_densities", &JK::max_batch_densities, "Engine limit on densities per compute(), 0 if none")
         .def("finalize", &JK::finalize)
         .def("C_clear",
              [](JK &jk) {
@@ -168,7 +188,16 @@ void export_fock(py::module &m) {
         .def("get_tensor_size", &DFHelper::get_tensor_size)
         .def("get_tensor_shape", &DFHelper::get_tensor_shape)
         .def("get_tensor", take_string(&DFHelper::get_tensor))
-        .def("get_tensor", tensor_access3(&DFHelper::get_tensor));
+        .def("get_tensor", tensor_access3(&DFHelper::get_tensor))
+        .def("get_tensor_view",
+             [](DFHelper& dfh, std::string name) {
+                 auto buffer = dfh.get_tensor_buffer(name);
+                 std::vector<size_t> shape{std::get<0>(buffer.second), std::get<1>(buffer.second),
+                                           std::get<2>(buffer.second)};
+                 // The view keeps the DFHelper alive, not the buffer: it dangles after transform() or clear_all()
+                 return py::array(shape, buffer.first, py::cast(&dfh));
+             },
+             "Returns a NumPy view (no copy) of an in-core (MO_core) transformed tensor", py::arg("name"));
 
     py::class_<scf::SADGuess, std::shared_ptr<scf::SADGuess>>(m, "SADGuess", "docstring")
         .def_static("build_SAD",
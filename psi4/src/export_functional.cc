@@ -106,6 +106,8 @@ void export_functional(py::module &m) {
         .def("set_vv10_c", &SuperFunctional::set_vv10_c, "Sets the VV10 c parameter.")
         .def("set_do_vv10", &SuperFunctional::set_do_vv10, "Sets whether to do VV10 correction.")
         .def("set_grac_shift", &SuperFunctional::set_grac_shift, "Sets the GRAC bulk shift value.")
+        .def("set_native_kernels", &SuperFunctional::set_native_kernels,
+             "Allows the LibXC components to use the native closed-shell kernels.")
         .def("set_grac_alpha", &SuperFunctional::set_grac_alpha, "Sets the GRAC alpha parameter.")
         .def("set_grac_beta", &SuperFunctional::set_grac_beta, "Sets the GRAC beta parameter.")
         .def("needs_xc", &SuperFunctional::needs_xc, "Does this functional need XC quantities.")
@@ -146,6 +148,10 @@ void export_functional(py::module &m) {
         .def("get_mix_data", &LibXCFunctional::get_mix_data, "docstring")
         .def("set_tweak", &LibXCFunctional::set_tweak, "docstring")
         .def("set_omega", &LibXCFunctional::set_omega, "docstring")
+        .def("set_native_kernels", &LibXCFunctional::set_native_kernels,
+             "Allows the closed-shell energy and potential to be evaluated by the native kernels.")
+        .def("native_kernels", &LibXCFunctional::native_kernels,
+             "Whether the closed-shell energy and potential are evaluated by the native kernels.")
         .def("query_libxc", &LibXCFunctional::query_libxc, "query libxc regarding functional parameters.");
 
     py::class_<VBase, std::shared_ptr<VBase>>(m, "VBase", "docstring")
@@ -293,6 +299,10 @@ void export_functional(py::module &m) {
         .def("compute_energy", &Dispersion::compute_energy, "docstring")
         .def("compute_gradient", &Dispersion::compute_gradient, "docstring")
         .def("compute_hessian", &Dispersion::compute_hessian, "docstring")
+        .def("compute_energies", &Dispersion::compute_energies, py::arg("molecule"), py::arg("geometries"),
+             "Energies of molecule at each of a list of natom x 3 geometries [bohr], threaded over geometries.")
+        .def("cutoff", &Dispersion::get_cutoff, "Pair cutoff distance [bohr]; zero keeps all pairs.")
+        .def("set_cutoff", &Dispersion::set_cutoff, "Drop pairs beyond this distance [bohr] through a neighbor list.")
         .def("d", &Dispersion::get_d, "docstring")
         .def("s6", &Dispersion::get_s6, "docstring")
         .def("sr6", &Dispersion::get_sr6, "docstring")
@@ -311,5 +321,9 @@ void export_functional(py::module &m) {
         .def("project_densities", &sapt::FDDS_Dispersion::project_densities,
              "Projects a density from the primary AO to auxiliary AO space.")
         .def("form_unc_amplitude", &sapt::FDDS_Dispersion::form_unc_amplitude,
-             "Forms the uncoupled amplitudes for either monomer.");
+             "Forms the uncoupled amplitudes for either monomer.")
+        .def("form_aux_compression", &sapt::FDDS_Dispersion::form_aux_compression,
+             "Builds the truncated auxiliary basis of a monomer's response.")
+        .def("form_unc_amplitude_lr", &sapt::FDDS_Dispersion::form_unc_amplitude_lr,
+             "Forms the uncoupled amplitudes for either monomer in the compressed auxiliary basis.");
 }
@@ -67,7 +67,9 @@
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/quadrupole.h"
 #include "psi4/libmints/dipole.h"
+#include "psi4/libmints/blocksparse.h"
 #include "psi4/libmints/overlap.h"
+#include "psi4/libmints/vibanal.h"
 
 #include <string>
 
@@ -998,6 +1000,9 @@ void export_mints(py::module& m) {
         .def("ao_pvp", &MintsHelper::ao_pvp, "AO pvp integrals")
         .def("ao_dkh", &MintsHelper::ao_dkh, "AO dkh integrals")
         .def("so_dkh", &MintsHelper::so_dkh, "SO dkh integrals")
+        .def("ao_one_electron", &MintsHelper::ao_one_electron,
+             "AO overlap, kinetic, potential, and (optionally) dipole integrals computed in one pass",
+             py::arg("include_dipole") = true)
         .def("ao_dipole", &MintsHelper::ao_dipole, "Vector AO dipole integrals")
         .def("so_dipole", &MintsHelper::so_dipole, "Vector SO dipole integrals")
         .def("ao_quadrupole", &MintsHelper::ao_quadrupole, "Vector AO quadrupole integrals")
@@ -1079,6 +1084,59 @@ void export_mints(py::module& m) {
         .def("mo_tei_deriv1", &MintsHelper::mo_tei_deriv1, "Gradient of MO basis TEI integrals: returns (3 * natoms) matrices")
         .def("mo_tei_deriv2", &MintsHelper::mo_tei_deriv2, "Hessian  of MO basis TEI integrals: returns (3 * natoms)^2 matrices");
 
+        py::class_<BlockSparseMatrix, std::shared_ptr<BlockSparseMatrix>>(
+            m, "BlockSparseMatrix", "Shell-block sparse (block-CSR) AO matrix with per-block Frobenius norms")
+        .def(py::init<std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>>())
+        .def_static("from_matrix", &BlockSparseMatrix::from_matrix,
+                    "Compress a C1 Matrix, dropping shell blocks with norm <= threshold", py::arg("M"), py::arg("rows"),
+                    py::arg("cols"), py::arg("threshold") = 0.0)
+        .def("to_matrix", &BlockSparseMatrix::to_matrix, "Expand into a dense Matrix", py::arg("name") = "")
+        .def_static("multiply", &BlockSparseMatrix::multiply, "Sparse product A B with block screening",
+                    py::arg("A"), py::arg("B"), py::arg("threshold") = 0.0)
+        .def_static("add", &BlockSparseMatrix::add, "alpha A + beta B with block screening", py::arg("alpha"),
+                    py::arg("A"), py::arg("beta"), py::arg("B"), py::arg("threshold") = 0.0)
+        .def("scale", &BlockSparseMatrix::scale, "Scale all stored blocks")
+        .def("vector_dot", py::overload_cast<const BlockSparseMatrix&>(&BlockSparseMatrix::vector_dot, py::const_),
+             "Elementwise dot with another sparse matrix")
+        .def("vector_dot", py::overload_cast<const SharedMatrix&>(&BlockSparseMatrix::vector_dot, py::const_),
+             "Elementwise dot with a dense Matrix")
+        .def("nblocks", &BlockSparseMatrix::nblocks, "Number of stored shell blocks")
+        .def("fill", &BlockSparseMatrix::fill, "Fraction of shell blocks stored")
+        .def("print_summary", &BlockSparseMatrix::print_summary, "Print block statistics", py::arg("label") = "");
+
+    py::class_<VibAnalysisResult>(m, "VibAnalysisResult",
+                                  "Harmonic frequencies and thermochemistry of one system of a BatchVibAnalysis run")
+        .def_readonly("frequencies", &VibAnalysisResult::frequencies,
+                      "Vibrational frequencies [cm^-1], imaginary ones negative")
+        .def_readonly("normal_modes", &VibAnalysisResult::normal_modes,
+                      "Normalized mass-weighted normal modes (3 nat x nvib), if requested")
+        .def_readonly("nrt", &VibAnalysisResult::nrt, "Number of translations and rotations projected out")
+        .def_readonly("nimag", &VibAnalysisResult::nimag, "Number of imaginary modes")
+        .def_readonly("lnq_elec", &VibAnalysisResult::lnq_elec, "ln of the electronic partition function")
+        .def_readonly("lnq_trans", &VibAnalysisResult::lnq_trans, "ln of the translational partition function")
+        .def_readonly("lnq_rot", &VibAnalysisResult::lnq_rot, "ln of the rotational partition function")
+        .def_readonly("lnq_vib", &VibAnalysisResult::lnq_vib,
+                      "ln of the vibrational partition function, from the zero-point level")
+        .def_readonly("ZPE", &VibAnalysisResult::ZPE, "Zero-point energy correction [Eh]")
+        .def_readonly("E", &VibAnalysisResult::E, "Thermal energy correction [Eh]")
+        .def_readonly("H", &VibAnalysisResult::H, "Enthalpy correction [Eh]")
+        .def_readonly("G", &VibAnalysisResult::G, "Gibbs free energy correction [Eh]")
+        .def_readonly("S", &VibAnalysisResult::S, "Total entropy [mEh/K]")
+        .def_readonly("Cv", &VibAnalysisResult::Cv, "Total constant volume heat capacity [mEh/K]")
+        .def_readonly("Cp", &VibAnalysisResult::Cp, "Total constant pressure heat capacity [mEh/K]")
+        .def_readonly("error", &VibAnalysisResult::error, "Why the system could not be analyzed, empty otherwise");
+
+    py::class_<BatchVibAnalysis, std::shared_ptr<BatchVibAnalysis>>(
+        m, "BatchVibAnalysis", "Harmonic vibrational analysis and thermochemistry of many Hessians at once")
+        .def(py::init<double, double, bool, bool>(), py::arg("T"), py::arg("P"), py::arg("project_trans") = true,
+             py::arg("project_rot") = true)
+        .def("add_system", &BatchVibAnalysis::add_system,
+             "Queues a non-mass-weighted Hessian of a molecule; a positive sigma overrides its rotational symmetry number",
+             py::arg("hessian"), py::arg("molecule"), py::arg("sigma") = 0)
+        .def("nsystem", &BatchVibAnalysis::nsystem, "Number of queued systems")
+        .def("set_normal_modes", &BatchVibAnalysis::set_normal_modes, "Also return the vibrational normal modes")
+        .def("compute", &BatchVibAnalysis::compute, "Analyzes every queued system, spread over the job's threads");
+
         py::class_<Vector3>(m, "Vector3",
                         "Class for vectors of length three, often Cartesian coordinate vectors, "
                         "and their common operations")
@@ -1490,6 +1548,12 @@ void export_mints(py::module& m) {
         .def("clear", &ExternalPotential::clear, "Reset the field to zero (eliminates all entries)")
         .def("computePotentialMatrix", &ExternalPotential::computePotentialMatrix,
              "Compute the external potential matrix in the given basis set", py::arg("basis"))
+        .def("computeChargeGradients", &ExternalPotential::computeChargeGradients,
+             "Compute the gradient on the external charges due to the given basis set's density and nuclei",
+             py::arg("basis"), py::arg("Dt"))
+        .def("set_far_field", &ExternalPotential::set_far_field,
+             "Expand charges beyond cutoff (bohr) of each shell pair in octree multipoles", py::arg("cutoff"),
+             py::arg("theta") = 0.3)
         .def("print_out", &ExternalPotential::py_print, "Print python print helper to the outfile");
 
     typedef std::shared_ptr<Localizer> (*localizer_with_type)(const std::string&, std::shared_ptr<BasisSet>,
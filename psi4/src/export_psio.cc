@@ -47,6 +47,8 @@ void export_psio(py::module &m) {
              "Seek string in binary file. This export is only good for catching None, as returned success object not exported.")
         .def("getpid", &PSIO::getpid, "Lookup process id")
         .def("set_pid", &PSIO::set_pid, "Set process id", py::arg("pid"))
+        .def("bytes_read", &PSIO::bytes_read, "Total bytes read through this object since it was created")
+        .def("bytes_written", &PSIO::bytes_written, "Total bytes written through this object since it was created")
         .def_static("shared_object", &PSIO::shared_object, "Return the global shared object")
         .def_static("get_default_namespace", &PSIO::get_default_namespace, "Get the default namespace (for PREFIX.NAMESPACE.UNIT file numbering)")
         .def_static("set_default_namespace", &PSIO::set_default_namespace, "Set the current namespace (for PREFIX.NAMESPACE.UNIT file numbering)", py::arg("ns"))
@@ -63,5 +65,9 @@ void export_psio(py::module &m) {
         .def("set_specific_path", &PSIOManager::set_specific_path, "Set the path for specific file numbers", py::arg("fileno"), py::arg("path"))
         .def("get_file_path", &PSIOManager::get_file_path, "Get the path for a specific file number", py::arg("fileno"))
         .def("set_specific_retention", &PSIOManager::set_specific_retention, "Set the specific file number to be retained", py::arg("fileno"), py::arg("retain"))
+        .def("set_specific_compression", &PSIOManager::set_specific_compression, "Store the specific file number compressed", py::arg("fileno"), py::arg("compress"))
+        .def("set_specific_storage", &PSIOManager::set_specific_storage, "Keep the specific file number on DISK, in MEMORY, or in memory with SPILL to disk past the memory limit", py::arg("fileno"), py::arg("storage"))
+        .def("get_specific_storage", &PSIOManager::get_specific_storage, "Return the storage tier of the specific file number", py::arg("fileno"))
+        .def("set_memory_limit", &PSIOManager::set_memory_limit, "Set the bytes SPILL files may hold in memory, 0 for no limit", py::arg("bytes"))
         .def("get_default_path", &PSIOManager::get_default_path, "Return the default path");
 }
@@ -124,6 +124,11 @@ void export_trans(py::module& m) {
     typedef int (IntegralTransform::*DPD_ID_2)(const char);
     typedef int (IntegralTransform::*DPD_ID_3)(const std::shared_ptr<MOSpace>, const std::shared_ptr<MOSpace>,
                                                IntegralTransform::SpinType, bool);
+    typedef void (IntegralTransform::*transform_tei_4)(const std::shared_ptr<MOSpace>, const std::shared_ptr<MOSpace>,
+                                                       const std::shared_ptr<MOSpace>, const std::shared_ptr<MOSpace>,
+                                                       IntegralTransform::HalfTrans);
+    typedef void (IntegralTransform::*second_half_4)(const std::shared_ptr<MOSpace>, const std::shared_ptr<MOSpace>,
+                                                     const std::shared_ptr<MOSpace>, const std::shared_ptr<MOSpace>);
 
     int_trans_bind.def("initialize", &IntegralTransform::initialize, "Initialize an IntegralTransform")
         .def("presort_so_tei", &IntegralTransform::presort_so_tei, "docstring")
@@ -131,12 +136,12 @@ void export_trans(py::module& m) {
         .def("update_orbitals", &IntegralTransform::update_orbitals, "docstring")
         .def("transform_oei", &IntegralTransform::transform_oei, "Transform one-electron integrals", py::arg("s1"),
              py::arg("s2"), py::arg("labels"))
-        .def("transform_tei", &IntegralTransform::transform_tei, "Transform two-electron integrals", py::arg("s1"),
-             py::arg("s2"), py::arg("s3"), py::arg("s4"),
+        .def("transform_tei", transform_tei_4(&IntegralTransform::transform_tei), "Transform two-electron integrals",
+             py::arg("s1"), py::arg("s2"), py::arg("s3"), py::arg("s4"),
              py::arg("half_trans") = IntegralTransform::HalfTrans::MakeAndNuke)
         .def("transform_tei_first_half", &IntegralTransform::transform_tei_first_half,
              "First half-transform two-electron integrals", py::arg("s1"), py::arg("s2"))
-        .def("transform_tei_second_half", &IntegralTransform::transform_tei_second_half,
+        .def("transform_tei_second_half", second_half_4(&IntegralTransform::transform_tei_second_half),
              "Second half-transform two-electron integrals", py::arg("s1"), py::arg("s2"), py::arg("s3"), py::arg("s4"))
         .def("backtransform_density", &IntegralTransform::backtransform_density)
         .def("backtransform_tpdm_restricted", &IntegralTransform::backtransform_tpdm_restricted)
@@ -34,6 +34,7 @@
 #include "psi4/libmints/oeprop.h"
 #include "psi4/libmints/orbitalspace.h"
 #include "psi4/libmints/extern.h"
+#include "psi4/libmints/blocksparse.h"
 
 #include "psi4/libfock/jk.h"
 #include "psi4/libfock/soscf.h"
@@ -49,6 +50,7 @@
 #include "psi4/libscf_solver/uhf.h"
 #include "psi4/libscf_solver/rohf.h"
 #include "psi4/libscf_solver/cuhf.h"
+#include "psi4/libscf_solver/batch.h"
 #include "psi4/libfunctional/superfunctional.h"
 #include "psi4/libfock/v.h"
 
@@ -65,6 +67,8 @@
 #include "psi4/libpsipcm/psipcm.h"
 #endif
 
+#include <pybind11/functional.h>
+
 #include <string>
 
 using namespace psi;
@@ -199,8 +203,14 @@ void export_wavefunction(py::module& m) {
         .def("set_sad_basissets", &scf::HF::set_sad_basissets, "Sets the Superposition of Atomic Densities basisset.")
         .def("set_sad_fitting_basissets", &scf::HF::set_sad_fitting_basissets,
              "Sets the Superposition of Atomic Densities density-fitted basisset.")
+        .def("set_frag_basissets", &scf::HF::set_frag_basissets,
+             "Sets the fragment basissets and their full-molecule atom indices for the FRAG guess.")
+        .def("set_frag_fitting_basissets", &scf::HF::set_frag_fitting_basissets,
+             "Sets the fragment density-fitted basissets for the FRAG guess.")
         .def("Va", &scf::HF::Va, "Returns the Alpha Kohn-Sham Potential Matrix.")
         .def("Vb", &scf::HF::Vb, "Returns the Beta Kohn-Sham Potential Matrix.")
+        .def("Da_sparse", &scf::HF::Da_sparse, "Returns the shell-block sparse alpha density (SPARSE_AO_THRESHOLD).")
+        .def("Fa_sparse", &scf::HF::Fa_sparse, "Returns the shell-block sparse alpha Fock matrix (SPARSE_AO_THRESHOLD).")
         .def("jk", &scf::HF::jk, "Returns the internal JK object.")
         .def("set_jk", &scf::HF::set_jk, "Sets the internal JK object !expert.")
         .def("functional", &scf::HF::functional, "Returns the internal DFT Superfunctional.")
@@ -220,6 +230,20 @@ void export_wavefunction(py::module& m) {
         .def_property("initialized_diis_manager_", &scf::HF::initialized_diis_manager,
                       &scf::HF::set_initialized_diis_manager, "docstring")
         .def("damping_update", &scf::HF::damping_update, "docstring")
+        .def("iterate", &scf::HF::iterate,
+             "Runs the native SCF iteration loop, returns (converged, last energy change, last orbital gradient RMS)",
+             py::arg("e_conv"), py::arg("d_conv"))
+        .def("set_iteration_callback", &scf::HF::set_iteration_callback,
+             "Sets a function called with the iteration number after each native SCF iteration, None to clear")
+        .def("begin_iteration_stats", &scf::HF::begin_iteration_stats,
+             "Starts the telemetry of an iteration; call before form_G()")
+        .def("end_iteration_stats", &scf::HF::end_iteration_stats,
+             "Records and returns the telemetry of the last begun iteration, given the DIIS time (s) it took",
+             py::arg("energy"), py::arg("delta_e"), py::arg("d_rms"), py::arg("diis_time"), py::arg("status"))
+        .def("iteration_stats", &scf::HF::iteration_stats, "Per-iteration cost and convergence telemetry so far")
+        .def("print_iteration_stats", &scf::HF::print_iteration_stats, "Prints the per-iteration telemetry table")
+        .def("reset_stalled_diis", &scf::HF::reset_stalled_diis,
+             "With SCF_ADAPTIVE, resets the DIIS subspace if the telemetry shows it has stalled; true if it did")
         .def("check_phases", &scf::HF::check_phases, "docstring")
         .def("print_orbitals", &scf::HF::print_orbitals, "docstring")
         .def("print_header", &scf::HF::print_header, "docstring")
@@ -238,6 +262,8 @@ void export_wavefunction(py::module& m) {
                       "Are we to do excited-state MOM?")
         .def_property("MOM_performed_", &scf::HF::MOM_performed, &scf::HF::set_MOM_performed,
                       "MOM performed current iteration?")
+        .def_property("purify_", &scf::HF::purify, &scf::HF::set_purify,
+                      "Is the density built by Fock-matrix purification instead of from orbitals?")
         .def_property("attempt_number_", &scf::HF::attempt_number, &scf::HF::set_attempt_number,
                       "Current macroiteration (1-indexed) for stability analysis")
         .def("stability_analysis", &scf::HF::stability_analysis, "Assess wfn stability and correct if requested")
@@ -277,6 +303,39 @@ void export_wavefunction(py::module& m) {
              "BasisSet *basis*",
              py::arg("basis"));
 
+    py::class_<scf::SCFIterationStats>(m, "SCFIterationStats", "Cost and convergence telemetry of one SCF iteration")
+        .def_readonly("iteration", &scf::SCFIterationStats::iteration, "Iteration number")
+        .def_readonly("energy", &scf::SCFIterationStats::energy, "Total energy")
+        .def_readonly("delta_e", &scf::SCFIterationStats::delta_e, "Energy change")
+        .def_readonly("d_rms", &scf::SCFIterationStats::d_rms, "Orbital gradient RMS")
+        .def_readonly("total_time", &scf::SCFIterationStats::total_time, "Wall time (s) of the iteration")
+        .def_readonly("jk_time", &scf::SCFIterationStats::jk_time, "Wall time (s) of the J/K builds")
+        .def_readonly("v_time", &scf::SCFIterationStats::v_time, "Wall time (s) of the XC potential")
+        .def_readonly("diis_time", &scf::SCFIterationStats::diis_time, "Wall time (s) of the DIIS step")
+        .def_readonly("screened_fraction", &scf::SCFIterationStats::screened_fraction,
+                      "Fraction of shell quartets skipped by screening, -1 if not counted")
+        .def_readonly("io_bytes", &scf::SCFIterationStats::io_bytes, "Bytes read and written through PSIO")
+        .def_readonly("scf_type", &scf::SCFIterationStats::scf_type, "SCF_TYPE of the J/K engine")
+        .def_readonly("status", &scf::SCFIterationStats::status, "Status of the iteration (DIIS, MOM, ...)");
+
+    py::class_<scf::BatchSCFResult>(m, "BatchSCFResult", "Final state of one system of a BatchRHF run")
+        .def_readonly("energy", &scf::BatchSCFResult::energy, "Total SCF energy")
+        .def_readonly("iterations", &scf::BatchSCFResult::iterations, "Number of SCF iterations")
+        .def_readonly("converged", &scf::BatchSCFResult::converged, "Did the SCF converge?")
+        .def_readonly("Ca", &scf::BatchSCFResult::Ca, "AO orbital coefficients (nbf x nmo)")
+        .def_readonly("epsilon", &scf::BatchSCFResult::epsilon, "Orbital energies")
+        .def_readonly("error", &scf::BatchSCFResult::error, "Why the system could not be run, empty otherwise");
+
+    py::class_<scf::BatchRHF, std::shared_ptr<scf::BatchRHF>>(
+        m, "BatchRHF", "Runs many small independent RHF/RKS calculations concurrently, one per thread")
+        .def(py::init<Options&>())
+        .def("add_system", &scf::BatchRHF::add_system,
+             "Queues a closed-shell system; a null auxiliary basis selects DirectJK, a null functional runs HF",
+             py::arg("primary"), py::arg("auxiliary") = nullptr, py::arg("functional") = nullptr)
+        .def("nsystem", &scf::BatchRHF::nsystem, "Number of queued systems")
+        .def("compute", &scf::BatchRHF::compute,
+             "Runs every queued system, spread over the job's threads");
+
     /// EP2 functions
     py::class_<dfep2::DFEP2Wavefunction, std::shared_ptr<dfep2::DFEP2Wavefunction>, Wavefunction>(
         m, "DFEP2Wavefunction", "A density-fitted second-order Electron Propagator Wavefunction.")
@@ -0,0 +1,95 @@
+#
+# @BEGIN LICENSE
+#
+# Psi4: an open-source quantum chemistry software package
+#
+# Copyright (c) 2007-2019 The Psi4 Developers.
+#
+# The copyrights for code used from other parties are included in
+# the corresponding files.
+#
+# This file is part of Psi4.
+#
+# Psi4 is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# Psi4 is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public License along
+# with Psi4; if not, write to the Free Software Foundation, Inc.,
+# 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#
+# @END LICENSE
+#
+"""Generates the precomputed global option table from read_options.cc.
+
+Every ``if (name == "MODULE" || options.read_globals())`` section of
+read_options.cc is a numbered block (the unconditional prelude is block -1).
+For each keyword the table records the block that must be registered before
+the global is complete: the first block declaring it, or for string options
+(whose choices are merged across blocks) the last one.  Registering blocks -1
+through that index reproduces exactly the global default and choices an eager
+registration would produce.  core.cc uses the table to register global
+options on first use.
+
+Usage: python option_table.py read_options.cc read_options_table.h
+"""
+
+import re
+import sys
+
+block_re = re.compile(r'if\s*\(\s*name\s*==\s*"(\w+)"\s*\|\|\s*options\.read_globals\(\)\s*\)')
+add_re = re.compile(r'options\.add(\w*)\(\s*"(\w+)"')
+
+
+def strip_comments(text):
+    text = re.sub(r'/\*.*?\*/', lambda m: '\n' * m.group(0).count('\n'), text, flags=re.S)
+    return re.sub(r'//[^\n]*', '', text)
+
+
+def build_table(text):
+    text = strip_comments(text)
+    events = [(m.start(), 'block', m.group(1)) for m in block_re.finditer(text)]
+    events += [(m.start(), m.group(1), m.group(2)) for m in add_re.finditer(text)]
+    events.sort()
+
+    modules = []
+    keys = {}
+    for _, kind, value in events:
+        if kind == 'block':
+            modules.append(value)
+        elif kind in ('_str', '_str_i') or value.upper() not in keys:
+            keys[value.upper()] = len(modules) - 1
+    return modules, keys
+
+
+def write_header(modules, keys, fp):
+    fp.write('// Generated by option_table.py from read_options.cc; do not edit.\n')
+    fp.write('#ifndef _psi_src_read_options_table_h_\n#define _psi_src_read_options_table_h_\n\n')
+    fp.write('namespace psi {\nnamespace {\n\n')
+    fp.write('struct OptionBlockEntry {\n    const char* key;\n    int block;\n};\n\n')
+    fp.write('const int option_block_count = {};\n\n'.format(len(modules)))
+    fp.write('const char* const option_block_modules[] = {\n')
+    for module in modules:
+        fp.write('    "{}",\n'.format(module))
+    fp.write('};\n\n')
+    fp.write('// Sorted by key for binary search\n')
+    fp.write('const OptionBlockEntry option_block_table[] = {\n')
+    for key in sorted(keys):
+        fp.write('    {{"{}", {}}},\n'.format(key, keys[key]))
+    fp.write('};\n\n')
+    fp.write('const int option_block_table_size = {};\n\n'.format(len(keys)))
+    fp.write('}  // namespace\n}  // namespace psi\n\n#endif\n')
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+    with open(sys.argv[1]) as fp:
+        modules, keys = build_table(fp.read())
+    with open(sys.argv[2], 'w') as fp:
+        write_header(modules, keys, fp)
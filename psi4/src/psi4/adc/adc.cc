@@ -62,6 +62,8 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) : Wavefunction(opti
         navir += avirpi_[h];
         nbvir += bvirpi_[h];
     }
+    naocc_ = naocc;
+    navir_ = navir;
     aocce_ = new double[naocc];
     bocce_ = new double[nbocc];
     avire_ = new double[navir];
@@ -73,6 +75,9 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) : Wavefunction(opti
 
     aoccount = 0, boccount = 0, avircount = 0, bvircount = 0;
     for (int h = 0; h < nirrep_; h++) {
+        occ_sym_.insert(occ_sym_.end(), aoccpi_[h], h);
+        vir_sym_.insert(vir_sym_.end(), avirpi_[h], h);
+
         for (int a = frzcpi_[h]; a < doccpi_[h] + soccpi_[h]; a++) aocce_[aoccount++] = epsilon_a_->get(h, a);
 
         for (int b = frzcpi_[h]; b < doccpi_[h]; b++) bocce_[boccount++] = epsilon_b_->get(h, b);
@@ -96,6 +101,9 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) : Wavefunction(opti
     pole_max_ = options_.get_int("POLE_MAXITER");
     sem_max_ = options_.get_int("SEM_MAXITER");
     num_amps_ = options_.get_int("NUM_AMPS_PRINT");
+    do_df_ = options_.get_str("ADC_TYPE") == "DF";
+    df_omega_ = 0.0;
+    naux_ = 0;
 
     if (options_["ROOTS_PER_IRREP"].size() > 0) {
         int i = options_["ROOTS_PER_IRREP"].size();
@@ -127,7 +135,8 @@ ADCWfn::ADCWfn(SharedWavefunction ref_wfn, Options& options) : Wavefunction(opti
 
     outfile->Printf("\t==> Input Parameters <==\n");
     outfile->Printf("\tNEWTON_CONV = %3g, NORM_TOL = %3g\n", conv_, norm_tol_);
-    outfile->Printf("\tPOLE_MAX    = %3d, SEM_MAX  = %3d\n\n", pole_max_, sem_max_);
+    outfile->Printf("\tPOLE_MAX    = %3d, SEM_MAX  = %3d\n", pole_max_, sem_max_);
+    outfile->Printf("\tADC_TYPE    = %s\n\n", do_df_ ? "DF" : "CONV");
 
     outfile->Printf("\tNXS           = %d\n", nxs_);
     //    outfile->Printf( "\tIRREP_XYZ     = [");
@@ -155,6 +164,9 @@ ADCWfn::~ADCWfn() {}
 void ADCWfn::release_mem() {
     free(poles_);
     delete _ints;
+    dfh_.reset();
+    Bov_.reset();
+    Boo_.reset();
     delete[] aocce_;
     delete[] avire_;
     delete[] bocce_;
@@ -47,6 +47,7 @@ class Options;
 class Matrix;
 class Vector;
 class IntegralTransform;
+class DFHelper;
 typedef std::shared_ptr<Matrix> SharedMatrix;
 typedef std::shared_ptr<Vector> SharedVector;
 
@@ -80,6 +81,12 @@ class ADCWfn : public Wavefunction {
     void rhf_construct_sigma(int irrep, int root);
     void shift_denom2(int root, int irrep, double omega);
     void shift_denom4(int irrep, double omega);
+    void rhf_df_init_ints();
+    void rhf_df_construct_sigma(int irrep, int first, int last);
+    double rhf_df_differentiate_omega(int irrep, int root);
+    void rhf_df_doubles(int irrep, double omega, bool derivative, const std::vector<double **> &B,
+                        std::vector<double **> &S);
+    size_t df_block_size(size_t row_size, size_t resident);
 
     // Number of the singly excited configurations
     int nxs_;
@@ -127,6 +134,20 @@ class ADCWfn : public Wavefunction {
     IntegralTransform *_ints;
     // Guesses for the correlated excitation energies, which are given as CIS/ADC(1) energies
     SharedVector omega_guess_;
+    // Do build the integrals and the doubles contribution from DF three-index tensors?
+    bool do_df_;
+    // The frequency at which the DF doubles denominators are currently evaluated
+    double df_omega_;
+    // Number of alpha active occupied and virtual MOs
+    int naocc_, navir_;
+    // Irreps of the active occupied and virtual MOs in DPD order
+    std::vector<int> occ_sym_, vir_sym_;
+    // Number of auxiliary basis functions
+    size_t naux_;
+    // DF helper object which holds the (VV|Q) tensor
+    std::shared_ptr<DFHelper> dfh_;
+    // (OV|Q) and (OO|Q) three-index integrals with the MOs in DPD order
+    SharedMatrix Bov_, Boo_;
 };
 }
 }
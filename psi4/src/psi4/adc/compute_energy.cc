@@ -266,6 +266,10 @@ double ADCWfn::compute_energy() {
                         oss.str(std::string());
                         oss << state_top << root + 1 << " " << irrep_[irrep] << " TOTAL ENERGY";
                         Process::environment.globals[oss.str()] = omega[root] + energy_ + corr_energy;
+                        /*- Process::environment.globals["ADC ROOT n s SQUARED NORM OF S COMPONENT"] -*/
+                        oss.str(std::string());
+                        oss << state_top << root + 1 << " " << irrep_[irrep] << " SQUARED NORM OF S COMPONENT";
+                        Process::environment.globals[oss.str()] = poles_[irrep][root].renorm_factor;
 
                         global_dpd_->file2_close(&V);
 
@@ -95,6 +95,14 @@ void ADCWfn::rhf_construct_sigma(int irrep, int root) {
     global_dpd_->buf4_close(&K);
     global_dpd_->buf4_close(&V);
 
+    // With DF integrals the frequency-dependent doubles term is added for the whole
+    // batch of new trial vectors at once by rhf_df_construct_sigma.
+    if (do_df_) {
+        global_dpd_->file2_close(&S);
+        global_dpd_->file2_close(&B);
+        return;
+    }
+
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[V,V]"), ID("[O,V]"), ID("[V,V]"), 0,
                            "MO Ints <OV|VV>");
     sprintf(lbl, "ZOOVV_[%d]1234", irrep);
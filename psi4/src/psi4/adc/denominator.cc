@@ -69,6 +69,12 @@ void ADCWfn::shift_denom4(int irrep, double omega) {
     char lbl[32];
     dpdbuf4 D;
 
+    // The DF doubles term evaluates its denominators on the fly
+    if (do_df_) {
+        df_omega_ = omega;
+        return;
+    }
+
     sprintf(lbl, "D_[%d]1234", irrep);
     global_dpd_->buf4_init(&D, PSIF_ADC_SEM, irrep, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0, lbl);
     for (int Gij = 0; Gij < nirrep_; Gij++) {
@@ -0,0 +1,367 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libtrans/integraltransform.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libqt/qt.h"
+#include "adc.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+namespace adc {
+
+//
+//  DF-ADC(2): the (OV|VV) and (OV|OO) integral lists and the 2h-2p intermediates of
+//  rhf_construct_sigma are replaced by three-index integrals,
+//
+//      (pq|rs) = \sum_Q B_{pq}^Q B_{rs}^Q,
+//
+//  so that only O(N^3) quantities and the O^2V^2 lists needed by the MP2 ground state
+//  and the CIS part are kept.  With X_{jb}^Q = \sum_c b_{jc} B_{cb}^Q - \sum_k B_{jk}^Q b_{kb}
+//  the 2h-2p intermediate of the conventional code becomes Z_{ijab} = \sum_Q B_{ia}^Q X_{jb}^Q,
+//  which is formed one occupied index at a time and contracted right away.
+//
+
+namespace {
+
+// Unpack a symmetry-blocked OV file2 into a dense naocc x navir matrix in DPD order.
+void file2_to_dense(dpdfile2 *F, double **M) {
+    global_dpd_->file2_mat_init(F);
+    global_dpd_->file2_mat_rd(F);
+    for (int h = 0; h < F->params->nirreps; h++) {
+        int Gv = h ^ F->my_irrep;
+        for (int I = 0; I < F->params->rowtot[h]; I++)
+            for (int A = 0; A < F->params->coltot[Gv]; A++)
+                M[F->params->poff[h] + I][F->params->qoff[Gv] + A] = F->matrix[h][I][A];
+    }
+    global_dpd_->file2_mat_close(F);
+}
+
+// Accumulate a dense naocc x navir matrix into a symmetry-blocked OV file2.
+void dense_to_file2_axpy(double **M, dpdfile2 *F) {
+    global_dpd_->file2_mat_init(F);
+    global_dpd_->file2_mat_rd(F);
+    for (int h = 0; h < F->params->nirreps; h++) {
+        int Gv = h ^ F->my_irrep;
+        for (int I = 0; I < F->params->rowtot[h]; I++)
+            for (int A = 0; A < F->params->coltot[Gv]; A++)
+                F->matrix[h][I][A] += M[F->params->poff[h] + I][F->params->qoff[Gv] + A];
+    }
+    global_dpd_->file2_mat_wrt(F);
+    global_dpd_->file2_mat_close(F);
+}
+
+}  // namespace
+
+size_t ADCWfn::df_block_size(size_t row_size, size_t resident) {
+    // Half of the memory is left to libdpd and DFHelper
+    size_t avail = Process::environment.get_memory() / sizeof(double) / 2;
+    size_t used = (size_t)naocc_ * (naocc_ + navir_) * naux_ + resident;
+    size_t nblock = (avail > used ? (avail - used) / row_size : 0);
+    if (nblock < 1) nblock = 1;
+    if (nblock > (size_t)navir_) nblock = navir_;
+    return nblock;
+}
+
+void ADCWfn::rhf_df_init_ints() {
+    outfile->Printf("\n\t==> Building DF (OV|Q), (OO|Q) and (VV|Q) Integrals <==\n");
+
+    // AO coefficients of the active orbitals, with the columns in DPD order
+    SharedMatrix Cocc = Ca_subset("SO", "ACTIVE_OCC");
+    SharedMatrix Cvir = Ca_subset("SO", "ACTIVE_VIR");
+    int nao = AO2SO_->rowspi()[0];
+    auto Cocc_ao = std::make_shared<Matrix>("AO Cocc", nao, naocc_);
+    auto Cvir_ao = std::make_shared<Matrix>("AO Cvir", nao, navir_);
+    int ooff = 0, voff = 0;
+    for (int h = 0; h < nirrep_; h++) {
+        int nso = AO2SO_->colspi()[h];
+        if (!nso) continue;
+        if (aoccpi_[h])
+            C_DGEMM('N', 'N', nao, aoccpi_[h], nso, 1.0, AO2SO_->pointer(h)[0], nso, Cocc->pointer(h)[0], aoccpi_[h],
+                    0.0, &Cocc_ao->pointer()[0][ooff], naocc_);
+        if (avirpi_[h])
+            C_DGEMM('N', 'N', nao, avirpi_[h], nso, 1.0, AO2SO_->pointer(h)[0], nso, Cvir->pointer(h)[0], avirpi_[h],
+                    0.0, &Cvir_ao->pointer()[0][voff], navir_);
+        ooff += aoccpi_[h];
+        voff += avirpi_[h];
+    }
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+
+    dfh_ = std::make_shared<DFHelper>(get_basisset("ORBITAL"), get_basisset("DF_BASIS_ADC"));
+    dfh_->set_memory(Process::environment.get_memory() * 0.5 / sizeof(double));
+    dfh_->set_method("STORE");
+    dfh_->set_nthreads(nthreads);
+    dfh_->initialize();
+
+    dfh_->add_space("o", Cocc_ao);
+    dfh_->add_space("v", Cvir_ao);
+    dfh_->add_transformation("ovQ", "o", "v", "pqQ");
+    dfh_->add_transformation("ooQ", "o", "o", "pqQ");
+    dfh_->add_transformation("vvQ", "v", "v", "pqQ");
+    dfh_->transform();
+
+    naux_ = dfh_->get_naux();
+    outfile->Printf("\tNAUX          = %zu\n", naux_);
+
+    // (OV|Q) and (OO|Q) are needed for every sigma vector and stay in core,
+    // (VV|Q) is read in blocks of the first virtual index when needed.
+    Bov_ = std::make_shared<Matrix>("(OV|Q)", naocc_ * navir_, naux_);
+    Boo_ = std::make_shared<Matrix>("(OO|Q)", naocc_ * naocc_, naux_);
+    dfh_->fill_tensor("ovQ", Bov_);
+    dfh_->fill_tensor("ooQ", Boo_);
+    double **Bovp = Bov_->pointer();
+    double **Boop = Boo_->pointer();
+
+    psio_->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_NEW);
+
+    dpdbuf4 V;
+    size_t oo = (size_t)naocc_ * naocc_;
+
+    // <ij|ab> = (ia|jb) = \sum_Q B_{ia}^Q B_{jb}^Q
+    auto Iab = std::make_shared<Matrix>("(ia|jb)", navir_, navir_);
+    double **Iabp = Iab->pointer();
+    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints <OO|VV>");
+    for (int h = 0; h < nirrep_; h++) {
+        global_dpd_->buf4_mat_irrep_init(&V, h);
+        for (int ij = 0; ij < V.params->rowtot[h]; ij++) {
+            int i = V.params->roworb[h][ij][0];
+            int j = V.params->roworb[h][ij][1];
+            C_DGEMM('N', 'T', navir_, navir_, naux_, 1.0, Bovp[i * navir_], naux_, Bovp[j * navir_], naux_, 0.0,
+                    Iabp[0], navir_);
+            for (int ab = 0; ab < V.params->coltot[h]; ab++) {
+                int a = V.params->colorb[h][ab][0];
+                int b = V.params->colorb[h][ab][1];
+                V.matrix[h][ij][ab] = Iabp[a][b];
+            }
+        }
+        global_dpd_->buf4_mat_irrep_wrt(&V, h);
+        global_dpd_->buf4_mat_irrep_close(&V, h);
+    }
+    global_dpd_->buf4_close(&V);
+    Iab.reset();
+
+    // <ia|jb> = (ij|ab) = \sum_Q B_{ij}^Q B_{ab}^Q
+    size_t nblock = df_block_size((size_t)navir_ * (naux_ + oo), 0);
+    auto Bvv = std::make_shared<Matrix>("(VV|Q)", nblock * navir_, naux_);
+    auto Iijab = std::make_shared<Matrix>("(ij|ab)", oo, nblock * navir_);
+    double **Bvvp = Bvv->pointer();
+    double **Iijabp = Iijab->pointer();
+    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                           "MO Ints <OV|OV>");
+    for (int h = 0; h < nirrep_; h++) {
+        global_dpd_->buf4_mat_irrep_init(&V, h);
+        for (size_t a0 = 0; a0 < (size_t)navir_; a0 += nblock) {
+            size_t na = (a0 + nblock > (size_t)navir_ ? navir_ - a0 : nblock);
+            size_t ncol = na * navir_;
+            dfh_->fill_tensor("vvQ", Bvvp[0], {a0, a0 + na});
+            C_DGEMM('N', 'T', oo, ncol, naux_, 1.0, Boop[0], naux_, Bvvp[0], naux_, 0.0, Iijabp[0], ncol);
+            for (int ia = 0; ia < V.params->rowtot[h]; ia++) {
+                int i = V.params->roworb[h][ia][0];
+                size_t a = V.params->roworb[h][ia][1];
+                if (a < a0 || a >= a0 + na) continue;
+                for (int jb = 0; jb < V.params->coltot[h]; jb++) {
+                    int j = V.params->colorb[h][jb][0];
+                    int b = V.params->colorb[h][jb][1];
+                    V.matrix[h][ia][jb] = Iijabp[0][(i * naocc_ + j) * ncol + (a - a0) * navir_ + b];
+                }
+            }
+        }
+        global_dpd_->buf4_mat_irrep_wrt(&V, h);
+        global_dpd_->buf4_mat_irrep_close(&V, h);
+    }
+    global_dpd_->buf4_close(&V);
+}
+
+//
+//  S(\omega)_{ia} += \sum_{jbc} T_{jicb} <ja|cb> - \sum_{jkb} <kj|bi> T_{jkab} for a batch of
+//  dense trial vectors, where T_{ijab} = (2Z_{ijab} - Z_{ijba} - Z_{jiab} + 2Z_{jiba}) / (\omega+e_i-e_a+e_j-e_b).
+//  With derivative the denominator is replaced by -1/(\omega+e_i-e_a+e_j-e_b)^2, which gives
+//  \frac{\partial A(\omega)}{\partial \omega} b instead.
+//
+void ADCWfn::rhf_df_doubles(int irrep, double omega, bool derivative, const std::vector<double **> &B,
+                            std::vector<double **> &S) {
+    int nroot = B.size();
+    size_t ov = (size_t)naocc_ * navir_;
+    size_t vQ = (size_t)navir_ * naux_;
+    double **Bovp = Bov_->pointer();
+    double **Boop = Boo_->pointer();
+
+    // X and G for every vector of the batch share each pass over (VV|Q)
+    std::vector<SharedMatrix> X, G;
+    for (int r = 0; r < nroot; r++) {
+        X.push_back(std::make_shared<Matrix>("X", ov, naux_));
+        G.push_back(std::make_shared<Matrix>("G", ov, naux_));
+    }
+    size_t resident = 2 * nroot * ov * naux_ + 3 * ov * navir_;
+    size_t nblock = df_block_size(vQ, resident);
+    auto Bvv = std::make_shared<Matrix>("(VV|Q)", nblock * navir_, naux_);
+    double **Bvvp = Bvv->pointer();
+
+    // X_{jb}^Q <-- \sum_c b_{jc} B_{cb}^Q
+    for (size_t c0 = 0; c0 < (size_t)navir_; c0 += nblock) {
+        size_t nc = (c0 + nblock > (size_t)navir_ ? navir_ - c0 : nblock);
+        dfh_->fill_tensor("vvQ", Bvvp[0], {c0, c0 + nc});
+        for (int r = 0; r < nroot; r++)
+            C_DGEMM('N', 'N', naocc_, vQ, nc, 1.0, &B[r][0][c0], navir_, Bvvp[0], vQ, 1.0, X[r]->pointer()[0], vQ);
+    }
+
+    // X_{jb}^Q <-- - \sum_k B_{jk}^Q b_{kb}
+    for (int r = 0; r < nroot; r++) {
+        double **Xp = X[r]->pointer();
+        for (int j = 0; j < naocc_; j++)
+            C_DGEMM('T', 'N', navir_, naux_, naocc_, -1.0, B[r][0], navir_, Boop[j * naocc_], naux_, 1.0,
+                    Xp[j * navir_], naux_);
+    }
+
+    // G_{ia}^Q <-- \sum_{jb} T_{ijab} B_{jb}^Q, one occupied index i at a time
+    auto Zr = std::make_shared<Matrix>("Zr", navir_, ov);
+    auto Zc = std::make_shared<Matrix>("Zc", ov, navir_);
+    auto T = std::make_shared<Matrix>("T", navir_, ov);
+    double **Zrp = Zr->pointer();
+    double **Zcp = Zc->pointer();
+    double **Tp = T->pointer();
+    for (int r = 0; r < nroot; r++) {
+        double **Xp = X[r]->pointer();
+        double **Gp = G[r]->pointer();
+        for (int i = 0; i < naocc_; i++) {
+            // Zr_{a,jb} = Z_{ijab}, Zc_{jb,a} = Z_{jiba}
+            C_DGEMM('N', 'T', navir_, ov, naux_, 1.0, Bovp[i * navir_], naux_, Xp[0], naux_, 0.0, Zrp[0], ov);
+            C_DGEMM('N', 'T', ov, navir_, naux_, 1.0, Bovp[0], naux_, Xp[i * navir_], naux_, 0.0, Zcp[0], navir_);
+#pragma omp parallel for schedule(static)
+            for (int a = 0; a < navir_; a++) {
+                int Gia = occ_sym_[i] ^ vir_sym_[a];
+                for (int j = 0; j < naocc_; j++) {
+                    for (int b = 0; b < navir_; b++) {
+                        size_t jb = (size_t)j * navir_ + b;
+                        if ((Gia ^ occ_sym_[j] ^ vir_sym_[b]) != irrep) {
+                            Tp[a][jb] = 0.0;
+                            continue;
+                        }
+                        size_t ja = (size_t)j * navir_ + a;
+                        double Ziajb = Zrp[a][jb] + Zcp[jb][a];
+                        double Zibja = Zrp[b][ja] + Zcp[ja][b];
+                        double denom = 1.0 / (omega + aocce_[i] - avire_[a] + aocce_[j] - avire_[b]);
+                        if (derivative) denom *= -denom;
+                        Tp[a][jb] = (2.0 * Ziajb - Zibja) * denom;
+                    }
+                }
+            }
+            C_DGEMM('N', 'N', navir_, naux_, ov, 1.0, Tp[0], ov, Bovp[0], naux_, 0.0, Gp[i * navir_], naux_);
+        }
+    }
+    Zr.reset();
+    Zc.reset();
+    T.reset();
+    X.clear();
+
+    // \sigma_{ia} <-- \sum_{bQ} G_{ib}^Q B_{ab}^Q
+    for (size_t a0 = 0; a0 < (size_t)navir_; a0 += nblock) {
+        size_t na = (a0 + nblock > (size_t)navir_ ? navir_ - a0 : nblock);
+        dfh_->fill_tensor("vvQ", Bvvp[0], {a0, a0 + na});
+        for (int r = 0; r < nroot; r++)
+            C_DGEMM('N', 'T', naocc_, na, vQ, 1.0, G[r]->pointer()[0], vQ, Bvvp[0], vQ, 1.0, &S[r][0][a0], navir_);
+    }
+
+    // \sigma_{ia} <-- - \sum_{jQ} B_{ji}^Q G_{ja}^Q
+    for (int r = 0; r < nroot; r++) {
+        double **Gp = G[r]->pointer();
+        for (int j = 0; j < naocc_; j++)
+            C_DGEMM('N', 'T', naocc_, navir_, naux_, -1.0, Boop[j * naocc_], naux_, Gp[j * navir_], naux_, 1.0,
+                    S[r][0], navir_);
+    }
+}
+
+void ADCWfn::rhf_df_construct_sigma(int irrep, int first, int last) {
+    char lbl[32];
+    dpdfile2 B, S;
+    std::vector<double **> b, sigma;
+
+    if (last <= first) return;
+
+    timer_on("DF doubles sigma");
+    for (int I = first; I < last; I++) {
+        double **bI = block_matrix(naocc_, navir_);
+        sprintf(lbl, "B^(%d)_[%d]12", I, irrep);
+        global_dpd_->file2_init(&B, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+        file2_to_dense(&B, bI);
+        global_dpd_->file2_close(&B);
+        b.push_back(bI);
+        sigma.push_back(block_matrix(naocc_, navir_));
+    }
+
+    rhf_df_doubles(irrep, df_omega_, false, b, sigma);
+
+    for (int I = first; I < last; I++) {
+        sprintf(lbl, "S^(%d)_[%d]12", I, irrep);
+        global_dpd_->file2_init(&S, PSIF_ADC_SEM, irrep, ID('O'), ID('V'), lbl);
+        dense_to_file2_axpy(sigma[I - first], &S);
+        global_dpd_->file2_close(&S);
+        free_block(b[I - first]);
+        free_block(sigma[I - first]);
+    }
+    timer_off("DF doubles sigma");
+}
+
+double ADCWfn::rhf_df_differentiate_omega(int irrep, int root) {
+    char lbl[32];
+    dpdfile2 V;
+
+    std::vector<double **> v(1, block_matrix(naocc_, navir_));
+    std::vector<double **> dv(1, block_matrix(naocc_, navir_));
+    sprintf(lbl, "V^(%d)_[%d]12", root, irrep);
+    global_dpd_->file2_init(&V, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
+    file2_to_dense(&V, v[0]);
+    global_dpd_->file2_close(&V);
+
+    rhf_df_doubles(irrep, df_omega_, true, v, dv);
+
+    // \frac{\partial \omega^{eigen}}{\partial omega} = V^t\frac{\partial A(\omega)}{\partial \omega}V
+    double dot = C_DDOT((size_t)naocc_ * navir_, v[0][0], 1, dv[0][0], 1);
+
+    free_block(v[0]);
+    free_block(dv[0]);
+
+    return dot;
+}
+}
+}  // End Namespaces
@@ -86,6 +86,7 @@ void ADCWfn::rhf_diagonalize(int irrep, int num_root, bool first, double omega_i
         timer_on("Sigma construction");
         for (int I = prev_length; I < length; I++)
             if (!nopen_) rhf_construct_sigma(irrep, I);
+        if (do_df_ && !nopen_) rhf_df_construct_sigma(irrep, prev_length, length);
         timer_off("Sigma construction");
 
         // Making so called Davidson mini-Hamiltonian, or Rayleigh matrix
@@ -48,6 +48,8 @@ double ADCWfn::rhf_differentiate_omega(int irrep, int root) {
     dpdfile2 S, D;
     dpdbuf4 A, V, K, Z;
 
+    if (do_df_) return rhf_df_differentiate_omega(irrep, root);
+
     sprintf(lbl, "V^(%d)_[%d]12", root, irrep);
     global_dpd_->file2_init(&S, PSIF_ADC, irrep, ID('O'), ID('V'), lbl);
     sprintf(lbl, "D^(%d)_[%d]12", root, irrep);
@@ -91,7 +93,7 @@ double ADCWfn::rhf_differentiate_omega(int irrep, int root) {
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,O]"), ID("[O,O]"), ID("[V,O]"), 0,
                            "MO Ints <OO|VO>");
     // \dV_{ia} <-- - \sum_{jkb} <kj|bi> B_{jkab}
-    global_dpd_->contract442(&V, &Z, &D, 3, 3, -1, 0);  // This is genuine
+    global_dpd_->contract442(&V, &Z, &D, 3, 3, -1, 1);  // This is genuine
     global_dpd_->buf4_close(&V);
     global_dpd_->buf4_close(&Z);
 
@@ -52,30 +52,37 @@ double ADCWfn::rhf_init_tensors() {
     _ints->set_keep_iwl_so_ints(true);
     _ints->set_keep_dpd_so_ints(true);
     dpd_set_default(_ints->get_dpd_id());
-    // Make (OV|OV) integrals
-    outfile->Printf("\n\t==> Transforming (OV|OV) Integrals <==\n");
-    _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::vir);
-    // Make (OO|VV) integrals
-    outfile->Printf("\n\t==> Transforming (OO|VV) Integrals <==\n");
-    _ints->transform_tei(MOSpace::occ, MOSpace::occ, MOSpace::vir, MOSpace::vir);
-    // Make (OO|OV) integrals
-    outfile->Printf("\n\t==> Transforming (OV|OO) Integrals <==\n");
-    _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::occ);
-    // Make (OV|VV) integrals
-    outfile->Printf("\n\t==> Transforming (OV|VV) Integrals <==\n");
-    _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::vir, MOSpace::vir);
-
-    // Preparing MP1 amplitudes then calculating MP2 energy
-    // and use of LMO is not considered in this code.
-    // In ADC(2) calculation, 2 <ij|ab> - <ij|ba> typed
-    // integral list is needed. So making this too.
-    psio_->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
-    psio_->open(PSIF_ADC, PSIO_OPEN_NEW);
-
-    global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
-                           "MO Ints (OV|OV)");
-    global_dpd_->buf4_sort(&V, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
-    global_dpd_->buf4_close(&V);
+    if (do_df_) {
+        // <OO|VV> and <OV|OV> are assembled from the three-index integrals; the (OV|VV)
+        // and (OV|OO) lists are never formed, the doubles part of sigma works on the fly.
+        rhf_df_init_ints();
+        psio_->open(PSIF_ADC, PSIO_OPEN_NEW);
+    } else {
+        // Make (OV|OV) integrals
+        outfile->Printf("\n\t==> Transforming (OV|OV) Integrals <==\n");
+        _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::vir);
+        // Make (OO|VV) integrals
+        outfile->Printf("\n\t==> Transforming (OO|VV) Integrals <==\n");
+        _ints->transform_tei(MOSpace::occ, MOSpace::occ, MOSpace::vir, MOSpace::vir);
+        // Make (OO|OV) integrals
+        outfile->Printf("\n\t==> Transforming (OV|OO) Integrals <==\n");
+        _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::occ);
+        // Make (OV|VV) integrals
+        outfile->Printf("\n\t==> Transforming (OV|VV) Integrals <==\n");
+        _ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::vir, MOSpace::vir);
+
+        // Preparing MP1 amplitudes then calculating MP2 energy
+        // and use of LMO is not considered in this code.
+        // In ADC(2) calculation, 2 <ij|ab> - <ij|ba> typed
+        // integral list is needed. So making this too.
+        psio_->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
+        psio_->open(PSIF_ADC, PSIO_OPEN_NEW);
+
+        global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                               "MO Ints (OV|OV)");
+        global_dpd_->buf4_sort(&V, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
+        global_dpd_->buf4_close(&V);
+    }
     global_dpd_->buf4_init(&V, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
                            "MO Ints <OO|VV>");
     global_dpd_->buf4_sort(&V, PSIF_LIBTRANS_DPD, pqsr, ID("[O,O]"), ID("[V,V]"), "MO Ints V1243");
@@ -187,6 +194,8 @@ double ADCWfn::rhf_init_tensors() {
 
     if (do_pr) energy = ePR2;
 
+    if (do_df_) return energy;
+
     // Reordering each ERIs other than (OO|VV) type from Mulliken to Dirac notation
     // for convenience of the evaluation of the sigma tensor
 
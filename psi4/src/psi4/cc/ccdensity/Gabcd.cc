@@ -31,7 +31,11 @@
     \brief Enter brief description of file here
 */
 #include <cstdio>
+#include <algorithm>
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libiwl/iwl.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/exception.h"
 #include "MOInfo.h"
 #include "Params.h"
 #include "Frozen.h"
@@ -41,6 +45,112 @@
 namespace psi {
 namespace ccdensity {
 
+/* Gabcd_stream(): Whether the RHF ground-state GAbCd is left implicit,
+** as its low-rank factors L(ij,ab) and tau(ij,cd), instead of being
+** written to CC_GAMMA.  Its consumers then use Gabcd_contract_RHF()
+** and Gabcd_dump_RHF() below.  The debug energies need the stored
+** component, so they turn streaming off.
+*/
+bool Gabcd_stream() {
+    return params.stream_gabcd && params.ref == 0 && params.ground && params.G_irr == 0 && !params.aobasis &&
+           !params.debug_;
+}
+
+/* T2 * L2 * V is absent in CC2 Lagrangian */
+static const char *Gabcd_tau_label() {
+    if (params.wfn == "CC2" && params.dertype == 1) return "t1_IjAb";
+    return "tauIjAb";
+}
+
+/* Gabcd_contract_RHF(): I(p,q) += 2 sum_x sum_CD V(px,CD) [2 G(qx,CD) - G(qx,DC)]
+** with the RHF ground-state G(Ab,Cd) = 1/2 sum_ij [L(ij,Ab) tau(ij,Cd) + tau(ij,Ab) L(ij,Cd)].
+**
+** Each half goes through Z(ij,px) = sum_CD X(ij,CD) V(px,CD), of the size
+** of the amplitudes, as 2 Z(ij,px) - Z(ji,px) contracted against the other
+** factor over ij and x.  V is the <Ab|Cd> or <Ib|Cd> integrals.
+*/
+void Gabcd_contract_RHF(dpdbuf4 *V, dpdfile2 *I) {
+    dpdbuf4 X, Y, Z;
+    int pxnum = V->params->pqnum;
+
+    for (int term = 0; term < 2; term++) {
+        const char *X_lbl = term ? "LIjAb" : Gabcd_tau_label();
+        const char *Y_lbl = term ? Gabcd_tau_label() : "LIjAb";
+        int X_file = term ? PSIF_CC_GLG : PSIF_CC_TAMPS;
+        int Y_file = term ? PSIF_CC_TAMPS : PSIF_CC_GLG;
+
+        global_dpd_->buf4_init(&Z, PSIF_CC_TMP0, 0, 0, pxnum, 0, pxnum, 0, "Z(Ij,Px) Gabcd");
+        global_dpd_->buf4_init(&X, X_file, 0, 0, 5, 0, 5, 0, X_lbl);
+        global_dpd_->contract444(&X, V, &Z, 0, 0, 1.0, 0.0);
+        global_dpd_->buf4_close(&X);
+        global_dpd_->buf4_scmcopy(&Z, PSIF_CC_TMP0, "2 Z(Ij,Px) - Z(jI,Px) Gabcd", 2);
+        global_dpd_->buf4_sort_axpy(&Z, PSIF_CC_TMP0, qprs, 0, pxnum, "2 Z(Ij,Px) - Z(jI,Px) Gabcd", -1);
+        global_dpd_->buf4_close(&Z);
+
+        global_dpd_->buf4_init(&Z, PSIF_CC_TMP0, 0, 0, pxnum, 0, pxnum, 0, "2 Z(Ij,Px) - Z(jI,Px) Gabcd");
+        global_dpd_->buf4_init(&Y, Y_file, 0, 0, 5, 0, 5, 0, Y_lbl);
+        global_dpd_->contract442(&Z, &Y, I, 2, 2, 1.0, 1.0);
+        global_dpd_->buf4_close(&Y);
+        global_dpd_->buf4_close(&Z);
+    }
+}
+
+/* Gabcd_dump_RHF(): Writes the Mulliken-ordered 2 G(AC,BD) - G(AD,BC) of
+** dump_RHF() to the backtransformation buffer, one bucket of G(Ab,Cd) rows
+** at a time, computed directly from L and tau.  The lower triangle of each
+** irrep block is written, as dpd_buf4_dump() does with bk_pack.
+*/
+void Gabcd_dump_RHF(struct iwlbuf *OutBuf) {
+    dpdbuf4 L, T;
+    int *qt_vir = moinfo.qt_vir;
+
+    global_dpd_->buf4_init(&L, PSIF_CC_GLG, 0, 0, 5, 0, 5, 0, "LIjAb");
+    global_dpd_->buf4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, Gabcd_tau_label());
+    dpdparams4 *P = L.params;
+
+    for (int h = 0; h < moinfo.nirreps; h++) {
+        int nij = P->rowtot[h];
+        int nab = P->coltot[h];
+        if (!nij || !nab) continue;
+
+        global_dpd_->buf4_mat_irrep_init(&L, h);
+        global_dpd_->buf4_mat_irrep_rd(&L, h);
+        global_dpd_->buf4_mat_irrep_init(&T, h);
+        global_dpd_->buf4_mat_irrep_rd(&T, h);
+
+        long int rows_per_bucket = std::min((long int)nab, dpd_memfree() / nab);
+        if (rows_per_bucket < 1) throw PSIEXCEPTION("ccdensity: not enough memory to stream Gabcd.");
+        double **G = global_dpd_->dpd_block_matrix(rows_per_bucket, nab);
+
+        for (int row_start = 0; row_start < nab; row_start += rows_per_bucket) {
+            int nrows = std::min(rows_per_bucket, (long int)(nab - row_start));
+            C_DGEMM('t', 'n', nrows, nab, nij, 0.5, &(L.matrix[h][0][row_start]), nab, T.matrix[h][0], nab, 0.0,
+                    G[0], nab);
+            C_DGEMM('t', 'n', nrows, nab, nij, 0.5, &(T.matrix[h][0][row_start]), nab, L.matrix[h][0], nab, 1.0,
+                    G[0], nab);
+
+            for (int row = 0; row < nrows; row++) {
+                int a = P->colorb[h][row_start + row][0];
+                int b = P->colorb[h][row_start + row][1];
+                for (int cd = 0; cd < nab; cd++) {
+                    int c = P->colorb[h][cd][0];
+                    int d = P->colorb[h][cd][1];
+                    if (P->colidx[b][d] > P->colidx[a][c]) continue;
+                    double value = 2.0 * G[row][cd] - G[row][P->colidx[d][c]];
+                    iwl_buf_wrt_val(OutBuf, qt_vir[a], qt_vir[c], qt_vir[b], qt_vir[d], value, 0, "outfile", 0);
+                }
+            }
+        }
+
+        global_dpd_->free_dpd_block(G, rows_per_bucket, nab);
+        global_dpd_->buf4_mat_irrep_close(&T, h);
+        global_dpd_->buf4_mat_irrep_close(&L, h);
+    }
+
+    global_dpd_->buf4_close(&T);
+    global_dpd_->buf4_close(&L);
+}
+
 void Gabcd() {
     dpdbuf4 G, L, T;
     int G_irr;
@@ -50,6 +160,8 @@ void Gabcd() {
     /*  T2 * L2 * V is absent in CC2 Lagrangian */
     if (params.wfn == "CC2" && params.dertype == 1) T2_L2_V = false;
 
+    if (Gabcd_stream()) return;
+
     if (params.ref == 0) { /** RHF **/
         global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, G_irr, 5, 5, 5, 5, 0, "GAbCd");
         global_dpd_->buf4_init(&L, PSIF_CC_GLG, G_irr, 0, 5, 0, 5, 0, "LIjAb");
@@ -41,6 +41,9 @@
 namespace psi {
 namespace ccdensity {
 
+bool Gabcd_stream();
+void Gabcd_contract_RHF(dpdbuf4 *V, dpdfile2 *I);
+
 /* Iab(): Build the virtual-virtual block of the orbital Lagrangian
 ** using the expression given in lag.c.
 **
@@ -257,7 +260,13 @@ void Iab(struct RHO_Params rho_params) {
         global_dpd_->file2_close(&I);
     }
 
-    if (params.ref == 0) { /** RHF **/
+    if (params.ref == 0 && Gabcd_stream()) { /** RHF, implicit Gabcd **/
+        global_dpd_->file2_init(&I, PSIF_CC_OEI, 0, 1, 1, "I'AB");
+        global_dpd_->buf4_init(&Bints, PSIF_CC_BINTS, 0, 5, 5, 5, 5, 0, "B <ab|cd>");
+        Gabcd_contract_RHF(&Bints, &I);
+        global_dpd_->buf4_close(&Bints);
+        global_dpd_->file2_close(&I);
+    } else if (params.ref == 0) { /** RHF **/
         /* I'AB <-- sum_CDE <AC||DE> G(BC,DE) + 2 sum_cDe <Ac|De> G(Bc,De) */
         global_dpd_->file2_init(&I, PSIF_CC_OEI, 0, 1, 1, "I'AB");
 
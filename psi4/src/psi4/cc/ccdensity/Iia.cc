@@ -40,6 +40,9 @@
 namespace psi {
 namespace ccdensity {
 
+bool Gabcd_stream();
+void Gabcd_contract_RHF(dpdbuf4 *V, dpdfile2 *I);
+
 /* Iia(): Build the occupied-virtual block of the orbital Lagrangian
 ** using the expression given in lag.c.
 **
@@ -254,7 +257,13 @@ void Iia(struct RHO_Params rho_params) {
         global_dpd_->file2_close(&I);
     }
 
-    if (params.ref == 0) { /** RHF **/
+    if (params.ref == 0 && Gabcd_stream()) { /** RHF, implicit Gabcd **/
+        global_dpd_->file2_init(&I, PSIF_CC_OEI, 0, 0, 1, "I'IA");
+        global_dpd_->buf4_init(&Fints, PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
+        Gabcd_contract_RHF(&Fints, &I);
+        global_dpd_->buf4_close(&Fints);
+        global_dpd_->file2_close(&I);
+    } else if (params.ref == 0) { /** RHF **/
         /* I'IA <-- sum_BCD <IB||CD> G(AB,CD) + 2 sum_bCd <Ib|Cd> G(Ab,Cd) */
         global_dpd_->file2_init(&I, PSIF_CC_OEI, 0, 0, 1, "I'IA");
 
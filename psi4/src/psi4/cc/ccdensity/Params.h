@@ -61,6 +61,7 @@ struct Params {
     std::string gauge;
     bool write_nos;
     int debug_;
+    bool stream_gabcd; /* leave the RHF ground-state Gabcd implicit */
 
     /* these are used by Xi and twopdm code */
     int G_irr;
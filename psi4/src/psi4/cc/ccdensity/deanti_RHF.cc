@@ -45,6 +45,8 @@
 namespace psi {
 namespace ccdensity {
 
+bool Gabcd_stream();
+
 /* DEANTI_RHF(): Convert the RHF two-particle density from an
 ** energy expression using antisymmetrized Dirac integrals to one
 ** using simple Diract integrals. The original, Fock-adjusted
@@ -216,7 +218,9 @@ void deanti_RHF(struct RHO_Params rho_params) {
 
     global_dpd_->buf4_close(&G1);
 
-    /* E_abcd = (2 Gabcd - Gabdc) <ab|cd> */
+    /* E_abcd = (2 Gabcd - Gabdc) <ab|cd>; an implicit Gabcd is combined as it is dumped */
+    if (Gabcd_stream()) return;
+
     global_dpd_->buf4_init(&G1, PSIF_CC_GAMMA, 0, 5, 5, 5, 5, 0, "GAbCd");
 
     global_dpd_->buf4_scmcopy(&G1, PSIF_CC_GAMMA, "2 Gabcd - Gabdc", 2);
@@ -44,6 +44,9 @@
 namespace psi {
 namespace ccdensity {
 
+bool Gabcd_stream();
+void Gabcd_dump_RHF(struct iwlbuf *OutBuf);
+
 /* DUMP_RHF(): Mulliken-order the RHF-CC two-electron density and
 ** dump it to a file for subsequent backtransformation.  Basically
 ** all we have to do is swap indices two and three, e.g.
@@ -135,12 +138,16 @@ void dump_RHF(struct iwlbuf *OutBuf, struct RHO_Params rho_params) {
         global_dpd_->buf4_dump(&G, OutBuf, qt_vir, qt_vir, qt_occ, qt_vir, 0, 0);
         global_dpd_->buf4_close(&G);
 
-        global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, 0, 5, 5, 5, 5, 0, "GAbCd");
-        global_dpd_->buf4_sort(&G, PSIF_CC_TMP0, prqs, 5, 5, "G(AC,BD)");
-        global_dpd_->buf4_close(&G);
-        global_dpd_->buf4_init(&G, PSIF_CC_TMP0, 0, 5, 5, 5, 5, 0, "G(AC,BD)");
-        global_dpd_->buf4_dump(&G, OutBuf, qt_vir, qt_vir, qt_vir, qt_vir, 1, 0);
-        global_dpd_->buf4_close(&G);
+        if (Gabcd_stream()) {
+            Gabcd_dump_RHF(OutBuf);
+        } else {
+            global_dpd_->buf4_init(&G, PSIF_CC_GAMMA, 0, 5, 5, 5, 5, 0, "GAbCd");
+            global_dpd_->buf4_sort(&G, PSIF_CC_TMP0, prqs, 5, 5, "G(AC,BD)");
+            global_dpd_->buf4_close(&G);
+            global_dpd_->buf4_init(&G, PSIF_CC_TMP0, 0, 5, 5, 5, 5, 0, "G(AC,BD)");
+            global_dpd_->buf4_dump(&G, OutBuf, qt_vir, qt_vir, qt_vir, qt_vir, 1, 0);
+            global_dpd_->buf4_close(&G);
+        }
     }
 }
 
@@ -141,6 +141,7 @@ void get_params(Options& options) {
 
     params.write_nos = options.get_bool("WRITE_NOS");
     params.debug_ = options.get_int("DEBUG");
+    params.stream_gabcd = options.get_bool("STREAM_GABCD");
 
     outfile->Printf("\n\tInput parameters:\n");
     outfile->Printf("\t-----------------\n");
@@ -156,6 +157,7 @@ void get_params(Options& options) {
     outfile->Printf("\tUse Zeta         = %s\n", (params.use_zeta) ? "Yes" : "No");
     outfile->Printf("\tXi connected     = %s\n", (params.connect_xi) ? "Yes" : "No");
     outfile->Printf("\tCompute NO       = %s\n", (params.write_nos) ? "Yes" : "No");
+    outfile->Printf("\tStream Gabcd     = %s\n", (params.stream_gabcd) ? "Yes" : "No");
 }
 
 }  // namespace ccdensity
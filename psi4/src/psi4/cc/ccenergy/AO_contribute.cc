@@ -33,23 +33,170 @@
 
 /*! \defgroup CCENERGY ccenergy: Compute the Coupled-Cluster Energy */
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <memory>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libiwl/iwl.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libdpd/dpd.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/sobasis.h"
+#include "psi4/libmints/sointegral_twobody.h"
+#include "psi4/libmints/twobody.h"
 #include "psi4/cc/ccwave.h"
 
 namespace psi {
 namespace ccenergy {
 
+namespace {
+
+/* Adds the contributions of the canonical SO integral (pq|rs) and its
+** permutational partners to the target blocks tau2 (laid out as
+** tau1_AO). */
+void AO_contribute_integral(int p, int q, int r, int s, double value, dpdbuf4 *tau1_AO, double ***tau2) {
+    int Gp, Gq, Gr, Gs, Gpr, Gps, Gqr, Gqs, Grp, Gsp, Grq, Gsq;
+    int pr, ps, qr, qs, rp, rq, sp, sq, pq, rs;
+
+    Gp = tau1_AO->params->psym[p];
+    Gq = tau1_AO->params->psym[q];
+    Gr = tau1_AO->params->psym[r];
+    Gs = tau1_AO->params->psym[s];
+
+    Gpr = Grp = Gp ^ Gr;
+    Gps = Gsp = Gp ^ Gs;
+    Gqr = Grq = Gq ^ Gr;
+    Gqs = Gsq = Gq ^ Gs;
+
+    pq = tau1_AO->params->rowidx[p][q];
+    rs = tau1_AO->params->rowidx[r][s];
+
+    pr = tau1_AO->params->rowidx[p][r];
+    rp = tau1_AO->params->rowidx[r][p];
+    ps = tau1_AO->params->rowidx[p][s];
+    sp = tau1_AO->params->rowidx[s][p];
+    qr = tau1_AO->params->rowidx[q][r];
+    rq = tau1_AO->params->rowidx[r][q];
+    qs = tau1_AO->params->rowidx[q][s];
+    sq = tau1_AO->params->rowidx[s][q];
+
+    /* (pq|rs) */
+    if (tau1_AO->params->coltot[Gpr])
+        C_DAXPY(tau1_AO->params->coltot[Gpr], value, tau1_AO->matrix[Gpr][qs], 1, tau2[Gpr][pr], 1);
+
+    if (p != q && r != s && pq != rs) {
+        /* (pq|sr) */
+        if (tau1_AO->params->coltot[Gps])
+            C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2[Gps][ps], 1);
+
+        /* (qp|rs) */
+        if (tau1_AO->params->coltot[Gqr])
+            C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2[Gqr][qr], 1);
+
+        /* (qp|sr) */
+        if (tau1_AO->params->coltot[Gqs])
+            C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1, tau2[Gqs][qs], 1);
+
+        /* (rs|pq) */
+        if (tau1_AO->params->coltot[Grp])
+            C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2[Grp][rp], 1);
+
+        /* (sr|pq) */
+        if (tau1_AO->params->coltot[Gsp])
+            C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1, tau2[Gsp][sp], 1);
+
+        /* (rs|qp) */
+        if (tau1_AO->params->coltot[Grq])
+            C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1, tau2[Grq][rq], 1);
+
+        /* (sr|qp) */
+        if (tau1_AO->params->coltot[Gsq])
+            C_DAXPY(tau1_AO->params->coltot[Gsq], value, tau1_AO->matrix[Gsq][rp], 1, tau2[Gsq][sq], 1);
+
+    } else if (p != q && r != s && pq == rs) {
+        /* (pq|sr) */
+        if (tau1_AO->params->coltot[Gps])
+            C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2[Gps][ps], 1);
+
+        /* (qp|rs) */
+        if (tau1_AO->params->coltot[Gqr])
+            C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2[Gqr][qr], 1);
+
+        /* (qp|sr) */
+        if (tau1_AO->params->coltot[Gqs])
+            C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1, tau2[Gqs][qs], 1);
+
+    } else if (p != q && r == s) {
+        /* (qp|rs) */
+        if (tau1_AO->params->coltot[Gqr])
+            C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2[Gqr][qr], 1);
+
+        /* (rs|pq) */
+        if (tau1_AO->params->coltot[Grp])
+            C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2[Grp][rp], 1);
+
+        /* (rs|qp) */
+        if (tau1_AO->params->coltot[Grq])
+            C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1, tau2[Grq][rq], 1);
+
+    }
+
+    else if (p == q && r != s) {
+        /* (pq|sr) */
+        if (tau1_AO->params->coltot[Gps])
+            C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2[Gps][ps], 1);
+
+        /* (rs|pq) */
+        if (tau1_AO->params->coltot[Grp])
+            C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2[Grp][rp], 1);
+
+        /* (sr|pq) */
+        if (tau1_AO->params->coltot[Gsp])
+            C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1, tau2[Gsp][sp], 1);
+
+    }
+
+    else if (p == q && r == s && pq != rs) {
+        /* (rs|pq) */
+        if (tau1_AO->params->coltot[Grp])
+            C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2[Grp][rp], 1);
+    }
+}
+
+/* Feeds the integrals of TwoBodySOInt::compute_shell() to
+** AO_contribute_integral(), each thread into its own copy of the target */
+class AODirectContributor {
+    dpdbuf4 *tau1_AO_;
+    std::vector<double ***> &tau2_;
+    std::vector<size_t> &count_;
+
+   public:
+    AODirectContributor(dpdbuf4 *tau1_AO, std::vector<double ***> &tau2, std::vector<size_t> &count)
+        : tau1_AO_(tau1_AO), tau2_(tau2), count_(count) {}
+
+    void operator()(int p, int q, int r, int s, int, int, int, int, int, int, int, int, double value) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        AO_contribute_integral(p, q, r, s, value, tau1_AO_, tau2_[thread]);
+        count_[thread]++;
+    }
+};
+
+}  // namespace
+
 int CCEnergyWavefunction::AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO) {
     int p, q, r, s;
     double value = 0.0;
-    int Gp, Gq, Gr, Gs, Gpr, Gps, Gqr, Gqs, Grp, Gsp, Grq, Gsq;
-    int pr, ps, qr, qs, rp, rq, sp, sq, pq, rs;
     int count = 0;
 
     auto lblptr = InBuf->labels;
@@ -64,112 +211,99 @@ int CCEnergyWavefunction::AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO,
         value = (double)valptr[InBuf->idx];
         count++;
 
-        Gp = tau1_AO->params->psym[p];
-        Gq = tau1_AO->params->psym[q];
-        Gr = tau1_AO->params->psym[r];
-        Gs = tau1_AO->params->psym[s];
-
-        Gpr = Grp = Gp ^ Gr;
-        Gps = Gsp = Gp ^ Gs;
-        Gqr = Grq = Gq ^ Gr;
-        Gqs = Gsq = Gq ^ Gs;
-
-        pq = tau1_AO->params->rowidx[p][q];
-        rs = tau1_AO->params->rowidx[r][s];
-
-        pr = tau1_AO->params->rowidx[p][r];
-        rp = tau1_AO->params->rowidx[r][p];
-        ps = tau1_AO->params->rowidx[p][s];
-        sp = tau1_AO->params->rowidx[s][p];
-        qr = tau1_AO->params->rowidx[q][r];
-        rq = tau1_AO->params->rowidx[r][q];
-        qs = tau1_AO->params->rowidx[q][s];
-        sq = tau1_AO->params->rowidx[s][q];
-
-        /* (pq|rs) */
-        if (tau1_AO->params->coltot[Gpr])
-            C_DAXPY(tau1_AO->params->coltot[Gpr], value, tau1_AO->matrix[Gpr][qs], 1, tau2_AO->matrix[Gpr][pr], 1);
-
-        if (p != q && r != s && pq != rs) {
-            /* (pq|sr) */
-            if (tau1_AO->params->coltot[Gps])
-                C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2_AO->matrix[Gps][ps], 1);
-
-            /* (qp|rs) */
-            if (tau1_AO->params->coltot[Gqr])
-                C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2_AO->matrix[Gqr][qr], 1);
-
-            /* (qp|sr) */
-            if (tau1_AO->params->coltot[Gqs])
-                C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1, tau2_AO->matrix[Gqs][qs], 1);
-
-            /* (rs|pq) */
-            if (tau1_AO->params->coltot[Grp])
-                C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2_AO->matrix[Grp][rp], 1);
-
-            /* (sr|pq) */
-            if (tau1_AO->params->coltot[Gsp])
-                C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1, tau2_AO->matrix[Gsp][sp], 1);
-
-            /* (rs|qp) */
-            if (tau1_AO->params->coltot[Grq])
-                C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1, tau2_AO->matrix[Grq][rq], 1);
-
-            /* (sr|qp) */
-            if (tau1_AO->params->coltot[Gsq])
-                C_DAXPY(tau1_AO->params->coltot[Gsq], value, tau1_AO->matrix[Gsq][rp], 1, tau2_AO->matrix[Gsq][sq], 1);
-
-        } else if (p != q && r != s && pq == rs) {
-            /* (pq|sr) */
-            if (tau1_AO->params->coltot[Gps])
-                C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2_AO->matrix[Gps][ps], 1);
-
-            /* (qp|rs) */
-            if (tau1_AO->params->coltot[Gqr])
-                C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2_AO->matrix[Gqr][qr], 1);
-
-            /* (qp|sr) */
-            if (tau1_AO->params->coltot[Gqs])
-                C_DAXPY(tau1_AO->params->coltot[Gqs], value, tau1_AO->matrix[Gqs][pr], 1, tau2_AO->matrix[Gqs][qs], 1);
-
-        } else if (p != q && r == s) {
-            /* (qp|rs) */
-            if (tau1_AO->params->coltot[Gqr])
-                C_DAXPY(tau1_AO->params->coltot[Gqr], value, tau1_AO->matrix[Gqr][ps], 1, tau2_AO->matrix[Gqr][qr], 1);
-
-            /* (rs|pq) */
-            if (tau1_AO->params->coltot[Grp])
-                C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2_AO->matrix[Grp][rp], 1);
-
-            /* (rs|qp) */
-            if (tau1_AO->params->coltot[Grq])
-                C_DAXPY(tau1_AO->params->coltot[Grq], value, tau1_AO->matrix[Grq][sp], 1, tau2_AO->matrix[Grq][rq], 1);
-
-        }
+        AO_contribute_integral(p, q, r, s, value, tau1_AO, tau2_AO->matrix);
+    }
 
-        else if (p == q && r != s) {
-            /* (pq|sr) */
-            if (tau1_AO->params->coltot[Gps])
-                C_DAXPY(tau1_AO->params->coltot[Gps], value, tau1_AO->matrix[Gps][qr], 1, tau2_AO->matrix[Gps][ps], 1);
+    return count;
+}
 
-            /* (rs|pq) */
-            if (tau1_AO->params->coltot[Grp])
-                C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2_AO->matrix[Grp][rp], 1);
+/* AO_contribute_direct(): The integral-direct counterpart of
+** AO_contribute().  The SO integrals are computed shell quartet by shell
+** quartet and contracted on the fly, so the two-electron integrals never
+** touch the disk.  Quartets whose Schwarz bound falls below the integral
+** tolerance are skipped.  The quartets are dealt out round-robin to the
+** threads, each of which accumulates into a private copy of tau2_AO;
+** the copies are summed at the end, and the thread count is lowered if
+** there is not enough core for them.  All irreps of tau1_AO and tau2_AO
+** must already be in core.
+*/
+size_t CCEnergyWavefunction::AO_contribute_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO, double tolerance) {
+    int nirreps = tau2_AO->params->nirreps;
+
+    long int size = 0;
+    for (int h = 0; h < nirreps; h++) size += ((long)tau2_AO->params->rowtot[h]) * tau2_AO->params->coltot[h];
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = params_.nthreads;
+#endif
+    if (size) nthreads = std::max(1L, std::min((long)nthreads, 1 + dpd_memfree() / size));
+
+    std::vector<double ***> tau2(nthreads);
+    tau2[0] = tau2_AO->matrix;
+    for (int t = 1; t < nthreads; t++) {
+        tau2[t] = (double ***)malloc(nirreps * sizeof(double **));
+        for (int h = 0; h < nirreps; h++)
+            tau2[t][h] = global_dpd_->dpd_block_matrix(tau2_AO->params->rowtot[h], tau2_AO->params->coltot[h]);
+    }
 
-            /* (sr|pq) */
-            if (tau1_AO->params->coltot[Gsp])
-                C_DAXPY(tau1_AO->params->coltot[Gsp], value, tau1_AO->matrix[Gsp][rq], 1, tau2_AO->matrix[Gsp][sp], 1);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
+    for (int t = 0; t < nthreads; t++) tb.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->eri()));
+    auto eri = std::make_shared<TwoBodySOInt>(tb, integral_);
+    eri->set_cutoff(tolerance);
+
+    /* Schwarz bound for each pair of SO shells: the largest AO shell pair
+       bound among their components, scaled by the square root of the
+       number of AO shells mixed in, which bounds the SO coefficients */
+    auto sieve = std::make_shared<ERISieve>(basisset_, 0.0);
+    int nsoshell = sobasisset_->nshell();
+    std::vector<double> schwarz(nsoshell * (size_t)nsoshell, 0.0);
+    for (int P = 0; P < nsoshell; P++) {
+        const SOTransform &tP = sobasisset_->sotrans(P);
+        for (int Q = 0; Q <= P; Q++) {
+            const SOTransform &tQ = sobasisset_->sotrans(Q);
+            double max = 0.0;
+            for (int i = 0; i < tP.naoshell; i++)
+                for (int j = 0; j < tQ.naoshell; j++) {
+                    int M = tP.aoshell[i].aoshell, N = tQ.aoshell[j].aoshell;
+                    max = std::max(max, std::sqrt(sieve->shell_ceiling2(M, N, M, N)));
+                }
+            schwarz[P * (size_t)nsoshell + Q] = schwarz[Q * (size_t)nsoshell + P] =
+                max * std::sqrt((double)tP.naoshell * tQ.naoshell);
+        }
+    }
 
+    std::vector<size_t> count(nthreads, 0);
+    AODirectContributor contributor(tau1_AO, tau2, count);
+
+#pragma omp parallel num_threads(nthreads)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        SOShellCombinationsIterator shellIter(sobasisset_, sobasisset_, sobasisset_, sobasisset_);
+        size_t quartet = 0;
+        for (shellIter.first(); !shellIter.is_done(); shellIter.next(), quartet++) {
+            if (quartet % nthreads != (size_t)thread) continue;
+            int P = shellIter.p(), Q = shellIter.q(), R = shellIter.r(), S = shellIter.s();
+            if (schwarz[P * (size_t)nsoshell + Q] * schwarz[R * (size_t)nsoshell + S] < tolerance) continue;
+            eri->compute_shell(P, Q, R, S, contributor);
         }
+    }
 
-        else if (p == q && r == s && pq != rs) {
-            /* (rs|pq) */
-            if (tau1_AO->params->coltot[Grp])
-                C_DAXPY(tau1_AO->params->coltot[Grp], value, tau1_AO->matrix[Grp][sq], 1, tau2_AO->matrix[Grp][rp], 1);
+    for (int t = 1; t < nthreads; t++) {
+        for (int h = 0; h < nirreps; h++) {
+            long int blocksize = ((long)tau2_AO->params->rowtot[h]) * tau2_AO->params->coltot[h];
+            if (blocksize) C_DAXPY(blocksize, 1.0, tau2[t][h][0], 1, tau2_AO->matrix[h][0], 1);
+            global_dpd_->free_dpd_block(tau2[t][h], tau2_AO->params->rowtot[h], tau2_AO->params->coltot[h]);
         }
+        free(tau2[t]);
     }
 
-    return count;
+    size_t total = 0;
+    for (int t = 0; t < nthreads; t++) total += count[t];
+    return total;
 }
 
 }  // namespace ccenergy
@@ -208,14 +208,12 @@ void CCEnergyWavefunction::BT2() {
         global_dpd_->buf4_init(&Z1, PSIF_CC_TMP0, 0, 7, 2, 7, 2, 0, "Z(ab,ij)");
 
         global_dpd_->contract444(&B_anti, &tauIJAB, &Z1, 0, 0, 1, 0);
-        global_dpd_->buf4_sort(&Z1, PSIF_CC_TMP0, rspq, 2, 7, "Z(ij,ab)");
-        global_dpd_->buf4_init(&Z2, PSIF_CC_TMP0, 0, 2, 7, 2, 7, 0, "Z(ij,ab)");
+        global_dpd_->buf4_init_sorted(&Z2, &Z1, rspq, 2, 7, "Z(ij,ab)");
         global_dpd_->buf4_axpy(&Z2, &newtIJAB, 1);
         global_dpd_->buf4_close(&Z2);
 
         global_dpd_->contract444(&B_anti, &tauijab, &Z1, 0, 0, 1, 0);
-        global_dpd_->buf4_sort(&Z1, PSIF_CC_TMP0, rspq, 2, 7, "Z(ij,ab)");
-        global_dpd_->buf4_init(&Z2, PSIF_CC_TMP0, 0, 2, 7, 2, 7, 0, "Z(ij,ab)");
+        global_dpd_->buf4_init_sorted(&Z2, &Z1, rspq, 2, 7, "Z(ij,ab)");
         global_dpd_->buf4_axpy(&Z2, &newtijab, 1);
         global_dpd_->buf4_close(&Z2);
 
@@ -254,21 +252,19 @@ void CCEnergyWavefunction::BT2() {
         global_dpd_->buf4_init(&B, PSIF_CC_BINTS, 0, 7, 7, 5, 5, 1, "B <AB|CD>");
         global_dpd_->buf4_init(&Z1, PSIF_CC_TMP0, 0, 7, 2, 7, 2, 0, "Z(AB,IJ)");
         global_dpd_->contract444(&B, &tauIJAB, &Z1, 0, 0, 1, 0);
-        global_dpd_->buf4_sort(&Z1, PSIF_CC_TMP0, rspq, 2, 7, "Z(IJ,AB)");
-        global_dpd_->buf4_close(&Z1);
-        global_dpd_->buf4_init(&Z2, PSIF_CC_TMP0, 0, 2, 7, 2, 7, 0, "Z(IJ,AB)");
+        global_dpd_->buf4_init_sorted(&Z2, &Z1, rspq, 2, 7, "Z(IJ,AB)");
         global_dpd_->buf4_axpy(&Z2, &newtIJAB, 1);
         global_dpd_->buf4_close(&Z2);
+        global_dpd_->buf4_close(&Z1);
         global_dpd_->buf4_close(&B);
 
         global_dpd_->buf4_init(&B, PSIF_CC_BINTS, 0, 17, 17, 15, 15, 1, "B <ab|cd>");
         global_dpd_->buf4_init(&Z1, PSIF_CC_TMP0, 0, 17, 12, 17, 12, 0, "Z(ab,ij)");
         global_dpd_->contract444(&B, &tauijab, &Z1, 0, 0, 1, 0);
-        global_dpd_->buf4_sort(&Z1, PSIF_CC_TMP0, rspq, 12, 17, "Z(ij,ab)");
-        global_dpd_->buf4_close(&Z1);
-        global_dpd_->buf4_init(&Z2, PSIF_CC_TMP0, 0, 12, 17, 12, 17, 0, "Z(ij,ab)");
+        global_dpd_->buf4_init_sorted(&Z2, &Z1, rspq, 12, 17, "Z(ij,ab)");
         global_dpd_->buf4_axpy(&Z2, &newtijab, 1);
         global_dpd_->buf4_close(&Z2);
+        global_dpd_->buf4_close(&Z1);
         global_dpd_->buf4_close(&B);
 
         global_dpd_->buf4_init(&B, PSIF_CC_BINTS, 0, 28, 28, 28, 28, 0, "B <Ab|Cd>");
@@ -58,11 +58,11 @@ void CCEnergyWavefunction::BT2_AO() {
     int **T2_cd_row_start, **T2_pq_row_start;
     int **T2_CD_row_start, **T2_Cd_row_start;
     dpdbuf4 tau, t2, tau1_AO, tau2_AO;
-    dpdfile4 T;
     struct iwlbuf InBuf;
     int lastbuf;
     double tolerance = 1e-14;
-    int counter = 0, counterAA = 0, counterBB = 0, counterAB = 0;
+    size_t counter = 0;
+    int counterAA = 0, counterBB = 0, counterAB = 0;
 
     auto nirreps = moinfo_.nirreps;
     auto sopi = moinfo_.sopi;
@@ -122,7 +122,7 @@ void CCEnergyWavefunction::BT2_AO() {
 
     if (params_.ref == 0) { /** RHF **/
 
-        if (params_.aobasis == "DISK") {
+        if (params_.aobasis == "DISK" || params_.aobasis == "DIRECT") {
             dpd_set_default(1);
             global_dpd_->buf4_init(&tau1_AO, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tauIjPq (1)");
             global_dpd_->buf4_scm(&tau1_AO, 0.0);
@@ -146,7 +146,7 @@ void CCEnergyWavefunction::BT2_AO() {
             global_dpd_->buf4_init(&tau2_AO, PSIF_CC_TMP0, 0, 5, 0, 5, 0, 0, "tauPqIj (2)");
             global_dpd_->buf4_scm(&tau2_AO, 0.0);
 
-            if (params_.df) {
+            if (params_.df && params_.aobasis == "DISK") {
                 dpdbuf4 B;
                 // 5 = unpacked. eventually use perm sym and pair number 8
                 global_dpd_->buf4_init(&B, PSIF_CC_OEI, 0, 5, 43, 8, 43, 0, "B(pq|Q)");
@@ -159,23 +159,28 @@ void CCEnergyWavefunction::BT2_AO() {
                     global_dpd_->buf4_mat_irrep_init(&tau2_AO, h);
                 }
 
-                iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
+                if (params_.aobasis == "DIRECT") {
+                    /* Compute the SO integrals on the fly; nothing is read from disk */
+                    counter = AO_contribute_direct(&tau1_AO, &tau2_AO, tolerance);
+                } else {
+                    iwl_buf_init(&InBuf, PSIF_SO_TEI, tolerance, 1, 1);
 
-                lastbuf = InBuf.lastbuf;
-
-                counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-
-                while (!lastbuf) {
-                    iwl_buf_fetch(&InBuf);
                     lastbuf = InBuf.lastbuf;
 
                     counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
-                }
 
-                iwl_buf_close(&InBuf, 1);
+                    while (!lastbuf) {
+                        iwl_buf_fetch(&InBuf);
+                        lastbuf = InBuf.lastbuf;
+
+                        counter += AO_contribute(&InBuf, &tau1_AO, &tau2_AO);
+                    }
+
+                    iwl_buf_close(&InBuf, 1);
+                }
 
                 if (params_.print & 2)
-                    outfile->Printf("     *** Processed %d SO integrals for <ab||cd> --> T2\n", counter);
+                    outfile->Printf("     *** Processed %zu SO integrals for <ab||cd> --> T2\n", counter);
 
                 for (int h = 0; h < nirreps; h++) {
                     global_dpd_->buf4_mat_irrep_wrt(&tau2_AO, h);
@@ -204,21 +209,6 @@ void CCEnergyWavefunction::BT2_AO() {
 
             global_dpd_->buf4_close(&t2);
             global_dpd_->buf4_close(&tau2_AO);
-
-        } else if (params_.aobasis == "DIRECT") {
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "tauIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            global_dpd_->file4_init(&T, PSIF_CC_TAMPS, 0, 0, 5, "New tIjAb");
-            global_dpd_->file4_cache_del(&T);
-            global_dpd_->file4_close(&T);
-
-            /* close the CC_TAMPS file for cints to use it */
-            psio_close(PSIF_CC_TAMPS, 1);
-
-            /* re-open CCC_TAMPS for remaining terms */
-            psio_open(PSIF_CC_TAMPS, PSIO_OPEN_OLD);
         }
 
     } else if (params_.ref == 1) { /** ROHF **/
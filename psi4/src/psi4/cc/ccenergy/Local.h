@@ -56,6 +56,7 @@ struct Local {
     double *eps_occ;
     double **eps_vir;
     double cutoff;
+    double pno_cutoff;
     std::string method;
     std::string weakp;
     int filter_singles;
@@ -45,10 +45,15 @@ struct Params {
     double convergence;
     double e_convergence;
     int restart;
+    int checkpoint_interval;     /* iterations between restart snapshots; 0 = none */
+    std::string checkpoint_file; /* where the snapshots go */
     long int memory;
     std::string aobasis;
     int cachelev;
     int cachetype;
+    int prefetch;
+    int dpd_profile;              /* time and count the DPD operations? */
+    std::string dpd_profile_json; /* where to write the counters as JSON, if anywhere */
     int ref;
     int diis;
     std::string wfn;
@@ -68,7 +73,7 @@ struct Params {
     int just_energy;    /* just compute energy from T amplitudes on disk and quit */
     int just_residuals; /* just compute residuals from T amplitudes on disk and quit */
     std::string abcd;
-    int t3_Ws_incore;
+    int t3_Ws_incore; /* 1 in core, 0 on disk, -1 in core if they fit */
     int nthreads;
     int scs;
     int scsn;
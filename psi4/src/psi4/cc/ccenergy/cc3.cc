@@ -69,7 +69,12 @@ void CCEnergyWavefunction::cc3() {
         global_dpd_->buf4_init(&WAmEf, PSIF_CC3_HET1, 0, 10, 5, 10, 5, 0, "CC3 WAmEf (mA,Ef)");
         global_dpd_->buf4_init(&WMnIe, PSIF_CC3_HET1, 0, 0, 10, 0, 10, 0, "CC3 WMnIe (Mn,Ie)");
 
-        if (params_.t3_Ws_incore)
+        bool incore = (params_.t3_Ws_incore == 1);
+        if (params_.t3_Ws_incore == -1)
+            incore = (global_dpd_->cc3_sigma_RHF_ic_memory(&TIjAb, &WAbEi, &WMbIj, &Dints, &WAmEf, &WMnIe, &TIjAb_new,
+                                                           moinfo_.virtpi, params_.nthreads) < dpd_memfree());
+
+        if (incore)
             global_dpd_->cc3_sigma_RHF_ic(&TIjAb, &WAbEi, &WMbIj, 1, &Dints, &TIA_new, 1, &FME, &WAmEf, &WMnIe,
                                           &TIjAb_new, moinfo_.occpi, moinfo_.occ_off, moinfo_.virtpi, moinfo_.vir_off,
                                           0.0, "outfile", params_.nthreads, params_.newtrips);
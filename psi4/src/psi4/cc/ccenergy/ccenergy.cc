@@ -102,7 +102,8 @@ double CCEnergyWavefunction::compute_energy() {
         spaces.push_back(moinfo_.bvirtpi);
         spaces.push_back(moinfo_.bvir_sym);
         delete[] dpd_list[0];
-        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, 0, cachefiles.data(), cachelist, nullptr, 4, spaces);
+        dpd_list[0] = new DPD(0, moinfo_.nirreps, params_.memory, params_.cachetype, cachefiles.data(), cachelist,
+                              nullptr, 4, spaces);
         dpd_set_default(0);
 
         if (params_.df) {
@@ -146,6 +147,13 @@ double CCEnergyWavefunction::compute_energy() {
         }
     }
 
+    /* Overlap the reads of out-of-core contractions with their DGEMMs */
+    dpd_list[0]->set_prefetch(params_.prefetch);
+    if (params_.dpd_profile) {
+        dpd_list[0]->profile_reset();
+        dpd_list[0]->profile_enable(true);
+    }
+
     if ((params_.just_energy) || (params_.just_residuals)) {
         one_step();
         if (params_.ref == 2)
@@ -159,9 +167,15 @@ double CCEnergyWavefunction::compute_energy() {
 
     if (params_.local) {
         local_init();
-        if (local_.weakp == "MP2") lmp2();
+        if (local_.weakp == "MP2" && local_.method != "PNO") lmp2();
     }
 
+    /* Pick up from the snapshot of an interrupted run, if there is one */
+    int resume_iter = 0;
+    double resume_energy = 0.0;
+    if (params_.restart && params_.checkpoint_interval)
+        snapshot_read(params_.checkpoint_file, snapshot_id(), &resume_iter, &resume_energy);
+
     init_amps();
 
     /* Compute the MP2 energy while we're here */
@@ -192,7 +206,7 @@ double CCEnergyWavefunction::compute_energy() {
     moinfo_.d2diag = d2diag();
     update();
     checkpoint();
-    for (moinfo_.iter = 1; moinfo_.iter <= params_.maxiter; moinfo_.iter++) {
+    for (moinfo_.iter = resume_iter + 1; moinfo_.iter <= params_.maxiter; moinfo_.iter++) {
         sort_amps();
 
         timer_on("F build");
@@ -273,6 +287,7 @@ double CCEnergyWavefunction::compute_energy() {
             outfile->Printf("\n");
             amp_write();
             if (params_.analyze != 0) analyze();
+            if (params_.checkpoint_interval) snapshot_remove(params_.checkpoint_file);
             break;
         }
         if (params_.diis) diis(moinfo_.iter);
@@ -287,6 +302,11 @@ double CCEnergyWavefunction::compute_energy() {
         moinfo_.d2diag = d2diag();
         update();
         checkpoint();
+        if (params_.checkpoint_interval && !(moinfo_.iter % params_.checkpoint_interval))
+            snapshot_write(params_.checkpoint_file, snapshot_id(), moinfo_.iter, moinfo_.ecc, snapshot_entries());
+
+        /* The first iteration has touched every intermediate; keep what the cache learned */
+        if (moinfo_.iter == 1) dpd_list[0]->file4_cache_freeze();
     }  // end loop over iterations
 
     // DGAS Edit
@@ -299,6 +319,8 @@ double CCEnergyWavefunction::compute_energy() {
     if (!done) {
         outfile->Printf("     ** Wave function not converged to %2.1e ** \n", params_.convergence);
 
+        if (params_.cachelev) dpd_list[0]->file4_cache_print_stats("outfile");
+        if (params_.dpd_profile) dpd_profile_report();
         if (params_.aobasis != "NONE") dpd_close(1);
         dpd_close(0);
         cleanup();
@@ -446,6 +468,8 @@ double CCEnergyWavefunction::compute_energy() {
 
     if (params_.brueckner) Process::environment.globals["BRUECKNER CONVERGED"] = rotate();
 
+    if (params_.cachelev) dpd_list[0]->file4_cache_print_stats("outfile");
+    if (params_.dpd_profile) dpd_profile_report();
     if (params_.aobasis != "NONE") dpd_close(1);
     dpd_close(0);
 
@@ -506,6 +530,43 @@ void CCEnergyWavefunction::checkpoint() {
     for (int i = PSIF_CC_MIN; i <= PSIF_CC_MAX; i++) psio_open(i, 1);
 }
 
+/* Prints the DPD operation counters gathered since dpd_init() and stops gathering */
+void CCEnergyWavefunction::dpd_profile_report() {
+    dpd_list[0]->profile_print("outfile");
+    if (!params_.dpd_profile_json.empty()) dpd_list[0]->profile_json(params_.dpd_profile_json);
+    dpd_list[0]->profile_enable(false);
+}
+
+/* Identifies the snapshots taken by this computation */
+SnapshotKey CCEnergyWavefunction::snapshot_id() {
+    int nocc = 0, nvir = 0;
+    for (int h = 0; h < moinfo_.nirreps; h++) {
+        if (params_.ref == 2) {
+            nocc += moinfo_.aoccpi[h] + moinfo_.boccpi[h];
+            nvir += moinfo_.avirtpi[h] + moinfo_.bvirtpi[h];
+        } else {
+            nocc += moinfo_.occpi[h];
+            nvir += moinfo_.virtpi[h];
+        }
+    }
+    return snapshot_key("CCENERGY " + params_.wfn, params_.ref, moinfo_.nirreps, nocc, nvir, 0, moinfo_.eref);
+}
+
+/* Everything the iterations need to resume: T1, T2, and the DIIS history */
+SnapshotEntries CCEnergyWavefunction::snapshot_entries() {
+    SnapshotEntries entries;
+    entries.push_back(std::make_pair(PSIF_CC_OEI, std::string("tIA")));
+    if (params_.ref != 0) {
+        entries.push_back(std::make_pair(PSIF_CC_OEI, std::string("tia")));
+        entries.push_back(std::make_pair(PSIF_CC_TAMPS, std::string("tIJAB")));
+        entries.push_back(std::make_pair(PSIF_CC_TAMPS, std::string("tijab")));
+    }
+    entries.push_back(std::make_pair(PSIF_CC_TAMPS, std::string("tIjAb")));
+    entries.push_back(std::make_pair(PSIF_CC_DIIS_ERR, std::string("DIIS Error Vectors")));
+    entries.push_back(std::make_pair(PSIF_CC_DIIS_AMP, std::string("DIIS Amplitude Vectors")));
+    return entries;
+}
+
 /* just use T's on disk and don't iterate */
 void CCEnergyWavefunction::one_step() {
     dpdfile2 t1;
@@ -40,6 +40,8 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
 #include "psi4/psifiles.h"
 #include "psi4/psi4-dec.h"
 
@@ -109,10 +111,16 @@ void CCEnergyWavefunction::get_params(Options &options) {
     params_.convergence = options.get_double("R_CONVERGENCE");
     params_.e_convergence = options.get_double("E_CONVERGENCE");
     params_.restart = options.get_bool("RESTART");
+    params_.checkpoint_interval = options.get_int("CHECKPOINT_INTERVAL");
+    params_.checkpoint_file = options.get_str("CHECKPOINT_FILE");
+    if (params_.checkpoint_file.empty())
+        params_.checkpoint_file = get_writer_file_prefix(molecule_->name()) + ".ccenergy.snap";
 
     params_.memory = Process::environment.get_memory();
 
     params_.aobasis = options.get_str("AO_BASIS");
+    if (params_.aobasis == "DIRECT" && params_.ref != 0)
+        throw PsiException("AO_BASIS = DIRECT is only available for RHF references", __FILE__, __LINE__);
     params_.cachelev = options.get_int("CACHELEVEL");
 
     params_.cachetype = 1;
@@ -121,12 +129,18 @@ void CCEnergyWavefunction::get_params(Options &options) {
         params_.cachetype = 1;
     else if (cachetype == "LRU")
         params_.cachetype = 0;
+    else if (cachetype == "COST")
+        params_.cachetype = 2;
     else
         throw PsiException("Error in input: invalid CACHETYPE", __FILE__, __LINE__);
 
-    if (params_.ref == 2) /* No LOW cacheing yet for UHF references */
+    if (params_.ref == 2 && params_.cachetype == 1) /* No LOW cacheing yet for UHF references */
         params_.cachetype = 0;
 
+    params_.prefetch = options.get_bool("DPD_PREFETCH");
+    params_.dpd_profile = options.get_bool("DPD_PROFILE");
+    params_.dpd_profile_json = options.get_str("DPD_PROFILE_JSON");
+
     params_.nthreads = Process::environment.get_n_threads();
     if (options["CC_NUM_THREADS"].has_changed()) {
         params_.nthreads = options.get_int("CC_NUM_THREADS");
@@ -138,6 +152,7 @@ void CCEnergyWavefunction::get_params(Options &options) {
     params_.local = options.get_bool("LOCAL");
     local_.cutoff = options.get_double("LOCAL_CUTOFF");
     local_.method = options.get_str("LOCAL_METHOD");
+    local_.pno_cutoff = options.get_double("LOCAL_PNO_CUTOFF");
     local_.weakp = options.get_str("LOCAL_WEAKP");
 
     // local.filter_singles = options.get_bool("LOCAL_FILTER_SINGLES");
@@ -166,7 +181,8 @@ void CCEnergyWavefunction::get_params(Options &options) {
     params_.print_mp2_amps = options.get_bool("MP2_AMPS_PRINT");
     params_.print_pair_energies = options.get_bool("PAIR_ENERGIES_PRINT");
     params_.spinadapt_energies = options.get_bool("SPINADAPT_ENERGIES");
-    params_.t3_Ws_incore = options.get_bool("T3_WS_INCORE");
+    /* Unless told otherwise, hold the CC3 Ws in core whenever they fit */
+    params_.t3_Ws_incore = options["T3_WS_INCORE"].has_changed() ? options.get_bool("T3_WS_INCORE") : -1;
 
     /* get parameters related to SCS-MP2 or SCS-N-MP2 */
     /* see papers by S. Grimme or J. Platz */
@@ -204,11 +220,17 @@ void CCEnergyWavefunction::get_params(Options &options) {
     outfile->Printf("    R_Convergence   =     %3.1e\n", params_.convergence);
     outfile->Printf("    E_Convergence   =     %3.1e\n", params_.e_convergence);
     outfile->Printf("    Restart         =     %s\n", params_.restart ? "Yes" : "No");
+    if (params_.checkpoint_interval)
+        outfile->Printf("    Snapshots       =     every %d iterations to %s\n", params_.checkpoint_interval,
+                        params_.checkpoint_file.c_str());
     outfile->Printf("    DIIS            =     %s\n", params_.diis ? "Yes" : "No");
     outfile->Printf("    AO Basis        =     %s\n", params_.aobasis.c_str());
     outfile->Printf("    ABCD            =     %s\n", params_.abcd.c_str());
     outfile->Printf("    Cache Level     =     %1d\n", params_.cachelev);
-    outfile->Printf("    Cache Type      =    %4s\n", params_.cachetype ? "LOW" : "LRU");
+    outfile->Printf("    Cache Type      =    %4s\n",
+                    params_.cachetype == 2 ? "COST" : (params_.cachetype ? "LOW" : "LRU"));
+    outfile->Printf("    Prefetch        =     %s\n", params_.prefetch ? "Yes" : "No");
+    outfile->Printf("    DPD profile     =     %s\n", params_.dpd_profile ? "Yes" : "No");
     outfile->Printf("    Print Level     =     %1d\n", params_.print);
     outfile->Printf("    Num. of threads =     %d\n", params_.nthreads);
     outfile->Printf("    # Amps to Print =     %1d\n", params_.num_amps);
@@ -221,7 +243,8 @@ void CCEnergyWavefunction::get_params(Options &options) {
     outfile->Printf("    Local CC        =     %s\n", params_.local ? "Yes" : "No");
 
     if (params_.wfn == "CC3" || params_.wfn == "EOM_CC3")
-        outfile->Printf("    T3 Ws incore    =     %s\n", params_.t3_Ws_incore ? "Yes" : "No");
+        outfile->Printf("    T3 Ws incore    =     %s\n",
+                        params_.t3_Ws_incore == -1 ? "Auto" : (params_.t3_Ws_incore ? "Yes" : "No"));
 
     if (params_.local) {
         outfile->Printf("    Local Cutoff       =     %3.1e\n", local_.cutoff);
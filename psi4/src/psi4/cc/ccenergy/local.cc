@@ -74,6 +74,8 @@ void CCEnergyWavefunction::local_init() {
 
     local_.weak_pair_energy = 0.0;
 
+    if (local_.method == "PNO") local_pno_init();
+
     local_.weak_pairs = init_int_array(nocc * nocc);
     psio_read_entry(PSIF_CC_INFO, "Local Weak Pairs", (char *)local_.weak_pairs,
                     local_.nocc * local_.nocc * sizeof(int));
@@ -81,6 +83,175 @@ void CCEnergyWavefunction::local_init() {
     outfile->Printf("    Localization parameters ready.\n\n");
 }
 
+/*!
+** local_pno_init(): Build pair natural orbitals from the semicanonical MP2
+** amplitudes and store them in the same CC_INFO entries as the Werner
+** domains, so that local_filter_T1() and local_filter_T2() truncate each
+** pair's virtual space to its PNOs.
+**
+** For every pair ij the MP2 pair density
+**
+**   D(ij) = 1/(1+delta_ij) [ Tt(ij)^T T(ij) + Tt(ij) T(ij)^T ],  Tt = 2 T - T^T
+**
+** is diagonalized, and natural orbitals with occupation above LOCAL_PNO_CUTOFF
+** are kept.  The retained PNOs are semicanonicalized in the virtual Fock
+** matrix.  Since the amplitudes stay in the canonical virtual basis, the
+** residual projector (V) is the identity; W holds the PNO coefficients.  Pairs
+** left without any PNOs are flagged as weak; with LOCAL_WEAKP = MP2 their
+** MP2 pair energies are collected in local_.weak_pair_energy, and with
+** LOCAL_WEAKP = NONE every pair keeps at least its leading PNO instead.
+** See F. Neese et al., J. Chem. Phys. 131, 064103 (2009).
+*/
+void CCEnergyWavefunction::local_pno_init() {
+    dpdfile2 fIJ, fAB;
+    dpdbuf4 D;
+    psio_address next;
+
+    auto nocc = local_.nocc;
+    auto nvir = local_.nvir;
+
+    if (moinfo_.nirreps != 1)
+        throw PsiException("PNO truncation of local-CC requires C1 symmetry.", __FILE__, __LINE__);
+
+    local_.eps_occ = init_array(nocc);
+    global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
+    global_dpd_->file2_mat_init(&fIJ);
+    global_dpd_->file2_mat_rd(&fIJ);
+    for (int i = 0; i < nocc; i++) local_.eps_occ[i] = fIJ.matrix[0][i][i];
+    global_dpd_->file2_mat_close(&fIJ);
+    global_dpd_->file2_close(&fIJ);
+
+    global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
+    global_dpd_->file2_mat_init(&fAB);
+    global_dpd_->file2_mat_rd(&fAB);
+    double **Fvv = fAB.matrix[0];
+
+    global_dpd_->buf4_init(&D, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
+    global_dpd_->buf4_mat_irrep_init(&D, 0);
+    global_dpd_->buf4_mat_irrep_rd(&D, 0);
+
+    local_.pairdom_len = init_int_array(nocc * nocc);
+    local_.pairdom_nrlen = init_int_array(nocc * nocc);
+    local_.weak_pairs = init_int_array(nocc * nocc);
+    local_.W = (double ***)malloc(nocc * nocc * sizeof(double **));
+    local_.eps_vir = (double **)malloc(nocc * nocc * sizeof(double *));
+
+    auto T = block_matrix(nvir, nvir);
+    auto Tt = block_matrix(nvir, nvir);
+    auto Dij = block_matrix(nvir, nvir);
+    auto Q = block_matrix(nvir, nvir);
+    auto X = block_matrix(nvir, nvir);
+    auto Fpno = block_matrix(nvir, nvir);
+    auto occ = init_array(nvir);
+
+    int npno_tot = 0, nweak = 0;
+    for (int i = 0, ij = 0; i < nocc; i++) {
+        for (int j = 0; j < nocc; j++, ij++) {
+            /* Semicanonical MP2 amplitudes and their spin-adapted partner */
+            double *Dints = D.matrix[0][ij];
+            double emp2 = 0.0;
+            for (int a = 0; a < nvir; a++)
+                for (int b = 0; b < nvir; b++)
+                    T[a][b] = Dints[a * nvir + b] /
+                              (local_.eps_occ[i] + local_.eps_occ[j] - Fvv[a][a] - Fvv[b][b]);
+            for (int a = 0; a < nvir; a++)
+                for (int b = 0; b < nvir; b++) {
+                    Tt[a][b] = 2.0 * T[a][b] - T[b][a];
+                    emp2 += Dints[a * nvir + b] * Tt[a][b];
+                }
+
+            /* Pair density and its natural orbitals, in descending occupation */
+            double fac = (i == j) ? 0.5 : 1.0;
+            C_DGEMM('t', 'n', nvir, nvir, nvir, fac, Tt[0], nvir, T[0], nvir, 0.0, Dij[0], nvir);
+            C_DGEMM('n', 't', nvir, nvir, nvir, fac, Tt[0], nvir, T[0], nvir, 1.0, Dij[0], nvir);
+            sq_rsp(nvir, nvir, Dij, occ, 3, Q, 1.0e-14);
+
+            int npno = 0;
+            while (npno < nvir && occ[npno] > local_.pno_cutoff) npno++;
+
+            /* Weak pairs still carry their leading PNO, which the filter never uses */
+            if (!npno && i != j && local_.weakp != "NONE") {
+                local_.weak_pairs[ij] = 1;
+                if (local_.weakp == "MP2") local_.weak_pair_energy += emp2;
+                nweak++;
+            }
+            if (!npno) npno = 1;
+
+            /* Semicanonicalize the retained PNOs: W = Q U, eps = eig(Q^T F Q) */
+            C_DGEMM('n', 'n', nvir, npno, nvir, 1.0, Fvv[0], nvir, Q[0], nvir, 0.0, X[0], nvir);
+            C_DGEMM('t', 'n', npno, npno, nvir, 1.0, Q[0], nvir, X[0], nvir, 0.0, Fpno[0], nvir);
+            auto Fsub = block_matrix(npno, npno);
+            auto U = block_matrix(npno, npno);
+            for (int p = 0; p < npno; p++)
+                for (int q = 0; q < npno; q++) Fsub[p][q] = Fpno[p][q];
+
+            local_.pairdom_len[ij] = nvir;
+            local_.pairdom_nrlen[ij] = npno;
+            local_.eps_vir[ij] = init_array(npno);
+            local_.W[ij] = block_matrix(nvir, npno);
+            sq_rsp(npno, npno, Fsub, local_.eps_vir[ij], 1, U, 1.0e-14);
+            C_DGEMM('n', 'n', nvir, npno, npno, 1.0, Q[0], nvir, U[0], npno, 0.0, local_.W[ij][0], npno);
+            free_block(Fsub);
+            free_block(U);
+
+            if (!local_.weak_pairs[ij]) npno_tot += npno;
+        }
+    }
+
+    free_block(T);
+    free_block(Tt);
+    free_block(Dij);
+    free_block(Q);
+    free_block(X);
+    free_block(Fpno);
+    free(occ);
+
+    global_dpd_->buf4_mat_irrep_close(&D, 0);
+    global_dpd_->buf4_close(&D);
+    global_dpd_->file2_mat_close(&fAB);
+    global_dpd_->file2_close(&fAB);
+
+    outfile->Printf("    PNO occupation cutoff     = %3.1e\n", local_.pno_cutoff);
+    outfile->Printf("    Average PNOs per pair     = %6.2f (of %d virtuals)\n", (double)npno_tot / (nocc * nocc - nweak),
+                    nvir);
+    outfile->Printf("    Number of weak pairs      = %d\n", nweak);
+    if (local_.weakp == "MP2") outfile->Printf("    Weak-pair MP2 energy      = %20.15f\n", local_.weak_pair_energy);
+
+    /* Store the PNO spaces where the local filters expect the pair domains */
+    auto Vij = block_matrix(nvir, nvir);
+    for (int a = 0; a < nvir; a++) Vij[a][a] = 1.0;
+
+    psio_write_entry(PSIF_CC_INFO, "Local Weak Pairs", (char *)local_.weak_pairs, nocc * nocc * sizeof(int));
+    psio_write_entry(PSIF_CC_INFO, "Local Pair Domain Length", (char *)local_.pairdom_len, nocc * nocc * sizeof(int));
+    psio_write_entry(PSIF_CC_INFO, "Local Pair Domain NR Length", (char *)local_.pairdom_nrlen,
+                     nocc * nocc * sizeof(int));
+    psio_write_entry(PSIF_CC_INFO, "Local Occupied Orbital Energies", (char *)local_.eps_occ, nocc * sizeof(double));
+    next = PSIO_ZERO;
+    for (int ij = 0; ij < nocc * nocc; ij++)
+        psio_write(PSIF_CC_INFO, "Local Virtual Orbital Energies", (char *)local_.eps_vir[ij],
+                   local_.pairdom_nrlen[ij] * sizeof(double), next, &next);
+    next = PSIO_ZERO;
+    for (int ij = 0; ij < nocc * nocc; ij++)
+        psio_write(PSIF_CC_INFO, "Local Residual Vector (V)", (char *)Vij[0], nvir * nvir * sizeof(double), next,
+                   &next);
+    next = PSIO_ZERO;
+    for (int ij = 0; ij < nocc * nocc; ij++)
+        psio_write(PSIF_CC_INFO, "Local Transformation Matrix (W)", (char *)local_.W[ij][0],
+                   nvir * local_.pairdom_nrlen[ij] * sizeof(double), next, &next);
+    free_block(Vij);
+
+    for (int ij = 0; ij < nocc * nocc; ij++) {
+        free_block(local_.W[ij]);
+        free(local_.eps_vir[ij]);
+    }
+    free(local_.W);
+    free(local_.eps_vir);
+    free(local_.eps_occ);
+    free(local_.pairdom_len);
+    free(local_.pairdom_nrlen);
+    free(local_.weak_pairs);
+}
+
 void CCEnergyWavefunction::local_done() { outfile->Printf("    Local parameters free.\n"); }
 
 void CCEnergyWavefunction::local_filter_T1(dpdfile2 *T1) {
@@ -0,0 +1,209 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup CCENERGY
+    \brief Restart snapshots of the CC iterations
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+#include "snapshot.h"
+
+namespace psi {
+namespace ccenergy {
+
+namespace {
+
+const char snapshot_magic[8] = "PSICCSN";
+const int snapshot_version = 1;
+
+/* Header at the top of the file; nentries (unit, label, size, data)
+   records follow it */
+struct SnapshotHeader {
+    char magic[8];
+    int version;
+    SnapshotKey key;
+    int iter;
+    double energy;
+    int nentries;
+};
+
+struct SnapshotRecord {
+    int unit;
+    char label[PSIO_KEYLEN];
+    size_t size;
+};
+
+/* Entries are streamed through a buffer of at most this many bytes */
+const size_t snapshot_chunk = 512 * (size_t)PSIO_PAGELEN;
+
+/* Bytes held by an entry of an open unit, or zero if there is no such entry */
+size_t entry_size(int unit, const char *label) {
+    psio_tocentry *entry = psio_tocscan(unit, label);
+    if (entry == nullptr) return 0;
+    size_t header = sizeof(psio_tocentry) - 2 * sizeof(psio_tocentry *);
+    size_t start = entry->sadd.page * PSIO_PAGELEN + entry->sadd.offset + header;
+    size_t end = entry->eadd.page * PSIO_PAGELEN + entry->eadd.offset;
+    return end - start;
+}
+
+bool same_key(const SnapshotKey &a, const SnapshotKey &b) {
+    return !std::strncmp(a.solver, b.solver, sizeof(a.solver)) && a.reference == b.reference &&
+           a.nirreps == b.nirreps && a.nocc == b.nocc && a.nvir == b.nvir && a.state == b.state &&
+           std::fabs(a.eref - b.eref) < 1.0e-8;
+}
+
+void write_or_throw(const void *data, size_t size, std::FILE *fp, const std::string &path) {
+    if (std::fwrite(data, 1, size, fp) != size) {
+        std::fclose(fp);
+        throw PsiException("Unable to write CC snapshot " + path, __FILE__, __LINE__);
+    }
+}
+
+void read_or_throw(void *data, size_t size, std::FILE *fp, const std::string &path) {
+    if (std::fread(data, 1, size, fp) != size) {
+        std::fclose(fp);
+        throw PsiException("CC snapshot " + path + " is truncated", __FILE__, __LINE__);
+    }
+}
+
+}  // namespace
+
+SnapshotKey snapshot_key(const std::string &solver, int reference, int nirreps, int nocc, int nvir, int state,
+                         double eref) {
+    SnapshotKey key;
+    std::memset(&key, 0, sizeof(SnapshotKey));
+    std::strncpy(key.solver, solver.c_str(), sizeof(key.solver) - 1);
+    key.reference = reference;
+    key.nirreps = nirreps;
+    key.nocc = nocc;
+    key.nvir = nvir;
+    key.state = state;
+    key.eref = eref;
+    return key;
+}
+
+void snapshot_write(const std::string &path, const SnapshotKey &key, int iter, double energy,
+                    const SnapshotEntries &entries) {
+    std::vector<SnapshotRecord> records;
+    for (const auto &entry : entries) {
+        SnapshotRecord record;
+        std::memset(&record, 0, sizeof(SnapshotRecord));
+        record.unit = entry.first;
+        std::strncpy(record.label, entry.second.c_str(), PSIO_KEYLEN - 1);
+        record.size = entry_size(record.unit, record.label);
+        if (record.size) records.push_back(record); /* e.g. no DIIS history yet */
+    }
+
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(SnapshotHeader));
+    std::memcpy(header.magic, snapshot_magic, sizeof(header.magic));
+    header.version = snapshot_version;
+    header.key = key;
+    header.iter = iter;
+    header.energy = energy;
+    header.nentries = records.size();
+
+    std::string tmp = path + ".tmp";
+    std::FILE *fp = std::fopen(tmp.c_str(), "wb");
+    if (fp == nullptr) throw PsiException("Unable to open CC snapshot " + tmp, __FILE__, __LINE__);
+    write_or_throw(&header, sizeof(SnapshotHeader), fp, tmp);
+
+    std::vector<char> buffer;
+    for (const auto &record : records) {
+        write_or_throw(&record, sizeof(SnapshotRecord), fp, tmp);
+        buffer.resize(std::min(record.size, snapshot_chunk));
+        psio_address next = PSIO_ZERO;
+        for (size_t done = 0; done < record.size;) {
+            size_t n = std::min(record.size - done, snapshot_chunk);
+            psio_read(record.unit, record.label, buffer.data(), n, next, &next);
+            write_or_throw(buffer.data(), n, fp, tmp);
+            done += n;
+        }
+    }
+    if (std::fclose(fp)) throw PsiException("Unable to write CC snapshot " + tmp, __FILE__, __LINE__);
+
+    /* Only now replace the previous snapshot */
+    if (std::rename(tmp.c_str(), path.c_str()))
+        throw PsiException("Unable to move CC snapshot into place at " + path, __FILE__, __LINE__);
+}
+
+bool snapshot_read(const std::string &path, const SnapshotKey &key, int *iter, double *energy) {
+    std::FILE *fp = std::fopen(path.c_str(), "rb");
+    if (fp == nullptr) return false;
+
+    SnapshotHeader header;
+    if (std::fread(&header, 1, sizeof(SnapshotHeader), fp) != sizeof(SnapshotHeader) ||
+        std::memcmp(header.magic, snapshot_magic, sizeof(header.magic)) || header.version != snapshot_version) {
+        outfile->Printf("    %s is not a CC snapshot; ignoring it.\n", path.c_str());
+        std::fclose(fp);
+        return false;
+    }
+    if (!same_key(header.key, key)) {
+        outfile->Printf("    Snapshot %s belongs to a different computation; ignoring it.\n", path.c_str());
+        std::fclose(fp);
+        return false;
+    }
+
+    std::vector<char> buffer;
+    for (int i = 0; i < header.nentries; i++) {
+        SnapshotRecord record;
+        read_or_throw(&record, sizeof(SnapshotRecord), fp, path);
+        record.label[PSIO_KEYLEN - 1] = '\0';
+
+        /* Replace whatever the unit holds under this label */
+        psio_tocdel(record.unit, record.label);
+        buffer.resize(std::min(record.size, snapshot_chunk));
+        psio_address next = PSIO_ZERO;
+        for (size_t done = 0; done < record.size;) {
+            size_t n = std::min(record.size - done, snapshot_chunk);
+            read_or_throw(buffer.data(), n, fp, path);
+            psio_write(record.unit, record.label, buffer.data(), n, next, &next);
+            done += n;
+        }
+    }
+    std::fclose(fp);
+
+    outfile->Printf("    Restored %d entries from snapshot %s (iteration %d, energy %20.15f).\n", header.nentries,
+                    path.c_str(), header.iter, header.energy);
+    *iter = header.iter;
+    *energy = header.energy;
+    return true;
+}
+
+void snapshot_remove(const std::string &path) { std::remove(path.c_str()); }
+
+}  // namespace ccenergy
+}  // namespace psi
@@ -0,0 +1,84 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup CCENERGY
+    \brief Restart snapshots of the CC iterations
+*/
+
+#ifndef _psi_src_bin_ccenergy_snapshot_h
+#define _psi_src_bin_ccenergy_snapshot_h
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace psi {
+namespace ccenergy {
+
+/* A snapshot is a verbatim copy of the PSIO entries an iterative CC solver
+** needs to pick up where it left off -- the amplitudes and the DIIS
+** history -- written to an ordinary file outside the scratch directory,
+** together with a header naming the solver, the iteration, and the
+** orbital spaces it belongs to.  The file is written under a temporary
+** name and renamed into place, so a job killed in the middle of a snapshot
+** leaves the previous one intact. */
+
+/* Identifies the computation a snapshot belongs to.  A snapshot is only
+   restored if every field matches. */
+struct SnapshotKey {
+    char solver[32]; /* e.g. "CCENERGY CCSD" */
+    int reference;   /* 0 = RHF, 1 = ROHF, 2 = UHF */
+    int nirreps;
+    int nocc; /* active occupied orbitals, summed over spins for UHF */
+    int nvir; /* active virtual orbitals, summed over spins for UHF */
+    int state;   /* index of the state being solved (cclambda), else 0 */
+    double eref; /* reference energy, to tell geometries apart */
+};
+
+/* (PSIO unit, TOC label) of each entry to include in a snapshot */
+typedef std::vector<std::pair<int, std::string> > SnapshotEntries;
+
+SnapshotKey snapshot_key(const std::string &solver, int reference, int nirreps, int nocc, int nvir, int state,
+                         double eref);
+
+/* Copy the entries (those that exist) to the snapshot file at path,
+   replacing any earlier snapshot there */
+void snapshot_write(const std::string &path, const SnapshotKey &key, int iter, double energy,
+                    const SnapshotEntries &entries);
+
+/* If path holds a snapshot for key, copy its entries back into their PSIO
+   units, return the iteration and energy it was taken at, and return true */
+bool snapshot_read(const std::string &path, const SnapshotKey &key, int *iter, double *energy);
+
+void snapshot_remove(const std::string &path);
+
+}  // namespace ccenergy
+}  // namespace psi
+
+#endif  // _psi_src_bin_ccenergy_snapshot_h
@@ -45,6 +45,13 @@ namespace ccenergy {
 void CCEnergyWavefunction::update() {
     outfile->Printf("  %4d      %20.15f    %4.3e    %7.6f    %7.6f    %7.6f    %7.6f\n", moinfo_.iter, moinfo_.ecc,
                     moinfo_.conv, moinfo_.t1diag, moinfo_.d1diag, moinfo_.new_d1diag, moinfo_.d2diag);
+    emit_event("cc_iteration", {{"iteration", moinfo_.iter},
+                                {"energy", moinfo_.ecc},
+                                {"rms", moinfo_.conv},
+                                {"t1diag", moinfo_.t1diag},
+                                {"d1diag", moinfo_.d1diag},
+                                {"d2diag", moinfo_.d2diag}},
+               {{"wfn", params_.wfn}});
 }
 }  // namespace ccenergy
 }  // namespace psi
@@ -44,6 +44,8 @@ struct Params {
     long int memory;
     int cachelev;
     int cachetype;
+    int dpd_profile;              /* time and count the DPD operations? */
+    std::string dpd_profile_json; /* where to write the counters as JSON, if anywhere */
     int ref;
     int eom_ref;
     int local;
@@ -51,7 +53,7 @@ struct Params {
     int semicanonical;
     int full_matrix; /* include reference rows/cols in diagonalization */
     std::string abcd;
-    int t3_Ws_incore;
+    int t3_Ws_incore; /* 1 in core, 0 on disk, -1 in core if they fit */
     int nthreads;
     int newtrips;
     int overlap;  // check for overlaps between current wfn set and older set stored on disk
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <string>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libqt/qt.h"
@@ -48,50 +49,122 @@ namespace cceom {
 
 void c_clean(dpdfile2 *CME, dpdfile2 *Cme, dpdbuf4 *CMNEF, dpdbuf4 *Cmnef, dpdbuf4 *CMnEf);
 
-/* This function computes the H-bar doubles-doubles block contribution
-   from Wabef to a Sigma vector stored at Sigma plus 'i' */
+/* abcd_batch(): Z_k(ab,ij) = alpha * B(ab,ef) C_k(ij,ef) for a set of
+** trial vectors C_k.  Each bucket of rows of the (totally symmetric) vvvv
+** integrals is read once and multiplied into all of the C_k together,
+** stacked as the columns of a single GEMM, rather than streaming B from
+** disk once per vector.  Falls back to one contract444() per vector if
+** the stacked vectors and their products won't fit in core next to at
+** least one row of B. */
+
+static void abcd_batch(dpdbuf4 *B, std::vector<dpdbuf4> &C, std::vector<dpdbuf4> &Z, double alpha) {
+    int h, k, r, Gij, nab, nef, nij, ncols;
+    int rows_per_bucket, row_start, nrows;
+    int num = C.size();
+    int nirreps = B->params->nirreps;
+    int C_irr = C[0].file.my_irrep;
+    long int core;
+    bool batch = (num > 1);
+    double **Cs, **W;
+
+    for (h = 0; h < nirreps && batch; h++) {
+        nab = B->params->rowtot[h];
+        nef = B->params->coltot[h];
+        nij = C[0].params->rowtot[h ^ C_irr];
+        if (!nab || !nef || !nij) continue;
+        core = (long int)num * nij * (nef + nab);
+        if (dpd_memfree() - core < (long int)nef + (long int)num * nij) batch = false;
+    }
 
-void WabefDD(int i, int C_irr) {
-    dpdfile2 tIA, tia, SIA, Sia;
-    dpdbuf4 SIJAB, Sijab, SIjAb, B;
-    dpdbuf4 CMNEF, Cmnef, CMnEf, X, F, tau, D, WM, WP, Z;
-    char CMNEF_lbl[32], Cmnef_lbl[32], CMnEf_lbl[32];
-    char SIJAB_lbl[32], Sijab_lbl[32], SIjAb_lbl[32], SIA_lbl[32], Sia_lbl[32];
-    char lbl_a[32], lbl_s[32];
-    dpdbuf4 tau_a, tau_s;
-    dpdbuf4 B_a, B_s;
-    dpdbuf4 S, A;
+    if (!batch) {
+        for (k = 0; k < num; k++) global_dpd_->contract444(B, &C[k], &Z[k], 0, 0, alpha, 0.0);
+        return;
+    }
+
+    for (h = 0; h < nirreps; h++) {
+        Gij = h ^ C_irr;
+        nab = B->params->rowtot[h];
+        nef = B->params->coltot[h];
+        nij = C[0].params->rowtot[Gij];
+        ncols = num * nij;
+
+        for (k = 0; k < num; k++) global_dpd_->buf4_mat_irrep_init(&Z[k], h);
+
+        if (nab && nef && nij) {
+            Cs = global_dpd_->dpd_block_matrix(ncols, nef);
+            for (k = 0; k < num; k++) {
+                global_dpd_->buf4_mat_irrep_init(&C[k], Gij);
+                global_dpd_->buf4_mat_irrep_rd(&C[k], Gij);
+                C_DCOPY((size_t)nij * nef, C[k].matrix[Gij][0], 1, Cs[k * nij], 1);
+                global_dpd_->buf4_mat_irrep_close(&C[k], Gij);
+            }
+
+            rows_per_bucket = dpd_memfree() / (nef + ncols);
+            if (rows_per_bucket > nab) rows_per_bucket = nab;
+
+            W = global_dpd_->dpd_block_matrix(rows_per_bucket, ncols);
+            global_dpd_->buf4_mat_irrep_init_block(B, h, rows_per_bucket);
+            for (row_start = 0; row_start < nab; row_start += rows_per_bucket) {
+                nrows = (nab - row_start < rows_per_bucket) ? nab - row_start : rows_per_bucket;
+                global_dpd_->buf4_mat_irrep_rd_block(B, h, row_start, nrows);
+                C_DGEMM('n', 't', nrows, ncols, nef, alpha, B->matrix[h][0], nef, Cs[0], nef, 0.0, W[0], ncols);
+                for (k = 0; k < num; k++)
+                    for (r = 0; r < nrows; r++) C_DCOPY(nij, &W[r][k * nij], 1, Z[k].matrix[h][row_start + r], 1);
+            }
+            global_dpd_->buf4_mat_irrep_close_block(B, h, rows_per_bucket);
+            global_dpd_->free_dpd_block(W, rows_per_bucket, ncols);
+            global_dpd_->free_dpd_block(Cs, ncols, nef);
+        }
+
+        for (k = 0; k < num; k++) {
+            global_dpd_->buf4_mat_irrep_wrt(&Z[k], h);
+            global_dpd_->buf4_mat_irrep_close(&Z[k], h);
+        }
+    }
+}
+
+/* WabefDD_ABCD_RHF(): SIjAb += <Ab|Ef> CIjEf for the RHF trial vectors
+** first, ..., first+num-1.  The vvvv integrals (or their symmetric and
+** antisymmetric combinations for ABCD = NEW) are read once for the
+** whole set; the Davidson driver calls this after the other sigma terms
+** for all of the vectors added in an iteration.  Intermediates on
+** PSIF_EOM_TMP are labeled by position in the set so they are reused
+** from one iteration to the next. */
+
+void WabefDD_ABCD_RHF(int first, int num, int C_irr) {
+    dpdbuf4 B, B_a, B_s, tau, tau_a;
+    std::vector<dpdbuf4> C(num), Z(num);
+    char CMnEf_lbl[32], SIjAb_lbl[32], lbl[32], lbl_a[32], lbl_s[32];
     double **B_diag, **tau_diag;
-    int ij, Gc, C, c, cc;
-    int nbuckets, rows_per_bucket, rows_left, m, row_start, ab, cd, dc, d;
+    int i, k, ij, Gc, c, cc, CC;
+    int nbuckets, rows_per_bucket, rows_left, m, row_start;
     int nrows, ncols, nlinks;
     psio_address next;
 
-    if (params.eom_ref == 0) { /* RHF */
-        /* SIjAb += WAbEf*CIjEf */
-        sprintf(SIjAb_lbl, "%s %d", "SIjAb", i);
-        sprintf(CMnEf_lbl, "%s %d", "CMnEf", i);
+    if (!num) return;
+
+    timer_on("WabefDD Z");
 
-        /* SIjAb += <Ab|Ef> CIjEf -- allow out of core algorithm */
-
-        timer_on("WabefDD Z");
-
-        if (params.abcd == "OLD") {
-            global_dpd_->buf4_init(&CMnEf, PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
-            global_dpd_->buf4_init(&Z, PSIF_EOM_TMP, C_irr, 5, 0, 5, 0, 0, "WabefDD Z(Ab,Ij)");
-            global_dpd_->buf4_init(&B, PSIF_CC_BINTS, H_IRR, 5, 5, 5, 5, 0, "B <ab|cd>");
-            global_dpd_->contract444(&B, &CMnEf, &Z, 0, 0, 1.0, 0.0);
-            global_dpd_->buf4_close(&B);
-            global_dpd_->buf4_close(&CMnEf);
-            global_dpd_->buf4_sort(&Z, PSIF_EOM_TMP, rspq, 0, 5, "WabefDD Z(Ij,Ab)");
-            global_dpd_->buf4_close(&Z);
-
-            global_dpd_->buf4_init(&SIjAb, PSIF_EOM_SIjAb, C_irr, 0, 5, 0, 5, 0, SIjAb_lbl);
-            global_dpd_->buf4_init(&Z, PSIF_EOM_TMP, C_irr, 0, 5, 0, 5, 0, "WabefDD Z(Ij,Ab)");
-            global_dpd_->buf4_axpy(&Z, &SIjAb, 1);
-            global_dpd_->buf4_close(&Z);
-            global_dpd_->buf4_close(&SIjAb);
-        } else if (params.abcd == "NEW") {
+    if (params.abcd == "OLD") {
+        global_dpd_->buf4_init(&B, PSIF_CC_BINTS, H_IRR, 5, 5, 5, 5, 0, "B <ab|cd>");
+        for (k = 0; k < num; k++) {
+            sprintf(CMnEf_lbl, "%s %d", "CMnEf", first + k);
+            sprintf(lbl, "WabefDD Z(Ab,Ij) %d", k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 0, 5, 0, 5, 0, CMnEf_lbl);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 5, 0, 0, lbl);
+        }
+        abcd_batch(&B, C, Z, 1.0);
+        global_dpd_->buf4_close(&B);
+        for (k = 0; k < num; k++) {
+            sprintf(SIjAb_lbl, "%s %d", "SIjAb", first + k);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+    } else if (params.abcd == "NEW") {
+        for (k = 0; k < num; k++) {
+            i = first + k;
+            sprintf(CMnEf_lbl, "%s %d", "CMnEf", i);
             sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", i);
             sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", i);
 
@@ -108,16 +181,27 @@ void WabefDD(int i, int C_irr) {
             global_dpd_->buf4_init(&tau_a, PSIF_EOM_TMP, C_irr, 3, 8, 0, 5, 0, lbl_s);
             global_dpd_->buf4_copy(&tau_a, PSIF_EOM_CMnEf, lbl_s);
             global_dpd_->buf4_close(&tau_a);
+        }
 
-            timer_on("ABCD:S");
-            global_dpd_->buf4_init(&tau_s, PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
-            global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->contract444(&B_s, &tau_s, &S, 0, 0, 0.5, 0);
-            global_dpd_->buf4_close(&S);
-            global_dpd_->buf4_close(&B_s);
-            global_dpd_->buf4_close(&tau_s);
-            timer_off("ABCD:S");
+        timer_on("ABCD:S");
+        global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
+        for (k = 0; k < num; k++) {
+            sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", first + k);
+            sprintf(lbl, "S(ab,ij) %d", k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 3, 8, 3, 8, 0, lbl_s);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, lbl);
+        }
+        abcd_batch(&B_s, C, Z, 0.5);
+        for (k = 0; k < num; k++) {
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+        global_dpd_->buf4_close(&B_s);
+        timer_off("ABCD:S");
+
+        for (k = 0; k < num; k++) {
+            sprintf(lbl_s, "CMnEf(+)(mn,ef) %d", first + k);
+            sprintf(lbl, "S(ab,ij) %d", k);
 
             /* L_diag(ij,c)  = 2 * L(ij,cc)*/
 
@@ -129,17 +213,17 @@ void WabefDD(int i, int C_irr) {
             tau_diag = global_dpd_->dpd_block_matrix(tau.params->rowtot[C_irr], moinfo.nvirt);
             for (ij = 0; ij < tau.params->rowtot[C_irr]; ij++)
                 for (Gc = 0; Gc < moinfo.nirreps; Gc++)
-                    for (C = 0; C < moinfo.virtpi[Gc]; C++) {
-                        c = C + moinfo.vir_off[Gc];
+                    for (CC = 0; CC < moinfo.virtpi[Gc]; CC++) {
+                        c = CC + moinfo.vir_off[Gc];
                         cc = tau.params->colidx[c][c];
                         tau_diag[ij][c] = tau.matrix[C_irr][ij][cc];
                     }
             global_dpd_->buf4_mat_irrep_close(&tau, C_irr);
 
             global_dpd_->buf4_init(&B_s, PSIF_CC_BINTS, 0, 8, 8, 8, 8, 0, "B(+) <ab|cd> + <ab|dc>");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->buf4_mat_irrep_init(&S, 0);
-            global_dpd_->buf4_mat_irrep_rd(&S, 0);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 8, 3, 8, 3, 0, lbl);
+            global_dpd_->buf4_mat_irrep_init(&Z[k], 0);
+            global_dpd_->buf4_mat_irrep_rd(&Z[k], 0);
 
             rows_per_bucket = dpd_memfree() / (B_s.params->coltot[0] + moinfo.nvirt);
             if (rows_per_bucket > B_s.params->rowtot[0]) rows_per_bucket = B_s.params->rowtot[0];
@@ -154,51 +238,85 @@ void WabefDD(int i, int C_irr) {
                 row_start = m * rows_per_bucket;
                 nrows = rows_per_bucket;
                 if (nrows && ncols && nlinks) {
-                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], nrows * nlinks * sizeof(double), next,
-                              &next);
+                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], nrows * nlinks * sizeof(double),
+                              next, &next);
                     C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks, tau_diag[0], nlinks, 1,
-                            S.matrix[0][row_start], ncols);
+                            Z[k].matrix[0][row_start], ncols);
                 }
             }
             if (rows_left) {
                 row_start = m * rows_per_bucket;
                 nrows = rows_left;
                 if (nrows && ncols && nlinks) {
-                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], nrows * nlinks * sizeof(double), next,
-                              &next);
+                    psio_read(PSIF_CC_BINTS, "B(+) <ab|cc>", (char *)B_diag[0], nrows * nlinks * sizeof(double),
+                              next, &next);
                     C_DGEMM('n', 't', nrows, ncols, nlinks, -0.25, B_diag[0], nlinks, tau_diag[0], nlinks, 1,
-                            S.matrix[0][row_start], ncols);
+                            Z[k].matrix[0][row_start], ncols);
                 }
             }
-            global_dpd_->buf4_mat_irrep_wrt(&S, 0);
-            global_dpd_->buf4_mat_irrep_close(&S, 0);
-            global_dpd_->buf4_close(&S);
+            global_dpd_->buf4_mat_irrep_wrt(&Z[k], 0);
+            global_dpd_->buf4_mat_irrep_close(&Z[k], 0);
+            global_dpd_->buf4_close(&Z[k]);
             global_dpd_->buf4_close(&B_s);
             global_dpd_->free_dpd_block(B_diag, rows_per_bucket, moinfo.nvirt);
             global_dpd_->free_dpd_block(tau_diag, tau.params->rowtot[C_irr], moinfo.nvirt);
             global_dpd_->buf4_close(&tau);
+        }
 
-            timer_on("ABCD:A");
-            global_dpd_->buf4_init(&tau_a, PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
-            global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
-            global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, "A(ab,ij)");
-            global_dpd_->contract444(&B_a, &tau_a, &A, 0, 0, 0.5, 0);
-            global_dpd_->buf4_close(&A);
-            global_dpd_->buf4_close(&B_a);
-            global_dpd_->buf4_close(&tau_a);
-            timer_off("ABCD:A");
-
-            timer_on("ABCD:axpy");
-            global_dpd_->buf4_init(&S, PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, "S(ab,ij)");
-            global_dpd_->buf4_sort_axpy(&S, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-            global_dpd_->buf4_close(&S);
-            global_dpd_->buf4_init(&A, PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, "A(ab,ij)");
-            global_dpd_->buf4_sort_axpy(&A, PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
-            global_dpd_->buf4_close(&A);
-            timer_off("ABCD:axpy");
+        timer_on("ABCD:A");
+        global_dpd_->buf4_init(&B_a, PSIF_CC_BINTS, 0, 9, 9, 9, 9, 0, "B(-) <ab|cd> - <ab|dc>");
+        for (k = 0; k < num; k++) {
+            sprintf(lbl_a, "CMnEf(-)(mn,ef) %d", first + k);
+            sprintf(lbl, "A(ab,ij) %d", k);
+            global_dpd_->buf4_init(&C[k], PSIF_EOM_CMnEf, C_irr, 4, 9, 4, 9, 0, lbl_a);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 9, 4, 9, 4, 0, lbl);
+        }
+        abcd_batch(&B_a, C, Z, 0.5);
+        for (k = 0; k < num; k++) {
+            global_dpd_->buf4_close(&Z[k]);
+            global_dpd_->buf4_close(&C[k]);
+        }
+        global_dpd_->buf4_close(&B_a);
+        timer_off("ABCD:A");
+
+        timer_on("ABCD:axpy");
+        for (k = 0; k < num; k++) {
+            sprintf(SIjAb_lbl, "%s %d", "SIjAb", first + k);
+            sprintf(lbl, "S(ab,ij) %d", k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 8, 3, 0, lbl);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
+            sprintf(lbl, "A(ab,ij) %d", k);
+            global_dpd_->buf4_init(&Z[k], PSIF_EOM_TMP, C_irr, 5, 0, 9, 4, 0, lbl);
+            global_dpd_->buf4_sort_axpy(&Z[k], PSIF_EOM_SIjAb, rspq, 0, 5, SIjAb_lbl, 1);
+            global_dpd_->buf4_close(&Z[k]);
         }
+        timer_off("ABCD:axpy");
+    }
+
+    timer_off("WabefDD Z");
+}
+
+/* This function computes the H-bar doubles-doubles block contribution
+   from Wabef to a Sigma vector stored at Sigma plus 'i'.  For RHF the
+   <Ab|Ef> ladder term is skipped unless do_abcd is set; see
+   WabefDD_ABCD_RHF(). */
+
+void WabefDD(int i, int C_irr, bool do_abcd) {
+    dpdfile2 tIA, tia, SIA, Sia;
+    dpdbuf4 SIJAB, Sijab, SIjAb, B;
+    dpdbuf4 CMNEF, Cmnef, CMnEf, X, F, tau, D, WM, WP, Z;
+    char CMNEF_lbl[32], Cmnef_lbl[32], CMnEf_lbl[32];
+    char SIJAB_lbl[32], Sijab_lbl[32], SIjAb_lbl[32], SIA_lbl[32], Sia_lbl[32];
+
+    if (params.eom_ref == 0) { /* RHF */
+        /* SIjAb += WAbEf*CIjEf */
+        sprintf(SIjAb_lbl, "%s %d", "SIjAb", i);
+        sprintf(CMnEf_lbl, "%s %d", "CMnEf", i);
 
-        timer_off("WabefDD Z");
+        /* SIjAb += <Ab|Ef> CIjEf -- done for all new vectors at once by the
+           Davidson driver unless do_abcd is set */
+        if (do_abcd) WabefDD_ABCD_RHF(i, 1, C_irr);
 
         /* construct XIjMb = CIjEf * <mb|ef> */
         global_dpd_->buf4_init(&X, PSIF_EOM_TMP, C_irr, 10, 0, 10, 0, 0, "WabefDD X(Mb,Ij)");
@@ -120,8 +120,19 @@ PsiReturnType cceom(std::shared_ptr<Wavefunction> ref_wfn, Options &options) {
 
     if (params.local) local_init();
 
+    if (params.dpd_profile) {
+        global_dpd_->profile_reset();
+        global_dpd_->profile_enable(true);
+    }
+
     diag();
 
+    if (params.dpd_profile) {
+        global_dpd_->profile_print("outfile");
+        if (!params.dpd_profile_json.empty()) global_dpd_->profile_json(params.dpd_profile_json);
+        global_dpd_->profile_enable(false);
+    }
+
     dpd_close(0);
     if (params.local) local_done();
     cleanup();
@@ -89,7 +89,8 @@ void c_clean(dpdfile2 *CME, dpdfile2 *Cme, dpdbuf4 *CMNEF, dpdbuf4 *Cmnef, dpdbu
 void sigmaSS(int index, int irrep);
 void sigmaSD(int index, int irrep);
 void sigmaDS(int index, int irrep);
-void sigmaDD(int index, int irrep);
+void sigmaDD(int index, int irrep, bool do_abcd);
+void WabefDD_ABCD_RHF(int first, int num, int C_irr);
 void sigma00(int index, int irrep);
 void sigma0S(int index, int irrep);
 void sigma0D(int index, int irrep);
@@ -146,6 +147,7 @@ void diag() {
     double ra, rb, r2aa, r2bb, r2ab, cc3_eval, cc3_last_converged_eval = 0.0, C0, S0, R0;
     int cc3_stage; /* 0=eom_ccsd; 1=eom_cc3 (reuse sigmas), 2=recompute sigma */
     int L_start_iter, L_old;
+    int batch_abcd; /* RHF WabefDD ladder done once per iteration for all new vectors */
     char *keyw;
 
     timer_on("HBAR_EXTRA");
@@ -312,6 +314,7 @@ void diag() {
             numCs = L_start_iter = L;
             num_converged = 0;
 
+            batch_abcd = (params.eom_ref == 0) && (params.wfn != "EOM_CC2");
             for (i = already_sigma; i < L; ++i) {
                 /* Form a zeroed S vector for each C vector
                    SIA and Sia do get overwritten by sigmaSS
@@ -343,7 +346,7 @@ void diag() {
                     sigmaDS(i, C_irr);
                     timer_off("sigmaDS");
                     timer_on("sigmaDD");
-                    sigmaDD(i, C_irr);
+                    sigmaDD(i, C_irr, !batch_abcd);
                     timer_off("sigmaDD");
                     if (((params.wfn == "EOM_CC3") && (cc3_stage > 0)) || eom_params.restart_eom_cc3) {
                         timer_on("cc3_HC1");
@@ -402,6 +405,19 @@ void diag() {
                 }
             }
 
+            /* The RHF <Ab|Ef> ladder is the most expensive sigma term and is
+               bound by reading the vvvv integrals, so it is done for all of
+               the new vectors together in one pass over them */
+            if (batch_abcd) {
+                timer_on("SIGMA ALL");
+                timer_on("sigmaDD");
+                timer_on("WabefDD");
+                WabefDD_ABCD_RHF(already_sigma, L - already_sigma, C_irr);
+                timer_off("WabefDD");
+                timer_off("sigmaDD");
+                timer_off("SIGMA ALL");
+            }
+
             timer_on("BUILD G");
             /* Form G = C'*S matrix */
             G = block_matrix(L, L);
@@ -105,13 +105,16 @@ void get_params(Options &options) {
         params.cachetype = 0;
     if (params.ref == 2) /* No LRU cacheing yet for UHF references */
         params.cachetype = 0;
+    params.dpd_profile = options.get_bool("DPD_PROFILE");
+    params.dpd_profile_json = options.get_str("DPD_PROFILE_JSON");
 
     params.nthreads = Process::environment.get_n_threads();
     if (options["CC_NUM_THREADS"].has_changed()) {
         params.nthreads = options.get_int("CC_NUM_THREADS");
     }
     params.abcd = options.get_str("ABCD");
-    params.t3_Ws_incore = options["T3_WS_INCORE"].to_integer();
+    /* Unless told otherwise, hold the CC3 Ws in core whenever they fit */
+    params.t3_Ws_incore = options["T3_WS_INCORE"].has_changed() ? options["T3_WS_INCORE"].to_integer() : -1;
     params.local = options["LOCAL"].to_integer();
     if (params.local) {
         local.cutoff = options.get_double("LOCAL_CUTOFF");
@@ -140,7 +143,10 @@ void get_params(Options &options) {
     outfile->Printf("\tABCD            =     %s\n", params.abcd.c_str());
     outfile->Printf("\tCache Level     =    %1d\n", params.cachelev);
     outfile->Printf("\tCache Type      =    %4s\n", params.cachetype ? "LOW" : "LRU");
-    if (params.wfn == "EOM_CC3") outfile->Printf("\tT3 Ws incore  =    %4s\n", params.t3_Ws_incore ? "Yes" : "No");
+    outfile->Printf("\tDPD profile     =     %s\n", params.dpd_profile ? "Yes" : "No");
+    if (params.wfn == "EOM_CC3")
+        outfile->Printf("\tT3 Ws incore  =    %4s\n",
+                        params.t3_Ws_incore == -1 ? "Auto" : (params.t3_Ws_incore ? "Yes" : "No"));
     outfile->Printf("\tNum. of threads =     %d\n", params.nthreads);
     outfile->Printf("\tLocal CC        =     %s\n", params.local ? "Yes" : "No");
     if (params.local) {
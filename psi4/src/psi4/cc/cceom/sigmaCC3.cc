@@ -39,6 +39,15 @@
 namespace psi {
 namespace cceom {
 
+/* Use the threaded in-core CC3 driver? Unless T3_WS_INCORE is given, only if
+   everything it holds fits in the memory left */
+static bool cc3_incore(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, dpdbuf4 *Dints, dpdbuf4 *WmAEf,
+                       dpdbuf4 *WMnIe, dpdbuf4 *SIjAb) {
+    if (params.t3_Ws_incore != -1) return params.t3_Ws_incore;
+    return global_dpd_->cc3_sigma_RHF_ic_memory(CIjAb, WAbEi, WMbIj, Dints, WmAEf, WMnIe, SIjAb, moinfo.virtpi,
+                                                params.nthreads) < dpd_memfree();
+}
+
 /* This function computes the extra contributions to sigma_1 and sigma_2
   for EOM_CC3 computations that are not normally present in a EOM_CCSD
   calculation */
@@ -92,7 +101,7 @@ void sigmaCC3(int i, int C_irr, double omega) {
         /* * <S| H    <T| (Uhat C2)c   |0> |T> / (w-wt) -> sigma_1
          * <D| Hhat <T| (Uhat C2)c   |0> |T> / (w-wt) -> sigma_2 */
 
-        if (params.t3_Ws_incore)
+        if (cc3_incore(&CMnEf, &WAbEi, &WMbIj, &Dints, &WmAEf, &WMnIe, &SIjAb))
             global_dpd_->cc3_sigma_RHF_ic(&CMnEf, &WAbEi, &WMbIj, 1, &Dints, &SIA, 1, &FME, &WmAEf, &WMnIe, &SIjAb,
                                           moinfo.occpi, moinfo.occ_off, moinfo.virtpi, moinfo.vir_off, omega, "outfile",
                                           params.nthreads, params.newtrips);
@@ -132,7 +141,7 @@ void sigmaCC3(int i, int C_irr, double omega) {
         /* * <S| H    <T| (Utilde T2)c |0> |T> / (w-wt) -> sigma_1
          * <D| Hhat <T| (Utilde T2)c |0> |T> / (w-wt) -> sigma_2 */
 
-        if (params.t3_Ws_incore)
+        if (cc3_incore(&tIjAb, &WAbEi, &WMbIj, &Dints, &WmAEf, &WMnIe, &SIjAb))
             global_dpd_->cc3_sigma_RHF_ic(&tIjAb, &WAbEi, &WMbIj, 1, &Dints, &SIA, 1, &FME, &WmAEf, &WMnIe, &SIjAb,
                                           moinfo.occpi, moinfo.occ_off, moinfo.virtpi, moinfo.vir_off, omega, "outfile",
                                           params.nthreads, params.newtrips);
@@ -170,7 +179,7 @@ void sigmaCC3(int i, int C_irr, double omega) {
 
         /* <D| H'   <T| (Uhat T2)c   |0> |T> / (-wt) -> sigma_2 */
 
-        if (params.t3_Ws_incore)
+        if (cc3_incore(&tIjAb, &WAbEi, &WMbIj, nullptr, &WmAEf, &WMnIe, &SIjAb))
             global_dpd_->cc3_sigma_RHF_ic(&tIjAb, &WAbEi, &WMbIj, 0, nullptr, nullptr, 1, &FME, &WmAEf, &WMnIe, &SIjAb,
                                           moinfo.occpi, moinfo.occ_off, moinfo.virtpi, moinfo.vir_off, 0.0, "outfile",
                                           params.nthreads, params.newtrips);
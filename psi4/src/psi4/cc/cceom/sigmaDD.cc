@@ -42,15 +42,16 @@ namespace psi {
 namespace cceom {
 
 void FDD(int i, int C_irr);
-void WabefDD(int i, int C_irr);
+void WabefDD(int i, int C_irr, bool do_abcd);
 void WmnijDD(int i, int C_irr);
 void WmbejDD(int i, int C_irr);
 void WmnefDD(int i, int C_irr);
 
 /* This function computes the H-bar doubles-doubles block contribution
-to a Sigma vector stored at Sigma plus 'i' */
+to a Sigma vector stored at Sigma plus 'i'.  If do_abcd is false the RHF
+<Ab|Ef> ladder term is left for the caller to add with WabefDD_ABCD_RHF() */
 
-void sigmaDD(int i, int C_irr) {
+void sigmaDD(int i, int C_irr, bool do_abcd) {
     timer_on("FDD");
     FDD(i, C_irr);
     timer_off("FDD");
@@ -58,7 +59,7 @@ void sigmaDD(int i, int C_irr) {
     WmnijDD(i, C_irr);
     timer_off("WmnijDD");
     timer_on("WabefDD");
-    WabefDD(i, C_irr);
+    WabefDD(i, C_irr, do_abcd);
     timer_off("WabefDD");
     timer_on("WmbejDD");
     WmbejDD(i, C_irr);
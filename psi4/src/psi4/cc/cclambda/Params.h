@@ -41,8 +41,12 @@ struct Params {
     int maxiter;
     double convergence;
     int restart;
+    int checkpoint_interval;     /* iterations between restart snapshots; 0 = none */
+    std::string checkpoint_file; /* where the snapshots go, suffixed with the state */
     long int memory;
     int cachelev;
+    int dpd_profile;              /* time and count the DPD operations? */
+    std::string dpd_profile_json; /* where to write the counters as JSON, if anywhere */
     int aobasis;
     std::string wfn;
     int ref;
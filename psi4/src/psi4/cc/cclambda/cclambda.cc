@@ -55,6 +55,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <string>
 
 namespace psi {
 namespace cclambda {
@@ -104,6 +105,33 @@ PsiReturnType cctriples(std::shared_ptr<Wavefunction> ref_wfn, Options &options)
 namespace psi {
 namespace cclambda {
 
+/* Restart snapshots of the iterations for left-hand state i; see
+   ccenergy/snapshot.h */
+static std::string lambda_snapshot_path(int i) { return params.checkpoint_file + "." + std::to_string(i); }
+
+static ccenergy::SnapshotKey lambda_snapshot_id(int i) {
+    int nocc = 0, nvir = 0;
+    for (int h = 0; h < moinfo.nirreps; h++) {
+        if (params.ref == 2) {
+            nocc += moinfo.aoccpi[h] + moinfo.boccpi[h];
+            nvir += moinfo.avirtpi[h] + moinfo.bvirtpi[h];
+        } else {
+            nocc += moinfo.occpi[h];
+            nvir += moinfo.virtpi[h];
+        }
+    }
+    return ccenergy::snapshot_key("CCLAMBDA " + params.wfn, params.ref, moinfo.nirreps, nocc, nvir, i, moinfo.eref);
+}
+
+static ccenergy::SnapshotEntries lambda_snapshot_entries() {
+    ccenergy::SnapshotEntries entries;
+    const char *labels[] = {"LIA", "Lia", "LIJAB", "Lijab", "LIjAb"};
+    for (const char *label : labels) entries.push_back(std::make_pair(PSIF_CC_LAMBDA, std::string(label)));
+    entries.push_back(std::make_pair(PSIF_CC_DIIS_ERR, std::string("DIIS Error Vectors")));
+    entries.push_back(std::make_pair(PSIF_CC_DIIS_AMP, std::string("DIIS Amplitude Vectors")));
+    return entries;
+}
+
 CCLambdaWavefunction::CCLambdaWavefunction(std::shared_ptr<Wavefunction> reference_wavefunction, Options &options)
     : CCEnergyWavefunction(reference_wavefunction, options) {
     psio_ = _default_psio_lib_;
@@ -192,6 +220,11 @@ double CCLambdaWavefunction::compute_energy() {
 
     if (params.local) local_init();
 
+    if (params.dpd_profile) {
+        global_dpd_->profile_reset();
+        global_dpd_->profile_enable(true);
+    }
+
     if (params.ref == 0) {
         if (params.wfn == "CC2" || params.wfn == "EOM_CC2")
             cc2_hbar_extra();
@@ -227,6 +260,12 @@ double CCLambdaWavefunction::compute_energy() {
         denom(pL_params[i]);     /* uses L_params.cceom_energy for excited states */
         init_amps(pL_params[i]); /* uses denominators for initial zeta guess */
 
+        /* Pick up from the snapshot of an interrupted run, if there is one */
+        int resume_iter = 0;
+        double resume_energy = 0.0;
+        if (params.checkpoint_interval)
+            ccenergy::snapshot_read(lambda_snapshot_path(i), lambda_snapshot_id(i), &resume_iter, &resume_energy);
+
         outfile->Printf("\n\t          Solving Lambda Equations\n");
         outfile->Printf("\t          ------------------------\n");
         outfile->Printf("\tIter     PseudoEnergy or Norm         RMS  \n");
@@ -235,7 +274,7 @@ double CCLambdaWavefunction::compute_energy() {
         moinfo.lcc = pseudoenergy(pL_params[i]);
         update();
 
-        for (moinfo.iter = 1; moinfo.iter <= params.maxiter; moinfo.iter++) {
+        for (moinfo.iter = resume_iter + 1; moinfo.iter <= params.maxiter; moinfo.iter++) {
             sort_amps(pL_params[i].irrep);
 
             /* must zero New L before adding RHS */
@@ -277,6 +316,7 @@ double CCLambdaWavefunction::compute_energy() {
 
                 /* sort_amps(); to be done by later functions */
                 outfile->Printf("\n\tIterations converged.\n");
+                if (params.checkpoint_interval) ccenergy::snapshot_remove(lambda_snapshot_path(i));
 
                 moinfo.iter = 0;
                 break;
@@ -286,6 +326,9 @@ double CCLambdaWavefunction::compute_energy() {
             Lsave(pL_params[i].irrep);
             moinfo.lcc = pseudoenergy(pL_params[i]);
             update();
+            if (params.checkpoint_interval && !(moinfo.iter % params.checkpoint_interval))
+                ccenergy::snapshot_write(lambda_snapshot_path(i), lambda_snapshot_id(i), moinfo.iter, moinfo.lcc,
+                                         lambda_snapshot_entries());
         }
         outfile->Printf("\n");
         if (!done) {
@@ -308,6 +351,12 @@ double CCLambdaWavefunction::compute_energy() {
 
     if (params.local) local_done();
 
+    if (params.dpd_profile) {
+        global_dpd_->profile_print("outfile");
+        if (!params.dpd_profile_json.empty()) global_dpd_->profile_json(params.dpd_profile_json);
+        global_dpd_->profile_enable(false);
+    }
+
     dpd_close(0);
 
     if (params.ref == 2)
@@ -38,6 +38,8 @@
 
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libciomr/libciomr.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/writer_file_prefix.h"
 #include "psi4/psifiles.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/liboptions/liboptions.h"
@@ -83,6 +85,12 @@ void CCLambdaWavefunction::get_params(Options &options) {
     params.convergence = options.get_double("R_CONVERGENCE");
 
     params.restart = options.get_bool("RESTART");
+    params.checkpoint_interval = options.get_int("CHECKPOINT_INTERVAL");
+    params.checkpoint_file = options.get_str("CHECKPOINT_FILE");
+    if (params.checkpoint_file.empty())
+        params.checkpoint_file = get_writer_file_prefix(molecule_->name()) + ".cclambda.snap";
+    params.dpd_profile = options.get_bool("DPD_PROFILE");
+    params.dpd_profile_json = options.get_str("DPD_PROFILE_JSON");
 
     params.memory = Process::environment.get_memory();
 
@@ -423,7 +431,11 @@ void CCLambdaWavefunction::get_params(Options &options) {
     outfile->Printf("\tMaxiter           =   %4d\n", params.maxiter);
     outfile->Printf("\tConvergence       = %3.1e\n", params.convergence);
     outfile->Printf("\tRestart           =     %s\n", params.restart ? "Yes" : "No");
+    if (params.checkpoint_interval)
+        outfile->Printf("\tSnapshots         =     every %d iterations to %s\n", params.checkpoint_interval,
+                        params.checkpoint_file.c_str());
     outfile->Printf("\tCache Level       =     %1d\n", params.cachelev);
+    outfile->Printf("\tDPD profile       =     %s\n", params.dpd_profile ? "Yes" : "No");
     outfile->Printf("\tModel III         =     %s\n", params.sekino ? "Yes" : "No");
     outfile->Printf("\tDIIS              =     %s\n", params.diis ? "Yes" : "No");
     outfile->Printf("\tAO Basis          =     %s\n", params.aobasis ? "Yes" : "No");
@@ -30,10 +30,13 @@
     \ingroup ccresponse
     \brief Enter brief description of file here
 */
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <string>
+#include <vector>
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
@@ -67,75 +70,118 @@ void amp_write(const char *pert, int irrep, double omega);
 
 void analyze(const char *pert, int irrep, double omega);
 
-void compute_X(const char *pert, int irrep, double omega) {
-    int i, iter = 0, done = 0;
+/*
+** compute_X_batch(): Solve the perturbed wave function equations for several
+** (perturbation, irrep, frequency) right-hand sides together. Every iteration
+** updates all perturbations that are not yet converged back to back, so the
+** HBAR and T2 blocks held in the DPD cache are reused across them instead of
+** being re-read for each separate solve. Each perturbation has its own DIIS
+** subspace and convergence test and drops out once it has converged.
+*/
+void compute_X_batch(const std::vector<std::string> &all_perts, const std::vector<int> &all_irreps,
+                     const std::vector<double> &all_omegas) {
+    int i, iter = 0, ntask, nactive;
     double rms, polar, X2_norm;
     char lbl[32];
     dpdbuf4 X2;
 
     timer_on("compute_X");
 
-    outfile->Printf("\n\tComputing %s-Perturbed Wave Function (%5.3f E_h).\n", pert, omega);
-    init_X(pert, irrep, omega);
-    outfile->Printf("\tIter   Pseudopolarizability       RMS \n");
-    outfile->Printf("\t----   --------------------   -----------\n");
+    /* Right-hand sides that share amplitude labels are the same solve */
+    std::vector<std::string> perts, labels;
+    std::vector<int> irreps;
+    std::vector<double> omegas;
+    for (size_t t = 0; t < all_perts.size(); t++) {
+        sprintf(lbl, "X_%s_IA (%5.3f)", all_perts[t].c_str(), all_omegas[t]);
+        if (std::find(labels.begin(), labels.end(), lbl) != labels.end()) continue;
+        labels.push_back(lbl);
+        perts.push_back(all_perts[t]);
+        irreps.push_back(all_irreps[t]);
+        omegas.push_back(all_omegas[t]);
+    }
+
+    ntask = perts.size();
+    std::vector<int> done(ntask, 0);
 
-    if (params.wfn == "CC2")
-        cc2_sort_X(pert, irrep, omega);
-    else
-        sort_X(pert, irrep, omega);
-    polar = -2.0 * pseudopolar(pert, irrep, omega);
-    outfile->Printf("\t%4d   %20.12f\n", iter, polar);
-
-    for (iter = 1; iter <= params.maxiter; iter++) {
-        if (params.wfn == "CC2") {
-            cc2_sort_X(pert, irrep, omega);
-            cc2_X1_build(pert, irrep, omega);
-            cc2_X2_build(pert, irrep, omega);
-        } else {
-            sort_X(pert, irrep, omega);
-            X1_build(pert, irrep, omega);
-            X2_build(pert, irrep, omega);
-        }
-        update_X(pert, irrep, omega);
-        rms = converged(pert, irrep, omega);
-        if (rms <= params.convergence) {
-            done = 1;
+    for (int t = 0; t < ntask; t++) {
+        const char *pert = perts[t].c_str();
+        outfile->Printf("\n\tComputing %s-Perturbed Wave Function (%5.3f E_h).\n", pert, omegas[t]);
+        init_X(pert, irreps[t], omegas[t]);
+    }
+    outfile->Printf("\n\tIter   Perturbation   Omega     Pseudopolarizability       RMS \n");
+    outfile->Printf("\t----   ------------  -------   --------------------   -----------\n");
+
+    for (int t = 0; t < ntask; t++) {
+        const char *pert = perts[t].c_str();
+        if (params.wfn == "CC2")
+            cc2_sort_X(pert, irreps[t], omegas[t]);
+        else
+            sort_X(pert, irreps[t], omegas[t]);
+        polar = -2.0 * pseudopolar(pert, irreps[t], omegas[t]);
+        outfile->Printf("\t%4d   %12s  %7.3f   %20.12f\n", iter, pert, omegas[t], polar);
+    }
+
+    nactive = ntask;
+    for (iter = 1; iter <= params.maxiter && nactive; iter++) {
+        for (int t = 0; t < ntask; t++) {
+            if (done[t]) continue;
+            const char *pert = perts[t].c_str();
+            int irrep = irreps[t];
+            double omega = omegas[t];
+
+            if (params.wfn == "CC2") {
+                cc2_sort_X(pert, irrep, omega);
+                cc2_X1_build(pert, irrep, omega);
+                cc2_X2_build(pert, irrep, omega);
+            } else {
+                sort_X(pert, irrep, omega);
+                X1_build(pert, irrep, omega);
+                X2_build(pert, irrep, omega);
+            }
+            update_X(pert, irrep, omega);
+            rms = converged(pert, irrep, omega);
+            if (rms <= params.convergence) {
+                done[t] = 1;
+                nactive--;
+                save_X(pert, irrep, omega);
+                if (params.wfn == "CC2")
+                    cc2_sort_X(pert, irrep, omega);
+                else
+                    sort_X(pert, irrep, omega);
+                outfile->Printf("\t%4d   %12s  %7.3f   Converged to %4.3e\n", iter, pert, omega, rms);
+                if (params.print & 2) {
+                    sprintf(lbl, "X_%s_IjAb (%5.3f)", pert, omega);
+                    global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 0, 5, 0, 5, 0, lbl);
+                    X2_norm = global_dpd_->buf4_dot_self(&X2);
+                    global_dpd_->buf4_close(&X2);
+                    X2_norm = sqrt(X2_norm);
+                    outfile->Printf("\tNorm of the converged X2 amplitudes %20.15f\n", X2_norm);
+                    amp_write(pert, irrep, omega);
+                }
+                continue;
+            }
+            if (params.diis) diis(iter, pert, irrep, omega);
             save_X(pert, irrep, omega);
             if (params.wfn == "CC2")
                 cc2_sort_X(pert, irrep, omega);
             else
                 sort_X(pert, irrep, omega);
-            outfile->Printf("\t-----------------------------------------\n");
-            outfile->Printf("\tConverged %s-Perturbed Wfn to %4.3e\n", pert, rms);
-            if (params.print & 2) {
-                sprintf(lbl, "X_%s_IjAb (%5.3f)", pert, omega);
-                global_dpd_->buf4_init(&X2, PSIF_CC_LR, irrep, 0, 5, 0, 5, 0, lbl);
-                X2_norm = global_dpd_->buf4_dot_self(&X2);
-                global_dpd_->buf4_close(&X2);
-                X2_norm = sqrt(X2_norm);
-                outfile->Printf("\tNorm of the converged X2 amplitudes %20.15f\n", X2_norm);
-                amp_write(pert, irrep, omega);
-            }
 
-            break;
+            polar = -2.0 * pseudopolar(pert, irrep, omega);
+            outfile->Printf("\t%4d   %12s  %7.3f   %20.12f    %4.3e\n", iter, pert, omega, polar, rms);
         }
-        if (params.diis) diis(iter, pert, irrep, omega);
-        save_X(pert, irrep, omega);
-        if (params.wfn == "CC2")
-            cc2_sort_X(pert, irrep, omega);
-        else
-            sort_X(pert, irrep, omega);
-
-        polar = -2.0 * pseudopolar(pert, irrep, omega);
-        outfile->Printf("\t%4d   %20.12f    %4.3e\n", iter, polar, rms);
     }
-    if (!done) {
+    outfile->Printf("\t-----------------------------------------------------------------\n");
+    if (nactive) {
         dpd_close(0);
         cleanup();
         exit_io();
         throw PsiException("Failed to converge perturbed wavefunction", __FILE__, __LINE__);
     }
+    if (ntask > 1)
+        outfile->Printf("\tConverged %d Perturbed Wfns to %4.3e\n", ntask, params.convergence);
+    else
+        outfile->Printf("\tConverged %s-Perturbed Wfn to %4.3e\n", perts[0].c_str(), params.convergence);
 
     /* Clean up disk space */
     psio_close(PSIF_CC_DIIS_AMP, 0);
@@ -149,7 +195,9 @@ void compute_X(const char *pert, int irrep, double omega) {
         psio_open(i, 0);
     }
 
-    if (params.analyze) analyze(pert, irrep, omega);
+    if (params.analyze) {
+        for (int t = 0; t < ntask; t++) analyze(perts[t].c_str(), irreps[t], omegas[t]);
+    }
 
     /*  print_X(pert, irrep, omega); */
 
@@ -77,7 +77,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
     double **error;
     double **B, *C, **vector;
     double product, determinant, maximum;
-    char lbl[32];
+    char lbl[64];
 
     nirreps = moinfo.nirreps;
 
@@ -135,7 +135,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
         global_dpd_->buf4_close(&T2b);
 
         start = psio_get_address(PSIO_ZERO, diis_cycle * vector_length * sizeof(double));
-        sprintf(lbl, "DIIS %s Error Vectors", pert);
+        sprintf(lbl, "DIIS %s (%5.3f) Error Vectors", pert, omega);
         psio_write(PSIF_CC_DIIS_ERR, lbl, (char *)error[0], vector_length * sizeof(double), start, &end);
 
         /* Store the current amplitude vector on disk */
@@ -163,7 +163,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
         global_dpd_->buf4_close(&T2a);
 
         start = psio_get_address(PSIO_ZERO, diis_cycle * vector_length * sizeof(double));
-        sprintf(lbl, "DIIS %s Amplitude Vectors", pert);
+        sprintf(lbl, "DIIS %s (%5.3f) Amplitude Vectors", pert, omega);
         psio_write(PSIF_CC_DIIS_AMP, lbl, (char *)error[0], vector_length * sizeof(double), start, &end);
 
         /* If we haven't run through enough iterations, set the correct dimensions
@@ -182,7 +182,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
         for (p = 0; p < nvector; p++) {
             start = psio_get_address(PSIO_ZERO, p * vector_length * sizeof(double));
 
-            sprintf(lbl, "DIIS %s Error Vectors", pert);
+            sprintf(lbl, "DIIS %s (%5.3f) Error Vectors", pert, omega);
             psio_read(PSIF_CC_DIIS_ERR, lbl, (char *)vector[0], vector_length * sizeof(double), start, &end);
 
             // dot_arr(vector[0], vector[0], vector_length, &product);
@@ -193,7 +193,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
             for (q = 0; q < p; q++) {
                 start = psio_get_address(PSIO_ZERO, q * vector_length * sizeof(double));
 
-                sprintf(lbl, "DIIS %s Error Vectors", pert);
+                sprintf(lbl, "DIIS %s (%5.3f) Error Vectors", pert, omega);
                 psio_read(PSIF_CC_DIIS_ERR, lbl, (char *)vector[1], vector_length * sizeof(double), start, &end);
 
                 // dot_arr(vector[1], vector[0], vector_length, &product);
@@ -238,7 +238,7 @@ void diis(int iter, const char *pert, int irrep, double omega) {
         for (p = 0; p < nvector; p++) {
             start = psio_get_address(PSIO_ZERO, p * vector_length * sizeof(double));
 
-            sprintf(lbl, "DIIS %s Amplitude Vectors", pert);
+            sprintf(lbl, "DIIS %s (%5.3f) Amplitude Vectors", pert, omega);
             psio_read(PSIF_CC_DIIS_AMP, lbl, (char *)vector[0], vector_length * sizeof(double), start, &end);
 
             for (q = 0; q < vector_length; q++) error[0][q] += C[p] * vector[0][q];
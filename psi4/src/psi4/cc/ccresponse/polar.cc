@@ -35,6 +35,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include "psi4/libpsi4util/process.h"
 #include "psi4/libciomr/libciomr.h"
@@ -52,7 +54,8 @@ namespace psi {
 namespace ccresponse {
 
 void pertbar(const char *pert, int irrep, int anti);
-void compute_X(const char *pert, int irrep, double omega);
+void compute_X_batch(const std::vector<std::string> &perts, const std::vector<int> &irreps,
+                     const std::vector<double> &omegas);
 void linresp(double *tensor, double A, double B, const char *pert_x, int x_irrep, double omega_x, const char *pert_y,
              int y_irrep, double omega_y);
 
@@ -74,16 +77,38 @@ void polar() {
 
     trace = init_array(params.nomega);
 
+    /* Solve for the perturbed wave functions of all missing frequencies together */
+    std::vector<int> todo(params.nomega, 0);
+    std::vector<std::string> perts;
+    std::vector<int> irreps;
+    std::vector<double> omegas;
     for (i = 0; i < params.nomega; i++) {
         sprintf(lbl, "<<Mu;Mu>_(%5.3f)", params.omega[i]);
-        if (!params.restart || !psio_tocscan(PSIF_CC_INFO, lbl)) {
-            for (alpha = 0; alpha < 3; alpha++) {
-                sprintf(pert, "Mu_%1s", cartcomp[alpha]);
-                pertbar(pert, moinfo.mu_irreps[alpha], 0);
-                compute_X(pert, moinfo.mu_irreps[alpha], params.omega[i]);
-                if (params.omega[i] != 0.0) compute_X(pert, moinfo.mu_irreps[alpha], -params.omega[i]);
+        if (params.restart && psio_tocscan(PSIF_CC_INFO, lbl)) continue;
+        todo[i] = 1;
+        for (alpha = 0; alpha < 3; alpha++) {
+            sprintf(pert, "Mu_%1s", cartcomp[alpha]);
+            perts.push_back(pert);
+            irreps.push_back(moinfo.mu_irreps[alpha]);
+            omegas.push_back(params.omega[i]);
+            if (params.omega[i] != 0.0) {
+                perts.push_back(pert);
+                irreps.push_back(moinfo.mu_irreps[alpha]);
+                omegas.push_back(-params.omega[i]);
             }
+        }
+    }
+    if (!perts.empty()) {
+        for (alpha = 0; alpha < 3; alpha++) {
+            sprintf(pert, "Mu_%1s", cartcomp[alpha]);
+            pertbar(pert, moinfo.mu_irreps[alpha], 0);
+        }
+        compute_X_batch(perts, irreps, omegas);
+    }
 
+    for (i = 0; i < params.nomega; i++) {
+        sprintf(lbl, "<<Mu;Mu>_(%5.3f)", params.omega[i]);
+        if (todo[i]) {
             outfile->Printf("\n\tComputing %s tensor.\n", lbl);
             for (alpha = 0; alpha < 3; alpha++) {
                 for (beta = 0; beta < 3; beta++) {
@@ -95,9 +120,6 @@ void polar() {
             }
 
             psio_write_entry(PSIF_CC_INFO, lbl, (char *)tensor[i][0], 9 * sizeof(double));
-
-            psio_close(PSIF_CC_LR, 0);
-            psio_open(PSIF_CC_LR, 0);
         } else {
             outfile->Printf("Using %s tensor found on disk.\n", lbl);
             psio_read_entry(PSIF_CC_INFO, lbl, (char *)tensor[i], 9 * sizeof(double));
@@ -150,6 +172,11 @@ void polar() {
         }
     }
 
+    if (!perts.empty()) {
+        psio_close(PSIF_CC_LR, 0);
+        psio_open(PSIF_CC_LR, 0);
+    }
+
     if (params.nomega > 1) { /* print a summary table for multi-wavelength calcs */
 
         outfile->Printf("\n\t-------------------------------\n");
@@ -29,9 +29,12 @@
 /*! \file \ingroup CCTRIPLES
     \brief Enter brief description of file here
 */
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
+#include <vector>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -53,6 +56,18 @@
 namespace psi {
 namespace cctriples {
 
+/* Scratch owned by one thread for the whole (T) computation: the W0,
+** W1 (reused for V), X, Y and Z abc-blocks, and one row block of F
+** <id|bc>.  The storage is sized for the largest irrep of ijk and laid
+** out afresh for each one by ET_RHF_scratch_layout(). */
+struct thread_scratch {
+    double **store[5];
+    std::vector<double *> rows[5];
+    std::vector<double **> blocks[5];
+    double **F_store;
+    std::vector<double *> F_rows;
+};
+
 struct thread_data {
     dpdfile2 *fIJ;
     dpdfile2 *fAB;
@@ -62,6 +77,7 @@ struct thread_data {
     dpdbuf4 *Eints;
     dpdbuf4 *Dints;
     dpdbuf4 *Fints_local;
+    thread_scratch *scratch;
     double *ET_local;
     int Gi;
     int Gj;
@@ -70,16 +86,25 @@ struct thread_data {
     int last_ijk;
 };
 
+/* A contiguous range of ijk within one (Gi,Gj,Gk) block */
+struct ijk_task {
+    int Gi;
+    int Gj;
+    int Gk;
+    int first_ijk;
+    int last_ijk;
+    double cost;
+};
+
 void ET_RHF_thread(thread_data *);
 
 double ET_RHF() {
-    int i, j, k, I, J, K, Gi, Gj, Gk, h, nirreps, cnt;
-    int nijk, nthreads, thread, *ijk_part;
+    int i, j, k, I, J, K, Gi, Gj, Gk, h, nirreps;
+    int nijk, nthreads, thread;
     int *occpi, *virtpi, *occ_off, *vir_off;
-    double ET, *ET_array;
+    double ET;
     dpdfile2 fIJ, fAB, fIA, T1;
     dpdbuf4 T2, Eints, Dints, *Fints_array;
-    FILE *ijkfile;
 
     timer_on("ET_RHF");
 
@@ -91,12 +116,20 @@ double ET_RHF() {
 
     nthreads = params.nthreads;
 
-    long int mem_avail = dpd_memfree();
-    // Find the size of 4 abc-blocks of the largest irrep
-    long int max_a = 0;
+    global_dpd_->buf4_init(&T2, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tIjAb");
+
+    /* Number of abc for each irrep of ijk, and the largest F <id|bc> block */
+    std::vector<long int> nabc(nirreps, 0);
+    long int max_F = 0;
     for (h = 0; h < nirreps; ++h)
-        if (virtpi[h] > max_a) max_a = virtpi[h];
-    long int thread_mem_estimate = 4 * max_a * max_a * max_a;
+        for (int Gab = 0; Gab < nirreps; Gab++) {
+            nabc[h] += (long)T2.params->coltot[Gab] * virtpi[Gab ^ h];
+            max_F = std::max(max_F, (long)virtpi[Gab ^ h] * T2.params->coltot[Gab]);
+        }
+    long int max_abc = *std::max_element(nabc.begin(), nabc.end());
+
+    long int mem_avail = dpd_memfree();
+    long int thread_mem_estimate = 5 * max_abc + max_F;
 
     outfile->Printf("    Memory available in words        : %15ld\n", mem_avail);
     outfile->Printf("    ~Words needed per explicit thread: %15ld\n", thread_mem_estimate);
@@ -122,8 +155,6 @@ double ET_RHF() {
     outfile->Printf("    MKL num_threads set to 1 for explicit threading.\n\n");
 #endif
 
-    std::vector<thread_data> thread_data_array(nthreads);
-
     global_dpd_->file2_init(&fIJ, PSIF_CC_OEI, 0, 0, 0, "fIJ");
     global_dpd_->file2_init(&fAB, PSIF_CC_OEI, 0, 1, 1, "fAB");
     global_dpd_->file2_init(&fIA, PSIF_CC_OEI, 0, 0, 1, "fIA");
@@ -138,7 +169,6 @@ double ET_RHF() {
     global_dpd_->file2_mat_init(&T1);
     global_dpd_->file2_mat_rd(&T1);
 
-    global_dpd_->buf4_init(&T2, PSIF_CC_TAMPS, 0, 0, 5, 0, 5, 0, "tIjAb");
     global_dpd_->buf4_init(&Eints, PSIF_CC_EINTS, 0, 0, 10, 0, 10, 0, "E <ij|ka>");
     global_dpd_->buf4_init(&Dints, PSIF_CC_DINTS, 0, 0, 5, 0, 5, 0, "D <ij|ab>");
     for (h = 0; h < nirreps; h++) {
@@ -153,101 +183,106 @@ double ET_RHF() {
     }
     auto mode = std::ostream::trunc;
     auto printer = std::make_shared<PsiOutStream>("ijk.dat", mode);
-    // ffile(&ijkfile,"ijk.dat", 0);
 
     /* each thread gets its own F buffer to assign memory and read blocks
-       into and its own energy double - all else shared */
+       into and its own scratch blocks - all else shared.  The scratch is
+       allocated here, on one thread, so the DPD memory count stays exact. */
     Fints_array = (dpdbuf4 *)malloc(nthreads * sizeof(dpdbuf4));
     for (thread = 0; thread < nthreads; ++thread)
         global_dpd_->buf4_init(&(Fints_array[thread]), PSIF_CC_FINTS, 0, 10, 5, 10, 5, 0, "F <ia|bc>");
-    ET_array = (double *)malloc(nthreads * sizeof(double));
-    ijk_part = new int[nthreads];
 
+    long int nrows_abc = 0;
+    for (int Gab = 0; Gab < nirreps; Gab++) nrows_abc += T2.params->coltot[Gab];
+    int max_v = *std::max_element(virtpi, virtpi + nirreps);
+
+    std::vector<thread_scratch> scratch(nthreads);
     for (thread = 0; thread < nthreads; ++thread) {
-        thread_data_array[thread].fIJ = &fIJ;
-        thread_data_array[thread].fAB = &fAB;
-        thread_data_array[thread].fIA = &fIA;
-        thread_data_array[thread].T1 = &T1;
-        thread_data_array[thread].T2 = &T2;
-        thread_data_array[thread].Eints = &Eints;
-        thread_data_array[thread].Dints = &Dints;
-        thread_data_array[thread].Fints_local = &(Fints_array[thread]);
-        thread_data_array[thread].ET_local = &(ET_array[thread]);
+        for (int n = 0; n < 5; n++) {
+            scratch[thread].store[n] = global_dpd_->dpd_block_matrix(1, max_abc);
+            scratch[thread].rows[n].resize(nrows_abc);
+            scratch[thread].blocks[n].resize(nirreps);
+        }
+        scratch[thread].F_store = global_dpd_->dpd_block_matrix(1, max_F);
+        scratch[thread].F_rows.resize(max_v);
     }
 
-    /* Compute total number of IJK combinations */
+    thread_data ref_data;
+    ref_data.fIJ = &fIJ;
+    ref_data.fAB = &fAB;
+    ref_data.fIA = &fIA;
+    ref_data.T1 = &T1;
+    ref_data.T2 = &T2;
+    ref_data.Eints = &Eints;
+    ref_data.Dints = &Dints;
+
+    /* Split every (Gi,Gj,Gk) block into ranges of ijk, each costed by the
+       number of abc it sweeps, so the threads draw from a single queue
+       and never wait for one another between irreps */
     nijk = 0;
+    std::vector<int> block_nijk(nirreps * nirreps * nirreps, 0);
     for (Gi = 0; Gi < nirreps; Gi++)
         for (Gj = 0; Gj < nirreps; Gj++)
-            for (Gk = 0; Gk < nirreps; Gk++)
+            for (Gk = 0; Gk < nirreps; Gk++) {
+                int n = 0;
                 for (i = 0; i < occpi[Gi]; i++) {
                     I = occ_off[Gi] + i;
                     for (j = 0; j < occpi[Gj]; j++) {
                         J = occ_off[Gj] + j;
                         for (k = 0; k < occpi[Gk]; k++) {
                             K = occ_off[Gk] + k;
-                            if (I >= J && J >= K) nijk++;
+                            if (I >= J && J >= K) n++;
                         }
                     }
                 }
+                block_nijk[(Gi * nirreps + Gj) * nirreps + Gk] = n;
+                nijk += n;
+            }
     printer->Printf("Total number of IJK combinations =: %d\n", nijk);
 
-    ET = 0.0;
-    for (Gi = 0; Gi < nirreps; Gi++) {
-        for (Gj = 0; Gj < nirreps; Gj++) {
+    int task_size = std::max(1, nijk / (8 * nthreads));
+    std::vector<ijk_task> tasks;
+    for (Gi = 0; Gi < nirreps; Gi++)
+        for (Gj = 0; Gj < nirreps; Gj++)
             for (Gk = 0; Gk < nirreps; Gk++) {
-                nijk = 0;  // total number of ijk for these irreps
-                for (i = 0; i < occpi[Gi]; i++) {
-                    I = occ_off[Gi] + i;
-                    for (j = 0; j < occpi[Gj]; j++) {
-                        J = occ_off[Gj] + j;
-                        for (k = 0; k < occpi[Gk]; k++) {
-                            K = occ_off[Gk] + k;
-                            if (I >= J && J >= K) nijk++;
-                        }
-                    }
-                }
-                printer->Printf("Num. of IJK with (Gi,Gj,Gk)=(%d,%d,%d) =: %d\n", Gi, Gj, Gk, nijk);
-                if (nijk == 0) continue;
-
-                for (thread = 0; thread < nthreads; ++thread) {
-                    thread_data_array[thread].Gi = Gi;
-                    thread_data_array[thread].Gj = Gj;
-                    thread_data_array[thread].Gk = Gk;
-                    ET_array[thread] = 0.0;
-                    ijk_part[thread] = nijk / nthreads;  // number of ijk for each thread
-                    if (thread < (nijk % nthreads)) ++ijk_part[thread];
+                int n = block_nijk[(Gi * nirreps + Gj) * nirreps + Gk];
+                printer->Printf("Num. of IJK with (Gi,Gj,Gk)=(%d,%d,%d) =: %d\n", Gi, Gj, Gk, n);
+                for (int first = 0; first < n; first += task_size) {
+                    int last = std::min(n, first + task_size) - 1;
+                    tasks.push_back({Gi, Gj, Gk, first, last, (double)(last - first + 1) * nabc[Gi ^ Gj ^ Gk]});
                 }
+            }
+    std::stable_sort(tasks.begin(), tasks.end(), [](const ijk_task &a, const ijk_task &b) { return a.cost > b.cost; });
+    printer->Printf("Number of IJK tasks =: %zu\n", tasks.size());
 
-                cnt = 0;
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (!ijk_part[thread]) continue;  // there are more threads than nijk
-                    thread_data_array[thread].first_ijk = cnt;
-                    cnt += ijk_part[thread];
-                    thread_data_array[thread].last_ijk = cnt - 1;
-                }
-
-                /* execute threads */
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (!ijk_part[thread]) continue;
-                    printer->Printf("    thread %d: first_ijk=%d,  last_ijk=%d\n", thread,
-                                    thread_data_array[thread].first_ijk, thread_data_array[thread].last_ijk);
-                }
+    /* Each task's energy is kept apart and summed in a fixed order, so the
+       result does not depend on which thread ran what */
+    std::vector<double> ET_task(tasks.size(), 0.0);
 
-#pragma omp parallel num_threads(nthreads)
-                {
-                    int ithread = 0;
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+    for (size_t t = 0; t < tasks.size(); t++) {
+        int ithread = 0;
 #ifdef _OPENMP
-                    ithread = omp_get_thread_num();
+        ithread = omp_get_thread_num();
 #endif
-                    if (ijk_part[ithread]) ET_RHF_thread(&thread_data_array[ithread]);
-                }
+        thread_data data = ref_data;
+        data.Fints_local = &(Fints_array[ithread]);
+        data.scratch = &(scratch[ithread]);
+        data.ET_local = &(ET_task[t]);
+        data.Gi = tasks[t].Gi;
+        data.Gj = tasks[t].Gj;
+        data.Gk = tasks[t].Gk;
+        data.first_ijk = tasks[t].first_ijk;
+        data.last_ijk = tasks[t].last_ijk;
+        ET_RHF_thread(&data);
+    }
 
-                for (thread = 0; thread < nthreads; ++thread) ET += ET_array[thread];
+    ET = 0.0;
+    for (size_t t = 0; t < tasks.size(); t++) ET += ET_task[t];
 
-            } /* Gk */
-        }     /* Gj */
-    }         /* Gi */
+    for (thread = 0; thread < nthreads; ++thread) {
+        for (int n = 0; n < 5; n++) global_dpd_->free_dpd_block(scratch[thread].store[n], 1, max_abc);
+        global_dpd_->free_dpd_block(scratch[thread].F_store, 1, max_F);
+    }
 
     for (h = 0; h < nirreps; h++) {
         global_dpd_->buf4_mat_irrep_close(&T2, h);
@@ -271,8 +306,6 @@ double ET_RHF() {
     for (thread = 0; thread < nthreads; ++thread) global_dpd_->buf4_close(&(Fints_array[thread]));
 
     free(Fints_array);
-    free(ET_array);
-    delete[] ijk_part;
 
     timer_off("ET_RHF");
 
@@ -283,6 +316,33 @@ double ET_RHF() {
     return ET;
 }
 
+/* ET_RHF_scratch_layout(): Points the row and irrep tables of scratch
+** block n at its storage, laid out as an abc-block of irrep Gijk.
+*/
+double ***ET_RHF_scratch_layout(thread_scratch *scratch, int n, int Gijk, dpdbuf4 *Fints) {
+    int nirreps = moinfo.nirreps;
+    int *virtpi = moinfo.virtpi;
+    double *next = scratch->store[n] ? scratch->store[n][0] : nullptr;
+    size_t row = 0;
+    for (int Gab = 0; Gab < nirreps; Gab++) {
+        int Gc = Gab ^ Gijk;
+        scratch->blocks[n][Gab] = &(scratch->rows[n][row]);
+        for (int ab = 0; ab < Fints->params->coltot[Gab]; ab++, row++, next += virtpi[Gc])
+            scratch->rows[n][row] = next;
+        if (!Fints->params->coltot[Gab] || !virtpi[Gc]) scratch->blocks[n][Gab] = nullptr;
+    }
+    return scratch->blocks[n].data();
+}
+
+/* ET_RHF_F_block(): Lays out the thread's F scratch as a nrows x ncols
+** block for buf4_mat_irrep_rd_block().
+*/
+double **ET_RHF_F_block(thread_scratch *scratch, int nrows, int ncols) {
+    if (!nrows || !ncols) return nullptr;
+    for (int r = 0; r < nrows; r++) scratch->F_rows[r] = &(scratch->F_store[0][(size_t)r * ncols]);
+    return scratch->F_rows.data();
+}
+
 void ET_RHF_thread(thread_data *data) {
     int h, nirreps, cnt_ijk;
     int Gp, p, nump;
@@ -327,18 +387,21 @@ void ET_RHF_thread(thread_data *data) {
     first_ijk = data->first_ijk;
     last_ijk = data->last_ijk;
 
-    W0 = (double ***)malloc(nirreps * sizeof(double **));
-    W1 = (double ***)malloc(nirreps * sizeof(double **));
-    V = (double ***)malloc(nirreps * sizeof(double **));
-    X = (double ***)malloc(nirreps * sizeof(double **));
-    Y = (double ***)malloc(nirreps * sizeof(double **));
-    Z = (double ***)malloc(nirreps * sizeof(double **));
-
     Gkj = Gjk = Gk ^ Gj;
     Gji = Gij = Gi ^ Gj;
     Gik = Gki = Gi ^ Gk;
     Gijk = Gi ^ Gj ^ Gk;
 
+    /* W1 is dead once it has been sorted into W0, so V takes its place */
+    thread_scratch *scratch = data->scratch;
+    W0 = ET_RHF_scratch_layout(scratch, 0, Gijk, Fints);
+    W1 = V = ET_RHF_scratch_layout(scratch, 1, Gijk, Fints);
+    X = ET_RHF_scratch_layout(scratch, 2, Gijk, Fints);
+    Y = ET_RHF_scratch_layout(scratch, 3, Gijk, Fints);
+    Z = ET_RHF_scratch_layout(scratch, 4, Gijk, Fints);
+    size_t nabc = 0;
+    for (Gab = 0; Gab < nirreps; Gab++) nabc += (size_t)Fints->params->coltot[Gab] * virtpi[Gab ^ Gijk];
+
     cnt_ijk = -1;
     for (i = 0; i < occpi[Gi]; i++) {
         I = occ_off[Gi] + i;
@@ -363,16 +426,11 @@ void ET_RHF_thread(thread_data *data) {
                     if (fIJ->params->rowtot[Gj]) dijk += fIJ->matrix[Gj][j][j];
                     if (fIJ->params->rowtot[Gk]) dijk += fIJ->matrix[Gk][k][k];
 
-                    /* Malloc space for the W intermediate */
-
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-
-                        W0[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        W1[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
+                    /* Clear the W intermediates */
+                    if (nabc) {
+                        ::memset(scratch->store[0][0], 0, nabc * sizeof(double));
+                        ::memset(scratch->store[1][0], 0, nabc * sizeof(double));
                     }
-                    // timer_off("malloc");
 
                     // timer_on("N7 Terms");
 
@@ -382,7 +440,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gc = Gkj ^ Gd;
 
                         /* Set up F integrals */
-                        Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
+                        Fints->matrix[Gid] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gid]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
 
@@ -397,8 +455,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gid][0][0]), nrows,
                                     &(T2->matrix[Gkj][kj][cd]), nlinks, 0.0, &(W0[Gab][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                     }
 
                     /* -E_jklc * t_ilab */
@@ -432,7 +488,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gac = Gid = Gi ^ Gd;
                         Gb = Gjk ^ Gd;
 
-                        Fints->matrix[Gid] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gid]);
+                        Fints->matrix[Gid] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gid]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gid, Fints->row_offset[Gid][I], virtpi[Gd]);
 
@@ -445,8 +501,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gid][0][0]), nrows,
                                     &(T2->matrix[Gjk][jk][bd]), nlinks, 1.0, &(W1[Gac][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gid], virtpi[Gd], Fints->params->coltot[Gid]);
                     }
 
                     /* -E_kjlb * t_ilac */
@@ -477,7 +531,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gca = Gkd = Gk ^ Gd;
                         Gb = Gji ^ Gd;
 
-                        Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
+                        Fints->matrix[Gkd] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gkd]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
 
@@ -490,8 +544,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gkd][0][0]), nrows,
                                     &(T2->matrix[Gji][ji][bd]), nlinks, 1.0, &(W0[Gca][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                     }
 
                     /* -E_ijlb * t_klca */
@@ -522,7 +574,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gcb = Gkd = Gk ^ Gd;
                         Ga = Gij ^ Gd;
 
-                        Fints->matrix[Gkd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gkd]);
+                        Fints->matrix[Gkd] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gkd]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gkd, Fints->row_offset[Gkd][K], virtpi[Gd]);
 
@@ -535,8 +587,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gkd][0][0]), nrows,
                                     &(T2->matrix[Gij][ij][ad]), nlinks, 1.0, &(W1[Gcb][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gkd], virtpi[Gd], Fints->params->coltot[Gkd]);
                     }
 
                     /* -E_jila * t_klcb */
@@ -567,7 +617,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gbc = Gjd = Gj ^ Gd;
                         Ga = Gik ^ Gd;
 
-                        Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
+                        Fints->matrix[Gjd] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gjd]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
 
@@ -580,8 +630,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gjd][0][0]), nrows,
                                     &(T2->matrix[Gik][ik][ad]), nlinks, 1.0, &(W0[Gbc][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                     }
 
                     /* -E_kila * t_jlbc */
@@ -612,7 +660,7 @@ void ET_RHF_thread(thread_data *data) {
                         Gba = Gjd = Gj ^ Gd;
                         Gc = Gki ^ Gd;
 
-                        Fints->matrix[Gjd] = global_dpd_->dpd_block_matrix(virtpi[Gd], Fints->params->coltot[Gjd]);
+                        Fints->matrix[Gjd] = ET_RHF_F_block(scratch, virtpi[Gd], Fints->params->coltot[Gjd]);
 #pragma omp critical
                         global_dpd_->buf4_mat_irrep_rd_block(Fints, Gjd, Fints->row_offset[Gjd][J], virtpi[Gd]);
 
@@ -625,8 +673,6 @@ void ET_RHF_thread(thread_data *data) {
                         if (nrows && ncols && nlinks)
                             C_DGEMM('t', 't', nrows, ncols, nlinks, 1.0, &(Fints->matrix[Gjd][0][0]), nrows,
                                     &(T2->matrix[Gki][ki][cd]), nlinks, 1.0, &(W1[Gba][0][0]), ncols);
-
-                        global_dpd_->free_dpd_block(Fints->matrix[Gjd], virtpi[Gd], Fints->params->coltot[Gjd]);
                     }
 
                     /* -E_iklc * t_jlba */
@@ -654,15 +700,6 @@ void ET_RHF_thread(thread_data *data) {
 
                     // timer_off("N7 Terms");
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-                        global_dpd_->free_dpd_block(W1[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-
-                        V[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
-
                     /* Copy W intermediate into V */
                     for (Gab = 0; Gab < nirreps; Gab++) {
                         Gc = Gab ^ Gijk;
@@ -756,16 +793,6 @@ void ET_RHF_thread(thread_data *data) {
 
                     // timer_off("EST Terms");
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-
-                        X[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        Y[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                        Z[Gab] = global_dpd_->dpd_block_matrix(Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
-
                     // timer_on("XYZ");
                     /* Build X, Y, and Z intermediates */
 
@@ -807,14 +834,6 @@ void ET_RHF_thread(thread_data *data) {
                     }
                     // timer_off("XYZ");
 
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-
-                        global_dpd_->free_dpd_block(V[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
-
                     // timer_on("Energy");
                     for (Gab = 0; Gab < nirreps; Gab++) {
                         Gc = Gab ^ Gijk;
@@ -862,18 +881,6 @@ void ET_RHF_thread(thread_data *data) {
                         }
                     }
                     // timer_off("Energy");
-
-                    /* Free the W and V intermediates */
-                    // timer_on("malloc");
-                    for (Gab = 0; Gab < nirreps; Gab++) {
-                        Gc = Gab ^ Gijk;
-
-                        global_dpd_->free_dpd_block(W0[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(X[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(Y[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                        global_dpd_->free_dpd_block(Z[Gab], Fints->params->coltot[Gab], virtpi[Gc]);
-                    }
-                    // timer_off("malloc");
                 }
             } /* k */
         }     /* j */
@@ -37,6 +37,7 @@
 #include "ccenergy/MOInfo.h"
 #include "ccenergy/Params.h"
 #include "ccenergy/Local.h"
+#include "ccenergy/snapshot.h"
 
 namespace psi {
 class Options;
@@ -76,6 +77,9 @@ class CCEnergyWavefunction : public Wavefunction {
     void spinad_amps();
     void amp_write();
     void checkpoint();
+    SnapshotKey snapshot_id();
+    SnapshotEntries snapshot_entries();
+    void dpd_profile_report();
 
     /* intermediates */
     void update();
@@ -170,6 +174,7 @@ class CCEnergyWavefunction : public Wavefunction {
     void local_filter_T1(dpdfile2 *T1);
     void local_filter_T2(dpdbuf4 *T2);
     void local_init();
+    void local_pno_init();
     void local_done();
 
     /* AO basis */
@@ -178,6 +183,7 @@ class CCEnergyWavefunction : public Wavefunction {
                    int **mo_row, int **so_row, int *mospi_left, int *mospi_right, int *sospi, int type, double alpha,
                    double beta);
     int AO_contribute(struct iwlbuf *InBuf, dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO);
+    size_t AO_contribute_direct(dpdbuf4 *tau1_AO, dpdbuf4 *tau2_AO, double tolerance);
 
     double rhf_energy();
     double uhf_energy();
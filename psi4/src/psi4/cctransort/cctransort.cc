@@ -178,6 +178,43 @@ PsiReturnType cctransort(SharedWavefunction ref, Options &options) {
     int nuocc = uoccpi.sum();
     int nactive = nclsd + nopen + nuocc;
 
+    // Everything the sorted integrals depend on, led by its own length
+    vector<double> signature = {0.0, (double)reference, (double)nirreps, (double)nmo,
+                                (double)(options.get_str("AO_BASIS") == "NONE"), escf, enuc};
+    for (int h = 0; h < nirreps; h++) {
+        signature.push_back(nsopi[h]);
+        signature.push_back(frzcpi[h]);
+        signature.push_back(frzvpi[h]);
+        signature.push_back(clsdpi[h]);
+        signature.push_back(openpi[h]);
+    }
+    signature[0] = signature.size();
+
+    // A complete sort for the same reference may still be on disk, e.g. when
+    // the CC codes are resumed from restart snapshots
+    psio->open(PSIF_CC_INFO, PSIO_OPEN_OLD);
+    bool same_sort = false;
+    if (options.get_bool("REUSE_SORTED_INTS") && psio->tocentry_exists(PSIF_CC_INFO, "Sort Signature")) {
+        double length;
+        psio_address next;
+        psio->read(PSIF_CC_INFO, "Sort Signature", (char *)&length, sizeof(double), PSIO_ZERO, &next);
+        if (length == signature[0]) {
+            vector<double> old(signature.size());
+            psio->read_entry(PSIF_CC_INFO, "Sort Signature", (char *)old.data(), sizeof(double) * old.size());
+            same_sort = true;
+            for (size_t i = 0; i < old.size(); i++)
+                if (std::fabs(old[i] - signature[i]) > 1.0e-10) same_sort = false;
+        }
+    }
+    // Until this sort completes, the files hold no valid one
+    if (!same_sort) psio->tocdel(PSIF_CC_INFO, "Sort Signature");
+    psio->close(PSIF_CC_INFO, 1);
+    if (same_sort) {
+        outfile->Printf("\tReusing the integrals already sorted for this reference.\n");
+        tstop();
+        return Success;
+    }
+
     psio->open(PSIF_CC_INFO, PSIO_OPEN_OLD);
 
     psio->write_entry(PSIF_CC_INFO, "Reference Wavefunction", (char *)&(reference), sizeof(int));
@@ -423,37 +460,19 @@ PsiReturnType cctransort(SharedWavefunction ref, Options &options) {
     }
     */
 
-    outfile->Printf("\t(OO|OO)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::occ, MOSpace::occ, MOSpace::occ,
-                        IntegralTransform::HalfTrans::MakeAndKeep);
-    outfile->Printf("\t(OO|OV)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::occ, MOSpace::occ, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndKeep);
-    outfile->Printf("\t(OO|VV)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::occ, MOSpace::vir, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndNuke);
-
-    outfile->Printf("\t(OV|OO)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::occ,
-                        IntegralTransform::HalfTrans::MakeAndKeep);
-    outfile->Printf("\t(OV|OV)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndKeep);
-    outfile->Printf("\t(OV|VV)...\n");
-    ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::vir, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndNuke);
+    // Each bra's three kets come from one sweep over its half-transformed integrals
+    const SpacePairVec kets = {{MOSpace::occ, MOSpace::occ}, {MOSpace::occ, MOSpace::vir}, {MOSpace::vir, MOSpace::vir}};
+
+    outfile->Printf("\t(OO|OO), (OO|OV), (OO|VV)...\n");
+    ints->transform_tei(MOSpace::occ, MOSpace::occ, kets, IntegralTransform::HalfTrans::MakeAndNuke);
+
+    outfile->Printf("\t(OV|OO), (OV|OV), (OV|VV)...\n");
+    ints->transform_tei(MOSpace::occ, MOSpace::vir, kets, IntegralTransform::HalfTrans::MakeAndNuke);
 
     if (options.get_bool("DELETE_TEI")) ints->set_keep_dpd_so_ints(false);
 
-    outfile->Printf("\t(VV|OO)...\n");
-    ints->transform_tei(MOSpace::vir, MOSpace::vir, MOSpace::occ, MOSpace::occ,
-                        IntegralTransform::HalfTrans::MakeAndKeep);
-    outfile->Printf("\t(VV|OV)...\n");
-    ints->transform_tei(MOSpace::vir, MOSpace::vir, MOSpace::occ, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndKeep);
-    outfile->Printf("\t(VV|VV)...\n");
-    ints->transform_tei(MOSpace::vir, MOSpace::vir, MOSpace::vir, MOSpace::vir,
-                        IntegralTransform::HalfTrans::ReadAndNuke);
+    outfile->Printf("\t(VV|OO), (VV|OV), (VV|VV)...\n");
+    ints->transform_tei(MOSpace::vir, MOSpace::vir, kets, IntegralTransform::HalfTrans::MakeAndNuke);
 
     double efzc;
     psio->open(PSIF_CC_INFO, PSIO_OPEN_OLD);
@@ -761,6 +780,8 @@ PsiReturnType cctransort(SharedWavefunction ref, Options &options) {
                             nsopi[h] * virpi[h] * sizeof(double), next, &next);
     }
 
+    psio->write_entry(PSIF_CC_INFO, "Sort Signature", (char *)signature.data(), sizeof(double) * signature.size());
+
     dpd_close(0);
     if (reference == 2)
         cachedone_uhf(cachelist);
@@ -91,9 +91,12 @@ void e_sort(int reference) {
         global_dpd_->buf4_close(&E);
 
     } else { /** RHF/ROHF **/
-        /* <ij|ka> */
+        /* <ij|ka>, <ia|jk> and <ij|ak> from one read */
         global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-        global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, srqp, 0, 10, "E <ij|ka>");
+        global_dpd_->buf4_sort_multi(&E, PSIF_CC_EINTS,
+                                     {{srqp, 0, 10, "E <ij|ka>"},
+                                      {qpsr, 10, 0, "E <ia|jk>"},
+                                      {rspq, 0, 11, "E <ij|ak>"}});
         global_dpd_->buf4_close(&E);
 
         /* <ij||ka> (i>j,ka) */
@@ -110,16 +113,6 @@ void e_sort(int reference) {
         global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 2, 10, 2, 10, 0, "E <ij||ka> (i>j,ka)");
         global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, pqsr, 2, 11, "E <ij||ka> (i>j,ak)");
         global_dpd_->buf4_close(&E);
-
-        /* <ia|jk> */
-        global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-        global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, qpsr, 10, 0, "E <ia|jk>");
-        global_dpd_->buf4_close(&E);
-
-        /* <ij|ak> */
-        global_dpd_->buf4_init(&E, PSIF_CC_EINTS, 0, 11, 0, 11, 0, 0, "E <ai|jk>");
-        global_dpd_->buf4_sort(&E, PSIF_CC_EINTS, rspq, 0, 11, "E <ij|ak>");
-        global_dpd_->buf4_close(&E);
     }
 }
 
@@ -587,6 +587,9 @@ class DCFTSolver : public Wavefunction {
     SharedMatrix bQpqB_mo_;
     SharedMatrix bQpqA_mo_scf_;
     SharedMatrix bQpqB_mo_scf_;
+    /// Orbitals used for the last b(Q|pq) SCF-basis transformation
+    SharedMatrix bQpq_scf_Ca_;
+    SharedMatrix bQpq_scf_Cb_;
 
     /// The Tau in the MO basis (All)
     SharedMatrix mo_tauA_;
@@ -1099,15 +1099,17 @@ void DCFTSolver::form_df_g_vooo() {
     // Sort b(Q|IA) -> b(Q|AI)
     bQaiA_mo_ = std::make_shared<Matrix>("b(Q|AI)", Q, VO);
     for (int h = 0; h < nirrep_; ++h) {
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hI = h ^ hA;
-            if (navirpi_[hA] > 0 && naoccpi_[hI] > 0) {
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+        double** bQia_p = bQiaA_mo_->pointer(h);
+        double** bQai_p = bQaiA_mo_->pointer(h);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+        for (int Q = 0; Q < nQ_; ++Q) {
+            for (int hA = 0; hA < nirrep_; ++hA) {
+                int hI = h ^ hA;
                 for (int A = 0; A < navirpi_[hA]; ++A) {
                     for (int I = 0; I < naoccpi_[hI]; ++I) {
                         long int IA = block_Qia[h][hI].first + I * navirpi_[hA] + A;
                         long int AI = block_Qai[h][hA].first + A * naoccpi_[hI] + I;
-                        bQaiA_mo_->set_column(h, AI, bQiaA_mo_->get_column(h, IA));
+                        bQai_p[Q][AI] = bQia_p[Q][IA];
                     }
                 }
             }
@@ -1168,15 +1170,17 @@ void DCFTSolver::form_df_g_vooo() {
         // Sort b(Q|ia) -> b(Q|ai)
         bQaiB_mo_ = std::make_shared<Matrix>("b(Q|ai)", Q, vo);
         for (int h = 0; h < nirrep_; ++h) {
-            for (int ha = 0; ha < nirrep_; ++ha) {
-                int hi = h ^ ha;
-                if (nbvirpi_[ha] > 0 && nboccpi_[hi] > 0) {
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            double** bQia_p = bQiaB_mo_->pointer(h);
+            double** bQai_p = bQaiB_mo_->pointer(h);
+#pragma omp parallel for schedule(static) num_threads(nthreads)
+            for (int Q = 0; Q < nQ_; ++Q) {
+                for (int ha = 0; ha < nirrep_; ++ha) {
+                    int hi = h ^ ha;
                     for (int a = 0; a < nbvirpi_[ha]; ++a) {
                         for (int i = 0; i < nboccpi_[hi]; ++i) {
                             long int ia = block_Qia[h][hi].first + i * nbvirpi_[ha] + a;
                             long int ai = block_Qai[h][ha].first + a * nboccpi_[hi] + i;
-                            bQaiB_mo_->set_column(h, ai, bQiaB_mo_->get_column(h, ia));
+                            bQai_p[Q][ai] = bQia_p[Q][ia];
                         }
                     }
                 }
@@ -1437,6 +1441,107 @@ void DCFTSolver::build_DF_tensors_RHF() {
     dcft_timer_off("DCFTSolver::build_df_tensors_RHF()");
 }
 
+namespace {
+
+/**
+ * Offsets of the (h1, h2) sub-blocks within each irrep of a pair index built from v1 x v2,
+ * i.e. offset[h12][h1] is where the h1 x (h12 ^ h1) block starts
+ */
+std::vector<std::vector<long int>> pair_offsets(const Dimension& v1, const Dimension& v2) {
+    int nirrep = v1.n();
+    std::vector<std::vector<long int>> offset(nirrep, std::vector<long int>(nirrep, 0));
+    for (int h12 = 0; h12 < nirrep; ++h12) {
+        long int entrance = 0;
+        for (int h1 = 0; h1 < nirrep; ++h1) {
+            offset[h12][h1] = entrance;
+            entrance += static_cast<long int>(v1[h1]) * v2[h12 ^ h1];
+        }
+    }
+    return offset;
+}
+
+/**
+ * G<ij|ab> += lambda<ij|cd> g(ac|bd), with g(ac|bd) = Sum_Q b(Q|ac) b(Q|bd) built on the fly.
+ * The [a,c] pairs are indexed by vL and the [b,d] pairs by vR, so the same routine serves the
+ * same-spin (vL == vR) and opposite-spin contractions. The pair of irreps (hij) is outermost,
+ * so every irrep block of lambda and G is read and written exactly once, and the per-thread
+ * scratch is allocated once for the largest block.
+ */
+void lambda_gbar_v3mem(dpdbuf4* L, dpdbuf4* G, const SharedMatrix& bQL, const SharedMatrix& bQR,
+                       const Dimension& vL, const Dimension& vR, int nQ, int nthreads) {
+    int nirrep = vL.n();
+    auto offL = pair_offsets(vL, vL);
+    auto offR = pair_offsets(vR, vR);
+    auto offLR = pair_offsets(vL, vR);
+
+    long int scratch = static_cast<long int>(vL.max()) * vR.max() * vR.max();
+    std::vector<std::vector<double>> CBD(nthreads, std::vector<double>(scratch));
+    std::vector<std::vector<double>> CDB(nthreads, std::vector<double>(scratch));
+
+    for (int hij = 0; hij < nirrep; ++hij) {
+        if (L->params->rowtot[hij] == 0 || L->params->coltot[hij] == 0) continue;
+
+        global_dpd_->buf4_mat_irrep_init(L, hij);
+        global_dpd_->buf4_mat_irrep_rd(L, hij);
+        // G was zeroed by the caller and the freshly allocated block is zero as well
+        global_dpd_->buf4_mat_irrep_init(G, hij);
+
+        int nij = L->params->rowtot[hij];
+        for (int ha = 0; ha < nirrep; ++ha) {
+            int hb = ha ^ hij;
+            for (int hc = 0; hc < nirrep; ++hc) {
+                int hd = hc ^ hij;
+                int hac = ha ^ hc;
+                int hbd = hb ^ hd;
+                int na = vL[ha], nc = vL[hc], nb = vR[hb], nd = vR[hd];
+                if (na == 0 || nb == 0 || nc == 0 || nd == 0) continue;
+
+                double** bQLp = bQL->pointer(hac);
+                double** bQRp = bQR->pointer(hbd);
+                double* Lp = L->matrix[hij][0] + offLR[hij][hc];
+                double* Gp = G->matrix[hij][0] + offLR[hij][ha];
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+                for (int A = 0; A < na; ++A) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double* CBDp = CBD[thread].data();
+                    double* CDBp = CDB[thread].data();
+
+                    // g(A'C|BD) = b(A'C|Q) b(Q|BD)
+                    C_DGEMM('T', 'N', nc, nb * nd, nQ, 1.0, bQLp[0] + offL[hac][ha] + A * nc, bQL->coldim(hac),
+                            bQRp[0] + offR[hbd][hb], bQR->coldim(hbd), 0.0, CBDp, nb * nd);
+
+                    // g(A'C|BD) -> g(A'C|DB); when hb == hd the two layouts coincide in shape and
+                    // swapping the roles of B and D is a relabelling of the summation index
+                    double* gp = CBDp;
+                    if (hb != hd) {
+                        for (int C = 0; C < nc; ++C) {
+                            const double* src = CBDp + static_cast<long int>(C) * nb * nd;
+                            double* dst = CDBp + static_cast<long int>(C) * nd * nb;
+                            for (int B = 0; B < nb; ++B)
+                                for (int D = 0; D < nd; ++D) dst[D * nb + B] = src[B * nd + D];
+                        }
+                        gp = CDBp;
+                    }
+
+                    // G<IJ|A'B> += lambda<IJ|CD> g(A'C|DB)
+                    C_DGEMM('N', 'N', nij, nb, nc * nd, 1.0, Lp, L->params->coltot[hij], gp, nb, 1.0, Gp + A * nb,
+                            G->params->coltot[hij]);
+                }
+            }
+        }
+
+        global_dpd_->buf4_mat_irrep_wrt(G, hij);
+        global_dpd_->buf4_mat_irrep_close(G, hij);
+        global_dpd_->buf4_mat_irrep_close(L, hij);
+    }
+}
+
+}  // namespace
+
 /**
  * Compute the contraction, gbar<ab|cd> lambda<ij|cd>, using density fitting.
  * Memory required: O(V^3)
@@ -1449,20 +1554,6 @@ void DCFTSolver::build_gbarlambda_RHF_v3mem() {
     nthreads = Process::environment.get_n_threads();
 #endif
 
-    // Put detailed information of b(Q|ab) block into 'block'
-    std::vector<std::vector<std::pair<long int, long int>>> block;
-    for (int hab = 0; hab < nirrep_; ++hab) {
-        long int entrance = 0;
-        std::vector<std::pair<long int, long int>> subblock;
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hb = hab ^ ha;
-            std::pair<long int, long int> subsubblock(entrance, navirpi_[ha] * navirpi_[hb]);
-            subblock.push_back(subsubblock);
-            entrance += subsubblock.second;
-        }
-        block.push_back(subblock);
-    }
-
     /*
      * Intermediate G_SF_<IJ|AB> = lambda_SF_<IJ|CD> g<AB|CD>
      */
@@ -1475,97 +1566,7 @@ void DCFTSolver::build_gbarlambda_RHF_v3mem() {
                            "tau(temp) SF <OO|VV>");
     global_dpd_->buf4_scm(&Gaa, 0.0);
 
-    for (int hac = 0; hac < nirrep_; ++hac) {
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hc = hac ^ ha;
-            int hbd = hac;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hab = ha ^ hb;
-                int hcd = hc ^ hd;
-                int hij = hcd;
-
-                if (Laa.params->rowtot[hij] > 0 && Laa.params->coltot[hcd] > 0 && Gaa.params->rowtot[hij] > 0 &&
-                    Gaa.params->coltot[hab] > 0 && navirpi_[ha] > 0 && navirpi_[hc] > 0 && navirpi_[hb] > 0 &&
-                    navirpi_[hd] > 0) {
-                    double** bQvvAp = bQabA_mo_->pointer(hac);
-
-                    global_dpd_->buf4_mat_irrep_init(&Laa, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Laa, hij);
-                    global_dpd_->buf4_mat_irrep_init(&Gaa, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Gaa, hij);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> CBD;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hc], navirpi_[hb] * navirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[ha]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hc], navirpi_[hb] * navirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block[hac][ha].first + A * navirpi_[hc], bQabA_mo_->coldim(hac),
-                                    bQvvAp[0] + block[hbd][hb].first, bQabA_mo_->coldim(hbd), 0.0, CBDp[0],
-                                    navirpi_[hb] * navirpi_[hd]);
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hij], navirpi_[hb], navirpi_[hc] * navirpi_[hd], 1.0,
-                                    Laa.matrix[hij][0] + block[hcd][hc].first, Laa.params->coltot[hij], CBDp[0],
-                                    navirpi_[hb], 1.0, Gaa.matrix[hij][0] + block[hab][ha].first + A * navirpi_[hb],
-                                    Gaa.params->coltot[hij]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> CBD, CDB;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hc], navirpi_[hb] * navirpi_[hd]));
-                            CDB.push_back(
-                                std::make_shared<Matrix>("g(A'C|DB)", navirpi_[hc], navirpi_[hd] * navirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[ha]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hc], navirpi_[hb] * navirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block[hac][ha].first + A * navirpi_[hc], bQabA_mo_->coldim(hac),
-                                    bQvvAp[0] + block[hbd][hb].first, bQabA_mo_->coldim(hbd), 0.0, CBDp[0],
-                                    navirpi_[hb] * navirpi_[hd]);
-
-                            // g(A'C|BD) -> g(A'C|DB)
-                            for (int B = 0; B < navirpi_[hb]; ++B) {
-                                for (int D = 0; D < navirpi_[hd]; ++D)
-                                    CDB[thread]->set_column(0, D * navirpi_[hb] + B,
-                                                            CBD[thread]->get_column(0, B * navirpi_[hd] + D));
-                            }
-
-                            double** CDBp = CDB[thread]->pointer();
-
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hij], navirpi_[hb], navirpi_[hc] * navirpi_[hd], 1.0,
-                                    Laa.matrix[hij][0] + block[hcd][hc].first, Laa.params->coltot[hij], CDBp[0],
-                                    navirpi_[hb], 1.0, Gaa.matrix[hij][0] + block[hab][ha].first + A * navirpi_[hb],
-                                    Gaa.params->coltot[hij]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gaa, hij);
-                    global_dpd_->buf4_mat_irrep_close(&Gaa, hij);
-
-                    global_dpd_->buf4_mat_irrep_close(&Laa, hij);
-                }
-            }
-        }
-    }
+    lambda_gbar_v3mem(&Laa, &Gaa, bQabA_mo_, bQabA_mo_, navirpi_, navirpi_, nQ_, nthreads);
 
     global_dpd_->buf4_close(&Laa);
     global_dpd_->buf4_close(&Gaa);
@@ -1861,20 +1862,6 @@ void DCFTSolver::build_gbarlambda_UHF_v3mem() {
 
     /********** Alpha-Alpha **********/
 
-    // Put detailed information of b(Q|AB) block into 'block_AB'
-    std::vector<std::vector<std::pair<long int, long int>>> block_AB;
-    for (int hAB = 0; hAB < nirrep_; ++hAB) {
-        long int entrance = 0;
-        std::vector<std::pair<long int, long int>> subblock;
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hB = hAB ^ hA;
-            std::pair<long int, long int> subsubblock(entrance, navirpi_[hA] * navirpi_[hB]);
-            subblock.push_back(subsubblock);
-            entrance += subsubblock.second;
-        }
-        block_AB.push_back(subblock);
-    }
-
     /*
      * Intermediate G <IJ|AB> = 1/2 lambda<IJ|CD> gbar<AB|CD>
      *                        = 1/2 lambda<IJ|CD> g(AC|BD) - 1/2 lambda<IJ|CD> g(AD|BC)
@@ -1889,116 +1876,13 @@ void DCFTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <OO|VV>");
     global_dpd_->buf4_scm(&Gaa, 0.0);
 
-    for (int hAC = 0; hAC < nirrep_; ++hAC) {
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hC = hAC ^ hA;
-            int hBD = hAC;
-            for (int hB = 0; hB < nirrep_; ++hB) {
-                int hD = hBD ^ hB;
-                int hAB = hA ^ hB;
-                int hCD = hC ^ hD;
-                int hIJ = hCD;
-
-                if (Laa.params->rowtot[hIJ] > 0 && Laa.params->coltot[hCD] > 0 && Gaa.params->rowtot[hIJ] > 0 &&
-                    Gaa.params->coltot[hAB] > 0 && navirpi_[hA] > 0 && navirpi_[hC] > 0 && navirpi_[hB] > 0 &&
-                    navirpi_[hD] > 0) {
-                    double** bQvvAp = bQabA_mo_->pointer(hAC);
-
-                    global_dpd_->buf4_mat_irrep_init(&Laa, hIJ);
-                    global_dpd_->buf4_mat_irrep_rd(&Laa, hIJ);
-                    global_dpd_->buf4_mat_irrep_init(&Gaa, hIJ);
-                    global_dpd_->buf4_mat_irrep_rd(&Gaa, hIJ);
-
-                    if (hB == hD) {
-                        std::vector<SharedMatrix> CBD;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hC], navirpi_[hB] * navirpi_[hD]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hC], navirpi_[hB] * navirpi_[hD], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_->coldim(hAC),
-                                    bQvvAp[0] + block_AB[hBD][hB].first, bQabA_mo_->coldim(hBD), 0.0, CBDp[0],
-                                    navirpi_[hB] * navirpi_[hD]);
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hIJ], navirpi_[hB], navirpi_[hC] * navirpi_[hD], 1.0,
-                                    Laa.matrix[hIJ][0] + block_AB[hCD][hC].first, Laa.params->coltot[hIJ], CBDp[0],
-                                    navirpi_[hB], 1.0, Gaa.matrix[hIJ][0] + block_AB[hAB][hA].first + A * navirpi_[hB],
-                                    Gaa.params->coltot[hIJ]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> CBD, CDB;
-                        for (int i = 0; i < nthreads; ++i) {
-                            CBD.push_back(
-                                std::make_shared<Matrix>("g(A'C|BD)", navirpi_[hC], navirpi_[hB] * navirpi_[hD]));
-                            CDB.push_back(
-                                std::make_shared<Matrix>("g(A'C|DB)", navirpi_[hC], navirpi_[hD] * navirpi_[hB]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** CBDp = CBD[thread]->pointer();
-
-                            // g(A'C|BD) = b(A'C|Q) b(Q|BD)
-                            C_DGEMM('T', 'N', navirpi_[hC], navirpi_[hB] * navirpi_[hD], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_->coldim(hAC),
-                                    bQvvAp[0] + block_AB[hBD][hB].first, bQabA_mo_->coldim(hBD), 0.0, CBDp[0],
-                                    navirpi_[hB] * navirpi_[hD]);
-
-                            // g(A'C|BD) -> g(A'C|DB)
-                            for (int B = 0; B < navirpi_[hB]; ++B) {
-                                for (int D = 0; D < navirpi_[hD]; ++D)
-                                    CDB[thread]->set_column(0, D * navirpi_[hB] + B,
-                                                            CBD[thread]->get_column(0, B * navirpi_[hD] + D));
-                            }
-
-                            double** CDBp = CDB[thread]->pointer();
-
-                            // G<IJ|A'B> = lambda<IJ|CD> g(A'C|DB)
-                            C_DGEMM('N', 'N', Gaa.params->rowtot[hIJ], navirpi_[hB], navirpi_[hC] * navirpi_[hD], 1.0,
-                                    Laa.matrix[hIJ][0] + block_AB[hCD][hC].first, Laa.params->coltot[hIJ], CDBp[0],
-                                    navirpi_[hB], 1.0, Gaa.matrix[hIJ][0] + block_AB[hAB][hA].first + A * navirpi_[hB],
-                                    Gaa.params->coltot[hIJ]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gaa, hIJ);
-                    global_dpd_->buf4_mat_irrep_close(&Gaa, hIJ);
-
-                    global_dpd_->buf4_mat_irrep_close(&Laa, hIJ);
-                }
-            }
-        }
-    }
+    lambda_gbar_v3mem(&Laa, &Gaa, bQabA_mo_, bQabA_mo_, navirpi_, navirpi_, nQ_, nthreads);
 
     global_dpd_->buf4_close(&Laa);
     global_dpd_->buf4_close(&Gaa);
 
     /********** Beta-Beta **********/
 
-    // Put detailed information of b(Q|ab) block into 'block_ab'
-    std::vector<std::vector<std::pair<long int, long int>>> block_ab;
-    for (int hab = 0; hab < nirrep_; ++hab) {
-        long int entrance = 0;
-        std::vector<std::pair<long int, long int>> subblock;
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hb = hab ^ ha;
-            std::pair<long int, long int> subsubblock(entrance, nbvirpi_[ha] * nbvirpi_[hb]);
-            subblock.push_back(subsubblock);
-            entrance += subsubblock.second;
-        }
-        block_ab.push_back(subblock);
-    }
-
     /*
      * Intermediate G <ij|ab> = 1/2 lambda<ij|cd> gbar<ab|cd>
      *                        = lambda<ij|cd> g(ac|bd)
@@ -2012,116 +1896,13 @@ void DCFTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <oo|vv>");
     global_dpd_->buf4_scm(&Gbb, 0.0);
 
-    for (int hac = 0; hac < nirrep_; ++hac) {
-        for (int ha = 0; ha < nirrep_; ++ha) {
-            int hc = hac ^ ha;
-            int hbd = hac;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hab = ha ^ hb;
-                int hcd = hc ^ hd;
-                int hij = hcd;
-
-                if (Lbb.params->rowtot[hij] > 0 && Lbb.params->coltot[hcd] > 0 && Gbb.params->rowtot[hij] > 0 &&
-                    Gbb.params->coltot[hab] > 0 && nbvirpi_[ha] > 0 && nbvirpi_[hc] > 0 && nbvirpi_[hb] > 0 &&
-                    nbvirpi_[hd] > 0) {
-                    double** bQvvBp = bQabB_mo_->pointer(hac);
-
-                    global_dpd_->buf4_mat_irrep_init(&Lbb, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Lbb, hij);
-                    global_dpd_->buf4_mat_irrep_init(&Gbb, hij);
-                    global_dpd_->buf4_mat_irrep_rd(&Gbb, hij);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> cbd;
-                        for (int i = 0; i < nthreads; ++i) {
-                            cbd.push_back(
-                                std::make_shared<Matrix>("g(a'c|bd)", nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int a = 0; a < nbvirpi_[ha]; ++a) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** cbdp = cbd[thread]->pointer();
-                            // g(a'c|bd) = b(a'c|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvBp[0] + block_ab[hac][ha].first + a * nbvirpi_[hc], bQabB_mo_->coldim(hac),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_->coldim(hbd), 0.0, cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-                            // G<ij|a'b> = lambda<ij|cd> g(a'c|db)
-                            C_DGEMM('N', 'N', Gbb.params->rowtot[hij], nbvirpi_[hb], nbvirpi_[hc] * nbvirpi_[hd], 1.0,
-                                    Lbb.matrix[hij][0] + block_ab[hcd][hc].first, Lbb.params->coltot[hij], cbdp[0],
-                                    nbvirpi_[hb], 1.0, Gbb.matrix[hij][0] + block_ab[hab][ha].first + a * nbvirpi_[hb],
-                                    Gbb.params->coltot[hij]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> cbd, cdb;
-                        for (int i = 0; i < nthreads; ++i) {
-                            cbd.push_back(
-                                std::make_shared<Matrix>("g(a'c|bd)", nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd]));
-                            cdb.push_back(
-                                std::make_shared<Matrix>("g(a'c|db)", nbvirpi_[hc], nbvirpi_[hd] * nbvirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int a = 0; a < nbvirpi_[ha]; ++a) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** cbdp = cbd[thread]->pointer();
-
-                            // g(a'c|bd) = b(a'c|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', nbvirpi_[hc], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvBp[0] + block_ab[hac][ha].first + a * nbvirpi_[hc], bQabB_mo_->coldim(hac),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_->coldim(hbd), 0.0, cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-
-                            // g(a'c|bd) -> g(a'c|db)
-                            for (int b = 0; b < nbvirpi_[hb]; ++b) {
-                                for (int d = 0; d < nbvirpi_[hd]; ++d)
-                                    cdb[thread]->set_column(0, d * nbvirpi_[hb] + b,
-                                                            cbd[thread]->get_column(0, b * nbvirpi_[hd] + d));
-                            }
-
-                            double** cdbp = cdb[thread]->pointer();
-
-                            // G<ij|a'b> = lambda<ij|cd> g(a'c|db)
-                            C_DGEMM('N', 'N', Gbb.params->rowtot[hij], nbvirpi_[hb], nbvirpi_[hc] * nbvirpi_[hd], 1.0,
-                                    Lbb.matrix[hij][0] + block_ab[hcd][hc].first, Lbb.params->coltot[hij], cdbp[0],
-                                    nbvirpi_[hb], 1.0, Gbb.matrix[hij][0] + block_ab[hab][ha].first + a * nbvirpi_[hb],
-                                    Gbb.params->coltot[hij]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gbb, hij);
-                    global_dpd_->buf4_mat_irrep_close(&Gbb, hij);
-
-                    global_dpd_->buf4_mat_irrep_close(&Lbb, hij);
-                }
-            }
-        }
-    }
+    lambda_gbar_v3mem(&Lbb, &Gbb, bQabB_mo_, bQabB_mo_, nbvirpi_, nbvirpi_, nQ_, nthreads);
 
     global_dpd_->buf4_close(&Lbb);
     global_dpd_->buf4_close(&Gbb);
 
     /********** Alpha-Beta **********/
 
-    // Put detailed information of Ab block (as in lambda<Ij|Ab>) into 'block_Ab'
-    std::vector<std::vector<std::pair<long int, long int>>> block_Ab;
-    for (int hAb = 0; hAb < nirrep_; ++hAb) {
-        long int entrance = 0;
-        std::vector<std::pair<long int, long int>> subblock;
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hb = hAb ^ hA;
-            std::pair<long int, long int> subsubblock(entrance, navirpi_[hA] * nbvirpi_[hb]);
-            subblock.push_back(subsubblock);
-            entrance += subsubblock.second;
-        }
-        block_Ab.push_back(subblock);
-    }
-
     /*
      * Intermediate G<Ij|Ab> = lambda<Ij|Cd> gbar<Ab|Cd>
      *                       = lambda<Ij|Cd> g(AC|bd)
@@ -2135,97 +1916,7 @@ void DCFTSolver::build_gbarlambda_UHF_v3mem() {
                            "tau(temp) <Oo|Vv>");
     global_dpd_->buf4_scm(&Gab, 0.0);
 
-    for (int hAC = 0; hAC < nirrep_; ++hAC) {
-        for (int hA = 0; hA < nirrep_; ++hA) {
-            int hC = hAC ^ hA;
-            int hbd = hAC;
-            for (int hb = 0; hb < nirrep_; ++hb) {
-                int hd = hbd ^ hb;
-                int hAb = hA ^ hb;
-                int hCd = hC ^ hd;
-                int hIj = hCd;
-
-                if (Lab.params->rowtot[hIj] > 0 && Lab.params->coltot[hCd] > 0 && Gab.params->rowtot[hIj] > 0 &&
-                    Gab.params->coltot[hAb] > 0 && navirpi_[hA] > 0 && navirpi_[hC] > 0 && nbvirpi_[hb] > 0 &&
-                    nbvirpi_[hd] > 0) {
-                    double** bQvvAp = bQabA_mo_->pointer(hAC);
-                    double** bQvvBp = bQabB_mo_->pointer(hbd);
-
-                    global_dpd_->buf4_mat_irrep_init(&Lab, hIj);
-                    global_dpd_->buf4_mat_irrep_rd(&Lab, hIj);
-                    global_dpd_->buf4_mat_irrep_init(&Gab, hIj);
-                    global_dpd_->buf4_mat_irrep_rd(&Gab, hIj);
-
-                    if (hb == hd) {
-                        std::vector<SharedMatrix> Cbd;
-                        for (int i = 0; i < nthreads; ++i) {
-                            Cbd.push_back(
-                                std::make_shared<Matrix>("g(A'C|bd)", navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** Cbdp = Cbd[thread]->pointer();
-                            // g(A'C|bd) = b(A'C|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_->coldim(hAC),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_->coldim(hbd), 0.0, Cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-                            // G<Ij|A'b> = lambda<Ij|Cd> g(A'C|db)
-                            C_DGEMM('N', 'N', Gab.params->rowtot[hIj], nbvirpi_[hb], navirpi_[hC] * nbvirpi_[hd], 1.0,
-                                    Lab.matrix[hIj][0] + block_Ab[hCd][hC].first, Lab.params->coltot[hIj], Cbdp[0],
-                                    nbvirpi_[hb], 1.0, Gab.matrix[hIj][0] + block_Ab[hAb][hA].first + A * nbvirpi_[hb],
-                                    Gab.params->coltot[hIj]);
-                        }
-                    } else {
-                        std::vector<SharedMatrix> Cbd, Cdb;
-                        for (int i = 0; i < nthreads; ++i) {
-                            Cbd.push_back(
-                                std::make_shared<Matrix>("g(A'C|bd)", navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd]));
-                            Cdb.push_back(
-                                std::make_shared<Matrix>("g(A'C|db)", navirpi_[hC], nbvirpi_[hd] * nbvirpi_[hb]));
-                        }
-#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-                        for (int A = 0; A < navirpi_[hA]; ++A) {
-                            int thread = 0;
-#ifdef _OPENMP
-                            thread = omp_get_thread_num();
-#endif
-                            double** Cbdp = Cbd[thread]->pointer();
-
-                            // g(A'C|bd) = b(A'C|Q) b(Q|bd)
-                            C_DGEMM('T', 'N', navirpi_[hC], nbvirpi_[hb] * nbvirpi_[hd], nQ_, 1.0,
-                                    bQvvAp[0] + block_AB[hAC][hA].first + A * navirpi_[hC], bQabA_mo_->coldim(hAC),
-                                    bQvvBp[0] + block_ab[hbd][hb].first, bQabB_mo_->coldim(hbd), 0.0, Cbdp[0],
-                                    nbvirpi_[hb] * nbvirpi_[hd]);
-
-                            // g(A'C|bd) -> g(A'C|db)
-                            for (int b = 0; b < nbvirpi_[hb]; ++b) {
-                                for (int d = 0; d < nbvirpi_[hd]; ++d)
-                                    Cdb[thread]->set_column(0, d * nbvirpi_[hb] + b,
-                                                            Cbd[thread]->get_column(0, b * nbvirpi_[hd] + d));
-                            }
-
-                            double** Cdbp = Cdb[thread]->pointer();
-
-                            // G<Ij|A'b> = lambda<Ij|Cd> g(A'C|db)
-                            C_DGEMM('N', 'N', Gab.params->rowtot[hIj], nbvirpi_[hb], navirpi_[hC] * nbvirpi_[hd], 1.0,
-                                    Lab.matrix[hIj][0] + block_Ab[hCd][hC].first, Lab.params->coltot[hIj], Cdbp[0],
-                                    nbvirpi_[hb], 1.0, Gab.matrix[hIj][0] + block_Ab[hAb][hA].first + A * nbvirpi_[hb],
-                                    Gab.params->coltot[hIj]);
-                        }
-                    }
-                    global_dpd_->buf4_mat_irrep_wrt(&Gab, hIj);
-                    global_dpd_->buf4_mat_irrep_close(&Gab, hIj);
-
-                    global_dpd_->buf4_mat_irrep_close(&Lab, hIj);
-                }
-            }
-        }
-    }
+    lambda_gbar_v3mem(&Lab, &Gab, bQabA_mo_, bQabB_mo_, navirpi_, nbvirpi_, nQ_, nthreads);
 
     global_dpd_->buf4_close(&Lab);
     global_dpd_->buf4_close(&Gab);
@@ -2778,6 +2469,9 @@ void DCFTSolver::transform_b_ao2so_scf() {
         }
     }
     bQmn_so_scf_ = std::make_shared<Matrix>("Fully-transformed b", Q, mn);
+    // A new SO-basis tensor invalidates any cached b(Q|pq)
+    bQpq_scf_Ca_.reset();
+    bQpq_scf_Cb_.reset();
 
     std::vector<int> offset(nirrep_);
     for (int h = 0; h < nirrep_; ++h) {
@@ -2918,6 +2612,19 @@ void DCFTSolver::formb_oo_scf() {
  * form b(Q,pq) for SCF terms
  */
 void DCFTSolver::formb_pq_scf() {
+    // b(Q|pq) in the SCF basis only depends on the orbitals, so keep it resident
+    // and skip the transformation while Ca/Cb have not changed since the last call
+    auto same_orbitals = [](const SharedMatrix& C, const SharedMatrix& C_last) {
+        if (!C_last) return false;
+        SharedMatrix diff = C->clone();
+        diff->subtract(C_last);
+        return diff->absmax() == 0.0;
+    };
+    bool rhf = options_.get_str("REFERENCE") == "RHF";
+    if (bQpqA_mo_scf_ && same_orbitals(Ca_, bQpq_scf_Ca_) &&
+        (rhf || (bQpqB_mo_scf_ && same_orbitals(Cb_, bQpq_scf_Cb_))))
+        return;
+
     dcft_timer_on("DCFTSolver::b(Q|mn) -> b(Q|pq)");
 
     int nthreads = 1;
@@ -3003,6 +2710,9 @@ void DCFTSolver::formb_pq_scf() {
         }
     }
 
+    bQpq_scf_Ca_ = Ca_->clone();
+    if (!rhf) bQpq_scf_Cb_ = Cb_->clone();
+
     dcft_timer_off("DCFTSolver::b(Q|mn) -> b(Q|pq)");
 }
 }  // namespace dcft
@@ -156,6 +156,10 @@ void CIvect::common_init(void) {
     first_unit_ = 0;
     print_lvl_ = 0;
     fopen_ = false;
+    hd_cache_oei_ = nullptr;
+    hd_cache_tei_ = nullptr;
+    hd_cache_edrc_ = 0.0;
+    hd_cache_method_ = -1;
 }
 
 void CIvect::set(int incor, int maxvect, int nunits, int funit, struct ci_blks *CIblks) {
@@ -869,37 +873,57 @@ size_t CIvect::strings2det(int alp_code, int alp_idx, int bet_code, int bet_idx)
     return (addr);
 }
 
+/*
+** CIvect::calc_hd_blocks()
+**
+** Computes the diagonal elements of H for blocks first_block...last_block
+** with the requested averaging method.  The blocks are independent, so they
+** are distributed over the CI threads.
+*/
+void CIvect::calc_hd_blocks(struct stringwr **alplist, struct stringwr **betlist, double *oei, double *tei,
+                            double edrc, int na, int nb, int nbf, int method, int first_block, int last_block) {
+    if (method != HD_KAVE && method != ORB_ENER && method != EVANGELISTI && method != LEININGER &&
+        method != HD_EXACT && method != Z_HD_KAVE) {
+        throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
+    }
+
+    /* the debug printing inside the block routines must stay ordered */
+    int nthreads = (print_lvl_ > 5) ? 1 : CI_Params_->nthreads;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int block = first_block; block <= last_block; block++) {
+        int iac = Ia_code_[block];
+        int ibc = Ib_code_[block];
+        int ias = Ia_size_[block];
+        int ibs = Ib_size_[block];
+        if (method == HD_KAVE)
+            calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
+        else if (method == ORB_ENER)
+            calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
+        else if (method == EVANGELISTI)
+            calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias,
+                                      ibs, na, nb, nbf);
+        else if (method == LEININGER)
+            calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
+        else if (method == HD_EXACT)
+            calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
+        else
+            calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
+                                edrc, ias, ibs, na, nb, nbf);
+    }
+}
+
 void CIvect::diag_mat_els(struct stringwr **alplist, struct stringwr **betlist, double *oei, double *tei, double edrc,
                           int na, int nb, int nbf, int method) {
-    int block, buf, iac, ibc, ias, ibs, irrep;
+    int block, buf, irrep;
     double minval = 0.0;
 
     if (icore_ == 1) { /* whole vector in-core */
-        for (block = 0; block < num_blocks_; block++) {
-            iac = Ia_code_[block];
-            ibc = Ib_code_[block];
-            ias = Ia_size_[block];
-            ibs = Ib_size_[block];
-            if (method == HD_KAVE)
-                calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == ORB_ENER)
-                calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                        nbf);
-            else if (method == EVANGELISTI)
-                calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc,
-                                          ias, ibs, na, nb, nbf);
-            else if (method == LEININGER)
-                calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == HD_EXACT)
-                calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == Z_HD_KAVE)
-                calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
-                                    edrc, ias, ibs, na, nb, nbf);
-            else {
-                throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-            }
+        calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, 0, num_blocks_ - 1);
 
-            if (CI_Params_->hd_otf && CI_H0block_->size) {
+        /* minval is carried from block to block, so this part stays serial */
+        if (CI_Params_->hd_otf && CI_H0block_->size) {
+            for (block = 0; block < num_blocks_; block++) {
                 minval = blk_max_abs_vals(block, 0, (CI_H0block_->size + CI_H0block_->coupling_size),
                                           CI_H0block_->alplist, CI_H0block_->betlist, CI_H0block_->alpidx,
                                           CI_H0block_->betidx, CI_H0block_->H00, minval, CI_Params_->neg_only);
@@ -916,33 +940,11 @@ void CIvect::diag_mat_els(struct stringwr **alplist, struct stringwr **betlist,
     else if (icore_ == 2) { /* whole symmetry block at a time */
         for (buf = 0; buf < buf_per_vect_; buf++) {
             irrep = buf2blk_[buf];
-            for (block = first_ablk_[irrep]; block <= last_ablk_[irrep]; block++) {
-                iac = Ia_code_[block];
-                ibc = Ib_code_[block];
-                ias = Ia_size_[block];
-                ibs = Ib_size_[block];
-                if (method == HD_KAVE)
-                    calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                      nbf);
-                else if (method == ORB_ENER)
-                    calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na,
-                                            nb, nbf);
-                else if (method == EVANGELISTI)
-                    calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei,
-                                              edrc, ias, ibs, na, nb, nbf);
-                else if (method == LEININGER)
-                    calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                      nbf);
-                else if (method == HD_EXACT)
-                    calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-                else if (method == Z_HD_KAVE)
-                    calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter,
-                                        tei, edrc, ias, ibs, na, nb, nbf);
-                else {
-                    throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-                }
+            calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, first_ablk_[irrep],
+                           last_ablk_[irrep]);
 
-                if (CI_Params_->hd_otf && CI_H0block_->size) {
+            if (CI_Params_->hd_otf && CI_H0block_->size) {
+                for (block = first_ablk_[irrep]; block <= last_ablk_[irrep]; block++) {
                     minval =
                         blk_max_abs_vals(block, buf_offdiag_[buf], (CI_H0block_->size + CI_H0block_->coupling_size),
                                          CI_H0block_->alplist, CI_H0block_->betlist, CI_H0block_->alpidx,
@@ -957,28 +959,7 @@ void CIvect::diag_mat_els(struct stringwr **alplist, struct stringwr **betlist,
     else if (icore_ == 0) { /* one subblock at a time */
         for (buf = 0; buf < buf_per_vect_; buf++) {
             block = buf2blk_[buf];
-            iac = Ia_code_[block];
-            ibc = Ib_code_[block];
-            ias = Ia_size_[block];
-            ibs = Ib_size_[block];
-            if (method == HD_KAVE)
-                calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == ORB_ENER)
-                calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                        nbf);
-            else if (method == EVANGELISTI)
-                calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc,
-                                          ias, ibs, na, nb, nbf);
-            else if (method == LEININGER)
-                calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == HD_EXACT)
-                calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == Z_HD_KAVE)
-                calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
-                                    edrc, ias, ibs, na, nb, nbf);
-            else {
-                throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-            }
+            calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, block, block);
             if (CI_Params_->hd_otf && CI_H0block_->size) {
                 minval = blk_max_abs_vals(block, buf_offdiag_[buf], (CI_H0block_->size + CI_H0block_->coupling_size),
                                           CI_H0block_->alplist, CI_H0block_->betlist, CI_H0block_->alpidx,
@@ -993,92 +974,62 @@ void CIvect::diag_mat_els(struct stringwr **alplist, struct stringwr **betlist,
     }
 }
 
+/*
+** CIvect::diag_mat_els_otf()
+**
+** Computes buffer buf of the diagonal of H into the locked buffer.  The
+** preconditioner asks for the same diagonal once per root and iteration, so
+** with HD_OTF_CACHE each buffer is computed once and then copied from an
+** in-core cache for as long as the integrals, core energy and method that
+** built it are unchanged.
+*/
 void CIvect::diag_mat_els_otf(struct stringwr **alplist, struct stringwr **betlist, double *oei, double *tei,
                               double edrc, int na, int nb, int nbf, int buf, int method) {
-    int block, iac, ibc, ias, ibs, irrep;
+    size_t cache_offset = 0;
+
+    if (CI_Params_->hd_otf_cache) {
+        if (hd_cached_.empty() || oei != hd_cache_oei_ || tei != hd_cache_tei_ || edrc != hd_cache_edrc_ ||
+            method != hd_cache_method_) {
+            hd_cached_.assign(buf_per_vect_, false);
+            hd_cache_oei_ = oei;
+            hd_cache_tei_ = tei;
+            hd_cache_edrc_ = edrc;
+            hd_cache_method_ = method;
+        }
+        for (int i = 0; i < buf; i++) cache_offset += buf_size_[i];
+        if (hd_cached_[buf]) {
+            C_DCOPY(buf_size_[buf], hd_cache_.data() + cache_offset, 1, buffer_, 1);
+            return;
+        }
+    }
 
     if (icore_ == 1) { /* whole vector in-core */
-        for (block = 0; block < num_blocks_; block++) {
-            iac = Ia_code_[block];
-            ibc = Ib_code_[block];
-            ias = Ia_size_[block];
-            ibs = Ib_size_[block];
-            if (method == HD_KAVE)
-                calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == ORB_ENER)
-                calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                        nbf);
-            else if (method == EVANGELISTI)
-                calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc,
-                                          ias, ibs, na, nb, nbf);
-            else if (method == LEININGER)
-                calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == HD_EXACT)
-                calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == Z_HD_KAVE)
-                calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
-                                    edrc, ias, ibs, na, nb, nbf);
-            else {
-                throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-            }
-        }
+        calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, 0, num_blocks_ - 1);
     } /* end icore==1 */
 
     else if (icore_ == 2) { /* whole symmetry block at a time */
-        irrep = buf2blk_[buf];
-        for (block = first_ablk_[irrep]; block <= last_ablk_[irrep]; block++) {
-            iac = Ia_code_[block];
-            ibc = Ib_code_[block];
-            ias = Ia_size_[block];
-            ibs = Ib_size_[block];
-            if (method == HD_KAVE)
-                calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == ORB_ENER)
-                calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb,
-                                        nbf);
-            else if (method == EVANGELISTI)
-                calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc,
-                                          ias, ibs, na, nb, nbf);
-            else if (method == LEININGER)
-                calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == HD_EXACT)
-                calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-            else if (method == Z_HD_KAVE)
-                calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
-                                    edrc, ias, ibs, na, nb, nbf);
-            else {
-                throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-            }
-        }
+        int irrep = buf2blk_[buf];
+        calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, first_ablk_[irrep], last_ablk_[irrep]);
     } /* end icore==2 */
 
     else if (icore_ == 0) { /* one subblock at a time */
-        block = buf2blk_[buf];
-        iac = Ia_code_[block];
-        ibc = Ib_code_[block];
-        ias = Ia_size_[block];
-        ibs = Ib_size_[block];
-        if (method == HD_KAVE)
-            calc_hd_block_ave(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-        else if (method == ORB_ENER)
-            calc_hd_block_orbenergy(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-        else if (method == EVANGELISTI)
-            calc_hd_block_evangelisti(alplist, betlist, alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias,
-                                      ibs, na, nb, nbf);
-        else if (method == LEININGER)
-            calc_hd_block_mll(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-        else if (method == HD_EXACT)
-            calc_hd_block(alplist[iac], betlist[ibc], blocks_[block], oei, tei, edrc, ias, ibs, na, nb, nbf);
-        else if (method == Z_HD_KAVE)
-            calc_hd_block_z_ave(alplist[iac], betlist[ibc], blocks_[block], CI_Params_->perturbation_parameter, tei,
-                                edrc, ias, ibs, na, nb, nbf);
-        else {
-            throw PsiException("hd_ave option not recognized.", __FILE__, __LINE__);
-        }
+        int block = buf2blk_[buf];
+        calc_hd_blocks(alplist, betlist, oei, tei, edrc, na, nb, nbf, method, block, block);
     } /* end icore==0 */
 
     else {
         outfile->Printf("(diag_mat_els): Unrecognized icore_ option!\n");
+        return;
+    }
+
+    if (CI_Params_->hd_otf_cache) {
+        if (hd_cache_.empty()) {
+            size_t total = 0;
+            for (int i = 0; i < buf_per_vect_; i++) total += buf_size_[i];
+            hd_cache_.resize(total);
+        }
+        C_DCOPY(buf_size_[buf], buffer_, 1, hd_cache_.data() + cache_offset, 1);
+        hd_cached_[buf] = true;
     }
 }
 
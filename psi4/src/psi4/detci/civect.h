@@ -123,7 +123,15 @@ class CIvect {
     int subgr_per_irrep_;          /* possible number of Olsen subgraphs per irrep */
     int print_lvl_;                /* print level*/
     bool fopen_;                   /* Are CIVec files open? */
+    std::vector<double> hd_cache_; /* in-core copy of the on-the-fly H diagonal */
+    std::vector<bool> hd_cached_;  /* which buffers hd_cache_ holds */
+    double *hd_cache_oei_;         /* integrals, core energy, and method */
+    double *hd_cache_tei_;         /*   the cached diagonal was built with */
+    double hd_cache_edrc_;
+    int hd_cache_method_;
 
+    void calc_hd_blocks(struct stringwr **alplist, struct stringwr **betlist, double *oei, double *tei, double edrc,
+                        int na, int nb, int nbf, int method, int first_block, int last_block);
     double ssq(struct stringwr *alplist, struct stringwr *betlist, double **CL, double **CR, int nas, int nbs,
                int Ja_list, int Jb_list);
 
@@ -115,6 +115,7 @@ void CIWavefunction::common_init() {
     // Set information
     ints_init_ = false;
     df_ints_init_ = false;
+    dfh_RRQ_ = false;
     mcscf_object_init_ = false;
     cleaned_up_ci_ = false;
     fzc_fock_computed_ = false;
@@ -456,6 +457,7 @@ void CIWavefunction::cleanup_ci(void) {
 
         // DGAS main areas to track size of
         // Free strings and graphs
+        delete[] betlist_ij_;
 
         // Free objects built in common_init
         if (CalcInfo_->sigma_initialized) sigma_free();
@@ -33,9 +33,11 @@
 PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
+#include <vector>
 PRAGMA_WARNING_POP
 #include "psi4/libmints/dimension.h"
 #include "psi4/libmints/wavefunction.h"
+#include "psi4/detci/dist.h"
 
 // From psi4
 namespace psi {
@@ -60,6 +62,7 @@ class SlaterDeterminant;
 struct calcinfo;
 struct params;
 struct stringwr;
+struct stringwr_ij;
 struct ci_blks;
 struct olsen_graph;
 struct H_zero_block;
@@ -334,6 +337,8 @@ class CIWavefunction : public Wavefunction {
     std::shared_ptr<MOSpace> rot_space_;
     std::shared_ptr<MOSpace> act_space_;
     std::shared_ptr<DFHelper> dfh_;  // DF
+    SharedMatrix dfh_Crot_;          // ROT orbitals of the last DF transform
+    bool dfh_RRQ_;                   // Last DF transform also built RRQ
     std::shared_ptr<JK> jk_;
     std::shared_ptr<SOMCSCF> somcscf_;
 
@@ -366,6 +371,7 @@ class CIWavefunction : public Wavefunction {
     /// => Globals <= //
     struct stringwr **alplist_;
     struct stringwr **betlist_;
+    struct stringwr_ij *betlist_ij_;
     struct calcinfo *CalcInfo_;
     struct params *Parameters_;
     struct ci_blks *CIblks_;
@@ -421,9 +427,16 @@ class CIWavefunction : public Wavefunction {
 
     /// => Sigma Calculations <= //
     struct sigma_data *SigmaData_;
+    /// Per-thread sigma scratch; element 0 is SigmaData_
+    std::vector<struct sigma_data *> SigmaThreadData_;
+    /// Sigma block ownership over MPI ranks
+    DistBlocks dist_;
     void sigma_init(CIvect &C, CIvect &S);
+    void sigma_init_scratch(struct sigma_data *SD, CIvect &C);
     void sigma_free(void);
     void sigma(CIvect &C, CIvect &S, double *oei, double *tei, int ivec);
+    int sigma_batch_size(CIvect &C);
+    void sigma_batch(CIvect &C, CIvect &S, double *oei, double *tei, int first, int nvec);
 
     void sigma_a(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei, double *tei,
                  int fci, int ivec);
@@ -434,7 +447,14 @@ class CIWavefunction : public Wavefunction {
 
     void sigma_block(struct stringwr **alplist, struct stringwr **betlist, double **cmat, double **smat, double *oei,
                      double *tei, int fci, int cblock, int sblock, int nas, int nbs, int sac, int sbc, int cac, int cbc,
-                     int cnas, int cnbs, int cnac, int cnbc, int sbirr, int cbirr, int Ms0);
+                     int cnas, int cnbs, int cnac, int cnbc, int sbirr, int cbirr, int Ms0,
+                     struct sigma_data *SD);
+    void sigma_block_batch(struct stringwr **alplist, struct stringwr **betlist, double ***cmat, double ***smat,
+                           int nvec, double *oei, double *tei, int fci, int cblock, int sblock, int nas, int nbs,
+                           int sac, int sbc, int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, int sbirr,
+                           int cbirr, int Ms0, struct sigma_data *SD);
+    void sigma3_vlist(double ***cmat, double ***smat, int nvec, double *tei, int sac, int sbc, int cac, int cbc,
+                      int nas, int nbs, int cnas, int sbirr, int cbirr, int diag, struct sigma_data *SD);
     void sigma_get_contrib(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, int **s1_contrib,
                            int **s2_contrib, int **s3_contrib);
     void form_ov();
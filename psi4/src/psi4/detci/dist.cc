@@ -0,0 +1,97 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DETCI
+    \brief Distribution of the sigma blocks over MPI ranks
+*/
+
+#include "psi4/detci/dist.h"
+
+#include <algorithm>
+#include <numeric>
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+namespace psi {
+namespace detci {
+
+void DistBlocks::assign(const std::vector<double>& cost) {
+    owner_.assign(cost.size(), 0);
+    if (!distributed()) return;
+
+    std::vector<int> order(cost.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+
+    std::vector<double> load(nrank_, 0.0);
+    for (int block : order) {
+        int rank = (int)(std::min_element(load.begin(), load.end()) - load.begin());
+        owner_[block] = rank;
+        load[rank] += cost[block];
+    }
+}
+
+#ifdef ENABLE_MPI
+
+// MPI counts are ints, so large buffers go in pieces
+static const size_t dist_chunk = 1L << 28;
+
+DistBlocks::DistBlocks() : rank_(0), nrank_(1) {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) return;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank_);
+}
+void DistBlocks::sum(double* buffer, size_t n) const {
+    if (nrank_ == 1) return;
+    for (size_t offset = 0L; offset < n; offset += dist_chunk) {
+        int count = (int)std::min(dist_chunk, n - offset);
+        MPI_Allreduce(MPI_IN_PLACE, buffer + offset, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+}
+void DistBlocks::sum(int* buffer, size_t n) const {
+    if (nrank_ == 1) return;
+    for (size_t offset = 0L; offset < n; offset += dist_chunk) {
+        int count = (int)std::min(dist_chunk, n - offset);
+        MPI_Allreduce(MPI_IN_PLACE, buffer + offset, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    }
+}
+
+#else
+
+DistBlocks::DistBlocks() : rank_(0), nrank_(1) {}
+void DistBlocks::sum(double* buffer, size_t n) const {}
+void DistBlocks::sum(int* buffer, size_t n) const {}
+
+#endif
+
+}  // namespace detci
+}  // namespace psi
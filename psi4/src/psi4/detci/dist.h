@@ -0,0 +1,74 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_bin_detci_dist_h
+#define _psi_src_bin_detci_dist_h
+
+#include <cstddef>
+#include <vector>
+
+namespace psi {
+namespace detci {
+
+/**
+ * Distribution of the sigma blocks over the ranks of MPI_COMM_WORLD.
+ * The blocks are dealt out once by estimated cost (longest first, each to
+ * the least loaded rank); every rank forms only the sigma blocks it owns
+ * and the sigma buffers are then summed. The CI vectors themselves are
+ * replicated. Without ENABLE_MPI, or with a single rank, every block is
+ * owned locally and the sums are no-ops.
+ */
+class DistBlocks {
+   protected:
+    int rank_;
+    int nrank_;
+    std::vector<int> owner_;
+
+   public:
+    DistBlocks();
+
+    int rank() const { return rank_; }
+    int nrank() const { return nrank_; }
+    /// Is there more than one rank?
+    bool distributed() const { return nrank_ > 1; }
+
+    /// Assign block i (cost[i]) to a rank
+    void assign(const std::vector<double>& cost);
+    /// Does this rank form block i?
+    bool owns(int block) const { return !distributed() || owner_.empty() || owner_[block] == rank_; }
+
+    /// Sum buffer[0:n] over all ranks, in place
+    void sum(double* buffer, size_t n) const;
+    /// Sum buffer[0:n] over all ranks, in place
+    void sum(int* buffer, size_t n) const;
+};
+
+}  // namespace detci
+}  // namespace psi
+
+#endif  // _psi_src_bin_detci_dist_h
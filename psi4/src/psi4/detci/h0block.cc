@@ -39,6 +39,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 
@@ -81,7 +82,6 @@ void CIWavefunction::H0block_init(size_t size) {
 
     if (H0block_->size) {
         H0block_->H0b = init_matrix(H0block_->size, H0block_->size);
-        if (Parameters_->precon == PRECON_GEN_DAVIDSON) H0block_->H0b_diag_transpose = init_array(H0block_->size);
         H0block_->H0b_diag = init_matrix(H0block_->size, H0block_->size);
         H0block_->H0b_eigvals = init_array(H0block_->size);
         H0block_->tmp1 = init_matrix(H0block_->size, H0block_->size);
@@ -109,9 +109,6 @@ void CIWavefunction::H0block_init(size_t size) {
 void CIWavefunction::H0block_free(void) {
     if (H0block_->osize) {
         free_matrix(H0block_->H0b, H0block_->osize);
-        if (Parameters_->precon == PRECON_GEN_DAVIDSON) {
-            free(H0block_->H0b_diag_transpose);
-        }
         free_matrix(H0block_->H0b_diag, H0block_->osize);
         free_matrix(H0block_->tmp1, H0block_->osize);
         free(H0block_->H00);
@@ -161,9 +158,9 @@ void CIWavefunction::H0block_print(void) {
 }
 
 int CIWavefunction::H0block_calc(double E) {
-    int i, j, size;
+    int i, j, size, lda;
     double detH0 = -1.0;
-    double c_tmp, s_tmp, tval1, tval2, tval3;
+    double tval3;
     double *H0xc0, *H0xs0;
 
     size = H0block_->size;
@@ -178,32 +175,25 @@ int CIWavefunction::H0block_calc(double E) {
     if (Parameters_->precon == PRECON_GEN_DAVIDSON) {
         H0xc0 = init_array(size);
         H0xs0 = init_array(size);
-        for (i = 0; i < size; i++) {
-            for (j = 0; j < size; j++) H0block_->H0b_diag_transpose[j] = H0block_->H0b_diag[j][i];
-            // dot_arr(H0block_->H0b_diag_transpose, H0block_->c0b, size, &H0xc0[i]);
-            // dot_arr(H0block_->H0b_diag_transpose, H0block_->s0b, size, &H0xs0[i]);
+        /* rows keep the stride of the original (possibly larger) allocation */
+        lda = (size > 1) ? (int)(H0block_->H0b_diag[1] - H0block_->H0b_diag[0]) : 1;
 
-            H0xc0[i] = C_DDOT(size, H0block_->H0b_diag_transpose, 1, H0block_->c0b, 1);
-            H0xs0[i] = C_DDOT(size, H0block_->H0b_diag_transpose, 1, H0block_->s0b, 1);
-        }
-        for (i = 0; i < size; i++) {
-            c_tmp = s_tmp = 0.0;
-            for (j = 0; j < size; j++) {
-                tval1 = H0xc0[j] * H0block_->H0b_diag[i][j];
-                tval2 = H0xs0[j] * H0block_->H0b_diag[i][j];
-                tval3 = H0block_->H0b_eigvals[j] - E;
-                if (std::fabs(tval3) < HD_MIN)
-                    tval3 = 0.0;
-                else
-                    tval3 = 1.0 / tval3;
-                tval1 *= tval3;
-                tval2 *= tval3;
-                c_tmp += tval1;
-                s_tmp += tval2;
-            }
-            H0block_->c0bp[i] = c_tmp;
-            H0block_->s0bp[i] = s_tmp;
+        /* project c0b and s0b onto the H0 block eigenvectors */
+        C_DGEMV('t', size, size, 1.0, H0block_->H0b_diag[0], lda, H0block_->c0b, 1, 0.0, H0xc0, 1);
+        C_DGEMV('t', size, size, 1.0, H0block_->H0b_diag[0], lda, H0block_->s0b, 1, 0.0, H0xs0, 1);
+
+        /* scale by 1/(lambda_j - E) and back-transform */
+        for (j = 0; j < size; j++) {
+            tval3 = H0block_->H0b_eigvals[j] - E;
+            if (std::fabs(tval3) < HD_MIN)
+                tval3 = 0.0;
+            else
+                tval3 = 1.0 / tval3;
+            H0xc0[j] *= tval3;
+            H0xs0[j] *= tval3;
         }
+        C_DGEMV('n', size, size, 1.0, H0block_->H0b_diag[0], lda, H0xc0, 1, 0.0, H0block_->c0bp, 1);
+        C_DGEMV('n', size, size, 1.0, H0block_->H0b_diag[0], lda, H0xs0, 1, 0.0, H0block_->s0bp, 1);
 
         if (print_ > 4) {
             outfile->Printf("\nc0b = \n");
@@ -654,7 +644,6 @@ void CIWavefunction::H0block_fill() {
     int Ia, Ib, Ja, Jb;
     int Ialist, Iblist;
     SlaterDeterminant I, J;
-    double *evals, **evecs;
 
     /* fill lower triangle */
     for (i = 0; i < H0block_->size; i++) {
@@ -698,7 +687,19 @@ void CIWavefunction::H0block_fill() {
             size);
     }
 
-    sq_rsp(size, size, H0block_->H0b, H0block_->H0b_eigvals, 1, H0block_->H0b_diag, 1.0E-14);
+    /* dense LAPACK solve (threaded through BLAS) so that large H0 blocks stay cheap */
+    std::vector<double> evecs(static_cast<size_t>(size) * size);
+    for (i = 0; i < size; i++) C_DCOPY(size, H0block_->H0b[i], 1, &evecs[static_cast<size_t>(i) * size], 1);
+    double lwork_query;
+    C_DSYEV('V', 'U', size, evecs.data(), size, H0block_->H0b_eigvals, &lwork_query, -1);
+    std::vector<double> work(static_cast<size_t>(lwork_query));
+    if (C_DSYEV('V', 'U', size, evecs.data(), size, H0block_->H0b_eigvals, work.data(), work.size()))
+        throw PSIEXCEPTION("H0block_fill: diagonalization of the H0 block failed.");
+
+    /* DSYEV leaves eigenvector j in row j; H0b_diag keeps them in columns */
+    for (i = 0; i < size; i++) {
+        for (j = 0; j < size; j++) H0block_->H0b_diag[j][i] = evecs[static_cast<size_t>(i) * size + j];
+    }
 
     if (print_) {
         outfile->Printf("    H0 Block Eigenvalue = %12.8lf\n", H0block_->H0b_eigvals[0] + CalcInfo_->enuc);
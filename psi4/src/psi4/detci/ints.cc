@@ -222,6 +222,20 @@ void CIWavefunction::rotate_mcscf_integrals(SharedMatrix k, SharedVector onel_ou
 }
 void CIWavefunction::transform_dfmcscf_ints(bool approx_only) {
     if (!df_ints_init_) setup_dfmcscf_ints();
+
+    // => Skip the transform if the orbitals have not moved <= //
+    // The DF tensors, onel and twoel ints from the last call are still exact
+    // when the rotating orbitals are unchanged and RRQ is there if requested.
+    SharedMatrix Crot = get_orbitals("ROT");
+    if (dfh_Crot_ && (approx_only || dfh_RRQ_)) {
+        SharedMatrix dC = Crot->clone();
+        dC->subtract(dfh_Crot_);
+        if (dC->absmax() == 0.0) {
+            if (print_ > 1) outfile->Printf("   DF-MCSCF integrals are current, skipping the transform.\n");
+            return;
+        }
+    }
+
     timer_on("CIWave: DFMCSCF integral transform");
 
     // => AO C matrices <= //
@@ -290,6 +304,8 @@ void CIWavefunction::transform_dfmcscf_ints(bool approx_only) {
 
     // compute
     dfh_->transform();
+    dfh_Crot_ = Crot;
+    dfh_RRQ_ = !approx_only;
 
     // => Compute onel ints <= //
     onel_ints_from_jk();
@@ -57,6 +57,7 @@ namespace psi {
 namespace detci {
 
 extern void stringlist(struct olsen_graph *Graph, struct stringwr **slist, int repl_otf, unsigned char ***Occs);
+extern void stringlist_ij(struct olsen_graph *Graph, struct stringwr **slist, struct stringwr_ij *ijlist);
 extern void print_ci_space(struct stringwr *strlist, int num_strings, int nirreps, int strtypes, int nel, int repl_otf);
 extern void str_abs2rel(int absidx, int *relidx, int *listnum, struct olsen_graph *Graph);
 
@@ -146,6 +147,14 @@ void CIWavefunction::form_strings(void) {
         BetaG_ = AlphaG_;
     }
 
+    /* beta replacements grouped by ij for the sigma3 gather */
+    betlist_ij_ = nullptr;
+    if (!Parameters_->repl_otf) {
+        nlists = BetaG_->nirreps * BetaG_->subgr_per_irrep;
+        betlist_ij_ = new stringwr_ij[nlists * nlists];
+        stringlist_ij(BetaG_, betlist_, betlist_ij_);
+    }
+
     /* get number of alpha/beta strings, ref symmetry, etc */
     set_ciblks();
 
@@ -313,6 +313,8 @@ void CIWavefunction::get_parameters(Options &options) {
         outfile->Printf("Warning: HD_OTF FALSE has not been tested recently\n");
     }
 
+    Parameters_->hd_otf_cache = options.get_bool("HD_OTF_CACHE");
+
     if (options["NO_DFILE"].has_changed()) Parameters_->nodfile = options["NO_DFILE"].to_integer();
     if (Parameters_->num_roots > 1) Parameters_->nodfile = FALSE;
 
@@ -467,6 +469,9 @@ void CIWavefunction::get_parameters(Options &options) {
     }
     if (Parameters_->nthreads < 1) Parameters_->nthreads = 1;
 
+    Parameters_->sigma_batch = options.get_int("CI_SIGMA_BATCH");
+    if (Parameters_->sigma_batch < 1) Parameters_->sigma_batch = 1;
+
     Parameters_->sf_restrict = options["SF_RESTRICT"].to_integer();
     Parameters_->print_sigma_overlap = options["SIGMA_OVERLAP"].to_integer();
 
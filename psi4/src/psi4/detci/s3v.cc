@@ -36,6 +36,9 @@
 
 #include <cstdio>
 #include <cstdlib>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
@@ -151,6 +154,10 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
     size_t *Iaridx;
     signed char *Iasgn;
     double *Tptr;
+    bool timed = true;
+#ifdef _OPENMP
+    timed = !omp_in_parallel();
+#endif
 
     /* loop over i, j */
     for (i = 0; i < norbs; i++) {
@@ -173,7 +180,7 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
                 }
             }
 
-            timer_on("CIWave: s3_mt");
+            if (timed) timer_on("CIWave: s3_mt");
             for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
                 /* loop over excitations E^a_{kl} from |A(I_a)> */
                 Jacnt = Ia->cnt[Ja_list];
@@ -207,7 +214,150 @@ void s3_block_v(struct stringwr *alplist, struct stringwr *betlist, double **C,
                 }
 
             } /* end loop over Ia */
-            timer_off("CIWave: s3_mt");
+            if (timed) timer_off("CIWave: s3_mt");
+
+        } /* end loop over j */
+    }     /* end loop over i */
+}
+
+/*
+** S3_DENSE_COUPLING()
+**
+** Decide whether the alpha coupling T(Ia,Ja) for one ij, formed from the
+** alpha replacements from list Ia_list (nas strings) into a list of cnas
+** strings, is full enough that a dense DGEMM beats the sparse update loop.
+*/
+#define S3_DENSE_FILL 8
+
+int s3_dense_coupling(struct stringwr *alplist, int nas, int cnas, int Ja_list) {
+    size_t nnz = 0;
+    for (int Ia_idx = 0; Ia_idx < nas; Ia_idx++) nnz += alplist[Ia_idx].cnt[Ja_list];
+    return (nnz * S3_DENSE_FILL >= (size_t)nas * cnas);
+}
+
+/*
+** S3_BLOCK_VLIST()
+**
+** Calculate a block of the sigma3 vector in equation (9c) of
+** Olsen, Roos, et al. for nvec C vectors at once, as a gather, a product
+** with the alpha coupling, and a scatter for each ij:
+**
+**   C'(Ja, v, J) = sgn(J) C_v(Ja, L(J))        (beta replacements from betij)
+**   V(Ia, v, J) = \sum_Ja T(Ia, Ja) C'(Ja, v, J)
+**   S_v(Ia, R(J)) += V(Ia, v, J)
+**
+** T is formed densely and applied by DGEMM when Tcoup is given (see
+** s3_dense_coupling); otherwise the alpha replacements are applied one row
+** at a time.  diag selects the treatment of diagonal sigma blocks (kl <= ij,
+** (ij|ij) halved) as in s3_block_vdiag().
+**
+** Scratch: Cgath holds cnas * nvec * nbs doubles, Vprod nas * nvec * nbs
+** (dense) or nvec * nbs (sparse), and Tcoup nas * cnas.
+*/
+void s3_block_vlist(struct stringwr *alplist, struct stringwr_ij *betij, double ***C, double ***S, int nvec,
+                    double *tei, int nas, int cnas, int Ja_list, int Ib_sym, int Jb_sym, double *Cgath, double *Tcoup,
+                    double *Vprod, int norbs, int *orbsym, int diag) {
+    struct stringwr *Ia;
+    size_t Ia_ex;
+    int ij, i, j, kl, ijkl, I, J, ivec;
+    double tval, VS, *CgathI0, *CI0, *SI0, *VI0, *TI0;
+    int jlen, Ia_idx, Jacnt, *Iaij;
+    size_t ld, n;
+    size_t *Iaridx;
+    signed char *Iasgn;
+    double *Tptr;
+    int *L, *R;
+    signed char *Sgn;
+
+    /* loop over i, j */
+    for (i = 0; i < norbs; i++) {
+        for (j = 0; j <= i; j++) {
+            if ((orbsym[i] ^ orbsym[j] ^ Jb_sym ^ Ib_sym) != 0) continue;
+            ij = ioff[i] + j;
+            jlen = (int)(betij->off[ij + 1] - betij->off[ij]);
+
+            if (!jlen) continue;
+
+            L = betij->L.data() + betij->off[ij];
+            R = betij->R.data() + betij->off[ij];
+            Sgn = betij->sgn.data() + betij->off[ij];
+            Tptr = tei + ioff[ij];
+            ld = (size_t)nvec * jlen;
+
+            /* gather operation */
+            for (I = 0; I < cnas; I++) {
+                for (ivec = 0; ivec < nvec; ivec++) {
+                    CgathI0 = Cgath + I * ld + (size_t)ivec * jlen;
+                    CI0 = C[ivec][I];
+                    for (J = 0; J < jlen; J++) {
+                        CgathI0[J] = CI0[L[J]] * (double)Sgn[J];
+                    }
+                }
+            }
+
+            if (Tcoup != nullptr) zero_arr(Tcoup, nas * cnas);
+
+            for (Ia = alplist, Ia_idx = 0; Ia_idx < nas; Ia_idx++, Ia++) {
+                /* loop over excitations E^a_{kl} from |A(I_a)> */
+                Jacnt = Ia->cnt[Ja_list];
+                Iaridx = Ia->ridx[Ja_list];
+                Iasgn = Ia->sgn[Ja_list];
+                Iaij = Ia->ij[Ja_list];
+
+                VI0 = (Tcoup != nullptr) ? nullptr : Vprod;
+                TI0 = (Tcoup != nullptr) ? Tcoup + (size_t)Ia_idx * cnas : nullptr;
+                if (VI0 != nullptr) zero_arr(VI0, (int)ld);
+
+                for (Ia_ex = 0; Ia_ex < Jacnt; Ia_ex++) {
+                    kl = *Iaij++;
+                    if (diag && kl > ij) break;
+                    I = *Iaridx++;
+                    tval = *Iasgn++;
+                    if (diag) {
+                        if (ij == kl) tval *= 0.5;
+                        VS = Tptr[kl] * tval;
+                    } else {
+                        ijkl = INDEX(ij, kl);
+                        VS = tval * tei[ijkl];
+                    }
+
+                    if (TI0 != nullptr) {
+                        TI0[I] += VS;
+                    } else {
+                        CgathI0 = Cgath + I * ld;
+                        for (n = 0; n < ld; n++) {
+                            VI0[n] += VS * CgathI0[n];
+                        }
+                    }
+                }
+
+                if (VI0 == nullptr) continue;
+
+                /* scatter */
+                for (ivec = 0; ivec < nvec; ivec++) {
+                    SI0 = S[ivec][Ia_idx];
+                    CgathI0 = VI0 + (size_t)ivec * jlen;
+                    for (J = 0; J < jlen; J++) {
+                        SI0[R[J]] += CgathI0[J];
+                    }
+                }
+
+            } /* end loop over Ia */
+
+            if (Tcoup == nullptr) continue;
+
+            C_DGEMM('n', 'n', nas, (int)ld, cnas, 1.0, Tcoup, cnas, Cgath, (int)ld, 0.0, Vprod, (int)ld);
+
+            /* scatter */
+            for (Ia_idx = 0; Ia_idx < nas; Ia_idx++) {
+                for (ivec = 0; ivec < nvec; ivec++) {
+                    SI0 = S[ivec][Ia_idx];
+                    VI0 = Vprod + Ia_idx * ld + (size_t)ivec * jlen;
+                    for (J = 0; J < jlen; J++) {
+                        SI0[R[J]] += VI0[J];
+                    }
+                }
+            }
 
         } /* end loop over j */
     }     /* end loop over i */
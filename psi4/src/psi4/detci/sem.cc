@@ -55,6 +55,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <algorithm>
 
 namespace psi {
 namespace detci {
@@ -523,6 +524,14 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
         Cvec.buf_lock(buffer1);
         Sigma.buf_lock(buffer2);
 
+        /* form the new sigma vectors together when they fit in core */
+        int nbatch = Parameters_->z_scale_H ? 1 : sigma_batch_size(Cvec);
+        if (nbatch > 1 && L - Llast > 1) {
+            for (i = Llast; i < L; i += nbatch) sigma_batch(Cvec, Sigma, oei, tei, i, std::min(nbatch, L - i));
+        } else {
+            nbatch = 1;
+        }
+
         for (i = Llast; i < L; i++) {
             Cvec.read(i, 0);
             if (print_ > 3) {
@@ -530,7 +539,10 @@ void CIWavefunction::sem_iter(CIvect &Hd, struct stringwr **alplist, struct stri
                 Cvec.print();
             }
 
-            sigma(Cvec, Sigma, oei, tei, i);
+            if (nbatch > 1)
+                Sigma.read(i, 0);
+            else
+                sigma(Cvec, Sigma, oei, tei, i);
 
             if (Parameters_->z_scale_H) {
                 Cvec.buf_unlock();
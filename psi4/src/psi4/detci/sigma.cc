@@ -45,9 +45,15 @@
 #include <cstdlib>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/detci/structs.h"
 #include "psi4/detci/civect.h"
 #include "psi4/detci/ciwave.h"
@@ -99,6 +105,10 @@ extern void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2], signed
                                 double *tei, int nas, int nbs, int cnas, int Ib_list, int Ja_list, int Jb_list,
                                 int Ib_sym, int Jb_sym, double **Cprime, double *F, double *V, double *Sgn, int *L,
                                 int *R, int norbs, int *orbsym);
+extern int s3_dense_coupling(struct stringwr *alplist, int nas, int cnas, int Ja_list);
+extern void s3_block_vlist(struct stringwr *alplist, struct stringwr_ij *betij, double ***C, double ***S, int nvec,
+                           double *tei, int nas, int cnas, int Ja_list, int Ib_sym, int Jb_sym, double *Cgath,
+                           double *Tcoup, double *Vprod, int norbs, int *orbsym, int diag);
 
 /*
 ** sigma_init()
@@ -108,87 +118,122 @@ extern void s3_block_vdiag_rotf(int *Cnt[2], int **Ij[2], int **Ridx[2], signed
 **
 */
 void CIWavefunction::sigma_init(CIvect &C, CIvect &S) {
+    if (CalcInfo_->sigma_initialized) {
+        // outfile->Printf("(sigma_init): sigma_initialized already set to 1\n");
+        return;
+    }
+
+    sigma_init_scratch(SigmaData_, C);
+
+    /* figure out which C blocks contribute to s */
+    s1_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
+    s2_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
+    s3_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
+    if (Parameters_->repl_otf)
+        sigma_get_contrib_rotf(C, S, s1_contrib_, s2_contrib_, s3_contrib_, SigmaData_->Jcnt, SigmaData_->Jij,
+                               SigmaData_->Joij, SigmaData_->Jridx, SigmaData_->Jsgn, SigmaData_->Toccs);
+    else
+        sigma_get_contrib(alplist_, betlist_, C, S, s1_contrib_, s2_contrib_, s3_contrib_);
+
+    /* deal the sigma blocks out over the MPI ranks by estimated work */
+    if (dist_.distributed()) {
+        std::vector<double> cost(S.num_blocks_, 0.0);
+        for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+            double size = (double)S.Ia_size_[sblock] * S.Ib_size_[sblock];
+            for (int cblock = 0; cblock < C.num_blocks_; cblock++) {
+                cost[sblock] += size * (s1_contrib_[sblock][cblock] + s2_contrib_[sblock][cblock] +
+                                        CalcInfo_->num_ci_orbs * s3_contrib_[sblock][cblock]);
+            }
+        }
+        dist_.assign(cost);
+    }
+
+    /* one set of scratch arrays per thread for the threaded sigma block loops */
+    SigmaThreadData_.assign(1, SigmaData_);
+#ifdef _OPENMP
+    for (int thread = 1; thread < Parameters_->nthreads; thread++) {
+        struct sigma_data *SD = new sigma_data();
+        sigma_init_scratch(SD, C);
+        SigmaThreadData_.push_back(SD);
+    }
+#endif
+
+    CalcInfo_->sigma_initialized = 1;
+}
+
+/*
+** sigma_init_scratch()
+**
+** Allocate the scratch arrays used by sigma_block() for one thread
+**
+*/
+void CIWavefunction::sigma_init_scratch(struct sigma_data *SD, CIvect &C) {
     int i, j;
     int maxcols = 0, maxrows = 0;
     int nsingles, max_dim = 0;
     size_t bufsz = 0;
 
-    SigmaData_->transp_tmp = nullptr;
-    SigmaData_->cprime = nullptr;
-    SigmaData_->sprime = nullptr;
-
-    if (CalcInfo_->sigma_initialized) {
-        // outfile->Printf("(sigma_init): sigma_initialized already set to 1\n");
-        return;
-    }
+    SD->transp_tmp = nullptr;
+    SD->cprime = nullptr;
+    SD->sprime = nullptr;
 
     for (i = 0; i < C.num_blocks_; i++) {
         if (C.Ib_size_[i] > max_dim) max_dim = C.Ib_size_[i];
         if (C.Ia_size_[i] > max_dim) max_dim = C.Ia_size_[i];
     }
-    SigmaData_->max_dim = max_dim;
-    SigmaData_->F = init_array(max_dim);
+    SD->max_dim = max_dim;
+    SD->F = init_array(max_dim);
 
-    SigmaData_->Sgn = init_array(max_dim);
-    SigmaData_->V = init_array(max_dim);
-    SigmaData_->L = init_int_array(max_dim);
-    SigmaData_->R = init_int_array(max_dim);
+    SD->Sgn = init_array(max_dim);
+    SD->V = init_array(max_dim);
+    SD->L = init_int_array(max_dim);
+    SD->R = init_int_array(max_dim);
 
     if (Parameters_->repl_otf) {
         max_dim += AlphaG_->num_el_expl;
         nsingles = AlphaG_->num_el_expl * AlphaG_->num_orb;
         for (i = 0; i < 2; i++) {
-            SigmaData_->Jcnt[i] = init_int_array(max_dim);
-            SigmaData_->Jij[i] = init_int_matrix(max_dim, nsingles);
-            SigmaData_->Joij[i] = init_int_matrix(max_dim, nsingles);
-            SigmaData_->Jridx[i] = init_int_matrix(max_dim, nsingles);
-            SigmaData_->Jsgn[i] = (signed char **)malloc(max_dim * sizeof(signed char *));
+            SD->Jcnt[i] = init_int_array(max_dim);
+            SD->Jij[i] = init_int_matrix(max_dim, nsingles);
+            SD->Joij[i] = init_int_matrix(max_dim, nsingles);
+            SD->Jridx[i] = init_int_matrix(max_dim, nsingles);
+            SD->Jsgn[i] = (signed char **)malloc(max_dim * sizeof(signed char *));
             for (j = 0; j < max_dim; j++) {
-                SigmaData_->Jsgn[i][j] = (signed char *)malloc(nsingles * sizeof(signed char));
+                SD->Jsgn[i][j] = (signed char *)malloc(nsingles * sizeof(signed char));
             }
         }
 
-        SigmaData_->Toccs = (unsigned char **)malloc(sizeof(unsigned char *) * nsingles);
+        SD->Toccs = (unsigned char **)malloc(sizeof(unsigned char *) * nsingles);
 
         /* test out the on-the-fly replacement routines */
         /*
-        b2brepl_test(Occs_,SigmaData_->Jcnt[0],SigmaData_->Jij[0],
-                     SigmaData_->Joij[0],SigmaData_->Jridx[0],SigmaData_->Jsgn[0],AlphaG);
+        b2brepl_test(Occs_,SD->Jcnt[0],SD->Jij[0],
+                     SD->Joij[0],SD->Jridx[0],SD->Jsgn[0],AlphaG);
         */
     }
 
-    /* figure out which C blocks contribute to s */
-    s1_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
-    s2_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
-    s3_contrib_ = init_int_matrix(S.num_blocks_, C.num_blocks_);
-    if (Parameters_->repl_otf)
-        sigma_get_contrib_rotf(C, S, s1_contrib_, s2_contrib_, s3_contrib_, SigmaData_->Jcnt, SigmaData_->Jij,
-                               SigmaData_->Joij, SigmaData_->Jridx, SigmaData_->Jsgn, SigmaData_->Toccs);
-    else
-        sigma_get_contrib(alplist_, betlist_, C, S, s1_contrib_, s2_contrib_, s3_contrib_);
-
     if ((C.icore_ == 2 && C.Ms0_ && CalcInfo_->ref_sym != 0) || (C.icore_ == 0 && C.Ms0_)) {
         for (i = 0, maxrows = 0, maxcols = 0; i < C.num_blocks_; i++) {
             if (C.Ia_size_[i] > maxrows) maxrows = C.Ia_size_[i];
             if (C.Ib_size_[i] > maxcols) maxcols = C.Ib_size_[i];
         }
         if (maxcols > maxrows) maxrows = maxcols;
-        SigmaData_->transp_tmp = (double **)malloc(maxrows * sizeof(double *));
-        if (SigmaData_->transp_tmp == nullptr) {
+        SD->transp_tmp = (double **)malloc(maxrows * sizeof(double *));
+        if (SD->transp_tmp == nullptr) {
             outfile->Printf(
                 "(sigma_init): Trouble with malloc'ing "
                 "SigmaData_->transp_tmp\n");
         }
         bufsz = C.get_max_blk_size();
-        SigmaData_->transp_tmp[0] = init_array(bufsz);
-        if (SigmaData_->transp_tmp[0] == nullptr) {
+        SD->transp_tmp[0] = init_array(bufsz);
+        if (SD->transp_tmp[0] == nullptr) {
             outfile->Printf(
                 "(sigma_init): Trouble with malloc'ing "
                 "SigmaData_->transp_tmp[0]\n");
         }
     }
 
-    /* make room for SigmaData_->cprime and SigmaData_->sprime if necessary */
+    /* make room for SD->cprime and SD->sprime if necessary */
     for (i = 0, maxrows = 0; i < C.num_blocks_; i++) {
         if (C.Ia_size_[i] > maxrows) maxrows = C.Ia_size_[i];
         if (C.Ib_size_[i] > maxcols) maxcols = C.Ib_size_[i];
@@ -198,31 +243,29 @@ void CIWavefunction::sigma_init(CIvect &C, CIvect &S) {
     }
     bufsz = C.get_max_blk_size();
 
-    SigmaData_->cprime = (double **)malloc(maxrows * sizeof(double *));
-    if (SigmaData_->cprime == nullptr) {
+    SD->cprime = (double **)malloc(maxrows * sizeof(double *));
+    if (SD->cprime == nullptr) {
         outfile->Printf("(sigma_init): Trouble with malloc'ing SigmaData_->cprime\n");
     }
-    if (C.icore_ == 0 && C.Ms0_ && SigmaData_->transp_tmp != nullptr && SigmaData_->transp_tmp[0] != nullptr)
-        SigmaData_->cprime[0] = SigmaData_->transp_tmp[0];
+    if (C.icore_ == 0 && C.Ms0_ && SD->transp_tmp != nullptr && SD->transp_tmp[0] != nullptr)
+        SD->cprime[0] = SD->transp_tmp[0];
     else
-        SigmaData_->cprime[0] = init_array(bufsz);
+        SD->cprime[0] = init_array(bufsz);
 
-    if (SigmaData_->cprime[0] == nullptr) {
+    if (SD->cprime[0] == nullptr) {
         outfile->Printf("(sigma_init): Trouble with malloc'ing SigmaData_->cprime[0]\n");
     }
 
     if (Parameters_->bendazzoli) {
-        SigmaData_->sprime = (double **)malloc(maxrows * sizeof(double *));
-        if (SigmaData_->sprime == nullptr) {
+        SD->sprime = (double **)malloc(maxrows * sizeof(double *));
+        if (SD->sprime == nullptr) {
             outfile->Printf("(sigma_init): Trouble with malloc'ing SigmaData_->sprime\n");
         }
-        SigmaData_->sprime[0] = init_array(bufsz);
-        if (SigmaData_->sprime[0] == nullptr) {
+        SD->sprime[0] = init_array(bufsz);
+        if (SD->sprime[0] == nullptr) {
             outfile->Printf("(sigma_init): Trouble with malloc'ing SigmaData_->sprime[0]\n");
         }
     }
-
-    CalcInfo_->sigma_initialized = 1;
 }
 
 void CIWavefunction::sigma_free() {
@@ -243,6 +286,44 @@ void CIWavefunction::sigma_free() {
             free(SigmaData_->Jsgn[i]);
         }
     }
+
+    /* the extra per-thread scratch is owned here in full */
+    for (size_t thread = 1; thread < SigmaThreadData_.size(); thread++) {
+        struct sigma_data *SD = SigmaThreadData_[thread];
+        free(SD->F);
+        free(SD->Sgn);
+        free(SD->V);
+        free(SD->L);
+        free(SD->R);
+        if (Parameters_->repl_otf) {
+            for (int i = 0; i < 2; i++) {
+                free(SD->Jcnt[i]);
+                free_int_matrix(SD->Jij[i]);
+                free_int_matrix(SD->Joij[i]);
+                free_int_matrix(SD->Jridx[i]);
+                for (int j = 0; j < SD->max_dim + AlphaG_->num_el_expl; j++) {
+                    free(SD->Jsgn[i][j]);
+                }
+                free(SD->Jsgn[i]);
+            }
+            free(SD->Toccs);
+        }
+        if (SD->cprime != nullptr) {
+            if (SD->transp_tmp == nullptr || SD->cprime[0] != SD->transp_tmp[0]) free(SD->cprime[0]);
+            free(SD->cprime);
+        }
+        if (SD->transp_tmp != nullptr) {
+            free(SD->transp_tmp[0]);
+            free(SD->transp_tmp);
+        }
+        if (SD->sprime != nullptr) {
+            free(SD->sprime[0]);
+            free(SD->sprime);
+        }
+        delete SD;
+    }
+    SigmaThreadData_.clear();
+
     CalcInfo_->sigma_initialized = false;
     // DGAS: Not sure how to free these yet
     //      SigmaData_->Toccs = (unsigned char **) malloc (sizeof(unsigned char *) * nsingles);
@@ -277,6 +358,216 @@ void CIWavefunction::sigma(CIvect &C, CIvect &S, double *oei, double *tei, int i
             break;
     }
 }
+/*
+** sigma_batch_size()
+**
+** Number of C vectors sigma_batch() may take at once.  Returns 1 when
+** batching does not apply: the whole vector must be in core (icore=1),
+** the on-the-fly replacement lists and the Bendazzoli sigma3 are not
+** batched, and the nvec C and sigma copies must fit in 40% of memory.
+*/
+int CIWavefunction::sigma_batch_size(CIvect &C) {
+    if (C.icore_ != 1 || Parameters_->repl_otf || Parameters_->bendazzoli || print_ > 3) return 1;
+
+    size_t vecmem = 2 * C.buffer_size_ * sizeof(double);
+    size_t maxvec = (size_t)(Process::environment.get_memory() * 0.4) / std::max(vecmem, (size_t)1);
+    return (int)std::max((size_t)1, std::min((size_t)Parameters_->sigma_batch, maxvec));
+}
+
+/*
+** sigma_batch(): compute the sigma vectors for C vectors first through
+**    first+nvec-1 in one pass over the block pairs (icore=1 only).  The
+**    sigma3 term shares the string replacement walk between all vectors
+**    (see s3_block_vlist); sigma1 and sigma2 are applied vector by vector
+**    while the block pair is hot.  C and S must be locked onto buffers and
+**    are left holding the last vector of the batch, as a run of sigma()
+**    calls would.
+*/
+void CIWavefunction::sigma_batch(CIvect &C, CIvect &S, double *oei, double *tei, int first, int nvec) {
+    if (!CalcInfo_->sigma_initialized) sigma_init(C, S);
+    int fci = Parameters_->fci;
+    int phase;
+
+    if (!Parameters_->Ms0)
+        phase = 1;
+    else
+        phase = ((int)Parameters_->S % 2) ? -1 : 1;
+
+    timer_on("CIWave: sigma_batch");
+
+    /* hold all nvec C and sigma vectors in core, blocked as C and S are */
+    size_t vlen = C.buffer_size_;
+    int nblk = C.num_blocks_;
+    std::vector<double> cbuf((size_t)nvec * vlen);
+    std::vector<double> sbuf((size_t)nvec * vlen, 0.0);
+    std::vector<std::vector<double *>> crows((size_t)nvec * nblk), srows((size_t)nvec * nblk);
+
+    for (int ivec = 0; ivec < nvec; ivec++) {
+        C.read(first + ivec, 0);
+        std::memcpy(cbuf.data() + ivec * vlen, C.buffer_, vlen * sizeof(double));
+        for (int blk = 0; blk < nblk; blk++) {
+            int nrow = C.Ia_size_[blk], ncol = C.Ib_size_[blk];
+            if (nrow == 0 || ncol == 0) continue;
+            double *c0 = cbuf.data() + ivec * vlen + (C.blocks_[blk][0] - C.buffer_);
+            double *s0 = sbuf.data() + ivec * vlen + (S.blocks_[blk][0] - S.buffer_);
+            crows[ivec * nblk + blk].resize(nrow);
+            srows[ivec * nblk + blk].resize(nrow);
+            for (int row = 0; row < nrow; row++) {
+                crows[ivec * nblk + blk][row] = c0 + (size_t)row * ncol;
+                srows[ivec * nblk + blk][row] = s0 + (size_t)row * ncol;
+            }
+        }
+    }
+
+    int nthreads = SigmaThreadData_.size();
+    std::vector<int> did_sblock(S.num_blocks_, 0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+        if (!dist_.owns(sblock)) continue;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        struct sigma_data *SD = SigmaThreadData_[thread];
+        std::vector<double **> cmat(nvec), smat(nvec);
+        int sac = S.Ia_code_[sblock];
+        int sbc = S.Ib_code_[sblock];
+        int nas = S.Ia_size_[sblock];
+        int nbs = S.Ib_size_[sblock];
+        if (nas == 0 || nbs == 0) continue;
+        if (S.Ms0_ && sbc > sac) continue;
+        int sbirr = sbc / BetaG_->subgr_per_irrep;
+        for (int ivec = 0; ivec < nvec; ivec++) smat[ivec] = srows[ivec * nblk + sblock].data();
+
+        for (int cblock = 0; cblock < C.num_blocks_; cblock++) {
+            if (C.check_zero_block(cblock)) continue;
+            if (!(s1_contrib_[sblock][cblock] || s2_contrib_[sblock][cblock] || s3_contrib_[sblock][cblock]))
+                continue;
+            int cac = C.Ia_code_[cblock];
+            int cbc = C.Ib_code_[cblock];
+            int cnas = C.Ia_size_[cblock];
+            int cnbs = C.Ib_size_[cblock];
+            int cbirr = cbc / BetaG_->subgr_per_irrep;
+            for (int ivec = 0; ivec < nvec; ivec++) cmat[ivec] = crows[ivec * nblk + cblock].data();
+
+            sigma_block_batch(alplist_, betlist_, cmat.data(), smat.data(), nvec, oei, tei, fci, cblock, sblock, nas,
+                              nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_, sbirr, cbirr,
+                              S.Ms0_, SD);
+            did_sblock[sblock] = 1;
+        } /* end loop over c blocks */
+
+        if (S.Ms0_ && (sac == sbc)) {
+            for (int ivec = 0; ivec < nvec; ivec++) transp_sigma(smat[ivec], nas, nbs, phase);
+        }
+    } /* end loop over sigma blocks */
+
+    /* each rank formed only its own blocks */
+    if (dist_.distributed()) {
+        dist_.sum(sbuf.data(), sbuf.size());
+        dist_.sum(did_sblock.data(), did_sblock.size());
+    }
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+        if (did_sblock[sblock]) S.set_zero_block(sblock, 0);
+    }
+
+    for (int ivec = 0; ivec < nvec; ivec++) {
+        std::memcpy(S.buffer_, sbuf.data() + ivec * vlen, vlen * sizeof(double));
+
+        /* the H0block keeps the sigma of the last vector, as after sigma() */
+        if (ivec == nvec - 1) {
+            for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+                int sac = S.Ia_code_[sblock];
+                int sbc = S.Ib_code_[sblock];
+                if (S.Ia_size_[sblock] == 0 || S.Ib_size_[sblock] == 0) continue;
+                if (S.Ms0_ && sbc > sac) continue;
+                H0block_gather(S.blocks_[sblock], sac, sbc, 1, Parameters_->Ms0, phase);
+            }
+        }
+
+        if (S.Ms0_) {
+            if ((int)Parameters_->S % 2)
+                S.symmetrize(-1.0, 0);
+            else
+                S.symmetrize(1.0, 0);
+        }
+        S.write(first + ivec, 0);
+    }
+
+    /* leave C holding the last vector as well */
+    std::memcpy(C.buffer_, cbuf.data() + (nvec - 1) * vlen, vlen * sizeof(double));
+
+    timer_off("CIWave: sigma_batch");
+}
+
+/*
+** sigma_block_batch()
+**
+** Calculate the contribution to sigma block sblock from C block cblock for
+** nvec vectors.
+*/
+void CIWavefunction::sigma_block_batch(struct stringwr **alplist, struct stringwr **betlist, double ***cmat,
+                                       double ***smat, int nvec, double *oei, double *tei, int fci, int cblock,
+                                       int sblock, int nas, int nbs, int sac, int sbc, int cac, int cbc, int cnas,
+                                       int cnbs, int cnac, int cnbc, int sbirr, int cbirr, int Ms0,
+                                       struct sigma_data *SD) {
+    /* SIGMA2 CONTRIBUTION */
+    if (s2_contrib_[sblock][cblock]) {
+        for (int ivec = 0; ivec < nvec; ivec++) {
+            if (fci)
+                s2_block_vfci(alplist, betlist, cmat[ivec], smat[ivec], oei, tei, SD->F, cnac, nas, nbs, sac, cac,
+                              cnas);
+            else
+                s2_block_vras(alplist, betlist, cmat[ivec], smat[ivec], oei, tei, SD->F, cnac, nas, nbs, sac, cac,
+                              cnas);
+        }
+    }
+
+    /* SIGMA1 CONTRIBUTION */
+    if ((!Ms0 || (sac != sbc)) && s1_contrib_[sblock][cblock]) {
+        for (int ivec = 0; ivec < nvec; ivec++) {
+            if (fci)
+                s1_block_vfci(alplist, betlist, cmat[ivec], smat[ivec], oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc,
+                              cnbs);
+            else
+                s1_block_vras(alplist, betlist, cmat[ivec], smat[ivec], oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc,
+                              cnbs);
+        }
+    }
+
+    /* SIGMA3 CONTRIBUTION */
+    if (s3_contrib_[sblock][cblock]) {
+        sigma3_vlist(cmat, smat, nvec, tei, sac, sbc, cac, cbc, nas, nbs, cnas, sbirr, cbirr, Ms0 && (sac == sbc),
+                     SD);
+    }
+}
+
+/*
+** sigma3_vlist()
+**
+** Apply the sigma3 contribution of one block pair to nvec vectors with the
+** ij-grouped beta replacement lists, sizing the thread's scratch first
+**
+*/
+void CIWavefunction::sigma3_vlist(double ***cmat, double ***smat, int nvec, double *tei, int sac, int sbc, int cac,
+                                  int cbc, int nas, int nbs, int cnas, int sbirr, int cbirr, int diag,
+                                  struct sigma_data *SD) {
+    int nlists = BetaG_->nirreps * BetaG_->subgr_per_irrep;
+    int dense = s3_dense_coupling(alplist_[sac], nas, cnas, cac);
+
+    SD->Cgath.resize((size_t)cnas * nvec * nbs);
+    if (dense) {
+        SD->Tcoup.resize((size_t)nas * cnas);
+        SD->Vprod.resize((size_t)nas * nvec * nbs);
+    } else {
+        SD->Vprod.resize((size_t)nvec * nbs);
+    }
+
+    s3_block_vlist(alplist_[sac], betlist_ij_ + (size_t)sbc * nlists + cbc, cmat, smat, nvec, tei, nas, cnas, cac,
+                   sbirr, cbirr, SD->Cgath.data(), dense ? SD->Tcoup.data() : nullptr, SD->Vprod.data(),
+                   CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs, diag);
+}
+
 void CIWavefunction::sigma(SharedCIVector C, SharedCIVector S, int cvec, int svec) {
     C->cur_vect_ = cvec;
     double *oei;
@@ -367,7 +658,7 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
                 if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock, sblock, nas,
                             nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_, sbirr, cbirr,
-                            S.Ms0_);
+                            S.Ms0_, SigmaData_);
                 did_sblock = 1;
             }
 
@@ -383,7 +674,7 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
                 if (SigmaData_->cprime != nullptr) set_row_ptrs(cnbs, cnas, SigmaData_->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock2], S.blocks_[sblock], oei, tei, fci, cblock2, sblock,
                             nas, nbs, sac, sbc, cbc, cac, cnbs, cnas, C.num_alpcodes_, C.num_betcodes_, sbirr, cairr,
-                            S.Ms0_);
+                            S.Ms0_, SigmaData_);
                 did_sblock = 1;
             }
 
@@ -429,11 +720,6 @@ void CIWavefunction::sigma_a(struct stringwr **alplist, struct stringwr **betlis
 */
 void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei,
                              double *tei, int fci, int ivec) {
-    int sblock, cblock; /* id of sigma and C blocks */
-    int sac, sbc, nas, nbs;
-    int cac, cbc, cnas, cnbs;
-    int sbirr, cbirr;
-    int did_sblock = 0;
     int phase;
 
     if (!Parameters_->Ms0)
@@ -444,41 +730,66 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
     S.zero();
     C.read(C.cur_vect_, 0);
 
+    /* sigma blocks are independent of one another; run them in parallel */
+    int nthreads = (print_ > 3) ? 1 : SigmaThreadData_.size();
+    std::vector<int> did_sblock(S.num_blocks_, 0);
+
     /* loop over unique sigma subblocks */
-    for (sblock = 0; sblock < S.num_blocks_; sblock++) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
         // if (Parameters_->cc && !cc_reqd_sblocks[sblock]) continue;
-        did_sblock = 0;
-        sac = S.Ia_code_[sblock];
-        sbc = S.Ib_code_[sblock];
-        nas = S.Ia_size_[sblock];
-        nbs = S.Ib_size_[sblock];
+        if (!dist_.owns(sblock)) continue;
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        struct sigma_data *SD = SigmaThreadData_[thread];
+        int sac = S.Ia_code_[sblock];
+        int sbc = S.Ib_code_[sblock];
+        int nas = S.Ia_size_[sblock];
+        int nbs = S.Ib_size_[sblock];
         if (nas == 0 || nbs == 0) continue;
         if (S.Ms0_ && sbc > sac) continue;
-        sbirr = sbc / BetaG_->subgr_per_irrep;
-        if (SigmaData_->sprime != nullptr) set_row_ptrs(nas, nbs, SigmaData_->sprime);
+        int sbirr = sbc / BetaG_->subgr_per_irrep;
+        if (SD->sprime != nullptr) set_row_ptrs(nas, nbs, SD->sprime);
 
-        for (cblock = 0; cblock < C.num_blocks_; cblock++) {
+        for (int cblock = 0; cblock < C.num_blocks_; cblock++) {
             if (C.check_zero_block(cblock)) continue;
-            cac = C.Ia_code_[cblock];
-            cbc = C.Ib_code_[cblock];
-            cnas = C.Ia_size_[cblock];
-            cnbs = C.Ib_size_[cblock];
-            cbirr = cbc / BetaG_->subgr_per_irrep;
+            int cac = C.Ia_code_[cblock];
+            int cbc = C.Ib_code_[cblock];
+            int cnas = C.Ia_size_[cblock];
+            int cnbs = C.Ib_size_[cblock];
+            int cbirr = cbc / BetaG_->subgr_per_irrep;
             if (s1_contrib_[sblock][cblock] || s2_contrib_[sblock][cblock] || s3_contrib_[sblock][cblock]) {
-                if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
+                if (SD->cprime != nullptr) set_row_ptrs(cnas, cnbs, SD->cprime);
                 sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock, sblock, nas,
                             nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_, sbirr, cbirr,
-                            S.Ms0_);
-                did_sblock = 1;
+                            S.Ms0_, SD);
+                did_sblock[sblock] = 1;
             }
         } /* end loop over c blocks */
 
-        if (did_sblock) S.set_zero_block(sblock, 0);
-
         if (S.Ms0_ && (sac == sbc)) transp_sigma(S.blocks_[sblock], nas, nbs, phase);
-        H0block_gather(S.blocks_[sblock], sac, sbc, 1, Parameters_->Ms0, phase);
     } /* end loop over sigma blocks */
 
+    /* each rank formed only its own blocks */
+    if (dist_.distributed()) {
+        dist_.sum(S.buffer_, S.buffer_size_);
+        dist_.sum(did_sblock.data(), did_sblock.size());
+    }
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+        if (did_sblock[sblock]) S.set_zero_block(sblock, 0);
+    }
+
+    /* gather the contributions from sigma to the H0block */
+    for (int sblock = 0; sblock < S.num_blocks_; sblock++) {
+        int sac = S.Ia_code_[sblock];
+        int sbc = S.Ib_code_[sblock];
+        if (S.Ia_size_[sblock] == 0 || S.Ib_size_[sblock] == 0) continue;
+        if (S.Ms0_ && sbc > sac) continue;
+        H0block_gather(S.blocks_[sblock], sac, sbc, 1, Parameters_->Ms0, phase);
+    }
+
     if (S.Ms0_) {
         if ((int)Parameters_->S % 2)
             S.symmetrize(-1.0, 0);
@@ -510,13 +821,11 @@ void CIWavefunction::sigma_b(struct stringwr **alplist, struct stringwr **betlis
 void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlist, CIvect &C, CIvect &S, double *oei,
                              double *tei, int fci, int ivec) {
     int buf, cbuf;
-    int sblock, cblock, cblock2; /* id of sigma and C blocks */
-    int sairr;                   /* irrep of alpha string for sigma block */
-    int cairr;                   /* irrep of alpha string for C block */
+    int sblock;       /* id of sigma block */
+    int sairr;        /* irrep of alpha string for sigma block */
+    int cairr;        /* irrep of alpha string for C block */
     int sbirr, cbirr;
     int sac, sbc, nas, nbs;
-    int cac, cbc, cnas, cnbs;
-    int did_sblock = 0;
     int phase;
 
     if (!Parameters_->Ms0)
@@ -524,60 +833,78 @@ void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlis
     else
         phase = ((int)Parameters_->S % 2) ? -1 : 1;
 
+    /* sigma blocks within an irrep are independent; run them in parallel */
+    int nthreads = (print_ > 3) ? 1 : SigmaThreadData_.size();
+    std::vector<int> did_sblock(S.num_blocks_, 0);
+
     for (buf = 0; buf < S.buf_per_vect_; buf++) {
         sairr = S.buf2blk_[buf];
         sbirr = sairr ^ CalcInfo_->ref_sym;
         S.zero();
+        std::fill(did_sblock.begin(), did_sblock.end(), 0);
         for (cbuf = 0; cbuf < C.buf_per_vect_; cbuf++) {
             C.read(C.cur_vect_, cbuf); /* go ahead and assume it will contrib */
             cairr = C.buf2blk_[cbuf];
             cbirr = cairr ^ CalcInfo_->ref_sym;
 
-            for (sblock = S.first_ablk_[sairr]; sblock <= S.last_ablk_[sairr]; sblock++) {
-                sac = S.Ia_code_[sblock];
-                sbc = S.Ib_code_[sblock];
-                nas = S.Ia_size_[sblock];
-                nbs = S.Ib_size_[sblock];
-                did_sblock = 0;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+            for (int sblock = S.first_ablk_[sairr]; sblock <= S.last_ablk_[sairr]; sblock++) {
+                if (!dist_.owns(sblock)) continue;
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                struct sigma_data *SD = SigmaThreadData_[thread];
+                int sac = S.Ia_code_[sblock];
+                int sbc = S.Ib_code_[sblock];
+                int nas = S.Ia_size_[sblock];
+                int nbs = S.Ib_size_[sblock];
 
                 if (S.Ms0_ && (sac < sbc)) continue;
-                if (SigmaData_->sprime != nullptr) set_row_ptrs(nas, nbs, SigmaData_->sprime);
+                if (SD->sprime != nullptr) set_row_ptrs(nas, nbs, SD->sprime);
 
-                for (cblock = C.first_ablk_[cairr]; cblock <= C.last_ablk_[cairr]; cblock++) {
-                    cac = C.Ia_code_[cblock];
-                    cbc = C.Ib_code_[cblock];
-                    cnas = C.Ia_size_[cblock];
-                    cnbs = C.Ib_size_[cblock];
+                for (int cblock = C.first_ablk_[cairr]; cblock <= C.last_ablk_[cairr]; cblock++) {
+                    int cac = C.Ia_code_[cblock];
+                    int cbc = C.Ib_code_[cblock];
+                    int cnas = C.Ia_size_[cblock];
+                    int cnbs = C.Ib_size_[cblock];
 
                     if ((s1_contrib_[sblock][cblock] || s2_contrib_[sblock][cblock] || s3_contrib_[sblock][cblock]) &&
                         !C.check_zero_block(cblock)) {
-                        if (SigmaData_->cprime != nullptr) set_row_ptrs(cnas, cnbs, SigmaData_->cprime);
+                        if (SD->cprime != nullptr) set_row_ptrs(cnas, cnbs, SD->cprime);
                         sigma_block(alplist, betlist, C.blocks_[cblock], S.blocks_[sblock], oei, tei, fci, cblock,
                                     sblock, nas, nbs, sac, sbc, cac, cbc, cnas, cnbs, C.num_alpcodes_, C.num_betcodes_,
-                                    sbirr, cbirr, S.Ms0_);
-                        did_sblock = 1;
+                                    sbirr, cbirr, S.Ms0_, SD);
+                        did_sblock[sblock] = 1;
                     }
 
                     if (C.buf_offdiag_[cbuf]) {
-                        cblock2 = C.decode_[cbc][cac];
+                        int cblock2 = C.decode_[cbc][cac];
                         if ((s1_contrib_[sblock][cblock2] || s2_contrib_[sblock][cblock2] ||
                              s3_contrib_[sblock][cblock2]) &&
                             !C.check_zero_block(cblock2)) {
-                            C.transp_block(cblock, SigmaData_->transp_tmp);
-                            if (SigmaData_->cprime != nullptr) set_row_ptrs(cnbs, cnas, SigmaData_->cprime);
-                            sigma_block(alplist, betlist, SigmaData_->transp_tmp, S.blocks_[sblock], oei, tei, fci,
-                                        cblock2, sblock, nas, nbs, sac, sbc, cbc, cac, cnbs, cnas, C.num_alpcodes_,
-                                        C.num_betcodes_, sbirr, cairr, S.Ms0_);
-                            did_sblock = 1;
+                            C.transp_block(cblock, SD->transp_tmp);
+                            if (SD->cprime != nullptr) set_row_ptrs(cnbs, cnas, SD->cprime);
+                            sigma_block(alplist, betlist, SD->transp_tmp, S.blocks_[sblock], oei, tei, fci, cblock2,
+                                        sblock, nas, nbs, sac, sbc, cbc, cac, cnbs, cnas, C.num_alpcodes_,
+                                        C.num_betcodes_, sbirr, cairr, S.Ms0_, SD);
+                            did_sblock[sblock] = 1;
                         }
                     }
                 } /* end loop over C blocks in this irrep */
-
-                if (did_sblock) S.set_zero_block(sblock, 0);
             } /* end loop over sblock */
 
         } /* end loop over cbuf */
 
+        /* each rank formed only its own blocks of this irrep */
+        if (dist_.distributed()) {
+            dist_.sum(S.buffer_, S.buf_size_[buf]);
+            dist_.sum(did_sblock.data(), did_sblock.size());
+        }
+        for (sblock = S.first_ablk_[sairr]; sblock <= S.last_ablk_[sairr]; sblock++) {
+            if (did_sblock[sblock]) S.set_zero_block(sblock, 0);
+        }
+
         /* transpose the diagonal sigma subblocks in this irrep */
         for (sblock = S.first_ablk_[sairr]; sblock <= S.last_ablk_[sairr]; sblock++) {
             sac = S.Ia_code_[sblock];
@@ -612,23 +939,29 @@ void CIWavefunction::sigma_c(struct stringwr **alplist, struct stringwr **betlis
 void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **betlist, double **cmat, double **smat,
                                  double *oei, double *tei, int fci, int cblock, int sblock, int nas, int nbs, int sac,
                                  int sbc, int cac, int cbc, int cnas, int cnbs, int cnac, int cnbc, int sbirr,
-                                 int cbirr, int Ms0) {
+                                 int cbirr, int Ms0, struct sigma_data *SD) {
+    /* libqt timers are not thread-safe; only time the serial path */
+    bool timed = true;
+#ifdef _OPENMP
+    timed = !omp_in_parallel();
+#endif
+
     /* SIGMA2 CONTRIBUTION */
     if (s2_contrib_[sblock][cblock]) {
-        timer_on("CIWave: s2");
+        if (timed) timer_on("CIWave: s2");
 
         if (fci) {
-            s2_block_vfci(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
+            s2_block_vfci(alplist, betlist, cmat, smat, oei, tei, SD->F, cnac, nas, nbs, sac, cac, cnas);
         } else {
             if (Parameters_->repl_otf) {
-                s2_block_vras_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Joij, SigmaData_->Jridx,
-                                   SigmaData_->Jsgn, SigmaData_->Toccs, cmat, smat, oei, tei, SigmaData_->F, cnac, nas,
+                s2_block_vras_rotf(SD->Jcnt, SD->Jij, SD->Joij, SD->Jridx,
+                                   SD->Jsgn, SD->Toccs, cmat, smat, oei, tei, SD->F, cnac, nas,
                                    nbs, sac, cac, cnas, AlphaG_, BetaG_, CalcInfo_, Occs_);
             } else {
-                s2_block_vras(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnac, nas, nbs, sac, cac, cnas);
+                s2_block_vras(alplist, betlist, cmat, smat, oei, tei, SD->F, cnac, nas, nbs, sac, cac, cnas);
             }
         }
-        timer_off("CIWave: s2");
+        if (timed) timer_off("CIWave: s2");
 
     } /* end sigma2 */
 
@@ -639,24 +972,24 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
 
     /* SIGMA1 CONTRIBUTION */
     if (!Ms0 || (sac != sbc)) {
-        timer_on("CIWave: s1");
+        if (timed) timer_on("CIWave: s1");
 
         if (s1_contrib_[sblock][cblock]) {
             if (fci) {
-                s1_block_vfci(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnbc, nas, nbs, sbc, cbc, cnbs);
+                s1_block_vfci(alplist, betlist, cmat, smat, oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc, cnbs);
             } else {
                 if (Parameters_->repl_otf) {
-                    s1_block_vras_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Joij, SigmaData_->Jridx,
-                                       SigmaData_->Jsgn, SigmaData_->Toccs, cmat, smat, oei, tei, SigmaData_->F, cnbc,
+                    s1_block_vras_rotf(SD->Jcnt, SD->Jij, SD->Joij, SD->Jridx,
+                                       SD->Jsgn, SD->Toccs, cmat, smat, oei, tei, SD->F, cnbc,
                                        nas, nbs, sbc, cbc, cnbs, BetaG_, CalcInfo_, Occs_);
                 } else {
-                    s1_block_vras(alplist, betlist, cmat, smat, oei, tei, SigmaData_->F, cnbc, nas, nbs, sbc, cbc,
+                    s1_block_vras(alplist, betlist, cmat, smat, oei, tei, SD->F, cnbc, nas, nbs, sbc, cbc,
                                   cnbs);
                 }
             }
         }
 
-        timer_off("CIWave: s1");
+        if (timed) timer_off("CIWave: s1");
     } /* end sigma1 */
 
     if (print_ > 3) {
@@ -666,46 +999,50 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
 
     /* SIGMA3 CONTRIBUTION */
     if (s3_contrib_[sblock][cblock]) {
-        timer_on("CIWave: s3");
+        if (timed) timer_on("CIWave: s3");
 
         /* zero_mat(smat, nas, nbs); */
 
         if (!Ms0 || (sac != sbc)) {
             if (Parameters_->repl_otf) {
-                b2brepl(Occs_[sac], SigmaData_->Jcnt[0], SigmaData_->Jij[0], SigmaData_->Joij[0], SigmaData_->Jridx[0],
-                        SigmaData_->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
-                b2brepl(Occs_[sbc], SigmaData_->Jcnt[1], SigmaData_->Jij[1], SigmaData_->Joij[1], SigmaData_->Jridx[1],
-                        SigmaData_->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
-                s3_block_vrotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Jridx, SigmaData_->Jsgn, cmat, smat, tei,
-                               nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SigmaData_->cprime, SigmaData_->F,
-                               SigmaData_->V, SigmaData_->Sgn, SigmaData_->L, SigmaData_->R, CalcInfo_->num_ci_orbs,
+                b2brepl(Occs_[sac], SD->Jcnt[0], SD->Jij[0], SD->Joij[0], SD->Jridx[0],
+                        SD->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
+                b2brepl(Occs_[sbc], SD->Jcnt[1], SD->Jij[1], SD->Joij[1], SD->Jridx[1],
+                        SD->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
+                s3_block_vrotf(SD->Jcnt, SD->Jij, SD->Jridx, SD->Jsgn, cmat, smat, tei,
+                               nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SD->cprime, SD->F,
+                               SD->V, SD->Sgn, SD->L, SD->R, CalcInfo_->num_ci_orbs,
                                CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+            } else if (betlist_ij_ != nullptr) {
+                sigma3_vlist(&cmat, &smat, 1, tei, sac, sbc, cac, cbc, nas, nbs, cnas, sbirr, cbirr, 0, SD);
             } else {
                 s3_block_v(alplist[sac], betlist[sbc], cmat, smat, tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr,
-                           SigmaData_->cprime, SigmaData_->F, SigmaData_->V, SigmaData_->Sgn, SigmaData_->L,
-                           SigmaData_->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+                           SD->cprime, SD->F, SD->V, SD->Sgn, SD->L,
+                           SD->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
             }
         }
 
         else if (Parameters_->bendazzoli) {
-            s3_block_bz(sac, sbc, cac, cbc, nas, nbs, cnas, tei, cmat, smat, SigmaData_->cprime, SigmaData_->sprime,
+            s3_block_bz(sac, sbc, cac, cbc, nas, nbs, cnas, tei, cmat, smat, SD->cprime, SD->sprime,
                         CalcInfo_, OV_);
         }
 
         else {
             if (Parameters_->repl_otf) {
-                b2brepl(Occs_[sac], SigmaData_->Jcnt[0], SigmaData_->Jij[0], SigmaData_->Joij[0], SigmaData_->Jridx[0],
-                        SigmaData_->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
-                b2brepl(Occs_[sbc], SigmaData_->Jcnt[1], SigmaData_->Jij[1], SigmaData_->Joij[1], SigmaData_->Jridx[1],
-                        SigmaData_->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
-                s3_block_vdiag_rotf(SigmaData_->Jcnt, SigmaData_->Jij, SigmaData_->Jridx, SigmaData_->Jsgn, cmat, smat,
-                                    tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SigmaData_->cprime, SigmaData_->F,
-                                    SigmaData_->V, SigmaData_->Sgn, SigmaData_->L, SigmaData_->R,
+                b2brepl(Occs_[sac], SD->Jcnt[0], SD->Jij[0], SD->Joij[0], SD->Jridx[0],
+                        SD->Jsgn[0], AlphaG_, sac, cac, nas, CalcInfo_);
+                b2brepl(Occs_[sbc], SD->Jcnt[1], SD->Jij[1], SD->Joij[1], SD->Jridx[1],
+                        SD->Jsgn[1], BetaG_, sbc, cbc, nbs, CalcInfo_);
+                s3_block_vdiag_rotf(SD->Jcnt, SD->Jij, SD->Jridx, SD->Jsgn, cmat, smat,
+                                    tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr, SD->cprime, SD->F,
+                                    SD->V, SD->Sgn, SD->L, SD->R,
                                     CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+            } else if (betlist_ij_ != nullptr) {
+                sigma3_vlist(&cmat, &smat, 1, tei, sac, sbc, cac, cbc, nas, nbs, cnas, sbirr, cbirr, 1, SD);
             } else {
                 s3_block_vdiag(alplist[sac], betlist[sbc], cmat, smat, tei, nas, nbs, cnas, sbc, cac, cbc, sbirr, cbirr,
-                               SigmaData_->cprime, SigmaData_->F, SigmaData_->V, SigmaData_->Sgn, SigmaData_->L,
-                               SigmaData_->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
+                               SD->cprime, SD->F, SD->V, SD->Sgn, SD->L,
+                               SD->R, CalcInfo_->num_ci_orbs, CalcInfo_->orbsym + CalcInfo_->num_drc_orbs);
             }
         }
 
@@ -714,7 +1051,7 @@ void CIWavefunction::sigma_block(struct stringwr **alplist, struct stringwr **be
             print_mat(smat, nas, nbs, "outfile");
         }
 
-        timer_off("CIWave: s3");
+        if (timed) timer_off("CIWave: s3");
 
     } /* end sigma3 */
 }
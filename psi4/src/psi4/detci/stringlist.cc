@@ -39,6 +39,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <vector>
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/wavefunction.h"
@@ -80,6 +81,48 @@ void og_form_repinfo(struct stringwr *string, int num_ci_orbs, struct olsen_grap
 void init_stringwr_temps(int nel, int num_ci_orbs, int nsym);
 void free_stringwr_temps(int nsym);
 
+/*
+** stringlist_ij(): Regroup the single replacements of the string lists in
+**    slist by orbital pair, for each pair of lists (Ilist, Jlist).  The
+**    result for the pair goes to ijlist[Ilist * nlists + Jlist], which must
+**    have room for nlists * nlists entries.
+*/
+void stringlist_ij(struct olsen_graph *Graph, struct stringwr **slist, struct stringwr_ij *ijlist) {
+    int nlists = Graph->nirreps * Graph->subgr_per_irrep;
+    int npairs = Graph->num_orb * (Graph->num_orb + 1) / 2;
+
+    for (int Ilist = 0; Ilist < nlists; Ilist++) {
+        struct stringwr *Istr = slist[Ilist];
+        int nstr = Graph->sg[Ilist / Graph->subgr_per_irrep][Ilist % Graph->subgr_per_irrep].num_strings;
+        if (Istr == nullptr || nstr == 0) continue;
+
+        for (int Jlist = 0; Jlist < nlists; Jlist++) {
+            struct stringwr_ij &list = ijlist[(size_t)Ilist * nlists + Jlist];
+            list.off.assign(npairs + 1, 0);
+
+            /* count the replacements per ij, then fill in string order */
+            for (int I = 0; I < nstr; I++) {
+                for (int ex = 0; ex < Istr[I].cnt[Jlist]; ex++) list.off[Istr[I].ij[Jlist][ex] + 1]++;
+            }
+            for (int ij = 0; ij < npairs; ij++) list.off[ij + 1] += list.off[ij];
+            if (list.off[npairs] == 0) continue;
+
+            list.L.resize(list.off[npairs]);
+            list.R.resize(list.off[npairs]);
+            list.sgn.resize(list.off[npairs]);
+            std::vector<size_t> next(list.off.begin(), list.off.end() - 1);
+            for (int I = 0; I < nstr; I++) {
+                for (int ex = 0; ex < Istr[I].cnt[Jlist]; ex++) {
+                    size_t n = next[Istr[I].ij[Jlist][ex]]++;
+                    list.R[n] = I;
+                    list.L[n] = (int)Istr[I].ridx[Jlist][ex];
+                    list.sgn[n] = Istr[I].sgn[Jlist][ex];
+                }
+            }
+        }
+    }
+}
+
 /*
 ** stringlist():  This function forms the list of strings with their
 **    single replacements using the Olsen Graph structures.
@@ -43,6 +43,7 @@
 #define _psi_src_bin_detci_structs_h
 
 #include <string>
+#include <vector>
 #include "psi4/pragma.h"
 PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
@@ -148,6 +149,24 @@ struct stringwr {
     int *cnt;
 };
 
+/*
+ * STRINGWR_IJ: The single replacements from one string list into another,
+ *    grouped by orbital pair rather than by string.  Built once from the
+ *    stringwr lists so the sigma3 code can look up all E_ij contributions
+ *    directly instead of searching every string for ij.
+ *
+ *    off[ij] .. off[ij+1]-1: the replacements for ij = ioff[i] + j, i >= j.
+ *    R[n]: the string acted on by E_ij (increasing within each ij).
+ *    L[n]: the generated string in the other list.
+ *    sgn[n]: the sign of the replacement (+/- 1).
+ */
+struct stringwr_ij {
+    std::vector<size_t> off;
+    std::vector<int> L;
+    std::vector<int> R;
+    std::vector<signed char> sgn;
+};
+
 struct level {
     int num_j;
     int *a;
@@ -267,7 +286,6 @@ struct H_zero_block {
     double **H0b;               /* H0 block */
     double **H0b_inv;           /* inverse of block (H0 - E) */
     double **H0b_diag;          /* Eigenvectors of H0 block */
-    double *H0b_diag_transpose; /* tmp array for Transpose of Eigenvectors of H0 block */
     double *H0b_eigvals;        /* Eigenvalues of H0 block */
     double *H00;                /* diag elements of H0 block */
     int size;                   /* size of H0 block */
@@ -472,6 +490,7 @@ struct params {
     int hd_ave;                          /* how to average H diag energies over spin coupling
                                             sets */
     int hd_otf;                          /* 1 if diag energies computed on the fly 0 otherwise */
+    int hd_otf_cache;                    /* 1 if on the fly diag energies are kept in core */
     int nodfile;                         /* 1 if no dfile used 0 otherwise works for nroots=1 */
     int nprint;                          /* number of important determinants to print out */
     int cc_nprint;                       /* number of most important CC amps per ex lvl to print */
@@ -536,6 +555,7 @@ struct params {
     int z_scale_H;                       /* 1(0) if pert. scaling used */
     double special_conv;                 /* special convergence value */
     int nthreads;                        /* number of threads to use in sigma routines */
+    int sigma_batch;                     /* max number of C vectors per batched sigma */
     int sf_restrict;                     /* 1 if restrict CI space (CI blocks) to
                                             do only determinants (or their
                                             spin-complements) in RASCI versions of
@@ -642,6 +662,7 @@ struct sigma_data {
     double *V, *Sgn;
     int *L, *R;
     int max_dim;
+    std::vector<double> Cgath, Tcoup, Vprod; /* sigma3 gather/coupling/product scratch */
 };
 }
 }  // namespace psi
@@ -45,6 +45,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <algorithm>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -315,11 +316,13 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
 
     // ==> More Sizing <== /
 
-    size_t aaE_size = memory_doubles_ / nvir * nvir * nE;
+    size_t aaE_size = memory_doubles_ / (nvir * nvir * nE);
+    if (aaE_size < 1) aaE_size = 1;
     if (aaE_size > nocc) aaE_size = nocc;
     // aaE_size = 2;
 
-    size_t ooE_size = memory_doubles_ / nocc * nocc * nE;
+    size_t ooE_size = memory_doubles_ / (nocc * nocc * nE);
+    if (ooE_size < 1) ooE_size = 1;
     if (ooE_size > nvir) ooE_size = nvir;
     // ooE_size = 2;
 
@@ -351,16 +354,21 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
     std::vector<std::vector<double>> sigma_temps(num_threads_, std::vector<double>(nE));
     size_t rank = 0;
 
+    // Poles that have not converged yet, converged poles keep their energy and derivative
+    std::vector<size_t> active(nE);
+    for (size_t e = 0; e < nE; e++) active[e] = e;
+
     for (size_t iter = 0; iter < max_iter_; iter++) {
         // Reset data for loop
-        for (size_t i = 0; i < nE; i++) {
-            Esigma[i] = 0.0;
-            Ederiv[i] = 0.0;
-            Eold[i] = Enew[i];
-            for (size_t j = 0; j < num_threads_; j++) {
-                deriv_temps[j][i] = 0.0;
-                sigma_temps[j][i] = 0.0;
-            }
+        size_t nactive = active.size();
+        for (size_t e : active) {
+            Esigma[e] = 0.0;
+            Ederiv[e] = 0.0;
+            Eold[e] = Enew[e];
+        }
+        for (size_t j = 0; j < num_threads_; j++) {
+            std::fill(deriv_temps[j].begin(), deriv_temps[j].end(), 0.0);
+            std::fill(sigma_temps[j].begin(), sigma_temps[j].end(), 0.0);
         }
 
         // => Excitations <= //
@@ -387,7 +395,8 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
                     rank = omp_get_thread_num();
 #endif
                     for (size_t b = 0; b < nvir; b++) {
-                        for (size_t e = 0; e < nE; e++) {
+                        for (size_t ea = 0; ea < nactive; ea++) {
+                            size_t e = active[ea];
                             double Eabi = I_ovvEp[i * nvir + b][a * nE + e];
                             double Ebai = I_ovvEp[i * nvir + a][b * nE + e];
                             double numer = (2.0 * Eabi - Ebai) * Eabi;
@@ -426,7 +435,8 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
                     rank = omp_get_thread_num();
 #endif
                     for (size_t j = 0; j < nocc; j++) {
-                        for (size_t e = 0; e < nE; e++) {
+                        for (size_t ea = 0; ea < nactive; ea++) {
+                            size_t e = active[ea];
                             double Eija = I_vooEp[a * nocc + j][i * nE + e];
                             double Ejia = I_vooEp[a * nocc + i][j * nE + e];
                             double numer = (2.0 * Eija - Ejia) * Eija;
@@ -442,49 +452,38 @@ std::vector<std::vector<std::pair<double, double>>> DFEP2Wavefunction::compute(
         I_vooE.reset();
 
         // Sum up thread data
-        for (size_t i = 0; i < nE; i++) {
+        for (size_t e : active) {
             for (size_t j = 0; j < num_threads_; j++) {
-                Ederiv[i] += deriv_temps[j][i];
-                Esigma[i] += sigma_temps[j][i];
+                Ederiv[e] += deriv_temps[j][e];
+                Esigma[e] += sigma_temps[j][e];
             }
         }
 
         // Update
         double max_error = 0.0;
         double mean_error = 0.0;
-        size_t nremain = nE;
-        for (size_t i = 0; i < nE; i++) {
-            // printf("%16.8f  ", Enew[i]);
-
+        for (size_t e : active) {
             // Compute new energy and update
-            Enew[i] = eps_E[i] + Esigma[i];
-            denom_E[i] = Eold[i] - ((Eold[i] - Enew[i]) / (1 + Ederiv[i]));
+            Enew[e] = eps_E[e] + Esigma[e];
+            denom_E[e] = Eold[e] - ((Eold[e] - Enew[e]) / (1 + Ederiv[e]));
 
             // Compute stats
-            Eerror[i] = std::fabs(Enew[i] - Eold[i]);
-            mean_error += Eerror[i];
-            if (Eerror[i] < conv_thresh_) {
-                nremain--;
-            }
-            if (Eerror[i] > max_error) {
-                max_error = Eerror[i];
+            Eerror[e] = std::fabs(Enew[e] - Eold[e]);
+            mean_error += Eerror[e];
+            if (Eerror[e] > max_error) {
+                max_error = Eerror[e];
             }
         }
-        mean_error /= (double)nE;
-        // printf("\n");
+        mean_error /= (double)nactive;
 
-        outfile->Printf("    %3zu %14.8f %14.8f   %4zu\n", (iter + 1), mean_error, max_error, nremain);
+        // Converged poles drop out of the next pass over the integrals
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](size_t e) { return Eerror[e] < conv_thresh_; }),
+                     active.end());
 
-        if (max_error < conv_thresh_) break;
+        outfile->Printf("    %3zu %14.8f %14.8f   %4zu\n", (iter + 1), mean_error, max_error, active.size());
 
-        for (size_t i = 0; i < nE; i++) {
-            // printf("%8.2f %8.2f |  ", Esigma[i], Ederiv[i]);
-            // Reset E's
-            Eold[i] = Enew[i];
-            Esigma[i] = 0.0;
-            Ederiv[i] = 0.0;
-        }
-        // printf("\n");
+        if (active.empty()) break;
     }
     outfile->Printf("   --------------------------------------------\n\n");
     psio->close(unit_, 0);
@@ -635,6 +635,8 @@ void DFCorrGrad::build_AB_x_terms() {
 
 #pragma omp parallel for schedule(dynamic) num_threads(df_ints_num_threads_)
     for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+        if (!dist_.owns(PQ)) continue;
+
         int P = PQ_pairs[PQ].first;
         int Q = PQ_pairs[PQ].second;
 
@@ -709,6 +711,8 @@ void DFCorrGrad::build_AB_x_terms() {
         gradients_["Coulomb"]->add(Jtemps[t]);
         gradients_["Exchange"]->add(Ktemps[t]);
     }
+    dist_.sum(gradients_["Coulomb"]->pointer()[0], 3L * natom);
+    dist_.sum(gradients_["Exchange"]->pointer()[0], 3L * natom);
 
     // gradients_["Coulomb"]->print();
     // gradients_["Exchange"]->print();
@@ -843,6 +847,15 @@ void DFCorrGrad::build_Amn_x_terms() {
         int pstop = (Pstop == auxiliary_->nshell() ? naux : auxiliary_->shell(Pstop).function_index());
         int np = pstop - pstart;
 
+        // Other ranks take this block, just step over its stripes
+        if (!dist_.owns(block)) {
+            next_Aila = psio_get_address(next_Aila, sizeof(double) * np * na * la);
+            next_Aira = psio_get_address(next_Aira, sizeof(double) * np * na * ra);
+            next_Ailb = psio_get_address(next_Ailb, sizeof(double) * np * nb * lb);
+            next_Airb = psio_get_address(next_Airb, sizeof(double) * np * nb * rb);
+            continue;
+        }
+
         // => J_mn^A <= //
 
         // > Alpha < //
@@ -1013,6 +1026,8 @@ void DFCorrGrad::build_Amn_x_terms() {
         gradients_["Coulomb"]->add(Jtemps[t]);
         gradients_["Exchange"]->add(Ktemps[t]);
     }
+    dist_.sum(gradients_["Coulomb"]->pointer()[0], 3L * natom);
+    dist_.sum(gradients_["Exchange"]->pointer()[0], 3L * natom);
 
     // gradients_["Coulomb"]->print();
     // gradients_["Exchange"]->print();
@@ -30,6 +30,7 @@
 #define Corr_GRAD_H
 
 #include "psi4/libmints/typedefs.h"
+#include "dist.h"
 #include <map>
 
 namespace psi {
@@ -54,6 +55,8 @@ class CorrGrad {
     int nthreads_;
     /// Integral cutoff (defaults to 0.0)
     double cutoff_;
+    /// Split of the shell-pair and auxiliary-block loops over MPI ranks
+    DistTasks dist_;
 
     std::shared_ptr<BasisSet> primary_;
 
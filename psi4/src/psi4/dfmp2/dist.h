@@ -0,0 +1,70 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef DFMP2_DIST_H
+#define DFMP2_DIST_H
+
+#include <cstddef>
+
+namespace psi {
+namespace dfmp2 {
+
+/**
+ * Work distribution of the DF-MP2 block loops over the ranks of
+ * MPI_COMM_WORLD. Every rank runs the same input and holds its own
+ * copy of the (Q|ia) files; the block (pair) loops skip the tasks
+ * they do not own and the partial results are summed afterwards.
+ * Without ENABLE_MPI, or with a single rank, everything is a no-op.
+ */
+class DistTasks {
+   protected:
+    int rank_;
+    int nrank_;
+
+   public:
+    DistTasks();
+
+    int rank() const { return rank_; }
+    int nrank() const { return nrank_; }
+    /// Is there more than one rank?
+    bool distributed() const { return nrank_ > 1; }
+    /// Round-robin ownership of task index task
+    bool owns(size_t task) const { return (int)(task % nrank_) == rank_; }
+    /// Rank owning task index task
+    int owner(size_t task) const { return (int)(task % nrank_); }
+
+    /// Sum buffer[0:n] over all ranks, in place
+    void sum(double* buffer, size_t n) const;
+    /// Copy buffer[0:n] from rank root to all ranks
+    void broadcast(double* buffer, size_t n, int root) const;
+};
+
+}  // namespace dfmp2
+}  // namespace psi
+
+#endif
@@ -0,0 +1,761 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "f12.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "psi4/lib3index/3index.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/integralparameters.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/blas_backend.h"
+#include "psi4/libqt/qt.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+namespace dfmp2 {
+
+namespace {
+
+// sum_xy A_xy B_yx
+double transpose_dot(int n, double** A, double** B) {
+    double value = 0.0;
+    for (int x = 0; x < n; x++) value += C_DDOT(n, A[x], 1, &B[0][x], n);
+    return value;
+}
+
+// Robustly fitted (xy|O|zw) = c^xy (A|O|zw) + [(xy|O|A) - c^xy (A|O|B)] c^zw, with pair-major [xy][A] rows
+double robust_fit(int naux, double** cL, double** HL, double** cR, double** TR, int xy, int zw) {
+    return C_DDOT(naux, cL[xy], 1, TR[zw], 1) + C_DDOT(naux, HL[xy], 1, cR[zw], 1);
+}
+
+}  // namespace
+
+RDFMP2F12::RDFMP2F12(SharedWavefunction ref_wfn, Options& options) : Wavefunction(options) {
+    shallow_copy(ref_wfn);
+    reference_wavefunction_ = ref_wfn;
+
+    common_init();
+}
+RDFMP2F12::~RDFMP2F12() {}
+void RDFMP2F12::common_init() {
+    print_ = options_.get_int("PRINT");
+    debug_ = options_.get_int("DEBUG");
+    name_ = "DF-MP2-F12";
+
+    if (frzvpi_.sum() != 0) throw PSIEXCEPTION("DF-MP2-F12: frozen virtuals are not supported.");
+
+    ribasis_ = get_basisset("DF_BASIS_MP2");
+    cabsbasis_ = get_basisset("CABS_BASIS");
+
+    beta_ = options_.get_double("F12_BETA");
+    cf_ = std::make_shared<FittedSlaterCorrelationFactor>(beta_);
+
+    nthread_ = 1;
+#ifdef _OPENMP
+    nthread_ = Process::environment.get_n_threads();
+#endif
+
+    Cocc_ = Ca_subset("AO", "OCC");
+    Caocc_ = Ca_subset("AO", "ACTIVE_OCC");
+    nocc_ = Cocc_->colspi()[0];
+    naocc_ = Caocc_->colspi()[0];
+    nfocc_ = nocc_ - naocc_;
+    if (naocc_ == 0) throw PSIEXCEPTION("DF-MP2-F12: there are no active occupied orbitals.");
+
+    SharedVector eps_occ = epsilon_a_subset("AO", "OCC");
+    SharedVector eps_vir = epsilon_a_subset("AO", "VIR");
+    nvir_ = eps_vir->dimpi()[0];
+    nobs_ = nocc_ + nvir_;
+    naux_ = ribasis_->nbf();
+
+    eps_obs_ = std::make_shared<Vector>("Orbital Energies", nobs_);
+    for (int p = 0; p < nocc_; p++) eps_obs_->set(p, eps_occ->get(p));
+    for (int a = 0; a < nvir_; a++) eps_obs_->set(nocc_ + a, eps_vir->get(a));
+
+    variables_["SCF TOTAL ENERGY"] = reference_wavefunction_->reference_energy();
+}
+void RDFMP2F12::print_header() {
+    outfile->Printf("\t --------------------------------------------------------\n");
+    outfile->Printf("\t                        DF-MP2-F12                       \n");
+    outfile->Printf("\t  Explicitly Correlated Density-Fitted MP2, 3C(FIX) Ansatz\n");
+    outfile->Printf("\t              RMP2 Wavefunction, %3d Threads             \n", nthread_);
+    outfile->Printf("\t --------------------------------------------------------\n");
+    outfile->Printf("\n");
+
+    if (print_ >= 1) {
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        ribasis_->print_by_level("outfile", print_);
+        outfile->Printf("   => CABS Basis Set <=\n\n");
+        cabsbasis_->print_by_level("outfile", print_);
+    }
+
+    outfile->Printf("\t --------------------------------------------------------\n");
+    outfile->Printf("\t     NBF = %5d, NCABS = %5d, NAUX = %5d\n", basisset_->nbf(), cabsbasis_->nbf(), naux_);
+    outfile->Printf("\t     F12 Exponent = %8.4f\n", beta_);
+    outfile->Printf("\t --------------------------------------------------------\n");
+    outfile->Printf("\t %7s %7s %7s %7s %7s\n", "CLASS", "FOCC", "OCC", "AOCC", "VIR");
+    outfile->Printf("\t %7s %7d %7d %7d %7d\n", "PAIRS", nfocc_, nocc_, naocc_, nvir_);
+    outfile->Printf("\t --------------------------------------------------------\n\n");
+}
+void RDFMP2F12::form_cabs() {
+    int nbf = basisset_->nbf();
+    int nstack = nbf + cabsbasis_->nbf();
+
+    // Overlap and core Hamiltonian over the stacked [orbital ; CABS] basis, one basis pair at a time
+    S_ao_ = std::make_shared<Matrix>("S (Stacked AO)", nstack, nstack);
+    H_ao_ = std::make_shared<Matrix>("H (Stacked AO)", nstack, nstack);
+    double** Sp = S_ao_->pointer();
+    double** Hp = H_ao_->pointer();
+    std::vector<std::shared_ptr<BasisSet> > bases = {basisset_, cabsbasis_};
+    std::vector<int> offsets = {0, nbf};
+    for (int b1 = 0; b1 < 2; b1++) {
+        for (int b2 = b1; b2 < 2; b2++) {
+            IntegralFactory factory(bases[b1], bases[b2], bases[b1], bases[b2]);
+            int n1 = bases[b1]->nbf();
+            int n2 = bases[b2]->nbf();
+            auto S = std::make_shared<Matrix>("S", n1, n2);
+            auto T = std::make_shared<Matrix>("T", n1, n2);
+            auto V = std::make_shared<Matrix>("V", n1, n2);
+            std::unique_ptr<OneBodyAOInt> Sint(factory.ao_overlap());
+            std::unique_ptr<OneBodyAOInt> Tint(factory.ao_kinetic());
+            std::unique_ptr<OneBodyAOInt> Vint(factory.ao_potential());
+            Sint->compute(S);
+            Tint->compute(T);
+            Vint->compute(V);
+            T->add(V);
+            double** S12p = S->pointer();
+            double** H12p = T->pointer();
+            for (int m = 0; m < n1; m++) {
+                for (int n = 0; n < n2; n++) {
+                    Sp[offsets[b1] + m][offsets[b2] + n] = Sp[offsets[b2] + n][offsets[b1] + m] = S12p[m][n];
+                    Hp[offsets[b1] + m][offsets[b2] + n] = Hp[offsets[b2] + n][offsets[b1] + m] = H12p[m][n];
+                }
+            }
+        }
+    }
+
+    // Orthonormal span of the union, then project the MOs out of it
+    SharedMatrix X = S_ao_->canonical_orthogonalization(options_.get_double("CABS_SINGULAR_TOLERANCE"));
+    int nunion = X->colspi()[0];
+    ncabs_ = nunion - nobs_;
+    if (ncabs_ <= 0) throw PSIEXCEPTION("DF-MP2-F12: the CABS basis adds nothing to the orbital basis.");
+
+    auto Cmo = std::make_shared<Matrix>("C (Stacked MO)", nstack, nobs_);
+    SharedMatrix Cocc = Cocc_;
+    SharedMatrix Cvir = Ca_subset("AO", "VIR");
+    for (int m = 0; m < nbf; m++) {
+        for (int p = 0; p < nocc_; p++) Cmo->set(m, p, Cocc->get(m, p));
+        for (int a = 0; a < nvir_; a++) Cmo->set(m, nocc_ + a, Cvir->get(m, a));
+    }
+
+    // The MOs span the unit eigenvalues of W^T W with W = C^T S X; the CABS are the null space
+    SharedMatrix W = Matrix::triplet(Cmo, S_ao_, X, true, false, false);
+    SharedMatrix WW = Matrix::doublet(W, W, true, false);
+    auto U = std::make_shared<Matrix>("U", nunion, nunion);
+    auto w = std::make_shared<Vector>("w", nunion);
+    WW->diagonalize(U, w, ascending);
+    if (w->get(ncabs_ - 1) > 1.0E-6 || w->get(ncabs_) < 1.0 - 1.0E-6) {
+        outfile->Printf("    Warning: the orbital basis is not spanned by the RI space (w = %11.3E, %11.3E).\n\n",
+                        w->get(ncabs_ - 1), w->get(ncabs_));
+    }
+    nri_ = nobs_ + ncabs_;
+
+    Cri_ = std::make_shared<Matrix>("C (RI)", nstack, nri_);
+    double** Crip = Cri_->pointer();
+    double** Cmop = Cmo->pointer();
+    double** Xp = X->pointer();
+    double** Up = U->pointer();
+    for (int m = 0; m < nstack; m++) {
+        for (int p = 0; p < nobs_; p++) Crip[m][p] = Cmop[m][p];
+    }
+    C_DGEMM('N', 'N', nstack, ncabs_, nunion, 1.0, Xp[0], nunion, Up[0], nunion, 0.0, &Crip[0][nobs_], nri_);
+
+    outfile->Printf("\t  %d RI functions, %d CABS orbitals (%d linear dependencies removed)\n\n", nunion, ncabs_,
+                    nstack - nunion);
+}
+TwoBodyAOInt* RDFMP2F12::build_ints(IntegralFactory& factory, Kernel kernel) const {
+    switch (kernel) {
+        case Kernel::ERI:
+            return factory.eri();
+        case Kernel::F12:
+            return factory.f12_scaled(cf_);
+        case Kernel::F12Squared:
+            return factory.f12_squared(cf_);
+        case Kernel::F12G12:
+            return factory.f12g12(cf_);
+        case Kernel::DoubleCommutator:
+            return factory.f12_double_commutator(cf_);
+    }
+    throw PSIEXCEPTION("DF-MP2-F12: unknown integral kernel.");
+}
+double RDFMP2F12::kernel_scale(Kernel kernel) const {
+    // The fitted geminal is -exp(-beta r12); F12Scaled already carries the 1/beta.
+    // F12DoubleCommutator is |grad_1 f12|^2, i.e. half of [f12, [T1 + T2, f12]].
+    switch (kernel) {
+        case Kernel::F12G12:
+            return 1.0 / beta_;
+        case Kernel::F12Squared:
+        case Kernel::DoubleCommutator:
+            return 1.0 / (beta_ * beta_);
+        default:
+            return 1.0;
+    }
+}
+SharedMatrix RDFMP2F12::form_Alr(Kernel kernel, SharedMatrix Cl, SharedMatrix Cr) {
+    int nbf = basisset_->nbf();
+    int nstack = nbf + cabsbasis_->nbf();
+    int nl = Cl->colspi()[0];
+    int nr = Cr->colspi()[0];
+    int maxQ = ribasis_->max_function_per_shell();
+    double scale = kernel_scale(kernel);
+
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    IntegralFactory obs_factory(ribasis_, zero, basisset_, basisset_);
+    IntegralFactory cabs_factory(ribasis_, zero, basisset_, cabsbasis_);
+    std::vector<std::shared_ptr<TwoBodyAOInt> > obs_ints;
+    std::vector<std::shared_ptr<TwoBodyAOInt> > cabs_ints;
+    std::vector<SharedMatrix> Amn;
+    std::vector<SharedMatrix> Aln;
+    for (int thread = 0; thread < nthread_; thread++) {
+        obs_ints.push_back(std::shared_ptr<TwoBodyAOInt>(build_ints(obs_factory, kernel)));
+        cabs_ints.push_back(std::shared_ptr<TwoBodyAOInt>(build_ints(cabs_factory, kernel)));
+        Amn.push_back(std::make_shared<Matrix>("(A|mn) Block", maxQ * nbf, nstack));
+        Aln.push_back(std::make_shared<Matrix>("(A|ln) Block", nl, nstack));
+    }
+
+    auto Alr = std::make_shared<Matrix>("(A|lr)", naux_, nl * (size_t)nr);
+    double** Alrp = Alr->pointer();
+    double** Clp = Cl->pointer();
+    double** Crp = Cr->pointer();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int Q = 0; Q < ribasis_->nshell(); Q++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        blas::ThreadScope blas_threads(1, "DF-MP2-F12");
+
+        int nq = ribasis_->shell(Q).nfunction();
+        int sq = ribasis_->shell(Q).function_index();
+        double** Amnp = Amn[thread]->pointer();
+        double** Alnp = Aln[thread]->pointer();
+
+        for (int M = 0; M < basisset_->nshell(); M++) {
+            int nm = basisset_->shell(M).nfunction();
+            int sm = basisset_->shell(M).function_index();
+            for (int N = 0; N < basisset_->nshell(); N++) {
+                int nn = basisset_->shell(N).nfunction();
+                int sn = basisset_->shell(N).function_index();
+                obs_ints[thread]->compute_shell(Q, 0, M, N);
+                const double* buffer = obs_ints[thread]->buffer();
+                for (int oq = 0; oq < nq; oq++) {
+                    for (int om = 0; om < nm; om++) {
+                        for (int on = 0; on < nn; on++) {
+                            Amnp[oq * nbf + sm + om][sn + on] = buffer[(oq * nm + om) * nn + on];
+                        }
+                    }
+                }
+            }
+            for (int N = 0; N < cabsbasis_->nshell(); N++) {
+                int nn = cabsbasis_->shell(N).nfunction();
+                int sn = nbf + cabsbasis_->shell(N).function_index();
+                cabs_ints[thread]->compute_shell(Q, 0, M, N);
+                const double* buffer = cabs_ints[thread]->buffer();
+                for (int oq = 0; oq < nq; oq++) {
+                    for (int om = 0; om < nm; om++) {
+                        for (int on = 0; on < nn; on++) {
+                            Amnp[oq * nbf + sm + om][sn + on] = buffer[(oq * nm + om) * nn + on];
+                        }
+                    }
+                }
+            }
+        }
+
+        // (A|lr) = C_ml (A|mn) C_nr
+        for (int oq = 0; oq < nq; oq++) {
+            C_DGEMM('T', 'N', nl, nstack, nbf, 1.0, Clp[0], nl, Amnp[oq * nbf], nstack, 0.0, Alnp[0], nstack);
+            C_DGEMM('N', 'N', nl, nr, nstack, scale, Alnp[0], nstack, Crp[0], nr, 0.0, Alrp[sq + oq], nr);
+        }
+    }
+
+    return Alr;
+}
+SharedMatrix RDFMP2F12::form_AB(Kernel kernel) {
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    IntegralFactory factory(ribasis_, zero, ribasis_, zero);
+    std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+    for (int thread = 0; thread < nthread_; thread++) {
+        ints.push_back(std::shared_ptr<TwoBodyAOInt>(build_ints(factory, kernel)));
+    }
+    double scale = kernel_scale(kernel);
+
+    auto AB = std::make_shared<Matrix>("(A|B)", naux_, naux_);
+    double** ABp = AB->pointer();
+    int nshell = ribasis_->nshell();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int P = 0; P < nshell; P++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int np = ribasis_->shell(P).nfunction();
+        int sp = ribasis_->shell(P).function_index();
+        for (int Q = 0; Q <= P; Q++) {
+            int nq = ribasis_->shell(Q).nfunction();
+            int sq = ribasis_->shell(Q).function_index();
+            ints[thread]->compute_shell(P, 0, Q, 0);
+            const double* buffer = ints[thread]->buffer();
+            for (int op = 0; op < np; op++) {
+                for (int oq = 0; oq < nq; oq++) {
+                    ABp[sp + op][sq + oq] = ABp[sq + oq][sp + op] = scale * buffer[op * nq + oq];
+                }
+            }
+        }
+    }
+
+    return AB;
+}
+SharedMatrix RDFMP2F12::form_J(const std::vector<double>& d) {
+    int nbf = basisset_->nbf();
+    int nstack = nbf + cabsbasis_->nbf();
+
+    // Shell pairs of the stacked basis: (orbital, orbital), (orbital, CABS) and (CABS, CABS)
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    std::vector<std::shared_ptr<BasisSet> > bases = {basisset_, cabsbasis_};
+    std::vector<int> offsets = {0, nbf};
+    std::vector<std::pair<int, int> > blocks = {{0, 0}, {0, 1}, {1, 1}};
+
+    std::vector<SharedMatrix> J;
+    for (int thread = 0; thread < nthread_; thread++) {
+        J.push_back(std::make_shared<Matrix>("J (Stacked AO)", nstack, nstack));
+    }
+
+    for (const auto& block : blocks) {
+        std::shared_ptr<BasisSet> bs1 = bases[block.first];
+        std::shared_ptr<BasisSet> bs2 = bases[block.second];
+        int off1 = offsets[block.first];
+        int off2 = offsets[block.second];
+        IntegralFactory factory(ribasis_, zero, bs1, bs2);
+        std::vector<std::shared_ptr<TwoBodyAOInt> > eri;
+        for (int thread = 0; thread < nthread_; thread++) {
+            eri.push_back(std::shared_ptr<TwoBodyAOInt>(factory.eri()));
+        }
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (int Q = 0; Q < ribasis_->nshell(); Q++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            int nq = ribasis_->shell(Q).nfunction();
+            int sq = ribasis_->shell(Q).function_index();
+            double** Jp = J[thread]->pointer();
+            for (int M = 0; M < bs1->nshell(); M++) {
+                int nm = bs1->shell(M).nfunction();
+                int sm = off1 + bs1->shell(M).function_index();
+                for (int N = 0; N < bs2->nshell(); N++) {
+                    int nn = bs2->shell(N).nfunction();
+                    int sn = off2 + bs2->shell(N).function_index();
+                    eri[thread]->compute_shell(Q, 0, M, N);
+                    const double* buffer = eri[thread]->buffer();
+                    for (int om = 0; om < nm; om++) {
+                        for (int on = 0; on < nn; on++) {
+                            double value = 0.0;
+                            for (int oq = 0; oq < nq; oq++) value += d[sq + oq] * buffer[(oq * nm + om) * nn + on];
+                            Jp[sm + om][sn + on] += value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Only the upper (orbital, CABS) block was built
+    for (int thread = 1; thread < nthread_; thread++) J[0]->add(J[thread]);
+    double** Jp = J[0]->pointer();
+    for (int m = 0; m < nbf; m++) {
+        for (int n = nbf; n < nstack; n++) Jp[n][m] = Jp[m][n];
+    }
+
+    return J[0];
+}
+void RDFMP2F12::form_fock(SharedMatrix Amp, SharedMatrix Cmp) {
+    double** Ampp = Amp->pointer();
+    double** Cmpp = Cmp->pointer();
+
+    // Coulomb: d_A = (A|B)^-1 sum_m (B|mm)
+    std::vector<double> g(naux_, 0.0);
+    for (int A = 0; A < naux_; A++) {
+        for (int m = 0; m < nocc_; m++) g[A] += Ampp[A][m * (size_t)nri_ + m];
+    }
+    std::vector<double> d(naux_);
+    C_DGEMV('N', naux_, naux_, 1.0, Jinv_->pointer()[0], naux_, g.data(), 1, 0.0, d.data(), 1);
+
+    SharedMatrix hJ = form_J(d);
+    hJ->scale(2.0);
+    hJ->add(H_ao_);
+    hJ_ = Matrix::triplet(Cri_, hJ, Cri_, true, false, false);
+    hJ_->set_name("h + 2J (RI)");
+
+    // Exchange: K_P'Q' = sum_mA c^mP'_A (A|mQ'), one GEMM over the (A, m) rows
+    K_ = std::make_shared<Matrix>("K (RI)", nri_, nri_);
+    C_DGEMM('T', 'N', nri_, nri_, naux_ * (size_t)nocc_, 1.0, Cmpp[0], nri_, Ampp[0], nri_, 0.0,
+            K_->pointer()[0], nri_);
+
+    fock_ = hJ_->clone();
+    fock_->subtract(K_);
+    fock_->set_name("Fock (RI)");
+
+    // The MO block is the reference's, canonical by construction; only the CABS couplings are fitted
+    double** fp = fock_->pointer();
+    for (int p = 0; p < nobs_; p++) {
+        for (int q = 0; q < nobs_; q++) fp[p][q] = (p == q ? eps_obs_->get(p) : 0.0);
+    }
+}
+double RDFMP2F12::form_cabs_singles() {
+    // Canonicalize the virtual + CABS block and apply first-order perturbation theory to f_iX
+    int nx = nri_ - nocc_;
+    auto fxx = std::make_shared<Matrix>("F (Virtual + CABS)", nx, nx);
+    auto fix = std::make_shared<Matrix>("F (Occupied, Virtual + CABS)", nocc_, nx);
+    double** fp = fock_->pointer();
+    for (int x = 0; x < nx; x++) {
+        for (int y = 0; y < nx; y++) fxx->set(x, y, fp[nocc_ + x][nocc_ + y]);
+    }
+    for (int i = 0; i < nocc_; i++) {
+        for (int x = 0; x < nx; x++) fix->set(i, x, fp[i][nocc_ + x]);
+    }
+    auto U = std::make_shared<Matrix>("U", nx, nx);
+    auto e = std::make_shared<Vector>("e", nx);
+    fxx->diagonalize(U, e, ascending);
+    SharedMatrix fit = Matrix::doublet(fix, U);
+
+    double energy = 0.0;
+    for (int i = 0; i < nocc_; i++) {
+        for (int x = 0; x < nx; x++) {
+            double value = fit->get(i, x);
+            energy += 2.0 * value * value / (eps_obs_->get(i) - e->get(x));
+        }
+    }
+    return energy;
+}
+double RDFMP2F12::compute_energy() {
+    print_header();
+
+    timer_on("DFMP2F12 CABS");
+    form_cabs();
+    timer_off("DFMP2F12 CABS");
+
+    timer_on("DFMP2F12 Metric");
+    auto metric = std::make_shared<FittingMetric>(ribasis_, true);
+    metric->form_eig_inverse(1.0E-10);
+    SharedMatrix Jm12 = metric->get_metric();
+    Jinv_ = Matrix::doublet(Jm12, Jm12);
+    timer_off("DFMP2F12 Metric");
+
+    // The occupied x RI tensors dominate; each thread adds a handful of RI x RI blocks
+    size_t nri2 = nri_ * (size_t)nri_;
+    size_t required = naux_ * (size_t)nri_ * (2 * nocc_ + 2 * naocc_) + 9 * nri2 * nthread_;
+    size_t doubles = memory_ / 8L;
+    if (required > doubles) {
+        outfile->Printf("\t  DF-MP2-F12 needs %zu MiB, but only %zu MiB are available.\n\n", required * 8 / 1048576,
+                        doubles * 8 / 1048576);
+        throw PSIEXCEPTION("DF-MP2-F12: not enough memory for the three-index tensors.");
+    }
+
+    // Coulomb (A|mP') for every occupied orbital and its fit c^mP' = (A|B)^-1 (B|mP')
+    timer_on("DFMP2F12 (A|mP)");
+    SharedMatrix Amp = form_Alr(Kernel::ERI, Cocc_, Cri_);
+    SharedMatrix Cmp = Matrix::doublet(Jinv_, Amp);
+    timer_off("DFMP2F12 (A|mP)");
+
+    timer_on("DFMP2F12 Fock");
+    form_fock(Amp, Cmp);
+    timer_off("DFMP2F12 Fock");
+
+    double e_singles = form_cabs_singles();
+
+    // Active slices of the stacked occupied orbitals, plain and with h + 2J applied
+    auto Caocc_ri = std::make_shared<Matrix>("C (Active Occupied, Stacked)", Cri_->rowspi()[0], naocc_);
+    auto hJocc = std::make_shared<Matrix>("h + 2J (RI, Active Occupied)", nri_, naocc_);
+    for (int P = 0; P < nri_; P++) {
+        for (int i = 0; i < naocc_; i++) hJocc->set(P, i, hJ_->get(P, nfocc_ + i));
+    }
+    for (int m = 0; m < Cri_->rowspi()[0]; m++) {
+        for (int i = 0; i < naocc_; i++) Caocc_ri->set(m, i, Cri_->get(m, nfocc_ + i));
+    }
+    SharedMatrix Ctilde = Matrix::doublet(Cri_, hJocc);
+
+    // f12 (A|f|iP') and (A|f|iP') - (A|f|B) c^iP', over the active occupied orbitals
+    timer_on("DFMP2F12 (A|f|iP)");
+    SharedMatrix Afp = form_Alr(Kernel::F12, Caocc_, Cri_);
+    SharedMatrix Hfp = Afp->clone();
+    {
+        SharedMatrix Wf = form_AB(Kernel::F12);
+        C_DGEMM('N', 'N', naux_, naocc_ * (size_t)nri_, naux_, -1.0, Wf->pointer()[0], naux_,
+                &Cmp->pointer()[0][nfocc_ * (size_t)nri_], nocc_ * (size_t)nri_, 1.0, Hfp->pointer()[0],
+                naocc_ * (size_t)nri_);
+    }
+    timer_off("DFMP2F12 (A|f|iP)");
+
+    // Occupied-pair fits c^xy and c^x~y (~y = (h + 2J) y), pair-major
+    int npair_oo = naocc_ * naocc_;
+    auto c_oo = std::make_shared<Matrix>("c^xy", naux_, npair_oo);
+    auto ct_oo = std::make_shared<Matrix>("c^x~y", naux_, npair_oo);
+    double** Cmpp = Cmp->pointer();
+    for (int x = 0; x < naocc_; x++) {
+        double* cx = &Cmpp[0][(nfocc_ + x) * (size_t)nri_];
+        for (int A = 0; A < naux_; A++) {
+            for (int y = 0; y < naocc_; y++) c_oo->set(A, x * naocc_ + y, cx[A * (size_t)nocc_ * nri_ + nfocc_ + y]);
+        }
+        C_DGEMM('N', 'N', naux_, naocc_, nri_, 1.0, cx, nocc_ * (size_t)nri_, hJocc->pointer()[0], naocc_, 0.0,
+                &ct_oo->pointer()[0][x * naocc_], npair_oo);
+    }
+
+    // Robust fits of the occupied-pair operators, [xy][A]: c and (A|O|xy) - (A|O|B) c
+    timer_on("DFMP2F12 (A|O|xy)");
+    auto pair_major = [&](SharedMatrix T, SharedMatrix c, Kernel kernel, SharedMatrix& Tt, SharedMatrix& Ht) {
+        SharedMatrix H = T->clone();
+        H->gemm(false, false, -1.0, form_AB(kernel), c, 1.0);
+        Tt = T->transpose();
+        Ht = H->transpose();
+    };
+    SharedMatrix c_xy = c_oo->transpose();
+    SharedMatrix ct_xy = ct_oo->transpose();
+    SharedMatrix T2, H2, T2t, H2t, TFG, HFG, TDC, HDC;
+    pair_major(form_Alr(Kernel::F12Squared, Caocc_, Caocc_ri), c_oo, Kernel::F12Squared, T2, H2);
+    pair_major(form_Alr(Kernel::F12Squared, Caocc_, Ctilde), ct_oo, Kernel::F12Squared, T2t, H2t);
+    pair_major(form_Alr(Kernel::F12G12, Caocc_, Caocc_ri), c_oo, Kernel::F12G12, TFG, HFG);
+    pair_major(form_Alr(Kernel::DoubleCommutator, Caocc_, Caocc_ri), c_oo, Kernel::DoubleCommutator, TDC, HDC);
+    timer_off("DFMP2F12 (A|O|xy)");
+
+    // => Pair Energies <= //
+
+    std::vector<std::pair<int, int> > pairs;
+    for (int i = 0; i < naocc_; i++) {
+        for (int j = i; j < naocc_; j++) pairs.push_back(std::make_pair(i, j));
+    }
+    size_t npair = pairs.size();
+    std::vector<double> e_os(npair), e_ss(npair), e_f12(npair);
+
+    // Pairs projected out by Q12 = 1 - P1P2 - O1C2 - C1O2
+    auto in_P = [&](int x, int y) {
+        return (x < nobs_ && y < nobs_) || (x < nocc_ && y >= nobs_) || (x >= nobs_ && y < nocc_);
+    };
+
+    std::vector<std::vector<SharedMatrix> > scratch(nthread_);
+    for (int thread = 0; thread < nthread_; thread++) {
+        for (int k = 0; k < 8; k++) scratch[thread].push_back(std::make_shared<Matrix>("Pair Scratch", nri_, nri_));
+    }
+
+    double** Ampp = Amp->pointer();
+    double** Afpp = Afp->pointer();
+    double** Hfpp = Hfp->pointer();
+    double** fp = fock_->pointer();
+    double** Kp = K_->pointer();
+    size_t ldo = nocc_ * (size_t)nri_;
+    size_t lda = naocc_ * (size_t)nri_;
+    double* eps = eps_obs_->pointer();
+    double** cxy = c_xy->pointer();
+    double** ctxy = ct_xy->pointer();
+
+    timer_on("DFMP2F12 Pairs");
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthread_)
+    for (size_t ij = 0; ij < npair; ij++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        blas::ThreadScope blas_threads(1, "DF-MP2-F12");
+
+        int i = pairs[ij].first;
+        int j = pairs[ij].second;
+        int oi = nfocc_ + i;
+        int oj = nfocc_ + j;
+        double** M = scratch[thread][0]->pointer();
+        double** G = scratch[thread][1]->pointer();
+        double** PM = scratch[thread][2]->pointer();
+        double** FM = scratch[thread][3]->pointer();
+        double** FPM = scratch[thread][4]->pointer();
+        double** KM = scratch[thread][5]->pointer();
+        double** MK = scratch[thread][6]->pointer();
+        double** C = scratch[thread][7]->pointer();
+
+        double* ci = &Cmpp[0][oi * (size_t)nri_];
+        double* cj = &Cmpp[0][oj * (size_t)nri_];
+
+        // F_ij^P'Q' = (iP'|f|jQ') = c^iP' (A|f|jQ') + [(A|f|iP') - (A|f|B) c^iP'] c^jQ'
+        C_DGEMM('T', 'N', nri_, nri_, naux_, 1.0, ci, ldo, &Afpp[0][j * (size_t)nri_], lda, 0.0, M[0], nri_);
+        C_DGEMM('T', 'N', nri_, nri_, naux_, 1.0, &Hfpp[0][i * (size_t)nri_], lda, cj, ldo, 1.0, M[0], nri_);
+        // G_ij^P'Q' = (iP'|jQ')
+        C_DGEMM('T', 'N', nri_, nri_, naux_, 1.0, ci, ldo, &Ampp[0][oj * (size_t)nri_], ldo, 0.0, G[0], nri_);
+
+        for (int x = 0; x < nri_; x++) {
+            for (int y = 0; y < nri_; y++) PM[x][y] = in_P(x, y) ? M[x][y] : 0.0;
+        }
+
+        // Fock operator on either electron: fM + Mf, f(PM) + (PM)f; exchange Kf and fK
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, fp[0], nri_, M[0], nri_, 0.0, FM[0], nri_);
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, M[0], nri_, fp[0], nri_, 1.0, FM[0], nri_);
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, fp[0], nri_, PM[0], nri_, 0.0, FPM[0], nri_);
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, PM[0], nri_, fp[0], nri_, 1.0, FPM[0], nri_);
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, Kp[0], nri_, M[0], nri_, 0.0, KM[0], nri_);
+        C_DGEMM('N', 'N', nri_, nri_, nri_, 1.0, M[0], nri_, Kp[0], nri_, 0.0, MK[0], nri_);
+
+        // Direct (ij|..|ij) and exchange (ij|..|ji) elements of V, X and B
+        int ii = i * naocc_ + i;
+        int jj = j * naocc_ + j;
+        int ij_ = i * naocc_ + j;
+        int ji_ = j * naocc_ + i;
+        double F2_d = robust_fit(naux_, cxy, H2->pointer(), cxy, T2->pointer(), ii, jj);
+        double F2_x = robust_fit(naux_, cxy, H2->pointer(), cxy, T2->pointer(), ij_, ji_);
+        double FG_d = robust_fit(naux_, cxy, HFG->pointer(), cxy, TFG->pointer(), ii, jj);
+        double FG_x = robust_fit(naux_, cxy, HFG->pointer(), cxy, TFG->pointer(), ij_, ji_);
+        double DC_d = robust_fit(naux_, cxy, HDC->pointer(), cxy, TDC->pointer(), ii, jj);
+        double DC_x = robust_fit(naux_, cxy, HDC->pointer(), cxy, TDC->pointer(), ij_, ji_);
+        // 1/2 <kl|f12^2 (h + 2J) + (h + 2J) f12^2|mn> through (x~y|f12^2|zw)
+        double Y_d = robust_fit(naux_, ctxy, H2t->pointer(), cxy, T2->pointer(), ii, jj) +
+                     robust_fit(naux_, ctxy, H2t->pointer(), cxy, T2->pointer(), jj, ii);
+        double Y_x = robust_fit(naux_, ctxy, H2t->pointer(), cxy, T2->pointer(), ij_, ij_) +
+                     robust_fit(naux_, ctxy, H2t->pointer(), cxy, T2->pointer(), ji_, ij_);
+
+        size_t n2 = nri2;
+        double M_PM = C_DDOT(n2, M[0], 1, PM[0], 1);
+        double G_PM = C_DDOT(n2, G[0], 1, PM[0], 1);
+        double PM_FM = C_DDOT(n2, PM[0], 1, FM[0], 1);
+        double PM_FPM = C_DDOT(n2, PM[0], 1, FPM[0], 1);
+        double A_d = DC_d + Y_d - C_DDOT(n2, M[0], 1, KM[0], 1) - C_DDOT(n2, M[0], 1, MK[0], 1);
+        double A_x = DC_x + Y_x - transpose_dot(nri_, M, MK) - transpose_dot(nri_, M, KM);
+
+        double V_d = FG_d - G_PM;
+        double V_x = FG_x - transpose_dot(nri_, G, PM);
+        double X_d = F2_d - M_PM;
+        double X_x = F2_x - transpose_dot(nri_, M, PM);
+        double B_d = A_d - 2.0 * PM_FM + PM_FPM;
+        double B_x = A_x - 2.0 * transpose_dot(nri_, PM, FM) + transpose_dot(nri_, PM, FPM);
+
+        double eij = eps[oi] + eps[oj];
+        double e_geminal = 2.0 * (0.625 * V_d - 0.125 * V_x) + 0.21875 * (B_d - eij * X_d) +
+                           0.03125 * (B_x - eij * X_x);
+
+        // C_ab^ij = [f (Q o F_ij) + (Q o F_ij) f]_ab couples the geminal into the conventional amplitudes
+        for (int x = 0; x < nri_; x++) {
+            for (int y = 0; y < nri_; y++) C[x][y] = FM[x][y] - FPM[x][y];
+        }
+
+        double os = 0.0;
+        double ss = 0.0;
+        double coupled = 0.0;
+        for (int a = nocc_; a < nobs_; a++) {
+            for (int b = nocc_; b < nobs_; b++) {
+                double denom = eps[a] + eps[b] - eij;
+                double Kab = G[a][b];
+                double Kba = G[b][a];
+                double tab = -Kab / denom;
+                double tba = -Kba / denom;
+                os += tab * Kab;
+                ss += (tab - tba) * Kab;
+
+                double Kcab = Kab + 0.375 * C[a][b] + 0.125 * C[b][a];
+                double Kcba = Kba + 0.375 * C[b][a] + 0.125 * C[a][b];
+                coupled += (-2.0 * Kcab + Kcba) / denom * Kcab;
+            }
+        }
+
+        double weight = (i == j ? 1.0 : 2.0);
+        e_os[ij] = weight * os;
+        e_ss[ij] = weight * ss;
+        e_f12[ij] = weight * (coupled - os - ss + e_geminal);
+    }
+    timer_off("DFMP2F12 Pairs");
+
+    double os = 0.0;
+    double ss = 0.0;
+    double f12 = 0.0;
+    for (size_t ij = 0; ij < npair; ij++) {
+        os += e_os[ij];
+        ss += e_ss[ij];
+        f12 += e_f12[ij];
+    }
+
+    variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = os;
+    variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = ss;
+    variables_["MP2 CORRELATION ENERGY"] = os + ss;
+    variables_["MP2 TOTAL ENERGY"] = variables_["SCF TOTAL ENERGY"] + os + ss;
+    variables_["MP2-F12 CABS SINGLES ENERGY"] = e_singles;
+    variables_["MP2-F12 CORRECTION ENERGY"] = f12;
+    variables_["MP2-F12 CORRELATION ENERGY"] = os + ss + f12 + e_singles;
+    variables_["MP2-F12 TOTAL ENERGY"] = variables_["SCF TOTAL ENERGY"] + variables_["MP2-F12 CORRELATION ENERGY"];
+    print_energies();
+    energy_ = variables_["MP2-F12 TOTAL ENERGY"];
+
+    return energy_;
+}
+void RDFMP2F12::print_energies() {
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\t ================> DF-MP2-F12 Energies <================== \n");
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Reference Energy", variables_["SCF TOTAL ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Same-Spin Energy", variables_["MP2 SAME-SPIN CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "Opposite-Spin Energy",
+                    variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "MP2 Correlation Energy", variables_["MP2 CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "MP2 Total Energy", variables_["MP2 TOTAL ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "F12 Doubles Correction", variables_["MP2-F12 CORRECTION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "CABS Singles Correction", variables_["MP2-F12 CABS SINGLES ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "F12 Correlation Energy", variables_["MP2-F12 CORRELATION ENERGY"]);
+    outfile->Printf("\t %-25s = %24.16f [Eh]\n", "F12 Total Energy", variables_["MP2-F12 TOTAL ENERGY"]);
+    outfile->Printf("\t-----------------------------------------------------------\n");
+    outfile->Printf("\n");
+
+    for (const char* key : {"MP2 TOTAL ENERGY", "MP2 CORRELATION ENERGY", "MP2 SAME-SPIN CORRELATION ENERGY",
+                                   "MP2 OPPOSITE-SPIN CORRELATION ENERGY", "MP2-F12 CABS SINGLES ENERGY",
+                                   "MP2-F12 CORRECTION ENERGY", "MP2-F12 CORRELATION ENERGY", "MP2-F12 TOTAL ENERGY"}) {
+        Process::environment.globals[key] = variables_[key];
+    }
+    Process::environment.globals["CURRENT ENERGY"] = variables_["MP2-F12 TOTAL ENERGY"];
+    Process::environment.globals["CURRENT CORRELATION ENERGY"] = variables_["MP2-F12 CORRELATION ENERGY"];
+}
+
+}  // namespace dfmp2
+}  // namespace psi
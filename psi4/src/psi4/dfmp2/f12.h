@@ -0,0 +1,131 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef DFMP2_F12_H
+#define DFMP2_F12_H
+
+#include "psi4/libmints/wavefunction.h"
+
+#include <vector>
+
+namespace psi {
+
+class CorrelationFactor;
+class IntegralFactory;
+class TwoBodyAOInt;
+
+namespace dfmp2 {
+
+/*!
+ * Closed-shell DF-MP2-F12/3C(FIX).
+ *
+ * The geminal is Ten-no's f12 = -exp(-beta r12)/beta with the fixed
+ * (1/2 singlet, 1/4 triplet) amplitudes, B is formed in approximation C and
+ * the conventional amplitudes are relaxed in the presence of the geminal
+ * through the C coupling. The RI space is the union of the orbital and CABS
+ * basis sets; its orbitals are ordered [occupied | virtual | CABS], where the
+ * CABS orbitals are the orthogonal complement of the MOs. Every two-electron
+ * integral is robustly density fitted in DF_BASIS_MP2.
+ *
+ * Only the three-index (A|iP') tensors of the occupied orbitals are held; each
+ * occupied pair builds its own (iP'|jQ') blocks, so the pair loop is threaded
+ * with O(N_RI^2) memory per thread.
+ */
+class RDFMP2F12 : public Wavefunction {
+   protected:
+    enum class Kernel { ERI, F12, F12Squared, F12G12, DoubleCommutator };
+
+    // Auxiliary basis
+    std::shared_ptr<BasisSet> ribasis_;
+    // Complementary auxiliary basis
+    std::shared_ptr<BasisSet> cabsbasis_;
+    // Fitted Slater geminal and its exponent
+    std::shared_ptr<CorrelationFactor> cf_;
+    double beta_;
+
+    int nthread_;
+    int nfocc_;
+    int nocc_;
+    int naocc_;
+    int nvir_;
+    int nobs_;
+    int ncabs_;
+    int nri_;
+    int naux_;
+
+    // Occupied orbitals in the orbital basis (all and active)
+    SharedMatrix Cocc_;
+    SharedMatrix Caocc_;
+    // RI orbitals over the stacked [orbital ; CABS] AO basis
+    SharedMatrix Cri_;
+    // Canonical orbital energies of the occupied and virtual orbitals
+    SharedVector eps_obs_;
+
+    // Overlap and core Hamiltonian over the stacked AO basis
+    SharedMatrix S_ao_;
+    SharedMatrix H_ao_;
+    // (A|B)^-1 in the Coulomb metric
+    SharedMatrix Jinv_;
+    // h + 2J, K and the Fock matrix over the RI orbitals
+    SharedMatrix hJ_;
+    SharedMatrix K_;
+    SharedMatrix fock_;
+
+    void common_init();
+    void print_header();
+    void print_energies();
+
+    // Stacked overlap and core Hamiltonian, and the CABS orbitals
+    void form_cabs();
+    // h + 2J, K and the Fock matrix over the RI orbitals from (A|mP') and its fitted coefficients
+    void form_fock(SharedMatrix Amp, SharedMatrix Cmp);
+    // CABS singles correction to the reference energy
+    double form_cabs_singles();
+
+    // Two-electron integral object for a kernel
+    TwoBodyAOInt* build_ints(IntegralFactory& factory, Kernel kernel) const;
+    // Kernel scaling to f12 = -exp(-beta r12)/beta
+    double kernel_scale(Kernel kernel) const;
+    // (A|O|lr) for left orbitals in the orbital basis and right orbitals in the stacked basis, as naux x (nl * nr)
+    SharedMatrix form_Alr(Kernel kernel, SharedMatrix Cl, SharedMatrix Cr);
+    // (A|O|B)
+    SharedMatrix form_AB(Kernel kernel);
+    // J_mn = d_A (A|mn) over the stacked AO basis
+    SharedMatrix form_J(const std::vector<double>& d);
+
+   public:
+    RDFMP2F12(SharedWavefunction ref_wfn, Options& options);
+    virtual ~RDFMP2F12();
+
+    virtual double compute_energy();
+};
+
+}  // namespace dfmp2
+}  // namespace psi
+
+#endif
@@ -37,6 +37,7 @@
 #include "psi4/libfock/apps.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/prefetch.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/physconst.h"
@@ -1017,6 +1018,21 @@ void RDFMP2::form_Qia_transpose() {
     apply_B_transpose(PSIF_DFMP2_AIA, ribasis_->nbf(), Caocc_->colspi()[0], (size_t)Cavir_->colspi()[0]);
 }
 void RDFMP2::form_energy() {
+    // The Laplace path only has an advantage when the same-spin (exchange) term is not needed
+    if (options_.get_bool("DFMP2_LAPLACE")) {
+        if (sss_ == 0.0) {
+            timer_on("DFMP2 Laplace");
+            double e_os = form_energy_laplace();
+            timer_off("DFMP2 Laplace");
+            outfile->Printf("\t MP2_SS_SCALE is zero: the same-spin energy is not computed on the Laplace path,\n");
+            outfile->Printf("\t only the SCS (SOS-MP2) energies below are complete.\n\n");
+            variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = 0.0;
+            variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = e_os;
+            return;
+        }
+        outfile->Printf("\t DFMP2_LAPLACE requires MP2_SS_SCALE = 0 (SOS-MP2), using the canonical pair loop.\n\n");
+    }
+
     // Energy registers
     double e_ss = 0.0;
     double e_os = 0.0;
@@ -1036,11 +1052,17 @@ void RDFMP2::form_energy() {
     size_t Iab_memory = navir * (size_t)navir;
     size_t Qa_memory = naux * (size_t)navir;
     size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
-    if (doubles < nthread * Iab_memory) {
+    // DFMP2_MIXED_PRECISION adds float copies of each Iab and of the ia and jb blocks, half their size in doubles
+    bool mixed = options_.get_bool("DFMP2_MIXED_PRECISION");
+    size_t Iab_total = nthread * Iab_memory + (mixed ? nthread * Iab_memory / 2 : 0L);
+    if (doubles < Iab_total) {
         throw PSIEXCEPTION("DFMP2: Insufficient memory for Iab buffers. Reduce OMP Threads or increase memory.");
     }
-    size_t remainder = doubles - nthread * Iab_memory;
-    size_t max_i = remainder / (2L * Qa_memory);
+    size_t remainder = doubles - Iab_total;
+    // With DFMP2_ASYNC_IO a second jb buffer takes the next block while the current one is contracted
+    bool async = options_.get_bool("DFMP2_ASYNC_IO");
+    int nbuffer = (async ? 2 : 1);
+    size_t max_i = remainder / ((1L + nbuffer + (mixed ? 1L : 0L)) * Qa_memory);
     max_i = (max_i > naocc ? naocc : max_i);
     max_i = (max_i < 1L ? 1L : max_i);
 
@@ -1058,22 +1080,57 @@ void RDFMP2::form_energy() {
 
     // Tensor blocks
     auto Qia = std::make_shared<Matrix>("Qia", max_i * (size_t)navir, naux);
-    auto Qjb = std::make_shared<Matrix>("Qjb", max_i * (size_t)navir, naux);
     double** Qiap = Qia->pointer();
-    double** Qjbp = Qjb->pointer();
+    std::vector<SharedMatrix> Qjb;
+    for (int buffer = 0; buffer < nbuffer; buffer++) {
+        Qjb.push_back(std::make_shared<Matrix>("Qjb", max_i * (size_t)navir, naux));
+    }
 
     std::vector<SharedMatrix> Iab;
     for (int i = 0; i < nthread; i++) {
         Iab.push_back(std::make_shared<Matrix>("Iab", navir, navir));
     }
 
+    // single precision copies of the blocks for the (ia|jb) GEMMs
+    std::vector<float> Qiaf(mixed ? max_i * (size_t)navir * naux : 0);
+    std::vector<float> Qjbf(mixed ? max_i * (size_t)navir * naux : 0);
+    std::vector<std::vector<float>> Iabf(mixed ? nthread : 0, std::vector<float>(navir * (size_t)navir));
+
     double* eps_aoccp = eps_aocc_->pointer();
     double* eps_avirp = eps_avir_->pointer();
 
+    // The (i,j) block pairs this rank owns, in loop order
+    std::vector<std::pair<int, int>> block_pairs;
+    size_t task = 0L;
+    for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+        for (int block_j = 0; block_j <= block_i; block_j++) {
+            if (dist_.owns(task++)) block_pairs.push_back(std::make_pair(block_i, block_j));
+        }
+    }
+
     // Loop through pairs of blocks
     psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
     psio_address next_AIA = PSIO_ZERO;
+    BlockPrefetcher prefetch(PSIF_DFMP2_AIA, async);
+
+    // Read the jb block of pair k into its buffer (nothing to read for diagonal pairs)
+    auto post_jb = [&](size_t k) {
+        if (k >= block_pairs.size() || block_pairs[k].first == block_pairs[k].second) return;
+        size_t jstart = i_starts[block_pairs[k].second];
+        size_t nj = i_starts[block_pairs[k].second + 1] - jstart;
+        double* buffer = Qjb[k % nbuffer]->pointer()[0];
+        prefetch.post([=](std::shared_ptr<PSIO> psio) {
+            psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
+            psio->read(PSIF_DFMP2_AIA, "(Q|ia)", (char*)buffer, sizeof(double) * (nj * navir * naux), addr, &addr);
+            return nj * navir * naux;
+        });
+    };
+    if (async) post_jb(0);
+
+    size_t pair = 0L;
     for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+        if (pair >= block_pairs.size() || block_pairs[pair].first != block_i) continue;
+
         // Sizing
         size_t istart = i_starts[block_i];
         size_t istop = i_starts[block_i + 1];
@@ -1087,21 +1144,31 @@ void RDFMP2::form_energy() {
         timer_off("DFMP2 Qia Read");
 
         for (int block_j = 0; block_j <= block_i; block_j++) {
+            if (pair >= block_pairs.size() || block_pairs[pair].second != block_j) continue;
+            size_t k = pair++;
+
             // Sizing
             size_t jstart = i_starts[block_j];
             size_t jstop = i_starts[block_j + 1];
             size_t nj = jstop - jstart;
 
-            // Read iaQ chunk (if unique)
+            // Wait for the iaQ chunk (if unique), then start on the next pair's
             timer_on("DFMP2 Qia Read");
-            if (block_i == block_j) {
-                ::memcpy((void*)Qjbp[0], (void*)Qiap[0], sizeof(double) * (ni * navir * naux));
+            if (async) {
+                prefetch.wait();
             } else {
-                next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
-                psio_->read(PSIF_DFMP2_AIA, "(Q|ia)", (char*)Qjbp[0], sizeof(double) * (nj * navir * naux), next_AIA,
-                            &next_AIA);
+                post_jb(k);
             }
             timer_off("DFMP2 Qia Read");
+            double** Qjbp = (block_i == block_j ? Qiap : Qjb[k % nbuffer]->pointer());
+            if (async) post_jb(k + 1);
+
+            if (mixed) {
+                size_t nia = ni * navir * naux;
+                size_t njb = nj * navir * naux;
+                for (size_t k = 0; k < nia; k++) Qiaf[k] = (float)Qiap[0][k];
+                for (size_t k = 0; k < njb; k++) Qjbf[k] = (float)Qjbp[0][k];
+            }
 
 #pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+ : e_ss, e_os)
             for (long int ij = 0L; ij < ni * nj; ij++) {
@@ -1120,8 +1187,15 @@ void RDFMP2::form_energy() {
                 double** Iabp = Iab[thread]->pointer();
 
                 // Form the integral block (ia|jb) = (ia|Q)(Q|jb)
-                C_DGEMM('N', 'T', navir, navir, naux, 1.0, Qiap[(i - istart) * navir], naux, Qjbp[(j - jstart) * navir],
-                        naux, 0.0, Iabp[0], navir);
+                if (mixed) {
+                    float* Iabfp = Iabf[thread].data();
+                    C_SGEMM('N', 'T', navir, navir, naux, 1.0f, &Qiaf[(i - istart) * navir * (size_t)naux], naux,
+                            &Qjbf[(j - jstart) * navir * (size_t)naux], naux, 0.0f, Iabfp, navir);
+                    for (size_t ab = 0; ab < navir * (size_t)navir; ab++) Iabp[0][ab] = Iabfp[ab];
+                } else {
+                    C_DGEMM('N', 'T', navir, navir, naux, 1.0, Qiap[(i - istart) * navir], naux,
+                            Qjbp[(j - jstart) * navir], naux, 0.0, Iabp[0], navir);
+                }
 
                 // Add the MP2 energy contributions
                 for (int a = 0; a < navir; a++) {
@@ -1137,11 +1211,122 @@ void RDFMP2::form_energy() {
             }
         }
     }
+    prefetch.close();
+    if (print_ > 1) prefetch.print_stats("(Q|ia)");
     psio_->close(PSIF_DFMP2_AIA, 0);
 
+    double e_pair[2] = {e_ss, e_os};
+    dist_.sum(e_pair, 2);
+    e_ss = e_pair[0];
+    e_os = e_pair[1];
+
     variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = e_ss;
     variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = e_os;
 }
+double RDFMP2::form_energy_laplace() {
+    // Sizing
+    int naux = ribasis_->nbf();
+    int naocc = Caocc_->colspi()[0];
+    int navir = Cavir_->colspi()[0];
+
+    // Thread considerations
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    // 1 / (e_a + e_b - e_i - e_j) = \sum_w tau_ia^w tau_jb^w
+    auto denom = std::make_shared<LaplaceDenominator>(eps_aocc_, eps_avir_, options_.get_double("DENOMINATOR_DELTA"));
+    SharedMatrix tau = denom->denominator();
+    int nvector = tau->rowspi()[0];
+    double** taup = tau->pointer();
+
+    // Memory: the X^w_PQ buffer plus raw and scaled (ia|Q) blocks
+    size_t X_memory = naux * (size_t)naux;
+    size_t Qa_memory = naux * (size_t)navir;
+    size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
+    if (doubles < X_memory + 2L * Qa_memory) {
+        throw PSIEXCEPTION("DFMP2: Insufficient memory for the Laplace X buffer. Increase memory.");
+    }
+    size_t max_i = (doubles - X_memory) / (2L * Qa_memory);
+    max_i = (max_i > naocc ? naocc : max_i);
+    max_i = (max_i < 1L ? 1L : max_i);
+
+    // Blocks
+    std::vector<size_t> i_starts;
+    i_starts.push_back(0L);
+    for (size_t i = 0; i < naocc; i += max_i) {
+        if (i + max_i >= naocc) {
+            i_starts.push_back(naocc);
+        } else {
+            i_starts.push_back(i + max_i);
+        }
+    }
+    bool in_core = (i_starts.size() == 2);
+
+    outfile->Printf("\t Laplace DF-MP2: %d quadrature points, %zu occupied blocks%s.\n\n", nvector,
+                    i_starts.size() - 1, (in_core ? " (in core)" : ""));
+
+    auto Qia = std::make_shared<Matrix>("Qia", max_i * (size_t)navir, naux);
+    auto Bia = std::make_shared<Matrix>("Bia", max_i * (size_t)navir, naux);
+    auto X = std::make_shared<Matrix>("X", naux, naux);
+    double** Qiap = Qia->pointer();
+    double** Biap = Bia->pointer();
+    double** Xp = X->pointer();
+
+    // E_os = - \sum_w \sum_PQ (X^w_PQ)^2, X^w_PQ = \sum_ia (ia|P) (ia|Q) tau_ia^w,
+    // which scales as O(n_w o v N_aux^2) instead of O(o^2 v^2 N_aux)
+    double e_os = 0.0;
+    bool loaded = false;
+    psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
+    for (int w = 0; w < nvector; w++) {
+        if (!dist_.owns(w)) continue;
+        X->zero();
+        for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+            size_t istart = i_starts[block_i];
+            size_t istop = i_starts[block_i + 1];
+            size_t ni = istop - istart;
+            long int nia = ni * navir;
+
+            // Read iaQ chunk (once if it all fits)
+            if (!in_core || !loaded) {
+                timer_on("DFMP2 Qia Read");
+                psio_address next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (istart * navir * naux));
+                psio_->read(PSIF_DFMP2_AIA, "(Q|ia)", (char*)Qiap[0], sizeof(double) * (ni * navir * naux), next_AIA,
+                            &next_AIA);
+                timer_off("DFMP2 Qia Read");
+            }
+
+            double* tauwp = &taup[w][istart * navir];
+#pragma omp parallel for num_threads(nthread)
+            for (long int ia = 0L; ia < nia; ia++) {
+                double scale = std::sqrt(tauwp[ia]);
+                for (int Q = 0; Q < naux; Q++) {
+                    Biap[ia][Q] = scale * Qiap[ia][Q];
+                }
+            }
+
+            C_DSYRK('L', 'T', naux, nia, 1.0, Biap[0], naux, 1.0, Xp[0], naux);
+        }
+        loaded = true;
+
+        // Only the lower triangle of X is formed
+        double e_w = 0.0;
+#pragma omp parallel for num_threads(nthread) reduction(+ : e_w)
+        for (int P = 0; P < naux; P++) {
+            e_w += Xp[P][P] * Xp[P][P];
+            for (int Q = 0; Q < P; Q++) {
+                e_w += 2.0 * Xp[P][Q] * Xp[P][Q];
+            }
+        }
+        e_os -= e_w;
+    }
+    psio_->close(PSIF_DFMP2_AIA, 0);
+
+    dist_.sum(&e_os, 1);
+
+    return e_os;
+}
 void RDFMP2::form_Pab() {
     // Energy registers
     double e_ss = 0.0;
@@ -1161,8 +1346,11 @@ void RDFMP2::form_Pab() {
     // Memory
     size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
     doubles -= navir * navir;
+    // With DFMP2_ASYNC_IO the jb and Cjb blocks are double buffered
+    bool async = options_.get_bool("DFMP2_ASYNC_IO");
+    int nbuffer = (async ? 2 : 1);
     double C = -(double)doubles;
-    double B = 4.0 * navir * naux;
+    double B = (2.0 + 2.0 * nbuffer) * navir * naux;
     double A = 2.0 * navir * (double)navir;
 
     int max_i = (int)((-B + sqrt(B * B - 4.0 * A * C)) / (2.0 * A));
@@ -1190,14 +1378,16 @@ void RDFMP2::form_Pab() {
 
     // 3-Index Tensor blocks
     auto Qia = std::make_shared<Matrix>("Qia", max_i * (size_t)navir, naux);
-    auto Qjb = std::make_shared<Matrix>("Qjb", max_i * (size_t)navir, naux);
     auto Gia = std::make_shared<Matrix>("Gia", max_i * (size_t)navir, naux);
-    auto Cjb = std::make_shared<Matrix>("Cjb", max_i * (size_t)navir, naux);
+    std::vector<SharedMatrix> Qjb;
+    std::vector<SharedMatrix> Cjb;
+    for (int buffer = 0; buffer < nbuffer; buffer++) {
+        Qjb.push_back(std::make_shared<Matrix>("Qjb", max_i * (size_t)navir, naux));
+        Cjb.push_back(std::make_shared<Matrix>("Cjb", max_i * (size_t)navir, naux));
+    }
 
     double** Qiap = Qia->pointer();
-    double** Qjbp = Qjb->pointer();
     double** Giap = Gia->pointer();
-    double** Cjbp = Cjb->pointer();
 
     // 4-index Tensor blocks
     auto I = std::make_shared<Matrix>("I", max_i * (size_t)navir, max_i * (size_t)navir);
@@ -1210,10 +1400,47 @@ void RDFMP2::form_Pab() {
     double* eps_aoccp = eps_aocc_->pointer();
     double* eps_avirp = eps_avir_->pointer();
 
+    // The (i,j) block pairs processed here, in loop order; Gamma rows of block_i are only formed on its owner
+    std::vector<std::pair<int, int>> block_pairs;
+    for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+        if (!dist_.owns(block_i)) continue;
+        for (int block_j = 0; block_j < i_starts.size() - 1; block_j++) {
+            block_pairs.push_back(std::make_pair(block_i, block_j));
+        }
+    }
+
     // Loop through pairs of blocks
     psio_address next_AIA = PSIO_ZERO;
     psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
+    // Opened before the (G|ia) writes below, closed before psio_ closes the unit
+    BlockPrefetcher prefetch(PSIF_DFMP2_AIA, async);
+
+    // Read the jb (if unique) and Cjb blocks of pair k into their buffers
+    auto post_jb = [&](size_t k) {
+        if (k >= block_pairs.size()) return;
+        bool diagonal = (block_pairs[k].first == block_pairs[k].second);
+        size_t jstart = i_starts[block_pairs[k].second];
+        size_t nj = i_starts[block_pairs[k].second + 1] - jstart;
+        double* Qbuffer = Qjb[k % nbuffer]->pointer()[0];
+        double* Cbuffer = Cjb[k % nbuffer]->pointer()[0];
+        prefetch.post([=](std::shared_ptr<PSIO> psio) {
+            size_t size = nj * navir * naux;
+            psio_address addr;
+            if (!diagonal) {
+                addr = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
+                psio->read(PSIF_DFMP2_AIA, "(Q|ia)", (char*)Qbuffer, sizeof(double) * size, addr, &addr);
+            }
+            addr = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
+            psio->read(PSIF_DFMP2_AIA, "(B|ia)", (char*)Cbuffer, sizeof(double) * size, addr, &addr);
+            return (diagonal ? 1L : 2L) * size;
+        });
+    };
+    if (async) post_jb(0);
+
+    size_t pair = 0L;
     for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+        if (pair >= block_pairs.size() || block_pairs[pair].first != block_i) continue;
+
         // Sizing
         size_t istart = i_starts[block_i];
         size_t istop = i_starts[block_i + 1];
@@ -1230,28 +1457,24 @@ void RDFMP2::form_Pab() {
         Gia->zero();
 
         for (int block_j = 0; block_j < i_starts.size() - 1; block_j++) {
+            size_t k = pair++;
+
             // Sizing
             size_t jstart = i_starts[block_j];
             size_t jstop = i_starts[block_j + 1];
             size_t nj = jstop - jstart;
 
-            // Read iaQ chunk (if unique)
+            // Wait for the iaQ (if unique) and iaC chunks, then start on the next pair's
             timer_on("DFMP2 Qia Read");
-            if (block_i == block_j) {
-                ::memcpy((void*)Qjbp[0], (void*)Qiap[0], sizeof(double) * (ni * navir * naux));
+            if (async) {
+                prefetch.wait();
             } else {
-                next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
-                psio_->read(PSIF_DFMP2_AIA, "(Q|ia)", (char*)Qjbp[0], sizeof(double) * (nj * navir * naux), next_AIA,
-                            &next_AIA);
+                post_jb(k);
             }
             timer_off("DFMP2 Qia Read");
-
-            // Read iaC chunk
-            timer_on("DFMP2 Cia Read");
-            next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (jstart * navir * naux));
-            psio_->read(PSIF_DFMP2_AIA, "(B|ia)", (char*)Cjbp[0], sizeof(double) * (nj * navir * naux), next_AIA,
-                        &next_AIA);
-            timer_off("DFMP2 Cia Read");
+            double** Qjbp = (block_i == block_j ? Qiap : Qjb[k % nbuffer]->pointer());
+            double** Cjbp = Cjb[k % nbuffer]->pointer();
+            if (async) post_jb(k + 1);
 
             // Form the integrals (ia|jb) = B_ia^Q B_jb^Q
             timer_on("DFMP2 I");
@@ -1325,6 +1548,36 @@ void RDFMP2::form_Pab() {
         timer_off("DFMP2 Gia Write");
     }
 
+    prefetch.close();
+    if (print_ > 1) prefetch.print_stats("(Q|ia),(B|ia)");
+
+    // Sum the partial Pab and energies, and hand every rank the full Gamma
+    if (dist_.distributed()) {
+        timer_on("DFMP2 Dist Reduce");
+        dist_.sum(Pabp[0], navir * (size_t)navir);
+        double e_pair[2] = {e_ss, e_os};
+        dist_.sum(e_pair, 2);
+        e_ss = e_pair[0];
+        e_os = e_pair[1];
+
+        for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
+            size_t istart = i_starts[block_i];
+            size_t ni = i_starts[block_i + 1] - istart;
+            next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (istart * navir * naux));
+            if (dist_.owns(block_i)) {
+                psio_->read(PSIF_DFMP2_AIA, "(G|ia)", (char*)Giap[0], sizeof(double) * (ni * navir * naux), next_AIA,
+                            &next_AIA);
+            }
+            dist_.broadcast(Giap[0], ni * navir * naux, dist_.owner(block_i));
+            if (!dist_.owns(block_i)) {
+                next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (istart * navir * naux));
+                psio_->write(PSIF_DFMP2_AIA, "(G|ia)", (char*)Giap[0], sizeof(double) * (ni * navir * naux), next_AIA,
+                             &next_AIA);
+            }
+        }
+        timer_off("DFMP2 Dist Reduce");
+    }
+
     // Save the ab block of P
     psio_->write_entry(PSIF_DFMP2_AIA, "Pab", (char*)Pabp[0], sizeof(double) * navir * navir);
     // Pab->print();
@@ -1353,8 +1606,11 @@ void RDFMP2::form_Pij() {
     // Memory
     size_t doubles = ((size_t)(options_.get_double("DFMP2_MEM_FACTOR") * memory_ / 8L));
     doubles -= naocc * naocc;
+    // With DFMP2_ASYNC_IO the jb block is double buffered
+    bool async = options_.get_bool("DFMP2_ASYNC_IO");
+    int nbuffer = (async ? 2 : 1);
     double C = -(double)doubles;
-    double B = 2.0 * naocc * naux;
+    double B = (1.0 + nbuffer) * naocc * naux;
     double A = 2.0 * naocc * (double)naocc;
 
     int max_a = (int)((-B + sqrt(B * B - 4.0 * A * C)) / (2.0 * A));
@@ -1382,10 +1638,12 @@ void RDFMP2::form_Pij() {
 
     // 3-Index Tensor blocks
     auto Qia = std::make_shared<Matrix>("Qia", max_a * (size_t)naocc, naux);
-    auto Qjb = std::make_shared<Matrix>("Qjb", max_a * (size_t)naocc, naux);
+    std::vector<SharedMatrix> Qjb;
+    for (int buffer = 0; buffer < nbuffer; buffer++) {
+        Qjb.push_back(std::make_shared<Matrix>("Qjb", max_a * (size_t)naocc, naux));
+    }
 
     double** Qiap = Qia->pointer();
-    double** Qjbp = Qjb->pointer();
 
     // 4-index Tensor blocks
     auto I = std::make_shared<Matrix>("I", max_a * (size_t)naocc, max_a * (size_t)naocc);
@@ -1398,10 +1656,38 @@ void RDFMP2::form_Pij() {
     double* eps_aoccp = eps_aocc_->pointer();
     double* eps_avirp = eps_avir_->pointer();
 
+    // The (a,b) block pairs this rank owns, in loop order
+    std::vector<std::pair<int, int>> block_pairs;
+    for (int block_a = 0; block_a < a_starts.size() - 1; block_a++) {
+        if (!dist_.owns(block_a)) continue;
+        for (int block_b = 0; block_b < a_starts.size() - 1; block_b++) {
+            block_pairs.push_back(std::make_pair(block_a, block_b));
+        }
+    }
+
     // Loop through pairs of blocks
     psio_address next_AIA = PSIO_ZERO;
     psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
+    BlockPrefetcher prefetch(PSIF_DFMP2_AIA, async);
+
+    // Read the bj block of pair k into its buffer (nothing to read for diagonal pairs)
+    auto post_jb = [&](size_t k) {
+        if (k >= block_pairs.size() || block_pairs[k].first == block_pairs[k].second) return;
+        size_t bstart = a_starts[block_pairs[k].second];
+        size_t nb = a_starts[block_pairs[k].second + 1] - bstart;
+        double* buffer = Qjb[k % nbuffer]->pointer()[0];
+        prefetch.post([=](std::shared_ptr<PSIO> psio) {
+            psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * (bstart * naocc * naux));
+            psio->read(PSIF_DFMP2_AIA, "(Q|ai)", (char*)buffer, sizeof(double) * (nb * naocc * naux), addr, &addr);
+            return nb * naocc * naux;
+        });
+    };
+    if (async) post_jb(0);
+
+    size_t pair = 0L;
     for (int block_a = 0; block_a < a_starts.size() - 1; block_a++) {
+        if (pair >= block_pairs.size() || block_pairs[pair].first != block_a) continue;
+
         // Sizing
         size_t astart = a_starts[block_a];
         size_t astop = a_starts[block_a + 1];
@@ -1415,21 +1701,23 @@ void RDFMP2::form_Pij() {
         timer_off("DFMP2 Qai Read");
 
         for (int block_b = 0; block_b < a_starts.size() - 1; block_b++) {
+            size_t k = pair++;
+
             // Sizing
             size_t bstart = a_starts[block_b];
             size_t bstop = a_starts[block_b + 1];
             size_t nb = bstop - bstart;
 
-            // Read iaQ chunk (if unique)
+            // Wait for the iaQ chunk (if unique), then start on the next pair's
             timer_on("DFMP2 Qai Read");
-            if (block_a == block_b) {
-                ::memcpy((void*)Qjbp[0], (void*)Qiap[0], sizeof(double) * (na * naocc * naux));
+            if (async) {
+                prefetch.wait();
             } else {
-                next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * (bstart * naocc * naux));
-                psio_->read(PSIF_DFMP2_AIA, "(Q|ai)", (char*)Qjbp[0], sizeof(double) * (nb * naocc * naux), next_AIA,
-                            &next_AIA);
+                post_jb(k);
             }
             timer_off("DFMP2 Qai Read");
+            double** Qjbp = (block_a == block_b ? Qiap : Qjb[k % nbuffer]->pointer());
+            if (async) post_jb(k + 1);
 
             // Form the integrals (ia|jb) = B_ia^Q B_jb^Q
             timer_on("DFMP2 I");
@@ -1490,6 +1778,11 @@ void RDFMP2::form_Pij() {
         }
     }
 
+    prefetch.close();
+    if (print_ > 1) prefetch.print_stats("(Q|ai)");
+
+    dist_.sum(Pijp[0], naocc * (size_t)naocc);
+
     // Save the ab block of P
     psio_->write_entry(PSIF_DFMP2_AIA, "Pij", (char*)Pijp[0], sizeof(double) * naocc * naocc);
     // Pij->print();
@@ -1553,6 +1846,8 @@ void RDFMP2::form_AB_x_terms() {
 
 #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
     for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+        if (!dist_.owns(PQ)) continue;
+
         int P = PQ_pairs[PQ].first;
         int Q = PQ_pairs[PQ].second;
 
@@ -1612,6 +1907,7 @@ void RDFMP2::form_AB_x_terms() {
     for (int t = 0; t < num_threads; t++) {
         gradients_["(A|B)^x"]->add(Ktemps[t]);
     }
+    dist_.sum(gradients_["(A|B)^x"]->pointer()[0], 3L * natom);
 }
 void RDFMP2::form_Amn_x_terms() {
     // => Sizing <= //
@@ -1717,8 +2013,11 @@ void RDFMP2::form_Amn_x_terms() {
         int pstop = (Pstop == ribasis_->nshell() ? naux : ribasis_->shell(Pstop).function_index());
         int np = pstop - pstart;
 
+        if (!dist_.owns(block)) continue;
+
         // > G_ia^P -> G_mn^P < //
 
+        next_AIA = psio_get_address(PSIO_ZERO, sizeof(double) * pstart * nia);
         psio_->read(PSIF_DFMP2_AIA, "(G|ia) T", (char*)Giap[0], sizeof(double) * np * nia, next_AIA, &next_AIA);
 
 #pragma omp parallel for num_threads(num_threads)
@@ -1811,6 +2110,7 @@ void RDFMP2::form_Amn_x_terms() {
     for (int t = 0; t < num_threads; t++) {
         gradients_["(A|mn)^x"]->add(Ktemps[t]);
     }
+    dist_.sum(gradients_["(A|mn)^x"]->pointer()[0], 3L * natom);
 
     psio_->close(PSIF_DFMP2_AIA, 1);
 }
@@ -3013,6 +3313,7 @@ void UDFMP2::form_energy() {
         // Loop through pairs of blocks
         psio_->open(PSIF_DFMP2_AIA, PSIO_OPEN_OLD);
         psio_address next_AIA = PSIO_ZERO;
+        size_t task = 0L;
         for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
             // Sizing
             size_t istart = i_starts[block_i];
@@ -3027,6 +3328,8 @@ void UDFMP2::form_energy() {
             timer_off("DFMP2 Qia Read");
 
             for (int block_j = 0; block_j <= block_i; block_j++) {
+                if (!dist_.owns(task++)) continue;
+
                 // Sizing
                 size_t jstart = i_starts[block_j];
                 size_t jstop = i_starts[block_j + 1];
@@ -3133,6 +3436,7 @@ void UDFMP2::form_energy() {
         // Loop through pairs of blocks
         psio_->open(PSIF_DFMP2_QIA, PSIO_OPEN_OLD);
         psio_address next_AIA = PSIO_ZERO;
+        size_t task = 0L;
         for (int block_i = 0; block_i < i_starts.size() - 1; block_i++) {
             // Sizing
             size_t istart = i_starts[block_i];
@@ -3147,6 +3451,8 @@ void UDFMP2::form_energy() {
             timer_off("DFMP2 Qia Read");
 
             for (int block_j = 0; block_j <= block_i; block_j++) {
+                if (!dist_.owns(task++)) continue;
+
                 // Sizing
                 size_t jstart = i_starts[block_j];
                 size_t jstop = i_starts[block_j + 1];
@@ -3270,6 +3576,7 @@ void UDFMP2::form_energy() {
         psio_->open(PSIF_DFMP2_QIA, PSIO_OPEN_OLD);
         psio_address next_AIA = PSIO_ZERO;
         psio_address next_QIA = PSIO_ZERO;
+        size_t task = 0L;
         for (int block_i = 0; block_i < i_starts_a.size() - 1; block_i++) {
             // Sizing
             size_t istart = i_starts_a[block_i];
@@ -3284,6 +3591,8 @@ void UDFMP2::form_energy() {
             timer_off("DFMP2 Qia Read");
 
             for (int block_j = 0; block_j < i_starts_b.size() - 1; block_j++) {
+                if (!dist_.owns(task++)) continue;
+
                 // Sizing
                 size_t jstart = i_starts_b[block_j];
                 size_t jstop = i_starts_b[block_j + 1];
@@ -3329,6 +3638,11 @@ void UDFMP2::form_energy() {
 
     /* End BB Terms */ }
 
+    double e_pair[2] = {e_ss, e_os};
+    dist_.sum(e_pair, 2);
+    e_ss = e_pair[0];
+    e_os = e_pair[1];
+
     variables_["MP2 SAME-SPIN CORRELATION ENERGY"] = e_ss;
     variables_["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = e_os;
 }
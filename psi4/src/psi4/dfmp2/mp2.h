@@ -30,6 +30,7 @@
 #define TOTAL_DFMP2_H
 
 #include "psi4/libmints/wavefunction.h"
+#include "dist.h"
 #include <map>
 
 namespace psi {
@@ -49,6 +50,8 @@ class DFMP2 : public Wavefunction {
     double sss_;
     // Opposite-spin scale
     double oss_;
+    // Block-loop distribution over MPI ranks
+    DistTasks dist_;
 
     void common_init();
     // Common printing of energies/SCS
@@ -145,6 +148,8 @@ class RDFMP2 : public DFMP2 {
     virtual void form_Qia_transpose();
     // Form the energy contributions
     virtual void form_energy();
+    // Form the opposite-spin energy with a Laplace-factorized denominator, returns E_os
+    double form_energy_laplace();
     // Form the energy contributions and gradients
     virtual void form_Pab();
     // Form the energy contributions and gradients
@@ -45,6 +45,7 @@
 #include "psi4/psi4-dec.h"
 
 #include "mp2.h"
+#include "f12.h"
 
 namespace psi {
 namespace dfmp2 {
@@ -65,5 +66,13 @@ SharedWavefunction dfmp2(SharedWavefunction ref_wfn, Options& options) {
 
     return dfmp2;
 }
+
+SharedWavefunction dfmp2_f12(SharedWavefunction ref_wfn, Options& options) {
+    if (options.get_str("REFERENCE") != "RHF") {
+        throw PSIEXCEPTION("DFMP2: MP2-F12 is only available for an RHF reference");
+    }
+
+    return std::make_shared<RDFMP2F12>(ref_wfn, options);
+}
 }  // namespace dfmp2
 }  // namespace psi
@@ -207,13 +207,12 @@ void DFOCC::ccd_WmbejT2_low() {
     tei_iajb_chem_directAA(W);
 
     // W(me,jb) <= 1/2\sum_{Q} T_jb^Q b_me^Q
-    T = SharedTensor2d(new Tensor2d("T2 (Q|IA)", nQ, naoccA, navirA));
-    T->read(psio_, PSIF_DFOCC_AMPS);
-    K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA, navirA));
-    K->read(psio_, PSIF_DFOCC_INTS);
-    W->gemm(true, false, K, T, 0.5, 1.0);
-    K.reset();
-    T.reset();
+    {
+        int rows = stream_rows(naoccA * navirA);
+        Tensor2dStream Ts(PSIF_DFOCC_AMPS, "T2 (Q|IA)", nQ, naoccA * navirA, rows);
+        Tensor2dStream Ks(PSIF_DFOCC_INTS, "DF_BASIS_CC B (Q|IA)", nQ, naoccA * navirA, rows);
+        W->gemm(true, false, Ks, Ts, 0.5, 1.0);
+    }
 
     // W(me,jb) <= -1/2 \sum_{nf} t_jn^bf X(me,nf)
     // (mf|ne) = X(me,nf) (sort: 1432)
@@ -354,13 +354,19 @@ void DFOCC::tei_vvoo_chem_directAB(SharedTensor2d &K) {
 //=======================================================
 void DFOCC::tei_iajb_chem_directAA(SharedTensor2d &K) {
     timer_on("Build (IA|JB)");
-    bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA, navirA));
-    bQiaA->read(psio_, PSIF_DFOCC_INTS);
-    K->gemm(true, false, bQiaA, bQiaA, 1.0, 0.0);
-    bQiaA.reset();
+    Tensor2dStream B(PSIF_DFOCC_INTS, "DF_BASIS_CC B (Q|IA)", nQ, naoccA * navirA, stream_rows(naoccA * navirA));
+    K->gemm(true, false, B, B, 1.0, 0.0);
     timer_off("Build (IA|JB)");
 }
 
+//=======================================================
+//          rows per streamed block
+//=======================================================
+int DFOCC::stream_rows(int dim2) {
+    double rows = (double)stream_block_mb * 1024.0 * 1024.0 / (8.0 * MAX0(dim2, 1));
+    return MAX0(1, (int)MIN0(rows, 2.0e9));
+}
+
 //=======================================================
 //          (ia|jb)
 //=======================================================
@@ -53,6 +53,7 @@ void DFOCC::common_init() {
 
     cc_maxiter = options_.get_int("CC_MAXITER");
     mo_maxiter = options_.get_int("MO_MAXITER");
+    stream_block_mb = options_.get_int("STREAM_BLOCK_SIZE");
     num_vecs = options_.get_int("MO_DIIS_NUM_VECS");
     cc_maxdiis_ = options_.get_int("CC_DIIS_MAX_VECS");
     cc_mindiis_ = options_.get_int("CC_DIIS_MIN_VECS");
@@ -30,6 +30,7 @@
 #define dfocc_h
 
 #include "tensors.h"
+#include "dist.h"
 
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libmints/wavefunction.h"
@@ -208,6 +209,9 @@ class DFOCC : public Wavefunction {
 
     void tei_iajb_chem_directAA(SharedTensor2d &K);
     void tei_iajb_chem_directBB(SharedTensor2d &K);
+
+    // rows per block of a Tensor2dStream with dim2 columns
+    int stream_rows(int dim2);
     void tei_iajb_chem_directAB(SharedTensor2d &K);
 
     void tei_oooo_chem_directAA(SharedTensor2d &K);
@@ -395,6 +399,8 @@ class DFOCC : public Wavefunction {
     void cd_mp2_manager();
     void omp2_opdm();
     void omp2_tpdm();
+    // dist_gather_rows: assemble an n-row tensor from the row slab each rank holds at start
+    SharedTensor2d dist_gather_rows(const SharedTensor2d &slab, const std::string &name, int n, int start);
     void mp2l_energy();
 
     // OMP3
@@ -670,6 +676,8 @@ class DFOCC : public Wavefunction {
     int conver;
     int cc_maxiter;
     int mo_maxiter;
+    int stream_block_mb;  // memory (MB) per row block of a Tensor2dStream
+    DistSlabs dist_;      // auxiliary-index slabs owned by this MPI rank
     int pcg_maxiter;
     int num_vecs;  // Number of vectors used in diis (diis order)
     int do_diis_;
@@ -0,0 +1,86 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "dist.h"
+#include "dfocc.h"
+
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+namespace psi {
+namespace dfoccwave {
+
+void DistSlabs::slab(int n, int& start, int& count) const {
+    if (n < nrank_) throw PSIEXCEPTION("DistSlabs: fewer auxiliary functions than MPI ranks.");
+    int base = n / nrank_;
+    int extra = n % nrank_;
+    start = rank_ * base + std::min(rank_, extra);
+    count = base + (rank_ < extra ? 1 : 0);
+}
+
+#ifdef ENABLE_MPI
+
+// MPI counts are ints, so large buffers go in pieces
+static const size_t dist_chunk = 1L << 28;
+
+DistSlabs::DistSlabs() : rank_(0), nrank_(1) {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) return;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &nrank_);
+}
+void DistSlabs::sum(double* buffer, size_t n) const {
+    if (nrank_ == 1) return;
+    for (size_t offset = 0L; offset < n; offset += dist_chunk) {
+        int count = (int)std::min(dist_chunk, n - offset);
+        MPI_Allreduce(MPI_IN_PLACE, buffer + offset, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+}
+
+#else
+
+DistSlabs::DistSlabs() : rank_(0), nrank_(1) {}
+void DistSlabs::sum(double* buffer, size_t n) const {}
+
+#endif
+
+SharedTensor2d DFOCC::dist_gather_rows(const SharedTensor2d &slab, const std::string &name, int n, int start) {
+    if (!dist_.distributed()) return slab;
+    SharedTensor2d A = SharedTensor2d(new Tensor2d(name, n, slab->dim2()));
+    A->set_rows(slab, start);
+    dist_.sum(A->data(), (size_t)n * slab->dim2());
+    return A;
+}
+
+}  // namespace dfoccwave
+}  // namespace psi
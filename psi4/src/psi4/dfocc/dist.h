@@ -0,0 +1,66 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _dfocc_dist_h_
+#define _dfocc_dist_h_
+
+#include <cstddef>
+
+namespace psi {
+namespace dfoccwave {
+
+/**
+ * Distribution of the auxiliary index over the ranks of MPI_COMM_WORLD.
+ * Each rank owns a contiguous slab of Q, reads only those rows of the
+ * (Q|pq) integrals and densities, and the Q-summed results are added up
+ * afterwards. Without ENABLE_MPI, or with a single rank, the slab is the
+ * whole range and the sums are no-ops.
+ */
+class DistSlabs {
+   protected:
+    int rank_;
+    int nrank_;
+
+   public:
+    DistSlabs();
+
+    int rank() const { return rank_; }
+    int nrank() const { return nrank_; }
+    /// Is there more than one rank?
+    bool distributed() const { return nrank_ > 1; }
+    /// Rows [start, start + count) of an n-row index owned by this rank
+    void slab(int n, int& start, int& count) const;
+
+    /// Sum buffer[0:n] over all ranks, in place
+    void sum(double* buffer, size_t n) const;
+};
+
+}  // namespace dfoccwave
+}  // namespace psi
+
+#endif  // _dfocc_dist_h_
@@ -46,15 +46,18 @@ void DFOCC::gfock_vv() {
         // Correlation Contribution
         //=========================
 
-        // Fab = \sum_{e} h_ae G_eb
-        GFvv->gemm(true, false, HvvA, G1c_vv, 1.0, 0.0);
+        // Each rank contracts its own slab of the auxiliary index
+        int Q0, nQl, Q0_ref, nQl_ref;
+        dist_.slab(nQ, Q0, nQl);
+        dist_.slab(nQ_ref, Q0_ref, nQl_ref);
+        GFvv->zero();
 
         // Fab += \sum_{Q} \sum_{m} G_mb^Q b_ma^Q
-        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA, nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|OV)", nQ, noccA * nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvv->contract(true, false, nvirA, nvirA, nQ * noccA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQl, noccA, nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|OV)", nQl, noccA * nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+        GFvv->contract(true, false, nvirA, nvirA, nQl * noccA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
@@ -63,23 +66,28 @@ void DFOCC::gfock_vv() {
         //=========================
 
         // Fab += \sum_{Q} \sum_{m} G_mb^Q b_ma^Q
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|OV)", nQ_ref, noccA * nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQ_ref, noccA * nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvv->contract(true, false, nvirA, nvirA, nQ_ref * noccA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|OV)", nQl_ref, noccA * nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQl_ref, noccA * nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref);
+        GFvv->contract(true, false, nvirA, nvirA, nQl_ref * noccA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
         // Fab += \sum_{Q} \sum_{e} G_eb^Q b_ea^Q
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|VV)", nQ_ref, nvirA, nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQ_ref, nvirA, nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS, true, true);
-        K->read(psio_, PSIF_DFOCC_INTS, true, true);
-        GFvv->contract(true, false, nvirA, nvirA, nQ_ref * nvirA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|VV)", nQl_ref, nvirA, nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQl_ref, nvirA, nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref, true, true);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref, true, true);
+        GFvv->contract(true, false, nvirA, nvirA, nQl_ref * nvirA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
+        dist_.sum(GFvv->data(), (size_t)nvirA * nvirA);
+
+        // Fab += \sum_{e} h_ae G_eb
+        GFvv->gemm(true, false, HvvA, G1c_vv, 1.0, 1.0);
+
         // Set global GF
         GF->set_vv(noccA, GFvv);
         if (print_ > 2) GF->print();
@@ -106,32 +114,29 @@ void DFOCC::gfock_vv() {
         // Correlation Contribution
         //=========================
 
-        // Fab = \sum_{e} h_ae G_eb
-        GFvvA->gemm(true, false, HvvA, G1c_vvA, 1.0, 0.0);
-        GFvvB->gemm(true, false, HvvB, G1c_vvB, 1.0, 0.0);
-
-        if (reference == "ROHF" && orb_opt_ == "FALSE") {
-            // Fab = \sum_{m} h_am G_mb
-            GFvvA->gemm(false, false, HvoA, G1c_ovA, 1.0, 1.0);
-            GFvvB->gemm(false, false, HvoB, G1c_ovB, 1.0, 1.0);
-        }
+        // Each rank contracts its own slab of the auxiliary index
+        int Q0, nQl, Q0_ref, nQl_ref;
+        dist_.slab(nQ, Q0, nQl);
+        dist_.slab(nQ_ref, Q0_ref, nQl_ref);
+        GFvvA->zero();
+        GFvvB->zero();
 
         // Fab += \sum_{Q} \sum_{m} G_mb^Q b_ma^Q
         // alpha spin
-        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA, nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|OV)", nQ, noccA * nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvvA->contract(true, false, nvirA, nvirA, nQ * noccA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQl, noccA, nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|OV)", nQl, noccA * nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+        GFvvA->contract(true, false, nvirA, nvirA, nQl * noccA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
         // beta spin
-        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ov)", nQ, noccB, nvirB));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ov)", nQ, noccB * nvirB));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvvB->contract(true, false, nvirB, nvirB, nQ * noccB, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ov)", nQl, noccB, nvirB));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ov)", nQl, noccB * nvirB));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+        GFvvB->contract(true, false, nvirB, nvirB, nQl * noccB, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
@@ -141,42 +146,55 @@ void DFOCC::gfock_vv() {
 
         // Fab += \sum_{Q} \sum_{m} G_mb^Q b_ma^Q
         // alpha spin
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|OV)", nQ_ref, noccA * nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQ_ref, noccA * nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvvA->contract(true, false, nvirA, nvirA, nQ_ref * noccA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|OV)", nQl_ref, noccA * nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQl_ref, noccA * nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref);
+        GFvvA->contract(true, false, nvirA, nvirA, nQl_ref * noccA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
         // beta spin
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|ov)", nQ_ref, noccB * nvirB));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQ_ref, noccB * nvirB));
-        G->read(psio_, PSIF_DFOCC_DENS);
-        K->read(psio_, PSIF_DFOCC_INTS);
-        GFvvB->contract(true, false, nvirB, nvirB, nQ_ref * noccB, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|ov)", nQl_ref, noccB * nvirB));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQl_ref, noccB * nvirB));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref);
+        GFvvB->contract(true, false, nvirB, nvirB, nQl_ref * noccB, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
         // Fab += \sum_{Q} \sum_{e} G_eb^Q b_ea^Q
         // alpha spin
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|VV)", nQ_ref, nvirA, nvirA));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQ_ref, nvirA, nvirA));
-        G->read(psio_, PSIF_DFOCC_DENS, true, true);
-        K->read(psio_, PSIF_DFOCC_INTS, true, true);
-        GFvvA->contract(true, false, nvirA, nvirA, nQ_ref * nvirA, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|VV)", nQl_ref, nvirA, nvirA));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQl_ref, nvirA, nvirA));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref, true, true);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref, true, true);
+        GFvvA->contract(true, false, nvirA, nvirA, nQl_ref * nvirA, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
         // beta spin
-        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|vv)", nQ_ref, nvirB, nvirB));
-        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vv)", nQ_ref, nvirB, nvirB));
-        G->read(psio_, PSIF_DFOCC_DENS, true, true);
-        K->read(psio_, PSIF_DFOCC_INTS, true, true);
-        GFvvB->contract(true, false, nvirB, nvirB, nQ_ref * nvirB, K, G, 1.0, 1.0);
+        G = SharedTensor2d(new Tensor2d("3-Index Separable TPDM (Q|vv)", nQl_ref, nvirB, nvirB));
+        K = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vv)", nQl_ref, nvirB, nvirB));
+        G->read_rows(psio_, PSIF_DFOCC_DENS, Q0_ref, true, true);
+        K->read_rows(psio_, PSIF_DFOCC_INTS, Q0_ref, true, true);
+        GFvvB->contract(true, false, nvirB, nvirB, nQl_ref * nvirB, K, G, 1.0, 1.0);
         G.reset();
         K.reset();
 
+        dist_.sum(GFvvA->data(), (size_t)nvirA * nvirA);
+        dist_.sum(GFvvB->data(), (size_t)nvirB * nvirB);
+
+        // Fab += \sum_{e} h_ae G_eb
+        GFvvA->gemm(true, false, HvvA, G1c_vvA, 1.0, 1.0);
+        GFvvB->gemm(true, false, HvvB, G1c_vvB, 1.0, 1.0);
+
+        if (reference == "ROHF" && orb_opt_ == "FALSE") {
+            // Fab += \sum_{m} h_am G_mb
+            GFvvA->gemm(false, false, HvoA, G1c_ovA, 1.0, 1.0);
+            GFvvB->gemm(false, false, HvoB, G1c_ovB, 1.0, 1.0);
+        }
+
         // Set global GF
         GFA->set_vv(noccA, GFvvA);
         GFB->set_vv(noccB, GFvvB);
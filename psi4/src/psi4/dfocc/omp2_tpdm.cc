@@ -39,19 +39,25 @@ namespace dfoccwave {
 void DFOCC::omp2_tpdm() {
     timer_on("tpdm");
     SharedTensor2d T, U;
+
+    // Each rank builds the rows of G_ia^Q for its own slab of the auxiliary index
+    int Q0, nQl;
+    dist_.slab(nQ, Q0, nQl);
+
     if (reference_ == "RESTRICTED") {
-        // G_ia^Q = 2\sum_{m,e} b_me^Q (2t_im^ae - t_mi^ae)
-        G2c_ia = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|IA)", nQ, naoccA * navirA));
+        // G_ia^Q = 2\sum_{m,e} b_me^Q (2t_im^ae - t_mi^ae), over this rank's slab of Q
+        G2c_ia = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|IA)", nQl, naoccA * navirA));
         u2p_1 = SharedTensor2d(new Tensor2d("U2_1 (ia|jb)", naoccA, navirA, naoccA, navirA));
         if (orb_opt_ == "FALSE" && mp2_amp_type_ == "DIRECT")
             u2_rmp2_direct(u2p_1);
         else
             u2p_1->read_symm(psio_, PSIF_DFOCC_AMPS);
-        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA * navirA));
-        bQiaA->read(psio_, PSIF_DFOCC_INTS);
+        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQl, naoccA * navirA));
+        bQiaA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
         G2c_ia->gemm(false, false, bQiaA, u2p_1, 2.0, 0.0);
         u2p_1.reset();
         bQiaA.reset();
+        G2c_ia = dist_gather_rows(G2c_ia, "Correlation 3-Index TPDM (Q|IA)", nQ, Q0);
 
         // G2c_ov = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA * nvirA));
         G2c_ov = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA, nvirA));
@@ -72,7 +78,7 @@ void DFOCC::omp2_tpdm() {
 
     else if (reference_ == "UNRESTRICTED") {
         // G_IA^Q = \sum_{M,E} b_ME^Q t_IM^AE
-        G2c_iaA = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|IA)", nQ, naoccA * navirA));
+        G2c_iaA = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|IA)", nQl, naoccA * navirA));
         t2p_1 = SharedTensor2d(new Tensor2d("T2_1 (IA|JB)", naoccA, navirA, naoccA, navirA));
         if (orb_opt_ == "FALSE" && mp2_amp_type_ == "DIRECT") {
             T = SharedTensor2d(new Tensor2d("T2_1 <IJ|AB>", naoccA, naoccA, navirA, navirA));
@@ -81,8 +87,8 @@ void DFOCC::omp2_tpdm() {
             T.reset();
         } else
             t2p_1->read_symm(psio_, PSIF_DFOCC_AMPS);
-        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA * navirA));
-        bQiaA->read(psio_, PSIF_DFOCC_INTS);
+        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQl, naoccA * navirA));
+        bQiaA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
         G2c_iaA->gemm(false, false, bQiaA, t2p_1, 1.0, 0.0);
         t2p_1.reset();
         bQiaA.reset();
@@ -96,12 +102,14 @@ void DFOCC::omp2_tpdm() {
             T.reset();
         } else
             t2p_1->read(psio_, PSIF_DFOCC_AMPS);
-        bQiaB = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ia)", nQ, naoccB * navirB));
-        bQiaB->read(psio_, PSIF_DFOCC_INTS);
+        bQiaB = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ia)", nQl, naoccB * navirB));
+        bQiaB->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
         G2c_iaA->gemm(false, true, bQiaB, t2p_1, 1.0, 1.0);
         t2p_1.reset();
         bQiaB.reset();
 
+        G2c_iaA = dist_gather_rows(G2c_iaA, "Correlation 3-Index TPDM (Q|IA)", nQ, Q0);
+
         // G_IA^Q -> G_OV^Q
         // G2c_ovA = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA * nvirA));
         G2c_ovA = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|OV)", nQ, noccA, nvirA));
@@ -120,7 +128,7 @@ void DFOCC::omp2_tpdm() {
         G2c_voA.reset();
 
         // G_ia^Q = \sum_{m,e} b_me^Q t_im^ae
-        G2c_iaB = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ia)", nQ, naoccB * navirB));
+        G2c_iaB = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ia)", nQl, naoccB * navirB));
         t2p_1 = SharedTensor2d(new Tensor2d("T2_1 (ia|jb)", naoccB, navirB, naoccB, navirB));
         if (orb_opt_ == "FALSE" && mp2_amp_type_ == "DIRECT") {
             T = SharedTensor2d(new Tensor2d("T2_1 <ij|ab>", naoccB, naoccB, navirB, navirB));
@@ -129,8 +137,8 @@ void DFOCC::omp2_tpdm() {
             T.reset();
         } else
             t2p_1->read_symm(psio_, PSIF_DFOCC_AMPS);
-        bQiaB = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ia)", nQ, naoccB * navirB));
-        bQiaB->read(psio_, PSIF_DFOCC_INTS);
+        bQiaB = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|ia)", nQl, naoccB * navirB));
+        bQiaB->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
         G2c_iaB->gemm(false, false, bQiaB, t2p_1, 1.0, 0.0);
         t2p_1.reset();
         bQiaB.reset();
@@ -145,12 +153,14 @@ void DFOCC::omp2_tpdm() {
             T.reset();
         } else
             t2p_1->read(psio_, PSIF_DFOCC_AMPS);
-        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQ, naoccA * navirA));
-        bQiaA->read(psio_, PSIF_DFOCC_INTS);
+        bQiaA = SharedTensor2d(new Tensor2d("DF_BASIS_CC B (Q|IA)", nQl, naoccA * navirA));
+        bQiaA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
         G2c_iaB->gemm(false, false, bQiaA, t2p_1, 1.0, 1.0);
         t2p_1.reset();
         bQiaA.reset();
 
+        G2c_iaB = dist_gather_rows(G2c_iaB, "Correlation 3-Index TPDM (Q|ia)", nQ, Q0);
+
         // G_ia^Q -> G_ov^Q
         // G2c_ovB = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ov)", nQ, noccB * nvirB));
         G2c_ovB = SharedTensor2d(new Tensor2d("Correlation 3-Index TPDM (Q|ov)", nQ, noccB, nvirB));
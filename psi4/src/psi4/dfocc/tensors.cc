@@ -28,6 +28,7 @@
 
 // Latest revision on April 38, 2013.
 #include <stdio.h>
+#include <algorithm>
 #include <fstream>
 #include <cmath>
 #include "psi4/libqt/qt.h"
@@ -832,6 +833,45 @@ void Tensor2d::gemm(bool transa, bool transb, const SharedTensor2d &a, const Sha
     }
 }  //
 
+void Tensor2d::gemm(bool transa, bool transb, Tensor2dStream &a, Tensor2dStream &b, double alpha, double beta) {
+    if (!transa || transb || a.dim1() != b.dim1() || a.nblocks() != b.nblocks()) {
+        throw PsiException("Tensor2d::gemm: streamed operands must share their row blocks", __FILE__, __LINE__);
+    }
+    int m = dim1_;
+    int n = dim2_;
+    if (!m || !n) return;
+    if (!a.dim1()) {
+        scale(beta);
+        return;
+    }
+    for (int blk = 0; blk < a.nblocks(); blk++) {
+        SharedTensor2d A = a.block(blk);
+        SharedTensor2d B = (&a == &b) ? A : b.block(blk);
+        int k = a.block_rows(blk);
+        C_DGEMM('t', 'n', m, n, k, alpha, &(A->A2d_[0][0]), m, &(B->A2d_[0][0]), n, (blk == 0 ? beta : 1.0),
+                &(A2d_[0][0]), n);
+    }
+}  //
+
+void Tensor2d::gemm(bool transa, bool transb, Tensor2dStream &a, const SharedTensor2d &b, double alpha,
+                    double beta) {
+    if (transa || a.dim1() != dim1_) {
+        throw PsiException("Tensor2d::gemm: streamed operand must share the rows of the target", __FILE__,
+                           __LINE__);
+    }
+    char tb = transb ? 't' : 'n';
+    int n = dim2_;
+    int k = a.dim2();
+    int ncb = transb ? k : n;
+    if (!n || !k) return;
+    for (int blk = 0; blk < a.nblocks(); blk++) {
+        SharedTensor2d A = a.block(blk);
+        int m = a.block_rows(blk);
+        C_DGEMM('n', tb, m, n, k, alpha, &(A->A2d_[0][0]), k, &(b->A2d_[0][0]), ncb, beta,
+                &(A2d_[a.block_start(blk)][0]), n);
+    }
+}  //
+
 void Tensor2d::contract(bool transa, bool transb, int m, int n, int k, const SharedTensor2d &a, const SharedTensor2d &b,
                         double alpha, double beta) {
     char ta = transa ? 't' : 'n';
@@ -2143,6 +2183,45 @@ void Tensor2d::read(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_i
 
 }  //
 
+void Tensor2d::read_rows(std::shared_ptr<psi::PSIO> psio, size_t fileno, int row_start, bool three_index,
+                         bool symm) {
+    if (dim1_ == 0 || dim2_ == 0) return;
+
+    // Packed three-index tensors keep the lower triangle of each row on disk
+    bool packed = three_index && symm;
+    size_t ncol = packed ? (size_t)d2_ * (d2_ + 1) / 2 : dim2_;
+    SharedTensor2d temp;
+    double *buffer = A2d_[0];
+    if (packed) {
+        temp = SharedTensor2d(new Tensor2d("temp", dim1_, ncol));
+        buffer = temp->A2d_[0];
+    }
+
+    // Check to see if the file is open
+    bool already_open = false;
+    if (psio->open_check(fileno))
+        already_open = true;
+    else
+        psio->open(fileno, PSIO_OPEN_OLD);
+    psio_address addr = psio_get_address(PSIO_ZERO, (size_t)row_start * ncol * sizeof(double));
+    psio->read(fileno, const_cast<char *>(name_.c_str()), (char *)buffer, (size_t)dim1_ * ncol * sizeof(double), addr,
+               &addr);
+    if (!already_open) psio->close(fileno, 1);  // Close and keep
+
+    if (packed) {
+#pragma omp parallel for
+        for (int R = 0; R < d1_; R++) {
+            for (int p = 0; p < d2_; p++) {
+                for (int q = 0; q < d3_; q++) {
+                    int pq = col_idx_[p][q];
+                    int pq_sym = index2(p, q);
+                    A2d_[R][pq] = temp->get(R, pq_sym);
+                }
+            }
+        }
+    }
+}  //
+
 void Tensor2d::read_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno) {
     // Form Lower triangular part
     int ntri_col = 0.5 * dim1_ * (dim1_ + 1);
@@ -2480,496 +2559,171 @@ double *Tensor2d::column_vector(int n) {
     return temp;
 }  //
 
-void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double beta) {
-    int d1 = A->d1_;
-    int d2 = A->d2_;
-    int d3 = A->d3_;
-    int d4 = A->d4_;
-
-    if (sort_type == 1243) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = col_idx_[s][r];
-                        A2d_[pq][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pq][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1324) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int qs = col_idx_[q][s];
-                        A2d_[pr][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1342) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int pr = row_idx_[p][r];
-                        int sq = col_idx_[s][q];
-                        A2d_[pr][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[pr][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1423) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        int qr = col_idx_[q][r];
-                        A2d_[ps][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][qr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 1432) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = col_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = row_idx_[p][s];
-                        A2d_[ps][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[ps][rq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2134) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        A2d_[qp][rs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][rs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2143) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = row_idx_[q][p];
-                        int sr = col_idx_[s][r];
-                        A2d_[qp][sr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qp][sr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2314) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int ps = col_idx_[p][s];
-                        A2d_[qr][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][ps]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2341) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qr = row_idx_[q][r];
-                        int sp = col_idx_[s][p];
-                        A2d_[qr][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qr][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2413) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int pr = col_idx_[p][r];
-                        A2d_[qs][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][pr]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 2431) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qs = row_idx_[q][s];
-                        int rp = col_idx_[r][p];
-                        A2d_[qs][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[qs][rp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3124) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int qs = col_idx_[q][s];
-                        A2d_[rp][qs] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][qs]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3142) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rp = row_idx_[r][p];
-                        int sq = col_idx_[s][q];
-                        A2d_[rp][sq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rp][sq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3214) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    int rq = row_idx_[r][q];
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int ps = col_idx_[p][s];
-                        A2d_[rq][ps] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][ps]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3241) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int rq = row_idx_[r][q];
-                        int sp = col_idx_[s][p];
-                        A2d_[rq][sp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rq][sp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3412) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        A2d_[rs][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][pq]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 3421) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int qp = col_idx_[q][p];
-                        A2d_[rs][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[rs][qp]);
-                    }
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 4123) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int qr = col_idx_[q][r];
-                        A2d_[sp][qr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][qr]);
-                    }
-                }
-            }
-        }
-    }
+namespace {
 
-    else if (sort_type == 4132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sp = row_idx_[s][p];
-                        int rq = col_idx_[r][q];
-                        A2d_[sp][rq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sp][rq]);
-                    }
-                }
-            }
-        }
-    }
+// Edge (in elements) of the square tiles used by permute4 when the index that
+// runs fastest in the source is not the one that runs fastest in the target.
+const int perm_tile = 32;
 
-    else if (sort_type == 4213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int pr = col_idx_[p][r];
-                        A2d_[sq][pr] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][pr]);
-                    }
-                }
-            }
-        }
+// Turn a sort_type such as 1432 into perm[k] = source index placed in target
+// slot k (0-based). Returns false unless sort_type is a permutation of 1..rank.
+bool decode_sort(int sort_type, int rank, int *perm) {
+    int seen = 0;
+    for (int k = rank - 1; k >= 0; k--) {
+        int digit = sort_type % 10;
+        sort_type /= 10;
+        if (digit < 1 || digit > rank || (seen & (1 << digit))) return false;
+        seen |= 1 << digit;
+        perm[k] = digit - 1;
     }
+    return sort_type == 0;
+}
 
-    else if (sort_type == 4231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sq = row_idx_[s][q];
-                        int rp = col_idx_[r][p];
-                        A2d_[sq][rp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sq][rp]);
+// Generic permutation kernel behind the sort routines:
+//   C[sum_k x_k sc_k] = alpha * A[sum_k x_k sa_k] + beta * C[sum_k x_k sc_k],  0 <= x_k < n_k
+// sa and sc are the element strides of each source index in A and in C. If the
+// fastest index of A and C coincide the copy is a set of strided axpy's; otherwise
+// the two fastest indices are blocked into perm_tile x perm_tile tiles so both the
+// reads and the writes of a tile stay in cache. Threads run over the outer
+// indices and the tiles together, so small outer dimensions still parallelize.
+void permute4(const int *n, const size_t *sa, const size_t *sc, const double *A, double *C, double alpha,
+              double beta) {
+    int ia = -1;
+    int ic = -1;
+    for (int k = 0; k < 4; k++) {
+        if (n[k] < 1) return;
+        if (n[k] == 1) continue;
+        if (ia < 0 || sa[k] < sa[ia]) ia = k;
+        if (ic < 0 || sc[k] < sc[ic]) ic = k;
+    }
+
+    // single element
+    if (ia < 0) {
+        C[0] = (beta == 0.0 ? 0.0 : beta * C[0]) + alpha * A[0];
+        return;
+    }
+
+    if (ia == ic) {
+        int o[3];
+        for (int k = 0, m = 0; k < 4; k++)
+            if (k != ia) o[m++] = k;
+        int n0 = n[o[0]];
+        int n1 = n[o[1]];
+        int n2 = n[o[2]];
+        int len = n[ia];
+        size_t inca = sa[ia];
+        size_t incc = sc[ia];
+
+#pragma omp parallel for collapse(3) schedule(static)
+        for (int x = 0; x < n0; x++) {
+            for (int y = 0; y < n1; y++) {
+                for (int z = 0; z < n2; z++) {
+                    const double *a = A + x * sa[o[0]] + y * sa[o[1]] + z * sa[o[2]];
+                    double *c = C + x * sc[o[0]] + y * sc[o[1]] + z * sc[o[2]];
+                    if (beta == 0.0) {
+                        for (int t = 0; t < len; t++) c[t * incc] = alpha * a[t * inca];
+                    } else {
+                        for (int t = 0; t < len; t++) c[t * incc] = alpha * a[t * inca] + beta * c[t * incc];
                     }
                 }
             }
         }
-    }
-
-    else if (sort_type == 4312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        A2d_[sr][pq] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][pq]);
+        return;
+    }
+
+    int o[2];
+    for (int k = 0, m = 0; k < 4; k++)
+        if (k != ia && k != ic) o[m++] = k;
+    int n0 = n[o[0]];
+    int n1 = n[o[1]];
+    int na = n[ia];
+    int nc = n[ic];
+    int ntile_a = (na + perm_tile - 1) / perm_tile;
+    int ntile_c = (nc + perm_tile - 1) / perm_tile;
+
+#pragma omp parallel for collapse(4) schedule(static)
+    for (int x = 0; x < n0; x++) {
+        for (int y = 0; y < n1; y++) {
+            for (int ta = 0; ta < ntile_a; ta++) {
+                for (int tc = 0; tc < ntile_c; tc++) {
+                    const double *a = A + x * sa[o[0]] + y * sa[o[1]];
+                    double *c = C + x * sc[o[0]] + y * sc[o[1]];
+                    int a0 = ta * perm_tile;
+                    int a1 = std::min(a0 + perm_tile, na);
+                    int c0 = tc * perm_tile;
+                    int c1 = std::min(c0 + perm_tile, nc);
+                    // writes are contiguous in the inner loop, reads are contiguous across it
+                    for (int i = a0; i < a1; i++) {
+                        const double *ai = a + i * sa[ia];
+                        double *ci = c + i * sc[ia];
+                        if (beta == 0.0) {
+                            for (int j = c0; j < c1; j++) ci[j * sc[ic]] = alpha * ai[j * sa[ic]];
+                        } else {
+                            for (int j = c0; j < c1; j++)
+                                ci[j * sc[ic]] = alpha * ai[j * sa[ic]] + beta * ci[j * sc[ic]];
+                        }
                     }
                 }
             }
         }
     }
+}
 
-    else if (sort_type == 4321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = A->row_idx_[p][q];
-                for (int r = 0; r < d3; r++) {
-                    for (int s = 0; s < d4; s++) {
-                        int rs = A->col_idx_[r][s];
-                        int sr = row_idx_[s][r];
-                        int qp = col_idx_[q][p];
-                        A2d_[sr][qp] = (alpha * A->A2d_[pq][rs]) + (beta * A2d_[sr][qp]);
-                    }
-                }
-            }
-        }
-    }
+}  // namespace
 
-    else {
+void Tensor2d::sort(int sort_type, const SharedTensor2d &A, double alpha, double beta) {
+    int perm[4];
+    if (!decode_sort(sort_type, 4, perm)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
+    // A(pq,rs): strides of p, q, r, s
+    int n[4] = {A->d1_, A->d2_, A->d3_, A->d4_};
+    size_t sa[4] = {(size_t)A->d2_ * A->dim2_, (size_t)A->dim2_, (size_t)A->d4_, 1};
+
+    // target slot k carries source index perm[k]
+    size_t slot[4] = {(size_t)d2_ * dim2_, (size_t)dim2_, (size_t)d4_, 1};
+    size_t sc[4];
+    for (int k = 0; k < 4; k++) sc[perm[k]] = slot[k];
+
+    permute4(n, sa, sc, A->A2d_[0], A2d_[0], alpha, beta);
 }  //
 
 void Tensor2d::sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    int qr = r + (q * d3);
-                    A2d_[p][rq] = (alpha * A->A2d_[p][qr]) + (beta * A2d_[p][rq]);
-                }
-            }
-        }
-    }
-
-    else {
+    int perm[3];
+    if (!decode_sort(sort_type, 3, perm) || perm[0] != 0) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
-}  //
-
-void Tensor2d::sort3b(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
-    if (sort_type == 132) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int pr = r + (p * d3);
-                    A2d_[pr][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[pr][q]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 213) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                int qp = p + (q * d1);
-                for (int r = 0; r < d3; r++) {
-                    A2d_[qp][r] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qp][r]);
-                }
-            }
-        }
-    }
-
-    else if (sort_type == 312) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rp = p + (r * d1);
-                    A2d_[rp][q] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rp][q]);
-                }
-            }
-        }
-    }
+    // A[p][qr], the trailing dummy index keeps permute4 four-dimensional
+    int n[4] = {d1, d2, d3, 1};
+    size_t sa[4] = {(size_t)A->dim2_, (size_t)d3, 1, 1};
 
-    else if (sort_type == 231) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int qr = r + (q * d3);
-                    A2d_[qr][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[qr][p]);
-                }
-            }
-        }
-    }
+    size_t slot[3] = {(size_t)dim2_, (size_t)n[perm[2]], 1};
+    size_t sc[4] = {0, 0, 0, 1};
+    for (int k = 0; k < 3; k++) sc[perm[k]] = slot[k];
 
-    else if (sort_type == 321) {
-#pragma omp parallel for
-        for (int p = 0; p < d1; p++) {
-            for (int q = 0; q < d2; q++) {
-                int pq = q + (p * d2);
-                for (int r = 0; r < d3; r++) {
-                    int rq = q + (r * d2);
-                    A2d_[rq][p] = (alpha * A->A2d_[pq][r]) + (beta * A2d_[rq][p]);
-                }
-            }
-        }
-    }
+    permute4(n, sa, sc, A->A2d_[0], A2d_[0], alpha, beta);
+}  //
 
-    else {
+void Tensor2d::sort3b(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta) {
+    int perm[3];
+    if (!decode_sort(sort_type, 3, perm)) {
         outfile->Printf("\tUnrecognized sort type!\n");
         throw PSIEXCEPTION("Unrecognized sort type!");
     }
 
+    // A[pq][r]
+    int n[4] = {d1, d2, d3, 1};
+    size_t sa[4] = {(size_t)d2 * A->dim2_, (size_t)A->dim2_, 1, 1};
+
+    size_t slot[3] = {(size_t)n[perm[1]] * dim2_, (size_t)dim2_, 1};
+    size_t sc[4] = {0, 0, 0, 1};
+    for (int k = 0; k < 3; k++) sc[perm[k]] = slot[k];
+
+    permute4(n, sa, sc, A->A2d_[0], A2d_[0], alpha, beta);
 }  //
 
 void Tensor2d::apply_denom(int frzc, int occ, const SharedTensor2d &fock) {
@@ -3939,6 +3693,14 @@ void Tensor2d::set_row(const SharedTensor2d &A, int n) {
     }
 }  //
 
+void Tensor2d::set_rows(const SharedTensor2d &A, int row_start) {
+    size_t size = (size_t)A->dim2_ * sizeof(double);
+#pragma omp parallel for
+    for (int R = 0; R < A->dim1_; R++) {
+        memcpy(A2d_[row_start + R], A->A2d_[R], size);
+    }
+}  //
+
 void Tensor2d::set_column(const SharedTensor2d &A, int n) {
 #pragma omp parallel for
     for (int i = 0; i < d1_; i++) {
@@ -6816,6 +6578,52 @@ void Tensor3i::set(int h, int i, int j, int value) { A3i_[h][i][j] = value; }  /
 
 int Tensor3i::get(int h, int i, int j) { return A3i_[h][i][j]; }  //
 
+/********************************************************************************************/
+/************************** Row-block stream of an on-disk Tensor2d *************************/
+/********************************************************************************************/
+Tensor2dStream::Tensor2dStream(size_t fileno, std::string name, int d1, int d2, int block_rows) {
+    fileno_ = fileno;
+    name_ = name;
+    dim1_ = d1;
+    dim2_ = d2;
+    block_rows_ = MAX0(1, MIN0(block_rows, d1));
+    nblocks_ = d1 ? (d1 + block_rows_ - 1) / block_rows_ : 0;
+    next_block_ = -1;
+    psio_ = std::make_shared<psi::PSIO>();
+    psio_->open(fileno_, PSIO_OPEN_OLD);
+}  //
+
+Tensor2dStream::~Tensor2dStream() {
+    if (pending_.valid()) pending_.wait();
+    psio_->close(fileno_, 1);
+}  //
+
+SharedTensor2d Tensor2dStream::read_block(int b) {
+    SharedTensor2d A = SharedTensor2d(new Tensor2d(name_, block_rows(b), dim2_));
+    psio_address addr = psio_get_address(PSIO_ZERO, (size_t)block_start(b) * dim2_ * sizeof(double));
+    A->read(psio_, fileno_, addr, &addr);
+    return A;
+}  //
+
+SharedTensor2d Tensor2dStream::block(int b) {
+    SharedTensor2d A;
+    if (pending_.valid()) pending_.get();
+    if (next_block_ == b && next_) {
+        A = next_;
+    } else {
+        A = read_block(b);
+    }
+    next_.reset();
+    next_block_ = -1;
+
+    // read ahead
+    if (b + 1 < nblocks_) {
+        next_block_ = b + 1;
+        pending_ = std::async(std::launch::async, [this]() { next_ = read_block(next_block_); });
+    }
+    return A;
+}  //
+
 /********************************************************************************************/
 /********************************************************************************************/
 }  // namespace dfoccwave
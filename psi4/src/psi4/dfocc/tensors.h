@@ -32,6 +32,8 @@
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/typedefs.h"
 
+#include <future>
+
 #define index2(i, j) ((i > j) ? ((i * (i + 1) / 2) + j) : ((j * (j + 1) / 2) + i))
 #define index4(i, j, k, l) index2(index2(i, j), index2(k, l))
 #define MIN0(a, b) (((a) < (b)) ? (a) : (b))
@@ -52,6 +54,7 @@ class Tensor3d;
 class Tensor1i;
 class Tensor2i;
 class Tensor3i;
+class Tensor2dStream;
 
 typedef std::shared_ptr<Tensor1d> SharedTensor1d;
 typedef std::shared_ptr<Tensor2d> SharedTensor2d;
@@ -170,6 +173,8 @@ class Tensor2d {
     void set(SharedTensor1d &A);
     // A2d_[n][ij] = A(i,j)
     void set_row(const SharedTensor2d &A, int n);
+    // A2d_[row_start + R][p] = A(R, p)
+    void set_rows(const SharedTensor2d &A, int row_start);
     // A2d_[ij][n] = A(i,j)
     void set_column(const SharedTensor2d &A, int n);
     double get(int i, int j);
@@ -226,6 +231,11 @@ class Tensor2d {
 
     // gemm: matrix multiplication C = A * B
     void gemm(bool transa, bool transb, const SharedTensor2d &a, const SharedTensor2d &b, double alpha, double beta);
+    // gemm over row blocks read from disk:
+    // C = alpha * A^T B + beta * C, A and B streamed over their common rows (transa = true, transb = false)
+    void gemm(bool transa, bool transb, Tensor2dStream &a, Tensor2dStream &b, double alpha, double beta);
+    // C = alpha * A B + beta * C, A and the rows of C streamed together (transa = false)
+    void gemm(bool transa, bool transb, Tensor2dStream &a, const SharedTensor2d &b, double alpha, double beta);
     // contract: general contraction C(m,n) = \sum_{k} A(m,k) * B(k,n)
     void contract(bool transa, bool transb, int m, int n, int k, const SharedTensor2d &a, const SharedTensor2d &b,
                   double alpha, double beta);
@@ -294,6 +304,8 @@ class Tensor2d {
     double *column_vector(int n);
     int dim1() const { return dim1_; }
     int dim2() const { return dim2_; }
+    // data: the contiguous dim1 x dim2 storage
+    double *data() { return A2d_[0]; }
 
     void write(std::shared_ptr<psi::PSIO> psio, size_t fileno);
     void write(std::shared_ptr<psi::PSIO> psio, size_t fileno, psio_address start, psio_address *end);
@@ -315,6 +327,9 @@ class Tensor2d {
     void read(psi::PSIO &psio, size_t fileno);
     void read(psi::PSIO &psio, size_t fileno, psio_address start, psio_address *end);
     void read(std::shared_ptr<psi::PSIO> psio, size_t fileno, bool three_index, bool symm);
+    // read_rows: rows [row_start, row_start + dim1) of the on-disk tensor with the same name
+    void read_rows(std::shared_ptr<psi::PSIO> psio, size_t fileno, int row_start, bool three_index = false,
+                   bool symm = false);
     void read_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno);
     void read_anti_symm(std::shared_ptr<psi::PSIO> psio, size_t fileno);
 
@@ -337,9 +352,9 @@ class Tensor2d {
     void myread(int fileno, size_t start);
 
     // sort (for example 1432 sort): A2d_(ps,rq) = A(pq,rs)
-    // A2d_ = alpha*A + beta*A2d_
+    // A2d_ = alpha*A + beta*A2d_, any permutation of 1234 is accepted
     void sort(int sort_type, const SharedTensor2d &A, double alpha, double beta);
-    // A2d_[p][qr] = sort(A[p][qr])
+    // A2d_[p][qr] = sort(A[p][qr]), sort_type 1xy
     void sort3a(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta);
     // A2d_[pq][r] = sort(A[pq][r])
     void sort3b(int sort_type, int d1, int d2, int d3, const SharedTensor2d &A, double alpha, double beta);
@@ -626,6 +641,36 @@ class Tensor3i {
     void set(int h, int i, int j, int value);
     int get(int h, int i, int j);
 };
+
+// Tensor2dStream: a (d1 x d2) Tensor2d written to disk with Tensor2d::write,
+// read back in blocks of block_rows rows.  block(b) also starts reading
+// block b+1 on a background thread, through a PSIO object of its own, so
+// the next block arrives while the current one is in use.  Nothing may
+// write to the file while the stream exists.
+class Tensor2dStream {
+   private:
+    std::shared_ptr<psi::PSIO> psio_;
+    size_t fileno_;
+    std::string name_;
+    int dim1_, dim2_, block_rows_, nblocks_;
+    SharedTensor2d next_;  // block being prefetched
+    int next_block_;
+    std::future<void> pending_;
+
+    SharedTensor2d read_block(int b);
+
+   public:
+    Tensor2dStream(size_t fileno, std::string name, int d1, int d2, int block_rows);
+    ~Tensor2dStream();
+
+    int dim1() const { return dim1_; }
+    int dim2() const { return dim2_; }
+    int nblocks() const { return nblocks_; }
+    int block_start(int b) const { return b * block_rows_; }
+    int block_rows(int b) const { return MIN0(block_rows_, dim1_ - b * block_rows_); }
+    // rows [block_start(b), block_start(b) + block_rows(b)) as a Tensor2d
+    SharedTensor2d block(int b);
+};
 }  // namespace dfoccwave
 }  // namespace psi
 #endif  // _dfocc_tensors_h_
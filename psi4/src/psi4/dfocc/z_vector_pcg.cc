@@ -518,38 +518,31 @@ void DFOCC::pcg_solver_uhf() {
 //          Sigma (RHF)
 //=======================================================
 void DFOCC::sigma_rhf(SharedTensor1d& sigma, SharedTensor1d& p_vec) {
+    // Each rank contracts its own slab of the auxiliary index; the partial
+    // sigma vectors are summed before the diagonal Fock term is added
+    int Q0, nQl;
+    dist_.slab(nQ_ref, Q0, nQl);
+
     // Build sigma0
     // Memalloc
     SharedTensor2d SvoA = SharedTensor2d(new Tensor2d("PCG Sigma <V|O>", nvirA, noccA));
-    SharedTensor1d pQ = SharedTensor1d(new Tensor1d("DF_BASIS_SCF p_Q", nQ_ref));
+    SharedTensor1d pQ = SharedTensor1d(new Tensor1d("DF_BASIS_SCF p_Q", nQl));
     SharedTensor2d PvoA = SharedTensor2d(new Tensor2d("PCG P <V|O>", nvirA, noccA));
     PvoA->set(p_vec);
 
-// Build sigma
-// s_ai = 2 \sum_{b} f_ab p_bi - 2 \sum_{j} f_ij p_aj  = 2 (f_aa - f_ii) p_ai
-// SvoA->gemm(false, false, FvvA, PvoA, 2.0, 0.0);
-// SvoA->gemm(false, false, PvoA, FooA, -2.0, 1.0);
-#pragma omp parallel for
-    for (int a = 0; a < nvirA; a++) {
-        for (int i = 0; i < noccA; i++) {
-            double value = FockA->get(a + noccA, a + noccA) - FockA->get(i, i);
-            SvoA->set(a, i, 2.0 * value * PvoA->get(a, i));
-        }
-    }
-
     // p_Q = 2\sum_{bj} b_bj^Q p_bj
-    bQovA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQ_ref, noccA, nvirA));
-    bQovA->read(psio_, PSIF_DFOCC_INTS);
-    SharedTensor2d bQvoA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VO)", nQ_ref, nvirA, noccA));
+    bQovA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQl, noccA, nvirA));
+    bQovA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+    SharedTensor2d bQvoA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VO)", nQl, nvirA, noccA));
     bQvoA->swap_3index_col(bQovA);
     bQovA.reset();
     pQ->gemv(false, bQvoA, p_vec, 2.0, 0.0);
 
-    // s_ai += 4 \sum_{Q} bai^Q p^Q
-    SvoA->gemv(true, bQvoA, pQ, 4.0, 1.0);
+    // s_ai = 4 \sum_{Q} bai^Q p^Q
+    SvoA->gemv(true, bQvoA, pQ, 4.0, 0.0);
 
     // p_ij^Q = \sum_{b} b_bi^Q p_bj = \su_{b} b_ib^Q p_bj
-    SharedTensor2d pQooA = SharedTensor2d(new Tensor2d("PCG P (Q|OO)", nQ_ref, noccA, noccA));
+    SharedTensor2d pQooA = SharedTensor2d(new Tensor2d("PCG P (Q|OO)", nQl, noccA, noccA));
     pQooA->contract323(true, false, noccA, noccA, bQvoA, PvoA, 1.0, 0.0);
 
     // s_ai += -2 \sum_{Q} \sum_{j} b_aj^Q p_ij^Q = b[Q](a,j) p'[Q](j,i)
@@ -558,19 +551,32 @@ void DFOCC::sigma_rhf(SharedTensor1d& sigma, SharedTensor1d& p_vec) {
     bQvoA.reset();
 
     // p_aj^Q = \sum_{b} b_ba^Q p_bj
-    bQvvA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQ_ref, nvirA, nvirA));
-    bQvvA->read(psio_, PSIF_DFOCC_INTS, true, true);
-    SharedTensor2d pQvoA = SharedTensor2d(new Tensor2d("PCG P (Q|VO)", nQ_ref, nvirA, noccA));
+    bQvvA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQl, nvirA, nvirA));
+    bQvvA->read_rows(psio_, PSIF_DFOCC_INTS, Q0, true, true);
+    SharedTensor2d pQvoA = SharedTensor2d(new Tensor2d("PCG P (Q|VO)", nQl, nvirA, noccA));
     pQvoA->contract323(false, false, nvirA, noccA, bQvvA, PvoA, 1.0, 0.0);
     bQvvA.reset();
 
     // s_ai += -2 \sum_{Q} \sum_{j} b_ij^Q p_aj^Q
-    bQooA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OO)", nQ_ref, noccA, noccA));
-    bQooA->read(psio_, PSIF_DFOCC_INTS);
+    bQooA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OO)", nQl, noccA, noccA));
+    bQooA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
     SvoA->contract332(false, false, noccA, pQvoA, bQooA, -2.0, 1.0);
     bQooA.reset();
     pQvoA.reset();
 
+    dist_.sum(SvoA->data(), (size_t)nvirA * noccA);
+
+// s_ai += 2 \sum_{b} f_ab p_bi - 2 \sum_{j} f_ij p_aj  = 2 (f_aa - f_ii) p_ai
+// SvoA->gemm(false, false, FvvA, PvoA, 2.0, 1.0);
+// SvoA->gemm(false, false, PvoA, FooA, -2.0, 1.0);
+#pragma omp parallel for
+    for (int a = 0; a < nvirA; a++) {
+        for (int i = 0; i < noccA; i++) {
+            double value = FockA->get(a + noccA, a + noccA) - FockA->get(i, i);
+            SvoA->add(a, i, 2.0 * value * PvoA->get(a, i));
+        }
+    }
+
     // Form sigma vector
     for (int a = 0, ai = 0; a < nvirA; a++) {
         for (int i = 0; i < noccA; i++, ai++) {
@@ -590,52 +596,44 @@ void DFOCC::sigma_rhf(SharedTensor1d& sigma, SharedTensor1d& p_vec) {
 //=======================================================
 void DFOCC::sigma_uhf(SharedTensor1d& sigma_A, SharedTensor1d& sigma_B, SharedTensor1d& p_vecA,
                       SharedTensor1d& p_vecB) {
+    // Auxiliary-index slab of this rank, as in sigma_rhf
+    int Q0, nQl;
+    dist_.slab(nQ_ref, Q0, nQl);
+
     // Memalloc
     SharedTensor2d SvoA = SharedTensor2d(new Tensor2d("PCG Sigma <V|O>", nvirA, noccA));
     SharedTensor2d SvoB = SharedTensor2d(new Tensor2d("PCG Sigma <v|o>", nvirB, noccB));
     SharedTensor2d PvoA = SharedTensor2d(new Tensor2d("PCG P <V|O>", nvirA, noccA));
     SharedTensor2d PvoB = SharedTensor2d(new Tensor2d("PCG P <v|o>", nvirB, noccB));
-    SharedTensor1d pQ = SharedTensor1d(new Tensor1d("DF_BASIS_SCF p_Q", nQ_ref));
+    SharedTensor1d pQ = SharedTensor1d(new Tensor1d("DF_BASIS_SCF p_Q", nQl));
 
     // Build sigma
     PvoA->set(p_vecA);
     PvoB->set(p_vecB);
 
-// Build alpha sigma
-// s_AI = 2 \sum_{B} f_AB p_BI - 2 \sum_{J} f_IJ p_AJ
-// SvoA->gemm(false, false, FvvA, PvoA, 2.0, 0.0);
-// SvoA->gemm(false, false, PvoA, FooA, -2.0, 1.0);
-#pragma omp parallel for
-    for (int a = 0; a < nvirA; a++) {
-        for (int i = 0; i < noccA; i++) {
-            double value = FockA->get(a + noccA, a + noccA) - FockA->get(i, i);
-            SvoA->set(a, i, 2.0 * value * PvoA->get(a, i));
-        }
-    }
-
     // p_Q = \sum_{BJ} b_BJ^Q p_BJ + \sum_{bj} b_bj^Q p_bj
     // beta contribution
-    bQovB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQ_ref, noccB, nvirB));
-    bQovB->read(psio_, PSIF_DFOCC_INTS);
-    SharedTensor2d bQvoB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vo)", nQ_ref, nvirB, noccB));
+    bQovB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQl, noccB, nvirB));
+    bQovB->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+    SharedTensor2d bQvoB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vo)", nQl, nvirB, noccB));
     bQvoB->swap_3index_col(bQovB);
     bQovB.reset();
     pQ->gemv(false, bQvoB, p_vecB, 1.0, 0.0);
     bQvoB.reset();
 
     // alpha contribution
-    bQovA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQ_ref, noccA, nvirA));
-    bQovA->read(psio_, PSIF_DFOCC_INTS);
-    SharedTensor2d bQvoA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VO)", nQ_ref, nvirA, noccA));
+    bQovA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OV)", nQl, noccA, nvirA));
+    bQovA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+    SharedTensor2d bQvoA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VO)", nQl, nvirA, noccA));
     bQvoA->swap_3index_col(bQovA);
     bQovA.reset();
     pQ->gemv(false, bQvoA, p_vecA, 1.0, 1.0);
 
-    // s_AI += 4 \sum_{Q} b_AI^Q p^Q
-    SvoA->gemv(true, bQvoA, pQ, 4.0, 1.0);
+    // s_AI = 4 \sum_{Q} b_AI^Q p^Q
+    SvoA->gemv(true, bQvoA, pQ, 4.0, 0.0);
 
     // p_IJ^Q = \sum_{B} b_BI^Q p_BJ
-    SharedTensor2d pQooA = SharedTensor2d(new Tensor2d("PCG P (Q|OO)", nQ_ref, noccA, noccA));
+    SharedTensor2d pQooA = SharedTensor2d(new Tensor2d("PCG P (Q|OO)", nQl, noccA, noccA));
     pQooA->contract323(true, false, noccA, noccA, bQvoA, PvoA, 1.0, 0.0);
 
     // s_AI += -2 \sum_{Q} \sum_{J} b_AJ^Q p_IJ^Q
@@ -644,19 +642,32 @@ void DFOCC::sigma_uhf(SharedTensor1d& sigma_A, SharedTensor1d& sigma_B, SharedTe
     bQvoA.reset();
 
     // p_AJ^Q = \sum_{B} b_BA^Q p_BJ
-    bQvvA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQ_ref, nvirA, nvirA));
-    bQvvA->read(psio_, PSIF_DFOCC_INTS, true, true);
-    SharedTensor2d pQvoA = SharedTensor2d(new Tensor2d("PCG P (Q|VO)", nQ_ref, nvirA, noccA));
+    bQvvA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|VV)", nQl, nvirA, nvirA));
+    bQvvA->read_rows(psio_, PSIF_DFOCC_INTS, Q0, true, true);
+    SharedTensor2d pQvoA = SharedTensor2d(new Tensor2d("PCG P (Q|VO)", nQl, nvirA, noccA));
     pQvoA->contract323(false, false, nvirA, noccA, bQvvA, PvoA, 1.0, 0.0);
     bQvvA.reset();
 
     // s_AI += -2 \sum_{Q} \sum_{J} b_IJ^Q p_AJ^Q
-    bQooA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OO)", nQ_ref, noccA * noccA));
-    bQooA->read(psio_, PSIF_DFOCC_INTS);
+    bQooA = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|OO)", nQl, noccA * noccA));
+    bQooA->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
     SvoA->contract332(false, false, noccA, pQvoA, bQooA, -2.0, 1.0);
     bQooA.reset();
     pQvoA.reset();
 
+    dist_.sum(SvoA->data(), (size_t)nvirA * noccA);
+
+// s_AI += 2 \sum_{B} f_AB p_BI - 2 \sum_{J} f_IJ p_AJ
+// SvoA->gemm(false, false, FvvA, PvoA, 2.0, 1.0);
+// SvoA->gemm(false, false, PvoA, FooA, -2.0, 1.0);
+#pragma omp parallel for
+    for (int a = 0; a < nvirA; a++) {
+        for (int i = 0; i < noccA; i++) {
+            double value = FockA->get(a + noccA, a + noccA) - FockA->get(i, i);
+            SvoA->add(a, i, 2.0 * value * PvoA->get(a, i));
+        }
+    }
+
     // Form sigma vector
     for (int a = 0, ai = 0; a < nvirA; a++) {
         for (int i = 0; i < noccA; i++, ai++) {
@@ -666,29 +677,18 @@ void DFOCC::sigma_uhf(SharedTensor1d& sigma_A, SharedTensor1d& sigma_B, SharedTe
     PvoA.reset();
     SvoA.reset();
 
-// Build beta sigma
-// s_ai = 2 \sum_{b} f_ab p_bi - 2 \sum_{j} f_ij p_aj
-// SvoB->gemm(false, false, FvvB, PvoB, 2.0, 0.0);
-// SvoB->gemm(false, false, PvoB, FooB, -2.0, 1.0);
-#pragma omp parallel for
-    for (int a = 0; a < nvirB; a++) {
-        for (int i = 0; i < noccB; i++) {
-            double value = FockB->get(a + noccB, a + noccB) - FockB->get(i, i);
-            SvoB->set(a, i, 2.0 * value * PvoB->get(a, i));
-        }
-    }
-
-    // s_ai += 4 \sum_{Q} bai^Q p^Q
-    bQovB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQ_ref, noccB, nvirB));
-    bQovB->read(psio_, PSIF_DFOCC_INTS);
-    bQvoB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vo)", nQ_ref, nvirB, noccB));
+    // Build beta sigma
+    // s_ai = 4 \sum_{Q} bai^Q p^Q
+    bQovB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|ov)", nQl, noccB, nvirB));
+    bQovB->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
+    bQvoB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vo)", nQl, nvirB, noccB));
     bQvoB->swap_3index_col(bQovB);
     bQovB.reset();
-    SvoB->gemv(true, bQvoB, pQ, 4.0, 1.0);
+    SvoB->gemv(true, bQvoB, pQ, 4.0, 0.0);
     pQ.reset();
 
     // p_ij^Q = \sum_{b} b_bi^Q p_bj
-    SharedTensor2d pQooB = SharedTensor2d(new Tensor2d("PCG P (Q|oo)", nQ_ref, noccB, noccB));
+    SharedTensor2d pQooB = SharedTensor2d(new Tensor2d("PCG P (Q|oo)", nQl, noccB, noccB));
     pQooB->contract323(true, false, noccB, noccB, bQvoB, PvoB, 1.0, 0.0);
 
     // s_ai += -2 \sum_{Q} \sum_{j} b_aj^Q p_ij^Q
@@ -697,19 +697,32 @@ void DFOCC::sigma_uhf(SharedTensor1d& sigma_A, SharedTensor1d& sigma_B, SharedTe
     bQvoB.reset();
 
     // p_aj^Q = \sum_{b} b_ba^Q p_bj
-    bQvvB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vv)", nQ_ref, nvirB, nvirB));
-    bQvvB->read(psio_, PSIF_DFOCC_INTS, true, true);
-    SharedTensor2d pQvoB = SharedTensor2d(new Tensor2d("PCG P (Q|vo)", nQ_ref, nvirB, noccB));
+    bQvvB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|vv)", nQl, nvirB, nvirB));
+    bQvvB->read_rows(psio_, PSIF_DFOCC_INTS, Q0, true, true);
+    SharedTensor2d pQvoB = SharedTensor2d(new Tensor2d("PCG P (Q|vo)", nQl, nvirB, noccB));
     pQvoB->contract323(false, false, nvirB, noccB, bQvvB, PvoB, 1.0, 0.0);
     bQvvB.reset();
 
     // s_ai += -2 \sum_{Q} \sum_{j} b_ij^Q p_aj^Q
-    bQooB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|oo)", nQ_ref, noccB * noccB));
-    bQooB->read(psio_, PSIF_DFOCC_INTS);
+    bQooB = SharedTensor2d(new Tensor2d("DF_BASIS_SCF B (Q|oo)", nQl, noccB * noccB));
+    bQooB->read_rows(psio_, PSIF_DFOCC_INTS, Q0);
     SvoB->contract332(false, false, noccB, pQvoB, bQooB, -2.0, 1.0);
     bQooB.reset();
     pQvoB.reset();
 
+    dist_.sum(SvoB->data(), (size_t)nvirB * noccB);
+
+// s_ai += 2 \sum_{b} f_ab p_bi - 2 \sum_{j} f_ij p_aj
+// SvoB->gemm(false, false, FvvB, PvoB, 2.0, 1.0);
+// SvoB->gemm(false, false, PvoB, FooB, -2.0, 1.0);
+#pragma omp parallel for
+    for (int a = 0; a < nvirB; a++) {
+        for (int i = 0; i < noccB; i++) {
+            double value = FockB->get(a + noccB, a + noccB) - FockB->get(i, i);
+            SvoB->add(a, i, 2.0 * value * PvoB->get(a, i));
+        }
+    }
+
     // Form sigma vector
     for (int a = 0, ai = 0; a < nvirB; a++) {
         for (int i = 0; i < noccB; i++, ai++) {
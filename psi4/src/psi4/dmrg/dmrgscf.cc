@@ -47,10 +47,13 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libfock/jk.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/libqt/qt.h"
 #include "psi4/libmints/writer_file_prefix.h"
 //Header above allows to obtain "filename.moleculename" with psi::get_writer_file_prefix(std::string name)
 
 #include <stdlib.h>
+#include <cstdio>
 #include <sys/stat.h>
 #include <iostream>
 #include <fstream>
@@ -256,12 +259,191 @@ SharedMatrix print_rdm_ao( CheMPS2::DMRGSCFindices * idx, double * DMRG1DM, Shar
 }
 
 
-void buildHamDMRG( std::shared_ptr<IntegralTransform> ints, std::shared_ptr<MOSpace> Aorbs_ptr, CheMPS2::DMRGSCFmatrix * theTmatrix, CheMPS2::DMRGSCFmatrix * theQmatOCC, CheMPS2::DMRGSCFindices * iHandler, CheMPS2::Hamiltonian * HamDMRG, std::shared_ptr<PSIO> psio, std::shared_ptr<Wavefunction> wfn ){
+SharedMatrix buildAOorbitals( SharedMatrix Cmat, CheMPS2::DMRGSCFindices * iHandler, const char space, std::shared_ptr<Wavefunction> wfn, std::vector<int> & orbirrep, std::vector<int> & orbrel ){
+
+    // AO coefficients of one orbital space, blocked per irrep in the same order as the corresponding MOSpace
+    const int nirrep = wfn->nirrep();
+    const int nao    = wfn->basisset()->nbf();
+    SharedMatrix AO2SO = wfn->aotoso();
+    std::vector<int> start( nirrep );
+    std::vector<int> size( nirrep );
+    orbirrep.clear();
+    orbrel.clear();
+    for (int h = 0; h < nirrep; h++){
+        const int NOCC  = iHandler->getNOCC(h);
+        const int NDMRG = iHandler->getNDMRG(h);
+        switch ( space ){
+            case 'Q': start[h] = 0;            size[h] = NOCC + NDMRG;          break;
+            case 'S': start[h] = NOCC;         size[h] = NDMRG;                 break;
+            case 'T': start[h] = NOCC + NDMRG; size[h] = iHandler->getNVIRT(h); break;
+            default : start[h] = 0;            size[h] = iHandler->getNORB(h);  break;
+        }
+        for (int orb = 0; orb < size[h]; orb++){
+            orbirrep.push_back( h );
+            orbrel.push_back( start[h] + orb );
+        }
+    }
+    const int ncol = orbirrep.size();
+
+    SharedMatrix Cao; Cao = SharedMatrix( new Matrix( "AO orbitals", nao, ncol ) );
+    for (int h = 0, offset = 0; h < nirrep; h++){
+        const int nso = wfn->nsopi()[h];
+        if (( nso == 0 ) || ( size[h] == 0 )){ continue; }
+        C_DGEMM('N', 'N', nao, size[h], nso, 1.0, AO2SO->pointer(h)[0], nso, Cmat->pointer(h)[0] + start[h], Cmat->colspi()[h], 0.0, Cao->pointer()[0] + offset, ncol);
+        offset += size[h];
+    }
+    return Cao;
+
+}
+
+
+size_t dfChunkSize( const size_t resident, const size_t per_row, const size_t nrows ){
+
+    // Number of rows of a three-index tensor which fit next to the resident DF-tensors
+    const size_t total = Process::environment.get_memory() * 0.3 / sizeof(double);
+    const size_t avail = ( total > resident ) ? total - resident : 0;
+    size_t chunk = ( per_row > 0 ) ? avail / per_row : nrows;
+    if ( chunk < 1 ){ chunk = 1; }
+    if ( chunk > nrows ){ chunk = nrows; }
+    return chunk;
+
+}
+
+
+void buildHamDMRG_DF( std::shared_ptr<DFHelper> dfh, CheMPS2::DMRGSCFindices * iHandler, CheMPS2::Hamiltonian * HamDMRG, std::shared_ptr<Wavefunction> wfn ){
+
+    std::vector<int> Sirrep, Srel;
+    SharedMatrix Cact = buildAOorbitals( wfn->Ca(), iHandler, 'S', wfn, Sirrep, Srel );
+    const size_t nS = Sirrep.size();
+    if ( nS == 0 ){ return; }
+
+    dfh->clear_spaces();
+    dfh->add_space( "S", Cact );
+    dfh->add_transformation( "SSQ", "S", "S", "pqQ" );
+    dfh->transform();
+
+    const size_t nQ = dfh->get_naux();
+    SharedMatrix SSQ; SSQ = SharedMatrix( new Matrix( "SSQ", nS * nS, nQ ) );
+    dfh->fill_tensor( "SSQ", SSQ );
+    SharedMatrix SSSS = Matrix::doublet( SSQ, SSQ, false, true );
+    SSQ.reset();
+
+    double ** Vp = SSSS->pointer();
+    for (size_t p = 0; p < nS; p++){
+        for (size_t q = 0; q < nS; q++){
+            const int pqsym = Sirrep[p] ^ Sirrep[q];
+            for (size_t r = 0; r < nS; r++){
+                for (size_t s = 0; s < nS; s++){
+                    if (( Sirrep[r] ^ Sirrep[s] ) != pqsym ){ continue; }
+                    HamDMRG->setVmat( p, r, q, s, Vp[ p * nS + q ][ r * nS + s ] );
+                }
+            }
+        }
+    }
+
+}
+
+
+void fillRotatedTEI_coulomb_DF( std::shared_ptr<DFHelper> dfh, CheMPS2::DMRGSCFintegrals * theRotatedTEI, CheMPS2::DMRGSCFindices * iHandler, std::shared_ptr<Wavefunction> wfn ){
+
+    std::vector<int> Qirrep, Qrel, Airrep, Arel;
+    SharedMatrix Cocc = buildAOorbitals( wfn->Ca(), iHandler, 'Q', wfn, Qirrep, Qrel );
+    SharedMatrix Call = buildAOorbitals( wfn->Ca(), iHandler, 'A', wfn, Airrep, Arel );
+    const size_t nOA = Qirrep.size();
+    const size_t nA  = Airrep.size();
+    if ( nOA == 0 ){ return; }
+
+    dfh->clear_spaces();
+    dfh->add_space( "Q", Cocc );
+    dfh->add_space( "A", Call );
+    dfh->add_transformation( "QQQ", "Q", "Q", "pqQ" );
+    dfh->add_transformation( "AAQ", "A", "A", "pqQ" );
+    dfh->transform();
+
+    const size_t nQ = dfh->get_naux();
+    SharedMatrix QQQ; QQQ = SharedMatrix( new Matrix( "QQQ", nOA * nOA, nQ ) );
+    dfh->fill_tensor( "QQQ", QQQ );
+
+    // (QQ|AA) is assembled for a block of r at a time, with AAQ read from disk in chunks
+    const size_t chunk = dfChunkSize( nOA * nOA * nQ, nA * ( nQ + nOA * nOA ), nA );
+    SharedMatrix AAQ;  AAQ  = SharedMatrix( new Matrix( "AAQ", chunk * nA, nQ ) );
+    SharedMatrix QQAA; QQAA = SharedMatrix( new Matrix( "QQAA", nOA * nOA, chunk * nA ) );
+    double ** QQQp  = QQQ->pointer();
+    double ** AAQp  = AAQ->pointer();
+    double ** QQAAp = QQAA->pointer();
+
+    for (size_t start = 0; start < nA; start += chunk){
+        const size_t block = ( start + chunk > nA ) ? nA - start : chunk;
+        dfh->fill_tensor( "AAQ", AAQp[0], { start, start + block } );
+        C_DGEMM('N', 'T', nOA * nOA, block * nA, nQ, 1.0, QQQp[0], nQ, AAQp[0], nQ, 0.0, QQAAp[0], chunk * nA);
+        for (size_t p = 0; p < nOA; p++){
+            for (size_t q = 0; q < nOA; q++){
+                const int psym = Qirrep[p];
+                const int qsym = Qirrep[q];
+                for (size_t r = start; r < start + block; r++){
+                    const int rsym = Airrep[r];
+                    for (size_t s = 0; s < nA; s++){
+                        const int ssym = Airrep[s];
+                        if (( psym ^ qsym ^ rsym ^ ssym ) != 0 ){ continue; }
+                        theRotatedTEI->set_coulomb( psym, qsym, rsym, ssym, Qrel[p], Qrel[q], Arel[r], Arel[s], QQAAp[ p * nOA + q ][ ( r - start ) * nA + s ] );
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+
+void fillRotatedTEI_exchange_DF( std::shared_ptr<DFHelper> dfh, CheMPS2::DMRGSCFintegrals * theRotatedTEI, CheMPS2::DMRGSCFindices * iHandler, std::shared_ptr<Wavefunction> wfn ){
+
+    std::vector<int> Qirrep, Qrel, Tirrep, Trel;
+    SharedMatrix Cocc = buildAOorbitals( wfn->Ca(), iHandler, 'Q', wfn, Qirrep, Qrel );
+    SharedMatrix Cvir = buildAOorbitals( wfn->Ca(), iHandler, 'T', wfn, Tirrep, Trel );
+    const size_t nOA = Qirrep.size();
+    const size_t nT  = Tirrep.size();
+    if (( nOA == 0 ) || ( nT == 0 )){ return; }
+
+    dfh->clear_spaces();
+    dfh->add_space( "Q", Cocc );
+    dfh->add_space( "T", Cvir );
+    dfh->add_transformation( "TQQ", "T", "Q", "pqQ" );
+    dfh->transform();
+
+    const size_t nQ = dfh->get_naux();
+    SharedMatrix TQQ; TQQ = SharedMatrix( new Matrix( "TQQ", nT * nOA, nQ ) );
+    dfh->fill_tensor( "TQQ", TQQ );
+
+    // (TQ|TQ) is assembled for a block of p at a time
+    const size_t chunk = dfChunkSize( nT * nOA * nQ, nOA * nT * nOA, nT );
+    SharedMatrix TQTQ; TQTQ = SharedMatrix( new Matrix( "TQTQ", chunk * nOA, nT * nOA ) );
+    double ** TQQp  = TQQ->pointer();
+    double ** TQTQp = TQTQ->pointer();
+
+    for (size_t start = 0; start < nT; start += chunk){
+        const size_t block = ( start + chunk > nT ) ? nT - start : chunk;
+        C_DGEMM('N', 'T', block * nOA, nT * nOA, nQ, 1.0, TQQp[ start * nOA ], nQ, TQQp[0], nQ, 0.0, TQTQp[0], nT * nOA);
+        for (size_t p = start; p < start + block; p++){
+            const int psym = Tirrep[p];
+            for (size_t q = 0; q < nOA; q++){
+                const int qsym = Qirrep[q];
+                for (size_t r = 0; r < nT; r++){
+                    const int rsym = Tirrep[r];
+                    for (size_t s = 0; s < nOA; s++){
+                        const int ssym = Qirrep[s];
+                        if (( psym ^ qsym ^ rsym ^ ssym ) != 0 ){ continue; }
+                        theRotatedTEI->set_exchange( qsym, ssym, psym, rsym, Qrel[q], Qrel[s], Trel[p], Trel[r], TQTQp[ ( p - start ) * nOA + q ][ r * nOA + s ] );
+                    }
+                }
+            }
+        }
+    }
+
+}
+
+
+void buildHamDMRG( std::shared_ptr<IntegralTransform> ints, std::shared_ptr<DFHelper> dfh, std::shared_ptr<MOSpace> Aorbs_ptr, CheMPS2::DMRGSCFmatrix * theTmatrix, CheMPS2::DMRGSCFmatrix * theQmatOCC, CheMPS2::DMRGSCFindices * iHandler, CheMPS2::Hamiltonian * HamDMRG, std::shared_ptr<PSIO> psio, std::shared_ptr<Wavefunction> wfn ){
 
-    ints->update_orbitals();
-    // Since we don't regenerate the SO ints, we don't call sort_so_tei, and the OEI are not updated !!!!!
-    ints->transform_tei( Aorbs_ptr, Aorbs_ptr, Aorbs_ptr, Aorbs_ptr );
-    dpd_set_default(ints->get_dpd_id());
     const int nirrep = wfn->nirrep();
 
     // Econstant and one-electron integrals
@@ -282,6 +464,14 @@ void buildHamDMRG( std::shared_ptr<IntegralTransform> ints, std::shared_ptr<MOSp
     HamDMRG->setEconst( Econstant );
 
     // Two-electron integrals
+    if ( dfh ){
+        buildHamDMRG_DF( dfh, iHandler, HamDMRG, wfn );
+        return;
+    }
+    ints->update_orbitals();
+    // Since we don't regenerate the SO ints, we don't call sort_so_tei, and the OEI are not updated !!!!!
+    ints->transform_tei( Aorbs_ptr, Aorbs_ptr, Aorbs_ptr, Aorbs_ptr );
+    dpd_set_default(ints->get_dpd_id());
     dpdbuf4 K;
     psio->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
     global_dpd_->buf4_init(&K, PSIF_LIBTRANS_DPD, 0, ID("[S,S]"), ID("[S,S]"), ID("[S>=S]+"), ID("[S>=S]+"), 0, "MO Ints (SS|SS)");
@@ -473,6 +663,8 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
     const int ndmrg_dvdson_rtol       = options["DMRG_SWEEP_DVDSON_RTOL"].size();
     const bool dmrg_print_corr        = options.get_bool("DMRG_PRINT_CORR");
     const bool mps_chkpt              = options.get_bool("DMRG_MPS_WRITE");
+    const bool mps_warm_start         = options.get_bool("DMRG_SCF_WARM_START");
+    const bool dmrg_scf_df            = ( options.get_str("DMRG_SCF_TYPE").compare("DF") == 0 ) ? true : false;
     int * frozen_docc                 = options.get_int_array("RESTRICTED_DOCC");
     int * active                      = options.get_int_array("ACTIVE");
     const double d_convergence        = options.get_double("DMRG_SCF_GRAD_THR");
@@ -638,8 +830,22 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
 
     SharedMatrix work1; work1 = SharedMatrix( new Matrix("work1", nirrep, orbspi, orbspi) );
     SharedMatrix work2; work2 = SharedMatrix( new Matrix("work2", nirrep, orbspi, orbspi) );
-    std::shared_ptr<JK> myJK; myJK = std::make_shared<DiskJK>(wfn->basisset(), options);
-    myJK->set_cutoff(0.0);
+    std::shared_ptr<JK> myJK;
+    std::shared_ptr<DFHelper> dfh;
+    if ( dmrg_scf_df ){
+        // The memory is split evenly over the JK object, dfh, and the blocks of rotated integrals
+        const size_t df_doubles = Process::environment.get_memory() * 0.3 / sizeof(double);
+        myJK = JK::build_JK(wfn->basisset(), wfn->get_basisset("DF_BASIS_SCF"), options, "MEM_DF");
+        myJK->set_memory(df_doubles);
+        dfh = std::make_shared<DFHelper>(wfn->basisset(), wfn->get_basisset("DF_BASIS_SCF"));
+        dfh->set_memory(df_doubles);
+        dfh->set_method("STORE");
+        dfh->set_nthreads(Process::environment.get_n_threads());
+        dfh->initialize();
+    } else {
+        myJK = std::make_shared<DiskJK>(wfn->basisset(), options);
+        myJK->set_cutoff(0.0);
+    }
     myJK->initialize();
     SharedMatrix orig_coeff; orig_coeff = SharedMatrix( new Matrix( wfn->Ca() ) );
 
@@ -668,10 +874,21 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
     spaces.push_back( MOSpace::all );
     // CheMPS2 requires RHF or ROHF orbitals.
     std::shared_ptr<IntegralTransform> ints;
-    ints = std::shared_ptr<IntegralTransform>( new IntegralTransform( wfn, spaces, IntegralTransform::TransformationType::Restricted ) );
-    ints->set_keep_iwl_so_ints( true );
-    ints->set_keep_dpd_so_ints( true );
-    //ints->set_print(6);
+    if ( !dmrg_scf_df ){ // With DF, the rotated integrals are built from the three-index tensors of dfh
+        ints = std::shared_ptr<IntegralTransform>( new IntegralTransform( wfn, spaces, IntegralTransform::TransformationType::Restricted ) );
+        ints->set_keep_iwl_so_ints( true );
+        ints->set_keep_dpd_so_ints( true );
+        //ints->set_print(6);
+    }
+
+    // The MPS of the previous macro-iteration is the initial guess for the next one. CheMPS2 reads it from
+    // its checkpoint files, so leftovers from an unrelated run have to go when no checkpoint was requested.
+    const bool mps_use_chkpt = ( mps_chkpt || mps_warm_start );
+    if ( mps_use_chkpt && !mps_chkpt ){
+        for (int state = 0; state <= dmrg_which_root; state++){
+            std::remove( ( CheMPS2::DMRG_MPS_storage_prefix + std::to_string( state ) + ".h5" ).c_str() );
+        }
+    }
 
     (*outfile->stream()) << "###########################################################" << std::endl;
     (*outfile->stream()) << "###                                                     ###" << std::endl;
@@ -788,7 +1005,7 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
         update_WFNco( orig_coeff, iHandler, unitary, wfn, work1, work2 );
         buildTmatrix( theTmatrix, iHandler, psio, wfn->Ca(), wfn );
         buildQmatOCC( theQmatOCC, iHandler, work1, work2, wfn->Ca(), myJK, wfn );
-        buildHamDMRG( ints, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
+        buildHamDMRG( ints, dfh, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
 
         //Localize the active space and reorder the orbitals within each irrep based on the exchange matrix
         if (( dmrg_active_space.compare("LOC")==0 ) && (theDIIS==nullptr)){ //When the DIIS has started: stop
@@ -819,7 +1036,7 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
             update_WFNco( orig_coeff, iHandler, unitary, wfn, work1, work2 );
             buildTmatrix( theTmatrix, iHandler, psio, wfn->Ca(), wfn );
             buildQmatOCC( theQmatOCC, iHandler, work1, work2, wfn->Ca(), myJK, wfn );
-            buildHamDMRG( ints, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
+            buildHamDMRG( ints, dfh, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
             (*outfile->stream()) << "Rotated the active space to localized orbitals, sorted according to the exchange matrix." << std::endl;
 
         }
@@ -835,7 +1052,7 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
 
             for (int cnt = 0; cnt < nOrbDMRG_pow4; cnt++){ DMRG2DM[ cnt ] = 0.0; } //Clear the 2-RDM (to allow for state-averaged calculations)
             const std::string psi4TMPpath = PSIOManager::shared_object()->get_default_path();
-            CheMPS2::DMRG * theDMRG = new CheMPS2::DMRG(Prob, OptScheme, mps_chkpt, psi4TMPpath);
+            CheMPS2::DMRG * theDMRG = new CheMPS2::DMRG(Prob, OptScheme, mps_use_chkpt, psi4TMPpath);
             for (int state = -1; state < dmrg_which_root; state++){
                 if (state > -1){ theDMRG->newExcitation( std::fabs( Energy ) ); }
                 Energy = theDMRG->Solve();
@@ -886,8 +1103,13 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
         }
 
         buildQmatACT( theQmatACT, iHandler, DMRG1DM, work1, work2, wfn->Ca(), myJK, wfn );
-        fillRotatedTEI_coulomb(  ints, OAorbs_ptr, theRotatedTEI, iHandler, psio, wfn );
-        fillRotatedTEI_exchange( ints, OAorbs_ptr, Vorbs_ptr,  theRotatedTEI, iHandler, psio );
+        if ( dmrg_scf_df ){
+            fillRotatedTEI_coulomb_DF(  dfh, theRotatedTEI, iHandler, wfn );
+            fillRotatedTEI_exchange_DF( dfh, theRotatedTEI, iHandler, wfn );
+        } else {
+            fillRotatedTEI_coulomb(  ints, OAorbs_ptr, theRotatedTEI, iHandler, psio, wfn );
+            fillRotatedTEI_exchange( ints, OAorbs_ptr, Vorbs_ptr,  theRotatedTEI, iHandler, psio );
+        }
 
         {
             std::ofstream capturing;
@@ -995,7 +1217,7 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
         (*outfile->stream()) << "###                     ###" << std::endl;
         (*outfile->stream()) << "###########################" << std::endl;
 
-        buildHamDMRG( ints, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
+        buildHamDMRG( ints, dfh, Aorbs_ptr, theTmatrix, theQmatOCC, iHandler, HamDMRG, psio, wfn );
 
         double * contract = new double[ tot_dmrg_power6 ];
         double * three_dm = new double[ tot_dmrg_power6 ];
@@ -1074,8 +1296,13 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
            CheMPS2::CASSCF::construct_fock( theFmatrix, theTmatrix, theQmatOCC, theQmatACT, iHandler ); // Fock
        }
 
-       fillRotatedTEI_coulomb(  ints, OAorbs_ptr, theRotatedTEI, iHandler, psio, wfn );
-       fillRotatedTEI_exchange( ints, OAorbs_ptr, Vorbs_ptr,  theRotatedTEI, iHandler, psio );
+       if ( dmrg_scf_df ){
+           fillRotatedTEI_coulomb_DF(  dfh, theRotatedTEI, iHandler, wfn );
+           fillRotatedTEI_exchange_DF( dfh, theRotatedTEI, iHandler, wfn );
+       } else {
+           fillRotatedTEI_coulomb(  ints, OAorbs_ptr, theRotatedTEI, iHandler, psio, wfn );
+           fillRotatedTEI_exchange( ints, OAorbs_ptr, Vorbs_ptr,  theRotatedTEI, iHandler, psio );
+       }
 
        (*outfile->stream()) << "CASPT2 : Norm F - F_pseudocan = " << CheMPS2::CASSCF::deviation_from_blockdiag( theFmatrix, iHandler ) << std::endl;
        double E_CASPT2 = 0.0;
@@ -1114,6 +1341,12 @@ SharedWavefunction dmrg(SharedWavefunction wfn, Options& options)
 
     }
 
+    if ( mps_use_chkpt && !mps_chkpt ){
+        for (int state = 0; state <= dmrg_which_root; state++){
+            std::remove( ( CheMPS2::DMRG_MPS_storage_prefix + std::to_string( state ) + ".h5" ).c_str() );
+        }
+    }
+
     delete [] mem1;
     delete [] mem2;
     delete [] theupdate;
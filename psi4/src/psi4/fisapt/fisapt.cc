@@ -45,6 +45,7 @@
 #include "psi4/libpsi4util/process.h"
 #include "psi4/lib3index/dfhelper.h"
 
+#include <algorithm>
 #include <ctime>
 #include <functional>
 
@@ -2559,7 +2560,6 @@ void FISAPT::felst() {
     // => Sizing <= //
 
     std::shared_ptr<Molecule> mol = primary_->molecule();
-    int nn = primary_->nbf();
     int nA = mol->natom();
     int nB = mol->natom();
     int na = matrices_["Locc0A"]->colspi()[0];
@@ -2638,50 +2638,40 @@ void FISAPT::felst() {
 
     // => Nuclear Part (PITA) <= //
 
-    auto Zxyz2 = std::make_shared<Matrix>("Zxyz", 1, 4);
-    double** Zxyz2p = Zxyz2->pointer();
-    auto Vfact2 = std::make_shared<IntegralFactory>(primary_);
-    std::shared_ptr<PotentialInt> Vint2(static_cast<PotentialInt*>(Vfact2->ao_potential()));
-    Vint2->set_charge_field(Zxyz2);
-    auto Vtemp2 = std::make_shared<Matrix>("Vtemp2", nn, nn);
+    // Atoms are processed a thread-sized batch at a time to bound the stored potentials
+    size_t nbatch = std::max(1, nT);
 
     // => A <-> b <= //
 
-    for (int A = 0; A < nA; A++) {
-        if (ZAp[A] == 0.0) continue;
-        Vtemp2->zero();
-        Zxyz2p[0][0] = ZAp[A];
-        Zxyz2p[0][1] = mol->x(A);
-        Zxyz2p[0][2] = mol->y(A);
-        Zxyz2p[0][3] = mol->z(A);
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vbb =
-            Matrix::triplet(matrices_["Locc0B"], Vtemp2, matrices_["Locc0B"], true, false, false);
-        double** Vbbp = Vbb->pointer();
-        for (int b = 0; b < nb; b++) {
-            double E = 2.0 * Vbbp[b][b];
-            Elst10_terms[1] += E;
-            Ep[A][b + nB] += E;
+    for (size_t Astart = 0; Astart < nA; Astart += nbatch) {
+        size_t Astop = std::min((size_t)nA, Astart + nbatch);
+        std::vector<std::shared_ptr<Matrix> > Vbb =
+            build_nuclear_pots(vectors_["ZA"], Astart, Astop, matrices_["Locc0B"], matrices_["Locc0B"]);
+        for (size_t A = Astart; A < Astop; A++) {
+            if (ZAp[A] == 0.0) continue;
+            double** Vbbp = Vbb[A - Astart]->pointer();
+            for (int b = 0; b < nb; b++) {
+                double E = 2.0 * Vbbp[b][b];
+                Elst10_terms[1] += E;
+                Ep[A][b + nB] += E;
+            }
         }
     }
 
     // => a <-> B <= //
 
-    for (int B = 0; B < nB; B++) {
-        if (ZBp[B] == 0.0) continue;
-        Vtemp2->zero();
-        Zxyz2p[0][0] = ZBp[B];
-        Zxyz2p[0][1] = mol->x(B);
-        Zxyz2p[0][2] = mol->y(B);
-        Zxyz2p[0][3] = mol->z(B);
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vaa =
-            Matrix::triplet(matrices_["Locc0A"], Vtemp2, matrices_["Locc0A"], true, false, false);
-        double** Vaap = Vaa->pointer();
-        for (int a = 0; a < na; a++) {
-            double E = 2.0 * Vaap[a][a];
-            Elst10_terms[0] += E;
-            Ep[a + nA][B] += E;
+    for (size_t Bstart = 0; Bstart < nB; Bstart += nbatch) {
+        size_t Bstop = std::min((size_t)nB, Bstart + nbatch);
+        std::vector<std::shared_ptr<Matrix> > Vaa =
+            build_nuclear_pots(vectors_["ZB"], Bstart, Bstop, matrices_["Locc0A"], matrices_["Locc0A"]);
+        for (size_t B = Bstart; B < Bstop; B++) {
+            if (ZBp[B] == 0.0) continue;
+            double** Vaap = Vaa[B - Bstart]->pointer();
+            for (int a = 0; a < na; a++) {
+                double E = 2.0 * Vaap[a][a];
+                Elst10_terms[0] += E;
+                Ep[a + nA][B] += E;
+            }
         }
     }
 
@@ -2846,11 +2836,36 @@ void FISAPT::fexch() {
     auto E_exch3 = std::make_shared<Matrix>("E_exch [a <x-x> b]", na, nb);
     double** E_exch3p = E_exch3->pointer();
 
-    for (size_t a = 0; a < na; a++) {
-        dfh_->fill_tensor("Bab", TbQ, {a, a + 1});
-        for (size_t b = 0; b < nb; b++) {
-            dfh_->fill_tensor("Bba", TaQ, {b, b + 1}, {a, a + 1});
-            E_exch3p[a][b] -= 2.0 * C_DDOT(nQ, TbQp[b], 1, TaQp[0], 1);
+    // Read both tensors for a block of a at a time, rather than one (b, a) slice per pair
+    TrQ.reset();
+    TsQ.reset();
+    TbQ.reset();
+    TaQ.reset();
+
+    long int max_a = (long int)doubles_ / (2L * nb * nQ);
+    max_a = (max_a > na ? na : max_a);
+    if (max_a < 1L) {
+        throw PSIEXCEPTION("Too little static memory for FISAPT::fexch");
+    }
+
+    auto Bab = std::make_shared<Matrix>("Bab", max_a * nb, nQ);
+    auto Bba = std::make_shared<Matrix>("Bba", nb * max_a, nQ);
+    double** Babp = Bab->pointer();
+    double** Bbap = Bba->pointer();
+
+    for (size_t astart = 0; astart < na; astart += max_a) {
+        size_t nablock = (astart + max_a >= na ? na - astart : max_a);
+
+        dfh_->fill_tensor("Bab", Bab, {astart, astart + nablock});
+        dfh_->fill_tensor("Bba", Bba, {0, (size_t)nb}, {astart, astart + nablock});
+
+        long int nab = nablock * nb;
+
+#pragma omp parallel for schedule(static) num_threads(nT)
+        for (long int ab = 0L; ab < nab; ab++) {
+            size_t a = ab / nb;
+            size_t b = ab % nb;
+            E_exch3p[a + astart][b] -= 2.0 * C_DDOT(nQ, Babp[a * nb + b], 1, Bbap[b * nablock + a], 1);
         }
     }
 
@@ -2905,7 +2920,6 @@ void FISAPT::find() {
     // => Sizing <= //
 
     std::shared_ptr<Molecule> mol = primary_->molecule();
-    int nn = primary_->nbf();
     int nA = mol->natom();
     int nB = mol->natom();
     int na = matrices_["Locc0A"]->colspi()[0];
@@ -2947,35 +2961,23 @@ void FISAPT::find() {
 
     // => Nuclear Part (PITA) <= //
 
-    auto Zxyz2 = std::make_shared<Matrix>("Zxyz", 1, 4);
-    double** Zxyz2p = Zxyz2->pointer();
-    auto Vfact2 = std::make_shared<IntegralFactory>(primary_);
-    std::shared_ptr<PotentialInt> Vint2(static_cast<PotentialInt*>(Vfact2->ao_potential()));
-    Vint2->set_charge_field(Zxyz2);
-    auto Vtemp2 = std::make_shared<Matrix>("Vtemp2", nn, nn);
+    // Atoms are processed a thread-sized batch at a time to bound the stored potentials
+    size_t nbatch = std::max(1, nT);
 
-    double* ZAp = vectors_["ZA"]->pointer();
-    for (size_t A = 0; A < nA; A++) {
-        Vtemp2->zero();
-        Zxyz2p[0][0] = ZAp[A];
-        Zxyz2p[0][1] = mol->x(A);
-        Zxyz2p[0][2] = mol->y(A);
-        Zxyz2p[0][3] = mol->z(A);
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Vbs = Matrix::triplet(Cocc_B, Vtemp2, Cvir_B, true, false, false);
-        dfh_->write_disk_tensor("WAbs", Vbs, {A, A + 1});
+    for (size_t Astart = 0; Astart < nA; Astart += nbatch) {
+        size_t Astop = std::min((size_t)nA, Astart + nbatch);
+        std::vector<std::shared_ptr<Matrix> > Vbs = build_nuclear_pots(vectors_["ZA"], Astart, Astop, Cocc_B, Cvir_B);
+        for (size_t A = Astart; A < Astop; A++) {
+            dfh_->write_disk_tensor("WAbs", Vbs[A - Astart], {A, A + 1});
+        }
     }
 
-    double* ZBp = vectors_["ZB"]->pointer();
-    for (size_t B = 0; B < nB; B++) {
-        Vtemp2->zero();
-        Zxyz2p[0][0] = ZBp[B];
-        Zxyz2p[0][1] = mol->x(B);
-        Zxyz2p[0][2] = mol->y(B);
-        Zxyz2p[0][3] = mol->z(B);
-        Vint2->compute(Vtemp2);
-        std::shared_ptr<Matrix> Var = Matrix::triplet(Cocc_A, Vtemp2, Cvir_A, true, false, false);
-        dfh_->write_disk_tensor("WBar", Var, {B, B + 1});
+    for (size_t Bstart = 0; Bstart < nB; Bstart += nbatch) {
+        size_t Bstop = std::min((size_t)nB, Bstart + nbatch);
+        std::vector<std::shared_ptr<Matrix> > Var = build_nuclear_pots(vectors_["ZB"], Bstart, Bstop, Cocc_A, Cvir_A);
+        for (size_t B = Bstart; B < Bstop; B++) {
+            dfh_->write_disk_tensor("WBar", Var[B - Bstart], {B, B + 1});
+        }
     }
 
     // ==> DFHelper Setup (JKFIT Type, in Full Basis) <== //
@@ -3011,9 +3013,7 @@ void FISAPT::find() {
     for (size_t b = 0; b < nb; b++) {
         dfh_->fill_tensor("Abs", TsQ, {b, b + 1});
         C_DGEMM('N', 'T', na, ns, nQ, 2.0, RaCp[0], nQ, TsQp[0], nQ, 0.0, T1Asp[0], ns);
-        for (size_t a = 0; a < na; a++) {
-            dfh_->write_disk_tensor("WAbs", T1Asp[a], {nA + a, nA + a + 1}, {b, b + 1});
-        }
+        dfh_->write_disk_tensor("WAbs", T1As, {nA, nA + na}, {b, b + 1});
     }
 
     auto TrQ = std::make_shared<Matrix>("TrQ", nr, nQ);
@@ -3023,9 +3023,7 @@ void FISAPT::find() {
     for (size_t a = 0; a < na; a++) {
         dfh_->fill_tensor("Aar", TrQ, {a, a + 1});
         C_DGEMM('N', 'T', nb, nr, nQ, 2.0, RbDp[0], nQ, TrQp[0], nQ, 0.0, T1Brp[0], nr);
-        for (size_t b = 0; b < nb; b++) {
-            dfh_->write_disk_tensor("WBar", T1Brp[b], {nB + b, nB + b + 1}, {a, a + 1});
-        }
+        dfh_->write_disk_tensor("WBar", T1Br, {nB, nB + nb}, {a, a + 1});
     }
 
     // ==> Stack Variables <== //
@@ -3309,6 +3307,20 @@ void FISAPT::find() {
             throw PSIEXCEPTION("Too little static memory for FISAPT::induction");
         }
 
+        // All perturbations are solved together: every vector in flight holds a J, K, and
+        // right-hand C in the JK object plus its CG vectors, so reserve half for those
+        size_t nC_A = nB + nb;
+        size_t nC_B = nA + na;
+        long int vec_memory = 3L * nso * nso + 2L * std::max(na, nb) * nso + 4L * std::max(na * nr, nb * ns);
+        size_t max_vectors = (size_t)std::max(1L, (jk_memory / 2L) / vec_memory);
+        max_vectors = std::min(max_vectors, nC_A + nC_B);
+        jk_memory -= (long int)max_vectors * vec_memory;
+        // plus the perturbations and responses of all sources
+        jk_memory -= 2L * (nC_A + nC_B) * std::max(na * nr, nb * ns);
+        if (jk_memory < 0L) {
+            throw PSIEXCEPTION("Too little static memory for FISAPT::induction");
+        }
+
         std::shared_ptr<JK> jk =
             JK::build_JK(primary_, reference_->get_basisset("DF_BASIS_SCF"), options_, false, (size_t)jk_memory);
 
@@ -3318,79 +3330,80 @@ void FISAPT::find() {
         jk->initialize();
         jk->print_header();
 
-        // ==> Master Loop over perturbing atoms <== //
+        // ==> Responses to all perturbing atoms and orbitals <== //
 
-        int nC = std::max(nA + na, nB + nb);
+        auto cphf = std::make_shared<CPHF_FISAPT>();
 
-        for (size_t C = 0; C < nC; C++) {
-            if (C < nB + nb) dfh_->fill_tensor("WBar", wB, {C, C + 1});
-            if (C < nA + na) dfh_->fill_tensor("WAbs", wB, {C, C + 1});
+        // Effective constructor
+        cphf->delta_ = options_.get_double("D_CONVERGENCE");
+        cphf->maxiter_ = options_.get_int("MAXITER");
+        cphf->jk_ = jk;
+        cphf->max_vectors_ = max_vectors;
 
-            outfile->Printf("    Responses for (A <- Source B = %3d) and (B <- Source A = %3d)\n\n",
-                            (C < nB + nb ? C : nB + nb - 1), (C < nA + na ? C : nA + na - 1));
+        cphf->Cocc_A_ = Cocc_A;
+        cphf->Cvir_A_ = Cvir_A;
+        cphf->eps_occ_A_ = eps_occ_A;
+        cphf->eps_vir_A_ = eps_vir_A;
 
-            auto cphf = std::make_shared<CPHF_FISAPT>();
+        cphf->Cocc_B_ = Cocc_B;
+        cphf->Cvir_B_ = Cvir_B;
+        cphf->eps_occ_B_ = eps_occ_B;
+        cphf->eps_vir_B_ = eps_vir_B;
 
-            // Effective constructor
-            cphf->delta_ = options_.get_double("D_CONVERGENCE");
-            cphf->maxiter_ = options_.get_int("MAXITER");
-            cphf->jk_ = jk;
+        // Reversal of convention: A responds to the potential of the sources on B
+        for (size_t C = 0; C < nC_A; C++) {
+            auto wBC = std::make_shared<Matrix>("wB", na, nr);
+            dfh_->fill_tensor("WBar", wBC, {C, C + 1});
+            cphf->w_As_.push_back(wBC);
+        }
+        for (size_t C = 0; C < nC_B; C++) {
+            auto wAC = std::make_shared<Matrix>("wA", nb, ns);
+            dfh_->fill_tensor("WAbs", wAC, {C, C + 1});
+            cphf->w_Bs_.push_back(wAC);
+        }
 
-            cphf->w_A_ = wB;  // Reversal of convention
-            cphf->Cocc_A_ = Cocc_A;
-            cphf->Cvir_A_ = Cvir_A;
-            cphf->eps_occ_A_ = eps_occ_A;
-            cphf->eps_vir_A_ = eps_vir_A;
+        // Gogo CPKS
+        cphf->compute_cphf_block();
 
-            cphf->w_B_ = wA;  // Reversal of convention
-            cphf->Cocc_B_ = Cocc_B;
-            cphf->Cvir_B_ = Cvir_B;
-            cphf->eps_occ_B_ = eps_occ_B;
-            cphf->eps_vir_B_ = eps_vir_B;
+        for (size_t C = 0; C < nC_A; C++) {
+            xA = cphf->x_As_[C];
+            xA->scale(-1.0);
 
-            // Gogo CPKS
-            cphf->compute_cphf();
+            // Backtransform the amplitude to LO
+            std::shared_ptr<Matrix> x2A = Matrix::doublet(Uocc_A, xA, true, false);
+            double** x2Ap = x2A->pointer();
 
-            xA = cphf->x_A_;
-            xB = cphf->x_B_;
+            // Zip up the Ind20 contributions
+            for (int a = 0; a < na; a++) {
+                double Jval = 2.0 * C_DDOT(nr, x2Ap[a], 1, wBTp[a], 1);
+                double Kval = 2.0 * C_DDOT(nr, x2Ap[a], 1, uBTp[a], 1);
+                Ind20r_AB_termsp[a][C] = Jval;
+                Ind20r_AB += Jval;
+                ExchInd20r_AB_termsp[a][C] = Kval;
+                ExchInd20r_AB += Kval;
+                Indr_AB_termsp[a][C] = Jval + Kval;
+                Indr_AB += Jval + Kval;
+            }
+        }
 
-            xA->scale(-1.0);
+        for (size_t C = 0; C < nC_B; C++) {
+            xB = cphf->x_Bs_[C];
             xB->scale(-1.0);
 
-            if (C < nB + nb) {
-                // Backtransform the amplitude to LO
-                std::shared_ptr<Matrix> x2A = Matrix::doublet(Uocc_A, xA, true, false);
-                double** x2Ap = x2A->pointer();
+            // Backtransform the amplitude to LO
+            std::shared_ptr<Matrix> x2B = Matrix::doublet(Uocc_B, xB, true, false);
+            double** x2Bp = x2B->pointer();
 
-                // Zip up the Ind20 contributions
-                for (int a = 0; a < na; a++) {
-                    double Jval = 2.0 * C_DDOT(nr, x2Ap[a], 1, wBTp[a], 1);
-                    double Kval = 2.0 * C_DDOT(nr, x2Ap[a], 1, uBTp[a], 1);
-                    Ind20r_AB_termsp[a][C] = Jval;
-                    Ind20r_AB += Jval;
-                    ExchInd20r_AB_termsp[a][C] = Kval;
-                    ExchInd20r_AB += Kval;
-                    Indr_AB_termsp[a][C] = Jval + Kval;
-                    Indr_AB += Jval + Kval;
-                }
-            }
-
-            if (C < nA + na) {
-                // Backtransform the amplitude to LO
-                std::shared_ptr<Matrix> x2B = Matrix::doublet(Uocc_B, xB, true, false);
-                double** x2Bp = x2B->pointer();
-
-                // Zip up the Ind20 contributions
-                for (int b = 0; b < nb; b++) {
-                    double Jval = 2.0 * C_DDOT(ns, x2Bp[b], 1, wATp[b], 1);
-                    double Kval = 2.0 * C_DDOT(ns, x2Bp[b], 1, uATp[b], 1);
-                    Ind20r_BA_termsp[C][b] = Jval;
-                    Ind20r_BA += Jval;
-                    ExchInd20r_BA_termsp[C][b] = Kval;
-                    ExchInd20r_BA += Kval;
-                    Indr_BA_termsp[C][b] = Jval + Kval;
-                    Indr_BA += Jval + Kval;
-                }
+            // Zip up the Ind20 contributions
+            for (int b = 0; b < nb; b++) {
+                double Jval = 2.0 * C_DDOT(ns, x2Bp[b], 1, wATp[b], 1);
+                double Kval = 2.0 * C_DDOT(ns, x2Bp[b], 1, uATp[b], 1);
+                Ind20r_BA_termsp[C][b] = Jval;
+                Ind20r_BA += Jval;
+                ExchInd20r_BA_termsp[C][b] = Kval;
+                ExchInd20r_BA += Kval;
+                Indr_BA_termsp[C][b] = Jval + Kval;
+                Indr_BA += Jval + Kval;
             }
         }
 
@@ -3917,8 +3930,9 @@ void FISAPT::fdisp() {
 
     // ==> Master Loop <== //
 
+    bool do_sSAPT0 = options_.get_bool("SSAPT0_SCALE");
     double scale = 1.0;
-    if (options_.get_bool("SSAPT0_SCALE")) {
+    if (do_sSAPT0) {
         scale = sSAPT0_scale_;
     }
 
@@ -4003,8 +4017,7 @@ void FISAPT::fdisp() {
                 for (int a = 0; a < na; a++) {
                     for (int b = 0; b < nb; b++) {
                         E_exch_disp20Tp[a][b] -= 2.0 * T2abp[a][b] * V2abp[a][b];
-                        if (options_.get_bool("SSAPT0_SCALE"))
-                            sE_exch_disp20Tp[a][b] -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
+                        if (do_sSAPT0) sE_exch_disp20Tp[a][b] -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
                         ExchDisp20 -= 2.0 * T2abp[a][b] * V2abp[a][b];
                         sExchDisp20 -= scale * 2.0 * T2abp[a][b] * V2abp[a][b];
                     }
@@ -4054,6 +4067,53 @@ void FISAPT::fdisp() {
     outfile->Printf("\n");
     // fflush(outfile);
 }
+std::vector<std::shared_ptr<Matrix> > FISAPT::build_nuclear_pots(std::shared_ptr<Vector> Z, size_t start,
+                                                                  size_t stop, std::shared_ptr<Matrix> Cl,
+                                                                  std::shared_ptr<Matrix> Cr) {
+    std::shared_ptr<Molecule> mol = primary_->molecule();
+    int nn = primary_->nbf();
+
+    int nT = 1;
+#ifdef _OPENMP
+    nT = Process::environment.get_n_threads();
+#endif
+
+    auto Vfact = std::make_shared<IntegralFactory>(primary_);
+    std::vector<std::shared_ptr<Matrix> > Zxyz;
+    std::vector<std::shared_ptr<PotentialInt> > Vint;
+    std::vector<std::shared_ptr<Matrix> > Vtemp;
+    for (int t = 0; t < nT; t++) {
+        Zxyz.push_back(std::make_shared<Matrix>("Zxyz", 1, 4));
+        Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
+        Vint[t]->set_charge_field(Zxyz[t]);
+        Vtemp.push_back(std::make_shared<Matrix>("Vtemp", nn, nn));
+    }
+
+    double* Zp = Z->pointer();
+    std::vector<std::shared_ptr<Matrix> > V(stop - start);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nT)
+    for (size_t A = start; A < stop; A++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        if (Zp[A] == 0.0) {
+            V[A - start] = std::make_shared<Matrix>("V", Cl->colspi()[0], Cr->colspi()[0]);
+            continue;
+        }
+        double** Zxyzp = Zxyz[thread]->pointer();
+        Zxyzp[0][0] = Zp[A];
+        Zxyzp[0][1] = mol->x(A);
+        Zxyzp[0][2] = mol->y(A);
+        Zxyzp[0][3] = mol->z(A);
+        Vtemp[thread]->zero();
+        Vint[thread]->compute(Vtemp[thread]);
+        V[A - start] = Matrix::triplet(Cl, Vtemp[thread], Cr, true, false, false);
+    }
+
+    return V;
+}
 std::shared_ptr<Matrix> FISAPT::extract_columns(const std::vector<int>& cols, std::shared_ptr<Matrix> A) {
     int nm = A->rowspi()[0];
     int na = A->colspi()[0];
@@ -4318,7 +4378,7 @@ void FISAPTSCF::print_orbitals(const std::string& header, int start, std::shared
     outfile->Printf("\n\n");
 }
 
-CPHF_FISAPT::CPHF_FISAPT() {}
+CPHF_FISAPT::CPHF_FISAPT() : max_vectors_(0) {}
 CPHF_FISAPT::~CPHF_FISAPT() {}
 void CPHF_FISAPT::compute_cphf() {
     // Allocate
@@ -4461,6 +4521,120 @@ void CPHF_FISAPT::compute_cphf() {
 
     if (iter == maxiter_) throw PSIEXCEPTION("CPHF did not converge.");
 }
+void CPHF_FISAPT::compute_cphf_block() {
+    // Vectors [0, nA) are perturbations of A, [nA, nvec) of B
+    size_t nA = w_As_.size();
+    size_t nvec = nA + w_Bs_.size();
+    size_t max_active = (max_vectors_ == 0 ? nvec : max_vectors_);
+
+    std::vector<std::shared_ptr<Matrix> > w(w_As_);
+    w.insert(w.end(), w_Bs_.begin(), w_Bs_.end());
+
+    std::vector<std::shared_ptr<Matrix> > x(nvec);
+    std::vector<std::shared_ptr<Matrix> > r(nvec);
+    std::vector<std::shared_ptr<Matrix> > z(nvec);
+    std::vector<std::shared_ptr<Matrix> > p(nvec);
+    std::vector<double> zr_old(nvec, 0.0);
+    std::vector<double> b2(nvec, 0.0);
+    std::vector<int> niter(nvec, 0);
+
+    outfile->Printf("  ==> Block CPHF Iterations <==\n\n");
+
+    outfile->Printf("    Perturbations = %9zu\n", nvec);
+    outfile->Printf("    Max Vectors   = %9zu\n", max_active);
+    outfile->Printf("    Maxiter       = %9d\n", maxiter_);
+    outfile->Printf("    Convergence   = %9.3E\n", delta_);
+    outfile->Printf("\n");
+
+    time_t start;
+    time_t stop;
+
+    start = time(nullptr);
+
+    outfile->Printf("    -----------------------------------------------\n");
+    outfile->Printf("    %-4s %8s %10s  %11s  %8s\n", "Iter", "Active", "Converged", "Max Resid", "Time [s]");
+    outfile->Printf("    -----------------------------------------------\n");
+
+    std::vector<size_t> active;
+    size_t next = 0;
+    size_t nconv = 0;
+    int iter = 0;
+
+    while (nconv < nvec) {
+        // Pull pending perturbations into the slots freed by converged ones (x_0 = 0)
+        while (active.size() < max_active && next < nvec) {
+            size_t k = next++;
+            bool is_A = (k < nA);
+            x[k] = std::shared_ptr<Matrix>(w[k]->clone());
+            x[k]->zero();
+            b2[k] = sqrt(w[k]->vector_dot(w[k]));
+            if (b2[k] == 0.0) {
+                nconv++;
+                continue;
+            }
+            r[k] = std::shared_ptr<Matrix>(w[k]->clone());
+            z[k] = std::shared_ptr<Matrix>(w[k]->clone());
+            preconditioner(r[k], z[k], (is_A ? eps_occ_A_ : eps_occ_B_), (is_A ? eps_vir_A_ : eps_vir_B_));
+            p[k] = std::shared_ptr<Matrix>(z[k]->clone());
+            zr_old[k] = z[k]->vector_dot(r[k]);
+            active.push_back(k);
+        }
+        if (active.empty()) break;
+
+        std::vector<std::shared_ptr<Matrix> > b;
+        std::vector<bool> is_A;
+        for (size_t k : active) {
+            b.push_back(p[k]);
+            is_A.push_back(k < nA);
+        }
+
+        std::vector<std::shared_ptr<Matrix> > s = product_block(b, is_A);
+        iter++;
+
+        size_t nactive = active.size();
+        double r2max = 0.0;
+        std::vector<size_t> remaining;
+        for (size_t ind = 0; ind < active.size(); ind++) {
+            size_t k = active[ind];
+            double alpha = r[k]->vector_dot(z[k]) / p[k]->vector_dot(s[ind]);
+            if (alpha < 0.0) {
+                throw PSIEXCEPTION(std::string(is_A[ind] ? "Monomer A" : "Monomer B") + ": A Matrix is not SPD");
+            }
+            x[k]->axpy(alpha, p[k]);
+            r[k]->axpy(-alpha, s[ind]);
+            double r2 = sqrt(r[k]->vector_dot(r[k])) / b2[k];
+            r2max = std::max(r2max, r2);
+            niter[k]++;
+
+            if (r2 <= delta_) {
+                nconv++;
+                r[k].reset();
+                z[k].reset();
+                p[k].reset();
+                continue;
+            }
+            if (niter[k] == maxiter_) throw PSIEXCEPTION("CPHF did not converge.");
+
+            preconditioner(r[k], z[k], (is_A[ind] ? eps_occ_A_ : eps_occ_B_), (is_A[ind] ? eps_vir_A_ : eps_vir_B_));
+            double zr_new = z[k]->vector_dot(r[k]);
+            double beta = zr_new / zr_old[k];
+            zr_old[k] = zr_new;
+            p[k]->scale(beta);
+            p[k]->add(z[k]);
+            remaining.push_back(k);
+        }
+        active = remaining;
+
+        stop = time(nullptr);
+        outfile->Printf("    %-4d %8zu %10zu  %11.3E  %8ld\n", iter, nactive, nconv, r2max, stop - start);
+    }
+
+    outfile->Printf("    -----------------------------------------------\n");
+    outfile->Printf("\n");
+
+    x_As_.assign(x.begin(), x.begin() + nA);
+    x_Bs_.assign(x.begin() + nA, x.end());
+}
 void CPHF_FISAPT::preconditioner(std::shared_ptr<Matrix> r, std::shared_ptr<Matrix> z, std::shared_ptr<Vector> o,
                                  std::shared_ptr<Vector> v) {
     int no = o->dim();
@@ -4480,36 +4654,44 @@ void CPHF_FISAPT::preconditioner(std::shared_ptr<Matrix> r, std::shared_ptr<Matr
 }
 std::map<std::string, std::shared_ptr<Matrix> > CPHF_FISAPT::product(
     std::map<std::string, std::shared_ptr<Matrix> > b) {
+    std::vector<std::shared_ptr<Matrix> > bv;
+    std::vector<bool> is_A;
+    if (b.count("A")) {
+        bv.push_back(b["A"]);
+        is_A.push_back(true);
+    }
+    if (b.count("B")) {
+        bv.push_back(b["B"]);
+        is_A.push_back(false);
+    }
+
+    std::vector<std::shared_ptr<Matrix> > sv = product_block(bv, is_A);
+
     std::map<std::string, std::shared_ptr<Matrix> > s;
+    for (size_t ind = 0; ind < sv.size(); ind++) {
+        s[(is_A[ind] ? "A" : "B")] = sv[ind];
+    }
 
-    bool do_A = b.count("A");
-    bool do_B = b.count("B");
+    return s;
+}
+std::vector<std::shared_ptr<Matrix> > CPHF_FISAPT::product_block(const std::vector<std::shared_ptr<Matrix> >& b,
+                                                                 const std::vector<bool>& is_A) {
+    std::vector<std::shared_ptr<Matrix> > s;
 
     std::vector<SharedMatrix>& Cl = jk_->C_left();
     std::vector<SharedMatrix>& Cr = jk_->C_right();
     Cl.clear();
     Cr.clear();
 
-    if (do_A) {
-        Cl.push_back(Cocc_A_);
-        int no = b["A"]->nrow();
-        int nv = b["A"]->ncol();
-        int nso = Cvir_A_->nrow();
-        double** Cp = Cvir_A_->pointer();
-        double** bp = b["A"]->pointer();
-        auto T = std::make_shared<Matrix>("T", nso, no);
-        double** Tp = T->pointer();
-        C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
-        Cr.push_back(T);
-    }
-
-    if (do_B) {
-        Cl.push_back(Cocc_B_);
-        int no = b["B"]->nrow();
-        int nv = b["B"]->ncol();
-        int nso = Cvir_B_->nrow();
-        double** Cp = Cvir_B_->pointer();
-        double** bp = b["B"]->pointer();
+    for (size_t ind = 0; ind < b.size(); ind++) {
+        std::shared_ptr<Matrix> Cocc = (is_A[ind] ? Cocc_A_ : Cocc_B_);
+        std::shared_ptr<Matrix> Cvir = (is_A[ind] ? Cvir_A_ : Cvir_B_);
+        Cl.push_back(Cocc);
+        int no = b[ind]->nrow();
+        int nv = b[ind]->ncol();
+        int nso = Cvir->nrow();
+        double** Cp = Cvir->pointer();
+        double** bp = b[ind]->pointer();
         auto T = std::make_shared<Matrix>("T", nso, no);
         double** Tp = T->pointer();
         C_DGEMM('N', 'T', nso, no, nv, 1.0, Cp[0], nv, bp[0], nv, 0.0, Tp[0], no);
@@ -4521,67 +4703,40 @@ std::map<std::string, std::shared_ptr<Matrix> > CPHF_FISAPT::product(
     const std::vector<SharedMatrix>& J = jk_->J();
     const std::vector<SharedMatrix>& K = jk_->K();
 
-    int indA = 0;
-    int indB = (do_A ? 1 : 0);
-
-    if (do_A) {
-        std::shared_ptr<Matrix> Jv = J[indA];
-        std::shared_ptr<Matrix> Kv = K[indA];
-        Jv->scale(4.0);
-        Jv->subtract(Kv);
-        Jv->subtract(Kv->transpose());
-
-        int no = b["A"]->nrow();
-        int nv = b["A"]->ncol();
-        int nso = Cvir_A_->nrow();
-        auto T = std::make_shared<Matrix>("T", no, nso);
-        s["A"] = std::make_shared<Matrix>("S", no, nv);
-        double** Cop = Cocc_A_->pointer();
-        double** Cvp = Cvir_A_->pointer();
-        double** Jp = Jv->pointer();
-        double** Tp = T->pointer();
-        double** Sp = s["A"]->pointer();
-        C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
-        C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
-
-        double** bp = b["A"]->pointer();
-        double* op = eps_occ_A_->pointer();
-        double* vp = eps_vir_A_->pointer();
-        for (int i = 0; i < no; i++) {
-            for (int a = 0; a < nv; a++) {
-                Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
-            }
-        }
-    }
+    for (size_t ind = 0; ind < b.size(); ind++) {
+        std::shared_ptr<Matrix> Cocc = (is_A[ind] ? Cocc_A_ : Cocc_B_);
+        std::shared_ptr<Matrix> Cvir = (is_A[ind] ? Cvir_A_ : Cvir_B_);
+        std::shared_ptr<Vector> eps_occ = (is_A[ind] ? eps_occ_A_ : eps_occ_B_);
+        std::shared_ptr<Vector> eps_vir = (is_A[ind] ? eps_vir_A_ : eps_vir_B_);
 
-    if (do_B) {
-        std::shared_ptr<Matrix> Jv = J[indB];
-        std::shared_ptr<Matrix> Kv = K[indB];
+        std::shared_ptr<Matrix> Jv = J[ind];
+        std::shared_ptr<Matrix> Kv = K[ind];
         Jv->scale(4.0);
         Jv->subtract(Kv);
         Jv->subtract(Kv->transpose());
 
-        int no = b["B"]->nrow();
-        int nv = b["B"]->ncol();
-        int nso = Cvir_B_->nrow();
+        int no = b[ind]->nrow();
+        int nv = b[ind]->ncol();
+        int nso = Cvir->nrow();
         auto T = std::make_shared<Matrix>("T", no, nso);
-        s["B"] = std::make_shared<Matrix>("S", no, nv);
-        double** Cop = Cocc_B_->pointer();
-        double** Cvp = Cvir_B_->pointer();
+        auto S = std::make_shared<Matrix>("S", no, nv);
+        double** Cop = Cocc->pointer();
+        double** Cvp = Cvir->pointer();
         double** Jp = Jv->pointer();
         double** Tp = T->pointer();
-        double** Sp = s["B"]->pointer();
+        double** Sp = S->pointer();
         C_DGEMM('T', 'N', no, nso, nso, 1.0, Cop[0], no, Jp[0], nso, 0.0, Tp[0], nso);
         C_DGEMM('N', 'N', no, nv, nso, 1.0, Tp[0], nso, Cvp[0], nv, 0.0, Sp[0], nv);
 
-        double** bp = b["B"]->pointer();
-        double* op = eps_occ_B_->pointer();
-        double* vp = eps_vir_B_->pointer();
+        double** bp = b[ind]->pointer();
+        double* op = eps_occ->pointer();
+        double* vp = eps_vir->pointer();
         for (int i = 0; i < no; i++) {
             for (int a = 0; a < nv; a++) {
                 Sp[i][a] += bp[i][a] * (vp[a] - op[i]);
             }
         }
+        s.push_back(S);
     }
 
     return s;
@@ -36,6 +36,7 @@
 
 #include <map>
 #include <tuple>
+#include <vector>
 
 namespace psi {
 
@@ -74,6 +75,9 @@ class FISAPT {
     std::shared_ptr<Matrix> build_exch_ind_pot(std::map<std::string, std::shared_ptr<Matrix> >& vars);
     // Build the Ind20 potential in the monomer A ov space
     std::shared_ptr<Matrix> build_ind_pot(std::map<std::string, std::shared_ptr<Matrix> >& vars);
+    // Build Cl^T V_A Cr for the nuclear potential of each atom A in [start, stop), threaded over atoms
+    std::vector<std::shared_ptr<Matrix> > build_nuclear_pots(std::shared_ptr<Vector> Z, size_t start, size_t stop,
+                                                             std::shared_ptr<Matrix> Cl, std::shared_ptr<Matrix> Cr);
 
     // DFHelper object
     std::shared_ptr<DFHelper> dfh_;
@@ -241,8 +245,24 @@ class CPHF_FISAPT {
     // Active vir orbital eigenvalues of B
     std::shared_ptr<Vector> eps_vir_B_;
 
+    // => Multiple Perturbations (compute_cphf_block) <= //
+
+    // Perturbations applied to A
+    std::vector<std::shared_ptr<Matrix> > w_As_;
+    // Responses of A
+    std::vector<std::shared_ptr<Matrix> > x_As_;
+    // Perturbations applied to B
+    std::vector<std::shared_ptr<Matrix> > w_Bs_;
+    // Responses of B
+    std::vector<std::shared_ptr<Matrix> > x_Bs_;
+    // Maximum number of unconverged vectors per JK call (0 for all)
+    size_t max_vectors_;
+
     // Form the s = Ab product for the provided vectors b (may or may not need more iterations)
     std::map<std::string, std::shared_ptr<Matrix> > product(std::map<std::string, std::shared_ptr<Matrix> > b);
+    // Form the s = Ab products for a list of vectors b of A (is_A true) or B (is_A false) in one JK call
+    std::vector<std::shared_ptr<Matrix> > product_block(const std::vector<std::shared_ptr<Matrix> >& b,
+                                                        const std::vector<bool>& is_A);
     // Apply the denominator from r into z
     void preconditioner(std::shared_ptr<Matrix> r, std::shared_ptr<Matrix> z, std::shared_ptr<Vector> o,
                         std::shared_ptr<Vector> v);
@@ -252,6 +272,8 @@ class CPHF_FISAPT {
     virtual ~CPHF_FISAPT();
 
     void compute_cphf();
+    // Solve for all of w_As_ and w_Bs_ together, converged vectors drop out of the JK calls
+    void compute_cphf_block();
 };
 
 }  // Namespace fisapt
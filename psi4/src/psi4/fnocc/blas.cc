@@ -27,9 +27,11 @@
  */
 
 #include "blas.h"
+#include <atomic>
 #include <stdlib.h>
 
 #include "psi4/pragma.h"
+#include "psi4/libqt/blas_backend.h"
 
 namespace psi {
 namespace fnocc {
@@ -49,13 +51,19 @@ void PSI_API F_DGEMV(char trans, integer m, integer n, doublereal alpha, doubler
                      integer incx, doublereal beta, doublereal* Y, integer incy) {
     DGEMV(trans, m, n, alpha, A, lda, X, incx, beta, Y, incy);
 }
+// running count of F_DGEMM floating-point operations; the triples call F_DGEMM from many threads
+static std::atomic<long long> dgemm_flops(0);
+
 /**
  * fortran-ordered dgemm
  */
 void PSI_API F_DGEMM(char transa, char transb, integer m, integer n, integer k, doublereal alpha, doublereal* A,
                      integer lda, doublereal* B, integer ldb, doublereal beta, doublereal* C, integer ldc) {
+    dgemm_flops += 2 * m * n * k;
+    if (blas::gemm_profiling.load(std::memory_order_relaxed)) blas::record_gemm(m, n, k);
     DGEMM(transa, transb, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
 }
+double F_DGEMM_flops() { return (double)dgemm_flops.load(); }
 
 /**
  *  Diagonalize a real symmetric matrix
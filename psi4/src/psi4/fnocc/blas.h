@@ -53,6 +53,11 @@ void PSI_API F_DGEMV(char trans, integer m, integer n, doublereal alpha, doubler
 void PSI_API F_DGEMM(char transa, char transb, integer m, integer n, integer k, doublereal alpha, doublereal *A,
                      integer lda, doublereal *B, integer ldb, doublereal beta, doublereal *C, integer ldc);
 
+/**
+ * floating-point operations issued through F_DGEMM so far
+ */
+double F_DGEMM_flops();
+
 /**
  * name mangling for fortran-ordered dgemv
  */
@@ -41,6 +41,7 @@
 #include "psi4/lib3index/3index.h"
 
 #include <ctime>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -439,6 +440,10 @@ PsiReturnType CoupledCluster::CCSDIterations() {
 
     bool timer = options_.get_bool("CC_TIMINGS");
 
+    // wall time and dgemm flops of each diagram, summed over iterations
+    std::vector<double> task_time(ncctasks, 0.0);
+    std::vector<double> task_flops(ncctasks, 0.0);
+
     double s1, e1;
     while (iter < maxiter) {
         time_t iter_start = time(nullptr);
@@ -446,12 +451,27 @@ PsiReturnType CoupledCluster::CCSDIterations() {
         // evaluate cc/qci diagrams
         memset((void *)w1, '\0', o * v * sizeof(double));
         if (timer) outfile->Printf("\n");
+        double iter_time = 0.0;
+        double iter_flops = 0.0;
         for (int i = 0; i < ncctasks; i++) {
-            if (timer) s1 = omp_get_wtime();
+            s1 = omp_get_wtime();
+            double f1 = F_DGEMM_flops();
             (*this.*CCTasklist[i].func)(CCParams[i]);
-            if (timer) outfile->Printf("        %s ... %6.2lf s\n", CCTasklist[i].name, omp_get_wtime() - s1);
+            e1 = omp_get_wtime() - s1;
+            CCTasklist[i].flopcount = F_DGEMM_flops() - f1;
+            task_time[i] += e1;
+            task_flops[i] += CCTasklist[i].flopcount;
+            iter_time += e1;
+            iter_flops += CCTasklist[i].flopcount;
+            if (timer)
+                outfile->Printf("        %s ... %6.2lf s %9.2lf GFLOP %8.2lf GFLOP/s\n", CCTasklist[i].name, e1,
+                                CCTasklist[i].flopcount / 1.0e9, e1 > 0.0 ? CCTasklist[i].flopcount / 1.0e9 / e1 : 0.0);
+        }
+        if (timer) {
+            outfile->Printf("        %-23s ... %6.2lf s %9.2lf GFLOP %8.2lf GFLOP/s\n", "total", iter_time,
+                            iter_flops / 1.0e9, iter_time > 0.0 ? iter_flops / 1.0e9 / iter_time : 0.0);
+            outfile->Printf("\n");
         }
-        if (timer) outfile->Printf("\n");
 
         // update the amplitudes
         Eold = eccsd;
@@ -509,6 +529,20 @@ PsiReturnType CoupledCluster::CCSDIterations() {
     double user_stop = ((double)total_tmstime.tms_utime) / clk_tck;
     double sys_stop = ((double)total_tmstime.tms_stime) / clk_tck;
 
+    // where the iterations went, diagram by diagram
+    if (timer) {
+        double total_time = 0.0;
+        for (int i = 0; i < ncctasks; i++) total_time += task_time[i];
+        outfile->Printf("\n");
+        outfile->Printf("  Diagram timings over %d iterations:\n", iter);
+        outfile->Printf("\n");
+        for (int i = 0; i < ncctasks; i++)
+            outfile->Printf("        %s ... %8.2lf s %5.1lf%% %10.2lf GFLOP %8.2lf GFLOP/s\n", CCTasklist[i].name,
+                            task_time[i], total_time > 0.0 ? 100.0 * task_time[i] / total_time : 0.0,
+                            task_flops[i] / 1.0e9, task_time[i] > 0.0 ? task_flops[i] / 1.0e9 / task_time[i] : 0.0);
+        outfile->Printf("\n");
+    }
+
     if (iter == maxiter) {
         if (isccsd)
             throw PsiException("  CCSD iterations did not converge.", __FILE__, __LINE__);
@@ -102,6 +102,16 @@ class CoupledCluster : public Wavefunction {
     PSI_API PsiReturnType lowmemory_triples();
     double et;
 
+    /// (ov|vv) integral slices for the low-memory (T) algorithm.  the
+    /// defaults read E2abci4 from disk; TriplesSliceInit returns the number
+    /// of virtual orbitals "a" per block (0 on failure), and TriplesSliceBlock
+    /// is called once before the (abc) with a in [a0,a1) are processed.
+    virtual long int TriplesSliceInit(int nthreads, long int memory);
+    virtual void TriplesSliceBlock(long int a0, long int a1);
+    virtual void TriplesSlice(long int x, long int y, double *buf, int thread);
+    virtual void TriplesSliceFinalize();
+    std::vector<std::shared_ptr<PSIO> > abci4_psio;
+
     /// mp4 triples
     void mp4_triples();
     double emp4_t;
@@ -241,9 +251,13 @@ class PSI_API DFCoupledCluster : public CoupledCluster {
 
     /// v^4 CC diagram
     virtual void Vabcd1();
+    /// v^4 CC diagram for a tile of consecutive a
+    void VabcdTile(long int a0, long int a1, double *Vcdb, double *Vp, double *Vm, double *A, double *S);
 
     /// workspace buffers.
     double *Abij, *Sbij;
+    /// length of the integrals buffer
+    long int integralsdim;
 
     /// check energy
     virtual double CheckEnergy();
@@ -255,6 +269,16 @@ class PSI_API DFCoupledCluster : public CoupledCluster {
     double *Qov, *Qvv, *Qoo;
     void ThreeIndexIntegrals();
 
+    /// assemble the (ov|vv) slices for low-memory (T) from Qvv and Qov in
+    /// blocks of "a" rather than writing E2abci4 to disk
+    bool isDFDirectTriples;
+    long int direct_a0, direct_a1;
+    double *Qvo_direct, *Wabci_direct, *Uabci_direct;
+    long int TriplesSliceInit(int nthreads, long int memory) override;
+    void TriplesSliceBlock(long int a0, long int a1) override;
+    void TriplesSlice(long int x, long int y, double *buf, int thread) override;
+    void TriplesSliceFinalize() override;
+
     /// more 3-index stuff for t1-transformed integrals
     double *Ca_L, *Ca_R, **Ca;
     double *Fij, *Fab, *Fia, *Fai;
@@ -36,6 +36,7 @@
 #include "psi4/libmints/mintshelper.h"
 
 #include <ctime>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -60,6 +61,8 @@ void DefineQuadraticTasks();
 // coupled cluster constructor
 DFCoupledCluster::DFCoupledCluster(SharedWavefunction ref_wfn, Options &options) : CoupledCluster(ref_wfn, options) {
     common_init();
+    isDFDirectTriples = false;
+    Qvo_direct = Wabci_direct = Uabci_direct = nullptr;
 }
 
 DFCoupledCluster::~DFCoupledCluster() {}
@@ -140,7 +143,7 @@ double DFCoupledCluster::compute_energy() {
             free(tempq);
             free(Z);
             free(Z2);
-        } else {
+        } else if (!isDFDirectTriples) {
             psio_address addr = PSIO_ZERO;
             double *temp1 = (double *)malloc((nQ * v > o * v * v ? nQ * v : o * v * v) * sizeof(double));
             double *temp2 = (double *)malloc(o * v * v * sizeof(double));
@@ -168,7 +171,8 @@ double DFCoupledCluster::compute_energy() {
             free(temp1);
             free(temp2);
         }
-        free(Qvv);
+        // the df-direct (t) assembles (ov|vv) from Qvv as it goes
+        if (!isDFDirectTriples) free(Qvv);
 
         double *temp1 = (double *)malloc(o * o * v * v * sizeof(double));
         double *temp2 = (double *)malloc(o * o * v * v * sizeof(double));
@@ -195,6 +199,19 @@ double DFCoupledCluster::compute_energy() {
         psio->write_entry(PSIF_DCC_IAJB, "E2iajb", (char *)&temp1[0], o * o * v * v * sizeof(double));
         psio->close(PSIF_DCC_IAJB, 1);
 
+        // Qvo_direct(a,i,Q) = Qov(Q,i,a) for the df-direct (t)
+        if (isDFDirectTriples) {
+            Qvo_direct = (double *)malloc(nQ * o * v * sizeof(double));
+#pragma omp parallel for schedule(static)
+            for (long int a = 0; a < v; a++) {
+                for (long int i = 0; i < o; i++) {
+                    for (long int q = 0; q < nQ; q++) {
+                        Qvo_direct[a * o * nQ + i * nQ + q] = Qov[q * o * v + i * v + a];
+                    }
+                }
+            }
+        }
+
         free(Qov);
         free(Qoo);
         free(temp1);
@@ -228,6 +245,11 @@ double DFCoupledCluster::compute_energy() {
         }
         tstop();
 
+        if (isDFDirectTriples) {
+            free(Qvv);
+            free(Qvo_direct);
+        }
+
         // if we allocated t2 just for triples, free it
         if (t2_on_disk) {
             free(tb);
@@ -648,10 +670,17 @@ void DFCoupledCluster::AllocateMemory() {
         if (mem_t > memory) {
             outfile->Printf("        <<< warning! >>> switched to low-memory (t) algorithm\n\n");
         }
-        if (mem_t > memory || options_.get_bool("TRIPLES_LOW_MEMORY")) {
+        if (mem_t > memory || options_.get_bool("TRIPLES_LOW_MEMORY") || options_.get_bool("TRIPLES_DF_DIRECT")) {
             isLowMemory = true;
             mem_t = 8. * (2L * o * o * v * v + o * o * o * v + o * v + 5L * o * o * o * nthreads);
-            outfile->Printf("        (T) part (low-memory alg.):      %9.2lf mb\n\n", mem_t / 1024. / 1024.);
+            outfile->Printf("        (T) part (low-memory alg.):      %9.2lf mb\n", mem_t / 1024. / 1024.);
+            if (options_.get_bool("TRIPLES_DF_DIRECT")) {
+                isDFDirectTriples = true;
+                // 3-index integrals plus at least one block of a
+                mem_t += 8. * (nQ * (v * v + o * v) + 2L * o * v * v);
+                outfile->Printf("        (T) part (df-direct alg.):       %9.2lf mb\n", mem_t / 1024. / 1024.);
+            }
+            outfile->Printf("\n");
         }
     }
     outfile->Printf("\n");
@@ -678,6 +707,7 @@ void DFCoupledCluster::AllocateMemory() {
     tempv = (double *)malloc(tempvdim * sizeof(double));
     Abij = (double *)malloc(o * (o + 1) / 2 * v * sizeof(double));
     Sbij = (double *)malloc(o * (o + 1) / 2 * v * sizeof(double));
+    integralsdim = dim;
     if (!t2_on_disk) {
         tb = (double *)malloc(o * o * v * v * sizeof(double));
     }
@@ -837,12 +867,6 @@ void DFCoupledCluster::Vabcd1() {
     psio->open(PSIF_DCC_R2, PSIO_OPEN_OLD);
     psio->read_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
 
-    int nthreads = Process::environment.get_n_threads();
-
-    double *Vcdb = integrals;
-    double *Vm = integrals + v * v * v;
-    double *Vp = Vm;
-
 // qvv transpose
 #pragma omp parallel for schedule(static)
     for (int q = 0; q < nQ; q++) {
@@ -850,80 +874,104 @@ void DFCoupledCluster::Vabcd1() {
     }
     C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
 
-    double time1 = 0.0;
-    double time2 = 0.0;
-    double time3 = 0.0;
-    for (long int a = 0; a < v; a++) {
-        double start1 = omp_get_wtime();
-        int nb = v - a;
-        F_DGEMM('t', 'n', v, v * nb, nQ, 1.0, Qvv + a * v * nQ, nQ, Qvv + a * v * nQ, nQ, 0.0, Vcdb, v);
+    // Tiles of consecutive a.  The (a,b>=a) columns of a whole tile go through one pair of
+    // ladder DGEMMs, which for large a would otherwise have only a handful of columns each.
+    // A tile is as wide as the integrals buffer allows: (ac|bd) for one a at a time, then
+    // per column the packed symmetric and antisymmetric parts and the two results.
+    long int percol = 2 * vtri + 2 * otri;
+    for (long int a0 = 0, a1; a0 < v; a0 = a1) {
+        long int ncols = 0;
+        for (a1 = a0; a1 < v && v * v * (v - a0) + (ncols + v - a1) * percol <= integralsdim; a1++) {
+            ncols += v - a1;
+        }
 
-#pragma omp parallel for schedule(static)
-        for (long int b = a; b < v; b++) {
-            long int cd = 0;
-            long int ind1 = (b - a) * vtri;
-            long int ind2 = (b - a) * v * v;
-            long int v1, v2;
-            for (long int c = 0; c < v; c++) {
-                for (long int d = 0; d <= c; d++) {
-                    Vp[ind1 + cd] = Vcdb[ind2 + d * v + c] + Vcdb[ind2 + c * v + d];
-                    cd++;
-                }
-            }
+        if (a1 == a0) {
+            // Not even one a fits: one a at a time, sharing the packed buffer, into Abij and Sbij
+            a1 = a0 + 1;
+            VabcdTile(a0, a1, integrals, integrals + v * v * v, integrals + v * v * v, Abij, Sbij);
+            continue;
         }
-        double end1 = omp_get_wtime();
+        double *Vp = integrals + v * v * (v - a0);
+        double *Vm = Vp + ncols * vtri;
+        double *A = Vm + ncols * vtri;
+        double *S = A + ncols * otri;
+        VabcdTile(a0, a1, integrals, Vp, Vm, A, S);
+    }
+
+    // contribute to residual
+    psio->write_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
+    psio->close(PSIF_DCC_R2, 1);
+
+// qvv un-transpose
+#pragma omp parallel for schedule(static)
+    for (int q = 0; q < nQ; q++) {
+        C_DCOPY(v * v, Qvv + q, nQ, integrals + q * v * v, 1);
+    }
+    C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
+}
+
+/**
+ *  Ladder contribution of the (a,b>=a) columns with a0 <= a < a1, added to the residual in tempv.
+ *  Vp and Vm hold the packed symmetric and antisymmetric (ac|bd) of every column; they may only
+ *  be the same buffer for a single a.
+ */
+void DFCoupledCluster::VabcdTile(long int a0, long int a1, double *Vcdb, double *Vp, double *Vm, double *A,
+                                 double *S) {
+    long int o = ndoccact;
+    long int v = nvirt;
+    long int oov = o * o * v;
+    long int oo = o * o;
+    long int otri = o * (o + 1) / 2;
+    long int vtri = v * (v + 1) / 2;
+    bool shared = (Vp == Vm);
+
+    // column of (a,b) is colstart[a-a0] + b - a
+    std::vector<long int> colstart(a1 - a0 + 1, 0);
+    for (long int a = a0; a < a1; a++) colstart[a - a0 + 1] = colstart[a - a0] + v - a;
+    long int ncols = colstart[a1 - a0];
 
-        double start2 = omp_get_wtime();
-        F_DGEMM('n', 'n', otri, nb, vtri, 0.5, tempt, otri, Vp, vtri, 0.0, Abij, otri);
+    auto pack = [&](long int a, double *V, double sign) {
 #pragma omp parallel for schedule(static)
         for (long int b = a; b < v; b++) {
             long int cd = 0;
-            long int ind1 = (b - a) * vtri;
+            long int ind1 = (colstart[a - a0] + b - a) * vtri;
             long int ind2 = (b - a) * v * v;
-            long int v1, v2;
             for (long int c = 0; c < v; c++) {
                 for (long int d = 0; d <= c; d++) {
-                    Vm[ind1 + cd] = Vcdb[ind2 + d * v + c] - Vcdb[ind2 + c * v + d];
+                    V[ind1 + cd] = Vcdb[ind2 + d * v + c] + sign * Vcdb[ind2 + c * v + d];
                     cd++;
                 }
             }
         }
-        F_DGEMM('n', 'n', otri, nb, vtri, 0.5, tempt + otri * vtri, otri, Vm, vtri, 0.0, Sbij, otri);
-        double end2 = omp_get_wtime();
+    };
 
-        // contribute to residual
-        double start3 = omp_get_wtime();
-#pragma omp parallel for schedule(static)
+    for (long int a = a0; a < a1; a++) {
+        int nb = v - a;
+        F_DGEMM('t', 'n', v, v * nb, nQ, 1.0, Qvv + a * v * nQ, nQ, Qvv + a * v * nQ, nQ, 0.0, Vcdb, v);
+        pack(a, Vp, 1.0);
+        if (!shared) pack(a, Vm, -1.0);
+    }
+
+    F_DGEMM('n', 'n', otri, ncols, vtri, 0.5, tempt, otri, Vp, vtri, 0.0, A, otri);
+    if (shared) pack(a0, Vm, -1.0);
+    F_DGEMM('n', 'n', otri, ncols, vtri, 0.5, tempt + otri * vtri, otri, Vm, vtri, 0.0, S, otri);
+
+    // contribute to residual
+#pragma omp parallel for schedule(dynamic)
+    for (long int a = a0; a < a1; a++) {
         for (long int b = a; b < v; b++) {
+            long int col = (colstart[a - a0] + b - a) * otri;
             for (long int i = 0; i < o; i++) {
                 for (long int j = 0; j < o; j++) {
                     int sg = (i > j) ? 1 : -1;
-                    tempv[a * oo * v + b * oo + i * o + j] +=
-                        Abij[(b - a) * otri + Position(i, j)] + sg * Sbij[(b - a) * otri + Position(i, j)];
+                    tempv[a * oov + b * oo + i * o + j] += A[col + Position(i, j)] + sg * S[col + Position(i, j)];
                     if (a != b) {
-                        tempv[b * oov + a * oo + i * o + j] +=
-                            Abij[(b - a) * otri + Position(i, j)] - sg * Sbij[(b - a) * otri + Position(i, j)];
+                        tempv[b * oov + a * oo + i * o + j] += A[col + Position(i, j)] - sg * S[col + Position(i, j)];
                     }
                 }
             }
         }
-        double end3 = omp_get_wtime();
-
-        time1 += end1 - start1;
-        time2 += end2 - start2;
-        time3 += end3 - start3;
     }
-
-    // contribute to residual
-    psio->write_entry(PSIF_DCC_R2, "residual", (char *)&tempv[0], o * o * v * v * sizeof(double));
-    psio->close(PSIF_DCC_R2, 1);
-
-// qvv un-transpose
-#pragma omp parallel for schedule(static)
-    for (int q = 0; q < nQ; q++) {
-        C_DCOPY(v * v, Qvv + q, nQ, integrals + q * v * v, 1);
-    }
-    C_DCOPY(nQ * v * v, integrals, 1, Qvv, 1);
 }
 }
 }  // end of namespaces
@@ -0,0 +1,139 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "ccsd.h"
+#include "blas.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/liboptions/liboptions.h"
+
+using namespace psi;
+
+namespace psi {
+namespace fnocc {
+
+/*
+ * DF-direct source of (ov|vv) slices for the low-memory (T) algorithm.
+ *
+ * the slice E2abci4[x][y](i,z) = (iy|xz) = sum_Q Qov(Q,iy) Qvv(Q,xz).  every
+ * (abc) visited by lowmemory_triples() needs the six slices [b][c], [a][c],
+ * [c][b], [b][a], [c][a], and [a][b].  for a block of a, the four that
+ * involve a are built up front with two large dgemms, and the other two
+ * ([b][c] and [c][b]) are built per (abc) from Qvv and Qvo_direct, which
+ * costs about nQ/(3 o^2) of the (T) work.
+ */
+long int DFCoupledCluster::TriplesSliceInit(int nthreads, long int memory) {
+    if (!isDFDirectTriples) return CoupledCluster::TriplesSliceInit(nthreads, memory);
+
+    long int o = ndoccact;
+    long int v = nvirt_no;
+
+    // Qvv and Qvo_direct are already allocated
+    memory -= 8L * nQ * (v * v + o * v);
+
+    // optional user cap on the blocks of integrals
+    long int cap = (long int)options_.get_int("TRIPLES_DF_DIRECT_MEMORY") * 1024L * 1024L;
+    if (cap > 0 && cap < memory) memory = cap;
+
+    long int per_a = 16L * o * v * v;
+    long int ablock = memory > 0 ? memory / per_a : 0;
+    if (ablock > v) ablock = v;
+
+    outfile->Printf("        (ov|vv) integrals assembled from 3-index integrals\n");
+    outfile->Printf("        3-index integrals:     %9.2lf mb\n", 8.0 * nQ * (v * v + o * v) / 1024. / 1024.);
+    if (ablock < 1) {
+        outfile->Printf("        Sorry, not enough memory for one block of virtual orbitals.\n");
+        outfile->Printf("        (T) requires at least %7.2lf mb more\n", (double)(per_a - memory) / 1024. / 1024.);
+        outfile->Printf("\n");
+        return 0;
+    }
+    outfile->Printf("        block memory:          %9.2lf mb\n", (double)ablock * per_a / 1024. / 1024.);
+    outfile->Printf("        virtuals per block:    %9li\n", ablock);
+    outfile->Printf("        number of blocks:      %9li\n", (v + ablock - 1) / ablock);
+    outfile->Printf("\n");
+
+    Wabci_direct = (double *)malloc(ablock * o * v * v * sizeof(double));
+    Uabci_direct = (double *)malloc(ablock * o * v * v * sizeof(double));
+    direct_a0 = direct_a1 = 0;
+
+    return ablock;
+}
+
+// build the slices [a][y] and [x][a] for a in [a0, a1)
+void DFCoupledCluster::TriplesSliceBlock(long int a0, long int a1) {
+    if (!isDFDirectTriples) {
+        CoupledCluster::TriplesSliceBlock(a0, a1);
+        return;
+    }
+
+    long int o = ndoccact;
+    long int v = nvirt_no;
+    long int na = a1 - a0;
+    direct_a0 = a0;
+    direct_a1 = a1;
+
+    // W(y,i,a,z) = (iy|az)
+    F_DGEMM('n', 'n', na * v, v * o, nQ, 1.0, Qvv + a0 * v, v * v, Qvo_direct, nQ, 0.0, Wabci_direct, na * v);
+    // U(a,i,x,z) = (ia|xz)
+    F_DGEMM('n', 'n', v * v, na * o, nQ, 1.0, Qvv, v * v, Qvo_direct + a0 * o * nQ, nQ, 0.0, Uabci_direct, v * v);
+}
+
+void DFCoupledCluster::TriplesSlice(long int x, long int y, double *buf, int thread) {
+    if (!isDFDirectTriples) {
+        CoupledCluster::TriplesSlice(x, y, buf, thread);
+        return;
+    }
+
+    long int o = ndoccact;
+    long int v = nvirt_no;
+    long int na = direct_a1 - direct_a0;
+
+    if (x >= direct_a0 && x < direct_a1) {
+        for (long int i = 0; i < o; i++) {
+            C_DCOPY(v, Wabci_direct + (y * o + i) * na * v + (x - direct_a0) * v, 1, buf + i * v, 1);
+        }
+    } else if (y >= direct_a0 && y < direct_a1) {
+        for (long int i = 0; i < o; i++) {
+            C_DCOPY(v, Uabci_direct + ((y - direct_a0) * o + i) * v * v + x * v, 1, buf + i * v, 1);
+        }
+    } else {
+        F_DGEMM('n', 'n', v, o, nQ, 1.0, Qvv + x * v, v * v, Qvo_direct + y * o * nQ, nQ, 0.0, buf, v);
+    }
+}
+
+void DFCoupledCluster::TriplesSliceFinalize() {
+    if (!isDFDirectTriples) {
+        CoupledCluster::TriplesSliceFinalize();
+        return;
+    }
+    free(Wabci_direct);
+    free(Uabci_direct);
+    Wabci_direct = Uabci_direct = nullptr;
+}
+}
+}  // end of namespaces
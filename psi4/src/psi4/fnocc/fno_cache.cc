@@ -0,0 +1,200 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/**
+  * Frozen natural orbital cache
+  *
+  * MP2 virtual natural orbitals (in the SO basis) and their occupation
+  * numbers are written to the scratch directory, keyed by basis, reference,
+  * frozen orbitals, and nuclear framework, so near-identical FNO jobs (cbs,
+  * nbody, findif) can skip the MP2 density.  on reuse, the cached NOs are
+  * projected onto the current virtual space and orthonormalized.
+  */
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "frozen_natural_orbitals.h"
+
+namespace psi {
+namespace fnocc {
+
+bool FrozenNO::UseNOCache() { return options_.exists("FNO_CACHE") && options_.get_bool("FNO_CACHE"); }
+
+std::string FrozenNO::NOCacheKey(const std::string& type) {
+    std::stringstream key;
+    key << type << ";" << basisset_->name() << ";" << nso << ";" << options_.get_str("REFERENCE") << ";";
+    key << molecule_->molecular_charge() << ";" << molecule_->multiplicity() << ";" << nirrep_ << ";";
+    for (int h = 0; h < nirrep_; h++) key << frzcpi_[h] << "," << frzvpi_[h] << "," << doccpi_[h] << ";";
+    for (int A = 0; A < molecule_->natom(); A++) key << molecule_->Z(A) << ",";
+    return key.str();
+}
+
+static std::string NOCacheFile(const std::string& key) {
+    char hash[32];
+    sprintf(hash, "%016zx", std::hash<std::string>()(key));
+    return PSIOManager::shared_object()->get_default_path() + "psi4.fno." + hash + ".cache";
+}
+
+/*
+ * U(h)[b][i] is the coefficient of canonical virtual b (column doccpi[h] + b
+ * of Ca) in natural orbital i, and occ the NO occupations in descending order
+ */
+void FrozenNO::WriteNOCache(const std::string& key, const int* virpi, SharedMatrix U, SharedVector occ,
+                            double emp2_os, double emp2_ss) {
+    std::ofstream out(NOCacheFile(key), std::ios::binary | std::ios::trunc);
+    if (!out.good()) {
+        outfile->Printf("        Could not write frozen natural orbital cache.\n\n");
+        return;
+    }
+
+    long int len = key.size();
+    out.write((char*)&len, sizeof(long int));
+    out.write(key.c_str(), len);
+
+    Matrix geom = molecule_->geometry();
+    int natom = molecule_->natom();
+    out.write((char*)&natom, sizeof(int));
+    for (int A = 0; A < natom; A++) out.write((char*)geom.pointer()[A], 3 * sizeof(double));
+
+    out.write((char*)&emp2_os, sizeof(double));
+    out.write((char*)&emp2_ss, sizeof(double));
+
+    for (int h = 0; h < nirrep_; h++) {
+        int v = virpi[h];
+        out.write((char*)&v, sizeof(int));
+        if (v == 0) continue;
+        out.write((char*)occ->pointer(h), v * sizeof(double));
+
+        // Cno = Cvir U
+        double** cp = Ca_->pointer(h);
+        double** up = U->pointer(h);
+        std::vector<double> row(v);
+        for (int mu = 0; mu < nsopi_[h]; mu++) {
+            for (int i = 0; i < v; i++) {
+                double dum = 0.0;
+                for (int b = 0; b < v; b++) dum += cp[mu][doccpi_[h] + b] * up[b][i];
+                row[i] = dum;
+            }
+            out.write((char*)row.data(), v * sizeof(double));
+        }
+    }
+    outfile->Printf("        Frozen natural orbitals written to cache.\n\n");
+}
+
+bool FrozenNO::ReadNOCache(const std::string& key, const int* virpi, SharedMatrix U, SharedVector occ,
+                           double& emp2_os, double& emp2_ss) {
+    std::ifstream in(NOCacheFile(key), std::ios::binary);
+    if (!in.good()) return false;
+
+    long int len = 0;
+    in.read((char*)&len, sizeof(long int));
+    if (!in.good() || len != (long int)key.size()) return false;
+    std::string stored(len, '\0');
+    in.read(&stored[0], len);
+    if (stored != key) return false;
+
+    // same nuclear framework, up to FNO_CACHE_DISPLACEMENT
+    Matrix geom = molecule_->geometry();
+    int natom = 0;
+    in.read((char*)&natom, sizeof(int));
+    if (natom != molecule_->natom()) return false;
+    double maxdisp = 0.0;
+    for (int A = 0; A < natom; A++) {
+        double xyz[3];
+        in.read((char*)xyz, 3 * sizeof(double));
+        for (int k = 0; k < 3; k++) maxdisp = std::max(maxdisp, std::fabs(xyz[k] - geom.get(A, k)));
+    }
+    double tol = options_.get_double("FNO_CACHE_DISPLACEMENT");
+    if (maxdisp > tol + 1.0e-10) return false;
+
+    double os, ss;
+    in.read((char*)&os, sizeof(double));
+    in.read((char*)&ss, sizeof(double));
+
+    std::shared_ptr<Matrix> S = S_;
+    for (int h = 0; h < nirrep_; h++) {
+        int v = 0;
+        in.read((char*)&v, sizeof(int));
+        if (!in.good() || v != virpi[h]) return false;
+        if (v == 0) continue;
+        in.read((char*)occ->pointer(h), v * sizeof(double));
+
+        long int n = nsopi_[h];
+        std::vector<double> Cno(n * v);
+        in.read((char*)Cno.data(), n * v * sizeof(double));
+        if (!in.good()) return false;
+
+        // U = Cvir^T S Cno
+        double** cp = Ca_->pointer(h);
+        double** sp = S->pointer(h);
+        double** up = U->pointer(h);
+        std::vector<double> SC(n * v);
+        for (long int mu = 0; mu < n; mu++) {
+            for (int i = 0; i < v; i++) {
+                double dum = 0.0;
+                for (long int nu = 0; nu < n; nu++) dum += sp[mu][nu] * Cno[nu * v + i];
+                SC[mu * v + i] = dum;
+            }
+        }
+        for (int b = 0; b < v; b++) {
+            for (int i = 0; i < v; i++) {
+                double dum = 0.0;
+                for (long int mu = 0; mu < n; mu++) dum += cp[mu][doccpi_[h] + b] * SC[mu * v + i];
+                up[b][i] = dum;
+            }
+        }
+    }
+
+    // the projection is only unitary at the cached geometry; orthonormalize: U (U^T U)^-1/2
+    auto M = Matrix::doublet(U, U, true, false);
+    M->power(-0.5);
+    auto Uorth = Matrix::doublet(U, M);
+    U->copy(Uorth);
+
+    emp2_os = os;
+    emp2_ss = ss;
+
+    outfile->Printf("        Frozen natural orbitals read from cache");
+    if (maxdisp > 1.0e-10) outfile->Printf(" (projected, max. displacement %8.2le bohr)", maxdisp);
+    outfile->Printf(".\n\n");
+    return true;
+}
+}
+}  // end of namespaces
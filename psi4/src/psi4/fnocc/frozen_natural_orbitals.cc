@@ -53,6 +53,8 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libdpd/dpd.h"
+
+#include <sstream>
 #define ID(x) ints->DPD_ID(x)
 
 namespace psi {
@@ -105,200 +107,42 @@ void FrozenNO::ComputeNaturalOrbitals() {
     outfile->Printf("        *******************************************************\n");
     outfile->Printf("\n\n");
 
-    outfile->Printf("        ==> Transform (OV|OV) integrals <==\n");
-    outfile->Printf("\n");
-
-    std::vector<std::shared_ptr<MOSpace> > spaces;
-    spaces.push_back(MOSpace::occ);
-    spaces.push_back(MOSpace::vir);
-    std::shared_ptr<Wavefunction> wfn = reference_wavefunction_;
-    std::shared_ptr<IntegralTransform> ints = std::make_shared<IntegralTransform>(
-        wfn, spaces, IntegralTransform::TransformationType::Restricted, IntegralTransform::OutputType::DPDOnly,
-        IntegralTransform::MOOrdering::QTOrder, IntegralTransform::FrozenOrbitals::OccAndVir, false);
-    ints->set_dpd_id(0);
-    ints->set_keep_iwl_so_ints(true);
-    ints->set_keep_dpd_so_ints(true);
-    ints->initialize();
-    ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::vir);
-
-    outfile->Printf("\n");
-    outfile->Printf("        ==> Build MP2 amplitudes, OPDM, and NOs <==\n");
-    outfile->Printf("\n");
-
-    dpdbuf4 amps1, amps2;
-    std::shared_ptr<PSIO> psio = _default_psio_lib_;
-    psio->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
-
-    // Use the IntegralTransform object's DPD instance, for convenience
-    dpd_set_default(ints->get_dpd_id());
-
-    // orbital energies:
-    int numAOcc = 0, numBOcc = 0, numAVir = 0, numBVir = 0;
-    int aOccCount = 0, bOccCount = 0, aVirCount = 0, bVirCount = 0;
-    int* aOccOrbsPI = new int[nirrep_];
-    int* bOccOrbsPI = new int[nirrep_];
+    // active virtual orbitals per irrep
     int* aVirOrbsPI = new int[nirrep_];
-    int* bVirOrbsPI = new int[nirrep_];
     for (int h = 0; h < nirrep_; ++h) {
-        aOccOrbsPI[h] = doccpi_[h] + soccpi_[h] - frzcpi_[h];
-        bOccOrbsPI[h] = doccpi_[h] - frzcpi_[h];
         aVirOrbsPI[h] = nmopi_[h] - doccpi_[h] - soccpi_[h] - frzvpi_[h];
-        bVirOrbsPI[h] = nmopi_[h] - doccpi_[h] - frzvpi_[h];
-        numAOcc += aOccOrbsPI[h];
-        numBOcc += bOccOrbsPI[h];
-        numAVir += aVirOrbsPI[h];
-        numBVir += bVirOrbsPI[h];
     }
-    double* aOccEvals = new double[numAOcc];
-    double* bOccEvals = new double[numBOcc];
-    double* aVirEvals = new double[numAVir];
-    double* bVirEvals = new double[numBVir];
-
     std::shared_ptr<Vector> epsA = reference_wavefunction_->epsilon_a();
-    std::shared_ptr<Vector> epsB = reference_wavefunction_->epsilon_b();
-    for (int h = 0; h < nirrep_; ++h) {
-        for (int a = frzcpi_[h]; a < doccpi_[h] + soccpi_[h]; ++a) aOccEvals[aOccCount++] = epsA->get(h, a);
-        for (int b = frzcpi_[h]; b < doccpi_[h]; ++b) bOccEvals[bOccCount++] = epsB->get(h, b);
-        for (int a = doccpi_[h] + soccpi_[h]; a < nmopi_[h]; ++a) aVirEvals[aVirCount++] = epsA->get(h, a);
-        for (int b = doccpi_[h]; b < nmopi_[h]; ++b) bVirEvals[bVirCount++] = epsB->get(h, b);
-    }
-
-    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
-                           "MO Ints (OV|OV)");
-    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
-
-    // T(ijab) -> T(jiab)
-    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "Tijab <OO|VV>");
-    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, rpqs, ID("[O,O]"), ID("[V,V]"), "Tjiab <OO|VV>");
-    global_dpd_->buf4_close(&amps1);
-
-    // only worry about alpha-beta
-    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "MO Ints <OO|VV>");
-    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "Tjiab <OO|VV>");
-
-    double emp2_os = 0.0;
-    double emp2_ss = 0.0;
-    for (int h = 0; h < nirrep_; ++h) {
-        global_dpd_->buf4_mat_irrep_init(&amps1, h);
-        global_dpd_->buf4_mat_irrep_rd(&amps1, h);
-
-        global_dpd_->buf4_mat_irrep_init(&amps2, h);
-        global_dpd_->buf4_mat_irrep_rd(&amps2, h);
-
-        for (int ij = 0; ij < amps1.params->rowtot[h]; ++ij) {
-            int i = amps1.params->roworb[h][ij][0];
-            int j = amps1.params->roworb[h][ij][1];
+    int symmetry = Ca_->symmetry();
 
-            for (int ab = 0; ab < amps1.params->coltot[h]; ++ab) {
-                int a = amps1.params->colorb[h][ab][0];
-                int b = amps1.params->colorb[h][ab][1];
-                double val1 = amps1.matrix[h][ij][ab];
-                double val2 = amps2.matrix[h][ij][ab];
-                double denom = aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b];
+    std::shared_ptr<Matrix> eigvec =
+        std::make_shared<Matrix>("Dab eigenvectors", nirrep_, aVirOrbsPI, aVirOrbsPI, symmetry);
+    auto eigval = std::make_shared<Vector>("Dab eigenvalues", nirrep_, aVirOrbsPI);
 
-                emp2_os += val1 * val1 / denom;
-                emp2_ss += val1 * (val1 - val2) / denom;
-            }
+    // reuse the natural orbitals of an earlier run?
+    bool cached = false;
+    std::string key;
+    if (UseNOCache()) {
+        key = NOCacheKey("CONV");
+        double emp2_os, emp2_ss;
+        cached = ReadNOCache(key, aVirOrbsPI, eigvec, eigval, emp2_os, emp2_ss);
+        if (cached) {
+            double escf = Process::environment.globals["SCF TOTAL ENERGY"];
+            Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
+            Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
+            Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2_os + emp2_ss;
+            Process::environment.globals["MP2 TOTAL ENERGY"] = emp2_os + emp2_ss + escf;
         }
-        global_dpd_->buf4_mat_irrep_close(&amps1, h);
-        global_dpd_->buf4_mat_irrep_close(&amps2, h);
     }
-    global_dpd_->buf4_close(&amps1);
-
-    double escf = Process::environment.globals["SCF TOTAL ENERGY"];
-    Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
-    Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
-    Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2_os + emp2_ss;
-    Process::environment.globals["MP2 TOTAL ENERGY"] = emp2_os + emp2_ss + escf;
-
-    // build amps1(ij,ab) = 2*T(ij,ab) - T(ji,ab)
-    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "MO Ints <OO|VV>");
-    global_dpd_->buf4_scm(&amps1, 2.0);
-    global_dpd_->buf4_axpy(&amps2, &amps1, -1.0);
-
-    global_dpd_->buf4_close(&amps1);
-    global_dpd_->buf4_close(&amps2);
-
-    outfile->Printf("        OS MP2 correlation energy:       %20.12lf\n", emp2_os);
-    outfile->Printf("        SS MP2 correlation energy:       %20.12lf\n", emp2_ss);
-    outfile->Printf("        MP2 correlation energy:          %20.12lf\n", emp2_os + emp2_ss);
-    outfile->Printf("      * MP2 total energy:                %20.12lf\n", emp2_os + emp2_ss + escf);
-    outfile->Printf("\n");
-
-    // scale amps by denominator
-    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "MO Ints <OO|VV>");
-    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "Tijab <OO|VV>");
-    for (int h = 0; h < nirrep_; ++h) {
-        global_dpd_->buf4_mat_irrep_init(&amps1, h);
-        global_dpd_->buf4_mat_irrep_rd(&amps1, h);
-
-        global_dpd_->buf4_mat_irrep_init(&amps2, h);
-        global_dpd_->buf4_mat_irrep_rd(&amps2, h);
-
-        for (int ij = 0; ij < amps1.params->rowtot[h]; ++ij) {
-            int i = amps1.params->roworb[h][ij][0];
-            int j = amps1.params->roworb[h][ij][1];
-            for (int ab = 0; ab < amps1.params->coltot[h]; ++ab) {
-                int a = amps1.params->colorb[h][ab][0];
-                int b = amps1.params->colorb[h][ab][1];
-                double denom = aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b];
-                amps1.matrix[h][ij][ab] /= (aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b]);
-                amps2.matrix[h][ij][ab] /= (aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b]);
-            }
+    if (!cached) {
+        SharedMatrix D = BuildVirtualDensity();
+        D->diagonalize(eigvec, eigval, descending);
+        if (UseNOCache()) {
+            WriteNOCache(key, aVirOrbsPI, eigvec, eigval,
+                         Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"],
+                         Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"]);
         }
-
-        global_dpd_->buf4_mat_irrep_wrt(&amps1, h);
-        global_dpd_->buf4_mat_irrep_close(&amps1, h);
-        global_dpd_->buf4_mat_irrep_wrt(&amps2, h);
-        global_dpd_->buf4_mat_irrep_close(&amps2, h);
     }
-    global_dpd_->buf4_close(&amps1);
-    global_dpd_->buf4_close(&amps2);
-
-    // build virtual-virtual block of opdm: sum(ijc) 2.0 * [ 2 t(ij,ac) - t(ji,ac) ] * t(ij,bc)
-    dpdfile2 Dab;
-    global_dpd_->file2_init(&Dab, PSIF_LIBTRANS_DPD, 0, 1, 1, "Dab");
-    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "MO Ints <OO|VV>");
-    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
-                           "Tijab <OO|VV>");
-    global_dpd_->contract442(&amps1, &amps2, &Dab, 3, 3, 2.0, 0.0);
-    global_dpd_->buf4_close(&amps1);
-    global_dpd_->buf4_close(&amps2);
-    global_dpd_->file2_close(&Dab);
-
-    // diagonalize virtual-virtual block of opdm
-    int symmetry = Ca_->symmetry();
-    auto D = std::make_shared<Matrix>("Dab", nirrep_, aVirOrbsPI, aVirOrbsPI, symmetry);
-
-    global_dpd_->file2_init(&Dab, PSIF_LIBTRANS_DPD, 0, 1, 1, "Dab");
-    global_dpd_->file2_mat_init(&Dab);
-    global_dpd_->file2_mat_rd(&Dab);
-    for (int h = 0; h < nirrep_; h++) {
-        int v = Dab.params->rowtot[h];
-
-        double** mat = D->pointer(h);
-        for (int a = 0; a < v; a++) {
-            for (int b = 0; b < v; b++) {
-                mat[a][b] = Dab.matrix[h][a][b];
-            }
-        }
-    }
-    global_dpd_->file2_close(&Dab);
-
-    // done with dpd and ints ... reset
-    psio->close(PSIF_LIBTRANS_DPD, 1);
-    ints.reset();
-
-    std::shared_ptr<Matrix> eigvec =
-        std::make_shared<Matrix>("Dab eigenvectors", nirrep_, aVirOrbsPI, aVirOrbsPI, symmetry);
-    auto eigval = std::make_shared<Vector>("Dab eigenvalues", nirrep_, aVirOrbsPI);
-    D->diagonalize(eigvec, eigval, descending);
 
     // overwrite ao/mo C matrix with ao/no transformation
     auto temp = std::make_shared<Matrix>("temp", nirrep_, nsopi_, aVirOrbsPI, symmetry);
@@ -471,25 +315,224 @@ void FrozenNO::ComputeNaturalOrbitals() {
                 c_oldv[mu][doccpi_[h] + a] = tp[mu][a];
             }
         }
-    }
+    }
+
+    // adjust number of frozen virtual orbitals:
+    for (int h = 0; h < nirrep_; h++) {
+        frzvpi_[h] += aVirOrbsPI[h] - newVirOrbsPI[h];
+    }
+
+    // put modified orbital energies back into epsilon_a
+    std::shared_ptr<Vector> eps = epsilon_a_;
+    for (int h = 0; h < nirrep_; h++) {
+        double* epsp = eps->pointer(h);
+        double* eigp = eigvalF->pointer(h);
+        for (int a = 0; a < newVirOrbsPI[h]; a++) {
+            epsp[doccpi_[h] + a] = eigp[a];
+        }
+    }
+
+    // free memory
+    delete[] newVirOrbsPI;
+    delete[] aVirOrbsPI;
+
+    tstop();
+}
+
+/*
+ * transform (ov|ov) integrals, evaluate the MP2 energy, and build the
+ * virtual-virtual block of the MP2 opdm
+ */
+SharedMatrix FrozenNO::BuildVirtualDensity() {
+    outfile->Printf("        ==> Transform (OV|OV) integrals <==\n");
+    outfile->Printf("\n");
+
+    std::vector<std::shared_ptr<MOSpace> > spaces;
+    spaces.push_back(MOSpace::occ);
+    spaces.push_back(MOSpace::vir);
+    std::shared_ptr<Wavefunction> wfn = reference_wavefunction_;
+    std::shared_ptr<IntegralTransform> ints = std::make_shared<IntegralTransform>(
+        wfn, spaces, IntegralTransform::TransformationType::Restricted, IntegralTransform::OutputType::DPDOnly,
+        IntegralTransform::MOOrdering::QTOrder, IntegralTransform::FrozenOrbitals::OccAndVir, false);
+    ints->set_dpd_id(0);
+    ints->set_keep_iwl_so_ints(true);
+    ints->set_keep_dpd_so_ints(true);
+    ints->initialize();
+    ints->transform_tei(MOSpace::occ, MOSpace::vir, MOSpace::occ, MOSpace::vir);
+
+    outfile->Printf("\n");
+    outfile->Printf("        ==> Build MP2 amplitudes, OPDM, and NOs <==\n");
+    outfile->Printf("\n");
+
+    dpdbuf4 amps1, amps2;
+    std::shared_ptr<PSIO> psio = _default_psio_lib_;
+    psio->open(PSIF_LIBTRANS_DPD, PSIO_OPEN_OLD);
+
+    // Use the IntegralTransform object's DPD instance, for convenience
+    dpd_set_default(ints->get_dpd_id());
+
+    // orbital energies:
+    int numAOcc = 0, numBOcc = 0, numAVir = 0, numBVir = 0;
+    int aOccCount = 0, bOccCount = 0, aVirCount = 0, bVirCount = 0;
+    int* aOccOrbsPI = new int[nirrep_];
+    int* bOccOrbsPI = new int[nirrep_];
+    int* aVirOrbsPI = new int[nirrep_];
+    int* bVirOrbsPI = new int[nirrep_];
+    for (int h = 0; h < nirrep_; ++h) {
+        aOccOrbsPI[h] = doccpi_[h] + soccpi_[h] - frzcpi_[h];
+        bOccOrbsPI[h] = doccpi_[h] - frzcpi_[h];
+        aVirOrbsPI[h] = nmopi_[h] - doccpi_[h] - soccpi_[h] - frzvpi_[h];
+        bVirOrbsPI[h] = nmopi_[h] - doccpi_[h] - frzvpi_[h];
+        numAOcc += aOccOrbsPI[h];
+        numBOcc += bOccOrbsPI[h];
+        numAVir += aVirOrbsPI[h];
+        numBVir += bVirOrbsPI[h];
+    }
+    double* aOccEvals = new double[numAOcc];
+    double* bOccEvals = new double[numBOcc];
+    double* aVirEvals = new double[numAVir];
+    double* bVirEvals = new double[numBVir];
+
+    std::shared_ptr<Vector> epsA = reference_wavefunction_->epsilon_a();
+    std::shared_ptr<Vector> epsB = reference_wavefunction_->epsilon_b();
+    for (int h = 0; h < nirrep_; ++h) {
+        for (int a = frzcpi_[h]; a < doccpi_[h] + soccpi_[h]; ++a) aOccEvals[aOccCount++] = epsA->get(h, a);
+        for (int b = frzcpi_[h]; b < doccpi_[h]; ++b) bOccEvals[bOccCount++] = epsB->get(h, b);
+        for (int a = doccpi_[h] + soccpi_[h]; a < nmopi_[h]; ++a) aVirEvals[aVirCount++] = epsA->get(h, a);
+        for (int b = doccpi_[h]; b < nmopi_[h]; ++b) bVirEvals[bVirCount++] = epsB->get(h, b);
+    }
+
+    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), ID("[O,V]"), 0,
+                           "MO Ints (OV|OV)");
+    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "MO Ints <OO|VV>");
+
+    // T(ijab) -> T(jiab)
+    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, prqs, ID("[O,O]"), ID("[V,V]"), "Tijab <OO|VV>");
+    global_dpd_->buf4_sort(&amps1, PSIF_LIBTRANS_DPD, rpqs, ID("[O,O]"), ID("[V,V]"), "Tjiab <OO|VV>");
+    global_dpd_->buf4_close(&amps1);
+
+    // only worry about alpha-beta
+    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints <OO|VV>");
+    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "Tjiab <OO|VV>");
+
+    double emp2_os = 0.0;
+    double emp2_ss = 0.0;
+    for (int h = 0; h < nirrep_; ++h) {
+        global_dpd_->buf4_mat_irrep_init(&amps1, h);
+        global_dpd_->buf4_mat_irrep_rd(&amps1, h);
+
+        global_dpd_->buf4_mat_irrep_init(&amps2, h);
+        global_dpd_->buf4_mat_irrep_rd(&amps2, h);
+
+        for (int ij = 0; ij < amps1.params->rowtot[h]; ++ij) {
+            int i = amps1.params->roworb[h][ij][0];
+            int j = amps1.params->roworb[h][ij][1];
+
+            for (int ab = 0; ab < amps1.params->coltot[h]; ++ab) {
+                int a = amps1.params->colorb[h][ab][0];
+                int b = amps1.params->colorb[h][ab][1];
+                double val1 = amps1.matrix[h][ij][ab];
+                double val2 = amps2.matrix[h][ij][ab];
+                double denom = aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b];
+
+                emp2_os += val1 * val1 / denom;
+                emp2_ss += val1 * (val1 - val2) / denom;
+            }
+        }
+        global_dpd_->buf4_mat_irrep_close(&amps1, h);
+        global_dpd_->buf4_mat_irrep_close(&amps2, h);
+    }
+    global_dpd_->buf4_close(&amps1);
+
+    double escf = Process::environment.globals["SCF TOTAL ENERGY"];
+    Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
+    Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
+    Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2_os + emp2_ss;
+    Process::environment.globals["MP2 TOTAL ENERGY"] = emp2_os + emp2_ss + escf;
+
+    // build amps1(ij,ab) = 2*T(ij,ab) - T(ji,ab)
+    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints <OO|VV>");
+    global_dpd_->buf4_scm(&amps1, 2.0);
+    global_dpd_->buf4_axpy(&amps2, &amps1, -1.0);
+
+    global_dpd_->buf4_close(&amps1);
+    global_dpd_->buf4_close(&amps2);
+
+    outfile->Printf("        OS MP2 correlation energy:       %20.12lf\n", emp2_os);
+    outfile->Printf("        SS MP2 correlation energy:       %20.12lf\n", emp2_ss);
+    outfile->Printf("        MP2 correlation energy:          %20.12lf\n", emp2_os + emp2_ss);
+    outfile->Printf("      * MP2 total energy:                %20.12lf\n", emp2_os + emp2_ss + escf);
+    outfile->Printf("\n");
+
+    // scale amps by denominator
+    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints <OO|VV>");
+    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "Tijab <OO|VV>");
+    for (int h = 0; h < nirrep_; ++h) {
+        global_dpd_->buf4_mat_irrep_init(&amps1, h);
+        global_dpd_->buf4_mat_irrep_rd(&amps1, h);
+
+        global_dpd_->buf4_mat_irrep_init(&amps2, h);
+        global_dpd_->buf4_mat_irrep_rd(&amps2, h);
+
+        for (int ij = 0; ij < amps1.params->rowtot[h]; ++ij) {
+            int i = amps1.params->roworb[h][ij][0];
+            int j = amps1.params->roworb[h][ij][1];
+            for (int ab = 0; ab < amps1.params->coltot[h]; ++ab) {
+                int a = amps1.params->colorb[h][ab][0];
+                int b = amps1.params->colorb[h][ab][1];
+                double denom = aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b];
+                amps1.matrix[h][ij][ab] /= (aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b]);
+                amps2.matrix[h][ij][ab] /= (aOccEvals[i] + bOccEvals[j] - aVirEvals[a] - bVirEvals[b]);
+            }
+        }
 
-    // adjust number of frozen virtual orbitals:
-    for (int h = 0; h < nirrep_; h++) {
-        frzvpi_[h] += aVirOrbsPI[h] - newVirOrbsPI[h];
+        global_dpd_->buf4_mat_irrep_wrt(&amps1, h);
+        global_dpd_->buf4_mat_irrep_close(&amps1, h);
+        global_dpd_->buf4_mat_irrep_wrt(&amps2, h);
+        global_dpd_->buf4_mat_irrep_close(&amps2, h);
     }
+    global_dpd_->buf4_close(&amps1);
+    global_dpd_->buf4_close(&amps2);
 
-    // put modified orbital energies back into epsilon_a
-    std::shared_ptr<Vector> eps = epsilon_a_;
+    // build virtual-virtual block of opdm: sum(ijc) 2.0 * [ 2 t(ij,ac) - t(ji,ac) ] * t(ij,bc)
+    dpdfile2 Dab;
+    global_dpd_->file2_init(&Dab, PSIF_LIBTRANS_DPD, 0, 1, 1, "Dab");
+    global_dpd_->buf4_init(&amps2, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "MO Ints <OO|VV>");
+    global_dpd_->buf4_init(&amps1, PSIF_LIBTRANS_DPD, 0, ID("[O,O]"), ID("[V,V]"), ID("[O,O]"), ID("[V,V]"), 0,
+                           "Tijab <OO|VV>");
+    global_dpd_->contract442(&amps1, &amps2, &Dab, 3, 3, 2.0, 0.0);
+    global_dpd_->buf4_close(&amps1);
+    global_dpd_->buf4_close(&amps2);
+    global_dpd_->file2_close(&Dab);
+
+    // diagonalize virtual-virtual block of opdm
+    int symmetry = Ca_->symmetry();
+    auto D = std::make_shared<Matrix>("Dab", nirrep_, aVirOrbsPI, aVirOrbsPI, symmetry);
+
+    global_dpd_->file2_init(&Dab, PSIF_LIBTRANS_DPD, 0, 1, 1, "Dab");
+    global_dpd_->file2_mat_init(&Dab);
+    global_dpd_->file2_mat_rd(&Dab);
     for (int h = 0; h < nirrep_; h++) {
-        double* epsp = eps->pointer(h);
-        double* eigp = eigvalF->pointer(h);
-        for (int a = 0; a < newVirOrbsPI[h]; a++) {
-            epsp[doccpi_[h] + a] = eigp[a];
+        int v = Dab.params->rowtot[h];
+
+        double** mat = D->pointer(h);
+        for (int a = 0; a < v; a++) {
+            for (int b = 0; b < v; b++) {
+                mat[a][b] = Dab.matrix[h][a][b];
+            }
         }
     }
+    global_dpd_->file2_close(&Dab);
 
-    // free memory
-    delete[] newVirOrbsPI;
+    // done with dpd and ints ... reset
+    psio->close(PSIF_LIBTRANS_DPD, 1);
+    ints.reset();
 
     delete[] aOccOrbsPI;
     delete[] bOccOrbsPI;
@@ -500,7 +543,7 @@ void FrozenNO::ComputeNaturalOrbitals() {
     delete[] aVirEvals;
     delete[] bVirEvals;
 
-    tstop();
+    return D;
 }
 
 // DF FNO class members
@@ -712,46 +755,7 @@ void DFFrozenNO::ComputeNaturalOrbitals() {
     outfile->Printf("  ==> Frozen Natural Orbitals <==\n");
     outfile->Printf("\n");
 
-    long int o = ndoccact;
     long int v = nvirt;
-    long int nQ = Process::environment.globals["NAUX (CC)"];
-    long int nQ_scf = Process::environment.globals["NAUX (SCF)"];
-    long int memory = Process::environment.get_memory();
-
-    if (memory < 8L * (3L * nso * nso + nso * nso * nQ + o * v * nQ)) {
-        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
-    }
-
-    auto psio = std::make_shared<PSIO>();
-
-    // read in 3-index integrals specific to the CC method:
-    double* tmp2 = (double*)malloc(nso * nso * nQ * sizeof(double));
-    psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
-    psio->read_entry(PSIF_DCC_QSO, "Qso CC", (char*)&tmp2[0], nQ * nso * nso * sizeof(double));
-    psio->close(PSIF_DCC_QSO, 1);
-
-    // transform Qso -> Qov:
-    TransformQ(nQ, tmp2);
-    double* Qov = (double*)malloc(o * v * nQ * sizeof(double));
-    C_DCOPY(o * v * nQ, tmp2, 1, Qov, 1);
-    free(tmp2);
-
-    if (memory < 8L * (o * o * v * v + o * v * nQ)) {
-        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
-    }
-
-    // allocate memory for a couple of buffers
-    double* amps2 = (double*)malloc(o * o * v * v * sizeof(double));
-
-    // build (ia|jb) integrals
-    F_DGEMM('n', 't', o * v, o * v, nQ, 1.0, Qov, o * v, Qov, o * v, 0.0, amps2, o * v);
-    free(Qov);
-
-    if (memory < 16L * o * o * v * v) {
-        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
-    }
-
-    double* amps1 = (double*)malloc(o * o * v * v * sizeof(double));
 
     nvirt_no = nvirt;
 
@@ -762,64 +766,47 @@ void DFFrozenNO::ComputeNaturalOrbitals() {
     double* temp = (double*)malloc(nso * v * sizeof(double));
     double* newFock = (double*)malloc(v * v * sizeof(double));
     double* neweps = (double*)malloc(nvirt_no * sizeof(double));
+    double* eigvalDab = (double*)malloc(v * sizeof(double));
 
-    // build mp2 amplitudes for mp2 density
-    long int ijab = 0;
-    emp2 = 0.0;
-    double emp2_os = 0.0;
-    double emp2_ss = 0.0;
-    for (long int a = o; a < o + v; a++) {
-        double da = F[a];
-        for (long int b = o; b < o + v; b++) {
-            double dab = da + F[b];
-            for (long int i = 0; i < o; i++) {
-                double dabi = dab - F[i];
-                for (long int j = 0; j < o; j++) {
-                    long int iajb = i * v * v * o + (a - o) * v * o + j * v + (b - o);
-                    double dijab = dabi - F[j];
-                    amps1[ijab++] = -amps2[iajb] / dijab;
-                    emp2_os -= amps2[iajb] * amps2[iajb] / dijab;
-                    emp2_ss -=
-                        amps2[iajb] * (amps2[iajb] - amps2[j * o * v * v + (a - o) * o * v + i * v + (b - o)]) / dijab;
-                }
+    // reuse the natural orbitals of an earlier run?
+    bool cached = false;
+    std::string key;
+    if (UseNOCache()) {
+        std::stringstream type;
+        type << "DF;" << options_.get_str("DF_BASIS_CC") << ";" << (long int)Process::environment.globals["NAUX (CC)"];
+        type << ";" << options_.get_double("CHOLESKY_TOLERANCE");
+        key = NOCacheKey(type.str());
+    }
+    int virpi[1] = {(int)v};
+    auto U = std::make_shared<Matrix>("Dab eigenvectors", v, v);
+    auto occ = std::make_shared<Vector>("Dab eigenvalues", v);
+    if (UseNOCache()) {
+        double emp2_os, emp2_ss;
+        cached = ReadNOCache(key, virpi, U, occ, emp2_os, emp2_ss);
+        if (cached) {
+            emp2 = emp2_os + emp2_ss;
+            Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
+            Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
+            Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2;
+            Process::environment.globals["MP2 TOTAL ENERGY"] = emp2 + Process::environment.globals["SCF TOTAL ENERGY"];
+            for (long int i = 0; i < v; i++) {
+                eigvalDab[i] = occ->get(i);
+                for (long int b = 0; b < v; b++) temp[i * v + b] = U->get(b, i);
             }
         }
     }
-    emp2 = emp2_os + emp2_ss;
-
-    outfile->Printf("        Doubles contribution to MP2 energy in full space: %20.12lf\n", emp2);
-    outfile->Printf("\n");
-
-    Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
-    Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
-    Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2;
-    Process::environment.globals["MP2 TOTAL ENERGY"] = emp2 + Process::environment.globals["SCF TOTAL ENERGY"];
-
-    ijab = 0;
-    for (long int a = o; a < o + v; a++) {
-        for (long int b = o; b < o + v; b++) {
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    long int ijba = (b - o) * o * o * v + (a - o) * o * o + i * o + j;
-                    amps2[ijab] = 2.0 * amps1[ijab] - amps1[ijba];
-                    ijab++;
-                }
+    if (!cached) {
+        BuildNaturalOrbitals(temp, eigvalDab);
+        if (UseNOCache()) {
+            for (long int i = 0; i < v; i++) {
+                occ->set(i, eigvalDab[i]);
+                for (long int b = 0; b < v; b++) U->set(b, i, temp[i * v + b]);
             }
+            WriteNOCache(key, virpi, U, occ, Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"],
+                         Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"]);
         }
     }
 
-    // build ab block of the density:
-    F_DGEMM('t', 'n', v, v, v * o * o, 2.0, amps1, v * o * o, amps2, v * o * o, 0.0, Dab, v);
-
-    // diagonalize Dab
-    double* eigvalDab = (double*)malloc(v * sizeof(double));
-    Diagonalize(v, Dab, eigvalDab);
-
-    // reorder transformation matrix:
-    for (long int i = 0; i < v; i++) {
-        C_DCOPY(v, Dab + (v - 1 - i) * v, 1, temp + i * v, 1);
-    }
-
     // establish cutoff for frozen virtuals
     double cutoff = options_.get_double("OCC_TOLERANCE");
     nvirt_no = 0;
@@ -905,8 +892,6 @@ void DFFrozenNO::ComputeNaturalOrbitals() {
     // free memory before using libtrans
     free(temp);
     free(neweps);
-    free(amps1);
-    free(amps2);
     free(eigvalDab);
     free(newFock);
 
@@ -919,6 +904,121 @@ void DFFrozenNO::ComputeNaturalOrbitals() {
     free(Dab);
 }
 
+/*
+ * MP2 energy and the virtual-virtual block of the MP2 opdm, diagonalized;
+ * temp[i * v + b] is natural orbital i, in order of decreasing occupation
+ */
+void DFFrozenNO::BuildNaturalOrbitals(double* temp, double* eigvalDab) {
+    long int o = ndoccact;
+    long int v = nvirt;
+    long int nQ = Process::environment.globals["NAUX (CC)"];
+    long int nQ_scf = Process::environment.globals["NAUX (SCF)"];
+    long int memory = Process::environment.get_memory();
+
+    if (memory < 8L * (3L * nso * nso + nso * nso * nQ + o * v * nQ)) {
+        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
+    }
+
+    auto psio = std::make_shared<PSIO>();
+
+    // read in 3-index integrals specific to the CC method:
+    double* tmp2 = (double*)malloc(nso * nso * nQ * sizeof(double));
+    psio->open(PSIF_DCC_QSO, PSIO_OPEN_OLD);
+    psio->read_entry(PSIF_DCC_QSO, "Qso CC", (char*)&tmp2[0], nQ * nso * nso * sizeof(double));
+    psio->close(PSIF_DCC_QSO, 1);
+
+    // transform Qso -> Qov:
+    TransformQ(nQ, tmp2);
+    double* Qov = (double*)malloc(o * v * nQ * sizeof(double));
+    C_DCOPY(o * v * nQ, tmp2, 1, Qov, 1);
+    free(tmp2);
+
+    if (memory < 8L * (o * o * v * v + o * v * nQ)) {
+        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
+    }
+
+    // allocate memory for a couple of buffers
+    double* amps2 = (double*)malloc(o * o * v * v * sizeof(double));
+
+    // build (ia|jb) integrals
+    F_DGEMM('n', 't', o * v, o * v, nQ, 1.0, Qov, o * v, Qov, o * v, 0.0, amps2, o * v);
+    free(Qov);
+
+    if (memory < 16L * o * o * v * v) {
+        throw PsiException("not enough memory (fno)", __FILE__, __LINE__);
+    }
+
+    double* amps1 = (double*)malloc(o * o * v * v * sizeof(double));
+
+    std::shared_ptr<Vector> eps_test = epsilon_a();
+    double* tempeps = eps_test->pointer();
+    double* F = tempeps + nfzc;
+    double* Dab = (double*)malloc(v * v * sizeof(double));
+
+    // build mp2 amplitudes for mp2 density
+    long int ijab = 0;
+    emp2 = 0.0;
+    double emp2_os = 0.0;
+    double emp2_ss = 0.0;
+    for (long int a = o; a < o + v; a++) {
+        double da = F[a];
+        for (long int b = o; b < o + v; b++) {
+            double dab = da + F[b];
+            for (long int i = 0; i < o; i++) {
+                double dabi = dab - F[i];
+                for (long int j = 0; j < o; j++) {
+                    long int iajb = i * v * v * o + (a - o) * v * o + j * v + (b - o);
+                    double dijab = dabi - F[j];
+                    amps1[ijab++] = -amps2[iajb] / dijab;
+                    emp2_os -= amps2[iajb] * amps2[iajb] / dijab;
+                    emp2_ss -=
+                        amps2[iajb] * (amps2[iajb] - amps2[j * o * v * v + (a - o) * o * v + i * v + (b - o)]) / dijab;
+                }
+            }
+        }
+    }
+    emp2 = emp2_os + emp2_ss;
+
+    outfile->Printf("        Doubles contribution to MP2 energy in full space: %20.12lf\n", emp2);
+    outfile->Printf("\n");
+
+    Process::environment.globals["MP2 OPPOSITE-SPIN CORRELATION ENERGY"] = emp2_os;
+    Process::environment.globals["MP2 SAME-SPIN CORRELATION ENERGY"] = emp2_ss;
+    Process::environment.globals["MP2 CORRELATION ENERGY"] = emp2;
+    Process::environment.globals["MP2 TOTAL ENERGY"] = emp2 + Process::environment.globals["SCF TOTAL ENERGY"];
+
+    ijab = 0;
+    for (long int a = o; a < o + v; a++) {
+        for (long int b = o; b < o + v; b++) {
+            for (long int i = 0; i < o; i++) {
+                for (long int j = 0; j < o; j++) {
+                    long int ijba = (b - o) * o * o * v + (a - o) * o * o + i * o + j;
+                    amps2[ijab] = 2.0 * amps1[ijab] - amps1[ijba];
+                    ijab++;
+                }
+            }
+        }
+    }
+
+    // build ab block of the density:
+    F_DGEMM('t', 'n', v, v, v * o * o, 2.0, amps1, v * o * o, amps2, v * o * o, 0.0, Dab, v);
+
+    // diagonalize Dab
+    Diagonalize(v, Dab, eigvalDab);
+
+    // reorder transformation matrix and occupations:
+    for (long int i = 0; i < v; i++) {
+        C_DCOPY(v, Dab + (v - 1 - i) * v, 1, temp + i * v, 1);
+    }
+    for (long int i = 0; i < v / 2; i++) {
+        std::swap(eigvalDab[i], eigvalDab[v - 1 - i]);
+    }
+
+    free(amps1);
+    free(amps2);
+    free(Dab);
+}
+
 void DFFrozenNO::ModifyCa(double* Dab) {
     long int v = nvirt;
 
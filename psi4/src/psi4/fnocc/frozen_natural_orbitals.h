@@ -49,6 +49,17 @@ class FrozenNO : public Wavefunction {
     long int nso, nmo, ndocc, nvirt, nfzc, nfzv, ndoccact, nvirt_no;
 
     void common_init();
+
+    /// frozen natural orbitals cached on disk between runs (FNO_CACHE)
+    bool UseNOCache();
+    std::string NOCacheKey(const std::string& type);
+    bool ReadNOCache(const std::string& key, const int* virpi, SharedMatrix U, SharedVector occ, double& emp2_os,
+                     double& emp2_ss);
+    void WriteNOCache(const std::string& key, const int* virpi, SharedMatrix U, SharedVector occ, double emp2_os,
+                      double emp2_ss);
+
+    /// MP2 virtual-virtual opdm
+    SharedMatrix BuildVirtualDensity();
 };
 
 class PSI_API DFFrozenNO : public FrozenNO {
@@ -72,6 +83,9 @@ class PSI_API DFFrozenNO : public FrozenNO {
     void ModifyCa_occ(double* Dij);
     void BuildFock(long int nQ, double* Qso, double* F);
     void TransformQ(long int nQ, double* Qso);
+
+    /// MP2 energy and virtual natural orbitals (temp[i*v+b]) from the 3-index integrals
+    void BuildNaturalOrbitals(double* temp, double* eigvalDab);
 };
 }
 }
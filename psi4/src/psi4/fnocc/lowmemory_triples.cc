@@ -29,6 +29,7 @@
 #include "ccsd.h"
 #include "blas.h"
 #include "psi4/libmints/wavefunction.h"
+#include "psi4/libqt/blas_backend.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
@@ -152,6 +153,16 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
         outfile->Printf("        Attempting to proceed with %d threads\n", nthreads);
     }
 
+    // source of the (ov|vv) slices, possibly blocked over a
+    memory_reqd = 8L * (2L * vvoo + vooo + vo + 5L * nthreads * ooo);
+    long int ablock = TriplesSliceInit(nthreads, memory - memory_reqd);
+    if (ablock < 1) {
+        delete[] name;
+        delete[] space;
+        free(E2ijak);
+        return Failure;
+    }
+
     E2abci = (double **)malloc(nthreads * sizeof(double *));
     // some o^3 intermediates
     double **Z = (double **)malloc(nthreads * sizeof(double *));
@@ -244,267 +255,259 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
       *  if there is enough memory to explicitly thread, do so
       */
 
-    std::vector<std::shared_ptr<PSIO> > mypsio;
-    for (int i = 0; i < nthreads; i++) {
-        mypsio.push_back(std::make_shared<PSIO>());
-        mypsio[i]->open(PSIF_DCC_ABCI4, PSIO_OPEN_OLD);
-    }
-
     if (threaded) {
+        // abc is ordered by a, so each block of a is a contiguous range of ind
+        for (long int a0 = 0; a0 < v; a0 += ablock) {
+            long int a1 = a0 + ablock < v ? a0 + ablock : v;
+            TriplesSliceBlock(a0, a1);
 #pragma omp parallel for schedule(dynamic) num_threads(nthreads)
-        for (long int ind = 0; ind < nabc; ind++) {
-            long int a = abc[ind][0];
-            long int b = abc[ind][1];
-            long int c = abc[ind][2];
+            for (long int ind = a0 * (a0 + 1) * (a0 + 2) / 6; ind < a1 * (a1 + 1) * (a1 + 2) / 6; ind++) {
+                long int a = abc[ind][0];
+                long int b = abc[ind][1];
+                long int c = abc[ind][2];
 
-            int thread = 0;
+                int thread = 0;
 #ifdef _OPENMP
-            thread = omp_get_thread_num();
+                thread = omp_get_thread_num();
 #endif
-
-            // auto mypsio = std::make_shared<PSIO>();
-            // mypsio->open(PSIF_DCC_ABCI4,PSIO_OPEN_OLD);
-            psio_address addr = psio_get_address(PSIO_ZERO, (b * vvo + c * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], vo * sizeof(double), addr,
-                                 &addr);
-
-            // (1)
-            F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + a * voo, oo, 0.0, Z[thread], o);
-            // (ikj)(acb)
-            F_DGEMM('t', 'n', o, oo, o, -1.0, tempt + c * voo + a * oo, o, E2ijak + b * ooo, o, 1.0, Z[thread], o);
-
-            addr = psio_get_address(PSIO_ZERO, (a * vvo + c * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], vo * sizeof(double), addr,
-                                 &addr);
-            //(ab)(ij)
-            F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + b * voo, oo, 0.0, Z2[thread], o);
-            //(ab)(ij)
-            F_DGEMM('t', 'n', o * o, o, o, -1.0, E2ijak + c * ooo, o, tempt + b * voo + a * oo, o, 1.0, Z2[thread], oo);
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    C_DAXPY(o, 1.0, Z2[thread] + j * oo + i * o, 1, Z[thread] + i * oo + j * o, 1);
+                blas::ThreadScope blas_threads(0, "FNOCC (T)");
+
+                TriplesSlice(b, c, E2abci[thread], thread);
+
+                // (1)
+                F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + a * voo, oo, 0.0, Z[thread], o);
+                // (ikj)(acb)
+                F_DGEMM('t', 'n', o, oo, o, -1.0, tempt + c * voo + a * oo, o, E2ijak + b * ooo, o, 1.0, Z[thread], o);
+
+                TriplesSlice(a, c, E2abci[thread], thread);
+                //(ab)(ij)
+                F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + b * voo, oo, 0.0, Z2[thread], o);
+                //(ab)(ij)
+                F_DGEMM('t', 'n', o * o, o, o, -1.0, E2ijak + c * ooo, o, tempt + b * voo + a * oo, o,
+                        1.0, Z2[thread], oo);
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        C_DAXPY(o, 1.0, Z2[thread] + j * oo + i * o, 1, Z[thread] + i * oo + j * o, 1);
+                    }
                 }
-            }
 
-            addr = psio_get_address(PSIO_ZERO, (c * vvo + b * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], vo * sizeof(double), addr,
-                                 &addr);
-            //(bc)(jk)
-            F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + a * voo, oo, 0.0, Z2[thread], o);
-            //(bc)(jk)
-            F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + b * ooo, o, tempt + a * voo + c * oo, o, 1.0, Z2[thread], oo);
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    C_DAXPY(o, 1.0, Z2[thread] + i * oo + j, o, Z[thread] + i * oo + j * o, 1);
+                TriplesSlice(c, b, E2abci[thread], thread);
+                //(bc)(jk)
+                F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + a * voo, oo, 0.0, Z2[thread], o);
+                //(bc)(jk)
+                F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + b * ooo, o, tempt + a * voo + c * oo, o,
+                        1.0, Z2[thread], oo);
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        C_DAXPY(o, 1.0, Z2[thread] + i * oo + j, o, Z[thread] + i * oo + j * o, 1);
+                    }
                 }
-            }
-            addr = psio_get_address(PSIO_ZERO, (b * vvo + a * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], vo * sizeof(double), addr,
-                                 &addr);
-            //(ac)(ik)
-            F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + c * voo, oo, 0.0, Z2[thread], o);
-            //(ac)(ik)
-            F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + a * ooo, o, tempt + c * voo + b * oo, o, 1.0, Z2[thread], oo);
-            //(1)
-            F_DGEMM('t', 't', o, oo, o, -1.0, tempt + a * voo + b * oo, o, E2ijak + c * ooo, oo, 1.0, Z2[thread], o);
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        Z[thread][i * oo + j * o + k] += Z2[thread][k * oo + j * o + i];
+                TriplesSlice(b, a, E2abci[thread], thread);
+                //(ac)(ik)
+                F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + c * voo, oo, 0.0, Z2[thread], o);
+                //(ac)(ik)
+                F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + a * ooo, o, tempt + c * voo + b * oo, o,
+                        1.0, Z2[thread], oo);
+                //(1)
+                F_DGEMM('t', 't', o, oo, o, -1.0, tempt + a * voo + b * oo, o, E2ijak + c * ooo, oo,
+                        1.0, Z2[thread], o);
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            Z[thread][i * oo + j * o + k] += Z2[thread][k * oo + j * o + i];
+                        }
                     }
                 }
-            }
-            addr = psio_get_address(PSIO_ZERO, (c * vvo + a * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], vo * sizeof(double), addr,
-                                 &addr);
-            //(ijk)(abc)
-            F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + b * voo, oo, 0.0, Z2[thread], o);
-            F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + a * ooo, o, tempt + b * voo + c * oo, o, 1.0, Z2[thread], oo);
-            //(ijk)(abc)
-            //(ikj)(acb)
-            addr = psio_get_address(PSIO_ZERO, (a * vvo + b * vo) * sizeof(double));
-            mypsio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&E2abci[thread][0], o * v * sizeof(double), addr,
-                                 &addr);
-            F_DGEMM('n', 'n', oo, o, v, 1.0, tempt + c * voo, oo, E2abci[thread], v, 1.0, Z2[thread], oo);
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        Z[thread][i * oo + j * o + k] += Z2[thread][j * oo + k * o + i];
+                TriplesSlice(c, a, E2abci[thread], thread);
+                //(ijk)(abc)
+                F_DGEMM('t', 't', o, oo, v, 1.0, E2abci[thread], v, tempt + b * voo, oo, 0.0, Z2[thread], o);
+                F_DGEMM('t', 'n', oo, o, o, -1.0, E2ijak + a * ooo, o, tempt + b * voo + c * oo, o,
+                        1.0, Z2[thread], oo);
+                //(ijk)(abc)
+                //(ikj)(acb)
+                TriplesSlice(a, b, E2abci[thread], thread);
+                F_DGEMM('n', 'n', oo, o, v, 1.0, tempt + c * voo, oo, E2abci[thread], v, 1.0, Z2[thread], oo);
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            Z[thread][i * oo + j * o + k] += Z2[thread][j * oo + k * o + i];
+                        }
                     }
                 }
-            }
 
-            C_DCOPY(ooo, Z[thread], 1, Z2[thread], 1);
-            double dabc = -F[a + o] - F[b + o] - F[c + o];
-            for (long int i = 0; i < o; i++) {
-                double dabci = dabc + F[i];
-                for (long int j = 0; j < o; j++) {
-                    double dabcij = dabci + F[j];
-                    for (long int k = 0; k < o; k++) {
-                        double denom = dabcij + F[k];
-                        Z[thread][i * oo + j * o + k] /= denom;
+                C_DCOPY(ooo, Z[thread], 1, Z2[thread], 1);
+                double dabc = -F[a + o] - F[b + o] - F[c + o];
+                for (long int i = 0; i < o; i++) {
+                    double dabci = dabc + F[i];
+                    for (long int j = 0; j < o; j++) {
+                        double dabcij = dabci + F[j];
+                        for (long int k = 0; k < o; k++) {
+                            double denom = dabcij + F[k];
+                            Z[thread][i * oo + j * o + k] /= denom;
+                        }
                     }
                 }
-            }
-            for (long int i = 0; i < o; i++) {
-                double tai = t1[a * o + i];
-                for (long int j = 0; j < o; j++) {
-                    double tbj = t1[b * o + j];
-                    double E2iajb = E2klcd[i * vvo + a * vo + j * v + b];
-                    for (long int k = 0; k < o; k++) {
-                        Z2[thread][i * oo + j * o + k] +=
-                            fac * (tai * E2klcd[j * vvo + b * vo + k * v + c] +
-                                   tbj * E2klcd[i * vvo + a * vo + k * v + c] + t1[c * o + k] * E2iajb);
+                for (long int i = 0; i < o; i++) {
+                    double tai = t1[a * o + i];
+                    for (long int j = 0; j < o; j++) {
+                        double tbj = t1[b * o + j];
+                        double E2iajb = E2klcd[i * vvo + a * vo + j * v + b];
+                        for (long int k = 0; k < o; k++) {
+                            Z2[thread][i * oo + j * o + k] +=
+                                fac * (tai * E2klcd[j * vvo + b * vo + k * v + c] +
+                                       tbj * E2klcd[i * vvo + a * vo + k * v + c] + t1[c * o + k] * E2iajb);
+                        }
                     }
                 }
-            }
 
-            C_DCOPY(ooo, Z[thread], 1, Z3[thread], 1);
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        Z3[thread][i * oo + j * o + k] *= (1.0 + 0.5 * (i == j) * (j == k));
+                C_DCOPY(ooo, Z[thread], 1, Z3[thread], 1);
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            Z3[thread][i * oo + j * o + k] *= (1.0 + 0.5 * (i == j) * (j == k));
+                        }
                     }
                 }
-            }
-
-            long int abcfac = (2 - ((a == b) + (b == c) + (a == c)));
 
-            // contribute to energy:
-            double tripval = 0.0;
-            for (long int i = 0; i < o; i++) {
-                double dum = 0.0;
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        dum += Z3[thread][ijk] * Z2[thread][ijk];
+                long int abcfac = (2 - ((a == b) + (b == c) + (a == c)));
+
+                // contribute to energy:
+                double tripval = 0.0;
+                for (long int i = 0; i < o; i++) {
+                    double dum = 0.0;
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            dum += Z3[thread][ijk] * Z2[thread][ijk];
+                        }
                     }
+                    tripval += dum;
                 }
-                tripval += dum;
-            }
-            etrip[thread] += 3.0 * tripval * abcfac;
-
-            // Z3(ijk) = -2(Z(ijk) + jki + kij) + ikj + jik + kji
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        long int jki = j * oo + k * o + i;
-                        long int kij = k * oo + i * o + j;
-                        long int ikj = i * oo + k * o + j;
-                        long int jik = j * oo + i * o + k;
-                        long int kji = k * oo + j * o + i;
-                        Z3[thread][ijk] = -2.0 * (Z[thread][ijk] + Z[thread][jki] + Z[thread][kij]) + Z[thread][ikj] +
-                                          Z[thread][jik] + Z[thread][kji];
+                etrip[thread] += 3.0 * tripval * abcfac;
+
+                // Z3(ijk) = -2(Z(ijk) + jki + kij) + ikj + jik + kji
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            long int jki = j * oo + k * o + i;
+                            long int kij = k * oo + i * o + j;
+                            long int ikj = i * oo + k * o + j;
+                            long int jik = j * oo + i * o + k;
+                            long int kji = k * oo + j * o + i;
+                            Z3[thread][ijk] = -2.0 * (Z[thread][ijk] + Z[thread][jki] + Z[thread][kij]) +
+                                              Z[thread][ikj] + Z[thread][jik] + Z[thread][kji];
+                        }
                     }
                 }
-            }
 
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        long int ikj = i * oo + k * o + j;
-                        E2abci[thread][ijk] = Z2[thread][ikj] * 0.5 * (1.0 + 0.5 * (i == j) * (j == k));
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            long int ikj = i * oo + k * o + j;
+                            E2abci[thread][ijk] = Z2[thread][ikj] * 0.5 * (1.0 + 0.5 * (i == j) * (j == k));
+                        }
                     }
                 }
-            }
 
-            // contribute to energy:
-            tripval = 0.0;
-            for (long int i = 0; i < o; i++) {
-                double dum = 0.0;
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        dum += E2abci[thread][ijk] * Z3[thread][ijk];
+                // contribute to energy:
+                tripval = 0.0;
+                for (long int i = 0; i < o; i++) {
+                    double dum = 0.0;
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            dum += E2abci[thread][ijk] * Z3[thread][ijk];
+                        }
                     }
+                    tripval += dum;
                 }
-                tripval += dum;
-            }
-            etrip[thread] += tripval * abcfac;
-
-            // the second bit
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        E2abci[thread][ijk] = Z2[thread][ijk] * 0.5 * (1.0 + 0.5 * (i == j) * (j == k));
+                etrip[thread] += tripval * abcfac;
+
+                // the second bit
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            E2abci[thread][ijk] = Z2[thread][ijk] * 0.5 * (1.0 + 0.5 * (i == j) * (j == k));
+                        }
                     }
                 }
-            }
 
-            // Z4 = Z(ijk)+jki+kij - 2( (ikj)+(jik)+(kji) )
-            for (long int i = 0; i < o; i++) {
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        long int jki = j * oo + k * o + i;
-                        long int kij = k * oo + i * o + j;
-                        long int ikj = i * oo + k * o + j;
-                        long int jik = j * oo + i * o + k;
-                        long int kji = k * oo + j * o + i;
-                        Z4[thread][ijk] = Z[thread][ijk] + Z[thread][jki] + Z[thread][kij] -
-                                          2.0 * (Z[thread][ikj] + Z[thread][jik] + Z[thread][kji]);
+                // Z4 = Z(ijk)+jki+kij - 2( (ikj)+(jik)+(kji) )
+                for (long int i = 0; i < o; i++) {
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            long int jki = j * oo + k * o + i;
+                            long int kij = k * oo + i * o + j;
+                            long int ikj = i * oo + k * o + j;
+                            long int jik = j * oo + i * o + k;
+                            long int kji = k * oo + j * o + i;
+                            Z4[thread][ijk] = Z[thread][ijk] + Z[thread][jki] + Z[thread][kij] -
+                                              2.0 * (Z[thread][ikj] + Z[thread][jik] + Z[thread][kji]);
+                        }
                     }
                 }
-            }
 
-            // contribute to energy:
-            tripval = 0.0;
-            for (long int i = 0; i < o; i++) {
-                double dum = 0.0;
-                for (long int j = 0; j < o; j++) {
-                    for (long int k = 0; k < o; k++) {
-                        long int ijk = i * oo + j * o + k;
-                        dum += Z4[thread][ijk] * E2abci[thread][ijk];
+                // contribute to energy:
+                tripval = 0.0;
+                for (long int i = 0; i < o; i++) {
+                    double dum = 0.0;
+                    for (long int j = 0; j < o; j++) {
+                        for (long int k = 0; k < o; k++) {
+                            long int ijk = i * oo + j * o + k;
+                            dum += Z4[thread][ijk] * E2abci[thread][ijk];
+                        }
                     }
+                    tripval += dum;
                 }
-                tripval += dum;
-            }
-            etrip[thread] += tripval * abcfac;
-
-            // print out update
-            if (thread == 0) {
-                int print = 0;
-                stop = time(nullptr);
-                if ((double)ind / nabc >= 0.1 && !pct10) {
-                    pct10 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.2 && !pct20) {
-                    pct20 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.3 && !pct30) {
-                    pct30 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.4 && !pct40) {
-                    pct40 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.5 && !pct50) {
-                    pct50 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.6 && !pct60) {
-                    pct60 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.7 && !pct70) {
-                    pct70 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.8 && !pct80) {
-                    pct80 = 1;
-                    print = 1;
-                } else if ((double)ind / nabc >= 0.9 && !pct90) {
-                    pct90 = 1;
-                    print = 1;
-                }
-                if (print) {
-                    outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nabc, (int)stop - (int)start);
+                etrip[thread] += tripval * abcfac;
+
+                // print out update
+                if (thread == 0) {
+                    int print = 0;
+                    stop = time(nullptr);
+                    if ((double)ind / nabc >= 0.1 && !pct10) {
+                        pct10 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.2 && !pct20) {
+                        pct20 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.3 && !pct30) {
+                        pct30 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.4 && !pct40) {
+                        pct40 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.5 && !pct50) {
+                        pct50 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.6 && !pct60) {
+                        pct60 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.7 && !pct70) {
+                        pct70 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.8 && !pct80) {
+                        pct80 = 1;
+                        print = 1;
+                    } else if ((double)ind / nabc >= 0.9 && !pct90) {
+                        pct90 = 1;
+                        print = 1;
+                    }
+                    if (print) {
+                        outfile->Printf("              %3.1lf  %8d s\n", 100.0 * ind / nabc, (int)stop - (int)start);
+                    }
                 }
+                // mypsio->close(PSIF_DCC_ABCI4,1);
+                // mypsio.reset();
             }
-            // mypsio->close(PSIF_DCC_ABCI4,1);
-            // mypsio.reset();
         }
     } else {
         outfile->Printf("on the to do pile!\n");
+        TriplesSliceFinalize();
         delete[] name;
         delete[] space;
         free(E2ijak);
@@ -519,9 +522,7 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
 
         return Failure;
     }
-    for (int i = 0; i < nthreads; i++) {
-        mypsio[i]->close(PSIF_DCC_ABCI4, 1);
-    }
+    TriplesSliceFinalize();
 
     double myet = 0.0;
     for (int i = 0; i < nthreads; i++) myet += etrip[i];
@@ -574,5 +575,33 @@ PsiReturnType CoupledCluster::lowmemory_triples() {
 
     return Success;
 }
+
+// the default source of (ov|vv) slices for low-memory (T): E2abci4 on disk,
+// one PSIO object per thread
+long int CoupledCluster::TriplesSliceInit(int nthreads, long int memory) {
+    abci4_psio.clear();
+    for (int i = 0; i < nthreads; i++) {
+        abci4_psio.push_back(std::make_shared<PSIO>());
+        abci4_psio[i]->open(PSIF_DCC_ABCI4, PSIO_OPEN_OLD);
+    }
+    return nvirt_no;
+}
+
+void CoupledCluster::TriplesSliceBlock(long int a0, long int a1) {}
+
+// E2abci4[x][y] = (iy|xz), an o x v slice
+void CoupledCluster::TriplesSlice(long int x, long int y, double *buf, int thread) {
+    long int o = ndoccact;
+    long int v = nvirt_no;
+    psio_address addr = psio_get_address(PSIO_ZERO, (x * v * v * o + y * v * o) * sizeof(double));
+    abci4_psio[thread]->read(PSIF_DCC_ABCI4, "E2abci4", (char *)&buf[0], o * v * sizeof(double), addr, &addr);
+}
+
+void CoupledCluster::TriplesSliceFinalize() {
+    for (size_t i = 0; i < abci4_psio.size(); i++) {
+        abci4_psio[i]->close(PSIF_DCC_ABCI4, 1);
+    }
+    abci4_psio.clear();
+}
 }
 }  // end of namespaces
@@ -30,6 +30,7 @@
 #include "blas.h"
 
 #include "psi4/libmints/wavefunction.h"
+#include "psi4/libqt/blas_backend.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
@@ -187,6 +188,7 @@ PsiReturnType CoupledCluster::triples() {
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
+        blas::ThreadScope blas_threads(0, "FNOCC (T)");
 
         auto mypsio = std::make_shared<PSIO>();
         mypsio->open(PSIF_DCC_ABCI, PSIO_OPEN_OLD);
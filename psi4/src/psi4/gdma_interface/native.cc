@@ -0,0 +1,135 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/psi4-dec.h"
+#include "psi4/physconst.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/dma.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/libmints/wavefunction.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <cmath>
+
+namespace psi {
+namespace gdma_interface {
+
+SharedWavefunction native_dma(SharedWavefunction ref_wfn, Options& options) {
+    std::shared_ptr<Molecule> mol = ref_wfn->molecule();
+    std::shared_ptr<BasisSet> basis = ref_wfn->basisset();
+    int natom = mol->natom();
+    int limit = options.get_int("GDMA_LIMIT");
+
+    outfile->Printf("\n  ==> Distributed Multipole Analysis <==\n\n");
+    outfile->Printf("    Multipole limit: %d, threads: %d\n", limit, Process::environment.get_n_threads());
+    if (options.get_double("GDMA_SWITCH") != 0.0) {
+        outfile->Printf("    All primitive pairs are treated with standard DMA, as for GDMA_SWITCH 0.\n");
+    }
+    if (options.get_str("GDMA_MULTIPOLE_UNITS") != "AU") {
+        outfile->Printf("    Multipoles are reported in atomic units.\n");
+    }
+
+    // GDMA's default radii, overridden per element by GDMA_RADIUS
+    std::vector<double> radii(natom);
+    for (int a = 0; a < natom; ++a) radii[a] = (mol->symbol(a) == "H" ? 0.35 : 0.65);
+    int nradius = options["GDMA_RADIUS"].size();
+    if (nradius % 2) throw PSIEXCEPTION("GDMA_RADIUS should be pairs of atom types and radii.");
+    for (int n = 0; n < nradius; n += 2) {
+        std::string type = to_upper_copy(options["GDMA_RADIUS"][n].to_string());
+        double r = options["GDMA_RADIUS"][n + 1].to_double();
+        for (int a = 0; a < natom; ++a) {
+            if (mol->symbol(a) == type || to_upper_copy(mol->label(a)) == type) radii[a] = r;
+        }
+    }
+    for (int a = 0; a < natom; ++a) radii[a] /= pc_bohr2angstroms;
+
+    Vector3 origin(0.0, 0.0, 0.0);
+    if (options["GDMA_ORIGIN"].size()) {
+        if (options["GDMA_ORIGIN"].size() != 3)
+            throw PSIEXCEPTION("The GDMA origin array should contain three entries: x, y, and z.");
+        for (int x = 0; x < 3; ++x) origin[x] = options["GDMA_ORIGIN"][x].to_double() / pc_bohr2angstroms;
+    }
+
+    // Total density in the Cartesian AO basis
+    SharedMatrix Dso = ref_wfn->Da()->clone();
+    Dso->add(ref_wfn->Db());
+    PetiteList petite(basis, ref_wfn->integral(), true);
+    auto D = std::make_shared<Matrix>("D carts", basis->nao(), basis->nao());
+    D->remove_symmetry(Dso, petite.sotoao());
+
+    DistributedMultipoleAnalysis dma(basis, limit);
+    dma.set_radii(radii);
+    dma.set_nthread(Process::environment.get_n_threads());
+    dma.compute(D);
+    SharedMatrix dmavals = dma.site_multipoles();
+    SharedMatrix totvals = dma.total_multipoles(origin);
+
+    auto print_site = [&](const std::string& label, const double* q) {
+        outfile->Printf("    %-8s Q00 = %12.6f\n", label.c_str(), q[0]);
+        for (int l = 1; l <= limit; ++l) {
+            double norm = 0.0;
+            for (int k = 0; k <= 2 * l; ++k) norm += q[l * l + k] * q[l * l + k];
+            outfile->Printf("    |Q%d| = %10.6f ", l, std::sqrt(norm));
+            for (int k = 0; k <= 2 * l; ++k) {
+                std::string name = "Q" + std::to_string(l) + std::to_string((k + 1) / 2);
+                if (k) name += (k % 2) ? "c" : "s";
+                outfile->Printf(" %5s = %10.6f", name.c_str(), q[l * l + k]);
+                if (k % 4 == 3 && k != 2 * l) outfile->Printf("\n                     ");
+            }
+            outfile->Printf("\n");
+        }
+    };
+    for (int a = 0; a < natom; ++a) {
+        Vector3 R = mol->xyz(a) * pc_bohr2angstroms;
+        outfile->Printf("\n    Site %d: %s at %10.6f %10.6f %10.6f [Ang], radius %.3f [Ang]\n", a + 1,
+                        mol->label(a).c_str(), R[0], R[1], R[2], radii[a] * pc_bohr2angstroms);
+        print_site(mol->label(a), dmavals->pointer()[a]);
+    }
+    Vector3 O = origin * pc_bohr2angstroms;
+    outfile->Printf("\n    Total multipoles about %10.6f %10.6f %10.6f [Ang]\n", O[0], O[1], O[2]);
+    print_site("Total", totvals->pointer()[0]);
+
+    Process::environment.arrays["DMA DISTRIBUTED MULTIPOLES"] = dmavals;
+    Process::environment.arrays["DMA TOTAL MULTIPOLES"] = totvals;
+    outfile->Printf(
+        "\n  DMA results are available in the Python driver through the\n"
+        "\t  get_array_variable('DMA DISTRIBUTED MULTIPOLES')\n"
+        "  and\n"
+        "\t  get_array_variable('DMA TOTAL MULTIPOLES')\n"
+        "  commands.\n\n");
+
+    return ref_wfn;
+}
+
+}  // namespace gdma_interface
+}  // namespace psi
@@ -44,6 +44,8 @@ PRAGMA_WARNING_POP
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/twobody.h"
+#include "psi4/libpsi4util/process.h"
+#include <algorithm>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -52,6 +54,12 @@ namespace psi {
 
 Cholesky::Cholesky(double delta, size_t memory) : delta_(delta), memory_(memory), Q_(0) {}
 Cholesky::~Cholesky() {}
+void Cholesky::pivot_block(int pivot, std::vector<int>& rows) { rows.assign(1, pivot); }
+void Cholesky::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets) {
+    for (size_t i = 0; i < rows.size(); i++) {
+        compute_row(rows[i], targets[i]);
+    }
+}
 void Cholesky::choleskify() {
     // Initial dimensions
     size_t n = N();
@@ -73,6 +81,19 @@ void Cholesky::choleskify() {
     // List of selected pivots
     std::vector<int> pivots;
 
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    // The O(n) vector updates are threaded over contiguous chunks of the row
+    const size_t chunk = 4096;
+    const long int nchunk = (n + chunk - 1) / chunk;
+
+    // Rows computed in the current pass, alongside the pivot that triggered it
+    std::vector<int> block;
+    std::vector<double*> rows;
+
     // Cholesky procedure
     while (Q_ < n) {
         // Select the pivot
@@ -88,49 +109,88 @@ void Cholesky::choleskify() {
         // Check to see if convergence reached
         if (Dmax < delta_ || Dmax < 0.0) break;
 
-        // If here, we're trying to add this row
-        pivots.push_back(pivot);
-        double L_QQ = sqrt(Dmax);
-
-        // Check to see if memory constraints are OK
-        if (Q_ > max_rows) {
-            throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
-        }
-
-        // If here, we're really going to add this row
-        L.push_back(new double[n]);
+        // Compute the pivot row together with the rows that come cheaply with it and are still candidates. The
+        // extra rows are only consumed if they become the next pivot, so the pivot sequence (and L) is that of
+        // the one-row-at-a-time algorithm; only the integral passes are batched.
+        pivot_block(pivot, block);
+        block.erase(std::remove_if(block.begin(), block.end(),
+                                   [&](int P) { return P != (int)pivot && diag[P] < delta_; }),
+                    block.end());
+        if (Q_ + block.size() > max_rows) block.assign(1, pivot);
+        rows.resize(block.size());
+        for (size_t b = 0; b < block.size(); b++) rows[b] = new double[n];
+        compute_rows(block, rows);
+
+        while (true) {
+            // If here, we're trying to add this row
+            pivots.push_back(pivot);
+            double L_QQ = sqrt(Dmax);
+
+            // Check to see if memory constraints are OK
+            if (Q_ > max_rows) {
+                throw PSIEXCEPTION("Cholesky: Memory constraints exceeded. Fire your theorist.");
+            }
 
-        // (m|Q)
-        compute_row(pivot, L[Q_]);
+            // If here, we're really going to add this row: (m|Q)
+            size_t b = std::find(block.begin(), block.end(), (int)pivot) - block.begin();
+            L.push_back(rows[b]);
+            rows[b] = nullptr;
+            double* LQ = L[Q_];
+
+            // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (long int c = 0; c < nchunk; c++) {
+                size_t m0 = c * chunk;
+                size_t nm = std::min(chunk, n - m0);
+                for (size_t P = 0; P < Q_; P++) {
+                    C_DAXPY(nm, -L[P][pivot], &L[P][m0], 1, &LQ[m0], 1);
+                }
+                C_DSCAL(nm, 1.0 / L_QQ, &LQ[m0], 1);
+            }
 
-        // [(m|Q) - L_m^P L_Q^P]
-        for (size_t P = 0; P < Q_; P++) {
-            C_DAXPY(n, -L[P][pivots[Q_]], L[P], 1, L[Q_], 1);
-        }
+            // Zero the upper triangle
+            for (size_t P = 0; P < pivots.size(); P++) {
+                LQ[pivots[P]] = 0.0;
+            }
 
-        // 1/L_QQ [(m|Q) - L_m^P L_Q^P]
-        C_DSCAL(n, 1.0 / L_QQ, L[Q_], 1);
+            // Set the pivot factor
+            LQ[pivot] = L_QQ;
 
-        // Zero the upper triangle
-        for (size_t P = 0; P < pivots.size(); P++) {
-            L[Q_][pivots[P]] = 0.0;
-        }
+            // Update the Schur complement diagonal
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (long int c = 0; c < nchunk; c++) {
+                size_t m0 = c * chunk;
+                size_t m1 = std::min(m0 + chunk, n);
+                for (size_t P = m0; P < m1; P++) {
+                    diag[P] -= LQ[P] * LQ[P];
+                }
+            }
 
-        // Set the pivot factor
-        L[Q_][pivot] = L_QQ;
+            // Force truly zero elements to zero
+            for (size_t P = 0; P < pivots.size(); P++) {
+                diag[pivots[P]] = 0.0;
+            }
 
-        // Update the Schur complement diagonal
-        for (size_t P = 0; P < n; P++) {
-            diag[P] -= L[Q_][P] * L[Q_][P];
-        }
+            Q_++;
+            if (Q_ >= n) break;
 
-        // Force truly zero elements to zero
-        for (size_t P = 0; P < pivots.size(); P++) {
-            diag[pivots[P]] = 0.0;
+            // Carry on with this pass only if the next pivot's row is already in hand
+            pivot = 0;
+            Dmax = diag[0];
+            for (size_t P = 0; P < n; P++) {
+                if (Dmax < diag[P]) {
+                    Dmax = diag[P];
+                    pivot = P;
+                }
+            }
+            if (Dmax < delta_ || Dmax < 0.0) break;
+            b = std::find(block.begin(), block.end(), (int)pivot) - block.begin();
+            if (b == block.size() || rows[b] == nullptr) break;
         }
 
-        Q_++;
+        for (size_t b = 0; b < rows.size(); b++) delete[] rows[b];
     }
+    delete[] diag;
     // Copy into a more permanant Matrix object
     L_ = std::make_shared<Matrix>("Partial Cholesky", Q_, n);
     double** Lp = L_->pointer();
@@ -161,59 +221,118 @@ void CholeskyMatrix::compute_row(int row, double* target) {
 CholeskyERI::CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz, double delta, size_t memory)
     : integral_(integral), schwarz_(schwarz), Cholesky(delta, memory) {
     basisset_ = integral_->basis();
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    ints_.push_back(integral_);
+    if (integral_->cloneable()) {
+        for (int thread = 1; thread < nthread; thread++) {
+            ints_.push_back(std::shared_ptr<TwoBodyAOInt>(integral_->clone()));
+        }
+    }
 }
 CholeskyERI::~CholeskyERI() {}
 size_t CholeskyERI::N() { return basisset_->nbf() * basisset_->nbf(); }
 void CholeskyERI::compute_diagonal(double* target) {
-    const double* buffer = integral_->buffer();
-    for (size_t M = 0; M < basisset_->nshell(); M++) {
+    size_t nshell = basisset_->nshell();
+    shell_pair_max_.assign(nshell * nshell, 0.0);
+
+#pragma omp parallel for schedule(dynamic) num_threads(ints_.size())
+    for (long int M = 0; M < nshell; M++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double* buffer = ints_[thread]->buffer();
         for (size_t N = 0; N < basisset_->nshell(); N++) {
-            integral_->compute_shell(M, N, M, N);
+            ints_[thread]->compute_shell(M, N, M, N);
 
             size_t nM = basisset_->shell(M).nfunction();
             size_t nN = basisset_->shell(N).nfunction();
             size_t mstart = basisset_->shell(M).function_index();
             size_t nstart = basisset_->shell(N).function_index();
 
+            double max = 0.0;
             for (size_t om = 0; om < nM; om++) {
                 for (size_t on = 0; on < nN; on++) {
-                    target[(om + mstart) * basisset_->nbf() + (on + nstart)] =
-                        buffer[om * nN * nM * nN + on * nM * nN + om * nN + on];
+                    double val = buffer[om * nN * nM * nN + on * nM * nN + om * nN + on];
+                    target[(om + mstart) * basisset_->nbf() + (on + nstart)] = val;
+                    max = std::max(max, std::fabs(val));
                 }
             }
+            shell_pair_max_[M * nshell + N] = sqrt(max);
         }
     }
 }
 void CholeskyERI::compute_row(int row, double* target) {
-    size_t r = row / basisset_->nbf();
-    size_t s = row % basisset_->nbf();
-    size_t R = basisset_->function_to_shell(r);
-    size_t S = basisset_->function_to_shell(s);
+    compute_rows(std::vector<int>(1, row), std::vector<double*>(1, target));
+}
+void CholeskyERI::pivot_block(int pivot, std::vector<int>& rows) {
+    size_t nbf = basisset_->nbf();
+    const GaussianShell& R = basisset_->shell(basisset_->function_to_shell(pivot / nbf));
+    const GaussianShell& S = basisset_->shell(basisset_->function_to_shell(pivot % nbf));
+
+    rows.clear();
+    for (int r = R.function_index(); r < R.function_index() + R.nfunction(); r++) {
+        for (int s = S.function_index(); s < S.function_index() + S.nfunction(); s++) {
+            rows.push_back(r * nbf + s);
+        }
+    }
+}
+void CholeskyERI::compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets) {
+    if (rows.empty()) return;
+
+    size_t nbf = basisset_->nbf();
+    size_t nshell = basisset_->nshell();
+
+    size_t R = basisset_->function_to_shell(rows[0] / nbf);
+    size_t S = basisset_->function_to_shell(rows[0] % nbf);
+    for (int row : rows) {
+        if (basisset_->function_to_shell(row / nbf) != R || basisset_->function_to_shell(row % nbf) != S) {
+            throw PSIEXCEPTION("CholeskyERI: compute_rows rows must share a shell pair");
+        }
+    }
 
     size_t nR = basisset_->shell(R).nfunction();
     size_t nS = basisset_->shell(S).nfunction();
     size_t rstart = basisset_->shell(R).function_index();
     size_t sstart = basisset_->shell(S).function_index();
 
-    size_t oR = r - rstart;
-    size_t os = s - sstart;
-    int nshell = basisset_->nshell();
+    // Offset of each requested row within the RS block of the integral buffer
+    std::vector<size_t> offsets;
+    for (int row : rows) {
+        offsets.push_back((row / nbf - rstart) * nS + (row % nbf - sstart));
+    }
 
-    const double* buffer = integral_->buffer();
-    for (size_t M = 0; M < basisset_->nshell(); M++) {
-        for (size_t N = M; N < basisset_->nshell(); N++) {
-            integral_->compute_shell(M, N, R, S);
+    double RSmax = (shell_pair_max_.size() ? shell_pair_max_[R * nshell + S] : 0.0);
 
+#pragma omp parallel for schedule(dynamic) num_threads(ints_.size())
+    for (long int M = 0; M < nshell; M++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double* buffer = ints_[thread]->buffer();
+        for (size_t N = M; N < basisset_->nshell(); N++) {
             size_t nM = basisset_->shell(M).nfunction();
             size_t nN = basisset_->shell(N).nfunction();
             size_t mstart = basisset_->shell(M).function_index();
             size_t nstart = basisset_->shell(N).function_index();
 
-            for (size_t om = 0; om < nM; om++) {
-                for (size_t on = 0; on < nN; on++) {
-                    target[(om + mstart) * basisset_->nbf() + (on + nstart)] =
-                        target[(on + nstart) * basisset_->nbf() + (om + mstart)] =
-                            buffer[om * nN * nR * nS + on * nR * nS + oR * nS + os];
+            // Schwarz screening, |(mn|rs)| <= sqrt((mn|mn)(rs|rs))
+            bool screened = (shell_pair_max_.size() && shell_pair_max_[M * nshell + N] * RSmax < schwarz_);
+            if (!screened) ints_[thread]->compute_shell(M, N, R, S);
+
+            for (size_t i = 0; i < rows.size(); i++) {
+                double* target = targets[i];
+                size_t ors = offsets[i];
+                for (size_t om = 0; om < nM; om++) {
+                    for (size_t on = 0; on < nN; on++) {
+                        target[(om + mstart) * nbf + (on + nstart)] = target[(on + nstart) * nbf + (om + mstart)] =
+                            (screened ? 0.0 : buffer[om * nN * nR * nS + on * nR * nS + ors]);
+                    }
                 }
             }
         }
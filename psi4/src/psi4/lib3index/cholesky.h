@@ -32,6 +32,8 @@
 #include "psi4/pragma.h"
 #include "psi4/libmints/typedefs.h"
 
+#include <vector>
+
 namespace psi {
 
 class Vector;
@@ -76,6 +78,10 @@ public:
     virtual void compute_diagonal(double* target) = 0;
     /// Row row of the original square tensor, provided by the subclass
     virtual void compute_row(int row, double* target) = 0;
+    /// Rows that are cheap to compute together with row pivot (including pivot itself), by default just pivot
+    virtual void pivot_block(int pivot, std::vector<int>& rows);
+    /// Rows rows of the original square tensor, by default one compute_row call per row
+    virtual void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets);
 
 };
 
@@ -98,6 +104,10 @@ protected:
     double schwarz_;
     std::shared_ptr<BasisSet> basisset_;
     std::shared_ptr<TwoBodyAOInt> integral_;
+    /// One integral object per thread (just integral_ if it cannot be cloned)
+    std::vector<std::shared_ptr<TwoBodyAOInt> > ints_;
+    /// sqrt(max (mn|mn)) for each shell pair MN, filled by compute_diagonal and used for Schwarz screening
+    std::vector<double> shell_pair_max_;
 public:
     CholeskyERI(std::shared_ptr<TwoBodyAOInt> integral, double schwarz, double delta, size_t memory);
     virtual ~CholeskyERI();
@@ -105,6 +115,10 @@ public:
     virtual size_t N();
     virtual void compute_diagonal(double* target);
     virtual void compute_row(int row, double* target);
+    /// All functions pairs rs of the shell pair RS holding pivot
+    virtual void pivot_block(int pivot, std::vector<int>& rows);
+    /// Rows (mn|rs) for rs in a single shell pair RS, computed from one pass over the MN shell pairs
+    virtual void compute_rows(const std::vector<int>& rows, const std::vector<double*>& targets);
 };
 
 class CholeskyMP2 : public Cholesky {
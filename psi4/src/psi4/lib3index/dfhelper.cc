@@ -27,6 +27,7 @@
  */
 
 #include "dfhelper.h"
+#include "dfhelper_device.h"
 
 #include "psi4/psi4-dec.h"
 #include "psi4/liboptions/liboptions.h"
@@ -40,6 +41,7 @@
 #include "psi4/libmints/sieve.h"
 #include "psi4/lib3index/dftensor.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/shared_segment.h"
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.hpp"
@@ -47,6 +49,11 @@
 #include "psi4/libpsio/aiohandler.h"
 
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
 #ifdef _MSC_VER
 #include <process.h>
 #define SYSTEM_GETPID ::_getpid
@@ -167,6 +174,10 @@ void DFHelper::initialize() {
     direct_iaQ_ = (!method_.compare("DIRECT_iaQ") ? true : false);
     direct_ = (!method_.compare("DIRECT") ? true : false);
 
+    if (local_fitting_ && (direct_ || direct_iaQ_ || do_wK_)) {
+        throw PSIEXCEPTION("DFHelper:initialize: local fitting is only available for the STORE method without wK");
+    }
+
     // did we get enough memory for at least the metric?
     if(naux_ * naux_ > memory_) {
         std::stringstream error;
@@ -175,19 +186,40 @@ void DFHelper::initialize() {
         throw PSIEXCEPTION(error.str().c_str());
     }
 
-    // if metric power is not zero, prepare it
-    if (!(std::fabs(mpower_ - 0.0) < 1e-13)) (hold_met_ ? prepare_metric_core() : prepare_metric());
-
     // prepare sparsity masks
     timer_on("DFH: sparsity prep");
     prepare_sparsity();
     timer_off("DFH: sparsity prep");
 
-    // figure out AO_core
-    AO_core();
+    // figure out AO_core (locally fitted AOs are expanded block by block, like AOs on disk)
+    if (local_fitting_) {
+        AO_core_ = false;
+    } else {
+        AO_core();
+    }
+
+    // a sibling process of the shared-memory session may already hold the AOs
+    bool cached = AO_core_ && !mixed_precision_ && prepare_AO_shared();
+
+    // an earlier job may have left matching AOs in the scratch directory
+    std::string cache_key;
+    if (!cached && AO_cache_ && !direct_ && !direct_iaQ_ && !do_wK_ && !local_fitting_) {
+        cache_key = AO_cache_key();
+        cached = load_AO_cache(cache_key);
+    }
+
+    // if metric power is not zero, prepare it (cached AOs are already contracted)
+    if (!cached && !local_fitting_ && !(std::fabs(mpower_ - 0.0) < 1e-13))
+        (hold_met_ ? prepare_metric_core() : prepare_metric());
 
     // prepare AOs for STORE method
-    if (AO_core_) {
+    if (cached) {
+        // nothing left to build
+    } else if (local_fitting_) {
+        timer_on("DFH: local fitting");
+        prepare_AO_local();
+        timer_off("DFH: local fitting");
+    } else if (AO_core_) {
         prepare_AO_core();
         if (do_wK_) {
             std::stringstream error;
@@ -204,6 +236,18 @@ void DFHelper::initialize() {
             // TODO prepare_AO_wK();
         }
     }
+    if (!cache_key.empty() && !cached) store_AO_cache(cache_key);
+
+    // single precision copy for the mixed-precision J/K builds
+    if (mixed_precision_ && AO_core_ && !direct_ && !direct_iaQ_) {
+        size_t size = big_skips_[nao_];
+        Ppq_sp_ = std::unique_ptr<float[]>(new float[size]);
+        float* Pfp = Ppq_sp_.get();
+        double* Pp = Ppq_.get();
+#pragma omp parallel for simd num_threads(nthreads_) schedule(static)
+        for (size_t i = 0; i < size; i++) Pfp[i] = (float)Pp[i];
+        Ppq_.reset();
+    }
 
     built_ = true;
     timer_off("DFH: initialize()");
@@ -241,6 +285,169 @@ void DFHelper::AO_core() {
         outfile->Printf("%s in-core AOs.\n\n", (memory_ < required) ? "Turning off" : "Using");
     }
 }
+void DFHelper::prepare_device(size_t max_nocc) {
+    // only the in-core double precision AOs are offloaded
+    if (!device_offload_ || device_failed_ || !AO_core_ || !Ppq_data() || direct_ || direct_iaQ_) return;
+    if (device_ && device_->max_nocc() >= max_nocc) return;
+    device_.reset();
+
+    std::vector<size_t> columns;
+    columns.reserve(big_skips_[nao_] / naux_);
+    for (size_t k = 0; k < nao_; k++) {
+        for (size_t m = 0; m < nao_; m++) {
+            if (schwarz_fun_mask_[k * nao_ + m]) columns.push_back(m);
+        }
+    }
+    std::vector<size_t> small_skips(small_skips_.begin(), small_skips_.begin() + nao_);
+
+    timer_on("DFH: device upload");
+    device_ = DFHelperDevice::build(Ppq_data(), nao_, naux_, max_nocc, small_skips, columns);
+    timer_off("DFH: device upload");
+
+    if (!device_) {
+        device_failed_ = true;
+        outfile->Printf("  DFHelper: no device available for the AOs, K stays on the host.\n\n");
+    } else if (print_lvl_ > 0) {
+        outfile->Printf("  DFHelper: AOs resident on the device, K built in Q blocks of %zu.\n\n",
+                        device_->Q_block());
+    }
+}
+void DFHelper::promote_precision() {
+    if (!Ppq_sp_) return;
+    Ppq_sp_.reset();
+
+    // the float AOs cannot be promoted in place, so rebuild (or reload) them
+    timer_on("DFH: promote precision");
+    if (!(AO_cache_ && load_AO_cache(AO_cache_key()))) {
+        if (hold_met_ && !(std::fabs(mpower_ - 0.0) < 1e-13)) prepare_metric_core();
+        prepare_AO_core();
+    }
+    timer_off("DFH: promote precision");
+
+    if (print_lvl_ > 0) outfile->Printf("  DFHelper: switched to double precision AOs.\n\n");
+}
+std::string DFHelper::AO_cache_key() {
+    // everything the metric-contracted, Schwarz-screened AOs depend on
+    std::stringstream key;
+    key.precision(17);
+    for (auto basis : {primary_, aux_}) {
+        key << basis->name() << " " << basis->has_puream() << " " << basis->nshell() << "\n";
+        for (int P = 0; P < basis->nshell(); P++) {
+            const GaussianShell& shell = basis->shell(P);
+            const double* center = shell.center();
+            key << shell.am() << " " << shell.is_pure() << " " << center[0] << " " << center[1] << " " << center[2];
+            for (int K = 0; K < shell.nprimitive(); K++) key << " " << shell.exp(K) << " " << shell.original_coef(K);
+            key << "\n";
+        }
+    }
+    key << cutoff_ << " " << condition_ << " " << mpower_ << " " << big_skips_[nao_] << "\n";
+    return key.str();
+}
+double* DFHelper::Ppq_data() {
+    // the segment is read-only: nothing writes to the AOs once built
+    return Ppq_shared_ ? (double*)Ppq_shared_->data() : Ppq_.get();
+}
+bool DFHelper::prepare_AO_shared() {
+    if (!SharedSegment::enabled() || direct_ || direct_iaQ_ || do_wK_ || local_fitting_) return false;
+
+    // the first process of the session builds the AOs straight into the segment, the others map them
+    size_t size = big_skips_[nao_];
+    Ppq_shared_ = SharedSegment::acquire("DFHelper AOs\n" + AO_cache_key(), size * sizeof(double), [&](void* data) {
+        if (!(std::fabs(mpower_ - 0.0) < 1e-13)) (hold_met_ ? prepare_metric_core() : prepare_metric());
+        prepare_AO_core();
+        std::memcpy(data, Ppq_.get(), size * sizeof(double));
+        Ppq_.reset();
+    });
+    if (!Ppq_shared_) return false;
+
+    if (print_lvl_ > 0)
+        outfile->Printf("  DFHelper: %s in-core AOs in shared memory %s.\n\n",
+                        Ppq_shared_->created() ? "placed" : "mapped", Ppq_shared_->name().c_str());
+    return true;
+}
+std::string DFHelper::AO_cache_file(const std::string& key) {
+    std::stringstream name;
+    name << PSIOManager::shared_object()->get_default_path() << "psi.dfh.AO." << std::hex
+         << std::hash<std::string>()(key) << ".dat";
+    return name.str();
+}
+bool DFHelper::load_AO_cache(const std::string& key) {
+    std::string file = AO_cache_file(key);
+
+    // the full key is kept next to the AOs, so hash collisions are caught here
+    std::ifstream keyfile(file + ".key");
+    if (!keyfile.good()) return false;
+    std::stringstream stored;
+    stored << keyfile.rdbuf();
+    if (stored.str() != key) return false;
+
+    // the file must hold exactly the sparse AOs we expect
+    size_t size = big_skips_[nao_];
+    FILE* fp = fopen(file.c_str(), "rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    if ((size_t)ftell(fp) != size * sizeof(double)) {
+        fclose(fp);
+        return false;
+    }
+
+    if (AO_core_) {
+        Ppq_ = std::unique_ptr<double[]>(new double[size]);
+        rewind(fp);
+        size_t s = fread(&Ppq_[0], sizeof(double), size, fp);
+        fclose(fp);
+        if (s != size) return false;
+    } else {
+        fclose(fp);
+        // stream straight out of the cache file, and leave it behind when done
+        AO_filename_maker(1);
+        AO_filename_maker(2);
+        AO_files_[AO_names_[1]] = file;
+        stream_check(file, "rb");
+        file_streams_[file]->keep_ = true;
+    }
+
+    if (print_lvl_ > 0) outfile->Printf("  DFHelper: reusing cached AOs from %s.\n\n", file.c_str());
+    return true;
+}
+void DFHelper::store_AO_cache(const std::string& key) {
+    std::string file = AO_cache_file(key);
+
+    // write under private names first, so concurrent jobs never see a partial cache
+    std::string tmp = file + "." + std::to_string(SYSTEM_GETPID());
+    std::ofstream keyfile(tmp + ".key");
+    keyfile << key;
+    keyfile.close();
+
+    bool stored;
+    if (AO_core_) {
+        size_t size = big_skips_[nao_];
+        FILE* fp = fopen(tmp.c_str(), "wb");
+        stored = (fp && fwrite(&Ppq_[0], sizeof(double), size, fp) == size);
+        if (fp) fclose(fp);
+        stored = stored && !std::rename(tmp.c_str(), file.c_str());
+    } else {
+        // the AOs were just written to disk; move that file into the cache
+        std::string aofile = AO_files_[AO_names_[1]];
+        if (file_streams_.count(aofile)) fflush(file_streams_[aofile]->fp_);
+        stored = !std::rename(aofile.c_str(), file.c_str());
+        if (stored) {
+            file_streams_.erase(aofile);
+            AO_files_[AO_names_[1]] = file;
+            stream_check(file, "rb");
+            file_streams_[file]->keep_ = true;
+        }
+    }
+
+    if (stored) stored = !std::rename((tmp + ".key").c_str(), (file + ".key").c_str());
+    if (!stored) {
+        std::remove(tmp.c_str());
+        std::remove((tmp + ".key").c_str());
+        outfile->Printf("  DFHelper: could not write the AO cache %s.\n\n", file.c_str());
+    } else if (print_lvl_ > 0) {
+        outfile->Printf("  DFHelper: AOs cached in %s.\n\n", file.c_str());
+    }
+}
 void DFHelper::print_header() {
     outfile->Printf("  ==> DFHelper <==\n");
     outfile->Printf("    nao:                     %11ld\n", nao_);
@@ -251,6 +458,7 @@ void DFHelper::print_header() {
     outfile->Printf("    OpenMP threads:          %11d\n", nthreads_);
     outfile->Printf("    Algorithm:               %11s\n", method_.c_str());
     outfile->Printf("    AO_core:                 %11s\n", (AO_core_ ? "True" : "False"));
+    outfile->Printf("    Local fitting:           %11s\n", (local_fitting_ ? "True" : "False"));
     outfile->Printf("    MO_core:                 %11s\n", (MO_core_ ? "True" : "False"));
     outfile->Printf("    Hold Metric:             %11s\n", (hold_met_ ? "True" : "False"));
     outfile->Printf("    Metric Power:            %11.0E\n", mpower_);
@@ -287,6 +495,9 @@ void DFHelper::prepare_sparsity() {
         buffer[rank] = eri[rank]->buffer();
     }
 
+    // only shell pairs close enough to matter are computed
+    ShellPairList candidates = ERISieve::distance_pairs(primary_, cutoff_);
+
     double val, max_val = 0.0;
     size_t MU, NU, mu, nu, omu, onu, nummu, numnu, index;
 #pragma omp parallel for private(MU, NU, mu, nu, omu, onu, nummu, numnu, index, val, \
@@ -296,7 +507,8 @@ void DFHelper::prepare_sparsity() {
         rank = omp_get_thread_num();
 #endif
         nummu = primary_->shell(MU).nfunction();
-        for (NU = 0; NU <= MU; ++NU) {
+        for (const int* NUp = candidates.begin(MU); NUp != candidates.end(MU) && (size_t)*NUp <= MU; ++NUp) {
+            NU = *NUp;
             numnu = primary_->shell(NU).nfunction();
             eri[rank]->compute_shell(MU, NU, MU, NU);
             for (mu = 0; mu < nummu; ++mu) {
@@ -663,7 +875,8 @@ std::tuple<size_t, size_t> DFHelper::Qshell_blocks_for_JK_build(
         tmpbs += end - begin + 1;
 
         // compute total memory used by aggregate block
-        size_t constraint = total_AO_buffer + T1 * tmpbs + T3;
+        // (streamed AOs are double-buffered so that reads overlap the contractions)
+        size_t constraint = (AO_core_ ? total_AO_buffer : 2 * total_AO_buffer) + T1 * tmpbs + T3;
         constraint += (lr_symmetric ? T2 : T2 * tmpbs);
 
         if (constraint > memory_ || i == Qshells_ - 1) {
@@ -719,7 +932,7 @@ DFHelper::StreamStruct::~StreamStruct(){
 
     fflush(fp_);
     fclose(fp_);
-    std::remove(filename_.c_str());
+    if (!keep_) std::remove(filename_.c_str());
 }
 
 FILE* DFHelper::StreamStruct::get_stream(std::string op){
@@ -940,6 +1153,13 @@ void DFHelper::get_tensor_(std::string file, double* b, const size_t start1, con
     }
 }
 
+// aux shells [start, stop] as (P0| bra blocks of a single AM class each
+static std::vector<ShellPairBlock> aux_shell_blocks(const size_t start, const size_t stop,
+                                                    std::shared_ptr<TwoBodyAOInt> eri) {
+    ShellPairBlock Pshells;
+    for (size_t Pshell = start; Pshell <= stop; Pshell++) Pshells.push_back(std::make_pair((int)Pshell, 0));
+    return eri->am_blocks(Pshells, true, eri->max_block_quartets());
+}
 void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t stop, double* Mp,
                              std::vector<std::shared_ptr<TwoBodyAOInt>> eri) {
 
@@ -954,18 +1174,9 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
     // stripe the buffer
     fill(Mp, block_size * nao_ * nao_, 0.0);
 
-    // prepare eri buffers
+    // batch the aux shells by AM class
     int rank = 0;
-    size_t nthread = nthreads_;
-    if (eri.size() != nthreads_) nthread = eri.size();
-    std::vector<const double*> buffer(nthread);
-#pragma omp parallel private(rank) num_threads(nthread)
-    {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<ShellPairBlock> Pblocks = aux_shell_blocks(start, stop, eri[0]);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
 #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, \
@@ -980,10 +1191,14 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (Pshell = start; Pshell <= stop; Pshell++) {
+            const ShellPairBlock ket(1, std::make_pair(MU, NU));
+            for (const auto& Pblock : Pblocks) {
+            eri[rank]->compute_shell_blocks(Pblock, ket);
+            const double* buffer = eri[rank]->block_buffer();
+            for (const auto& P0 : Pblock) {
+                Pshell = P0.first;
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_->shell(Pshell).nfunction();
-                eri[rank]->compute_shell(Pshell, 0, MU, NU);
                 for (mu = 0; mu < nummu; mu++) {
                     omu = primary_->shell(MU).function_index() + mu;
                     for (nu = 0; nu < numnu; nu++) {
@@ -994,10 +1209,12 @@ void DFHelper::compute_dense_Qpq_blocking_Q(const size_t start, const size_t sto
                         for (P = 0; P < numP; P++) {
                             Mp[(PHI + P - begin) * nao_ * nao_ + omu * nao_ + onu] =
                             Mp[(PHI + P - begin) * nao_ * nao_ + onu * nao_ + omu] =
-                            buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                            buffer[P * nummu * numnu + mu * numnu + nu];
                         }
                     }
                 }
+                buffer += numP * nummu * numnu;
+            }
             }
         }
     }
@@ -1009,19 +1226,9 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
     size_t end = Qshell_aggs_[stop + 1] - 1;
     size_t block_size = end - begin + 1;
 
-    // prepare eri buffers
-    size_t nthread = nthreads_;
-    if (eri.size() != nthreads_) nthread = eri.size();
-
+    // batch the aux shells by AM class
     int rank = 0;
-    std::vector<const double*> buffer(nthread);
-#pragma omp parallel private(rank) num_threads(nthread)
-    {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<ShellPairBlock> Pblocks = aux_shell_blocks(start, stop, eri[0]);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
 #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, \
@@ -1036,10 +1243,14 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (Pshell = start; Pshell <= stop; Pshell++) {
+            const ShellPairBlock ket(1, std::make_pair(MU, NU));
+            for (const auto& Pblock : Pblocks) {
+            eri[rank]->compute_shell_blocks(Pblock, ket);
+            const double* buffer = eri[rank]->block_buffer();
+            for (const auto& P0 : Pblock) {
+                Pshell = P0.first;
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_->shell(Pshell).nfunction();
-                eri[rank]->compute_shell(Pshell, 0, MU, NU);
                 for (mu = 0; mu < nummu; mu++) {
                     omu = primary_->shell(MU).function_index() + mu;
                     for (nu = 0; nu < numnu; nu++) {
@@ -1050,10 +1261,12 @@ void DFHelper::compute_sparse_pQq_blocking_Q(const size_t start, const size_t st
                         for (P = 0; P < numP; P++) {
                             Mp[(big_skips_[omu] * block_size) / naux_ + (PHI + P - begin) * small_skips_[omu] +
                                schwarz_fun_mask_[omu * nao_ + onu] - 1] =
-                                buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                                buffer[P * nummu * numnu + mu * numnu + nu];
                         }
                     }
                 }
+                buffer += numP * nummu * numnu;
+            }
             }
         }
     }
@@ -1067,19 +1280,12 @@ void DFHelper::compute_sparse_pQq_blocking_p(const size_t start, const size_t st
     //    outfile->Printf("      MU shell: (%zu, %zu)", start, stop);
     //    outfile->Printf(", nao index: (%zu, %zu), size: %zu\n", begin, end, block_size);
 
-    // prepare eri buffers
+    // batch the aux shells by AM class
     size_t nthread = nthreads_;
     if (eri.size() != nthreads_) nthread = eri.size();
 
     int rank = 0;
-    std::vector<const double*> buffer(nthread);
-#pragma omp parallel for private(rank) num_threads(nthread) schedule(static)
-    for (size_t i = 0; i < nthread; i++) {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<ShellPairBlock> Pblocks = aux_shell_blocks(0, Qshells_ - 1, eri[0]);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
 #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, \
@@ -1094,10 +1300,14 @@ void DFHelper::compute_sparse_pQq_blocking_p(const size_t start, const size_t st
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (Pshell = 0; Pshell < Qshells_; Pshell++) {
+            const ShellPairBlock ket(1, std::make_pair(MU, NU));
+            for (const auto& Pblock : Pblocks) {
+            eri[rank]->compute_shell_blocks(Pblock, ket);
+            const double* buffer = eri[rank]->block_buffer();
+            for (const auto& P0 : Pblock) {
+                Pshell = P0.first;
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_->shell(Pshell).nfunction();
-                eri[rank]->compute_shell(Pshell, 0, MU, NU);
                 for (mu = 0; mu < nummu; mu++) {
                     omu = primary_->shell(MU).function_index() + mu;
                     for (nu = 0; nu < numnu; nu++) {
@@ -1108,10 +1318,12 @@ void DFHelper::compute_sparse_pQq_blocking_p(const size_t start, const size_t st
                         for (P = 0; P < numP; P++) {
                             Mp[big_skips_[omu] - startind + (PHI + P) * small_skips_[omu] +
                                schwarz_fun_mask_[omu * nao_ + onu] - 1] =
-                                buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                                buffer[P * nummu * numnu + mu * numnu + nu];
                         }
                     }
                 }
+                buffer += numP * nummu * numnu;
+            }
             }
         }
     }
@@ -1125,19 +1337,12 @@ void DFHelper::compute_sparse_pQq_blocking_p_symm(const size_t start, const size
     //    outfile->Printf("      MU shell: (%zu, %zu)", start, stop);
     //    outfile->Printf(", nao index: (%zu, %zu), size: %zu\n", begin, end, block_size);
 
-    // prepare eri buffers
+    // batch the aux shells by AM class
     size_t nthread = nthreads_;
     if (eri.size() != nthreads_) nthread = eri.size();
 
     int rank = 0;
-    std::vector<const double*> buffer(nthread);
-#pragma omp parallel for private(rank) num_threads(nthread) schedule(static)
-    for (size_t i = 0; i < nthread; i++) {
-#ifdef _OPENMP
-        rank = omp_get_thread_num();
-#endif
-        buffer[rank] = eri[rank]->buffer();
-    }
+    std::vector<ShellPairBlock> Pblocks = aux_shell_blocks(0, Qshells_ - 1, eri[0]);
 
     size_t MU, nummu, NU, numnu, Pshell, numP, mu, omu, nu, onu, P, PHI;
 #pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, \
@@ -1152,10 +1357,14 @@ void DFHelper::compute_sparse_pQq_blocking_p_symm(const size_t start, const size
             if (!schwarz_shell_mask_[MU * pshells_ + NU]) {
                 continue;
             }
-            for (Pshell = 0; Pshell < Qshells_; Pshell++) {
+            const ShellPairBlock ket(1, std::make_pair(MU, NU));
+            for (const auto& Pblock : Pblocks) {
+            eri[rank]->compute_shell_blocks(Pblock, ket);
+            const double* buffer = eri[rank]->block_buffer();
+            for (const auto& P0 : Pblock) {
+                Pshell = P0.first;
                 PHI = aux_->shell(Pshell).function_index();
                 numP = aux_->shell(Pshell).nfunction();
-                eri[rank]->compute_shell(Pshell, 0, MU, NU);
                 for (mu = 0; mu < nummu; mu++) {
                     omu = primary_->shell(MU).function_index() + mu;
                     for (nu = 0; nu < numnu; nu++) {
@@ -1166,15 +1375,22 @@ void DFHelper::compute_sparse_pQq_blocking_p_symm(const size_t start, const size
                         for (P = 0; P < numP; P++) {
                             size_t jump = schwarz_fun_mask_[omu * nao_ + onu] - schwarz_fun_mask_[omu * nao_ + omu];
                             size_t ind1 = symm_big_skips_[omu] - startind + (PHI + P) * symm_small_skips_[omu] + jump;
-                            Mp[ind1] = buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                            Mp[ind1] = buffer[P * nummu * numnu + mu * numnu + nu];
                         }
                     }
                 }
+                buffer += numP * nummu * numnu;
+            }
             }
         }
     }
 }
 void DFHelper::grab_AO(const size_t start, const size_t stop, double* Mp) {
+    if (local_fitting_) {
+        grab_AO_local(start, stop, Mp);
+        return;
+    }
+
     size_t begin = Qshell_aggs_[start];
     size_t end = Qshell_aggs_[stop + 1] - 1;
     size_t block_size = end - begin + 1;
@@ -1188,6 +1404,190 @@ void DFHelper::grab_AO(const size_t start, const size_t stop, double* Mp) {
         sta += size;
     }
 }
+void DFHelper::prepare_AO_local() {
+    size_t natom = primary_->molecule()->natom();
+
+    // auxiliary functions are ordered by center; atoms without any start where the next atom does
+    aux_atom_starts_.assign(natom + 1, naux_);
+    for (size_t P = naux_; P > 0; P--) {
+        if (P < naux_ && aux_->function_to_center(P - 1) > aux_->function_to_center(P)) {
+            throw PSIEXCEPTION("DFHelper: local fitting needs the auxiliary functions ordered by center");
+        }
+        aux_atom_starts_[aux_->function_to_center(P - 1)] = P - 1;
+    }
+    for (size_t A = natom; A > 0; A--) aux_atom_starts_[A - 1] = std::min(aux_atom_starts_[A - 1], aux_atom_starts_[A]);
+
+    // group the significant columns of each row into runs on the same atom
+    local_blocks_.assign(nao_, {});
+    size_t total = 0;
+    for (size_t m = 0; m < nao_; m++) {
+        size_t A = primary_->function_to_center(m);
+        size_t nA = aux_atom_starts_[A + 1] - aux_atom_starts_[A];
+        for (size_t n = 0, col = 0; n < nao_; n++) {
+            if (!schwarz_fun_mask_[m * nao_ + n]) continue;
+            size_t B = primary_->function_to_center(n);
+            if (local_blocks_[m].empty() || std::get<0>(local_blocks_[m].back()) != B) {
+                local_blocks_[m].push_back(std::make_tuple(B, col, 0, total));
+            }
+            std::get<2>(local_blocks_[m].back())++;
+            total += nA + (B == A ? 0 : aux_atom_starts_[B + 1] - aux_atom_starts_[B]);
+            col++;
+        }
+    }
+
+    // the full metric provides the pair blocks and J^(mpower + 1)
+    auto Jfit = std::make_shared<FittingMetric>(aux_, true);
+    Jfit->form_fitting_metric();
+    SharedMatrix J = Jfit->get_metric();
+    double** Jp = J->pointer();
+    local_metric_ = J->clone();
+    if (std::fabs(mpower_ + 1.0 - 1.0) > 1e-13) local_metric_->power(mpower_ + 1.0, condition_);
+
+    // the coefficients live alongside the expanded Q blocks
+    size_t required = total + naux_ * naux_;
+    if (required >= memory_) {
+        std::stringstream error;
+        error << "DFHelper: local fitting needs " << required * 8 / (1024 * 1024 * 1024.0) << "[GiB] for the "
+              << "coefficients and metric, but we only got " << memory_ * 8 / (1024 * 1024 * 1024.0) << "[GiB].";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+    memory_ -= required;
+    Cpq_local_ = std::unique_ptr<double[]>(new double[total]);
+    double* Cp = Cpq_local_.get();
+    fill(Cp, total, 0.0);
+
+    if (print_lvl_ > 0) {
+        outfile->Printf("  DFHelper Memory: locally fitted AOs need %.3f GiB (%.3f GiB for full fitting).\n\n",
+                        total * 8 / (1024 * 1024 * 1024.0), big_skips_[nao_] * 8 / (1024 * 1024 * 1024.0));
+    }
+
+    // one eri object per thread
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    auto rifactory = std::make_shared<IntegralFactory>(aux_, zero, primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> eri(nthreads_);
+    for (size_t i = 0; i < nthreads_; i++) eri[i] = std::shared_ptr<TwoBodyAOInt>(rifactory->eri());
+
+    // fit every atom pair AB against the aux functions on A and B: C_mn = J_AB^-1 (P|mn)
+    bool singular = false;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t AB = 0; AB < natom * natom; AB++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        size_t A = AB / natom;
+        size_t B = AB % natom;
+
+        // the rows of A that hold a block on B, and where it is
+        std::vector<std::pair<size_t, const std::tuple<size_t, size_t, size_t, size_t>*>> rows;
+        for (int Mi = 0; Mi < primary_->nshell_on_center(A); Mi++) {
+            const GaussianShell& Msh = primary_->shell(primary_->shell_on_center(A, Mi));
+            for (int om = 0; om < Msh.nfunction(); om++) {
+                size_t m = Msh.function_index() + om;
+                for (const auto& block : local_blocks_[m]) {
+                    if (std::get<0>(block) == B) rows.push_back(std::make_pair(m, &block));
+                }
+            }
+        }
+        if (rows.empty()) continue;
+
+        // the pair's fitting space and its metric
+        size_t A0 = aux_atom_starts_[A];
+        size_t nA = aux_atom_starts_[A + 1] - A0;
+        size_t B0 = aux_atom_starts_[B];
+        size_t nB = (B == A ? 0 : aux_atom_starts_[B + 1] - B0);
+        size_t nS = nA + nB;
+        if (!nS) continue;
+        std::vector<size_t> S(nS);
+        for (size_t P = 0; P < nA; P++) S[P] = A0 + P;
+        for (size_t P = 0; P < nB; P++) S[nA + P] = B0 + P;
+        std::vector<double> JS(nS * nS);
+        for (size_t P = 0; P < nS; P++) {
+            for (size_t Q = 0; Q < nS; Q++) JS[P * nS + Q] = Jp[S[P]][S[Q]];
+        }
+        if (C_DPOTRF('L', nS, JS.data(), nS)) {
+            singular = true;
+            continue;
+        }
+
+        // (P|mn) for the significant shell pairs on A and B
+        const double* buffer = eri[rank]->buffer();
+        std::vector<int> Pshells;
+        for (int Pi = 0; Pi < aux_->nshell_on_center(A); Pi++) Pshells.push_back(aux_->shell_on_center(A, Pi));
+        if (B != A) {
+            for (int Pi = 0; Pi < aux_->nshell_on_center(B); Pi++) Pshells.push_back(aux_->shell_on_center(B, Pi));
+        }
+        for (int Mi = 0; Mi < primary_->nshell_on_center(A); Mi++) {
+            size_t M = primary_->shell_on_center(A, Mi);
+            size_t nm = primary_->shell(M).nfunction();
+            size_t m0 = primary_->shell(M).function_index();
+            for (int Ni = 0; Ni < primary_->nshell_on_center(B); Ni++) {
+                size_t N = primary_->shell_on_center(B, Ni);
+                if (!schwarz_shell_mask_[M * pshells_ + N]) continue;
+                size_t nn = primary_->shell(N).nfunction();
+                size_t n0 = primary_->shell(N).function_index();
+                for (int Psh : Pshells) {
+                    size_t np = aux_->shell(Psh).nfunction();
+                    size_t p0 = aux_->shell(Psh).function_index();
+                    size_t Poff = (aux_->shell(Psh).ncenter() == (int)A ? p0 - A0 : nA + p0 - B0);
+                    eri[rank]->compute_shell(Psh, 0, M, N);
+                    for (const auto& row : rows) {
+                        size_t m = row.first;
+                        if (m < m0 || m >= m0 + nm) continue;
+                        size_t col0 = std::get<1>(*row.second);
+                        double* Cm = &Cp[std::get<3>(*row.second)];
+                        for (size_t on = 0; on < nn; on++) {
+                            size_t mask = schwarz_fun_mask_[m * nao_ + n0 + on];
+                            if (!mask) continue;
+                            double* Cmn = &Cm[(mask - 1 - col0) * nS + Poff];
+                            for (size_t op = 0; op < np; op++) {
+                                Cmn[op] = buffer[op * nm * nn + (m - m0) * nn + on];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // solve J_AB C_mn = (P|mn) for every column at once
+        for (const auto& row : rows) {
+            C_DPOTRS('L', nS, std::get<2>(*row.second), JS.data(), nS, &Cp[std::get<3>(*row.second)], nS);
+        }
+    }
+    if (singular) throw PSIEXCEPTION("DFHelper: local fitting metric of an atom pair is not positive definite");
+}
+void DFHelper::grab_AO_local(const size_t start, const size_t stop, double* Mp) {
+    size_t begin = Qshell_aggs_[start];
+    size_t end = Qshell_aggs_[stop + 1] - 1;
+    size_t block_size = end - begin + 1;
+    double* Wp = local_metric_->pointer()[begin];
+    double* Cp = Cpq_local_.get();
+
+    // (Q|mn) = sum_{P in A, B} [J^(mpower + 1)]_QP C^P_mn, in the layout grab_AO reads from disk
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads_)
+    for (size_t m = 0; m < nao_; m++) {
+        size_t A = primary_->function_to_center(m);
+        size_t sk = small_skips_[m];
+        double* Mm = &Mp[(big_skips_[m] * block_size) / naux_];
+        size_t A0 = aux_atom_starts_[A];
+        size_t nA = aux_atom_starts_[A + 1] - A0;
+        for (const auto& block : local_blocks_[m]) {
+            size_t B = std::get<0>(block);
+            size_t col0 = std::get<1>(block);
+            size_t ncol = std::get<2>(block);
+            double* Cm = &Cp[std::get<3>(block)];
+            size_t B0 = aux_atom_starts_[B];
+            size_t nB = (B == A ? 0 : aux_atom_starts_[B + 1] - B0);
+            size_t nS = nA + nB;
+            if (!nA) {
+                for (size_t Q = 0; Q < block_size; Q++) std::fill_n(&Mm[Q * sk + col0], ncol, 0.0);
+            }
+            C_DGEMM('N', 'T', block_size, ncol, nA, 1.0, &Wp[A0], naux_, Cm, nS, 0.0, &Mm[col0], sk);
+            C_DGEMM('N', 'T', block_size, ncol, nB, 1.0, &Wp[B0], naux_, &Cm[nA], nS, (nA ? 1.0 : 0.0), &Mm[col0],
+                    sk);
+        }
+    }
+}
 void DFHelper::prepare_metric_core() {
     timer_on("DFH: metric contsruction");
     auto Jinv = std::make_shared<FittingMetric>(aux_, true);
@@ -1469,6 +1869,7 @@ void DFHelper::add_transformation(std::string name, std::string key1, std::strin
         throw PSIEXCEPTION("DF_Hepler:add_transformation: incorrect integral format, use 'Qpq', 'pQq', or 'pqQ'");
     }
     transf_[name] = std::make_tuple(key1, key2, op);
+    ordered_ = false;
 
     size_t a1 = std::get<1>(spaces_[key1]);
     size_t a2 = std::get<1>(spaces_[key2]);
@@ -1504,72 +1905,156 @@ void DFHelper::clear_all() {
 }
 
 std::pair<size_t, size_t> DFHelper::identify_order() {
-    // Identify order of transformations to use strategic intermediates
-    std::sort(sorted_spaces_.begin(), sorted_spaces_.end(),
-              [](const std::pair<std::string, size_t>& left, const std::pair<std::string, size_t>& right) {
-                  return left.second < right.second;
-              });
-
-    // copy transf_ keys into a list of needs
-    std::list<std::string> needs;
-    for (auto const& itr : transf_) needs.push_back(itr.first);
-
-    // construct best transformation order
-    size_t largest = 0, maximum = 0, small, large, op;
-    for (size_t i = 0; i < sorted_spaces_.size(); i++) {
-        bool on = false;
-        size_t st = 0;
-        std::string str = sorted_spaces_[i].first;
-
-        auto itr = needs.begin();
-        while (itr != needs.end()) {
-            op = 0;
-            op = (!(std::get<0>(transf_[*itr]).compare(str)) ? 1 : op);
-            op = (!(std::get<1>(transf_[*itr]).compare(str)) ? 2 : op);
-            if (op != 0) {
-                if (!on) {
-                    bspace_.push_back(str);
-                    on = true;
+    // Plan the transformations as a bipartite DAG: every requested (Q|lr) hangs off one first-half
+    // intermediate (Q|mb) with b in {l, r}. The second contraction costs the same whichever side is
+    // picked, so the plan only decides which first halves to form. That is a minimum weighted vertex
+    // cover over the spaces (weight = space size, edge = transformation), solved exactly for the
+    // handful of spaces codes actually register and greedily otherwise.
+    order_.clear();
+    bspace_.clear();
+    strides_.clear();
+
+    // distinct spaces touched by the requested transformations, smallest first
+    std::vector<std::pair<std::string, size_t>> cands;
+    for (auto const& kv : transf_) {
+        for (const std::string& key : {std::get<0>(kv.second), std::get<1>(kv.second)}) {
+            bool found = false;
+            for (auto const& c : cands) found = (found || c.first == key);
+            if (!found) cands.push_back(std::make_pair(key, std::get<1>(spaces_[key])));
+        }
+    }
+    std::stable_sort(cands.begin(), cands.end(),
+                     [](const std::pair<std::string, size_t>& left, const std::pair<std::string, size_t>& right) {
+                         return left.second < right.second;
+                     });
+    size_t nspace = cands.size();
+    auto index = [&cands](const std::string& key) {
+        size_t i = 0;
+        while (cands[i].first != key) i++;
+        return i;
+    };
+    std::vector<std::pair<size_t, size_t>> edges;
+    for (auto const& kv : transf_)
+        edges.push_back(std::make_pair(index(std::get<0>(kv.second)), index(std::get<1>(kv.second))));
+
+    std::vector<bool> chosen(nspace, false);
+    if (nspace <= 16) {
+        // exhaustive, ties go to the smaller largest intermediate (less T buffer) then fewer first halves
+        size_t best = 0, best_cost = 0, best_peak = 0, best_count = 0;
+        for (size_t mask = 1; mask < (1ul << nspace); mask++) {
+            bool cover = true;
+            for (auto const& e : edges) cover = (cover && ((mask >> e.first) & 1 || (mask >> e.second) & 1));
+            if (!cover) continue;
+            size_t cost = 0, peak = 0, count = 0;
+            for (size_t i = 0; i < nspace; i++) {
+                if (!((mask >> i) & 1)) continue;
+                cost += cands[i].second;
+                peak = std::max(peak, cands[i].second);
+                count++;
+            }
+            if (!best || std::make_tuple(cost, peak, count) < std::make_tuple(best_cost, best_peak, best_count)) {
+                best = mask;
+                best_cost = cost;
+                best_peak = peak;
+                best_count = count;
+            }
+        }
+        for (size_t i = 0; i < nspace; i++) chosen[i] = (best >> i) & 1;
+    } else {
+        // greedy: most uncovered transformations per AO-row of first-half work
+        std::vector<bool> covered(edges.size(), false);
+        size_t left = edges.size();
+        while (left) {
+            size_t pick = 0;
+            double score = -1.0;
+            for (size_t i = 0; i < nspace; i++) {
+                if (chosen[i]) continue;
+                size_t hits = 0;
+                for (size_t e = 0; e < edges.size(); e++)
+                    hits += (!covered[e] && (edges[e].first == i || edges[e].second == i));
+                double s = (double)hits / (double)std::max(cands[i].second, (size_t)1);
+                if (hits && s > score) {
+                    score = s;
+                    pick = i;
                 }
-                small = (op == 1 ? std::get<1>(spaces_[std::get<0>(transf_[*itr])])
-                                 : std::get<1>(spaces_[std::get<1>(transf_[*itr])]));
-                large = (op == 1 ? std::get<1>(spaces_[std::get<1>(transf_[*itr])])
-                                 : std::get<1>(spaces_[std::get<0>(transf_[*itr])]));
-                maximum = (maximum < small * large ? small * large : maximum);
-                largest = (largest < small ? small : largest);
-                order_.push_back(*itr);
-                st++;
-                itr = needs.erase(itr);
-            } else
-                itr++;
+            }
+            chosen[pick] = true;
+            for (size_t e = 0; e < edges.size(); e++) {
+                if (!covered[e] && (edges[e].first == pick || edges[e].second == pick)) {
+                    covered[e] = true;
+                    left--;
+                }
+            }
+        }
+    }
+
+    // hand each transformation to the smallest chosen space it contains. Transformations sharing an
+    // intermediate are contiguous, so each Q block streams through the output files in a fixed order.
+    size_t largest = 0, maximum = 0;
+    for (size_t i = 0; i < nspace; i++) {
+        if (!chosen[i]) continue;
+        size_t st = 0, e = 0;
+        for (auto const& kv : transf_) {
+            size_t l = edges[e].first, r = edges[e].second;
+            e++;
+            size_t owner = ((chosen[l] && (l <= r || !chosen[r])) ? l : r);
+            if (owner != i) continue;
+            order_.push_back(kv.first);
+            maximum = std::max(maximum, cands[l].second * cands[r].second);
+            st++;
         }
         if (st > 0) {
+            bspace_.push_back(cands[i].first);
             strides_.push_back(st);
+            largest = std::max(largest, cands[i].second);
         }
     }
-    // print_order();
+
     ordered_ = true;
+    if (print_lvl_ > 1 || debug_) print_order();
     return std::make_pair(largest, maximum);
 }
 void DFHelper::print_order() {
     size_t o = order_.size();
     size_t b = bspace_.size();
-    outfile->Printf("\n     ==> DFHelper:--Begin Transformations Information <==\n\n");
-    outfile->Printf("   Transformation order:\n");
+    double nao = (double)nao_;
+    double naux = (double)naux_;
+
+    // first halves would be formed once per transformation without the plan
+    double first = 0.0, naive = 0.0, second = 0.0, written = 0.0;
+    for (size_t i = 0; i < b; i++) first += 2.0 * naux * nao * nao * (double)std::get<1>(spaces_[bspace_[i]]);
     for (size_t i = 0; i < o; i++) {
-        outfile->Printf("         %s: (%s, %s)\n", order_[i].c_str(), std::get<0>(transf_[order_[i]]).c_str(),
-                        std::get<1>(transf_[order_[i]]).c_str());
+        double l = (double)std::get<1>(spaces_[std::get<0>(transf_[order_[i]])]);
+        double r = (double)std::get<1>(spaces_[std::get<1>(transf_[order_[i]])]);
+        naive += 2.0 * naux * nao * nao * std::min(l, r);
+        second += 2.0 * naux * nao * l * r;
+        written += 8.0 * naux * l * r;
     }
-    outfile->Printf("\n    Best Spaces:\n");
-    for (size_t i = 0; i < b; i++) {
-        outfile->Printf("         (space: %s, size: %zu)\n", bspace_[i].c_str(), std::get<1>(spaces_[bspace_[i]]));
+    if (!direct_iaQ_) {
+        // pQq first contractions only touch the significant (mn) pairs
+        first *= 1.0 - ao_sparsity();
+        naive *= 1.0 - ao_sparsity();
     }
-    outfile->Printf("\n    Transformation strides: ");
-    for (size_t i = 0; i < b; i++) {
-        outfile->Printf("%zu", strides_[i]);
-        if (i < b - 1) outfile->Printf(", ");
+    double read = 0.0;
+    if (!AO_core_ && !direct_ && !direct_iaQ_ && !local_fitting_) read = 8.0 * (double)big_skips_[nao_];
+    if (MO_core_) written = 0.0;
+
+    outfile->Printf("\n     ==> DFHelper:--Begin Transformations Information <==\n\n");
+    outfile->Printf("   Transformation plan:\n");
+    for (size_t i = 0, count = 0; i < b; count += strides_[i], i++) {
+        outfile->Printf("         (Q|m %s), size: %zu\n", bspace_[i].c_str(), std::get<1>(spaces_[bspace_[i]]));
+        for (size_t k = 0; k < strides_[i]; k++) {
+            const std::string& name = order_[count + k];
+            outfile->Printf("           -> %s: (%s, %s)\n", name.c_str(), std::get<0>(transf_[name]).c_str(),
+                            std::get<1>(transf_[name]).c_str());
+        }
     }
-    outfile->Printf("\n\n     ==> DFHelper:--End Transformations Information <==\n\n");
+    outfile->Printf("\n    First halves:            %11zu (of %zu transformations)\n", b, o);
+    outfile->Printf("    1st contraction [GFLOP]: %11.3f (unshared: %.3f)\n", first / 1.0E9, naive / 1.0E9);
+    outfile->Printf("    2nd contraction [GFLOP]: %11.3f\n", second / 1.0E9);
+    outfile->Printf("    AO read [GiB]:           %11.3f\n", read / (1024.0 * 1024.0 * 1024.0));
+    outfile->Printf("    MO write [GiB]:          %11.3f\n", written / (1024.0 * 1024.0 * 1024.0));
+    outfile->Printf("\n     ==> DFHelper:--End Transformations Information <==\n\n");
 }
 
 
@@ -1596,7 +2081,7 @@ void DFHelper::transform() {
     size_t wfinal = std::get<1>(info_);
 
     // prep AO file stream if STORE + !AO_core_
-    if (!direct_iaQ_ && !direct_ && !AO_core_) stream_check(AO_files_[AO_names_[1]], "rb");
+    if (!direct_iaQ_ && !direct_ && !AO_core_ && !local_fitting_) stream_check(AO_files_[AO_names_[1]], "rb");
 
     // get Q blocking scheme
     std::vector<std::pair<size_t, size_t>> Qsteps;
@@ -1649,7 +2134,7 @@ void DFHelper::transform() {
             M = std::unique_ptr<double[]>(new double[std::get<0>(Qlargest)]);
             Mp = M.get();
         } else {
-            Mp = Ppq_.get();
+            Mp = Ppq_data();
         }
 
         // transform in steps, blocking over the auxiliary basis (Q blocks)
@@ -2200,7 +2685,7 @@ void DFHelper::fill_tensor(std::string name, SharedMatrix M, std::vector<size_t>
         size_t a2 = std::get<2>(sizes);
 
         double* Fp = transf_core_[name].get();
-#pragma omp parallel num_threads(nthreads_)
+#pragma omp parallel for num_threads(nthreads_)
         for (size_t i = 0; i < A0; i++) {
             for (size_t j = 0; j < A1; j++) {
 #pragma omp simd
@@ -2304,6 +2789,19 @@ SharedMatrix DFHelper::get_tensor(std::string name, std::vector<size_t> t0, std:
     return M;
 }
 
+std::pair<double*, std::tuple<size_t, size_t, size_t>> DFHelper::get_tensor_buffer(std::string name) {
+    check_file_key(name);
+    if (!MO_core_ || !transf_core_.count(name)) {
+        std::stringstream error;
+        error << "DFHelper:get_tensor_buffer: " << name << " is not held in core; use get_tensor or set_MO_core(True).";
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+    std::string filename = std::get<1>(files_[name]);
+    std::tuple<size_t, size_t, size_t> sizes;
+    sizes = (tsizes_.find(filename) != tsizes_.end() ? tsizes_[filename] : sizes_[filename]);
+    return std::make_pair(transf_core_[name].get(), sizes);
+}
+
 // Add a disk tensor
 void DFHelper::add_disk_tensor(std::string key, std::tuple<size_t, size_t, size_t> dimensions) {
     if (files_.count(key)) {
@@ -2768,7 +3266,11 @@ void DFHelper::build_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMatri
         outfile->Printf("Entering DFHelper::build_JK\n");
     }
 
-    if(do_J || do_K) {
+    if ((do_J || do_K) && Ppq_sp_) {
+        timer_on("DFH: compute_JK_sp()");
+        compute_JK_sp(Cleft, Cright, D, J, K, max_nocc, do_J, do_K, lr_symmetric);
+        timer_off("DFH: compute_JK_sp()");
+    } else if(do_J || do_K) {
         timer_on("DFH: compute_JK()");
         compute_JK(Cleft, Cright, D, J, K, max_nocc, do_J, do_K, do_wK, lr_symmetric);
         timer_off("DFH: compute_JK()");
@@ -2794,6 +3296,19 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     // size checks for C matrices occur in jk.cc
     // computing D occurs inside of jk.cc
 
+    // K on the device, where the AOs stay resident across builds
+    prepare_device(max_nocc);
+    if (device_ && do_K) {
+        timer_on("DFH: compute_K (device)");
+        for (size_t i = 0; i < K.size(); i++) {
+            device_->compute_K(Cleft[i]->pointer()[0], Cright[i]->pointer()[0], Cleft[i]->colspi()[0],
+                               lr_symmetric, K[i]->pointer()[0]);
+        }
+        timer_off("DFH: compute_K (device)");
+        do_K = false;
+        if (!do_J) return;
+    }
+
     size_t naux = naux_;
     size_t nao = nao_;
 
@@ -2810,7 +3325,7 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     size_t totsb = std::get<1>(info);
 
     // prep stream, blocking
-    if (!direct_ && !AO_core_) stream_check(AO_files_[AO_names_[1]], "rb");
+    if (!direct_ && !AO_core_ && !local_fitting_) stream_check(AO_files_[AO_names_[1]], "rb");
 
     int rank = 0;
     std::vector<std::vector<double>> C_buffers(nthreads_);
@@ -2849,11 +3364,37 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
     double* T2p = T2.get();
     double* Mp;
 
+    // when streaming from disk, two AO buffers are kept: block j is contracted
+    // out of one while block j + 1 is read into the other on the AIO thread
+    std::unique_ptr<double[]> M2;
+    std::shared_ptr<AIOHandler> aio;
+    std::exception_ptr aio_error;
+    size_t aio_job = 0;
+    double* Mnext = nullptr;
+
     if (!AO_core_) {
         M = std::unique_ptr<double[]>(new double[tots]);
         Mp = M.get();
+        if (Qsteps.size() > 1 && !local_fitting_) {
+            M2 = std::unique_ptr<double[]>(new double[tots]);
+            Mnext = M2.get();
+            aio = std::make_shared<AIOHandler>(_default_psio_lib_);
+        }
     } else
-        Mp = Ppq_.get();
+        Mp = Ppq_data();
+
+    // queues an asynchronous read of Qstep j into buf
+    auto prefetch = [&](size_t j, double* buf) {
+        size_t start = std::get<0>(Qsteps[j]);
+        size_t stop = std::get<1>(Qsteps[j]);
+        return aio->call([this, start, stop, buf, &aio_error]() {
+            try {
+                grab_AO(start, stop, buf);
+            } catch (...) {
+                aio_error = std::current_exception();
+            }
+        });
+    };
 
     // transform in steps (blocks of Q)
     for (size_t j = 0, bcount = 0; j < Qsteps.size(); j++) {
@@ -2871,7 +3412,20 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
         // get AO chunk according to directive
         timer_on("DFH: Grabbing AOs");
         if (!AO_core_) {
-            grab_AO(start, stop, Mp);
+            if (!aio) {
+                grab_AO(start, stop, Mp);
+            } else {
+                if (j == 0) {
+                    aio_job = prefetch(0, Mp);
+                }
+                aio->wait_for_job(aio_job);
+                if (aio_error) std::rethrow_exception(aio_error);
+
+                // start on the next block before contracting this one
+                if (j + 1 < Qsteps.size()) {
+                    aio_job = prefetch(j + 1, Mnext);
+                }
+            }
         }
         timer_off("DFH: Grabbing AOs");
 
@@ -2892,9 +3446,138 @@ void DFHelper::compute_JK(std::vector<SharedMatrix> Cleft, std::vector<SharedMat
         }
 
         bcount += block_size;
+
+        if (aio) std::swap(Mp, Mnext);
     }
+    if (aio) aio->synchronize();
     // outfile->Printf("\n     ==> DFHelper:--End J/K Builds (disk)<==\n\n");
 }
+void DFHelper::compute_JK_sp(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                              std::vector<SharedMatrix> D, std::vector<SharedMatrix> J,
+                              std::vector<SharedMatrix> K, size_t max_nocc,
+                              bool do_J, bool do_K, bool lr_symmetric) {
+    // Same contractions as compute_J(_symm)/compute_K on the in-core pQq AOs,
+    // but with float operands. Each Q block is added into the double J/K, so
+    // the single precision error does not accumulate over the blocks.
+    size_t nao = nao_;
+    size_t naux = naux_;
+    float* Mp = Ppq_sp_.get();
+
+    std::vector<std::pair<size_t, size_t>> Qsteps;
+    std::tuple<size_t, size_t> info = Qshell_blocks_for_JK_build(Qsteps, max_nocc, lr_symmetric);
+    size_t totsb = std::get<1>(info);
+    size_t nocc_max = std::max(max_nocc, (size_t)1);
+
+    // float buffers
+    std::vector<float> T1(std::max(totsb * nocc_max * nao, nthreads_ * naux));
+    std::vector<float> T2(lr_symmetric ? 0 : totsb * nocc_max * nao);
+    std::vector<float> F(nao * nao);
+    std::vector<std::vector<float>> B(nthreads_, std::vector<float>(nao * nocc_max));
+    float* T1p = T1.data();
+    float* Fp = F.data();
+
+    for (size_t j = 0, bcount = 0; j < Qsteps.size(); j++) {
+        size_t begin = Qshell_aggs_[std::get<0>(Qsteps[j])];
+        size_t end = Qshell_aggs_[std::get<1>(Qsteps[j]) + 1] - 1;
+        size_t block_size = end - begin + 1;
+
+        if (do_J) {
+            timer_on("DFH: compute_J_sp");
+            for (size_t i = 0; i < J.size(); i++) {
+                double* Dp = D[i]->pointer()[0];
+                double* Jp = J[i]->pointer()[0];
+
+                // (Q|mn) D_mn -> (Q), one partial vector per thread
+                std::fill(T1p, T1p + nthreads_ * naux, 0.0f);
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+                for (size_t k = 0; k < nao; k++) {
+                    int rank = 0;
+#ifdef _OPENMP
+                    rank = omp_get_thread_num();
+#endif
+                    size_t si = small_skips_[k];
+                    size_t mi = (lr_symmetric ? symm_small_skips_[k] : si);
+                    size_t skip = (lr_symmetric ? symm_ignored_columns_[k] : 0);
+                    size_t jump = big_skips_[k] + bcount * si;
+                    float* Bp = B[rank].data();
+                    for (size_t m = (lr_symmetric ? k : 0), sp_count = 0; m < nao; m++) {
+                        if (schwarz_fun_mask_[k * nao + m]) {
+                            Bp[sp_count++] = (float)((lr_symmetric && m != k ? 2.0 : 1.0) * Dp[nao * k + m]);
+                        }
+                    }
+                    C_SGEMV('N', block_size, mi, 1.0f, &Mp[jump + skip], si, Bp, 1, 1.0f, &T1p[rank * naux], 1);
+                }
+                for (size_t k = 1; k < nthreads_; k++) {
+                    for (size_t l = 0; l < block_size; l++) T1p[l] += T1p[k * naux + l];
+                }
+
+                // (Q|mn) (Q) -> J_mn
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+                for (size_t k = 0; k < nao; k++) {
+                    size_t si = small_skips_[k];
+                    size_t mi = (lr_symmetric ? symm_small_skips_[k] : si);
+                    size_t skip = (lr_symmetric ? symm_ignored_columns_[k] : 0);
+                    size_t jump = big_skips_[k] + bcount * si;
+                    C_SGEMV('T', block_size, mi, 1.0f, &Mp[jump + skip], si, T1p, 1, 0.0f, &Fp[k * nao], 1);
+                }
+
+                // unpack from sparse to dense, promoting to double
+                for (size_t k = 0; k < nao; k++) {
+                    for (size_t m = (lr_symmetric ? k : 0), count = 0; m < nao; m++) {
+                        if (schwarz_fun_mask_[k * nao + m]) {
+                            double val = Fp[k * nao + count++];
+                            Jp[k * nao + m] += val;
+                            if (lr_symmetric && m != k) Jp[m * nao + k] += val;
+                        }
+                    }
+                }
+            }
+            timer_off("DFH: compute_J_sp");
+        }
+
+        if (do_K) {
+            timer_on("DFH: compute_K_sp");
+            for (size_t i = 0; i < K.size(); i++) {
+                size_t nocc = Cleft[i]->colspi()[0];
+                if (!nocc) continue;
+                double* Kp = K[i]->pointer()[0];
+
+                // (Q|mn) C_nb -> (mQb) for the left and right coefficients
+                for (size_t side = 0; side < (lr_symmetric ? 1 : 2); side++) {
+                    double* Cp = (side ? Cright[i] : Cleft[i])->pointer()[0];
+                    float* Tp = (side ? T2.data() : T1p);
+#pragma omp parallel for schedule(guided) num_threads(nthreads_)
+                    for (size_t k = 0; k < nao; k++) {
+                        int rank = 0;
+#ifdef _OPENMP
+                        rank = omp_get_thread_num();
+#endif
+                        size_t sp_size = small_skips_[k];
+                        size_t jump = big_skips_[k] + bcount * sp_size;
+                        float* Bp = B[rank].data();
+                        for (size_t m = 0, sp_count = 0; m < nao; m++) {
+                            if (schwarz_fun_mask_[k * nao + m]) {
+                                for (size_t b = 0; b < nocc; b++) Bp[sp_count * nocc + b] = (float)Cp[m * nocc + b];
+                                sp_count++;
+                            }
+                        }
+                        C_SGEMM('N', 'N', block_size, nocc, sp_size, 1.0f, &Mp[jump], sp_size, Bp, nocc, 0.0f,
+                                &Tp[k * block_size * nocc], nocc);
+                    }
+                }
+
+                // (mQb)(nQb) -> K_mn
+                float* T2p = (lr_symmetric ? T1p : T2.data());
+                C_SGEMM('N', 'T', nao, nao, nocc * block_size, 1.0f, T1p, nocc * block_size, T2p, nocc * block_size,
+                        0.0f, Fp, nao);
+                for (size_t k = 0; k < nao * nao; k++) Kp[k] += Fp[k];
+            }
+            timer_off("DFH: compute_K_sp");
+        }
+
+        bcount += block_size;
+    }
+}
 void DFHelper::compute_J_symm(std::vector<SharedMatrix> D, std::vector<SharedMatrix> J, double* Mp, double* T1p,
                                double* T2p, std::vector<std::vector<double>>& D_buffers, size_t bcount,
                                size_t block_size) {
@@ -45,6 +45,8 @@ class Options;
 class Matrix;
 class ERISieve;
 class TwoBodyAOInt;
+class DFHelperDevice;
+class SharedSegment;
 
 class PSI_API DFHelper {
    public:
@@ -147,6 +149,50 @@ class PSI_API DFHelper {
     ///
     void set_print_lvl(int print_lvl) { print_lvl_ = print_lvl; }
 
+    ///
+    /// Keep the metric-contracted AOs of the STORE method in a cache file
+    /// in the scratch directory, keyed by the basis sets, geometry and fitting
+    /// parameters, and reuse them when a later job finds a matching file
+    /// @param cache (defaults to false)
+    ///
+    void set_AO_cache(bool cache) { AO_cache_ = cache; }
+    bool get_AO_cache() { return AO_cache_; }
+
+    ///
+    /// Keep the in-core AOs of the STORE method in single precision and run
+    /// the J/K contractions as float GEMMs, accumulating each Q block into the
+    /// double precision J/K. promote_precision() switches back to double.
+    /// @param mixed (defaults to false)
+    ///
+    void set_mixed_precision(bool mixed) { mixed_precision_ = mixed; }
+    bool get_mixed_precision() { return mixed_precision_; }
+
+    /// Are the J/K builds currently running from single precision AOs?
+    bool single_precision() { return (bool)Ppq_sp_; }
+
+    /// Rebuild the AOs in double precision for the remaining J/K builds
+    void promote_precision();
+
+    ///
+    /// Keep the in-core AOs of the STORE method resident on a CUDA device and
+    /// run the K contractions there. Without a device (or ENABLE_CUDA), or
+    /// when the AOs do not fit in device memory, the host path is used.
+    /// @param device (defaults to false)
+    ///
+    void set_device(bool device) { device_offload_ = device; }
+    bool get_device() { return device_offload_; }
+
+    ///
+    /// Fit each AO pair (mn) of the STORE method only against the auxiliary
+    /// functions on the atoms of m and n (pair-atomic RI) and keep just those
+    /// coefficients in core. The metric-contracted Q blocks used by build_JK()
+    /// and transform() are expanded from them as needed, so storage grows
+    /// with the number of significant pairs rather than with naux * npairs.
+    /// @param local (defaults to false)
+    ///
+    void set_local_fitting(bool local) { local_fitting_ = local; }
+    bool get_local_fitting() { return local_fitting_; }
+
     /// Initialize the object
     void initialize();
 
@@ -214,6 +260,15 @@ class PSI_API DFHelper {
     SharedMatrix get_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2);
     SharedMatrix get_tensor(std::string name, std::vector<size_t> a1, std::vector<size_t> a2, std::vector<size_t> a3);
 
+    ///
+    /// return the in-core storage of a transformed tensor, without copying.
+    /// Only available with MO_core; the shape follows any transpose().
+    /// @param name name of transformation to be accessed
+    /// The buffer belongs to DFHelper and stays valid until the next
+    /// transform() or clear_all().
+    ///
+    std::pair<double*, std::tuple<size_t, size_t, size_t>> get_tensor_buffer(std::string name);
+
     ///
     /// Add a 3-index disk tensor (that is not a transformation)
     /// @param name name of tensor - used to be accessed later
@@ -284,6 +339,13 @@ class PSI_API DFHelper {
     bool direct_iaQ_;
     bool symm_compute_;
     bool AO_core_ = true;
+    bool AO_cache_ = false;
+    bool mixed_precision_ = false;
+    bool device_offload_ = false;
+    bool device_failed_ = false;
+    bool local_fitting_ = false;
+    std::unique_ptr<DFHelperDevice> device_;
+    void prepare_device(size_t max_nocc);
     bool MO_core_ = false;
     size_t nthreads_ = 1;
     double cutoff_ = 1e-12;
@@ -302,6 +364,12 @@ class PSI_API DFHelper {
     // => in-core machinery <=
     void AO_core();
     std::unique_ptr<double[]> Ppq_;
+    std::unique_ptr<float[]> Ppq_sp_;
+    /// In-core AOs mapped read-only from a shared-memory segment of the session, instead of Ppq_
+    std::shared_ptr<SharedSegment> Ppq_shared_;
+    double* Ppq_data();
+    /// Build the in-core AOs once per shared-memory session and map them; false if not shared
+    bool prepare_AO_shared();
     std::map<double, SharedMatrix> metrics_;
 
     // => AO building machinery <=
@@ -318,6 +386,18 @@ class PSI_API DFHelper {
     void contract_metric_AO_core_symm(double* Qpq, double* metp, size_t begin, size_t end);
     void grab_AO(const size_t start, const size_t stop, double* Mp);
 
+    // => pair-atomic local fitting <=
+    void prepare_AO_local();
+    void grab_AO_local(const size_t start, const size_t stop, double* Mp);
+    /// J^(mpower + 1), which turns the local coefficients into metric-contracted AOs
+    SharedMatrix local_metric_;
+    /// First auxiliary function on each atom (natom + 1 entries)
+    std::vector<size_t> aux_atom_starts_;
+    /// Per function m: (atom B, first sparse column, number of columns, offset into Cpq_local_)
+    /// for each run of significant n on the same atom; each block is [ncol][naux(A) + naux(B)]
+    std::vector<std::vector<std::tuple<size_t, size_t, size_t, size_t>>> local_blocks_;
+    std::unique_ptr<double[]> Cpq_local_;
+
     // first integral transforms
     void first_transform_pQq(size_t nao, size_t naux, size_t bsize, size_t bcount, size_t block_size,
         double* Mp, double* Tp, double* Bp, std::vector<std::vector<double>>& C_buffers);
@@ -398,6 +478,7 @@ class PSI_API DFHelper {
         FILE* fp_;
         std::string op_;
         bool open_ = false;
+        bool keep_ = false;
         std::string filename_;
 
     } Stream;
@@ -418,6 +499,12 @@ class PSI_API DFHelper {
     void put_tensor_AO(std::string file, double* Mp, size_t size, size_t start, std::string op);
     void get_tensor_AO(std::string file, double* Mp, size_t size, size_t start);
 
+    // => cross-job AO cache <=
+    std::string AO_cache_key();
+    std::string AO_cache_file(const std::string& key);
+    bool load_AO_cache(const std::string& key);
+    void store_AO_cache(const std::string& key);
+
     // => internal handlers for FILE IO <=
     std::map<std::string, std::tuple<std::string, std::string>> files_;
     std::map<std::string, std::tuple<size_t, size_t, size_t>> sizes_;
@@ -451,6 +538,10 @@ class PSI_API DFHelper {
     void compute_K(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright, std::vector<SharedMatrix> K,
                    double* Tp, double* Jtmp, double* Mp, size_t bcount, size_t block_size,
                    std::vector<std::vector<double>>& C_buffers, bool lr_symmetric);
+    void compute_JK_sp(std::vector<SharedMatrix> Cleft, std::vector<SharedMatrix> Cright,
+                       std::vector<SharedMatrix> D, std::vector<SharedMatrix> J,
+                       std::vector<SharedMatrix> K, size_t max_nocc,
+                       bool do_J, bool do_K, bool lr_symmetric);
     std::tuple<size_t, size_t> Qshell_blocks_for_JK_build(
         std::vector<std::pair<size_t, size_t>>& b, size_t max_nocc, bool lr_symmetric);
 
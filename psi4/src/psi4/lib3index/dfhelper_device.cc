@@ -0,0 +1,44 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "dfhelper_device.h"
+
+namespace psi {
+
+// CPU-only builds: there is never a device, DFHelper keeps the host path
+
+std::unique_ptr<DFHelperDevice> DFHelperDevice::build(const double* Ppq, size_t nao, size_t naux, size_t max_nocc,
+                                                      const std::vector<size_t>& small_skips,
+                                                      const std::vector<size_t>& columns) {
+    return nullptr;
+}
+DFHelperDevice::~DFHelperDevice() {}
+void DFHelperDevice::compute_K(double* Cleft, double* Cright, size_t nocc, bool lr_symmetric, double* K) {}
+void DFHelperDevice::release() {}
+
+}  // namespace psi
@@ -0,0 +1,199 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "dfhelper_device.h"
+
+#include "psi4/libpsi4util/exception.h"
+
+#include <cuda_runtime.h>
+#include <cublas_v2.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace psi {
+
+namespace {
+
+const int nstreams = 4;
+
+void check(cudaError_t err, const char* what) {
+    if (err != cudaSuccess) {
+        std::stringstream error;
+        error << "DFHelperDevice: " << what << " failed: " << cudaGetErrorString(err);
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+}
+void check(cublasStatus_t err, const char* what) {
+    if (err != CUBLAS_STATUS_SUCCESS) {
+        std::stringstream error;
+        error << "DFHelperDevice: " << what << " failed with cuBLAS status " << (int)err;
+        throw PSIEXCEPTION(error.str().c_str());
+    }
+}
+
+// Cpack[j * nocc + b] = C[columns[j] * nocc + b]
+__global__ void gather_rows(size_t nnz, size_t nocc, const int* columns, const double* C, double* Cpack) {
+    size_t size = nnz * nocc;
+    for (size_t i = blockIdx.x * (size_t)blockDim.x + threadIdx.x; i < size; i += (size_t)blockDim.x * gridDim.x) {
+        size_t j = i / nocc;
+        size_t b = i % nocc;
+        Cpack[i] = C[columns[j] * nocc + b];
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<DFHelperDevice> DFHelperDevice::build(const double* Ppq, size_t nao, size_t naux, size_t max_nocc,
+                                                      const std::vector<size_t>& small_skips,
+                                                      const std::vector<size_t>& columns) {
+    int ndevice = 0;
+    if (cudaGetDeviceCount(&ndevice) != cudaSuccess || ndevice == 0) return nullptr;
+
+    std::unique_ptr<DFHelperDevice> dev(new DFHelperDevice());
+    dev->nao_ = nao;
+    dev->naux_ = naux;
+    dev->nnz_ = columns.size();
+    dev->max_nocc_ = std::max(max_nocc, (size_t)1);
+    dev->small_skips_ = small_skips;
+    dev->offsets_.resize(nao + 1, 0);
+    for (size_t k = 0; k < nao; k++) dev->offsets_[k + 1] = dev->offsets_[k] + small_skips[k];
+
+    size_t nocc = dev->max_nocc_;
+    size_t nnz = dev->nnz_;
+
+    // everything but the T buffers is fixed; T gets what is left, in Q blocks
+    size_t free_mem, total_mem;
+    if (cudaMemGetInfo(&free_mem, &total_mem) != cudaSuccess) return nullptr;
+    size_t fixed = sizeof(double) * (nnz * naux + 2 * nao * nocc + 2 * nnz * nocc + nao * nao) + sizeof(int) * nnz;
+    size_t usable = (size_t)(0.9 * free_mem);
+    if (fixed >= usable) return nullptr;
+    dev->qblock_ = std::min(naux, (usable - fixed) / (2 * sizeof(double) * nao * nocc));
+    if (dev->qblock_ == 0) return nullptr;
+
+    // allocate, giving up (and falling back to the host) on any failure
+    size_t Tsize = nao * nocc * dev->qblock_;
+    bool ok = cudaMalloc((void**)&dev->Ppq_, sizeof(double) * nnz * naux) == cudaSuccess;
+    ok = ok && cudaMalloc((void**)&dev->columns_, sizeof(int) * nnz) == cudaSuccess;
+    for (int s = 0; s < 2; s++) {
+        ok = ok && cudaMalloc((void**)&dev->C_[s], sizeof(double) * nao * nocc) == cudaSuccess;
+        ok = ok && cudaMalloc((void**)&dev->Cpack_[s], sizeof(double) * nnz * nocc) == cudaSuccess;
+        ok = ok && cudaMalloc((void**)&dev->T_[s], sizeof(double) * Tsize) == cudaSuccess;
+    }
+    ok = ok && cudaMalloc((void**)&dev->K_, sizeof(double) * nao * nao) == cudaSuccess;
+
+    cublasHandle_t handle;
+    ok = ok && cublasCreate(&handle) == CUBLAS_STATUS_SUCCESS;
+    if (!ok) return nullptr;
+    dev->handle_ = (void*)handle;
+    for (int s = 0; s < nstreams; s++) {
+        cudaStream_t stream;
+        check(cudaStreamCreate(&stream), "cudaStreamCreate");
+        dev->streams_.push_back((void*)stream);
+    }
+
+    // upload the AOs once; they stay resident until DFHelper drops the device
+    std::vector<int> cols(columns.begin(), columns.end());
+    check(cudaMemcpy(dev->Ppq_, Ppq, sizeof(double) * nnz * naux, cudaMemcpyHostToDevice), "AO upload");
+    check(cudaMemcpy(dev->columns_, cols.data(), sizeof(int) * nnz, cudaMemcpyHostToDevice), "mask upload");
+
+    return dev;
+}
+
+DFHelperDevice::~DFHelperDevice() { release(); }
+
+void DFHelperDevice::release() {
+    for (void* stream : streams_) cudaStreamDestroy((cudaStream_t)stream);
+    streams_.clear();
+    if (handle_) cublasDestroy((cublasHandle_t)handle_);
+    handle_ = nullptr;
+    cudaFree(Ppq_);
+    cudaFree(columns_);
+    for (int s = 0; s < 2; s++) {
+        cudaFree(C_[s]);
+        cudaFree(Cpack_[s]);
+        cudaFree(T_[s]);
+    }
+    cudaFree(K_);
+}
+
+void DFHelperDevice::compute_K(double* Cleft, double* Cright, size_t nocc, bool lr_symmetric, double* K) {
+    if (!nocc) return;
+    if (nocc > max_nocc_) throw PSIEXCEPTION("DFHelperDevice: nocc exceeds the device buffers.");
+
+    cublasHandle_t handle = (cublasHandle_t)handle_;
+    size_t nao = nao_;
+    size_t sides = (lr_symmetric ? 1 : 2);
+    const double one = 1.0, zero = 0.0;
+
+    // upload and pack C by the significant functions of each p
+    for (size_t s = 0; s < sides; s++) {
+        check(cudaMemcpy(C_[s], (s ? Cright : Cleft), sizeof(double) * nao * nocc, cudaMemcpyHostToDevice),
+              "C upload");
+        size_t size = nnz_ * nocc;
+        int threads = 256;
+        int blocks = (int)std::min((size + threads - 1) / threads, (size_t)65535);
+        gather_rows<<<blocks, threads>>>(nnz_, nocc, columns_, C_[s], Cpack_[s]);
+        check(cudaGetLastError(), "gather_rows");
+    }
+    check(cudaDeviceSynchronize(), "gather_rows");
+
+    for (size_t q0 = 0; q0 < naux_; q0 += qblock_) {
+        size_t qb = std::min(qblock_, naux_ - q0);
+
+        // (Q|mp) C_pb -> T_m(Qb), one GEMM per m, round robin over the streams
+        for (size_t s = 0; s < sides; s++) {
+            for (size_t k = 0; k < nao; k++) {
+                size_t sp = small_skips_[k];
+                if (!sp) continue;
+                check(cublasSetStream(handle, (cudaStream_t)streams_[k % streams_.size()]), "cublasSetStream");
+                const double* M = Ppq_ + offsets_[k] * naux_ + q0 * sp;
+                const double* Cp = Cpack_[s] + offsets_[k] * nocc;
+                check(cublasDgemm(handle, CUBLAS_OP_N, CUBLAS_OP_N, nocc, qb, sp, &one, Cp, nocc, M, sp, &zero,
+                                  T_[s] + k * qb * nocc, nocc),
+                      "first transform");
+            }
+        }
+        check(cudaDeviceSynchronize(), "first transform");
+
+        // K_mn += T_m(Qb) T_n(Qb)
+        check(cublasSetStream(handle, 0), "cublasSetStream");
+        size_t L = qb * nocc;
+        double* T2 = T_[lr_symmetric ? 0 : 1];
+        check(cublasDgemm(handle, CUBLAS_OP_T, CUBLAS_OP_N, nao, nao, L, &one, T2, L, T_[0], L,
+                          (q0 ? &one : &zero), K_, nao),
+              "K contraction");
+    }
+
+    // bring K home and add
+    std::vector<double> Kbuf(nao * nao);
+    check(cudaMemcpy(Kbuf.data(), K_, sizeof(double) * nao * nao, cudaMemcpyDeviceToHost), "K download");
+    for (size_t i = 0; i < nao * nao; i++) K[i] += Kbuf[i];
+}
+
+}  // namespace psi
@@ -0,0 +1,99 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef three_index_dfhelper_device
+#define three_index_dfhelper_device
+
+#include <memory>
+#include <vector>
+
+namespace psi {
+
+/**
+ * Device-resident copy of the sparse, metric-contracted pQq AOs of DFHelper.
+ *
+ * The AOs are uploaded once and stay on the device across J/K builds; the
+ * per-p first-half transforms of the K build are spread over several device
+ * streams and the final (mQb)(nQb) contraction runs as a single GEMM, blocked
+ * over Q to fit the device memory that is left.
+ *
+ * build() returns nullptr when psi4 was built without ENABLE_CUDA, when no
+ * device is found, or when the AOs do not fit; DFHelper then stays on the host.
+ */
+class DFHelperDevice {
+   public:
+    /**
+     * @param Ppq sparse pQq AOs (DFHelper layout)
+     * @param nao number of basis functions
+     * @param naux number of auxiliary functions
+     * @param max_nocc largest number of occupied columns in the C matrices
+     * @param small_skips significant functions per p
+     * @param columns significant function indices, concatenated over p
+     */
+    static std::unique_ptr<DFHelperDevice> build(const double* Ppq, size_t nao, size_t naux, size_t max_nocc,
+                                                 const std::vector<size_t>& small_skips,
+                                                 const std::vector<size_t>& columns);
+    ~DFHelperDevice();
+
+    /// K += (Q|mp) Cl_pb (Q|nq) Cr_qb, with C row-major nao x nocc and nocc <= max_nocc()
+    void compute_K(double* Cleft, double* Cright, size_t nocc, bool lr_symmetric, double* K);
+
+    /// Largest nocc the device buffers were sized for
+    size_t max_nocc() const { return max_nocc_; }
+    /// Number of auxiliary functions per device Q block
+    size_t Q_block() const { return qblock_; }
+
+   private:
+    DFHelperDevice() = default;
+
+    size_t nao_ = 0;
+    size_t naux_ = 0;
+    size_t nnz_ = 0;
+    size_t max_nocc_ = 0;
+    size_t qblock_ = 0;
+    std::vector<size_t> small_skips_;
+    std::vector<size_t> offsets_;
+
+    // device buffers: AOs, column indices, C (left/right), packed C, T (left/right), K
+    double* Ppq_ = nullptr;
+    int* columns_ = nullptr;
+    double* C_[2] = {nullptr, nullptr};
+    double* Cpack_[2] = {nullptr, nullptr};
+    double* T_[2] = {nullptr, nullptr};
+    double* K_ = nullptr;
+
+    // opaque cuBLAS handle and streams, so this header stays CUDA free
+    void* handle_ = nullptr;
+    std::vector<void*> streams_;
+
+    void release();
+};
+
+}  // namespace psi
+
+#endif
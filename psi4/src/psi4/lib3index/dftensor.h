@@ -33,6 +33,7 @@
 #include "psi4/pragma.h"
 
 #include <string>
+#include <vector>
 
 namespace psi {
 
@@ -71,6 +72,19 @@ protected:
     /// Fully pivot the fitting metric
     void pivot();
 
+    /// Build the raw fitting metric, bypassing the cache
+    void build_fitting_metric();
+    /// Key identifying this metric's bases, geometry and kernel for the given algorithm and tolerance
+    std::vector<double> cache_key(const std::string& algorithm, double tol) const;
+    /// Load metric_, pivots and flags from the job-wide cache. Returns false on a miss
+    bool load_cached(const std::vector<double>& key);
+    /// Store metric_, pivots and flags in the job-wide cache
+    void store_cached(const std::vector<double>& key) const;
+    /// Copy metric_, pivots and flags from the shared-memory session. Returns false on a miss
+    bool load_shared(const std::vector<double>& key);
+    /// Publish metric_, pivots and flags to the shared-memory session, if there is one
+    void store_shared(const std::vector<double>& key) const;
+
 public:
 
     /// DF Fitting Metric
@@ -116,6 +130,9 @@ public:
     void form_full_eig_inverse(double tol = 1.0E-10);
     /// Build the full metric's Cholesky factor. RECOMMENDED: Numerical stability
     void form_cholesky_factor();
+
+    /// Drop all metrics and factorizations cached across FittingMetric objects
+    static void clear_cache();
 };
 
 class PSI_API DFTensor {
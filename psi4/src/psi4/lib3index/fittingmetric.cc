@@ -34,6 +34,9 @@
 #include <algorithm>
 #include <vector>
 #include <utility>
+#include <map>
+#include <list>
+#include <mutex>
 
 #include "psi4/psifiles.h"
 #include "psi4/libpsio/psio.h"
@@ -45,6 +48,10 @@
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/vector.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/pointgrp.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/shared_segment.h"
 
 //MKL Header
 #ifdef USING_LAPACK_MKL
@@ -61,6 +68,76 @@
 
 namespace psi {
 
+namespace {
+
+/// A finished metric or factorization, shared by every FittingMetric with the same key in this job
+struct CachedMetric {
+    SharedMatrix metric;
+    std::shared_ptr<IntVector> pivots;
+    std::shared_ptr<IntVector> rev_pivots;
+    std::string algorithm;
+    bool is_inverted;
+};
+
+std::mutex metric_cache_lock;
+std::map<std::vector<double>, CachedMetric> metric_cache;
+/// Keys in insertion order, oldest first, for eviction
+std::list<std::vector<double> > metric_cache_order;
+/// Doubles currently held by the cache
+size_t metric_cache_size = 0;
+
+/// Append everything that defines the basis functions of bs (and their positions) to key
+void append_basis(std::vector<double>& key, const std::shared_ptr<BasisSet>& bs) {
+    key.push_back(bs->nshell());
+    for (int P = 0; P < bs->nshell(); P++) {
+        const GaussianShell& shell = bs->shell(P);
+        const double* center = shell.center();
+        key.insert(key.end(), {center[0], center[1], center[2]});
+        key.insert(key.end(), {(double)shell.am(), (double)shell.is_pure(), (double)shell.nprimitive()});
+        for (int K = 0; K < shell.nprimitive(); K++) {
+            key.push_back(shell.exp(K));
+            key.push_back(shell.original_coef(K));
+        }
+    }
+}
+
+/// Sibling processes of a shared-memory session find a metric under this name
+std::string shared_key(const std::vector<double>& key) {
+    return "FittingMetric\n" + std::string((const char*)key.data(), key.size() * sizeof(double));
+}
+
+void append_string(std::vector<double>& blob, const std::string& str) {
+    blob.push_back(str.size());
+    blob.insert(blob.end(), str.begin(), str.end());
+}
+std::string read_string(const double*& p) {
+    size_t n = (size_t)*p++;
+    std::string str(n, ' ');
+    for (size_t i = 0; i < n; i++) str[i] = (char)*p++;
+    return str;
+}
+
+/// IntVectors travel as nirrep, dimensions and values; a null one as nirrep 0
+void append_ints(std::vector<double>& blob, const std::shared_ptr<IntVector>& vec) {
+    blob.push_back(vec ? vec->nirrep() : 0);
+    if (!vec) return;
+    for (int h = 0; h < vec->nirrep(); h++) blob.push_back(vec->dim(h));
+    for (int h = 0; h < vec->nirrep(); h++) blob.insert(blob.end(), vec->pointer(h), vec->pointer(h) + vec->dim(h));
+}
+std::shared_ptr<IntVector> read_ints(const double*& p) {
+    int nirrep = (int)*p++;
+    if (!nirrep) return nullptr;
+    std::vector<int> dim(nirrep);
+    for (int h = 0; h < nirrep; h++) dim[h] = (int)*p++;
+    auto vec = std::make_shared<IntVector>(nirrep, dim.data());
+    for (int h = 0; h < nirrep; h++) {
+        for (int i = 0; i < dim[h]; i++) vec->pointer(h)[i] = (int)*p++;
+    }
+    return vec;
+}
+
+}  // namespace
+
 FittingMetric::FittingMetric(std::shared_ptr<BasisSet> aux, bool force_C1) :
     aux_(aux), is_poisson_(false), is_inverted_(false), force_C1_(force_C1), omega_(0.0)
 {
@@ -78,7 +155,123 @@ FittingMetric::~FittingMetric()
 {
 }
 
+std::vector<double> FittingMetric::cache_key(const std::string& algorithm, double tol) const
+{
+    std::vector<double> key(algorithm.begin(), algorithm.end());
+    key.insert(key.end(), {tol, omega_, (double)is_poisson_, (double)force_C1_});
+    key.push_back(force_C1_ ? 0.0 : (double)aux_->molecule()->point_group()->bits());
+    append_basis(key, aux_);
+    if (is_poisson_) append_basis(key, pois_);
+    return key;
+}
+bool FittingMetric::load_cached(const std::vector<double>& key)
+{
+    std::lock_guard<std::mutex> lock(metric_cache_lock);
+    auto it = metric_cache.find(key);
+    if (it == metric_cache.end()) return load_shared(key);
+
+    // Hand out copies, callers are free to modify what they get
+    const CachedMetric& entry = it->second;
+    metric_ = entry.metric->clone();
+    pivots_ = (entry.pivots ? std::make_shared<IntVector>(*entry.pivots) : nullptr);
+    rev_pivots_ = (entry.rev_pivots ? std::make_shared<IntVector>(*entry.rev_pivots) : nullptr);
+    algorithm_ = entry.algorithm;
+    is_inverted_ = entry.is_inverted;
+    return true;
+}
+void FittingMetric::store_cached(const std::vector<double>& key) const
+{
+    store_shared(key);
+
+    // Keep the cache within a quarter of the job's memory, evicting the oldest entries first
+    size_t limit = Process::environment.get_memory() / (4L * sizeof(double));
+    size_t size = 0;
+    for (int h = 0; h < metric_->nirrep(); h++) size += (size_t)metric_->rowspi()[h] * metric_->colspi()[h];
+    if (size > limit) return;
+
+    std::lock_guard<std::mutex> lock(metric_cache_lock);
+    if (metric_cache.count(key)) return;
+    while (metric_cache_size + size > limit && !metric_cache_order.empty()) {
+        const CachedMetric& oldest = metric_cache[metric_cache_order.front()];
+        for (int h = 0; h < oldest.metric->nirrep(); h++)
+            metric_cache_size -= (size_t)oldest.metric->rowspi()[h] * oldest.metric->colspi()[h];
+        metric_cache.erase(metric_cache_order.front());
+        metric_cache_order.pop_front();
+    }
+
+    CachedMetric entry;
+    entry.metric = metric_->clone();
+    entry.pivots = (pivots_ ? std::make_shared<IntVector>(*pivots_) : nullptr);
+    entry.rev_pivots = (rev_pivots_ ? std::make_shared<IntVector>(*rev_pivots_) : nullptr);
+    entry.algorithm = algorithm_;
+    entry.is_inverted = is_inverted_;
+    metric_cache[key] = entry;
+    metric_cache_order.push_back(key);
+    metric_cache_size += size;
+}
+bool FittingMetric::load_shared(const std::vector<double>& key)
+{
+    std::shared_ptr<SharedSegment> segment = SharedSegment::attach(shared_key(key));
+    if (!segment) return false;
+
+    // Matrix owns its storage, so the shared metric is copied out; its build is what is saved
+    const double* p = (const double*)segment->data();
+    is_inverted_ = (*p++ != 0.0);
+    algorithm_ = read_string(p);
+    std::string name = read_string(p);
+    int symmetry = (int)*p++;
+    int nirrep = (int)*p++;
+    std::vector<int> rowspi(nirrep), colspi(nirrep);
+    for (int h = 0; h < nirrep; h++) rowspi[h] = (int)*p++;
+    for (int h = 0; h < nirrep; h++) colspi[h] = (int)*p++;
+    metric_ = std::make_shared<Matrix>(name, nirrep, rowspi.data(), colspi.data(), symmetry);
+    for (int h = 0; h < nirrep; h++) {
+        size_t size = (size_t)rowspi[h] * colspi[h ^ symmetry];
+        if (size) std::copy(p, p + size, metric_->pointer(h)[0]);
+        p += size;
+    }
+    pivots_ = read_ints(p);
+    rev_pivots_ = read_ints(p);
+    return true;
+}
+void FittingMetric::store_shared(const std::vector<double>& key) const
+{
+    if (!SharedSegment::enabled()) return;
+
+    std::vector<double> blob;
+    blob.push_back(is_inverted_);
+    append_string(blob, algorithm_);
+    append_string(blob, metric_->name());
+    blob.push_back(metric_->symmetry());
+    blob.push_back(metric_->nirrep());
+    for (int h = 0; h < metric_->nirrep(); h++) blob.push_back(metric_->rowspi()[h]);
+    for (int h = 0; h < metric_->nirrep(); h++) blob.push_back(metric_->colspi()[h]);
+    for (int h = 0; h < metric_->nirrep(); h++) {
+        size_t size = (size_t)metric_->rowspi()[h] * metric_->colspi()[h ^ metric_->symmetry()];
+        if (size) blob.insert(blob.end(), metric_->pointer(h)[0], metric_->pointer(h)[0] + size);
+    }
+    append_ints(blob, pivots_);
+    append_ints(blob, rev_pivots_);
+
+    // A sibling may have published it first; either way the segment stays for later processes
+    SharedSegment::acquire(shared_key(key), blob.size() * sizeof(double),
+                           [&](void* data) { std::copy(blob.begin(), blob.end(), (double*)data); });
+}
+void FittingMetric::clear_cache()
+{
+    std::lock_guard<std::mutex> lock(metric_cache_lock);
+    metric_cache.clear();
+    metric_cache_order.clear();
+    metric_cache_size = 0;
+}
 void FittingMetric::form_fitting_metric()
+{
+    std::vector<double> key = cache_key("NONE", 0.0);
+    if (load_cached(key)) return;
+    build_fitting_metric();
+    store_cached(key);
+}
+void FittingMetric::build_fitting_metric()
 {
     is_inverted_ = false;
     algorithm_ = "NONE";
@@ -335,10 +528,13 @@ void FittingMetric::form_fitting_metric()
 }
 void FittingMetric::form_cholesky_inverse()
 {
+    std::vector<double> key = cache_key("CHOLESKY", 0.0);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "CHOLESKY";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     pivot();
     for (int h = 0; h < metric_->nirrep(); h++) {
@@ -353,13 +549,18 @@ void FittingMetric::form_cholesky_inverse()
                 J[A][B] = 0.0;
     }
     metric_->set_name("SO Basis Fitting Inverse (Cholesky)");
+
+    store_cached(key);
 }
 void FittingMetric::form_QR_inverse(double tol)
 {
+    std::vector<double> key = cache_key("QR", tol);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "QR";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     pivot();
     for (int h = 0; h < metric_->nirrep(); h++) {
@@ -441,13 +642,18 @@ void FittingMetric::form_QR_inverse(double tol)
         delete[] tau;
     }
     metric_->set_name("SO Basis Fitting Inverse (QR)");
+
+    store_cached(key);
 }
 void FittingMetric::form_eig_inverse(double tol)
 {
+    std::vector<double> key = cache_key("EIG", tol);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "EIG";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     //metric_->print();
 
@@ -496,13 +702,18 @@ void FittingMetric::form_eig_inverse(double tol)
 
     }
     metric_->set_name("SO Basis Fitting Inverse (Eig)");
+
+    store_cached(key);
 }
 void FittingMetric::form_full_eig_inverse(double tol)
 {
+    std::vector<double> key = cache_key("FULL_EIG", tol);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "EIG";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     //metric_->print();
 
@@ -551,13 +762,18 @@ void FittingMetric::form_full_eig_inverse(double tol)
 
     }
     metric_->set_name("SO Basis Fitting Inverse (Eig)");
+
+    store_cached(key);
 }
 void FittingMetric::form_full_inverse()
 {
+    std::vector<double> key = cache_key("FULL", 0.0);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "FULL";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     pivot();
     for (int h = 0; h < metric_->nirrep(); h++) {
@@ -575,13 +791,18 @@ void FittingMetric::form_full_inverse()
                 J[A][B] = J[B][A];
     }
     metric_->set_name("SO Basis Fitting Inverse (Full)");
+
+    store_cached(key);
 }
 void FittingMetric::form_cholesky_factor()
 {
+    std::vector<double> key = cache_key("CHOLESKY_FACTOR", 0.0);
+    if (load_cached(key)) return;
+
     is_inverted_ = true;
     algorithm_ = "CHOLESKY";
 
-    form_fitting_metric();
+    build_fitting_metric();
 
     //pivot();
     for (int h = 0; h < metric_->nirrep(); h++) {
@@ -593,6 +814,8 @@ void FittingMetric::form_cholesky_factor()
         int info = C_DPOTRF('L', metric_->colspi()[h], J[0], metric_->colspi()[h]);
     }
     metric_->set_name("SO Basis Cholesky Factor (Full)");
+
+    store_cached(key);
 }
 void FittingMetric::pivot()
 {
@@ -39,15 +39,22 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/fittedesp.h"
 #include "psi4/libfilesystem/path.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/liboptions/liboptions.h"
 
 #include "csg.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
 #ifdef _OPENMP
 #include <omp.h>
-#include "psi4/libpsi4util/process.h"
 #endif
 
 namespace psi {
@@ -231,38 +238,28 @@ void CubicScalarGrid::write_gen_file(double* v, const std::string& name, const s
                                      const std::string& comment) {
     if (type == "CUBE") {
         write_cube_file(v, name, comment);
+    } else if (type == "BCUBE") {
+        write_bcube_file(v, name, comment);
     } else {
         throw PSIEXCEPTION("CubicScalarGrid: Unrecognized output file type");
     }
 }
-void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
-    // => Reorder the grid <= //
-
-    double* v2 = new double[npoints_];
-    size_t offset = 0L;
-    for (int istart = 0L; istart <= N_[0]; istart += nxyz_) {
-        int ni = (istart + nxyz_ > N_[0] ? (N_[0] + 1) - istart : nxyz_);
-        for (int jstart = 0L; jstart <= N_[1]; jstart += nxyz_) {
-            int nj = (jstart + nxyz_ > N_[1] ? (N_[1] + 1) - jstart : nxyz_);
-            for (int kstart = 0L; kstart <= N_[2]; kstart += nxyz_) {
-                int nk = (kstart + nxyz_ > N_[2] ? (N_[2] + 1) - kstart : nxyz_);
-                for (int i = istart; i < istart + ni; i++) {
-                    for (int j = jstart; j < jstart + nj; j++) {
-                        for (int k = kstart; k < kstart + nk; k++) {
-                            size_t index = i * (N_[1] + 1L) * (N_[2] + 1L) + j * (N_[2] + 1L) + k;
-                            v2[index] = v[offset];
-                            offset++;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    // => Drop the grid out <= //
-
+size_t CubicScalarGrid::fast_index(int i, int j, int k) const {
+    // Blocks are laid out x-slab, then y-slab, then z, each nxyz_ wide except at the far edges
+    size_t ny = N_[1] + 1L;
+    size_t nz = N_[2] + 1L;
+    size_t istart = (i / nxyz_) * nxyz_;
+    size_t jstart = (j / nxyz_) * nxyz_;
+    size_t kstart = (k / nxyz_) * nxyz_;
+    size_t ni = std::min<size_t>(nxyz_, N_[0] + 1L - istart);
+    size_t nj = std::min<size_t>(nxyz_, ny - jstart);
+    size_t nk = std::min<size_t>(nxyz_, nz - kstart);
+    return istart * ny * nz + ni * jstart * nz + ni * nj * kstart + ((i - istart) * nj + (j - jstart)) * nk +
+           (k - kstart);
+}
+FILE* CubicScalarGrid::open_grid_file(const std::string& name, const std::string& ext, const char* mode) {
     std::stringstream ss;
-    ss << filepath_ << "/" << name << ".cube";
+    ss << filepath_ << "/" << name << "." << ext;
 
     // Is filepath a valid directory?
     if (filesystem::path(filepath_).make_absolute().is_directory() == false) {
@@ -271,7 +268,12 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const
         exit(Failure);
     }
 
-    FILE* fh = fopen(ss.str().c_str(), "w");
+    FILE* fh = fopen(ss.str().c_str(), mode);
+    if (!fh) throw PSIEXCEPTION("CubicScalarGrid: Unable to open " + ss.str());
+    return fh;
+}
+void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const std::string& comment) {
+    FILE* fh = open_grid_file(name, "cube", "w");
     // Two comment lines
     fprintf(fh, "Psi4 Gaussian Cube File.\n");
     fprintf(fh, "Property: %s%s\n", name.c_str(), comment.c_str());
@@ -290,10 +292,69 @@ void CubicScalarGrid::write_cube_file(double* v, const std::string& name, const
                 mol_->z(A));
     }
 
-    // Data, striped (x, y, z)
-    for (size_t ind = 0; ind < npoints_; ind++) {
-        fprintf(fh, "%12.5E ", v2[ind]);
-        if (ind % 6 == 5) fprintf(fh, "\n");
+    // Data, striped (x, y, z), gathered straight out of the blocked ordering.  The x planes
+    // are formatted concurrently, a batch at a time, and each batch is written in one go.
+    const int planes_per_batch = 64;
+    size_t plane_size = (size_t)(N_[1] + 1) * (N_[2] + 1);
+    std::vector<std::string> planes(planes_per_batch);
+    for (int i0 = 0; i0 <= N_[0]; i0 += planes_per_batch) {
+        int nplane = std::min(planes_per_batch, N_[0] + 1 - i0);
+#pragma omp parallel for schedule(dynamic)
+        for (int p = 0; p < nplane; p++) {
+            int i = i0 + p;
+            std::string& text = planes[p];
+            text.clear();
+            text.reserve(plane_size * 14);
+            char field[32];
+            size_t ind = i * plane_size;
+            for (int j = 0; j <= N_[1]; j++) {
+                for (int k = 0; k <= N_[2]; k++, ind++) {
+                    text.append(field, std::snprintf(field, sizeof(field), "%12.5E ", v[fast_index(i, j, k)]));
+                    if (ind % 6 == 5) text.push_back('\n');
+                }
+            }
+        }
+        for (int p = 0; p < nplane; p++) fwrite(planes[p].data(), 1, planes[p].size(), fh);
+    }
+
+    fclose(fh);
+}
+void CubicScalarGrid::write_bcube_file(double* v, const std::string& name, const std::string& comment) {
+    FILE* fh = open_grid_file(name, "bcube", "wb");
+
+    // Header: magic, version, then the same geometry a cube file carries, in native byte order
+    const char magic[8] = {'P', 'S', 'I', '4', 'C', 'U', 'B', 'E'};
+    int32_t version = 1;
+    int32_t natom = mol_->natom();
+    int32_t npts[3] = {N_[0] + 1, N_[1] + 1, N_[2] + 1};
+    std::string title = name + comment;
+    int32_t ntitle = title.size();
+    fwrite(magic, 1, 8, fh);
+    fwrite(&version, sizeof(int32_t), 1, fh);
+    fwrite(&ntitle, sizeof(int32_t), 1, fh);
+    fwrite(title.c_str(), 1, ntitle, fh);
+    fwrite(&natom, sizeof(int32_t), 1, fh);
+    fwrite(npts, sizeof(int32_t), 3, fh);
+    fwrite(O_, sizeof(double), 3, fh);
+    fwrite(D_, sizeof(double), 3, fh);
+    for (int A = 0; A < natom; A++) {
+        int32_t Z = mol_->true_atomic_number(A);
+        double xyz[3] = {mol_->x(A), mol_->y(A), mol_->z(A)};
+        fwrite(&Z, sizeof(int32_t), 1, fh);
+        fwrite(xyz, sizeof(double), 3, fh);
+    }
+
+    // Data as float32 in cube (x, y, z) order, one x-slab at a time
+    size_t nslab = (size_t)npts[1] * npts[2];
+    std::vector<float> slab(nslab);
+    for (int i = 0; i <= N_[0]; i++) {
+        size_t ind = 0L;
+        for (int j = 0; j <= N_[1]; j++) {
+            for (int k = 0; k <= N_[2]; k++) {
+                slab[ind++] = static_cast<float>(v[fast_index(i, j, k)]);
+            }
+        }
+        fwrite(slab.data(), sizeof(float), nslab, fh);
     }
 
     fclose(fh);
@@ -321,159 +382,27 @@ void CubicScalarGrid::add_esp(double* v, std::shared_ptr<Matrix> D, const std::v
     double cutoff = options_.get_double("INTS_TOLERANCE");
     double condition = options_.get_double("DF_FITTING_CONDITION");
 
-    // => Sizing <= //
-
-    int nbf = primary_->nbf();
-    int naux = auxiliary_->nbf();
-    int maxP = auxiliary_->max_function_per_shell();
-
-    int nthreads = 1;
-#ifdef _OPENMP
-    nthreads = Process::environment.get_n_threads();
-#endif
-
-    // => Density Fitting (TODO: Could be sped up) <= //
-
-    std::shared_ptr<IntegralFactory> Ifact =
-        std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
-    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
-    for (int thread = 0; thread < nthreads; thread++) {
-        ints.push_back(std::shared_ptr<TwoBodyAOInt>(Ifact->eri()));
-    }
-
-    auto sieve = std::make_shared<ERISieve>(primary_, cutoff);
-    const std::vector<std::pair<int, int>>& pairs = sieve->shell_pairs();
-
-    auto c = std::make_shared<Vector>("c", naux);
-    double* cp = c->pointer();
-
-    auto Amn = std::make_shared<Matrix>("Amn", maxP, nbf * nbf);
-    double** Amnp = Amn->pointer();
+    // => Density Fitting <= //
 
-    double** Dp = D->pointer();
-
-    for (int P = 0; P < auxiliary_->nshell(); P++) {
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-
-        Amn->zero();
-
-// Integrals
-#pragma omp parallel for schedule(dynamic)
-        for (int task = 0; task < pairs.size(); task++) {
-            int thread = 0;
-#ifdef _OPENMP
-            thread = omp_get_thread_num();
-#endif
-
-            int M = pairs[task].first;
-            int N = pairs[task].second;
-
-            ints[thread]->compute_shell(P, 0, M, N);
-            const double* buffer = ints[thread]->buffer();
-
-            int nM = primary_->shell(M).nfunction();
-            int oM = primary_->shell(M).function_index();
-            int nN = primary_->shell(N).nfunction();
-            int oN = primary_->shell(N).function_index();
-
-            int index = 0;
-            for (int p = 0; p < nP; p++) {
-                for (int m = 0; m < nM; m++) {
-                    for (int n = 0; n < nN; n++) {
-                        Amnp[p][(m + oM) * nbf + (n + oN)] = Amnp[p][(n + oN) * nbf + (m + oM)] = buffer[index++];
-                    }
-                }
-            }
-        }
-
-        // Contraction
-        C_DGEMV('N', nP, nbf * nbf, 1.0, Amnp[0], nbf * nbf, Dp[0], 1, 0.0, cp + oP, 1);
-    }
-
-    Amn.reset();
-    Ifact.reset();
-    ints.clear();
-
-    auto J = std::make_shared<Matrix>("J", naux, naux);
-    double** Jp = J->pointer();
-
-    std::shared_ptr<IntegralFactory> Jfact = std::make_shared<IntegralFactory>(
-        auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_, BasisSet::zero_ao_basis_set());
-
-    std::shared_ptr<TwoBodyAOInt> Jints(Jfact->eri());
-    const double* Jbuffer = Jints->buffer();
-
-    for (int P = 0; P < auxiliary_->nshell(); P++) {
-        int nP = auxiliary_->shell(P).nfunction();
-        int oP = auxiliary_->shell(P).function_index();
-
-        for (int Q = 0; Q <= P; Q++) {
-            int nQ = auxiliary_->shell(Q).nfunction();
-            int oQ = auxiliary_->shell(Q).function_index();
-
-            Jints->compute_shell(P, 0, Q, 0);
-
-            int index = 0;
-            for (int p = 0; p < nP; p++) {
-                for (int q = 0; q < nQ; q++) {
-                    Jp[p + oP][q + oQ] = Jp[q + oQ][p + oP] = Jbuffer[index++];
-                }
-            }
-        }
-    }
-
-    Jfact.reset();
-    Jints.reset();
-
-    J->power(-1.0, condition);
-
-    auto d = std::make_shared<Vector>("d", naux);
-    double* dp = d->pointer();
-
-    C_DGEMV('N', naux, naux, 1.0, Jp[0], naux, cp, 1, 0.0, dp, 1);
-
-    // c->print();
-    // d->print();
-
-    J.reset();
+    FittedESP esp(primary_, auxiliary_, options_.get_double("CUBIC_ESP_TOLERANCE"));
+    esp.fit(D, cutoff, condition);
 
     // => Electronic Part <= //
 
-    std::shared_ptr<IntegralFactory> Vfact = std::make_shared<IntegralFactory>(
-        auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_, BasisSet::zero_ao_basis_set());
-    std::vector<std::shared_ptr<Matrix>> ZxyzT;
-    std::vector<std::shared_ptr<Matrix>> VtempT;
-    std::vector<std::shared_ptr<PotentialInt>> VintT;
-    for (int thread = 0; thread < nthreads; thread++) {
-        ZxyzT.push_back(std::make_shared<Matrix>("Zxyz", 1, 4));
-        VtempT.push_back(std::make_shared<Matrix>("Vtemp", naux, 1));
-        VintT.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(Vfact->ao_potential())));
-        VintT[thread]->set_charge_field(ZxyzT[thread]);
-    }
-
+    // Far atoms enter as multipoles, so the cost per block is set by how many atoms are close
 #pragma omp parallel for schedule(dynamic)
-    for (int P = 0; P < npoints_; P++) {
-        // Thread info
+    for (size_t ind = 0; ind < blocks_.size(); ind++) {
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
+        std::shared_ptr<BlockOPoints> block = blocks_[ind];
+        size_t offset = block->x() - x_;
+        esp.compute(block->npoints(), block->x(), block->y(), block->z(), v + offset, thread);
+    }
 
-        // Pointers
-        double** ZxyzTp = ZxyzT[thread]->pointer();
-        double** VtempTp = VtempT[thread]->pointer();
-
-        // Integrals
-        VtempT[thread]->zero();
-        ZxyzTp[0][0] = 1.0;
-        ZxyzTp[0][1] = x_[P];
-        ZxyzTp[0][2] = y_[P];
-        ZxyzTp[0][3] = z_[P];
-        VintT[thread]->compute(VtempT[thread]);
-
-        // Contraction
-        v[P] += C_DDOT(naux, dp, 1, VtempTp[0], 1);  // Potential integrals are negative definite already
+    if (options_.get_int("PRINT") > 1) {
+        outfile->Printf("  ESP: %zu atom-point pairs integrated, %zu by multipoles.\n\n", esp.nnear(), esp.nfar());
     }
 
     // => Nuclear Part <= //
@@ -633,20 +562,34 @@ void CubicScalarGrid::compute_orbitals(std::shared_ptr<Matrix> C, const std::vec
     for (int k = 0; k < indices.size(); k++) {
         C_DCOPY(primary_->nbf(), &Cp[0][indices[k]], C->colspi()[0], &C2p[0][k], C2->colspi()[0]);
     }
-    double** v = block_matrix(indices.size(), npoints_);
-    memset(v[0], '\0', indices.size() * npoints_ * sizeof(double));
-    add_orbitals(v, C2);
-    for (int k = 0; k < indices.size(); k++) {
-        // Get adaptive isocountour range
-        std::pair<double, double> isocontour_range = compute_isocontour_range(v[k], 2.0);
-        double density_percent = 100.0 * options_.get_double("CUBEPROP_ISOCONTOUR_THRESHOLD");
-        std::stringstream comment;
-        comment << ". Isocontour range for " << density_percent << "% of the density: (" << isocontour_range.first
-                << "," << isocontour_range.second << ")";
-        // Write to disk
-        std::stringstream ss;
-        ss << name << "_" << (indices[k] + 1) << "_" << labels[k];
-        write_gen_file(v[k], ss.str(), type, comment.str());
+
+    // Hold only as many orbital fields as half the memory allows; each batch is one collocation sweep
+    size_t nmo = indices.size();
+    size_t nbatch = Process::environment.get_memory() / (2L * sizeof(double) * npoints_);
+    nbatch = std::max<size_t>(1L, std::min(nbatch, nmo));
+
+    double** v = block_matrix(nbatch, npoints_);
+    for (size_t kstart = 0; kstart < nmo; kstart += nbatch) {
+        size_t nk = std::min(nbatch, nmo - kstart);
+        auto C3 = std::make_shared<Matrix>(primary_->nbf(), nk);
+        double** C3p = C3->pointer();
+        for (size_t k = 0; k < nk; k++) {
+            C_DCOPY(primary_->nbf(), &C2p[0][kstart + k], C2->colspi()[0], &C3p[0][k], nk);
+        }
+        memset(v[0], '\0', nk * npoints_ * sizeof(double));
+        add_orbitals(v, C3);
+        for (size_t k = 0; k < nk; k++) {
+            // Get adaptive isocountour range
+            std::pair<double, double> isocontour_range = compute_isocontour_range(v[k], 2.0);
+            double density_percent = 100.0 * options_.get_double("CUBEPROP_ISOCONTOUR_THRESHOLD");
+            std::stringstream comment;
+            comment << ". Isocontour range for " << density_percent << "% of the density: (" << isocontour_range.first
+                    << "," << isocontour_range.second << ")";
+            // Write to disk
+            std::stringstream ss;
+            ss << name << "_" << (indices[kstart + k] + 1) << "_" << labels[kstart + k];
+            write_gen_file(v[k], ss.str(), type, comment.str());
+        }
     }
     free_block(v);
 }
@@ -29,6 +29,7 @@
 #ifndef _psi_src_lib_libcubeprop_csg_h_
 #define _psi_src_lib_libcubeprop_csg_h_
 
+#include <cstdio>
 #include <map>
 #include <set>
 
@@ -92,6 +93,10 @@ class CubicScalarGrid {
 
     /// Setup grid from info in N_, D_, O_
     void populate_grid();
+    /// Position in the blocked (fast) ordering of voxel (i, j, k)
+    size_t fast_index(int i, int j, int k) const;
+    /// Open filepath/name.ext, dying if filepath is not a directory
+    FILE* open_grid_file(const std::string& name, const std::string& ext, const char* mode);
 
    public:
     // => Constructors <= //
@@ -151,6 +156,13 @@ class CubicScalarGrid {
     void write_gen_file(double* v, const std::string& name, const std::string& type, const std::string& comment = "");
     /// Write a Gaussian cube file of the scalar field v (in fast ordering) to filepath/name.cube
     void write_cube_file(double* v, const std::string& name, const std::string& comment = "");
+    /**
+     * Write a binary cube of the scalar field v (in fast ordering) to filepath/name.bcube, in native
+     * byte order: char[8] "PSI4CUBE", int32 version (1), int32 title length and title, int32 natom,
+     * int32 points along x, y, z, double origin[3], double spacing[3], natom x (int32 Z, double xyz[3]),
+     * then float32 values in cube (x, y, z) order. Bohr throughout, as in the text cube.
+     */
+    void write_bcube_file(double* v, const std::string& name, const std::string& comment = "");
 
     // => Low-Level Scalar Field Computation (Use only if you know what you are doing) <= //
 
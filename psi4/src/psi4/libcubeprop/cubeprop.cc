@@ -95,6 +95,7 @@ void CubeProperties::common_init() {
     grid_ = std::make_shared<CubicScalarGrid>(basisset_, options_);
     grid_->set_filepath(options_.get_str("CUBEPROP_FILEPATH"));
     grid_->set_auxiliary_basis(auxiliary_);
+    file_type_ = options_.get_str("CUBEPROP_FILE_TYPE");
 }
 void CubeProperties::print_header() {
     outfile->Printf("  ==> One Electron Grid Properties (v2.0) <==\n\n");
@@ -235,23 +236,23 @@ void CubeProperties::raw_compute_properties() {
     }
 }
 void CubeProperties::compute_density(std::shared_ptr<Matrix> D, const std::string& key) {
-    grid_->compute_density(D, key);
+    grid_->compute_density(D, key, file_type_);
 }
 void CubeProperties::compute_esp(std::shared_ptr<Matrix> Dt, const std::vector<double>& w) {
-    grid_->compute_density(Dt, "Dt");
-    grid_->compute_esp(Dt, w, "ESP");
+    grid_->compute_density(Dt, "Dt", file_type_);
+    grid_->compute_esp(Dt, w, "ESP", file_type_);
 }
 void CubeProperties::compute_orbitals(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                                       const std::vector<std::string>& labels, const std::string& key) {
-    grid_->compute_orbitals(C, indices, labels, key);
+    grid_->compute_orbitals(C, indices, labels, key, file_type_);
 }
 void CubeProperties::compute_difference(std::shared_ptr<Matrix> C, const std::vector<int>& indices,
                                       const std::string& label, bool square) {
-    grid_->compute_difference(C, indices, label, square);
+    grid_->compute_difference(C, indices, label, square, file_type_);
 }
 void CubeProperties::compute_basis_functions(const std::vector<int>& indices, const std::string& key) {
-    grid_->compute_basis_functions(indices, key);
+    grid_->compute_basis_functions(indices, key, file_type_);
 }
-void CubeProperties::compute_LOL(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_LOL(D, key); }
-void CubeProperties::compute_ELF(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_ELF(D, key); }
+void CubeProperties::compute_LOL(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_LOL(D, key, file_type_); }
+void CubeProperties::compute_ELF(std::shared_ptr<Matrix> D, const std::string& key) { grid_->compute_ELF(D, key, file_type_); }
 }  // namespace psi
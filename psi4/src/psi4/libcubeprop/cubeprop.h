@@ -72,6 +72,8 @@ class PSI_API CubeProperties {
 
     /// Grid-based property computer
     std::shared_ptr<CubicScalarGrid> grid_;
+    /// Output format handed to grid_ (CUBE or BCUBE)
+    std::string file_type_;
 
     // => Helper Functions <= //
 
@@ -42,7 +42,9 @@ PRAGMA_WARNING_POP
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
 
 using namespace psi;
 
@@ -64,7 +66,8 @@ DIISManager::DIISManager(int maxSubspaceSize, const std::string &label, RemovalP
       _vectorSize(0),
       _psio(_default_psio_lib_),
       _entryCount(0),
-      _label(label) {}
+      _label(label),
+      _andersonMixing(0.0) {}
 
 int DIISManager::subspace_size() { return _subspace.size(); }
 
@@ -250,11 +253,9 @@ bool DIISManager::add_entry(int numQuantities, ...) {
             case DIISEntry::Matrix:
                 matrix = va_arg(args, Matrix *);
                 for (int h = 0; h < matrix->nirrep(); ++h) {
-                    for (int row = 0; row < matrix->rowspi()[h]; ++row) {
-                        for (int col = 0; col < matrix->colspi()[h]; ++col) {
-                            *arrayPtr++ = matrix->get(h, row, col);
-                        }
-                    }
+                    size_t size = (size_t)matrix->rowspi()[h] * matrix->colspi()[h];
+                    if (size) ::memcpy(arrayPtr, matrix->pointer(h)[0], size * sizeof(double));
+                    arrayPtr += size;
                 }
                 break;
             case DIISEntry::Vector:
@@ -272,23 +273,34 @@ bool DIISManager::add_entry(int numQuantities, ...) {
     va_end(args);
 
     int entryID = get_next_entry_id();
+    DIISEntry *entry = new DIISEntry(_label, entryID, _entryCount++, _errorVectorSize, errorVectorPtr, _vectorSize,
+                                     vectorPtr, _psio);
     if (_subspace.size() < _maxSubspaceSize) {
-        _subspace.push_back(new DIISEntry(_label, entryID, _entryCount++, _errorVectorSize, errorVectorPtr, _vectorSize,
-                                          vectorPtr, _psio));
+        _subspace.push_back(entry);
     } else {
         delete _subspace[entryID];
-        _subspace[entryID] = new DIISEntry(_label, entryID, _entryCount++, _errorVectorSize, errorVectorPtr,
-                                           _vectorSize, vectorPtr, _psio);
+        _subspace[entryID] = entry;
     }
 
-    if (_storagePolicy == OnDisk) {
-        _subspace[entryID]->dump_vector_to_disk();
-        _subspace[entryID]->dump_error_vector_to_disk();
+    // Fill in the new row of the B matrix while the new error vector is still in memory, so that
+    // extrapolate() never has to revisit old error vectors
+    std::vector<double> scratch;
+    for (int i = 0; i < _subspace.size(); ++i) {
+        if (i == entryID) continue;
+        double dot = C_DDOT(_errorVectorSize, errorVectorPtr, 1, const_cast<double *>(error_vector(i, scratch)), 1);
+        _subspace[i]->set_dot_with(entryID, dot);
+        entry->set_dot_with(i, dot);
+        if (_storagePolicy == OnDisk) _subspace[i]->free_error_vector_memory();
     }
 
-    // Make we don't know any inner products involving this new entry
-    for (int i = 0; i < _subspace.size(); ++i)
-        if (i != entryID) _subspace[i]->invalidate_dot(entryID);
+    if (_storagePolicy == OnDisk) {
+        entry->dump_vector_to_disk();
+        entry->dump_error_vector_to_disk();
+    } else {
+        store_in_core(entryID, errorVectorPtr, vectorPtr);
+        entry->free_vector_memory();
+        entry->free_error_vector_memory();
+    }
 
     timer_off("DIISManager::add_entry");
 
@@ -339,16 +351,125 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
 
     timer_on("DIISManager::extrapolate");
 
+    _coefficients = compute_coefficients();
+
+    timer_on("New vector");
+
+    int print = Process::environment.options.get_int("PRINT");
+    if (print > 2) {
+        outfile->Printf("DIIS coefficients: ");
+        for (double coefficient : _coefficients) outfile->Printf(" %.3f ", coefficient);
+        outfile->Printf("\n");
+    }
+
+    // Accumulate the new vector contiguously, then scatter it into the components once
+    std::vector<double> result(_vectorSize, 0.0);
+    std::vector<double> scratch;
+    for (int n = 0; n < _subspace.size(); ++n) {
+        C_DAXPY(_vectorSize, _coefficients[n], const_cast<double *>(stored_vector(n, scratch)), 1, result.data(),
+                1);
+        if (_storagePolicy == OnDisk) _subspace[n]->free_vector_memory();
+    }
+    if (_andersonMixing != 0.0) {
+        if (_errorVectorSize != _vectorSize)
+            throw SanityCheckError("DIISManager: Anderson mixing needs error vectors shaped like the vectors",
+                                   __FILE__, __LINE__);
+        for (int n = 0; n < _subspace.size(); ++n) {
+            C_DAXPY(_vectorSize, _andersonMixing * _coefficients[n],
+                    const_cast<double *>(error_vector(n, scratch)), 1, result.data(), 1);
+            if (_storagePolicy == OnDisk) _subspace[n]->free_error_vector_memory();
+        }
+    }
+
+    dpdfile2 *file2;
+    dpdbuf4 *buf4;
+    Vector *vector;
+    Matrix *matrix;
+    double *array;
+    va_list args;
+    const double *arrayPtr = result.data();
+    va_start(args, numQuantities);
+    for (int i = 0; i < numQuantities; ++i) {
+        // The indexing arrays contain the error vector, then the vector, so they
+        // need to be offset by the number of components in the error vector
+        int componentIndex = i + _numErrorVectorComponents;
+        DIISEntry::InputType type = _componentTypes[componentIndex];
+        switch (type) {
+            case DIISEntry::Pointer:
+                array = va_arg(args, double *);
+                ::memcpy(array, arrayPtr, _componentSizes[componentIndex] * sizeof(double));
+                arrayPtr += _componentSizes[componentIndex];
+                break;
+            case DIISEntry::DPDBuf4:
+                buf4 = va_arg(args, dpdbuf4 *);
+                for (int h = 0; h < buf4->params->nirreps; ++h) {
+                    global_dpd_->buf4_mat_irrep_init(buf4, h);
+                    for (int row = 0; row < buf4->params->rowtot[h]; ++row) {
+                        for (int col = 0; col < buf4->params->coltot[h]; ++col) {
+                            buf4->matrix[h][row][col] = *arrayPtr++;
+                        }
+                    }
+                    global_dpd_->buf4_mat_irrep_wrt(buf4, h);
+                    global_dpd_->buf4_mat_irrep_close(buf4, h);
+                }
+                break;
+            case DIISEntry::DPDFile2:
+                file2 = va_arg(args, dpdfile2 *);
+                global_dpd_->file2_mat_init(file2);
+                for (int h = 0; h < file2->params->nirreps; ++h) {
+                    for (int row = 0; row < file2->params->rowtot[h]; ++row) {
+                        for (int col = 0; col < file2->params->coltot[h]; ++col) {
+                            file2->matrix[h][row][col] = *arrayPtr++;
+                        }
+                    }
+                }
+                global_dpd_->file2_mat_wrt(file2);
+                global_dpd_->file2_mat_close(file2);
+                break;
+            case DIISEntry::Matrix:
+                matrix = va_arg(args, Matrix *);
+                for (int h = 0; h < matrix->nirrep(); ++h) {
+                    size_t size = (size_t)matrix->rowspi()[h] * matrix->colspi()[h];
+                    if (size) ::memcpy(matrix->pointer(h)[0], arrayPtr, size * sizeof(double));
+                    arrayPtr += size;
+                }
+                break;
+            case DIISEntry::Vector:
+                vector = va_arg(args, Vector *);
+                for (int h = 0; h < vector->nirrep(); ++h) {
+                    for (int row = 0; row < vector->dimpi()[h]; ++row) {
+                        vector->set(h, row, *arrayPtr++);
+                    }
+                }
+                break;
+            default:
+                throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
+        }
+    }
+    va_end(args);
+
+    timer_off("New vector");
+
+    timer_off("DIISManager::extrapolate");
+
+    return true;
+}
+
+/**
+ * Builds the B matrix from the dot products cached by add_entry() and solves the
+ * balanced DIIS equations by pseudoinversion.
+ */
+std::vector<double> DIISManager::compute_coefficients() {
     int dimension = _subspace.size() + 1;
     auto B = std::make_shared<Matrix>("B (DIIS Connectivity Matrix", dimension, dimension);
     double **bMatrix = B->pointer();
-    double *coefficients = init_array(dimension);
-    double *force = init_array(dimension);
+    std::vector<double> coefficients(dimension, 0.0);
+    std::vector<double> force(dimension, 0.0);
 
     timer_on("bMatrix setup");
 
+    std::vector<double> scratchI, scratchJ;
     for (int i = 0; i < _subspace.size(); ++i) {
-        coefficients[i] = 0.0;
         bMatrix[i][_subspace.size()] = bMatrix[_subspace.size()][i] = 1.0;
         DIISEntry *entryI = _subspace[i];
         for (int j = 0; j < _subspace.size(); ++j) {
@@ -356,8 +477,8 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
             if (entryI->dot_is_known_with(j)) {
                 bMatrix[i][j] = entryI->dot_with(j);
             } else {
-                double dot = C_DDOT(_errorVectorSize, const_cast<double *>(entryI->errorVector()), 1,
-                                    const_cast<double *>(entryJ->errorVector()), 1);
+                double dot = C_DDOT(_errorVectorSize, const_cast<double *>(error_vector(i, scratchI)), 1,
+                                    const_cast<double *>(error_vector(j, scratchJ)), 1);
                 bMatrix[i][j] = dot;
                 entryI->set_dot_with(j, dot);
                 entryJ->set_dot_with(i, dot);
@@ -409,113 +530,48 @@ bool DIISManager::extrapolate(int numQuantities, ...) {
     // => S [S^-1 B S^-1] S \ f <= //
 
     B->power(-1.0, 1.0E-12);
-    C_DGEMV('N', dimension, dimension, 1.0, Bp[0], dimension, force, 1, 0.0, coefficients, 1);
+    C_DGEMV('N', dimension, dimension, 1.0, Bp[0], dimension, force.data(), 1, 0.0, coefficients.data(), 1);
     for (int i = 0; i < dimension; i++) {
         coefficients[i] *= Sp[i];
     }
 
     timer_off("bMatrix pseudoinverse");
 
-    timer_on("New vector");
+    coefficients.resize(_subspace.size());
+    return coefficients;
+}
 
-    dpdfile2 *file2;
-    dpdbuf4 *buf4;
-    Vector *vector;
-    Matrix *matrix;
-    double *array;
-    va_list args;
-    int print = Process::environment.options.get_int("PRINT");
-    if (print > 2) outfile->Printf("DIIS coefficients: ");
-    for (int n = 0; n < _subspace.size(); ++n) {
-        double coefficient = coefficients[n];
-        if (print > 2) outfile->Printf(" %.3f ", coefficient);
-        const double *arrayPtr = _subspace[n]->vector();
-        va_start(args, numQuantities);
-        for (int i = 0; i < numQuantities; ++i) {
-            // The indexing arrays contain the error vector, then the vector, so they
-            // need to be offset by the number of components in the error vector
-            int componentIndex = i + _numErrorVectorComponents;
-            DIISEntry::InputType type = _componentTypes[componentIndex];
-            switch (type) {
-                case DIISEntry::Pointer:
-                    array = va_arg(args, double *);
-                    if (!n) ::memset(array, 0, _componentSizes[componentIndex] * sizeof(double));
-                    for (int j = 0; j < _componentSizes[componentIndex]; ++j) array[j] += coefficient * *arrayPtr++;
-                    break;
-                case DIISEntry::DPDBuf4:
-                    buf4 = va_arg(args, dpdbuf4 *);
-                    if (!n) global_dpd_->buf4_scm(buf4, 0.0);
-                    for (int h = 0; h < buf4->params->nirreps; ++h) {
-                        global_dpd_->buf4_mat_irrep_init(buf4, h);
-                        global_dpd_->buf4_mat_irrep_rd(buf4, h);
-                        for (int row = 0; row < buf4->params->rowtot[h]; ++row) {
-                            for (int col = 0; col < buf4->params->coltot[h]; ++col) {
-                                buf4->matrix[h][row][col] += coefficient * *arrayPtr++;
-                            }
-                        }
-                        global_dpd_->buf4_mat_irrep_wrt(buf4, h);
-                        global_dpd_->buf4_mat_irrep_close(buf4, h);
-                    }
-                    break;
-                case DIISEntry::DPDFile2:
-                    file2 = va_arg(args, dpdfile2 *);
-                    if (!n) global_dpd_->file2_scm(file2, 0.0);
-                    global_dpd_->file2_mat_init(file2);
-                    global_dpd_->file2_mat_rd(file2);
-                    for (int h = 0; h < file2->params->nirreps; ++h) {
-                        for (int row = 0; row < file2->params->rowtot[h]; ++row) {
-                            for (int col = 0; col < file2->params->coltot[h]; ++col) {
-                                file2->matrix[h][row][col] += coefficient * *arrayPtr++;
-                            }
-                        }
-                    }
-                    global_dpd_->file2_mat_wrt(file2);
-                    global_dpd_->file2_mat_close(file2);
-                    break;
-                case DIISEntry::Matrix:
-                    matrix = va_arg(args, Matrix *);
-                    if (!n) matrix->zero();
-                    for (int h = 0; h < matrix->nirrep(); ++h) {
-                        for (int row = 0; row < matrix->rowspi()[h]; ++row) {
-                            for (int col = 0; col < matrix->colspi()[h]; ++col) {
-                                matrix->add(h, row, col, coefficient * *arrayPtr++);
-                            }
-                        }
-                    }
-                    break;
-                case DIISEntry::Vector:
-                    vector = va_arg(args, Vector *);
-                    if (!n) {
-                        for (int h = 0; h < vector->nirrep(); ++h) {
-                            for (int row = 0; row < vector->dimpi()[h]; ++row) {
-                                vector->set(h, row, 0.0);
-                            }
-                        }
-                    }
-                    for (int h = 0; h < vector->nirrep(); ++h) {
-                        for (int row = 0; row < vector->dimpi()[h]; ++row) {
-                            double val = vector->get(h, row);
-                            vector->set(h, row, coefficient * *arrayPtr++ + val);
-                        }
-                    }
-                    break;
-                default:
-                    throw SanityCheckError("Unknown input type", __FILE__, __LINE__);
-            }
-        }
-        if (_storagePolicy == OnDisk) _subspace[n]->free_vector_memory();
-        va_end(args);
+void DIISManager::store_in_core(int slot, const double *errorVector, const double *vector) {
+    size_t stride = (size_t)_errorVectorSize + _vectorSize;
+    if (_storagePolicy == InCore) {
+        if (_arena.empty()) _arena.resize(stride * _maxSubspaceSize);
+        double *dest = _arena.data() + slot * stride;
+        ::memcpy(dest, errorVector, _errorVectorSize * sizeof(double));
+        ::memcpy(dest + _errorVectorSize, vector, _vectorSize * sizeof(double));
+    } else {
+        if (_arenaSingle.empty()) _arenaSingle.resize(stride * _maxSubspaceSize);
+        float *dest = _arenaSingle.data() + slot * stride;
+        std::copy(errorVector, errorVector + _errorVectorSize, dest);
+        std::copy(vector, vector + _vectorSize, dest + _errorVectorSize);
     }
+}
 
-    timer_off("New vector");
-
-    if (print > 2) outfile->Printf("\n");
-    free(coefficients);
-    free(force);
-
-    timer_off("DIISManager::extrapolate");
+const double *DIISManager::error_vector(int n, std::vector<double> &scratch) {
+    size_t stride = (size_t)_errorVectorSize + _vectorSize;
+    if (_storagePolicy == OnDisk) return _subspace[n]->errorVector();
+    if (_storagePolicy == InCore) return _arena.data() + n * stride;
+    const float *source = _arenaSingle.data() + n * stride;
+    scratch.assign(source, source + _errorVectorSize);
+    return scratch.data();
+}
 
-    return true;
+const double *DIISManager::stored_vector(int n, std::vector<double> &scratch) {
+    size_t stride = (size_t)_errorVectorSize + _vectorSize;
+    if (_storagePolicy == OnDisk) return _subspace[n]->vector();
+    if (_storagePolicy == InCore) return _arena.data() + n * stride + _errorVectorSize;
+    const float *source = _arenaSingle.data() + n * stride + _errorVectorSize;
+    scratch.assign(source, source + _vectorSize);
+    return scratch.data();
 }
 
 /**
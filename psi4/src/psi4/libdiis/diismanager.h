@@ -50,9 +50,10 @@ class PSI_API DIISManager {
      * @brief How the quantities are to be stored;
      *
      * OnDisk - Stored on disk, and retrieved when required
-     * InCore - Stored in memory throughout
+     * InCore - Stored in memory throughout, in one contiguous block
+     * InCoreSingle - As InCore, but rounded to single precision to halve the memory
      */
-    enum StoragePolicy { InCore, OnDisk };
+    enum StoragePolicy { InCore, OnDisk, InCoreSingle };
     /**
      * @brief How vectors are removed from the subspace, when required
      *
@@ -62,7 +63,7 @@ class PSI_API DIISManager {
     enum RemovalPolicy { LargestError, OldestAdded };
 
     DIISManager(int maxSubspaceSize, const std::string& label, RemovalPolicy = LargestError, StoragePolicy = OnDisk);
-    DIISManager() { _maxSubspaceSize = 0; }
+    DIISManager() : _maxSubspaceSize(0), _andersonMixing(0.0) {}
     ~DIISManager();
 
     // C-style variadic? Why?
@@ -88,8 +89,24 @@ class PSI_API DIISManager {
     /// The number of vectors currently in the subspace
     int subspace_size();
 
+    /**
+     * Anderson mixing: the extrapolated vector becomes sum_i c_i (x_i + beta r_i).  Only meaningful
+     * when the error vector is the update of the vector (e.g. amplitude residuals); 0.0 is plain DIIS.
+     */
+    void set_anderson_mixing(double beta) { _andersonMixing = beta; }
+    double anderson_mixing() const { return _andersonMixing; }
+    /// The coefficients used in the last extrapolation, in subspace order
+    const std::vector<double>& coefficients() const { return _coefficients; }
+
    protected:
     int get_next_entry_id();
+    /// Solves the (balanced) DIIS equations from the cached error-vector dot products
+    std::vector<double> compute_coefficients();
+    /// Copies a new entry into its slot of the in-core arena
+    void store_in_core(int slot, const double* errorVector, const double* vector);
+    /// Error vector / vector of entry n; scratch holds the expansion of single-precision storage
+    const double* error_vector(int n, std::vector<double>& scratch);
+    const double* stored_vector(int n, std::vector<double>& scratch);
 
     /// How the vectors are handled in memory
     StoragePolicy _storagePolicy;
@@ -117,6 +134,13 @@ class PSI_API DIISManager {
     std::string _label;
     /// The PSIO object to use for I/O
     std::shared_ptr<PSIO> _psio;
+    /// In-core storage, one [error vector | vector] slot per subspace entry
+    std::vector<double> _arena;
+    std::vector<float> _arenaSingle;
+    /// The Anderson mixing parameter beta
+    double _andersonMixing;
+    /// The coefficients from the last extrapolation
+    std::vector<double> _coefficients;
 };
 
 }  // namespace psi
@@ -0,0 +1,183 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "ediis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+namespace {
+
+// Euclidean projection onto {c : c >= 0, sum c = 1}
+void project_on_simplex(std::vector<double>& c) {
+    std::vector<double> sorted(c);
+    std::sort(sorted.begin(), sorted.end(), std::greater<double>());
+    double cumulative = 0.0, shift = 0.0;
+    for (size_t k = 0; k < sorted.size(); k++) {
+        cumulative += sorted[k];
+        double candidate = (cumulative - 1.0) / (k + 1);
+        if (sorted[k] - candidate > 0.0) shift = candidate;
+    }
+    for (double& value : c) value = std::max(value - shift, 0.0);
+}
+
+double model_value(const std::vector<double>& g, const std::vector<std::vector<double>>& H,
+                   const std::vector<double>& c) {
+    double value = 0.0;
+    for (size_t i = 0; i < c.size(); i++) {
+        value += g[i] * c[i];
+        for (size_t j = 0; j < c.size(); j++) value += 0.5 * c[i] * H[i][j] * c[j];
+    }
+    return value;
+}
+
+}  // namespace
+
+EnergyDIIS::EnergyDIIS(int maxSubspaceSize, Model model, double spinFactor)
+    : maxSubspaceSize_(maxSubspaceSize), model_(model), spinFactor_(spinFactor) {
+    if (maxSubspaceSize_ < 2) throw PSIEXCEPTION("EnergyDIIS: the subspace must hold at least two entries.");
+}
+
+void EnergyDIIS::reset_subspace() {
+    entries_.clear();
+    traces_.clear();
+    coefficients_.clear();
+}
+
+void EnergyDIIS::add_entry(double energy, const std::vector<SharedMatrix>& D, const std::vector<SharedMatrix>& F) {
+    if (D.size() != F.size()) throw PSIEXCEPTION("EnergyDIIS: need one Fock matrix per density.");
+
+    if ((int)entries_.size() == maxSubspaceSize_) {
+        entries_.pop_front();
+        traces_.pop_front();
+        for (auto& row : traces_) row.pop_front();
+    }
+
+    Entry entry;
+    entry.energy = energy;
+    for (size_t s = 0; s < D.size(); s++) {
+        entry.D.push_back(D[s]->clone());
+        entry.F.push_back(F[s]->clone());
+    }
+    entries_.push_back(entry);
+
+    auto trace = [this](const Entry& a, const Entry& b) {
+        double value = 0.0;
+        for (size_t s = 0; s < a.D.size(); s++) value += a.D[s]->vector_dot(b.F[s]);
+        return spinFactor_ * value;
+    };
+
+    const Entry& added = entries_.back();
+    for (size_t i = 0; i < traces_.size(); i++) traces_[i].push_back(trace(entries_[i], added));
+    std::deque<double> row;
+    for (size_t j = 0; j < entries_.size(); j++) row.push_back(trace(added, entries_[j]));
+    traces_.push_back(row);
+}
+
+bool EnergyDIIS::extrapolate(const std::vector<SharedMatrix>& F) {
+    int n = entries_.size();
+    if (n < 2) return false;
+
+    const auto& T = traces_;
+    std::vector<double> g(n);
+    std::vector<std::vector<double>> H(n, std::vector<double>(n));
+    if (model_ == EDIIS) {
+        // E(sum c_i D_i) = sum c_i E_i - 1/4 sum c_i c_j tr[(D_i - D_j)(F_i - F_j)] for a quadratic energy
+        for (int i = 0; i < n; i++) {
+            g[i] = entries_[i].energy;
+            for (int j = 0; j < n; j++) H[i][j] = -0.5 * (T[i][i] - T[i][j] - T[j][i] + T[j][j]);
+        }
+    } else {
+        // Second-order Taylor expansion of the energy about the newest density
+        int m = n - 1;
+        for (int i = 0; i < n; i++) {
+            g[i] = T[i][m] - T[m][m];
+            for (int j = 0; j < n; j++) {
+                double Aij = T[i][j] - T[i][m] - T[m][j] + T[m][m];
+                double Aji = T[j][i] - T[j][m] - T[m][i] + T[m][m];
+                H[i][j] = 0.5 * (Aij + Aji);
+            }
+        }
+    }
+
+    coefficients_ = minimize_on_simplex(g, H);
+
+    for (size_t s = 0; s < F.size(); s++) {
+        F[s]->zero();
+        for (int i = 0; i < n; i++) F[s]->axpy(coefficients_[i], entries_[i].F[s]);
+    }
+    return true;
+}
+
+std::vector<double> EnergyDIIS::minimize_on_simplex(const std::vector<double>& g,
+                                                    const std::vector<std::vector<double>>& H) {
+    size_t n = g.size();
+
+    // Projected gradient descent with step 1/L; EDIIS is concave, so start from every vertex and the barycenter
+    double L = 0.0;
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < n; j++) L += H[i][j] * H[i][j];
+    L = std::max(std::sqrt(L), 1.0E-12);
+
+    std::vector<double> best;
+    double best_value = std::numeric_limits<double>::max();
+    for (size_t start = 0; start <= n; start++) {
+        std::vector<double> c(n, start == n ? 1.0 / n : 0.0);
+        if (start < n) c[start] = 1.0;
+
+        std::vector<double> grad(n);
+        for (int iter = 0; iter < 500; iter++) {
+            for (size_t i = 0; i < n; i++) {
+                grad[i] = g[i];
+                for (size_t j = 0; j < n; j++) grad[i] += H[i][j] * c[j];
+            }
+            std::vector<double> next(n);
+            for (size_t i = 0; i < n; i++) next[i] = c[i] - grad[i] / L;
+            project_on_simplex(next);
+
+            double step = 0.0;
+            for (size_t i = 0; i < n; i++) step = std::max(step, std::fabs(next[i] - c[i]));
+            c = next;
+            if (step < 1.0E-12) break;
+        }
+
+        double value = model_value(g, H, c);
+        if (value < best_value) {
+            best_value = value;
+            best = c;
+        }
+    }
+    return best;
+}
+
+}  // namespace psi
@@ -0,0 +1,89 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _PSI_SRC_LIB_LIBDIIS_EDIIS_H_
+#define _PSI_SRC_LIB_LIBDIIS_EDIIS_H_
+
+#include <deque>
+#include <vector>
+
+#include "psi4/pragma.h"
+#include "psi4/libmints/matrix.h"
+
+namespace psi {
+
+/**
+   @brief The EnergyDIIS class provides the energy-based SCF accelerators EDIIS
+   (Kudin, Scuseria, Cances, J. Chem. Phys. 116, 8255 (2002)) and ADIIS
+   (Hu, Yang, J. Chem. Phys. 132, 054109 (2010)).
+
+   Both minimize a model energy over convex combinations of the stored densities
+   and take the same combination of the stored Fock matrices.  They are robust far
+   from convergence, where Pulay DIIS can diverge, and are meant to be blended into
+   DIIS as the orbital gradient falls.  Each entry holds one density and one Fock
+   matrix per spin; spinFactor (2 for restricted, 1 for unrestricted) turns the
+   stored traces into total-energy traces.
+ */
+class PSI_API EnergyDIIS {
+   public:
+    enum Model { EDIIS, ADIIS };
+
+    EnergyDIIS(int maxSubspaceSize, Model model, double spinFactor);
+
+    /// Adds the energy, densities and Fock matrices of one SCF iteration; the oldest entry goes when full
+    void add_entry(double energy, const std::vector<SharedMatrix>& D, const std::vector<SharedMatrix>& F);
+    /// Overwrites F with the model-optimal combination of the stored Fock matrices
+    bool extrapolate(const std::vector<SharedMatrix>& F);
+    void reset_subspace();
+    int subspace_size() const { return (int)entries_.size(); }
+    /// The coefficients used in the last extrapolation, oldest entry first
+    const std::vector<double>& coefficients() const { return coefficients_; }
+
+    /// Minimizes g.c + 1/2 c.H.c over the probability simplex (c >= 0, sum c = 1)
+    static std::vector<double> minimize_on_simplex(const std::vector<double>& g,
+                                                   const std::vector<std::vector<double>>& H);
+
+   protected:
+    struct Entry {
+        double energy;
+        std::vector<SharedMatrix> D;
+        std::vector<SharedMatrix> F;
+    };
+
+    int maxSubspaceSize_;
+    Model model_;
+    double spinFactor_;
+    std::deque<Entry> entries_;
+    /// traces_[i][j] = spinFactor * sum_spin tr(D_i F_j), updated as entries come and go
+    std::deque<std::deque<double>> traces_;
+    std::vector<double> coefficients_;
+};
+
+}  // namespace psi
+
+#endif  // Header guard
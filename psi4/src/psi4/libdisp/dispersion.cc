@@ -43,7 +43,10 @@
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <iomanip>
 #include <stdlib.h>
@@ -52,9 +55,237 @@
 #include <vector>
 #include <memory>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
-Dispersion::Dispersion() {}
+namespace {
+
+/*
+ * Pairwise -D kernels. The C6 combination rule and the damping function are template
+ * parameters, so the inner pair loops carry no branches and vectorize.
+ */
+
+template <Dispersion::C6_type C>
+struct C6Rule;
+
+template <>
+struct C6Rule<Dispersion::C6_arit> {
+    static inline double combine(double ci, double cj) {
+        double denom = ci + cj;
+        return (denom == 0.0 ? 0.0 : 2.0 * ci * cj / denom);
+    }
+};
+
+template <>
+struct C6Rule<Dispersion::C6_geom> {
+    static inline double combine(double ci, double cj) { return std::sqrt(ci * cj); }
+};
+
+template <Dispersion::Damping_type D>
+struct Damping;
+
+/// Fermi damping, f = 1 / (1 + exp(-d (R / RvdW - 1)))
+template <>
+struct Damping<Dispersion::Damping_D1> {
+    static inline double f(double R, double RvdW, double d) { return 1.0 / (1.0 + std::exp(-d * (R / RvdW - 1.0))); }
+    /// f and its first two derivatives with respect to R
+    static inline void derivs(double R, double RvdW, double d, double &f, double &f_R, double &f_RR) {
+        double k = d / RvdW;
+        double e = std::exp(-d * (R / RvdW - 1.0));
+        f = 1.0 / (1.0 + e);
+        f_R = k * f * f * e;
+        f_RR = k * f * e * (2.0 * f_R - k * f);
+    }
+};
+
+/// Chai--Head-Gordon damping, f = 1 / (1 + d (R / RvdW)^-12)
+template <>
+struct Damping<Dispersion::Damping_CHG> {
+    static inline double f(double R, double RvdW, double d) { return 1.0 / (1.0 + d * std::pow(R / RvdW, -12.0)); }
+    static inline void derivs(double R, double RvdW, double d, double &f, double &f_R, double &f_RR) {
+        double g = d * std::pow(R / RvdW, -12.0);
+        f = 1.0 / (1.0 + g);
+        f_R = 12.0 * f * f * g / R;
+        f_RR = 12.0 * f * g / R * (2.0 * f_R - 13.0 * f / R);
+    }
+};
+
+/// Pair lists j < i in compressed rows: the neighbors of i are nbr[start[i]] ... nbr[start[i + 1] - 1]
+struct NeighborList {
+    std::vector<size_t> start;
+    std::vector<int> nbr;
+};
+
+/// Bin atoms into cubic cells of edge cutoff, so only the 27 surrounding cells are searched per atom
+NeighborList build_neighbors(int natom, const double *xyz, double cutoff) {
+    NeighborList list;
+    list.start.assign(natom + 1, 0);
+    if (natom == 0) return list;
+
+    double lo[3], hi[3];
+    for (int x = 0; x < 3; ++x) {
+        lo[x] = hi[x] = xyz[x];
+        for (int i = 1; i < natom; ++i) {
+            lo[x] = std::min(lo[x], xyz[3 * i + x]);
+            hi[x] = std::max(hi[x], xyz[3 * i + x]);
+        }
+    }
+    int ncell[3];
+    for (int x = 0; x < 3; ++x) ncell[x] = std::max(1, std::min(1024, (int)((hi[x] - lo[x]) / cutoff) + 1));
+    auto cell_of = [&](int i, int x) { return std::min(ncell[x] - 1, (int)((xyz[3 * i + x] - lo[x]) / cutoff)); };
+
+    // atoms sorted by cell
+    size_t total = (size_t)ncell[0] * ncell[1] * ncell[2];
+    std::vector<size_t> cell_start(total + 1, 0);
+    std::vector<size_t> atom_cell(natom);
+    for (int i = 0; i < natom; ++i) {
+        atom_cell[i] = ((size_t)cell_of(i, 0) * ncell[1] + cell_of(i, 1)) * ncell[2] + cell_of(i, 2);
+        cell_start[atom_cell[i] + 1]++;
+    }
+    for (size_t c = 0; c < total; ++c) cell_start[c + 1] += cell_start[c];
+    std::vector<int> cell_atoms(natom);
+    std::vector<size_t> fill(cell_start.begin(), cell_start.end() - 1);
+    for (int i = 0; i < natom; ++i) cell_atoms[fill[atom_cell[i]]++] = i;
+
+    double cut2 = cutoff * cutoff;
+    for (int i = 0; i < natom; ++i) {
+        int ci[3] = {cell_of(i, 0), cell_of(i, 1), cell_of(i, 2)};
+        for (int a = std::max(0, ci[0] - 1); a <= std::min(ncell[0] - 1, ci[0] + 1); ++a) {
+            for (int b = std::max(0, ci[1] - 1); b <= std::min(ncell[1] - 1, ci[1] + 1); ++b) {
+                for (int c = std::max(0, ci[2] - 1); c <= std::min(ncell[2] - 1, ci[2] + 1); ++c) {
+                    size_t cell = ((size_t)a * ncell[1] + b) * ncell[2] + c;
+                    for (size_t k = cell_start[cell]; k < cell_start[cell + 1]; ++k) {
+                        int j = cell_atoms[k];
+                        if (j >= i) continue;
+                        double dx = xyz[3 * j] - xyz[3 * i];
+                        double dy = xyz[3 * j + 1] - xyz[3 * i + 1];
+                        double dz = xyz[3 * j + 2] - xyz[3 * i + 2];
+                        if (dx * dx + dy * dy + dz * dz <= cut2) list.nbr.push_back(j);
+                    }
+                }
+            }
+        }
+        list.start[i + 1] = list.nbr.size();
+    }
+    return list;
+}
+
+/*
+ * Sum over pairs of C6 R^-6 f(R), without the -s6 prefactor. The gradient G (natom x 3) and the
+ * Hessian H (3 natom x 3 natom) are accumulated when not null. Pairs come from list when given,
+ * otherwise all j < i are taken.
+ */
+template <Dispersion::C6_type C6T, Dispersion::Damping_type DT>
+double pairwise_kernel(int natom, const double *xyz, const double *c6, const double *rvdw, double d,
+                       const NeighborList *list, double *G, double *H, int nthread) {
+    double E = 0.0;
+    std::vector<std::vector<double>> Gt(nthread);
+
+#pragma omp parallel num_threads(nthread) reduction(+ : E)
+    {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        if (G) Gt[rank].assign(3 * natom, 0.0);
+        std::vector<int> js;
+        std::vector<double> dE(G ? 3 * natom : 0);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < natom; ++i) {
+            // gather the partners of i so the pair loop runs over contiguous indices
+            js.clear();
+            if (list) {
+                js.assign(list->nbr.begin() + list->start[i], list->nbr.begin() + list->start[i + 1]);
+            } else {
+                for (int j = 0; j < i; ++j) js.push_back(j);
+            }
+            int n = js.size();
+            const int *jp = js.data();
+            double xi = xyz[3 * i], yi = xyz[3 * i + 1], zi = xyz[3 * i + 2];
+            double c6i = c6[i], ri = rvdw[i];
+
+            if (!G && !H) {
+                double Ei = 0.0;
+#pragma omp simd reduction(+ : Ei)
+                for (int k = 0; k < n; ++k) {
+                    int j = jp[k];
+                    double dx = xyz[3 * j] - xi;
+                    double dy = xyz[3 * j + 1] - yi;
+                    double dz = xyz[3 * j + 2] - zi;
+                    double R2 = dx * dx + dy * dy + dz * dz;
+                    double R = std::sqrt(R2);
+                    double Rm6 = 1.0 / (R2 * R2 * R2);
+                    Ei += C6Rule<C6T>::combine(c6i, c6[j]) * Rm6 * Damping<DT>::f(R, ri + rvdw[j], d);
+                }
+                E += Ei;
+                continue;
+            }
+
+            for (int k = 0; k < n; ++k) {
+                int j = jp[k];
+                double u[3] = {xyz[3 * j] - xi, xyz[3 * j + 1] - yi, xyz[3 * j + 2] - zi};
+                double R2 = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+                double R = std::sqrt(R2);
+                for (int x = 0; x < 3; ++x) u[x] /= R;
+                double C6 = C6Rule<C6T>::combine(c6i, c6[j]);
+                double f, f_R, f_RR;
+                Damping<DT>::derivs(R, ri + rvdw[j], d, f, f_R, f_RR);
+                double Rm6 = 1.0 / (R2 * R2 * R2);
+                double Rm6_R = -6.0 * Rm6 / R;
+                double Rm6_RR = 42.0 * Rm6 / R2;
+
+                E += C6 * Rm6 * f;
+                double E_R = C6 * (Rm6_R * f + Rm6 * f_R);
+                if (G) {
+                    for (int x = 0; x < 3; ++x) {
+                        Gt[rank][3 * i + x] -= E_R * u[x];
+                        Gt[rank][3 * j + x] += E_R * u[x];
+                    }
+                }
+                if (H) {
+                    // Off-diagonal block d2E / dA_x dB_y; the diagonal blocks follow from translational invariance
+                    double E_RR = C6 * (Rm6_RR * f + 2.0 * Rm6_R * f_R + Rm6 * f_RR);
+                    for (int x = 0; x < 3; ++x) {
+                        for (int y = 0; y < 3; ++y) {
+                            double val = -(E_RR * u[x] * u[y] + E_R / R * ((x == y ? 1.0 : 0.0) - u[x] * u[y]));
+                            H[(3 * i + x) * 3 * natom + 3 * j + y] = val;
+                            H[(3 * j + y) * 3 * natom + 3 * i + x] = val;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (G) {
+        for (int t = 0; t < nthread; ++t) {
+            for (int k = 0; k < 3 * natom && !Gt[t].empty(); ++k) G[k] += Gt[t][k];
+        }
+    }
+    if (H) {
+        size_t n3 = 3 * natom;
+        for (int i = 0; i < natom; ++i) {
+            for (int x = 0; x < 3; ++x) {
+                for (int y = 0; y < 3; ++y) {
+                    double sum = 0.0;
+                    for (int j = 0; j < natom; ++j) {
+                        if (j != i) sum += H[(3 * i + x) * n3 + 3 * j + y];
+                    }
+                    H[(3 * i + x) * n3 + 3 * i + y] = -sum;
+                }
+            }
+        }
+    }
+    return E;
+}
+
+}  // namespace
+
+Dispersion::Dispersion() : nthread_(Process::environment.get_n_threads()) {}
 
 Dispersion::~Dispersion() {}
 
@@ -321,42 +552,10 @@ double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
         }
     } else {
         std::shared_ptr<Vector> atom_list = set_atom_list(m);
-        double *atom_list_p = atom_list->pointer();
-        for (int i = 0; i < m->natom(); i++) {
-            for (int j = 0; j < i; j++) {
-                double C6, Rm6, f;
-
-                double dx = m->x(j) - m->x(i);
-                double dy = m->y(j) - m->y(i);
-                double dz = m->z(j) - m->z(i);
-
-                double R2 = dx * dx + dy * dy + dz * dz;
-                double R = sqrt(R2);
-                double R6 = R2 * R2 * R2;
-                Rm6 = 1.0 / R6;
-
-                if (C6_type_ == C6_arit) {
-                    C6 = 2.0 * C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]] /
-                         (C6_[(int)atom_list_p[i]] + C6_[(int)atom_list_p[j]]);
-                } else if (C6_type_ == C6_geom) {
-                    C6 = sqrt(C6_[(int)atom_list_p[i]] * C6_[(int)atom_list_p[j]]);
-                } else {
-                    throw PSIEXCEPTION("Unrecognized C6 Type");
-                }
-
-                if (Damping_type_ == Damping_D1) {
-                    double RvdW = RvdW_[(int)atom_list_p[i]] + RvdW_[(int)atom_list_p[j]];
-                    f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1)));
-                } else if (Damping_type_ == Damping_CHG) {
-                    double RvdW = RvdW_[(int)atom_list_p[i]] + RvdW_[(int)atom_list_p[j]];
-                    f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                } else {
-                    throw PSIEXCEPTION("Unrecognized Damping Function");
-                }
-
-                E += C6 * Rm6 * f;
-            }
-        }
+        std::vector<int> Z(m->natom());
+        for (int i = 0; i < m->natom(); i++) Z[i] = (int)atom_list->get(i);
+        Matrix geom = m->geometry();
+        E = compute_pairwise(Z, geom.pointer()[0], nullptr, nullptr, nthread_);
     }
     E *= -s6_;
 
@@ -365,79 +564,96 @@ double Dispersion::compute_energy(std::shared_ptr<Molecule> m) {
 
 SharedMatrix Dispersion::compute_gradient(std::shared_ptr<Molecule> m) {
     auto G = std::make_shared<Matrix>("Dispersion Gradient", m->natom(), 3);
-    double **Gp = G->pointer();
 
     if (Damping_type_ == Damping_TT) {
         throw PSIEXCEPTION("+Das Gradients not yet implemented");
     }
 
-    for (int i = 0; i < m->natom(); i++) {
-        for (int j = 0; j < i; j++) {
-            double C6, Rm6, f;
-            double C6_R, Rm6_R, f_R;
-
-            double R;
-            double R_xi, R_yi, R_zi;
-            double R_xj, R_yj, R_zj;
-
-            double dx = m->x(j) - m->x(i);
-            double dy = m->y(j) - m->y(i);
-            double dz = m->z(j) - m->z(i);
-
-            double R2 = dx * dx + dy * dy + dz * dz;
-            R = sqrt(R2);
-
-            R_xi = -dx / R;
-            R_xj = dx / R;
-            R_yi = -dy / R;
-            R_yj = dy / R;
-            R_zi = -dz / R;
-            R_zj = dz / R;
-
-            double R6 = R2 * R2 * R2;
-            Rm6 = 1.0 / R6;
-            Rm6_R = -6.0 * Rm6 / R;
-
-            double RvdW = RvdW_[(int)m->Z(i)] + RvdW_[(int)m->Z(j)];
-
-            if (C6_type_ == C6_arit) {
-                C6 = 2.0 * C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)] / (C6_[(int)m->Z(i)] + C6_[(int)m->Z(j)]);
-                C6_R = 0.0;
-            } else if (C6_type_ == C6_geom) {
-                C6 = sqrt(C6_[(int)m->Z(i)] * C6_[(int)m->Z(j)]);
-                C6_R = 0.0;
-            } else {
-                throw PSIEXCEPTION("Unrecognized C6 Type");
-            }
-            if (Damping_type_ == Damping_D1) {
-                f = 1.0 / (1.0 + exp(-d_ * (R / RvdW - 1.0)));
-                f_R = -f * f * exp(-d_ * (R / RvdW - 1.0)) * (-d_ / RvdW);
-            } else if (Damping_type_ == Damping_CHG) {
-                f = 1.0 / (1.0 + d_ * pow((R / RvdW), -12.0));
-                f_R = -f * f * d_ * (-12.0) * pow((R / RvdW), -13.0) * (1.0 / RvdW);
-            } else if (Damping_type_ == Damping_TT) {
-                throw PSIEXCEPTION("+Das Gradients not yet implemented");
-            } else {
-                throw PSIEXCEPTION("Unrecognized Damping Function");
-            }
-
-            double E_R = C6_R * Rm6 * f + C6 * Rm6_R * f + C6 * Rm6 * f_R;
-
-            Gp[i][0] += E_R * R_xi;
-            Gp[i][1] += E_R * R_yi;
-            Gp[i][2] += E_R * R_zi;
-            Gp[j][0] += E_R * R_xj;
-            Gp[j][1] += E_R * R_yj;
-            Gp[j][2] += E_R * R_zj;
-        }
-    }
+    std::vector<int> Z(m->natom());
+    for (int i = 0; i < m->natom(); i++) Z[i] = (int)m->Z(i);
+    Matrix geom = m->geometry();
+    compute_pairwise(Z, geom.pointer()[0], G->pointer()[0], nullptr, nthread_);
 
     G->scale(-s6_);
     return G;
 }
 
 SharedMatrix Dispersion::compute_hessian(std::shared_ptr<Molecule> m) {
-    throw PSIEXCEPTION("Dispersion: Hessians not implemented");
+    if (Damping_type_ == Damping_TT) {
+        throw PSIEXCEPTION("Dispersion: +Das Hessians not implemented");
+    }
+
+    auto H = std::make_shared<Matrix>("Dispersion Hessian", 3 * m->natom(), 3 * m->natom());
+    std::vector<int> Z(m->natom());
+    for (int i = 0; i < m->natom(); i++) Z[i] = (int)m->Z(i);
+    Matrix geom = m->geometry();
+    compute_pairwise(Z, geom.pointer()[0], nullptr, (m->natom() ? H->pointer()[0] : nullptr), nthread_);
+
+    H->scale(-s6_);
+    return H;
+}
+
+double Dispersion::compute_pairwise(const std::vector<int> &Z, const double *xyz, double *G, double *H,
+                                    int nthread) const {
+    int natom = Z.size();
+    std::vector<double> c6(natom), rvdw(natom);
+    for (int i = 0; i < natom; i++) {
+        c6[i] = C6_[Z[i]];
+        rvdw[i] = RvdW_[Z[i]];
+    }
+
+    NeighborList list;
+    if (cutoff_ > 0.0) list = build_neighbors(natom, xyz, cutoff_);
+    const NeighborList *lp = (cutoff_ > 0.0 ? &list : nullptr);
+
+    if (C6_type_ == C6_arit && Damping_type_ == Damping_D1) {
+        return pairwise_kernel<C6_arit, Damping_D1>(natom, xyz, c6.data(), rvdw.data(), d_, lp, G, H, nthread);
+    } else if (C6_type_ == C6_geom && Damping_type_ == Damping_D1) {
+        return pairwise_kernel<C6_geom, Damping_D1>(natom, xyz, c6.data(), rvdw.data(), d_, lp, G, H, nthread);
+    } else if (C6_type_ == C6_arit && Damping_type_ == Damping_CHG) {
+        return pairwise_kernel<C6_arit, Damping_CHG>(natom, xyz, c6.data(), rvdw.data(), d_, lp, G, H, nthread);
+    } else if (C6_type_ == C6_geom && Damping_type_ == Damping_CHG) {
+        return pairwise_kernel<C6_geom, Damping_CHG>(natom, xyz, c6.data(), rvdw.data(), d_, lp, G, H, nthread);
+    } else {
+        throw PSIEXCEPTION("Unrecognized Damping Function");
+    }
+}
+
+SharedVector Dispersion::compute_energies(std::shared_ptr<Molecule> m, const std::vector<SharedMatrix> &geometries) {
+    int ngeom = geometries.size();
+    auto E = std::make_shared<Vector>("Dispersion Energies", ngeom);
+    for (const SharedMatrix &geom : geometries) {
+        if (geom->nirrep() != 1 || geom->rowdim() != m->natom() || geom->coldim() != 3) {
+            throw PSIEXCEPTION("Dispersion::compute_energies: each geometry must be an natom x 3 matrix.");
+        }
+    }
+
+    if (Damping_type_ == Damping_TT) {
+        // -DAS works on fragments, so go through the molecule one geometry at a time
+        Molecule copy(*m);
+        for (int g = 0; g < ngeom; g++) {
+            copy.set_geometry(*geometries[g]);
+            E->set(g, compute_energy(std::make_shared<Molecule>(copy)));
+        }
+        return E;
+    }
+
+    std::shared_ptr<Vector> atom_list = set_atom_list(m);
+    std::vector<int> Z(m->natom());
+    for (int i = 0; i < m->natom(); i++) Z[i] = (int)atom_list->get(i);
+
+    // Many geometries: one per thread. Few: thread each pair sum instead
+    if (ngeom >= nthread_) {
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (int g = 0; g < ngeom; g++) {
+            E->set(g, -s6_ * compute_pairwise(Z, geometries[g]->pointer()[0], nullptr, nullptr, 1));
+        }
+    } else {
+        for (int g = 0; g < ngeom; g++) {
+            E->set(g, -s6_ * compute_pairwise(Z, geometries[g]->pointer()[0], nullptr, nullptr, nthread_));
+        }
+    }
+    return E;
 }
 
 std::shared_ptr<Vector> Dispersion::set_atom_list(std::shared_ptr<Molecule> mol) {
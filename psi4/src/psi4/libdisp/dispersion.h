@@ -37,6 +37,7 @@
 ***********************************************************/
 #include "psi4/psi4-dec.h"
 #include <string>
+#include <vector>
 
 namespace psi {
 
@@ -72,6 +73,14 @@ class Dispersion {
     const double *A_;
     const double *Beta_;
 
+    /// Pairs beyond this distance [bohr] are dropped, through a cell neighbor list. Zero keeps all pairs
+    double cutoff_ = 0.0;
+    /// Number of OpenMP threads for the pair kernels
+    int nthread_ = 1;
+
+    /// Pairwise (-D1, -D2, -CHG) energy, gradient (if G) and Hessian (if H) at the given coordinates [bohr]
+    double compute_pairwise(const std::vector<int> &Z, const double *xyz, double *G, double *H, int nthread) const;
+
    public:
     Dispersion();
     virtual ~Dispersion();
@@ -104,6 +113,10 @@ class Dispersion {
     void set_a1(double a1) { a1_ = a1; }
     void set_a2(double a2) { a2_ = a2; }
 
+    double get_cutoff() const { return cutoff_; }
+    void set_cutoff(double cutoff) { cutoff_ = cutoff; }
+    void set_nthread(int nthread) { nthread_ = nthread; }
+
     std::string print_energy(std::shared_ptr<Molecule> m);
     std::string print_gradient(std::shared_ptr<Molecule> m);
     std::string print_hessian(std::shared_ptr<Molecule> m);
@@ -111,6 +124,10 @@ class Dispersion {
     virtual double compute_energy(std::shared_ptr<Molecule> m);
     virtual SharedMatrix compute_gradient(std::shared_ptr<Molecule> m);
     virtual SharedMatrix compute_hessian(std::shared_ptr<Molecule> m);
+    /*! Energies of m at many geometries, each an natom x 3 matrix in bohr. The parameters
+     *  are resolved once and the geometries are spread over the threads.
+     */
+    virtual SharedVector compute_energies(std::shared_ptr<Molecule> m, const std::vector<SharedMatrix> &geometries);
 
     virtual void print(std::string out_fname = "outfile", int level = 1) const;
     void py_print() const { print("outfile", 1); }
@@ -32,6 +32,7 @@
 */
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include "psi4/libciomr/libciomr.h"
 #include "dpd.h"
 using std::string;
@@ -65,15 +66,23 @@ namespace psi {
 
 int DPD::buf4_init(dpdbuf4 *Buf, int inputfile, int irrep, int pqnum, int rsnum, int file_pqnum, int file_rsnum,
                    int anti, const char *label) {
-    int h, nirreps, nump, nrows, p, Gp, Gr, offset;
-
     Buf->dpdnum = dpd_default;
     Buf->params = &(dpd_list[dpd_default]->params4[pqnum][rsnum]);
 
     Buf->anti = anti;
 
+    Buf->sort_source = nullptr;
+
     file4_init(&(Buf->file), inputfile, irrep, file_pqnum, file_rsnum, label);
 
+    buf4_init_layout(Buf);
+
+    return 0;
+}
+
+void DPD::buf4_init_layout(dpdbuf4 *Buf) {
+    int h, nirreps, nump, nrows, p, Gp, Gr, offset;
+
     Buf->matrix = (double ***)malloc(Buf->params->nirreps * sizeof(double **));
 
     /* Set up shifted matrix info */
@@ -112,10 +121,56 @@ int DPD::buf4_init(dpdbuf4 *Buf, int inputfile, int irrep, int pqnum, int rsnum,
             offset += Buf->params->rpi[Gr] * Buf->params->spi[Gr ^ h ^ Buf->file.my_irrep];
         }
     }
+}
+
+/* dpd_buf4_init_sorted(): Initializes a dpd four-index buffer that is a
+** sorted view of another: reading an irrep of Buf gathers it from Source
+** in the given ordering, exactly as buf4_sort() would have written it,
+** but without the round trip through disk.  It may be handed to any
+** routine that only reads it (buf4_axpy(), buf4_dot(), the X or Y of
+** contract444(), ...); writing to it is an error.
+**
+** Arguments:
+**   dpdbuf4 *Buf: A pointer to the view to be initialized.
+**   dpdbuf4 *Source: The buffer being sorted.  It must stay open until
+**     Buf is closed, must not have any irrep in core while Buf is read,
+**     and must not be the buffer the consumer writes to.
+**   enum indices index: The sorting pattern, as in buf4_sort().
+**   int pqnum, rsnum: The index combinations for the bra and ket of Buf.
+**   char *label: A string labelling the view, used only for printing.
+**
+** Each read loads the symmetry blocks of Source that feed the irrep
+** asked for, so those must fit in core next to it.
+*/
+
+int DPD::buf4_init_sorted(dpdbuf4 *Buf, dpdbuf4 *Source, enum indices index, int pqnum, int rsnum,
+                          const char *label) {
+    Buf->dpdnum = dpd_default;
+    Buf->params = &(dpd_list[dpd_default]->params4[pqnum][rsnum]);
+    Buf->anti = 0;
+    Buf->sort_source = Source;
+    Buf->sort_index = index;
+
+    /* The view's file4 is never read or written; it only describes the layout */
+    Buf->file.dpdnum = dpd_default;
+    Buf->file.params = Buf->params;
+    strcpy(Buf->file.label, label);
+    Buf->file.filenum = Source->file.filenum;
+    Buf->file.my_irrep = Source->file.my_irrep;
+    Buf->file.incore = 0;
+    Buf->file.matrix = (double ***)malloc(Buf->params->nirreps * sizeof(double **));
+    Buf->file.lfiles = (psio_address *)malloc(Buf->params->nirreps * sizeof(psio_address));
+
+    buf4_init_layout(Buf);
 
     return 0;
 }
 
+int DPD::buf4_init_sorted(dpdbuf4 *Buf, dpdbuf4 *Source, enum indices index, string pq, string rs,
+                          const char *label) {
+    return buf4_init_sorted(Buf, Source, index, pairnum(pq), pairnum(rs), label);
+}
+
 // Wrapper for the main buf4_init() using strings rather than pair numbers
 int DPD::buf4_init(dpdbuf4 *Buf, int inputfile, int irrep, string pq, string rs, string file_pq, string file_rs,
                    int anti, const char *label) {
@@ -0,0 +1,156 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Background reads of dpdbuf4 row blocks for out-of-core contractions
+*/
+#include <cstdio>
+#include <utility>
+#include "dpd.h"
+
+namespace psi {
+
+/* dpd_buf4_prefetchable(): Only buffers read straight from their
+** dpdfile, with no unpacking or antisymmetrization, are prefetched:
+** their rows are read into the block with a single psio_read() and no
+** further allocation, so the read can run on another thread. Files
+** held in core have nothing to prefetch.
+*/
+
+bool DPD::buf4_prefetchable(dpdbuf4 *Buf) {
+    if (!prefetch_ || Buf->anti || Buf->file.incore || Buf->sort_source) return false;
+    return (Buf->params->perm_pq == Buf->file.params->perm_pq) && (Buf->params->perm_rs == Buf->file.params->perm_rs) &&
+           (Buf->params->peq == Buf->file.params->peq) && (Buf->params->res == Buf->file.params->res);
+}
+
+/* dpd_buf4_mat_irrep_init_prefetch(): Allocates the spare block used to
+** prefetch rows of one irrep of a dpd four-index buffer, the second
+** buffer of a double-buffered out-of-core loop. Nothing is allocated
+** if prefetching is off or the buffer cannot be prefetched, in which
+** case buf4_mat_irrep_prefetch_block() does nothing.
+**
+** Arguments:
+**   dpdbuf4 *Buf: A pointer to the input dpdbuf.
+**   int irrep: The irrep number to be prepared.
+**   int num_pq: The number of rows, the same as given to
+**               buf4_mat_irrep_init_block().
+*/
+
+int DPD::buf4_mat_irrep_init_prefetch(dpdbuf4 *Buf, int irrep, int num_pq) {
+    if (!buf4_prefetchable(Buf) || !num_pq) return 0;
+    int coltot = Buf->params->coltot[irrep ^ Buf->file.my_irrep];
+    if (!coltot) return 0;
+
+    dpd_prefetch &spare = prefetches_[std::make_pair(Buf, irrep)];
+    spare.block = dpd_block_matrix(num_pq, coltot);
+    spare.rows = num_pq;
+    spare.start_pq = -1;
+    spare.num_pq = 0;
+
+    return 0;
+}
+
+/* dpd_buf4_mat_irrep_prefetch_block(): Starts reading a block of rows of
+** one irrep into the spare block on a background thread. The next
+** buf4_mat_irrep_rd_block() asking for the same rows waits for the
+** read and swaps the spare block in, instead of reading them itself.
+** Until then, the caller should only compute on blocks it already has:
+** the buffer's file is being read.
+**
+** Arguments:
+**   dpdbuf4 *Buf: A pointer to the input dpdbuf.
+**   int irrep: The irrep number to be read.
+**   int start_pq: The starting row to be read.
+**   int num_pq: The number of rows to be read, at most the number
+**               given to buf4_mat_irrep_init_prefetch().
+*/
+
+int DPD::buf4_mat_irrep_prefetch_block(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq) {
+    auto it = prefetches_.find(std::make_pair(Buf, irrep));
+    if (it == prefetches_.end()) return 0;
+    dpd_prefetch &spare = it->second;
+    if (spare.done.valid()) spare.done.wait();
+    if (num_pq > spare.rows) dpd_error("buf4_mat_irrep_prefetch_block: block too large", "outfile");
+
+    spare.start_pq = start_pq;
+    spare.num_pq = num_pq;
+
+    /* Read through a copy of the dpdfile whose irrep block is the spare */
+    dpdfile4 file = Buf->file;
+    std::vector<double **> matrix(Buf->file.matrix, Buf->file.matrix + Buf->params->nirreps);
+    matrix[irrep] = spare.block;
+    spare.done = std::async(std::launch::async, [this, file, matrix, irrep, start_pq, num_pq]() mutable {
+        file.matrix = matrix.data();
+        file4_mat_irrep_rd_block(&file, irrep, start_pq, num_pq);
+    });
+
+    return 0;
+}
+
+/* dpd_buf4_prefetch_take(): Called by buf4_mat_irrep_rd_block(). If the
+** requested rows are the ones prefetched, waits for them and swaps the
+** spare block with the buffer's block. Returns false if the rows must be
+** read as usual.
+*/
+
+bool DPD::buf4_prefetch_take(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq) {
+    if (prefetches_.empty()) return false;
+    auto it = prefetches_.find(std::make_pair(Buf, irrep));
+    if (it == prefetches_.end()) return false;
+    dpd_prefetch &spare = it->second;
+    if (spare.done.valid()) spare.done.get();
+    if (spare.start_pq != start_pq || spare.num_pq != num_pq) return false;
+
+    std::swap(Buf->matrix[irrep], spare.block);
+    spare.start_pq = -1;
+    spare.num_pq = 0;
+    return true;
+}
+
+/* dpd_buf4_mat_irrep_close_prefetch(): Waits for any read still in flight
+** and releases the spare block of one irrep of a dpd four-index buffer.
+**
+** Arguments:
+**   dpdbuf4 *Buf: A pointer to the input dpdbuf.
+**   int irrep: The irrep number to be freed.
+**   int num_pq: The number of rows given to buf4_mat_irrep_init_prefetch().
+*/
+
+int DPD::buf4_mat_irrep_close_prefetch(dpdbuf4 *Buf, int irrep, int num_pq) {
+    auto it = prefetches_.find(std::make_pair(Buf, irrep));
+    if (it == prefetches_.end()) return 0;
+    dpd_prefetch &spare = it->second;
+    if (spare.done.valid()) spare.done.get();
+    free_dpd_block(spare.block, num_pq, Buf->params->coltot[irrep ^ Buf->file.my_irrep]);
+    prefetches_.erase(it);
+
+    return 0;
+}
+
+}  // namespace psi
@@ -77,6 +77,10 @@ int DPD::buf4_mat_irrep_rd(dpdbuf4 *Buf, int irrep) {
     double value;
     long int size;
 
+    if (Buf->sort_source) return buf4_sorted_rd(Buf, irrep, 0, -1);
+
+    dpd_profile_scope prof("buf4_rd", Buf->file.label);
+
 #ifdef DPD_TIMER
     timer_on("buf_rd");
 #endif
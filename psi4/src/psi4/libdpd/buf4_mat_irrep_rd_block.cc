@@ -52,6 +52,11 @@ int DPD::buf4_mat_irrep_rd_block(dpdbuf4 *Buf, int irrep, int start_pq, int num_
     int pq_permute, permute;
     double value;
 
+    /* The rows may already have been read in the background */
+    if (buf4_prefetch_take(Buf, irrep, start_pq, num_pq)) return 0;
+
+    if (Buf->sort_source) return buf4_sorted_rd(Buf, irrep, start_pq, num_pq);
+
 #ifdef DPD_TIMER
     timer_on("buf4_rd_bk");
 #endif
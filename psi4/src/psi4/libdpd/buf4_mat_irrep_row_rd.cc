@@ -52,6 +52,9 @@ int DPD::buf4_mat_irrep_row_rd(dpdbuf4 *Buf, int irrep, int pq) {
     int pq_permute, permute;
     double value;
 
+    if (Buf->sort_source)
+        dpd_error("buf4_mat_irrep_row_rd: row reads of a sorted view are not supported", "outfile");
+
     all_buf_irrep = Buf->file.my_irrep;
     rowtot = Buf->params->rowtot[irrep];
     coltot = Buf->params->coltot[irrep ^ all_buf_irrep];
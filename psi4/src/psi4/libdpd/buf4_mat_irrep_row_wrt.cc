@@ -52,6 +52,8 @@ int DPD::buf4_mat_irrep_row_wrt(dpdbuf4 *Buf, int irrep, int pq) {
     int permute;
     double value;
 
+    if (Buf->sort_source) dpd_error("buf4_mat_irrep_row_wrt: cannot write to a sorted view", "outfile");
+
     all_buf_irrep = Buf->file.my_irrep;
     /* Row and column dimensions in the DPD file */
     rowtot = Buf->file.params->rowtot[irrep];
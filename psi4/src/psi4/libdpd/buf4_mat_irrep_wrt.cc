@@ -70,6 +70,10 @@ int DPD::buf4_mat_irrep_wrt(dpdbuf4 *Buf, int irrep) {
     double value;
     long int size;
 
+    if (Buf->sort_source) dpd_error("buf4_mat_irrep_wrt: cannot write to a sorted view", "outfile");
+
+    dpd_profile_scope prof("buf4_wrt", Buf->file.label);
+
     all_buf_irrep = Buf->file.my_irrep;
 
     /* Row and column dimensions in the DPD file */
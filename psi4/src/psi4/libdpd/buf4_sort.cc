@@ -113,13 +113,19 @@ namespace psi {
 ** sqrp: IC     ** sqpr: none
 ** srqp: IC     ** srpq: IC
 ** spqr: IC     ** sprq: IC
-** -RAK, Nov. 2005*/
+** -RAK, Nov. 2005
+**
+** The in-core sorts for all orderings (now including sqpr) are done by the
+** tiled, threaded buf4_sort_permute().  Orderings without a bucketed
+** out-of-core algorithm here fall back to buf4_sort_ooc(), which needs
+** only one symmetry block of each buffer in core at a time.
+*/
 
 int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum, int rsnum, const char *label) {
-    int h, nirreps, row, col, my_irrep, r_irrep;
-    int p, q, r, s, P, Q, R, S, pq, rs, sr, pr, qs, qp, rq, qr, ps, sp, rp, sq;
+    int h, nirreps, my_irrep;
+    int p, q, r, s, pq, rs, sr, pr, qs, qp, qr, ps;
     int PQ, RS;
-    int Gp, Gq, Gr, Gs, Gpq, Grs, Gpr, Gqs, Grq, Gqr, Gps, Gsp, Grp, Gsq;
+    int Gp, Gr, Gs, Gpq, Grs, Gpr, Gps;
     dpdbuf4 OutBuf;
     int incore;
     long int rowtot, coltot, core_total, maxrows;
@@ -128,6 +134,8 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
     int in_rows_per_bucket, in_nbuckets, in_rows_left, in_row_start, m;
     int rows_per_bucket, nbuckets, rows_left;
 
+    dpd_profile_scope prof("buf4_sort", label);
+
     nirreps = InBuf->params->nirreps;
     my_irrep = InBuf->file.my_irrep;
 
@@ -216,50 +224,35 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
     }
 #endif
 
-    /* Init input and output buffers and read in all blocks of the input */
+    if (index == pqrs) {
+        outfile->Printf("\nDPD sort error: invalid index ordering.\n");
+        dpd_error("buf_sort", "outfile");
+    }
+
     if (incore) {
+        /* Init input and output buffers and read in all blocks of the input */
         for (h = 0; h < nirreps; h++) {
             buf4_mat_irrep_init(&OutBuf, h);
             buf4_mat_irrep_init(InBuf, h);
             buf4_mat_irrep_rd(InBuf, h);
         }
-    }
 
-    switch (index) {
-        case pqrs:
-            outfile->Printf("\nDPD sort error: invalid index ordering.\n");
-            dpd_error("buf_sort", "outfile");
-            break;
+        for (h = 0; h < nirreps; h++) buf4_sort_permute(InBuf, &OutBuf, index, h, -1);
 
-        case pqsr:
+        for (h = 0; h < nirreps; h++) {
+            buf4_mat_irrep_wrt(&OutBuf, h);
+            buf4_mat_irrep_close(&OutBuf, h);
+            buf4_mat_irrep_close(InBuf, h);
+        }
+    } else {
+        switch (index) {
+            case pqsr:
 
 #ifdef DPD_TIMER
-            timer_on("pqsr");
+                timer_on("pqsr");
 #endif
 
-            /* p->p; q->q; s->r; r->s = pqsr */
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-
-                        row = InBuf->params->rowidx[p][q];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            sr = InBuf->params->colidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][sr];
-                        }
-                    }
-                }
-            } else { /* out-of-core pqsr -> pqrs */
-
+                /* out-of-core pqsr -> pqrs */
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
                     rows_per_bucket = dpd_memfree() / 2 / InBuf->params->coltot[Grs];
@@ -312,58 +305,19 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
                 }
-            }
 
 #ifdef DPD_TIMER
-            timer_off("pqsr");
+                timer_off("pqsr");
 #endif
-            break;
+                break;
 
-        case prqs:
+            case prqs:
 
 #ifdef DPD_TIMER
-            timer_on("prqs");
+                timer_on("prqs");
 #endif
 
-            /* p->p; r->q; q->r; s->s = prqs */
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            /* Irreps on the source */
-                            Gpr = Gp ^ Gr;
-                            Gqs = Gq ^ Gs;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        pr = InBuf->params->rowidx[P][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            qs = InBuf->params->colidx[Q][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gpr][pr][qs];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else { /* pqrs <- prqs */
-
+                /* pqrs <- prqs */
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
@@ -407,7 +361,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -435,7 +388,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -486,7 +438,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -513,7 +464,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -541,57 +491,18 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
                 }
-            }
 
 #ifdef DPD_TIMER
-            timer_off("prqs");
+                timer_off("prqs");
 #endif
-            break;
+                break;
 
-        case prsq:
+            case prsq:
 
 #ifdef DPD_TIMER
-            timer_on("prsq");
+                timer_on("prsq");
 #endif
 
-            /* p->p; r->q; s->r; q->s = psqr */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gps = Gp ^ Gs;
-                            Gqr = Gq ^ Gr;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        qr = InBuf->params->colidx[Q][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            ps = InBuf->params->rowidx[P][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gps][ps][qr];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
@@ -635,7 +546,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -663,7 +573,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -714,7 +623,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -742,7 +650,6 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                                     p = OutBuf.params->roworb[Gpq][pq + out_row_start][0];
                                     q = OutBuf.params->roworb[Gpq][pq + out_row_start][1];
                                     Gp = OutBuf.params->psym[p];
-                                    Gq = Gpq ^ Gp;
                                     for (rs = 0; rs < OutBuf.params->coltot[Grs]; rs++) {
                                         r = OutBuf.params->colorb[Grs][rs][0];
                                         s = OutBuf.params->colorb[Grs][rs][1];
@@ -771,147 +678,18 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
 
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, out_rows_per_bucket);
                 }
-            }
 
 #ifdef DPD_TIMER
-            timer_off("prsq");
+                timer_off("prsq");
 #endif
-            break;
-
-        case psqr:
-
-#ifdef DPD_TIMER
-            timer_on("psqr");
-#endif
-
-            /* p->p; s->q; q->r; r->s = prsq */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gpr = Gp ^ Gr;
-                            Gsq = Gs ^ Gq;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        pr = InBuf->params->rowidx[P][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sq = InBuf->params->colidx[S][Q];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gpr][pr][sq];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for psqr sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("psqr");
-#endif
-            break;
-
-        case psrq:
-
-#ifdef DPD_TIMER
-            timer_on("psrq");
-#endif
-
-            /* p->p; s->q; r->r; q->s = psrq */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gps = Gp ^ Gs;
-                            Grq = Gr ^ Gq;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rq = InBuf->params->colidx[R][Q];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            ps = InBuf->params->rowidx[P][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gps][ps][rq];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for psrq sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("psrq");
-#endif
-            break;
+                break;
 
-        case qprs:
+            case qprs:
 
 #ifdef DPD_TIMER
-            timer_on("qprs");
+                timer_on("qprs");
 #endif
 
-            /* q->p; p->q; r->r; s->s = qprs */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-                        qp = InBuf->params->rowidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            col = InBuf->params->colidx[r][s];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][qp][col];
-                        }
-                    }
-                }
-            } else {
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
@@ -1002,39 +780,18 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     buf4_mat_irrep_close_block(InBuf, Gpq, rows_per_bucket);
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
                 } /* Gpq */
-            }
+
 #ifdef DPD_TIMER
-            timer_off("qprs");
+                timer_off("qprs");
 #endif
-            break;
+                break;
 
-        case qpsr:
+            case qpsr:
 
 #ifdef DPD_TIMER
-            timer_on("qpsr");
+                timer_on("qpsr");
 #endif
 
-            /* q->p; p->q; s->r; r->s = qpsr */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-                        qp = InBuf->params->rowidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-                            sr = InBuf->params->colidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][qp][sr];
-                        }
-                    }
-                }
-            } else {
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
@@ -1145,501 +902,18 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     buf4_mat_irrep_close_block(&OutBuf, Gpq, rows_per_bucket);
 
                 } /* Gpq */
-            }
-
-#ifdef DPD_TIMER
-            timer_off("qpsr");
-#endif
-            break;
-
-        case qrps:
-#ifdef DPD_TIMER
-            timer_on("qrps");
-#endif
-
-            /* q->p; r->q; p->r; s->s = rpqs */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Grp = Gr ^ Gp;
-                            Gqs = Gq ^ Gs;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rp = InBuf->params->rowidx[R][P];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            qs = InBuf->params->colidx[Q][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grp][rp][qs];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for qrps sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("qrps");
-#endif
-            break;
-
-        case qrsp:
-
-#ifdef DPD_TIMER
-            timer_on("qrsp");
-#endif
-
-            /* q->p; r->q; s->r; p->s = spqr */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gsp = Gs ^ Gp;
-                            Gqr = Gq ^ Gr;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        qr = InBuf->params->colidx[Q][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sp = InBuf->params->rowidx[S][P];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsp][sp][qr];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for qrsp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
 
 #ifdef DPD_TIMER
-            timer_off("qrsp");
+                timer_off("qpsr");
 #endif
-            break;
-
-        case qspr:
-#ifdef DPD_TIMER
-            timer_on("qspr");
-#endif
-
-            /* q->p; s->q; p->r; r->s = rpsq */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Grp = Gr ^ Gp;
-                            Gsq = Gs ^ Gq;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rp = InBuf->params->rowidx[R][P];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sq = InBuf->params->colidx[S][Q];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grp][rp][sq];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for qspr sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("qspr");
-#endif
-            break;
-
-        case qsrp:
-
-#ifdef DPD_TIMER
-            timer_on("qsrp");
-#endif
-
-            /* q->p; s->q; r->r; p->s = sprq */
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gsp = Gs ^ Gp;
-                            Grq = Gr ^ Gq;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rq = InBuf->params->colidx[R][Q];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sp = InBuf->params->rowidx[S][P];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsp][sp][rq];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for qsrp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("qsrp");
-#endif
-            break;
-
-        case rqps:
-
-#ifdef DPD_TIMER
-            timer_on("rqps");
-#endif
-
-            /* r->p; q->q; p->r; s->s = rqps */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Grq = Gr ^ Gq;
-                            Gps = Gp ^ Gs;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rq = InBuf->params->rowidx[R][Q];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            ps = InBuf->params->colidx[P][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Grq][rq][ps];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rqps sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rqps");
-#endif
-            break;
-
-        case rqsp:
-
-#ifdef DPD_TIMER
-            timer_on("rqsp");
-#endif
-
-            /* r->p; q->q; s->r; p->s = sqpr */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gsq = Gs ^ Gq;
-                            Gpr = Gp ^ Gr;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        pr = InBuf->params->colidx[P][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sq = InBuf->params->rowidx[S][Q];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsq][sq][pr];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rqsp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rqsp");
-#endif
-            break;
-
-        case rpqs:
-
-#ifdef DPD_TIMER
-            timer_on("rpqs");
-#endif
-
-            /* r->p; p->q; q->r; s->s = qrps */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gqr = Gq ^ Gr;
-                            Gps = Gp ^ Gs;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        qr = InBuf->params->rowidx[Q][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            ps = InBuf->params->colidx[P][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqr][qr][ps];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rpqs sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rpqs");
-#endif
-            break;
-
-        case rpsq:
-
-#ifdef DPD_TIMER
-            timer_on("rpsq");
-#endif
-
-            /* r->p; p->q; s->r; q->s = qspr */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gqs = Gq ^ Gs;
-                            Gpr = Gp ^ Gr;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        pr = InBuf->params->colidx[P][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            qs = InBuf->params->rowidx[Q][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqs][qs][pr];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rpsq sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rpsq");
-#endif
-            break;
-
-        case rsqp:
-
-#ifdef DPD_TIMER
-            timer_on("rsqp");
-#endif
-
-            /* r->p; s->q; q->r; p->s = srpq */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[p][q];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for rsqp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rsqp");
-#endif
-            break;
+                break;
 
-        case rspq:
+            case rspq:
 
 #ifdef DPD_TIMER
-            timer_on("rspq");
+                timer_on("rspq");
 #endif
 
-            /* r->p; s->q; p->r; q->s = rspq */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[p][q];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[r][s];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
-                        }
-                    }
-                }
-            } else {
                 for (Gpq = 0; Gpq < nirreps; Gpq++) {
                     Grs = Gpq ^ my_irrep;
 
@@ -1706,258 +980,19 @@ int DPD::buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum
                     buf4_mat_irrep_close_block(InBuf, Grs, in_rows_per_bucket);
 
                 } /* Gpq */
-            }
-
-#ifdef DPD_TIMER
-            timer_off("rspq");
-#endif
-            break;
-
-        case sqrp:
-
-#ifdef DPD_TIMER
-            timer_on("sqrp");
-#endif
-
-            /* s->p; q->q; r->r; p->s = sqrp */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gsq = Gs ^ Gq;
-                            Grp = Gr ^ Gp;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rp = InBuf->params->colidx[R][P];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sq = InBuf->params->rowidx[S][Q];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gsq][sq][rp];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for sqrp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("sqrp");
-#endif
-            break;
-
-        case sqpr:
-            outfile->Printf("\nDPD sort error: sqpr index ordering not yet coded.\n");
-            dpd_error("buf_sort", "outfile");
-            break;
-
-        case srqp:
-
-#ifdef DPD_TIMER
-            timer_on("srqp");
-#endif
-
-            /* s->p; r->q; q->r; p->s = srqp */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[s][r];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[r_irrep][row][col];
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for srqp sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("srqp");
-#endif
-            break;
-
-        case srpq:
-#ifdef DPD_TIMER
-            timer_on("srpq");
-#endif
-
-            /* s->p; r->q; p->r; q->s = rsqp */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (pq = 0; pq < OutBuf.params->rowtot[h]; pq++) {
-                        p = OutBuf.params->roworb[h][pq][0];
-                        q = OutBuf.params->roworb[h][pq][1];
-
-                        col = InBuf->params->colidx[q][p];
-
-                        for (rs = 0; rs < OutBuf.params->coltot[r_irrep]; rs++) {
-                            r = OutBuf.params->colorb[r_irrep][rs][0];
-                            s = OutBuf.params->colorb[r_irrep][rs][1];
-
-                            row = InBuf->params->rowidx[r][s];
-
-                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[h][row][col];
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for srpq sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("srpq");
-#endif
-            break;
-
-        case spqr:
-
-#ifdef DPD_TIMER
-            timer_on("spqr");
-#endif
-
-            /* s->p; p->q; q->r; r->s = qrsp */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gqr = Gq ^ Gr;
-                            Gsp = Gs ^ Gp;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        qr = InBuf->params->rowidx[Q][R];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            sp = InBuf->params->colidx[S][P];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqr][qr][sp];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for spqr sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
-#ifdef DPD_TIMER
-            timer_off("spqr");
-#endif
-            break;
-
-        case sprq:
 
 #ifdef DPD_TIMER
-            timer_on("sprq");
+                timer_off("rspq");
 #endif
+                break;
 
-            /* s->p; p->q; r->r; q->s = qsrp */
-
-            if (incore) {
-                for (h = 0; h < nirreps; h++) {
-                    r_irrep = h ^ my_irrep;
-
-                    for (Gp = 0; Gp < nirreps; Gp++) {
-                        Gq = Gp ^ h;
-                        for (Gr = 0; Gr < nirreps; Gr++) {
-                            Gs = Gr ^ r_irrep;
-
-                            Gqs = Gq ^ Gs;
-                            Grp = Gr ^ Gp;
-
-                            for (p = 0; p < OutBuf.params->ppi[Gp]; p++) {
-                                P = OutBuf.params->poff[Gp] + p;
-                                for (q = 0; q < OutBuf.params->qpi[Gq]; q++) {
-                                    Q = OutBuf.params->qoff[Gq] + q;
-                                    pq = OutBuf.params->rowidx[P][Q];
-
-                                    for (r = 0; r < OutBuf.params->rpi[Gr]; r++) {
-                                        R = OutBuf.params->roff[Gr] + r;
-                                        rp = InBuf->params->colidx[R][P];
-
-                                        for (s = 0; s < OutBuf.params->spi[Gs]; s++) {
-                                            S = OutBuf.params->soff[Gs] + s;
-                                            rs = OutBuf.params->colidx[R][S];
-                                            qs = InBuf->params->rowidx[Q][S];
-
-                                            OutBuf.matrix[h][pq][rs] = InBuf->matrix[Gqs][qs][rp];
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            } else {
-                outfile->Printf("LIBDPD: Out-of-core algorithm not yet coded for sprq sort.\n");
-                dpd_error("buf4_sort", "outfile");
-            }
-
+            default:
+                /* No bucketed algorithm for this ordering; sort one symmetry block at a time */
+                buf4_close(&OutBuf);
 #ifdef DPD_TIMER
-            timer_off("sprq");
+                timer_off("buf4_sort");
 #endif
-            break;
-    }
-
-    if (incore) {
-        for (h = 0; h < nirreps; h++) {
-            buf4_mat_irrep_wrt(&OutBuf, h);
-            buf4_mat_irrep_close(&OutBuf, h);
-            buf4_mat_irrep_close(InBuf, h);
+                return buf4_sort_ooc(InBuf, outfilenum, index, pqnum, rsnum, label);
         }
     }
 
@@ -0,0 +1,107 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Several sorts of one buffer from a single read
+*/
+#include <algorithm>
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "dpd.h"
+
+namespace psi {
+
+/* buf4_sort_multi(): Writes every target ordering of InBuf into outfilenum,
+** reading InBuf only once.  All symmetry blocks of InBuf are held in core,
+** plus one symmetry block of one target at a time, each gathered by the
+** threaded buf4_sort_permute() and written with a single block write.  If
+** that does not fit, the targets are sorted one after the other with
+** buf4_sort(), which picks its own out-of-core algorithm.
+**
+** Arguments:
+**   dpdbuf4 *InBuf: A pointer to the dpdbuf4 for the input quantity.
+**   int outfilenum: The PSI unit number for all of the new dpd file4s.
+**   targets: The ordering, pq and rs pair types, and label of each new
+**     dpd file4.  As with buf4_sort(), the pair types are not checked for
+**     consistency with the input buffer.
+*/
+int DPD::buf4_sort_multi(dpdbuf4 *InBuf, int outfilenum, const std::vector<dpd_sort_target> &targets) {
+    int nirreps = InBuf->params->nirreps;
+    int my_irrep = InBuf->file.my_irrep;
+    std::vector<dpdbuf4> OutBuf(targets.size());
+
+    dpd_profile_scope prof("buf4_sort_multi", InBuf->file.label);
+
+    for (const dpd_sort_target &target : targets) {
+        if (target.index == pqrs) {
+            outfile->Printf("\nDPD sort error: invalid index ordering.\n");
+            dpd_error("buf4_sort_multi", "outfile");
+        }
+    }
+
+    /* The whole input and the largest target block */
+    long int core_total = 0;
+    for (int h = 0; h < nirreps; h++)
+        core_total += (long int)InBuf->params->rowtot[h] * InBuf->params->coltot[h ^ my_irrep];
+    long int out_max = 0;
+    for (size_t t = 0; t < targets.size(); t++) {
+        buf4_init(&OutBuf[t], outfilenum, my_irrep, targets[t].pqnum, targets[t].rsnum, targets[t].pqnum,
+                  targets[t].rsnum, 0, targets[t].label);
+        for (int h = 0; h < nirreps; h++)
+            out_max = std::max(out_max, (long int)OutBuf[t].params->rowtot[h] * OutBuf[t].params->coltot[h ^ my_irrep]);
+    }
+
+    if (core_total + out_max > dpd_memfree()) {
+        for (size_t t = 0; t < targets.size(); t++) {
+            buf4_close(&OutBuf[t]);
+            buf4_sort(InBuf, outfilenum, targets[t].index, targets[t].pqnum, targets[t].rsnum, targets[t].label);
+        }
+        return 0;
+    }
+
+    for (int h = 0; h < nirreps; h++) {
+        buf4_mat_irrep_init(InBuf, h);
+        buf4_mat_irrep_rd(InBuf, h);
+    }
+
+    for (size_t t = 0; t < targets.size(); t++) {
+        for (int h = 0; h < nirreps; h++) {
+            buf4_mat_irrep_init(&OutBuf[t], h);
+            buf4_sort_permute(InBuf, &OutBuf[t], targets[t].index, h, -1);
+            buf4_mat_irrep_wrt(&OutBuf[t], h);
+            buf4_mat_irrep_close(&OutBuf[t], h);
+        }
+        buf4_close(&OutBuf[t]);
+    }
+
+    for (int h = 0; h < nirreps; h++) buf4_mat_irrep_close(InBuf, h);
+
+    return 0;
+}
+
+}  // namespace psi
@@ -0,0 +1,166 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Generic index permutation kernel shared by the buf4 sorts
+*/
+#include <algorithm>
+#include <cstring>
+#include "psi4/libqt/qt.h"
+#include "dpd.h"
+
+namespace psi {
+
+namespace {
+/* Tile of the target irrep block handled by one thread at a time: 16 rows of
+** 512 columns (64 kB) stays in L2 while the source is gathered into it. */
+const int sort_tile_rows = 16;
+const int sort_tile_cols = 512;
+
+/* Orderings in the order of enum indices */
+const char *sort_orders[] = {"pqrs", "pqsr", "prqs", "prsq", "psqr", "psrq", "qprs", "qpsr",
+                             "qrps", "qrsp", "qspr", "qsrp", "rqps", "rqsp", "rpqs", "rpsq",
+                             "rsqp", "rspq", "sqrp", "sqpr", "srqp", "srpq", "spqr", "sprq"};
+
+/* For each of the source indices p, q, r, s, the target position that holds it.
+** Ordering psqr means Out[ps][qr] = In[pq][rs], i.e., Out[pq][rs] = In[pr][sq]. */
+void sort_positions(enum indices index, int *src) {
+    const char *order = sort_orders[index];
+    for (int j = 0; j < 4; j++) src[j] = std::strchr(order, "pqrs"[j]) - order;
+}
+}  // namespace
+
+/* buf4_sort_sources(): Lists the symmetry blocks of InBuf that feed
+** symmetry block h of OutBuf under the given ordering.
+*/
+std::vector<int> DPD::buf4_sort_sources(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index, int h) {
+    int src[4], G[4];
+    int nirreps = OutBuf->params->nirreps;
+    int r_irrep = h ^ OutBuf->file.my_irrep;
+    std::vector<bool> used(nirreps, false);
+
+    sort_positions(index, src);
+
+    for (int Gp = 0; Gp < nirreps; Gp++) {
+        for (int Gr = 0; Gr < nirreps; Gr++) {
+            G[0] = Gp;
+            G[1] = Gp ^ h;
+            G[2] = Gr;
+            G[3] = Gr ^ r_irrep;
+            if (!OutBuf->params->ppi[G[0]] || !OutBuf->params->qpi[G[1]] || !OutBuf->params->rpi[G[2]] ||
+                !OutBuf->params->spi[G[3]])
+                continue;
+            used[G[src[0]] ^ G[src[1]]] = true;
+        }
+    }
+
+    std::vector<int> sources;
+    for (int Gsrc = 0; Gsrc < nirreps; Gsrc++)
+        if (used[Gsrc] && InBuf->params->rowtot[Gsrc]) sources.push_back(Gsrc);
+    return sources;
+}
+
+/* buf4_sort_permute(): Fills symmetry block h of OutBuf from InBuf under the
+** given ordering.  If Gsrc >= 0 only the elements that come from block Gsrc
+** of InBuf are written, and only that block needs to be in core; otherwise
+** every block of InBuf that feeds h must be.  With num_pq >= 0 only rows
+** start_pq to start_pq + num_pq - 1 are filled, into a block of that many
+** rows.  The target block is split into tiles that are gathered in parallel.
+*/
+void DPD::buf4_sort_permute(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index, int h, int Gsrc, int start_pq,
+                            int num_pq) {
+    int src[4];
+    dpdparams4 *In = InBuf->params;
+    dpdparams4 *Out = OutBuf->params;
+    int r_irrep = h ^ OutBuf->file.my_irrep;
+    int rowtot = (num_pq < 0) ? Out->rowtot[h] - start_pq : num_pq;
+    int coltot = Out->coltot[r_irrep];
+
+    if (!rowtot || !coltot) return;
+
+#ifdef DPD_TIMER
+    timer_on(sort_orders[index]);
+#endif
+
+    sort_positions(index, src);
+
+    double ***A = InBuf->matrix;
+    double **B = OutBuf->matrix[h];
+    int ncoltiles = (coltot + sort_tile_cols - 1) / sort_tile_cols;
+    int ntiles = ((rowtot + sort_tile_rows - 1) / sort_tile_rows) * ncoltiles;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int tile = 0; tile < ntiles; tile++) {
+        int orb[4];
+        int row_start = (tile / ncoltiles) * sort_tile_rows;
+        int col_start = (tile % ncoltiles) * sort_tile_cols;
+        int row_end = std::min(row_start + sort_tile_rows, rowtot);
+        int col_end = std::min(col_start + sort_tile_cols, coltot);
+
+        for (int row = row_start; row < row_end; row++) {
+            orb[0] = Out->roworb[h][start_pq + row][0];
+            orb[1] = Out->roworb[h][start_pq + row][1];
+            double *Bpq = B[row];
+            for (int rs = col_start; rs < col_end; rs++) {
+                orb[2] = Out->colorb[r_irrep][rs][0];
+                orb[3] = Out->colorb[r_irrep][rs][1];
+
+                int p = orb[src[0]], q = orb[src[1]], r = orb[src[2]], s = orb[src[3]];
+                int G = In->psym[p] ^ In->qsym[q];
+                if (Gsrc >= 0 && G != Gsrc) continue;
+
+                Bpq[rs] = A[G][In->rowidx[p][q]][In->colidx[r][s]];
+            }
+        }
+    }
+
+#ifdef DPD_TIMER
+    timer_off(sort_orders[index]);
+#endif
+}
+
+/* buf4_sorted_rd(): Fills rows start_pq to start_pq + num_pq - 1 of irrep
+** of a view made by buf4_init_sorted(), loading each source block that
+** feeds them in turn.
+*/
+int DPD::buf4_sorted_rd(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq) {
+    dpdbuf4 *Source = Buf->sort_source;
+    enum indices index = static_cast<enum indices>(Buf->sort_index);
+
+    for (int Gsrc : buf4_sort_sources(Source, Buf, index, irrep)) {
+        buf4_mat_irrep_init(Source, Gsrc);
+        buf4_mat_irrep_rd(Source, Gsrc);
+        buf4_sort_permute(Source, Buf, index, irrep, Gsrc, start_pq, num_pq);
+        buf4_mat_irrep_close(Source, Gsrc);
+    }
+
+    return 0;
+}
+
+}  // namespace psi
@@ -34,6 +34,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -65,12 +67,43 @@ namespace psi {
 
 void cc3_sigma_RHF_ic_thread(thread_data &);
 
+/* cc3_sigma_RHF_ic_memory(): The number of doubles cc3_sigma_RHF_ic()
+** holds for the same arguments: all buffers in core, a copy of the
+** sigma doubles per thread, and the (ab,c) and (a,bc) triples scratch
+** of each thread. Dints and WMnIe may be null if singles or doubles
+** are not wanted.
+*/
+
+long int DPD::cc3_sigma_RHF_ic_memory(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, dpdbuf4 *Dints, dpdbuf4 *WmAEf,
+                                      dpdbuf4 *WMnIe, dpdbuf4 *SIjAb, int *virtpi, int nthreads) {
+    auto size = [](dpdbuf4 *Buf) {
+        long int total = 0;
+        if (Buf == nullptr) return total;
+        for (int h = 0; h < Buf->params->nirreps; h++)
+            total += ((long int)Buf->params->rowtot[h]) * Buf->params->coltot[h ^ Buf->file.my_irrep];
+        return total;
+    };
+
+    int nirreps = CIjAb->params->nirreps;
+    int max_virtpi = 0;
+    long int abc = 0;
+    for (int h = 0; h < nirreps; h++) {
+        max_virtpi = std::max(max_virtpi, virtpi[h]);
+        abc += WAbEi->params->coltot[h];
+    }
+    abc *= max_virtpi;
+
+    long int memory = size(CIjAb) + size(WAbEi) + size(WMbIj) + size(Dints) + size(WmAEf) + size(WMnIe) + size(SIjAb);
+    memory += nthreads * (size(SIjAb) + 6L * abc);
+    return memory;
+}
+
 void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int do_singles, dpdbuf4 *Dints,
                            dpdfile2 *SIA, int do_doubles, dpdfile2 *FME, dpdbuf4 *WmAEf, dpdbuf4 *WMnIe, dpdbuf4 *SIjAb,
                            int *occpi, int *occ_off, int *virtpi, int *vir_off, double omega, std::string out,
                            int nthreads, int newtrips) {
     std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
-    int h, nirreps, thread, nijk, *ijk_part;
+    int h, nirreps, thread, nijk;
     int Gi, Gj, Gk, Gl, Ga, Gb, Gc, Gd;
     int i, j, k, l, a, b, c, d, row, col;
     int I, J, K, L, A, B, C, D;
@@ -165,6 +198,20 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
         }
     }
 
+    /* The per-thread increments are summed over all irrep triples and reduced once at the end */
+    for (thread = 0; thread < nthreads; ++thread) {
+        if (do_singles) {
+            for (h = 0; h < nirreps; ++h)
+                zero_mat(SIA_local[thread].matrix[h], SIA_local[thread].params->rowtot[h],
+                         SIA_local[thread].params->coltot[h ^ GS]);
+        }
+        if (do_doubles) {
+            for (h = 0; h < nirreps; ++h)
+                zero_mat(SIjAb_local[thread].matrix[h], SIjAb_local[thread].params->rowtot[h],
+                         SIjAb_local[thread].params->coltot[h ^ GS]);
+        }
+    }
+
     for (thread = 0; thread < nthreads; ++thread) {
         thread_data_array[thread].CIjAb = CIjAb;
         thread_data_array[thread].WAbEi = WAbEi;
@@ -191,7 +238,8 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
         thread_data_array[thread].newtrips = newtrips;
     }
 
-    ijk_part = new int[nthreads];
+    std::atomic<int> next_ijk(0);
+    for (thread = 0; thread < nthreads; ++thread) thread_data_array[thread].next_ijk = &next_ijk;
 
     for (Gi = 0; Gi < nirreps; Gi++) {
         for (Gj = 0; Gj < nirreps; Gj++) {
@@ -208,57 +256,40 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
                     thread_data_array[thread].Gi = Gi;
                     thread_data_array[thread].Gj = Gj;
                     thread_data_array[thread].Gk = Gk;
-                    ijk_part[thread] = nijk / nthreads;
-                    if (thread < (nijk % nthreads)) ++ijk_part[thread];
-                    if (do_singles) { /* zero S's */
-                        for (h = 0; h < nirreps; ++h)
-                            zero_mat(SIA_local[thread].matrix[h], SIA_local[thread].params->rowtot[h],
-                                     SIA_local[thread].params->coltot[h ^ GS]);
-                    }
-                    if (do_doubles) {
-                        for (h = 0; h < nirreps; ++h)
-                            zero_mat(SIjAb_local[thread].matrix[h], SIjAb_local[thread].params->rowtot[h],
-                                     SIjAb_local[thread].params->coltot[h ^ GS]);
-                    }
                 }
 
-                cnt = 0;
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (!ijk_part[thread]) continue;  // there are more threads than nijk
-                    thread_data_array[thread].first_ijk = cnt;
-                    cnt += ijk_part[thread];
-                    thread_data_array[thread].last_ijk = cnt - 1;
-                }
+                /* Each thread claims the next unclaimed ijk as it finishes one, which keeps the
+                   threads busy however unevenly the work per ijk is spread over the irreps */
+                next_ijk = 0;
 
 /* execute threads */
-#pragma omp parallel num_threads(nthreads)
+#pragma omp parallel num_threads(std::min(nthreads, nijk))
                 {
                     int ithread = 0;
 #ifdef _OPENMP
                     ithread = omp_get_thread_num();
 #endif
-                    if (ijk_part[ithread]) cc3_sigma_RHF_ic_thread(thread_data_array[ithread]);
+                    cc3_sigma_RHF_ic_thread(thread_data_array[ithread]);
                 }
+            } /* Gk */
+        }     /* Gj */
+    }         /* Gi */
 
-                for (thread = 0; thread < nthreads; ++thread) {
-                    if (do_singles) {
-                        for (h = 0; h < nirreps; ++h)
-                            for (row = 0; row < SIA->params->rowtot[h]; row++)
-                                for (col = 0; col < SIA->params->coltot[h ^ GS]; col++)
-                                    SIA->matrix[h][row][col] += SIA_local[thread].matrix[h][row][col];
-                    }
-                    if (do_doubles) {
-                        for (h = 0; h < nirreps; ++h) {
-                            length = ((long)SIjAb->params->rowtot[h]) * ((long)SIjAb->params->coltot[h ^ GS]);
-                            if (length)
-                                C_DAXPY(length, 1.0, &(SIjAb_local[thread].matrix[h][0][0]), 1,
-                                        &(SIjAb->matrix[h][0][0]), 1);
-                        }
-                    }
-                } /* end adding up S's */
-            }     /* Gk */
-        }         /* Gj */
-    }             /* Gi */
+    for (thread = 0; thread < nthreads; ++thread) {
+        if (do_singles) {
+            for (h = 0; h < nirreps; ++h)
+                for (row = 0; row < SIA->params->rowtot[h]; row++)
+                    for (col = 0; col < SIA->params->coltot[h ^ GS]; col++)
+                        SIA->matrix[h][row][col] += SIA_local[thread].matrix[h][row][col];
+        }
+        if (do_doubles) {
+            for (h = 0; h < nirreps; ++h) {
+                length = ((long)SIjAb->params->rowtot[h]) * ((long)SIjAb->params->coltot[h ^ GS]);
+                if (length)
+                    C_DAXPY(length, 1.0, &(SIjAb_local[thread].matrix[h][0][0]), 1, &(SIjAb->matrix[h][0][0]), 1);
+            }
+        }
+    } /* end adding up S's */
 
     /* close up files and update sigma vectors */
     file2_mat_close(&fIJ);
@@ -279,7 +310,6 @@ void DPD::cc3_sigma_RHF_ic(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, int d
             buf4_close(&(SIjAb_local[i]));
         }
     }
-    delete[] ijk_part;
 
     for (h = 0; h < nirreps; h++) {
         buf4_mat_irrep_close(WAbEi, h);
@@ -317,7 +347,7 @@ void cc3_sigma_RHF_ic_thread(thread_data &data) {
     char lbl[32];
 
     int do_singles, do_doubles, *occpi, *occ_off, *virtpi, *vir_off;
-    int Gi, Gj, Gk, thr_id, first_ijk, last_ijk;
+    int Gi, Gj, Gk, thr_id;
     double omega;
     dpdfile2 *FME, *fIJ, *fAB;
     dpdbuf4 *CIjAb, *WAbEi, *WMbIj, *Dints, *WmAEf, *WMnIe;
@@ -346,8 +376,6 @@ void cc3_sigma_RHF_ic_thread(thread_data &data) {
     Gi = data.Gi;
     Gj = data.Gj;
     Gk = data.Gk;
-    first_ijk = data.first_ijk;
-    last_ijk = data.last_ijk;
     std::string out = data.outfile;
     thr_id = data.thr_id;
     SIA_local = data.SIA_local;
@@ -366,6 +394,10 @@ void cc3_sigma_RHF_ic_thread(thread_data &data) {
     GW = WmAEf->file.my_irrep;
     GS = SIjAb->file.my_irrep;
 
+    /* nothing left for this thread, skip the scratch allocations */
+    int my_ijk = data.next_ijk->fetch_add(1);
+    if (my_ijk >= occpi[Gi] * occpi[Gj] * occpi[Gk]) return;
+
     W3 = (double ***)malloc(nirreps * sizeof(double **));
     W3a = (double ***)malloc(nirreps * sizeof(double **));
     W = (double ***)malloc(nirreps * sizeof(double **));
@@ -399,8 +431,8 @@ void cc3_sigma_RHF_ic_thread(thread_data &data) {
                 K = occ_off[Gk] + k;
 
                 ++cnt_ijk;
-                /* check to see if this ijk is for this thread */
-                if ((cnt_ijk < first_ijk) || (cnt_ijk > last_ijk)) continue;
+                /* check to see if this ijk is the one this thread claimed */
+                if (cnt_ijk != my_ijk) continue;
 
                 ij = CIjAb->params->rowidx[I][J];
                 ji = CIjAb->params->rowidx[J][I];
@@ -858,9 +890,12 @@ void cc3_sigma_RHF_ic_thread(thread_data &data) {
                         }
                     } /* oldtrips */
                 }     /* end do_doubles */
-            }         /* k */
-        }             /* j */
-    }                 /* i */
+
+                /* claim the next ijk; it always lies further along the loops */
+                my_ijk = data.next_ijk->fetch_add(1);
+            } /* k */
+        }     /* j */
+    }         /* i */
 
     for (Gab = 0; Gab < nirreps; Gab++) {
         Gc = Gab ^ Gijk ^ GX3;
@@ -49,6 +49,8 @@ int DPD::contract222(dpdfile2 *X, dpdfile2 *Y, dpdfile2 *Z, int target_X, int ta
     int *xrow, *xcol, *yrow, *ycol, *zrow, *zcol;
 #endif
 
+    dpd_profile_scope prof("contract222", Z->label);
+
     nirreps = X->params->nirreps;
     GX = X->my_irrep;
     GY = Y->my_irrep;
@@ -125,6 +127,7 @@ int DPD::contract222(dpdfile2 *X, dpdfile2 *Y, dpdfile2 *Z, int target_X, int ta
         }
 
         if (Z->params->rowtot[Hz] && Z->params->coltot[Hz ^ GZ] && numlinks[Hx ^ symlink]) {
+            prof.flops += 2.0 * Z->params->rowtot[Hz] * Z->params->coltot[Hz ^ GZ] * numlinks[Hx ^ symlink];
             C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[Hz], Z->params->coltot[Hz ^ GZ],
                     numlinks[Hx ^ symlink], alpha, &(X->matrix[Hx][0][0]), X->params->coltot[Hx ^ GX],
                     &(Y->matrix[Hy][0][0]), Y->params->coltot[Hy ^ GY], beta, &(Z->matrix[Hz][0][0]),
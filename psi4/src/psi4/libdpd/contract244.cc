@@ -76,6 +76,8 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
     int *xrow, *xcol, *zrow, *zcol;
 #endif
 
+    dpd_profile_scope prof("contract244", Z->file.label);
+
     nirreps = Y->params->nirreps;
     GX = X->my_irrep;
     GY = Y->file.my_irrep;
@@ -296,6 +298,7 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                         dpd_error("dpd_contract244", "outfile");
                     }
 #endif
+                    prof.flops += 2.0 * numrows[Hz] * numcols[Hz] * numlinks[Hx ^ symlink];
                     newmm_rking(X->matrix[Hx], Xtrans, Ymat[Hy], Ytrans, Zmat[Hz], numrows[Hz], numlinks[Hx ^ symlink],
                                 numcols[Hz], alpha, 1.0);
                 }
@@ -326,6 +329,7 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
          Hz, Hx, Hy, numrows[Hz],numlinks[Hx],numcols[Hz]); */
 
                     if (numrows[Hz] && numcols[Hz] && numlinks[Hx ^ symlink]) {
+                        prof.flops += 2.0 * numrows[Hz] * numcols[Hz] * numlinks[Hx ^ symlink];
                         if (!Xtrans && !Ytrans) {
                             C_DGEMM('n', 'n', numrows[Hz], numcols[Hz], numlinks[Hx ^ symlink], alpha,
                                     &(X->matrix[Hx][0][0]), numlinks[Hz ^ symlink], &(Ymat[Hy][0][0]), numcols[Hz], 1.0,
@@ -380,6 +384,9 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
             buf4_mat_irrep_row_init(Y, hybuf);
             buf4_mat_irrep_row_init(Z, hzbuf);
 
+            /* The per-irrep products for a row are small; issue them together */
+            dpd_gemm_batch Batch;
+
             /* Loop over rows of the Y factor and the target */
             for (pq = 0; pq < Z->params->rowtot[hzbuf]; pq++) {
                 buf4_mat_irrep_row_zero(Y, hybuf, pq);
@@ -403,12 +410,14 @@ int DPD::contract244(dpdfile2 *X, dpdbuf4 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                     colz = Z->params->spi[Gs];
 
                     if (nrows && ncols && nlinks) {
-                        C_DGEMM(Xtrans ? 't' : 'n', 'n', nrows, ncols, nlinks, alpha,
-                                &(X->matrix[Xtrans ? GrY : GrZ][0][0]), Xtrans ? nrows : nlinks,
-                                &(Y->matrix[hybuf][0][Y->col_offset[hybuf][GrY]]), ncols, 1.0,
-                                &(Z->matrix[hzbuf][0][Z->col_offset[hzbuf][GrZ]]), ncols);
+                        Batch.add(Xtrans ? 't' : 'n', 'n', nrows, ncols, nlinks, alpha,
+                                  &(X->matrix[Xtrans ? GrY : GrZ][0][0]), Xtrans ? nrows : nlinks,
+                                  &(Y->matrix[hybuf][0][Y->col_offset[hybuf][GrY]]), ncols, 1.0,
+                                  &(Z->matrix[hzbuf][0][Z->col_offset[hzbuf][GrZ]]), ncols);
                     }
                 }
+                prof.flops += Batch.flops();
+                gemm_batch(Batch);
                 buf4_mat_irrep_row_wrt(Z, hzbuf, pq);
             }
 
@@ -33,6 +33,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <vector>
 #include "psi4/libqt/qt.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
@@ -59,21 +60,23 @@ namespace psi {
  */
 
 int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y, int Ztrans, double alpha, double beta) {
-    int h, nirreps, GX, GY, GZ, hxbuf, hzbuf, h0, Hx, Hy, Hz, GsX, GsZ;
+    int nirreps, GX, GY, GZ, hxbuf, hzbuf, Hz, GsX, GsZ;
     int rking = 0, symlink;
     int Xtrans, Ytrans;
     int *numlinks, *numrows, *numcols;
     int incore;
-    long int core, memoryd, core_total, rowtot, coltot, maxrows;
-    int xcount, zcount, scount, Ysym;
+    long int memoryd, core_total, rowtot, coltot, maxrows;
+    int xcount, zcount;
     int rowx, rowz, colx, colz;
-    int pq, rs, r, s, Gr, Gs;
+    int pq, Gr;
     dpdtrans4 Xt, Zt;
     double ***Xmat, ***Zmat;
 #ifdef DPD_DEBUG
     int *xrow, *xcol, *yrow, *ycol, *zrow, *zcol;
 #endif
 
+    dpd_profile_scope prof("contract424", Z->file.label);
+
     nirreps = X->params->nirreps;
     GX = X->file.my_irrep;
     GY = Y->my_irrep;
@@ -258,75 +261,59 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
 #endif
             }
 
-            if (rking)
-                for (Hz = 0; Hz < nirreps; Hz++) {
-                    if (!Xtrans && !Ytrans) {
-                        Hx = Hz;
-                        Hy = Hz ^ GX;
-                    } else if (!Xtrans && Ytrans) {
-                        Hx = Hz;
-                        Hy = Hz ^ GX ^ GY;
-                    } else if (Xtrans && !Ytrans) {
-                        Hx = Hz ^ GX;
-                        Hy = Hz ^ GX;
-                    } else if (Xtrans && Ytrans) {
-                        Hx = Hz ^ GX;
-                        Hy = Hz ^ GX ^ GY;
-                    }
+            /* The sub-blocks of Z are disjoint, so they are computed as
+               concurrent tasks, weighted by their multiplication counts */
+            std::vector<int> Hxs(nirreps), Hys(nirreps);
+            std::vector<double> cost(nirreps, 0.0);
+            for (Hz = 0; Hz < nirreps; Hz++) {
+                if (!Xtrans && !Ytrans) {
+                    Hxs[Hz] = Hz;
+                    Hys[Hz] = Hz ^ GX;
+                } else if (!Xtrans && Ytrans) {
+                    Hxs[Hz] = Hz;
+                    Hys[Hz] = Hz ^ GX ^ GY;
+                } else if (Xtrans && !Ytrans) {
+                    Hxs[Hz] = Hz ^ GX;
+                    Hys[Hz] = Hz ^ GX;
+                } else if (Xtrans && Ytrans) {
+                    Hxs[Hz] = Hz ^ GX;
+                    Hys[Hz] = Hz ^ GX ^ GY;
+                }
 #ifdef DPD_DEBUG
-                    if ((xrow[Hz] != zrow[Hz]) || (ycol[Hz] != zcol[Hz]) || (xcol[Hz] != yrow[Hz])) {
-                        outfile->Printf("** Alignment error in contract424 **\n");
-                        outfile->Printf("** Irrep: %d; Subirrep: %d **\n", hxbuf, Hz);
-                        dpd_error("dpd_contract424", "outfile");
-                    }
-#endif
-                    /* outfile->Printf("Hx %d Hy %d Hz %d\n",Hx,Hy,Hz);
-         outfile->Printf("numrows %d numlinks %d numcols %d\n",numrows[Hz],numlinks[Hy],numcols[Hz]); */
-                    newmm_rking(Xmat[Hx], Xtrans, Y->matrix[Hy], Ytrans, Zmat[Hz], numrows[Hz], numlinks[Hy ^ symlink],
-                                numcols[Hz], alpha, 1.0);
+                if ((xrow[Hz] != zrow[Hz]) || (ycol[Hz] != zcol[Hz]) || (xcol[Hz] != yrow[Hz])) {
+                    outfile->Printf("** Alignment error in contract424 **\n");
+                    outfile->Printf("** Irrep: %d; Subirrep: %d **\n", hxbuf, Hz);
+                    dpd_error("dpd_contract424", "outfile");
                 }
+#endif
+                cost[Hz] = ((double)numrows[Hz]) * ((double)numcols[Hz]) * ((double)numlinks[Hys[Hz] ^ symlink]);
+                prof.flops += 2.0 * cost[Hz];
+            }
+
+            if (rking)
+                irrep_tasks(cost, [&](int hz) {
+                    int hx = Hxs[hz], hy = Hys[hz];
+                    newmm_rking(Xmat[hx], Xtrans, Y->matrix[hy], Ytrans, Zmat[hz], numrows[hz], numlinks[hy ^ symlink],
+                                numcols[hz], alpha, 1.0);
+                });
             else
-                for (Hz = 0; Hz < nirreps; Hz++) {
+                irrep_tasks(cost, [&](int hz) {
+                    int hy = Hys[hz];
+                    int nlinks = numlinks[hy ^ symlink];
                     if (!Xtrans && !Ytrans) {
-                        Hx = Hz;
-                        Hy = Hz ^ GX;
-                    } else if (!Xtrans && Ytrans) {
-                        Hx = Hz;
-                        Hy = Hz ^ GX ^ GY;
+                        C_DGEMM('n', 'n', numrows[hz], numcols[hz], nlinks, alpha, &(Xmat[hz][0][0]), nlinks,
+                                &(Y->matrix[hy][0][0]), numcols[hz], 1.0, &(Zmat[hz][0][0]), numcols[hz]);
                     } else if (Xtrans && !Ytrans) {
-                        Hx = Hz ^ GX;
-                        Hy = Hz ^ GX;
-                    } else if (Xtrans && Ytrans) {
-                        Hx = Hz ^ GX;
-                        Hy = Hz ^ GX ^ GY;
-                    }
-#ifdef DPD_DEBUG
-                    if ((xrow[Hz] != zrow[Hz]) || (ycol[Hz] != zcol[Hz]) || (xcol[Hz] != yrow[Hz])) {
-                        outfile->Printf("** Alignment error in contract424 **\n");
-                        outfile->Printf("** Irrep: %d; Subirrep: %d **\n", hxbuf, Hz);
-                        dpd_error("dpd_contract424", "outfile");
-                    }
-#endif
-                    if (numrows[Hz] && numcols[Hz] && numlinks[Hy ^ symlink]) {
-                        if (!Xtrans && !Ytrans) {
-                            C_DGEMM('n', 'n', numrows[Hz], numcols[Hz], numlinks[Hy ^ symlink], alpha,
-                                    &(Xmat[Hz][0][0]), numlinks[Hy ^ symlink], &(Y->matrix[Hy][0][0]), numcols[Hz], 1.0,
-                                    &(Zmat[Hz][0][0]), numcols[Hz]);
-                        } else if (Xtrans && !Ytrans) {
-                            C_DGEMM('t', 'n', numrows[Hz], numcols[Hz], numlinks[Hy ^ symlink], alpha,
-                                    &(Xmat[Hz][0][0]), numrows[Hz], &(Y->matrix[Hy][0][0]), numcols[Hz], 1.0,
-                                    &(Zmat[Hz][0][0]), numcols[Hz]);
-                        } else if (!Xtrans && Ytrans) {
-                            C_DGEMM('n', 't', numrows[Hz], numcols[Hz], numlinks[Hy ^ symlink], alpha,
-                                    &(Xmat[Hz][0][0]), numlinks[Hy ^ symlink], &(Y->matrix[Hy][0][0]),
-                                    numlinks[Hy ^ symlink], 1.0, &(Zmat[Hz][0][0]), numcols[Hz]);
-                        } else {
-                            C_DGEMM('t', 't', numrows[Hz], numcols[Hz], numlinks[Hy ^ symlink], alpha,
-                                    &(Xmat[Hz][0][0]), numrows[Hz], &(Y->matrix[Hy][0][0]), numlinks[Hy ^ symlink], 1.0,
-                                    &(Zmat[Hz][0][0]), numcols[Hz]);
-                        }
+                        C_DGEMM('t', 'n', numrows[hz], numcols[hz], nlinks, alpha, &(Xmat[hz][0][0]), numrows[hz],
+                                &(Y->matrix[hy][0][0]), numcols[hz], 1.0, &(Zmat[hz][0][0]), numcols[hz]);
+                    } else if (!Xtrans && Ytrans) {
+                        C_DGEMM('n', 't', numrows[hz], numcols[hz], nlinks, alpha, &(Xmat[hz][0][0]), nlinks,
+                                &(Y->matrix[hy][0][0]), nlinks, 1.0, &(Zmat[hz][0][0]), numcols[hz]);
+                    } else {
+                        C_DGEMM('t', 't', numrows[hz], numcols[hz], nlinks, alpha, &(Xmat[hz][0][0]), numrows[hz],
+                                &(Y->matrix[hy][0][0]), nlinks, 1.0, &(Zmat[hz][0][0]), numcols[hz]);
                     }
-                }
+                });
 
             if (sum_X == 0)
                 buf4_mat_irrep_close(X, hxbuf);
@@ -355,6 +342,9 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
             buf4_mat_irrep_row_init(X, hxbuf);
             buf4_mat_irrep_row_init(Z, hzbuf);
 
+            /* The per-irrep products for a row are small; issue them together */
+            dpd_gemm_batch Batch;
+
             /* Loop over rows of the X factor and the target */
             for (pq = 0; pq < Z->params->rowtot[hzbuf]; pq++) {
                 buf4_mat_irrep_row_zero(X, hxbuf, pq);
@@ -376,14 +366,16 @@ int DPD::contract424(dpdbuf4 *X, dpdfile2 *Y, dpdbuf4 *Z, int sum_X, int sum_Y,
                     colz = Z->params->spi[GsZ];
 
                     if (rowx && colx && colz) {
-                        C_DGEMM('n', Ytrans ? 't' : 'n', rowx, colz, colx, alpha, &(X->matrix[hxbuf][0][xcount]), colx,
-                                &(Y->matrix[Ytrans ? GsZ : GsX][0][0]), Ytrans ? colx : colz, 1.0,
-                                &(Z->matrix[hzbuf][0][zcount]), colz);
+                        Batch.add('n', Ytrans ? 't' : 'n', rowx, colz, colx, alpha, &(X->matrix[hxbuf][0][xcount]), colx,
+                                  &(Y->matrix[Ytrans ? GsZ : GsX][0][0]), Ytrans ? colx : colz, 1.0,
+                                  &(Z->matrix[hzbuf][0][zcount]), colz);
                     }
 
                     xcount += rowx * colx;
                     zcount += rowz * colz;
                 }
+                prof.flops += Batch.flops();
+                gemm_batch(Batch);
 
                 buf4_mat_irrep_row_wrt(Z, hzbuf, pq);
             }
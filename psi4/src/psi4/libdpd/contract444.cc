@@ -32,6 +32,7 @@
 */
 #include <cstdio>
 #include <cmath>
+#include <vector>
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsio/psio.h"
 #include "dpd.h"
@@ -58,7 +59,7 @@ namespace psi {
 int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int target_Y, double alpha, double beta) {
     int n, Hx, Hy, Hz, GX, GY, GZ, nirreps, Xtrans, Ytrans, *numlinks, symlink;
     long int size_Y, size_Z, size_file_X_row;
-    int incore, nbuckets;
+    int incore, nbuckets, prefetch;
     long int memoryd, core, rows_per_bucket, rows_left, memtotal;
     int nrows, ncols, nlinks;
 #if DPD_DEBUG
@@ -66,6 +67,8 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     double byte_conv;
 #endif
 
+    dpd_profile_scope prof("contract444", Z->file.label);
+
     nirreps = X->params->nirreps;
     GX = X->file.my_irrep;
     GY = Y->file.my_irrep;
@@ -112,20 +115,76 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
     }
 #endif
 
+    std::vector<int> Hys(nirreps), Hzs(nirreps);
     for (Hx = 0; Hx < nirreps; Hx++) {
         if ((!Xtrans) && (!Ytrans)) {
-            Hy = Hx ^ GX;
-            Hz = Hx;
+            Hys[Hx] = Hx ^ GX;
+            Hzs[Hx] = Hx;
         } else if ((!Xtrans) && (Ytrans)) {
-            Hy = Hx ^ GX ^ GY;
-            Hz = Hx;
+            Hys[Hx] = Hx ^ GX ^ GY;
+            Hzs[Hx] = Hx;
         } else if ((Xtrans) && (!Ytrans)) {
-            Hy = Hx;
-            Hz = Hx ^ GX;
+            Hys[Hx] = Hx;
+            Hzs[Hx] = Hx ^ GX;
         } else /* (( Xtrans)&&( Ytrans))*/ {
-            Hy = Hx ^ GY;
-            Hz = Hx ^ GX;
+            Hys[Hx] = Hx ^ GY;
+            Hzs[Hx] = Hx ^ GX;
+        }
+        prof.flops += 2.0 * Z->params->rowtot[Hzs[Hx]] * Z->params->coltot[Hzs[Hx] ^ GZ] * numlinks[Hx ^ symlink];
+    }
+
+    /* If every irrep of X, Y and Z fits in core at once, read them all
+       up front and run the irreps' DGEMMs as concurrent tasks.  The
+       I/O stays on this thread; only the arithmetic is spread out. */
+    if (nirreps > 1 && irrep_task_threads() > 1 && X != Y && X != Z && Y != Z) {
+        long int core_total = 0;
+        std::vector<double> cost(nirreps, 0.0);
+        for (Hx = 0; Hx < nirreps; Hx++) {
+            Hy = Hys[Hx];
+            Hz = Hzs[Hx];
+            core_total += ((long)X->params->rowtot[Hx]) * ((long)X->params->coltot[Hx ^ GX]);
+            core_total += ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
+            core_total += ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
+            cost[Hx] = ((double)Z->params->rowtot[Hz]) * ((double)Z->params->coltot[Hz ^ GZ]) *
+                       ((double)numlinks[Hx ^ symlink]);
+        }
+
+        if (core_total <= dpd_memfree()) {
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                Hy = Hys[Hx];
+                Hz = Hzs[Hx];
+                buf4_mat_irrep_init(X, Hx);
+                buf4_mat_irrep_rd(X, Hx);
+                buf4_mat_irrep_init(Y, Hy);
+                buf4_mat_irrep_rd(Y, Hy);
+                buf4_mat_irrep_init(Z, Hz);
+                if (std::fabs(beta) > 0.0) buf4_mat_irrep_rd(Z, Hz);
+            }
+
+            irrep_tasks(cost, [&](int h) {
+                int hy = Hys[h], hz = Hzs[h];
+                C_DGEMM(Xtrans ? 't' : 'n', Ytrans ? 't' : 'n', Z->params->rowtot[hz], Z->params->coltot[hz ^ GZ],
+                        numlinks[h ^ symlink], alpha, &(X->matrix[h][0][0]), X->params->coltot[h ^ GX],
+                        &(Y->matrix[hy][0][0]), Y->params->coltot[hy ^ GY], beta, &(Z->matrix[hz][0][0]),
+                        Z->params->coltot[hz ^ GZ]);
+            });
+
+            for (Hx = 0; Hx < nirreps; Hx++) {
+                Hy = Hys[Hx];
+                Hz = Hzs[Hx];
+                buf4_mat_irrep_close(X, Hx);
+                buf4_mat_irrep_wrt(Z, Hz);
+                buf4_mat_irrep_close(Y, Hy);
+                buf4_mat_irrep_close(Z, Hz);
+            }
+
+            return 0;
         }
+    }
+
+    for (Hx = 0; Hx < nirreps; Hx++) {
+        Hy = Hys[Hx];
+        Hz = Hzs[Hx];
 
         size_Y = ((long)Y->params->rowtot[Hy]) * ((long)Y->params->coltot[Hy ^ GY]);
         size_Z = ((long)Z->params->rowtot[Hz]) * ((long)Z->params->coltot[Hz ^ GZ]);
@@ -152,6 +211,18 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
         } else
             incore = 1;
 
+        /* Out of core, read the next bucket of X while the current one is
+           contracted, if there is room for two */
+        prefetch = 0;
+        if (!incore && buf4_prefetchable(X) && memoryd / (2 * X->params->coltot[Hx ^ GX])) {
+            prefetch = 1;
+            rows_per_bucket = memoryd / (2 * X->params->coltot[Hx ^ GX]);
+            nbuckets = (int)ceil((double)X->params->rowtot[Hx] / (double)rows_per_bucket);
+            rows_left = X->params->rowtot[Hx] % rows_per_bucket;
+        }
+        /* The last bucket is full if the rows divide evenly */
+        if (!incore && !rows_left) rows_left = rows_per_bucket;
+
 #if DPD_DEBUG
         if (!incore) {
             outfile->Printf("Contract444: memory information.\n");
@@ -207,6 +278,7 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
             }
 
             buf4_mat_irrep_init_block(X, Hx, rows_per_bucket);
+            if (prefetch) buf4_mat_irrep_init_prefetch(X, Hx, rows_per_bucket);
 
             buf4_mat_irrep_init(Y, Hy);
             buf4_mat_irrep_rd(Y, Hy);
@@ -219,6 +291,10 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                 else
                     buf4_mat_irrep_rd_block(X, Hx, n * rows_per_bucket, rows_left);
 
+                if (prefetch && n + 1 < nbuckets)
+                    buf4_mat_irrep_prefetch_block(X, Hx, (n + 1) * rows_per_bucket,
+                                                  n + 1 < (nbuckets - 1) ? rows_per_bucket : rows_left);
+
                 if (!Xtrans && Ytrans) {
                     nrows = n < (nbuckets - 1) ? rows_per_bucket : rows_left;
                     ncols = Z->params->coltot[Hz ^ GZ];
@@ -243,6 +319,7 @@ int DPD::contract444(dpdbuf4 *X, dpdbuf4 *Y, dpdbuf4 *Z, int target_X, int targe
                 }
             }
 
+            if (prefetch) buf4_mat_irrep_close_prefetch(X, Hx, rows_per_bucket);
             buf4_mat_irrep_close_block(X, Hx, rows_per_bucket);
 
             buf4_mat_irrep_close(Y, Hy);
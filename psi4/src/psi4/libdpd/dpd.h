@@ -33,8 +33,14 @@
 #ifndef _psi_src_lib_libdpd_dpd_h
 #define _psi_src_lib_libdpd_dpd_h
 
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <functional>
+#include <future>
+#include <map>
 #include <string>
+#include <utility>
 #include "psi4/psifiles.h"
 #include "psi4/libpsio/config.h"
 #include "psi4/pragma.h"
@@ -111,6 +117,8 @@ struct dpdbuf4 {
     int **row_offset;
     int **col_offset;
     double ***matrix;
+    dpdbuf4 *sort_source; /* Buffer this one is a sorted view of (see buf4_init_sorted()) */
+    int sort_index;       /* enum indices ordering of the view */
 };
 
 struct dpdtrans4 {
@@ -167,6 +175,14 @@ struct dpd_file4_cache_entry {
     dpd_file4_cache_entry *last; /* pointer to previous cache entry */
 };
 
+/* Reload cost and use of a file4, learned by the cost-aware (COST) cache policy */
+struct dpd_file4_cache_cost {
+    size_t accesses; /* number of file4_init() calls */
+    size_t size;     /* size in double words */
+    double weight;   /* accesses x reload time, fixed once frozen */
+    bool frozen;     /* weight learned and held fixed? */
+};
+
 /* DPD File2 Cache entries */
 struct dpd_file2_cache_entry {
     dpd_file2_cache_entry() : next(nullptr), last(nullptr) {}
@@ -183,6 +199,16 @@ struct dpd_file2_cache_entry {
     dpd_file2_cache_entry *last; /* pointer to previous cache entry */
 };
 
+/* Counters for one operation on one label, kept while DPD profiling is on */
+struct dpd_profile_entry {
+    size_t calls = 0;
+    size_t cache_hits = 0;      /* file4_init() calls served from the cache */
+    double flops = 0.0;         /* floating-point operations in GEMMs */
+    double bytes_read = 0.0;    /* bytes read from disk */
+    double bytes_written = 0.0; /* bytes written to disk */
+    double seconds = 0.0;       /* wall time, including nested operations */
+};
+
 /* DPD global parameter set */
 struct dpd_data {
     int nirreps;
@@ -223,8 +249,8 @@ struct thread_data {
     int Gi;
     int Gj;
     int Gk;
-    int first_ijk;
-    int last_ijk;
+    /* Shared counter of the next (i,j,k) of this irrep triple to be claimed */
+    std::atomic<int> *next_ijk;
     std::string outfile;
     int thr_id;
     dpdfile2 SIA_local;
@@ -245,17 +271,55 @@ struct dpd_gbl {
           file4_cache_most_recent(0),
           file4_cache_least_recent(1),
           file4_cache_lru_del(0),
-          file4_cache_low_del(0) {}
+          file4_cache_low_del(0),
+          file4_cache_cost_del(0),
+          file4_cache_hits(0),
+          file4_cache_misses(0),
+          file4_cache_internal(0),
+          file4_cache_frozen(false),
+          file4_cache_read_bytes(0.0),
+          file4_cache_read_seconds(0.0),
+          profile(false) {}
     dpd_file2_cache_entry *file2_cache;
     dpd_file4_cache_entry *file4_cache;
     size_t file4_cache_most_recent;
     size_t file4_cache_least_recent;
     size_t file4_cache_lru_del;
     size_t file4_cache_low_del;
+    size_t file4_cache_cost_del;
+    size_t file4_cache_hits;            /* file4_init() calls served from the cache */
+    size_t file4_cache_misses;          /* file4_init() calls that read the file4 from disk */
+    int file4_cache_internal;           /* > 0 while the cache opens its own entries */
+    bool file4_cache_frozen;            /* COST weights learned and held fixed? */
+    double file4_cache_read_bytes;      /* bytes read from disk by cache misses */
+    double file4_cache_read_seconds;    /* time spent on those reads */
+    std::map<std::string, dpd_file4_cache_cost> file4_cache_costs;
     int cachetype;
     int *cachefiles;
     int **cachelist;
     dpd_file4_cache_entry *file4_cache_priority;
+    bool profile; /* record per-operation counters? */
+    std::map<std::pair<std::string, std::string>, dpd_profile_entry> profile_ops; /* by (operation, label) */
+};
+
+/* dpd_profile_scope: Times one libdpd operation and, when profiling is on,
+** adds its time and whatever counts the caller accumulated in the public
+** members to the (op, label) entry of dpd_main.profile_ops on destruction.
+*/
+class dpd_profile_scope {
+   public:
+    dpd_profile_scope(const char *op, const char *label);
+    ~dpd_profile_scope();
+    double flops = 0.0;
+    double bytes_read = 0.0;
+    double bytes_written = 0.0;
+    size_t cache_hits = 0;
+
+   private:
+    bool on_;
+    const char *op_;
+    std::string label_;
+    std::chrono::steady_clock::time_point start_;
 };
 
 /* Useful for the generalized 4-index sorting function */
@@ -286,9 +350,76 @@ enum indices {
     sprq
 };
 
+/* One target of buf4_sort_multi(): the ordering, row/column pair types and label */
+struct dpd_sort_target {
+    enum indices index;
+    int pqnum;
+    int rsnum;
+    const char *label;
+};
+
 /* Useful for the 3-index sorting function dpd_3d_sort() */
 enum pattern { abc, acb, cab, cba, bca, bac };
 
+/* Second block of rows for one irrep of a dpdbuf4, filled on a background
+** thread by buf4_mat_irrep_prefetch_block() */
+struct dpd_prefetch {
+    double **block; /* spare block, swapped with the buffer's when consumed */
+    int rows;       /* rows allocated in block */
+    int start_pq;   /* first row being read, -1 if none */
+    int num_pq;     /* number of rows being read */
+    std::future<void> done;
+};
+
+/* Independent row-major GEMMs, in C_DGEMM's conventions, collected so
+** they can be handed to the BLAS in one call by DPD::gemm_batch().  The
+** vectors keep their capacity across clear(), so one batch can be reused
+** for every row of a contraction. */
+struct dpd_gemm_batch {
+    std::vector<char> transa, transb;
+    std::vector<int> m, n, k, lda, ldb, ldc;
+    std::vector<double> alpha, beta;
+    std::vector<double *> A, B, C;
+
+    void add(char ta, char tb, int mm, int nn, int kk, double al, double *a, int la, double *b, int lb, double be,
+             double *c, int lc) {
+        transa.push_back(ta);
+        transb.push_back(tb);
+        m.push_back(mm);
+        n.push_back(nn);
+        k.push_back(kk);
+        alpha.push_back(al);
+        A.push_back(a);
+        lda.push_back(la);
+        B.push_back(b);
+        ldb.push_back(lb);
+        beta.push_back(be);
+        C.push_back(c);
+        ldc.push_back(lc);
+    }
+    size_t size() const { return m.size(); }
+    double flops() const {
+        double f = 0.0;
+        for (size_t i = 0; i < m.size(); i++) f += 2.0 * m[i] * n[i] * k[i];
+        return f;
+    }
+    void clear() {
+        transa.clear();
+        transb.clear();
+        m.clear();
+        n.clear();
+        k.clear();
+        lda.clear();
+        ldb.clear();
+        ldc.clear();
+        alpha.clear();
+        beta.clear();
+        A.clear();
+        B.clear();
+        C.clear();
+    }
+};
+
 class PSI_API DPD {
    public:
     // These used to live in the dpd_data struct
@@ -394,6 +525,14 @@ class PSI_API DPD {
     int buf4_sort(dpdbuf4 *InBuf, int outfilenum, enum indices index, std::string pq, std::string rs,
                   const char *label);
     int buf4_sort_ooc(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum, int rsnum, const char *label);
+    int buf4_sort_multi(dpdbuf4 *InBuf, int outfilenum, const std::vector<dpd_sort_target> &targets);
+    std::vector<int> buf4_sort_sources(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index, int h);
+    void buf4_sort_permute(dpdbuf4 *InBuf, dpdbuf4 *OutBuf, enum indices index, int h, int Gsrc, int start_pq = 0,
+                           int num_pq = -1);
+    int buf4_init_sorted(dpdbuf4 *Buf, dpdbuf4 *Source, enum indices index, int pqnum, int rsnum, const char *label);
+    int buf4_init_sorted(dpdbuf4 *Buf, dpdbuf4 *Source, enum indices index, std::string pq, std::string rs,
+                         const char *label);
+    int buf4_sorted_rd(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq);
     int buf4_sort_axpy(dpdbuf4 *InBuf, int outfilenum, enum indices index, int pqnum, int rsnum, const char *label,
                        double alpha);
     int buf4_axpy(dpdbuf4 *BufX, dpdbuf4 *BufY, double alpha);
@@ -415,6 +554,11 @@ class PSI_API DPD {
     int buf4_mat_irrep_init_block(dpdbuf4 *Buf, int irrep, int num_pq);
     int buf4_mat_irrep_close_block(dpdbuf4 *Buf, int irrep, int num_pq);
     int buf4_mat_irrep_rd_block(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq);
+    void set_prefetch(bool on) { prefetch_ = on; }
+    bool prefetch() const { return prefetch_; }
+    int buf4_mat_irrep_init_prefetch(dpdbuf4 *Buf, int irrep, int num_pq);
+    int buf4_mat_irrep_prefetch_block(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq);
+    int buf4_mat_irrep_close_prefetch(dpdbuf4 *Buf, int irrep, int num_pq);
     int buf4_mat_irrep_wrt_block(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq);
     int buf4_dump(dpdbuf4 *DPDBuf, struct iwlbuf *IWLBuf, int *prel, int *qrel, int *rrel, int *srel, int bk_pack,
                   int swap23);
@@ -448,10 +592,20 @@ class PSI_API DPD {
     dpd_file4_cache_entry *file4_cache_scan(int filenum, int irrep, int pqnum, int rsnum, const char *label,
                                             int dpdnum);
     dpd_file4_cache_entry *file4_cache_last(void);
+    void file4_cache_access(dpdfile4 *File);
     int file4_cache_add(dpdfile4 *File, size_t priority);
     int file4_cache_del(dpdfile4 *File);
     dpd_file4_cache_entry *file4_cache_find_lru(void);
     int file4_cache_del_lru(void);
+    dpd_file4_cache_entry *file4_cache_find_cost(void);
+    int file4_cache_del_cost(void);
+    void file4_cache_freeze(void);
+    void file4_cache_print_stats(std::string out_fname);
+
+    void profile_enable(bool on);
+    void profile_reset(void);
+    void profile_print(std::string out_fname);
+    void profile_json(std::string fname);
     void file4_cache_dirty(dpdfile4 *File);
     void file4_cache_lock(dpdfile4 *File);
     void file4_cache_unlock(dpdfile4 *File);
@@ -484,6 +638,8 @@ class PSI_API DPD {
                           int do_doubles, dpdfile2 *FME, dpdbuf4 *WAmEf, dpdbuf4 *WMnIe, dpdbuf4 *SIjAb, int *occpi,
                           int *occ_off, int *virtpi, int *vir_off, double omega, std::string out_fname, int nthreads,
                           int newtrips);
+    long int cc3_sigma_RHF_ic_memory(dpdbuf4 *CIjAb, dpdbuf4 *WAbEi, dpdbuf4 *WMbIj, dpdbuf4 *Dints, dpdbuf4 *WAmEf,
+                                     dpdbuf4 *WMnIe, dpdbuf4 *SIjAb, int *virtpi, int nthreads);
 
     void cc3_sigma_UHF_AAA(dpdbuf4 *CMNEF, dpdbuf4 *WABEI, dpdbuf4 *WMBIJ, int do_singles, dpdbuf4 *Dints_anti,
                            dpdfile2 *SIA, int do_doubles, dpdfile2 *FME, dpdbuf4 *WMAFE, dpdbuf4 *WMNIE, dpdbuf4 *SIJAB,
@@ -510,6 +666,24 @@ class PSI_API DPD {
                            dpdbuf4 *Sijab, dpdbuf4 *SIjAb, int *aoccpi, int *aocc_off, int *boccpi, int *bocc_off,
                            int *avirtpi, int *avir_off, int *bvirtpi, int *bvir_off, double omega,
                            std::string out_fname);
+
+   private:
+    /* Is prefetching of buf4 row blocks enabled? */
+    bool prefetch_ = false;
+    /* Issue and clear a batch of independent GEMMs */
+    void gemm_batch(dpd_gemm_batch &Batch);
+    /* Threads available to irrep_tasks() */
+    int irrep_task_threads();
+    /* Run independent per-irrep work concurrently, weighted by cost */
+    void irrep_tasks(const std::vector<double> &cost, const std::function<void(int)> &task);
+    /* Shift and row/column offset tables shared by buf4_init() and buf4_init_sorted() */
+    void buf4_init_layout(dpdbuf4 *Buf);
+    /* Spare blocks set up by buf4_mat_irrep_init_prefetch(), by buffer and irrep */
+    std::map<std::pair<dpdbuf4 *, int>, dpd_prefetch> prefetches_;
+    /* Can buf4_mat_irrep_rd_block() of Buf be done from a background thread? */
+    bool buf4_prefetchable(dpdbuf4 *Buf);
+    /* Swap in the prefetched rows, if they are the ones asked for */
+    bool buf4_prefetch_take(dpdbuf4 *Buf, int irrep, int start_pq, int num_pq);
 };  // Dpd class
 
 /*
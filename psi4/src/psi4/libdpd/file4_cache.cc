@@ -33,17 +33,46 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <chrono>
+#include <string>
 #include "psi4/libqt/qt.h"
+#include "psi4/libpsio/psio.h"
 #include "dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 namespace psi {
 
+namespace {
+/* Key of a file4 in the table of learned reload costs */
+std::string file4_cache_cost_key(int dpdnum, int filenum, int irrep, int pqnum, int rsnum, const char *label) {
+    return std::to_string(dpdnum) + ":" + std::to_string(filenum) + ":" + std::to_string(irrep) + ":" +
+           std::to_string(pqnum) + ":" + std::to_string(rsnum) + ":" + label;
+}
+
+/* Current weight of a cost record: how often the file4 is used times the
+** time to bring it back from disk at the bandwidth observed so far. */
+double file4_cache_cost_weight(const dpd_file4_cache_cost &cost) {
+    if (cost.frozen) return cost.weight;
+    double reload = cost.size * sizeof(double);
+    if (dpd_main.file4_cache_read_bytes > 0.0)
+        reload *= dpd_main.file4_cache_read_seconds / dpd_main.file4_cache_read_bytes;
+    return cost.accesses * reload;
+}
+}  // namespace
+
 void DPD::file4_cache_init(void) {
     dpd_main.file4_cache = nullptr;
     dpd_main.file4_cache_most_recent = 0;
     dpd_main.file4_cache_least_recent = 1;
     dpd_main.file4_cache_lru_del = 0;
     dpd_main.file4_cache_low_del = 0;
+    dpd_main.file4_cache_cost_del = 0;
+    dpd_main.file4_cache_hits = 0;
+    dpd_main.file4_cache_misses = 0;
+    dpd_main.file4_cache_internal = 0;
+    dpd_main.file4_cache_frozen = false;
+    dpd_main.file4_cache_read_bytes = 0.0;
+    dpd_main.file4_cache_read_seconds = 0.0;
+    dpd_main.file4_cache_costs.clear();
 }
 
 void DPD::file4_cache_close(void) {
@@ -60,8 +89,10 @@ void DPD::file4_cache_close(void) {
         dpd_set_default(this_entry->dpdnum);
 
         /* Clean out each file4_cache entry */
+        dpd_main.file4_cache_internal++;
         file4_init(&Outfile, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_internal--;
 
         next_entry = this_entry->next;
 
@@ -110,6 +141,24 @@ dpd_file4_cache_entry *DPD::file4_cache_scan(int filenum, int irrep, int pqnum,
     return (this_entry);
 }
 
+/* file4_cache_access(): Records a file4_init() of a cacheable file4 as a
+** hit or a miss.  Initializations made by the cache itself are not counted.
+*/
+void DPD::file4_cache_access(dpdfile4 *File) {
+    if (dpd_main.file4_cache_internal) return;
+
+    if (File->incore) {
+        dpd_main.file4_cache_hits++;
+        dpd_profile_scope prof("file4_cache", File->label);
+        prof.cache_hits = 1;
+    } else
+        dpd_main.file4_cache_misses++;
+
+    dpd_file4_cache_cost &cost = dpd_main.file4_cache_costs[file4_cache_cost_key(
+        File->dpdnum, File->filenum, File->my_irrep, File->params->pqnum, File->params->rsnum, File->label)];
+    if (!cost.frozen) cost.accesses++;
+}
+
 dpd_file4_cache_entry *DPD::file4_cache_last(void) {
     dpd_file4_cache_entry *this_entry;
 
@@ -147,12 +196,21 @@ int DPD::file4_cache_add(dpdfile4 *File, size_t priority) {
         dpd_set_default(File->dpdnum);
 
         /* Read all data into core */
+        auto read_start = std::chrono::steady_clock::now();
         this_entry->size = 0;
         for (h = 0; h < File->params->nirreps; h++) {
             this_entry->size += File->params->rowtot[h] * File->params->coltot[h ^ (File->my_irrep)];
             file4_mat_irrep_init(File, h);
             file4_mat_irrep_rd(File, h);
         }
+        double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - read_start).count();
+
+        /* Track the disk bandwidth and file4 size for the cost-aware policy */
+        dpd_main.file4_cache_read_bytes += this_entry->size * sizeof(double);
+        dpd_main.file4_cache_read_seconds += read_seconds;
+        dpd_main.file4_cache_costs[file4_cache_cost_key(File->dpdnum, File->filenum, File->my_irrep,
+                                                        File->params->pqnum, File->params->rsnum, File->label)]
+            .size = this_entry->size;
 
         this_entry->dpdnum = File->dpdnum;
         this_entry->filenum = File->filenum;
@@ -219,12 +277,18 @@ int DPD::file4_cache_del(dpdfile4 *File) {
 
         File->incore = 0;
 
+        /* The owner may have closed the file between uses; reopen it just long enough to flush */
+        int reopen = !(this_entry->clean) && !psio_open_check(File->filenum);
+        if (reopen) psio_open(File->filenum, PSIO_OPEN_OLD);
+
         /* Write all the data to disk and free the memory */
         for (h = 0; h < File->params->nirreps; h++) {
             if (!(this_entry->clean)) file4_mat_irrep_wrt(File, h);
             file4_mat_irrep_close(File, h);
         }
 
+        if (reopen) psio_close(File->filenum, 1);
+
         next_entry = this_entry->next;
         last_entry = this_entry->last;
 
@@ -269,6 +333,8 @@ void DPD::file4_cache_print_screen(void) {
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
     outfile->Printf("#LRU deletions = %6d; #Low-priority deletions = %6d\n", dpd_main.file4_cache_lru_del,
                     dpd_main.file4_cache_low_del);
+    outfile->Printf("#Cost deletions = %6zu; #Hits = %8zu; #Misses = %8zu\n", dpd_main.file4_cache_cost_del,
+                    dpd_main.file4_cache_hits, dpd_main.file4_cache_misses);
     outfile->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     outfile->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     outfile->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -301,6 +367,8 @@ void DPD::file4_cache_print(std::string out) {
                     dpd_main.file4_cache_most_recent, dpd_main.file4_cache_least_recent);
     printer->Printf("#LRU deletions = %6d; #Low-priority deletions = %6d\n", dpd_main.file4_cache_lru_del,
                     dpd_main.file4_cache_low_del);
+    printer->Printf("#Cost deletions = %6zu; #Hits = %8zu; #Misses = %8zu\n", dpd_main.file4_cache_cost_del,
+                    dpd_main.file4_cache_hits, dpd_main.file4_cache_misses);
     printer->Printf("Core max size:  %9.1f kB\n", (dpd_main.memory) * sizeof(double) / 1e3);
     printer->Printf("Core used:      %9.1f kB\n", (dpd_main.memused) * sizeof(double) / 1e3);
     printer->Printf("Core available: %9.1f kB\n", dpd_memfree() * sizeof(double) / 1e3);
@@ -372,8 +440,10 @@ int DPD::file4_cache_del_lru(void) {
         dpdnum = dpd_default;
         dpd_set_default(this_entry->dpdnum);
 
+        dpd_main.file4_cache_internal++;
         file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_internal--;
 
         file4_cache_del(&File);
         file4_close(&File);
@@ -476,8 +546,10 @@ int DPD::file4_cache_del_low(void) {
 
         dpd_set_default(this_entry->dpdnum);
 
+        dpd_main.file4_cache_internal++;
         file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
                    this_entry->label);
+        dpd_main.file4_cache_internal--;
         file4_cache_del(&File);
         file4_close(&File);
 
@@ -492,6 +564,112 @@ int DPD::file4_cache_del_low(void) {
     }
 }
 
+/* file4_cache_find_cost(): Finds the unlocked entry that is cheapest to
+** lose, i.e., the one with the smallest product of access count and reload
+** time (size over the observed disk bandwidth).  Ties go to the least
+** recently used entry.
+*/
+dpd_file4_cache_entry *DPD::file4_cache_find_cost(void) {
+    dpd_file4_cache_entry *this_entry, *low_entry;
+    double weight, low_weight = 0.0;
+
+    low_entry = nullptr;
+    for (this_entry = dpd_main.file4_cache; this_entry != nullptr; this_entry = this_entry->next) {
+        if (this_entry->lock) continue;
+
+        auto cost = dpd_main.file4_cache_costs.find(file4_cache_cost_key(
+            this_entry->dpdnum, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
+            this_entry->label));
+        weight = (cost == dpd_main.file4_cache_costs.end()) ? 0.0 : file4_cache_cost_weight(cost->second);
+
+        if (low_entry == nullptr || weight < low_weight ||
+            (weight == low_weight && this_entry->access < low_entry->access)) {
+            low_entry = this_entry;
+            low_weight = weight;
+        }
+    }
+
+    return low_entry;
+}
+
+int DPD::file4_cache_del_cost(void) {
+    int dpdnum;
+    dpdfile4 File;
+    dpd_file4_cache_entry *this_entry;
+
+#ifdef DPD_TIMER
+    timer_on("cache_cost");
+#endif
+
+    this_entry = file4_cache_find_cost();
+
+    if (this_entry == nullptr) {
+#ifdef DPD_TIMER
+        timer_off("cache_cost");
+#endif
+        return 1; /* there is no cache or everything is locked */
+    }
+
+#ifdef DPD_DEBUG
+    printf("Delete COST: %-22s %3d %2d %2d %6d %1d %6d %8.1f\n", this_entry->label, this_entry->filenum,
+           this_entry->pqnum, this_entry->rsnum, this_entry->usage, this_entry->clean, this_entry->priority,
+           (this_entry->size * sizeof(double)) / 1e3);
+#endif
+
+    /* increment the global COST deletion counter */
+    dpd_main.file4_cache_cost_del++;
+
+    /* save the current dpd default value */
+    dpdnum = dpd_default;
+    dpd_set_default(this_entry->dpdnum);
+
+    dpd_main.file4_cache_internal++;
+    file4_init(&File, this_entry->filenum, this_entry->irrep, this_entry->pqnum, this_entry->rsnum,
+               this_entry->label);
+    dpd_main.file4_cache_internal--;
+    file4_cache_del(&File);
+    file4_close(&File);
+
+    /* return the default dpd to its original value */
+    dpd_set_default(dpdnum);
+
+#ifdef DPD_TIMER
+    timer_off("cache_cost");
+#endif
+
+    return 0;
+}
+
+/* file4_cache_freeze(): Fixes the weights learned so far by the cost-aware
+** policy.  Called by the CC codes after their first iteration, which touches
+** every intermediate in the same pattern as the rest; file4s seen for the
+** first time afterwards keep learning.
+*/
+void DPD::file4_cache_freeze(void) {
+    if (dpd_main.file4_cache_frozen) return;
+
+    for (auto &cost : dpd_main.file4_cache_costs) {
+        cost.second.weight = file4_cache_cost_weight(cost.second);
+        cost.second.frozen = true;
+    }
+
+    dpd_main.file4_cache_frozen = true;
+}
+
+void DPD::file4_cache_print_stats(std::string out) {
+    std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    size_t total = dpd_main.file4_cache_hits + dpd_main.file4_cache_misses;
+
+    printer->Printf("\n\tDPD File4 Cache Statistics:\n");
+    printer->Printf("\tHits            = %10zu (%5.1f%%)\n", dpd_main.file4_cache_hits,
+                    total ? 100.0 * dpd_main.file4_cache_hits / total : 0.0);
+    printer->Printf("\tMisses          = %10zu\n", dpd_main.file4_cache_misses);
+    printer->Printf("\tRead from disk  = %10.1f MiB in %.2f s\n", dpd_main.file4_cache_read_bytes / 1048576.0,
+                    dpd_main.file4_cache_read_seconds);
+    printer->Printf("\tDeletions       =  LRU %zu; LOW %zu; COST %zu\n", dpd_main.file4_cache_lru_del,
+                    dpd_main.file4_cache_low_del, dpd_main.file4_cache_cost_del);
+}
+
 void DPD::file4_cache_lock(dpdfile4 *File) {
     int h;
     dpd_file4_cache_entry *this_entry;
@@ -110,6 +110,9 @@ int DPD::file4_init(dpdfile4 *File, int filenum, int irrep, int pqnum, int rsnum
         else
             priority = 0;
 
+        /* Count the access for the cache statistics and the cost-aware policy */
+        file4_cache_access(File);
+
         file4_cache_add(File, priority);
 
         /* Make sure this cache entry can't be deleted until we're done */
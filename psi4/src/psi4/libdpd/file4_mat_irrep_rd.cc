@@ -44,6 +44,8 @@ int DPD::file4_mat_irrep_rd(dpdfile4 *File, int irrep) {
 
     if (File->incore) return 0; /* We already have this data in core */
 
+    dpd_profile_scope prof("file4_rd", File->label);
+
     /* If the data doesn't actually exist on disk, we just leave */
     if (psio_tocscan(File->filenum, File->label) == nullptr) return 1;
 
@@ -57,9 +59,11 @@ int DPD::file4_mat_irrep_rd(dpdfile4 *File, int irrep) {
     coltot = File->params->coltot[irrep ^ my_irrep];
     size = ((long)rowtot) * ((long)coltot);
 
-    if (rowtot && coltot)
+    if (rowtot && coltot) {
         psio_read(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
                   &next_address);
+        prof.bytes_read += size * ((long)sizeof(double));
+    }
 
 #ifdef DPD_TIMER
     timer_off("file4_rd");
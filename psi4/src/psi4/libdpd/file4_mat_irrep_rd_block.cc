@@ -46,6 +46,8 @@ int DPD::file4_mat_irrep_rd_block(dpdfile4 *File, int irrep, int start_pq, int n
     my_irrep = File->my_irrep;
     if (File->incore) return 0; /* We already have this data in core */
 
+    dpd_profile_scope prof("file4_rd", File->label);
+
     irrep_ptr = File->lfiles[irrep];
     rowtot = num_pq;
     coltot = File->params->coltot[irrep ^ my_irrep];
@@ -64,9 +66,11 @@ int DPD::file4_mat_irrep_rd_block(dpdfile4 *File, int irrep, int start_pq, int n
         irrep_ptr = psio_get_address(irrep_ptr, start_pq * coltot * sizeof(double));
     }
 
-    if (rowtot && coltot)
+    if (rowtot && coltot) {
         psio_read(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
                   &next_address);
+        prof.bytes_read += size * ((long)sizeof(double));
+    }
 
     return 0;
 }
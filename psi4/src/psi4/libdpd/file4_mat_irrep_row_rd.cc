@@ -44,6 +44,8 @@ int DPD::file4_mat_irrep_row_rd(dpdfile4 *File, int irrep, int row) {
 
     if (File->incore) return 0; /* We already have this data in core */
 
+    dpd_profile_scope prof("file4_rd", File->label);
+
 #ifdef DPD_TIMER
     timer_on("f4_rowrd");
 #endif
@@ -65,9 +67,11 @@ int DPD::file4_mat_irrep_row_rd(dpdfile4 *File, int irrep, int row) {
         row_ptr = psio_get_address(row_ptr, row * coltot * sizeof(double));
     }
 
-    if (coltot)
+    if (coltot) {
         psio_read(File->filenum, File->label, (char *)File->matrix[irrep][0], coltot * sizeof(double), row_ptr,
                   &next_address);
+        prof.bytes_read += coltot * sizeof(double);
+    }
 
 #ifdef DPD_TIMER
     timer_off("f4_rowrd");
@@ -46,6 +46,8 @@ int DPD::file4_mat_irrep_row_wrt(dpdfile4 *File, int irrep, int row) {
         return 0;                /* We're keeping the data in core */
     }
 
+    dpd_profile_scope prof("file4_wrt", File->label);
+
     my_irrep = File->my_irrep;
 
     row_ptr = File->lfiles[irrep];
@@ -63,9 +65,11 @@ int DPD::file4_mat_irrep_row_wrt(dpdfile4 *File, int irrep, int row) {
         row_ptr = psio_get_address(row_ptr, row * coltot * sizeof(double));
     }
 
-    if (coltot)
+    if (coltot) {
         psio_write(File->filenum, File->label, (char *)File->matrix[irrep][0], coltot * sizeof(double), row_ptr,
                    &next_address);
+        prof.bytes_written += coltot * sizeof(double);
+    }
 
     return 0;
 }
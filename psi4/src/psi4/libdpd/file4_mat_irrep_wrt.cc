@@ -45,15 +45,19 @@ int DPD::file4_mat_irrep_wrt(dpdfile4 *File, int irrep) {
         return 0;                /* We're keeping this data in core */
     }
 
+    dpd_profile_scope prof("file4_wrt", File->label);
+
     my_irrep = File->my_irrep;
     irrep_ptr = File->lfiles[irrep];
     rowtot = File->params->rowtot[irrep];
     coltot = File->params->coltot[irrep ^ my_irrep];
     size = ((long)rowtot) * ((long)coltot);
 
-    if (rowtot && coltot)
+    if (rowtot && coltot) {
         psio_write(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
                    &next_address);
+        prof.bytes_written += size * ((long)sizeof(double));
+    }
 
     return 0;
 }
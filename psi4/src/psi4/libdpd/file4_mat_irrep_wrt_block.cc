@@ -49,6 +49,8 @@ int DPD::file4_mat_irrep_wrt_block(dpdfile4 *File, int irrep, int start_pq, int
         return 0;                /* We're keeping this data in core */
     }
 
+    dpd_profile_scope prof("file4_wrt", File->label);
+
     my_irrep = File->my_irrep;
     irrep_ptr = File->lfiles[irrep];
     rowtot = num_pq;
@@ -67,9 +69,11 @@ int DPD::file4_mat_irrep_wrt_block(dpdfile4 *File, int irrep, int start_pq, int
         irrep_ptr = psio_get_address(irrep_ptr, start_pq * coltot * sizeof(double));
     }
 
-    if (rowtot && coltot)
+    if (rowtot && coltot) {
         psio_write(File->filenum, File->label, (char *)File->matrix[irrep][0], size * ((long)sizeof(double)), irrep_ptr,
                    &next_address);
+        prof.bytes_written += size * ((long)sizeof(double));
+    }
 
     return 0;
 }
@@ -0,0 +1,54 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Batched dispatch of independent GEMMs
+*/
+#include "psi4/libqt/qt.h"
+#include "dpd.h"
+
+namespace psi {
+
+/* dpd_gemm_batch(): Issues all the GEMMs collected in Batch as one
+** C_DGEMM_BATCH() and clears it, so the many small products of a
+** row-by-row contraction of a symmetric molecule cost one BLAS call (with
+** MKL) rather than one per irrep.  GEMMs with an empty dimension are
+** dropped, as C_DGEMM() would.
+*/
+void DPD::gemm_batch(dpd_gemm_batch &Batch) {
+    size_t nbatch = Batch.size();
+    if (!nbatch) return;
+
+    C_DGEMM_BATCH(nbatch, Batch.transa.data(), Batch.transb.data(), Batch.m.data(), Batch.n.data(), Batch.k.data(),
+                  Batch.alpha.data(), Batch.A.data(), Batch.lda.data(), Batch.B.data(), Batch.ldb.data(),
+                  Batch.beta.data(), Batch.C.data(), Batch.ldc.data());
+    Batch.clear();
+}
+
+}  // namespace psi
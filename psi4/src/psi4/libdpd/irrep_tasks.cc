@@ -0,0 +1,88 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Concurrent execution of independent per-irrep work
+*/
+#include <algorithm>
+#include <cmath>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "psi4/libqt/blas_backend.h"
+#include "dpd.h"
+
+namespace psi {
+
+/* dpd_irrep_task_threads(): The number of threads the irreps of a
+** contraction may be spread over: the OpenMP thread count, or 1 when
+** called from inside a parallel region.
+*/
+int DPD::irrep_task_threads() {
+#ifdef _OPENMP
+    if (!omp_in_parallel()) return omp_get_max_threads();
+#endif
+    return 1;
+}
+
+/* dpd_irrep_tasks(): Runs task(h) for every h with cost[h] > 0.  With more
+** than one thread the tasks run concurrently, largest first, and each
+** one's BLAS calls get a share of the threads proportional to its
+** cost, so that one large block is not starved by several small ones and
+** small blocks don't pay for a full team.  The tasks must touch disjoint
+** data and must not do any I/O.
+*/
+void DPD::irrep_tasks(const std::vector<double> &cost, const std::function<void(int)> &task) {
+    std::vector<int> order;
+    double total = 0.0;
+    for (int h = 0; h < (int)cost.size(); h++) {
+        if (cost[h] <= 0.0) continue;
+        order.push_back(h);
+        total += cost[h];
+    }
+
+    int nthreads = irrep_task_threads();
+    if (nthreads < 2 || order.size() < 2) {
+        for (int h : order) task(h);
+        return;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+    int nteam = std::min(nthreads, (int)order.size());
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nteam)
+    for (int k = 0; k < (int)order.size(); k++) {
+        int h = order[k];
+        int nblas = std::max(1, (int)std::lround(nthreads * cost[h] / total));
+        blas::ThreadScope blas_threads(nblas, "DPD irrep tasks");
+        task(h);
+    }
+}
+
+}  // namespace psi
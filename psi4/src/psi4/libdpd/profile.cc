@@ -0,0 +1,157 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*! \file
+    \ingroup DPD
+    \brief Per-operation FLOP, disk-traffic, cache and timing counters
+*/
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "dpd.h"
+
+namespace psi {
+
+namespace {
+/* Operations may finish on a prefetch or irrep-task thread */
+std::mutex profile_mutex;
+
+std::string json_escape(const std::string &s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+}  // namespace
+
+dpd_profile_scope::dpd_profile_scope(const char *op, const char *label) : on_(dpd_main.profile), op_(op) {
+    if (!on_) return;
+    label_ = label;
+    start_ = std::chrono::steady_clock::now();
+}
+
+dpd_profile_scope::~dpd_profile_scope() {
+    if (!on_) return;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    dpd_profile_entry &entry = dpd_main.profile_ops[std::make_pair(std::string(op_), label_)];
+    entry.calls++;
+    entry.cache_hits += cache_hits;
+    entry.flops += flops;
+    entry.bytes_read += bytes_read;
+    entry.bytes_written += bytes_written;
+    entry.seconds += seconds;
+}
+
+/* profile_enable(): Turns the per-operation counters of contract444(),
+** contract424(), contract244(), contract222(), buf4_sort(),
+** buf4_mat_irrep_rd/wrt(), the file4 disk reads and writes, and file4 cache
+** hits on or off.  Counters are shared by all DPD instances.
+*/
+void DPD::profile_enable(bool on) { dpd_main.profile = on; }
+
+void DPD::profile_reset(void) {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    dpd_main.profile_ops.clear();
+}
+
+/* profile_print(): Prints the counters gathered so far, heaviest operation
+** first, followed by totals per operation.  Times are inclusive, so a
+** contraction's time covers the buf4 reads and writes it made.
+*/
+void DPD::profile_print(std::string out) {
+    std::shared_ptr<psi::PsiOutStream> printer = (out == "outfile" ? outfile : std::make_shared<PsiOutStream>(out));
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    if (dpd_main.profile_ops.empty()) return;
+
+    typedef std::pair<std::pair<std::string, std::string>, dpd_profile_entry> op_entry;
+    std::vector<op_entry> ops(dpd_main.profile_ops.begin(), dpd_main.profile_ops.end());
+    std::sort(ops.begin(), ops.end(),
+              [](const op_entry &a, const op_entry &b) { return a.second.seconds > b.second.seconds; });
+
+    std::map<std::string, dpd_profile_entry> totals;
+    for (const auto &op : ops) {
+        dpd_profile_entry &t = totals[op.first.first];
+        t.calls += op.second.calls;
+        t.cache_hits += op.second.cache_hits;
+        t.flops += op.second.flops;
+        t.bytes_read += op.second.bytes_read;
+        t.bytes_written += op.second.bytes_written;
+        t.seconds += op.second.seconds;
+    }
+
+    printer->Printf("\n\tDPD Operation Profile:\n");
+    printer->Printf("\t%-12s %-24s %9s %10s %10s %10s %8s %10s %8s\n", "Operation", "Label", "Calls", "GFLOP",
+                    "Read MiB", "Wrote MiB", "Hits", "Seconds", "GFLOP/s");
+    for (const auto &op : ops) {
+        const dpd_profile_entry &e = op.second;
+        printer->Printf("\t%-12s %-24s %9zu %10.3f %10.1f %10.1f %8zu %10.3f %8.2f\n", op.first.first.c_str(),
+                        op.first.second.c_str(), e.calls, e.flops / 1.0e9, e.bytes_read / 1048576.0,
+                        e.bytes_written / 1048576.0, e.cache_hits, e.seconds,
+                        e.seconds > 0.0 ? e.flops / 1.0e9 / e.seconds : 0.0);
+    }
+    printer->Printf("\n\t%-12s %-24s %9s %10s %10s %10s %8s %10s %8s\n", "Totals", "", "Calls", "GFLOP", "Read MiB",
+                    "Wrote MiB", "Hits", "Seconds", "GFLOP/s");
+    for (const auto &t : totals) {
+        const dpd_profile_entry &e = t.second;
+        printer->Printf("\t%-12s %-24s %9zu %10.3f %10.1f %10.1f %8zu %10.3f %8.2f\n", t.first.c_str(), "", e.calls,
+                        e.flops / 1.0e9, e.bytes_read / 1048576.0, e.bytes_written / 1048576.0, e.cache_hits,
+                        e.seconds, e.seconds > 0.0 ? e.flops / 1.0e9 / e.seconds : 0.0);
+    }
+}
+
+/* profile_json(): Writes the counters to fname as a JSON array of
+** {op, label, calls, flops, bytes_read, bytes_written, cache_hits, seconds}
+** records, for comparing runs with different CACHELEVEL or MEMORY settings.
+*/
+void DPD::profile_json(std::string fname) {
+    std::lock_guard<std::mutex> lock(profile_mutex);
+    std::ofstream json(fname);
+    if (!json) throw PsiException("DPD: cannot write profile to " + fname, __FILE__, __LINE__);
+
+    json.precision(12);
+    json << "[\n";
+    size_t n = 0;
+    for (const auto &op : dpd_main.profile_ops) {
+        const dpd_profile_entry &e = op.second;
+        json << "  {\"op\": \"" << json_escape(op.first.first) << "\", \"label\": \"" << json_escape(op.first.second)
+             << "\", \"calls\": " << e.calls << ", \"flops\": " << e.flops << ", \"bytes_read\": " << e.bytes_read
+             << ", \"bytes_written\": " << e.bytes_written << ", \"cache_hits\": " << e.cache_hits
+             << ", \"seconds\": " << e.seconds << "}" << (++n < dpd_main.profile_ops.size() ? ",\n" : "\n");
+    }
+    json << "]\n";
+}
+
+}  // namespace psi
@@ -56,6 +56,8 @@ namespace psi {
 CDJK::CDJK(std::shared_ptr<BasisSet> primary, double cholesky_tolerance):
     DiskDFJK(primary,primary), cholesky_tolerance_(cholesky_tolerance)
 {
+    // The Cholesky vectors have no (Q|w|mn) counterpart to fuse with
+    fused_wK_ = false;
 }
 CDJK::~CDJK()
 {
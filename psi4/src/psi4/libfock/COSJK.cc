@@ -0,0 +1,304 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/points.h"
+
+#include "jk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include "psi4/libpsi4util/PsiOutStream.h"
+#ifdef _OPENMP
+#include <omp.h>
+#include "psi4/libpsi4util/process.h"
+#endif
+
+using namespace psi;
+
+namespace psi {
+
+COSJK::COSJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options)
+    : JK(primary), options_(options), auxiliary_(auxiliary) {
+    common_init();
+}
+COSJK::~COSJK() {}
+void COSJK::common_init() {
+    dfh_ = std::make_shared<DFHelper>(primary_, auxiliary_);
+    condition_ = 1.0E-12;
+
+    spherical_points_ = options_.get_int("COSX_SPHERICAL_POINTS");
+    radial_points_ = options_.get_int("COSX_RADIAL_POINTS");
+    kcutoff_ = options_.get_double("COSX_INTS_TOLERANCE");
+}
+void COSJK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> COSJK: Density-Fitted J, Seminumerical K <==\n\n");
+
+        outfile->Printf("    J tasked:           %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:           %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:          %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
+        outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
+        outfile->Printf("    Fitting Condition:  %11.0E\n", condition_);
+        outfile->Printf("    K Grid (rad, sph):  %5d, %5d\n", radial_points_, spherical_points_);
+        if (grid_) outfile->Printf("    K Grid Points:      %11zu\n", (size_t)grid_->npoints());
+        outfile->Printf("    K Pair Cutoff:      %11.0E\n\n", kcutoff_);
+
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+int COSJK::max_nocc() const {
+    int max_nocc = 0;
+    for (size_t N = 0; N < C_left_ao_.size(); N++) {
+        max_nocc = (C_left_ao_[N]->colspi()[0] > max_nocc ? C_left_ao_[N]->colspi()[0] : max_nocc);
+    }
+    return max_nocc;
+}
+void COSJK::preiterations() {
+    if (do_wK_) throw PSIEXCEPTION("COSJK does not yet support wK builds.");
+
+    // => DF J <= //
+
+    if (!auxiliary_->has_puream()) {
+        throw PSIEXCEPTION("COSJK: Cannot do cartesian auxiliary functions, use SCF_TYPE DISK_DF instead.");
+    }
+    dfh_->set_nthreads(omp_nthread_);
+    dfh_->set_schwarz_cutoff(cutoff_);
+    dfh_->set_method("STORE");
+    dfh_->set_fitting_condition(condition_);
+    dfh_->set_memory(memory_ - memory_overhead());
+    dfh_->initialize();
+
+    // => Seminumerical K <= //
+
+    build_grid();
+
+    sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    point_workers_.clear();
+    potential_ints_.clear();
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        point_workers_.push_back(
+            std::make_shared<BasisFunctions>(primary_, grid_->max_points(), grid_->max_functions()));
+
+        // PotentialInt adds -Z/|r - C|, so a charge of -1 gives the bare 1/|r - g|
+        auto potential = std::shared_ptr<PotentialInt>(static_cast<PotentialInt*>(factory->ao_potential()));
+        auto Zxyz = std::make_shared<Matrix>("Grid Point Charge (Z,x,y,z)", 1, 4);
+        Zxyz->set(0, 0, -1.0);
+        potential->set_charge_field(Zxyz);
+        potential_ints_.push_back(potential);
+    }
+}
+void COSJK::build_grid() {
+    std::map<std::string, int> opt_int_map;
+    opt_int_map["DFT_SPHERICAL_POINTS"] = spherical_points_;
+    opt_int_map["DFT_RADIAL_POINTS"] = radial_points_;
+    std::map<std::string, std::string> opt_map;
+    grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, opt_int_map, opt_map, options_);
+}
+void COSJK::compute_JK() {
+    if (do_J_) {
+        dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, max_nocc(), true, false, false, lr_symmetric_);
+    }
+    if (do_K_) {
+        build_K(D_ao_, K_ao_);
+        // The quadrature breaks the m <-> n symmetry of K slightly
+        if (lr_symmetric_) {
+            for (size_t ind = 0; ind < K_ao_.size(); ind++) K_ao_[ind]->hermitivitize();
+        }
+    }
+}
+void COSJK::postiterations() {
+    grid_.reset();
+    sieve_.reset();
+    point_workers_.clear();
+    potential_ints_.clear();
+}
+void COSJK::build_K(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K) {
+    // => Sizing <= //
+
+    int nbf = primary_->nbf();
+    int nshell = primary_->nshell();
+    size_t nD = D.size();
+    int max_points = grid_->max_points();
+    int max_functions = grid_->max_functions();
+    const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+    const std::vector<std::pair<int, int> >& shell_pairs = sieve_->shell_pairs();
+
+    // Schwarz-like estimate of the size of each shell pair's potential integrals
+    std::vector<double> pair_values = sieve_->shell_pair_values();
+    for (size_t MN = 0; MN < pair_values.size(); MN++) pair_values[MN] = std::sqrt(std::fabs(pair_values[MN]));
+
+    // => Thread Buffers <= //
+
+    std::vector<std::vector<SharedMatrix> > KT(omp_nthread_);
+    std::vector<std::vector<SharedMatrix> > FT(omp_nthread_);
+    std::vector<std::vector<SharedMatrix> > GT(omp_nthread_);
+    std::vector<SharedMatrix> DlocT(omp_nthread_);
+    std::vector<SharedMatrix> wphiT(omp_nthread_);
+    std::vector<std::vector<double> > FmaxT(omp_nthread_, std::vector<double>(nshell));
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        for (size_t ind = 0; ind < nD; ind++) {
+            KT[thread].push_back(std::make_shared<Matrix>("KT", nbf, nbf));
+            FT[thread].push_back(std::make_shared<Matrix>("FT", max_points, nbf));
+            GT[thread].push_back(std::make_shared<Matrix>("GT", max_points, nbf));
+        }
+        DlocT[thread] = std::make_shared<Matrix>("DlocT", max_functions, nbf);
+        wphiT[thread] = std::make_shared<Matrix>("wphiT", max_points, max_functions);
+    }
+
+    // ==> Master Block Loop <== //
+
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        if (nlocal == 0) continue;
+
+        double* x = block->x();
+        double* y = block->y();
+        double* z = block->z();
+        double* w = block->w();
+
+        // => Basis Functions <= //
+
+        point_workers_[rank]->compute_functions(block);
+        double** phip = point_workers_[rank]->basis_value("PHI")->pointer();
+        size_t coll_funcs = point_workers_[rank]->basis_value("PHI")->ncol();
+
+        double** wphip = wphiT[rank]->pointer();
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                wphip[P][ml] = w[P] * phip[P][ml];
+            }
+        }
+
+        // => F_gs = phi_gl D_ls <= //
+
+        double** Dlocp = DlocT[rank]->pointer();
+        std::vector<double>& Fmax = FmaxT[rank];
+        std::fill(Fmax.begin(), Fmax.end(), 0.0);
+        for (size_t ind = 0; ind < nD; ind++) {
+            double** Dp = D[ind]->pointer();
+            double** Fp = FT[rank][ind]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                ::memcpy((void*)Dlocp[ml], (void*)Dp[function_map[ml]], nbf * sizeof(double));
+            }
+            C_DGEMM('N', 'N', npoints, nbf, nlocal, 1.0, phip[0], coll_funcs, Dlocp[0], nbf, 0.0, Fp[0], nbf);
+
+            for (int P = 0; P < npoints; P++) {
+                for (int s = 0; s < nbf; s++) {
+                    int S = primary_->function_to_shell(s);
+                    Fmax[S] = std::max(Fmax[S], std::fabs(Fp[P][s]));
+                }
+            }
+            GT[rank][ind]->zero();
+        }
+
+        // => G_gn = A_ns(g) F_gs <= //
+
+        std::shared_ptr<PotentialInt> ints = potential_ints_[rank];
+        double** Zxyzp = ints->charge_field()->pointer();
+        const double* buffer = ints->buffer();
+        for (size_t MN = 0; MN < shell_pairs.size(); MN++) {
+            int M = shell_pairs[MN].first;
+            int N = shell_pairs[MN].second;
+            if (pair_values[M * nshell + N] * std::max(Fmax[M], Fmax[N]) < kcutoff_) continue;
+
+            int nM = primary_->shell(M).nfunction();
+            int nN = primary_->shell(N).nfunction();
+            int oM = primary_->shell(M).function_index();
+            int oN = primary_->shell(N).function_index();
+
+            for (int P = 0; P < npoints; P++) {
+                Zxyzp[0][1] = x[P];
+                Zxyzp[0][2] = y[P];
+                Zxyzp[0][3] = z[P];
+                ints->compute_shell(M, N);
+
+                for (size_t ind = 0; ind < nD; ind++) {
+                    double* Fp = FT[rank][ind]->pointer()[P];
+                    double* Gp = GT[rank][ind]->pointer()[P];
+                    for (int m = 0; m < nM; m++) {
+                        for (int n = 0; n < nN; n++) {
+                            double A = buffer[m * nN + n];
+                            Gp[m + oM] += A * Fp[n + oN];
+                            if (M != N) Gp[n + oN] += A * Fp[m + oM];
+                        }
+                    }
+                }
+            }
+        }
+
+        // => K_mn += w_g phi_gm G_gn <= //
+
+        for (size_t ind = 0; ind < nD; ind++) {
+            double** Gp = GT[rank][ind]->pointer();
+            double** Kp = KT[rank][ind]->pointer();
+            // Dloc is free again, reuse it for the local rows of K
+            C_DGEMM('T', 'N', nlocal, nbf, npoints, 1.0, wphip[0], max_functions, Gp[0], nbf, 0.0, Dlocp[0], nbf);
+            for (int ml = 0; ml < nlocal; ml++) {
+                C_DAXPY(nbf, 1.0, Dlocp[ml], 1, Kp[function_map[ml]], 1);
+            }
+        }
+    }
+
+    // => Reduction <= //
+
+    for (size_t ind = 0; ind < nD; ind++) {
+        K[ind]->zero();
+        for (int thread = 0; thread < omp_nthread_; thread++) {
+            K[ind]->add(KT[thread][ind]);
+        }
+    }
+}
+
+}  // namespace psi
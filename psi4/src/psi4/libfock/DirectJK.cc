@@ -35,6 +35,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/psifiles.h"
 #include "psi4/libmints/sieve.h"
+#include "psi4/libmints/blocksparse.h"
 #include "psi4/libiwl/iwl.hpp"
 #include "jk.h"
 //#include "jk_independent.h"
@@ -47,9 +48,13 @@
 #include "psi4/libmints/twobody.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/lib3index/cholesky.h"
+#include "psi4/libfock/cfmm.h"
 
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/libpsi4util.h"
 #ifdef _OPENMP
 #include <omp.h>
 #include "psi4/libpsi4util/process.h"
@@ -72,6 +77,26 @@ void DirectJK::common_init()
     #ifdef _OPENMP
         df_ints_num_threads_ = Process::environment.get_n_threads();
     #endif
+
+    density_screening_ = false;
+    density_cutoff_ = 0.0;
+    nbuild_ = 0L;
+    quartets_computed_ = 0L;
+    quartets_density_skipped_ = 0L;
+    quartets_schwarz_skipped_ = 0L;
+
+    incfock_ = false;
+    incfock_full_fock_every_ = 100;
+    incfock_count_ = 0;
+    do_incfock_iter_ = false;
+    incfock_delta_max_ = 0.0;
+    incfock_omega_ = 0.0;
+
+    cfmm_ = false;
+    cfmm_order_ = 8;
+
+    task_rank_ = 0;
+    task_nrank_ = 1;
 }
 void DirectJK::print_header() const
 {
@@ -84,16 +109,159 @@ void DirectJK::print_header() const
         if (do_wK_)
             outfile->Printf( "    Omega:             %11.3E\n", omega_);
         outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
+        if (task_nrank_ > 1)
+            outfile->Printf( "    MPI ranks:         %11d\n", task_nrank_);
         //outfile->Printf( "    Memory [MiB]:      %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf( "    Incremental Fock:  %11s\n", (incfock_ ? "Yes" : "No"));
+        if (incfock_)
+            outfile->Printf( "    Full Fock every:   %11d\n", incfock_full_fock_every_);
+        outfile->Printf( "    Density Screening: %11s\n", (density_screening_ ? "Yes" : "No"));
+        if (density_screening_ || incfock_)
+            outfile->Printf( "    Density Cutoff:    %11.0E\n", (density_cutoff_ > 0.0 ? density_cutoff_ : cutoff_));
+        outfile->Printf( "    CFMM J:            %11s\n", (cfmm_ ? "Yes" : "No"));
+        if (cfmm_)
+            outfile->Printf( "    CFMM Order:        %11d\n", cfmm_order_);
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n\n", cutoff_);
+
+        if (nbuild_) {
+            size_t total = quartets_computed_ + quartets_density_skipped_ + quartets_schwarz_skipped_;
+            outfile->Printf( "    => Screening Statistics (%zu builds) <=\n\n", nbuild_);
+            outfile->Printf( "    Quartets computed: %20zu (%6.2f%%)\n", quartets_computed_,
+                             100.0 * quartets_computed_ / (double) total);
+            outfile->Printf( "    Skipped (Schwarz): %20zu (%6.2f%%)\n", quartets_schwarz_skipped_,
+                             100.0 * quartets_schwarz_skipped_ / (double) total);
+            outfile->Printf( "    Skipped (density): %20zu (%6.2f%%)\n\n", quartets_density_skipped_,
+                             100.0 * quartets_density_skipped_ / (double) total);
+        }
     }
 }
 void DirectJK::preiterations()
 {
     sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
+    incfock_reset();
+
+    // The tree and pair multipoles only depend on the basis, so they last all iterations
+    if (cfmm_ && do_J_) {
+        cfmm_tree_ = std::make_shared<CFMMTree>(primary_, sieve_, cfmm_order_, cutoff_);
+    }
+
+    nbuild_ = 0L;
+    quartets_computed_ = 0L;
+    quartets_density_skipped_ = 0L;
+    quartets_schwarz_skipped_ = 0L;
+}
+void DirectJK::incfock_reset()
+{
+    incfock_count_ = 0;
+    do_incfock_iter_ = false;
+    incfock_delta_max_ = 0.0;
+    D_prev_.clear();
+    dD_ao_.clear();
+    J_prev_.clear();
+    K_prev_.clear();
+    wK_prev_.clear();
+}
+void DirectJK::reset_build_state()
+{
+    JK::reset_build_state();
+    incfock_reset();
+}
+void DirectJK::incfock_setup()
+{
+    do_incfock_iter_ = false;
+
+    // The saved state must correspond to this call's densities and tasks
+    bool valid = D_prev_.size() && (D_prev_.size() == D_ao_.size()) &&
+                 (J_prev_.size() == J_ao_.size()) && (K_prev_.size() == K_ao_.size()) &&
+                 (wK_prev_.size() == wK_ao_.size()) && (!do_wK_ || incfock_omega_ == omega_);
+
+    if (!valid || incfock_count_ >= incfock_full_fock_every_) {
+        incfock_count_ = 0;
+        incfock_delta_max_ = 0.0;
+        return;
+    }
+
+    // => Density Change <= //
+
+    if (dD_ao_.size() != D_ao_.size()) {
+        dD_ao_.clear();
+        for (size_t N = 0; N < D_ao_.size(); N++) {
+            std::stringstream s;
+            s << "dD " << N << " (AO)";
+            dD_ao_.push_back(std::make_shared<Matrix>(s.str(), primary_->nbf(), primary_->nbf()));
+        }
+    }
+
+    double delta_max = 0.0;
+    for (size_t N = 0; N < D_ao_.size(); N++) {
+        dD_ao_[N]->copy(D_ao_[N]);
+        dD_ao_[N]->subtract(D_prev_[N]);
+        delta_max = std::max(delta_max, dD_ao_[N]->absmax());
+    }
+
+    // A growing density change means the iterations are not settling down:
+    // increments buy nothing there and only carry screening error forward
+    if (incfock_count_ && delta_max > incfock_delta_max_) {
+        if (debug_) {
+            outfile->Printf( "  DirectJK: max |dD| grew from %11.3E to %11.3E, full rebuild\n", incfock_delta_max_, delta_max);
+        }
+        incfock_count_ = 0;
+        incfock_delta_max_ = 0.0;
+        return;
+    }
+
+    do_incfock_iter_ = true;
+    incfock_count_++;
+    incfock_delta_max_ = delta_max;
+
+    if (debug_) {
+        outfile->Printf( "  DirectJK: incremental build %d of %d, max |dD| = %11.3E\n", incfock_count_, incfock_full_fock_every_, delta_max);
+    }
+}
+void DirectJK::incfock_postiter()
+{
+    // => Add back the previous matrices <= //
+
+    if (do_incfock_iter_) {
+        for (size_t N = 0; N < J_ao_.size(); N++) {
+            J_ao_[N]->add(J_prev_[N]);
+        }
+        for (size_t N = 0; N < K_ao_.size(); N++) {
+            K_ao_[N]->add(K_prev_[N]);
+        }
+        for (size_t N = 0; N < wK_ao_.size(); N++) {
+            wK_ao_[N]->add(wK_prev_[N]);
+        }
+    }
+
+    // => Save this call's state <= //
+
+    // The AO quantities may alias the SO ones, so these are always deep copies
+    auto save = [](const std::vector<SharedMatrix>& current, std::vector<SharedMatrix>& prev) {
+        if (prev.size() != current.size()) {
+            prev.clear();
+            for (size_t N = 0; N < current.size(); N++) {
+                prev.push_back(current[N]->clone());
+            }
+        } else {
+            for (size_t N = 0; N < current.size(); N++) {
+                prev[N]->copy(current[N]);
+            }
+        }
+    };
+    save(D_ao_, D_prev_);
+    save(J_ao_, J_prev_);
+    save(K_ao_, K_prev_);
+    save(wK_ao_, wK_prev_);
+    incfock_omega_ = omega_;
 }
 void DirectJK::compute_JK()
 {
+    if (incfock_) incfock_setup();
+
+    // Incremental builds contract against the density change only
+    std::vector<SharedMatrix>& D = (do_incfock_iter_ ? dD_ao_ : D_ao_);
+
     auto factory = std::make_shared<IntegralFactory>(primary_,primary_,primary_,primary_);
 
     if (do_wK_) {
@@ -103,13 +271,13 @@ void DirectJK::compute_JK()
         }
         // TODO: Fast K algorithm
         if (do_J_) {
-            build_JK(ints,D_ao_,J_ao_,wK_ao_);
+            build_JK(ints,D,J_ao_,wK_ao_);
         } else {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
             }
-            build_JK(ints,D_ao_,temp,wK_ao_);
+            build_JK(ints,D,temp,wK_ao_);
         }
     }
 
@@ -122,27 +290,92 @@ void DirectJK::compute_JK()
             else
                 ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri()));
         }
-        if (do_J_ && do_K_) {
-            build_JK(ints,D_ao_,J_ao_,K_ao_);
+        if (cfmm_tree_ && do_J_) {
+            // Only K is left for the quartet loop, J comes from the multipole tree
+            cfmm_tree_->build_J(ints,D,J_ao_);
+            if (debug_) {
+                outfile->Printf( "  DirectJK: CFMM J with %zu near-field quartets, %zu far-field interactions\n",
+                                 cfmm_tree_->near_quartets(), cfmm_tree_->far_interactions());
+            }
+            if (do_K_) {
+                std::vector<std::shared_ptr<Matrix> > temp;
+                for (size_t i = 0; i < D.size(); i++) {
+                    temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
+                }
+                build_JK(ints,D,temp,K_ao_);
+            }
+        } else if (do_J_ && do_K_) {
+            build_JK(ints,D,J_ao_,K_ao_);
         } else if (do_J_) {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
             }
-            build_JK(ints,D_ao_,J_ao_,temp);
+            build_JK(ints,D,J_ao_,temp);
         } else {
             std::vector<std::shared_ptr<Matrix> > temp;
-            for (size_t i = 0; i < D_ao_.size(); i++) {
+            for (size_t i = 0; i < D.size(); i++) {
                 temp.push_back(std::make_shared<Matrix>("temp", primary_->nbf(), primary_->nbf()));
             }
-            build_JK(ints,D_ao_,temp,K_ao_);
+            build_JK(ints,D,temp,K_ao_);
         }
     }
 
+    if (incfock_) incfock_postiter();
 }
 void DirectJK::postiterations()
 {
     sieve_.reset();
+    cfmm_tree_.reset();
+    incfock_reset();
+}
+std::vector<double> DirectJK::shell_max_density(const std::vector<SharedMatrix>& D) const
+{
+    int nshell = primary_->nshell();
+    std::vector<double> shell_D(nshell * (size_t) nshell, 0.0);
+
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        double** Dp = D[ind]->pointer();
+        for (int M = 0; M < nshell; M++) {
+            int Msize = primary_->shell(M).nfunction();
+            int Moff = primary_->shell(M).function_index();
+            for (int N = 0; N <= M; N++) {
+                int Nsize = primary_->shell(N).nfunction();
+                int Noff = primary_->shell(N).function_index();
+                double max_val = shell_D[M * (size_t) nshell + N];
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        max_val = std::max(max_val, std::fabs(Dp[m + Moff][n + Noff]));
+                        max_val = std::max(max_val, std::fabs(Dp[n + Noff][m + Moff]));
+                    }
+                }
+                shell_D[M * (size_t) nshell + N] = max_val;
+                shell_D[N * (size_t) nshell + M] = max_val;
+            }
+        }
+    }
+
+    return shell_D;
+}
+std::vector<double> DirectJK::sparse_shell_max_density(
+    const std::vector<std::shared_ptr<BlockSparseMatrix> >& D) const
+{
+    int nshell = primary_->nshell();
+    std::vector<double> shell_D(nshell * (size_t) nshell, 0.0);
+
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        std::vector<double> block_max = D[ind]->shell_max();
+        for (int M = 0; M < nshell; M++) {
+            for (int N = 0; N <= M; N++) {
+                double max_val = std::max(block_max[M * (size_t) nshell + N], block_max[N * (size_t) nshell + M]);
+                max_val = std::max(max_val, shell_D[M * (size_t) nshell + N]);
+                shell_D[M * (size_t) nshell + N] = max_val;
+                shell_D[N * (size_t) nshell + M] = max_val;
+            }
+        }
+    }
+
+    return shell_D;
 }
 void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
                         std::vector<std::shared_ptr<Matrix> >& D,
@@ -163,6 +396,23 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
     int nshell  = primary_->nshell();
     int nthread = df_ints_num_threads_;
 
+    // => Density Screening <= //
+
+    // The Schwarz ceiling is weighted by the largest density element a quartet
+    // contracts with; always on for incremental builds, where D is a small change
+    bool density_screen = density_screening_ || do_incfock_iter_;
+    std::vector<double> shell_D;
+    if (density_screen) {
+        // Sparse copies describe D_ao_, not the change an incremental build contracts with
+        if (!do_incfock_iter_ && D_sparse_.size() == D.size() && D.size()) {
+            shell_D = sparse_shell_max_density(D_sparse_);
+        } else {
+            shell_D = shell_max_density(D);
+        }
+    }
+    double density_cutoff = (density_cutoff_ > 0.0 ? density_cutoff_ : cutoff_);
+    double density_cutoff2 = density_cutoff * density_cutoff;
+
     // => Task Blocking <= //
 
     std::vector<int> task_shells;
@@ -190,6 +440,10 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
         task_offsets.push_back(task_offsets[P2] + primary_->shell(task_shells[P2]).nfunction());
     }
 
+    // Inverse of task_shells, to place batched ket quartets back in their task
+    std::vector<int> shell_tasks(nshell);
+    for (int P2 = 0; P2 < nshell; P2++) shell_tasks[task_shells[P2]] = P2;
+
     size_t max_task = 0L;
     for (size_t task = 0; task < ntask; task++) {
         size_t size = 0L;
@@ -216,27 +470,98 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
 
     // => Significant Task Pairs (PQ|-style <= //
 
+    // Task pairs are read off the sieve's significant shell pair list, so this and
+    // the cost estimate below scale with the number of significant pairs
+
+    std::vector<int> shell_task(nshell);
+    for (size_t task = 0; task < ntask; task++) {
+        for (int P2 = task_starts[task]; P2 < task_starts[task+1]; P2++) {
+            shell_task[task_shells[P2]] = task;
+        }
+    }
+
+    const ShellPairList& shell_pair_list = sieve_->shell_pair_list();
+    std::vector<std::vector<int> > task_rows(ntask);
+    for (int P = 0; P < nshell; P++) {
+        for (const int* Q = shell_pair_list.begin(P); Q != shell_pair_list.end(P); ++Q) {
+            int Ptask = shell_task[P];
+            int Qtask = shell_task[*Q];
+            if (Qtask <= Ptask) task_rows[Ptask].push_back(Qtask);
+        }
+    }
+
     std::vector<std::pair<int, int> > task_pairs;
+    std::vector<size_t> task_row_starts(ntask + 1, 0L);
     for (size_t Ptask = 0; Ptask < ntask; Ptask++) {
-        for (size_t Qtask = 0; Qtask < ntask; Qtask++) {
+        std::vector<int>& row = task_rows[Ptask];
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        task_row_starts[Ptask] = task_pairs.size();
+        for (int Qtask : row) task_pairs.push_back(std::pair<int,int>(Ptask,Qtask));
+    }
+    task_row_starts[ntask] = task_pairs.size();
+    size_t ntask_pair = task_pairs.size();
+    size_t ntask_pair2 = ntask_pair * ntask_pair;
+
+    // => Task Pair Ordering <= //
+
+    // Estimated cost of each task pair, summed over its significant shell
+    // pairs as nfunction * nprimitive on both centers. A quartet task then
+    // costs roughly the product of its bra and ket estimates.
+    std::vector<double> task_pair_costs(ntask_pair, 0.0);
+    for (int P = 0; P < nshell; P++) {
+        for (const int* Q = shell_pair_list.begin(P); Q != shell_pair_list.end(P); ++Q) {
+            int Ptask = shell_task[P];
+            int Qtask = shell_task[*Q];
             if (Qtask > Ptask) continue;
-            bool found = false;
-            for (int P2 = task_starts[Ptask]; P2 < task_starts[Ptask+1]; P2++) {
-                for (int Q2 = task_starts[Qtask]; Q2 < task_starts[Qtask+1]; Q2++) {
-                    int P = task_shells[P2];
-                    int Q = task_shells[Q2];
-                    if (sieve_->shell_pair_significant(P,Q)) {
-                        found = true;
-                        task_pairs.push_back(std::pair<int,int>(Ptask,Qtask));
-                        break;
-                    }
-                }
-                if (found) break;
+            const std::vector<int>& row = task_rows[Ptask];
+            size_t PQtask = task_row_starts[Ptask] + (std::lower_bound(row.begin(), row.end(), Qtask) - row.begin());
+            const GaussianShell& Pshell = primary_->shell(P);
+            const GaussianShell& Qshell = primary_->shell(*Q);
+            task_pair_costs[PQtask] += (double) Pshell.nfunction() * Pshell.nprimitive() *
+                                       Qshell.nfunction() * Qshell.nprimitive();
+        }
+    }
+
+    // Most expensive task pairs first, so the flattened quartet task list below
+    // hands the heavy (high angular momentum) work out early and finishes the
+    // dynamic schedule with cheap tasks that fill in the load imbalance
+    std::vector<size_t> task_pair_order(ntask_pair);
+    for (size_t PQtask = 0; PQtask < ntask_pair; PQtask++) task_pair_order[PQtask] = PQtask;
+    std::stable_sort(task_pair_order.begin(), task_pair_order.end(),
+                     [&task_pair_costs](size_t a, size_t b) { return task_pair_costs[a] > task_pair_costs[b]; });
+    std::vector<std::pair<int, int> > sorted_task_pairs(ntask_pair);
+    for (size_t PQtask = 0; PQtask < ntask_pair; PQtask++) {
+        sorted_task_pairs[PQtask] = task_pairs[task_pair_order[PQtask]];
+    }
+    task_pairs.swap(sorted_task_pairs);
+
+    // => Rank Partitioning <= //
+
+    // Whole bra task pairs (rows of the quartet task list) are dealt out to
+    // ranks, heaviest row to the least loaded rank. Every rank sees the same
+    // sieve and basis, so the assignment is identical everywhere.
+    std::vector<int> task_owner(ntask_pair, 0);
+    if (task_nrank_ > 1) {
+        std::vector<double> row_costs(ntask_pair, 0.0);
+        for (size_t task1 = 0; task1 < ntask_pair; task1++) {
+            for (size_t task2 = 0; task2 < ntask_pair; task2++) {
+                if (task_pairs[task2].first > task_pairs[task1].first) continue;
+                row_costs[task1] += task_pair_costs[task_pair_order[task2]];
             }
+            row_costs[task1] *= task_pair_costs[task_pair_order[task1]];
+        }
+        std::vector<size_t> row_order(ntask_pair);
+        for (size_t task1 = 0; task1 < ntask_pair; task1++) row_order[task1] = task1;
+        std::stable_sort(row_order.begin(), row_order.end(),
+                         [&row_costs](size_t a, size_t b) { return row_costs[a] > row_costs[b]; });
+        std::vector<double> rank_costs(task_nrank_, 0.0);
+        for (size_t row : row_order) {
+            int rank = std::min_element(rank_costs.begin(), rank_costs.end()) - rank_costs.begin();
+            task_owner[row] = rank;
+            rank_costs[rank] += row_costs[row];
         }
     }
-    size_t ntask_pair = task_pairs.size();
-    size_t ntask_pair2 = ntask_pair * ntask_pair;
 
     // => Intermediate Buffers <= //
 
@@ -252,15 +577,23 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
     // => Benchmarks <= //
 
     size_t computed_shells = 0L;
+    size_t density_skipped_shells = 0L;
+
+    // Per-thread wall time, tasks and quartets, for the load balance report
+    std::vector<double> thread_times(nthread, 0.0);
+    std::vector<size_t> thread_tasks(nthread, 0L);
+    std::vector<size_t> thread_shells(nthread, 0L);
 
     // ==> Master Task Loop <== //
 
-    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_shells)
+    #pragma omp parallel for num_threads(nthread) schedule(dynamic) reduction(+: computed_shells, density_skipped_shells)
     for (size_t task = 0L; task < ntask_pair2; task++) {
 
         size_t task1 = task / ntask_pair;
         size_t task2 = task % ntask_pair;
 
+        if (task_owner[task1] != task_rank_) continue;
+
         int Ptask = task_pairs[task1].first;
         int Qtask = task_pairs[task1].second;
         int Rtask = task_pairs[task2].first;
@@ -295,6 +628,9 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             thread = omp_get_thread_num();
         #endif
 
+        Timer task_timer;
+        thread_tasks[thread]++;
+
         // => Master shell quartet loops <= //
 
         bool touched = false;
@@ -304,37 +640,61 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
             int P = task_shells[P2];
             int Q = task_shells[Q2];
             if (!sieve_->shell_pair_significant(P,Q)) continue;
-        for (int R2 = R2start; R2 < R2start + nRtask; R2++) {
-        for (int S2 = S2start; S2 < S2start + nStask; S2++) {
-            if (S2 > R2) continue;
-            int R = task_shells[R2];
-            int S = task_shells[S2];
-            if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
-            if (!sieve_->shell_pair_significant(R,S)) continue;
-            if (!sieve_->shell_significant(P,Q,R,S)) continue;
 
-            //printf("Quartet: %2d %2d %2d %2d\n", P, Q, R, S);
+            // Gather the surviving kets, then hand them to the integral
+            // code in AM-uniform batches
+            ShellPairBlock kets;
+            for (int R2 = R2start; R2 < R2start + nRtask; R2++) {
+            for (int S2 = S2start; S2 < S2start + nStask; S2++) {
+                if (S2 > R2) continue;
+                int R = task_shells[R2];
+                int S = task_shells[S2];
+                if (R2 * nshell + S2 > P2 * nshell + Q2) continue;
+                if (!sieve_->shell_pair_significant(R,S)) continue;
+                if (!sieve_->shell_significant(P,Q,R,S)) continue;
+                if (density_screen) {
+                    double Dmax = std::max({shell_D[P * nshell + Q], shell_D[R * nshell + S],
+                                            shell_D[P * nshell + R], shell_D[P * nshell + S],
+                                            shell_D[Q * nshell + R], shell_D[Q * nshell + S]});
+                    if (sieve_->shell_ceiling2(P,Q,R,S) * Dmax * Dmax < density_cutoff2) {
+                        density_skipped_shells++;
+                        continue;
+                    }
+                }
+                kets.push_back(std::make_pair(R, S));
+            }}
+            if (kets.empty()) continue;
+
+            int Psize = primary_->shell(P).nfunction();
+            int Qsize = primary_->shell(Q).nfunction();
+            int Poff = primary_->shell(P).function_index();
+            int Qoff = primary_->shell(Q).function_index();
+            int Poff2 = task_offsets[P2] - task_offsets[P2start];
+            int Qoff2 = task_offsets[Q2] - task_offsets[Q2start];
+
+            const ShellPairBlock bra(1, std::make_pair(P, Q));
+            for (const ShellPairBlock& block : ints[thread]->am_blocks(kets, false, ints[thread]->max_block_quartets())) {
 
             //if (thread == 0) timer_on("JK: Ints");
-            if(ints[thread]->compute_shell(P,Q,R,S) == 0)
-                continue; // No integrals in this shell quartet
-            computed_shells++;
+            ints[thread]->compute_shell_blocks(bra, block);
+            computed_shells += block.size();
+            thread_shells[thread] += block.size();
             //if (thread == 0) timer_off("JK: Ints");
 
-            const double* buffer = ints[thread]->buffer();
+            const double* buffer = ints[thread]->block_buffer();
+
+            for (const auto& RS : block) {
+            int R = RS.first;
+            int S = RS.second;
+            int R2 = shell_tasks[R];
+            int S2 = shell_tasks[S];
 
-            int Psize = primary_->shell(P).nfunction();
-            int Qsize = primary_->shell(Q).nfunction();
             int Rsize = primary_->shell(R).nfunction();
             int Ssize = primary_->shell(S).nfunction();
 
-            int Poff = primary_->shell(P).function_index();
-            int Qoff = primary_->shell(Q).function_index();
             int Roff = primary_->shell(R).function_index();
             int Soff = primary_->shell(S).function_index();
 
-            int Poff2 = task_offsets[P2] - task_offsets[P2start];
-            int Qoff2 = task_offsets[Q2] - task_offsets[Q2start];
             int Roff2 = task_offsets[R2] - task_offsets[R2start];
             int Soff2 = task_offsets[S2] - task_offsets[S2start];
 
@@ -401,12 +761,17 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
                 }}}}
 
             }
+            buffer += (size_t)Psize * Qsize * Rsize * Ssize;
             touched = true;
             //if (thread == 0) timer_off("JK: GEMV");
 
-        }}}} // End Shell Quartets
+            }} // End kets of this block
+        }} // End Shell Quartets
 
-        if (!touched) continue;
+        if (!touched) {
+            thread_times[thread] += task_timer.get();
+            continue;
+        }
 
         // => Stripe out <= //
 
@@ -566,8 +931,13 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
         } // End stripe out
         //if (thread == 0) timer_off("JK: Atomic");
 
+        thread_times[thread] += task_timer.get();
+
     } // End master task list
 
+    // Sum the partial J/K (and the counters) over all ranks
+    if (task_nrank_ > 1) reduce_JK(J, K, computed_shells, density_skipped_shells);
+
     for (size_t ind = 0; ind < D.size(); ind++) {
         J[ind]->scale(2.0);
         J[ind]->hermitivitize();
@@ -577,12 +947,37 @@ void DirectJK::build_JK(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
         }
     }
 
+    // => Screening Statistics <= //
+
+    size_t ntri = nshell * (nshell + 1L) / 2L;
+    size_t possible_shells = ntri * (ntri + 1L) / 2L;
+    nbuild_++;
+    quartets_computed_ += computed_shells;
+    quartets_density_skipped_ += density_skipped_shells;
+    quartets_schwarz_skipped_ += possible_shells - computed_shells - density_skipped_shells;
+
     if (bench_) {
         auto mode = std::ostream::app;
         auto printer = std::make_shared<PsiOutStream>("bench.dat", mode);
-        size_t ntri = nshell * (nshell + 1L) / 2L;
-        size_t possible_shells = ntri * (ntri + 1L) / 2L;
         printer->Printf( "Computed %20zu Shell Quartets out of %20zu, (%11.3E ratio)\n", computed_shells, possible_shells, computed_shells / (double) possible_shells);
+        if (density_screen) {
+            printer->Printf( "Density Screened %12zu Shell Quartets out of %20zu, (%11.3E ratio)\n", density_skipped_shells, possible_shells, density_skipped_shells / (double) possible_shells);
+        }
+
+        // > Thread Load Balance < //
+
+        double max_time = 0.0;
+        double sum_time = 0.0;
+        for (int thread = 0; thread < nthread; thread++) {
+            max_time = std::max(max_time, thread_times[thread]);
+            sum_time += thread_times[thread];
+        }
+        double mean_time = sum_time / nthread;
+        printer->Printf( "  Thread %4s %12s %20s %12s\n", "", "Tasks", "Shell Quartets", "Time [s]");
+        for (int thread = 0; thread < nthread; thread++) {
+            printer->Printf( "  Thread %4d %12zu %20zu %12.3f\n", thread, thread_tasks[thread], thread_shells[thread], thread_times[thread]);
+        }
+        printer->Printf( "  Load imbalance (max/mean thread time): %8.3f\n", (mean_time > 0.0 ? max_time / mean_time : 1.0));
     }
 }
 
@@ -29,6 +29,7 @@
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/aiohandler.h"
+#include "psi4/libpsio/prefetch.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/psifiles.h"
@@ -67,6 +68,8 @@ void DiskDFJK::common_init() {
     condition_ = 1.0E-12;
     unit_ = PSIF_DFSCF_BJ;
     is_core_ = true;
+    async_io_ = true;
+    fused_wK_ = true;
     psio_ = PSIO::shared_object();
 }
 SharedVector DiskDFJK::iaia(SharedMatrix Ci, SharedMatrix Ca) {
@@ -259,6 +262,8 @@ void DiskDFJK::print_header() const {
         outfile->Printf("    Integrals threads: %11d\n", df_ints_num_threads_);
         outfile->Printf("    Memory [MiB]:      %11ld\n", (memory_ * 8L) / (1024L * 1024L));
         outfile->Printf("    Algorithm:         %11s\n", (is_core_ ? "Core" : "Disk"));
+        if (!is_core_) outfile->Printf("    Async I/O:         %11s\n", (async_io_ ? "Yes" : "No"));
+        if (do_wK_) outfile->Printf("    Fused wK:          %11s\n", (fuse_wK() ? "Yes" : "No"));
         outfile->Printf("    Integral Cache:    %11s\n", df_ints_io_.c_str());
         outfile->Printf("    Schwarz Cutoff:    %11.0E\n", cutoff_);
         outfile->Printf("    Fitting Condition: %11.0E\n\n", condition_);
@@ -278,7 +283,7 @@ bool DiskDFJK::is_core() const {
 
     // Two is for buffer space in fitting
     if (do_wK_)
-        return (3L * three_memory + 2L * two_memory < memory_);
+        return ((fused_wK_ ? 2L : 3L) * three_memory + 2L * two_memory < memory_);
     else
         return (three_memory + 2L * two_memory < memory_);
 }
@@ -304,8 +309,10 @@ int DiskDFJK::max_rows() const {
     size_t row_cost = 0L;
     // Copies of E tensor
     row_cost += (lr_symmetric_ ? 1L : 2L) * max_nocc() * primary_->nbf();
-    // Slices of Qmn tensor, including AIO buffer (NOTE: AIO not implemented yet)
-    row_cost += (is_core_ ? 1L : 1L) * sieve_->function_pairs().size();
+    // The E tensor of the fused wK
+    if (fuse_wK()) row_cost += max_nocc() * primary_->nbf();
+    // Slices of Qmn tensor, including the prefetch buffer
+    row_cost += (is_core_ || !async_io_ ? 1L : 2L) * sieve_->function_pairs().size();
 
     size_t max_rows = mem / row_cost;
 
@@ -349,6 +356,7 @@ void DiskDFJK::initialize_temps() {
         E_right_ = E_left_;
     else
         E_right_ = std::make_shared<Matrix>("E_right", primary_->nbf(), max_rows_ * max_nocc_);
+    if (fuse_wK()) E_w_ = std::make_shared<Matrix>("E_w", primary_->nbf(), max_rows_ * max_nocc_);
 }
 void DiskDFJK::initialize_w_temps() {
     int max_rows_w = max_rows_ / 2;
@@ -381,6 +389,7 @@ void DiskDFJK::free_temps() {
     d_temp_.reset();
     E_left_.reset();
     E_right_.reset();
+    E_w_.reset();
     C_temp_.clear();
     Q_temp_.clear();
 }
@@ -405,7 +414,9 @@ void DiskDFJK::preiterations() {
         initialize_JK_disk();
 
     if (do_wK_) {
-        if (is_core_)
+        if (fuse_wK())
+            initialize_wK_fused();
+        else if (is_core_)
             initialize_wK_core();
         else
             initialize_wK_disk();
@@ -413,10 +424,11 @@ void DiskDFJK::preiterations() {
 }
 
 void DiskDFJK::compute_JK() {
+    reduce_C_rank();
     max_nocc_ = max_nocc();
     max_rows_ = max_rows();
 
-    if (do_J_ || do_K_) {
+    if (do_J_ || do_K_ || fuse_wK()) {
         initialize_temps();
         if (is_core_)
             manage_JK_core();
@@ -426,12 +438,14 @@ void DiskDFJK::compute_JK() {
     }
 
     if (do_wK_) {
-        initialize_w_temps();
-        if (is_core_)
-            manage_wK_core();
-        else
-            manage_wK_disk();
-        free_w_temps();
+        if (!fuse_wK()) {
+            initialize_w_temps();
+            if (is_core_)
+                manage_wK_core();
+            else
+                manage_wK_disk();
+            free_w_temps();
+        }
         // Bring the wK matrices back to Hermitian
         if (lr_symmetric_) {
             for (size_t N = 0; N < wK_ao_.size(); N++) {
@@ -444,6 +458,7 @@ void DiskDFJK::postiterations() {
     Qmn_.reset();
     Qlmn_.reset();
     Qrmn_.reset();
+    Qwmn_.reset();
 }
 void DiskDFJK::initialize_JK_core() {
     size_t ntri = sieve_->function_pairs().size();
@@ -953,6 +968,130 @@ void DiskDFJK::initialize_JK_disk() {
 
     psio_->close(unit_, 1);
 }
+void DiskDFJK::initialize_wK_fused() {
+    int naux = auxiliary_->nbf();
+    size_t ntri = sieve_->function_pairs().size();
+    size_t three_memory = ((size_t)naux) * ntri;
+    size_t two_memory = ((size_t)naux) * naux;
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = df_ints_num_threads_;
+#endif
+    int rank = 0;
+
+    Qwmn_ = std::make_shared<Matrix>("Qwmn (Fitted Integrals)", naux, ntri);
+    double** Qwmnp = Qwmn_->pointer();
+
+    // Try to load, if the integrals are there and for the right omega
+    if (df_ints_io_ == "LOAD") {
+        psio_->open(unit_, PSIO_OPEN_OLD);
+        bool found = psio_->tocentry_exists(unit_, "(Q|w|mn) Integrals");
+        if (found) {
+            double check_omega;
+            psio_->read_entry(unit_, "Omega", (char*)&check_omega, sizeof(double));
+            found = (check_omega == omega_);
+        }
+        if (found) psio_->read_entry(unit_, "(Q|w|mn) Integrals", (char*)Qwmnp[0], sizeof(double) * ntri * naux);
+        psio_->close(unit_, 1);
+        if (found) return;
+    }
+
+    // => (A|w|mn) <= //
+
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    std::shared_ptr<IntegralFactory> rifactory =
+        std::make_shared<IntegralFactory>(auxiliary_, zero, primary_, primary_);
+    const double** buffer = new const double*[nthread];
+    std::shared_ptr<TwoBodyAOInt>* eri = new std::shared_ptr<TwoBodyAOInt>[ nthread ];
+    for (int Q = 0; Q < nthread; Q++) {
+        eri[Q] = std::shared_ptr<TwoBodyAOInt>(rifactory->erf_eri(omega_));
+        buffer[Q] = eri[Q]->buffer();
+    }
+
+    const std::vector<long int>& schwarz_shell_pairs = sieve_->shell_pairs_reverse();
+    const std::vector<long int>& schwarz_fun_pairs = sieve_->function_pairs_reverse();
+
+    int numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu;
+
+    timer_on("JK: (A|w|mn)");
+
+#pragma omp parallel for private(numP, Pshell, MU, NU, P, PHI, mu, nu, nummu, numnu, omu, onu, \
+                                 rank) schedule(dynamic) num_threads(nthread)
+    for (MU = 0; MU < primary_->nshell(); ++MU) {
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        nummu = primary_->shell(MU).nfunction();
+        for (NU = 0; NU <= MU; ++NU) {
+            numnu = primary_->shell(NU).nfunction();
+            if (schwarz_shell_pairs[MU * (MU + 1) / 2 + NU] > -1) {
+                for (Pshell = 0; Pshell < auxiliary_->nshell(); ++Pshell) {
+                    numP = auxiliary_->shell(Pshell).nfunction();
+                    eri[rank]->compute_shell(Pshell, 0, MU, NU);
+                    for (mu = 0; mu < nummu; ++mu) {
+                        omu = primary_->shell(MU).function_index() + mu;
+                        for (nu = 0; nu < numnu; ++nu) {
+                            onu = primary_->shell(NU).function_index() + nu;
+                            if (omu >= onu && schwarz_fun_pairs[omu * (omu + 1) / 2 + onu] > -1) {
+                                for (P = 0; P < numP; ++P) {
+                                    PHI = auxiliary_->shell(Pshell).function_index() + P;
+                                    Qwmnp[PHI][schwarz_fun_pairs[omu * (omu + 1) / 2 + onu]] =
+                                        buffer[rank][P * nummu * numnu + mu * numnu + nu];
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    timer_off("JK: (A|w|mn)");
+
+    delete[] buffer;
+    delete[] eri;
+
+    // => Fitting <= //
+
+    // The same (A|Q)^-1/2 as Qmn_, so that the two meet as (A|Q)^-1 in the K pass
+    timer_on("JK: (A|Q)^-1/2");
+
+    auto Jinv = std::make_shared<FittingMetric>(auxiliary_, true);
+    Jinv->form_eig_inverse();
+    double** Jinvp = Jinv->get_metric()->pointer();
+
+    timer_off("JK: (A|Q)^-1/2");
+
+    size_t used = 2L * three_memory + two_memory;
+    size_t max_cols = (memory_ > used ? (memory_ - used) / naux : 1);
+    if (max_cols < 1) max_cols = 1;
+    if (max_cols > ntri) max_cols = ntri;
+    auto temp = std::make_shared<Matrix>("Qwmn buffer", naux, max_cols);
+    double** tempp = temp->pointer();
+
+    timer_on("JK: (Q|w|mn)");
+
+    for (size_t col = 0; col < ntri; col += max_cols) {
+        size_t ncol = (col + max_cols > ntri ? ntri - col : max_cols);
+
+        C_DGEMM('N', 'N', naux, ncol, naux, 1.0, Jinvp[0], naux, &Qwmnp[0][col], ntri, 0.0, tempp[0], max_cols);
+
+        for (int Q = 0; Q < naux; Q++) {
+            C_DCOPY(ncol, tempp[Q], 1, &Qwmnp[Q][col], 1);
+        }
+    }
+
+    timer_off("JK: (Q|w|mn)");
+
+    // Try to save
+    if (df_ints_io_ == "SAVE") {
+        psio_->open(unit_, PSIO_OPEN_OLD);
+        psio_->write_entry(unit_, "(Q|w|mn) Integrals", (char*)Qwmnp[0], sizeof(double) * ntri * naux);
+        psio_->write_entry(unit_, "Omega", (char*)&omega_, sizeof(double));
+        psio_->close(unit_, 1);
+    }
+}
 void DiskDFJK::initialize_wK_core() {
     int naux = auxiliary_->nbf();
     int ntri = sieve_->function_pairs().size();
@@ -1677,38 +1816,65 @@ void DiskDFJK::manage_JK_core() {
             block_J(&Qmn_->pointer()[Q], naux);
             timer_off("JK: J");
         }
-        if (do_K_) {
+        if (do_K_ || fuse_wK()) {
             timer_on("JK: K");
-            block_K(&Qmn_->pointer()[Q], naux);
+            block_K(&Qmn_->pointer()[Q], naux, (fuse_wK() ? &Qwmn_->pointer()[Q] : nullptr));
             timer_off("JK: K");
         }
     }
 }
 void DiskDFJK::manage_JK_disk() {
     int ntri = sieve_->function_pairs().size();
-    Qmn_ = std::make_shared<Matrix>("(Q|mn) Block", max_rows_, ntri);
+    int naux_total = auxiliary_->nbf();
+    int nblocks = (naux_total + max_rows_ - 1) / max_rows_;
+    int nbuffer = (async_io_ && nblocks > 1 ? 2 : 1);
+
+    std::vector<SharedMatrix> Qmn;
+    for (int k = 0; k < nbuffer; k++) Qmn.push_back(std::make_shared<Matrix>("(Q|mn) Block", max_rows_, ntri));
+
     psio_->open(unit_, PSIO_OPEN_OLD);
-    for (int Q = 0; Q < auxiliary_->nbf(); Q += max_rows_) {
-        int naux = (auxiliary_->nbf() - Q <= max_rows_ ? auxiliary_->nbf() - Q : max_rows_);
-        psio_address addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
+    BlockPrefetcher prefetch(psio_, unit_, nbuffer > 1);
+
+    auto post_block = [&](int block) {
+        int Q = block * max_rows_;
+        int naux = (naux_total - Q <= max_rows_ ? naux_total - Q : max_rows_);
+        double* buffer = Qmn[block % nbuffer]->pointer()[0];
+        size_t unit = unit_;
+        prefetch.post([=](std::shared_ptr<PSIO> psio) {
+            psio_address addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
+            psio->read(unit, "(Q|mn) Integrals", (char*)buffer, sizeof(double) * naux * ntri, addr, &addr);
+            return (size_t)naux * ntri;
+        });
+    };
+    if (nbuffer > 1) post_block(0);
+
+    for (int block = 0; block < nblocks; block++) {
+        int Q = block * max_rows_;
+        int naux = (naux_total - Q <= max_rows_ ? naux_total - Q : max_rows_);
 
         timer_on("JK: (Q|mn) Read");
-        psio_->read(unit_, "(Q|mn) Integrals", (char*)(Qmn_->pointer()[0]), sizeof(double) * naux * ntri, addr, &addr);
+        if (nbuffer > 1) {
+            prefetch.wait();
+            if (block + 1 < nblocks) post_block(block + 1);
+        } else {
+            post_block(block);
+        }
         timer_off("JK: (Q|mn) Read");
 
+        double** Qmnp = Qmn[block % nbuffer]->pointer();
         if (do_J_) {
             timer_on("JK: J");
-            block_J(&Qmn_->pointer()[0], naux);
+            block_J(Qmnp, naux);
             timer_off("JK: J");
         }
         if (do_K_) {
             timer_on("JK: K");
-            block_K(&Qmn_->pointer()[0], naux);
+            block_K(Qmnp, naux);
             timer_off("JK: K");
         }
     }
+    prefetch.close();
     psio_->close(unit_, 1);
-    Qmn_.reset();
 }
 void DiskDFJK::manage_wK_core() {
     int max_rows_w = max_rows_ / 2;
@@ -1725,32 +1891,55 @@ void DiskDFJK::manage_wK_disk() {
     int max_rows_w = max_rows_ / 2;
     max_rows_w = (max_rows_w < 1 ? 1 : max_rows_w);
     int ntri = sieve_->function_pairs().size();
-    Qlmn_ = std::make_shared<Matrix>("(Q|mn) Block", max_rows_w, ntri);
-    Qrmn_ = std::make_shared<Matrix>("(Q|mn) Block", max_rows_w, ntri);
-    psio_->open(unit_, PSIO_OPEN_OLD);
-    for (int Q = 0; Q < auxiliary_->nbf(); Q += max_rows_w) {
-        int naux = (auxiliary_->nbf() - Q <= max_rows_w ? auxiliary_->nbf() - Q : max_rows_w);
-        psio_address addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
-
-        timer_on("JK: (Q|mn)^L Read");
-        psio_->read(unit_, "Left (Q|w|mn) Integrals", (char*)(Qlmn_->pointer()[0]), sizeof(double) * naux * ntri, addr,
-                    &addr);
-        timer_off("JK: (Q|mn)^L Read");
+    int naux_total = auxiliary_->nbf();
+    int nblocks = (naux_total + max_rows_w - 1) / max_rows_w;
+    int nbuffer = (async_io_ && nblocks > 1 ? 2 : 1);
 
-        addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
+    std::vector<SharedMatrix> Qlmn;
+    std::vector<SharedMatrix> Qrmn;
+    for (int k = 0; k < nbuffer; k++) {
+        Qlmn.push_back(std::make_shared<Matrix>("(Q|mn) Block", max_rows_w, ntri));
+        Qrmn.push_back(std::make_shared<Matrix>("(Q|mn) Block", max_rows_w, ntri));
+    }
 
-        timer_on("JK: (Q|mn)^R Read");
-        psio_->read(unit_, "Right (Q|w|mn) Integrals", (char*)(Qrmn_->pointer()[0]), sizeof(double) * naux * ntri, addr,
-                    &addr);
-        timer_off("JK: (Q|mn)^R Read");
+    psio_->open(unit_, PSIO_OPEN_OLD);
+    BlockPrefetcher prefetch(psio_, unit_, nbuffer > 1);
+
+    auto post_block = [&](int block) {
+        int Q = block * max_rows_w;
+        int naux = (naux_total - Q <= max_rows_w ? naux_total - Q : max_rows_w);
+        double* left = Qlmn[block % nbuffer]->pointer()[0];
+        double* right = Qrmn[block % nbuffer]->pointer()[0];
+        size_t unit = unit_;
+        prefetch.post([=](std::shared_ptr<PSIO> psio) {
+            psio_address addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
+            psio->read(unit, "Left (Q|w|mn) Integrals", (char*)left, sizeof(double) * naux * ntri, addr, &addr);
+            addr = psio_get_address(PSIO_ZERO, (Q * (size_t)ntri) * sizeof(double));
+            psio->read(unit, "Right (Q|w|mn) Integrals", (char*)right, sizeof(double) * naux * ntri, addr, &addr);
+            return (size_t)2 * naux * ntri;
+        });
+    };
+    if (nbuffer > 1) post_block(0);
+
+    for (int block = 0; block < nblocks; block++) {
+        int Q = block * max_rows_w;
+        int naux = (naux_total - Q <= max_rows_w ? naux_total - Q : max_rows_w);
+
+        timer_on("JK: (Q|mn)^L,R Read");
+        if (nbuffer > 1) {
+            prefetch.wait();
+            if (block + 1 < nblocks) post_block(block + 1);
+        } else {
+            post_block(block);
+        }
+        timer_off("JK: (Q|mn)^L,R Read");
 
         timer_on("JK: wK");
-        block_wK(&Qlmn_->pointer()[0], &Qrmn_->pointer()[0], naux);
+        block_wK(Qlmn[block % nbuffer]->pointer(), Qrmn[block % nbuffer]->pointer(), naux);
         timer_off("JK: wK");
     }
+    prefetch.close();
     psio_->close(unit_, 1);
-    Qlmn_.reset();
-    Qrmn_.reset();
 }
 void DiskDFJK::block_J(double** Qmnp, int naux) {
     const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
@@ -1783,12 +1972,36 @@ void DiskDFJK::block_J(double** Qmnp, int naux) {
         }
     }
 }
-void DiskDFJK::block_K(double** Qmnp, int naux) {
-    const std::vector<std::pair<int, int> >& function_pairs = sieve_->function_pairs();
+void DiskDFJK::half_transform(double** Qmnp, int naux, double** Cp, int nocc, double** Ep) {
     const std::vector<long int>& function_pairs_reverse = sieve_->function_pairs_reverse();
-    size_t num_nm = function_pairs.size();
+    size_t num_nm = sieve_->function_pairs().size();
+    int nbf = primary_->nbf();
 
-    for (size_t N = 0; N < K_ao_.size(); N++) {
+#pragma omp parallel for schedule(dynamic)
+    for (int m = 0; m < nbf; m++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+
+        double** Ctp = C_temp_[thread]->pointer();
+        double** QSp = Q_temp_[thread]->pointer();
+
+        const std::vector<int>& pairs = sieve_->function_to_function()[m];
+        int rows = pairs.size();
+
+        for (int i = 0; i < rows; i++) {
+            int n = pairs[i];
+            long int ij = function_pairs_reverse[(m >= n ? (m * (m + 1L) >> 1) + n : (n * (n + 1L) >> 1) + m)];
+            C_DCOPY(naux, &Qmnp[0][ij], num_nm, &QSp[0][i], nbf);
+            C_DCOPY(nocc, Cp[n], 1, &Ctp[0][i], nbf);
+        }
+
+        C_DGEMM('N', 'T', nocc, naux, rows, 1.0, Ctp[0], nbf, QSp[0], nbf, 0.0, &Ep[0][m * (size_t)nocc * naux], naux);
+    }
+}
+void DiskDFJK::block_K(double** Qmnp, int naux, double** Qwmnp) {
+    for (size_t N = 0; N < C_left_ao_.size(); N++) {
         int nbf = C_left_ao_[N]->rowspi()[0];
         int nocc = C_left_ao_[N]->colspi()[0];
 
@@ -1798,76 +2011,44 @@ void DiskDFJK::block_K(double** Qmnp, int naux) {
         double** Crp = C_right_ao_[N]->pointer();
         double** Elp = E_left_->pointer();
         double** Erp = E_right_->pointer();
-        double** Kp = K_ao_[N]->pointer();
 
         if (N == 0 || C_left_[N].get() != C_left_[N - 1].get()) {
             timer_on("JK: K1");
-
-#pragma omp parallel for schedule(dynamic)
-            for (int m = 0; m < nbf; m++) {
-                int thread = 0;
-#ifdef _OPENMP
-                thread = omp_get_thread_num();
-#endif
-
-                double** Ctp = C_temp_[thread]->pointer();
-                double** QSp = Q_temp_[thread]->pointer();
-
-                const std::vector<int>& pairs = sieve_->function_to_function()[m];
-                int rows = pairs.size();
-
-                for (int i = 0; i < rows; i++) {
-                    int n = pairs[i];
-                    long int ij = function_pairs_reverse[(m >= n ? (m * (m + 1L) >> 1) + n : (n * (n + 1L) >> 1) + m)];
-                    C_DCOPY(naux, &Qmnp[0][ij], num_nm, &QSp[0][i], nbf);
-                    C_DCOPY(nocc, Clp[n], 1, &Ctp[0][i], nbf);
-                }
-
-                C_DGEMM('N', 'T', nocc, naux, rows, 1.0, Ctp[0], nbf, QSp[0], nbf, 0.0,
-                        &Elp[0][m * (size_t)nocc * naux], naux);
-            }
-
+            half_transform(Qmnp, naux, Clp, nocc, Elp);
             timer_off("JK: K1");
         }
 
-        if (!lr_symmetric_ && (N == 0 || C_right_[N].get() != C_right_[N - 1].get())) {
+        if (do_K_ && !lr_symmetric_ && (N == 0 || C_right_[N].get() != C_right_[N - 1].get())) {
             if (C_right_[N].get() == C_left_[N].get()) {
                 ::memcpy((void*)Erp[0], (void*)Elp[0], sizeof(double) * naux * nocc * nbf);
             } else {
                 timer_on("JK: K1");
-
-#pragma omp parallel for schedule(dynamic)
-                for (int m = 0; m < nbf; m++) {
-                    int thread = 0;
-#ifdef _OPENMP
-                    thread = omp_get_thread_num();
-#endif
-
-                    double** Ctp = C_temp_[thread]->pointer();
-                    double** QSp = Q_temp_[thread]->pointer();
-
-                    const std::vector<int>& pairs = sieve_->function_to_function()[m];
-                    int rows = pairs.size();
-
-                    for (int i = 0; i < rows; i++) {
-                        int n = pairs[i];
-                        long int ij =
-                            function_pairs_reverse[(m >= n ? (m * (m + 1L) >> 1) + n : (n * (n + 1L) >> 1) + m)];
-                        C_DCOPY(naux, &Qmnp[0][ij], num_nm, &QSp[0][i], nbf);
-                        C_DCOPY(nocc, Crp[n], 1, &Ctp[0][i], nbf);
-                    }
-
-                    C_DGEMM('N', 'T', nocc, naux, rows, 1.0, Ctp[0], nbf, QSp[0], nbf, 0.0,
-                            &Erp[0][m * (size_t)nocc * naux], naux);
-                }
-
+                half_transform(Qmnp, naux, Crp, nocc, Erp);
                 timer_off("JK: K1");
             }
         }
 
-        timer_on("JK: K2");
-        C_DGEMM('N', 'T', nbf, nbf, naux * nocc, 1.0, Elp[0], naux * nocc, Erp[0], naux * nocc, 1.0, Kp[0], nbf);
-        timer_off("JK: K2");
+        if (do_K_) {
+            double** Kp = K_ao_[N]->pointer();
+            timer_on("JK: K2");
+            C_DGEMM('N', 'T', nbf, nbf, naux * nocc, 1.0, Elp[0], naux * nocc, Erp[0], naux * nocc, 1.0, Kp[0], nbf);
+            timer_off("JK: K2");
+        }
+
+        // wK_mn = (E_left)_m,iQ (Q|P)^-1/2 (P|w|ls) C_si, the metric already being folded into Qwmn
+        if (Qwmnp) {
+            double** Ewp = E_w_->pointer();
+            double** wKp = wK_ao_[N]->pointer();
+            if (N == 0 || C_right_[N].get() != C_right_[N - 1].get()) {
+                timer_on("JK: wK1");
+                half_transform(Qwmnp, naux, Crp, nocc, Ewp);
+                timer_off("JK: wK1");
+            }
+
+            timer_on("JK: wK2");
+            C_DGEMM('N', 'T', nbf, nbf, naux * nocc, 1.0, Elp[0], naux * nocc, Ewp[0], naux * nocc, 1.0, wKp[0], nbf);
+            timer_off("JK: wK2");
+        }
     }
 }
 void DiskDFJK::block_wK(double** Qlmnp, double** Qrmnp, int naux) {
@@ -0,0 +1,118 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/libmints/matrix.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+namespace psi {
+
+#ifdef ENABLE_MPI
+
+DistDirectJK::DistDirectJK(std::shared_ptr<BasisSet> primary) : DirectJK(primary) {
+    MPI_Comm_rank(MPI_COMM_WORLD, &task_rank_);
+    MPI_Comm_size(MPI_COMM_WORLD, &task_nrank_);
+}
+DistDirectJK::~DistDirectJK() {}
+int DistDirectJK::world_size() {
+    int initialized = 0;
+    MPI_Initialized(&initialized);
+    if (!initialized) return 1;
+    int size = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    return size;
+}
+void DistDirectJK::reduce_JK(std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, size_t& computed_shells,
+                             size_t& density_skipped_shells) {
+    // => Pack <= //
+
+    size_t nbuffer = 2L;
+    for (size_t ind = 0; ind < J.size(); ind++) nbuffer += J[ind]->rowdim() * (size_t)J[ind]->coldim();
+    for (size_t ind = 0; ind < K.size(); ind++) nbuffer += K[ind]->rowdim() * (size_t)K[ind]->coldim();
+
+    std::vector<double> buffer(nbuffer);
+    double* bufferp = buffer.data();
+    for (size_t ind = 0; ind < J.size(); ind++) {
+        size_t size = J[ind]->rowdim() * (size_t)J[ind]->coldim();
+        if (size) ::memcpy((void*)bufferp, (void*)J[ind]->pointer()[0], size * sizeof(double));
+        bufferp += size;
+    }
+    for (size_t ind = 0; ind < K.size(); ind++) {
+        size_t size = K[ind]->rowdim() * (size_t)K[ind]->coldim();
+        if (size) ::memcpy((void*)bufferp, (void*)K[ind]->pointer()[0], size * sizeof(double));
+        bufferp += size;
+    }
+    // Counts stay exact in a double well past any realistic quartet count
+    bufferp[0] = (double)computed_shells;
+    bufferp[1] = (double)density_skipped_shells;
+
+    // => Reduce <= //
+
+    // MPI counts are ints, so large buffers go in chunks
+    for (size_t offset = 0; offset < nbuffer; offset += INT_MAX) {
+        int count = (int)std::min<size_t>(INT_MAX, nbuffer - offset);
+        MPI_Allreduce(MPI_IN_PLACE, buffer.data() + offset, count, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    }
+
+    // => Unpack <= //
+
+    bufferp = buffer.data();
+    for (size_t ind = 0; ind < J.size(); ind++) {
+        size_t size = J[ind]->rowdim() * (size_t)J[ind]->coldim();
+        if (size) ::memcpy((void*)J[ind]->pointer()[0], (void*)bufferp, size * sizeof(double));
+        bufferp += size;
+    }
+    for (size_t ind = 0; ind < K.size(); ind++) {
+        size_t size = K[ind]->rowdim() * (size_t)K[ind]->coldim();
+        if (size) ::memcpy((void*)K[ind]->pointer()[0], (void*)bufferp, size * sizeof(double));
+        bufferp += size;
+    }
+    computed_shells = (size_t)bufferp[0];
+    density_skipped_shells = (size_t)bufferp[1];
+}
+
+#else
+
+DistDirectJK::DistDirectJK(std::shared_ptr<BasisSet> primary) : DirectJK(primary) {
+    throw PSIEXCEPTION("PSI4 has not been compiled with MPI support");
+}
+DistDirectJK::~DistDirectJK() {}
+int DistDirectJK::world_size() { return 1; }
+void DistDirectJK::reduce_JK(std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, size_t& computed_shells,
+                             size_t& density_skipped_shells) {}
+
+#endif
+
+}  // namespace psi
@@ -80,6 +80,10 @@ void MemDFJK::preiterations() {
     dfh_->set_memory(memory_ - memory_overhead());
     dfh_->set_do_wK(do_wK_);
     dfh_->set_omega(omega_);
+    dfh_->set_AO_cache(ints_cache_);
+    dfh_->set_mixed_precision(mixed_precision_);
+    dfh_->set_device(device_offload_);
+    dfh_->set_local_fitting(local_fitting_);
 
     // This is a very subtle issue that only happens if the auxiliary is cartesian.
     // It should be noted that this bug does not show up in the 3-index transform.
@@ -106,6 +110,24 @@ void MemDFJK::preiterations() {
 }
 void MemDFJK::compute_JK() {
 
+    // promote to double precision once the density stops changing much
+    if (dfh_->single_precision()) {
+        bool converged = (D_prev_.size() == D_ao_.size());
+        for (size_t i = 0; converged && i < D_ao_.size(); i++) {
+            auto dD = D_ao_[i]->clone();
+            dD->subtract(D_prev_[i]);
+            converged = (dD->rms() < mixed_precision_convergence_);
+        }
+        if (converged) {
+            dfh_->promote_precision();
+            D_prev_.clear();
+        } else {
+            D_prev_.clear();
+            for (size_t i = 0; i < D_ao_.size(); i++) D_prev_.push_back(D_ao_[i]->clone());
+        }
+    }
+
+    reduce_C_rank();
     dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_,
                    max_nocc(), do_J_, do_K_, do_wK_, lr_symmetric_);
 
@@ -119,6 +141,11 @@ void set_do_wK(bool do_wK){
     }
 }
 void MemDFJK::postiterations() {
+    D_prev_.clear();
+}
+void MemDFJK::reset_build_state() {
+    JK::reset_build_state();
+    D_prev_.clear();
 }
 void MemDFJK::print_header() const {
     // dfh_->print_header();
@@ -131,7 +158,11 @@ void MemDFJK::print_header() const {
         if (do_wK_) outfile->Printf("    Omega:              %11.3E\n", omega_);
         outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
         outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
-        outfile->Printf("    Algorithm:          %11s\n", (dfh_->get_AO_core() ? "Core" : "Disk"));
+        outfile->Printf("    Algorithm:          %11s\n",
+                        (local_fitting_ ? "Local" : (dfh_->get_AO_core() ? "Core" : "Disk")));
+        if (ints_cache_) outfile->Printf("    Integral Cache:     %11s\n", "Yes");
+        if (mixed_precision_) outfile->Printf("    Mixed Precision:    %11.0E\n", mixed_precision_convergence_);
+        if (device_offload_) outfile->Printf("    Device K:           %11s\n", "Yes");
         outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
         outfile->Printf("    Mask sparsity (%%):  %11.4f\n", 100. * dfh_->ao_sparsity());
         outfile->Printf("    Fitting Condition:  %11.0E\n\n", condition_);
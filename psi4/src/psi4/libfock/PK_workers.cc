@@ -640,13 +640,13 @@ void PKWrkrReord::write(std::vector<size_t> min_ind, std::vector<size_t> max_ind
         size_t stop = std::min(max_idx() + 1, max_ind[b]);
         psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * sizeof(double));
         size_t nints = stop - start;
-        jobID_J_[buf_].push_back(AIO()->write(target_file(), labels_J_[buf_][i],
-                                              (char *)(&J_bufs_[buf_][start - offset()]), nints * sizeof(double), adr,
-                                              &dummy_));
+        jobID_J_[buf_].push_back(AIO()->write_inplace(target_file(), labels_J_[buf_][i],
+                                                      (char *)(&J_bufs_[buf_][start - offset()]),
+                                                      nints * sizeof(double), adr));
         labels_K_[buf_].push_back(get_label_K(b));
-        jobID_K_[buf_].push_back(AIO()->write(target_file(), labels_K_[buf_][i],
-                                              (char *)(&K_bufs_[buf_][start - offset()]), nints * sizeof(double), adr,
-                                              &dummy_));
+        jobID_K_[buf_].push_back(AIO()->write_inplace(target_file(), labels_K_[buf_][i],
+                                                      (char *)(&K_bufs_[buf_][start - offset()]),
+                                                      nints * sizeof(double), adr));
     }
 
     // Update the buffer being written into
@@ -714,9 +714,9 @@ void PKWrkrReord::write_wK(std::vector<size_t> min_ind, std::vector<size_t> max_
         size_t stop = std::min(max_idx() + 1, max_ind[b]);
         psio_address adr = psio_get_address(PSIO_ZERO, (start - min_ind[b]) * sizeof(double));
         size_t nints = stop - start;
-        jobID_wK_[buf_].push_back(AIO()->write(target_file(), labels_wK_[buf_][i],
-                                               (char *)(&wK_bufs_[buf_][start - offset()]), nints * sizeof(double), adr,
-                                               &dummy_));
+        jobID_wK_[buf_].push_back(AIO()->write_inplace(target_file(), labels_wK_[buf_][i],
+                                                       (char *)(&wK_bufs_[buf_][start - offset()]),
+                                                       nints * sizeof(double), adr));
     }
 
     // Update the buffer being written into
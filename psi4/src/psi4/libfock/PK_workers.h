@@ -395,9 +395,6 @@ private:
     std::vector< double* > K_bufs_;
     std::vector< double* > wK_bufs_;
 
-    /// Dummy psio_address for storage of write return value
-    psio_address dummy_;
-
     /// Internal buffer index
     size_t buf_;
 
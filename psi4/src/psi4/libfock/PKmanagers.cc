@@ -490,15 +490,19 @@ void PKManager::finalize_D() {
 PKMgrDisk::PKMgrDisk(std::shared_ptr<PSIO> psio, std::shared_ptr<BasisSet> primary, size_t memory, Options& options)
     : PKManager(primary, memory, options) {
     psio_ = psio;
-    AIO_ = std::make_shared<AIOHandler>(psio_);
+    writers_ = std::max(1, options.get_int("PK_WRITERS"));
+    AIO_ = std::make_shared<AIOHandler>(psio_, writers_);
     max_batches_ = options.get_int("PK_MAX_BUCKETS");
     pk_file_ = PSIF_SO_PK;
+    full_batches_ = false;
+    build_timed_ = false;
 
     // No current writing since we are constructing
     writing_ = false;
 }
 
 void PKMgrDisk::initialize() {
+    start_build_clock();
     batch_sizing();
     prestripe_files();
     print_batches();
@@ -506,6 +510,7 @@ void PKMgrDisk::initialize() {
 }
 
 void PKMgrDisk::initialize_wK() {
+    start_build_clock();
     prestripe_files_wK();
     print_batches_wK();
     allocate_buffers_wK();
@@ -513,6 +518,7 @@ void PKMgrDisk::initialize_wK() {
 
 void PKMgrDisk::batch_sizing() {
     double batch_thresh = 0.1;
+    size_t batch_mem = (full_batches_ ? memory() : batch_memory());
 
     ijklBasisIterator AOintsiter(nbf(), sieve());
 
@@ -541,7 +547,7 @@ void PKMgrDisk::batch_sizing() {
         } else {
             size_t pqrs = INDEX2(pq, INDEX2(rb, sb));
             nintbatch += nintpq;
-            if (nintbatch > memory()) {
+            if (nintbatch > batch_mem) {
                 batch_index_max_.push_back(old_max);
                 batch_pq_max_.push_back(old_pq);
                 batch_for_pq_.pop_back();
@@ -566,7 +572,7 @@ void PKMgrDisk::batch_sizing() {
     int lastb = batch_index_max_.size() - 1;
     if (lastb > 0) {
         size_t size_lastb = batch_index_max_[lastb] - batch_index_min_[lastb];
-        if (((double)size_lastb / memory()) < batch_thresh) {
+        if (((double)size_lastb / batch_mem) < batch_thresh) {
             batch_index_max_[lastb - 1] = batch_index_max_[lastb];
             batch_pq_max_[lastb - 1] = batch_pq_max_[lastb];
             batch_pq_max_.pop_back();
@@ -581,6 +587,17 @@ void PKMgrDisk::batch_sizing() {
     }
 
     int nbatches = batch_pq_min_.size();
+    if (nbatches > max_batches_ && batch_mem < memory()) {
+        // Smaller batches were only an optimization, use the whole memory instead
+        batch_pq_min_.clear();
+        batch_pq_max_.clear();
+        batch_index_min_.clear();
+        batch_index_max_.clear();
+        batch_for_pq_.clear();
+        full_batches_ = true;
+        batch_sizing();
+        return;
+    }
     if (nbatches > max_batches_) {
         outfile->Printf("  PKJK: maximum number of batches exceeded\n");
         outfile->Printf("  PK computation needs %d batches, max. number: %d\n", nbatches, max_batches_);
@@ -791,6 +808,25 @@ void PKMgrDisk::form_J(std::vector<SharedMatrix> J, std::string exch, std::vecto
     get_results(J, exch);
 }
 
+void PKMgrDisk::start_build_clock() {
+    if (build_timed_) return;
+    build_start_ = std::chrono::steady_clock::now();
+    build_timed_ = true;
+}
+
+void PKMgrDisk::print_build_bandwidth(int nmatrix) {
+    if (!build_timed_) return;
+    build_timed_ = false;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - build_start_).count();
+    size_t nints = 0;
+    for (size_t batch = 0; batch < batch_index_min_.size(); ++batch) {
+        nints += batch_index_max_[batch] - batch_index_min_[batch];
+    }
+    double mib = (double)(nmatrix * nints * sizeof(double)) / (1024.0 * 1024.0);
+    outfile->Printf("  PK build: %d supermatrices, %.1f MiB in %.2f s (%.1f MiB/s, %d writers).\n", nmatrix, mib,
+                    seconds, (seconds > 0.0 ? mib / seconds : 0.0), writers_);
+}
+
 void PKMgrDisk::finalize_JK() {
     finalize_D();
     close_PK_file(true);
@@ -897,6 +933,7 @@ void PKMgrReorder::finalize_PK() {
     timer_on("AIO synchronize");
     AIO()->synchronize();
     timer_off("AIO synchronize");
+    print_build_bandwidth(do_wk() ? 3 : 2);
 
     // Can get rid of the pre-striping labels
     for (int i = 0; i < label_J_.size(); ++i) {
@@ -1195,10 +1232,14 @@ void PKMgrYoshimine::sort_ints(bool wK) {
         if (batch_size > max_size) max_size = batch_size;
     }
 
-    // TODO: other possibility here: have an array half the size to do AIO
-    // Allocate a big array to contain the batch.
-    double* twoel_ints = new double[max_size];
-    ::memset((void*)twoel_ints, '\0', max_size * sizeof(double));
+    // Allocate the arrays to contain the batches. With room for two of them,
+    // each finished batch is written out while the next one is sorted.
+    int nbuf = (2 * max_size <= memory() ? 2 : 1);
+    std::vector<double*> twoel_ints(nbuf);
+    for (int i = 0; i < nbuf; ++i) {
+        twoel_ints[i] = new double[max_size];
+    }
+    ::memset((void*)twoel_ints[0], '\0', max_size * sizeof(double));
 
     // At this point we need to close the IWL file to create
     // an IWL object which will open it. Dumb but minor inconvenience (hopefully)
@@ -1212,7 +1253,7 @@ void PKMgrYoshimine::sort_ints(bool wK) {
         close_iwl_buckets();
         generate_J_PK(twoel_ints, max_size);
         // Need to reset to zero the two-el integral array
-        ::memset((void*)twoel_ints, '\0', max_size * sizeof(double));
+        ::memset((void*)twoel_ints[0], '\0', max_size * sizeof(double));
         generate_K_PK(twoel_ints, max_size);
 
     } else {
@@ -1220,10 +1261,13 @@ void PKMgrYoshimine::sort_ints(bool wK) {
         generate_wK_PK(twoel_ints, max_size);
     }
 
-    // delete two-el int array
-    delete[] twoel_ints;
+    // delete two-el int arrays
+    for (int i = 0; i < nbuf; ++i) {
+        delete[] twoel_ints[i];
+    }
 
     psio()->close(pk_file(), 1);
+    print_build_bandwidth(wK ? 1 : 2);
 }
 
 void PKMgrYoshimine::sort_ints_wK() {
@@ -1231,6 +1275,35 @@ void PKMgrYoshimine::sort_ints_wK() {
     sort_ints(true);
 }
 
+size_t PKMgrYoshimine::batch_memory() const { return (writers() > 1 ? memory() / 2 : memory()); }
+
+double* PKMgrYoshimine::write_batch(const std::vector<double*>& twoel_ints, size_t& cur, char* label,
+                                    size_t nintegrals, size_t max_size, bool more) {
+    sort_jobs_.resize(twoel_ints.size(), 0);
+    sort_labels_.push_back(label);
+    sort_jobs_[cur] = AIO()->write_entry(pk_file(), label, (char*)twoel_ints[cur], nintegrals * sizeof(double));
+    cur = (cur + 1) % twoel_ints.size();
+    // The next buffer can be reused once its previous batch is on disk
+    if (sort_jobs_[cur]) {
+        AIO()->wait_for_job(sort_jobs_[cur]);
+        sort_jobs_[cur] = 0;
+    }
+    if (more) {
+        ::memset((void*)twoel_ints[cur], '\0', max_size * sizeof(double));
+    }
+    return twoel_ints[cur];
+}
+
+void PKMgrYoshimine::finish_batches() {
+    // Also keeps the writes clear of the bucket file being closed
+    AIO()->synchronize();
+    sort_jobs_.clear();
+    for (size_t i = 0; i < sort_labels_.size(); ++i) {
+        delete[] sort_labels_[i];
+    }
+    sort_labels_.clear();
+}
+
 void PKMgrYoshimine::close_iwl_buckets() {
     psio()->close(iwl_file_J_, 1);
     psio()->close(iwl_file_K_, 1);
@@ -1238,7 +1311,7 @@ void PKMgrYoshimine::close_iwl_buckets() {
 
 void PKMgrYoshimine::close_iwl_buckets_wK() { psio()->close(iwl_file_wK_, 1); }
 
-void PKMgrYoshimine::generate_J_PK(double* twoel_ints, size_t max_size) {
+void PKMgrYoshimine::generate_J_PK(const std::vector<double*>& buffers, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_J_, 0.0, 1, 0);
 
     int idx, id;
@@ -1250,6 +1323,9 @@ void PKMgrYoshimine::generate_J_PK(double* twoel_ints, size_t max_size) {
     size_t offset, maxind, nintegrals;
     size_t pqrs;
 
+    size_t cur = 0;
+    double* twoel_ints = buffers[cur];
+
     int batch = 0;
     int nbatches = batch_ind_min().size();
     while (batch < nbatches) {
@@ -1283,19 +1359,16 @@ void PKMgrYoshimine::generate_J_PK(double* twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq, pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
-            delete[] label;
             ++batch;
-            if (batch < nbatches) {
-                ::memset((void*)twoel_ints, '\0', max_size * sizeof(double));
-            }
+            twoel_ints = write_batch(buffers, cur, label, nintegrals, max_size, batch < nbatches);
         }
     }
 
+    finish_batches();
     inbuf.set_keep_flag(false);
 }
 
-void PKMgrYoshimine::generate_K_PK(double* twoel_ints, size_t max_size) {
+void PKMgrYoshimine::generate_K_PK(const std::vector<double*>& buffers, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_K_, 0.0, 1, 0);
 
     int idx, id;
@@ -1307,6 +1380,9 @@ void PKMgrYoshimine::generate_K_PK(double* twoel_ints, size_t max_size) {
     size_t offset, maxind, nintegrals;
     size_t pqrs;
 
+    size_t cur = 0;
+    double* twoel_ints = buffers[cur];
+
     int batch = 0;
     int nbatches = batch_ind_min().size();
     while (batch < nbatches) {
@@ -1363,19 +1439,16 @@ void PKMgrYoshimine::generate_K_PK(double* twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq, pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
-            delete[] label;
             ++batch;
-            if (batch < nbatches) {
-                ::memset((void*)twoel_ints, '\0', max_size * sizeof(double));
-            }
+            twoel_ints = write_batch(buffers, cur, label, nintegrals, max_size, batch < nbatches);
         }
     }
 
+    finish_batches();
     inbuf.set_keep_flag(false);
 }
 
-void PKMgrYoshimine::generate_wK_PK(double* twoel_ints, size_t max_size) {
+void PKMgrYoshimine::generate_wK_PK(const std::vector<double*>& buffers, size_t max_size) {
     IWL inbuf(psio().get(), iwl_file_wK_, 0.0, 1, 0);
 
     int idx, id;
@@ -1387,6 +1460,9 @@ void PKMgrYoshimine::generate_wK_PK(double* twoel_ints, size_t max_size) {
     size_t offset, maxind, nintegrals;
     size_t pqrs;
 
+    size_t cur = 0;
+    double* twoel_ints = buffers[cur];
+
     int batch = 0;
     int nbatches = batch_ind_min().size();
     while (batch < nbatches) {
@@ -1420,15 +1496,12 @@ void PKMgrYoshimine::generate_wK_PK(double* twoel_ints, size_t max_size) {
                 pqrs = INDEX2(pq, pq);
                 twoel_ints[pqrs - offset] *= 0.5;
             }
-            psio()->write_entry(pk_file(), label, (char*)twoel_ints, nintegrals * sizeof(double));
-            delete[] label;
             ++batch;
-            if (batch < nbatches) {
-                ::memset((void*)twoel_ints, '\0', max_size * sizeof(double));
-            }
+            twoel_ints = write_batch(buffers, cur, label, nintegrals, max_size, batch < nbatches);
         }
     }
 
+    finish_batches();
     inbuf.set_keep_flag(false);
 }
 
@@ -1508,114 +1581,25 @@ void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vec
     make_J_vec(J);
 
     for (int N = 0; N < J.size(); ++N) {
-        double* j_ptr;
-        if (exch == "K") {
-            j_ptr = K_ints_.get();
-        } else {
-            j_ptr = J_ints_.get();
-        }
-        // TODO We should totally parallelize this loop now.
         // Symmetric density matrix case
         if (is_sym(N) && exch != "wK") {
-            double* J_vec = JK_glob_vecs(N);
-            double* D_vec = D_glob_vecs(N);
-            for (size_t pq = 0; pq < pk_pairs(); ++pq) {
-                double D_pq = D_vec[pq];
-                double* D_rs = D_vec;
-                double J_pq = 0.0;
-                double* J_rs = J_vec;
-                for (size_t rs = 0; rs <= pq; ++rs) {
-                    // DEBUG               if(!exch && rs == 0) {
-                    // DEBUG                 outfile->Printf("PK int (%lu|%lu) = %20.16f\n",pq,rs,*j_ptr);
-                    // DEBUG               }
-                    J_pq += *j_ptr * (*D_rs);
-                    *J_rs += *j_ptr * D_pq;
-                    ++D_rs;
-                    ++J_rs;
-                    ++j_ptr;
-                }
-                J_vec[pq] += J_pq;
-            }
-
-            // TODO ? Fuse J and K loops ?
+            contract_sym(exch == "K" ? K_ints_.get() : J_ints_.get(), D_glob_vecs(N), JK_glob_vecs(N));
             // Non-symmetric density matrix
         } else if (exch == "" || exch == "wK") {
             if (exch == "") {
-                double* D_vec = D_glob_vecs(N);
-                double** J_vec = J[N]->pointer();
-                for (int p = 0; p < nbf(); ++p) {
-                    int poffs = p * nbf();
-                    for (int q = 0; q <= p; ++q) {
-                        int qoffs = q * nbf();
-                        for (int r = 0; r <= p; ++r) {
-                            int roffs = r * nbf();
-                            int maxs = (r == p) ? q : r;
-                            for (int s = 0; s <= maxs; ++s) {
-                                J_vec[p][q] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                                J_vec[q][p] += *j_ptr * (D_vec[roffs + s] + D_vec[s * nbf() + r]);
-                                J_vec[r][s] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                                J_vec[s][r] += *j_ptr * (D_vec[poffs + q] + D_vec[qoffs + p]);
-                                ++j_ptr;
-                            }
-                        }
-                    }
-                }
+                contract_J_nonsym(J_ints_.get(), D_glob_vecs(N), J[N]);
             }
             // Since we just read a batch, might as well compute K
             // Primitive algorithm, just contract integrals with appropriate
             // element on the fly. Might be faster than reading/writing the appropriate
             // PK supermatrix
             if (K.size() || exch == "wK") {
-                double** Dmat = original_D(N)->pointer();
-                double** K_vec;
                 if (exch == "wK") {
-                    K_vec = J[N]->pointer();
-                    j_ptr = wK_ints_.get();
+                    contract_K_nonsym(wK_ints_.get(), original_D(N), J[N]);
                 } else {
-                    K_vec = K[N]->pointer();
                     // We use J supermatrix because it contains every unique integral
                     // K supermatrix has summed some integrals that we need separately
-                    j_ptr = J_ints_.get();
-                }
-                for (int p = 0; p < nbf(); ++p) {
-                    //        int poffs = p * nbf();
-                    for (int q = 0; q <= p; ++q) {
-                        //          int qoffs = q * nbf();
-                        for (int r = 0; r <= p; ++r) {
-                            //            int roffs = r * nbf();
-                            int maxs = (r == p) ? q : r;
-                            for (int s = 0; s <= maxs; ++s) {
-                                // Need ugly factors for now. A better solution would be great.
-                                double fac = 1.0;
-                                //              int soffs = s * nbf();
-                                if (p == q && r == s && p == r) {
-                                    fac = 0.25;  // Divide only be 4, PK stores integral with a
-                                    // factor 0.5 on the (pq|pq) diagonal.
-                                } else if ((p == q && q == r) || (q == r && r == s)) {
-                                    fac = 0.5;
-                                } else if (p == q && r == s) {
-                                    fac = 0.25;
-                                } else if (p == q || r == s) {
-                                    fac = 0.5;
-                                }
-                                // DEBUG                       bool prt = (p == 0 && r == 0) || (q == 0 && r == 0) || (p
-                                // == 0 && s == 0) || (s == 0 && q == 0);
-                                // DEBUG                       if(exch == "wK" && prt) {
-                                // DEBUG                         outfile->Printf("PK int (%d %d|%d %d) =
-                                // %20.16f\n",p,q,r,s,*j_ptr);
-                                // DEBUG                       }
-                                K_vec[p][r] += (*j_ptr) * fac * Dmat[q][s];
-                                K_vec[r][p] += (*j_ptr) * fac * Dmat[s][q];
-                                K_vec[q][r] += (*j_ptr) * fac * Dmat[p][s];
-                                K_vec[p][s] += (*j_ptr) * fac * Dmat[q][r];
-                                K_vec[s][p] += (*j_ptr) * fac * Dmat[r][q];
-                                K_vec[r][q] += (*j_ptr) * fac * Dmat[s][p];
-                                K_vec[s][q] += (*j_ptr) * fac * Dmat[r][p];
-                                K_vec[q][s] += (*j_ptr) * fac * Dmat[p][r];
-                                ++j_ptr;
-                            }
-                        }
-                    }
+                    contract_K_nonsym(J_ints_.get(), original_D(N), K[N]);
                 }
             }
 
@@ -1625,6 +1609,140 @@ void PKMgrInCore::form_J(std::vector<SharedMatrix> J, std::string exch, std::vec
     get_results(J, exch);
 }
 
+void PKMgrInCore::zero_thread_buffers(size_t size) {
+    // All of them, in case a parallel region gets fewer threads than asked for
+    thread_JK_.resize(nthreads());
+    for (auto& buf : thread_JK_) buf.assign(size, 0.0);
+}
+
+void PKMgrInCore::reduce_thread_buffers(double* target, size_t size) {
+    int nthread = nthreads();
+#pragma omp parallel for num_threads(nthread) schedule(static)
+    for (size_t i = 0; i < size; ++i) {
+        double sum = 0.0;
+        for (int t = 0; t < nthread; ++t) sum += thread_JK_[t][i];
+        target[i] += sum;
+    }
+}
+
+void PKMgrInCore::contract_sym(const double* ints, const double* D_vec, double* JK_vec) {
+    size_t npairs = pk_pairs();
+
+    // Row pq of the packed triangle holds (pq|rs) for rs <= pq. Each thread sums the
+    // scattered rs updates of its rows in a private vector, reduced afterwards.
+    zero_thread_buffers(npairs);
+#pragma omp parallel num_threads(nthreads())
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double* JK_loc = thread_JK_[thread].data();
+#pragma omp for schedule(dynamic, 8)
+        for (size_t pq = 0; pq < npairs; ++pq) {
+            const double* row = ints + pq * (pq + 1) / 2;
+            double D_pq = D_vec[pq];
+            double JK_pq = 0.0;
+#pragma omp simd reduction(+ : JK_pq)
+            for (size_t rs = 0; rs <= pq; ++rs) {
+                JK_pq += row[rs] * D_vec[rs];
+                JK_loc[rs] += row[rs] * D_pq;
+            }
+            JK_loc[pq] += JK_pq;
+        }
+    }
+    reduce_thread_buffers(JK_vec, npairs);
+}
+
+void PKMgrInCore::contract_J_nonsym(const double* ints, const double* D_vec, SharedMatrix J) {
+    int n = nbf();
+
+    // The integrals of the pairs (p, q <= p) start at the packed row of (p, 0)
+    zero_thread_buffers((size_t)n * n);
+#pragma omp parallel num_threads(nthreads())
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double* J_loc = thread_JK_[thread].data();
+#pragma omp for schedule(dynamic, 1)
+        for (int p = 0; p < n; ++p) {
+            size_t pq0 = (size_t)p * (p + 1) / 2;
+            const double* j_ptr = ints + pq0 * (pq0 + 1) / 2;
+            int poffs = p * n;
+            for (int q = 0; q <= p; ++q) {
+                int qoffs = q * n;
+                double D_pq = D_vec[poffs + q] + D_vec[qoffs + p];
+                double J_pq = 0.0;
+                for (int r = 0; r <= p; ++r) {
+                    int roffs = r * n;
+                    int maxs = (r == p) ? q : r;
+                    for (int s = 0; s <= maxs; ++s) {
+                        J_pq += *j_ptr * (D_vec[roffs + s] + D_vec[s * n + r]);
+                        J_loc[roffs + s] += *j_ptr * D_pq;
+                        J_loc[s * n + r] += *j_ptr * D_pq;
+                        ++j_ptr;
+                    }
+                }
+                J_loc[poffs + q] += J_pq;
+                J_loc[qoffs + p] += J_pq;
+            }
+        }
+    }
+    reduce_thread_buffers(J->pointer()[0], (size_t)n * n);
+}
+
+void PKMgrInCore::contract_K_nonsym(const double* ints, SharedMatrix D, SharedMatrix K) {
+    int n = nbf();
+    double** Dmat = D->pointer();
+
+    zero_thread_buffers((size_t)n * n);
+#pragma omp parallel num_threads(nthreads())
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double* K_loc = thread_JK_[thread].data();
+#pragma omp for schedule(dynamic, 1)
+        for (int p = 0; p < n; ++p) {
+            size_t pq0 = (size_t)p * (p + 1) / 2;
+            const double* j_ptr = ints + pq0 * (pq0 + 1) / 2;
+            for (int q = 0; q <= p; ++q) {
+                for (int r = 0; r <= p; ++r) {
+                    int maxs = (r == p) ? q : r;
+                    for (int s = 0; s <= maxs; ++s) {
+                        // Need ugly factors for now. A better solution would be great.
+                        double fac = 1.0;
+                        if (p == q && r == s && p == r) {
+                            fac = 0.25;  // Divide only be 4, PK stores integral with a
+                            // factor 0.5 on the (pq|pq) diagonal.
+                        } else if ((p == q && q == r) || (q == r && r == s)) {
+                            fac = 0.5;
+                        } else if (p == q && r == s) {
+                            fac = 0.25;
+                        } else if (p == q || r == s) {
+                            fac = 0.5;
+                        }
+                        double val = (*j_ptr) * fac;
+                        K_loc[p * n + r] += val * Dmat[q][s];
+                        K_loc[r * n + p] += val * Dmat[s][q];
+                        K_loc[q * n + r] += val * Dmat[p][s];
+                        K_loc[p * n + s] += val * Dmat[q][r];
+                        K_loc[s * n + p] += val * Dmat[r][q];
+                        K_loc[r * n + q] += val * Dmat[s][p];
+                        K_loc[s * n + q] += val * Dmat[r][p];
+                        K_loc[q * n + s] += val * Dmat[p][r];
+                        ++j_ptr;
+                    }
+                }
+            }
+        }
+    }
+    reduce_thread_buffers(K->pointer()[0], (size_t)n * n);
+}
+
 void PKMgrInCore::finalize_JK() { finalize_D(); }
 
 }  // End namespace pk
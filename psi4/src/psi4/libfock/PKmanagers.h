@@ -32,6 +32,7 @@
 //TODO Const correctness of everything
 #include "psi4/libmints/typedefs.h"
 #include <psi4/libpsio/psio.hpp>
+#include <chrono>
 #include <vector>
 
 namespace psi {
@@ -274,6 +275,14 @@ private:
     int pk_file_;
     /// Is there any pending AIO writing ?
     bool writing_;
+    /// Number of AIO requests allowed in flight while building PK
+    int writers_;
+    /// Were the batches sized with the whole memory after batch_memory() gave too many?
+    bool full_batches_;
+    /// Start of the current PK build, see start_build_clock()
+    std::chrono::steady_clock::time_point build_start_;
+    /// Is a PK build being timed?
+    bool build_timed_;
 
 public:
     /// Constructor for PKMgrDisk
@@ -286,6 +295,8 @@ public:
     void set_writing(bool tmp) { writing_ = tmp; }
     bool writing()  const { return writing_; }
     int pk_file() const { return pk_file_; }
+    int writers() const { return writers_; }
+    bool full_batches() const { return full_batches_; }
     std::vector< size_t >& batch_ind_min() { return batch_index_min_;}
     std::vector< size_t >& batch_ind_max() { return batch_index_max_;}
     std::vector< size_t >& batch_pq_min() { return batch_pq_min_;}
@@ -308,6 +319,9 @@ public:
     virtual void prepare_JK(std::vector<SharedMatrix> D, std::vector<SharedMatrix> Cl,
                             std::vector<SharedMatrix> Cr);
 
+    /// Number of integrals a batch may hold, memory() unless the algorithm
+    /// needs room for more than one batch at a time
+    virtual size_t batch_memory() const { return memory(); }
     /// Determining the batch sizes
     void batch_sizing();
     /// Printing out the batches
@@ -334,6 +348,12 @@ public:
 
     /// Finalize JK matrix formation
     virtual void finalize_JK();
+
+    /// Start timing a PK build, unless one is already being timed
+    void start_build_clock();
+    /// Stop timing the PK build and print the effective bandwidth at
+    /// which nmatrix supermatrices reached the disk
+    void print_build_bandwidth(int nmatrix);
 };
 
 /**
@@ -345,8 +365,9 @@ public:
  * For low memory, Yoshimine is recommended and selected automatically
  * by the build_PKManager constructor.
  *
- * This routine uses OMP multithreading. A dedicated thread generated by
- * AIOHandler handles all disk I/O
+ * This routine uses OMP multithreading. Disk I/O is handled by up to
+ * PK_WRITERS threads of AIOHandler; since the PK file is pre-striped, the
+ * buffers of different threads are written into it concurrently.
  */
 
 class PKMgrReorder : public PKMgrDisk {
@@ -398,7 +419,10 @@ public:
  *
  * This routine takes advantage of OMP parallelization, then
  * each thread has N little buffers. All disk writing is handled
- * by a dedicated thread generated by AIOHandler
+ * by up to PK_WRITERS threads of AIOHandler, so the J and K bucket
+ * files are filled concurrently. With more than one writer, batches
+ * are sized to half the memory so that each finished batch of the
+ * sort is written out while the next one is being sorted.
  */
 
 class PKMgrYoshimine : public PKMgrDisk {
@@ -414,6 +438,18 @@ private:
     /// Total size of one IWL buffer on disk in bytes
     size_t iwl_int_size_;
 
+    /// Pending AIO write of the batch in each sort buffer, 0 if none
+    std::vector<size_t> sort_jobs_;
+    /// Labels of the batches written by the sort, freed by finish_batches()
+    std::vector<char*> sort_labels_;
+
+    /// Queue the write of the batch in buffer cur under label and move cur to
+    /// the next buffer, cleared for the next batch if more follow. Returns the new buffer.
+    double* write_batch(const std::vector<double*>& twoel_ints, size_t& cur, char* label,
+                        size_t nintegrals, size_t max_size, bool more);
+    /// Wait for all batches written by the sort
+    void finish_batches();
+
 public:
     /// Constructor
     PKMgrYoshimine(std::shared_ptr<PSIO> psio, std::shared_ptr<BasisSet> primary,
@@ -447,6 +483,9 @@ public:
     /// Writing of the last partially filled buffers for wK
     virtual void write_wK();
 
+    /// Half the memory with several writers, to double-buffer the sort
+    virtual size_t batch_memory() const;
+
     /// Reading and sorting integrals to generate PK file
     void sort_ints(bool wK = false);
     /// Reading and sorting wK integrals for PK file
@@ -457,12 +496,13 @@ public:
     /// Close the IWL bucket file for wK
     void close_iwl_buckets_wK();
 
-    /// Generate the J PK supermatrix from IWL integrals
-    void generate_J_PK(double* twoel_ints, size_t max_size);
+    /// Generate the J PK supermatrix from IWL integrals, alternating
+    /// between the batch buffers
+    void generate_J_PK(const std::vector<double*>& buffers, size_t max_size);
     /// Generate the K PK supermatrix from IWL integrals
-    void generate_K_PK(double* twoel_ints, size_t max_size);
+    void generate_K_PK(const std::vector<double*>& buffers, size_t max_size);
     /// Generate the wK PK supermatrix from IWL integrals
-    void generate_wK_PK(double* twoel_ints, size_t max_size);
+    void generate_wK_PK(const std::vector<double*>& buffers, size_t max_size);
 };
 
 /* PKMgrInCore: Class to manage in-core PK algorithm */
@@ -482,6 +522,19 @@ private:
     std::unique_ptr<double []> J_ints_;
     std::unique_ptr<double []> K_ints_;
     std::unique_ptr<double []> wK_ints_;
+    /// Per-thread J/K accumulators for the contractions, kept between calls
+    std::vector<std::vector<double>> thread_JK_;
+
+    /// Zeroes one accumulator of the given size per thread
+    void zero_thread_buffers(size_t size);
+    /// Adds the per-thread accumulators into target
+    void reduce_thread_buffers(double* target, size_t size);
+    /// Contracts the packed supermatrix with a packed symmetric density
+    void contract_sym(const double* ints, const double* D_vec, double* JK_vec);
+    /// Coulomb contraction with a non-symmetric density
+    void contract_J_nonsym(const double* ints, const double* D_vec, SharedMatrix J);
+    /// Exchange contraction with a non-symmetric density, from the unsummed integrals
+    void contract_K_nonsym(const double* ints, SharedMatrix D, SharedMatrix K);
 
 public:
     /// Constructor for in-core class
@@ -0,0 +1,176 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libqt/qt.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/lib3index/dfhelper.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libfock/cubature.h"
+#include "psi4/libfock/points.h"
+
+#include "jk.h"
+
+#include "psi4/libpsi4util/PsiOutStream.h"
+#ifdef _OPENMP
+#include <omp.h>
+#include "psi4/libpsi4util/process.h"
+#endif
+
+using namespace psi;
+
+namespace psi {
+
+PSJK::PSJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options)
+    : COSJK(primary, auxiliary, options) {
+    spherical_points_ = options_.get_int("PS_SPHERICAL_POINTS");
+    radial_points_ = options_.get_int("PS_RADIAL_POINTS");
+    kcutoff_ = options_.get_double("PS_INTS_TOLERANCE");
+    fit_condition_ = options_.get_double("PS_FITTING_CONDITION");
+}
+PSJK::~PSJK() {}
+void PSJK::print_header() const {
+    if (print_) {
+        outfile->Printf("  ==> PSJK: Density-Fitted J, Pseudospectral K <==\n\n");
+
+        outfile->Printf("    J tasked:           %11s\n", (do_J_ ? "Yes" : "No"));
+        outfile->Printf("    K tasked:           %11s\n", (do_K_ ? "Yes" : "No"));
+        outfile->Printf("    wK tasked:          %11s\n", (do_wK_ ? "Yes" : "No"));
+        outfile->Printf("    OpenMP threads:     %11d\n", omp_nthread_);
+        outfile->Printf("    Memory [MiB]:       %11ld\n", (memory_ * 8L) / (1024L * 1024L));
+        outfile->Printf("    Schwarz Cutoff:     %11.0E\n", cutoff_);
+        outfile->Printf("    Fitting Condition:  %11.0E\n", condition_);
+        outfile->Printf("    K Grid (rad, sph):  %5d, %5d\n", radial_points_, spherical_points_);
+        if (grid_) outfile->Printf("    K Grid Points:      %11zu\n", (size_t)grid_->npoints());
+        outfile->Printf("    K Pair Cutoff:      %11.0E\n", kcutoff_);
+        outfile->Printf("    K Fit Condition:    %11.0E\n\n", fit_condition_);
+
+        outfile->Printf("   => Auxiliary Basis Set <=\n\n");
+        auxiliary_->print_by_level("outfile", print_);
+    }
+}
+void PSJK::build_grid() {
+    // The grid reads the PS_ options itself
+    grid_ = std::make_shared<PseudospectralGrid>(primary_->molecule(), primary_, options_);
+}
+void PSJK::preiterations() {
+    COSJK::preiterations();
+    build_fit();
+}
+void PSJK::build_fit() {
+    int nbf = primary_->nbf();
+    int max_points = grid_->max_points();
+    int max_functions = grid_->max_functions();
+    const std::vector<std::shared_ptr<BlockOPoints> >& blocks = grid_->blocks();
+
+    // => Q_mn = \sum_g w_g phi_m(g) phi_n(g) <= //
+
+    std::vector<SharedMatrix> QT(omp_nthread_);
+    std::vector<SharedMatrix> wphiT(omp_nthread_);
+    std::vector<SharedMatrix> QlocT(omp_nthread_);
+    for (int thread = 0; thread < omp_nthread_; thread++) {
+        QT[thread] = std::make_shared<Matrix>("QT", nbf, nbf);
+        wphiT[thread] = std::make_shared<Matrix>("wphiT", max_points, max_functions);
+        QlocT[thread] = std::make_shared<Matrix>("QlocT", max_functions, max_functions);
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(omp_nthread_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        int npoints = block->npoints();
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+        if (nlocal == 0) continue;
+        double* w = block->w();
+
+        point_workers_[rank]->compute_functions(block);
+        double** phip = point_workers_[rank]->basis_value("PHI")->pointer();
+        size_t coll_funcs = point_workers_[rank]->basis_value("PHI")->ncol();
+
+        double** wphip = wphiT[rank]->pointer();
+        for (int P = 0; P < npoints; P++) {
+            for (int ml = 0; ml < nlocal; ml++) {
+                wphip[P][ml] = w[P] * phip[P][ml];
+            }
+        }
+
+        double** Qlocp = QlocT[rank]->pointer();
+        double** Qp = QT[rank]->pointer();
+        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, wphip[0], max_functions, phip[0], coll_funcs, 0.0, Qlocp[0],
+                max_functions);
+        for (int ml = 0; ml < nlocal; ml++) {
+            for (int nl = 0; nl < nlocal; nl++) {
+                Qp[function_map[ml]][function_map[nl]] += Qlocp[ml][nl];
+            }
+        }
+    }
+
+    auto Qnum = std::make_shared<Matrix>("Q", nbf, nbf);
+    for (int thread = 0; thread < omp_nthread_; thread++) Qnum->add(QT[thread]);
+    Qnum->hermitivitize();
+    Qnum->power(-1.0, fit_condition_);
+
+    // => S Q^-1 <= //
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    std::unique_ptr<OneBodyAOInt> Sint(factory->ao_overlap());
+    auto S = std::make_shared<Matrix>("S", nbf, nbf);
+    Sint->compute(S);
+
+    fit_ = Matrix::doublet(S, Qnum);
+}
+void PSJK::compute_JK() {
+    if (do_J_) {
+        dfh_->build_JK(C_left_ao_, C_right_ao_, D_ao_, J_ao_, K_ao_, max_nocc(), true, false, false, lr_symmetric_);
+    }
+    if (do_K_) {
+        build_K(D_ao_, K_ao_);
+        for (size_t ind = 0; ind < K_ao_.size(); ind++) {
+            SharedMatrix K = Matrix::doublet(fit_, K_ao_[ind]);
+            K_ao_[ind]->copy(K);
+            // S Q^-1 is not symmetric, so neither is the fitted K
+            if (lr_symmetric_) K_ao_[ind]->hermitivitize();
+        }
+    }
+}
+void PSJK::postiterations() {
+    COSJK::postiterations();
+    fit_.reset();
+}
+
+}  // namespace psi
@@ -1251,8 +1251,8 @@ double RTDHF::compute_energy()
     return 0.0;
 }
 
-RCPKS::RCPKS(SharedWavefunction ref_wfn, Options& options) :
-             RCPHF(ref_wfn, options)
+RCPKS::RCPKS(SharedWavefunction ref_wfn, Options& options, bool use_symmetry) :
+             RCPHF(ref_wfn, options, use_symmetry)
 {
 }
 RCPKS::~RCPKS()
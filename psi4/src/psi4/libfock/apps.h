@@ -91,8 +91,8 @@ public:
     void set_jk(std::shared_ptr<JK> jk) { jk_ = jk; }
     /// Gets a handle to the VBase object, if built by preiterations
     std::shared_ptr<VBase> v() const { return v_;}
-    /// Set the VBase object, say from SCF (except that wouldn't work, right?)
-    void set_jk(std::shared_ptr<VBase> v) { v_ = v; }
+    /// Set the VBase object, say from SCF
+    void set_v(std::shared_ptr<VBase> v) { v_ = v; }
     /// Builds JK object, if needed
     virtual void preiterations();
     /// Destroys JK object, if needed
@@ -228,7 +228,7 @@ protected:
     virtual void print_header();
 
 public:
-    RCPKS(SharedWavefunction ref_wfn, Options& options);
+    RCPKS(SharedWavefunction ref_wfn, Options& options, bool use_symmetry=true);
     virtual ~RCPKS();
 
     virtual double compute_energy();
@@ -0,0 +1,527 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libfock/cfmm.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/multipoles.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/vector3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+CFMMTree::CFMMTree(std::shared_ptr<BasisSet> primary, std::shared_ptr<ERISieve> sieve, int order,
+                   double extent_cutoff)
+    : primary_(primary),
+      sieve_(sieve),
+      order_(order),
+      leaf_size_(16),
+      extent_cutoff_(extent_cutoff),
+      near_quartets_(0L),
+      far_interactions_(0L) {
+    nmult_ = (order_ + 1) * (order_ + 2) * (order_ + 3) / 6;
+    build_tables();
+    build_pairs();
+
+    // => Octree <= //
+
+    std::vector<int> all_pairs(pairs_.size());
+    for (size_t PQ = 0; PQ < pairs_.size(); PQ++) all_pairs[PQ] = PQ;
+
+    double lo[3] = {0.0, 0.0, 0.0};
+    double hi[3] = {0.0, 0.0, 0.0};
+    for (size_t PQ = 0; PQ < pairs_.size(); PQ++) {
+        for (int k = 0; k < 3; k++) {
+            double c = pair_centers_[3 * PQ + k];
+            lo[k] = (PQ == 0 ? c : std::min(lo[k], c));
+            hi[k] = (PQ == 0 ? c : std::max(hi[k], c));
+        }
+    }
+    Node root;
+    root.half_width = 0.0;
+    for (int k = 0; k < 3; k++) {
+        root.center[k] = 0.5 * (lo[k] + hi[k]);
+        root.half_width = std::max(root.half_width, 0.5 * (hi[k] - lo[k]));
+    }
+    // Pad so pairs on the faces fall cleanly into an octant
+    root.half_width = root.half_width * 1.0001 + 1.0E-8;
+    nodes_.push_back(root);
+    build_node(0, all_pairs, 0);
+}
+CFMMTree::~CFMMTree() {}
+int CFMMTree::component(int lx, int ly, int lz) {
+    if (lx + ly + lz == 0) return 0;
+    return MultipoleInt::address(lx, ly, lz) + 1;
+}
+void CFMMTree::build_tables() {
+    lx_.resize(nmult_);
+    ly_.resize(nmult_);
+    lz_.resize(nmult_);
+    for (int l = 0; l <= order_; l++) {
+        for (int ii = 0; ii <= l; ii++) {
+            int lx = l - ii;
+            for (int lz = 0; lz <= ii; lz++) {
+                int ly = ii - lz;
+                int a = component(lx, ly, lz);
+                lx_[a] = lx;
+                ly_[a] = ly;
+                lz_[a] = lz;
+            }
+        }
+    }
+
+    std::vector<double> fact(order_ + 1, 1.0);
+    for (int n = 1; n <= order_; n++) fact[n] = fact[n - 1] * n;
+    auto binom = [&fact](int n, int k) { return fact[n] / (fact[k] * fact[n - k]); };
+
+    // > Local expansion: L_a = sum_b (-1)^|b| / (a! b!) M_b d^(a+b) 1/|R| < //
+
+    int n1 = order_ + 1;
+    local_b_.assign(nmult_, std::vector<int>());
+    local_T_.assign(nmult_, std::vector<int>());
+    local_coef_.assign(nmult_, std::vector<double>());
+    for (int a = 0; a < nmult_; a++) {
+        int la = lx_[a] + ly_[a] + lz_[a];
+        for (int b = 0; b < nmult_; b++) {
+            int lb = lx_[b] + ly_[b] + lz_[b];
+            if (la + lb > order_) continue;
+            local_b_[a].push_back(b);
+            local_T_[a].push_back(((lx_[a] + lx_[b]) * n1 + ly_[a] + ly_[b]) * n1 + lz_[a] + lz_[b]);
+            double sign = (lb % 2 ? -1.0 : 1.0);
+            local_coef_[a].push_back(sign / (fact[lx_[a]] * fact[ly_[a]] * fact[lz_[a]] * fact[lx_[b]] *
+                                             fact[ly_[b]] * fact[lz_[b]]));
+        }
+    }
+
+    // > Translation: (r - B')^b = sum_c binom(b, c) (r - B)^c (B - B')^(b - c) < //
+
+    shift_c_.assign(nmult_, std::vector<int>());
+    shift_coef_.assign(nmult_, std::vector<double>());
+    for (int b = 0; b < nmult_; b++) {
+        for (int c = 0; c < nmult_; c++) {
+            if (lx_[c] > lx_[b] || ly_[c] > ly_[b] || lz_[c] > lz_[b]) continue;
+            shift_c_[b].push_back(c);
+            shift_coef_[b].push_back(binom(lx_[b], lx_[c]) * binom(ly_[b], ly_[c]) * binom(lz_[b], lz_[c]));
+        }
+    }
+}
+void CFMMTree::build_pairs() {
+    pairs_ = sieve_->shell_pairs();
+    size_t npair = pairs_.size();
+    pair_centers_.assign(3 * npair, 0.0);
+    pair_extents_.assign(npair, 0.0);
+    pair_moments_.assign(npair, std::vector<double>());
+
+    auto factory = std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
+    std::shared_ptr<OneBodyAOInt> sint(factory->ao_overlap());
+    std::shared_ptr<OneBodyAOInt> mint;
+    if (order_ > 0) mint = std::shared_ptr<OneBodyAOInt>(factory->ao_multipoles(order_));
+
+    double log_cutoff = -std::log(extent_cutoff_);
+
+    for (size_t PQ = 0; PQ < npair; PQ++) {
+        int P = pairs_[PQ].first;
+        int Q = pairs_[PQ].second;
+        const GaussianShell& Pshell = primary_->shell(P);
+        const GaussianShell& Qshell = primary_->shell(Q);
+        const double* A = Pshell.center();
+        const double* B = Qshell.center();
+        double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]);
+
+        // => Center: primitive product centers weighted by their prefactors <= //
+
+        double* C = &pair_centers_[3 * PQ];
+        double wsum = 0.0;
+        for (int p1 = 0; p1 < Pshell.nprimitive(); p1++) {
+            for (int p2 = 0; p2 < Qshell.nprimitive(); p2++) {
+                double a1 = Pshell.exp(p1);
+                double a2 = Qshell.exp(p2);
+                double gamma = a1 + a2;
+                double w = std::fabs(Pshell.coef(p1) * Qshell.coef(p2)) * std::exp(-a1 * a2 * AB2 / gamma) *
+                           std::pow(M_PI / gamma, 1.5);
+                for (int k = 0; k < 3; k++) C[k] += w * (a1 * A[k] + a2 * B[k]) / gamma;
+                wsum += w;
+            }
+        }
+        for (int k = 0; k < 3; k++) C[k] = (wsum > 0.0 ? C[k] / wsum : 0.5 * (A[k] + B[k]));
+
+        // => Extent: the largest radius any primitive product reaches <= //
+
+        double extent = 0.0;
+        for (int p1 = 0; p1 < Pshell.nprimitive(); p1++) {
+            for (int p2 = 0; p2 < Qshell.nprimitive(); p2++) {
+                double a1 = Pshell.exp(p1);
+                double a2 = Qshell.exp(p2);
+                double gamma = a1 + a2;
+                double dist2 = 0.0;
+                for (int k = 0; k < 3; k++) {
+                    double d = (a1 * A[k] + a2 * B[k]) / gamma - C[k];
+                    dist2 += d * d;
+                }
+                extent = std::max(extent, std::sqrt(dist2) + std::sqrt(log_cutoff / gamma));
+            }
+        }
+        pair_extents_[PQ] = extent;
+
+        // => Moments about the pair center <= //
+
+        int nP = Pshell.nfunction();
+        int nQ = Qshell.nfunction();
+        std::vector<double>& moments = pair_moments_[PQ];
+        moments.assign(nP * (size_t)nQ * nmult_, 0.0);
+
+        sint->compute_shell(P, Q);
+        const double* sbuffer = sint->buffer();
+        for (int pq = 0; pq < nP * nQ; pq++) moments[pq * (size_t)nmult_] = sbuffer[pq];
+
+        if (order_ > 0) {
+            mint->set_origin(Vector3(C[0], C[1], C[2]));
+            mint->compute_shell(P, Q);
+            const double* mbuffer = mint->buffer();
+            // MultipoleInt carries the electron's negative charge
+            for (int k = 1; k < nmult_; k++) {
+                for (int pq = 0; pq < nP * nQ; pq++) {
+                    moments[pq * (size_t)nmult_ + k] = -mbuffer[(k - 1) * (size_t)(nP * nQ) + pq];
+                }
+            }
+        }
+    }
+}
+void CFMMTree::build_node(int node, std::vector<int>& pairs, int level) {
+    if (pairs.size() <= (size_t)leaf_size_ || level >= 12) {
+        nodes_[node].pairs = pairs;
+    } else {
+        std::vector<std::vector<int> > octants(8);
+        for (int PQ : pairs) {
+            int oct = 0;
+            for (int k = 0; k < 3; k++) {
+                if (pair_centers_[3 * PQ + k] >= nodes_[node].center[k]) oct |= (1 << k);
+            }
+            octants[oct].push_back(PQ);
+        }
+        for (int oct = 0; oct < 8; oct++) {
+            if (octants[oct].empty()) continue;
+            Node child;
+            child.half_width = 0.5 * nodes_[node].half_width;
+            for (int k = 0; k < 3; k++) {
+                child.center[k] = nodes_[node].center[k] + ((oct >> k) & 1 ? 1.0 : -1.0) * child.half_width;
+            }
+            int index = nodes_.size();
+            nodes_.push_back(child);
+            nodes_[node].children.push_back(index);
+            build_node(index, octants[oct], level + 1);
+        }
+    }
+
+    // => Radius enclosing all extents below this node <= //
+
+    double radius = 0.0;
+    if (nodes_[node].children.empty()) {
+        for (int PQ : nodes_[node].pairs) {
+            double dist2 = 0.0;
+            for (int k = 0; k < 3; k++) {
+                double d = pair_centers_[3 * PQ + k] - nodes_[node].center[k];
+                dist2 += d * d;
+            }
+            radius = std::max(radius, std::sqrt(dist2) + pair_extents_[PQ]);
+        }
+    } else {
+        for (int child : nodes_[node].children) {
+            double dist2 = 0.0;
+            for (int k = 0; k < 3; k++) {
+                double d = nodes_[child].center[k] - nodes_[node].center[k];
+                dist2 += d * d;
+            }
+            radius = std::max(radius, std::sqrt(dist2) + nodes_[child].radius);
+        }
+    }
+    nodes_[node].radius = radius;
+}
+void CFMMTree::interaction_tensor(const double* R, std::vector<double>& T) const {
+    // McMurchie-Davidson recursion in the point-charge limit:
+    //  R^(n)_000 = (-1)^n (2n - 1)!! / |R|^(2n + 1)
+    //  R^(n)_t+1,u,v = t R^(n+1)_t-1,u,v + X R^(n+1)_t,u,v
+    // with R^(0)_tuv = d^t/dX^t d^u/dY^u d^v/dZ^v 1/|R|
+    int N = order_;
+    int n1 = N + 1;
+    size_t size = n1 * n1 * n1;
+    std::vector<double> next(size, 0.0);
+    T.assign(size, 0.0);
+
+    double R2 = R[0] * R[0] + R[1] * R[1] + R[2] * R[2];
+    double Rinv = 1.0 / std::sqrt(R2);
+    double R2inv = Rinv * Rinv;
+
+    // (-1)^n (2n - 1)!! / |R|^(2n + 1)
+    std::vector<double> R000(N + 1);
+    R000[0] = Rinv;
+    for (int n = 1; n <= N; n++) R000[n] = -(2 * n - 1) * R000[n - 1] * R2inv;
+
+    for (int n = N; n >= 0; n--) {
+        std::vector<double>& cur = T;
+        for (int t = 0; t <= N - n; t++) {
+            for (int u = 0; u <= N - n - t; u++) {
+                for (int v = 0; v <= N - n - t - u; v++) {
+                    double val;
+                    if (t + u + v == 0) {
+                        val = R000[n];
+                    } else if (t > 0) {
+                        val = R[0] * next[((t - 1) * n1 + u) * n1 + v];
+                        if (t > 1) val += (t - 1) * next[((t - 2) * n1 + u) * n1 + v];
+                    } else if (u > 0) {
+                        val = R[1] * next[(t * n1 + u - 1) * n1 + v];
+                        if (u > 1) val += (u - 1) * next[(t * n1 + u - 2) * n1 + v];
+                    } else {
+                        val = R[2] * next[(t * n1 + u) * n1 + v - 1];
+                        if (v > 1) val += (v - 1) * next[(t * n1 + u) * n1 + v - 2];
+                    }
+                    cur[(t * n1 + u) * n1 + v] = val;
+                }
+            }
+        }
+        if (n) next.swap(T);
+    }
+}
+void CFMMTree::add_local_expansion(const double* M, const std::vector<double>& T, double* L) const {
+    for (int a = 0; a < nmult_; a++) {
+        const std::vector<int>& bs = local_b_[a];
+        const std::vector<int>& Ts = local_T_[a];
+        const std::vector<double>& coefs = local_coef_[a];
+        double val = 0.0;
+        for (size_t ind = 0; ind < bs.size(); ind++) {
+            val += coefs[ind] * M[bs[ind]] * T[Ts[ind]];
+        }
+        L[a] += val;
+    }
+}
+void CFMMTree::add_shifted_moments(const double* Min, const double* d, double* Mout) const {
+    std::vector<double> dx(order_ + 1, 1.0), dy(order_ + 1, 1.0), dz(order_ + 1, 1.0);
+    for (int l = 1; l <= order_; l++) {
+        dx[l] = dx[l - 1] * d[0];
+        dy[l] = dy[l - 1] * d[1];
+        dz[l] = dz[l - 1] * d[2];
+    }
+    for (int b = 0; b < nmult_; b++) {
+        const std::vector<int>& cs = shift_c_[b];
+        const std::vector<double>& coefs = shift_coef_[b];
+        double val = 0.0;
+        for (size_t ind = 0; ind < cs.size(); ind++) {
+            int c = cs[ind];
+            val += coefs[ind] * Min[c] * dx[lx_[b] - lx_[c]] * dy[ly_[b] - ly_[c]] * dz[lz_[b] - lz_[c]];
+        }
+        Mout[b] += val;
+    }
+}
+void CFMMTree::build_J(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, const std::vector<SharedMatrix>& D,
+                       std::vector<SharedMatrix>& J) {
+    size_t nD = D.size();
+    size_t npair = pairs_.size();
+    int nthread = ints.size();
+
+    // => Ket Pair Multipoles <= //
+
+    // J_pq = (pq|rs) D_rs over all r, s, so off-diagonal shell pairs carry D_rs + D_sr
+    pair_density_moments_.assign(npair, std::vector<double>(nD * nmult_, 0.0));
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (size_t RS = 0; RS < npair; RS++) {
+        int R = pairs_[RS].first;
+        int S = pairs_[RS].second;
+        int nR = primary_->shell(R).nfunction();
+        int nS = primary_->shell(S).nfunction();
+        int oR = primary_->shell(R).function_index();
+        int oS = primary_->shell(S).function_index();
+        const std::vector<double>& moments = pair_moments_[RS];
+        for (size_t ind = 0; ind < nD; ind++) {
+            double** Dp = D[ind]->pointer();
+            double* Mp = &pair_density_moments_[RS][ind * nmult_];
+            for (int r = 0; r < nR; r++) {
+                for (int s = 0; s < nS; s++) {
+                    double Drs = Dp[r + oR][s + oS] + (R != S ? Dp[s + oS][r + oR] : 0.0);
+                    const double* Qp = &moments[(r * (size_t)nS + s) * nmult_];
+                    for (int k = 0; k < nmult_; k++) Mp[k] += Drs * Qp[k];
+                }
+            }
+        }
+    }
+
+    // => Upward Pass <= //
+
+    // Children always follow their parent in nodes_
+    for (int node = (int)nodes_.size() - 1; node >= 0; node--) {
+        Node& box = nodes_[node];
+        box.moments.assign(nD * nmult_, 0.0);
+        if (box.children.empty()) {
+            for (int RS : box.pairs) {
+                double d[3];
+                for (int k = 0; k < 3; k++) d[k] = pair_centers_[3 * RS + k] - box.center[k];
+                for (size_t ind = 0; ind < nD; ind++) {
+                    add_shifted_moments(&pair_density_moments_[RS][ind * nmult_], d, &box.moments[ind * nmult_]);
+                }
+            }
+        } else {
+            for (int child : box.children) {
+                double d[3];
+                for (int k = 0; k < 3; k++) d[k] = nodes_[child].center[k] - box.center[k];
+                for (size_t ind = 0; ind < nD; ind++) {
+                    add_shifted_moments(&nodes_[child].moments[ind * nmult_], d, &box.moments[ind * nmult_]);
+                }
+            }
+        }
+    }
+
+    for (size_t ind = 0; ind < nD; ind++) J[ind]->zero();
+
+    // ==> Bra Pair Loop <== //
+
+    size_t near_quartets = 0L;
+    size_t far_interactions = 0L;
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(+: near_quartets, far_interactions)
+    for (size_t PQ = 0; PQ < npair; PQ++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int P = pairs_[PQ].first;
+        int Q = pairs_[PQ].second;
+        int nP = primary_->shell(P).nfunction();
+        int nQ = primary_->shell(Q).nfunction();
+        int oP = primary_->shell(P).function_index();
+        int oQ = primary_->shell(Q).function_index();
+        const double* A = &pair_centers_[3 * PQ];
+        double extA = pair_extents_[PQ];
+
+        // => Far field: sum the local expansions of all separated sources at A <= //
+
+        std::vector<double> T;
+        std::vector<double> L(nD * nmult_, 0.0);
+        std::vector<int> near_pairs;
+        std::vector<int> stack(1, 0);
+        while (!stack.empty()) {
+            int node = stack.back();
+            stack.pop_back();
+            const Node& box = nodes_[node];
+            double R[3];
+            for (int k = 0; k < 3; k++) R[k] = A[k] - box.center[k];
+            double dist = std::sqrt(R[0] * R[0] + R[1] * R[1] + R[2] * R[2]);
+            if (dist > box.radius + extA) {
+                interaction_tensor(R, T);
+                for (size_t ind = 0; ind < nD; ind++) {
+                    add_local_expansion(&box.moments[ind * nmult_], T, &L[ind * nmult_]);
+                }
+                far_interactions++;
+            } else if (box.children.empty()) {
+                for (int RS : box.pairs) {
+                    const double* B = &pair_centers_[3 * RS];
+                    for (int k = 0; k < 3; k++) R[k] = A[k] - B[k];
+                    dist = std::sqrt(R[0] * R[0] + R[1] * R[1] + R[2] * R[2]);
+                    if (dist > pair_extents_[RS] + extA) {
+                        interaction_tensor(R, T);
+                        for (size_t ind = 0; ind < nD; ind++) {
+                            add_local_expansion(&pair_density_moments_[RS][ind * nmult_], T, &L[ind * nmult_]);
+                        }
+                        far_interactions++;
+                    } else {
+                        near_pairs.push_back(RS);
+                    }
+                }
+            } else {
+                for (int child : box.children) stack.push_back(child);
+            }
+        }
+
+        std::vector<double> Jpq(nD * nP * nQ, 0.0);
+        const std::vector<double>& moments = pair_moments_[PQ];
+        for (size_t ind = 0; ind < nD; ind++) {
+            const double* Lp = &L[ind * nmult_];
+            for (int pq = 0; pq < nP * nQ; pq++) {
+                const double* Qp = &moments[pq * (size_t)nmult_];
+                double val = 0.0;
+                for (int k = 0; k < nmult_; k++) val += Qp[k] * Lp[k];
+                Jpq[ind * nP * nQ + pq] += val;
+            }
+        }
+
+        // => Near field: explicit ERIs <= //
+
+        for (int RS : near_pairs) {
+            int R = pairs_[RS].first;
+            int S = pairs_[RS].second;
+            if (!sieve_->shell_significant(P, Q, R, S)) continue;
+            if (ints[thread]->compute_shell(P, Q, R, S) == 0) continue;
+            near_quartets++;
+            const double* buffer = ints[thread]->buffer();
+            int nR = primary_->shell(R).nfunction();
+            int nS = primary_->shell(S).nfunction();
+            int oR = primary_->shell(R).function_index();
+            int oS = primary_->shell(S).function_index();
+            for (size_t ind = 0; ind < nD; ind++) {
+                double** Dp = D[ind]->pointer();
+                const double* buffer2 = buffer;
+                for (int pq = 0; pq < nP * nQ; pq++) {
+                    double val = 0.0;
+                    for (int r = 0; r < nR; r++) {
+                        for (int s = 0; s < nS; s++) {
+                            double Drs = Dp[r + oR][s + oS] + (R != S ? Dp[s + oS][r + oR] : 0.0);
+                            val += Drs * (*buffer2++);
+                        }
+                    }
+                    Jpq[ind * nP * nQ + pq] += val;
+                }
+            }
+        }
+
+        // => Stripe out, each bra pair owns its blocks of J <= //
+
+        for (size_t ind = 0; ind < nD; ind++) {
+            double** Jp = J[ind]->pointer();
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) {
+                    double val = Jpq[ind * nP * nQ + p * nQ + q];
+                    Jp[p + oP][q + oQ] = val;
+                    Jp[q + oQ][p + oP] = val;
+                }
+            }
+        }
+    }
+
+    near_quartets_ = near_quartets;
+    far_interactions_ = far_interactions;
+}
+
+}  // namespace psi
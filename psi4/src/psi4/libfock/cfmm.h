@@ -0,0 +1,163 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef libfock_cfmm_H
+#define libfock_cfmm_H
+
+#include "psi4/libmints/typedefs.h"
+
+#include <memory>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+class ERISieve;
+class TwoBodyAOInt;
+
+/**
+ * Class CFMMTree
+ *
+ * Coulomb matrix from a continuous fast multipole method.
+ * The significant shell pairs are sorted into an octree by
+ * the centers of their charge distributions. A bra pair
+ * interacts with every box (or ket pair) that is separated
+ * from it by more than the sum of their extents through
+ * Cartesian multipoles up to order_ in total; only the
+ * overlapping near field is computed with explicit ERIs.
+ *
+ * The tree and the pair multipoles only depend on the basis,
+ * so they are built once at construction and reused for
+ * every density passed to build_J.
+ */
+class CFMMTree {
+   protected:
+    /// A box of the octree
+    struct Node {
+        /// Expansion center (geometric center of the box)
+        double center[3];
+        /// Half the box edge
+        double half_width;
+        /// Distance from center enclosing the extents of all pairs below this node
+        double radius;
+        /// Child nodes, empty for a leaf
+        std::vector<int> children;
+        /// Ket pairs, only for a leaf
+        std::vector<int> pairs;
+        /// Density-contracted multipoles about center, ndensity x nmult
+        std::vector<double> moments;
+    };
+
+    /// Primary basis
+    std::shared_ptr<BasisSet> primary_;
+    /// ERI sieve, defines the significant shell pairs
+    std::shared_ptr<ERISieve> sieve_;
+    /// Maximum total order of the multipole interactions
+    int order_;
+    /// Number of Cartesian multipole components with order <= order_
+    int nmult_;
+    /// Maximum number of pairs in a leaf
+    int leaf_size_;
+    /// Charge below which a distribution is considered vanished, sets the pair extents
+    double extent_cutoff_;
+    /// Significant shell pairs (P >= Q)
+    std::vector<std::pair<int, int> > pairs_;
+    /// Center of each pair's charge distribution (npair x 3)
+    std::vector<double> pair_centers_;
+    /// Radius outside of which each pair's charge distribution is negligible
+    std::vector<double> pair_extents_;
+    /// Raw Cartesian moments of each function pair about its pair center, (nP x nQ) x nmult
+    std::vector<std::vector<double> > pair_moments_;
+    /// Density-contracted moments of each pair about its pair center, ndensity x nmult
+    std::vector<std::vector<double> > pair_density_moments_;
+    /// The octree, the root is nodes_[0] and children follow their parents
+    std::vector<Node> nodes_;
+
+    /// Cartesian exponents of each multipole component
+    std::vector<int> lx_, ly_, lz_;
+    /// For each component a, the components b with |a| + |b| <= order_: index of b
+    std::vector<std::vector<int> > local_b_;
+    /// ... the interaction tensor index of a + b
+    std::vector<std::vector<int> > local_T_;
+    /// ... and (-1)^|b| / (a! b!)
+    std::vector<std::vector<double> > local_coef_;
+    /// For each component b, the components c <= b: index of c
+    std::vector<std::vector<int> > shift_c_;
+    /// ... and binom(b, c)
+    std::vector<std::vector<double> > shift_coef_;
+
+    /// Near-field shell quartets computed in the last build_J
+    size_t near_quartets_;
+    /// Far-field multipole interactions in the last build_J
+    size_t far_interactions_;
+
+    /// Index of the x^lx y^ly z^lz component
+    static int component(int lx, int ly, int lz);
+    /// Set up the component tables
+    void build_tables();
+    /// Centers, extents and moments of the shell pairs
+    void build_pairs();
+    /// Recursively subdivide the box holding pairs
+    void build_node(int node, std::vector<int>& pairs, int level);
+    /// Cartesian derivatives of 1/|R| up to order_, indexed [(t * (order_ + 1) + u) * (order_ + 1) + v]
+    void interaction_tensor(const double* R, std::vector<double>& T) const;
+    /// L += local expansion of the moments M, given the interaction tensor T to their center
+    void add_local_expansion(const double* M, const std::vector<double>& T, double* L) const;
+    /// Mout += Min translated from its center to a center d closer (d = old center - new center)
+    void add_shifted_moments(const double* Min, const double* d, double* Mout) const;
+
+   public:
+    /**
+     * @param primary primary basis set
+     * @param sieve ERI sieve holding the significant shell pairs
+     * @param order maximum order of the multipole interactions
+     * @param extent_cutoff charge below which a distribution is considered vanished
+     */
+    CFMMTree(std::shared_ptr<BasisSet> primary, std::shared_ptr<ERISieve> sieve, int order, double extent_cutoff);
+    virtual ~CFMMTree();
+
+    /**
+     * J_mn = (mn|ls) D_ls for each D, with one integral object per thread
+     * in ints. Far-field pairs use multipoles, near-field pairs explicit ERIs.
+     */
+    void build_J(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints, const std::vector<SharedMatrix>& D,
+                 std::vector<SharedMatrix>& J);
+
+    /// Number of multipole interaction orders
+    int order() const { return order_; }
+    /// Number of octree boxes
+    size_t nnode() const { return nodes_.size(); }
+    /// Near-field shell quartets computed in the last build_J
+    size_t near_quartets() const { return near_quartets_; }
+    /// Far-field multipole interactions in the last build_J
+    size_t far_interactions() const { return far_interactions_; }
+};
+
+}  // namespace psi
+
+#endif
@@ -43,6 +43,11 @@
 
 #include <vector>
 #include <string>
+#include <functional>
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include <cstdint>
 #include <sstream>
 #include <cstdio>
 #include <limits>
@@ -80,7 +85,6 @@ double GetBSRadius(unsigned Z)
 class LebedevGridMgr
 {
 public:
-    static void Initialize();
     // If you know the number of points in the grid you want, call this.
     static const MassPoint *findGridByNPoints(int npoints);
     static int findOrderByNPoints(int npoints);
@@ -141,6 +145,10 @@ private:
     static const MassPoint *mk5810ptGrid();
 
     static const MassPoint *nonstandard18PointGrid_;
+    static std::mutex mutex_;
+    // Grids are only built when first asked for, so loading the library stays cheap
+    static const MassPoint *grid(int i);
+    static const MassPoint *nonstandard18PointGrid();
     struct GridData {
         int order;
         int npoints;
@@ -151,6 +159,7 @@ private:
 };
 
 const MassPoint *LebedevGridMgr::nonstandard18PointGrid_;
+std::mutex LebedevGridMgr::mutex_;
 LebedevGridMgr::GridData LebedevGridMgr::grids_[] = {
     {0,   1,    mk1ptGrid,    nullptr},
     {3,   6,    mk6ptGrid,    nullptr},
@@ -192,19 +201,24 @@ LebedevGridMgr::LebedevGridMgr()
 {
 }
 
-void LebedevGridMgr::Initialize()
+const MassPoint *LebedevGridMgr::grid(int i)
 {
-    for (int i = 0; grids_[i].mkGridFn != nullptr; i++)
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (grids_[i].grid == nullptr)
         grids_[i].grid = grids_[i].mkGridFn();
+    return grids_[i].grid;
+}
 
+const MassPoint *LebedevGridMgr::nonstandard18PointGrid()
+{
     // We handle the 18-point grid separately so it doesn't
     // contaminate the list of true Lebedev grids.
-    nonstandard18PointGrid_ = mk18ptGrid_nonstandard();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (nonstandard18PointGrid_ == nullptr)
+        nonstandard18PointGrid_ = mk18ptGrid_nonstandard();
+    return nonstandard18PointGrid_;
 }
 
-// The MagicInitializer calls LebedevGridMgr::Initialize() at program startup!
-static class MagicInitializer { public: MagicInitializer() { LebedevGridMgr::Initialize(); } } s_magic;
-
 bool LebedevGridMgr::isUsableOrder(int order)
 {
     return findGridByOrder(order) != nullptr;
@@ -214,7 +228,7 @@ const MassPoint *LebedevGridMgr::findGridByOrder(int order)
 {
     for (int i = 0; grids_[i].mkGridFn != nullptr; i++)
         if (grids_[i].order == order)
-            return grids_[i].grid;
+            return grid(i);
     return nullptr;
 }
 
@@ -230,7 +244,7 @@ const MassPoint *LebedevGridMgr::findGridByOrder_roundUp(int order)
 {
     for (int i = 0; grids_[i].mkGridFn != nullptr; i++)
         if (grids_[i].order >= order)
-            return grids_[i].grid;
+            return grid(i);
     return nullptr; // Too high!
 }
 
@@ -253,10 +267,10 @@ int LebedevGridMgr::findOrderByNPoints(int npoints)
 const MassPoint *LebedevGridMgr::findGridByNPoints(int npoints)
 {
     if (npoints == 18) // Special case; this isn't actually a Lebedev grid, but some SG-1 atomic grids require it.
-        return nonstandard18PointGrid_;
+        return nonstandard18PointGrid();
     for (int i = 0; grids_[i].mkGridFn != nullptr; i++)
         if (grids_[i].npoints == npoints)
-            return grids_[i].grid;
+            return grid(i);
     return nullptr;
 }
 
@@ -2439,8 +2453,11 @@ private:
 
     static const MassPoint *SG1_grids_[19];
     static int              SG1_sizes_[19];
-public:
+
+    // SG-0 and SG-1 are built on first use rather than at library load
+    static std::once_flag initialized_;
     static void Initialize();
+public:
     static void ReleaseMemory();
     static int WhichGrid(const char *name);
     static int GetSG0size(int Z);
@@ -2449,13 +2466,9 @@ public:
     static const MassPoint *GetSG1grid(int Z);
 };
 
-// The MagicInitializer calls various initialization routines at program startup
+// The MagicInitializer frees the standard grids at program exit
 static class MagicInitializer2 {
 public:
-    MagicInitializer2()
-    {
-        StandardGridMgr::Initialize();
-    }
     ~MagicInitializer2()
     {
         StandardGridMgr::ReleaseMemory();
@@ -2466,6 +2479,7 @@ const MassPoint *StandardGridMgr::SG0_grids_[18];
 int              StandardGridMgr::SG0_sizes_[18];
 const MassPoint *StandardGridMgr::SG1_grids_[19];
 int              StandardGridMgr::SG1_sizes_[19];
+std::once_flag   StandardGridMgr::initialized_;
 
 int StandardGridMgr::WhichGrid(const char *name)
 {
@@ -2478,6 +2492,7 @@ int StandardGridMgr::WhichGrid(const char *name)
 
 int StandardGridMgr::GetSG0size(int Z)
 {
+    std::call_once(initialized_, Initialize);
     if ((size_t)Z >= sizeof(SG0_sizes_)/sizeof(SG0_sizes_[0]) || SG0_sizes_[Z] == 0) {
         outfile->Printf( "There is no SG-0 grid defined for atomic number %d!\n", Z);
         throw PSIEXCEPTION("There is no SG-0 grid defined for the requested atomic number!");
@@ -2487,6 +2502,7 @@ int StandardGridMgr::GetSG0size(int Z)
 
 int StandardGridMgr::GetSG1size(int Z)
 {
+    std::call_once(initialized_, Initialize);
     if ((size_t)Z >= sizeof(SG1_sizes_)/sizeof(SG1_sizes_[0]) || SG1_sizes_[Z] == 0) {
         outfile->Printf( "There is no SG-1 grid defined for atomic number %d!\n", Z);
         throw PSIEXCEPTION("There is no SG-1 grid defined for the requested atomic number!");
@@ -2496,6 +2512,7 @@ int StandardGridMgr::GetSG1size(int Z)
 
 const MassPoint *StandardGridMgr::GetSG0grid(int Z)
 {
+    std::call_once(initialized_, Initialize);
     if ((size_t)Z >= sizeof(SG0_grids_)/sizeof(SG0_grids_[0]) || SG0_grids_[Z] == 0) {
         outfile->Printf( "There is no SG-0 grid defined for atomic number %d!\n", Z);
         throw PSIEXCEPTION("There is no SG-0 grid defined for the requested atomic number!");
@@ -2504,6 +2521,7 @@ const MassPoint *StandardGridMgr::GetSG0grid(int Z)
 }
 const MassPoint *StandardGridMgr::GetSG1grid(int Z)
 {
+    std::call_once(initialized_, Initialize);
     if ((size_t)Z >= sizeof(SG1_grids_)/sizeof(SG1_grids_[0]) || SG1_grids_[Z] == 0) {
         outfile->Printf( "There is no SG-1 grid defined for atomic number %d!\n", Z);
         throw PSIEXCEPTION("There is no SG-1 grid defined for the requested atomic number!");
@@ -3476,6 +3494,36 @@ OrientationMgr::OrientationMgr(std::shared_ptr<Molecule> mol)
     rotation_ = Q;
 }
 
+// Position of the cell (X[0], X[1], X[2]) along a 3D Hilbert curve through a 2^bits grid
+// (J. Skilling, AIP Conf. Proc. 707, 381 (2004)). Cells next to each other on the curve are
+// also next to each other in space, which Morton ordering only guarantees within an octant.
+uint64_t hilbert_key(uint32_t X[3], int bits)
+{
+    // Inverse undo of the excess work
+    for (uint32_t Q = 1u << (bits - 1); Q > 1; Q >>= 1) {
+        uint32_t P = Q - 1;
+        for (int i = 0; i < 3; i++) {
+            if (X[i] & Q) {
+                X[0] ^= P;
+            } else {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    // Gray encode
+    for (int i = 1; i < 3; i++) X[i] ^= X[i - 1];
+    uint32_t t = 0;
+    for (uint32_t Q = 1u << (bits - 1); Q > 1; Q >>= 1)
+        if (X[2] & Q) t ^= Q - 1;
+    for (int i = 0; i < 3; i++) X[i] ^= t;
+    // Interleave the transposed coordinates into one key
+    uint64_t key = 0;
+    for (int b = bits - 1; b >= 0; b--)
+        for (int i = 0; i < 3; i++) key = (key << 1) | ((X[i] >> b) & 1u);
+    return key;
+}
 
 } // Local namespace
 
@@ -3485,7 +3533,10 @@ namespace psi {
 class RadialPruneMgr {
 private:
     int nominal_order_;
+    int min_order_;
     double alpha_;
+    double tolerance_;
+    bool adaptive_;
     double (*pruneFn_)(double, double);
 
     // These are ad-hoc functions. The idea is that rho = (distance from center of atom)/(Bragg-Slater radius) and alpha = some settable parameter.
@@ -3508,6 +3559,10 @@ public:
     static const char *SchemeName(int which) { return pruneschemes[which].name; }
     RadialPruneMgr(MolecularGrid::MolecularGridOptions const& opt);
     int GetPrunedNumAngPts(double rho);
+
+    // ADAPTIVE picks the order of each radial shell from the integration error, see GetAdaptiveNumAngPts.
+    bool adaptive() const { return adaptive_; }
+    int GetAdaptiveNumAngPts(int nominalAngPts, std::function<double(int)> const& shellIntegral) const;
 };
 
 RadialPruneMgr::PruneSchemeTable RadialPruneMgr::pruneschemes[] = {
@@ -3518,6 +3573,7 @@ RadialPruneMgr::PruneSchemeTable RadialPruneMgr::pruneschemes[] = {
     {"P_GAUSSIAN", p_gaussian},
     {"D_GAUSSIAN", d_gaussian},
     {"LOG_GAUSSIAN", log_gaussian},
+    {"ADAPTIVE", flat}, // The flat grid is the reference the adaptive orders are checked against
     {nullptr, nullptr}
 };
 
@@ -3535,6 +3591,9 @@ RadialPruneMgr::RadialPruneMgr(MolecularGrid::MolecularGridOptions const& opt)
     nominal_order_ = LebedevGridMgr::findOrderByNPoints(opt.nangpts);
     pruneFn_ = pruneschemes[opt.prunescheme].scalFn;
     alpha_ = opt.pruning_alpha;
+    adaptive_ = (strcmp(pruneschemes[opt.prunescheme].name, "ADAPTIVE") == 0);
+    tolerance_ = opt.pruning_tolerance / opt.nradpts; // Spread the per-atom budget evenly over the shells
+    min_order_ = std::min(opt.pruning_min_order, nominal_order_);
 }
 int RadialPruneMgr::GetPrunedNumAngPts(double rho)
 {
@@ -3543,6 +3602,21 @@ int RadialPruneMgr::GetPrunedNumAngPts(double rho)
         throw PSIEXCEPTION("DFTGrid: Requested Spherical Order is too high in pruned grid");
     return LebedevGridMgr::findNPointsByOrder_roundUp(pruned_order);
 }
+// shellIntegral(npoints) integrates the model density over one radial shell with the npoints Lebedev grid,
+// including the radial and nuclear weights. The cheapest grid, not below min_order_, that reproduces the
+// nominal grid to within tolerance_ electrons wins. Near the nucleus the partitioned density is almost
+// spherical and a handful of points suffice; in the bonding region the neighbors' densities keep the order up.
+int RadialPruneMgr::GetAdaptiveNumAngPts(int nominalAngPts, std::function<double(int)> const& shellIntegral) const
+{
+    double reference = shellIntegral(nominalAngPts);
+    for (int order = min_order_; order < nominal_order_; order++) {
+        int npoints = LebedevGridMgr::findNPointsByOrder_roundUp(order);
+        if (npoints >= nominalAngPts) break;
+        order = LebedevGridMgr::findOrderByNPoints(npoints);
+        if (std::fabs(shellIntegral(npoints) - reference) <= tolerance_) return npoints;
+    }
+    return nominalAngPts;
+}
 
 void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
 {
@@ -3563,8 +3637,25 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
         spherical_grids_.resize(molecule_->natom());
     }
 
+    // Promolecular model density for ADAPTIVE pruning: one normalized exp(-zeta r) per atom,
+    // with zeta = 2 / (Bragg-Slater radius) so that hydrogen gets its 1s density.
+    std::vector<double> model_zeta(molecule_->natom()), model_norm(molecule_->natom());
+    for (int B = 0; B < molecule_->natom(); B++) {
+        int ZB = molecule_->true_atomic_number(B);
+        model_zeta[B] = 2.0 / GetBSRadius(ZB);
+        model_norm[B] = ZB * std::pow(model_zeta[B], 3) / (8.0 * M_PI);
+    }
+    auto model_density = [&](MassPoint const& mp) {
+        double rho = 0.0;
+        for (int B = 0; B < molecule_->natom(); B++) {
+            double dx = mp.x - molecule_->x(B), dy = mp.y - molecule_->y(B), dz = mp.z - molecule_->z(B);
+            rho += model_norm[B] * std::exp(-model_zeta[B] * std::sqrt(dx*dx + dy*dy + dz*dz));
+        }
+        return rho;
+    };
+
     // Iterate over atoms
-#pragma omp parallel for schedule(static)
+#pragma omp parallel for schedule(dynamic)
     for (int A = 0; A < molecule_->natom(); A++) {
         int Z = molecule_->true_atomic_number(A);
         double stratmannCutoff = nuc.GetStratmannCutoff(A);
@@ -3581,6 +3672,19 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
 
             for (int i = 0; i < opt.nradpts; i++) {
                 int numAngPts = prune.GetPrunedNumAngPts(r[i]/alpha);
+                if (prune.adaptive()) {
+                    auto shellIntegral = [&](int npts) {
+                        const MassPoint *ang = LebedevGridMgr::findGridByNPoints(npts);
+                        double value = 0.0;
+                        for (int j = 0; j < npts; j++) {
+                            MassPoint mp = { r[i] * ang[j].x, r[i]*ang[j].y, r[i]*ang[j].z, wr[i]*ang[j].w };
+                            mp = std_orientation.MoveIntoPosition(mp, A);
+                            value += mp.w * nuc.computeNuclearWeight(mp, A, stratmannCutoff) * model_density(mp);
+                        }
+                        return value;
+                    };
+                    numAngPts = prune.GetAdaptiveNumAngPts(numAngPts, shellIntegral);
+                }
                 const MassPoint *anggrid = LebedevGridMgr::findGridByNPoints(numAngPts);
 
                 // RMP: And this stuff! This whole thing is completely and utterly FUBAR.
@@ -3611,6 +3715,8 @@ void MolecularGrid::buildGridFromOptions(MolecularGridOptions const& opt)
     for (int i = 0; i < grid.size(); ++i) {
         npoints_ += grid[i].size();
     }
+    pruned_npoints_ = npoints_;
+    unpruned_npoints_ = (opt.namedGrid == -1) ? molecule_->natom() * opt.nradpts * opt.nangpts : npoints_;
     x_ = new double[npoints_];
     y_ = new double[npoints_];
     z_ = new double[npoints_];
@@ -3960,6 +4066,20 @@ void BlockOPoints::populate()
     }
     local_nbf_ = functions_local_to_global_.size();
 }
+void BlockOPoints::set_local_shells(const std::vector<int>& shells)
+{
+    std::shared_ptr<BasisSet> primary = extents_->basis();
+    shells_local_to_global_ = shells;
+    functions_local_to_global_.clear();
+    for (int P : shells) {
+        int nP = primary->shell(P).nfunction();
+        int pstart = primary->shell(P).function_index();
+        for (int oP = 0; oP < nP; oP++) {
+            functions_local_to_global_.push_back(oP + pstart);
+        }
+    }
+    local_nbf_ = functions_local_to_global_.size();
+}
 void BlockOPoints::print(std::string out, int print)
 {
    std::shared_ptr<psi::PsiOutStream> printer=(out=="outfile"?outfile:
@@ -4047,6 +4167,9 @@ void DFTGrid::buildGridFromOptions(std::map<std::string, int> int_opts_map, std:
     MolecularGridOptions opt;
     opt.bs_radius_alpha = options_.get_double("DFT_BS_RADIUS_ALPHA");
     opt.pruning_alpha = options_.get_double("DFT_PRUNING_ALPHA");
+    opt.pruning_tolerance = options_.get_double("DFT_PRUNING_TOLERANCE");
+    // Products of two basis functions carry angular degree up to 2 lmax; never prune below that
+    opt.pruning_min_order = 2 * primary_->max_am() + 1;
     opt.radscheme = RadialGridMgr::WhichScheme(full_str_options["DFT_RADIAL_SCHEME"].c_str());
     opt.prunescheme = RadialPruneMgr::WhichPruneScheme(full_str_options["DFT_PRUNING_SCHEME"].c_str());
     opt.nucscheme = NuclearWeightMgr::WhichScheme(full_str_options["DFT_NUCLEAR_SCHEME"].c_str());
@@ -4087,6 +4210,8 @@ void PseudospectralGrid::buildGridFromOptions()
     MolecularGridOptions opt;
     opt.bs_radius_alpha = options_.get_double("PS_BS_RADIUS_ALPHA");
     opt.pruning_alpha = options_.get_double("PS_PRUNING_ALPHA");
+    opt.pruning_tolerance = 0.0;
+    opt.pruning_min_order = 0;
     opt.radscheme = RadialGridMgr::WhichScheme(options_.get_str("PS_RADIAL_SCHEME").c_str());
     opt.prunescheme = RadialPruneMgr::WhichPruneScheme(options_.get_str("PS_PRUNING_SCHEME").c_str());
     opt.nucscheme = NuclearWeightMgr::WhichScheme(options_.get_str("PS_NUCLEAR_SCHEME").c_str());
@@ -4112,7 +4237,7 @@ void PseudospectralGrid::buildGridFromOptions()
 }
 
 MolecularGrid::MolecularGrid(std::shared_ptr<Molecule> molecule) :
-    debug_(0), molecule_(molecule), npoints_(0), max_points_(0), max_functions_(0)
+    debug_(0), molecule_(molecule), npoints_(0), unpruned_npoints_(0), pruned_npoints_(0), max_points_(0), max_functions_(0)
 {
 }
 MolecularGrid::~MolecularGrid()
@@ -4233,6 +4358,12 @@ void MolecularGrid::print(std::string out, int /*print*/) const
     printer->Printf("    Radial Points          = %14d\n", options_.nradpts);
     printer->Printf("    Spherical Points       = %14d\n", options_.nangpts);
     printer->Printf("    Total Points           = %14d\n", npoints_);
+    if (unpruned_npoints_ > 0 && strcmp(RadialPruneMgr::SchemeName(options_.prunescheme), "ADAPTIVE") == 0) {
+        printer->Printf("    Pruning Tolerance      = %14.3E\n", options_.pruning_tolerance);
+        printer->Printf("    Unpruned Points        = %14d\n", unpruned_npoints_);
+        printer->Printf("    Point Reduction        = %13.1f%%\n",
+                        100.0 * (1.0 - (double)pruned_npoints_ / unpruned_npoints_));
+    }
     printer->Printf("    Total Blocks           = %14zu\n", blocks_.size());
     printer->Printf("    Max Points             = %14d\n", max_points_);
     printer->Printf("    Max Functions          = %14d\n", max_functions_);
@@ -4474,6 +4605,47 @@ void OctreeGridBlocker::block()
     }
 
 
+    // Walk the leaves along a Hilbert curve through their centroids. The octree emits them
+    // level by level, so neighboring blocks used to come from opposite ends of the molecule;
+    // in curve order consecutive blocks share most of their significant functions, and the
+    // D/V sub-blocks a thread gathers stay in cache from one block to the next.
+    {
+        const int bits = 16;
+        std::vector<std::array<double, 3> > centers(completed_tree.size());
+        double lo[3] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+                        std::numeric_limits<double>::max()};
+        double hi[3] = {-lo[0], -lo[1], -lo[2]};
+        for (size_t A = 0; A < completed_tree.size(); A++) {
+            const std::vector<int>& block = completed_tree[A];
+            centers[A] = {{0.0, 0.0, 0.0}};
+            for (size_t Q = 0; Q < block.size(); Q++) {
+                centers[A][0] += x[block[Q]];
+                centers[A][1] += y[block[Q]];
+                centers[A][2] += z[block[Q]];
+            }
+            for (int k = 0; k < 3 && block.size(); k++) {
+                centers[A][k] /= block.size();
+                lo[k] = std::min(lo[k], centers[A][k]);
+                hi[k] = std::max(hi[k], centers[A][k]);
+            }
+        }
+        double span = std::max({hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2], 1.0E-12});
+        double scale = ((1u << bits) - 1) / span;
+
+        std::vector<std::pair<uint64_t, size_t> > order(completed_tree.size());
+        for (size_t A = 0; A < completed_tree.size(); A++) {
+            uint32_t X[3];
+            for (int k = 0; k < 3; k++)
+                X[k] = completed_tree[A].size() ? (uint32_t)((centers[A][k] - lo[k]) * scale) : 0u;
+            order[A] = std::make_pair(hilbert_key(X, bits), A);
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<std::vector<int> > sorted_tree(completed_tree.size());
+        for (size_t A = 0; A < order.size(); A++) sorted_tree[A].swap(completed_tree[order[A].second]);
+        completed_tree.swap(sorted_tree);
+    }
+
     // Move stuff over
     x_ = new double[npoints_];
     y_ = new double[npoints_];
@@ -72,6 +72,9 @@ protected:
 
     /// Total points for this molecule
     int npoints_;
+    /// Points the atomic grids would have had without pruning, and with it
+    int unpruned_npoints_;
+    int pruned_npoints_;
     /// Maximum number of points in a block
     int max_points_;
     /// Maximum number of functions in a block
@@ -115,6 +118,8 @@ public:
     struct MolecularGridOptions {
         double bs_radius_alpha;
         double pruning_alpha;
+        double pruning_tolerance; // Model density error per atom, ADAPTIVE pruning only
+        int pruning_min_order;    // Lowest Lebedev order ADAPTIVE pruning may select
         short radscheme;   // Effectively an enumeration
         short prunescheme;
         short nucscheme;
@@ -397,6 +402,8 @@ public:
 
     /// Refresh populations (if extents_->delta() changes)
     void refresh() { populate(); }
+    /// Restrict the block to the given subset of its local shells (global indices, ascending)
+    void set_local_shells(const std::vector<int>& shells);
 
     /// Number of grid points
     size_t npoints() const { return npoints_; }
@@ -404,6 +411,10 @@ public:
     size_t local_nbf() const { return local_nbf_; }
     /// Index of the currently owned block
     size_t index() const { return index_; }
+    /// Center of the bounding sphere
+    const Vector3& xc() const { return xc_; }
+    /// Radius of the bounding sphere
+    double R() const { return R_; }
     /// Print a trace of this BlockOPoints
     void print(std::string out_fname = "outfile", int print = 2);
 
@@ -35,9 +35,13 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libfunctional/superfunctional.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
 #include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -45,6 +49,103 @@
 
 namespace psi {
 
+namespace {
+
+/*
+ * Natural-transition-orbital factors of one trial vector block x (occ x vir per irrep, symmetry symm):
+ * x_h = U_h s_h V_h^T gives D = (Cocc U s)(Cvir V)^T, so JK sees rank(x) columns instead of nocc.
+ * Singular triplets are dropped smallest first, over all irreps, while the discarded Frobenius norm
+ * stays below tol * |x|. x is overwritten with the kept part so that the product is exact for the
+ * vector the solver keeps in its subspace. Returns the retained rank.
+ */
+int nto_factor(SharedMatrix Caocc, SharedMatrix Cavir, double* xp, int symm, double tol, SharedMatrix& Cl,
+               SharedMatrix& Cr) {
+    int nirrep = Caocc->nirrep();
+    std::vector<SharedMatrix> U(nirrep), V(nirrep);
+    std::vector<SharedVector> S(nirrep);
+    std::vector<std::tuple<double, int, int> > values;
+    double total2 = 0.0;
+    double smax = 0.0;
+
+    long int offset = 0L;
+    for (int h = 0; h < nirrep; ++h) {
+        int nocc = Caocc->colspi()[h];
+        int nvir = Cavir->colspi()[h ^ symm];
+        if (!nocc || !nvir) continue;
+
+        auto X = std::make_shared<Matrix>("X", nocc, nvir);
+        ::memcpy((void*)X->pointer()[0], (void*)&xp[offset], sizeof(double) * nocc * nvir);
+        std::tie(U[h], S[h], V[h]) = X->svd_temps();
+        X->svd(U[h], S[h], V[h]);
+
+        for (int k = 0; k < S[h]->dim(); k++) {
+            double sk = S[h]->get(k);
+            values.push_back(std::make_tuple(sk, h, k));
+            total2 += sk * sk;
+            smax = std::max(smax, sk);
+        }
+        offset += nocc * nvir;
+    }
+
+    // Smallest first; exact zeros always go, at least one triplet always stays
+    std::sort(values.begin(), values.end());
+    std::vector<std::vector<bool> > keep(nirrep);
+    for (int h = 0; h < nirrep; ++h) keep[h].assign(S[h] ? S[h]->dim() : 0, true);
+    double dropped2 = 0.0;
+    for (size_t v = 0; v + 1 < values.size(); v++) {
+        double sk = std::get<0>(values[v]);
+        if (sk > 1.0E-14 * smax && dropped2 + sk * sk > tol * tol * total2) break;
+        dropped2 += sk * sk;
+        keep[std::get<1>(values[v])][std::get<2>(values[v])] = false;
+    }
+
+    Dimension rank(nirrep);
+    for (int h = 0; h < nirrep; ++h) rank[h] = std::count(keep[h].begin(), keep[h].end(), true);
+
+    Cl = std::make_shared<Matrix>("C_left (NTO)", nirrep, Caocc->rowspi(), rank);
+    Cr = std::make_shared<Matrix>("C_right (NTO)", nirrep, Caocc->rowspi(), rank, symm);
+
+    offset = 0L;
+    for (int h = 0; h < nirrep; ++h) {
+        int nocc = Caocc->colspi()[h];
+        int nvir = Cavir->colspi()[h ^ symm];
+        if (!nocc || !nvir) continue;
+        int nsoocc = Caocc->rowspi()[h];
+        int nsovir = Cavir->rowspi()[h ^ symm];
+
+        double** Up = U[h]->pointer();
+        double** Vp = V[h]->pointer();
+        double* Sp = S[h]->pointer();
+        double** Cop = Caocc->pointer(h);
+        double** Cvp = Cavir->pointer(h ^ symm);
+        double** Clp = Cl->pointer(h);
+        double** Crp = Cr->pointer(h ^ symm);
+        double* X = &xp[offset];
+        ::memset((void*)X, '\0', sizeof(double) * nocc * nvir);
+
+        int r = 0;
+        for (int k = 0; k < S[h]->dim(); k++) {
+            if (!keep[h][k]) continue;
+            // Cl(:,r) = Cocc U(:,k) s_k, Cr(:,r) = Cvir V(k,:)^T, x += s_k U(:,k) V(k,:)
+            for (int m = 0; m < nsoocc; m++) {
+                Clp[m][r] = Sp[k] * C_DDOT(nocc, Cop[m], 1, &Up[0][k], U[h]->coldim());
+            }
+            for (int m = 0; m < nsovir; m++) {
+                Crp[m][r] = C_DDOT(nvir, Cvp[m], 1, Vp[k], 1);
+            }
+            for (int i = 0; i < nocc; i++) {
+                C_DAXPY(nvir, Sp[k] * Up[i][k], Vp[k], 1, &X[i * nvir], 1);
+            }
+            r++;
+        }
+        offset += nocc * nvir;
+    }
+
+    return rank.sum();
+}
+
+}  // namespace
+
 Hamiltonian::Hamiltonian(std::shared_ptr<JK> jk) :
     jk_(jk)
 {
@@ -64,6 +165,7 @@ void Hamiltonian::common_init()
     debug_ = 0;
     bench_ = 0;
     exact_diagonal_ = false;
+    nto_tolerance_ = 0.0;
 }
 
 RHamiltonian::RHamiltonian(std::shared_ptr<JK> jk) :
@@ -278,11 +380,8 @@ std::shared_ptr<Vector> CISRHamiltonian::diagonal()
 void CISRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                                     std::vector<std::shared_ptr<Vector> >& b)
 {
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
@@ -373,10 +472,8 @@ void CISRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
-
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
 
@@ -516,11 +613,8 @@ std::shared_ptr<Vector> TDHFRHamiltonian::diagonal()
 void TDHFRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                                      std::vector<std::shared_ptr<Vector> >& b)
 {
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
@@ -582,10 +676,8 @@ void TDHFRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
-
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
 
@@ -770,11 +862,8 @@ std::map<std::string, SharedVector> CPHFRHamiltonian::pack(const std::map<std::s
 void CPHFRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                                      std::vector<std::shared_ptr<Vector> >& b)
 {
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
@@ -808,10 +897,8 @@ void CPHFRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
-
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
 
@@ -930,21 +1017,29 @@ void TDARHamiltonian::print_header() const
 void TDARHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                                      std::vector<std::shared_ptr<Vector> >& b)
 {
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
     // std::vector<SharedMatrix >& P = v_->P();
 
-    C_left.clear();
-    C_right.clear();
     // P.clear();
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
     for (int symm = 0; symm < nirrep; ++symm) {
         for (size_t N = 0; N < x.size(); ++N) {
-            C_left.push_back(Caocc_);
             double* xp = x[N]->pointer(symm);
 
+            if (nto_tolerance_ > 0.0) {
+                // NTO-compressed trial, the JK cost follows the retained rank
+                SharedMatrix Cl, Cr;
+                nto_factor(Caocc_, Cavir_, xp, symm, nto_tolerance_, Cl, Cr);
+                C_left.push_back(Cl);
+                C_right.push_back(Cr);
+                continue;
+            }
+
+            C_left.push_back(Caocc_);
+
             std::stringstream ss;
             ss << "C_right, h = " << symm << ", N = " << N;
             auto Cr = std::make_shared<Matrix>(ss.str(), Caocc_->nirrep(), Caocc_->rowspi(), Caocc_->colspi(), symm);
@@ -987,11 +1082,10 @@ void TDARHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
     // v_->compute();
 
-    const std::vector<SharedMatrix >& J = jk_->J();
-//    const std::vector<SharedMatrix >& K = jk_->K();
 //    const std::vector<SharedMatrix >& V = v_->V();
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
@@ -1092,24 +1186,33 @@ void TDDFTRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
 {
     // TODO V
 
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
     for (int symm = 0; symm < nirrep; ++symm) {
         for (size_t N = 0; N < x.size(); ++N) {
 
-            C_left.push_back(Caocc_);
-            C_left.push_back(Caocc_);
-
             int nov = x[N]->dimpi()[symm] / 2;
 
             double* xp = x[N]->pointer(symm);
 
+            if (nto_tolerance_ > 0.0) {
+                // NTO-compressed X and Y, the JK cost follows the retained ranks
+                SharedMatrix ClX, CrX, ClY, CrY;
+                nto_factor(Caocc_, Cavir_, xp, symm, nto_tolerance_, ClX, CrX);
+                nto_factor(Caocc_, Cavir_, &xp[nov], symm, nto_tolerance_, ClY, CrY);
+                C_left.push_back(ClX);
+                C_left.push_back(ClY);
+                C_right.push_back(CrX);
+                C_right.push_back(CrY);
+                continue;
+            }
+
+            C_left.push_back(Caocc_);
+            C_left.push_back(Caocc_);
+
             std::stringstream ss;
             ss << "C_right_X, h = " << symm << ", N = " << N;
             auto CXr = std::make_shared<Matrix>(ss.str(), Caocc_->nirrep(), Caocc_->rowspi(), Caocc_->colspi(), symm);
@@ -1158,10 +1261,8 @@ void TDDFTRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
-
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
 
@@ -1292,13 +1393,8 @@ void CPKSRHamiltonian::print_header() const
 void CPKSRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                                      std::vector<std::shared_ptr<Vector> >& b)
 {
-    // TODO V
-
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrep = (x.size() ? x[0]->nirrep() : 0);
 
@@ -1332,10 +1428,23 @@ void CPKSRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
         }
     }
 
-    jk_->compute();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    // Exact exchange fraction; the JK object may not build K at all for pure functionals
+    double alpha = v_->functional()->x_alpha();
+
+    // XC kernel contracted with the (C1) transition densities
+    std::vector<SharedMatrix > Vx;
+    if (v_->functional()->needs_xc()) {
+        if (nirrep > 1) throw PSIEXCEPTION("CPKSRHamiltonian: XC kernel requires C1 symmetry.");
+        std::vector<SharedMatrix > Dx;
+        for (size_t i = 0; i < C_left.size(); ++i) {
+            Dx.push_back(Matrix::doublet(C_left[i], C_right[i], false, true));
+            Vx.push_back(std::make_shared<Matrix>("Vx Temp", Dx[i]->rowspi(), Dx[i]->colspi()));
+        }
+        v_->compute_Vx(Dx, Vx);
+    }
 
     double* Tp = new double[Caocc_->max_nrow() * Caocc_->max_ncol()];
 
@@ -1344,6 +1453,7 @@ void CPKSRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
 
             double* bp = b[N]->pointer(symm);
             double* xp = x[N]->pointer(symm);
+            size_t task = symm * x.size() + N;
             long int offset = 0L;
 
             for (int h = 0; h < Caocc_->nirrep(); ++h) {
@@ -1359,21 +1469,32 @@ void CPKSRHamiltonian::product(const std::vector<std::shared_ptr<Vector> >& x,
                 double** Cvp = Cavir_->pointer(h^symm);
                 double*  eop  = eps_aocc_->pointer(h);
                 double*  evp  = eps_avir_->pointer(h^symm);
-                double** Jp  = J[N]->pointer(h);
-                double** Kp  = K[N]->pointer(h);
-                double** K2p = K[N]->pointer(h^symm);
+                double** Jp  = J[task]->pointer(h);
 
                 // 4(ia|jb)P_jb = C_im J_mn C_na
                 C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Jp[0],nsovir,0.0,Tp,nsovir);
                 C_DGEMM('N','N',nocc,nvir,nsovir,4.0,Tp,nsovir,Cvp[0],nvir,0.0,&bp[offset],nvir);
 
-                // -(ib|ja)P_jb = C_in K_nm C_ma
-                C_DGEMM('T','T',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,K2p[0],nsoocc,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                if (alpha != 0.0) {
+                    double** Kp  = K[task]->pointer(h);
+                    double** K2p = K[task]->pointer(h^symm);
 
-                // -(ij|ab)P_jb = C_im K_mn C_ra
-                C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Kp[0],nsovir,0.0,Tp,nsovir);
-                C_DGEMM('N','N',nocc,nvir,nsovir,-1.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                    // -a (ib|ja)P_jb = C_in K_nm C_ma
+                    C_DGEMM('T','T',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,K2p[0],nsoocc,0.0,Tp,nsovir);
+                    C_DGEMM('N','N',nocc,nvir,nsovir,-alpha,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+
+                    // -a (ij|ab)P_jb = C_im K_mn C_ra
+                    C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Kp[0],nsovir,0.0,Tp,nsovir);
+                    C_DGEMM('N','N',nocc,nvir,nsovir,-alpha,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                }
+
+                if (Vx.size()) {
+                    double** Vp = Vx[task]->pointer(h);
+
+                    // 4 (ia|f_xc|jb)P_jb = C_im Vx_mn C_na
+                    C_DGEMM('T','N',nocc,nsovir,nsoocc,1.0,Cop[0],nocc,Vp[0],nsovir,0.0,Tp,nsovir);
+                    C_DGEMM('N','N',nocc,nvir,nsovir,4.0,Tp,nsovir,Cvp[0],nvir,1.0,&bp[offset],nvir);
+                }
 
                 for (int i = 0; i < nocc; ++i) {
                     for (int a = 0; a < nvir; ++a) {
@@ -1495,11 +1616,8 @@ void USTABHamiltonian::product(const std::vector<std::pair <std::shared_ptr<Vect
                                     std::vector<std::pair<std::shared_ptr<Vector>,std::shared_ptr<Vector> > >& b)
 {
 
-    std::vector<SharedMatrix >& C_left = jk_->C_left();
-    std::vector<SharedMatrix >& C_right = jk_->C_right();
-
-    C_left.clear();
-    C_right.clear();
+    std::vector<SharedMatrix > C_left;
+    std::vector<SharedMatrix > C_right;
 
     int nirrepa = (x.size() ? x[0].first->nirrep() : 0);
     int nirrepb = (x.size() ? x[0].second->nirrep() : 0);
@@ -1682,10 +1800,8 @@ void USTABHamiltonian::product(const std::vector<std::pair <std::shared_ptr<Vect
         }
     }
 
-    jk_->compute();
-
-    const std::vector<SharedMatrix >& J = jk_->J();
-    const std::vector<SharedMatrix >& K = jk_->K();
+    std::vector<SharedMatrix > J, K, wK;
+    jk_->compute_batch(C_left, C_right, J, K, wK);
 
 //    Compute the alpha part of the b vector
 
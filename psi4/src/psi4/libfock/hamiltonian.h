@@ -52,6 +52,8 @@ protected:
     int bench_;
     /// Use exact diagonal, if available?
     bool exact_diagonal_;
+    /// Relative truncation of NTO-compressed trial vectors, 0.0 for dense trials
+    double nto_tolerance_;
     /// jk object
     std::shared_ptr<JK> jk_;
     /// v object
@@ -106,6 +108,12 @@ public:
     void set_bench(int bench) { bench_ = bench; }
     /// User the exact diagonal, if available? (defaults to false)
     void set_exact_diagonal(bool diag) { exact_diagonal_ = diag; }
+    /**
+    * Hand trial vectors to JK as truncated NTO (SVD) factors, dropping up to tol * |x| of each
+    * vector's norm. Supported by TDARHamiltonian and TDDFTRHamiltonian, which then overwrite
+    * the trial vectors with their truncated form; ignored elsewhere. (defaults to 0.0, off)
+    */
+    void set_nto_tolerance(double tol) { nto_tolerance_ = tol; }
 };
 
 class RHamiltonian : public Hamiltonian {
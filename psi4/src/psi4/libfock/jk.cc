@@ -38,13 +38,18 @@
 #include "psi4/libmints/sieve.h"
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/vector.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/lib3index/cholesky.h"
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_broker.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <sstream>
 #include <vector>
 #ifdef _OPENMP
@@ -78,6 +83,7 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         if (options["DF_INTS_IO"].has_changed()) jk->set_df_ints_io(options.get_str("DF_INTS_IO"));
         if (options["DF_FITTING_CONDITION"].has_changed())
             jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+        if (options.exists("DF_DENSITY_RANK_CUTOFF")) jk->set_rank_cutoff(options.get_double("DF_DENSITY_RANK_CUTOFF"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
 
@@ -93,8 +99,11 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         if (options["DF_INTS_IO"].has_changed()) jk->set_df_ints_io(options.get_str("DF_INTS_IO"));
         if (options["DF_FITTING_CONDITION"].has_changed())
             jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+        if (options.exists("DF_DENSITY_RANK_CUTOFF")) jk->set_rank_cutoff(options.get_double("DF_DENSITY_RANK_CUTOFF"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options.exists("DF_ASYNC_IO")) jk->set_async_io(options.get_bool("DF_ASYNC_IO"));
+        if (options.exists("DF_FUSED_WK")) jk->set_fused_wK(options.get_bool("DF_FUSED_WK"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -106,13 +115,47 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
         if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
         //if (options["DF_INTS_IO"].has_changed()) jk->set_df_ints_io(options.get_str("DF_INTS_IO"));
+        if (options["DF_INTS_CACHE"].has_changed()) jk->set_ints_cache(options.get_bool("DF_INTS_CACHE"));
+        if (options["DF_MIXED_PRECISION"].has_changed())
+            jk->set_mixed_precision(options.get_bool("DF_MIXED_PRECISION"));
+        if (options["DF_MIXED_PRECISION_CONVERGENCE"].has_changed())
+            jk->set_mixed_precision_convergence(options.get_double("DF_MIXED_PRECISION_CONVERGENCE"));
+        if (options["DF_DEVICE_OFFLOAD"].has_changed())
+            jk->set_device_offload(options.get_bool("DF_DEVICE_OFFLOAD"));
+        if (options["DF_LOCAL_FITTING"].has_changed())
+            jk->set_local_fitting(options.get_bool("DF_LOCAL_FITTING"));
         if (options["DF_FITTING_CONDITION"].has_changed())
             jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+        if (options.exists("DF_DENSITY_RANK_CUTOFF")) jk->set_rank_cutoff(options.get_double("DF_DENSITY_RANK_CUTOFF"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
 
         return std::shared_ptr<JK>(jk);
 
+    } else if (jk_type == "COSX") {
+        COSJK* jk = new COSJK(primary, auxiliary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_FITTING_CONDITION"].has_changed())
+            jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+
+        return std::shared_ptr<JK>(jk);
+
+    } else if (jk_type == "PS") {
+        PSJK* jk = new PSJK(primary, auxiliary, options);
+
+        if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
+        if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
+        if (options["DEBUG"].has_changed()) jk->set_debug(options.get_int("DEBUG"));
+        if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
+        if (options["DF_FITTING_CONDITION"].has_changed())
+            jk->set_condition(options.get_double("DF_FITTING_CONDITION"));
+
+        return std::shared_ptr<JK>(jk);
+
     } else if (jk_type == "PK") {
         PKJK* jk = new PKJK(primary, options);
 
@@ -133,7 +176,8 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         return std::shared_ptr<JK>(jk);
 
     } else if (jk_type == "DIRECT") {
-        DirectJK* jk = new DirectJK(primary);
+        // Launched under MPI, every rank takes a share of the quartet tasks
+        DirectJK* jk = (DistDirectJK::world_size() > 1 ? new DistDirectJK(primary) : new DirectJK(primary));
 
         if (options["INTS_TOLERANCE"].has_changed()) jk->set_cutoff(options.get_double("INTS_TOLERANCE"));
         if (options["PRINT"].has_changed()) jk->set_print(options.get_int("PRINT"));
@@ -141,6 +185,15 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
         if (options["BENCH"].has_changed()) jk->set_bench(options.get_int("BENCH"));
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_df_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["INCFOCK"].has_changed()) jk->set_incfock(options.get_bool("INCFOCK"));
+        if (options["INCFOCK_FULL_FOCK_EVERY"].has_changed())
+            jk->set_incfock_full_fock_every(options.get_int("INCFOCK_FULL_FOCK_EVERY"));
+        if (options["DENSITY_SCREENING"].has_changed())
+            jk->set_density_screening(options.get_bool("DENSITY_SCREENING"));
+        if (options["DENSITY_SCREENING_TOLERANCE"].has_changed())
+            jk->set_density_cutoff(options.get_double("DENSITY_SCREENING_TOLERANCE"));
+        if (options["CFMM"].has_changed()) jk->set_cfmm(options.get_bool("CFMM"));
+        if (options["CFMM_ORDER"].has_changed()) jk->set_cfmm_order(options.get_int("CFMM_ORDER"));
 
         return std::shared_ptr<JK>(jk);
 
@@ -178,7 +231,10 @@ std::shared_ptr<JK> JK::build_JK(std::shared_ptr<BasisSet> primary, std::shared_
             size_t naux = auxiliary->nbf();
             size_t required = naux * nbf * nbf; // + nthreads_ * nbf * nbf TODO
 
-            if (required > doubles) {
+            // MemDFJK streams the (sparse) AOs from disk with double-buffered
+            // reads once they no longer fit, which holds up well to about
+            // an order of magnitude beyond the available memory
+            if (required > 10 * doubles) {
                 return build_JK(primary, auxiliary, options, "DISK_DF");
             } else {
                 return build_JK(primary, auxiliary, options, "MEM_DF");
@@ -208,19 +264,21 @@ void JK::common_init() {
     omp_nthread_ = Process::environment.get_n_threads();
 #endif
     cutoff_ = 1.0E-12;
+    rank_cutoff_ = 0.0;
 
     do_J_ = true;
     do_K_ = true;
     do_wK_ = false;
     lr_symmetric_ = false;
     omega_ = 0.0;
+    compute_time_ = 0.0;
 
     std::shared_ptr<IntegralFactory> integral =
         std::make_shared<IntegralFactory>(primary_, primary_, primary_, primary_);
     auto pet = std::make_shared<PetiteList>(primary_, integral);
     AO2USO_ = SharedMatrix(pet->aotoso());
 }
-size_t JK::memory_overhead() const {
+size_t JK::pair_overhead(SharedMatrix C_left, SharedMatrix C_right, bool lr_symmetric) const {
     size_t mem = 0L;
 
     int JKwKD_factor = 1;
@@ -229,34 +287,91 @@ size_t JK::memory_overhead() const {
     if (do_wK_) JKwKD_factor++;
 
     int C_factor = 1;
-    if (!lr_symmetric_) C_factor++;
+    if (!lr_symmetric) C_factor++;
 
     // USO Quantities
-    for (size_t N = 0; N < C_left_.size(); N++) {
-        int symml = C_left_[N]->symmetry();
-        for (int h = 0; h < C_left_[N]->nirrep(); h++) {
-            int nbfl = C_left_[N]->rowspi()[h];
-            int nbfr = C_right_[N]->rowspi()[h];
-            int nocc = C_left_[N]->colspi()[symml ^ h];
+    int symml = C_left->symmetry();
+    for (int h = 0; h < C_left->nirrep(); h++) {
+        int nbfl = C_left->rowspi()[h];
+        int nbfr = C_right->rowspi()[h];
+        int nocc = C_left->colspi()[symml ^ h];
 
-            mem += C_factor * (size_t)nocc * (nbfl + nbfr) / 2L + JKwKD_factor * (size_t)nbfl * nbfr;
-        }
+        mem += C_factor * (size_t)nocc * (nbfl + nbfr) / 2L + JKwKD_factor * (size_t)nbfl * nbfr;
     }
 
     // AO Copies
-    if (C1() && C_left_.size() && C_left_[0]->nirrep() != 1) {
+    if (C1() && C_left->nirrep() != 1) {
         int nbf = primary_->nbf();
-        for (size_t N = 0; N < C_left_.size(); N++) {
-            int nocc = 0;
-            for (int h = 0; h < C_left_[N]->nirrep(); h++) {
-                nocc += C_left_[N]->colspi()[h];
-            }
-            mem += C_factor * (size_t)nocc * nbf + JKwKD_factor * (size_t)nbf * nbf;
+        int nocc = 0;
+        for (int h = 0; h < C_left->nirrep(); h++) {
+            nocc += C_left->colspi()[h];
         }
+        mem += C_factor * (size_t)nocc * nbf + JKwKD_factor * (size_t)nbf * nbf;
     }
 
     return mem;
 }
+size_t JK::memory_overhead() const {
+    size_t mem = 0L;
+    for (size_t N = 0; N < C_left_.size(); N++) {
+        mem += pair_overhead(C_left_[N], C_right_[N], lr_symmetric_);
+    }
+    return mem;
+}
+size_t JK::batch_densities(const std::vector<SharedMatrix>& C_left,
+                           const std::vector<SharedMatrix>& C_right) const {
+    if (C_left.empty()) return 0;
+
+    bool lr_symmetric = C_right.empty();
+    size_t max_pair = 0L;
+    for (size_t N = 0; N < C_left.size(); N++) {
+        max_pair = std::max(max_pair, pair_overhead(C_left[N], (lr_symmetric ? C_left[N] : C_right[N]), lr_symmetric));
+    }
+
+    size_t batch = C_left.size();
+    if (max_pair) batch = std::min(batch, memory_ / max_pair);
+    if (max_batch_densities()) batch = std::min(batch, max_batch_densities());
+    return std::max(batch, (size_t)1);
+}
+void JK::compute_batch(const std::vector<SharedMatrix>& C_left, const std::vector<SharedMatrix>& C_right,
+                       std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, std::vector<SharedMatrix>& wK) {
+    if (C_right.size() && C_right.size() != C_left.size()) {
+        throw PSIEXCEPTION("JK::compute_batch: C_left/C_right size mismatch!");
+    }
+
+    J.clear();
+    K.clear();
+    wK.clear();
+
+    size_t npair = C_left.size();
+    size_t batch = batch_densities(C_left, C_right);
+    // J_/K_/wK_ are reallocated only when the batch shape changes, so copy out unless one batch does it all
+    bool copy = batch < npair;
+    if (copy && debug_) {
+        outfile->Printf("  JK: %zu densities in batches of %zu.\n\n", npair, batch);
+    }
+
+    for (size_t start = 0; start < npair; start += batch) {
+        size_t stop = std::min(npair, start + batch);
+        C_left_.assign(C_left.begin() + start, C_left.begin() + stop);
+        if (C_right.size()) {
+            C_right_.assign(C_right.begin() + start, C_right.begin() + stop);
+        } else {
+            C_right_.clear();
+        }
+
+        compute();
+
+        for (size_t N = 0; N < stop - start; N++) {
+            if (do_J_) J.push_back(copy ? J_[N]->clone() : J_[N]);
+            if (do_K_) K.push_back(copy ? K_[N]->clone() : K_[N]);
+            if (do_wK_) wK.push_back(copy ? wK_[N]->clone() : wK_[N]);
+        }
+    }
+
+    C_left_.clear();
+    C_right_.clear();
+}
 void JK::compute_D() {
     /// Make sure the memory is there
     bool same = true;
@@ -543,8 +658,84 @@ void JK::AO2USO() {
     }
     delete[] temp;
 }
-void JK::initialize() { preiterations(); }
+void JK::reduce_C_rank() {
+    C_rank_.clear();
+    bool reduced = false;
+    for (size_t N = 0; N < C_left_ao_.size(); N++) {
+        SharedMatrix L = C_left_ao_[N];
+        SharedMatrix R = C_right_ao_[N];
+        int nbf = L->rowspi()[0];
+        int nocc = L->colspi()[0];
+        if (rank_cutoff_ <= 0.0 || nocc < 2) {
+            C_rank_.push_back(nocc);
+            continue;
+        }
+
+        // D = L R^T = sum_j (L v_j)(R v_j)^T for any orthonormal v_j, take them from L^T L
+        SharedMatrix G = Matrix::doublet(L, L, true, false);
+        auto V = std::make_shared<Matrix>("V", nocc, nocc);
+        auto l = std::make_shared<Vector>("l", nocc);
+        G->diagonalize(V, l, descending);
+
+        // Each term is bounded by |L v_j| |R v_j|, which is l_j itself if symmetric
+        SharedMatrix RV;
+        if (!lr_symmetric_) RV = Matrix::doublet(R, V);
+        std::vector<double> weight(nocc);
+        double max_weight = 0.0;
+        for (int j = 0; j < nocc; j++) {
+            double lj = std::max(l->get(j), 0.0);
+            if (lr_symmetric_) {
+                weight[j] = lj;
+            } else {
+                double** RVp = RV->pointer();
+                weight[j] = std::sqrt(lj * C_DDOT(nbf, &RVp[0][j], nocc, &RVp[0][j], nocc));
+            }
+            max_weight = std::max(max_weight, weight[j]);
+        }
+
+        // Also require a non-negligible l_j, the bound above only sees its square root
+        std::vector<int> keep;
+        for (int j = 0; j < nocc; j++) {
+            if (weight[j] > rank_cutoff_ * max_weight && l->get(j) > rank_cutoff_ * l->get(0)) keep.push_back(j);
+        }
+        int rank = keep.size();
+        if (!max_weight || rank == nocc) {
+            C_rank_.push_back(nocc);
+            continue;
+        }
+
+        auto Vk = std::make_shared<Matrix>("Vk", nocc, rank);
+        for (int k = 0; k < rank; k++) {
+            C_DCOPY(nocc, &V->pointer()[0][keep[k]], nocc, &Vk->pointer()[0][k], rank);
+        }
+        C_left_ao_[N] = Matrix::doublet(L, Vk);
+        C_left_ao_[N]->set_name(L->name());
+        if (!lr_symmetric_) {
+            C_right_ao_[N] = Matrix::doublet(R, Vk);
+            C_right_ao_[N]->set_name(R->name());
+        }
+        C_rank_.push_back(rank);
+        reduced = true;
+    }
+
+    if (lr_symmetric_) C_right_ao_ = C_left_ao_;
+
+    if (reduced && debug_) {
+        outfile->Printf("  JK: Density ranks after truncation to %11.3E:", rank_cutoff_);
+        for (size_t N = 0; N < C_rank_.size(); N++) outfile->Printf(" %d", C_rank_[N]);
+        outfile->Printf("\n\n");
+    }
+}
+void JK::initialize() {
+    // JK outranks the caches that can give memory back; a strict broker may also cut memory_ down
+    memory_budget_ = Process::environment.memory_broker().request("JK", memory_ * sizeof(double),
+                                                                  memory_ * sizeof(double), MemoryPriority::High);
+    memory_ = memory_budget_->granted() / sizeof(double);
+    preiterations();
+}
 void JK::compute() {
+    auto start = std::chrono::steady_clock::now();
+
     // Is this density symmetric?
     if (C_left_.size() && !C_right_.size()) {
         lr_symmetric_ = true;
@@ -630,6 +821,11 @@ void JK::compute() {
     if (lr_symmetric_) {
         C_right_.clear();
     }
+
+    compute_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+void JK::finalize() {
+    postiterations();
+    memory_budget_.reset();
 }
-void JK::finalize() { postiterations(); }
 }
@@ -47,6 +47,13 @@ class TwoBodyAOInt;
 class Options;
 class PSIO;
 class DFHelper;
+class DFTGrid;
+class MolecularGrid;
+class BasisFunctions;
+class PotentialInt;
+class CFMMTree;
+class BlockSparseMatrix;
+class MemoryBudget;
 
 namespace pk {
 class PKManager;
@@ -236,12 +243,20 @@ class PSI_API JK {
     int bench_;
     /// Memory available, in doubles, defaults to 256 MB (32 M doubles)
     size_t memory_;
+    /// Share of the job memory held between initialize() and finalize()
+    std::shared_ptr<MemoryBudget> memory_budget_;
     /// Number of OpenMP threads (defaults to 1 in no OpenMP, Process::environment.get_n_threads() otherwise)
     int omp_nthread_;
     /// Integral cutoff (defaults to 0.0)
     double cutoff_;
+    /// Relative cutoff for the rank truncation of C_left_ao_/C_right_ao_ (defaults to 0.0, off)
+    double rank_cutoff_;
+    /// Number of columns of each C_left_ao_/C_right_ao_ pair after reduce_C_rank()
+    std::vector<int> C_rank_;
     /// Whether to all desymmetrization, for cases when it's already been performed elsewhere
     std::vector<bool> input_symmetry_cast_map_;
+    /// Wall time (s) spent in compute() since construction
+    double compute_time_;
 
     // => Tasks <= //
 
@@ -291,6 +306,8 @@ class PSI_API JK {
     std::vector<SharedMatrix> K_ao_;
     /// wK matrices: wK_mn = (ml|w|ns) C_li^left C_si^right
     std::vector<SharedMatrix> wK_ao_;
+    /// Optional shell-block sparse copies of D_ao_, see set_D_sparse()
+    std::vector<std::shared_ptr<BlockSparseMatrix> > D_sparse_;
 
     // => Per-Iteration Setup/Finalize Routines <= //
 
@@ -300,6 +317,12 @@ class PSI_API JK {
     void USO2AO();
     /// Transform finished J_ao_/K_ao_ to J_/K_, after compute_JK()
     void AO2USO();
+    /**
+     * Replace each C_left_ao_/C_right_ao_ pair by the smallest pair giving
+     * the same density to rank_cutoff_, for engines whose K cost scales with
+     * the number of columns. Called by those engines from compute_JK().
+     */
+    void reduce_C_rank();
     /// Allocate J_/K_ should we be using SOs
     void allocate_JK();
     /**
@@ -328,6 +351,8 @@ class PSI_API JK {
 
     /// Memory (doubles) used to hold J/K/wK/C/D and ao versions, at current moment
     size_t memory_overhead() const;
+    /// Memory (doubles) the J/K/wK/C/D (and ao versions) of a single C_left/C_right pair occupy
+    size_t pair_overhead(SharedMatrix C_left, SharedMatrix C_right, bool lr_symmetric) const;
 
    public:
     // => Constructors <= //
@@ -377,6 +402,15 @@ class PSI_API JK {
      *        ignored if possible
      */
     void set_cutoff(double cutoff) { cutoff_ = cutoff; }
+    /**
+     * Relative cutoff for the rank of the densities in factor-based K builds
+     * (DiskDFJK, CDJK, MemDFJK). The C_left factor is rotated to the eigenbasis
+     * of C_left^T C_left and the directions whose contribution to the density
+     * falls below cutoff times the largest one are dropped, so fractionally
+     * occupied or natural-orbital densities reach K with their effective rank.
+     * @param cutoff relative cutoff, 0.0 to use the factors as given
+     */
+    void set_rank_cutoff(double cutoff) { rank_cutoff_ = cutoff; }
     /**
      * Maximum memory to use, in doubles (for tensor-based methods,
      * integral generation objects typically ignore this)
@@ -422,6 +456,19 @@ class PSI_API JK {
     * @param omega range-separation parameter
     */
     void set_omega(double omega) { omega_ = omega; }
+    /**
+    * Hand over shell-block sparse copies of the AO densities of the next compute() (C1 only).
+    * Density-screened engines (DirectJK) then take the shell-block maxima from their block norms
+    * instead of scanning the dense densities; others ignore them. Pass an empty vector to stop.
+    * @param D one BlockSparseMatrix per C_left/C_right pair
+    */
+    void set_D_sparse(const std::vector<std::shared_ptr<BlockSparseMatrix> >& D) { D_sparse_ = D; }
+    /**
+    * Forget everything carried from one compute() to the next about the previous densities
+    * (sparse copies, incremental-build history), keeping integrals, sieves and fitting tensors.
+    * Call when one JK object is lent to a different set of densities, e.g. SCF -> stability analysis.
+    */
+    virtual void reset_build_state() { D_sparse_.clear(); }
 
     // => Computers <= //
 
@@ -455,6 +502,58 @@ class PSI_API JK {
      */
     virtual SharedVector iaia(SharedMatrix Ci, SharedMatrix Ca);
 
+    // => Multi-Density Batches <= //
+
+    /**
+     * Capability flag: does one compute() generate (or read) each integral
+     * block once, whatever the number of C_left/C_right pairs queued?
+     * Engines which redo the integral work per density return false.
+     */
+    virtual bool single_pass_densities() const { return false; }
+    /**
+     * Capability flag: are the K builds of all densities done in the same
+     * integral pass as their J builds, instead of a separate sweep?
+     */
+    virtual bool fused_K_densities() const { return false; }
+    /**
+     * Capability flag: is one screened pair list (and density screening on the
+     * maximum over all densities) shared by every density of a batch?
+     */
+    virtual bool shared_pair_screening() const { return false; }
+
+    /// Wall time (s) spent in compute() since construction
+    double compute_time() const { return compute_time_; }
+    /// Shell quartets computed over all builds, 0 for engines that do not count them
+    virtual size_t quartets_computed() const { return 0; }
+    /// Shell quartets skipped by screening over all builds, 0 for engines that do not count them
+    virtual size_t quartets_skipped() const { return 0; }
+    /**
+     * Largest number of densities a single compute() may take,
+     * 0 if the engine has no limit of its own
+     */
+    virtual size_t max_batch_densities() const { return 0; }
+    /**
+     * Number of the given pairs one compute() can take: bounded by
+     * max_batch_densities() and by the J/K/wK/C/D overhead fitting in memory
+     * @param C_left pseudo-occupied left C matrices
+     * @param C_right pseudo-occupied right C matrices, empty if symmetric
+     */
+    size_t batch_densities(const std::vector<SharedMatrix>& C_left, const std::vector<SharedMatrix>& C_right) const;
+    /**
+     * Compute J/K/wK for many C_left/C_right pairs (response vectors, stability
+     * trial vectors) in as few compute() calls as batch_densities() allows, so
+     * engines with single_pass_densities() do one integral pass per batch.
+     * Like J()/K()/wK(), the returned matrices may be reused by the next
+     * compute(); copy them if they have to outlive it.
+     * @param C_left pseudo-occupied left C matrices
+     * @param C_right pseudo-occupied right C matrices, empty if symmetric
+     * @param J one J matrix per pair on return, empty if !do_J
+     * @param K one K matrix per pair on return, empty if !do_K
+     * @param wK one wK matrix per pair on return, empty if !do_wK
+     */
+    void compute_batch(const std::vector<SharedMatrix>& C_left, const std::vector<SharedMatrix>& C_right,
+                       std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, std::vector<SharedMatrix>& wK);
+
     // => Accessors <= //
 
     /**
@@ -510,6 +609,12 @@ class PSI_API JK {
      * @return D vector of D matrices
      */
     const std::vector<SharedMatrix>& D() const { return D_; }
+    /**
+     * Number of orbital columns each density of the last compute() was
+     * contracted with, after any truncation by set_rank_cutoff().
+     * Empty for engines that do not contract with the factors.
+     */
+    const std::vector<int>& C_ranks() const { return C_rank_; }
 
     /**
     * Print header information regarding JK
@@ -537,6 +642,10 @@ class DiskJK : public JK {
 
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return false; }
+    /// PK integrals are screened once when written, each density reuses every buffer read
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return true; }
+    virtual bool shared_pair_screening() const { return true; }
     /// Setup integrals, files, etc
     virtual void preiterations();
     /// Compute J/K for current C/D
@@ -594,6 +703,10 @@ class PSI_API PKJK : public JK {
 
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const;
+    /// One sweep of the J and one of the K supermatrix for all densities
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return false; }
+    virtual bool shared_pair_screening() const { return true; }
     /// Setup integrals, files, etc
     virtual void preiterations();
     /// Compute J/K for current C/D
@@ -653,10 +766,86 @@ class DirectJK : public JK {
     /// ERI Sieve
     std::shared_ptr<ERISieve> sieve_;
 
+    // => Density Screening <= //
+
+    /// Weight the Schwarz ceiling by the density elements each quartet touches? Defaults to false
+    bool density_screening_;
+    /// Cutoff for density-weighted screening, 0.0 means use cutoff_ (defaults to 0.0)
+    double density_cutoff_;
+    /// Number of J/K builds performed since the last preiterations()
+    size_t nbuild_;
+    /// Shell quartets computed over all builds
+    size_t quartets_computed_;
+    /// Shell quartets skipped by density screening over all builds
+    size_t quartets_density_skipped_;
+    /// Shell quartets skipped by Schwarz screening (or with no integrals) over all builds
+    size_t quartets_schwarz_skipped_;
+
+    // => Incremental Fock Build <= //
+
+    /// Build J/K from the change in the density between calls? Defaults to false
+    bool incfock_;
+    /// Maximum number of consecutive incremental builds before a full rebuild, defaults to 100
+    int incfock_full_fock_every_;
+    /// Number of incremental builds since the last full build
+    int incfock_count_;
+    /// Is the current call an incremental build?
+    bool do_incfock_iter_;
+    /// Largest |dD| element seen in the last incremental build
+    double incfock_delta_max_;
+    /// Omega used for the saved wK_prev_
+    double incfock_omega_;
+    /// AO densities of the previous call
+    std::vector<SharedMatrix> D_prev_;
+    /// AO density changes D_ao_ - D_prev_ for the current call
+    std::vector<SharedMatrix> dD_ao_;
+    /// AO J matrices of the previous call
+    std::vector<SharedMatrix> J_prev_;
+    /// AO K matrices of the previous call
+    std::vector<SharedMatrix> K_prev_;
+    /// AO wK matrices of the previous call
+    std::vector<SharedMatrix> wK_prev_;
+
+    /// Decide between a full and an incremental build, forms dD_ao_ for the latter
+    void incfock_setup();
+    /// Add the previous J/K/wK onto this call's increments and save the new state
+    void incfock_postiter();
+    /// Clear all saved incremental Fock build state
+    void incfock_reset();
+    /// Shell-pair maxima of |D_mn| over all densities (nshell x nshell, symmetrized)
+    std::vector<double> shell_max_density(const std::vector<SharedMatrix>& D) const;
+    /// Same, from the block-sparse copies set by set_D_sparse(); absent blocks count as zero
+    std::vector<double> sparse_shell_max_density(const std::vector<std::shared_ptr<BlockSparseMatrix> >& D) const;
+
+    // => CFMM <= //
+
+    /// Build J with the continuous fast multipole method? Defaults to false
+    bool cfmm_;
+    /// Maximum order of the CFMM multipole interactions, defaults to 8
+    int cfmm_order_;
+    /// The CFMM octree, built in preiterations()
+    std::shared_ptr<CFMMTree> cfmm_tree_;
+
+    // => Distributed Tasks <= //
+
+    /// Rank of this process among task_nrank_, which owns a share of the quartet tasks
+    int task_rank_;
+    /// Number of processes splitting the quartet tasks, defaults to 1
+    int task_nrank_;
+    /// Sum the partial J/K and screening counts of all task ranks (only called if task_nrank_ > 1)
+    virtual void reduce_JK(std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, size_t& computed_shells,
+                           size_t& density_skipped_shells) {}
+
     // => Required Algorithm-Specific Methods <= //
 
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return true; }
+    /// Densities share the quartet loop and the density screening; CFMM takes J out of it
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return !cfmm_; }
+    virtual bool shared_pair_screening() const { return true; }
+    size_t quartets_computed() const override { return quartets_computed_; }
+    size_t quartets_skipped() const override { return quartets_density_skipped_ + quartets_schwarz_skipped_; }
     /// Setup integrals, files, etc
     virtual void preiterations();
     /// Compute J/K for current C/D
@@ -692,6 +881,47 @@ class DirectJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Build J/K from the change in the density since the previous
+     * call, screening shell quartets against that change
+     * @param incfock do incremental builds or not,
+     *        defaults to false
+     */
+    void set_incfock(bool incfock) { incfock_ = incfock; }
+    /**
+     * Force a full J/K build after this many consecutive
+     * incremental builds, to bound the accumulated screening error
+     * @param val a positive integer, defaults to 100
+     */
+    void set_incfock_full_fock_every(int val) { incfock_full_fock_every_ = val; }
+    /// Also forgets the incremental Fock history, the next build is a full one
+    void reset_build_state() override;
+    /**
+     * Skip shell quartets whose Schwarz ceiling times the largest
+     * density element they contract with falls below the density
+     * cutoff. Always active for incremental builds.
+     * @param val do density screening or not,
+     *        defaults to false
+     */
+    void set_density_screening(bool val) { density_screening_ = val; }
+    /**
+     * Cutoff for density-weighted screening
+     * @param val cutoff, 0.0 uses the Schwarz cutoff,
+     *        defaults to 0.0
+     */
+    void set_density_cutoff(double val) { density_cutoff_ = val; }
+    /**
+     * Build J with the continuous fast multipole method: well
+     * separated shell pairs interact through multipoles and only
+     * the near field uses ERIs. K still comes from the quartet loop.
+     * @param val do CFMM or not, defaults to false
+     */
+    void set_cfmm(bool val) { cfmm_ = val; }
+    /**
+     * Maximum total order of the CFMM multipole interactions
+     * @param val a non-negative integer, defaults to 8
+     */
+    void set_cfmm_order(int val) { cfmm_order_ = val; }
 
     // => Accessors <= //
 
@@ -702,6 +932,34 @@ class DirectJK : public JK {
     virtual void print_header() const;
 };
 
+/**
+ * Class DistDirectJK
+ *
+ * DirectJK with the shell-quartet tasks split across the
+ * ranks of MPI_COMM_WORLD. D, J and K stay replicated on
+ * every rank, and the partial J/K are combined with a single
+ * allreduce per build. Requires compiling with ENABLE_MPI.
+ */
+class DistDirectJK : public DirectJK {
+   protected:
+    /// Allreduce the partial J/K and screening counts in one packed buffer
+    virtual void reduce_JK(std::vector<SharedMatrix>& J, std::vector<SharedMatrix>& K, size_t& computed_shells,
+                           size_t& density_skipped_shells);
+
+   public:
+    /**
+     * @param primary primary basis set for this system.
+     *        Every rank must construct the object collectively
+     *        and call compute() in the same order.
+     */
+    DistDirectJK(std::shared_ptr<BasisSet> primary);
+    /// Destructor
+    virtual ~DistDirectJK();
+
+    /// Number of ranks in MPI_COMM_WORLD, 1 if not compiled with MPI
+    static int world_size();
+};
+
 /** \brief Derived class extending the JK object to GTFock
  *
  *   Unfortunately GTFock needs to know the number of density
@@ -724,6 +982,8 @@ class GTFockJK : public JK {
    protected:
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return true; }
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return true; }
     /// Setup integrals, files, etc
     virtual void preiterations() {}
     /// Compute J/K for current C/D
@@ -779,6 +1039,10 @@ class PSI_API DiskDFJK : public JK {
     size_t unit_;
     /// Core or disk?
     bool is_core_;
+    /// Read the next (Q|mn) slice while the current one is used (disk algorithm only)?
+    bool async_io_;
+    /// Build wK within the K pass, from the half-transformed (Q|mn) of K (core algorithm only)?
+    bool fused_wK_;
     /// Maximum number of rows to handle at a time
     int max_rows_;
     /// Maximum number of nocc in C vectors
@@ -792,6 +1056,8 @@ class PSI_API DiskDFJK : public JK {
     SharedMatrix Qlmn_;
     /// (Q|w|mn) for wK (or chunk for disk-based)
     SharedMatrix Qrmn_;
+    /// (Q|P)^-1/2 (P|w|mn) for the fused wK, aligned with the rows of Qmn_
+    SharedMatrix Qwmn_;
 
     // => Temps (built/destroyed in compute_JK) <= //
     std::shared_ptr<Vector> J_temp_;
@@ -800,6 +1066,7 @@ class PSI_API DiskDFJK : public JK {
 
     SharedMatrix E_left_;
     SharedMatrix E_right_;
+    SharedMatrix E_w_;
     std::vector<SharedMatrix> C_temp_;
     std::vector<SharedMatrix> Q_temp_;
 
@@ -807,6 +1074,10 @@ class PSI_API DiskDFJK : public JK {
 
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return true; }
+    /// Each Qmn block is contracted with all densities before the next is read
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return true; }
+    virtual bool shared_pair_screening() const { return true; }
     /// Setup integrals, files, etc
     virtual void preiterations();
     /// Compute J/K for current C/D
@@ -825,6 +1096,10 @@ class PSI_API DiskDFJK : public JK {
     void free_temps();
     void initialize_w_temps();
     void free_w_temps();
+    /// Is wK built in the K pass this time?
+    bool fuse_wK() const { return fused_wK_ && do_wK_ && is_core_; }
+    /// E_mia = C_ni (Q|mn) for the naux rows of Qmnp, threaded over m
+    void half_transform(double** Qmnp, int naux, double** Cp, int nocc, double** Ep);
 
     // => J <= //
     virtual void initialize_JK_core();
@@ -832,9 +1107,11 @@ class PSI_API DiskDFJK : public JK {
     virtual void manage_JK_core();
     virtual void manage_JK_disk();
     virtual void block_J(double** Qmnp, int naux);
-    virtual void block_K(double** Qmnp, int naux);
+    /// K from a slice of Qmn_, and wK as well if the matching slice Qwmnp is given
+    virtual void block_K(double** Qmnp, int naux, double** Qwmnp = nullptr);
 
     // => wK <= //
+    virtual void initialize_wK_fused();
     virtual void initialize_wK_core();
     virtual void initialize_wK_disk();
     virtual void manage_wK_core();
@@ -891,6 +1168,19 @@ class PSI_API DiskDFJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+    /**
+     * Overlap the (Q|mn) reads of the disk algorithm with the J/K builds,
+     * at the cost of a second slice buffer
+     * @param val defaults to true
+     */
+    void set_async_io(bool val) { async_io_ = val; }
+    /**
+     * Build wK in the same pass as K, reusing its half-transformed
+     * (Q|mn) and storing one metric-fitted (Q|w|mn) tensor instead of
+     * two (core algorithm only)
+     * @param val defaults to true
+     */
+    void set_fused_wK(bool val) { fused_wK_ = val; }
 
     // => Accessors <= //
 
@@ -969,12 +1259,28 @@ class MemDFJK : public JK {
     int df_ints_num_threads_;
     /// Condition cutoff in fitting metric, defaults to 1.0E-12
     double condition_ = 1.0E-12;
+    /// Reuse the contracted AOs across jobs through a scratch cache file?
+    bool ints_cache_ = false;
+    /// Run the early J/K builds from single precision AOs?
+    bool mixed_precision_ = false;
+    /// RMS density change below which the builds switch to double precision
+    double mixed_precision_convergence_ = 1.0E-4;
+    /// Densities of the previous build, to measure the change
+    std::vector<SharedMatrix> D_prev_;
+    /// Build K on a CUDA device when one is available?
+    bool device_offload_ = false;
+    /// Fit each AO pair only against the aux functions on its two atoms?
+    bool local_fitting_ = false;
 
     // => Required Algorithm-Specific Methods <= //
 
     int max_nocc() const;
     /// Do we need to backtransform to C1 under the hood?
     virtual bool C1() const { return true; }
+    /// DFHelper contracts each B block with all densities before moving on
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return true; }
+    virtual bool shared_pair_screening() const { return true; }
     /// Setup integrals, files, etc
     /// calls initialize(), JK_blocking
     virtual void preiterations();
@@ -1016,6 +1322,42 @@ class MemDFJK : public JK {
      * @param val a positive integer
      */
     void set_df_ints_num_threads(int val) { df_ints_num_threads_ = val; }
+
+    /**
+     * Keep the metric-contracted three-index integrals in a cache
+     * file in the scratch directory and reuse a matching one from
+     * an earlier job
+     * @param cache, defaults to false
+     */
+    void set_ints_cache(bool cache) { ints_cache_ = cache; }
+
+    /**
+     * Build J/K from single precision AOs until the density settles,
+     * then switch to double precision for the remaining builds
+     * @param mixed, defaults to false
+     */
+    void set_mixed_precision(bool mixed) { mixed_precision_ = mixed; }
+    /**
+     * RMS change of the density between builds below which the
+     * mixed-precision mode switches to double precision
+     * @param conv, defaults to 1.0E-4
+     */
+    void set_mixed_precision_convergence(double conv) { mixed_precision_convergence_ = conv; }
+    /**
+     * Keep the three-index integrals on a CUDA device and build K there,
+     * falling back to the host when no device (or memory) is available
+     * @param device, defaults to false
+     */
+    void set_device_offload(bool device) { device_offload_ = device; }
+    /**
+     * Fit each AO pair only against the auxiliary functions on
+     * its two atoms (pair-atomic RI), storing just those compact
+     * coefficients instead of the full three-index integrals
+     * @param local, defaults to false
+     */
+    void set_local_fitting(bool local) { local_fitting_ = local; }
+    /// Also forgets the density history of the mixed-precision switch
+    void reset_build_state() override;
     
     
     // => Accessors <= //
@@ -1031,5 +1373,170 @@ class MemDFJK : public JK {
      */
     std::shared_ptr<DFHelper> dfh() { return dfh_; }
 };
+
+/**
+ * Class COSJK
+ *
+ * JK implementation using density-fitted J and
+ * seminumerical (chain-of-spheres) K:
+ *
+ *  K_mn = \sum_g w_g phi_m(g) \sum_s A_ns(g) \sum_l phi_l(g) D_ls
+ *
+ * with A_ns(g) the potential integrals of a unit charge at
+ * grid point g. The grid is a coarse DFTGrid, evaluated block
+ * by block, and shell pairs are screened per block against the
+ * density-contracted basis functions.
+ */
+class COSJK : public JK {
+   protected:
+    /// Options reference, for the exchange grid
+    Options& options_;
+
+    // => DF J <= //
+
+    /// This class wraps a DFHelper object for J
+    std::shared_ptr<DFHelper> dfh_;
+    /// Auxiliary basis set
+    std::shared_ptr<BasisSet> auxiliary_;
+    /// Condition cutoff in fitting metric, defaults to 1.0E-12
+    double condition_;
+
+    // => Seminumerical K <= //
+
+    /// Number of spherical points of the exchange grid
+    int spherical_points_;
+    /// Number of radial points of the exchange grid
+    int radial_points_;
+    /// Cutoff for shell pairs at a grid block, defaults to 1.0E-11
+    double kcutoff_;
+    /// The exchange grid
+    std::shared_ptr<MolecularGrid> grid_;
+    /// ERI Sieve, for the significant shell pairs and their bounds
+    std::shared_ptr<ERISieve> sieve_;
+    /// Basis function evaluation, one per thread
+    std::vector<std::shared_ptr<BasisFunctions> > point_workers_;
+    /// Potential integrals of a unit point charge, one per thread
+    std::vector<std::shared_ptr<PotentialInt> > potential_ints_;
+
+    /// Build K for the given AO densities (not symmetrized)
+    void build_K(std::vector<SharedMatrix>& D, std::vector<SharedMatrix>& K);
+    /// Build the exchange grid
+    virtual void build_grid();
+
+    // => Required Algorithm-Specific Methods <= //
+
+    int max_nocc() const;
+    /// Do we need to backtransform to C1 under the hood?
+    virtual bool C1() const { return true; }
+    /// J comes from DFHelper, K from a separate grid pass shared by all densities
+    virtual bool single_pass_densities() const { return true; }
+    virtual bool fused_K_densities() const { return false; }
+    virtual bool shared_pair_screening() const { return true; }
+    /// Setup grid, integrals, DFHelper
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+    /// Delete grid and integral objects
+    virtual void postiterations();
+
+    /// Common initialization
+    void common_init();
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for the J fitting.
+     * @param options Options reference, for the grid and COSX knobs
+     */
+    COSJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options);
+    /// Destructor
+    virtual ~COSJK();
+
+    // => Knobs <= //
+
+    /**
+     * Minimum relative eigenvalue to retain in fitting inverse
+     * @param condition minimum relative eigenvalue allowed,
+     *        defaults to 1.0E-12
+     */
+    void set_condition(double condition) { condition_ = condition; }
+    /**
+     * Cutoff for skipping a shell pair at a grid block
+     * @param val cutoff, defaults to 1.0E-11
+     */
+    void set_kcutoff(double val) { kcutoff_ = val; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+};
+
+/**
+ * Class PSJK
+ *
+ * JK implementation using density-fitted J and
+ * pseudospectral K. The seminumerical exchange of COSJK is
+ * evaluated on a PseudospectralGrid, and the left-hand basis
+ * functions are least-squares fitted against the analytic
+ * overlap (dealiasing in the primary basis):
+ *
+ *  K = S Q^-1 \tilde K,    Q_mn = \sum_g w_g phi_m(g) phi_n(g)
+ *
+ * with \tilde K the COSJK quadrature. The fit removes most of
+ * the grid error, so a coarser grid than COSX's suffices.
+ */
+class PSJK : public COSJK {
+   protected:
+    /// The pseudospectral fitting matrix S Q^-1
+    SharedMatrix fit_;
+    /// Minimum relative eigenvalue kept in Q^-1, defaults to 1.0E-10
+    double fit_condition_;
+
+    /// Build the pseudospectral grid
+    virtual void build_grid();
+    /// Build the fitting matrix
+    void build_fit();
+
+    /// Setup grid, integrals, DFHelper and fitting matrix
+    virtual void preiterations();
+    /// Compute J/K for current C/D
+    virtual void compute_JK();
+    /// Delete grid, integral objects and fitting matrix
+    virtual void postiterations();
+
+   public:
+    // => Constructors < = //
+
+    /**
+     * @param primary primary basis set for this system.
+     * @param auxiliary auxiliary basis set for the J fitting.
+     * @param options Options reference, for the grid and PS knobs
+     */
+    PSJK(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, Options& options);
+    /// Destructor
+    virtual ~PSJK();
+
+    // => Knobs <= //
+
+    /**
+     * Minimum relative eigenvalue of the numerical overlap retained in the fit
+     * @param condition minimum relative eigenvalue allowed, defaults to 1.0E-10
+     */
+    void set_fit_condition(double condition) { fit_condition_ = condition; }
+
+    // => Accessors <= //
+
+    /**
+    * Print header information regarding JK
+    * type on output file
+    */
+    virtual void print_header() const;
+};
 }
 #endif
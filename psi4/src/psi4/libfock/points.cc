@@ -38,10 +38,57 @@
 
 #include "gau2grid/gau2grid.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 
 namespace psi {
 
+void PointFunctions::fetch_functions(std::shared_ptr<BlockOPoints> block, bool force_compute) {
+    block_index_ = block->index();
+    current_basis_map_ = &basis_values_;
+
+    auto start = std::chrono::steady_clock::now();
+    auto done = [&]() {
+        collocation_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    // A cache built at a lower derivative level than this worker's cannot serve it
+    if (!force_compute && cache_map_) {
+        auto it = cache_map_->find(block_index_);
+        if (it != cache_map_->end()) {
+            bool covered = true;
+            for (auto& kv : basis_values_) covered = covered && it->second.count(kv.first);
+            if (covered) {
+                current_basis_map_ = &it->second;
+                return;
+            }
+        }
+    }
+
+    if (!force_compute && spill_map_) {
+        auto it = spill_map_->find(block_index_);
+        if (it != spill_map_->end()) {
+            bool covered = true;
+            for (auto& kv : basis_values_) covered = covered && it->second.count(kv.first);
+            if (covered) {
+                size_t npoints = block->npoints();
+                size_t nlocal = block->local_nbf();
+                for (auto& kv : basis_values_) {
+                    const double* src = it->second[kv.first];
+                    double** dst = kv.second->pointer();
+                    for (size_t P = 0; P < npoints; P++) std::copy(src + P * nlocal, src + (P + 1) * nlocal, dst[P]);
+                }
+                done();
+                return;
+            }
+        }
+    }
+
+    BasisFunctions::compute_functions(block);
+    done();
+}
+
 RKSFunctions::RKSFunctions(std::shared_ptr<BasisSet> primary, int max_points, int max_functions)
     : PointFunctions(primary, max_points, max_functions) {
     set_ansatz(0);
@@ -94,13 +141,7 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!D_AO_) throw PSIEXCEPTION("RKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())){
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    fetch_functions(block, force_compute);
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -131,6 +172,26 @@ void RKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     double* rhoap = point_value("RHO_A")->pointer();
     size_t coll_funcs = basis_value("PHI")->ncol();
 
+    // => Density block screening <= //
+    negligible_block_ = false;
+    if (density_cutoff_ > 0.0) {
+        double Dmax = 0.0;
+        for (int ml = 0; ml < nlocal; ml++) {
+            for (int nl = 0; nl <= ml; nl++) Dmax = std::max(Dmax, std::fabs(D2p[ml][nl]));
+        }
+        double phimax = 0.0;
+        for (int P = 0; P < npoints; P++) {
+            double phisum = 0.0;
+            for (int ml = 0; ml < nlocal; ml++) phisum += std::fabs(phip[P][ml]);
+            phimax = std::max(phimax, phisum);
+        }
+        if (2.0 * Dmax * phimax * phimax < density_cutoff_) {
+            negligible_block_ = true;
+            for (auto& kv : point_values_) kv.second->zero();
+            return;
+        }
+    }
+
     // Rho_a = 2.0 * D_xy phi_xa phi_ya
     C_DGEMM('N', 'N', npoints, nlocal, nlocal, 2.0, phip[0], coll_funcs, D2p[0], nglobal, 0.0, Tp[0], nglobal);
     for (int P = 0; P < npoints; P++) {
@@ -239,13 +300,7 @@ void RKSFunctions::set_Cs(SharedMatrix /*Ca_AO*/, SharedMatrix /*Cb_AO*/) {
 }
 void RKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())){
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    fetch_functions(block, force_compute);
     // timer_off("Functions: Points");
 
     // => Global information <= //
@@ -363,13 +418,7 @@ void UKSFunctions::compute_points(std::shared_ptr<BlockOPoints> block, bool forc
     if (!Da_AO_) throw PSIEXCEPTION("UKSFunctions: call set_pointers.");
 
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())){
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    fetch_functions(block, force_compute);
 
     // => Global information <= //
     int npoints = block->npoints();
@@ -508,13 +557,7 @@ void UKSFunctions::set_Cs(SharedMatrix Ca_AO, SharedMatrix Cb_AO) {
 }
 void UKSFunctions::compute_orbitals(std::shared_ptr<BlockOPoints> block, bool force_compute) {
     // => Build basis function values <= //
-    block_index_ = block->index();
-    if (!force_compute && cache_map_ && (cache_map_->find(block->index()) != cache_map_->end())){
-        current_basis_map_ = &(*cache_map_)[block->index()];
-    } else {
-        current_basis_map_ = &basis_values_;
-        BasisFunctions::compute_functions(block);
-    }
+    fetch_functions(block, force_compute);
 
     // => Global information <= //
 
@@ -639,6 +682,27 @@ void BasisFunctions::allocate() {
 
     if (deriv_ >= 3) throw PSIEXCEPTION("BasisFunctions: Only up to Hessians are currently supported");
 }
+namespace {
+
+// (function, point) with row stride npoints -> (point, function) with row stride ldout,
+// in tiles small enough that both sides stay in L1
+void transpose_collocation(size_t nvals, size_t npoints, const double* in, double* out, size_t ldout) {
+    const size_t tile = 16;
+    for (size_t f0 = 0; f0 < nvals; f0 += tile) {
+        size_t f1 = std::min(f0 + tile, nvals);
+        for (size_t p0 = 0; p0 < npoints; p0 += tile) {
+            size_t p1 = std::min(p0 + tile, npoints);
+            for (size_t p = p0; p < p1; p++) {
+                double* outp = out + p * ldout;
+#pragma omp simd
+                for (size_t f = f0; f < f1; f++) outp[f] = in[f * npoints + p];
+            }
+        }
+    }
+}
+
+}  // namespace
+
 void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
 
     //Pull out data
@@ -737,21 +801,22 @@ void BasisFunctions::compute_functions(std::shared_ptr<BlockOPoints> block) {
         }
     }
 
-    // GG spits it out tranpose of what we need
-    int nso = max_functions_;
-    gg_fast_transpose(nso, npoints, tmpp, valuesp);
+    // GG spits it out tranpose of what we need. Only the nvals rows it filled are moved;
+    // the rest of the max_functions_ wide rows are never read for this block.
+    size_t ldv = max_functions_;
+    transpose_collocation(nvals, npoints, tmpp, valuesp, ldv);
     if (deriv_ >= 1) {
-        gg_fast_transpose(nso, npoints, tmp_xp, values_xp);
-        gg_fast_transpose(nso, npoints, tmp_yp, values_yp);
-        gg_fast_transpose(nso, npoints, tmp_zp, values_zp);
+        transpose_collocation(nvals, npoints, tmp_xp, values_xp, ldv);
+        transpose_collocation(nvals, npoints, tmp_yp, values_yp, ldv);
+        transpose_collocation(nvals, npoints, tmp_zp, values_zp, ldv);
     }
     if (deriv_ >= 2) {
-        gg_fast_transpose(nso, npoints, tmp_xxp, values_xxp);
-        gg_fast_transpose(nso, npoints, tmp_xyp, values_xyp);
-        gg_fast_transpose(nso, npoints, tmp_xzp, values_xzp);
-        gg_fast_transpose(nso, npoints, tmp_yyp, values_yyp);
-        gg_fast_transpose(nso, npoints, tmp_yzp, values_yzp);
-        gg_fast_transpose(nso, npoints, tmp_zzp, values_zzp);
+        transpose_collocation(nvals, npoints, tmp_xxp, values_xxp, ldv);
+        transpose_collocation(nvals, npoints, tmp_xyp, values_xyp, ldv);
+        transpose_collocation(nvals, npoints, tmp_xzp, values_xzp, ldv);
+        transpose_collocation(nvals, npoints, tmp_yyp, values_yyp, ldv);
+        transpose_collocation(nvals, npoints, tmp_yzp, values_yzp, ldv);
+        transpose_collocation(nvals, npoints, tmp_zzp, values_zzp, ldv);
     }
 }
 void BasisFunctions::print(std::string out, int print) const {
@@ -108,10 +108,18 @@ protected:
     // Contains a pointer to the current map to use for basis_values
     std::map<std::string, SharedMatrix> *current_basis_map_ = nullptr;
 
+    // Contains a map to the collocation blocks spilled to scratch, packed npoints x local_nbf
+    std::unordered_map<size_t, std::map<std::string, const double*>> *spill_map_ = nullptr;
+
+
     /// Ansatz (0 - LSDA, 1 - GGA, 2 - Meta-GGA)
     int ansatz_;
     /// Map of value names to Vectors containing values
     std::map<std::string, std::shared_ptr<Vector> > point_values_;
+    /// Did the last compute_points call skip its block (see RKSFunctions::set_density_cutoff)?
+    bool negligible_block_ = false;
+    /// Wall time [s] fetch_functions has spent producing basis values
+    double collocation_time_ = 0.0;
 
     // => Orbital Collocation <= //
 
@@ -126,15 +134,22 @@ public:
 
     // => Setters <= //
     void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) { cache_map_ = cache_map; }
+    void set_spill_map(std::unordered_map<size_t, std::map<std::string, const double*>>* spill_map) { spill_map_ = spill_map; }
 
     // => Computers <= //
 
     virtual void compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute = true) = 0;
+    /// Basis values only: from the collocation cache, the spill file, or computed
+    void fetch_functions(std::shared_ptr<BlockOPoints> block, bool force_compute);
+    /// Running total of the time spent in fetch_functions, for profiling the callers
+    double collocation_time() const { return collocation_time_; }
 
     // => Accessors <= //
 
     std::shared_ptr<Vector> point_value(const std::string& key);
     std::map<std::string, SharedVector>& point_values() { return point_values_; }
+    /// True if the last block was skipped by a density cutoff (all point values are zero)
+    bool negligible_block() const { return negligible_block_; }
 
     SharedMatrix basis_value(const std::string& key) { return (*current_basis_map_)[key]; }
     std::map<std::string, SharedMatrix>& basis_values() { return (*current_basis_map_); }
@@ -174,6 +189,8 @@ protected:
     SharedMatrix temp_;
     /// Local D matrix
     SharedMatrix D_local_;
+    /// Blocks whose density bound falls below this skip the density build (0.0 = never)
+    double density_cutoff_ = 0.0;
 
     /// Build temporary work arrays
     void build_temps();
@@ -196,6 +213,8 @@ public:
 
     void compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute = true);
 
+    /// Skip the density build on blocks where rho <= 2 max|D| (sum_m |phi_m|)^2 stays under cutoff
+    void set_density_cutoff(double cutoff) { density_cutoff_ = cutoff; }
     std::vector<SharedMatrix> scratch();
     std::vector<SharedMatrix> D_scratch();
 
@@ -251,6 +270,7 @@ public:
     void set_pointers(SharedMatrix Da_occ_AO);
     void set_pointers(SharedMatrix Da_occ_AO, SharedMatrix Db_occ_AO);
     void set_cache_map(std::unordered_map<size_t, std::map<std::string, SharedMatrix>>* cache_map) { cache_map_ = cache_map; }
+    void set_spill_map(std::unordered_map<size_t, std::map<std::string, const double*>>* spill_map) { spill_map_ = spill_map; }
 
     void compute_points(std::shared_ptr<BlockOPoints> block, bool force_compute = true);
 
@@ -40,6 +40,8 @@
 
 #include <cmath>
 #include <sstream>
+#include <string>
+#include <algorithm>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -71,13 +73,20 @@ void Solver::common_init()
 }
 
 RSolver::RSolver(std::shared_ptr<RHamiltonian> H) :
-    Solver(), H_(H)
+    Solver(), H_(H), nto_tolerance_(0.0)
 {
     name_ = "RSolver";
 }
 RSolver::~RSolver()
 {
 }
+void RSolver::update_nto_tolerance()
+{
+    if (nto_tolerance_ <= 0.0) return;
+    // Nothing to measure the truncation against before the first residual; afterwards
+    // never discard more of a (normalized) trial than the residual it is meant to remove
+    H_->set_nto_tolerance(iteration_ ? std::min(nto_tolerance_, convergence_) : 0.0);
+}
 
 USolver::USolver(std::shared_ptr<UHamiltonian> H) :
     Solver(), H_(H)
@@ -633,8 +642,12 @@ DLRSolver::DLRSolver(std::shared_ptr<RHamiltonian> H) :
     max_subspace_(6),
     min_subspace_(2),
     nguess_(1),
+    max_block_(0),
+    lock_roots_(true),
     nsubspace_(0),
-    nconverged_(0)
+    nconverged_(0),
+    nproduct_(0L),
+    nproduct_last_(0)
 {
     name_ = "DLR";
 }
@@ -676,9 +689,18 @@ std::shared_ptr<DLRSolver> DLRSolver::build_solver(Options& options,
     if (options["SOLVER_NORM"].has_changed()) {
         solver->set_norm(options.get_double("SOLVER_NORM"));
     }
+    if (options["SOLVER_NTO_TOLERANCE"].has_changed()) {
+        solver->set_nto_tolerance(options.get_double("SOLVER_NTO_TOLERANCE"));
+    }
     if (options["SOLVER_PRECONDITION"].has_changed()) {
         solver->set_precondition(options.get_str("SOLVER_PRECONDITION"));
     }
+    if (options["SOLVER_MAX_BLOCK"].has_changed()) {
+        solver->set_max_block(options.get_int("SOLVER_MAX_BLOCK"));
+    }
+    if (options["SOLVER_LOCK_ROOTS"].has_changed()) {
+        solver->set_lock_roots(options.get_bool("SOLVER_LOCK_ROOTS"));
+    }
 
     return solver;
 }
@@ -691,6 +713,9 @@ void DLRSolver::print_header() const
         outfile->Printf( "   Maximum subspace size   = %11d\n", max_subspace_);
         outfile->Printf( "   Minimum subspace size   = %11d\n", min_subspace_);
         outfile->Printf( "   Subspace expansion norm = %11.0E\n", norm_);
+        outfile->Printf( "   Maximum block size      = %11s\n",
+            (max_block_ > 0 ? std::to_string(max_block_).c_str() : "All"));
+        outfile->Printf( "   Lock converged roots    = %11s\n", (lock_roots_ ? "Yes" : "No"));
         outfile->Printf( "   Convergence cutoff      = %11.0E\n", criteria_);
         outfile->Printf( "   Maximum iterations      = %11d\n", maxiter_);
         outfile->Printf( "   Preconditioning         = %11s\n\n", precondition_.c_str());
@@ -711,6 +736,7 @@ void DLRSolver::initialize()
 
     c_.clear();
     E_.clear();
+    locked_.clear();
 
     diag_ = H_->diagonal();
 }
@@ -720,16 +746,20 @@ void DLRSolver::solve()
     converged_ = false;
     nconverged_ = 0;
     convergence_ = 0.0;
+    nproduct_ = 0L;
+    locked_.assign(nroot_, false);
 
     if (print_ > 1) {
         outfile->Printf( "  => Iterations <=\n\n");
-        outfile->Printf( "  %10s %4s %10s %10s %11s\n", "", "Iter", "Converged", "Subspace", "Residual");
+        outfile->Printf( "  %10s %4s %10s %10s %11s %9s\n", "", "Iter", "Converged", "Subspace", "Residual",
+            "Products");
 
     }
 
     // Compute the first set of sigma vectors
     guess();
     sigma();
+    size_t nproduct_guess = nproduct_;
 
     do {
         iteration_++;
@@ -746,8 +776,8 @@ void DLRSolver::solve()
         residuals();
 
         if (print_) {
-            outfile->Printf( "  %-10s %4d %10d %10d %11.3E\n", name_.c_str(), iteration_, nconverged_,
-                nsubspace_, convergence_);
+            outfile->Printf( "  %-10s %4d %10d %10d %11.3E %9d\n", name_.c_str(), iteration_, nconverged_,
+                nsubspace_, convergence_, nproduct_last_);
 
         }
 
@@ -768,10 +798,12 @@ void DLRSolver::solve()
     if (print_ > 1) {
         outfile->Printf( "\n");
         if (!converged_ && print_ > 1) {
-            outfile->Printf( "    %sSolver did not converge.\n\n", name_.c_str());
+            outfile->Printf( "    %sSolver did not converge.\n", name_.c_str());
         } else if (print_ > 1) {
-            outfile->Printf( "    %sSolver converged.\n\n", name_.c_str());
+            outfile->Printf( "    %sSolver converged.\n", name_.c_str());
         }
+        outfile->Printf( "    %zu Hamiltonian products, %zu in the guess and %zu in %d iterations.\n\n",
+            nproduct_, nproduct_guess, nproduct_ - nproduct_guess, iteration_);
 
     }
 }
@@ -812,11 +844,13 @@ void DLRSolver::guess()
     }
 
     // Preconditioner submatrix and Guess Hamiltonian
+    // The delta guesses are cheap low-rank products, send them in as few batches as allowed
     A_ = std::make_shared<Matrix>("A_IJ (Preconditioner)", rank, rank);
-    for (int i = 0; i < nguess_; i += max_subspace_) {
+    int guess_block = (max_block_ > 0 ? max_block_ : nguess_);
+    for (int i = 0; i < nguess_; i += guess_block) {
         b_.clear();
         s_.clear();
-        int n = (max_subspace_ > (nguess_ - i) ? (nguess_ - i) : max_subspace_);
+        int n = (guess_block > (nguess_ - i) ? (nguess_ - i) : guess_block);
         for (int j = 0; j < n; j++) {
             size_t k = i + j;
             b_.push_back(std::make_shared<Vector>("Delta Guess", diag_->dimpi()));
@@ -894,7 +928,10 @@ void DLRSolver::sigma()
         b.push_back(s_[i]);
     }
 
+    update_nto_tolerance();
     H_->product(x,b);
+    nproduct_ += n;
+    nproduct_last_ = n;
 
     if (debug_) {
         outfile->Printf( "   > Sigma <\n\n");
@@ -1088,7 +1125,10 @@ void DLRSolver::residuals()
         // Residual norm k
         double rnorm = sqrt(R2/S2);
         n_[k] = rnorm;
-        if (rnorm < criteria_) {
+        if (lock_roots_ && rnorm < criteria_ && (size_t)k < locked_.size()) {
+            locked_[k] = true;
+        }
+        if (rnorm < criteria_ || ((size_t)k < locked_.size() && locked_[k])) {
             nconverged_++;
         }
     }
@@ -1115,15 +1155,33 @@ void DLRSolver::residuals()
 
     }
 }
+std::vector<int> DLRSolver::active_roots() const
+{
+    // Converged and locked roots get no corrector
+    std::vector<std::pair<double, int> > order;
+    for (int k = 0; k < nroot_; k++) {
+        if (n_[k] < criteria_) continue;
+        if ((size_t)k < locked_.size() && locked_[k]) continue;
+        order.push_back(std::make_pair(-n_[k], k));
+    }
+
+    // Over the block size, the worst roots go first and the rest wait
+    if (max_block_ > 0 && order.size() > (size_t)max_block_) {
+        std::sort(order.begin(), order.end());
+        order.resize(max_block_);
+    }
+
+    std::vector<int> roots;
+    for (size_t i = 0; i < order.size(); i++) roots.push_back(order[i].second);
+    std::sort(roots.begin(), roots.end());
+    return roots;
+}
 void DLRSolver::correctors()
 {
     // Only add correctors for roots that are not converged
     d_.clear();
 
-    for (int k = 0; k < nroot_; k++) {
-
-        // Do not attempt to add a corrector if root is already converged
-        if (n_[k] < criteria_) continue;
+    for (int k : active_roots()) {
 
         std::stringstream s;
         s << "Corrector Vector " << k;
@@ -1275,7 +1333,11 @@ void DLRSolver::subspaceCollapse()
     std::vector<std::shared_ptr<Vector> > s2;
     std::vector<std::shared_ptr<Vector> > b2;
 
-    for (int k = 0; k < min_subspace_; ++k) {
+    // Never collapse below the number of roots, locked roots would lose their vectors
+    int n = a_->rowspi()[0];
+    int ncollapse = std::min(std::max(min_subspace_, nroot_), n);
+
+    for (int k = 0; k < ncollapse; ++k) {
         std::stringstream bs;
         bs << "Subspace Vector " << k;
         b2.push_back(std::make_shared<Vector>(bs.str(), diag_->dimpi()));
@@ -1284,8 +1346,7 @@ void DLRSolver::subspaceCollapse()
         s2.push_back(std::make_shared<Vector>(ss.str(), diag_->dimpi()));
     }
 
-    int n = a_->rowspi()[0];
-    for (int k = 0; k < min_subspace_; ++k) {
+    for (int k = 0; k < ncollapse; ++k) {
         for (int h = 0; h < diag_->nirrep(); ++h) {
             int dimension = diag_->dimpi()[h];
             if (!dimension) continue;
@@ -1444,7 +1505,7 @@ void RayleighRSolver::correctors()
     std::vector<int> sig_inds;
     std::vector<std::vector<double> > shifts(diag_->nirrep());
     for (int i = 0; i < nroot_; i++) {
-        if (n_[i] > criteria_) {
+        if (n_[i] > criteria_ && !((size_t)i < locked_.size() && locked_[i])) {
             for (int h = 0; h < diag_->nirrep(); h++) {
                 shifts[h].push_back(E_[i][h]);
             }
@@ -1534,6 +1595,9 @@ std::shared_ptr<DLRXSolver> DLRXSolver::build_solver(Options& options,
     if (options["SOLVER_NORM"].has_changed()) {
         solver->set_norm(options.get_double("SOLVER_NORM"));
     }
+    if (options["SOLVER_NTO_TOLERANCE"].has_changed()) {
+        solver->set_nto_tolerance(options.get_double("SOLVER_NTO_TOLERANCE"));
+    }
 
     return solver;
 }
@@ -1693,6 +1757,7 @@ void DLRXSolver::sigma()
         b.push_back(s_[i]);
     }
 
+    update_nto_tolerance();
     H_->product(x,b);
 
     if (debug_) {
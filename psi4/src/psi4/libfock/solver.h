@@ -139,6 +139,11 @@ class RSolver : public Solver {
 protected:
     /// Reference to underlying RHamiltonian
     std::shared_ptr<RHamiltonian> H_;
+    /// Largest relative NTO truncation of the trial vectors, 0.0 for dense trials
+    double nto_tolerance_;
+
+    /// Pass the trial truncation for the next product to H_: nto_tolerance_, capped by the current residual
+    void update_nto_tolerance();
 
 public:
     // => Constructors < = //
@@ -160,6 +165,9 @@ public:
     * @return current RHamiltonian object
     */
     std::shared_ptr<RHamiltonian> H() const { return H_; }
+
+    /// Compress trial vectors to NTO factors, see Hamiltonian::set_nto_tolerance (defaults to 0.0, off)
+    void set_nto_tolerance(double tol) { nto_tolerance_ = tol; }
 };
 
 class USolver : public Solver {
@@ -285,6 +293,10 @@ protected:
     int min_subspace_;
     /// Number of guess vectors to build
     int nguess_;
+    /// Maximum number of correctors (new sigma vectors) per iteration, 0 for no limit
+    int max_block_;
+    /// Stop refining a root once its residual has converged?
+    bool lock_roots_;
 
     // => Iteration values <= //
 
@@ -292,6 +304,11 @@ protected:
     int nsubspace_;
     /// The number of converged roots
     int nconverged_;
+    /// Roots that converged and are no longer refined (nroots)
+    std::vector<bool> locked_;
+    /// Sigma vectors formed in this solve, and in the last call to sigma()
+    size_t nproduct_;
+    int nproduct_last_;
 
     // => State values <= //
 
@@ -338,6 +355,8 @@ protected:
     void eigenvals();
     // Find residuals, update convergence
     void residuals();
+    // Roots that still get a corrector this iteration, largest residual first up to max_block_
+    std::vector<int> active_roots() const;
     // Find correctors
     virtual void correctors();
     // Orthogonalize/add significant correctors
@@ -372,6 +391,8 @@ public:
     const std::vector<std::shared_ptr<Vector> >& eigenvectors() const { return c_; }
     /// Eigenvalues, by state/irrep
     const std::vector<std::vector<double> >& eigenvalues() const { return E_; }
+    /// Number of sigma vectors (Hamiltonian products) formed by the last solve()
+    size_t nproduct() const { return nproduct_; }
 
     // => Knobs <= //
 
@@ -385,6 +406,10 @@ public:
     void set_nguess(int nguess) { nguess_ = nguess; }
     /// Set norm critera for adding vectors to subspace (defaults to 1.0E-6)
     void set_norm(double norm) { norm_ = norm; }
+    /// Set maximum number of new vectors per iteration, 0 for all unconverged roots (defaults to 0)
+    void set_max_block(int max_block) { max_block_ = max_block; }
+    /// Lock converged roots (defaults to true)
+    void set_lock_roots(bool lock) { lock_roots_ = lock; }
 };
 
 class RayleighRSolver : public DLRSolver {
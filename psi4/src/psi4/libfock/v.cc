@@ -35,6 +35,7 @@
 #include "psi4/libfunctional/functional.h"
 #include "psi4/libfunctional/superfunctional.h"
 #include "psi4/libqt/qt.h"
+#include "psi4/libqt/trace.h"
 #include "psi4/psi4-dec.h"
 
 #include "psi4/libmints/basisset.h"
@@ -45,12 +46,24 @@
 #include "psi4/libmints/vector.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_broker.h"
+#include "psi4/libpsi4util/shared_segment.h"
+#include "psi4/libpsio/psio.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <cstdlib>
+#include <mutex>
 #include <numeric>
 #include <sstream>
 #include <string>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define SYSTEM_GETPID ::getpid
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
@@ -61,12 +74,14 @@ VBase::VBase(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisS
     : options_(options), primary_(primary), functional_(functional) {
     common_init();
 }
-VBase::~VBase() {}
+VBase::~VBase() { release_spill(); }
 void VBase::common_init() {
     print_ = options_.get_int("PRINT");
     debug_ = options_.get_int("DEBUG");
     v2_rho_cutoff_ = options_.get_double("DFT_V2_RHO_CUTOFF");
     vv10_rho_cutoff_ = options_.get_double("DFT_VV10_RHO_CUTOFF");
+    vv10_kernel_cutoff_ = options_.get_double("DFT_VV10_KERNEL_TOLERANCE");
+    block_density_cutoff_ = options_.get_double("DFT_BLOCK_DENSITY_TOLERANCE");
     grac_initialized_ = false;
     cache_map_deriv_ = -1;
     num_threads_ = 1;
@@ -112,6 +127,9 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
         nbf_ = Dvec[0]->rowspi()[0];
     }
 
+    // A new density means a new Vx kernel
+    vx_kernel_.clear();
+
     // Allocate the densities
     if (D_AO_.size() != Dvec.size()) {
         D_AO_.clear();
@@ -129,18 +147,112 @@ void VBase::set_D(std::vector<SharedMatrix> Dvec) {
         }
     }
 }
+namespace {
+
+// The last grid built, kept for the next V object on the same geometry (SCF then
+// TDDFT/response/gradient, repeated SCFs in a workflow). It also remembers which
+// functional ansatz its blocks were collocation-screened for.
+struct LastGrid {
+    std::string key;
+    std::shared_ptr<DFTGrid> grid;
+};
+LastGrid last_grid;
+/// Guards last_grid when V objects are initialized concurrently (e.g. BatchRHF)
+std::mutex last_grid_lock;
+
+std::string grid_key(std::shared_ptr<BasisSet> primary, Options& options, int ansatz) {
+    std::stringstream key;
+    key.precision(14);
+    std::shared_ptr<Molecule> mol = primary->molecule();
+    for (int A = 0; A < mol->natom(); A++) {
+        key << mol->Z(A) << " " << mol->x(A) << " " << mol->y(A) << " " << mol->z(A) << "\n";
+    }
+    key << primary->name() << " " << primary->nbf() << " " << primary->nshell() << " " << ansatz << "\n";
+    for (std::string name : {"DFT_RADIAL_SCHEME", "DFT_PRUNING_SCHEME", "DFT_NUCLEAR_SCHEME", "DFT_GRID_NAME",
+                             "DFT_BLOCK_SCHEME"}) {
+        key << options.get_str(name) << " ";
+    }
+    for (std::string name : {"DFT_BLOCK_MAX_POINTS", "DFT_BLOCK_MIN_POINTS", "DFT_SPHERICAL_POINTS",
+                             "DFT_RADIAL_POINTS"}) {
+        key << options.get_int(name) << " ";
+    }
+    for (std::string name : {"DFT_BS_RADIUS_ALPHA", "DFT_PRUNING_ALPHA", "DFT_PRUNING_TOLERANCE",
+                             "DFT_BLOCK_MAX_RADIUS", "DFT_BASIS_TOLERANCE"}) {
+        key << options.get_double(name) << " ";
+    }
+    return key.str();
+}
+
+// Seconds since t, and restart t
+double lap(std::chrono::steady_clock::time_point& t) {
+    auto now = std::chrono::steady_clock::now();
+    double dt = std::chrono::duration<double>(now - t).count();
+    t = now;
+    return dt;
+}
+
+// Add the symmetric block-local V2 into the global V; atomics only when another thread
+// may be scattering a block with shared functions at the same time
+void scatter_block(double** Vp, double** V2p, const std::vector<int>& function_map, bool atomic) {
+    int nlocal = function_map.size();
+    if (!atomic) {
+        for (int ml = 0; ml < nlocal; ml++) {
+            int mg = function_map[ml];
+            for (int nl = 0; nl < ml; nl++) {
+                int ng = function_map[nl];
+                Vp[mg][ng] += V2p[ml][nl];
+                Vp[ng][mg] += V2p[ml][nl];
+            }
+            Vp[mg][mg] += V2p[ml][ml];
+        }
+        return;
+    }
+    for (int ml = 0; ml < nlocal; ml++) {
+        int mg = function_map[ml];
+        for (int nl = 0; nl < ml; nl++) {
+            int ng = function_map[nl];
+#pragma omp atomic update
+            Vp[mg][ng] += V2p[ml][nl];
+#pragma omp atomic update
+            Vp[ng][mg] += V2p[ml][nl];
+        }
+#pragma omp atomic update
+        Vp[mg][mg] += V2p[ml][ml];
+    }
+}
+
+}  // namespace
+
 void VBase::initialize() {
+    vx_kernel_.clear();
     timer_on("V: Grid");
-    grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, options_);
+    // Points, weights and the collocation screening only depend on the geometry, the basis
+    // and the grid options, so an identical earlier grid is taken as is
+    std::string key = grid_key(primary_, options_, functional_->ansatz());
+    {
+        std::lock_guard<std::mutex> lock(last_grid_lock);
+        grid_reused_ = options_.get_bool("DFT_GRID_REUSE") && last_grid.grid && last_grid.key == key;
+        if (grid_reused_) grid_ = last_grid.grid;
+    }
+    if (!grid_reused_) {
+        grid_ = std::make_shared<DFTGrid>(primary_->molecule(), primary_, options_);
+        std::lock_guard<std::mutex> lock(last_grid_lock);
+        last_grid.key = options_.get_bool("DFT_GRID_REUSE") ? key : std::string();
+        last_grid.grid = options_.get_bool("DFT_GRID_REUSE") ? grid_ : nullptr;
+    }
     timer_off("V: Grid");
 
     for (size_t i = 0; i < num_threads_; i++) {
         // Need a functional worker per thread
         functional_workers_.push_back(functional_->build_worker());
+        functional_workers_[i]->set_native_kernels(options_.get_bool("DFT_NATIVE_KERNELS"));
     }
 }
 SharedMatrix VBase::compute_gradient() { throw PSIEXCEPTION("VBase: gradient not implemented for this V instance."); }
 SharedMatrix VBase::compute_hessian() { throw PSIEXCEPTION("VBase: hessian not implemented for this V instance."); }
+std::vector<SharedMatrix> VBase::compute_fock_derivatives(int first, int count) {
+    throw PSIEXCEPTION("VBase: Fock derivatives not implemented for this V instance.");
+}
 void VBase::compute_V(std::vector<SharedMatrix> ret) {
     throw PSIEXCEPTION("VBase: deriv not implemented for this V instance.");
 }
@@ -179,12 +291,14 @@ void VBase::set_grac_shift(double grac_shift) {
             functional_workers_[i]->set_grac_beta(grac_beta);
             functional_workers_[i]->set_grac_x_functional(grac_x_func->build_worker());
             functional_workers_[i]->set_grac_c_functional(grac_c_func->build_worker());
+            functional_workers_[i]->set_native_kernels(options_.get_bool("DFT_NATIVE_KERNELS"));
             functional_workers_[i]->allocate();
             functional_workers_[i]->set_lock(true);
         }
         grac_initialized_ = true;
     }
 
+    vx_kernel_.clear();
     functional_->set_lock(false);
     functional_->set_grac_shift(grac_shift);
     functional_->set_lock(true);
@@ -201,9 +315,151 @@ void VBase::print_header() const {
 }
 std::shared_ptr<BlockOPoints> VBase::get_block(int block) { return grid_->blocks()[block]; }
 size_t VBase::nblocks() { return grid_->blocks().size(); }
-void VBase::finalize() { grid_.reset(); }
+void VBase::finalize() {
+    if (print_ > 1) print_phase_times();
+    vx_kernel_.clear();
+    release_spill();
+    grid_.reset();
+}
+void VBase::screen_collocation() {
+    if (grid_reused_) return;
+
+    // The extents only bound the radial envelope at the nearest point; the actual values
+    // over a block are often far smaller, and every shell kept here is carried through the
+    // phi D phi and phi^T v phi GEMMs of each iteration
+    double tolerance = options_.get_double("DFT_BASIS_TOLERANCE");
+    int deriv = std::min(point_workers_[0]->deriv(), 1);
+
+    size_t nbefore = 0;
+    size_t nafter = 0;
+    int rank = 0;
+#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_) reduction(+ : nbefore, nafter)
+    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        pworker->compute_functions(block);
+
+        std::vector<std::string> keys = {"PHI"};
+        if (deriv >= 1) keys.insert(keys.end(), {"PHI_X", "PHI_Y", "PHI_Z"});
+
+        const std::vector<int>& shells = block->shells_local_to_global();
+        size_t npoints = block->npoints();
+        std::vector<int> kept;
+        int offset = 0;
+        for (int P : shells) {
+            int nP = primary_->shell(P).nfunction();
+            double max_val = 0.0;
+            for (const std::string& key : keys) {
+                double** phip = pworker->basis_value(key)->pointer();
+                for (size_t p = 0; p < npoints; p++) {
+                    for (int f = offset; f < offset + nP; f++) max_val = std::max(max_val, std::fabs(phip[p][f]));
+                }
+            }
+            if (max_val >= tolerance) kept.push_back(P);
+            offset += nP;
+        }
+
+        nbefore += block->local_nbf();
+        if (kept.size() != shells.size()) block->set_local_shells(kept);
+        nafter += block->local_nbf();
+    }
+
+    if (print_ > 1) {
+        outfile->Printf("  Collocation screening kept %zu of %zu block-local basis functions.\n\n", nafter, nbefore);
+    }
+}
+void VBase::build_block_schedule() {
+    const auto& blocks = grid_->blocks();
+    phase_times_.assign(num_threads_, {{0.0, 0.0, 0.0, 0.0}});
+
+    // Longest blocks first: with dynamic scheduling the cheap outer blocks fill in the gaps
+    // at the end instead of one thread finishing a core block while the others wait
+    std::vector<std::pair<double, size_t>> cost(blocks.size());
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        double nlocal = blocks[Q]->local_nbf();
+        cost[Q] = std::make_pair(-(double)blocks[Q]->npoints() * nlocal * nlocal, Q);
+    }
+    std::sort(cost.begin(), cost.end());
+
+    // Greedy coloring: a block joins the first group none of whose blocks share a basis
+    // function with it. Only worth it while the groups stay large enough to keep every
+    // thread busy; compact molecules with diffuse functions fall back to atomics.
+    block_schedule_.clear();
+    colored_scatter_ = false;
+    size_t max_groups = blocks.size() / (8 * (size_t)num_threads_);
+    if (num_threads_ > 1 && max_groups > 1) {
+        std::vector<std::vector<char>> used;
+        bool fits = true;
+        for (size_t i = 0; i < cost.size() && fits; i++) {
+            const std::vector<int>& functions = blocks[cost[i].second]->functions_local_to_global();
+            size_t g = 0;
+            for (; g < used.size(); g++) {
+                bool clash = false;
+                for (int m : functions) {
+                    if (used[g][m]) {
+                        clash = true;
+                        break;
+                    }
+                }
+                if (!clash) break;
+            }
+            if (g == used.size()) {
+                if (used.size() == max_groups) {
+                    fits = false;
+                    break;
+                }
+                used.emplace_back(nbf_, 0);
+                block_schedule_.emplace_back();
+            }
+            for (int m : functions) used[g][m] = 1;
+            block_schedule_[g].push_back(cost[i].second);
+        }
+        colored_scatter_ = fits;
+    }
+    if (!colored_scatter_) {
+        block_schedule_.assign(1, std::vector<size_t>());
+        for (const auto& c : cost) block_schedule_[0].push_back(c.second);
+    }
+
+    if (print_ > 1) {
+        if (colored_scatter_) {
+            outfile->Printf("  V build: %zu blocks in %zu conflict-free groups.\n\n", blocks.size(),
+                            block_schedule_.size());
+        } else {
+            outfile->Printf("  V build: %zu blocks, atomic accumulation.\n\n", blocks.size());
+        }
+    }
+}
+void VBase::print_phase_times() const {
+    if (phase_times_.empty()) return;
+    std::array<double, 4> total = {{0.0, 0.0, 0.0, 0.0}};
+    double busiest = 0.0;
+    for (const auto& t : phase_times_) {
+        for (int k = 0; k < 4; k++) total[k] += t[k];
+        busiest = std::max(busiest, t[0] + t[1] + t[2] + t[3]);
+    }
+    double busy = total[0] + total[1] + total[2] + total[3];
+    if (busy == 0.0) return;
+    outfile->Printf("   => V Build Profile (thread seconds) <=\n\n");
+    outfile->Printf("    Collocation            = %14.3f\n", total[0]);
+    outfile->Printf("    Density                = %14.3f\n", total[1]);
+    outfile->Printf("    Functional             = %14.3f\n", total[2]);
+    outfile->Printf("    V                      = %14.3f\n", total[3]);
+    outfile->Printf("    Load Balance           = %14.3f\n", busy / (phase_times_.size() * busiest));
+    outfile->Printf("\n");
+}
 void VBase::build_collocation_cache(size_t memory){
 
+    // The cache is the first thing to go when a higher-priority module needs memory
+    collocation_budget_.reset();
+    collocation_budget_ = Process::environment.memory_broker().request(
+        "DFT collocation", 0, memory * sizeof(double), MemoryPriority::Low,
+        [this](size_t bytes) { return shrink_collocation_cache(bytes); });
+    memory = collocation_budget_->granted() / sizeof(double);
+
     // Figure out many blocks to skip
 
     size_t collocation_size = grid_->collocation_size();
@@ -222,17 +478,27 @@ void VBase::build_collocation_cache(size_t memory){
         stride = 1;
     }
 
+    cache_map_.clear();
+    release_spill();
+    cache_map_deriv_ = point_workers_[0]->deriv();
+
+    // Sibling processes of a shared-memory session compute the whole grid once, between them
+    if (SharedSegment::enabled() && share_collocation()) {
+        collocation_budget_->shrink_to(0);
+        return;
+    }
+
     // Effectively zero blocks saved.
     if (stride > grid_->blocks().size()) {
+        collocation_budget_->shrink_to(0);
+        if (options_.get_bool("DFT_COLLOCATION_SPILL")) spill_collocation();
         return;
     }
 
-    cache_map_.clear();
-    cache_map_deriv_ = point_workers_[0]->deriv();
     int rank = 0;
     size_t saved_size = 0;
     size_t ncomputed = 0;
-    #pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+    #pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_) reduction(+ : saved_size, ncomputed)
     for (size_t Q = 0; Q < grid_->blocks().size(); Q+=stride) {
         // Get thread info
         #ifdef _OPENMP
@@ -262,15 +528,173 @@ void VBase::build_collocation_cache(size_t memory){
             saved_size += nrows * ncols;
         }
         ncomputed++;
+        #pragma omp critical
         cache_map_[block->index()] = collocation_map;
     }
 
+    collocation_budget_->set_used(saved_size * sizeof(double));
+    collocation_budget_->shrink_to(saved_size * sizeof(double));
+
     size_t mib_saved = (size_t)(8 * (double)saved_size / 1024.0 / 1024.0);
     double fraction = (double) ncomputed / grid_->blocks().size() * 100;
     if (print_) {
         outfile->Printf("  Cached %.1lf%% of DFT collocation blocks in %d MiB.\n\n", fraction, mib_saved);
     }
 
+    // The rest go to scratch on request, so no block is recomputed every iteration
+    if (options_.get_bool("DFT_COLLOCATION_SPILL")) spill_collocation();
+}
+size_t VBase::shrink_collocation_cache(size_t bytes) {
+    size_t cached = 0;
+    for (const auto& block : cache_map_) {
+        for (const auto& kv : block.second) cached += kv.second->size() * sizeof(double);
+    }
+    // Dropped blocks are recomputed on the fly
+    for (auto it = cache_map_.begin(); it != cache_map_.end() && cached > bytes;) {
+        for (const auto& kv : it->second) cached -= kv.second->size() * sizeof(double);
+        it = cache_map_.erase(it);
+    }
+    if (collocation_budget_) collocation_budget_->set_used(cached);
+    return cached;
+}
+void VBase::spill_collocation() {
+    const auto& blocks = grid_->blocks();
+    size_t nblocks = blocks.size();
+    std::vector<std::string> keys;
+    for (auto& kv : point_workers_[0]->basis_values()) keys.push_back(kv.first);
+
+    // Packed npoints x local_nbf per key, laid out block after block
+    std::vector<size_t> offsets(nblocks + 1, 0);
+    for (size_t Q = 0; Q < nblocks; Q++) {
+        bool cached = cache_map_.count(blocks[Q]->index());
+        offsets[Q + 1] = offsets[Q] + (cached ? 0 : keys.size() * blocks[Q]->npoints() * blocks[Q]->local_nbf());
+    }
+    if (offsets[nblocks] == 0) return;
+
+    spill_file_ = PSIOManager::shared_object()->get_default_path() + "psi." + std::to_string(SYSTEM_GETPID()) +
+                  ".collocation." + std::to_string((size_t)this) + ".dat";
+    spill_bytes_ = offsets[nblocks] * sizeof(double);
+    int fd = ::open(spill_file_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) throw PSIEXCEPTION("V: Unable to open the collocation spill file " + spill_file_);
+    if (::ftruncate(fd, spill_bytes_) != 0) {
+        ::close(fd);
+        throw PSIEXCEPTION("V: Unable to size the collocation spill file " + spill_file_);
+    }
+    void* data = ::mmap(nullptr, spill_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) throw PSIEXCEPTION("V: Unable to map the collocation spill file " + spill_file_);
+    spill_data_ = static_cast<double*>(data);
+
+    // Entries first, so the parallel fill below only writes block data
+    map_collocation(spill_data_, offsets, keys);
+
+    fill_collocation(spill_data_, offsets, keys);
+
+    for (size_t i = 0; i < num_threads_; i++) point_workers_[i]->set_spill_map(&spill_map_);
+
+    if (print_) {
+        outfile->Printf("  Spilled %zu DFT collocation blocks to scratch in %zu MiB.\n\n", spill_map_.size(),
+                        spill_bytes_ / 1024 / 1024);
+    }
+}
+void VBase::map_collocation(const double* data, const std::vector<size_t>& offsets,
+                            const std::vector<std::string>& keys) {
+    const auto& blocks = grid_->blocks();
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        if (offsets[Q + 1] == offsets[Q]) continue;
+        size_t size = blocks[Q]->npoints() * blocks[Q]->local_nbf();
+        std::map<std::string, const double*>& entry = spill_map_[blocks[Q]->index()];
+        for (size_t k = 0; k < keys.size(); k++) entry[keys[k]] = data + offsets[Q] + k * size;
+    }
+}
+void VBase::fill_collocation(double* data, const std::vector<size_t>& offsets, const std::vector<std::string>& keys) {
+    const auto& blocks = grid_->blocks();
+    int rank = 0;
+#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
+    for (size_t Q = 0; Q < blocks.size(); Q++) {
+        if (offsets[Q + 1] == offsets[Q]) continue;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        std::shared_ptr<BlockOPoints> block = blocks[Q];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+        pworker->compute_functions(block);
+
+        size_t nrows = block->npoints();
+        size_t ncols = block->local_nbf();
+        for (size_t k = 0; k < keys.size(); k++) {
+            double** sourcep = pworker->basis_values()[keys[k]]->pointer();
+            double* destp = data + offsets[Q] + k * nrows * ncols;
+            for (size_t i = 0; i < nrows; i++) std::copy(sourcep[i], sourcep[i] + ncols, destp + i * ncols);
+        }
+    }
+}
+bool VBase::share_collocation() {
+    const auto& blocks = grid_->blocks();
+    size_t nblocks = blocks.size();
+    std::vector<std::string> keys;
+    for (auto& kv : point_workers_[0]->basis_values()) keys.push_back(kv.first);
+
+    // Every block, packed as in the spill file
+    std::vector<size_t> offsets(nblocks + 1, 0);
+    for (size_t Q = 0; Q < nblocks; Q++)
+        offsets[Q + 1] = offsets[Q] + keys.size() * blocks[Q]->npoints() * blocks[Q]->local_nbf();
+    if (offsets[nblocks] == 0) return false;
+
+    // The values depend on the basis, the derivative level and the exact points and functions of each block
+    std::string key = "VBase collocation\n";
+    auto append = [&key](const void* p, size_t bytes) { key.append(static_cast<const char*>(p), bytes); };
+    std::vector<double> basis;
+    basis.push_back(primary_->has_puream());
+    basis.push_back(primary_->nshell());
+    for (int P = 0; P < primary_->nshell(); P++) {
+        const GaussianShell& shell = primary_->shell(P);
+        const double* center = shell.center();
+        basis.insert(basis.end(), {center[0], center[1], center[2], (double)shell.am(), (double)shell.is_pure()});
+        for (int K = 0; K < shell.nprimitive(); K++) basis.insert(basis.end(), {shell.exp(K), shell.coef(K)});
+    }
+    append(basis.data(), basis.size() * sizeof(double));
+    append(&cache_map_deriv_, sizeof(int));
+    for (const std::string& k : keys) key += k + "\n";
+    for (size_t Q = 0; Q < nblocks; Q++) {
+        const BlockOPoints& block = *blocks[Q];
+        size_t npoints = block.npoints();
+        append(&npoints, sizeof(size_t));
+        append(block.x(), npoints * sizeof(double));
+        append(block.y(), npoints * sizeof(double));
+        append(block.z(), npoints * sizeof(double));
+        const auto& functions = block.functions_local_to_global();
+        size_t nlocal = functions.size();
+        append(&nlocal, sizeof(size_t));
+        append(functions.data(), nlocal * sizeof(int));
+    }
+
+    collocation_shared_ = SharedSegment::acquire(key, offsets[nblocks] * sizeof(double), [&](void* data) {
+        fill_collocation(static_cast<double*>(data), offsets, keys);
+    });
+    if (!collocation_shared_) return false;
+
+    map_collocation(static_cast<const double*>(collocation_shared_->data()), offsets, keys);
+    for (size_t i = 0; i < num_threads_; i++) point_workers_[i]->set_spill_map(&spill_map_);
+
+    if (print_) {
+        outfile->Printf("  %s %zu DFT collocation blocks in shared memory %s (%zu MiB).\n\n",
+                        collocation_shared_->created() ? "Placed" : "Mapped", nblocks,
+                        collocation_shared_->name().c_str(), offsets[nblocks] * sizeof(double) / 1024 / 1024);
+    }
+    return true;
+}
+void VBase::release_spill() {
+    for (size_t i = 0; i < point_workers_.size(); i++) point_workers_[i]->set_spill_map(nullptr);
+    spill_map_.clear();
+    // Other processes of the session may still use the segment, so it is only unmapped here
+    collocation_shared_.reset();
+    if (spill_data_) {
+        ::munmap(spill_data_, spill_bytes_);
+        ::unlink(spill_file_.c_str());
+        spill_data_ = nullptr;
+        spill_bytes_ = 0;
+    }
 }
 void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D, std::vector<std::map<std::string, SharedVector>>& vv10_cache, std::vector<std::shared_ptr<PointFunctions>>& nl_point_workers, int ansatz) {
 
@@ -311,46 +735,42 @@ void VBase::prepare_vv10_cache(DFTGrid& nlgrid, SharedMatrix D, std::vector<std:
             fworker->compute_vv10_cache(pworker->point_values(), block, vv10_rho_cutoff_, block->npoints(), false);
     }
 
-    // Stitch the cache together to make a single contiguous cache
-    size_t total_size = 0;
-    for (auto cache : vv10_tmp_cache) {
-        total_size += cache["W"]->dimpi()[0];
-    }
-
-    // printf("VV10 NL Total size %zu\n", total_size);
-
-    // Leave this as a vector of maps in case we ever revisit the on-the fly manipulation
-    vv10_cache.resize(1);
-    vv10_cache[0]["W"] = std::make_shared<Vector>("W Grid points", total_size);
-    vv10_cache[0]["X"] = std::make_shared<Vector>("X Grid points", total_size);
-    vv10_cache[0]["Y"] = std::make_shared<Vector>("Y Grid points", total_size);
-    vv10_cache[0]["Z"] = std::make_shared<Vector>("Z Grid points", total_size);
-    vv10_cache[0]["RHO"] = std::make_shared<Vector>("RHO Grid points", total_size);
-    vv10_cache[0]["W0"] = std::make_shared<Vector>("W0 Grid points", total_size);
-    vv10_cache[0]["KAPPA"] = std::make_shared<Vector>("KAPPA Grid points", total_size);
-
-    double* w_vecp = vv10_cache[0]["W"]->pointer();
-    double* x_vecp = vv10_cache[0]["X"]->pointer();
-    double* y_vecp = vv10_cache[0]["Y"]->pointer();
-    double* z_vecp = vv10_cache[0]["Z"]->pointer();
-    double* rho_vecp = vv10_cache[0]["RHO"]->pointer();
-    double* w0_vecp = vv10_cache[0]["W0"]->pointer();
-    double* kappa_vecp = vv10_cache[0]["KAPPA"]->pointer();
-
-    size_t offset = 0;
-    for (auto cache : vv10_tmp_cache) {
+    // One cache entry per block with significant density, so that compute_vv10_kernel can
+    // screen whole blocks by distance. BOUND holds the block's bounding sphere (center and
+    // radius), the sum of w rho, and the smallest W0 and kappa among its points.
+    vv10_cache.clear();
+    for (size_t Q = 0; Q < vv10_tmp_cache.size(); Q++) {
+        auto& cache = vv10_tmp_cache[Q];
         size_t csize = cache["W"]->dimpi()[0];
-        C_DCOPY(csize, cache["W"]->pointer(), 1, (w_vecp + offset), 1);
-        C_DCOPY(csize, cache["X"]->pointer(), 1, (x_vecp + offset), 1);
-        C_DCOPY(csize, cache["Y"]->pointer(), 1, (y_vecp + offset), 1);
-        C_DCOPY(csize, cache["Z"]->pointer(), 1, (z_vecp + offset), 1);
-        C_DCOPY(csize, cache["RHO"]->pointer(), 1, (rho_vecp + offset), 1);
-        C_DCOPY(csize, cache["W0"]->pointer(), 1, (w0_vecp + offset), 1);
-        C_DCOPY(csize, cache["KAPPA"]->pointer(), 1, (kappa_vecp + offset), 1);
+        if (!csize) continue;
+
+        const double* w = cache["W"]->pointer();
+        const double* rho = cache["RHO"]->pointer();
+        const double* w0 = cache["W0"]->pointer();
+        const double* kappa = cache["KAPPA"]->pointer();
+        double wrho = 0.0;
+        double w0_min = w0[0];
+        double kappa_min = kappa[0];
+        for (size_t P = 0; P < csize; P++) {
+            wrho += w[P] * rho[P];
+            w0_min = std::min(w0_min, w0[P]);
+            kappa_min = std::min(kappa_min, kappa[P]);
+        }
 
-        offset += csize;
+        std::shared_ptr<BlockOPoints> block = nlgrid.blocks()[Q];
+        auto bound = std::make_shared<Vector>("VV10 Block Bound", 7);
+        double* boundp = bound->pointer();
+        boundp[0] = block->xc()[0];
+        boundp[1] = block->xc()[1];
+        boundp[2] = block->xc()[2];
+        boundp[3] = block->R();
+        boundp[4] = wrho;
+        boundp[5] = w0_min;
+        boundp[6] = kappa_min;
+        cache["BOUND"] = bound;
+
+        vv10_cache.push_back(cache);
     }
-
 }
 double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
     timer_on("V: VV10");
@@ -406,7 +826,8 @@ double VBase::vv10_nlc(SharedMatrix D, SharedMatrix ret) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, -1, false,
+                                                       vv10_kernel_cutoff_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("VV10 Fock", rank);
@@ -501,7 +922,8 @@ SharedMatrix VBase::vv10_nlc_gradient(SharedMatrix D) {
         std::map<std::string, SharedVector> vals = fworker->values();
 
         parallel_timer_on("Kernel", rank);
-        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true);
+        vv10_exc[rank] += fworker->compute_vv10_kernel(pworker->point_values(), vv10_cache, block, npoints, true,
+                                                       vv10_kernel_cutoff_);
         parallel_timer_off("Kernel", rank);
 
         parallel_timer_on("V_xc gradient", rank);
@@ -564,9 +986,11 @@ void RV::initialize() {
         auto point_tmp = std::make_shared<RKSFunctions>(primary_, max_points, max_functions);
         point_tmp->set_ansatz(functional_->ansatz());
         point_tmp->set_cache_map(&cache_map_);
+        point_tmp->set_density_cutoff(block_density_cutoff_);
         point_workers_.push_back(point_tmp);
     }
-
+    screen_collocation();
+    build_block_schedule();
 }
 void RV::finalize() { VBase::finalize(); }
 void RV::print_header() const { VBase::print_header(); }
@@ -607,67 +1031,56 @@ void RV::compute_V(std::vector<SharedMatrix> ret) {
     std::vector<double> rhoayq(num_threads_);
     std::vector<double> rhoazq(num_threads_);
 
-// VV10 kernel data if requested
-
-// Traverse the blocks of points
-#pragma omp parallel for private(rank) schedule(guided) num_threads(num_threads_)
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+    // Traverse the blocks of points, group by group (see build_block_schedule)
+    for (const std::vector<size_t>& group : block_schedule_) {
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+        for (size_t i = 0; i < group.size(); i++) {
 // Get thread info
 #ifdef _OPENMP
-        rank = omp_get_thread_num();
+            rank = omp_get_thread_num();
 #endif
 
-        // Get per-rank workers
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
-        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
-        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-
-        // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block, false);
-        parallel_timer_off("Properties", rank);
-
-        // Compute functional values
-        parallel_timer_on("Functional", rank);
-        fworker->compute_functional(pworker->point_values());
-        parallel_timer_off("Functional", rank);
-
-        if (debug_ > 4) {
-            block->print("outfile", debug_);
-            pworker->print("outfile", debug_);
-        }
-
-        parallel_timer_on("V_xc", rank);
-
-        // => Compute quadrature <= //
-        std::vector<double> qvals = dft_integrators::rks_quadrature_integrate(block, fworker, pworker);
-        functionalq[rank] += qvals[0];
-        rhoaq[rank]  += qvals[1];
-        rhoaxq[rank] += qvals[2];
-        rhoayq[rank] += qvals[3];
-        rhoazq[rank] += qvals[4];
+            // Get per-rank workers
+            std::shared_ptr<BlockOPoints> block = grid_->blocks()[group[i]];
+            std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+            std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+            std::array<double, 4>& phase = phase_times_[rank];
+            auto clock = std::chrono::steady_clock::now();
+
+            // Compute Rho, Phi, etc
+            double collocation = pworker->collocation_time();
+            pworker->compute_points(block, false);
+            collocation = pworker->collocation_time() - collocation;
+            phase[0] += collocation;
+            phase[1] += lap(clock) - collocation;
+
+            // Nothing to integrate where the density is bounded away
+            if (pworker->negligible_block()) continue;
+
+            // Compute functional values
+            fworker->compute_functional(pworker->point_values());
+            phase[2] += lap(clock);
+
+            if (debug_ > 4) {
+                block->print("outfile", debug_);
+                pworker->print("outfile", debug_);
+            }
 
-        // => LSDA, GGA, and meta contribution (symmetrized) <= //
-        dft_integrators::rks_integrator(block, fworker, pworker, V_local[rank]);
+            // => Compute quadrature <= //
+            std::vector<double> qvals = dft_integrators::rks_quadrature_integrate(block, fworker, pworker);
+            functionalq[rank] += qvals[0];
+            rhoaq[rank]  += qvals[1];
+            rhoaxq[rank] += qvals[2];
+            rhoayq[rank] += qvals[3];
+            rhoazq[rank] += qvals[4];
 
-        // => Unpacking <= //
-        double** V2p = V_local[rank]->pointer();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
+            // => LSDA, GGA, and meta contribution (symmetrized) <= //
+            dft_integrators::rks_integrator(block, fworker, pworker, V_local[rank]);
 
-        for (int ml = 0; ml < nlocal; ml++) {
-            int mg = function_map[ml];
-            for (int nl = 0; nl < ml; nl++) {
-                int ng = function_map[nl];
-#pragma omp atomic update
-                Vp[mg][ng] += V2p[ml][nl];
-#pragma omp atomic update
-                Vp[ng][mg] += V2p[ml][nl];
-            }
-#pragma omp atomic update
-            Vp[mg][mg] += V2p[ml][ml];
+            // => Unpacking <= //
+            scatter_block(Vp, V_local[rank]->pointer(), block->functions_local_to_global(), !colored_scatter_);
+            phase[3] += lap(clock);
         }
-        parallel_timer_off("V_xc", rank);
     }
 
     // Do we need VV10?
@@ -773,6 +1186,15 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         functional_workers_[i]->allocate();
     }
 
+    // The ground-state part is the same for every call until set_D, so each block's
+    // densities and kernel are kept after the first call and only the trial densities
+    // are contracted on later calls (Davidson iterations in TDDFT/CPKS)
+    bool kernel_cached = (vx_kernel_.size() == grid_->blocks().size());
+    if (!kernel_cached) {
+        vx_kernel_.clear();
+        vx_kernel_.resize(grid_->blocks().size());
+    }
+
     // Output quantities
     std::vector<SharedMatrix> Vx_AO;
     for (size_t i = 0; i < Dx.size(); i++) {
@@ -802,22 +1224,47 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
+        std::map<std::string, SharedVector>& kernel = vx_kernel_[Q];
+        if (kernel_cached) {
+            // Only the basis values are needed again
+            {
+                PSI_TIMER_SCOPE("Properties");
+                pworker->fetch_functions(block, false);
+            }
+        } else {
+            // Compute Rho, Phi, etc
+            {
+                PSI_TIMER_SCOPE("Properties");
+                pworker->compute_points(block, false);
+            }
 
-        // Compute functional values
+            // Compute functional values
+            parallel_timer_on("Functional", rank);
+            std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+            parallel_timer_off("Functional", rank);
 
-        parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
-        parallel_timer_off("Functional", rank);
+            std::vector<std::pair<std::string, SharedVector>> keep = {
+                {"RHO_A", pworker->point_value("RHO_A")}, {"V_RHO_A_RHO_A", vals["V_RHO_A_RHO_A"]}};
+            if (ansatz >= 1) {
+                keep.insert(keep.end(), {{"RHO_AX", pworker->point_value("RHO_AX")},
+                                         {"RHO_AY", pworker->point_value("RHO_AY")},
+                                         {"RHO_AZ", pworker->point_value("RHO_AZ")},
+                                         {"V_GAMMA_AA", vals["V_GAMMA_AA"]},
+                                         {"V_GAMMA_AA_GAMMA_AA", vals["V_GAMMA_AA_GAMMA_AA"]},
+                                         {"V_RHO_A_GAMMA_AA", vals["V_RHO_A_GAMMA_AA"]}});
+            }
+            for (auto& kv : keep) {
+                auto copy = std::make_shared<Vector>(kv.first, npoints);
+                std::copy(kv.second->pointer(), kv.second->pointer() + npoints, copy->pointer());
+                kernel[kv.first] = copy;
+            }
+        }
 
         // => Grab quantities <= //
         // LDA
         double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* v2_rho2 = vals["V_RHO_A_RHO_A"]->pointer();
+        double* rho_a = kernel["RHO_A"]->pointer();
+        double* v2_rho2 = kernel["V_RHO_A_RHO_A"]->pointer();
         double* rho_k = R_rho_k[rank]->pointer();
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
@@ -840,9 +1287,9 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             phi_x = pworker->basis_value("PHI_X")->pointer();
             phi_y = pworker->basis_value("PHI_Y")->pointer();
             phi_z = pworker->basis_value("PHI_Z")->pointer();
-            rho_x = pworker->point_value("RHO_AX")->pointer();
-            rho_y = pworker->point_value("RHO_AY")->pointer();
-            rho_z = pworker->point_value("RHO_AZ")->pointer();
+            rho_x = kernel["RHO_AX"]->pointer();
+            rho_y = kernel["RHO_AY"]->pointer();
+            rho_z = kernel["RHO_AZ"]->pointer();
         }
 
         // Meta
@@ -899,9 +1346,9 @@ void RV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
             // => GGA contribution <= //
             // parallel_timer_on("GGA", rank);
             if (ansatz >= 1) {
-                double* v_gamma = vals["V_GAMMA_AA"]->pointer();
-                double* v2_gamma_gamma = vals["V_GAMMA_AA_GAMMA_AA"]->pointer();
-                double* v2_rho_gamma = vals["V_RHO_A_GAMMA_AA"]->pointer();
+                double* v_gamma = kernel["V_GAMMA_AA"]->pointer();
+                double* v2_gamma_gamma = kernel["V_GAMMA_AA_GAMMA_AA"]->pointer();
+                double* v2_rho_gamma = kernel["V_RHO_A_GAMMA_AA"]->pointer();
                 double tmp_val = 0.0, v2_val = 0.0;
 
                 for (int P = 0; P < npoints; P++) {
@@ -1027,9 +1474,10 @@ SharedMatrix RV::compute_gradient() {
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
 
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
+        {
+            PSI_TIMER_SCOPE("Properties");
+            pworker->compute_points(block, false);
+        }
 
         parallel_timer_on("Functional", rank);
         std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values());
@@ -1093,7 +1541,7 @@ SharedMatrix RV::compute_gradient() {
 
 SharedMatrix RV::compute_hessian() {
     if (functional_->is_gga() || functional_->is_meta())
-        throw PSIEXCEPTION("Hessians for GGA and meta GGA functionals are not yet implemented.");
+        throw PSIEXCEPTION("V: RKS Hessians are only implemented for LSDA functionals.");
 
     if ((D_AO_.size() != 1)) throw PSIEXCEPTION("V: RKS should have only one D Matrix");
 
@@ -1101,255 +1549,357 @@ SharedMatrix RV::compute_hessian() {
         throw PSIEXCEPTION("V: RKS cannot compute VV10 Hessian contribution.");
     }
 
-    // Build the target Hessian Matrix
+    timer_on("RV: Form Hessian");
+
     int natom = primary_->molecule()->natom();
-    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
-    double** Hp = H->pointer();
+    int max_functions = grid_->max_functions();
+    int max_points = grid_->max_points();
 
     // Thread info
     int rank = 0;
 
-    // Set Hessian derivative level in properties
-    int old_deriv = point_workers_[0]->deriv();
+    int old_point_deriv = point_workers_[0]->deriv();
     int old_func_deriv = functional_->deriv();
 
-    // How many functions are there (for lda in Vtemp, T)
-    int max_functions = grid_->max_functions();
-    int max_points = grid_->max_points();
-
-    int derivlev = (functional_->is_gga() || functional_->is_meta()) ? 3 : 2;
-    functional_->set_deriv(derivlev);
-
-    // Setup the pointers
+    // Basis second derivatives and the functional kernel
     for (size_t i = 0; i < num_threads_; i++) {
         point_workers_[i]->set_pointers(D_AO_[0]);
-        point_workers_[i]->set_deriv(derivlev);
-        functional_workers_[i]->set_deriv(derivlev);
+        point_workers_[i]->set_deriv(2);
+        functional_workers_[i]->set_deriv(2);
         functional_workers_[i]->allocate();
     }
 
     // Per thread temporaries
-    std::vector<SharedMatrix> V_local;
-    std::vector<std::shared_ptr<Vector>> Q_temp;
+    std::vector<SharedMatrix> H_local, K_local, R_local, W_local, M_local;
     for (size_t i = 0; i < num_threads_; i++) {
-        V_local.push_back(std::make_shared<Matrix>("V Temp", max_functions, max_functions));
-        Q_temp.push_back(std::make_shared<Vector>("Quadrature Tempt", max_points));
-    }
-
-    auto QT = std::make_shared<Vector>("Quadrature Temp", max_points);
-    double* QTp = QT->pointer();
-    const std::vector<std::shared_ptr<BlockOPoints>>& blocks = grid_->blocks();
-
-    for (size_t Q = 0; Q < blocks.size(); Q++) {
-// Get thread info
+        H_local.push_back(std::make_shared<Matrix>("H Temp", 3 * natom, 3 * natom));
+        K_local.push_back(std::make_shared<Matrix>("K Temp", 3 * natom, 3 * natom));
+        R_local.push_back(std::make_shared<Matrix>("Rho^x Temp", max_points, 3 * natom));
+        W_local.push_back(std::make_shared<Matrix>("W Temp", max_points, 3 * natom));
+        M_local.push_back(std::make_shared<Matrix>("M Temp", max_functions, max_functions));
+    }
+
+    /*
+     * With rho = 2 D_mn phi_m phi_n and all basis derivatives taken once per block,
+     *
+     *  H_AB <- w v_rho rho^AB + w v_rho_rho rho^A rho^B
+     *
+     *  rho^A  = -4 D_mn phi^x_m phi_n                     (m on A)
+     *  rho^AB =  4 d_AB D_mn phi^xy_m phi_n + 4 D_mn phi^x_m phi^y_n   (m on A, n on B)
+     */
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
 #ifdef _OPENMP
         rank = omp_get_thread_num();
 #endif
 
+        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
         std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
         std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** V2p = V_local[rank]->pointer();
-        double* QTp = Q_temp[rank]->pointer();
-        double** Dp = pworker->D_scratch()[0]->pointer();
 
-        // Scratch
-        double** Tp = pworker->scratch()[0]->pointer();
-        SharedMatrix U_local(pworker->scratch()[0]->clone());
-        double** Up = U_local->pointer();
-
-        // ACS TODO: these need to be threaded eventually, to fit in with the new infrastructure
-        auto Tmpx = std::make_shared<Vector>("Tx", max_functions);
-        auto Tmpy = std::make_shared<Vector>("Ty", max_functions);
-        auto Tmpz = std::make_shared<Vector>("Tz", max_functions);
-        double* pTx = Tmpx->pointer();
-        double* pTy = Tmpy->pointer();
-        double* pTz = Tmpz->pointer();
-        SharedMatrix Tx(U_local->clone());
-        SharedMatrix Ty(U_local->clone());
-        SharedMatrix Tz(U_local->clone());
-        double** pTx2 = Tx->pointer();
-        double** pTy2 = Ty->pointer();
-        double** pTz2 = Tz->pointer();
+        {
+            PSI_TIMER_SCOPE("Properties");
+            pworker->compute_points(block, false);
+        }
+        if (pworker->negligible_block()) continue;
 
-        std::shared_ptr<BlockOPoints> block = blocks[Q];
         int npoints = block->npoints();
-        double* x = block->x();
-        double* y = block->y();
-        double* z = block->z();
         double* w = block->w();
         const std::vector<int>& function_map = block->functions_local_to_global();
         int nlocal = function_map.size();
 
-        pworker->compute_points(block);
+        parallel_timer_on("Functional", rank);
         std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        parallel_timer_off("Functional", rank);
+
+        parallel_timer_on("V_xc Hessian", rank);
 
         double** phi = pworker->basis_value("PHI")->pointer();
-        double** phi_x = pworker->basis_value("PHI_X")->pointer();
-        double** phi_y = pworker->basis_value("PHI_Y")->pointer();
-        double** phi_z = pworker->basis_value("PHI_Z")->pointer();
+        double** phi_d[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
         double** phi_xx = pworker->basis_value("PHI_XX")->pointer();
         double** phi_xy = pworker->basis_value("PHI_XY")->pointer();
         double** phi_xz = pworker->basis_value("PHI_XZ")->pointer();
         double** phi_yy = pworker->basis_value("PHI_YY")->pointer();
         double** phi_yz = pworker->basis_value("PHI_YZ")->pointer();
         double** phi_zz = pworker->basis_value("PHI_ZZ")->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
+        double** phi_dd[3][3] = {{phi_xx, phi_xy, phi_xz}, {phi_xy, phi_yy, phi_yz}, {phi_xz, phi_yz, phi_zz}};
         size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
-        }
+        double* rho_a = pworker->point_value("RHO_A")->pointer();
+        double* v_rho_a = vals["V_RHO_A"]->pointer();
+        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
 
-        // => LSDA Contribution <= //
+        double** Hp = H_local[rank]->pointer();
+        double** Kp = K_local[rank]->pointer();
+        double** Rp = R_local[rank]->pointer();
+        double** Wp = W_local[rank]->pointer();
+        double** Mp = M_local[rank]->pointer();
+        double** Tp = pworker->scratch()[0]->pointer();
+        double** Dp = pworker->D_scratch()[0]->pointer();
 
-        /*
-         *                        m             n  ∂^2 F
-         *  H_mn <- 4 D_ab ɸ_a ɸ_b  D_cd ɸ_c ɸ_d   ------
-         *                                         ∂ ρ^2
-         */
+        // Atoms of the block, compactly numbered
+        std::vector<int> local_atom(nlocal);
+        std::vector<int> atoms;
+        for (int ml = 0; ml < nlocal; ml++) {
+            int A = primary_->function_to_center(function_map[ml]);
+            auto it = std::find(atoms.begin(), atoms.end(), A);
+            local_atom[ml] = it - atoms.begin();
+            if (it == atoms.end()) atoms.push_back(A);
+        }
+        int nlatom = atoms.size();
 
-        // T = ɸ D
+        // T = phi D
         C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[0], max_functions, 0.0, Tp[0],
                 max_functions);
 
-        // Compute rho, to filter out small values
+        // rho^A for every atom of the block, and its kernel-weighted copy
         for (int P = 0; P < npoints; P++) {
-            double rho = C_DDOT(nlocal, phi[P], 1, Tp[P], 1);
-            if (std::fabs(rho) < 1E-8) {
-                v_rho_a[P] = 0.0;
-                v_rho_aa[P] = 0.0;
+            std::fill(Rp[P], Rp[P] + 3 * nlatom, 0.0);
+            for (int ml = 0; ml < nlocal; ml++) {
+                int a = 3 * local_atom[ml];
+                Rp[P][a + 0] -= 4.0 * phi_d[0][P][ml] * Tp[P][ml];
+                Rp[P][a + 1] -= 4.0 * phi_d[1][P][ml] * Tp[P][ml];
+                Rp[P][a + 2] -= 4.0 * phi_d[2][P][ml] * Tp[P][ml];
             }
-            //            outfile->Printf("%f %f %f\n", w[P], v_rho_a[P], v_rho_aa[P]);
+            double wf = (rho_a[P] < v2_rho_cutoff_ ? 0.0 : w[P] * v_rho_aa[P]);
+            for (int a = 0; a < 3 * nlatom; a++) Wp[P][a] = wf * Rp[P][a];
         }
 
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 4.0 * w[P] * v_rho_aa[P], Tp[P], 1, Up[P], 1);
+        // Kernel term, all atom pairs at once
+        C_DGEMM('T', 'N', 3 * nlatom, 3 * nlatom, npoints, 1.0, Rp[0], 3 * natom, Wp[0], 3 * natom, 0.0, Kp[0],
+                3 * natom);
+        for (int a = 0; a < 3 * nlatom; a++) {
+            int ga = 3 * atoms[a / 3] + a % 3;
+            for (int b = 0; b < 3 * nlatom; b++) {
+                int gb = 3 * atoms[b / 3] + b % 3;
+                Hp[ga][gb] += Kp[a][b];
+            }
         }
 
-        for (int ml = 0; ml < nlocal; ml++) {
-            pTx[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_x[0][ml], coll_funcs);
-            pTy[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_y[0][ml], coll_funcs);
-            pTz[ml] = C_DDOT(npoints, &Tp[0][ml], max_functions, &phi_z[0][ml], coll_funcs);
+        // Potential weights: wv_P phi^x_m
+        for (int P = 0; P < npoints; P++) {
+            double wv = (rho_a[P] < v2_rho_cutoff_ ? 0.0 : w[P] * v_rho_a[P]);
+            Wp[P][0] = wv;
         }
 
+        // Same-atom term: 4 w v_rho phi^xy_m (phi D)_m
         for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double mx = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_x[0][ml], coll_funcs);
-            double my = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_y[0][ml], coll_funcs);
-            double mz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_z[0][ml], coll_funcs);
-            for (int nl = 0; nl < nlocal; nl++) {
-                int B = primary_->function_to_center(function_map[nl]);
-                Hp[3 * A + 0][3 * B + 0] += mx * pTx[nl];
-                Hp[3 * A + 0][3 * B + 1] += mx * pTy[nl];
-                Hp[3 * A + 0][3 * B + 2] += mx * pTz[nl];
-                Hp[3 * A + 1][3 * B + 0] += my * pTx[nl];
-                Hp[3 * A + 1][3 * B + 1] += my * pTy[nl];
-                Hp[3 * A + 1][3 * B + 2] += my * pTz[nl];
-                Hp[3 * A + 2][3 * B + 0] += mz * pTx[nl];
-                Hp[3 * A + 2][3 * B + 1] += mz * pTy[nl];
-                Hp[3 * A + 2][3 * B + 2] += mz * pTz[nl];
+            int A = atoms[local_atom[ml]];
+            for (int x = 0; x < 3; x++) {
+                for (int y = 0; y <= x; y++) {
+                    double val = 0.0;
+                    for (int P = 0; P < npoints; P++) val += Wp[P][0] * phi_dd[x][y][P][ml] * Tp[P][ml];
+                    Hp[3 * A + x][3 * A + y] += 4.0 * val;
+                    if (y != x) Hp[3 * A + y][3 * A + x] += 4.0 * val;
+                }
             }
         }
 
-        /*
-         *                        mn  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a ɸ_b    ---
-         *                            ∂ ρ
-         */
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], Tp[P], 1, Up[P], 1);
-        }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            double Txx = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xx[0][ml], coll_funcs);
-            double Txy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xy[0][ml], coll_funcs);
-            double Txz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_xz[0][ml], coll_funcs);
-            double Tyy = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yy[0][ml], coll_funcs);
-            double Tyz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_yz[0][ml], coll_funcs);
-            double Tzz = C_DDOT(npoints, &Up[0][ml], max_functions, &phi_zz[0][ml], coll_funcs);
-            Hp[3 * A + 0][3 * A + 0] += Txx;
-            Hp[3 * A + 0][3 * A + 1] += Txy;
-            Hp[3 * A + 0][3 * A + 2] += Txz;
-            Hp[3 * A + 1][3 * A + 0] += Txy;
-            Hp[3 * A + 1][3 * A + 1] += Tyy;
-            Hp[3 * A + 1][3 * A + 2] += Tyz;
-            Hp[3 * A + 2][3 * A + 0] += Txz;
-            Hp[3 * A + 2][3 * A + 1] += Tyz;
-            Hp[3 * A + 2][3 * A + 2] += Tzz;
+        // Pair term: 4 D_mn sum_P w v_rho phi^x_m phi^y_n
+        for (int x = 0; x < 3; x++) {
+            for (int P = 0; P < npoints; P++) {
+                for (int ml = 0; ml < nlocal; ml++) Tp[P][ml] = Wp[P][0] * phi_d[x][P][ml];
+            }
+            for (int y = 0; y < 3; y++) {
+                C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Tp[0], max_functions, phi_d[y][0], coll_funcs, 0.0,
+                        Mp[0], max_functions);
+                for (int ml = 0; ml < nlocal; ml++) {
+                    int A = atoms[local_atom[ml]];
+                    for (int nl = 0; nl < nlocal; nl++) {
+                        int B = atoms[local_atom[nl]];
+                        Hp[3 * A + x][3 * B + y] += 4.0 * Dp[ml][nl] * Mp[ml][nl];
+                    }
+                }
+            }
         }
 
-        /*
-         *                    m    n  ∂ F
-         *  H_mn <- 2 D_ab ɸ_a  ɸ_b   ---
-         *                            ∂ ρ
-         */
-        // T = ɸ_x D
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_x[0], coll_funcs, Dp[0], max_functions, 0.0, pTx2[0],
-                max_functions);
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_y[0], coll_funcs, Dp[0], max_functions, 0.0, pTy2[0],
-                max_functions);
-        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi_z[0], coll_funcs, Dp[0], max_functions, 0.0, pTz2[0],
-                max_functions);
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTx2[P], 1, Up[P], 1);
-        }
+        parallel_timer_off("V_xc Hessian", rank);
+    }
+
+    auto H = std::make_shared<Matrix>("XC Hessian", 3 * natom, 3 * natom);
+    for (auto const& val : H_local) {
+        H->add(val);
+    }
+    H->hermitivitize();
+
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
+    }
+
+    timer_off("RV: Form Hessian");
+    return H;
+}
+std::vector<SharedMatrix> RV::compute_fock_derivatives(int first, int count) {
+    if (functional_->is_gga() || functional_->is_meta())
+        throw PSIEXCEPTION("V: RKS Fock derivatives are only implemented for LSDA functionals.");
+
+    if ((D_AO_.size() != 1)) throw PSIEXCEPTION("V: RKS should have only one D Matrix");
+
+    int natom = primary_->molecule()->natom();
+    if (first < 0 || count < 0 || first + count > 3 * natom)
+        throw PSIEXCEPTION("V: RKS Fock derivative perturbations out of range.");
+
+    timer_on("RV: Form Fock Derivatives");
+
+    int max_functions = grid_->max_functions();
+    int max_points = grid_->max_points();
+
+    // Thread info
+    int rank = 0;
+
+    int old_point_deriv = point_workers_[0]->deriv();
+    int old_func_deriv = functional_->deriv();
+
+    for (size_t i = 0; i < num_threads_; i++) {
+        point_workers_[i]->set_pointers(D_AO_[0]);
+        point_workers_[i]->set_deriv(1);
+        functional_workers_[i]->set_deriv(2);
+        functional_workers_[i]->allocate();
+    }
+
+    std::vector<SharedMatrix> ret;
+    for (int i = 0; i < count; i++) {
+        ret.push_back(std::make_shared<Matrix>("Vxc derivative", nbf_, nbf_));
+    }
+
+    // Per thread temporaries
+    std::vector<SharedMatrix> Y_local, M_local, Z_local;
+    for (size_t i = 0; i < num_threads_; i++) {
+        Y_local.push_back(std::make_shared<Matrix>("Y Temp", 3 * max_functions, max_functions));
+        M_local.push_back(std::make_shared<Matrix>("M Temp", max_functions, max_functions));
+        Z_local.push_back(std::make_shared<Matrix>("Z Temp", max_points, max_functions));
+    }
+
+    /*
+     * For every perturbation A (an atom and direction), with phi, its derivatives and the
+     * kernel computed once per block:
+     *
+     *  V^A_mn = -w v_rho (phi^x_m phi_n + phi_m phi^x_n)  (m, n on A)  +  w v_rho_rho rho^A phi_m phi_n
+     */
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+
+        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
+        const std::vector<int>& function_map = block->functions_local_to_global();
+        int nlocal = function_map.size();
+
+        // Skip blocks without a function on a requested atom
+        std::vector<bool> perturbed(count, false);
+        bool any = false;
         for (int ml = 0; ml < nlocal; ml++) {
             int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 0][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 0][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 0][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
-        }
-        // y derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTy2[P], 1, Up[P], 1);
+            for (int x = 0; x < 3; x++) {
+                int k = 3 * A + x - first;
+                if (k >= 0 && k < count) perturbed[k] = any = true;
+            }
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 1][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 1][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 1][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
+        if (!any) continue;
+
+        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+
+        {
+            PSI_TIMER_SCOPE("Properties");
+            pworker->compute_points(block, false);
         }
-        // x derivatives
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Up[P], Up[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 2.0 * w[P] * v_rho_a[P], pTz2[P], 1, Up[P], 1);
+        if (pworker->negligible_block()) continue;
+
+        int npoints = block->npoints();
+        double* w = block->w();
+
+        parallel_timer_on("Functional", rank);
+        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+        parallel_timer_off("Functional", rank);
+
+        parallel_timer_on("V_xc derivatives", rank);
+
+        double** phi = pworker->basis_value("PHI")->pointer();
+        double** phi_d[3] = {pworker->basis_value("PHI_X")->pointer(), pworker->basis_value("PHI_Y")->pointer(),
+                             pworker->basis_value("PHI_Z")->pointer()};
+        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
+
+        double* rho_a = pworker->point_value("RHO_A")->pointer();
+        double* v_rho_a = vals["V_RHO_A"]->pointer();
+        double* v_rho_aa = vals["V_RHO_A_RHO_A"]->pointer();
+
+        double** Yp = Y_local[rank]->pointer();
+        double** Mp = M_local[rank]->pointer();
+        double** Zp = Z_local[rank]->pointer();
+        double** Tp = pworker->scratch()[0]->pointer();
+        double** Dp = pworker->D_scratch()[0]->pointer();
+
+        std::vector<int> center(nlocal);
+        for (int ml = 0; ml < nlocal; ml++) center[ml] = primary_->function_to_center(function_map[ml]);
+
+        // Y^x = (w v_rho phi^x)^T phi, for the basis function derivative terms
+        for (int x = 0; x < 3; x++) {
+            for (int P = 0; P < npoints; P++) {
+                double wv = (rho_a[P] < v2_rho_cutoff_ ? 0.0 : w[P] * v_rho_a[P]);
+                for (int ml = 0; ml < nlocal; ml++) Zp[P][ml] = wv * phi_d[x][P][ml];
+            }
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Zp[0], max_functions, phi[0], coll_funcs, 0.0,
+                    Yp[x * max_functions], max_functions);
         }
-        for (int ml = 0; ml < nlocal; ml++) {
-            int A = primary_->function_to_center(function_map[ml]);
-            Hp[3 * A + 2][3 * A + 0] += C_DDOT(npoints, &pTx2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 2][3 * A + 1] += C_DDOT(npoints, &pTy2[0][ml], max_functions, &Up[0][ml], max_functions);
-            Hp[3 * A + 2][3 * A + 2] += C_DDOT(npoints, &pTz2[0][ml], max_functions, &Up[0][ml], max_functions);
+
+        // T = phi D
+        C_DGEMM('N', 'N', npoints, nlocal, nlocal, 1.0, phi[0], coll_funcs, Dp[0], max_functions, 0.0, Tp[0],
+                max_functions);
+
+        for (int k = 0; k < count; k++) {
+            if (!perturbed[k]) continue;
+            int A = (first + k) / 3;
+            int x = (first + k) % 3;
+
+            // Kernel term: (w v_rho_rho rho^A phi)^T phi
+            for (int P = 0; P < npoints; P++) {
+                double rho_A = 0.0;
+                for (int ml = 0; ml < nlocal; ml++) {
+                    if (center[ml] == A) rho_A -= 4.0 * phi_d[x][P][ml] * Tp[P][ml];
+                }
+                double wf = (rho_a[P] < v2_rho_cutoff_ ? 0.0 : w[P] * v_rho_aa[P] * rho_A);
+                for (int ml = 0; ml < nlocal; ml++) Zp[P][ml] = wf * phi[P][ml];
+            }
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, Zp[0], max_functions, phi[0], coll_funcs, 0.0, Mp[0],
+                    max_functions);
+
+            // Basis function derivative terms
+            double** Yxp = &Yp[x * max_functions];
+            for (int ml = 0; ml < nlocal; ml++) {
+                if (center[ml] != A) continue;
+                for (int nl = 0; nl < nlocal; nl++) {
+                    Mp[ml][nl] -= Yxp[ml][nl];
+                    Mp[nl][ml] -= Yxp[ml][nl];
+                }
+            }
+
+            double** Vp = ret[k]->pointer();
+            for (int ml = 0; ml < nlocal; ml++) {
+                int mg = function_map[ml];
+                for (int nl = 0; nl < nlocal; nl++) {
+                    int ng = function_map[nl];
+#pragma omp atomic update
+                    Vp[mg][ng] += Mp[ml][nl];
+                }
+            }
         }
-    }
 
-    if (debug_) {
-        outfile->Printf("   => XC Hessian: Numerical Integrals <=\n\n");
-        outfile->Printf("    Functional Value:  %24.16E\n", quad_values_["FUNCTIONAL"]);
-        outfile->Printf("    <\\rho_a>        :  %24.16E\n", quad_values_["RHO_A"]);
-        outfile->Printf("    <\\rho_b>        :  %24.16E\n", quad_values_["RHO_B"]);
-        outfile->Printf("    <\\vec r\\rho_a>  : <%24.16E,%24.16E,%24.16E>\n", quad_values_["RHO_AX"],
-                        quad_values_["RHO_AY"], quad_values_["RHO_AZ"]);
-        outfile->Printf("    <\\vec r\\rho_b>  : <%24.16E,%24.16E,%24.16E>\n\n", quad_values_["RHO_BX"],
-                        quad_values_["RHO_BY"], quad_values_["RHO_BZ"]);
+        parallel_timer_off("V_xc derivatives", rank);
     }
 
     for (size_t i = 0; i < num_threads_; i++) {
-        point_workers_[i]->set_deriv(old_deriv);
+        point_workers_[i]->set_deriv(old_point_deriv);
+        functional_workers_[i]->set_deriv(old_func_deriv);
+        functional_workers_[i]->allocate();
     }
-    functional_->set_deriv(old_func_deriv);
-
-    // RKS
-    H->scale(2.0);
-    H->hermitivitize();
 
-    return H;
+    timer_off("RV: Form Fock Derivatives");
+    return ret;
 }
 
 UV::UV(std::shared_ptr<SuperFunctional> functional, std::shared_ptr<BasisSet> primary, Options& options)
@@ -1366,7 +1916,8 @@ void UV::initialize() {
         point_tmp->set_cache_map(&cache_map_);
         point_workers_.push_back(point_tmp);
     }
-
+    screen_collocation();
+    build_block_schedule();
 }
 void UV::finalize() { VBase::finalize(); }
 void UV::print_header() const { VBase::print_header(); }
@@ -1420,188 +1971,178 @@ void UV::compute_V(std::vector<SharedMatrix> ret) {
     std::vector<double> rhobyq(num_threads_);
     std::vector<double> rhobzq(num_threads_);
 
-    // Loop over grid
-    for (size_t Q = 0; Q < grid_->blocks().size(); Q++) {
+    // Loop over grid, group by group (see build_block_schedule)
+    for (const std::vector<size_t>& group : block_schedule_) {
+#pragma omp parallel for private(rank) schedule(dynamic) num_threads(num_threads_)
+        for (size_t i = 0; i < group.size(); i++) {
 // Get thread info
 #ifdef _OPENMP
-        rank = omp_get_thread_num();
+            rank = omp_get_thread_num();
 #endif
 
-        std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
-        std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
-        double** Va2p = Va_local[rank]->pointer();
-        double** Vb2p = Vb_local[rank]->pointer();
-        double* QTap = Qa_temp[rank]->pointer();
-        double* QTbp = Qb_temp[rank]->pointer();
-
-        // Scratch
-        double** Tap = pworker->scratch()[0]->pointer();
-        double** Tbp = pworker->scratch()[1]->pointer();
-
-        std::shared_ptr<BlockOPoints> block = grid_->blocks()[Q];
-        int npoints = block->npoints();
-        double* x = block->x();
-        double* y = block->y();
-        double* z = block->z();
-        double* w = block->w();
-        const std::vector<int>& function_map = block->functions_local_to_global();
-        int nlocal = function_map.size();
-
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block, false);
-        parallel_timer_off("Properties", rank);
-
-        parallel_timer_on("Functional", rank);
-        std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
-        parallel_timer_off("Functional", rank);
-
-        if (debug_ > 3) {
-            block->print("outfile", debug_);
-            pworker->print("outfile", debug_);
-        }
-
-        parallel_timer_on("V_xc", rank);
-        double** phi = pworker->basis_value("PHI")->pointer();
-        double* rho_a = pworker->point_value("RHO_A")->pointer();
-        double* rho_b = pworker->point_value("RHO_B")->pointer();
-        double* zk = vals["V"]->pointer();
-        double* v_rho_a = vals["V_RHO_A"]->pointer();
-        double* v_rho_b = vals["V_RHO_B"]->pointer();
-        size_t coll_funcs = pworker->basis_value("PHI")->ncol();
-
-        // => Quadrature values <= //
-        functionalq[rank] += C_DDOT(npoints, w, 1, zk, 1);
-        for (int P = 0; P < npoints; P++) {
-            QTap[P] = w[P] * rho_a[P];
-            QTbp[P] = w[P] * rho_b[P];
-        }
-        rhoaq[rank] += C_DDOT(npoints, w, 1, rho_a, 1);
-        rhoaxq[rank] += C_DDOT(npoints, QTap, 1, x, 1);
-        rhoayq[rank] += C_DDOT(npoints, QTap, 1, y, 1);
-        rhoazq[rank] += C_DDOT(npoints, QTap, 1, z, 1);
-        rhobq[rank] += C_DDOT(npoints, w, 1, rho_b, 1);
-        rhobxq[rank] += C_DDOT(npoints, QTbp, 1, x, 1);
-        rhobyq[rank] += C_DDOT(npoints, QTbp, 1, y, 1);
-        rhobzq[rank] += C_DDOT(npoints, QTbp, 1, z, 1);
-
-        // => LSDA contribution (symmetrized) <= //
-        // timer_on("V: LSDA");
-        for (int P = 0; P < npoints; P++) {
-            std::fill(Tap[P], Tap[P] + nlocal, 0.0);
-            std::fill(Tbp[P], Tbp[P] + nlocal, 0.0);
-            C_DAXPY(nlocal, 0.5 * v_rho_a[P] * w[P], phi[P], 1, Tap[P], 1);
-            C_DAXPY(nlocal, 0.5 * v_rho_b[P] * w[P], phi[P], 1, Tbp[P], 1);
-        }
-        // timer_off("V: LSDA");
+            std::shared_ptr<SuperFunctional> fworker = functional_workers_[rank];
+            std::shared_ptr<PointFunctions> pworker = point_workers_[rank];
+            double** Va2p = Va_local[rank]->pointer();
+            double** Vb2p = Vb_local[rank]->pointer();
+            double* QTap = Qa_temp[rank]->pointer();
+            double* QTbp = Qb_temp[rank]->pointer();
+
+            // Scratch
+            double** Tap = pworker->scratch()[0]->pointer();
+            double** Tbp = pworker->scratch()[1]->pointer();
+
+            std::shared_ptr<BlockOPoints> block = grid_->blocks()[group[i]];
+            int npoints = block->npoints();
+            double* x = block->x();
+            double* y = block->y();
+            double* z = block->z();
+            double* w = block->w();
+            const std::vector<int>& function_map = block->functions_local_to_global();
+            int nlocal = function_map.size();
+
+            std::array<double, 4>& phase = phase_times_[rank];
+            auto clock = std::chrono::steady_clock::now();
+
+            double collocation = pworker->collocation_time();
+            pworker->compute_points(block, false);
+            collocation = pworker->collocation_time() - collocation;
+            phase[0] += collocation;
+            phase[1] += lap(clock) - collocation;
+
+            std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
+            phase[2] += lap(clock);
+
+            if (debug_ > 3) {
+                block->print("outfile", debug_);
+                pworker->print("outfile", debug_);
+            }
 
-        // => GGA contribution (symmetrized) <= //
-        if (ansatz >= 1) {
-            // timer_on("V: GGA");
-            double** phix = pworker->basis_value("PHI_X")->pointer();
-            double** phiy = pworker->basis_value("PHI_Y")->pointer();
-            double** phiz = pworker->basis_value("PHI_Z")->pointer();
-            double* rho_ax = pworker->point_value("RHO_AX")->pointer();
-            double* rho_ay = pworker->point_value("RHO_AY")->pointer();
-            double* rho_az = pworker->point_value("RHO_AZ")->pointer();
-            double* rho_bx = pworker->point_value("RHO_BX")->pointer();
-            double* rho_by = pworker->point_value("RHO_BY")->pointer();
-            double* rho_bz = pworker->point_value("RHO_BZ")->pointer();
-            double* v_sigma_aa = vals["V_GAMMA_AA"]->pointer();
-            double* v_sigma_ab = vals["V_GAMMA_AB"]->pointer();
-            double* v_sigma_bb = vals["V_GAMMA_BB"]->pointer();
+            double** phi = pworker->basis_value("PHI")->pointer();
+            double* rho_a = pworker->point_value("RHO_A")->pointer();
+            double* rho_b = pworker->point_value("RHO_B")->pointer();
+            double* zk = vals["V"]->pointer();
+            double* v_rho_a = vals["V_RHO_A"]->pointer();
+            double* v_rho_b = vals["V_RHO_B"]->pointer();
+            size_t coll_funcs = pworker->basis_value("PHI")->ncol();
 
+            // => Quadrature values <= //
+            functionalq[rank] += C_DDOT(npoints, w, 1, zk, 1);
             for (int P = 0; P < npoints; P++) {
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1,
-                        Tap[P], 1);
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_ay[P] + v_sigma_ab[P] * rho_by[P]), phiy[P], 1,
-                        Tap[P], 1);
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_az[P] + v_sigma_ab[P] * rho_bz[P]), phiz[P], 1,
-                        Tap[P], 1);
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_bx[P] + v_sigma_ab[P] * rho_ax[P]), phix[P], 1,
-                        Tbp[P], 1);
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_by[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1,
-                        Tbp[P], 1);
-                C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_bz[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1,
-                        Tbp[P], 1);
+                QTap[P] = w[P] * rho_a[P];
+                QTbp[P] = w[P] * rho_b[P];
             }
-            // timer_off("V: GGA");
-        }
-
-        // timer_on("V: LSDA");
-        // Single GEMM slams GGA+LSDA together (man but GEM's hot!)
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tap[0], max_functions, 0.0, Va2p[0],
-                max_functions);
-        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tbp[0], max_functions, 0.0, Vb2p[0],
-                max_functions);
+            rhoaq[rank] += C_DDOT(npoints, w, 1, rho_a, 1);
+            rhoaxq[rank] += C_DDOT(npoints, QTap, 1, x, 1);
+            rhoayq[rank] += C_DDOT(npoints, QTap, 1, y, 1);
+            rhoazq[rank] += C_DDOT(npoints, QTap, 1, z, 1);
+            rhobq[rank] += C_DDOT(npoints, w, 1, rho_b, 1);
+            rhobxq[rank] += C_DDOT(npoints, QTbp, 1, x, 1);
+            rhobyq[rank] += C_DDOT(npoints, QTbp, 1, y, 1);
+            rhobzq[rank] += C_DDOT(npoints, QTbp, 1, z, 1);
 
-        // Symmetrization (V is Hermitian)
-        for (int m = 0; m < nlocal; m++) {
-            for (int n = 0; n <= m; n++) {
-                Va2p[m][n] = Va2p[n][m] = Va2p[m][n] + Va2p[n][m];
-                Vb2p[m][n] = Vb2p[n][m] = Vb2p[m][n] + Vb2p[n][m];
+            // => LSDA contribution (symmetrized) <= //
+            // timer_on("V: LSDA");
+            for (int P = 0; P < npoints; P++) {
+                std::fill(Tap[P], Tap[P] + nlocal, 0.0);
+                std::fill(Tbp[P], Tbp[P] + nlocal, 0.0);
+                C_DAXPY(nlocal, 0.5 * v_rho_a[P] * w[P], phi[P], 1, Tap[P], 1);
+                C_DAXPY(nlocal, 0.5 * v_rho_b[P] * w[P], phi[P], 1, Tbp[P], 1);
             }
-        }
-        // timer_off("V: LSDA");
-
-        // => Meta contribution <= //
-        if (ansatz >= 2) {
-            // timer_on("V: Meta");
-            double** phix = pworker->basis_value("PHI_X")->pointer();
-            double** phiy = pworker->basis_value("PHI_Y")->pointer();
-            double** phiz = pworker->basis_value("PHI_Z")->pointer();
-            double* v_tau_a = vals["V_TAU_A"]->pointer();
-            double* v_tau_b = vals["V_TAU_B"]->pointer();
+            // timer_off("V: LSDA");
 
-            double** phi[3];
-            phi[0] = phix;
-            phi[1] = phiy;
-            phi[2] = phiz;
+            // => GGA contribution (symmetrized) <= //
+            if (ansatz >= 1) {
+                // timer_on("V: GGA");
+                double** phix = pworker->basis_value("PHI_X")->pointer();
+                double** phiy = pworker->basis_value("PHI_Y")->pointer();
+                double** phiz = pworker->basis_value("PHI_Z")->pointer();
+                double* rho_ax = pworker->point_value("RHO_AX")->pointer();
+                double* rho_ay = pworker->point_value("RHO_AY")->pointer();
+                double* rho_az = pworker->point_value("RHO_AZ")->pointer();
+                double* rho_bx = pworker->point_value("RHO_BX")->pointer();
+                double* rho_by = pworker->point_value("RHO_BY")->pointer();
+                double* rho_bz = pworker->point_value("RHO_BZ")->pointer();
+                double* v_sigma_aa = vals["V_GAMMA_AA"]->pointer();
+                double* v_sigma_ab = vals["V_GAMMA_AB"]->pointer();
+                double* v_sigma_bb = vals["V_GAMMA_BB"]->pointer();
 
-            double* v_tau[2];
-            v_tau[0] = v_tau_a;
-            v_tau[1] = v_tau_b;
+                for (int P = 0; P < npoints; P++) {
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_ax[P] + v_sigma_ab[P] * rho_bx[P]), phix[P], 1,
+                            Tap[P], 1);
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_ay[P] + v_sigma_ab[P] * rho_by[P]), phiy[P], 1,
+                            Tap[P], 1);
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_aa[P] * rho_az[P] + v_sigma_ab[P] * rho_bz[P]), phiz[P], 1,
+                            Tap[P], 1);
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_bx[P] + v_sigma_ab[P] * rho_ax[P]), phix[P], 1,
+                            Tbp[P], 1);
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_by[P] + v_sigma_ab[P] * rho_ay[P]), phiy[P], 1,
+                            Tbp[P], 1);
+                    C_DAXPY(nlocal, w[P] * (2.0 * v_sigma_bb[P] * rho_bz[P] + v_sigma_ab[P] * rho_az[P]), phiz[P], 1,
+                            Tbp[P], 1);
+                }
+                // timer_off("V: GGA");
+            }
 
-            double** V_val[2];
-            V_val[0] = Va2p;
-            V_val[1] = Vb2p;
+            // timer_on("V: LSDA");
+            // Single GEMM slams GGA+LSDA together (man but GEM's hot!)
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tap[0], max_functions, 0.0, Va2p[0],
+                    max_functions);
+            C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phi[0], coll_funcs, Tbp[0], max_functions, 0.0, Vb2p[0],
+                    max_functions);
 
-            for (int s = 0; s < 2; s++) {
-                double** V2p = V_val[s];
-                double* v_taup = v_tau[s];
-                for (int i = 0; i < 3; i++) {
-                    double** phiw = phi[i];
-                    for (int P = 0; P < npoints; P++) {
-                        std::fill(Tap[P], Tap[P] + nlocal, 0.0);
-                        C_DAXPY(nlocal, v_taup[P] * w[P], phiw[P], 1, Tap[P], 1);
-                    }
-                    C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phiw[0], coll_funcs, Tap[0], max_functions, 1.0,
-                            V2p[0], max_functions);
+            // Symmetrization (V is Hermitian)
+            for (int m = 0; m < nlocal; m++) {
+                for (int n = 0; n <= m; n++) {
+                    Va2p[m][n] = Va2p[n][m] = Va2p[m][n] + Va2p[n][m];
+                    Vb2p[m][n] = Vb2p[n][m] = Vb2p[m][n] + Vb2p[n][m];
                 }
             }
+            // timer_off("V: LSDA");
+
+            // => Meta contribution <= //
+            if (ansatz >= 2) {
+                // timer_on("V: Meta");
+                double** phix = pworker->basis_value("PHI_X")->pointer();
+                double** phiy = pworker->basis_value("PHI_Y")->pointer();
+                double** phiz = pworker->basis_value("PHI_Z")->pointer();
+                double* v_tau_a = vals["V_TAU_A"]->pointer();
+                double* v_tau_b = vals["V_TAU_B"]->pointer();
+
+                double** phi[3];
+                phi[0] = phix;
+                phi[1] = phiy;
+                phi[2] = phiz;
+
+                double* v_tau[2];
+                v_tau[0] = v_tau_a;
+                v_tau[1] = v_tau_b;
+
+                double** V_val[2];
+                V_val[0] = Va2p;
+                V_val[1] = Vb2p;
+
+                for (int s = 0; s < 2; s++) {
+                    double** V2p = V_val[s];
+                    double* v_taup = v_tau[s];
+                    for (int i = 0; i < 3; i++) {
+                        double** phiw = phi[i];
+                        for (int P = 0; P < npoints; P++) {
+                            std::fill(Tap[P], Tap[P] + nlocal, 0.0);
+                            C_DAXPY(nlocal, v_taup[P] * w[P], phiw[P], 1, Tap[P], 1);
+                        }
+                        C_DGEMM('T', 'N', nlocal, nlocal, npoints, 1.0, phiw[0], coll_funcs, Tap[0], max_functions, 1.0,
+                                V2p[0], max_functions);
+                    }
+                }
 
-            // timer_off("V: Meta");
-        }
-
-        // => Unpacking <= //
-        for (int ml = 0; ml < nlocal; ml++) {
-            int mg = function_map[ml];
-            for (int nl = 0; nl < ml; nl++) {
-                int ng = function_map[nl];
-#pragma omp atomic update
-                Vap[mg][ng] += Va2p[ml][nl];
-#pragma omp atomic update
-                Vap[ng][mg] += Va2p[ml][nl];
-#pragma omp atomic update
-                Vbp[mg][ng] += Vb2p[ml][nl];
-#pragma omp atomic update
-                Vbp[ng][mg] += Vb2p[ml][nl];
+                // timer_off("V: Meta");
             }
-#pragma omp atomic update
-            Vap[mg][mg] += Va2p[ml][ml];
-#pragma omp atomic update
-            Vbp[mg][mg] += Vb2p[ml][ml];
+
+            // => Unpacking <= //
+            scatter_block(Vap, Va2p, function_map, !colored_scatter_);
+            scatter_block(Vbp, Vb2p, function_map, !colored_scatter_);
+            phase[3] += lap(clock);
         }
-        parallel_timer_off("V_xc", rank);
     }
 
     // Do we need VV10?
@@ -1768,9 +2309,10 @@ void UV::compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret)
         int nlocal = function_map.size();
 
         // Compute Rho, Phi, etc
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
+        {
+            PSI_TIMER_SCOPE("Properties");
+            pworker->compute_points(block, false);
+        }
 
         // Compute functional values
         parallel_timer_on("Functional", rank);
@@ -2204,9 +2746,10 @@ SharedMatrix UV::compute_gradient() {
         int nlocal = function_map.size();
 
         // Compute grid and functional
-        parallel_timer_on("Properties", rank);
-        pworker->compute_points(block);
-        parallel_timer_off("Properties", rank);
+        {
+            PSI_TIMER_SCOPE("Properties");
+            pworker->compute_points(block, false);
+        }
 
         parallel_timer_on("Functional", rank);
         std::map<std::string, SharedVector>& vals = fworker->compute_functional(pworker->point_values(), npoints);
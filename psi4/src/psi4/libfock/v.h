@@ -30,6 +30,7 @@
 #define LIBFOCK_DFT_H
 #include "psi4/libmints/typedefs.h"
 #include "psi4/pragma.h"
+#include <array>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -42,6 +43,8 @@ class DFTGrid;
 class PointFunctions;
 class SuperFunctional;
 class BlockOPoints;
+class MemoryBudget;
+class SharedSegment;
 
 // => BASE CLASS <= //
 
@@ -67,6 +70,10 @@ protected:
     double v2_rho_cutoff_;
     /// VV10 interior kernel threshold
     double vv10_rho_cutoff_;
+    /// Block pairs whose VV10 kernel is bounded below this are skipped
+    double vv10_kernel_cutoff_;
+    /// Blocks whose density is bounded below this are skipped in compute_V
+    double block_density_cutoff_;
     /// Options object, used to build grid
     Options& options_;
     /// Basis set used in the integration
@@ -84,6 +91,27 @@ protected:
     // Caches collocation grids
     std::unordered_map<size_t, std::map<std::string, SharedMatrix>> cache_map_;
     int cache_map_deriv_;
+    // Collocation blocks that did not fit in memory, mapped from a scratch file
+    std::unordered_map<size_t, std::map<std::string, const double*>> spill_map_;
+    std::string spill_file_;
+    double* spill_data_ = nullptr;
+    size_t spill_bytes_ = 0;
+    /// Write every block not held in cache_map_ to a mapped scratch file
+    void spill_collocation();
+    /// Unmap and delete the spill file, or unmap the shared collocation
+    void release_spill();
+    /// Point spill_map_ at the blocks packed in data at offsets (empty ranges are skipped)
+    void map_collocation(const double* data, const std::vector<size_t>& offsets, const std::vector<std::string>& keys);
+    /// Compute the blocks with nonempty offset ranges into data, in parallel
+    void fill_collocation(double* data, const std::vector<size_t>& offsets, const std::vector<std::string>& keys);
+    /// Map every block from a segment of the shared-memory session, building it if this process is first
+    bool share_collocation();
+    /// All collocation blocks, shared read-only with sibling processes (see SharedSegment)
+    std::shared_ptr<SharedSegment> collocation_shared_;
+    /// Share of the job memory behind cache_map_; the broker may shrink it
+    std::shared_ptr<MemoryBudget> collocation_budget_;
+    /// Drop cached blocks until at most bytes remain, returning the bytes still cached
+    size_t shrink_collocation_cache(size_t bytes);
 
     /// AO2USO matrix (if not C1)
     SharedMatrix AO2USO_;
@@ -92,6 +120,10 @@ protected:
     /// Vector of C1 D matrices (built by USO2AO)
     std::vector<SharedMatrix> D_AO_;
 
+    /// Per-block ground-state kernel (densities and functional second derivatives) for
+    /// compute_Vx, kept until the density or functional changes
+    std::vector<std::map<std::string, SharedVector>> vx_kernel_;
+
     // GRAC data
     bool grac_initialized_;
 
@@ -107,6 +139,22 @@ protected:
 
     /// Set things up
     void common_init();
+    /// Drop shells whose values (and gradients) are below DFT_BASIS_TOLERANCE on a whole block
+    void screen_collocation();
+    /// Was grid_ taken from an earlier V object (already screened)?
+    bool grid_reused_ = false;
+
+    /// compute_V block order: groups run one after another, the blocks of a group in parallel,
+    /// heaviest (npoints x local_nbf^2) first
+    std::vector<std::vector<size_t>> block_schedule_;
+    /// Do the blocks of each group touch disjoint basis functions, so V needs no atomics?
+    bool colored_scatter_ = false;
+    /// Group the (screened) blocks of grid_ into block_schedule_
+    void build_block_schedule();
+    /// Per-thread compute_V wall time [s]: collocation, density, functional, V
+    std::vector<std::array<double, 4>> phase_times_;
+    /// Print phase_times_ and the thread load balance they imply
+    void print_phase_times() const;
 
 
 public:
@@ -129,7 +177,11 @@ public:
 
     // Creates a collocation cache map based on stride
     void build_collocation_cache(size_t memory);
-    void clear_collocation_cache(void) { cache_map_.clear(); }
+    void clear_collocation_cache(void) {
+        cache_map_.clear();
+        collocation_budget_.reset();
+        release_spill();
+    }
 
     // Set the D matrix, get it back if needed
     void set_D(std::vector<SharedMatrix> Dvec);
@@ -143,6 +195,8 @@ public:
     virtual void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret);
     virtual SharedMatrix compute_gradient();
     virtual SharedMatrix compute_hessian();
+    /// Nuclear derivatives of Vxc at fixed D for perturbations [first, first + count), 3 per atom
+    virtual std::vector<SharedMatrix> compute_fock_derivatives(int first, int count);
 
     void set_print(int print) { print_ = print; }
     void set_debug(int debug) { debug_ = debug; }
@@ -172,6 +226,7 @@ public:
     virtual void compute_Vx(std::vector<SharedMatrix> Dx, std::vector<SharedMatrix> ret);
     virtual SharedMatrix compute_gradient();
     virtual SharedMatrix compute_hessian();
+    virtual std::vector<SharedMatrix> compute_fock_derivatives(int first, int count);
 
     virtual void print_header() const;
 };
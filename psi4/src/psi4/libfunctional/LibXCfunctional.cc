@@ -161,6 +161,25 @@ LibXCFunctional::LibXCFunctional(std::string xc_name, bool unpolarized) {
     vxc_ = xc_functional_->info->flags & XC_FLAGS_HAVE_VXC;
     fxc_ = xc_functional_->info->flags & XC_FLAGS_HAVE_FXC;
 
+    // The components LibXC would mix, for a native plan; modified parameters (tweaks, omega) drop it again
+    native_enabled_ = true;
+    if (unpolarized_) {
+        std::vector<int> ids;
+        std::vector<double> coefs;
+        bool plain = true;
+        if (xc_functional_->mix_coef == nullptr) {
+            ids.push_back(func_id_);
+            coefs.push_back(1.0);
+        } else {
+            for (size_t i = 0; i < xc_functional_->n_func_aux; i++) {
+                plain = plain && (xc_functional_->func_aux[i]->n_func_aux == 0);
+                ids.push_back(xc_functional_->func_aux[i]->info->number);
+                coefs.push_back(xc_functional_->mix_coef[i]);
+            }
+        }
+        if (plain) native_plan_ = native_xc::make_plan(ids, coefs);
+    }
+
     // VV10 info, ONLY for passing up the chain
     needs_vv10_ = false;
     vv10_c_ = 0.0;
@@ -194,12 +213,14 @@ std::shared_ptr<Functional> LibXCFunctional::build_worker() {
     func->exc_ = exc_;
     func->vxc_ = vxc_;
     func->fxc_ = fxc_;
+    func->native_enabled_ = native_enabled_;
 
     return static_cast<std::shared_ptr<Functional>>(func);
 }
 void LibXCFunctional::set_omega(double omega) {
     omega_ = omega;
     user_omega_ = true;
+    native_plan_ = native_xc::Plan();
     if (xc_func_name_ == "XC_GGA_X_WPBEH") {
         xc_gga_x_wpbeh_set_params(xc_functional_.get(), omega);
     } else if (xc_func_name_ == "XC_GGA_X_HJS_PBE") {
@@ -351,6 +372,7 @@ void LibXCFunctional::set_tweak(std::vector<double> values) {
     }
 
     user_tweakers_ = values;
+    native_plan_ = native_xc::Plan();
 }
 std::vector<std::tuple<std::string, int, double>> LibXCFunctional::get_mix_data() {
     std::vector<std::tuple<std::string, int, double>> ret;
@@ -390,6 +412,17 @@ void LibXCFunctional::compute_functional(const std::map<std::string, SharedVecto
         throw PSIEXCEPTION("LibXCfunctional: Third derivatives are not implemented!");
     }
 
+    // Closed-shell energies and potentials of the common functionals, in one fused pass
+    if (deriv == 1 && native_kernels()) {
+        const double* rho = in.find("RHO_A")->second->pointer();
+        const double* sigma = (native_plan_.gga ? in.find("GAMMA_AA")->second->pointer() : nullptr);
+        double* v = (exc_ ? out.find("V")->second->pointer() : nullptr);
+        double* v_rho = out.find("V_RHO_A")->second->pointer();
+        double* v_sigma = (native_plan_.gga ? out.find("V_GAMMA_AA")->second->pointer() : nullptr);
+        native_xc::compute(native_plan_, npoints, rho, sigma, v, v_rho, v_sigma, alpha_, lsda_cutoff_);
+        return;
+    }
+
     // => Input variables <= //
 
     double* rho_ap = nullptr;
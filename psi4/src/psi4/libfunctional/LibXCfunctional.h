@@ -30,6 +30,7 @@
 #define LibXC_FUNCTIONAL_H
 
 #include "psi4/libfunctional/functional.h"
+#include "psi4/libfunctional/native_kernels.h"
 #include "psi4/libmints/typedefs.h"
 
 #include <map>
@@ -66,6 +67,10 @@ private:
     // User defined tweakers
     std::vector<double> user_tweakers_;
 
+    // Closed-shell evaluation without LibXC, for the components native_xc knows
+    native_xc::Plan native_plan_;
+    bool native_enabled_;
+
 public:
 
     LibXCFunctional(std::string xc_name, bool unpolarized);
@@ -83,6 +88,11 @@ public:
     void set_tweak(std::vector<double> values);
     std::vector<std::tuple<std::string, int, double>> get_mix_data();
 
+    /// Use the native kernels where there are any (the default); false always calls LibXC
+    void set_native_kernels(bool on) { native_enabled_ = on; }
+    /// Will first derivatives be evaluated by the native kernels?
+    bool native_kernels() const { return native_enabled_ && native_plan_.recipe != native_xc::Recipe::None; }
+
     // Make queries to libxc
     std::map<std::string, double> query_libxc(const std::string& functional);
 
@@ -0,0 +1,123 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "native_kernels.h"
+
+#include "libxc/xc.h"
+
+namespace psi {
+namespace native_xc {
+
+Plan make_plan(const std::vector<int>& ids, const std::vector<double>& coefs) {
+    Plan plan;
+    plan.coef = coefs;
+
+    // Whole hybrids, component for component as LibXC mixes them
+    if (ids == std::vector<int>{XC_LDA_X, XC_GGA_X_B88, XC_LDA_C_VWN_RPA, XC_GGA_C_LYP}) {
+        plan.recipe = Recipe::B3LYP;
+    } else if (ids == std::vector<int>{XC_LDA_X, XC_GGA_X_B88, XC_LDA_C_VWN, XC_GGA_C_LYP}) {
+        plan.recipe = Recipe::B3LYP5;
+    } else if (ids == std::vector<int>{XC_GGA_X_PBE, XC_GGA_C_PBE}) {
+        plan.recipe = Recipe::PBE0;
+    } else if (ids.size() == 1) {
+        // Single components, as in BLYP or PBE built from separate x and c functionals
+        switch (ids[0]) {
+            case XC_LDA_X:
+                plan.recipe = Recipe::SlaterX;
+                break;
+            case XC_LDA_C_VWN_RPA:
+                plan.recipe = Recipe::VWNRPA;
+                break;
+            case XC_LDA_C_VWN:
+                plan.recipe = Recipe::VWN5;
+                break;
+            case XC_GGA_X_B88:
+                plan.recipe = Recipe::B88X;
+                break;
+            case XC_GGA_C_LYP:
+                plan.recipe = Recipe::LYPC;
+                break;
+            case XC_GGA_X_PBE:
+                plan.recipe = Recipe::PBEX;
+                break;
+            case XC_GGA_C_PBE:
+                plan.recipe = Recipe::PBEC;
+                break;
+            default:
+                break;
+        }
+    }
+
+    plan.gga = !(plan.recipe == Recipe::None || plan.recipe == Recipe::SlaterX || plan.recipe == Recipe::VWNRPA ||
+                 plan.recipe == Recipe::VWN5);
+    return plan;
+}
+
+void compute(const Plan& plan, size_t npoints, const double* rho, const double* sigma, double* v, double* v_rho,
+             double* v_sigma, double alpha, double cutoff) {
+    const double* c = plan.coef.data();
+    switch (plan.recipe) {
+        case Recipe::SlaterX:
+            compute_rks<SlaterX>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::VWNRPA:
+            compute_rks<VWNC<VWNRPAParameters>>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::VWN5:
+            compute_rks<VWNC<VWN5Parameters>>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::B88X:
+            compute_rks<B88X>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::LYPC:
+            compute_rks<LYPC>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::PBEX:
+            compute_rks<PBEX>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::PBEC:
+            compute_rks<PBEC>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::B3LYP:
+            compute_rks<SlaterX, B88X, VWNC<VWNRPAParameters>, LYPC>(c, npoints, rho, sigma, v, v_rho, v_sigma,
+                                                                     alpha, cutoff);
+            break;
+        case Recipe::B3LYP5:
+            compute_rks<SlaterX, B88X, VWNC<VWN5Parameters>, LYPC>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha,
+                                                                   cutoff);
+            break;
+        case Recipe::PBE0:
+            compute_rks<PBEX, PBEC>(c, npoints, rho, sigma, v, v_rho, v_sigma, alpha, cutoff);
+            break;
+        case Recipe::None:
+            break;
+    }
+}
+
+}  // namespace native_xc
+}  // namespace psi
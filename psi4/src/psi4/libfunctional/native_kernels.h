@@ -0,0 +1,262 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef NATIVE_KERNELS_H
+#define NATIVE_KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Native closed-shell kernels for the semilocal parts of the workhorse functionals
+ *
+ * LibXCFunctional hands every grid block to LibXC one component functional at
+ * a time, through interleaved scratch arrays. For the components below the
+ * whole weighted sum is instead evaluated here in one pass over the points,
+ * straight from and into the RHO_A/GAMMA_AA and V/V_RHO_A/V_GAMMA_AA vectors.
+ * Each kernel is written once, as its energy density f(rho, sigma) of the
+ * total density rho and sigma = |grad rho|^2 (LibXC's unpolarized
+ * variables), and differentiated exactly by evaluating it on Dual numbers.
+ **/
+namespace psi {
+namespace native_xc {
+
+/// A value with its derivatives with respect to rho and sigma
+struct Dual {
+    double v;
+    double r;
+    double s;
+};
+
+inline Dual operator+(const Dual& a, const Dual& b) { return {a.v + b.v, a.r + b.r, a.s + b.s}; }
+inline Dual operator-(const Dual& a, const Dual& b) { return {a.v - b.v, a.r - b.r, a.s - b.s}; }
+inline Dual operator*(const Dual& a, const Dual& b) { return {a.v * b.v, a.r * b.v + a.v * b.r, a.s * b.v + a.v * b.s}; }
+inline Dual operator/(const Dual& a, const Dual& b) {
+    double inv = 1.0 / b.v;
+    double q = a.v * inv;
+    return {q, (a.r - q * b.r) * inv, (a.s - q * b.s) * inv};
+}
+inline Dual operator+(const Dual& a, double b) { return {a.v + b, a.r, a.s}; }
+inline Dual operator+(double a, const Dual& b) { return {a + b.v, b.r, b.s}; }
+inline Dual operator-(const Dual& a, double b) { return {a.v - b, a.r, a.s}; }
+inline Dual operator-(double a, const Dual& b) { return {a - b.v, -b.r, -b.s}; }
+inline Dual operator-(const Dual& a) { return {-a.v, -a.r, -a.s}; }
+inline Dual operator*(const Dual& a, double b) { return {a.v * b, a.r * b, a.s * b}; }
+inline Dual operator*(double a, const Dual& b) { return {a * b.v, a * b.r, a * b.s}; }
+inline Dual operator/(const Dual& a, double b) { return a * (1.0 / b); }
+inline Dual operator/(double a, const Dual& b) {
+    double q = a / b.v;
+    double d = -q / b.v;
+    return {q, d * b.r, d * b.s};
+}
+
+/// f(a) with f'(a) = df, by the chain rule
+inline Dual chain(const Dual& a, double f, double df) { return {f, df * a.r, df * a.s}; }
+inline Dual exp(const Dual& a) {
+    double e = std::exp(a.v);
+    return chain(a, e, e);
+}
+inline Dual log(const Dual& a) { return chain(a, std::log(a.v), 1.0 / a.v); }
+inline Dual sqrt(const Dual& a) {
+    double q = std::sqrt(a.v);
+    return chain(a, q, 0.5 / q);
+}
+inline Dual pow(const Dual& a, double p) {
+    double q = std::pow(a.v, p);
+    return chain(a, q, p * q / a.v);
+}
+inline Dual atan(const Dual& a) { return chain(a, std::atan(a.v), 1.0 / (1.0 + a.v * a.v)); }
+inline Dual asinh(const Dual& a) { return chain(a, std::asinh(a.v), 1.0 / std::sqrt(1.0 + a.v * a.v)); }
+
+// => Kernels: energy density per volume of one component <= //
+
+/// LDA_X: Slater exchange
+struct SlaterX {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double Cx = -0.75 * std::cbrt(3.0 / M_PI);
+        return Cx * pow(rho, 4.0 / 3.0);
+    }
+};
+
+/// VWN paramagnetic correlation, the only part that survives at zeta = 0
+template <class Parameters>
+struct VWNC {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double A = 0.0310907;
+        const double b = Parameters::b;
+        const double c = Parameters::c;
+        const double x0 = Parameters::x0;
+        const double Q = std::sqrt(4.0 * c - b * b);
+        const double X0 = x0 * x0 + b * x0 + c;
+
+        Dual x = pow(rho, -1.0 / 6.0) * std::pow(3.0 / (4.0 * M_PI), 1.0 / 6.0);  // sqrt(rs)
+        Dual X = x * x + b * x + c;
+        Dual at = atan(Q / (2.0 * x + b));
+        Dual eps = A * (log(x * x / X) + (2.0 * b / Q) * at -
+                        (b * x0 / X0) * (log((x - x0) * (x - x0) / X) + (2.0 * (b + 2.0 * x0) / Q) * at));
+        return rho * eps;
+    }
+};
+/// LDA_C_VWN_RPA (VWN functional III, as in B3LYP)
+struct VWNRPAParameters {
+    static constexpr double b = 13.0720;
+    static constexpr double c = 42.7198;
+    static constexpr double x0 = -0.409286;
+};
+/// LDA_C_VWN (VWN functional V)
+struct VWN5Parameters {
+    static constexpr double b = 3.72744;
+    static constexpr double c = 12.9352;
+    static constexpr double x0 = -0.10498;
+};
+
+/// GGA_X_B88: Becke 88 exchange, summed over the two equal spins
+struct B88X {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double beta = 0.0042;
+        const double Cx = 1.5 * std::cbrt(3.0 / (4.0 * M_PI));
+        Dual rho_s43 = pow(0.5 * rho, 4.0 / 3.0);
+        Dual x = 0.5 * sqrt(sigma) / rho_s43;
+        return -2.0 * rho_s43 * (Cx + beta * x * x / (1.0 + 6.0 * beta * x * asinh(x)));
+    }
+};
+
+/// GGA_C_LYP: Lee-Yang-Parr correlation in Miehlich's form, at rho_a = rho_b
+struct LYPC {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double a = 0.04918;
+        const double b = 0.132;
+        const double c = 0.2533;
+        const double d = 0.349;
+        const double CF = 0.3 * std::pow(3.0 * M_PI * M_PI, 2.0 / 3.0);
+
+        Dual rm13 = pow(rho, -1.0 / 3.0);
+        Dual denom = 1.0 / (1.0 + d * rm13);
+        Dual delta = c * rm13 + d * rm13 * denom;
+        Dual omega = exp(-c * rm13) * denom;
+        Dual grad = sigma * pow(rho, -5.0 / 3.0) * (1.0 / 24.0 + 7.0 / 72.0 * delta);
+        return -a * rho * denom - a * b * omega * (CF * rho - grad);
+    }
+};
+
+/// GGA_X_PBE: Perdew-Burke-Ernzerhof exchange
+struct PBEX {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double kappa = 0.8040;
+        const double mu = 0.2195149727645171;
+        const double Cx = -0.75 * std::cbrt(3.0 / M_PI);
+        const double Cs = 1.0 / (4.0 * std::pow(3.0 * M_PI * M_PI, 2.0 / 3.0));
+
+        Dual rho43 = pow(rho, 4.0 / 3.0);
+        Dual s2 = Cs * sigma / (rho43 * rho43);
+        return Cx * rho43 * (1.0 + kappa - kappa / (1.0 + mu * s2 / kappa));
+    }
+};
+
+/// GGA_C_PBE: Perdew-Burke-Ernzerhof correlation on PW92 (LibXC's PW_MOD parameters) at zeta = 0
+struct PBEC {
+    static Dual energy(const Dual& rho, const Dual& sigma) {
+        const double A = 0.0310907;
+        const double a1 = 0.21370;
+        const double b1 = 7.5957;
+        const double b2 = 3.5876;
+        const double b3 = 1.6382;
+        const double b4 = 0.49294;
+        const double beta = 0.06672455060314922;
+        const double gamma = (1.0 - std::log(2.0)) / (M_PI * M_PI);
+
+        Dual rs = std::cbrt(3.0 / (4.0 * M_PI)) * pow(rho, -1.0 / 3.0);
+        Dual srs = sqrt(rs);
+        Dual eps = -2.0 * A * (1.0 + a1 * rs) *
+                   log(1.0 + 1.0 / (2.0 * A * (b1 * srs + b2 * rs + b3 * rs * srs + b4 * rs * rs)));
+
+        // t^2 = sigma / (2 ks rho)^2, ks^2 = 4 kF / pi
+        Dual kF = std::cbrt(3.0 * M_PI * M_PI) * pow(rho, 1.0 / 3.0);
+        Dual t2 = sigma / (16.0 / M_PI * kF * rho * rho);
+        Dual At = (beta / gamma) / (exp(-eps / gamma) - 1.0);
+        Dual At2 = At * t2;
+        Dual H = gamma * log(1.0 + (beta / gamma) * t2 * (1.0 + At2) / (1.0 + At2 + At2 * At2));
+        return rho * (eps + H);
+    }
+};
+
+// => Fused evaluation <= //
+
+/**
+ * Adds alpha * sum_k coef[k] Kernels[k] to v, v_rho and (for GGAs) v_sigma
+ * at every point whose density is at least cutoff; the others are left alone,
+ * as LibXC leaves them zero.
+ */
+template <class... Kernels>
+void compute_rks(const double* coef, size_t npoints, const double* rho, const double* sigma, double* v,
+                 double* v_rho, double* v_sigma, double alpha, double cutoff) {
+#if _OPENMP >= 201307  // OpenMP 4.0 or newer
+#pragma omp simd
+#endif
+    for (size_t i = 0; i < npoints; i++) {
+        if (rho[i] < cutoff) continue;
+        // A floor on sigma keeps the derivatives of sqrt(sigma) finite
+        const Dual r = {rho[i], 1.0, 0.0};
+        const Dual s = {sigma ? std::fmax(sigma[i], 1.0e-40) : 1.0e-40, 0.0, 1.0};
+        Dual f = {0.0, 0.0, 0.0};
+        size_t k = 0;
+        using expand = int[];
+        (void)expand{0, (f = f + coef[k++] * Kernels::energy(r, s), 0)...};
+        if (v) v[i] += alpha * f.v;
+        v_rho[i] += alpha * f.r;
+        if (v_sigma) v_sigma[i] += alpha * f.s;
+    }
+}
+
+/// The fused kernel sets with a specialized evaluation
+enum class Recipe { None, SlaterX, VWNRPA, VWN5, B88X, LYPC, PBEX, PBEC, B3LYP, B3LYP5, PBE0 };
+
+/// Everything LibXCFunctional needs to evaluate one LibXC functional natively
+struct Plan {
+    Recipe recipe = Recipe::None;
+    bool gga = false;
+    /// Component weights, in the order of the recipe's kernels
+    std::vector<double> coef;
+};
+
+/**
+ * The native plan for a LibXC functional made of the given LibXC functional
+ * ids and mixing coefficients (one id with coefficient 1 for a plain
+ * functional); Recipe::None if there is none, and LibXC stays in charge.
+ */
+Plan make_plan(const std::vector<int>& ids, const std::vector<double>& coefs);
+
+/// Evaluates the plan on npoints closed-shell points; see compute_rks
+void compute(const Plan& plan, size_t npoints, const double* rho, const double* sigma, double* v, double* v_rho,
+             double* v_sigma, double alpha, double cutoff);
+
+}  // namespace native_xc
+}  // namespace psi
+
+#endif
@@ -37,8 +37,10 @@
 #include "functional.h"
 #include "LibXCfunctional.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <limits>
 
 // using namespace psi;
 
@@ -376,6 +378,16 @@ void SuperFunctional::set_grac_shift(double grac_shift) {
     needs_grac_ = true;
     grac_shift_ = grac_shift;
 }
+void SuperFunctional::set_native_kernels(bool enabled) {
+    std::vector<std::shared_ptr<Functional>> functionals(x_functionals_);
+    functionals.insert(functionals.end(), c_functionals_.begin(), c_functionals_.end());
+    functionals.push_back(grac_x_functional_);
+    functionals.push_back(grac_c_functional_);
+    for (auto& fun : functionals) {
+        auto libxc = std::dynamic_pointer_cast<LibXCFunctional>(fun);
+        if (libxc) libxc->set_native_kernels(enabled);
+    }
+}
 void SuperFunctional::set_c_ss_alpha(double alpha){
     can_edit();
     c_ss_alpha_ = alpha;
@@ -807,9 +819,11 @@ std::map<std::string, SharedVector> SuperFunctional::compute_vv10_cache(
 double SuperFunctional::compute_vv10_kernel(
     const std::map<std::string, SharedVector>& vals,
     const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-    std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad) {
+    std::shared_ptr<BlockOPoints> block, int npoints, bool do_grad, double screen) {
 
-    // Kernel between left (*this) and right (vv10_cache) grids
+    // Kernel between left (*this) and right (vv10_cache) grids.
+    // Each right block carries a BOUND entry (center, radius, sum w rho, min W0, min kappa),
+    // see VBase::prepare_vv10_cache, used to drop blocks whose kernel is below screen.
 
     // Compute the vv10 cache in place
     const double l_thresh = 1.e-12;
@@ -840,6 +854,31 @@ double SuperFunctional::compute_vv10_kernel(
     const double* l_W0 = vv_values_["W0"]->pointer();
     const double* l_kappa = vv_values_["KAPPA"]->pointer();
 
+    // => Right blocks within reach <= //
+    // The kernel 1.5 w' rho' / (g g' (g + g')) with g = W0 R^2 + kappa decays as R^-6; bound it
+    // by the closest approach of the two bounding spheres and the smallest W0/kappa on each side
+    double l_W0_min = std::numeric_limits<double>::max();
+    double l_kappa_min = std::numeric_limits<double>::max();
+    for (size_t i = 0; i < l_npoints; i++) {
+        if (l_rho[i] < l_thresh) continue;
+        l_W0_min = std::min(l_W0_min, l_W0[i]);
+        l_kappa_min = std::min(l_kappa_min, l_kappa[i]);
+    }
+    std::vector<const std::map<std::string, SharedVector>*> r_blocks;
+    for (const auto& r_block : vv10_cache) {
+        if (screen > 0.0 && r_block.count("BOUND")) {
+            const double* bound = r_block.at("BOUND")->pointer();
+            double dx = block->xc()[0] - bound[0];
+            double dy = block->xc()[1] - bound[1];
+            double dz = block->xc()[2] - bound[2];
+            double R = std::max(0.0, std::sqrt(dx * dx + dy * dy + dz * dz) - block->R() - bound[3]);
+            double g = l_W0_min * R * R + l_kappa_min;
+            double gp = bound[5] * R * R + bound[6];
+            if (1.5 * bound[4] / (g * gp * (g + gp)) < screen) continue;
+        }
+        r_blocks.push_back(&r_block);
+    }
+
     for (size_t i = 0; i < l_npoints; i++){
 
         // Add Phi agnostic quantities
@@ -856,18 +895,18 @@ double SuperFunctional::compute_vv10_kernel(
         double xc = 0.0;
         double yc = 0.0;
         double zc = 0.0;
-        for (auto r_block : vv10_cache){
+        for (const auto* r_block : r_blocks){
 
             // Get right points
-            const double* r_x = r_block["X"]->pointer();
-            const double* r_y = r_block["Y"]->pointer();
-            const double* r_z = r_block["Z"]->pointer();
-            const double* r_w = r_block["W"]->pointer();
-            const double* r_rho = r_block["RHO"]->pointer();
-            const double* r_W0 = r_block["W0"]->pointer();
-            const double* r_kappa = r_block["KAPPA"]->pointer();
-
-            const size_t r_npoints = r_block["KAPPA"]->dimpi()[0];
+            const double* r_x = r_block->at("X")->pointer();
+            const double* r_y = r_block->at("Y")->pointer();
+            const double* r_z = r_block->at("Z")->pointer();
+            const double* r_w = r_block->at("W")->pointer();
+            const double* r_rho = r_block->at("RHO")->pointer();
+            const double* r_W0 = r_block->at("W0")->pointer();
+            const double* r_kappa = r_block->at("KAPPA")->pointer();
+
+            const size_t r_npoints = r_block->at("KAPPA")->dimpi()[0];
 
             // Interior Kernel
             if (do_grad){
@@ -146,7 +146,8 @@ public:
     // Copmutes the Cache data for VV10 dispersion
     double compute_vv10_kernel(const std::map<std::string, SharedVector>& vals,
                                const std::vector<std::map<std::string, SharedVector>>& vv10_cache,
-                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad=false);
+                               std::shared_ptr<BlockOPoints> block, int npoints = -1, bool do_grad=false,
+                               double screen = 0.0);
 
     // => Input/Output <= //
 
@@ -195,6 +196,8 @@ public:
     void set_grac_shift(double grac_shift);
     void set_grac_alpha(double grac_alpha);
     void set_grac_beta(double grac_beta);
+    // Lets LibXC components use the native closed-shell kernels; not affected by the lock
+    void set_native_kernels(bool enabled);
 
     // => Accessors <= //
 
@@ -0,0 +1,284 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+  \file
+  \ingroup IWL
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsi4util/exception.h"
+#include "blocks.h"
+
+namespace psi {
+
+namespace {
+
+/// Header of IWL_KEY_BLOCKS, followed by nblock IWLBlockInfo
+struct IWLBlockHeader {
+    uint64_t nblock;
+    uint32_t max_ints;
+    uint32_t version;
+};
+
+/// 4-bit code of an exactly zero value, next to the 0-8 significant-byte XOR codes
+const int iwl_zero_value = 15;
+
+inline uint64_t iwl_pair(uint64_t p, uint64_t q) { return p * (p + 1) / 2 + q; }
+
+inline void iwl_unpair(uint64_t pq, int &p, int &q) {
+    uint64_t r = (uint64_t)((std::sqrt(8.0 * pq + 1.0) - 1.0) / 2.0);
+    while (r * (r + 1) / 2 > pq) r--;
+    while ((r + 1) * (r + 2) / 2 <= pq) r++;
+    p = (int)r;
+    q = (int)(pq - r * (r + 1) / 2);
+}
+
+inline void put_varint(std::vector<unsigned char> &out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((unsigned char)v);
+}
+
+inline uint64_t get_varint(const unsigned char *&in, const unsigned char *end) {
+    uint64_t v = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        unsigned char byte = *in++;
+        v |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return v;
+    }
+    throw PSIEXCEPTION("IWL: corrupt integral block");
+}
+
+}  // namespace
+
+IWLBlockWriter::IWLBlockWriter(PSIO *psio, int itap, int nso, double cutoff, bool compress)
+    : psio_(psio),
+      itap_(itap),
+      cutoff_(cutoff),
+      compress_(compress),
+      next_(PSIO_ZERO),
+      offset_(0),
+      count_(0),
+      keep_(true) {
+    uint64_t npq = iwl_pair(nso, 0);
+    slice_rows_ = std::max<uint64_t>(1, (npq + IWL_BLOCK_SLICES - 1) / IWL_BLOCK_SLICES);
+    uint64_t nslice = (npq + slice_rows_ - 1) / slice_rows_ + 1;
+    tiles_.resize(iwl_pair(nslice, 0));
+    psio_->open(itap_, PSIO_OPEN_NEW);
+}
+
+IWLBlockWriter::~IWLBlockWriter() {
+    if (psio_->open_check(itap_)) close();
+}
+
+void IWLBlockWriter::write_value(int p, int q, int r, int s, double value) {
+    if (std::fabs(value) < cutoff_) return;
+    if (p < q) std::swap(p, q);
+    if (r < s) std::swap(r, s);
+    uint64_t pq = iwl_pair(p, q);
+    uint64_t rs = iwl_pair(r, s);
+    if (pq < rs) std::swap(pq, rs);
+
+    Tile &tile = tiles_[iwl_pair(pq / slice_rows_, rs / slice_rows_)];
+    tile.push_back(std::make_pair(iwl_pair(pq, rs), value));
+    count_++;
+    if (tile.size() == IWL_INTS_PER_BLOCK) flush_tile(tile);
+}
+
+void IWLBlockWriter::flush_tile(Tile &tile) {
+    if (tile.empty()) return;
+    std::sort(tile.begin(), tile.end(),
+              [](const std::pair<uint64_t, double> &a, const std::pair<uint64_t, double> &b) { return a.first < b.first; });
+
+    IWLBlockInfo info = IWLBlockInfo();
+    info.offset = offset_;
+    info.nints = tile.size();
+    info.rs_first = UINT64_MAX;
+    info.rs_last = 0;
+
+    std::vector<unsigned char> out;
+    out.reserve(tile.size() * 12);
+    uint64_t last_pq = 0, last_rs = 0;
+    for (size_t i = 0; i < tile.size(); i++) {
+        int pqp, pqq;
+        iwl_unpair(tile[i].first, pqp, pqq);
+        uint64_t pq = pqp, rs = pqq;
+        info.rs_first = std::min(info.rs_first, rs);
+        info.rs_last = std::max(info.rs_last, rs);
+        if (i == 0) {
+            info.pq_first = pq;
+            put_varint(out, pq);
+            put_varint(out, rs);
+        } else if (pq == last_pq) {
+            put_varint(out, 0);
+            put_varint(out, rs - last_rs - 1);
+        } else {
+            put_varint(out, pq - last_pq);
+            put_varint(out, rs);
+        }
+        last_pq = pq;
+        last_rs = rs;
+    }
+    info.pq_last = last_pq;
+
+    size_t labels = out.size();
+    info.compressed = 0;
+    if (compress_) {
+        size_t codes = out.size();
+        out.resize(out.size() + (tile.size() + 1) / 2, 0);
+        uint64_t prev = 0;
+        for (size_t i = 0; i < tile.size(); i++) {
+            uint64_t word;
+            memcpy(&word, &tile[i].second, sizeof(uint64_t));
+            uint64_t x = word ^ prev;
+            prev = word;
+            int code;
+            if (word == 0 && x != 0) {
+                code = iwl_zero_value;
+            } else {
+                code = 0;
+                for (uint64_t t = x; t; t >>= 8) code++;
+                for (int b = 0; b < code; b++) out.push_back((unsigned char)(x >> (8 * b)));
+            }
+            out[codes + i / 2] |= (unsigned char)(code << (4 * (i % 2)));
+        }
+        info.compressed = 1;
+    }
+    if (!info.compressed || out.size() - labels >= tile.size() * sizeof(double)) {
+        // Uncompressed or incompressible values are stored raw
+        out.resize(labels);
+        info.compressed = 0;
+        size_t start = out.size();
+        out.resize(start + tile.size() * sizeof(double));
+        for (size_t i = 0; i < tile.size(); i++)
+            memcpy(&out[start + i * sizeof(double)], &tile[i].second, sizeof(double));
+    }
+
+    info.nbytes = out.size();
+    psio_->write(itap_, IWL_KEY_BLOCK_DATA, (char *)out.data(), out.size(), next_, &next_);
+    offset_ += out.size();
+    index_.push_back(info);
+    tile.clear();
+}
+
+void IWLBlockWriter::close() {
+    for (Tile &tile : tiles_) flush_tile(tile);
+    tiles_.clear();
+
+    IWLBlockHeader header;
+    header.nblock = index_.size();
+    header.max_ints = IWL_INTS_PER_BLOCK;
+    header.version = 1;
+    std::vector<char> entry(sizeof(IWLBlockHeader) + index_.size() * sizeof(IWLBlockInfo));
+    memcpy(entry.data(), &header, sizeof(IWLBlockHeader));
+    if (index_.size()) memcpy(&entry[sizeof(IWLBlockHeader)], index_.data(), index_.size() * sizeof(IWLBlockInfo));
+    psio_->write_entry(itap_, IWL_KEY_BLOCKS, entry.data(), entry.size());
+    psio_->close(itap_, keep_);
+}
+
+bool IWLBlockReader::present(PSIO *psio, int itap) { return psio->tocscan(itap, IWL_KEY_BLOCKS) != nullptr; }
+
+IWLBlockReader::IWLBlockReader(PSIO *psio, int itap) : psio_(psio), itap_(itap), next_(0) {
+    IWLBlockHeader header;
+    psio_address next = PSIO_ZERO;
+    psio_->read(itap_, IWL_KEY_BLOCKS, (char *)&header, sizeof(IWLBlockHeader), next, &next);
+    index_.resize(header.nblock);
+    if (header.nblock)
+        psio_->read(itap_, IWL_KEY_BLOCKS, (char *)index_.data(), header.nblock * sizeof(IWLBlockInfo), next, &next);
+    max_ints_ = header.max_ints;
+    if (max_ints_ > IWL_INTS_PER_BUF) throw PSIEXCEPTION("IWL: integral blocks do not fit an IWL buffer");
+}
+
+int IWLBlockReader::fetch(Label *labels, Value *values, int &last) {
+    while (next_ < index_.size() && filter_ && !filter_(index_[next_])) next_++;
+    if (next_ == index_.size()) {
+        last = 1;
+        return 0;
+    }
+
+    const IWLBlockInfo &info = index_[next_++];
+    data_.resize(info.nbytes);
+    psio_address start = psio_get_address(PSIO_ZERO, info.offset);
+    psio_->read(itap_, IWL_KEY_BLOCK_DATA, (char *)data_.data(), info.nbytes, start, &start);
+
+    const unsigned char *in = data_.data();
+    const unsigned char *end = in + data_.size();
+    uint64_t pq = 0, rs = 0;
+    for (uint32_t i = 0; i < info.nints; i++) {
+        uint64_t step = get_varint(in, end);
+        uint64_t value = get_varint(in, end);
+        if (i == 0) {
+            pq = step;
+            rs = value;
+        } else if (step == 0) {
+            rs += value + 1;
+        } else {
+            pq += step;
+            rs = value;
+        }
+        int p, q, r, s;
+        iwl_unpair(pq, p, q);
+        iwl_unpair(rs, r, s);
+        labels[4 * i] = p;
+        labels[4 * i + 1] = q;
+        labels[4 * i + 2] = r;
+        labels[4 * i + 3] = s;
+    }
+
+    if (info.compressed) {
+        const unsigned char *codes = in;
+        in += (info.nints + 1) / 2;
+        uint64_t prev = 0;
+        for (uint32_t i = 0; i < info.nints; i++) {
+            int code = (codes[i / 2] >> (4 * (i % 2))) & 0xF;
+            if (code == iwl_zero_value) {
+                prev = 0;
+            } else {
+                if (code > 8 || in + code > end) throw PSIEXCEPTION("IWL: corrupt integral block");
+                uint64_t x = 0;
+                for (int b = 0; b < code; b++) x |= (uint64_t)(*in++) << (8 * b);
+                prev ^= x;
+            }
+            memcpy(&values[i], &prev, sizeof(double));
+        }
+    } else {
+        if (in + info.nints * sizeof(double) > end) throw PSIEXCEPTION("IWL: corrupt integral block");
+        memcpy(values, in, info.nints * sizeof(double));
+    }
+
+    while (next_ < index_.size() && filter_ && !filter_(index_[next_])) next_++;
+    last = (next_ == index_.size());
+    return info.nints;
+}
+
+}  // namespace psi
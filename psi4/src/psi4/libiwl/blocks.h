@@ -0,0 +1,145 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libiwl_blocks_h_
+#define _psi_src_lib_libiwl_blocks_h_
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "psi4/libpsio/psio.hpp"
+#include "config.h"
+
+namespace psi {
+
+/*! \ingroup IWL
+ *  Entry of the block index of a blocked IWL file, see IWLBlockWriter
+ */
+struct IWLBlockInfo {
+    /// Byte offset of the block in IWL_KEY_BLOCK_DATA
+    uint64_t offset;
+    /// Ranges of canonical pq = p(p+1)/2 + q (p >= q) and rs covered by the block
+    uint64_t pq_first;
+    uint64_t pq_last;
+    uint64_t rs_first;
+    uint64_t rs_last;
+    /// Encoded length in bytes and number of integrals
+    uint32_t nbytes;
+    uint32_t nints;
+    /// Are the values compressed, rather than raw?
+    uint32_t compressed;
+    uint32_t reserved;
+};
+
+/*! \ingroup IWL
+ *  \class IWLBlockWriter
+ *  \brief Writes two-electron integrals as a blocked IWL file.
+ *
+ * Integrals are canonicalized to p >= q, r >= s, pq >= rs. The canonical pairs are cut into
+ * IWL_BLOCK_SLICES ranges, and integrals are gathered into one tile per (pq range, rs range). A tile
+ * is written as one block, sorted by (pq, rs), whenever it holds IWL_INTS_PER_BLOCK integrals. Every
+ * block thus covers narrow pq and rs ranges, and readers can skip blocks they have no use for.
+ *
+ * Within a block the labels are stored as LEB128 varints of the pq step and of rs (the rs step when
+ * pq repeats). Values are raw doubles or, when compressed and smaller for it, XORed with their
+ * predecessor with only the significant bytes kept under a 4-bit code (lossless). The block index
+ * goes to IWL_KEY_BLOCKS when the writer is closed.
+ *
+ * IWL and iwl_buf_init() recognize blocked files and decode them into ordinary IWL buffers, so
+ * every existing reader works unchanged.
+ */
+class PSI_API IWLBlockWriter {
+    typedef std::vector<std::pair<uint64_t, double> > Tile;
+
+    PSIO *psio_;
+    int itap_;
+    double cutoff_;
+    bool compress_;
+    /// Canonical pairs per range
+    uint64_t slice_rows_;
+    /// Tile (a, b), b <= a, at a(a+1)/2 + b
+    std::vector<Tile> tiles_;
+    std::vector<IWLBlockInfo> index_;
+    psio_address next_;
+    uint64_t offset_;
+    size_t count_;
+    bool keep_;
+
+    void flush_tile(Tile &tile);
+
+   public:
+    /// Open itap new for the integrals of nso orbitals; values below cutoff are dropped
+    IWLBlockWriter(PSIO *psio, int itap, int nso, double cutoff, bool compress);
+    ~IWLBlockWriter();
+
+    /// Add the integral (pq|rs)
+    void write_value(int p, int q, int r, int s, double value);
+    /// Write the remaining blocks and the index, then close the unit
+    void close();
+    void set_keep_flag(bool k) { keep_ = k; }
+
+    /// Integrals written, and bytes they take on disk
+    size_t count() const { return count_; }
+    size_t bytes() const { return offset_; }
+};
+
+/*! \ingroup IWL
+ *  \class IWLBlockReader
+ *  \brief Streams the blocks of a blocked IWL file on an open unit.
+ */
+class PSI_API IWLBlockReader {
+    PSIO *psio_;
+    int itap_;
+    std::vector<IWLBlockInfo> index_;
+    uint32_t max_ints_;
+    size_t next_;
+    std::function<bool(const IWLBlockInfo &)> filter_;
+    std::vector<unsigned char> data_;
+
+   public:
+    /// Does open unit itap hold a blocked IWL file?
+    static bool present(PSIO *psio, int itap);
+    /// Read the block index of open unit itap
+    IWLBlockReader(PSIO *psio, int itap);
+
+    /// Only decode blocks for which want(block) is true; set before the first fetch()
+    void set_filter(std::function<bool(const IWLBlockInfo &)> want) { filter_ = want; }
+    /**
+     * Decode the next wanted block into IWL-style buffers (4 labels per integral), returning the
+     * number of integrals, at most max_ints(); last is set once no wanted block is left.
+     */
+    int fetch(Label *labels, Value *values, int &last);
+
+    uint32_t max_ints() const { return max_ints_; }
+    const std::vector<IWLBlockInfo> &index() const { return index_; }
+};
+
+}  // namespace psi
+
+#endif
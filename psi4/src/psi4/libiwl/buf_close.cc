@@ -37,6 +37,7 @@
 #include "psi4/libpsio/psio.h"
 #include "iwl.h"
 #include "iwl.hpp"
+#include "blocks.h"
 
 namespace psi {
 
@@ -48,6 +49,7 @@ void IWL::close() {
     if (values_) delete[](values_);
     labels_ = nullptr;
     values_ = nullptr;
+    blocks_.reset();
 }
 
 /*!
@@ -63,5 +65,7 @@ void PSI_API iwl_buf_close(struct iwlbuf *Buf, int keep) {
     psio_close(Buf->itap, keep ? 1 : 0);
     free(Buf->labels);
     free(Buf->values);
+    delete Buf->blocks;
+    Buf->blocks = nullptr;
 }
 }
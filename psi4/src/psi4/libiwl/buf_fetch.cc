@@ -34,10 +34,16 @@
 #include "psi4/libpsio/psio.h"
 #include "iwl.h"
 #include "iwl.hpp"
+#include "blocks.h"
 
 namespace psi {
 
 void IWL::fetch() {
+    if (blocks_) {
+        inbuf_ = blocks_->fetch(labels_, values_, lastbuf_);
+        idx_ = 0;
+        return;
+    }
     psio_->read(itap_, IWL_KEY_BUF, (char *)&(lastbuf_), sizeof(int), bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *)&(inbuf_), sizeof(int), bufpos_, &bufpos_);
     psio_->read(itap_, IWL_KEY_BUF, (char *)labels_, ints_per_buf_ * 4 * sizeof(Label), bufpos_, &bufpos_);
@@ -45,6 +51,10 @@ void IWL::fetch() {
     idx_ = 0;
 }
 
+void IWL::set_block_filter(std::function<bool(const IWLBlockInfo &)> want) {
+    if (blocks_) blocks_->set_filter(want);
+}
+
 /*!
 ** iwl_buf_fetch()
 **
@@ -53,6 +63,11 @@ void IWL::fetch() {
 ** \ingroup IWL
 */
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf) {
+    if (Buf->blocks) {
+        Buf->inbuf = Buf->blocks->fetch(Buf->labels, Buf->values, Buf->lastbuf);
+        Buf->idx = 0;
+        return;
+    }
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->lastbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)&(Buf->inbuf), sizeof(int), Buf->bufpos, &Buf->bufpos);
     psio_read(Buf->itap, IWL_KEY_BUF, (char *)Buf->labels, Buf->ints_per_buf * 4 * sizeof(Label), Buf->bufpos,
@@ -35,6 +35,7 @@
 #include "psi4/libpsio/psio.h"
 #include "iwl.h"
 #include "iwl.hpp"
+#include "blocks.h"
 #include "psi4/psi4-dec.h"  //need outfile
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
@@ -79,7 +80,11 @@ void IWL::init(PSIO *psio, int it, double coff, int oldfile, int readflag) {
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
     psio_->open(itap_, oldfile ? PSIO_OPEN_OLD : PSIO_OPEN_NEW);
-    if (oldfile && (psio_->tocscan(itap_, IWL_KEY_BUF) == nullptr)) {
+    blocks_.reset();
+    if (oldfile && IWLBlockReader::present(psio_, itap_)) {
+        /*! blocked files are decoded into IWL buffers on fetch */
+        blocks_ = std::make_shared<IWLBlockReader>(psio_, itap_);
+    } else if (oldfile && (psio_->tocscan(itap_, IWL_KEY_BUF) == nullptr)) {
         outfile->Printf("iwl_buf_init: Can't open file %d\n", itap_);
         psio_->close(itap_, 0);
         return;
@@ -125,7 +130,10 @@ void PSI_API iwl_buf_init(struct iwlbuf *Buf, int itape, double cutoff, int oldf
     /*! open the output file */
     /*! Note that we assume that if oldfile isn't set, we O_CREAT the file */
     psio_open(Buf->itap, oldfile ? PSIO_OPEN_OLD : PSIO_OPEN_NEW);
-    if (oldfile && (psio_tocscan(Buf->itap, IWL_KEY_BUF) == nullptr)) {
+    Buf->blocks = nullptr;
+    if (oldfile && IWLBlockReader::present(_default_psio_lib_.get(), Buf->itap)) {
+        Buf->blocks = new IWLBlockReader(_default_psio_lib_.get(), Buf->itap);
+    } else if (oldfile && (psio_tocscan(Buf->itap, IWL_KEY_BUF) == nullptr)) {
         outfile->Printf("iwl_buf_init: Can't open file %d\n", Buf->itap);
         psio_close(Buf->itap, 0);
         return;
@@ -38,6 +38,12 @@ typedef double Value;
 #define IWL_KEY_ONEL "IWL One-electron matrix elements"
 
 #define IWL_INTS_PER_BUF 2980
+
+/* Blocked IWL files, see IWLBlockWriter; blocks fit an IWL buffer */
+#define IWL_KEY_BLOCKS "IWL Block Index"
+#define IWL_KEY_BLOCK_DATA "IWL Block Data"
+#define IWL_INTS_PER_BLOCK IWL_INTS_PER_BUF
+#define IWL_BLOCK_SLICES 16
 }
 
 #endif
@@ -44,6 +44,8 @@
 #include "psi4/psi4-dec.h"
 namespace psi {
 
+class IWLBlockReader;
+
 struct iwlbuf {
     int itap;            /* tape number for input file */
     psio_address bufpos; /* current page/offset */
@@ -55,6 +57,7 @@ struct iwlbuf {
     int idx;             /* index of integral in current buffer */
     Label *labels;       /* pointer to where integral values begin */
     Value *values;       /* integral values */
+    IWLBlockReader *blocks; /* decoder of a blocked IWL file, or null */
 };
 
 void PSI_API iwl_buf_fetch(struct iwlbuf *Buf);
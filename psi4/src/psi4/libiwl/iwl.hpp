@@ -30,11 +30,17 @@
 #define _psi_src_lib_libiwl_iwl_hpp_
 
 #include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include "psi4/libpsio/psio.hpp"
 #include "config.h"
 
 namespace psi {
 
+class IWLBlockReader;
+struct IWLBlockInfo;
+
 class PSI_API IWL {
     int itap_;            /* tape number for input file */
     psio_address bufpos_; /* current page/offset */
@@ -50,6 +56,8 @@ class PSI_API IWL {
     PSIO *psio_;
     /*! Flag indicating whether to keep the IWL file or not */
     bool keep_;
+    /*! Decoder of a blocked IWL file (see IWLBlockWriter), null for plain buffers */
+    std::shared_ptr<IWLBlockReader> blocks_;
 
    public:
     IWL();
@@ -72,6 +80,10 @@ class PSI_API IWL {
     void init(PSIO *psio, int itap, double cutoff, int oldfile, int readflag);
 
     void set_keep_flag(bool k) { keep_ = k; }
+    /// Is the file read a blocked IWL file?
+    bool blocked() const { return blocks_ != nullptr; }
+    /// On a blocked file, only fetch blocks for which want(block) is true; set before the first fetch()
+    void set_block_filter(std::function<bool(const IWLBlockInfo &)> want);
     void close();
 
     void fetch();
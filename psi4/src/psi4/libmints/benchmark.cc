@@ -30,6 +30,13 @@
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/3coverlap.h"
+#include "psi4/libmints/eri.h"
+#include "psi4/libmints/erd_eri.h"
+#include "psi4/libmints/hybrideri.h"
+#include "psi4/libmints/fjt.h"
+#ifdef USING_simint
+#include "psi4/libmints/siminteri.h"
+#endif
 
 #include "psi4/libqt/qt.h"
 #include "psi4/libciomr/libciomr.h"
@@ -38,8 +45,11 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
 
+#include <functional>
 #include <map>
+#include <sstream>
 #include <string>
 #include <cmath>
 #include <cstdlib>
@@ -2558,4 +2568,187 @@ void benchmark_integrals(int max_am, double min_time) {
     }
 }
 
+namespace {
+
+// Seconds per call of f, repeated until min_time has elapsed
+double time_calls(const std::function<void()>& f, double min_time) {
+    f();  // warm the caches
+    size_t rounds = 0L;
+    double T = 0.0;
+    Timer qq;
+    while (T < min_time) {
+        f();
+        T = qq.get();
+        rounds++;
+    }
+    return T / (double)rounds;
+}
+
+void json_timings(std::ostringstream& json, const std::vector<std::string>& combinations,
+                  const std::vector<double>& timings) {
+    json << "{";
+    for (size_t index = 0; index < combinations.size(); index++) {
+        json << (index ? ", " : "") << "\"" << combinations[index] << "\": " << timings[index];
+    }
+    json << "}";
+}
+
+}  // namespace
+
+std::string benchmark_integrals_json(std::shared_ptr<BasisSet> basis, int max_am, double min_time) {
+    std::shared_ptr<BasisSet> zero = BasisSet::zero_ao_basis_set();
+    std::shared_ptr<Molecule> mol = basis->molecule();
+    int nam = std::min(max_am, basis->max_am()) + 1;
+
+    // First shell of each am on up to four distinct centers (-1 if absent)
+    std::vector<std::vector<int> > shells(4, std::vector<int>(nam, -1));
+    for (int c = 0; c < 4; c++) {
+        int A = c % mol->natom();
+        for (int n = basis->nshell_on_center(A) - 1; n >= 0; n--) {
+            int P = basis->shell_on_center(A, n);
+            int l = basis->shell(P).am();
+            if (l < nam) shells[c][l] = P;
+        }
+    }
+
+    auto bbbb = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    auto b0bb = std::make_shared<IntegralFactory>(basis, zero, basis, basis);
+
+    // Every compiled-in backend, under its INTEGRAL_PACKAGE name
+    std::vector<std::pair<std::string, std::function<TwoBodyAOInt*(const IntegralFactory*, int)> > > backends;
+    backends.emplace_back("LIBINT", [](const IntegralFactory* f, int d) -> TwoBodyAOInt* { return new ERI(f, d); });
+#ifdef USING_simint
+    backends.emplace_back("SIMINT",
+                          [](const IntegralFactory* f, int d) -> TwoBodyAOInt* { return new SimintERI(f, d); });
+#endif
+#ifdef USING_erd
+    backends.emplace_back("ERD", [](const IntegralFactory* f, int d) -> TwoBodyAOInt* { return new ERDERI(f, d); });
+#endif
+    backends.emplace_back("HYBRID",
+                          [](const IntegralFactory* f, int d) -> TwoBodyAOInt* { return new HybridERI(f, d); });
+
+    std::vector<std::string> combinations3;
+    std::vector<std::vector<int> > triplets;
+    std::vector<int> n3;
+    for (int P = 0; P < nam; P++) {
+        for (int Q = 0; Q < nam; Q++) {
+            for (int R = 0; R < nam; R++) {
+                int sP = shells[0][P], sQ = shells[1][Q], sR = shells[2][R];
+                if (sP < 0 || sQ < 0 || sR < 0) continue;
+                combinations3.push_back(std::string("(") + basis->shell(sP).amchar() + "|" +
+                                        basis->shell(sQ).amchar() + basis->shell(sR).amchar() + ")");
+                triplets.push_back({sP, sQ, sR});
+                n3.push_back(basis->shell(sP).nfunction() * basis->shell(sQ).nfunction() *
+                             basis->shell(sR).nfunction());
+            }
+        }
+    }
+    std::vector<std::string> combinations4;
+    std::vector<std::vector<int> > quartets;
+    std::vector<int> n4;
+    for (int P = 0; P < nam; P++) {
+        for (int Q = 0; Q < nam; Q++) {
+            for (int R = 0; R < nam; R++) {
+                for (int S = 0; S < nam; S++) {
+                    int sP = shells[0][P], sQ = shells[1][Q], sR = shells[2][R], sS = shells[3][S];
+                    if (sP < 0 || sQ < 0 || sR < 0 || sS < 0) continue;
+                    combinations4.push_back(std::string("(") + basis->shell(sP).amchar() +
+                                            basis->shell(sQ).amchar() + "|" + basis->shell(sR).amchar() +
+                                            basis->shell(sS).amchar() + ")");
+                    quartets.push_back({sP, sQ, sR, sS});
+                    n4.push_back(basis->shell(sP).nfunction() * basis->shell(sQ).nfunction() *
+                                 basis->shell(sR).nfunction() * basis->shell(sS).nfunction());
+                }
+            }
+        }
+    }
+
+    // All timings are seconds per integral (or per Fm(T) value for the Boys function)
+    std::ostringstream json;
+    json.precision(6);
+    json << std::scientific;
+    json << "{\"basis\": \"" << basis->name() << "\", \"max_am\": " << nam - 1 << ", \"min_time\": " << min_time;
+
+    // 4C ERI, each backend and derivative level it supports
+    for (int deriv = 0; deriv <= 1; deriv++) {
+        json << ", \"" << (deriv ? "4C ERI deriv1" : "4C ERI") << "\": {";
+        bool first_backend = true;
+        for (const auto& backend : backends) {
+            std::vector<double> timings;
+            try {
+                std::shared_ptr<TwoBodyAOInt> eri(backend.second(bbbb.get(), deriv));
+                for (size_t index = 0; index < quartets.size(); index++) {
+                    const std::vector<int>& q = quartets[index];
+                    double t = time_calls(
+                        [&]() {
+                            if (deriv)
+                                eri->compute_shell_deriv1(q[0], q[1], q[2], q[3]);
+                            else
+                                eri->compute_shell(q[0], q[1], q[2], q[3]);
+                        },
+                        min_time);
+                    timings.push_back(t / (double)((deriv ? 12 : 1) * n4[index]));
+                }
+            } catch (const PsiException&) {
+                continue;  // e.g. no derivatives from this backend, or AM beyond its build
+            }
+            json << (first_backend ? "" : ", ") << "\"" << backend.first << "\": ";
+            json_timings(json, combinations4, timings);
+            first_backend = false;
+        }
+        json << "}";
+    }
+
+    // 3C ERI (the density-fitting case)
+    json << ", \"3C ERI\": {";
+    bool first_backend = true;
+    for (const auto& backend : backends) {
+        std::shared_ptr<TwoBodyAOInt> eri;
+        try {
+            eri = std::shared_ptr<TwoBodyAOInt>(backend.second(b0bb.get(), 0));
+        } catch (const PsiException&) {
+            continue;
+        }
+        std::vector<double> timings;
+        for (size_t index = 0; index < triplets.size(); index++) {
+            const std::vector<int>& q = triplets[index];
+            double t = time_calls([&]() { eri->compute_shell(q[0], 0, q[1], q[2]); }, min_time);
+            timings.push_back(t / (double)n3[index]);
+        }
+        json << (first_backend ? "" : ", ") << "\"" << backend.first << "\": ";
+        json_timings(json, combinations3, timings);
+        first_backend = false;
+    }
+    json << "}";
+
+    // Boys function, one value at a time and batched, over the range of T seen in ERIs
+    const size_t nT = 1024;
+    const int Jmax = 4 * (nam - 1) + 1;
+    std::vector<double> Ts(nT);
+    std::vector<double> F(nT * (Jmax + 1));
+    for (size_t k = 0; k < nT; k++) Ts[k] = 40.0 * (double)k / (double)nT;
+    Taylor_Fjt fjt(Jmax, 1.0E-15);
+    std::vector<std::string> Jnames;
+    std::vector<double> scalar, batched;
+    for (int J = 0; J <= Jmax; J++) {
+        Jnames.push_back(std::to_string(J));
+        scalar.push_back(time_calls(
+                             [&]() {
+                                 for (size_t k = 0; k < nT; k++) fjt.values(J, Ts[k]);
+                             },
+                             min_time) /
+                         (double)(nT * (J + 1)));
+        batched.push_back(time_calls([&]() { fjt.values(J, Ts.data(), nT, F.data()); }, min_time) /
+                          (double)(nT * (J + 1)));
+    }
+    json << ", \"Fjt\": {\"scalar\": ";
+    json_timings(json, Jnames, scalar);
+    json << ", \"batched\": ";
+    json_timings(json, Jnames, batched);
+    json << "}";
+
+    json << "}";
+    return json.str();
+}
+
 }  // namespace psi
@@ -29,8 +29,13 @@
 #ifndef _psi_src_lib_libmints_bench_h
 #define _psi_src_lib_libmints_bench_h
 
+#include <memory>
+#include <string>
+
 namespace psi {
 
+class BasisSet;
+
 /**
  * Perform a benchmark traverse of BLAS 1 routines on
  * the current hardware
@@ -75,6 +80,17 @@ void benchmark_disk(int N, double min_time);
  * each integral type
  **/
 void benchmark_integrals(int max_am, double min_time);
+/**
+ * Time the 4C ERIs (energy and first derivative), 3C ERIs and
+ * the Boys function for every compiled-in integral backend,
+ * using the first shell of each am on up to four centers of basis
+ * \param basis basis set to draw the shells from
+ * \param max_am maximum am to consider
+ * \param min_time minimum time to run each shell combination [s]
+ * \return JSON object of seconds per integral, keyed by integral
+ * type, backend and shell combination
+ **/
+std::string benchmark_integrals_json(std::shared_ptr<BasisSet> basis, int max_am, double min_time);
 /**
  * Perform a benchmark of common double floating
  * point operations, including most of cmath
@@ -0,0 +1,295 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/blocksparse.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+namespace psi {
+
+BlockSparseMatrix::BlockSparseMatrix(std::shared_ptr<BasisSet> rows, std::shared_ptr<BasisSet> cols)
+    : rows_(rows), cols_(cols) {
+    for (int P = 0; P < rows_->nshell(); P++) {
+        row_size_.push_back(rows_->shell(P).nfunction());
+        row_off_.push_back(rows_->shell(P).function_index());
+    }
+    for (int Q = 0; Q < cols_->nshell(); Q++) {
+        col_size_.push_back(cols_->shell(Q).nfunction());
+        col_off_.push_back(cols_->shell(Q).function_index());
+    }
+    offsets_.assign(row_size_.size() + 1, 0);
+}
+
+void BlockSparseMatrix::clear_rows() {
+    offsets_.assign(1, 0);
+    col_shell_.clear();
+    norms_.clear();
+    data_start_.clear();
+    data_.clear();
+}
+
+BlockSparseMatrix::Row BlockSparseMatrix::compress_row(int P, const double* stripe, const std::vector<char>& keep,
+                                                       double threshold) const {
+    Row row;
+    int nP = row_size_[P];
+    int ncol = cols_->nbf();
+    for (int Q = 0; Q < nshell_col(); Q++) {
+        if (!keep[Q]) continue;
+        int nQ = col_size_[Q];
+        double norm2 = 0.0;
+        for (int p = 0; p < nP; p++) {
+            const double* src = stripe + (size_t)p * ncol + col_off_[Q];
+            for (int q = 0; q < nQ; q++) norm2 += src[q] * src[q];
+        }
+        double norm = std::sqrt(norm2);
+        if (norm <= threshold) continue;
+        row.shells.push_back(Q);
+        row.norms.push_back(norm);
+        for (int p = 0; p < nP; p++) {
+            const double* src = stripe + (size_t)p * ncol + col_off_[Q];
+            row.data.insert(row.data.end(), src, src + nQ);
+        }
+    }
+    return row;
+}
+
+void BlockSparseMatrix::append_row(const Row& row) {
+    int P = (int)offsets_.size() - 1;
+    size_t start = data_.size();
+    for (size_t b = 0; b < row.shells.size(); b++) {
+        col_shell_.push_back(row.shells[b]);
+        norms_.push_back(row.norms[b]);
+        data_start_.push_back(start);
+        start += (size_t)row_size_[P] * col_size_[row.shells[b]];
+    }
+    data_.insert(data_.end(), row.data.begin(), row.data.end());
+    offsets_.push_back(col_shell_.size());
+}
+
+std::shared_ptr<BlockSparseMatrix> BlockSparseMatrix::from_matrix(const SharedMatrix& M,
+                                                                  std::shared_ptr<BasisSet> rows,
+                                                                  std::shared_ptr<BasisSet> cols, double threshold) {
+    if (M->nirrep() != 1) throw PSIEXCEPTION("BlockSparseMatrix::from_matrix: matrix must be C1.");
+    if (M->rowdim() != rows->nbf() || M->coldim() != cols->nbf())
+        throw PSIEXCEPTION("BlockSparseMatrix::from_matrix: matrix does not match the basis sets.");
+
+    auto S = std::make_shared<BlockSparseMatrix>(rows, cols);
+    S->clear_rows();
+    double** Mp = M->pointer();
+    std::vector<char> keep(S->nshell_col(), 1);
+    for (int P = 0; P < S->nshell_row(); P++) {
+        S->append_row(S->compress_row(P, Mp[S->row_off_[P]], keep, threshold));
+    }
+    return S;
+}
+
+SharedMatrix BlockSparseMatrix::to_matrix(const std::string& name) const {
+    auto M = std::make_shared<Matrix>(name, rows_->nbf(), cols_->nbf());
+    add_to(M, 1.0);
+    return M;
+}
+
+void BlockSparseMatrix::add_to(const SharedMatrix& M, double alpha) const {
+    double** Mp = M->pointer();
+    for (int P = 0; P < nshell_row(); P++) {
+        for (size_t b = offsets_[P]; b < offsets_[P + 1]; b++) {
+            int Q = col_shell_[b];
+            const double* src = data(b);
+            for (int p = 0; p < row_size_[P]; p++) {
+                C_DAXPY(col_size_[Q], alpha, const_cast<double*>(src) + (size_t)p * col_size_[Q], 1,
+                        &Mp[row_off_[P] + p][col_off_[Q]], 1);
+            }
+        }
+    }
+}
+
+std::shared_ptr<BlockSparseMatrix> BlockSparseMatrix::multiply(const BlockSparseMatrix& A,
+                                                               const BlockSparseMatrix& B, double threshold) {
+    if (A.nshell_col() != B.nshell_row() || A.cols_->nbf() != B.rows_->nbf())
+        throw PSIEXCEPTION("BlockSparseMatrix::multiply: inner dimensions do not match.");
+
+    auto C = std::make_shared<BlockSparseMatrix>(A.rows_, B.cols_);
+    int nrow = A.nshell_row();
+    int ncol = B.cols_->nbf();
+    std::vector<Row> rows(nrow);
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = omp_get_max_threads();
+#endif
+    std::vector<std::vector<double> > stripes(nthread);
+    std::vector<std::vector<char> > keeps(nthread);
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+    for (int P = 0; P < nrow; P++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int nP = A.row_size_[P];
+        std::vector<double>& stripe = stripes[thread];
+        std::vector<char>& keep = keeps[thread];
+        stripe.assign((size_t)nP * ncol, 0.0);
+        keep.assign(B.nshell_col(), 0);
+
+        // C_PQ = sum_R A_PR B_RQ, over the stored blocks of row P of A and row R of B
+        for (size_t a = A.offsets_[P]; a < A.offsets_[P + 1]; a++) {
+            int R = A.col_shell_[a];
+            int nR = A.col_size_[R];
+            for (size_t b = B.offsets_[R]; b < B.offsets_[R + 1]; b++) {
+                if (A.norms_[a] * B.norms_[b] <= threshold) continue;
+                int Q = B.col_shell_[b];
+                int nQ = B.col_size_[Q];
+                C_DGEMM('N', 'N', nP, nQ, nR, 1.0, const_cast<double*>(A.data(a)), nR, const_cast<double*>(B.data(b)),
+                        nQ, 1.0, stripe.data() + B.col_off_[Q], ncol);
+                keep[Q] = 1;
+            }
+        }
+        rows[P] = C->compress_row(P, stripe.data(), keep, threshold);
+    }
+
+    C->clear_rows();
+    for (int P = 0; P < nrow; P++) C->append_row(rows[P]);
+    return C;
+}
+
+std::shared_ptr<BlockSparseMatrix> BlockSparseMatrix::add(double alpha, const BlockSparseMatrix& A, double beta,
+                                                          const BlockSparseMatrix& B, double threshold) {
+    if (A.nshell_row() != B.nshell_row() || A.nshell_col() != B.nshell_col())
+        throw PSIEXCEPTION("BlockSparseMatrix::add: dimensions do not match.");
+
+    auto C = std::make_shared<BlockSparseMatrix>(A.rows_, A.cols_);
+    C->clear_rows();
+    int ncol = A.cols_->nbf();
+    std::vector<double> stripe;
+    std::vector<char> keep(A.nshell_col());
+    for (int P = 0; P < A.nshell_row(); P++) {
+        int nP = A.row_size_[P];
+        stripe.assign((size_t)nP * ncol, 0.0);
+        std::fill(keep.begin(), keep.end(), 0);
+        const BlockSparseMatrix* terms[] = {&A, &B};
+        const double factors[] = {alpha, beta};
+        for (int t = 0; t < 2; t++) {
+            const BlockSparseMatrix& X = *terms[t];
+            for (size_t b = X.offsets_[P]; b < X.offsets_[P + 1]; b++) {
+                int Q = X.col_shell_[b];
+                int nQ = X.col_size_[Q];
+                const double* src = X.data(b);
+                for (int p = 0; p < nP; p++) {
+                    C_DAXPY(nQ, factors[t], const_cast<double*>(src) + (size_t)p * nQ, 1,
+                            stripe.data() + (size_t)p * ncol + X.col_off_[Q], 1);
+                }
+                keep[Q] = 1;
+            }
+        }
+        C->append_row(C->compress_row(P, stripe.data(), keep, threshold));
+    }
+    return C;
+}
+
+void BlockSparseMatrix::scale(double alpha) {
+    if (data_.empty()) return;
+    C_DSCAL(data_.size(), alpha, data_.data(), 1);
+    for (double& norm : norms_) norm *= std::fabs(alpha);
+}
+
+long int BlockSparseMatrix::find(int P, int Q) const {
+    auto first = col_shell_.begin() + offsets_[P];
+    auto last = col_shell_.begin() + offsets_[P + 1];
+    auto it = std::lower_bound(first, last, Q);
+    if (it == last || *it != Q) return -1;
+    return (long int)(it - col_shell_.begin());
+}
+
+double BlockSparseMatrix::vector_dot(const BlockSparseMatrix& B) const {
+    double dot = 0.0;
+    for (int P = 0; P < nshell_row(); P++) {
+        for (size_t b = offsets_[P]; b < offsets_[P + 1]; b++) {
+            long int other = B.find(P, col_shell_[b]);
+            if (other < 0) continue;
+            size_t size = (size_t)row_size_[P] * col_size_[col_shell_[b]];
+            dot += C_DDOT(size, const_cast<double*>(data(b)), 1, const_cast<double*>(B.data(other)), 1);
+        }
+    }
+    return dot;
+}
+
+double BlockSparseMatrix::vector_dot(const SharedMatrix& M) const {
+    double** Mp = M->pointer();
+    double dot = 0.0;
+    for (int P = 0; P < nshell_row(); P++) {
+        for (size_t b = offsets_[P]; b < offsets_[P + 1]; b++) {
+            int Q = col_shell_[b];
+            const double* src = data(b);
+            for (int p = 0; p < row_size_[P]; p++) {
+                dot += C_DDOT(col_size_[Q], const_cast<double*>(src) + (size_t)p * col_size_[Q], 1,
+                              &Mp[row_off_[P] + p][col_off_[Q]], 1);
+            }
+        }
+    }
+    return dot;
+}
+
+double BlockSparseMatrix::fill() const {
+    double total = (double)nshell_row() * nshell_col();
+    return (total > 0.0 ? nblocks() / total : 0.0);
+}
+
+std::vector<double> BlockSparseMatrix::shell_max() const {
+    std::vector<double> smax((size_t)nshell_row() * nshell_col(), 0.0);
+    for (int P = 0; P < nshell_row(); P++) {
+        for (size_t b = offsets_[P]; b < offsets_[P + 1]; b++) {
+            int Q = col_shell_[b];
+            size_t size = (size_t)row_size_[P] * col_size_[Q];
+            const double* src = data(b);
+            double max_val = 0.0;
+            for (size_t i = 0; i < size; i++) max_val = std::max(max_val, std::fabs(src[i]));
+            smax[P * (size_t)nshell_col() + Q] = max_val;
+        }
+    }
+    return smax;
+}
+
+void BlockSparseMatrix::print_summary(const std::string& label) const {
+    outfile->Printf("  ==> Block-Sparse Matrix%s%s <==\n\n", label.empty() ? "" : ": ", label.c_str());
+    outfile->Printf("    Shells        = %d x %d\n", nshell_row(), nshell_col());
+    outfile->Printf("    Stored blocks = %zu (%.1f%%)\n", nblocks(), 100.0 * fill());
+    outfile->Printf("    Memory        = %.1f MiB\n\n", 8.0 * data_.size() / (1024.0 * 1024.0));
+}
+
+}  // namespace psi
@@ -0,0 +1,144 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef BLOCKSPARSE_H
+#define BLOCKSPARSE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class BasisSet;
+class Matrix;
+using SharedMatrix = std::shared_ptr<Matrix>;
+
+/**
+ * BlockSparseMatrix
+ *
+ * AO-basis matrix stored by shell blocks in compressed sparse row form, for
+ * D, F, J, K or S of spatially extended systems where most shell blocks are
+ * negligible. The stored blocks of shell row P are (P, Q) for Q in
+ * col_shells(P) ... col_shells(P + 1), ascending; each is a dense,
+ * row-major nfunction(P) x nfunction(Q) tile with its Frobenius norm kept
+ * alongside. multiply() and add() use the norms to skip block products and
+ * to drop result blocks at or below a threshold.
+ *
+ * Like the AO quantities JK works on, this is C1 only; from_matrix() and
+ * to_matrix() convert to and from a one-irrep Matrix.
+ */
+class PSI_API BlockSparseMatrix {
+   public:
+    /// Empty (all blocks absent) matrix with shells of rows x shells of cols
+    BlockSparseMatrix(std::shared_ptr<BasisSet> rows, std::shared_ptr<BasisSet> cols);
+
+    /// Blocks of the C1 matrix M whose Frobenius norm exceeds threshold
+    static std::shared_ptr<BlockSparseMatrix> from_matrix(const SharedMatrix& M, std::shared_ptr<BasisSet> rows,
+                                                          std::shared_ptr<BasisSet> cols, double threshold = 0.0);
+    /// Dense copy, absent blocks zero
+    SharedMatrix to_matrix(const std::string& name = "") const;
+    /// M += alpha * this
+    void add_to(const SharedMatrix& M, double alpha = 1.0) const;
+
+    /** A B, skipping block products with norm(A_PR) norm(B_RQ) <= threshold and dropping result
+     *  blocks with norm <= threshold. Rows are threaded with OpenMP.
+     */
+    static std::shared_ptr<BlockSparseMatrix> multiply(const BlockSparseMatrix& A, const BlockSparseMatrix& B,
+                                                       double threshold = 0.0);
+    /// alpha A + beta B over the union of their blocks, dropping blocks with norm <= threshold
+    static std::shared_ptr<BlockSparseMatrix> add(double alpha, const BlockSparseMatrix& A, double beta,
+                                                  const BlockSparseMatrix& B, double threshold = 0.0);
+
+    void scale(double alpha);
+    /// sum_ij this_ij B_ij
+    double vector_dot(const BlockSparseMatrix& B) const;
+    /// sum_ij this_ij M_ij, M a C1 matrix
+    double vector_dot(const SharedMatrix& M) const;
+
+    int nshell_row() const { return (int)row_size_.size(); }
+    int nshell_col() const { return (int)col_size_.size(); }
+    /// Number of stored blocks
+    size_t nblocks() const { return col_shell_.size(); }
+    /// Fraction of shell blocks stored
+    double fill() const;
+    /// First stored block of shell row P; blocks of row P are [row_begin(P), row_begin(P + 1))
+    size_t row_begin(int P) const { return offsets_[P]; }
+    /// Column shell, Frobenius norm and data of stored block b
+    int col_shell(size_t b) const { return col_shell_[b]; }
+    double norm(size_t b) const { return norms_[b]; }
+    const double* data(size_t b) const { return data_.data() + data_start_[b]; }
+    /// Stored block index of (P, Q), or -1 if absent
+    long int find(int P, int Q) const;
+
+    /// Largest |element| per shell block, nshell_row x nshell_col row-major, 0 for absent blocks
+    std::vector<double> shell_max() const;
+
+    void print_summary(const std::string& label = "") const;
+
+   private:
+    std::shared_ptr<BasisSet> rows_;
+    std::shared_ptr<BasisSet> cols_;
+
+    /// Functions per shell and offsets of the shells in the dense matrix
+    std::vector<int> row_size_;
+    std::vector<int> row_off_;
+    std::vector<int> col_size_;
+    std::vector<int> col_off_;
+
+    /// Row starts, nshell_row + 1 entries
+    std::vector<size_t> offsets_;
+    /// Column shell of each stored block
+    std::vector<int> col_shell_;
+    /// Frobenius norm of each stored block
+    std::vector<double> norms_;
+    /// Start of each stored block in data_
+    std::vector<size_t> data_start_;
+    std::vector<double> data_;
+
+    /// Stored blocks of one shell row, in ascending column shell order
+    struct Row {
+        std::vector<int> shells;
+        std::vector<double> norms;
+        std::vector<double> data;
+    };
+    /** Compress the dense stripe of shell row P (row_size_[P] x ncol functions, ld = ncol), keeping the
+     *  column shells flagged in keep whose norm exceeds threshold
+     */
+    Row compress_row(int P, const double* stripe, const std::vector<char>& keep, double threshold) const;
+    /// Drop all rows ahead of a rebuild by append_row()
+    void clear_rows();
+    /// Append the next shell row; rows must be appended in order, from 0 after clear_rows()
+    void append_row(const Row& row);
+};
+
+}  // namespace psi
+
+#endif
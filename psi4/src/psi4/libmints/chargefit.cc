@@ -0,0 +1,256 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/chargefit.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libmints/vector3.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/physconst.h"
+#include "psi4/psi4-dec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace psi {
+
+namespace {
+
+// Bondi, J. Phys. Chem. 68, 441 (1964), in Angstrom, with Mantina et al., J. Phys. Chem. A 113,
+// 5806 (2009) for B and Al; zero where neither gives a value
+const double vdw_radii[] = {
+    0.00,                                                                                    // Ghost
+    1.20, 1.40,                                                                              // H-He
+    1.82, 0.00, 1.92, 1.70, 1.55, 1.52, 1.47, 1.54,                                          // Li-Ne
+    2.27, 1.73, 1.84, 2.10, 1.80, 1.80, 1.75, 1.88,                                          // Na-Ar
+    2.75, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 1.63, 1.40, 1.39,                  // K-Zn
+    1.87, 0.00, 1.85, 1.90, 1.85, 2.02,                                                      // Ga-Kr
+    0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 0.00, 1.63, 1.72, 1.58,                  // Rb-Cd
+    1.93, 2.17, 0.00, 2.06, 1.98, 2.16};                                                     // In-Xe
+const int n_vdw_radii = sizeof(vdw_radii) / sizeof(double);
+
+}  // namespace
+
+ChargeFit::ChargeFit(std::shared_ptr<Molecule> mol) : mol_(mol) {
+    for (int a = 0; a < mol_->natom(); ++a) {
+        if (mol_->Z(a) == 0.0) continue;
+        int Z = mol_->true_atomic_number(a);
+        centers_.push_back(a);
+        radius_.push_back(vdw_radius(Z));
+        heavy_.push_back(Z > 1);
+    }
+    if (centers_.empty()) throw PSIEXCEPTION("ChargeFit: the molecule has no real atoms.");
+}
+
+ChargeFit::~ChargeFit() {}
+
+double ChargeFit::vdw_radius(int Z) {
+    double r = (Z > 0 && Z < n_vdw_radii) ? vdw_radii[Z] : 0.0;
+    if (r == 0.0) r = 2.0;
+    return r / pc_bohr2angstroms;
+}
+
+bool ChargeFit::inside(const double* p, double scale) const {
+    for (size_t c = 0; c < centers_.size(); ++c) {
+        Vector3 A = mol_->xyz(centers_[c]);
+        double dx = p[0] - A[0], dy = p[1] - A[1], dz = p[2] - A[2];
+        double r = scale * radius_[c];
+        // Points exactly on a neighbor's sphere count as outside it
+        if (dx * dx + dy * dy + dz * dz < r * r * (1.0 - 1.0E-10)) return true;
+    }
+    return false;
+}
+
+SharedMatrix ChargeFit::chelpg_grid(double spacing, double max_distance) const {
+    spacing /= pc_bohr2angstroms;
+    max_distance /= pc_bohr2angstroms;
+    if (spacing <= 0.0) throw PSIEXCEPTION("ChargeFit: the CHELPG spacing must be positive.");
+
+    double lo[3], hi[3];
+    for (int x = 0; x < 3; ++x) {
+        lo[x] = std::numeric_limits<double>::max();
+        hi[x] = std::numeric_limits<double>::lowest();
+    }
+    for (int a : centers_) {
+        Vector3 A = mol_->xyz(a);
+        for (int x = 0; x < 3; ++x) {
+            lo[x] = std::min(lo[x], A[x] - max_distance);
+            hi[x] = std::max(hi[x], A[x] + max_distance);
+        }
+    }
+    // Center the lattice on the box so the grid does not depend on which corner it starts from
+    int n[3];
+    double start[3];
+    for (int x = 0; x < 3; ++x) {
+        n[x] = (int)std::floor((hi[x] - lo[x]) / spacing) + 1;
+        start[x] = 0.5 * (lo[x] + hi[x]) - 0.5 * (n[x] - 1) * spacing;
+    }
+
+    double max2 = max_distance * max_distance;
+    std::vector<double> points;
+    for (int i = 0; i < n[0]; ++i) {
+        for (int j = 0; j < n[1]; ++j) {
+            for (int k = 0; k < n[2]; ++k) {
+                double p[3] = {start[0] + i * spacing, start[1] + j * spacing, start[2] + k * spacing};
+                if (inside(p, 1.0)) continue;
+                bool near = false;
+                for (int a : centers_) {
+                    Vector3 A = mol_->xyz(a);
+                    double dx = p[0] - A[0], dy = p[1] - A[1], dz = p[2] - A[2];
+                    if (dx * dx + dy * dy + dz * dz <= max2) {
+                        near = true;
+                        break;
+                    }
+                }
+                if (near) points.insert(points.end(), p, p + 3);
+            }
+        }
+    }
+
+    int npoints = points.size() / 3;
+    auto grid = std::make_shared<Matrix>("CHELPG Grid", npoints, 3);
+    if (npoints) std::copy(points.begin(), points.end(), grid->pointer()[0]);
+    return grid;
+}
+
+SharedMatrix ChargeFit::mk_grid(double density) const {
+    if (density <= 0.0) throw PSIEXCEPTION("ChargeFit: the Merz-Kollman point density must be positive.");
+    const double scales[] = {1.4, 1.6, 1.8, 2.0};
+    const double golden = M_PI * (3.0 - std::sqrt(5.0));
+
+    std::vector<double> points;
+    for (double scale : scales) {
+        for (size_t c = 0; c < centers_.size(); ++c) {
+            Vector3 A = mol_->xyz(centers_[c]);
+            double r = scale * radius_[c];
+            double r_ang = r * pc_bohr2angstroms;
+            int nsphere = std::max(1, (int)(4.0 * M_PI * r_ang * r_ang * density));
+            // Fibonacci sphere: near-uniform coverage for any point count
+            for (int k = 0; k < nsphere; ++k) {
+                double z = 1.0 - (2.0 * k + 1.0) / nsphere;
+                double rho = std::sqrt(std::max(0.0, 1.0 - z * z));
+                double phi = golden * k;
+                double p[3] = {A[0] + r * rho * std::cos(phi), A[1] + r * rho * std::sin(phi), A[2] + r * z};
+                if (!inside(p, scale)) points.insert(points.end(), p, p + 3);
+            }
+        }
+    }
+
+    int npoints = points.size() / 3;
+    auto grid = std::make_shared<Matrix>("MK Grid", npoints, 3);
+    if (npoints) std::copy(points.begin(), points.end(), grid->pointer()[0]);
+    return grid;
+}
+
+SharedVector ChargeFit::fit(SharedMatrix grid, SharedVector esp, double total_charge, double resp_a,
+                            double resp_b) {
+    int npoints = grid->rowdim();
+    if (grid->coldim() != 3 || esp->dimpi()[0] != npoints)
+        throw PSIEXCEPTION("ChargeFit: the grid must be npoints x 3 with one ESP value per point.");
+    int ncenter = centers_.size();
+    if (npoints < ncenter) throw PSIEXCEPTION("ChargeFit: fewer grid points than atoms to fit.");
+
+    // Normal equations A_ab = sum_k 1/(r_ka r_kb), B_a = sum_k V_k / r_ka, bordered by the
+    // total-charge constraint
+    int n = ncenter + 1;
+    std::vector<double> A(n * n, 0.0), B(n, 0.0);
+    std::vector<double> invr(ncenter);
+    double** gp = grid->pointer();
+    double* vp = esp->pointer();
+    for (int k = 0; k < npoints; ++k) {
+        for (int a = 0; a < ncenter; ++a) {
+            Vector3 R = mol_->xyz(centers_[a]);
+            double dx = gp[k][0] - R[0], dy = gp[k][1] - R[1], dz = gp[k][2] - R[2];
+            invr[a] = 1.0 / std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        for (int a = 0; a < ncenter; ++a) {
+            B[a] += vp[k] * invr[a];
+            for (int b = 0; b <= a; ++b) A[a * n + b] += invr[a] * invr[b];
+        }
+    }
+    for (int a = 0; a < ncenter; ++a) {
+        for (int b = 0; b < a; ++b) A[b * n + a] = A[a * n + b];
+        A[a * n + ncenter] = A[ncenter * n + a] = 1.0;
+    }
+    B[ncenter] = total_charge;
+
+    auto solve = [&](const std::vector<double>& restraint, std::vector<double>& q) {
+        std::vector<double> M(A);
+        for (int a = 0; a < ncenter; ++a) M[a * n + a] += restraint[a];
+        q = B;
+        std::vector<int> ipiv(n);
+        int info = C_DGESV(n, 1, M.data(), n, ipiv.data(), q.data(), n);
+        if (info) throw PSIEXCEPTION("ChargeFit: the fitting equations are singular.");
+    };
+
+    std::vector<double> restraint(ncenter, 0.0), q;
+    solve(restraint, q);
+    iterations_ = 0;
+    if (resp_a > 0.0) {
+        const int maxiter = 100;
+        double change = 1.0;
+        while (change > 1.0E-6 && iterations_ < maxiter) {
+            // d/dq a (sqrt(q^2 + b^2) - b) = a q / sqrt(q^2 + b^2), linear in q at fixed denominator
+            for (int a = 0; a < ncenter; ++a)
+                restraint[a] = heavy_[a] ? resp_a / std::sqrt(q[a] * q[a] + resp_b * resp_b) : 0.0;
+            std::vector<double> qnew;
+            solve(restraint, qnew);
+            change = 0.0;
+            for (int a = 0; a < ncenter; ++a) change = std::max(change, std::fabs(qnew[a] - q[a]));
+            q = qnew;
+            iterations_++;
+        }
+        if (change > 1.0E-6)
+            outfile->Printf("  Warning: RESP restraint not converged in %d iterations (change %.2E).\n", maxiter,
+                            change);
+    }
+
+    double err2 = 0.0, v2 = 0.0;
+    for (int k = 0; k < npoints; ++k) {
+        double v = 0.0;
+        for (int a = 0; a < ncenter; ++a) {
+            Vector3 R = mol_->xyz(centers_[a]);
+            double dx = gp[k][0] - R[0], dy = gp[k][1] - R[1], dz = gp[k][2] - R[2];
+            v += q[a] / std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        err2 += (v - vp[k]) * (v - vp[k]);
+        v2 += vp[k] * vp[k];
+    }
+    rms_ = std::sqrt(err2 / npoints);
+    rrms_ = v2 > 0.0 ? std::sqrt(err2 / v2) : 0.0;
+
+    auto charges = std::make_shared<Vector>("Fitted Charges", mol_->natom());
+    for (int a = 0; a < ncenter; ++a) charges->set(centers_[a], q[a]);
+    return charges;
+}
+
+}  // namespace psi
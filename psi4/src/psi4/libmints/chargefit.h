@@ -0,0 +1,102 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_chargefit_h_
+#define _psi_src_lib_libmints_chargefit_h_
+
+#include "psi4/libmints/typedefs.h"
+#include "psi4/pragma.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+class Molecule;
+
+/*! \ingroup MINTS
+ *  \class ChargeFit
+ *  \brief Atomic charges fitted to the electrostatic potential on a grid around the molecule.
+ *
+ * Two fitting grids are built in: CHELPG (Breneman and Wiberg), a cubic grid between the van
+ * der Waals surface and a maximum distance from the nearest atom, and Merz-Kollman, points on
+ * nested spheres of 1.4, 1.6, 1.8 and 2.0 times the van der Waals radius. The charges minimize
+ * the squared ESP error under a total-charge constraint (a Lagrange multiplier), optionally with
+ * the hyperbolic RESP restraint a (sqrt(q^2 + b^2) - b) on non-hydrogen atoms, which is
+ * linearized and iterated to self-consistency. Ghost atoms take no part and get zero charge.
+ */
+class PSI_API ChargeFit {
+   protected:
+    std::shared_ptr<Molecule> mol_;
+    /// Atoms with a nuclear charge, in molecule order
+    std::vector<int> centers_;
+    /// Van der Waals radius (bohr) and whether RESP restrains it, per center
+    std::vector<double> radius_;
+    std::vector<bool> heavy_;
+
+    /// Root-mean-square ESP error of the last fit, and that relative to the rms ESP
+    double rms_ = 0.0;
+    double rrms_ = 0.0;
+    /// Restraint iterations taken by the last fit
+    int iterations_ = 0;
+
+    /// True if the point (bohr) lies inside scale times the vdW radius of any center
+    bool inside(const double* p, double scale) const;
+
+   public:
+    ChargeFit(std::shared_ptr<Molecule> mol);
+    ~ChargeFit();
+
+    /// Bondi van der Waals radius in bohr, 2.0 Angstrom for elements it does not cover
+    static double vdw_radius(int Z);
+
+    /// CHELPG points (npoints x 3, bohr); spacing and max_distance in Angstrom
+    SharedMatrix chelpg_grid(double spacing = 0.3, double max_distance = 2.8) const;
+    /// Merz-Kollman points (npoints x 3, bohr); density in points per square Angstrom
+    SharedMatrix mk_grid(double density = 1.0) const;
+
+    /*! Fit charges to the total ESP at the grid points
+     *  \param grid npoints x 3, bohr
+     *  \param esp total (nuclear plus electronic) potential at each point, a.u.
+     *  \param total_charge constraint on the sum of the charges
+     *  \param resp_a hyperbolic restraint strength, zero for a plain ESP fit
+     *  \param resp_b hyperbolic restraint width
+     *  \return one charge per atom in the molecule
+     */
+    SharedVector fit(SharedMatrix grid, SharedVector esp, double total_charge, double resp_a = 0.0,
+                     double resp_b = 0.1);
+
+    double rms() const { return rms_; }
+    double rrms() const { return rrms_; }
+    int iterations() const { return iterations_; }
+};
+
+}  // namespace psi
+
+#endif
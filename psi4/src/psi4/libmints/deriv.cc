@@ -414,23 +414,26 @@ SharedMatrix Deriv::compute() {
     // derivatives.
     so_eri.set_only_totally_symmetric(true);
 
-    // Compute one-electron derivatives.
-    std::vector<SharedMatrix> s_deriv = cdsalcs_.create_matrices("S'", *factory_);
-    std::shared_ptr<OneBodySOInt> s_int(integral_->so_overlap(1));
-
-    s_int->compute_deriv1(s_deriv, cdsalcs_);
-
     auto mints = std::make_shared<MintsHelper>(wfn_->basisset(), wfn_->options());
+
+    // Overlap derivative contracted with a Lagrangian as the integrals are made, -sum_pq X_pq dS_pq/dx, instead of
+    // holding one S' matrix per displacement
+    auto lagrangian_grad = [&](SharedMatrix Xso, const std::string &name) {
+        auto X_AO = std::make_shared<Matrix>("AO basis Lagrangian", wfn_->nso(), wfn_->nso());
+        X_AO->remove_symmetry(Xso, wfn_->aotoso()->transpose());
+        // S' is symmetric, so only the symmetric part of X contributes
+        X_AO->hermitivitize();
+        SharedMatrix grad = mints->overlap_grad(X_AO);
+        grad->scale(-1.0);
+        grad->set_name(name);
+        return grad;
+    };
     int ncd = cdsalcs_.ncd();
     auto TPDMcont_vector = std::make_shared<Vector>(ncd);
-    auto Xcont_vector = std::make_shared<Vector>(ncd);
     auto Dcont_vector = std::make_shared<Vector>(ncd);
     SharedVector TPDM_ref_cont_vector;
-    SharedVector X_ref_cont_vector;
-    double *Xcont = Xcont_vector->pointer();
     double *TPDMcont = TPDMcont_vector->pointer();
     double *TPDM_ref_cont = 0;
-    double *X_ref_cont = 0;
 
     if (!wfn_) throw("In Deriv: The wavefunction passed in is empty!");
 
@@ -470,11 +473,8 @@ SharedMatrix Deriv::compute() {
            the correlated part.  The reference contributions must be harvested from the reference_wavefunction
            member.  If density fitting was used, we don't want to compute two electron contributions here*/
         if (wfn_->density_fitted()) {
-            X_ref_cont_vector = std::make_shared<Vector>(ncd);
             TPDM_ref_cont_vector = std::make_shared<Vector>(ncd);
-            X_ref_cont = X_ref_cont_vector->pointer();
             TPDM_ref_cont = TPDM_ref_cont_vector->pointer();
-            x_ref_contr_ = factory_->create_shared_matrix("Reference Lagrangian contribution to gradient", natom_, 3);
             tpdm_ref_contr_ =
                 factory_->create_shared_matrix("Reference two-electron contribution to gradient", natom_, 3);
 
@@ -482,10 +482,7 @@ SharedMatrix Deriv::compute() {
             SharedMatrix X_ref = ref_wfn->Lagrangian();
             SharedMatrix Da_ref = ref_wfn->Da();
 
-            for (size_t cd = 0; cd < cdsalcs_.ncd(); ++cd) {
-                double temp = -X_ref->vector_dot(s_deriv[cd]);
-                X_ref_cont[cd] = temp;
-            }
+            x_ref_contr_ = lagrangian_grad(X_ref, "Reference Lagrangian contribution to gradient");
 
             if (wfn_->same_a_b_orbs()) {
                 // In the restricted case, the alpha D is really the total D.  Undefine the beta one, so
@@ -555,10 +552,7 @@ SharedMatrix Deriv::compute() {
     Dtot->add(Db);
     Dtot_AO->remove_symmetry(Dtot, wfn_->aotoso()->transpose());
     opdm_contr_ = mints->core_hamiltonian_grad(Dtot_AO);
-    for (size_t cd = 0; cd < cdsalcs_.ncd(); ++cd) {
-        double temp = X->vector_dot(s_deriv[cd]);
-        Xcont[cd] = -temp;
-    }
+    x_contr_->copy(lagrangian_grad(X, x_contr_->name()));
 
     // Transform the SALCs back to cartesian space
     SharedMatrix st = cdsalcs_.matrix();
@@ -581,22 +575,6 @@ SharedMatrix Deriv::compute() {
             for (int xyz = 0; xyz < 3; ++xyz) tpdm_contr_->set(a, xyz, cart[3 * a + xyz]);
     }
 
-    // B^t g_q^t = g_x^t -> g_q B = g_x
-    C_DGEMM('n', 'n', 1, 3 * natom_, cdsalcs_.ncd(), 1.0, Xcont, cdsalcs_.ncd(), B[0], 3 * natom_, 0.0, cart,
-            3 * natom_);
-
-    for (int a = 0; a < natom_; ++a)
-        for (int xyz = 0; xyz < 3; ++xyz) x_contr_->set(a, xyz, cart[3 * a + xyz]);
-
-    if (X_ref_cont) {
-        // B^t g_q^t = g_x^t -> g_q B = g_x
-        C_DGEMM('n', 'n', 1, 3 * natom_, cdsalcs_.ncd(), 1.0, X_ref_cont, cdsalcs_.ncd(), B[0], 3 * natom_, 0.0, cart,
-                3 * natom_);
-
-        for (int a = 0; a < natom_; ++a)
-            for (int xyz = 0; xyz < 3; ++xyz) x_ref_contr_->set(a, xyz, cart[3 * a + xyz]);
-    }
-
     // Obtain nuclear repulsion contribution from the wavefunction
     auto enuc = std::make_shared<Matrix>(molecule_->nuclear_repulsion_energy_deriv1(wfn_->get_dipole_field_strength()));
 
@@ -0,0 +1,293 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/dma.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/osrecur.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+uint64_t binomial(int n, int c1);  // From solidharmonics.cc
+uint64_t fact(int n);              // From solidharmonics.cc
+
+namespace psi {
+
+namespace {
+
+/// Position of x^lx y^ly z^lz among all Cartesian moments, monopole first
+inline int cart_index(int lx, int ly, int lz) {
+    int l = lx + ly + lz;
+    int ii = l - lx;
+    return l * (l + 1) * (l + 2) / 6 + ii * (ii + 1) / 2 + lz;
+}
+
+}  // namespace
+
+DistributedMultipoleAnalysis::DistributedMultipoleAnalysis(std::shared_ptr<BasisSet> basis, int limit)
+    : basis_(basis), limit_(limit), nthread_(1) {
+    if (limit_ < 0) throw PSIEXCEPTION("DistributedMultipoleAnalysis: the multipole limit must be non-negative.");
+    std::shared_ptr<Molecule> mol = basis_->molecule();
+    for (int a = 0; a < mol->natom(); ++a) sites_.push_back(mol->xyz(a));
+    radii_.assign(sites_.size(), 1.0);
+}
+
+DistributedMultipoleAnalysis::~DistributedMultipoleAnalysis() {}
+
+void DistributedMultipoleAnalysis::set_radii(const std::vector<double>& radii) {
+    if (radii.size() != sites_.size())
+        throw PSIEXCEPTION("DistributedMultipoleAnalysis: one radius per site is needed.");
+    for (double r : radii)
+        if (r <= 0.0) throw PSIEXCEPTION("DistributedMultipoleAnalysis: site radii must be positive.");
+    radii_ = radii;
+}
+
+void DistributedMultipoleAnalysis::compute(SharedMatrix D) {
+    if (D->nirrep() != 1 || D->rowdim() != basis_->nao() || D->coldim() != basis_->nao())
+        throw PSIEXCEPTION("DistributedMultipoleAnalysis: the density must be in the Cartesian AO basis.");
+    double** Dp = D->pointer();
+    int nsite = sites_.size();
+    int ncart = ncartesian();
+    int nshell = basis_->nshell();
+
+    // Unique shell pairs whose density block is not negligible
+    std::vector<std::pair<int, int>> pairs;
+    for (int P = 0; P < nshell; ++P) {
+        int p0 = basis_->shell_to_ao_function(P);
+        int np = basis_->shell(P).ncartesian();
+        for (int Q = 0; Q <= P; ++Q) {
+            int q0 = basis_->shell_to_ao_function(Q);
+            int nq = basis_->shell(Q).ncartesian();
+            double dmax = 0.0;
+            for (int p = p0; p < p0 + np; ++p)
+                for (int q = q0; q < q0 + nq; ++q) dmax = std::max(dmax, std::fabs(Dp[p][q]));
+            if (dmax > 1.0E-14) pairs.emplace_back(P, Q);
+        }
+    }
+
+    int max_am = basis_->max_am();
+    std::vector<SharedMatrix> thread_moments(nthread_);
+    for (int t = 0; t < nthread_; ++t) thread_moments[t] = std::make_shared<Matrix>(nsite, ncart);
+
+#pragma omp parallel num_threads(nthread_)
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        double** Mp = thread_moments[thread]->pointer();
+        ObaraSaikaTwoCenterMIRecursion mi_recur(max_am, max_am, limit_);
+        double*** x = mi_recur.x();
+        double*** y = mi_recur.y();
+        double*** z = mi_recur.z();
+        std::vector<double> Xpowers(limit_ + 1), Ypowers(limit_ + 1), Zpowers(limit_ + 1);
+        std::vector<int> nearest;
+
+#pragma omp for schedule(dynamic)
+        for (size_t pq = 0; pq < pairs.size(); ++pq) {
+            int P = pairs[pq].first;
+            int Q = pairs[pq].second;
+            const GaussianShell& s1 = basis_->shell(P);
+            const GaussianShell& s2 = basis_->shell(Q);
+            int am1 = s1.am();
+            int am2 = s2.am();
+            int p0 = basis_->shell_to_ao_function(P);
+            int q0 = basis_->shell_to_ao_function(Q);
+            // The (Q, P) block is the same by symmetry of D
+            double perm = (P == Q) ? 1.0 : 2.0;
+            const double* A = s1.center();
+            const double* B = s2.center();
+            double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) + (A[2] - B[2]) * (A[2] - B[2]);
+
+            for (int p1 = 0; p1 < s1.nprimitive(); ++p1) {
+                double a1 = s1.exp(p1);
+                double c1 = s1.coef(p1);
+                for (int p2 = 0; p2 < s2.nprimitive(); ++p2) {
+                    double a2 = s2.exp(p2);
+                    double c2 = s2.coef(p2);
+                    double gamma = a1 + a2;
+                    double oog = 1.0 / gamma;
+                    double Pc[3], PA[3], PB[3];
+                    for (int k = 0; k < 3; ++k) {
+                        Pc[k] = (a1 * A[k] + a2 * B[k]) * oog;
+                        PA[k] = Pc[k] - A[k];
+                        PB[k] = Pc[k] - B[k];
+                    }
+                    double over_pf = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
+
+                    // Nearest site in units of its radius; an exact tie is shared evenly
+                    double best = 0.0;
+                    nearest.clear();
+                    for (int s = 0; s < nsite; ++s) {
+                        double dx = Pc[0] - sites_[s][0], dy = Pc[1] - sites_[s][1], dz = Pc[2] - sites_[s][2];
+                        double r = std::sqrt(dx * dx + dy * dy + dz * dz) / radii_[s];
+                        if (nearest.empty() || r < best - 1.0E-10) {
+                            best = r;
+                            nearest.assign(1, s);
+                        } else if (std::fabs(r - best) <= 1.0E-10) {
+                            nearest.push_back(s);
+                        }
+                    }
+                    double share = perm * over_pf / nearest.size();
+
+                    mi_recur.compute(PA, PB, gamma, am1, am2);
+
+                    for (int site : nearest) {
+                        double PSx = Pc[0] - sites_[site][0];
+                        double PSy = Pc[1] - sites_[site][1];
+                        double PSz = Pc[2] - sites_[site][2];
+                        int bf1 = p0;
+                        for (int ii = 0; ii <= am1; ii++) {
+                            int lx1 = am1 - ii;
+                            for (int lz1 = 0; lz1 <= ii; lz1++, bf1++) {
+                                int ly1 = ii - lz1;
+                                int bf2 = q0;
+                                for (int kk = 0; kk <= am2; kk++) {
+                                    int lx2 = am2 - kk;
+                                    for (int lz2 = 0; lz2 <= kk; lz2++, bf2++) {
+                                        int ly2 = kk - lz2;
+                                        double w = Dp[bf1][bf2] * share;
+                                        if (w == 0.0) continue;
+                                        // (X - S)^l = sum_i (l choose i) (X - P)^(l - i) (P - S)^i
+                                        for (int l = 0; l <= limit_; ++l) {
+                                            double px = 1.0, py = 1.0, pz = 1.0;
+                                            Xpowers[l] = Ypowers[l] = Zpowers[l] = 0.0;
+                                            for (int i = 0; i <= l; ++i) {
+                                                double coef = (double)binomial(l, i);
+                                                Xpowers[l] += coef * px * x[lx1][lx2][l - i];
+                                                Ypowers[l] += coef * py * y[ly1][ly2][l - i];
+                                                Zpowers[l] += coef * pz * z[lz1][lz2][l - i];
+                                                px *= PSx;
+                                                py *= PSy;
+                                                pz *= PSz;
+                                            }
+                                        }
+                                        // Electrons carry a negative charge
+                                        double* Ms = Mp[site];
+                                        for (int l = 0, idx = 0; l <= limit_; ++l) {
+                                            for (int jj = 0; jj <= l; jj++) {
+                                                int lx = l - jj;
+                                                for (int lz = 0; lz <= jj; lz++, idx++) {
+                                                    int ly = jj - lz;
+                                                    Ms[idx] -= w * Xpowers[lx] * Ypowers[ly] * Zpowers[lz];
+                                                }
+                                            }
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    cartesian_ = std::make_shared<Matrix>("DMA Cartesian Moments", nsite, ncart);
+    for (int t = 0; t < nthread_; ++t) cartesian_->add(thread_moments[t]);
+    std::shared_ptr<Molecule> mol = basis_->molecule();
+    for (int a = 0; a < nsite; ++a) cartesian_->add(a, 0, mol->Z(a));
+}
+
+void DistributedMultipoleAnalysis::to_spherical(const double* cart, double* sph) const {
+    // Racah-normalized real solid harmonics, S_lm = sqrt(4 pi / (2l + 1)) r^l Y_lm, expanded in
+    // Cartesian monomials as in solidharmonics.cc; components ordered 0, 1c, 1s, 2c, 2s, ...
+    for (int l = 0, out = 0; l <= limit_; ++l) {
+        for (int k = 0; k <= 2 * l; ++k, ++out) {
+            int m = (k == 0) ? 0 : ((k % 2) ? (k + 1) / 2 : -(k / 2));
+            int absm = std::abs(m);
+            int v2m = (m >= 0) ? 0 : 1;
+            double norm = std::sqrt(2.0 * fact(l + absm) * fact(l - absm) / (m == 0 ? 2.0 : 1.0)) /
+                          (std::pow(2.0, absm) * fact(l));
+            double val = 0.0;
+            for (int t = 0; t <= (l - absm) / 2; t++) {
+                for (int u = 0; u <= t; u++) {
+                    for (int v2 = v2m; v2 <= absm; v2 += 2) {
+                        int px = 2 * t + absm - 2 * u - v2;
+                        int py = 2 * u + v2;
+                        int pz = l - px - py;
+                        double c = (double)(binomial(l, t) * binomial(l - t, absm + t) * binomial(t, u) *
+                                            binomial(absm, v2)) /
+                                   std::pow(4.0, t);
+                        if ((t + (v2 - v2m) / 2) % 2) c = -c;
+                        val += c * cart[cart_index(px, py, pz)];
+                    }
+                }
+            }
+            sph[out] = norm * val;
+        }
+    }
+}
+
+SharedMatrix DistributedMultipoleAnalysis::site_multipoles() const {
+    if (!cartesian_) throw PSIEXCEPTION("DistributedMultipoleAnalysis: compute() has not been called.");
+    int nsite = sites_.size();
+    auto Q = std::make_shared<Matrix>("DMA Distributed Multipoles", nsite, (limit_ + 1) * (limit_ + 1));
+    for (int s = 0; s < nsite; ++s) to_spherical(cartesian_->pointer()[s], Q->pointer()[s]);
+    return Q;
+}
+
+SharedMatrix DistributedMultipoleAnalysis::total_multipoles(const Vector3& origin) const {
+    if (!cartesian_) throw PSIEXCEPTION("DistributedMultipoleAnalysis: compute() has not been called.");
+    int ncart = ncartesian();
+    std::vector<double> total(ncart, 0.0);
+    for (size_t s = 0; s < sites_.size(); ++s) {
+        const double* M = cartesian_->pointer()[s];
+        Vector3 d = sites_[s] - origin;
+        // (X - O)^a = sum_i (a choose i) (X - S)^i (S - O)^(a - i), per Cartesian direction
+        for (int l = 0, idx = 0; l <= limit_; ++l) {
+            for (int jj = 0; jj <= l; jj++) {
+                int a = l - jj;
+                for (int c = 0; c <= jj; c++, idx++) {
+                    int b = jj - c;
+                    double val = 0.0;
+                    for (int i = 0; i <= a; ++i)
+                        for (int j = 0; j <= b; ++j)
+                            for (int k = 0; k <= c; ++k)
+                                val += (double)(binomial(a, i) * binomial(b, j) * binomial(c, k)) *
+                                       std::pow(d[0], a - i) * std::pow(d[1], b - j) * std::pow(d[2], c - k) *
+                                       M[cart_index(i, j, k)];
+                    total[idx] += val;
+                }
+            }
+        }
+    }
+    auto Q = std::make_shared<Matrix>("DMA Total Multipoles", 1, (limit_ + 1) * (limit_ + 1));
+    to_spherical(total.data(), Q->pointer()[0]);
+    return Q;
+}
+
+}  // namespace psi
@@ -0,0 +1,89 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_dma_h_
+#define _psi_src_lib_libmints_dma_h_
+
+#include "psi4/libmints/typedefs.h"
+#include "psi4/libmints/vector3.h"
+#include "psi4/pragma.h"
+
+#include <memory>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+
+/*! \ingroup MINTS
+ *  \class DistributedMultipoleAnalysis
+ *  \brief Stone's distributed multipole analysis of a one-particle density.
+ *
+ * Every primitive product is a Gaussian at its own center P, and its moments are taken directly
+ * about the site nearest P, measured in units of the site radius, using the Obara-Saika moment
+ * recursion MultipoleInt is built on. Ranks up to the limit are exact after the move, so the
+ * result is the standard DMA (GDMA with switch 0). Shell pairs are spread over threads, each
+ * accumulating its own site moments. The sites are the atoms.
+ */
+class PSI_API DistributedMultipoleAnalysis {
+   protected:
+    std::shared_ptr<BasisSet> basis_;
+    /// Highest multipole rank kept on each site
+    int limit_;
+    int nthread_;
+    /// Site positions and radii (bohr)
+    std::vector<Vector3> sites_;
+    std::vector<double> radii_;
+    /// Raw Cartesian moments about each site, monopole first, then MultipoleInt order
+    SharedMatrix cartesian_;
+
+    /// Number of Cartesian moments up to limit_
+    int ncartesian() const { return (limit_ + 1) * (limit_ + 2) * (limit_ + 3) / 6; }
+    /// Real Racah-normalized solid harmonics from a row of raw Cartesian moments
+    void to_spherical(const double* cart, double* sph) const;
+
+   public:
+    DistributedMultipoleAnalysis(std::shared_ptr<BasisSet> basis, int limit);
+    ~DistributedMultipoleAnalysis();
+
+    /// Site radii in bohr, one per atom; all sites are equal by default
+    void set_radii(const std::vector<double>& radii);
+    void set_nthread(int nthread) { nthread_ = nthread; }
+
+    /// Distribute the total density D (Cartesian AO basis) and the nuclear charges over the sites
+    void compute(SharedMatrix D);
+
+    /// Site multipoles Q00, Q10, Q11c, Q11s, Q20, ... (nsite x (limit + 1)^2)
+    SharedMatrix site_multipoles() const;
+    /// Site multipoles moved to, and summed at, origin (1 x (limit + 1)^2)
+    SharedMatrix total_multipoles(const Vector3& origin) const;
+};
+
+}  // namespace psi
+
+#endif
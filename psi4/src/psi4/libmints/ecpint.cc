@@ -44,6 +44,7 @@
 #include <cmath>
 #include <algorithm>
 #include <functional>
+#include <mutex>
 #include <vector>
 
 namespace psi {
@@ -320,6 +321,20 @@ void AngularIntegral::compute() {
 
 void AngularIntegral::clear() {}
 
+std::shared_ptr<const AngularIntegral> AngularIntegral::shared(int LB, int LE) {
+    static std::map<std::pair<int, int>, std::shared_ptr<const AngularIntegral>> tables;
+    static std::mutex tables_mutex;
+
+    std::lock_guard<std::mutex> lock(tables_mutex);
+    std::shared_ptr<const AngularIntegral> &table = tables[std::make_pair(LB, LE)];
+    if (!table) {
+        auto ints = std::make_shared<AngularIntegral>(LB, LE);
+        ints->compute();
+        table = ints;
+    }
+    return table;
+}
+
 double AngularIntegral::getIntegral(int k, int l, int m, int lam, int mu) const { return W(k, l, m, lam, lam + mu); }
 double AngularIntegral::getIntegral(int k, int l, int m, int lam, int mu, int rho, int sigma) const {
     return omega(k, l, m, lam, lam + mu, rho, rho + sigma);
@@ -352,6 +367,24 @@ void RadialIntegral::init(int maxL, double tol, int small, int large) {
     tolerance = tol;
 }
 
+const std::vector<double> &RadialIntegral::smallU(const GaussianShell &U, int l, int N) {
+    std::vector<double> &Utab = smallUCache[std::make_tuple(&U, l, N)];
+    if (Utab.empty()) {
+        Utab.resize(smallGrid.getN());
+        buildU(U, l, N, smallGrid, Utab.data());
+    }
+    return Utab;
+}
+
+const TwoIndex<double> &RadialIntegral::smallF(const GaussianShell &shell, double A, int lend) {
+    TwoIndex<double> &F = smallFCache[std::make_pair(&shell, A)];
+    if (F.dims[0] < lend + 1) {
+        int gridSize = smallGrid.getN();
+        buildF(shell, A, 0, lend, smallGrid.getX(), gridSize, 0, gridSize - 1, F);
+    }
+    return F;
+}
+
 void RadialIntegral::buildBessel(std::vector<double> &r, int nr, int maxL, TwoIndex<double> &values, double weight) {
     std::vector<double> besselValues;
     for (int i = 0; i < nr; i++) {
@@ -550,18 +583,22 @@ void RadialIntegral::type2(int l, int l1start, int l1end, int l2start, int l2end
     smallGrid.start = 0;
     smallGrid.end = gridSize - 1;
 
-    std::vector<double> Utab(gridSize);
-    buildU(U, l, N, smallGrid, Utab.data());
+    const std::vector<double> &Utab = smallU(U, l, N);
     values.assign(l1end + 1, l2end + 1, 0.0);
 
     // Build the F matrices
     // If shell is on same center as ECP, only l = 0 will be nonzero
     if (A < 1e-15) l1end = 0;
     if (B < 1e-15) l2end = 0;
-    TwoIndex<double> Fa;
-    TwoIndex<double> Fb;
-    buildF(shellA, data.Am, l1start, l1end, gridPoints, gridSize, smallGrid.start, smallGrid.end, Fa);
-    buildF(shellB, data.Bm, l2start, l2end, gridPoints, gridSize, smallGrid.start, smallGrid.end, Fb);
+    // Only the shells of the current few pairs are worth keeping; trim before taking references
+    if (smallFCache.size() > 64) smallFCache.clear();
+    TwoIndex<double> FaTab, FbTab;
+    if (l1start > 0)
+        buildF(shellA, data.Am, l1start, l1end, gridPoints, gridSize, smallGrid.start, smallGrid.end, FaTab);
+    if (l2start > 0)
+        buildF(shellB, data.Bm, l2start, l2end, gridPoints, gridSize, smallGrid.start, smallGrid.end, FbTab);
+    const TwoIndex<double> &Fa = l1start > 0 ? FaTab : smallF(shellA, data.Am, l1end);
+    const TwoIndex<double> &Fb = l2start > 0 ? FbTab : smallF(shellB, data.Bm, l2end);
 
     // Build the integrals
     bool foundStart, tooSmall;
@@ -584,8 +621,8 @@ void RadialIntegral::type2(int l, int l1start, int l1end, int l2start, int l2end
         double zeta_a, zeta_b, c_a, c_b;
 
         gridSize = bigGrid.getN();
-        Fa.assign(l1end + 1, gridSize, 0.0);
-        Fb.assign(l2end + 1, gridSize, 0.0);
+        TwoIndex<double> Fa(l1end + 1, gridSize, 0.0);
+        TwoIndex<double> Fb(l2end + 1, gridSize, 0.0);
 
         for (int a = 0; a < npA; a++) {
             c_a = shellA.coef(a);
@@ -644,8 +681,7 @@ ECPInt::ECPInt(std::vector<SphericalTransform> &st, std::shared_ptr<BasisSet> bs
     int maxam2 = bs2->max_am();
     int maxLB = maxam1 > maxam2 ? maxam1 : maxam2;
     int maxLU = bs1_->max_ecp_am();
-    angInts.init(maxLB + deriv, maxLU);
-    angInts.compute();
+    angInts = AngularIntegral::shared(maxLB + deriv, maxLU);
     radInts.init(2 * (maxLB + deriv) + maxLU);
 
     int maxnao1 = INT_NCART(maxam1);
@@ -745,7 +781,7 @@ void ECPInt::type1(const GaussianShell &U, const GaussianShell &shellA, const Ga
                                                 for (int lam = lparity; lam <= ix; lam += 2) {
                                                     for (int mu = mparity; mu <= lam; mu += 2)
                                                         values(na, nb) +=
-                                                            C * angInts.getIntegral(k, l, m, lam, msign * mu) *
+                                                            C * angInts->getIntegral(k, l, m, lam, msign * mu) *
                                                             radials(ix, lam, lam + msign * mu);
                                                 }
                                             }
@@ -833,10 +869,10 @@ void ECPInt::type2(int lam, const GaussianShell &U, const GaussianShell &shellA,
                                                             for (int mu = -lam; mu <= lam; mu++)
                                                                 values(na, nb, lam + mu) +=
                                                                     val2 *
-                                                                    angInts.getIntegral(alpha_x, alpha_y, alpha_z, lam,
-                                                                                        mu, lam1, mu1) *
-                                                                    angInts.getIntegral(beta_x, beta_y, beta_z, lam, mu,
-                                                                                        lam2, mu2);
+                                                                    angInts->getIntegral(alpha_x, alpha_y, alpha_z,
+                                                                                         lam, mu, lam1, mu1) *
+                                                                    angInts->getIntegral(beta_x, beta_y, beta_z, lam,
+                                                                                         mu, lam2, mu2);
                                                         }
                                                     }
                                                 }
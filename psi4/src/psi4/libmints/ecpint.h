@@ -41,6 +41,9 @@
 #ifndef ECPINT_HEAD
 #define ECPINT_HEAD
 
+#include <map>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include "psi4/libmints/multiarr.h"
 #include "psi4/libmints/gaussquad.h"
@@ -151,6 +154,12 @@ class AngularIntegral {
     /// TODO: Clears the W and omega arrays
     void clear();
 
+    /**
+     * Computed tables for the given limits, shared by every ECPInt that needs them.
+     * They depend only on LB and LE, so each pair is built once per process.
+     */
+    static std::shared_ptr<const AngularIntegral> shared(int LB, int LE);
+
     /**
      * Returns the type 1 angular integral W(k, l, m, lam, mu)
      * @param k - x index
@@ -203,6 +212,17 @@ class RadialIntegral {
     /// Tolerance for change below which an integral is considered converged
     double tolerance;
 
+    /// r^N U_l(r) on the small grid, keyed on ECP shell, l and N; the grid never moves
+    std::map<std::tuple<const GaussianShell *, int, int>, std::vector<double>> smallUCache;
+    /// F functions (see buildF) on the small grid from l = 0, keyed on basis shell and its distance
+    /// from the ECP center; they are reused over all ECP shells on that center, all N, and the partner shells
+    std::map<std::pair<const GaussianShell *, double>, TwoIndex<double>> smallFCache;
+
+    /// Cached r^N U_l(r) on the small grid
+    const std::vector<double> &smallU(const GaussianShell &U, int l, int N);
+    /// Cached F functions on the small grid, for l = 0 to at least lend
+    const TwoIndex<double> &smallF(const GaussianShell &shell, double A, int lend);
+
     /// This integrand simply returns the pretabulated integrand values stored in p given an index ix
     static double integrand(double r, double *p, int ix);
 
@@ -325,8 +345,8 @@ class ECPInt : public OneBodyAOInt {
    private:
     /// The interface to the radial integral calculation
     RadialIntegral radInts;
-    /// The angular integrals, which can be reused over all ECP centers
-    AngularIntegral angInts;
+    /// The angular integrals, which can be reused over all ECP centers (and are shared between ECPInts)
+    std::shared_ptr<const AngularIntegral> angInts;
 
     /// Worker functions for calculating binomial expansion coefficients
     double calcC(int a, int m, double A) const;
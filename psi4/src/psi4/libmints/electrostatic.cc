@@ -126,6 +126,7 @@ void ElectrostaticInt::compute_pair(const GaussianShell& s1, const GaussianShell
     memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
 
     double*** vi = potential_recur_->vi();
+    reserve_far_charges(1);
 
     for (int p1 = 0; p1 < nprim1; ++p1) {
         double a1 = s1.exp(p1);
@@ -159,6 +160,15 @@ void ElectrostaticInt::compute_pair(const GaussianShell& s1, const GaussianShell
             PC[1] = P[1] - C[1];
             PC[2] = P[2] - C[2];
 
+            if (PC[0] * PC[0] + PC[1] * PC[1] + PC[2] * PC[2] > far_T_[am1 + am2] * oog) {
+                far_q_[0] = -1.0;
+                far_x_[0] = PC[0];
+                far_y_[0] = PC[1];
+                far_z_[0] = PC[2];
+                far_field(am1, am2, PA, PB, gamma, over_pf, 1);
+                continue;
+            }
+
             // Do recursion
             potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
 
@@ -65,8 +65,45 @@ typedef struct ShellPair_typ {
     double *ci, *cj;
     //! Overlap between primitives on i and j
     double** overlap;
+    //! Prefactor bound per primitive pair: |prefactor of (ij|kl)| <= bound_ij * bound_kl
+    double** bound;
+    //! Largest bound over the primitive pairs
+    double bound_max;
 } ShellPair;
 
+/*! \ingroup MINTS
+ *  \class ShellPairTable
+ *  \brief Read-only ShellPair table for one ordered pair of basis sets.
+ *
+ *  The table only depends on the two basis sets, so it is built once and
+ *  shared by every TwoElectronInt (one per thread, typically) through get().
+ */
+class ShellPairTable {
+    std::shared_ptr<BasisSet> bs1_, bs2_;
+    int nshell2_;
+    //! Backing store for all the per-primitive arrays
+    std::vector<double> stack_;
+    std::vector<ShellPair> pairs_;
+
+    ShellPairTable(const ShellPairTable&) = delete;
+    ShellPairTable& operator=(const ShellPairTable&) = delete;
+
+   public:
+    ShellPairTable(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2);
+    ~ShellPairTable();
+
+    /// The shared table for (bs1, bs2), built on first use and kept while anyone holds it
+    static std::shared_ptr<const ShellPairTable> get(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2);
+
+    /// Evaluates how much memory (in doubles) is needed to store shell pair data
+    static size_t memory(const std::shared_ptr<BasisSet>& bs1, const std::shared_ptr<BasisSet>& bs2);
+
+    const std::shared_ptr<BasisSet>& basis1() const { return bs1_; }
+    const std::shared_ptr<BasisSet>& basis2() const { return bs2_; }
+
+    const ShellPair* pair(int i, int j) const { return &pairs_[(size_t)i * nshell2_ + j]; }
+};
+
 /*! \ingroup MINTS
  *  \class ERI
  *  \brief Capable of computing two-electron repulsion integrals.
@@ -84,6 +121,12 @@ class TwoElectronInt : public TwoBodyAOInt {
     //! Computes the fundamental
     Fjt* fjt_;
 
+    //! Work space for the batched Boys function evaluation
+    std::vector<double> fjt_scratch_;
+
+    //! Primitive quartets with a prefactor bound below this are skipped (INTS_PRIMITIVE_TOLERANCE)
+    double prim_cutoff_;
+
     //! Computes the ERIs between four shells.
     size_t compute_quartet(int, int, int, int);
 
@@ -93,25 +136,14 @@ class TwoElectronInt : public TwoBodyAOInt {
     //! Computes the ERI second derivative between four shells.
     size_t compute_quartet_deriv2(int, int, int, int);
 
-    //! Form shell pair information. Must be smart enough to handle arbitrary basis sets
-    void init_shell_pairs12();
-    void init_shell_pairs34();
-
-    //! Free shell pair information
-    void free_shell_pairs12();
-    void free_shell_pairs34();
-
     //! Should we use shell pair information?
     bool use_shell_pairs_;
 
-    //! Stack memory pointer, used in init_shell_pairs, freed in destructor
-    double *stack12_, *stack34_;
-
-    //! Shell pair information
-    ShellPair **pairs12_, **pairs34_;
+    //! Shared shell pair tables, one per basis set ordering compute_quartet can see
+    std::vector<std::shared_ptr<const ShellPairTable>> pair_data_;
 
-    //! Evaluates how much memory (in doubles) is needed to store shell pair data
-    size_t memory_to_store_shell_pairs(const std::shared_ptr<BasisSet>&, const std::shared_ptr<BasisSet>&);
+    //! Shell pair table for the (possibly permuted) basis sets bsA, bsB
+    const ShellPairTable* pair_data(const std::shared_ptr<BasisSet>& bsA, const std::shared_ptr<BasisSet>& bsB) const;
 
     //! Original shell index requested
     int osh1_, osh2_, osh3_, osh4_;
@@ -36,7 +36,12 @@
 #include "psi4/libmints/fjt.h"
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 
@@ -1659,15 +1664,21 @@ static void handle_reordering12(PermutedOrder permutation, Libderiv_t &libderiv_
  * @param sh1eqsh2 Is the shell on center 1 identical to that on center 2?
  * @param sh3eqsh4 Is the shell on center 3 identical to that on center 4?
  * @param deriv_lvl Derivitive level of the integral
+ * @param scratch Room for (3 + am + deriv_lvl + 1) doubles per primitive quartet, for the batched Boys function
+ * @param prim_cutoff Drop primitive quartets whose prefactor bound is below this (0.0 keeps all)
  * @return The total number of primitive combinations found. This is passed to libint/libderiv.
  */
 static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellPair *p12, const ShellPair *p34, int am,
                                   int nprim1, int nprim2, int nprim3, int nprim4, bool sh1eqsh2, bool sh3eqsh4,
-                                  int deriv_lvl) {
+                                  int deriv_lvl, double *scratch, double prim_cutoff = 0.0) {
     double zeta, eta, ooze, rho, poz, coef1, PQx, PQy, PQz, PQ2, Wx, Wy, Wz, o12, o34, T, *F;
     double a1, a2, a3, a4;
     int p1, p2, p3, p4, i;
     size_t nprim = 0L;
+    const size_t nmax = (size_t)nprim1 * nprim2 * nprim3 * nprim4;
+    double *Ts = scratch;
+    double *rhos = scratch + nmax;
+    double *coefs = scratch + 2 * nmax;
     double *pai = p12->ai;
     double *pgamma12 = p12->gamma[0];
     double *poverlap12 = p12->overlap[0];
@@ -1682,6 +1693,9 @@ static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellP
             ++paj;
             ++pgamma12;
             ++poverlap12;
+            // Nothing on the ket side can lift this primitive pair over the cutoff
+            const double bound12 = p12->bound[p1][p2];
+            if (bound12 * p34->bound_max < prim_cutoff) continue;
             double PAx = p12->PA[p1][p2][0];
             double PAy = p12->PA[p1][p2][1];
             double PAz = p12->PA[p1][p2][2];
@@ -1706,6 +1720,7 @@ static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellP
                     ++pal;
                     ++pgamma34;
                     ++poverlap34;
+                    if (bound12 * p34->bound[p3][p4] < prim_cutoff) continue;
 
                     double PCx = p34->PA[p3][p4][0];
                     double PCy = p34->PA[p3][p4][1];
@@ -1766,17 +1781,31 @@ static size_t fill_primitive_data(prim_data *PrimQuartet, Fjt *fjt, const ShellP
                     PrimQuartet[nprim].U[5][1] = Wy - PCDy;
                     PrimQuartet[nprim].U[5][2] = Wz - PCDz;
 
-                    T = rho * PQ2;
-                    fjt->set_rho(rho);
-                    F = fjt->values(am + deriv_lvl, T);
-
-                    for (i = 0; i <= am + deriv_lvl; ++i) PrimQuartet[nprim].F[i] = F[i] * coef1;
+                    Ts[nprim] = rho * PQ2;
+                    rhos[nprim] = rho;
+                    coefs[nprim] = coef1;
 
                     nprim++;
                 }
             }
         }
     }
+
+    // Boys function for all primitive quartets in one call, unless it depends on rho
+    const int J = am + deriv_lvl;
+    if (fjt->rho_dependent()) {
+        for (size_t k = 0; k < nprim; ++k) {
+            T = Ts[k];
+            fjt->set_rho(rhos[k]);
+            F = fjt->values(J, T);
+            for (i = 0; i <= J; ++i) PrimQuartet[k].F[i] = F[i] * coefs[k];
+        }
+    } else {
+        F = scratch + 3 * nmax;
+        fjt->values(J, Ts, nprim, F);
+        for (size_t k = 0; k < nprim; ++k)
+            for (i = 0; i <= J; ++i) PrimQuartet[k].F[i] = F[k * (J + 1) + i] * coefs[k];
+    }
     return nprim;
 }
 
@@ -1843,6 +1872,11 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
         outfile->Printf("Error allocating memory for libint/libderiv.\n");
         exit(EXIT_FAILURE);
     }
+    prim_cutoff_ = Process::environment.options.get_double("INTS_PRIMITIVE_TOLERANCE");
+
+    // T, rho, prefactor and F_0..F_J for every primitive quartet (see fill_primitive_data)
+    fjt_scratch_.resize((size_t)max_nprim * (3 + 4 * max_am + deriv_ + 1));
+
     size_t size = INT_NCART(basis1()->max_am()) * INT_NCART(basis2()->max_am()) * INT_NCART(basis3()->max_am()) *
                   INT_NCART(basis4()->max_am());
 
@@ -1876,16 +1910,16 @@ TwoElectronInt::TwoElectronInt(const IntegralFactory *integral, int deriv, bool
     }
     memset(source_, 0, sizeof(double) * size);
 
-    if (basis1() != basis2() || basis1() != basis3() || basis2() != basis4()) {
-        use_shell_pairs_ = false;
-    }
-
     if (use_shell_pairs_) {
-        // Precompute a bunch of information
-        init_shell_pairs12();
-        // If basis3 and basis4 equals basis1 and basis2, then the following function will do nothing,
-        // except assign pairs34_ to pairs12_
-        init_shell_pairs34();
+        // compute_shell may hand compute_quartet any of these orderings; the
+        // tables themselves are shared with every other integral object
+        std::vector<std::pair<std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>>> orderings = {
+            {basis1(), basis2()}, {basis2(), basis1()}, {basis3(), basis4()}, {basis4(), basis3()}};
+        for (const auto &bs : orderings) {
+            bool have = false;
+            for (const auto &data : pair_data_) have = have || (data->basis1() == bs.first && data->basis2() == bs.second);
+            if (!have) pair_data_.push_back(ShellPairTable::get(bs.first, bs.second));
+        }
     }
 
     // form the blocking. We use the default
@@ -1898,41 +1932,31 @@ TwoElectronInt::~TwoElectronInt() {
     delete[] source_full_;
     free_libint(&libint_);
     if (deriv_) free_libderiv(&libderiv_);
-    free_shell_pairs12();
-    free_shell_pairs34();  // This shouldn't do anything, but this might change in the future
 }
 
-void TwoElectronInt::init_shell_pairs12() {
-    ShellPair *sp;
+ShellPairTable::ShellPairTable(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2)
+    : bs1_(bs1), bs2_(bs2), nshell2_(bs2->nshell()) {
     Vector3 P, PA, PB, AB, A, B;
-    int i, j, si, sj, np_i, np_j;
-    size_t memd;
     double a1, a2, ab2, gam, c1, c2;
-    double *curr_stack_ptr;
 
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = TwoElectronInt::memory_to_store_shell_pairs(basis1(), basis2());
+    // One stack for the dynamically sized parts of every ShellPair
+    stack_.resize(memory(bs1_, bs2_));
+    double *curr_stack_ptr = stack_.data();
 
-    // Allocate a stack of memory
-    stack12_ = new double[memd];
-    curr_stack_ptr = stack12_;
-
-    // Allocate shell pair memory
-    pairs12_ = new ShellPair *[basis1()->nshell()];
-    for (i = 0; i < basis1()->nshell(); ++i) pairs12_[i] = new ShellPair[basis2()->nshell()];
+    pairs_.resize((size_t)bs1_->nshell() * nshell2_);
 
     // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        A = basis1()->shell(si).center();
+    for (int si = 0; si < bs1_->nshell(); ++si) {
+        A = bs1_->shell(si).center();
 
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            B = basis2()->shell(sj).center();
+        for (int sj = 0; sj < nshell2_; ++sj) {
+            B = bs2_->shell(sj).center();
 
             AB = A - B;
             ab2 = AB.dot(AB);
 
             // Get the pointer for convenience
-            sp = &(pairs12_[si][sj]);
+            ShellPair *sp = &(pairs_[(size_t)si * nshell2_ + sj]);
 
             // Save some information
             sp->i = si;
@@ -1941,8 +1965,8 @@ void TwoElectronInt::init_shell_pairs12() {
             sp->AB[1] = AB[1];
             sp->AB[2] = AB[2];
 
-            np_i = basis1()->shell(si).nprimitive();
-            np_j = basis2()->shell(sj).nprimitive();
+            int np_i = bs1_->shell(si).nprimitive();
+            int np_j = bs2_->shell(sj).nprimitive();
 
             // Reserve some memory for the primitives
             sp->ai = curr_stack_ptr;
@@ -1952,7 +1976,7 @@ void TwoElectronInt::init_shell_pairs12() {
 
             // Allocate and reserve memory for gammas
             sp->gamma = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
+            for (int i = 0; i < np_i; ++i) {
                 sp->gamma[i] = curr_stack_ptr;
                 curr_stack_ptr += np_j;
             }
@@ -1965,21 +1989,28 @@ void TwoElectronInt::init_shell_pairs12() {
 
             // Allocate and reserve space for overlaps
             sp->overlap = new double *[np_i];
-            for (i = 0; i < np_i; ++i) {
+            for (int i = 0; i < np_i; ++i) {
                 sp->overlap[i] = curr_stack_ptr;
                 curr_stack_ptr += np_j;
             }
 
+            // Allocate and reserve space for the primitive pair bounds
+            sp->bound = new double *[np_i];
+            for (int i = 0; i < np_i; ++i) {
+                sp->bound[i] = curr_stack_ptr;
+                curr_stack_ptr += np_j;
+            }
+
             // Allocate and reserve space for P, PA, and PB.
             sp->P = new double **[np_i];
             sp->PA = new double **[np_i];
             sp->PB = new double **[np_i];
-            for (i = 0; i < np_i; ++i) {
+            for (int i = 0; i < np_i; ++i) {
                 sp->P[i] = new double *[np_j];
                 sp->PA[i] = new double *[np_j];
                 sp->PB[i] = new double *[np_j];
 
-                for (j = 0; j < np_j; ++j) {
+                for (int j = 0; j < np_j; ++j) {
                     sp->P[i][j] = curr_stack_ptr;
                     curr_stack_ptr += 3;
                     sp->PA[i][j] = curr_stack_ptr;
@@ -1991,17 +2022,18 @@ void TwoElectronInt::init_shell_pairs12() {
 
             // All memory has been reserved/allocated for this shell primitive pair pair.
             // Pre-compute all data that we can:
-            for (i = 0; i < np_i; ++i) {
-                a1 = basis1()->shell(si).exp(i);
-                c1 = basis1()->shell(si).coef(i);
+            sp->bound_max = 0.0;
+            for (int i = 0; i < np_i; ++i) {
+                a1 = bs1_->shell(si).exp(i);
+                c1 = bs1_->shell(si).coef(i);
 
                 // Save some information
                 sp->ai[i] = a1;
                 sp->ci[i] = c1;
 
-                for (j = 0; j < np_j; ++j) {
-                    a2 = basis2()->shell(sj).exp(j);
-                    c2 = basis2()->shell(sj).coef(j);
+                for (int j = 0; j < np_j; ++j) {
+                    a2 = bs2_->shell(sj).exp(j);
+                    c2 = bs2_->shell(sj).coef(j);
 
                     gam = a1 + a2;
 
@@ -2024,168 +2056,54 @@ void TwoElectronInt::init_shell_pairs12() {
                     sp->PB[i][j][1] = PB[1];
                     sp->PB[i][j][2] = PB[2];
                     sp->overlap[i][j] = pow(M_PI / gam, 3.0 / 2.0) * exp(-a1 * a2 * ab2 / gam) * c1 * c2;
+                    // 2 sqrt(rho / pi) <= (2 / pi)^1/4 (zeta eta)^1/4 splits the prefactor over the pairs,
+                    // and F_m(T) <= 1
+                    sp->bound[i][j] = std::pow(2.0 * M_1_PI * gam, 0.25) * std::fabs(sp->overlap[i][j]);
+                    sp->bound_max = std::max(sp->bound_max, sp->bound[i][j]);
                 }
             }
         }
     }
 }
 
-void TwoElectronInt::init_shell_pairs34() {
-    // If basis1 == basis3 && basis2 == basis4, then we don't need to do anything except use the pointer
-    // of pairs12_.
-    if (use_shell_pairs_ == true) {
-        // This assumes init_shell_pairs12 was called and precomputed the values.
-        pairs34_ = pairs12_;
-        stack34_ = nullptr;
-        return;
-    }
-#if 0
-                                                                                                                            outfile->Printf( "  Pre-computing additional values for two-electron integrals. [ |34) does not equal (12| ]\n");
-
-    // Estimate memory needed by allocated space for the dynamically allocated parts of ShellPair structure
-    memd = ERIBase::memory_to_store_shell_pairs(basis3(), basis4());
-
-    // Allocate a stack of memory
-    stack34_ = new double[memd];
-    curr_stack_ptr = stack34_;
-
-    // Allocate shell pair memory
-    pairs34_ = new ShellPair*[basis3()->nprimitive()];
-    for (i=0; i<basis3()->nprimitive(); ++i)
-        pairs34_[i] = new ShellPair[basis4()->nprimitive()];
-
-    // Loop over all shell pairs (si, sj) and create primitive pairs pairs
-    for (si=0; si<basis3()->nprimitive(); ++si) {
-        A = basis3()->shell(si).center();
-
-        for (sj=0; sj<basis4()->nprimitive(); ++sj) {
-            B = basis4()->shell(sj).center();
-
-            AB = A - B;
-            ab2 = AB.dot(AB);
-
-            // Get the pointer for convenience
-            sp = &(pairs34_[si][sj]);
-
-            // Save some information
-            sp->i = si;
-            sp->j = sj;
-            sp->AB[0] = AB[0]; sp->AB[1] = AB[1]; sp->AB[2] = AB[2];
-
-            np_i = basis3()->shell(si).nprimitive();
-            np_j = basis4()->shell(sj).nprimitive();
-
-            // Reserve some memory for the primitives
-            sp->ai = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->aj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve memory for gammas
-            sp->gamma = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->gamma[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Reserve space for contraction coefficients
-            sp->ci = curr_stack_ptr; curr_stack_ptr += np_i;
-            sp->cj = curr_stack_ptr; curr_stack_ptr += np_j;
-
-            // Allocate and reserve space for overlaps
-            sp->overlap = new double*[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->overlap[i] = curr_stack_ptr; curr_stack_ptr += np_j;
-            }
-
-            // Allocate and reserve space for P, PA, and PB.
-            sp->P  = new double**[np_i];
-            sp->PA = new double**[np_i];
-            sp->PB = new double**[np_i];
-            for (i=0; i<np_i; ++i) {
-                sp->P[i]  = new double*[np_j];
-                sp->PA[i] = new double*[np_j];
-                sp->PB[i] = new double*[np_j];
-
-                for (j=0; j<np_j; ++j) {
-                    sp->P[i][j]  = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PA[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                    sp->PB[i][j] = curr_stack_ptr; curr_stack_ptr += 3;
-                }
-            }
-
-            // All memory has been reserved/allocated for this shell primitive pair pair.
-            // Pre-compute all data that we can:
-            for (i=0; i<np_i; ++i) {
-                a1 = basis3()->shell(si)->exp(i);
-                c1 = basis3()->shell(si)->coef(i);
-
-                // Save some information
-                sp->ai[i] = a1;
-                sp->ci[i] = c1;
-
-                for (j=0; j<np_j; ++j) {
-                    a2 = basis4()->shell(sj)->exp(j);
-                    c2 = basis4()->shell(sj)->coef(j);
-
-                    gam = a1 + a2;
-
-                    // Compute some distances
-                    P = ( A * a1 + B * a2 ) / gam;
-                    PA = P - A;
-                    PB = P - B;
-
-                    // Copy data into pairs array
-                    sp->aj[j] = a2;
-                    sp->cj[j] = c2;
-                    sp->gamma[i][j] = gam;
-                    sp->P[i][j][0]  = P[0];  sp->P[i][j][1]  = P[1];  sp->P[i][j][2]  = P[2];
-                    sp->PA[i][j][0] = PA[0]; sp->PA[i][j][1] = PA[1]; sp->PA[i][j][2] = PA[2];
-                    sp->PB[i][j][0] = PB[0]; sp->PB[i][j][1] = PB[1]; sp->PB[i][j][2] = PB[2];
-                    sp->overlap[i][j] = pow(M_PI/gam, 3.0/2.0) * exp(-a1*a2*ab2/gam) * c1 * c2;
-                }
-            }
-        }
-    }
-#endif
-}
-
-void TwoElectronInt::free_shell_pairs12() {
-    int i, si, sj;
-    ShellPair *sp;
-    int np_i;
-
-    if (!use_shell_pairs_) return;
-
-    delete[] stack12_;
-    for (si = 0; si < basis1()->nshell(); ++si) {
-        for (sj = 0; sj < basis2()->nshell(); ++sj) {
-            np_i = basis1()->shell(si).nprimitive();
-            sp = &(pairs12_[si][sj]);
+ShellPairTable::~ShellPairTable() {
+    for (int si = 0; si < bs1_->nshell(); ++si) {
+        int np_i = bs1_->shell(si).nprimitive();
+        for (int sj = 0; sj < nshell2_; ++sj) {
+            ShellPair *sp = &(pairs_[(size_t)si * nshell2_ + sj]);
 
             delete[] sp->gamma;
             delete[] sp->overlap;
-
-            if (sp->P != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->P[i];
-                delete[] sp->P;
-            }
-            if (sp->PA != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PA[i];
-                delete[] sp->PA;
-            }
-            if (sp->PB != nullptr) {
-                for (i = 0; i < np_i; ++i) delete[] sp->PB[i];
-                delete[] sp->PB;
+            delete[] sp->bound;
+            for (int i = 0; i < np_i; ++i) {
+                delete[] sp->P[i];
+                delete[] sp->PA[i];
+                delete[] sp->PB[i];
             }
+            delete[] sp->P;
+            delete[] sp->PA;
+            delete[] sp->PB;
         }
     }
-
-    for (si = 0; si < basis1()->nshell(); ++si) delete[] pairs12_[si];
-    delete[] pairs12_;
 }
 
-void TwoElectronInt::free_shell_pairs34() {}
+std::shared_ptr<const ShellPairTable> ShellPairTable::get(std::shared_ptr<BasisSet> bs1, std::shared_ptr<BasisSet> bs2) {
+    // A live table holds its basis sets, so the raw pointers in the key
+    // cannot be recycled while the entry can still be locked
+    static std::map<std::pair<const BasisSet *, const BasisSet *>, std::weak_ptr<const ShellPairTable>> cache;
+    static std::mutex cache_mutex;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    auto &entry = cache[std::make_pair(bs1.get(), bs2.get())];
+    std::shared_ptr<const ShellPairTable> data = entry.lock();
+    if (!data) {
+        data = std::make_shared<const ShellPairTable>(bs1, bs2);
+        entry = data;
+    }
+    return data;
+}
 
-size_t TwoElectronInt::memory_to_store_shell_pairs(const std::shared_ptr<BasisSet> &bs1,
-                                                   const std::shared_ptr<BasisSet> &bs2) {
+size_t ShellPairTable::memory(const std::shared_ptr<BasisSet> &bs1, const std::shared_ptr<BasisSet> &bs2) {
     int i, j, np_i, np_j;
     size_t mem = 0;
 
@@ -2193,12 +2111,19 @@ size_t TwoElectronInt::memory_to_store_shell_pairs(const std::shared_ptr<BasisSe
         np_i = bs1->shell(i).nprimitive();
         for (j = 0; j < bs2->nshell(); ++j) {
             np_j = bs2->shell(j).nprimitive();
-            mem += (2 * (np_i + np_j) + 11 * np_i * np_j);
+            mem += (2 * (np_i + np_j) + 12 * np_i * np_j);
         }
     }
     return mem;
 }
 
+const ShellPairTable *TwoElectronInt::pair_data(const std::shared_ptr<BasisSet> &bsA,
+                                               const std::shared_ptr<BasisSet> &bsB) const {
+    for (const auto &data : pair_data_)
+        if (data->basis1() == bsA && data->basis2() == bsB) return data.get();
+    throw PSIEXCEPTION("TwoElectronInt: no shell pair data for this basis set ordering.");
+}
+
 size_t TwoElectronInt::compute_shell(const AOShellCombinationsIterator &shellIter) {
     return compute_shell(shellIter.p(), shellIter.q(), shellIter.r(), shellIter.s());
 }
@@ -2423,13 +2348,11 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
 
     // If we can, use the precomputed values found in ShellPair.
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        // 1234 -> 1234 no change
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        const ShellPair *p12 = pair_data(bs1_, bs2_)->pair(sh1, sh2);
+        const ShellPair *p34 = pair_data(bs3_, bs4_)->pair(sh3, sh4);
 
         nprim = fill_primitive_data(libint_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4, sh1 == sh2,
-                                    sh3 == sh4, 0);
+                                    sh3 == sh4, 0, fjt_scratch_.data(), prim_cutoff_);
     } else {
         const double *a1s = s1.exps();
         const double *a2s = s2.exps();
@@ -2560,7 +2483,10 @@ size_t TwoElectronInt::compute_quartet(int sh1, int sh2, int sh3, int sh4) {
 #endif
 
     // Compute the integral
-    if (am) {
+    if (nprim == 0) {
+        // Every primitive quartet was screened out
+        memset(source_, 0, sizeof(double) * size);
+    } else if (am) {
         double *target_ints;
 
         target_ints = build_eri[am1][am2][am3][am4](&libint_, nprim);
@@ -2787,12 +2713,11 @@ size_t TwoElectronInt::compute_quartet_deriv1(int sh1, int sh2, int sh3, int sh4
     nprim = 0;
 
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        const ShellPair *p12 = pair_data(bs1_, bs2_)->pair(sh1, sh2);
+        const ShellPair *p34 = pair_data(bs3_, bs4_)->pair(sh3, sh4);
 
         nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 1);
+                                    sh1 == sh2, sh3 == sh4, 1, fjt_scratch_.data());
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
@@ -3128,12 +3053,11 @@ size_t TwoElectronInt::compute_quartet_deriv2(int sh1, int sh2, int sh3, int sh4
 
     // prepare all the data needed for libderiv
     if (use_shell_pairs_) {
-        ShellPair *p12, *p34;
-        p12 = &(pairs12_[sh1][sh2]);
-        p34 = &(pairs34_[sh3][sh4]);
+        const ShellPair *p12 = pair_data(bs1_, bs2_)->pair(sh1, sh2);
+        const ShellPair *p34 = pair_data(bs3_, bs4_)->pair(sh3, sh4);
 
         nprim = fill_primitive_data(libderiv_.PrimQuartet, fjt_, p12, p34, am, nprim1, nprim2, nprim3, nprim4,
-                                    sh1 == sh2, sh3 == sh4, 2);
+                                    sh1 == sh2, sh3 == sh4, 2, fjt_scratch_.data());
     } else {
         for (int p1 = 0; p1 < nprim1; ++p1) {
             double a1 = s1.exp(p1);
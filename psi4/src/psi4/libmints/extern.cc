@@ -32,19 +32,482 @@
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/potential.h"
+#include "psi4/libmints/overlap.h"
+#include "psi4/libmints/multipoles.h"
+#include "psi4/libmints/electricfield.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/physconst.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
 namespace psi {
 
-ExternalPotential::ExternalPotential() : debug_(0), print_(1) {}
+namespace {
+
+/// Octree cell over the point charges, with the charge multipoles about its center
+struct ChargeCell {
+    double center[3];
+    double radius;
+    /// Range of the cell's charges in the octree order
+    int begin;
+    int end;
+    std::vector<int> children;
+    double Q0;
+    double Q1[3];
+    /// Second moments, xx xy xz yy yz zz
+    double Q2[6];
+};
+
+class ChargeOctree {
+    double **Zxyz_;
+    std::vector<int> order_;
+    std::vector<ChargeCell> cells_;
+
+    static const int leaf_size_ = 16;
+    static const int max_depth_ = 20;
+
+    int build(int begin, int end, int depth) {
+        ChargeCell cell;
+        double lo[3], hi[3];
+        for (int k = 0; k < 3; k++) lo[k] = hi[k] = Zxyz_[order_[begin]][k + 1];
+        for (int n = begin; n < end; n++) {
+            for (int k = 0; k < 3; k++) {
+                lo[k] = std::min(lo[k], Zxyz_[order_[n]][k + 1]);
+                hi[k] = std::max(hi[k], Zxyz_[order_[n]][k + 1]);
+            }
+        }
+        for (int k = 0; k < 3; k++) cell.center[k] = 0.5 * (lo[k] + hi[k]);
+        cell.begin = begin;
+        cell.end = end;
+        cell.radius = 0.0;
+        cell.Q0 = 0.0;
+        std::fill(cell.Q1, cell.Q1 + 3, 0.0);
+        std::fill(cell.Q2, cell.Q2 + 6, 0.0);
+        for (int n = begin; n < end; n++) {
+            const double *q = Zxyz_[order_[n]];
+            double s[3] = {q[1] - cell.center[0], q[2] - cell.center[1], q[3] - cell.center[2]};
+            cell.radius = std::max(cell.radius, std::sqrt(s[0] * s[0] + s[1] * s[1] + s[2] * s[2]));
+            cell.Q0 += q[0];
+            for (int k = 0; k < 3; k++) cell.Q1[k] += q[0] * s[k];
+            cell.Q2[0] += q[0] * s[0] * s[0];
+            cell.Q2[1] += q[0] * s[0] * s[1];
+            cell.Q2[2] += q[0] * s[0] * s[2];
+            cell.Q2[3] += q[0] * s[1] * s[1];
+            cell.Q2[4] += q[0] * s[1] * s[2];
+            cell.Q2[5] += q[0] * s[2] * s[2];
+        }
+        int index = cells_.size();
+        cells_.push_back(cell);
+        if (end - begin <= leaf_size_ || depth >= max_depth_) return index;
+
+        const double *c = cells_[index].center;
+        auto octant = [&](int i) {
+            return (Zxyz_[i][1] > c[0] ? 1 : 0) + (Zxyz_[i][2] > c[1] ? 2 : 0) + (Zxyz_[i][3] > c[2] ? 4 : 0);
+        };
+        std::sort(order_.begin() + begin, order_.begin() + end, [&](int a, int b) { return octant(a) < octant(b); });
+        for (int first = begin; first < end;) {
+            int last = first;
+            int oct = octant(order_[first]);
+            while (last < end && octant(order_[last]) == oct) last++;
+            int child = build(first, last, depth + 1);
+            cells_[index].children.push_back(child);
+            first = last;
+        }
+        return index;
+    }
+
+   public:
+    ChargeOctree(SharedMatrix Zxyz) : Zxyz_(Zxyz->pointer()), order_(Zxyz->rowspi()[0]) {
+        for (size_t i = 0; i < order_.size(); i++) order_[i] = i;
+        if (order_.size()) build(0, order_.size(), 0);
+    }
+
+    const std::vector<ChargeCell> &cells() const { return cells_; }
+    const std::vector<int> &order() const { return order_; }
+};
+
+/// The shell pairs of one atom pair, with the center and extent of their product distributions
+struct PairTarget {
+    int A;
+    int B;
+    double center[3];
+    double radius;
+};
+
+/// Atom pairs whose product distributions survive screening; a target holds shells P on A and Q on B (Q <= P if A == B)
+std::vector<PairTarget> build_targets(std::shared_ptr<BasisSet> basis) {
+    // exp(-gamma r^2) beyond this is treated as no density
+    const double tail = -std::log(1.0E-12);
+    std::vector<PairTarget> targets;
+    int natom = basis->molecule()->natom();
+    for (int A = 0; A < natom; A++) {
+        if (!basis->nshell_on_center(A)) continue;
+        const double *RA = basis->shell(basis->shell_on_center(A, 0)).center();
+        for (int B = 0; B <= A; B++) {
+            if (!basis->nshell_on_center(B)) continue;
+            const double *RB = basis->shell(basis->shell_on_center(B, 0)).center();
+            PairTarget t;
+            t.A = A;
+            t.B = B;
+            for (int k = 0; k < 3; k++) t.center[k] = 0.5 * (RA[k] + RB[k]);
+            double AB2 = (RA[0] - RB[0]) * (RA[0] - RB[0]) + (RA[1] - RB[1]) * (RA[1] - RB[1]) +
+                         (RA[2] - RB[2]) * (RA[2] - RB[2]);
+            t.radius = -1.0;
+            for (int i = 0; i < basis->nshell_on_center(A); i++) {
+                const GaussianShell &sP = basis->shell(basis->shell_on_center(A, i));
+                for (int j = 0; j < basis->nshell_on_center(B); j++) {
+                    const GaussianShell &sQ = basis->shell(basis->shell_on_center(B, j));
+                    for (int p = 0; p < sP.nprimitive(); p++) {
+                        for (int q = 0; q < sQ.nprimitive(); q++) {
+                            double a = sP.exp(p);
+                            double b = sQ.exp(q);
+                            double gamma = a + b;
+                            if (a * b * AB2 / gamma > tail) continue;
+                            double dist = 0.0;
+                            for (int k = 0; k < 3; k++) {
+                                double Pk = (a * RA[k] + b * RB[k]) / gamma;
+                                dist += (Pk - t.center[k]) * (Pk - t.center[k]);
+                            }
+                            t.radius = std::max(t.radius, std::sqrt(dist) + std::sqrt(tail / gamma));
+                        }
+                    }
+                }
+            }
+            if (t.radius >= 0.0) targets.push_back(t);
+        }
+    }
+    return targets;
+}
+
+/// Charges within cutoff of the target are exact; beyond it a cell is used whole if it is small enough on
+/// the scale of its distance, otherwise its charges are expanded one by one
+void split_sources(const ChargeOctree &tree, double **Zxyzp, const PairTarget &t, double cutoff, double theta,
+                   std::vector<int> &near, std::vector<int> &far_cells, std::vector<int> &far_charges) {
+    near.clear();
+    far_cells.clear();
+    far_charges.clear();
+    const std::vector<ChargeCell> &cells = tree.cells();
+    const std::vector<int> &order = tree.order();
+    if (cells.empty()) return;
+    std::vector<int> stack(1, 0);
+    while (!stack.empty()) {
+        const ChargeCell &cell = cells[stack.back()];
+        int index = stack.back();
+        stack.pop_back();
+        double d = std::sqrt((cell.center[0] - t.center[0]) * (cell.center[0] - t.center[0]) +
+                             (cell.center[1] - t.center[1]) * (cell.center[1] - t.center[1]) +
+                             (cell.center[2] - t.center[2]) * (cell.center[2] - t.center[2]));
+        if (d - cell.radius - t.radius > cutoff && cell.radius + t.radius < theta * d) {
+            far_cells.push_back(index);
+        } else if (cell.children.empty()) {
+            for (int n = cell.begin; n < cell.end; n++) {
+                const double *q = Zxyzp[order[n]];
+                double di = std::sqrt((q[1] - t.center[0]) * (q[1] - t.center[0]) +
+                                      (q[2] - t.center[1]) * (q[2] - t.center[1]) +
+                                      (q[3] - t.center[2]) * (q[3] - t.center[2]));
+                if (di - t.radius > cutoff)
+                    far_charges.push_back(order[n]);
+                else
+                    near.push_back(order[n]);
+            }
+        } else {
+            stack.insert(stack.end(), cell.children.begin(), cell.children.end());
+        }
+    }
+}
+
+/// 1/R and its first two derivatives (xx xy xz yy yz zz) at R
+void interaction_tensors(const double *R, double &T0, double *T1, double *T2) {
+    double R2 = R[0] * R[0] + R[1] * R[1] + R[2] * R[2];
+    double R1 = std::sqrt(R2);
+    T0 = 1.0 / R1;
+    double oR3 = T0 / R2;
+    double oR5 = oR3 / R2;
+    for (int k = 0; k < 3; k++) T1[k] = -R[k] * oR3;
+    T2[0] = (3.0 * R[0] * R[0] - R2) * oR5;
+    T2[1] = 3.0 * R[0] * R[1] * oR5;
+    T2[2] = 3.0 * R[0] * R[2] * oR5;
+    T2[3] = (3.0 * R[1] * R[1] - R2) * oR5;
+    T2[4] = 3.0 * R[1] * R[2] * oR5;
+    T2[5] = (3.0 * R[2] * R[2] - R2) * oR5;
+}
+
+/// T2 (symmetric, packed) times v
+void packed_mult(const double *T2, const double *v, double *out) {
+    out[0] = T2[0] * v[0] + T2[1] * v[1] + T2[2] * v[2];
+    out[1] = T2[1] * v[0] + T2[3] * v[1] + T2[4] * v[2];
+    out[2] = T2[2] * v[0] + T2[4] * v[1] + T2[5] * v[2];
+}
+
+/// Full contraction of two packed symmetric tensors
+double packed_dot(const double *X, const double *Y) {
+    return X[0] * Y[0] + X[3] * Y[3] + X[5] * Y[5] + 2.0 * (X[1] * Y[1] + X[2] * Y[2] + X[4] * Y[4]);
+}
+
+/**
+ * Adds the Taylor coefficients about c (potential, gradient, packed Hessian) of a source with charge
+ * multipoles Q about n, truncated so that source and target ranks sum to at most two
+ */
+void add_local(const double *n, const double *c, double Q0, const double *Q1, const double *Q2, double &phi, double *g,
+               double *H) {
+    double R[3] = {n[0] - c[0], n[1] - c[1], n[2] - c[2]};
+    double T0, T1[3], T2[6];
+    interaction_tensors(R, T0, T1, T2);
+    phi += Q0 * T0;
+    for (int k = 0; k < 3; k++) g[k] -= Q0 * T1[k];
+    for (int k = 0; k < 6; k++) H[k] += Q0 * T2[k];
+    if (Q1) {
+        double TQ[3];
+        packed_mult(T2, Q1, TQ);
+        phi += T1[0] * Q1[0] + T1[1] * Q1[1] + T1[2] * Q1[2] + 0.5 * packed_dot(T2, Q2);
+        for (int k = 0; k < 3; k++) g[k] -= TQ[k];
+    }
+}
+
+/// Potential matrix of the point charges, exact within cutoff of each shell pair and multipole-expanded beyond it
+SharedMatrix partitioned_potential(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz, double cutoff, double theta) {
+    int n = basis->nbf();
+    auto V = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+    double **Vp = V->pointer();
+    double **Zxyzp = Zxyz->pointer();
+
+    ChargeOctree tree(Zxyz);
+    const std::vector<ChargeCell> &cells = tree.cells();
+    std::vector<PairTarget> targets = build_targets(basis);
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = Process::environment.get_n_threads();
+#endif
+
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<PotentialInt> > Vint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Sint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Mint;
+    for (int t = 0; t < threads; t++) {
+        Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
+        Sint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap()));
+        Mint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(2)));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (size_t T = 0; T < targets.size(); T++) {
+        const PairTarget &t = targets[T];
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        std::vector<int> near, far_cells, far_charges;
+        split_sources(tree, Zxyzp, t, cutoff, theta, near, far_cells, far_charges);
+
+        if (near.size()) {
+            auto field = std::make_shared<Matrix>("Near Charges (Z,x,y,z)", near.size(), 4);
+            for (size_t i = 0; i < near.size(); i++) ::memcpy(field->pointer()[i], Zxyzp[near[i]], 4 * sizeof(double));
+            Vint[thread]->set_charge_field(field);
+        }
+
+        double phi = 0.0, g[3] = {0.0, 0.0, 0.0}, H[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        for (int c : far_cells) add_local(cells[c].center, t.center, cells[c].Q0, cells[c].Q1, cells[c].Q2, phi, g, H);
+        for (int i : far_charges) add_local(&Zxyzp[i][1], t.center, Zxyzp[i][0], nullptr, nullptr, phi, g, H);
+        bool far = far_cells.size() || far_charges.size();
+        if (far) Mint[thread]->set_origin(Vector3(t.center[0], t.center[1], t.center[2]));
+
+        for (int i = 0; i < basis->nshell_on_center(t.A); i++) {
+            int P = basis->shell_on_center(t.A, i);
+            int nj = (t.A == t.B ? i + 1 : basis->nshell_on_center(t.B));
+            for (int j = 0; j < nj; j++) {
+                int Q = basis->shell_on_center(t.B, j);
+                int nP = basis->shell(P).nfunction();
+                int oP = basis->shell(P).function_index();
+                int nQ = basis->shell(Q).nfunction();
+                int oQ = basis->shell(Q).function_index();
+                int nPQ = nP * nQ;
+                std::vector<double> block(nPQ, 0.0);
+
+                if (near.size()) {
+                    Vint[thread]->compute_shell(P, Q);
+                    const double *buffer = Vint[thread]->buffer();
+                    for (int pq = 0; pq < nPQ; pq++) block[pq] += buffer[pq];
+                }
+                if (far) {
+                    // V = -(phi S + g.d + 1/2 H:Q) with d, Q the moments about the center; the
+                    // multipole integrals carry the electron sign already
+                    Sint[thread]->compute_shell(P, Q);
+                    const double *S = Sint[thread]->buffer();
+                    for (int pq = 0; pq < nPQ; pq++) block[pq] -= phi * S[pq];
+                    Mint[thread]->compute_shell(P, Q);
+                    const double *M = Mint[thread]->buffer();
+                    for (int pq = 0; pq < nPQ; pq++) {
+                        double m2[6];
+                        for (int k = 0; k < 6; k++) m2[k] = M[(3 + k) * nPQ + pq];
+                        block[pq] += g[0] * M[pq] + g[1] * M[nPQ + pq] + g[2] * M[2 * nPQ + pq] + 0.5 * packed_dot(H, m2);
+                    }
+                }
+
+                for (int p = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++) {
+                        Vp[p + oP][q + oQ] = Vp[q + oQ][p + oP] = block[p * nQ + q];
+                    }
+                }
+            }
+        }
+    }
+
+    return V;
+}
+
+/// Electronic gradient on the point charges, partitioned as in partitioned_potential; the charges near a
+/// target take the exact electric field of its density, the far ones the field of its charge and dipole
+SharedMatrix partitioned_charge_gradient(std::shared_ptr<BasisSet> basis, SharedMatrix Zxyz, SharedMatrix Dt,
+                                         double cutoff, double theta) {
+    int ncharge = Zxyz->rowspi()[0];
+    double **Zxyzp = Zxyz->pointer();
+    double **Dp = Dt->pointer();
+
+    ChargeOctree tree(Zxyz);
+    const std::vector<ChargeCell> &cells = tree.cells();
+    const std::vector<int> &order = tree.order();
+    std::vector<PairTarget> targets = build_targets(basis);
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = Process::environment.get_n_threads();
+#endif
+
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<OneBodyAOInt> > Sint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Mint;
+    std::vector<std::shared_ptr<OneBodyAOInt> > Fint;
+    std::vector<SharedMatrix> Gtemps;
+    // Per-thread cell locals: the gradient on a charge at s from its cell center is Z (L1 + L2 s)
+    std::vector<std::vector<double> > L1(threads, std::vector<double>(3 * cells.size(), 0.0));
+    std::vector<std::vector<double> > L2(threads, std::vector<double>(6 * cells.size(), 0.0));
+    for (int t = 0; t < threads; t++) {
+        Sint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_overlap()));
+        Mint.push_back(std::shared_ptr<OneBodyAOInt>(fact->ao_multipoles(1)));
+        Fint.push_back(std::shared_ptr<OneBodyAOInt>(fact->electric_field()));
+        Gtemps.push_back(std::make_shared<Matrix>("Charge Gradient", ncharge, 3));
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (size_t T = 0; T < targets.size(); T++) {
+        const PairTarget &t = targets[T];
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        std::vector<int> near, far_cells, far_charges;
+        split_sources(tree, Zxyzp, t, cutoff, theta, near, far_cells, far_charges);
+        double **Gp = Gtemps[thread]->pointer();
+
+        // Loop over the target's shell pairs, weighting off-diagonal blocks twice for D symmetry
+        auto for_pairs = [&](std::function<void(int, int, double)> body) {
+            for (int i = 0; i < basis->nshell_on_center(t.A); i++) {
+                int P = basis->shell_on_center(t.A, i);
+                int nj = (t.A == t.B ? i + 1 : basis->nshell_on_center(t.B));
+                for (int j = 0; j < nj; j++) {
+                    int Q = basis->shell_on_center(t.B, j);
+                    body(P, Q, P == Q ? 1.0 : 2.0);
+                }
+            }
+        };
+        auto contract = [&](int P, int Q, const double *buffer) {
+            int nP = basis->shell(P).nfunction();
+            int oP = basis->shell(P).function_index();
+            int nQ = basis->shell(Q).nfunction();
+            int oQ = basis->shell(Q).function_index();
+            double val = 0.0;
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) val += Dp[p + oP][q + oQ] * (*buffer++);
+            }
+            return val;
+        };
+
+        for (int i : near) {
+            Fint[thread]->set_origin(Vector3(Zxyzp[i][1], Zxyzp[i][2], Zxyzp[i][3]));
+            double E[3] = {0.0, 0.0, 0.0};
+            for_pairs([&](int P, int Q, double perm) {
+                Fint[thread]->compute_shell(P, Q);
+                const double *buffer = Fint[thread]->buffer();
+                int nPQ = basis->shell(P).nfunction() * basis->shell(Q).nfunction();
+                for (int k = 0; k < 3; k++) E[k] += perm * contract(P, Q, buffer + k * nPQ);
+            });
+            for (int k = 0; k < 3; k++) Gp[i][k] -= Zxyzp[i][0] * E[k];
+        }
+
+        if (far_cells.empty() && far_charges.empty()) continue;
+
+        // Electronic charge and dipole of the target about its center
+        double qe = 0.0, mue[3] = {0.0, 0.0, 0.0};
+        Mint[thread]->set_origin(Vector3(t.center[0], t.center[1], t.center[2]));
+        for_pairs([&](int P, int Q, double perm) {
+            Sint[thread]->compute_shell(P, Q);
+            qe -= perm * contract(P, Q, Sint[thread]->buffer());
+            Mint[thread]->compute_shell(P, Q);
+            const double *buffer = Mint[thread]->buffer();
+            int nPQ = basis->shell(P).nfunction() * basis->shell(Q).nfunction();
+            for (int k = 0; k < 3; k++) mue[k] += perm * contract(P, Q, buffer + k * nPQ);
+        });
+
+        auto local = [&](const double *n, double *l1, double *l2) {
+            double R[3] = {n[0] - t.center[0], n[1] - t.center[1], n[2] - t.center[2]};
+            double T0, T1[3], T2[6], Tmu[3];
+            interaction_tensors(R, T0, T1, T2);
+            packed_mult(T2, mue, Tmu);
+            for (int k = 0; k < 3; k++) l1[k] += qe * T1[k] - Tmu[k];
+            if (l2)
+                for (int k = 0; k < 6; k++) l2[k] += qe * T2[k];
+        };
+        for (int c : far_cells) local(cells[c].center, &L1[thread][3 * c], &L2[thread][6 * c]);
+        for (int i : far_charges) {
+            double l1[3] = {0.0, 0.0, 0.0};
+            local(&Zxyzp[i][1], l1, nullptr);
+            for (int k = 0; k < 3; k++) Gp[i][k] += Zxyzp[i][0] * l1[k];
+        }
+    }
+
+    auto grad = std::make_shared<Matrix>("External Charge Gradient", ncharge, 3);
+    for (int t = 0; t < threads; t++) grad->add(Gtemps[t]);
+
+    // Hand each cell's local expansion down to its charges
+    double **Gp = grad->pointer();
+    for (size_t c = 0; c < cells.size(); c++) {
+        double l1[3] = {0.0, 0.0, 0.0}, l2[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        bool any = false;
+        for (int t = 0; t < threads; t++) {
+            for (int k = 0; k < 3; k++) l1[k] += L1[t][3 * c + k];
+            for (int k = 0; k < 6; k++) l2[k] += L2[t][6 * c + k];
+        }
+        for (int k = 0; k < 3; k++) any = any || l1[k] != 0.0;
+        for (int k = 0; k < 6; k++) any = any || l2[k] != 0.0;
+        if (!any) continue;
+        for (int n = cells[c].begin; n < cells[c].end; n++) {
+            int i = order[n];
+            double s[3] = {Zxyzp[i][1] - cells[c].center[0], Zxyzp[i][2] - cells[c].center[1],
+                           Zxyzp[i][3] - cells[c].center[2]};
+            double l2s[3];
+            packed_mult(l2, s, l2s);
+            for (int k = 0; k < 3; k++) Gp[i][k] += Zxyzp[i][0] * (l1[k] + l2s[k]);
+        }
+    }
+
+    return grad;
+}
+
+}  // namespace
+
+ExternalPotential::ExternalPotential() : debug_(0), print_(1), far_cutoff_(0.0), far_theta_(0.3) {}
 
 ExternalPotential::~ExternalPotential() {}
 
@@ -92,16 +555,9 @@ void ExternalPotential::print(std::string out) const {
     }
 }
 
-SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet> basis) {
-    int n = basis->nbf();
-    auto V = std::make_shared<Matrix>("External Potential", n, n);
-    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
-
+SharedMatrix ExternalPotential::charge_field(std::shared_ptr<Molecule> mol) const {
     double convfac = 1.0;
-    if (basis->molecule()->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
-
-    // Monopoles
-    auto V_charge = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+    if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
 
     auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
     double **Zxyzp = Zxyz->pointer();
@@ -111,14 +567,69 @@ SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet>
         Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
         Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
     }
+    return Zxyz;
+}
+
+SharedMatrix ExternalPotential::computePotentialMatrix(std::shared_ptr<BasisSet> basis) {
+    int n = basis->nbf();
+    auto V = std::make_shared<Matrix>("External Potential", n, n);
+    auto fact = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+
+    // Monopoles
+    SharedMatrix Zxyz = charge_field(basis->molecule());
+    if (far_cutoff_ > 0.0 && charges_.size()) {
+        V->add(partitioned_potential(basis, Zxyz, far_cutoff_, far_theta_));
+    } else {
+        auto V_charge = std::make_shared<Matrix>("External Potential (Charges)", n, n);
+
+        // Thread count
+        int threads = 1;
+#ifdef _OPENMP
+        threads = Process::environment.get_n_threads();
+#endif
+
+        std::vector<std::shared_ptr<PotentialInt> > Vint;
+        for (int t = 0; t < threads; t++) {
+            Vint.push_back(std::shared_ptr<PotentialInt>(static_cast<PotentialInt *>(fact->ao_potential())));
+            Vint[t]->set_charge_field(Zxyz);
+        }
+
+        // Lower Triangle; with many charges each pair is expensive, so spread them over threads
+        std::vector<std::pair<int, int> > PQ_pairs;
+        for (int P = 0; P < basis->nshell(); P++) {
+            for (int Q = 0; Q <= P; Q++) {
+                PQ_pairs.push_back(std::pair<int, int>(P, Q));
+            }
+        }
+
+        double **Vcp = V_charge->pointer();
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+        for (long int PQ = 0L; PQ < PQ_pairs.size(); PQ++) {
+            int P = PQ_pairs[PQ].first;
+            int Q = PQ_pairs[PQ].second;
+
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
 
-    std::shared_ptr<PotentialInt> pot(static_cast<PotentialInt *>(fact->ao_potential()));
-    pot->set_charge_field(Zxyz);
-    pot->compute(V_charge);
+            Vint[thread]->compute_shell(P, Q);
+            const double *buffer = Vint[thread]->buffer();
 
-    V->add(V_charge);
-    V_charge.reset();
-    pot.reset();
+            int nP = basis->shell(P).nfunction();
+            int oP = basis->shell(P).function_index();
+            int nQ = basis->shell(Q).nfunction();
+            int oQ = basis->shell(Q).function_index();
+
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) {
+                    Vcp[p + oP][q + oQ] = Vcp[q + oQ][p + oP] = (*buffer++);
+                }
+            }
+        }
+
+        V->add(V_charge);
+    }
 
     // Diffuse Bases
     for (size_t ind = 0; ind < bases_.size(); ind++) {
@@ -171,19 +682,9 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
     auto grad = std::make_shared<Matrix>("External Potential Gradient", natom, 3);
     double **Gp = grad->pointer();
 
-    auto Zxyz = std::make_shared<Matrix>("Charges (Z,x,y,z)", charges_.size(), 4);
+    SharedMatrix Zxyz = charge_field(mol);
     double **Zxyzp = Zxyz->pointer();
 
-    double convfac = 1.0;
-    if (mol->units() == Molecule::Angstrom) convfac /= pc_bohr2angstroms;
-
-    for (size_t i = 0; i < charges_.size(); i++) {
-        Zxyzp[i][0] = std::get<0>(charges_[i]);
-        Zxyzp[i][1] = convfac * std::get<1>(charges_[i]);
-        Zxyzp[i][2] = convfac * std::get<2>(charges_[i]);
-        Zxyzp[i][3] = convfac * std::get<3>(charges_[i]);
-    }
-
     // Start with the nuclear contribution
     grad->zero();
     for (int cen = 0; cen < natom; ++cen) {
@@ -303,6 +804,37 @@ SharedMatrix ExternalPotential::computePotentialGradients(std::shared_ptr<BasisS
 #endif
 }
 
+SharedMatrix ExternalPotential::computeChargeGradients(std::shared_ptr<BasisSet> basis, std::shared_ptr<Matrix> Dt) {
+    if (bases_.size()) throw PSIEXCEPTION("Gradients with blurred external charges are not implemented yet.");
+
+    SharedMolecule mol = basis->molecule();
+    SharedMatrix Zxyz = charge_field(mol);
+    double **Zxyzp = Zxyz->pointer();
+
+    // Without a far field every charge is inside the cutoff, so the electronic part is exact
+    double cutoff = (far_cutoff_ > 0.0 ? far_cutoff_ : std::numeric_limits<double>::max());
+    SharedMatrix grad = partitioned_charge_gradient(basis, Zxyz, Dt, cutoff, far_theta_);
+    grad->set_name("External Charge Gradient");
+    double **Gp = grad->pointer();
+
+    // Nuclear contribution
+    for (size_t i = 0; i < charges_.size(); i++) {
+        for (int A = 0; A < mol->natom(); A++) {
+            double x = Zxyzp[i][1] - mol->x(A);
+            double y = Zxyzp[i][2] - mol->y(A);
+            double z = Zxyzp[i][3] - mol->z(A);
+            double r2 = x * x + y * y + z * z;
+            double r = sqrt(r2);
+            double charge = Zxyzp[i][0] * mol->Z(A);
+            Gp[i][0] -= charge * x / (r * r2);
+            Gp[i][1] -= charge * y / (r * r2);
+            Gp[i][2] -= charge * z / (r * r2);
+        }
+    }
+
+    return grad;
+}
+
 double ExternalPotential::computeNuclearEnergy(std::shared_ptr<Molecule> mol) {
     double E = 0.0;
     double convfac = 1.0;
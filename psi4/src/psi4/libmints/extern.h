@@ -60,6 +60,14 @@ class ExternalPotential {
     /// Auxiliary basis sets (with accompanying molecules and coefs) of diffuse charges
     std::vector<std::pair<std::shared_ptr<BasisSet>, SharedVector> > bases_;
 
+    /// Charges further than this (bohr) from a shell pair are expanded in multipoles; <= 0 keeps all exact
+    double far_cutoff_;
+    /// Opening criterion for using an octree cell's multipoles rather than its individual charges
+    double far_theta_;
+
+    /// The point charges as a (Z,x,y,z) matrix in bohr
+    SharedMatrix charge_field(std::shared_ptr<Molecule> mol) const;
+
    public:
     /// Constructur, does nothing
     ExternalPotential();
@@ -81,6 +89,8 @@ class ExternalPotential {
     SharedMatrix computePotentialMatrix(std::shared_ptr<BasisSet> basis);
     /// Compute the gradients due to the external potential
     SharedMatrix computePotentialGradients(std::shared_ptr<BasisSet> basis, std::shared_ptr<Matrix> Dt);
+    /// Compute the gradient on the point charges (ncharge x 3) due to the electrons and nuclei of the basis molecule
+    SharedMatrix computeChargeGradients(std::shared_ptr<BasisSet> basis, std::shared_ptr<Matrix> Dt);
     /// Compute the contribution to the nuclear repulsion energy for the given molecule
     double computeNuclearEnergy(std::shared_ptr<Molecule> mol);
 
@@ -90,6 +100,12 @@ class ExternalPotential {
     /// Python print helper
     void py_print() const { print("outfile"); }
 
+    /// Couple charges beyond cutoff (bohr) of each shell pair through an octree multipole expansion
+    void set_far_field(double cutoff, double theta = 0.3) {
+        far_cutoff_ = cutoff;
+        far_theta_ = theta;
+    }
+
     /// Print flag
     void set_print(int print) { print_ = print; }
     /// Debug flag
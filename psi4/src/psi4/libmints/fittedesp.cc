@@ -0,0 +1,324 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libmints/fittedesp.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/electrostatic.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/sieve.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libmints/vector3.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/qt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+// R^(0)_tuv = d^t/dX^t d^u/dY^u d^v/dZ^v (1/R) for t + u + v <= L, by the McMurchie-Davidson
+// recursion with R^(n)_000 = (-1)^n (2n-1)!! / R^(2n+1) (the point-charge limit of the Boys function)
+void coulomb_derivatives(int L, double X, double Y, double Z, const std::vector<std::array<int, 3>>& powers,
+                         double* out, std::vector<double>& work) {
+    const int L1 = L + 1;
+    work.assign((size_t)L1 * L1 * L1 * L1, 0.0);
+    auto R = [&](int n, int t, int u, int v) -> double& { return work[((n * L1 + t) * L1 + u) * L1 + v]; };
+
+    double inv2 = 1.0 / (X * X + Y * Y + Z * Z);
+    double val = std::sqrt(inv2);
+    for (int n = 0; n <= L; n++) {
+        R(n, 0, 0, 0) = val;
+        val *= -(2 * n + 1) * inv2;
+    }
+    for (int n = L - 1; n >= 0; n--) {
+        for (int t = 0; t <= L - n; t++) {
+            for (int u = 0; u <= L - n - t; u++) {
+                for (int v = 0; v <= L - n - t - u; v++) {
+                    if (t > 0) {
+                        R(n, t, u, v) = (t > 1 ? (t - 1) * R(n + 1, t - 2, u, v) : 0.0) + X * R(n + 1, t - 1, u, v);
+                    } else if (u > 0) {
+                        R(n, t, u, v) = (u > 1 ? (u - 1) * R(n + 1, t, u - 2, v) : 0.0) + Y * R(n + 1, t, u - 1, v);
+                    } else if (v > 0) {
+                        R(n, t, u, v) = (v > 1 ? (v - 1) * R(n + 1, t, u, v - 2) : 0.0) + Z * R(n + 1, t, u, v - 1);
+                    }
+                }
+            }
+        }
+    }
+    size_t ncomp = (size_t)(L + 1) * (L + 2) * (L + 3) / 6;
+    for (size_t k = 0; k < ncomp; k++) out[k] = R(0, powers[k][0], powers[k][1], powers[k][2]);
+}
+
+}  // namespace
+
+FittedESP::FittedESP(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, double far_tolerance)
+    : primary_(primary), auxiliary_(auxiliary), far_tolerance_(far_tolerance) {
+    nthread_ = 1;
+#ifdef _OPENMP
+    nthread_ = Process::environment.get_n_threads();
+#endif
+
+    int lmax = auxiliary_->max_am();
+    for (int l = 0; l <= lmax; l++) {
+        for (int ii = 0; ii <= l; ii++) {
+            int lx = l - ii;
+            for (int lz = 0; lz <= ii; lz++) powers_.push_back({{lx, ii - lz, lz}});
+        }
+    }
+
+    // The multipole form of a Gaussian's potential is off by ~ (a R^2)^l exp(-a R^2); a zero
+    // tolerance keeps every atom in the near field, i.e. the plain fitted potential
+    int natom = auxiliary_->molecule()->natom();
+    atom_shells_.resize(natom);
+    lmax_.assign(natom, 0);
+    near_radius2_.assign(natom, 0.0);
+    double T = -std::log(far_tolerance_);
+    for (int P = 0; P < auxiliary_->nshell(); P++) {
+        const GaussianShell& shell = auxiliary_->shell(P);
+        int A = auxiliary_->shell_to_center(P);
+        atom_shells_[A].push_back(P);
+        lmax_[A] = std::max(lmax_[A], shell.am());
+        double amin = shell.exp(0);
+        for (int K = 1; K < shell.nprimitive(); K++) amin = std::min(amin, shell.exp(K));
+        double r2 = (far_tolerance_ > 0.0) ? (T + shell.am() * std::log(T)) / amin : std::numeric_limits<double>::max();
+        near_radius2_[A] = std::max(near_radius2_[A], r2);
+    }
+
+    auto factory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_,
+                                                     BasisSet::zero_ao_basis_set());
+    for (int thread = 0; thread < nthread_; thread++) {
+        ints_.push_back(std::shared_ptr<ElectrostaticInt>(static_cast<ElectrostaticInt*>(factory->electrostatic())));
+    }
+}
+FittedESP::~FittedESP() {}
+
+void FittedESP::fit(SharedMatrix D, double cutoff, double condition) {
+    int nbf = primary_->nbf();
+    int naux = auxiliary_->nbf();
+    int maxP = auxiliary_->max_function_per_shell();
+
+    // => (Q|mn) D_mn <= //
+
+    auto Ifact = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> ints;
+    for (int thread = 0; thread < nthread_; thread++) {
+        ints.push_back(std::shared_ptr<TwoBodyAOInt>(Ifact->eri()));
+    }
+
+    auto sieve = std::make_shared<ERISieve>(primary_, cutoff);
+    const std::vector<std::pair<int, int>>& pairs = sieve->shell_pairs();
+
+    auto c = std::make_shared<Vector>("c", naux);
+    double* cp = c->pointer();
+
+    auto Amn = std::make_shared<Matrix>("Amn", maxP, nbf * nbf);
+    double** Amnp = Amn->pointer();
+    double** Dp = D->pointer();
+
+    for (int P = 0; P < auxiliary_->nshell(); P++) {
+        int nP = auxiliary_->shell(P).nfunction();
+        int oP = auxiliary_->shell(P).function_index();
+
+        Amn->zero();
+
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+        for (size_t task = 0; task < pairs.size(); task++) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+
+            int M = pairs[task].first;
+            int N = pairs[task].second;
+
+            ints[thread]->compute_shell(P, 0, M, N);
+            const double* buffer = ints[thread]->buffer();
+
+            int nM = primary_->shell(M).nfunction();
+            int oM = primary_->shell(M).function_index();
+            int nN = primary_->shell(N).nfunction();
+            int oN = primary_->shell(N).function_index();
+
+            int index = 0;
+            for (int p = 0; p < nP; p++) {
+                for (int m = 0; m < nM; m++) {
+                    for (int n = 0; n < nN; n++) {
+                        Amnp[p][(m + oM) * nbf + (n + oN)] = Amnp[p][(n + oN) * nbf + (m + oM)] = buffer[index++];
+                    }
+                }
+            }
+        }
+
+        C_DGEMV('N', nP, nbf * nbf, 1.0, Amnp[0], nbf * nbf, Dp[0], 1, 0.0, cp + oP, 1);
+    }
+
+    Amn.reset();
+    ints.clear();
+
+    // => J^-1 <= //
+
+    auto J = std::make_shared<Matrix>("J", naux, naux);
+    double** Jp = J->pointer();
+
+    auto Jfact = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_,
+                                                   BasisSet::zero_ao_basis_set());
+    std::shared_ptr<TwoBodyAOInt> Jints(Jfact->eri());
+    const double* Jbuffer = Jints->buffer();
+
+    for (int P = 0; P < auxiliary_->nshell(); P++) {
+        int nP = auxiliary_->shell(P).nfunction();
+        int oP = auxiliary_->shell(P).function_index();
+        for (int Q = 0; Q <= P; Q++) {
+            int nQ = auxiliary_->shell(Q).nfunction();
+            int oQ = auxiliary_->shell(Q).function_index();
+
+            Jints->compute_shell(P, 0, Q, 0);
+
+            int index = 0;
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) {
+                    Jp[p + oP][q + oQ] = Jp[q + oQ][p + oP] = Jbuffer[index++];
+                }
+            }
+        }
+    }
+
+    J->power(-1.0, condition);
+
+    d_ = std::make_shared<Vector>("d", naux);
+    C_DGEMV('N', naux, naux, 1.0, Jp[0], naux, cp, 1, 0.0, d_->pointer(), 1);
+
+    build_moments();
+}
+
+void FittedESP::build_moments() {
+    std::shared_ptr<Molecule> mol = auxiliary_->molecule();
+    int natom = mol->natom();
+    int lmax = auxiliary_->max_am();
+    const double* dp = d_->pointer();
+
+    // Monopoles from the overlap with the unit function, higher moments from the multipole
+    // integrals (which carry the electron's negative sign)
+    auto factory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), auxiliary_,
+                                                     BasisSet::zero_ao_basis_set());
+    std::shared_ptr<OneBodyAOInt> sints(factory->ao_overlap());
+    std::shared_ptr<OneBodyAOInt> mints(lmax ? factory->ao_multipoles(lmax) : nullptr);
+
+    moments_.assign(natom, std::vector<double>());
+    for (int A = 0; A < natom; A++) {
+        int L = lmax_[A];
+        size_t ncomp = (size_t)(L + 1) * (L + 2) * (L + 3) / 6;
+        std::vector<double>& M = moments_[A];
+        M.assign(ncomp, 0.0);
+        if (mints) mints->set_origin(mol->xyz(A));
+
+        for (int P : atom_shells_[A]) {
+            int nP = auxiliary_->shell(P).nfunction();
+            int oP = auxiliary_->shell(P).function_index();
+
+            sints->compute_shell(P, 0);
+            const double* sbuffer = sints->buffer();
+            for (int p = 0; p < nP; p++) M[0] += dp[oP + p] * sbuffer[p];
+
+            if (!L) continue;
+            mints->compute_shell(P, 0);
+            const double* mbuffer = mints->buffer();
+            for (size_t k = 1; k < ncomp; k++) {
+                for (int p = 0; p < nP; p++) M[k] -= dp[oP + p] * mbuffer[(k - 1) * nP + p];
+            }
+        }
+
+        for (size_t k = 0; k < ncomp; k++) {
+            int i = powers_[k][0], j = powers_[k][1], l = powers_[k][2];
+            M[k] *= ((i + j + l) % 2 ? -1.0 : 1.0) / (factorial(i) * factorial(j) * factorial(l));
+        }
+    }
+}
+
+void FittedESP::compute(size_t npoints, const double* x, const double* y, const double* z, double* v, int thread) {
+    if (!d_) throw PSIEXCEPTION("FittedESP: call fit before compute.");
+
+    std::shared_ptr<Molecule> mol = auxiliary_->molecule();
+    int natom = mol->natom();
+    const double* dp = d_->pointer();
+    std::shared_ptr<ElectrostaticInt> ints = ints_[thread];
+    const double* buffer = ints->buffer();
+
+    std::vector<double> R(powers_.size());
+    std::vector<double> work;
+    size_t nnear = 0;
+    size_t nfar = 0;
+
+    for (size_t P = 0; P < npoints; P++) {
+        double Vp = 0.0;
+        for (int A = 0; A < natom; A++) {
+            if (atom_shells_[A].empty()) continue;
+            double X = x[P] - mol->x(A);
+            double Y = y[P] - mol->y(A);
+            double Z = z[P] - mol->z(A);
+
+            if (X * X + Y * Y + Z * Z < near_radius2_[A]) {
+                // Inside the Gaussians: analytic integrals (negative definite already)
+                Vector3 origin(x[P], y[P], z[P]);
+                for (int Q : atom_shells_[A]) {
+                    int nQ = auxiliary_->shell(Q).nfunction();
+                    int oQ = auxiliary_->shell(Q).function_index();
+                    ints->compute_shell(Q, 0, origin);
+                    for (int q = 0; q < nQ; q++) Vp += dp[oQ + q] * buffer[q];
+                }
+                nnear++;
+            } else {
+                const std::vector<double>& M = moments_[A];
+                coulomb_derivatives(lmax_[A], X, Y, Z, powers_, R.data(), work);
+                double phi = 0.0;
+                for (size_t k = 0; k < M.size(); k++) phi += M[k] * R[k];
+                Vp -= phi;
+                nfar++;
+            }
+        }
+        v[P] += Vp;
+    }
+
+#pragma omp atomic
+    nnear_ += nnear;
+#pragma omp atomic
+    nfar_ += nfar;
+}
+
+}  // namespace psi
@@ -0,0 +1,102 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_fittedesp_h_
+#define _psi_src_lib_libmints_fittedesp_h_
+
+#include "psi4/libmints/typedefs.h"
+#include "psi4/pragma.h"
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace psi {
+
+class BasisSet;
+class ElectrostaticInt;
+
+/*! \ingroup MINTS
+ *  \class FittedESP
+ *  \brief Electronic electrostatic potential of a density fitted to an auxiliary basis.
+ *
+ * The fitted density d_P = J^-1_PQ (Q|mn) D_mn is a sum of atom-centered Gaussians. Outside
+ * an atom's near-field radius its Gaussians no longer penetrate, and its part of the density
+ * acts exactly as a point multipole up to the highest angular momentum among its shells.
+ * Only points inside that radius need analytic potential integrals, and only over that
+ * atom's shells, so the cost per point is O(natom) instead of O(naux) integrals.
+ */
+class PSI_API FittedESP {
+   protected:
+    std::shared_ptr<BasisSet> primary_;
+    std::shared_ptr<BasisSet> auxiliary_;
+    /// Neglected Gaussian tail at which an atom is treated as a multipole
+    double far_tolerance_;
+    int nthread_;
+
+    /// Fitted coefficients
+    SharedVector d_;
+    /// Auxiliary shells per atom
+    std::vector<std::vector<int>> atom_shells_;
+    /// Multipole order per atom (highest am of its shells)
+    std::vector<int> lmax_;
+    /// Squared near-field radius per atom
+    std::vector<double> near_radius2_;
+    /// (-1)^(i+j+k) M_ijk / (i! j! k!) about each nucleus, in powers_ order
+    std::vector<std::vector<double>> moments_;
+    /// Cartesian powers, l = 0, 1, ... in the libmints component order
+    std::vector<std::array<int, 3>> powers_;
+    /// Per-thread analytic potential integrals
+    std::vector<std::shared_ptr<ElectrostaticInt>> ints_;
+
+    size_t nnear_ = 0;
+    size_t nfar_ = 0;
+
+    void build_moments();
+
+   public:
+    FittedESP(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary, double far_tolerance = 1.0E-10);
+    ~FittedESP();
+
+    /// Fit the total AO density D; Schwarz cutoff for the (Q|mn) integrals, condition for J^-1
+    void fit(SharedMatrix D, double cutoff, double condition);
+    /// Fitted coefficients
+    SharedVector coefficients() const { return d_; }
+
+    /// Add the electronic ESP at npoints points (bohr) to v. Safe to call concurrently as long
+    /// as each caller passes its own thread index, below the number of threads at construction.
+    void compute(size_t npoints, const double* x, const double* y, const double* z, double* v, int thread = 0);
+
+    /// Atom-point pairs evaluated analytically and as multipoles, since construction
+    size_t nnear() const { return nnear_; }
+    size_t nfar() const { return nfar_; }
+};
+
+}  // namespace psi
+
+#endif
@@ -62,6 +62,7 @@
 #include "psi4/psi4-dec.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace psi;
@@ -83,6 +84,13 @@ const double oon[] = {0.0,       1.0,       1.0 / 2.0, 1.0 / 3.0, 1.0 / 4.0,  1.
 Fjt::Fjt() {}
 Fjt::~Fjt() {}
 
+void Fjt::values(int J, const double *T, size_t n, double *out) {
+    for (size_t i = 0; i < n; ++i) {
+        const double *F = values(J, T[i]);
+        std::copy(F, F + J + 1, out + i * (J + 1));
+    }
+}
+
 double Taylor_Fjt::relative_zero_(1e-6);
 
 /*------------------------------------------------------
@@ -326,6 +334,63 @@ And then do downward recursion in j
     return F_;
 }
 
+/* Batched Taylor_Fjt::values(): the same interpolation and asymptotic
+ * formulas, but with the T loop innermost so the compiler can vectorize
+ * both branches (the grid lookup becomes a gather).
+ */
+void Taylor_Fjt::values(int l, const double *T, size_t n, double *out) {
+#if TAYLOR_INTERPOLATION_AND_RECURSION
+    Fjt::values(l, T, n, out);
+#else
+    const size_t ldF = l + 1;
+    const double Tcrit = T_crit_[l];
+
+    if (batch_h_.size() < n) {
+        batch_h_.resize(n);
+        batch_idx_.resize(n);
+    }
+    double *h = batch_h_.data();
+    int *idx = batch_idx_.data();
+
+    // Grid rows; T beyond T_crit is clamped here and overwritten below
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        const int T_ind = std::min((int)std::floor(0.5 + T[i] * oodelT_), max_T_);
+        idx[i] = T_ind;
+        h[i] = T_ind * delT_ - T[i];
+    }
+
+    /*--- Taylor interpolation ---*/
+    const double *grid0 = grid_[0];
+    const size_t ldgrid = max_m_ + 1;
+    for (int j = 0; j <= l; ++j) {
+#pragma omp simd
+        for (size_t i = 0; i < n; ++i) {
+            const double *F_row = grid0 + idx[i] * ldgrid + j;
+            double acc = F_row[TAYLOR_INTERPOLATION_ORDER];
+            for (int k = TAYLOR_INTERPOLATION_ORDER - 1; k >= 0; --k) acc = F_row[k] + oon[k + 1] * h[i] * acc;
+            out[i * ldF + j] = acc;
+        }
+    }
+
+    /*--- Asymptotic formula, c.f. IJQC 40 745 (1991) ---*/
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+        if (T[i] > Tcrit) {
+            const double X = 1.0 / (2.0 * T[i]);
+            const double Fj = M_SQRT_PI_2 * std::sqrt(X);
+            double dffac = 1.0;
+            double jfac = 1.0;
+            for (int j = 0; j <= l; ++j) {
+                out[i * ldF + j] = jfac * Fj;
+                jfac *= dffac * X;
+                dffac += 2.0;
+            }
+        }
+    }
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////////////
 
 /* Tablesize should always be at least 121. */
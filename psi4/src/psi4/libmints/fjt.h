@@ -56,6 +56,8 @@
 #ifndef _chemistry_qc_basis_fjt_h
 #define _chemistry_qc_basis_fjt_h
 
+#include <vector>
+
 namespace psi {
 
 class CorrelationFactor;
@@ -70,7 +72,12 @@ class Fjt {
         The values will be overwritten with the next call to this functions.
         The pointer will be invalidated after the call to ~Fjt. */
     virtual double* values(int J, double T) = 0;
+    /** Batched version of values(J, T): F_j(T[i]) for 0 <= j <= J goes to
+        out[i * (J + 1) + j]. The default implementation loops over values(). */
+    virtual void values(int J, const double* T, size_t n, double* out);
     virtual void set_rho(double /*rho*/) {}
+    /// Do the values depend on the last set_rho() call? Then T values with different rho cannot share a batch.
+    virtual bool rho_dependent() const { return false; }
 };
 
 #define TAYLOR_INTERPOLATION_ORDER 6
@@ -87,6 +94,8 @@ class Taylor_Fjt : public Fjt {
     virtual ~Taylor_Fjt();
     /// Implements Fjt::values()
     double* values(int J, double T);
+    /// Implements the batched Fjt::values(), vectorized over T
+    void values(int J, const double* T, size_t n, double* out);
 
    private:
     double** grid_;    /* Table of "exact" Fm(T) values. Row index corresponds to
@@ -104,6 +113,8 @@ class Taylor_Fjt : public Fjt {
                           for a given m and T_idx <= max_T_idx[m] use Taylor interpolation,
                           for a given m and T_idx > max_T_idx[m] use the asymptotic formula */
     double* F_;        /* Here computed values of Fj(T) are stored */
+    std::vector<double> batch_h_; /* Interpolation offsets for the batched values() */
+    std::vector<int> batch_idx_;  /* Interpolation grid rows for the batched values() */
 };
 
 /// "Old" intv3 code from Curt
@@ -126,6 +137,7 @@ class FJT : public Fjt {
     virtual ~FJT();
     /// implementation of Fjt::values()
     double* values(int J, double T);
+    using Fjt::values;
 };
 
 class GaussianFundamental : public Fjt {
@@ -139,7 +151,9 @@ class GaussianFundamental : public Fjt {
     virtual ~GaussianFundamental();
 
     virtual double* values(int J, double T) = 0;
+    using Fjt::values;
     void set_rho(double rho);
+    bool rho_dependent() const { return true; }
 };
 
 /**
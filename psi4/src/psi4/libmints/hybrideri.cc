@@ -0,0 +1,227 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+#include "psi4/libmints/hybrideri.h"
+#include "psi4/libmints/eri.h"
+#include "psi4/libmints/erd_eri.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/gshell.h"
+#ifdef USING_simint
+#include "psi4/libmints/siminteri.h"
+#endif
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+
+namespace psi {
+
+namespace {
+
+// Per-host tuning results: "<backends> <am1> <am2> <am3> <am4>" -> backend name.
+// Loaded from / appended to the scratch file once per process.
+std::map<std::string, std::string> tuning_table;
+bool tuning_table_loaded = false;
+std::mutex tuning_mutex;
+
+std::string tuning_file() {
+    char host[256] = "localhost";
+    gethostname(host, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    return PSIOManager::shared_object()->get_default_path() + "psi.eri_backend." + std::string(host) + ".dat";
+}
+
+// Seconds per compute_shell call for one quartet, over at least ~0.2 ms of work
+double time_quartet(TwoBodyAOInt &eri, int sh1, int sh2, int sh3, int sh4) {
+    eri.compute_shell(sh1, sh2, sh3, sh4);  // warm the caches
+    size_t ncall = 0;
+    double elapsed = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    do {
+        eri.compute_shell(sh1, sh2, sh3, sh4);
+        ncall++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 2.0E-4 && ncall < 64);
+    return elapsed / ncall;
+}
+
+}  // namespace
+
+HybridERI::HybridERI(const IntegralFactory *integral, int deriv, bool use_shell_pairs)
+    : TwoBodyAOInt(integral, deriv) {
+    if (deriv_ > 0) throw PSIEXCEPTION("HybridERI: derivative integrals are Libint only; use INTEGRAL_PACKAGE LIBINT.");
+
+    backends_.push_back(std::make_shared<ERI>(integral, deriv, use_shell_pairs));
+    names_.push_back("LIBINT");
+#ifdef USING_simint
+    // Simint refuses angular momenta it was not built for
+    try {
+        backends_.push_back(std::make_shared<SimintERI>(integral, deriv, use_shell_pairs));
+        names_.push_back("SIMINT");
+    } catch (const PsiException &) {
+    }
+#endif
+#ifdef USING_erd
+    backends_.push_back(std::make_shared<ERDERI>(integral, deriv, use_shell_pairs));
+    names_.push_back("ERD");
+#endif
+
+    int max_am = std::max(std::max(basis1()->max_am(), basis2()->max_am()),
+                          std::max(basis3()->max_am(), basis4()->max_am()));
+    nam_ = max_am + 1;
+
+    // Our own buffer: callers may keep the pointer from buffer() across calls
+    size_t size = INT_NCART(basis1()->max_am()) * INT_NCART(basis2()->max_am()) * INT_NCART(basis3()->max_am()) *
+                  INT_NCART(basis4()->max_am());
+    target_full_ = new double[size];
+    target_ = target_full_;
+
+    tune();
+
+    create_blocks();
+}
+
+HybridERI::~HybridERI() { delete[] target_full_; }
+
+void HybridERI::tune() {
+    choice_.assign(static_cast<size_t>(nam_) * nam_ * nam_ * nam_, 0);
+    if (backends_.size() == 1) return;
+
+    std::string set_name;
+    for (const auto &name : names_) set_name += (set_name.empty() ? "" : ",") + name;
+
+    // One representative shell per AM on each center
+    auto first_shells = [this](const std::shared_ptr<BasisSet> &bs) {
+        std::vector<int> first(nam_, -1);
+        for (int P = bs->nshell() - 1; P >= 0; --P) first[bs->shell(P).am()] = P;
+        return first;
+    };
+    std::vector<int> first1 = first_shells(basis1()), first2 = first_shells(basis2());
+    std::vector<int> first3 = first_shells(basis3()), first4 = first_shells(basis4());
+
+    std::lock_guard<std::mutex> lock(tuning_mutex);
+
+    const std::string file = tuning_file();
+    if (!tuning_table_loaded) {
+        std::ifstream in(file);
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string set, a1, a2, a3, a4, winner;
+            if (fields >> set >> a1 >> a2 >> a3 >> a4 >> winner)
+                tuning_table[set + " " + a1 + " " + a2 + " " + a3 + " " + a4] = winner;
+        }
+        tuning_table_loaded = true;
+    }
+
+    std::vector<std::string> tuned;
+    for (int am1 = 0; am1 < nam_; am1++) {
+        if (first1[am1] < 0) continue;
+        for (int am2 = 0; am2 < nam_; am2++) {
+            if (first2[am2] < 0) continue;
+            for (int am3 = 0; am3 < nam_; am3++) {
+                if (first3[am3] < 0) continue;
+                for (int am4 = 0; am4 < nam_; am4++) {
+                    if (first4[am4] < 0) continue;
+
+                    std::stringstream key;
+                    key << set_name << " " << am1 << " " << am2 << " " << am3 << " " << am4;
+                    auto it = tuning_table.find(key.str());
+                    if (it == tuning_table.end()) {
+                        double best = 0.0;
+                        std::string winner;
+                        for (size_t b = 0; b < backends_.size(); b++) {
+                            double t = time_quartet(*backends_[b], first1[am1], first2[am2], first3[am3], first4[am4]);
+                            if (winner.empty() || t < best) {
+                                best = t;
+                                winner = names_[b];
+                            }
+                        }
+                        it = tuning_table.insert(std::make_pair(key.str(), winner)).first;
+                        tuned.push_back(key.str() + " " + winner);
+                    }
+                    auto found = std::find(names_.begin(), names_.end(), it->second);
+                    choice_[am_index(am1, am2, am3, am4)] = (found == names_.end() ? 0 : found - names_.begin());
+                }
+            }
+        }
+    }
+
+    if (!tuned.empty()) {
+        std::ofstream out(file, std::ios::app);
+        for (const auto &line : tuned) out << line << "\n";
+    }
+}
+
+const std::string &HybridERI::backend(int am1, int am2, int am3, int am4) const {
+    return names_[choice_[am_index(am1, am2, am3, am4)]];
+}
+
+size_t HybridERI::compute_shell(const AOShellCombinationsIterator &shellIter) {
+    return compute_shell(shellIter.p(), shellIter.q(), shellIter.r(), shellIter.s());
+}
+
+size_t HybridERI::compute_shell(int sh1, int sh2, int sh3, int sh4) {
+    const GaussianShell &s1 = original_bs1_->shell(sh1);
+    const GaussianShell &s2 = original_bs2_->shell(sh2);
+    const GaussianShell &s3 = original_bs3_->shell(sh3);
+    const GaussianShell &s4 = original_bs4_->shell(sh4);
+
+    TwoBodyAOInt &eri = *backends_[choice_[am_index(s1.am(), s2.am(), s3.am(), s4.am())]];
+    eri.set_force_cartesian(force_cartesian_);
+
+    if (force_cartesian_)
+        curr_buff_size_ = s1.ncartesian() * s2.ncartesian() * s3.ncartesian() * s4.ncartesian();
+    else
+        curr_buff_size_ = s1.nfunction() * s2.nfunction() * s3.nfunction() * s4.nfunction();
+
+    size_t ncomputed = eri.compute_shell(sh1, sh2, sh3, sh4);
+    if (ncomputed)
+        std::copy(eri.buffer(), eri.buffer() + curr_buff_size_, target_full_);
+    else
+        std::fill(target_full_, target_full_ + curr_buff_size_, 0.0);
+    return ncomputed;
+}
+
+size_t HybridERI::compute_shell_deriv1(int, int, int, int) {
+    throw PSIEXCEPTION("HybridERI: derivative integrals are Libint only; use INTEGRAL_PACKAGE LIBINT.");
+}
+
+size_t HybridERI::compute_shell_deriv2(int, int, int, int) {
+    throw PSIEXCEPTION("HybridERI: derivative integrals are Libint only; use INTEGRAL_PACKAGE LIBINT.");
+}
+
+}  // namespace psi
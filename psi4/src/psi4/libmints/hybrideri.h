@@ -0,0 +1,86 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+#ifndef psi4_libmints_hybrideri_h_
+#define psi4_libmints_hybrideri_h_
+
+#include "psi4/libmints/twobody.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+class IntegralFactory;
+class AOShellCombinationsIterator;
+
+/*! \ingroup MINTS
+ *  \class HybridERI
+ *  \brief ERIs from whichever compiled-in backend is fastest for each AM class.
+ *
+ *  Libint is always available; Simint and ERD join when compiled in. The
+ *  first HybridERI for a set of basis sets times every backend on one
+ *  quartet of each AM class present and keeps the winner. Timings live in
+ *  a per-host table in the scratch directory, so later jobs on the same
+ *  machine skip the tuning. Selected with INTEGRAL_PACKAGE HYBRID.
+ */
+class HybridERI : public TwoBodyAOInt {
+    /// Candidate backends; entry 0 is always Libint
+    std::vector<std::shared_ptr<TwoBodyAOInt>> backends_;
+    /// Backend names, as in INTEGRAL_PACKAGE
+    std::vector<std::string> names_;
+    /// Backend per AM class, see am_index()
+    std::vector<int> choice_;
+    /// Highest AM + 1 over the four basis sets
+    int nam_;
+
+    size_t am_index(int am1, int am2, int am3, int am4) const {
+        return ((static_cast<size_t>(am1) * nam_ + am2) * nam_ + am3) * nam_ + am4;
+    }
+
+    /// Fill choice_, from the per-host table or by timing the backends
+    void tune();
+
+   public:
+    HybridERI(const IntegralFactory *integral, int deriv = 0, bool use_shell_pairs = false);
+    ~HybridERI() override;
+
+    size_t compute_shell(const AOShellCombinationsIterator &) override;
+    size_t compute_shell(int, int, int, int) override;
+    size_t compute_shell_deriv1(int, int, int, int) override;
+    size_t compute_shell_deriv2(int, int, int, int) override;
+
+    /// Name of the backend used for quartets of this AM class
+    const std::string &backend(int am1, int am2, int am3, int am4) const;
+};
+
+}  // namespace psi
+
+#endif  // psi4_libmints_hybrideri_h_
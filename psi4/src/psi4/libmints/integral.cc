@@ -50,6 +50,7 @@
 #include "psi4/libmints/ecpint.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libmints/erd_eri.h"
+#include "psi4/libmints/hybrideri.h"
 
 #ifdef USING_simint
 #include "psi4/libmints/siminteri.h"
@@ -218,6 +219,8 @@ TwoBodyAOInt* IntegralFactory::erd_eri(int deriv, bool use_shell_pairs) {
     if (deriv == 0 && Process::environment.options.get_str("INTEGRAL_PACKAGE") == "ERD")
         return new ERDERI(this, deriv, use_shell_pairs);
 #endif
+    if (deriv == 0 && Process::environment.options.get_str("INTEGRAL_PACKAGE") == "HYBRID")
+        return new HybridERI(this, deriv, use_shell_pairs);
     return eri(deriv, use_shell_pairs);
 }
 
@@ -230,6 +233,8 @@ TwoBodyAOInt* IntegralFactory::eri(int deriv, bool use_shell_pairs) {
     if (deriv == 0 && Process::environment.options.get_str("INTEGRAL_PACKAGE") == "ERD")
         return new ERDERI(this, deriv, use_shell_pairs);
 #endif
+    if (deriv == 0 && Process::environment.options.get_str("INTEGRAL_PACKAGE") == "HYBRID")
+        return new HybridERI(this, deriv, use_shell_pairs);
     return new ERI(this, deriv, use_shell_pairs);
 }
 
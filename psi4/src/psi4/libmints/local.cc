@@ -38,10 +38,42 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace psi;
 
 namespace psi {
 
+namespace {
+
+/// Round-robin (circle method) schedule over the orbitals in order: every pair appears exactly once, and the
+/// pairs within one round are disjoint, so their 2x2 rotations commute and can be applied concurrently
+std::vector<std::vector<std::pair<int, int> > > jacobi_rounds(const std::vector<int>& order) {
+    int n = order.size();
+    int m = n + (n % 2);
+    std::vector<int> slots(order);
+    if (m != n) slots.push_back(-1);
+
+    std::vector<std::vector<std::pair<int, int> > > rounds;
+    for (int r = 0; r < m - 1; r++) {
+        std::vector<std::pair<int, int> > round;
+        for (int k = 0; k < m / 2; k++) {
+            int i = slots[k];
+            int j = slots[m - 1 - k];
+            if (i < 0 || j < 0) continue;
+            round.push_back(std::pair<int, int>(i, j));
+        }
+        rounds.push_back(round);
+        // Hold slot 0 fixed and rotate the others
+        std::rotate(slots.begin() + 1, slots.end() - 1, slots.end());
+    }
+    return rounds;
+}
+
+}  // namespace
+
 Localizer::Localizer(std::shared_ptr<BasisSet> primary, std::shared_ptr<Matrix> C) : primary_(primary), C_(C) {
     if (C->nirrep() != 1) {
         throw PSIEXCEPTION("Localizer: C matrix is not C1");
@@ -215,7 +247,10 @@ void BoysLocalizer::localize() {
 
     // ==> Master Loop <== //
 
-    double Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
 
     for (int iter = 1; iter <= maxiter_; iter++) {
         // => Random Permutation <= //
@@ -232,38 +267,44 @@ void BoysLocalizer::localize() {
             order2.push_back(i2);
         }
 
-        // => Jacobi sweep <= //
+        // => Jacobi sweep, one round of disjoint pairs at a time <= //
 
-        for (int i2 = 0; i2 < nmo - 1; i2++) {
-            for (int j2 = i2 + 1; j2 < nmo; j2++) {
-                int i = order2[i2];
-                int j = order2[j2];
+        for (const auto& round : jacobi_rounds(order2)) {
+            int npair = round.size();
+            std::vector<double> abc(3L * npair);
+            std::vector<double> thetas(npair);
+            std::vector<char> breaks(npair, 0);
 
-                // > Compute the rotation < //
+            // > Compute the rotations < //
+
+            // A^k_ii, A^k_jj and A^k_ij are untouched by the other rotations of the round
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
 
                 // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
+                double a = 0.0;
+                double b = 0.0;
+                double c = 0.0;
                 for (int xyz = 0; xyz < 3; xyz++) {
                     double** Ak = Dp[xyz];
-                    Ad = (Ak[i][i] - Ak[j][j]);
-                    Ao = 2.0 * Ak[i][j];
+                    double Ad = (Ak[i][i] - Ak[j][j]);
+                    double Ao = 2.0 * Ak[i][j];
                     a += Ad * Ad;
                     b += Ao * Ao;
                     c += Ad * Ao;
                 }
 
                 // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
+                double Hd = a - b;
+                double Ho = 2.0 * c;
+                double theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
 
                 // Check for trivial (maximal) rotation, which might be better with theta = pi/4
                 if (std::fabs(theta) < 1.0E-8) {
                     double O0 = 0.0;
                     double O1 = 0.0;
-                    ;
                     for (int xyz = 0; xyz < 3; xyz++) {
                         double** Ak = Dp[xyz];
                         O0 += Ak[i][j] * Ak[i][j];
@@ -271,33 +312,53 @@ void BoysLocalizer::localize() {
                     }
                     if (O1 < O0) {
                         theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf("@Break\n");
-                        }
+                        breaks[p] = 1;
                     }
                 }
 
-                // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
+                thetas[p] = theta;
+                abc[3L * p + 0] = a;
+                abc[3L * p + 1] = b;
+                abc[3L * p + 2] = c;
+            }
 
-                if (debug_ > 3) {
-                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j, theta);
-                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
+            if (debug_ > 3) {
+                for (int p = 0; p < npair; p++) {
+                    if (breaks[p]) outfile->Printf("@Break\n");
+                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", round[p].first,
+                                    round[p].second, thetas[p]);
+                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", abc[3L * p + 0],
+                                    abc[3L * p + 1], abc[3L * p + 2]);
                 }
+            }
 
-                // > Apply the rotation < //
+            // > Apply the rotations < //
 
-                // rows and columns of A^k
+            // rows of A^k and Q, then columns of A^k (disjoint Givens rotations commute)
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
+                double cc = cos(thetas[p]);
+                double ss = sin(thetas[p]);
                 for (int xyz = 0; xyz < 3; xyz++) {
                     double** Ak = Dp[xyz];
                     C_DROT(nmo, &Ak[i][0], 1, &Ak[j][0], 1, cc, ss);
-                    C_DROT(nmo, &Ak[0][i], nmo, &Ak[0][j], nmo, cc, ss);
                 }
-
-                // Q
                 C_DROT(nmo, Up[i], 1, Up[j], 1, cc, ss);
             }
+
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
+                double cc = cos(thetas[p]);
+                double ss = sin(thetas[p]);
+                for (int xyz = 0; xyz < 3; xyz++) {
+                    double** Ak = Dp[xyz];
+                    C_DROT(nmo, &Ak[0][i], nmo, &Ak[0][j], nmo, cc, ss);
+                }
+            }
         }
 
         // => Metric <= //
@@ -375,14 +436,16 @@ void PMLocalizer::localize() {
 
     // => Pointers <= //
 
-    double** Lp = L_->pointer();
+    // Orbitals are held as rows so the per-atom populations and rotations run over contiguous memory
+    SharedMatrix Lt = L_->transpose();
+    double** Ltp = Lt->pointer();
     double** Up = U_->pointer();
 
     // => LS product (avoids GEMV) <= //
 
-    auto LS = std::make_shared<Matrix>("LS", nso, nmo);
-    double** LSp = LS->pointer();
-    C_DGEMM('N', 'N', nso, nmo, nso, 1.0, Sp[0], nso, Lp[0], nmo, 0.0, LSp[0], nmo);
+    auto LSt = std::make_shared<Matrix>("LS", nmo, nso);
+    double** LStp = LSt->pointer();
+    C_DGEMM('N', 'N', nmo, nso, nso, 1.0, Ltp[0], nso, Sp[0], nso, 0.0, LStp[0], nso);
 
     // => Starting functions on each atomic center <= //
 
@@ -407,7 +470,7 @@ void PMLocalizer::localize() {
         for (int A = 0; A < nA; A++) {
             int nm = Astarts[A + 1] - Astarts[A];
             int off = Astarts[A];
-            double PA = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
+            double PA = C_DDOT(nm, &LStp[i][off], 1, &Ltp[i][off], 1);
             metric += PA * PA;
         }
     }
@@ -419,7 +482,10 @@ void PMLocalizer::localize() {
 
     // ==> Master Loop <== //
 
-    double Aii, Ajj, Aij, Ad, Ao, a, b, c, Hd, Ho, theta, cc, ss;
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
 
     for (int iter = 1; iter <= maxiter_; iter++) {
         // => Random Permutation <= //
@@ -436,80 +502,84 @@ void PMLocalizer::localize() {
             order2.push_back(i2);
         }
 
-        // => Jacobi sweep <= //
+        // => Jacobi sweep, one round of disjoint pairs at a time <= //
 
-        for (int i2 = 0; i2 < nmo - 1; i2++) {
-            for (int j2 = i2 + 1; j2 < nmo; j2++) {
-                int i = order2[i2];
-                int j = order2[j2];
+        for (const auto& round : jacobi_rounds(order2)) {
+            int npair = round.size();
+            std::vector<double> abc(3L * npair);
+            std::vector<double> thetas(npair);
+            std::vector<char> breaks(npair, 0);
+
+            // Each pair only reads and rotates its own two orbitals, so the whole round runs concurrently
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+            for (int p = 0; p < npair; p++) {
+                int i = round[p].first;
+                int j = round[p].second;
 
                 // > Compute the rotation < //
 
                 // H elements
-                a = 0.0;
-                b = 0.0;
-                c = 0.0;
+                double a = 0.0;
+                double b = 0.0;
+                double c = 0.0;
+                double O0 = 0.0;
+                double O1 = 0.0;
                 for (int A = 0; A < nA; A++) {
                     int nm = Astarts[A + 1] - Astarts[A];
                     int off = Astarts[A];
-                    Aii = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
-                    Ajj = C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][j], nmo);
-                    Aij = 0.5 * C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][j], nmo) +
-                          0.5 * C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][i], nmo);
+                    double Aii = C_DDOT(nm, &LStp[i][off], 1, &Ltp[i][off], 1);
+                    double Ajj = C_DDOT(nm, &LStp[j][off], 1, &Ltp[j][off], 1);
+                    double Aij = 0.5 * C_DDOT(nm, &LStp[i][off], 1, &Ltp[j][off], 1) +
+                                 0.5 * C_DDOT(nm, &LStp[j][off], 1, &Ltp[i][off], 1);
 
-                    Ad = (Aii - Ajj);
-                    Ao = 2.0 * Aij;
+                    double Ad = (Aii - Ajj);
+                    double Ao = 2.0 * Aij;
                     a += Ad * Ad;
                     b += Ao * Ao;
                     c += Ad * Ao;
+                    O0 += Aij * Aij;
+                    O1 += 0.25 * (Ajj - Aii) * (Ajj - Aii);
                 }
 
                 // Theta
-                Hd = a - b;
-                Ho = 2.0 * c;
-                theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
+                double Hd = a - b;
+                double Ho = 2.0 * c;
+                double theta = 0.5 * atan2(Ho, Hd + sqrt(Hd * Hd + Ho * Ho));
 
                 // Check for trivial (maximal) rotation, which might be better with theta = pi/4
-                if (std::fabs(theta) < 1.0E-8) {
-                    double O0 = 0.0;
-                    double O1 = 0.0;
-                    ;
-                    for (int A = 0; A < nA; A++) {
-                        int nm = Astarts[A + 1] - Astarts[A];
-                        int off = Astarts[A];
-                        Aii = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
-                        Ajj = C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][j], nmo);
-                        Aij = 0.5 * C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][j], nmo) +
-                              0.5 * C_DDOT(nm, &LSp[off][j], nmo, &Lp[off][i], nmo);
-                        O0 += Aij * Aij;
-                        O1 += 0.25 * (Ajj - Aii) * (Ajj - Aii);
-                    }
-                    if (O1 < O0) {
-                        theta = M_PI / 4.0;
-                        if (debug_ > 3) {
-                            outfile->Printf("@Break\n");
-                        }
-                    }
+                if (std::fabs(theta) < 1.0E-8 && O1 < O0) {
+                    theta = M_PI / 4.0;
+                    breaks[p] = 1;
                 }
 
-                // Givens rotation
-                cc = cos(theta);
-                ss = sin(theta);
-
-                if (debug_ > 3) {
-                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", i, j, theta);
-                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", a, b, c);
-                }
+                thetas[p] = theta;
+                abc[3L * p + 0] = a;
+                abc[3L * p + 1] = b;
+                abc[3L * p + 2] = c;
 
                 // > Apply the rotation < //
 
-                // columns of LS and L
-                C_DROT(nso, &LSp[0][i], nmo, &LSp[0][j], nmo, cc, ss);
-                C_DROT(nso, &Lp[0][i], nmo, &Lp[0][j], nmo, cc, ss);
+                // Givens rotation
+                double cc = cos(theta);
+                double ss = sin(theta);
+
+                // orbitals of LS and L
+                C_DROT(nso, LStp[i], 1, LStp[j], 1, cc, ss);
+                C_DROT(nso, Ltp[i], 1, Ltp[j], 1, cc, ss);
 
                 // Q
                 C_DROT(nmo, Up[i], 1, Up[j], 1, cc, ss);
             }
+
+            if (debug_ > 3) {
+                for (int p = 0; p < npair; p++) {
+                    if (breaks[p]) outfile->Printf("@Break\n");
+                    outfile->Printf("@Rotation, i = %4d, j = %4d, Theta = %24.16E\n", round[p].first,
+                                    round[p].second, thetas[p]);
+                    outfile->Printf("@Info, a = %24.16E, b = %24.16E, c = %24.16E\n", abc[3L * p + 0],
+                                    abc[3L * p + 1], abc[3L * p + 2]);
+                }
+            }
         }
 
         // => Metric <= //
@@ -519,7 +589,7 @@ void PMLocalizer::localize() {
             for (int A = 0; A < nA; A++) {
                 int nm = Astarts[A + 1] - Astarts[A];
                 int off = Astarts[A];
-                double PA = C_DDOT(nm, &LSp[off][i], nmo, &Lp[off][i], nmo);
+                double PA = C_DDOT(nm, &LStp[i][off], 1, &Ltp[i][off], 1);
                 metric += PA * PA;
             }
         }
@@ -546,6 +616,7 @@ void PMLocalizer::localize() {
         outfile->Printf("    PM Localizer failed.\n\n");
     }
 
+    L_->copy(Lt->transpose());
     U_->transpose_this();
 }
 
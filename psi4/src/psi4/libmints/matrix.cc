@@ -42,6 +42,7 @@
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/matrix.h"
 #include "psi4/libmints/integral.h"
+#include "psi4/libmints/pool_allocator.h"
 #include "psi4/libdpd/dpd.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
@@ -242,9 +243,9 @@ Matrix::~Matrix() { release(); }
 
 /// allocate a block matrix -- analogous to libciomr's block_matrix
 double **Matrix::matrix(int nrow, int ncol) {
-    double **mat = (double **)malloc(sizeof(double *) * nrow);
+    double **mat = (double **)pool::allocate(sizeof(double *) * nrow);
     const size_t size = sizeof(double) * nrow * ncol;
-    mat[0] = (double *)malloc(size);
+    mat[0] = (double *)pool::allocate(size);
     ::memset((void *)mat[0], 0, size);
     for (int r = 1; r < nrow; ++r) mat[r] = mat[r - 1] + ncol;
     return mat;
@@ -252,8 +253,8 @@ double **Matrix::matrix(int nrow, int ncol) {
 
 /// free a (block) matrix -- analogous to libciomr's free_block
 void Matrix::free(double **Block) {
-    ::free(Block[0]);
-    ::free(Block);
+    pool::deallocate(Block[0]);
+    pool::deallocate(Block);
 }
 
 void Matrix::init(int l_nirreps, const int *l_rowspi, const int *l_colspi, const std::string &name, int symmetry) {
@@ -1315,9 +1316,24 @@ void Matrix::transform(const SharedMatrix &L, const SharedMatrix &F, const Share
         throw PSIEXCEPTION("Matrix::transformer(L, F, R): Target matrix does not have correct dimensions.");
 #endif
 
-    Matrix temp(nirrep_, F->rowspi_, R->colspi_, F->symmetry_ ^ R->symmetry_);
-    temp.gemm(false, false, 1.0, F, R, 0.0);
-    gemm(true, false, 1.0, L, temp, 0.0);
+    // Contract the cheaper pair first, counted over all irreps
+    double right_first = 0.0, left_first = 0.0;
+    for (int h = 0; h < nirrep_; ++h) {
+        int hr = h ^ F->symmetry_;
+        double lc = L->colspi_[h], fr = F->rowspi_[h], fc = F->colspi_[hr], rc = R->colspi_[hr];
+        right_first += fr * fc * rc + lc * fr * rc;
+        left_first += lc * fr * fc + lc * fc * rc;
+    }
+
+    if (left_first < right_first) {
+        Matrix temp(nirrep_, L->colspi_, F->colspi_, F->symmetry_);
+        temp.gemm(true, false, 1.0, L, F, 0.0);
+        gemm(false, false, 1.0, temp, R, 0.0);
+    } else {
+        Matrix temp(nirrep_, F->rowspi_, R->colspi_, F->symmetry_ ^ R->symmetry_);
+        temp.gemm(false, false, 1.0, F, R, 0.0);
+        gemm(true, false, 1.0, L, temp, 0.0);
+    }
 }
 
 void Matrix::back_transform(const Matrix *const a, const Matrix *const transformer) {
@@ -1478,6 +1494,23 @@ SharedMatrix Matrix::doublet(const SharedMatrix &A, const SharedMatrix &B, bool
 
 SharedMatrix Matrix::triplet(const SharedMatrix &A, const SharedMatrix &B, const SharedMatrix &C, bool transA,
                              bool transB, bool transC) {
+    // Pick (AB)C or A(BC) by flop count; the intermediate is freed back to the pool on return
+    const Dimension &m = (transA ? A->colspi() : A->rowspi());
+    const Dimension &k = (transA ? A->rowspi() : A->colspi());
+    const Dimension &l = (transB ? B->rowspi() : B->colspi());
+    const Dimension &n = (transC ? C->rowspi() : C->colspi());
+    double left_first = 0.0, right_first = 0.0;
+    if (m.n() == k.n() && k.n() == l.n() && l.n() == n.n()) {
+        for (int h = 0; h < m.n(); ++h) {
+            left_first += (double)m[h] * k[h] * l[h] + (double)m[h] * l[h] * n[h];
+            right_first += (double)k[h] * l[h] * n[h] + (double)m[h] * k[h] * n[h];
+        }
+    }
+
+    if (right_first < left_first) {
+        SharedMatrix T = Matrix::doublet(B, C, transB, transC);
+        return Matrix::doublet(A, T, transA, false);
+    }
     SharedMatrix T = Matrix::doublet(A, B, transA, transB);
     SharedMatrix S = Matrix::doublet(T, C, false, transC);
     return S;
@@ -1759,19 +1792,136 @@ double Matrix::vector_dot(const Matrix *const rhs) {
 
 double Matrix::vector_dot(const SharedMatrix &rhs) { return vector_dot(rhs.get()); }
 
+namespace {
+
+// Blocks at least this large with eigenvectors requested go through divide-and-conquer (DSYEVD), which is
+// several times faster than the QR-based DSYEV once the back-transformation dominates.
+constexpr int diag_dsyevd_min_dim = 64;
+// Irreps are only farmed out to threads when the total work (sum of n^3) is worth the fork.
+constexpr double diag_parallel_min_work = 64.0 * 64.0 * 64.0;
+
+// Diagonalizes one n x n symmetric block A.  Follows the sq_rsp conventions: nMatz is a diagonalize_order,
+// eigenvectors are returned in the columns of V, and A is left untouched.  V may alias A.  Returns the
+// LAPACK info code.
+int diagonalize_block(int n, double **A, double *w, int nMatz, double **V) {
+    bool vectors = (nMatz == ascending || nMatz == descending);
+    bool descend = (nMatz == evals_only_descending || nMatz == descending);
+
+    int info;
+    if (vectors) {
+        // LAPACK reads the symmetric matrix identically in row- or column-major order, so we work straight
+        // in V and transpose the (column-major) eigenvectors back into columns afterwards.
+        if (V[0] != A[0]) C_DCOPY(static_cast<size_t>(n) * n, A[0], 1, V[0], 1);
+        if (n >= diag_dsyevd_min_dim) {
+            int lwork = 1 + 6 * n + 2 * n * n;
+            int liwork = 3 + 5 * n;
+            std::vector<double> work(lwork);
+            std::vector<int> iwork(liwork);
+            info = C_DSYEVD('V', 'U', n, V[0], n, w, work.data(), lwork, iwork.data(), liwork);
+        } else {
+            int lwork = 3 * n;
+            std::vector<double> work(lwork);
+            info = C_DSYEV('V', 'U', n, V[0], n, w, work.data(), lwork);
+        }
+        for (int i = 0; i < n; ++i)
+            for (int j = 0; j < i; ++j) std::swap(V[i][j], V[j][i]);
+        if (descend) {
+            for (int i = 0; i < n; ++i) std::reverse(V[i], V[i] + n);
+        }
+    } else {
+        std::vector<double> T(static_cast<size_t>(n) * n);
+        C_DCOPY(static_cast<size_t>(n) * n, A[0], 1, T.data(), 1);
+        int lwork = 3 * n;
+        std::vector<double> work(lwork);
+        info = C_DSYEV('N', 'U', n, T.data(), n, w, work.data(), lwork);
+    }
+    if (descend) std::reverse(w, w + n);
+
+    return info;
+}
+
+// Diagonalizes every nonempty irrep block, running independent irreps concurrently (largest first) when
+// there is enough work to go around.
+void diagonalize_blocks(int nirrep, const Dimension &dim, double ***A, double **w, int nMatz, double ***V) {
+    std::vector<int> order;
+    double work = 0.0;
+    for (int h = 0; h < nirrep; ++h) {
+        if (dim[h]) {
+            order.push_back(h);
+            work += static_cast<double>(dim[h]) * dim[h] * dim[h];
+        }
+    }
+    std::sort(order.begin(), order.end(), [&dim](int a, int b) { return dim[a] > dim[b]; });
+
+    int nblock = order.size();
+    std::vector<int> info(nblock, 0);
+#pragma omp parallel for schedule(dynamic) if (nblock > 1 && work > diag_parallel_min_work)
+    for (int b = 0; b < nblock; ++b) {
+        int h = order[b];
+        info[b] = diagonalize_block(dim[h], A[h], w[h], nMatz, V[h]);
+    }
+
+    for (int b = 0; b < nblock; ++b) {
+        if (info[b]) {
+            throw PSIEXCEPTION("Matrix::diagonalize: LAPACK eigensolver failed in irrep " +
+                               std::to_string(order[b]) + " (info = " + std::to_string(info[b]) + ").");
+        }
+    }
+}
+
+}  // namespace
+
 void Matrix::diagonalize(Matrix *eigvectors, Vector *eigvalues, diagonalize_order nMatz) {
     if (symmetry_) {
         throw PSIEXCEPTION("Matrix::diagonalize: Matrix is non-totally symmetric.");
     }
-    int h;
-    for (h = 0; h < nirrep_; ++h) {
-        if (rowspi_[h]) {
-            sq_rsp(rowspi_[h], colspi_[h], matrix_[h], eigvalues->vector_[h], static_cast<int>(nMatz),
-                   eigvectors->matrix_[h], 1.0e-14);
+    diagonalize_blocks(nirrep_, rowspi_, matrix_, eigvalues->vector_.data(), static_cast<int>(nMatz),
+                       eigvectors->matrix_);
+}
+
+void Matrix::diagonalize_lowest(Matrix *eigvectors, Vector *eigvalues) {
+    if (symmetry_) {
+        throw PSIEXCEPTION("Matrix::diagonalize_lowest: Matrix is non-totally symmetric.");
+    }
+
+    for (int h = 0; h < nirrep_; ++h) {
+        int n = rowspi_[h];
+        int k = eigvectors->colspi()[h];
+        if (!n || !k) continue;
+        if (k > n || eigvectors->rowspi()[h] != n || eigvalues->dimpi()[h] < k) {
+            throw PSIEXCEPTION("Matrix::diagonalize_lowest: Eigenvector/eigenvalue dimensions do not match.");
+        }
+
+        // DSYEVR destroys its input, and the vectors come back column-major n x k.
+        std::vector<double> T(static_cast<size_t>(n) * n);
+        C_DCOPY(static_cast<size_t>(n) * n, matrix_[h][0], 1, T.data(), 1);
+        std::vector<double> Z(static_cast<size_t>(n) * k);
+        std::vector<int> isuppz(2 * n);
+
+        int m;
+        double lwork_query;
+        int liwork_query;
+        C_DSYEVR('V', 'I', 'U', n, T.data(), n, 0.0, 0.0, 1, k, 0.0, &m, eigvalues->pointer(h), Z.data(), n,
+                 isuppz.data(), &lwork_query, -1, &liwork_query, -1);
+        int lwork = static_cast<int>(lwork_query);
+        int liwork = liwork_query;
+        std::vector<double> work(lwork);
+        std::vector<int> iwork(liwork);
+        int info = C_DSYEVR('V', 'I', 'U', n, T.data(), n, 0.0, 0.0, 1, k, 0.0, &m, eigvalues->pointer(h), Z.data(),
+                            n, isuppz.data(), work.data(), lwork, iwork.data(), liwork);
+        if (info || m != k) {
+            throw PSIEXCEPTION("Matrix::diagonalize_lowest: DSYEVR failed in irrep " + std::to_string(h) + ".");
         }
+
+        double **Vp = eigvectors->matrix_[h];
+        for (int j = 0; j < k; ++j) C_DCOPY(n, &Z[static_cast<size_t>(j) * n], 1, &Vp[0][j], k);
     }
 }
 
+void Matrix::diagonalize_lowest(SharedMatrix &eigvectors, SharedVector &eigvalues) {
+    diagonalize_lowest(eigvectors.get(), eigvalues.get());
+}
+
 void Matrix::diagonalize(SharedMatrix &eigvectors, std::shared_ptr<Vector> &eigvalues, diagonalize_order nMatz) {
     diagonalize(eigvectors.get(), eigvalues.get(), nMatz);
 }
@@ -2760,22 +2910,24 @@ void Matrix::remove_symmetry(const SharedMatrix &a, const SharedMatrix &SO2AO) {
     }
 }
 
+// The temporaries below only need the right shape; gemm overwrites them (beta = 0)
+
 void Matrix::transform(const Matrix &transformer) {
-    Matrix temp(this);
+    Matrix temp(nirrep_, rowspi_, transformer.colspi(), symmetry_);
 
     temp.gemm(false, false, 1.0, *this, transformer, 0.0);
     gemm(true, false, 1.0, transformer, temp, 0.0);
 }
 
 void Matrix::back_transform(const Matrix &a, const Matrix &transformer) {
-    Matrix temp(a);
+    Matrix temp(a.nirrep(), a.rowspi(), transformer.rowspi(), a.symmetry());
 
     temp.gemm(false, true, 1.0, a, transformer, 0.0);
     gemm(false, false, 1.0, transformer, temp, 0.0);
 }
 
 void Matrix::back_transform(const Matrix &transformer) {
-    Matrix temp(this);
+    Matrix temp(nirrep_, rowspi_, transformer.rowspi(), symmetry_);
 
     temp.gemm(false, true, 1.0, *this, transformer, 0.0);
     gemm(false, false, 1.0, transformer, temp, 0.0);
@@ -2784,12 +2936,8 @@ void Matrix::back_transform(const Matrix &transformer) {
 double Matrix::vector_dot(const Matrix &rhs) { return vector_dot(&rhs); }
 
 void Matrix::diagonalize(Matrix &eigvectors, Vector &eigvalues, int nMatz) {
-    int h;
-    for (h = 0; h < nirrep_; ++h) {
-        if (rowspi_[h]) {
-            sq_rsp(rowspi_[h], colspi_[h], matrix_[h], eigvalues.vector_[h], nMatz, eigvectors.matrix_[h], 1.0e-14);
-        }
-    }
+    if ((nMatz > 3) || (nMatz < 0)) nMatz = 0;
+    diagonalize_blocks(nirrep_, rowspi_, matrix_, eigvalues.vector_.data(), nMatz, eigvectors.matrix_);
 }
 
 void Matrix::write_to_dpdfile2(dpdfile2 *outFile) {
@@ -820,6 +820,14 @@ class PSI_API Matrix : public std::enable_shared_from_this<Matrix> {
     void diagonalize(SharedMatrix& eigvectors, Vector& eigvalues, diagonalize_order nMatz = ascending);
     /// @}
 
+    /// @{
+    /// Computes only the lowest eigenpairs of each irrep block, in ascending order.  The number of pairs per irrep is
+    /// taken from eigvectors->colspi(); eigvectors (rowspi x k) and eigvalues must be created by caller.  Only for
+    /// symmetric matrices.
+    void diagonalize_lowest(Matrix* eigvectors, Vector* eigvalues);
+    void diagonalize_lowest(SharedMatrix& eigvectors, std::shared_ptr<Vector>& eigvalues);
+    /// @}
+
     /// @{
     /// Diagonalizes this, applying supplied metric, eigvectors and eigvalues must be created by caller.  Only for
     /// symmetric matrices.
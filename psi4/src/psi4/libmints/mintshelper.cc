@@ -35,6 +35,7 @@
 #include "psi4/psifiles.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libiwl/iwl.hpp"
+#include "psi4/libiwl/blocks.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libmints/sointegral_twobody.h"
 #include "psi4/libmints/petitelist.h"
@@ -46,6 +47,7 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <cmath>
@@ -116,6 +118,22 @@ class IWLWriter {
     size_t count() const { return count_; }
 };
 
+/**
+ * IWLBlockWriter functor for use with SO TEIs
+ **/
+class IWLBlockWriterFunctor {
+    IWLBlockWriter &writeto_;
+
+   public:
+    IWLBlockWriterFunctor(IWLBlockWriter &writeto) : writeto_(writeto) {}
+
+    void operator()(int i, int j, int k, int l, int, int, int, int, int, int, int, int, double value) {
+        writeto_.write_value(i, j, k, l, value);
+    }
+
+    size_t count() const { return writeto_.count(); }
+};
+
 MintsHelper::MintsHelper(std::shared_ptr<BasisSet> basis, Options &options, int print)
     : options_(options), print_(print) {
     init_helper(basis);
@@ -237,33 +255,50 @@ void MintsHelper::integrals() {
     // Compute one-electron integrals.
     one_electron_integrals();
 
-    // Open the IWL buffer where we will store the integrals.
-    IWL ERIOUT(psio_.get(), PSIF_SO_TEI, cutoff_, 0, 0);
-    IWLWriter writer(ERIOUT);
+    // Libtrans computes the two-electron integrals itself in this mode
+    if (Process::environment.options.get_str("SO_TEI_FORMAT") == "DIRECT") {
+        if (print_) outfile->Printf("      Two-electron integrals will be computed on the fly.\n\n");
+        return;
+    }
 
     // Let the user know what we're doing.
     if (print_) {
         outfile->Printf("      Computing two-electron integrals...");
     }
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) {
-        eri->compute_shell(shellIter, writer);
-    }
+    // Unique shell quartets are transformed in parallel; the writers still see them in iterator order
+    size_t count;
+    if (Process::environment.options.get_str("SO_TEI_FORMAT") == "BLOCKS") {
+        // Sorted, indexed integral blocks; IWL readers decode these transparently
+        IWLBlockWriter ERIOUT(psio_.get(), PSIF_SO_TEI, basisset_->nbf(), cutoff_,
+                              Process::environment.options.get_bool("SO_TEI_COMPRESS"));
+        IWLBlockWriterFunctor writer(ERIOUT);
+        eri->compute_integrals(writer);
+        ERIOUT.set_keep_flag(true);
+        ERIOUT.close();
+        count = writer.count();
+    } else {
+        // Open the IWL buffer where we will store the integrals.
+        IWL ERIOUT(psio_.get(), PSIF_SO_TEI, cutoff_, 0, 0);
+        IWLWriter writer(ERIOUT);
 
-    // Flush out buffers.
-    ERIOUT.flush(1);
+        eri->compute_integrals(writer);
 
-    // We just did all this work to create the file, let's keep it around
-    ERIOUT.set_keep_flag(true);
-    ERIOUT.close();
+        // Flush out buffers.
+        ERIOUT.flush(1);
+
+        // We just did all this work to create the file, let's keep it around
+        ERIOUT.set_keep_flag(true);
+        ERIOUT.close();
+        count = writer.count();
+    }
 
     if (print_) {
         outfile->Printf("done\n");
         outfile->Printf(
             "      Computed %lu non-zero two-electron integrals.\n"
             "        Stored in file %d.\n\n",
-            writer.count(), PSIF_SO_TEI);
+            count, PSIF_SO_TEI);
     }
 }
 
@@ -281,8 +316,7 @@ void MintsHelper::integrals_erf(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERF integrals (omega = %.3f)...", omega);
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    erf->compute_integrals(writer);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -313,8 +347,7 @@ void MintsHelper::integrals_erfc(double w) {
     // Let the user know what we're doing.
     outfile->Printf("      Computing non-zero ERFComplement integrals...");
 
-    SOShellCombinationsIterator shellIter(sobasis_, sobasis_, sobasis_, sobasis_);
-    for (shellIter.first(); shellIter.is_done() == false; shellIter.next()) erf->compute_shell(shellIter, writer);
+    erf->compute_integrals(writer);
 
     // Flush the buffers
     ERIOUT.flush(1);
@@ -366,6 +399,8 @@ void MintsHelper::one_electron_integrals() {
             throw PSIEXCEPTION("OEINTS: X2C requested, but relativistic basis was not set.");
         }
         X2CInt x2cint;
+        x2cint.set_dlu(options_.get_str("X2C_DECOUPLING") == "DLU");
+        x2cint.set_nthread(nthread_);
         SharedMatrix so_overlap_x2c = so_overlap();
         SharedMatrix so_kinetic_x2c = so_kinetic();
         SharedMatrix so_potential_x2c = so_potential();
@@ -410,24 +445,51 @@ void MintsHelper::integral_hessians() {
 }
 
 void MintsHelper::one_body_ao_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, SharedMatrix out, bool symm) {
+    one_body_ao_computer(std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>>{ints},
+                         std::vector<std::vector<SharedMatrix>>{{out}}, symm);
+}
+
+void MintsHelper::one_body_ao_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, std::vector<SharedMatrix> out,
+                                       bool symm) {
+    one_body_ao_computer(std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>>{ints},
+                         std::vector<std::vector<SharedMatrix>>{out}, symm);
+}
+
+void MintsHelper::one_body_ao_computer(std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>> ints,
+                                       std::vector<std::vector<SharedMatrix>> out, bool symm) {
+    // ints[op][thread] computes the out[op] components; every operator shares the same shell-pair loop
+    size_t nop = ints.size();
+    if (nop == 0 || nop != out.size()) {
+        throw PSIEXCEPTION("MintsHelper::one_body_ao_computer: Integral objects do not match the output matrices.");
+    }
+
     // Grab basis info
-    std::shared_ptr<BasisSet> bs1 = ints[0]->basis1();
-    std::shared_ptr<BasisSet> bs2 = ints[0]->basis2();
+    std::shared_ptr<BasisSet> bs1 = ints[0][0]->basis1();
+    std::shared_ptr<BasisSet> bs2 = ints[0][0]->basis2();
 
     // Limit to the number of incoming onbody ints
     size_t nthread = nthread_;
-    if (nthread > ints.size()) {
-        nthread = ints.size();
+    for (size_t op = 0; op < nop; op++) {
+        if (nthread > ints[op].size()) {
+            nthread = ints[op].size();
+        }
+        if (out[op].size() != (size_t)ints[op][0]->nchunk()) {
+            throw PSIEXCEPTION("MintsHelper::one_body_ao_computer: Output length does not match the integral chunks.");
+        }
     }
 
     // Grab the buffers
-    std::vector<const double *> ints_buff(nthread);
-    for (size_t thread = 0; thread < nthread; thread++) {
-        ints_buff[thread] = ints[thread]->buffer();
+    std::vector<std::vector<const double *>> ints_buff(nop, std::vector<const double *>(nthread));
+    std::vector<std::vector<double **>> outp(nop);
+    for (size_t op = 0; op < nop; op++) {
+        for (size_t thread = 0; thread < nthread; thread++) {
+            ints_buff[op][thread] = ints[op][thread]->buffer();
+        }
+        for (SharedMatrix mat : out[op]) {
+            outp[op].push_back(mat->pointer());
+        }
     }
 
-    double **outp = out->pointer();
-
 // Loop it
 #pragma omp parallel for schedule(guided) num_threads(nthread)
     for (long MU = 0; MU < bs1->nshell(); ++MU) {
@@ -439,41 +501,55 @@ void MintsHelper::one_body_ao_computer(std::vector<std::shared_ptr<OneBodyAOInt>
         rank = omp_get_thread_num();
 #endif
 
-        if (symm) {
-            // Triangular
-            for (size_t NU = 0; NU <= MU; ++NU) {
-                const size_t num_nu = bs2->shell(NU).nfunction();
-                const size_t index_nu = bs2->shell(NU).function_index();
+        // Triangular when symmetric, rectangular otherwise
+        const size_t max_nu = symm ? MU + 1 : bs2->nshell();
+        for (size_t NU = 0; NU < max_nu; ++NU) {
+            const size_t num_nu = bs2->shell(NU).nfunction();
+            const size_t index_nu = bs2->shell(NU).function_index();
 
-                ints[rank]->compute_shell(MU, NU);
+            for (size_t op = 0; op < nop; ++op) {
+                ints[op][rank]->compute_shell(MU, NU);
 
+                const double *buff = ints_buff[op][rank];
                 size_t index = 0;
-                for (size_t mu = index_mu; mu < (index_mu + num_mu); ++mu) {
-                    for (size_t nu = index_nu; nu < (index_nu + num_nu); ++nu) {
-                        outp[nu][mu] = outp[mu][nu] = ints_buff[rank][index++];
+                for (double **matp : outp[op]) {
+                    for (size_t mu = index_mu; mu < (index_mu + num_mu); ++mu) {
+                        for (size_t nu = index_nu; nu < (index_nu + num_nu); ++nu) {
+                            if (symm) {
+                                matp[nu][mu] = matp[mu][nu] = buff[index++];
+                            } else {
+                                matp[mu][nu] = buff[index++];
+                            }
+                        }
                     }
                 }
-            }  // End NU
-        }      // End Symm
-        else {
-            // Rectangular
-            for (size_t NU = 0; NU < bs2->nshell(); ++NU) {
-                const size_t num_nu = bs2->shell(NU).nfunction();
-                const size_t index_nu = bs2->shell(NU).function_index();
+            }
+        }  // End NU
+    }      // End Mu
+}
 
-                ints[rank]->compute_shell(MU, NU);
+std::vector<double> MintsHelper::shell_block_max(SharedMatrix D) {
+    int nshell = basisset_->nshell();
+    std::vector<double> Dmax(static_cast<size_t>(nshell) * nshell, 0.0);
+    double **Dp = D->pointer();
 
-                size_t index = 0;
-                for (size_t mu = index_mu; mu < (index_mu + num_mu); ++mu) {
-                    for (size_t nu = index_nu; nu < (index_nu + num_nu); ++nu) {
-                        // printf("%zu %zu | %zu %zu | %lf\n", MU, NU, mu, nu, ints_buff[rank][index]);
-                        outp[mu][nu] = ints_buff[rank][index++];
-                    }
-                }
-            }  // End NU
-        }      // End Rectangular
-    }          // End Mu
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (int P = 0; P < nshell; P++) {
+        int nP = basisset_->shell(P).nfunction();
+        int oP = basisset_->shell(P).function_index();
+        for (int Q = 0; Q < nshell; Q++) {
+            int nQ = basisset_->shell(Q).nfunction();
+            int oQ = basisset_->shell(Q).function_index();
+            double val = 0.0;
+            for (int p = 0; p < nP; p++) {
+                for (int q = 0; q < nQ; q++) val = std::max(val, std::fabs(Dp[p + oP][q + oQ]));
+            }
+            Dmax[static_cast<size_t>(P) * nshell + Q] = val;
+        }
+    }
+    return Dmax;
 }
+
 void MintsHelper::grad_two_center_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, SharedMatrix D,
                                            SharedMatrix out) {
     // Grab basis info
@@ -502,6 +578,10 @@ void MintsHelper::grad_two_center_computer(std::vector<std::shared_ptr<OneBodyAO
     double **outp = out->pointer();
     double **Dp = D->pointer();
 
+    // The integrals are contracted as they are made, so shell pairs with a negligible density block are skipped
+    size_t nshell = basisset_->nshell();
+    std::vector<double> Dmax = shell_block_max(D);
+
 #pragma omp parallel for schedule(guided) num_threads(nthread)
     for (long P = 0; P < basisset_->nshell(); P++) {
         size_t rank = 0;
@@ -509,6 +589,7 @@ void MintsHelper::grad_two_center_computer(std::vector<std::shared_ptr<OneBodyAO
         rank = omp_get_thread_num();
 #endif
         for (size_t Q = 0; Q <= P; Q++) {
+            if (std::max(Dmax[P * nshell + Q], Dmax[Q * nshell + P]) < cutoff_) continue;
             ints[rank]->compute_shell_deriv1(P, Q);
 
             size_t nP = basisset_->shell(P).nfunction();
@@ -519,7 +600,6 @@ void MintsHelper::grad_two_center_computer(std::vector<std::shared_ptr<OneBodyAO
             size_t oQ = basisset_->shell(Q).function_index();
             size_t aQ = basisset_->shell(Q).ncenter();
 
-            size_t offset = nP * nQ;
             const double *ref = ints_buff[rank];
             double perm = (P == Q ? 1.0 : 2.0);
 
@@ -656,6 +736,31 @@ SharedMatrix MintsHelper::ao_potential(std::shared_ptr<BasisSet> bs1, std::share
     return potential_mat;
 }
 
+std::vector<SharedMatrix> MintsHelper::ao_one_electron(bool include_dipole) {
+    int nbf = basisset_->nbf();
+    std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>> ints(include_dipole ? 4 : 3);
+    for (size_t i = 0; i < nthread_; i++) {
+        ints[0].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap()));
+        ints[1].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic()));
+        ints[2].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential()));
+        if (include_dipole) ints[3].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_dipole()));
+    }
+
+    std::vector<std::vector<SharedMatrix>> out;
+    out.push_back({std::make_shared<Matrix>(PSIF_AO_S, nbf, nbf)});
+    out.push_back({std::make_shared<Matrix>("AO-basis Kinetic Ints", nbf, nbf)});
+    out.push_back({std::make_shared<Matrix>("AO-basis Potential Ints", nbf, nbf)});
+    if (include_dipole) {
+        out.push_back({std::make_shared<Matrix>("AO Mux", nbf, nbf), std::make_shared<Matrix>("AO Muy", nbf, nbf),
+                       std::make_shared<Matrix>("AO Muz", nbf, nbf)});
+    }
+    one_body_ao_computer(ints, out, true);
+
+    std::vector<SharedMatrix> ret;
+    for (const auto &op : out) ret.insert(ret.end(), op.begin(), op.end());
+    return ret;
+}
+
 SharedMatrix MintsHelper::ao_ecp() {
     std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
     for (size_t i = 0; i < nthread_; i++) {
@@ -1408,8 +1513,12 @@ std::vector<SharedMatrix> MintsHelper::ao_angular_momentum() {
     angmom.push_back(std::make_shared<Matrix>("AO Ly", basisset_->nbf(), basisset_->nbf()));
     angmom.push_back(std::make_shared<Matrix>("AO Lz", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_angular_momentum());
-    ints->compute(angmom);
+    // The operator is antisymmetric, so the full rectangle is computed
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_angular_momentum()));
+    }
+    one_body_ao_computer(ints_vec, angmom, false);
 
     return angmom;
 }
@@ -1422,8 +1531,11 @@ std::vector<SharedMatrix> MintsHelper::ao_dipole() {
     dipole.push_back(std::make_shared<Matrix>("AO Muy", basisset_->nbf(), basisset_->nbf()));
     dipole.push_back(std::make_shared<Matrix>("AO Muz", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_dipole());
-    ints->compute(dipole);
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_dipole()));
+    }
+    one_body_ao_computer(ints_vec, dipole, true);
 
     return dipole;
 }
@@ -1439,8 +1551,11 @@ std::vector<SharedMatrix> MintsHelper::ao_quadrupole() {
     quadrupole.push_back(std::make_shared<Matrix>("AO Quadrupole YZ", basisset_->nbf(), basisset_->nbf()));
     quadrupole.push_back(std::make_shared<Matrix>("AO Quadrupole ZZ", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_quadrupole());
-    ints->compute(quadrupole);
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_quadrupole()));
+    }
+    one_body_ao_computer(ints_vec, quadrupole, true);
 
     return quadrupole;
 }
@@ -1456,8 +1571,11 @@ std::vector<SharedMatrix> MintsHelper::ao_traceless_quadrupole() {
     quadrupole.push_back(std::make_shared<Matrix>("AO Traceless Quadrupole YZ", basisset_->nbf(), basisset_->nbf()));
     quadrupole.push_back(std::make_shared<Matrix>("AO Traceless Quadrupole ZZ", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_traceless_quadrupole());
-    ints->compute(quadrupole);
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_traceless_quadrupole()));
+    }
+    one_body_ao_computer(ints_vec, quadrupole, true);
 
     return quadrupole;
 }
@@ -1488,9 +1606,12 @@ std::vector<SharedMatrix> MintsHelper::ao_efp_multipole_potential(const std::vec
     mult.push_back(std::make_shared<Matrix>("AO EFP Octupole YZZ", basisset_->nbf(), basisset_->nbf()));
     mult.push_back(std::make_shared<Matrix>("AO EFP Octupole XYZ", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_efp_multipole_potential(deriv));
-    ints->set_origin(v3origin);
-    ints->compute(mult);
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_efp_multipole_potential(deriv)));
+        ints_vec[i]->set_origin(v3origin);
+    }
+    one_body_ao_computer(ints_vec, mult, false);
 
     return mult;
 }
@@ -1504,9 +1625,12 @@ std::vector<SharedMatrix> MintsHelper::electric_field(const std::vector<double>
     field.push_back(std::make_shared<Matrix>("Ey integrals", basisset_->nbf(), basisset_->nbf()));
     field.push_back(std::make_shared<Matrix>("Ez integrals", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->electric_field(deriv));
-    ints->set_origin(v3origin);
-    ints->compute(field);
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->electric_field(deriv)));
+        ints_vec[i]->set_origin(v3origin);
+    }
+    one_body_ao_computer(ints_vec, field, false);
 
     return field;
 }
@@ -1519,8 +1643,12 @@ std::vector<SharedMatrix> MintsHelper::ao_nabla() {
     nabla.push_back(std::make_shared<Matrix>("AO Py", basisset_->nbf(), basisset_->nbf()));
     nabla.push_back(std::make_shared<Matrix>("AO Pz", basisset_->nbf(), basisset_->nbf()));
 
-    std::shared_ptr<OneBodyAOInt> ints(integral_->ao_nabla());
-    ints->compute(nabla);
+    // The operator is antisymmetric, so the full rectangle is computed
+    std::vector<std::shared_ptr<OneBodyAOInt>> ints_vec;
+    for (size_t i = 0; i < nthread_; i++) {
+        ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_nabla()));
+    }
+    one_body_ao_computer(ints_vec, nabla, false);
 
     return nabla;
 }
@@ -1710,10 +1838,13 @@ SharedMatrix MintsHelper::potential_grad(SharedMatrix D) {
         ints_vec.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential(1)));
     }
 
-    // Lower Triangle
+    // Lower triangle, without the shell pairs whose density block is negligible
+    int nshell = basisset_->nshell();
+    std::vector<double> Dmax = shell_block_max(D);
     std::vector<std::pair<int, int>> PQ_pairs;
-    for (int P = 0; P < basisset_->nshell(); P++) {
+    for (int P = 0; P < nshell; P++) {
         for (int Q = 0; Q <= P; Q++) {
+            if (std::max(Dmax[P * nshell + Q], Dmax[Q * nshell + P]) < cutoff_) continue;
             PQ_pairs.push_back(std::pair<int, int>(P, Q));
         }
     }
@@ -2016,18 +2147,19 @@ std::vector<SharedMatrix> MintsHelper::ao_overlap_kinetic_deriv1_helper(const st
     cartcomp.push_back("Y");
     cartcomp.push_back("Z");
 
-    std::shared_ptr<OneBodyAOInt> GInt;
-
-    if (type == "OVERLAP") {
-        std::shared_ptr<OneBodyAOInt> Int(integral_->ao_overlap(1));
-        GInt = Int;
-    } else {
-        std::shared_ptr<OneBodyAOInt> Int(integral_->ao_kinetic(1));
-        GInt = Int;
+    std::vector<std::shared_ptr<OneBodyAOInt>> GInts;
+    std::vector<const double *> buffers;
+    for (size_t i = 0; i < nthread_; i++) {
+        if (type == "OVERLAP") {
+            GInts.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap(1)));
+        } else {
+            GInts.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic(1)));
+        }
+        buffers.push_back(GInts[i]->buffer());
     }
 
-    std::shared_ptr<BasisSet> bs1 = GInt->basis1();
-    std::shared_ptr<BasisSet> bs2 = GInt->basis2();
+    std::shared_ptr<BasisSet> bs1 = GInts[0]->basis1();
+    std::shared_ptr<BasisSet> bs2 = GInts[0]->basis2();
 
     int nbf1 = bs1->nbf();
     int nbf2 = bs2->nbf();
@@ -2039,9 +2171,14 @@ std::vector<SharedMatrix> MintsHelper::ao_overlap_kinetic_deriv1_helper(const st
         grad.push_back(SharedMatrix(new Matrix(sstream.str(), nbf1, nbf2)));
     }
 
-    const double *buffer = GInt->buffer();
-
-    for (int P = 0; P < bs1->nshell(); P++)
+    // Each shell pair owns a distinct block of the result, so threads never write the same element
+#pragma omp parallel for schedule(guided) num_threads(nthread_)
+    for (int P = 0; P < bs1->nshell(); P++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const double *buffer = buffers[rank];
         for (int Q = 0; Q < bs2->nshell(); Q++) {
             int nP = basisset_->shell(P).nfunction();
             int oP = basisset_->shell(P).function_index();
@@ -2053,7 +2190,7 @@ std::vector<SharedMatrix> MintsHelper::ao_overlap_kinetic_deriv1_helper(const st
 
             if (aP != atom && aQ != atom) continue;
 
-            GInt->compute_shell_deriv1(P, Q);
+            GInts[rank]->compute_shell_deriv1(P, Q);
             int offset = 0;
 
             if (aP == atom) {
@@ -2114,6 +2251,7 @@ std::vector<SharedMatrix> MintsHelper::ao_overlap_kinetic_deriv1_helper(const st
                 offset += 3 * nP * nQ;
             }
         }
+    }
 
     return grad;
 }
@@ -2124,10 +2262,15 @@ std::vector<SharedMatrix> MintsHelper::ao_potential_deriv1_helper(int atom) {
     cartcomp.push_back("Y");
     cartcomp.push_back("Z");
 
-    std::shared_ptr<OneBodyAOInt> Vint(integral_->ao_potential(1));
+    std::vector<std::shared_ptr<OneBodyAOInt>> Vints;
+    std::vector<const double *> buffers;
+    for (size_t i = 0; i < nthread_; i++) {
+        Vints.push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential(1)));
+        buffers.push_back(Vints[i]->buffer());
+    }
 
-    std::shared_ptr<BasisSet> bs1 = Vint->basis1();
-    std::shared_ptr<BasisSet> bs2 = Vint->basis2();
+    std::shared_ptr<BasisSet> bs1 = Vints[0]->basis1();
+    std::shared_ptr<BasisSet> bs2 = Vints[0]->basis2();
 
     int nbf1 = bs1->nbf();
     int nbf2 = bs2->nbf();
@@ -2141,19 +2284,22 @@ std::vector<SharedMatrix> MintsHelper::ao_potential_deriv1_helper(int atom) {
         grad.push_back(SharedMatrix(new Matrix(sstream.str(), nbf1, nbf2)));
     }
 
-    const double *buffer = Vint->buffer();
-
-    for (int P = 0; P < bs1->nshell(); P++)
+    // Each shell pair owns a distinct block of the result, so threads never write the same element
+#pragma omp parallel for schedule(guided) num_threads(nthread_)
+    for (int P = 0; P < bs1->nshell(); P++) {
+        size_t rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        const double *buffer = buffers[rank];
         for (int Q = 0; Q < bs2->nshell(); Q++) {
             int nP = bs1->shell(P).nfunction();
             int oP = bs1->shell(P).function_index();
-            int aP = bs1->shell(P).ncenter();
 
             int nQ = bs2->shell(Q).nfunction();
             int oQ = bs2->shell(Q).function_index();
-            int aQ = bs2->shell(Q).ncenter();
 
-            Vint->compute_shell_deriv1(P, Q);
+            Vints[rank]->compute_shell_deriv1(P, Q);
 
             const double *ref0 = &buffer[3 * atom * nP * nQ + 0 * nP * nQ];
             const double *ref1 = &buffer[3 * atom * nP * nQ + 1 * nP * nQ];
@@ -2165,6 +2311,7 @@ std::vector<SharedMatrix> MintsHelper::ao_potential_deriv1_helper(int atom) {
                     grad[2]->set(p + oP, q + oQ, (*ref2++));
                 }
         }
+    }
 
     return grad;
 }
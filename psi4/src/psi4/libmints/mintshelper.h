@@ -82,7 +82,13 @@ class PSI_API MintsHelper {
     void common_init();
 
     void one_body_ao_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, SharedMatrix out, bool symm);
+    void one_body_ao_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, std::vector<SharedMatrix> out, bool symm);
+    /// Threaded shell-pair loop shared by several operators: ints[op][thread] fills the out[op] components
+    void one_body_ao_computer(std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>> ints,
+                              std::vector<std::vector<SharedMatrix>> out, bool symm);
     void grad_two_center_computer(std::vector<std::shared_ptr<OneBodyAOInt>> ints, SharedMatrix D, SharedMatrix out);
+    /// Largest |D| element in each (P,Q) shell block, nshell x nshell, used to skip shell pairs in gradients
+    std::vector<double> shell_block_max(SharedMatrix D);
 
    public:
     void init_helper(std::shared_ptr<Wavefunction> wavefunction = std::shared_ptr<Wavefunction>());
@@ -237,6 +243,8 @@ class PSI_API MintsHelper {
     SharedMatrix ao_dkh(int dkh_order = -1);
     /// SO DKH Integrals
     SharedMatrix so_dkh(int dkh_order = -1);
+    /// AO Overlap, Kinetic, Potential, and (optionally) Mux, Muy, Muz Integrals from a single shell-pair pass
+    std::vector<SharedMatrix> ao_one_electron(bool include_dipole = true);
     /// Vector AO Dipole Integrals
     std::vector<SharedMatrix> ao_dipole();
     /// Vector AO Quadrupole Integrals
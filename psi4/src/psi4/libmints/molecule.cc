@@ -376,6 +376,60 @@ int Molecule::atom_at_position3(const std::array<double, 3> &coord, const double
     return -1;
 }
 
+AtomPositionHash::AtomPositionHash(const Molecule &mol, double tol) : tol_(tol), maxabs_(0.0) {
+    int natom = mol.natom();
+    xyz_.reserve(natom);
+    for (int i = 0; i < natom; ++i) {
+        xyz_.push_back(mol.xyz(i));
+        for (int k = 0; k < 3; ++k) maxabs_ = std::max(maxabs_, std::fabs(xyz_[i][k]));
+    }
+
+    // Cells must be at least tol wide so that only the 27 surrounding cells can hold a match. The other
+    // bounds keep the packed 21-bit cell indices in range for tiny tolerances or very spread-out systems.
+    cell_ = std::max({tol, 1.0e-3, (maxabs_ + 1.0) / 500000.0});
+
+    cells_.reserve(natom);
+    for (int i = 0; i < natom; ++i) {
+        cells_[key(cell_index(xyz_[i][0]), cell_index(xyz_[i][1]), cell_index(xyz_[i][2]))].push_back(i);
+    }
+}
+
+long long AtomPositionHash::cell_index(double x) const { return static_cast<long long>(std::floor(x / cell_)); }
+
+long long AtomPositionHash::key(long long ix, long long iy, long long iz) {
+    const long long offset = 1LL << 20;
+    return ((ix + offset) << 42) | ((iy + offset) << 21) | (iz + offset);
+}
+
+int AtomPositionHash::find(const Vector3 &b) const {
+    for (int k = 0; k < 3; ++k) {
+        if (std::fabs(b[k]) > maxabs_ + tol_) return -1;
+    }
+
+    long long ix = cell_index(b[0]);
+    long long iy = cell_index(b[1]);
+    long long iz = cell_index(b[2]);
+
+    // Atoms are stored in ascending order within a cell, so the first hit in each cell is its lowest
+    int match = -1;
+    for (long long dx = -1; dx <= 1; ++dx) {
+        for (long long dy = -1; dy <= 1; ++dy) {
+            for (long long dz = -1; dz <= 1; ++dz) {
+                auto cell = cells_.find(key(ix + dx, iy + dy, iz + dz));
+                if (cell == cells_.end()) continue;
+                for (int i : cell->second) {
+                    if (match >= 0 && i >= match) break;
+                    if (b.distance(xyz_[i]) < tol_) {
+                        match = i;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return match;
+}
+
 Vector3 Molecule::nuclear_dipole() const {
     Vector3 origin(0.0, 0.0, 0.0);
     return nuclear_dipole(origin);
@@ -1440,9 +1494,24 @@ RotorType Molecule::rotor_type(double zero_tol) const {
 // Symmetry
 //
 bool Molecule::has_inversion(Vector3 &origin, double tol) const {
+    AtomPositionHash atoms(*this, tol);
+    return has_inversion(atoms, origin);
+}
+
+bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const {
+    AtomPositionHash atoms(*this, tol);
+    return is_plane(atoms, origin, uperp);
+}
+
+bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) const {
+    AtomPositionHash atoms(*this, tol);
+    return is_axis(atoms, origin, axis, order);
+}
+
+bool Molecule::has_inversion(const AtomPositionHash &atoms, Vector3 &origin) const {
     for (int i = 0; i < natom(); ++i) {
         Vector3 inverted = origin - (xyz(i) - origin);
-        int atom = atom_at_position2(inverted, tol);
+        int atom = atoms.find(inverted);
         if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
             return false;
         }
@@ -1450,13 +1519,13 @@ bool Molecule::has_inversion(Vector3 &origin, double tol) const {
     return true;
 }
 
-bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const {
+bool Molecule::is_plane(const AtomPositionHash &atoms, Vector3 &origin, Vector3 &uperp) const {
     for (int i = 0; i < natom(); ++i) {
         Vector3 A = xyz(i) - origin;
         Vector3 Apar = uperp.dot(A) * uperp;
         Vector3 Aperp = A - Apar;
         A = (Aperp - Apar) + origin;
-        int atom = atom_at_position2(A, tol);
+        int atom = atoms.find(A);
         if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
             return false;
         }
@@ -1464,14 +1533,14 @@ bool Molecule::is_plane(Vector3 &origin, Vector3 &uperp, double tol) const {
     return true;
 }
 
-bool Molecule::is_axis(Vector3 &origin, Vector3 &axis, int order, double tol) const {
+bool Molecule::is_axis(const AtomPositionHash &atoms, Vector3 &origin, Vector3 &axis, int order) const {
     for (int i = 0; i < natom(); ++i) {
         Vector3 A = xyz(i) - origin;
         for (int j = 1; j < order; ++j) {
             Vector3 R = A;
             R.rotate(j * 2.0 * M_PI / order, axis);
             R += origin;
-            int atom = atom_at_position2(R, tol);
+            int atom = atoms.find(R);
             if (atom < 0 || !atoms_[atom]->is_equivalent_to(atoms_[i])) {
                 return false;
             }
@@ -1579,7 +1648,30 @@ std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
     bool linear, planar;
     is_linear_planar(linear, planar, tol);
 
-    bool have_inversion = has_inversion(com, tol);
+    // Hash the geometry once for all of the candidate element tests below
+    AtomPositionHash atoms(*this, tol);
+
+    // Atom pairs related by a symmetry element are equidistant from the com. Sorting the atoms by that
+    // distance lets each pair scan below visit only the atoms inside the tolerance window instead of all
+    // of them; partners(i) returns those atoms in ascending order, so the scans find the same pair first.
+    std::vector<double> r2(natom());
+    std::vector<int> by_r2(natom());
+    for (i = 0; i < natom(); ++i) {
+        Vector3 A = xyz(i) - com;
+        r2[i] = A.dot(A);
+        by_r2[i] = i;
+    }
+    std::sort(by_r2.begin(), by_r2.end(), [&r2](int a, int b) { return r2[a] < r2[b]; });
+    auto partners = [&](int i) {
+        std::vector<int> near;
+        auto lo = std::lower_bound(by_r2.begin(), by_r2.end(), r2[i] - 2.0 * tol,
+                                   [&r2](int a, double value) { return r2[a] < value; });
+        for (auto it = lo; it != by_r2.end() && r2[*it] <= r2[i] + 2.0 * tol; ++it) near.push_back(*it);
+        std::sort(near.begin(), near.end());
+        return near;
+    };
+
+    bool have_inversion = has_inversion(atoms, com);
 
     // check for C2 axis
     Vector3 c2axis;
@@ -1613,7 +1705,8 @@ std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
         for (i = 0; i < natom(); ++i) {
             Vector3 A = xyz(i) - com;
             double AdotA = A.dot(A);
-            for (j = 0; j <= i; ++j) {
+            for (int j : partners(i)) {
+                if (j > i) break;
                 // the atoms must be identical
                 if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                 Vector3 B = xyz(j) - com;
@@ -1623,7 +1716,7 @@ std::shared_ptr<Matrix> Molecule::symmetry_frame(double tol) {
                 // atoms colinear with the com don't work
                 if (axis.norm() < tol) continue;
                 axis.normalize();
-                if (is_axis(com, axis, 2, tol)) {
+                if (is_axis(atoms, com, axis, 2)) {
                     have_c2axis = true;
                     c2axis = axis;
                     goto symmframe_found_c2axis;
@@ -1657,7 +1750,8 @@ symmframe_found_c2axis:
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
                 double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
+                for (int j : partners(i)) {
+                    if (j >= i) break;
                     // the atoms must be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
@@ -1669,7 +1763,7 @@ symmframe_found_c2axis:
                     axis.normalize();
                     // if axis is not perp continue
                     if (std::fabs(axis.dot(c2axis)) > tol) continue;
-                    if (is_axis(com, axis, 2, tol)) {
+                    if (is_axis(atoms, com, axis, 2)) {
                         have_c2axisperp = true;
                         c2axisperp = axis;
                         goto symmframe_found_c2axisperp;
@@ -1731,7 +1825,8 @@ symmframe_found_c2axisperp:
                 double AdotA = A.dot(A);
                 // the second atom can equal i because i might be
                 // in the plane
-                for (j = 0; j <= i; ++j) {
+                for (int j : partners(i)) {
+                    if (j > i) break;
                     // the atoms must be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
@@ -1745,7 +1840,7 @@ symmframe_found_c2axisperp:
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (is_plane(atoms, com, perp)) {
                         have_sigmav = true;
                         sigmav = perp;
                         goto symmframe_found_sigmav;
@@ -1795,7 +1890,8 @@ symmframe_found_sigmav:
             for (i = 0; i < natom(); ++i) {
                 Vector3 A = xyz(i) - com;
                 double AdotA = A.dot(A);
-                for (j = 0; j < i; ++j) {
+                for (int j : partners(i)) {
+                    if (j >= i) break;
                     // the atomsmust be identical
                     if (!atoms_[i]->is_equivalent_to(atoms_[j])) continue;
                     Vector3 B = xyz(j) - com;
@@ -1806,7 +1902,7 @@ symmframe_found_sigmav:
                     double norm_perp = perp.norm();
                     if (norm_perp < tol) continue;
                     perp *= 1.0 / norm_perp;
-                    if (is_plane(com, perp, tol)) {
+                    if (is_plane(atoms, com, perp)) {
                         have_sigma = true;
                         sigma = perp;
                         goto found_sigma;
@@ -1895,6 +1991,7 @@ std::shared_ptr<PointGroup> Molecule::find_highest_point_group(double tol) const
                         &SymmetryOperation::sigma_yz};
 
     SymmetryOperation symop;
+    AtomPositionHash atoms(*this, tol);
 
     int matching_atom = -1;
     // Only needs to detect the 8 symmetry operations
@@ -1910,7 +2007,7 @@ std::shared_ptr<PointGroup> Molecule::find_highest_point_group(double tol) const
             Vector3 op(symop(0, 0), symop(1, 1), symop(2, 2));
             Vector3 pos = xyz(i) * op;
 
-            if ((matching_atom = atom_at_position2(pos, tol)) >= 0) {
+            if ((matching_atom = atoms.find(pos)) >= 0) {
                 if (atoms_[i]->is_equivalent_to(atoms_[matching_atom]) == false) {
                     found = false;
                     break;
@@ -2022,9 +2119,10 @@ void Molecule::set_point_group(std::shared_ptr<PointGroup> pg) {
 }
 
 bool Molecule::has_symmetry_element(Vector3 &op, double tol) const {
+    AtomPositionHash atoms(*this, tol);
     for (int i = 0; i < natom(); ++i) {
         Vector3 result = xyz(i) * op;
-        int atom = atom_at_position2(result, tol);
+        int atom = atoms.find(result);
 
         if (atom != -1) {
             if (!atoms_[atom]->is_equivalent_to(atoms_[i])) return false;
@@ -2116,6 +2214,7 @@ void Molecule::form_symmetry_information(double tol) {
     atom_to_unique_[0] = 0;
 
     CharacterTable ct = point_group()->char_table();
+    AtomPositionHash atoms(*this, tol);
 
     Vector3 ac;
     SymmetryOperation so;
@@ -2136,16 +2235,12 @@ void Molecule::form_symmetry_information(double tol) {
                 for (int jj = 0; jj < 3; ++jj) np[ii] += so(ii, jj) * ac[jj];
             }
 
-            // See if the transformed atom is equivalent to a
-            // unique atom
-            for (int j = 0; j < nunique_; ++j) {
-                int unique = equiv_[j][0];
-                Vector3 aj(xyz(unique));
-                if (np.distance(aj) < tol && Z(unique) == Z(i) && std::fabs(mass(unique) - mass(i)) < tol) {
-                    i_is_unique = 0;
-                    i_equiv = j;
-                    break;
-                }
+            // See if the transformed atom lands on an atom that has already
+            // been classified; if so, i belongs to that atom's unique set
+            int k = atoms.find(np);
+            if (k >= 0 && k < i && Z(k) == Z(i) && std::fabs(mass(k) - mass(i)) < tol) {
+                i_is_unique = 0;
+                i_equiv = atom_to_unique_[k];
             }
         }
         if (i_is_unique) {
@@ -2366,6 +2461,7 @@ bool Molecule::valid_atom_map(double tol) const {
     double np[3];
     SymmetryOperation so;
     CharacterTable ct = point_group()->char_table();
+    AtomPositionHash atoms(*this, tol);
 
     // loop over all centers
     for (int i = 0; i < natom(); i++) {
@@ -2381,7 +2477,7 @@ bool Molecule::valid_atom_map(double tol) const {
                 for (int jj = 0; jj < 3; jj++) np[ii] += so(ii, jj) * ac[jj];
             }
 
-            if (atom_at_position1(np, tol) < 0) return false;
+            if (atoms.find(Vector3(np)) < 0) return false;
         }
     }
     return true;
@@ -34,6 +34,7 @@
 #include <cstdio>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #define LINEAR_A_TOL 1.0E-2  // When sin(a) is below this, we consider the angle to be linear
 #define DEFAULT_SYM_TOL 1.0E-8
@@ -45,6 +46,7 @@
 namespace psi {
 class PointGroup;
 class BasisSet;
+class AtomPositionHash;
 enum RotorType { RT_ASYMMETRIC_TOP, RT_SYMMETRIC_TOP, RT_SPHERICAL_TOP, RT_LINEAR, RT_ATOM };
 enum FullPointGroup {
     PG_ATOM,
@@ -173,6 +175,14 @@ class PSI_API Molecule {
     /// Reinterpret the coord entries or not
     /// Default is true, except for findif
     bool reinterpret_coordentries_;
+
+    /// @{
+    /// Symmetry element tests against a prebuilt position hash, so callers that test many
+    /// candidate elements only hash the geometry once
+    bool has_inversion(const AtomPositionHash& atoms, Vector3& origin) const;
+    bool is_plane(const AtomPositionHash& atoms, Vector3& origin, Vector3& uperp) const;
+    bool is_axis(const AtomPositionHash& atoms, Vector3& origin, Vector3& axis, int order) const;
+    /// @}
     /// Nilpotence boolean (flagged upon first determination of symmetry frame, reset each time a substantiative change
     /// is made)
     bool lock_frame_;
@@ -667,6 +677,32 @@ class PSI_API Molecule {
     void update_geometry();
 };
 
+/*! \ingroup MINTS
+ *  \class AtomPositionHash
+ *  \brief Spatial hash over a snapshot of the atom positions of a Molecule.
+ *
+ *  Answers atom_at_position queries in constant time instead of a scan over all atoms, which keeps
+ *  symmetry detection and atom mapping linear in the number of atoms. The snapshot is not updated
+ *  if the geometry changes afterwards.
+ */
+class PSI_API AtomPositionHash {
+   public:
+    AtomPositionHash(const Molecule& mol, double tol);
+
+    /// Lowest-numbered atom within tol of b, or -1; the same answer as Molecule::atom_at_position2
+    int find(const Vector3& b) const;
+
+   private:
+    double tol_;
+    double cell_;
+    double maxabs_;
+    std::vector<Vector3> xyz_;
+    std::unordered_map<long long, std::vector<int>> cells_;
+
+    long long cell_index(double x) const;
+    static long long key(long long ix, long long iy, long long iz);
+};
+
 }  // namespace psi
 
 #endif
@@ -68,6 +68,13 @@ class MultipoleInt : public OneBodyAOInt {
 
     /// Returns the nuclear contribution to the multipole moments, with angular momentum up to order
     static SharedVector nuclear_contribution(std::shared_ptr<Molecule> mol, int order, const Vector3 &origin);
+
+    /// Chunk of the x^lx y^ly z^lz component in the buffer (lx + ly + lz >= 1)
+    static int address(int lx, int ly, int lz) {
+        int l = lx + ly + lz;
+        int ii = l - lx;
+        return l * (l + 1) * (l + 2) / 6 - 1 + ii * (ii + 1) / 2 + lz;
+    }
 };
 
 }  // namespace psi
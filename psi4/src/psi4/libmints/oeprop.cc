@@ -48,6 +48,9 @@
 #include "psi4/libmints/pointgrp.h"
 #include "psi4/libmints/electricfield.h"
 #include "psi4/libmints/electrostatic.h"
+#include "psi4/libmints/fittedesp.h"
+#include "psi4/libmints/chargefit.h"
+#include "psi4/libmints/potentialint.h"
 #include "psi4/libmints/petitelist.h"
 #include "psi4/libmints/multipoles.h"
 #include "psi4/libmints/dipole.h"
@@ -66,6 +69,10 @@
 #include <tuple>
 #include <functional>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
 Prop::Prop(std::shared_ptr<Wavefunction> wfn) : wfn_(wfn) {
@@ -821,6 +828,9 @@ void OEProp::compute() {
     if (tasks_.count("MO_EXTENTS")) compute_mo_extents();
     if (tasks_.count("MULLIKEN_CHARGES")) compute_mulliken_charges();
     if (tasks_.count("LOWDIN_CHARGES")) compute_lowdin_charges();
+    if (tasks_.count("CHELPG_CHARGES")) compute_fitted_charges("CHELPG");
+    if (tasks_.count("MK_CHARGES")) compute_fitted_charges("MK");
+    if (tasks_.count("RESP_CHARGES")) compute_fitted_charges("RESP");
     if (tasks_.count("MAYER_INDICES")) compute_mayer_indices();
     if (tasks_.count("WIBERG_LOWDIN_INDICES")) compute_wiberg_lowdin_indices();
     if (tasks_.count("NO_OCCUPATIONS")) compute_no_occupations();
@@ -974,47 +984,47 @@ ESPPropCalc::ESPPropCalc(std::shared_ptr<Wavefunction> wfn) : Prop(wfn) {}
 
 ESPPropCalc::~ESPPropCalc() {}
 
+std::shared_ptr<FittedESP> ESPPropCalc::fitted_esp(SharedMatrix Dtot) const {
+    Options& options = Process::environment.options;
+    if (!options.get_bool("PROPERTIES_ESP_FIT")) return nullptr;
+    if (!wfn_->basisset_exists("DF_BASIS_SCF")) {
+        outfile->Printf("  PROPERTIES_ESP_FIT requested but no DF_BASIS_SCF is attached, using exact integrals.\n");
+        return nullptr;
+    }
+    auto esp = std::make_shared<FittedESP>(basisset_, wfn_->get_basisset("DF_BASIS_SCF"),
+                                           options.get_double("CUBIC_ESP_TOLERANCE"));
+    // INTS_TOLERANCE and DF_FITTING_CONDITION are module options, so take their SCF defaults
+    esp->fit(Dtot, 1.0E-12, 1.0E-12);
+    return esp;
+}
+
 void OEProp::compute_esp_over_grid() { epc_.compute_esp_over_grid(true); }
 
 void ESPPropCalc::compute_esp_over_grid(bool print_output) {
     std::shared_ptr<Molecule> mol = basisset_->molecule();
 
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
-
     if (print_output) {
         outfile->Printf("\n Electrostatic potential computed on the grid and written to grid_esp.dat\n");
     }
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
-    if (same_dens_) {
-        Dtot->scale(2.0);
-    } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
-    }
-
-    int nbf = basisset_->nbf();
-    auto ints = std::make_shared<Matrix>("Ex integrals", nbf, nbf);
-
-    Vvals_.clear();
-    FILE* gridout = fopen("grid_esp.dat", "w");
-    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    // Read the whole grid first, so the points can be batched
+    std::vector<double> points;
     GridIterator griditer("grid.dat");
     for (griditer.first(); !griditer.last(); griditer.next()) {
         Vector3 origin(griditer.gridpoints());
         if (mol->units() == Molecule::Angstrom) origin /= pc_bohr2angstroms;
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int i = 0; i < natom; i++) {
-            Vector3 dR = origin - mol->xyz(i);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(i) / r;
-        }
-        Vvals_.push_back(Velec + Vnuc);
-        fprintf(gridout, "%16.10f\n", Velec + Vnuc);
+        points.insert(points.end(), {origin[0], origin[1], origin[2]});
     }
+    int npoints = points.size() / 3;
+    auto grid = std::make_shared<Matrix>("ESP Grid", npoints, 3);
+    if (npoints) std::copy(points.begin(), points.end(), grid->pointer()[0]);
+
+    SharedVector esp = compute_esp(grid);
+
+    Vvals_.assign(esp->pointer(), esp->pointer() + npoints);
+    FILE* gridout = fopen("grid_esp.dat", "w");
+    if (!gridout) throw PSIEXCEPTION("Unable to write to grid_esp.dat");
+    for (int i = 0; i < npoints; i++) fprintf(gridout, "%16.10f\n", Vvals_[i]);
     fclose(gridout);
 }
 
@@ -1027,44 +1037,191 @@ SharedVector ESPPropCalc::compute_esp_over_grid_in_memory(SharedMatrix input_gri
         throw PSIEXCEPTION("ESPPropCalc only allows \"plain\" input matrices with a dimension of N (rows) x 3 (cols)");
     }
 
-    int number_of_grid_points = input_grid->rowdim();
-    SharedVector output = std::make_shared<Vector>(number_of_grid_points);
-
-    std::shared_ptr<Molecule> mol = basisset_->molecule();
-    std::shared_ptr<ElectrostaticInt> epot(dynamic_cast<ElectrostaticInt*>(integral_->electrostatic()));
+    SharedMatrix grid = input_grid;
+    if (basisset_->molecule()->units() == Molecule::Angstrom) {
+        grid = input_grid->clone();
+        grid->scale(1.0 / pc_bohr2angstroms);
+    }
+    return compute_esp(grid);
+}
 
-    SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
+SharedMatrix ESPPropCalc::cartesian_density() const {
+    SharedMatrix Dso = Da_so_->clone();
     if (same_dens_) {
-        Dtot->scale(2.0);
+        Dso->scale(2.0);
     } else {
-        Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
+        Dso->add(Db_so_);
+    }
+    PetiteList petite(basisset_, integral_, true);
+    auto Dcart = std::make_shared<Matrix>("D carts", basisset_->nao(), basisset_->nao());
+    Dcart->remove_symmetry(Dso, petite.sotoao());
+    return Dcart;
+}
+
+SharedVector ESPPropCalc::compute_esp(SharedMatrix grid) const {
+    if (grid->nirrep() != 1 || grid->coldim() != 3) {
+        throw PSIEXCEPTION("ESPPropCalc::compute_esp: the grid must be a plain N x 3 matrix.");
+    }
+    int npoints = grid->rowdim();
+    auto output = std::make_shared<Vector>(npoints);
+    if (!npoints) return output;
+    double** gp = grid->pointer();
+    double* vp = output->pointer();
+
+    std::shared_ptr<Molecule> mol = basisset_->molecule();
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = Process::environment.get_n_threads();
+#endif
+
+    std::shared_ptr<FittedESP> fitted;
+    if (Process::environment.options.get_bool("PROPERTIES_ESP_FIT")) {
+        SharedMatrix Dtot = wfn_->matrix_subset_helper(Da_so_, Ca_so_, "AO", "D");
+        if (same_dens_) {
+            Dtot->scale(2.0);
+        } else {
+            Dtot->add(wfn_->matrix_subset_helper(Db_so_, Cb_so_, "AO", "D beta"));
+        }
+        fitted = fitted_esp(Dtot);
+    }
+
+    // Exact path: the points of a block form the charge field of one PCMPotentialInt pass, so
+    // the shell-pair setup is paid once per block rather than once per point, and shell pairs
+    // whose density block cannot contribute are skipped outright
+    SharedMatrix Dcart;
+    std::vector<bool> skip;
+    std::vector<std::shared_ptr<PCMPotentialInt>> pot;
+    if (!fitted) {
+        Dcart = cartesian_density();
+        double** Dp = Dcart->pointer();
+        int nshell = basisset_->nshell();
+        skip.resize((size_t)nshell * nshell);
+        for (int P = 0, p0 = 0; P < nshell; p0 += basisset_->shell(P).ncartesian(), ++P) {
+            const GaussianShell& sP = basisset_->shell(P);
+            for (int Q = 0, q0 = 0; Q < nshell; q0 += basisset_->shell(Q).ncartesian(), ++Q) {
+                const GaussianShell& sQ = basisset_->shell(Q);
+                double dmax = 0.0;
+                for (int p = p0; p < p0 + sP.ncartesian(); ++p)
+                    for (int q = q0; q < q0 + sQ.ncartesian(); ++q) dmax = std::max(dmax, std::fabs(Dp[p][q]));
+                // Largest (s|1/r|s)-like prefactor over the primitive pairs, times AB^l for the
+                // angular factors; a bound for s functions and a safe estimate beyond
+                const double* A = sP.center();
+                const double* B = sQ.center();
+                double AB2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) +
+                             (A[2] - B[2]) * (A[2] - B[2]);
+                double bound = 0.0;
+                for (int i = 0; i < sP.nprimitive(); ++i) {
+                    for (int j = 0; j < sQ.nprimitive(); ++j) {
+                        double a = sP.exp(i), b = sQ.exp(j);
+                        bound += std::fabs(sP.coef(i) * sQ.coef(j)) * 2.0 * M_PI / (a + b) *
+                                 std::exp(-a * b * AB2 / (a + b));
+                    }
+                }
+                bound *= std::pow(std::max(1.0, std::sqrt(AB2)), sP.am() + sQ.am());
+                skip[(size_t)P * nshell + Q] = (dmax * bound < 1.0E-14);
+            }
+        }
+        for (int t = 0; t < threads; t++) {
+            pot.push_back(
+                std::shared_ptr<PCMPotentialInt>(static_cast<PCMPotentialInt*>(integral_->pcm_potentialint())));
+        }
     }
 
-    int const nbf = basisset_->nbf();
-
-    bool convert = mol->units() == Molecule::Angstrom;
-
-#pragma omp parallel for
-    for (int i = 0; i < number_of_grid_points; ++i) {
-        Vector3 origin(input_grid->get(i, 0), input_grid->get(i, 1), input_grid->get(i, 2));
-        if (convert) origin /= pc_bohr2angstroms;
-        auto ints = std::make_shared<Matrix>(nbf, nbf);
-        ints->zero();
-        epot->compute(ints, origin);
-        double Velec = Dtot->vector_dot(ints);
-        double Vnuc = 0.0;
-        int natom = mol->natom();
-        for (int iat = 0; iat < natom; iat++) {
-            Vector3 dR = origin - mol->xyz(iat);
-            double r = dR.norm();
-            if (r > 1.0E-8) Vnuc += mol->Z(iat) / r;
+    const int block = 128;
+    int nblock = (npoints + block - 1) / block;
+    int natom = mol->natom();
+
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (int blk = 0; blk < nblock; ++blk) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        int start = blk * block;
+        int n = std::min(block, npoints - start);
+        if (fitted) {
+            std::vector<double> x(n), y(n), z(n);
+            for (int i = 0; i < n; i++) {
+                x[i] = gp[start + i][0];
+                y[i] = gp[start + i][1];
+                z[i] = gp[start + i][2];
+            }
+            fitted->compute(n, x.data(), y.data(), z.data(), &vp[start], thread);
+        } else {
+            auto Zxyz = std::make_shared<Matrix>("ESP Points", n, 4);
+            double** Zp = Zxyz->pointer();
+            for (int i = 0; i < n; i++) {
+                Zp[i][0] = 1.0;
+                for (int x = 0; x < 3; x++) Zp[i][x + 1] = gp[start + i][x];
+            }
+            pot[thread]->set_charge_field(Zxyz);
+            ContractOverDensityFunctor contract(n, &vp[start], Dcart);
+            pot[thread]->compute(contract, skip);
+        }
+        for (int i = start; i < start + n; i++) {
+            Vector3 origin(gp[i][0], gp[i][1], gp[i][2]);
+            double Vnuc = 0.0;
+            for (int iat = 0; iat < natom; iat++) {
+                Vector3 dR = origin - mol->xyz(iat);
+                double r = dR.norm();
+                if (r > 1.0E-8) Vnuc += mol->Z(iat) / r;
+            }
+            vp[i] += Vnuc;
         }
-        double Vtot = Velec + Vnuc;
-        (*output)[i] = Vtot;
     }
     return output;
 }
 
+void OEProp::compute_fitted_charges(const std::string& scheme) {
+    SharedVector q = epc_.compute_fitted_charges(scheme, true);
+    auto apcs = std::make_shared<std::vector<double>>(q->pointer(), q->pointer() + q->dimpi()[0]);
+    wfn_->set_atomic_point_charges(apcs);
+
+    auto vec_apcs = std::make_shared<Matrix>(scheme + " Charges: (a.u.)", 1, apcs->size());
+    for (size_t i = 0; i < apcs->size(); i++) {
+        vec_apcs->set(0, i, (*apcs)[i]);
+    }
+    /*- Process::environment.arrays["CHELPG_CHARGES"] -*/
+    /*- Process::environment.arrays["MK_CHARGES"] -*/
+    /*- Process::environment.arrays["RESP_CHARGES"] -*/
+    wfn_->set_array(scheme + "_CHARGES", vec_apcs);
+}
+
+SharedVector ESPPropCalc::compute_fitted_charges(const std::string& scheme, bool print_output) {
+    Options& options = Process::environment.options;
+    std::shared_ptr<Molecule> mol = basisset_->molecule();
+    ChargeFit fit(mol);
+
+    SharedMatrix grid;
+    if (scheme == "CHELPG") {
+        grid = fit.chelpg_grid(options.get_double("CHELPG_SPACING"), options.get_double("CHELPG_MAX_DISTANCE"));
+    } else if (scheme == "MK" || scheme == "RESP") {
+        grid = fit.mk_grid(options.get_double("MK_POINT_DENSITY"));
+    } else {
+        throw PSIEXCEPTION("ESPPropCalc: unknown charge fitting scheme " + scheme);
+    }
+
+    SharedVector esp = compute_esp(grid);
+    double resp_a = scheme == "RESP" ? options.get_double("RESP_A") : 0.0;
+    SharedVector q = fit.fit(grid, esp, mol->molecular_charge(), resp_a, options.get_double("RESP_B"));
+
+    if (print_output) {
+        outfile->Printf("  %s Charges: (a.u.)\n", scheme.c_str());
+        outfile->Printf("   Center  Symbol    Charge\n");
+        double total = 0.0;
+        for (int A = 0; A < mol->natom(); A++) {
+            outfile->Printf("   %5d    %2s    %9.5f\n", A + 1, mol->label(A).c_str(), q->get(A));
+            total += q->get(A);
+        }
+        outfile->Printf("\n   Total charge = %9.5f, %d grid points, RMS error = %.3E, RRMS = %.4f\n", total,
+                        grid->rowdim(), fit.rms(), fit.rrms());
+        if (resp_a > 0.0) outfile->Printf("   RESP restraint converged in %d iterations\n", fit.iterations());
+        outfile->Printf("\n");
+    }
+    return q;
+}
+
 void OEProp::compute_field_over_grid() { epc_.compute_field_over_grid(true); }
 
 void ESPPropCalc::compute_field_over_grid(bool print_output) {
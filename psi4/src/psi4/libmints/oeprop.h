@@ -43,6 +43,7 @@ class Wavefunction;
 class IntegralFactory;
 class MatrixFactory;
 class BasisSet;
+class FittedESP;
 
 /**
  * The Prop object, base class of OEProp and GridProp objects
@@ -357,6 +358,11 @@ class ESPPropCalc : public Prop {
     std::vector<double> Eyvals_;
     std::vector<double> Ezvals_;
 
+    /// Density fitted to DF_BASIS_SCF if PROPERTIES_ESP_FIT is set, else nullptr
+    std::shared_ptr<FittedESP> fitted_esp(SharedMatrix Dtot) const;
+    /// Total SO density in the Cartesian AO basis, as the PCMPotentialInt kernel wants it
+    SharedMatrix cartesian_density() const;
+
    public:
     /// Constructor
     ESPPropCalc(std::shared_ptr<Wavefunction> wfn);
@@ -378,6 +384,10 @@ class ESPPropCalc : public Prop {
     void compute_field_over_grid(bool print_output = false);
     /// Compute electrostatic potential at grid points based on input grid, OpenMP version. input_grid is Nx3
     SharedVector compute_esp_over_grid_in_memory(SharedMatrix input_grid) const;
+    /// Total ESP at the points of an Nx3 grid in bohr, batched over points and threaded
+    SharedVector compute_esp(SharedMatrix grid) const;
+    /// Charges fitted to the ESP on a CHELPG, MK or RESP (MK grid, restrained) grid
+    SharedVector compute_fitted_charges(const std::string& scheme, bool print_output = false);
 };
 
 /**
@@ -425,6 +435,8 @@ class OEProp : public TaskListComputer {
     void compute_esp_over_grid();
     /// Compute field at specified grid points
     void compute_field_over_grid();
+    /// Compute ESP-fitted charges, scheme is CHELPG, MK or RESP
+    void compute_fitted_charges(const std::string& scheme);
 
     MultipolePropCalc mpc_;
     PopulationAnalysisCalc pac_;
@@ -256,6 +256,7 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
 
     double np[3];
     SymmetryOperation so;
+    AtomPositionHash atoms(mol, tol);
 
     // loop over all centers
     for (int i = 0; i < natom; i++) {
@@ -271,7 +272,7 @@ int **compute_atom_map(const Molecule *molecule, double tol, bool suppress_mol_p
                 for (int jj = 0; jj < 3; jj++) np[ii] += so(ii, jj) * ac[jj];
             }
 
-            atom_map[i][g] = mol.atom_at_position1(np, tol);
+            atom_map[i][g] = atoms.find(Vector3(np));
             if (atom_map[i][g] < 0) {
                 outfile->Printf("\tERROR: Symmetry operation %d did not map atom %d to another atom:\n", g, i + 1);
                 if (!suppress_mol_print_in_exc) {
@@ -487,6 +488,7 @@ void PetiteList::init(double tol) {
     // set up atom and shell mappings
     double np[3];
     SymmetryOperation so;
+    AtomPositionHash atoms(mol, tol);
 
     max_stablizer_ = nirrep_ / mol.max_nequivalent();
 
@@ -506,7 +508,7 @@ void PetiteList::init(double tol) {
                 for (int jj = 0; jj < 3; jj++) np[ii] += so(ii, jj) * ac[jj];
             }
 
-            atom_map_[i][g] = mol.atom_at_position1(np, tol);
+            atom_map_[i][g] = atoms.find(Vector3(np));
 
             // We want the list of operations that keeps the atom the same that is not E.
             if (atom_map_[i][g] == i) stablizer_[i] |= so.bit();
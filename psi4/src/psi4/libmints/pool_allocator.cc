@@ -0,0 +1,137 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "pool_allocator.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+namespace psi {
+namespace pool {
+
+namespace {
+
+// Blocks above this size go straight to the system; their allocation cost is
+// negligible next to the work done on them.
+constexpr size_t max_cached_block = size_t(64) << 20;
+// Upper bound on the memory one thread keeps cached
+constexpr size_t max_cached_total = size_t(256) << 20;
+
+// Bookkeeping stored in front of each aligned block
+struct Header {
+    void* raw;
+    size_t bytes;
+};
+constexpr size_t header_space = ((sizeof(Header) + alignment - 1) / alignment) * alignment;
+
+// Round up to one of four classes per power of two, at least one cache line
+size_t size_class(size_t bytes) {
+    if (bytes <= alignment) return alignment;
+    size_t p = 1;
+    while ((p << 1) < bytes) p <<= 1;
+    size_t step = (p >= 4 * alignment) ? p / 4 : alignment;
+    return ((bytes + step - 1) / step) * step;
+}
+
+void* system_allocate(size_t bytes) {
+    void* raw = std::malloc(bytes + header_space + alignment);
+    if (raw == nullptr) throw std::bad_alloc();
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw) + header_space;
+    start = (start + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    Header* header = reinterpret_cast<Header*>(start) - 1;
+    header->raw = raw;
+    header->bytes = bytes;
+    return reinterpret_cast<void*>(start);
+}
+
+Header* header_of(void* ptr) { return static_cast<Header*>(ptr) - 1; }
+
+// Set once the cache of a thread is gone, so blocks freed by late destructors
+// (e.g., of static objects) bypass it
+thread_local bool cache_destroyed = false;
+
+struct Cache {
+    std::unordered_map<size_t, std::vector<void*> > free_blocks;
+    size_t total = 0;
+
+    void clear() {
+        for (auto& kv : free_blocks)
+            for (void* ptr : kv.second) std::free(header_of(ptr)->raw);
+        free_blocks.clear();
+        total = 0;
+    }
+    ~Cache() {
+        clear();
+        cache_destroyed = true;
+    }
+};
+
+Cache& thread_cache() {
+    static thread_local Cache cache;
+    return cache;
+}
+
+}  // namespace
+
+void* allocate(size_t bytes) {
+    size_t rounded = size_class(bytes);
+    if (rounded <= max_cached_block && !cache_destroyed) {
+        Cache& cache = thread_cache();
+        auto it = cache.free_blocks.find(rounded);
+        if (it != cache.free_blocks.end() && !it->second.empty()) {
+            void* ptr = it->second.back();
+            it->second.pop_back();
+            cache.total -= rounded;
+            return ptr;
+        }
+    }
+    return system_allocate(rounded);
+}
+
+void deallocate(void* ptr) {
+    if (ptr == nullptr) return;
+    size_t bytes = header_of(ptr)->bytes;
+    if (bytes <= max_cached_block && !cache_destroyed) {
+        Cache& cache = thread_cache();
+        if (cache.total + bytes <= max_cached_total) {
+            cache.free_blocks[bytes].push_back(ptr);
+            cache.total += bytes;
+            return;
+        }
+    }
+    std::free(header_of(ptr)->raw);
+}
+
+void release_cache() {
+    if (!cache_destroyed) thread_cache().clear();
+}
+
+}  // namespace pool
+}  // namespace psi
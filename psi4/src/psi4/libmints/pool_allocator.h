@@ -0,0 +1,85 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_pool_allocator_h_
+#define _psi_src_lib_libmints_pool_allocator_h_
+
+#include "psi4/pragma.h"
+
+#include <cstddef>
+#include <new>
+
+namespace psi {
+
+/*! \ingroup MINTS
+ *  Storage for Matrix and Vector blocks.
+ *
+ *  Blocks are 64-byte aligned and rounded up to a size class (four classes per
+ *  power of two). Freed blocks are kept in a cache of the freeing thread and
+ *  handed back for the next request of the same class, so the temporaries of
+ *  doublet(), triplet(), clone() and friends reuse memory that is already
+ *  mapped instead of going back to the system allocator each time.
+ */
+namespace pool {
+
+/// Alignment in bytes of every block handed out
+constexpr size_t alignment = 64;
+
+/// Returns uninitialized storage of at least \p bytes bytes
+PSI_API void* allocate(size_t bytes);
+/// Returns a block from allocate() to the cache of the calling thread
+PSI_API void deallocate(void* ptr);
+/// Frees the blocks cached by the calling thread
+PSI_API void release_cache();
+
+/// std::allocator replacement backed by the pool, for std::vector storage
+template <class T>
+struct Allocator {
+    typedef T value_type;
+
+    Allocator() = default;
+    template <class U>
+    Allocator(const Allocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(pool::allocate(n * sizeof(T))); }
+    void deallocate(T* ptr, size_t) { pool::deallocate(ptr); }
+};
+
+template <class T, class U>
+bool operator==(const Allocator<T>&, const Allocator<U>&) {
+    return true;
+}
+template <class T, class U>
+bool operator!=(const Allocator<T>&, const Allocator<U>&) {
+    return false;
+}
+
+}  // namespace pool
+}  // namespace psi
+
+#endif
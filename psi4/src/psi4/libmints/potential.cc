@@ -37,6 +37,10 @@
 #include "psi4/physconst.h"
 #include "typedefs.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
 #define VDEBUG 1
@@ -88,6 +92,8 @@ PotentialInt::PotentialInt(std::vector<SphericalTransform> &st, std::shared_ptr<
         Zxyzp[A][2] = bs1_->molecule()->y(A);
         Zxyzp[A][3] = bs1_->molecule()->z(A);
     }
+
+    set_far_field_tolerance(1.0E-15);
 }
 
 PotentialInt::~PotentialInt() {
@@ -95,6 +101,176 @@ PotentialInt::~PotentialInt() {
     delete potential_recur_;
 }
 
+void PotentialInt::set_far_field_tolerance(double tol) {
+    const int maxL = bs1_->max_am() + bs2_->max_am();
+    far_T_.assign(maxL + 1, std::numeric_limits<double>::max());
+    if (tol <= 0.0) return;
+
+    // Same criterion as Taylor_Fjt: T^{m-1/2} exp(-T) = tol * Gamma(m+1/2) gives the T
+    // past which the asymptotic F_m(T) is good to tol. A pair with am1 + am2 = L needs F_0 ... F_L.
+    double T_max = 0.0;
+    for (int L = 0; L <= maxL; ++L) {
+        const double rhs = -std::log(tol * std::tgamma(L + 0.5));
+        double T = std::max(1.0, -std::log(tol));
+        for (int iter = 0; iter < 100; ++iter) T = rhs + (L - 0.5) * std::log(T);
+        T_max = std::max(T_max, T);
+        far_T_[L] = T_max;
+    }
+}
+
+void PotentialInt::reserve_far_charges(size_t n) {
+    if (far_q_.size() >= n) return;
+    far_q_.resize(n);
+    far_x_.resize(n);
+    far_y_.resize(n);
+    far_z_.resize(n);
+}
+
+void PotentialInt::far_field(int am1, int am2, const double *PA, const double *PB, double gamma, double prefac,
+                             size_t nfar) {
+    const int L = am1 + am2;
+    const int n1 = am1 + 1;
+    const int n2 = am2 + 1;
+    const int nt = L + 1;
+
+    // Hermite expansion E^{ij}_t of the primitive product, per Cartesian direction,
+    // with the exp(-mu AB^2) factor left in prefac (McMurchie-Davidson recursion)
+    herm_E_.assign(3 * n1 * n2 * nt, 0.0);
+    auto E = [&](int d, int i, int j, int t) -> double & { return herm_E_[((d * n1 + i) * n2 + j) * nt + t]; };
+    const double oo2g = 0.5 / gamma;
+    for (int d = 0; d < 3; ++d) {
+        E(d, 0, 0, 0) = 1.0;
+        for (int i = 0; i <= am1; ++i) {
+            for (int j = 0; j <= am2; ++j) {
+                if (i == 0 && j == 0) continue;
+                // Step up i from (i-1, j), or j from (0, j-1)
+                const int pi = (i > 0) ? i - 1 : 0;
+                const int pj = (i > 0) ? j : j - 1;
+                const double XP = (i > 0) ? PA[d] : PB[d];
+                for (int t = 0; t <= i + j; ++t) {
+                    double val = XP * E(d, pi, pj, t);
+                    if (t > 0) val += oo2g * E(d, pi, pj, t - 1);
+                    if (t + 1 < nt) val += (t + 1) * E(d, pi, pj, t + 1);
+                    E(d, i, j, t) = val;
+                }
+            }
+        }
+    }
+
+    // Index of the Hermite component tuv, t + u + v <= L
+    herm_index_.assign(nt * nt * nt, -1);
+    int ntuv = 0;
+    for (int t = 0; t <= L; ++t)
+        for (int u = 0; u <= L - t; ++u)
+            for (int v = 0; v <= L - t - u; ++v) herm_index_[(t * nt + u) * nt + v] = ntuv++;
+    auto index = [&](int t, int u, int v) { return herm_index_[(t * nt + u) * nt + v]; };
+
+    // W_tuv = sum_C q_C d^{t+u+v} / dPx^t dPy^u dPz^v (1 / |P - C|), built per block of charges
+    // from R^{(n)}_{000} = (-1)^n (2n-1)!! / R^{2n+1} by the usual Hermite recursion
+    const size_t block = 32;
+    herm_W_.assign(ntuv, 0.0);
+    herm_R_.resize((2 * ntuv + nt) * block);
+    double *W = herm_W_.data();
+    double *levels[2] = {herm_R_.data(), herm_R_.data() + ntuv * block};
+    double *base = herm_R_.data() + 2 * ntuv * block;
+
+    for (size_t c0 = 0; c0 < nfar; c0 += block) {
+        const size_t nc = std::min(block, nfar - c0);
+        const double *X = far_x_.data() + c0;
+        const double *Y = far_y_.data() + c0;
+        const double *Z = far_z_.data() + c0;
+        const double *q = far_q_.data() + c0;
+
+#pragma omp simd
+        for (size_t k = 0; k < nc; ++k) base[k] = 1.0 / std::sqrt(X[k] * X[k] + Y[k] * Y[k] + Z[k] * Z[k]);
+        for (int n = 1; n <= L; ++n) {
+            const double fac = -(2.0 * n - 1.0);
+            double *bn = base + n * block;
+            const double *bm = base + (n - 1) * block;
+#pragma omp simd
+            for (size_t k = 0; k < nc; ++k) bn[k] = fac * bm[k] * base[k] * base[k];
+        }
+
+        for (int n = L; n >= 0; --n) {
+            double *cur = levels[n % 2];
+            const double *prev = levels[(n + 1) % 2];
+            for (int t = 0; t <= L - n; ++t) {
+                for (int u = 0; u <= L - n - t; ++u) {
+                    for (int v = 0; v <= L - n - t - u; ++v) {
+                        double *out = cur + index(t, u, v) * block;
+                        // Recurse on the first non-zero index
+                        int m;
+                        const double *XC;
+                        const double *a;
+                        const double *b = nullptr;
+                        if (t > 0) {
+                            m = t - 1;
+                            XC = X;
+                            a = prev + index(t - 1, u, v) * block;
+                            if (t > 1) b = prev + index(t - 2, u, v) * block;
+                        } else if (u > 0) {
+                            m = u - 1;
+                            XC = Y;
+                            a = prev + index(t, u - 1, v) * block;
+                            if (u > 1) b = prev + index(t, u - 2, v) * block;
+                        } else if (v > 0) {
+                            m = v - 1;
+                            XC = Z;
+                            a = prev + index(t, u, v - 1) * block;
+                            if (v > 1) b = prev + index(t, u, v - 2) * block;
+                        } else {
+                            std::copy(base + n * block, base + n * block + nc, out);
+                            continue;
+                        }
+                        if (b) {
+#pragma omp simd
+                            for (size_t k = 0; k < nc; ++k) out[k] = XC[k] * a[k] + m * b[k];
+                        } else {
+#pragma omp simd
+                            for (size_t k = 0; k < nc; ++k) out[k] = XC[k] * a[k];
+                        }
+                    }
+                }
+            }
+        }
+
+        const double *R0 = levels[0];
+        for (int tuv = 0; tuv < ntuv; ++tuv) {
+            const double *r = R0 + tuv * block;
+            double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+            for (size_t k = 0; k < nc; ++k) sum += q[k] * r[k];
+            W[tuv] += sum;
+        }
+    }
+
+    // Contract with the Hermite coefficients, in the Cartesian order of compute_pair
+    int ao12 = 0;
+    for (int ii = 0; ii <= am1; ii++) {
+        int l1 = am1 - ii;
+        for (int jj = 0; jj <= ii; jj++) {
+            int m1 = ii - jj;
+            int n1c = jj;
+            for (int kk = 0; kk <= am2; kk++) {
+                int l2 = am2 - kk;
+                for (int ll = 0; ll <= kk; ll++) {
+                    int m2 = kk - ll;
+                    int n2c = ll;
+                    double val = 0.0;
+                    for (int t = 0; t <= l1 + l2; ++t) {
+                        const double Ex = E(0, l1, l2, t);
+                        for (int u = 0; u <= m1 + m2; ++u) {
+                            const double Exy = Ex * E(1, m1, m2, u);
+                            for (int v = 0; v <= n1c + n2c; ++v) val += Exy * E(2, n1c, n2c, v) * W[index(t, u, v)];
+                        }
+                    }
+                    buffer_[ao12++] += prefac * val;
+                }
+            }
+        }
+    }
+}
+
 // The engine only supports segmented basis sets
 void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2) {
     int ao12;
@@ -129,6 +305,7 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
 
     double **Zxyzp = Zxyz_->pointer();
     int ncharge = Zxyz_->rowspi()[0];
+    reserve_far_charges(ncharge);
 
     for (int p1 = 0; p1 < nprim1; ++p1) {
         double a1 = s1.exp(p1);
@@ -154,6 +331,10 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
 
             double over_pf = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
 
+            // Charges with |PC|^2 beyond this are collected for far_field()
+            const double far_PC2 = far_T_[am1 + am2] * oog;
+            size_t nfar = 0;
+
             // Loop over atoms of basis set 1 (only works if bs1_ and bs2_ are on the same
             // molecule)
             for (int atom = 0; atom < ncharge; ++atom) {
@@ -165,6 +346,15 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
                 PC[1] = P[1] - Zxyzp[atom][2];
                 PC[2] = P[2] - Zxyzp[atom][3];
 
+                if (PC[0] * PC[0] + PC[1] * PC[1] + PC[2] * PC[2] > far_PC2) {
+                    far_q_[nfar] = -Z;
+                    far_x_[nfar] = PC[0];
+                    far_y_[nfar] = PC[1];
+                    far_z_[nfar] = PC[2];
+                    nfar++;
+                    continue;
+                }
+
                 // Do recursion
                 potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
 
@@ -195,6 +385,8 @@ void PotentialInt::compute_pair(const GaussianShell &s1, const GaussianShell &s2
                     }
                 }
             }
+
+            if (nfar) far_field(am1, am2, PA, PB, gamma, over_pf, nfar);
         }
     }
 }
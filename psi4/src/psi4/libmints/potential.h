@@ -62,6 +62,25 @@ class PotentialInt : public OneBodyAOInt {
     /// Matrix of coordinates/charges of partial charges
     SharedMatrix Zxyz_;
 
+    /// gamma |PC|^2 beyond which a charge takes the far-field path, indexed by am1 + am2
+    std::vector<double> far_T_;
+    /// Far-field charges of the current primitive pair, as (q, PCx, PCy, PCz) blocks
+    std::vector<double> far_q_, far_x_, far_y_, far_z_;
+    /// Scratch for far_field(): Hermite coefficients, Hermite integrals, their charge sums
+    std::vector<double> herm_E_, herm_R_, herm_W_;
+    std::vector<int> herm_index_;
+
+    /**
+     * Adds the potential of nfar charges in far_q_ (at P - far_x_/_y_/_z_) on one
+     * primitive pair to buffer_, scaled by prefac. Outside the product distribution
+     * erf(sqrt(gamma) R) = 1, so the Boys functions become powers of 1/R and each
+     * Hermite component of the pair sees a plain multipole derivative of 1/R. The
+     * charges are done in blocks, vectorized over charges.
+     */
+    void far_field(int am1, int am2, const double* PA, const double* PB, double gamma, double prefac, size_t nfar);
+    /// Makes sure the far-field charge blocks hold n charges
+    void reserve_far_charges(size_t n);
+
    public:
     /// Constructor. Assumes nuclear centers/charges as the potential
     PotentialInt(std::vector<SphericalTransform>&, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>, int deriv = 0);
@@ -85,6 +104,14 @@ class PotentialInt : public OneBodyAOInt {
     /// Get the field of charges
     SharedMatrix charge_field() const { return Zxyz_; }
 
+    /**
+     * Relative accuracy of the Boys function at which a charge counts as far
+     * from a primitive pair and goes through far_field() instead of the
+     * Obara-Saika recursion. The default 1e-15 matches the Taylor_Fjt used
+     * for the ERIs; 0 disables the far-field path.
+     */
+    void set_far_field_tolerance(double tol);
+
     /// Does the method provide first derivatives?
     bool has_deriv1() { return true; }
 };
@@ -36,6 +36,8 @@
 #include "psi4/libmints/osrecur.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
+#include <vector>
+
 namespace psi {
 
 class GaussianShell;
@@ -54,19 +56,31 @@ class BasisSet;
  * NB: This code must be specified in the .h file in order for the compiler to properly in-line the functors. (TDC)
  */
 class PCMPotentialInt : public PotentialInt {
+   protected:
+    /// Per primitive pair of the current shell pair: gamma, P, PA, PB and the overlap prefactor
+    std::vector<double> prim_pairs_;
+    /// Per Cartesian component pair of the current shell pair: the (i, j) index into the recursion
+    std::vector<int> rec_index_;
+
    public:
     PCMPotentialInt(std::vector<SphericalTransform> &, std::shared_ptr<BasisSet>, std::shared_ptr<BasisSet>,
                     int deriv = 0);
-    /// Drives the loops over all shell pairs, to compute integrals
+    /*! Drives the loops over all shell pairs, to compute integrals
+     *  \param[in] skip_pair if not empty, shell pair (i, j) is skipped when skip_pair[i * nshell2 + j] is set
+     */
     template <typename PCMPotentialIntFunctor>
-    void compute(PCMPotentialIntFunctor &functor);
+    void compute(PCMPotentialIntFunctor &functor, const std::vector<bool> &skip_pair = std::vector<bool>());
 };
 
 template <typename PCMPotentialIntFunctor>
-void PCMPotentialInt::compute(PCMPotentialIntFunctor &functor) {
+void PCMPotentialInt::compute(PCMPotentialIntFunctor &functor, const std::vector<bool> &skip_pair) {
     // Do not worry about zeroing out result
     int ns1 = bs1_->nshell();
     int ns2 = bs2_->nshell();
+    double ***vi = potential_recur_->vi();
+    double **Zxyzp = Zxyz_->pointer();
+    int ncharge = Zxyz_->rowspi()[0];
+
     int bf1_offset = 0;
     for (int i = 0; i < ns1; ++i) {
         const GaussianShell &s1 = bs1_->shell(i);
@@ -75,116 +89,98 @@ void PCMPotentialInt::compute(PCMPotentialIntFunctor &functor) {
         for (int j = 0; j < ns2; ++j) {
             const GaussianShell &s2 = bs2_->shell(j);
             int nj = s2.ncartesian();
-            // Compute the shell
+            if (!skip_pair.empty() && skip_pair[i * ns2 + j]) {
+                bf2_offset += nj;
+                continue;
+            }
 
-            int ao12;
             int am1 = s1.am();
             int am2 = s2.am();
             int nprim1 = s1.nprimitive();
             int nprim2 = s2.nprimitive();
-            double A[3], B[3];
-            A[0] = s1.center()[0];
-            A[1] = s1.center()[1];
-            A[2] = s1.center()[2];
-            B[0] = s2.center()[0];
-            B[1] = s2.center()[1];
-            B[2] = s2.center()[2];
-
-            int izm = 1;
-            int iym = am1 + 1;
-            int ixm = iym * iym;
-            int jzm = 1;
-            int jym = am2 + 1;
-            int jxm = jym * jym;
+            const double *A = s1.center();
+            const double *B = s2.center();
 
-            // compute intermediates
             double AB2 = 0.0;
             AB2 += (A[0] - B[0]) * (A[0] - B[0]);
             AB2 += (A[1] - B[1]) * (A[1] - B[1]);
             AB2 += (A[2] - B[2]) * (A[2] - B[2]);
 
-            double ***vi = potential_recur_->vi();
+            // Nothing below depends on the charge, so it is formed once per shell pair and
+            // the charge loop is left with the recursion and one flat accumulation
+            int npair = nprim1 * nprim2;
+            prim_pairs_.resize(11 * npair);
+            for (int p1 = 0, pp = 0; p1 < nprim1; ++p1) {
+                double a1 = s1.exp(p1);
+                double c1 = s1.coef(p1);
+                for (int p2 = 0; p2 < nprim2; ++p2, ++pp) {
+                    double a2 = s2.exp(p2);
+                    double c2 = s2.coef(p2);
+                    double gamma = a1 + a2;
+                    double oog = 1.0 / gamma;
+                    double *data = &prim_pairs_[11 * pp];
+                    data[0] = gamma;
+                    for (int x = 0; x < 3; ++x) {
+                        data[1 + x] = (a1 * A[x] + a2 * B[x]) * oog;
+                        data[4 + x] = data[1 + x] - A[x];
+                        data[7 + x] = data[1 + x] - B[x];
+                    }
+                    data[10] = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
+                }
+            }
 
-            double **Zxyzp = Zxyz_->pointer();
-            int ncharge = Zxyz_->rowspi()[0];
+            int izm = 1;
+            int iym = am1 + 1;
+            int ixm = iym * iym;
+            int jzm = 1;
+            int jym = am2 + 1;
+            int jxm = jym * jym;
+            int n12 = ni * nj;
+            rec_index_.resize(2 * n12);
+            int ao12 = 0;
+            for (int ii = 0; ii <= am1; ii++) {
+                int l1 = am1 - ii;
+                for (int jj = 0; jj <= ii; jj++) {
+                    int m1 = ii - jj;
+                    int n1 = jj;
+                    /*--- create all am components of sj ---*/
+                    for (int kk = 0; kk <= am2; kk++) {
+                        int l2 = am2 - kk;
+                        for (int ll = 0; ll <= kk; ll++) {
+                            int m2 = kk - ll;
+                            int n2 = ll;
+                            rec_index_[2 * ao12] = l1 * ixm + m1 * iym + n1 * izm;
+                            rec_index_[2 * ao12 + 1] = l2 * jxm + m2 * jym + n2 * jzm;
+                            ao12++;
+                        }
+                    }
+                }
+            }
 
             for (int atom = 0; atom < ncharge; ++atom) {
-                memset(buffer_, 0, s1.ncartesian() * s2.ncartesian() * sizeof(double));
-                double PC[3];
-
+                memset(buffer_, 0, n12 * sizeof(double));
                 double Z = Zxyzp[atom][0];
-
-                double C[3];
-                C[0] = Zxyzp[atom][1];
-                C[1] = Zxyzp[atom][2];
-                C[2] = Zxyzp[atom][3];
-                for (int p1 = 0; p1 < nprim1; ++p1) {
-                    double a1 = s1.exp(p1);
-                    double c1 = s1.coef(p1);
-                    for (int p2 = 0; p2 < nprim2; ++p2) {
-                        double a2 = s2.exp(p2);
-                        double c2 = s2.coef(p2);
-                        double gamma = a1 + a2;
-                        double oog = 1.0 / gamma;
-
-                        double PA[3], PB[3], P[3];
-                        P[0] = (a1 * A[0] + a2 * B[0]) * oog;
-                        P[1] = (a1 * A[1] + a2 * B[1]) * oog;
-                        P[2] = (a1 * A[2] + a2 * B[2]) * oog;
-                        PA[0] = P[0] - A[0];
-                        PA[1] = P[1] - A[1];
-                        PA[2] = P[2] - A[2];
-                        PB[0] = P[0] - B[0];
-                        PB[1] = P[1] - B[1];
-                        PB[2] = P[2] - B[2];
-                        PC[0] = P[0] - C[0];
-                        PC[1] = P[1] - C[1];
-                        PC[2] = P[2] - C[2];
-
-                        double over_pf = exp(-a1 * a2 * AB2 * oog) * sqrt(M_PI * oog) * M_PI * oog * c1 * c2;
-
-                        // Do recursion
-                        potential_recur_->compute(PA, PB, PC, gamma, am1, am2);
-
-                        ao12 = 0;
-                        for (int ii = 0; ii <= am1; ii++) {
-                            int l1 = am1 - ii;
-                            for (int jj = 0; jj <= ii; jj++) {
-                                int m1 = ii - jj;
-                                int n1 = jj;
-                                /*--- create all am components of sj ---*/
-                                for (int kk = 0; kk <= am2; kk++) {
-                                    int l2 = am2 - kk;
-                                    for (int ll = 0; ll <= kk; ll++) {
-                                        int m2 = kk - ll;
-                                        int n2 = ll;
-
-                                        // Compute location in the recursion and store the value
-                                        int iind = l1 * ixm + m1 * iym + n1 * izm;
-                                        int jind = l2 * jxm + m2 * jym + n2 * jzm;
-                                        buffer_[ao12++] += -vi[iind][jind][0] * over_pf * Z;
-                                    }
-                                }
-                            }
-                        }
-                    }  // End loop over primitives of shell 2
-                }      // End loop over primitives of shell 1
+                const double *C = &Zxyzp[atom][1];
+                for (int pp = 0; pp < npair; ++pp) {
+                    double *data = &prim_pairs_[11 * pp];
+                    double PC[3];
+                    PC[0] = data[1] - C[0];
+                    PC[1] = data[2] - C[1];
+                    PC[2] = data[3] - C[2];
+
+                    // Do recursion
+                    potential_recur_->compute(&data[4], &data[7], PC, data[0], am1, am2);
+
+                    double pf = -data[10] * Z;
+                    for (int k = 0; k < n12; ++k) {
+                        buffer_[k] += vi[rec_index_[2 * k]][rec_index_[2 * k + 1]][0] * pf;
+                    }
+                }  // End loop over primitive pairs
                 ao12 = 0;
-                int ao1 = 0;
-                for (int ii = 0; ii <= am1; ii++) {
-                    for (int jj = 0; jj <= ii; jj++) {
-                        /*--- create all am components of sj ---*/
-                        int ao2 = 0;
-                        for (int kk = 0; kk <= am2; kk++) {
-                            for (int ll = 0; ll <= kk; ll++) {
-                                // Compute location in the recursion
-                                double val = buffer_[ao12++];
-                                // Hand the work off to the functor
-                                functor(ao1 + bf1_offset, ao2 + bf2_offset, atom, val);
-                                ao2++;
-                            }
-                        }
-                        ao1++;
+                for (int ao1 = 0; ao1 < ni; ++ao1) {
+                    for (int ao2 = 0; ao2 < nj; ++ao2) {
+                        // Hand the work off to the functor
+                        functor(ao1 + bf1_offset, ao2 + bf2_offset, atom, buffer_[ao12++]);
                     }
                 }
             }  // End loop over points
@@ -35,10 +35,52 @@
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
+namespace {
+
+/// The (MN|MN) table of the last sieve built on a basis, with the shell centers it was built at
+struct SieveGeometryRecord {
+    std::vector<int> am;
+    std::vector<int> nprimitive;
+    std::vector<double> exp0;
+    std::vector<double> centers;
+    std::vector<double> shell_pair_values;
+};
+
+std::map<std::string, SieveGeometryRecord> sieve_geometry_records;
+std::mutex sieve_geometry_mutex;
+
+std::string sieve_geometry_key(std::shared_ptr<BasisSet> basis) {
+    return basis->name() + ":" + std::to_string(basis->nshell()) + ":" + std::to_string(basis->nbf());
+}
+
+/// Same shells in the same order, so the old table can be indexed as the new one
+bool same_shell_structure(const SieveGeometryRecord &record, std::shared_ptr<BasisSet> basis) {
+    if ((int)record.am.size() != basis->nshell()) return false;
+    for (int P = 0; P < basis->nshell(); P++) {
+        const GaussianShell &shell = basis->shell(P);
+        if (record.am[P] != shell.am() || record.nprimitive[P] != shell.nprimitive() ||
+            record.exp0[P] != shell.exp(0))
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
 ERISieve::ERISieve(std::shared_ptr<BasisSet> primary, double sieve) : primary_(primary), sieve_(sieve) {
     common_init();
 }
@@ -55,6 +97,9 @@ void ERISieve::common_init() {
     //    erfc_thresh_ = DBL_MAX;
 
     Options &options = Process::environment.options;
+    reuse_tolerance_ = options.get_double("SIEVE_REUSE_TOLERANCE");
+    nreused_ = 0;
+    candidate_sieve_ = 0.0;
     do_qqr_ = false;  // Code below for QQR was/is utterly broken.
 
     debug_ = 0;
@@ -65,60 +110,54 @@ void ERISieve::common_init() {
 
 void ERISieve::set_sieve(double sieve) {
     sieve_ = sieve;
+    // A tighter cutoff than the candidate pairs were built for needs the bounds redone
+    if (sieve_ < candidate_sieve_) integrals();
     sieve2_ = sieve_ * sieve;
     sieve_over_max_ = sieve_ / max_;
     sieve2_over_max_ = sieve2_ / max_;
 
-    shell_pairs_.clear();
-    function_pairs_.clear();
-    shell_pairs_reverse_.resize(nshell_ * (nshell_ + 1L) / 2L);
-    function_pairs_reverse_.resize(nbf_ * (nbf_ + 1L) / 2L);
-
-    long int offset = 0L;
-    size_t MUNU = 0L;
+    // Significant partners of every shell, straight from the candidate pairs
+    shell_pair_list_.offsets.assign(nshell_ + 1L, 0L);
+    shell_pair_list_.partners.clear();
     for (int MU = 0; MU < nshell_; MU++) {
-        for (int NU = 0; NU <= MU; NU++, MUNU++) {
-            if (shell_pair_values_[MU * (size_t)nshell_ + NU] >= sieve2_over_max_) {
-                shell_pairs_.push_back(std::make_pair(MU, NU));
-                shell_pairs_reverse_[MUNU] = offset;
-                offset++;
-            } else {
-                shell_pairs_reverse_[MUNU] = -1L;
-            }
-        }
-    }
-
-    offset = 0L;
-    size_t munu = 0L;
-    for (int mu = 0; mu < nbf_; mu++) {
-        for (int nu = 0; nu <= mu; nu++, munu++) {
-            if (function_pair_values_[mu * (size_t)nbf_ + nu] >= sieve2_over_max_) {
-                function_pairs_.push_back(std::make_pair(mu, nu));
-                function_pairs_reverse_[munu] = offset;
-                offset++;
-            } else {
-                function_pairs_reverse_[munu] = -1L;
+        for (const int *NU = candidate_pairs_.begin(MU); NU != candidate_pairs_.end(MU); ++NU) {
+            if (shell_pair_values_[MU * (size_t)nshell_ + *NU] >= sieve2_over_max_) {
+                shell_pair_list_.partners.push_back(*NU);
             }
         }
+        shell_pair_list_.offsets[MU + 1] = shell_pair_list_.partners.size();
     }
 
+    shell_pairs_.clear();
+    function_pairs_.clear();
+    shell_pairs_reverse_.assign(nshell_ * (nshell_ + 1L) / 2L, -1L);
+    function_pairs_reverse_.assign(nbf_ * (nbf_ + 1L) / 2L, -1L);
     shell_to_shell_.clear();
     function_to_function_.clear();
     shell_to_shell_.resize(nshell_);
     function_to_function_.resize(nbf_);
 
+    // Function pairs carry their shell pair's bound, so they follow the shell lists
     for (int MU = 0; MU < nshell_; MU++) {
-        for (int NU = 0; NU < nshell_; NU++) {
-            if (shell_pair_values_[MU * (size_t)nshell_ + NU] >= sieve2_over_max_) {
-                shell_to_shell_[MU].push_back(NU);
-            }
+        shell_to_shell_[MU].assign(shell_pair_list_.begin(MU), shell_pair_list_.end(MU));
+        for (const int *NU = shell_pair_list_.begin(MU); NU != shell_pair_list_.end(MU) && *NU <= MU; ++NU) {
+            shell_pairs_reverse_[MU * (MU + 1L) / 2L + *NU] = shell_pairs_.size();
+            shell_pairs_.push_back(std::make_pair(MU, *NU));
         }
-    }
 
-    for (int mu = 0; mu < nbf_; mu++) {
-        for (int nu = 0; nu < nbf_; nu++) {
-            if (function_pair_values_[mu * (size_t)nbf_ + nu] >= sieve2_over_max_) {
-                function_to_function_[mu].push_back(nu);
+        int nmu = primary_->shell(MU).nfunction();
+        int omu = primary_->shell(MU).function_index();
+        for (int mu = omu; mu < omu + nmu; mu++) {
+            for (const int *NU = shell_pair_list_.begin(MU); NU != shell_pair_list_.end(MU); ++NU) {
+                int nnu = primary_->shell(*NU).nfunction();
+                int onu = primary_->shell(*NU).function_index();
+                for (int nu = onu; nu < onu + nnu; nu++) {
+                    function_to_function_[mu].push_back(nu);
+                    if (nu <= mu) {
+                        function_pairs_reverse_[mu * (mu + 1L) / 2L + nu] = function_pairs_.size();
+                        function_pairs_.push_back(std::make_pair(mu, nu));
+                    }
+                }
             }
         }
     }
@@ -195,6 +234,116 @@ void ERISieve::set_sieve(double sieve) {
     }
 }
 
+ShellPairList ERISieve::distance_pairs(std::shared_ptr<BasisSet> basis, double sieve) {
+    int nshell = basis->nshell();
+    ShellPairList list;
+    list.offsets.resize(nshell + 1L);
+    list.offsets[0] = 0L;
+
+    if (sieve <= 0.0) {
+        for (int P = 0; P < nshell; P++) {
+            for (int Q = 0; Q < nshell; Q++) list.partners.push_back(Q);
+            list.offsets[P + 1] = list.partners.size();
+        }
+        return list;
+    }
+
+    // (PQ|PQ) falls off at least as exp(-min(a_P, a_Q) R^2) for the most diffuse exponents a on
+    // either shell. The 1E-8 margin covers contraction, normalization and angular factors.
+    double L = -std::log(sieve * sieve * 1.0E-8);
+    std::vector<double> radius(nshell);
+    for (int P = 0; P < nshell; P++) {
+        const GaussianShell &shell = basis->shell(P);
+        double amin = shell.exp(0);
+        for (int K = 1; K < shell.nprimitive(); K++) amin = std::min(amin, shell.exp(K));
+        radius[P] = std::sqrt(L / amin);
+    }
+
+    // Bin the shells into cubic cells about as wide as the typical radius, then each shell only
+    // scans the cells its own radius reaches. A pair is kept if either shell's radius covers it.
+    double rsum = 0.0;
+    for (int P = 0; P < nshell; P++) rsum += radius[P];
+    double h = std::max(rsum / std::max(nshell, 1), 1.0);
+    double lo[3] = {0.0, 0.0, 0.0};
+    for (int P = 0; P < nshell; P++) {
+        for (int x = 0; x < 3; x++) lo[x] = (P == 0 ? basis->shell(P).center()[x]
+                                                    : std::min(lo[x], basis->shell(P).center()[x]));
+    }
+    std::vector<long int> cell(3L * nshell);
+    std::map<std::tuple<long int, long int, long int>, std::vector<int> > cells;
+    for (int P = 0; P < nshell; P++) {
+        for (int x = 0; x < 3; x++) cell[3 * P + x] = (long int)std::floor((basis->shell(P).center()[x] - lo[x]) / h);
+        cells[std::make_tuple(cell[3 * P], cell[3 * P + 1], cell[3 * P + 2])].push_back(P);
+    }
+
+    std::vector<std::vector<int> > rows(nshell);
+    for (int P = 0; P < nshell; P++) {
+        const double *A = basis->shell(P).center();
+        long int reach = (long int)std::ceil(radius[P] / h);
+        double r2 = radius[P] * radius[P];
+        for (long int i = cell[3 * P] - reach; i <= cell[3 * P] + reach; i++) {
+            for (long int j = cell[3 * P + 1] - reach; j <= cell[3 * P + 1] + reach; j++) {
+                for (long int k = cell[3 * P + 2] - reach; k <= cell[3 * P + 2] + reach; k++) {
+                    auto it = cells.find(std::make_tuple(i, j, k));
+                    if (it == cells.end()) continue;
+                    for (int Q : it->second) {
+                        const double *B = basis->shell(Q).center();
+                        double R2 = (A[0] - B[0]) * (A[0] - B[0]) + (A[1] - B[1]) * (A[1] - B[1]) +
+                                    (A[2] - B[2]) * (A[2] - B[2]);
+                        if (R2 > r2) continue;
+                        rows[P].push_back(Q);
+                        rows[Q].push_back(P);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int P = 0; P < nshell; P++) {
+        std::sort(rows[P].begin(), rows[P].end());
+        rows[P].erase(std::unique(rows[P].begin(), rows[P].end()), rows[P].end());
+        list.partners.insert(list.partners.end(), rows[P].begin(), rows[P].end());
+        list.offsets[P + 1] = list.partners.size();
+    }
+    return list;
+}
+
+double ERISieve::reused_pair_value(int P, int Q, const std::vector<double> &centers,
+                                   const std::vector<double> &old_centers,
+                                   const std::vector<double> &old_values) const {
+    // (PQ|PQ) only depends on R = P - Q, so a pair whose separation vector barely changed keeps its
+    // bound. Pairs on one center (R = 0 in both geometries) are reused exactly.
+    double R2 = 0.0;
+    double dR2 = 0.0;
+    for (int x = 0; x < 3; x++) {
+        double R = centers[3 * P + x] - centers[3 * Q + x];
+        double Rold = old_centers[3 * P + x] - old_centers[3 * Q + x];
+        R2 += R * R;
+        dR2 += (R - Rold) * (R - Rold);
+    }
+    double dR = std::sqrt(dR2);
+    if (dR > reuse_tolerance_) return -1.0;
+
+    // Zero means the pair was left out by distance last time, not that it is small now
+    double value = old_values[P * (size_t)nshell_ + Q];
+    if (value == 0.0) return -1.0;
+    if (dR == 0.0) return value;
+
+    // Stay conservative: the diagonal falls off as exp(-2 mu R^2) in the most compact primitive pair
+    // mu = a b / (a + b), and |R_old| <= |R| + dR, so the old value grows by at most this factor.
+    const GaussianShell &sP = primary_->shell(P);
+    const GaussianShell &sQ = primary_->shell(Q);
+    double mu = 0.0;
+    for (int p = 0; p < sP.nprimitive(); p++) {
+        for (int q = 0; q < sQ.nprimitive(); q++) {
+            double a = sP.exp(p);
+            double b = sQ.exp(q);
+            mu = std::max(mu, a * b / (a + b));
+        }
+    }
+    return value * std::exp(2.0 * mu * dR * (2.0 * std::sqrt(R2) + dR));
+}
+
 void ERISieve::integrals() {
     int nshell = primary_->nshell();
     int nbf = primary_->nbf();
@@ -208,24 +357,68 @@ void ERISieve::integrals() {
     ::memset(&shell_pair_values_[0], '\0', sizeof(double) * nshell * nshell);
     max_ = 0.0;
 
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
     IntegralFactory schwarzfactory(primary_, primary_, primary_, primary_);
-    std::shared_ptr<TwoBodyAOInt> eri = std::shared_ptr<TwoBodyAOInt>(schwarzfactory.eri());
-    const double *buffer = eri->buffer();
+    std::vector<std::shared_ptr<TwoBodyAOInt> > eris;
+    std::vector<const double *> buffers;
+    for (int thread = 0; thread < nthread; thread++) {
+        eris.push_back(std::shared_ptr<TwoBodyAOInt>(schwarzfactory.eri()));
+        buffers.push_back(eris[thread]->buffer());
+    }
+
+    std::vector<double> centers(3L * nshell);
+    for (int P = 0; P < nshell; P++) {
+        const GaussianShell &shell = primary_->shell(P);
+        for (int x = 0; x < 3; x++) centers[3 * P + x] = shell.center()[x];
+    }
+
+    // A previous geometry's table for this basis, if reuse is on and its shells line up with ours
+    SieveGeometryRecord previous;
+    bool reuse = false;
+    if (reuse_tolerance_ > 0.0) {
+        std::lock_guard<std::mutex> lock(sieve_geometry_mutex);
+        auto it = sieve_geometry_records.find(sieve_geometry_key(primary_));
+        if (it != sieve_geometry_records.end() && same_shell_structure(it->second, primary_)) {
+            previous = it->second;
+            reuse = true;
+        }
+    }
 
+    candidate_sieve_ = sieve_;
+    candidate_pairs_ = distance_pairs(primary_, sieve_);
+
+    double max_all = 0.0;
+    size_t nreused = 0L;
+#pragma omp parallel for schedule(dynamic) num_threads(nthread) reduction(max : max_all) reduction(+ : nreused)
     for (int P = 0; P < nshell_; P++) {
-        for (int Q = 0; Q <= P; Q++) {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        const double *buffer = buffers[thread];
+        for (const int *Qp = candidate_pairs_.begin(P); Qp != candidate_pairs_.end(P) && *Qp <= P; ++Qp) {
+            int Q = *Qp;
             int nP = primary_->shell(P).nfunction();
             int nQ = primary_->shell(Q).nfunction();
             int oP = primary_->shell(P).function_index();
             int oQ = primary_->shell(Q).function_index();
-            eri->compute_shell(P, Q, P, Q);
-            double max_val = 0.0;
-            for (int p = 0; p < nP; p++) {
-                for (int q = 0; q < nQ; q++) {
-                    max_val = std::max(max_val, std::fabs(buffer[p * (nQ * nP * nQ + nQ) + q * (nP * nQ + 1)]));
+            double max_val = (reuse ? reused_pair_value(P, Q, centers, previous.centers, previous.shell_pair_values)
+                                    : -1.0);
+            if (max_val < 0.0) {
+                eris[thread]->compute_shell(P, Q, P, Q);
+                max_val = 0.0;
+                for (int p = 0; p < nP; p++) {
+                    for (int q = 0; q < nQ; q++) {
+                        max_val = std::max(max_val, std::fabs(buffer[p * (nQ * nP * nQ + nQ) + q * (nP * nQ + 1)]));
+                    }
                 }
+            } else {
+                nreused++;
             }
-            max_ = std::max(max_, max_val);
+            max_all = std::max(max_all, max_val);
             shell_pair_values_[P * nshell_ + Q] = shell_pair_values_[Q * nshell_ + P] = max_val;
             for (int p = 0; p < nP; p++) {
                 for (int q = 0; q < nQ; q++) {
@@ -235,6 +428,27 @@ void ERISieve::integrals() {
             }
         }
     }
+    max_ = max_all;
+    nreused_ = nreused;
+
+    if (reuse_tolerance_ > 0.0) {
+        SieveGeometryRecord record;
+        for (int P = 0; P < nshell; P++) {
+            const GaussianShell &shell = primary_->shell(P);
+            record.am.push_back(shell.am());
+            record.nprimitive.push_back(shell.nprimitive());
+            record.exp0.push_back(shell.exp(0));
+        }
+        record.centers = centers;
+        record.shell_pair_values = shell_pair_values_;
+        std::lock_guard<std::mutex> lock(sieve_geometry_mutex);
+        sieve_geometry_records[sieve_geometry_key(primary_)] = std::move(record);
+    }
+
+    if (reuse) {
+        outfile->Printf("  ERISieve: reused %zu of %zu shell pair bounds from the previous geometry.\n\n", nreused_,
+                        nshell_ * (nshell_ + 1L) / 2L);
+    }
 
     // All this is broken (only built one shell-pair's info)
 #if 0
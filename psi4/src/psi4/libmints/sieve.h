@@ -41,6 +41,33 @@ namespace psi {
 
 class BasisSet;
 
+/**
+ * ShellPairList
+ *
+ * Shell pairs of one basis in compressed sparse row form. The partners of
+ * shell P are partners[offsets[P]] ... partners[offsets[P + 1] - 1], in
+ * ascending order, and both (P,Q) and (Q,P) are stored:
+ *
+ *     for (int P = 0; P < list.nshell(); P++) {
+ *         for (const int* Q = list.begin(P); Q != list.end(P); ++Q) {
+ *             ...
+ *         }
+ *     }
+ */
+struct PSI_API ShellPairList {
+    /// Row starts, nshell + 1 entries
+    std::vector<size_t> offsets;
+    /// Partner shells, ascending within each row
+    std::vector<int> partners;
+
+    int nshell() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+    /// Number of stored (ordered) pairs
+    size_t npairs() const { return partners.size(); }
+    size_t size(int P) const { return offsets[P + 1] - offsets[P]; }
+    const int* begin(int P) const { return partners.data() + offsets[P]; }
+    const int* end(int P) const { return partners.data() + offsets[P + 1]; }
+};
+
 /**
  * ERISieve
  *
@@ -56,6 +83,11 @@ class BasisSet;
  *     // Initialize the sieve object
  *     std::shared_ptr<ERISieve> sieve(basisset, sieve_cutoff);
  *
+ *     // With SIEVE_REUSE_TOLERANCE > 0, a sieve on a basis seen before at another
+ *     // geometry (e.g. the previous optimization step) copies the (MN|MN) bounds
+ *     // of shell pairs that did not move relative to each other, and only
+ *     // recomputes the rest.
+ *
  *     // Reset the sieve cutoff (you can do this wherever)
  *     sieve->set_sieve(new_cutoff);
  *
@@ -72,6 +104,10 @@ class BasisSet;
  *     if (sieve->shell_ceiling2(M,N,R,S) * D_RS * D_RS >= sieve_cutoff * sieve_cutoff)
  *         eri->compute(M,N,R,S);
  *
+ *     // Walk the significant partners N of each shell M (both triangles)
+ *     const ShellPairList& list = sieve->shell_pair_list();
+ *     for (const int* N = list.begin(M); N != list.end(M); ++N) { ... }
+ *
  *     // Index the significant MN shell pairs (triangular M,N)
  *     const std::vector<std::pair<int,int> >& MN = sieve->shell_pairs();
  *     for (long int index = 0L; index < MN.size(); ++index) {
@@ -129,6 +165,12 @@ class PSI_API ERISieve {
     std::vector<long int> function_pairs_reverse_;
     /// Unique bra- shell pair indexing, accessed in triangular order, or -1 for non-significant pair
     std::vector<long int> shell_pairs_reverse_;
+    /// Significant shell pairs, both triangles, in CSR form
+    ShellPairList shell_pair_list_;
+    /// Shell pairs close enough to be computed at all (see distance_pairs)
+    ShellPairList candidate_pairs_;
+    /// Sieve cutoff the candidate pairs were built for
+    double candidate_sieve_;
     /// Significant function pairs, indexes by function
     std::vector<std::vector<int> > shell_to_shell_;
     /// Significant shell pairs, indexes by shell
@@ -160,10 +202,18 @@ class PSI_API ERISieve {
 
     ////////////////////////////////////////
 
+    /// Relative shell-pair displacement below which a previous geometry's bound is reused (0 = off)
+    double reuse_tolerance_;
+    /// Number of shell pair bounds taken from the previous geometry
+    size_t nreused_;
+
     /// Set initial indexing
     void common_init();
     /// Compute sieve integrals (only done once)
     void integrals();
+    /// Bound for (PQ|PQ) from the previous geometry's table, or -1.0 if the pair moved too far
+    double reused_pair_value(int P, int Q, const std::vector<double>& centers, const std::vector<double>& old_centers,
+                             const std::vector<double>& old_values) const;
 
    public:
     /// Constructor, basis set and first sieve cutoff
@@ -177,6 +227,17 @@ class PSI_API ERISieve {
     double sieve() const { return sieve_; }
     /// Global maximum |(mn|rs)|
     double max() const { return max_; }
+    /// Number of shell pair bounds reused from the previous geometry (see SIEVE_REUSE_TOLERANCE)
+    size_t nreused() const { return nreused_; }
+
+    /**
+     * Shell pairs whose (MN|MN) can reach sieve^2 at all, found in O(N) from a
+     * cell list over the shell centers. Each shell gets the radius at which its
+     * most diffuse primitive decays below the cutoff with a wide safety margin;
+     * pairs farther apart than the larger of their two radii are left out. A
+     * sieve of 0.0 returns every pair.
+     */
+    static ShellPairList distance_pairs(std::shared_ptr<BasisSet> basis, double sieve);
 
     // => Significance Checks <= //
 
@@ -236,6 +297,8 @@ class PSI_API ERISieve {
     const std::vector<std::vector<int> >& function_to_function() const { return function_to_function_; }
     /// Significant shell pairs, indexes by shell
     const std::vector<std::vector<int> >& shell_to_shell() const { return shell_to_shell_; }
+    /// Significant shell pairs, indexes by shell, in CSR form
+    const ShellPairList& shell_pair_list() const { return shell_pair_list_; }
 
     // void shell_pair_values(std::vector<std::vector<std::pair<double, int> > >& values) const;
 
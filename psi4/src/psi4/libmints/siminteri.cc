@@ -378,6 +378,79 @@ void SimintTwoElectronInt::compute_shell_blocks(int shellpair1, int shellpair2,
     }
 }
 
+size_t SimintTwoElectronInt::compute_shell_blocks(const ShellPairBlock &bra, const ShellPairBlock &ket) {
+    if (bra.empty() || ket.empty()) return 0;
+
+    const size_t nbra = bra.size();
+    const size_t nket = ket.size();
+
+    const auto &shell1 = original_bs1_->shell(bra[0].first);
+    const auto &shell2 = original_bs2_->shell(bra[0].second);
+    const auto &shell3 = original_bs3_->shell(ket[0].first);
+    const auto &shell4 = original_bs4_->shell(ket[0].second);
+
+    // simint only vectorizes over a single AM class (and a bounded batch)
+    bool uniform = (nbra * nket <= batchsize_);
+    for (size_t i = 1; uniform && i < nbra; i++)
+        uniform = (original_bs1_->shell(bra[i].first).am() == shell1.am() &&
+                   original_bs2_->shell(bra[i].second).am() == shell2.am());
+    for (size_t j = 1; uniform && j < nket; j++)
+        uniform = (original_bs3_->shell(ket[j].first).am() == shell3.am() &&
+                   original_bs4_->shell(ket[j].second).am() == shell4.am());
+    if (!uniform) return TwoBodyAOInt::compute_shell_blocks(bra, ket);
+
+    bool do_cart = force_cartesian_ ||
+                   (shell1.is_cartesian() && shell2.is_cartesian() && shell3.is_cartesian() && shell4.is_cartesian());
+
+    const size_t ncart1234 = shell1.ncartesian() * shell2.ncartesian() * shell3.ncartesian() * shell4.ncartesian();
+    const size_t n1234 = (force_cartesian_ ? ncart1234
+                                           : shell1.nfunction() * shell2.nfunction() * shell3.nfunction() *
+                                                 shell4.nfunction());
+    const size_t total = nbra * nket * n1234;
+    curr_buff_size_ = n1234;
+
+    // single pairs are precomputed; anything larger is built for this call only
+    const auto nsh2 = original_bs2_->nshell();
+    const auto nsh4 = original_bs4_->nshell();
+    ShellPairVec multi_bra, multi_ket;
+    const simint_multi_shellpair *P = &(*single_spairs_bra_)[bra[0].first * nsh2 + bra[0].second];
+    const simint_multi_shellpair *Q = &(*single_spairs_ket_)[ket[0].first * nsh4 + ket[0].second];
+    if (nbra > 1) {
+        multi_bra = create_multi_shellpair_({bra}, *shells1_, *shells2_);
+        P = &multi_bra[0];
+    }
+    if (nket > 1) {
+        multi_ket = create_multi_shellpair_({ket}, *shells3_, *shells4_);
+        Q = &multi_ket[0];
+    }
+
+    target_ = target_full_;
+    source_ = source_full_;
+
+    if (do_cart)
+        simint_compute_eri(P, Q, SIMINT_SCREEN_TOL, sharedwork_, target_);
+    else {
+        simint_compute_eri(P, Q, SIMINT_SCREEN_TOL, sharedwork_, source_);
+        for (size_t i = 0; i < nbra; i++) {
+            for (size_t j = 0; j < nket; j++) {
+                pure_transform(bra[i].first, bra[i].second, ket[j].first, ket[j].second, 1, false);
+                source_ += ncart1234;
+                target_ += n1234;
+            }
+        }
+    }
+
+    if (block_buffer_.size() < total) block_buffer_.resize(total);
+    std::copy(target_full_, target_full_ + total, block_buffer_.begin());
+
+    for (auto &mp : multi_bra) simint_free_multi_shellpair(&mp);
+    for (auto &mp : multi_ket) simint_free_multi_shellpair(&mp);
+
+    target_ = target_full_;
+    source_ = source_full_;
+    return total;
+}
+
 void SimintTwoElectronInt::create_blocks(void) {
     blocks12_.clear();
     blocks34_.clear();
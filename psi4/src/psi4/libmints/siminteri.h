@@ -49,6 +49,11 @@ class SimintTwoElectronInt : public TwoBodyAOInt {
 
     virtual void compute_shell_blocks(int shellpair1, int shellpair2, int npair1 = -1, int npair2 = -1) override;
 
+    using TwoBodyAOInt::compute_shell_blocks;
+    virtual size_t compute_shell_blocks(const ShellPairBlock& bra, const ShellPairBlock& ket) override;
+
+    virtual size_t max_block_quartets() const override { return batchsize_; }
+
     virtual size_t compute_shell_deriv1(int, int, int, int);
 
     virtual size_t compute_shell_deriv2(int, int, int, int);
@@ -42,6 +42,7 @@
 #include "psi4/pragma.h"
 PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
+#include <algorithm>
 #include <memory>
 PRAGMA_WARNING_POP
 
@@ -385,7 +386,7 @@ void TwoBodySOInt::common_init() {
     else
         b4_ = std::make_shared<SOBasisSet>(tb_[0]->basis4(), integral_);
 
-    for (int i = 0; i < nthread_; ++i) tb_[i]->set_force_cartesian(b1_->petite_list()->include_pure_transform());
+    for (size_t i = 0; i < tb_.size(); ++i) tb_[i]->set_force_cartesian(b1_->petite_list()->include_pure_transform());
 
     size_ = b1_->max_nfunction_in_shell() * b2_->max_nfunction_in_shell() * b3_->max_nfunction_in_shell() *
             b4_->max_nfunction_in_shell();
@@ -438,6 +439,40 @@ void TwoBodySOInt::common_init() {
         }
     }
 
+    // Dense AO->SO blocks and scratch for the GEMM-based transform in compute_so_shell
+    if (tb_[0]->deriv() == 0) {
+        const std::shared_ptr<SOBasisSet> bases[4] = {b1_, b2_, b3_, b4_};
+        size_t maxnao = 0, maxnso = 0;
+        for (int x = 0; x < 4; ++x) {
+            const SOBasisSet &b = *bases[x];
+            aoso_[x].resize(b.basis()->nshell());
+            for (int u = 0; u < b.nshell(); ++u) {
+                const int nao = b.naofunction(u);
+                const int nso = b.nfunction(u);
+                maxnao = std::max<size_t>(maxnao, nao);
+                maxnso = std::max<size_t>(maxnso, nso);
+                const SOTransform &t = b.sotrans(u);
+                for (int a = 0; a < t.naoshell; ++a) {
+                    const int aoshell = t.aoshell[a].aoshell;
+                    const AOTransform &at = b.aotrans(aoshell);
+                    std::vector<double> &U = aoso_[x][aoshell];
+                    U.assign((size_t)nao * nso, 0.0);
+                    for (int h = 0; h < b.nirrep(); ++h) {
+                        for (int f = 0; f < at.nfuncpi[h]; ++f) {
+                            const AOTransformFunction &func = at.soshellpi[h][f];
+                            U[(size_t)func.aofunc * nso + func.sofunc] += func.coef;
+                        }
+                    }
+                }
+            }
+        }
+        // stage1_ holds (ijk|L) and (iJ|KL), stage2_ holds (ij|KL)
+        const size_t nstage1 = std::max(maxnao * maxnao * maxnao * maxnso, maxnao * maxnso * maxnso * maxnso);
+        const size_t nstage2 = maxnao * maxnao * maxnso * maxnso;
+        stage1_.assign(nthread_, std::vector<double>(nstage1));
+        stage2_.assign(nthread_, std::vector<double>(nstage2));
+    }
+
     cutoff_ = Process::environment.options.get_double("INTS_TOLERANCE");
 }
 
@@ -452,6 +487,153 @@ TwoBodySOInt::~TwoBodySOInt() {
     }
 }
 
+void TwoBodySOInt::compute_so_shell(int uish, int ujsh, int uksh, int ulsh, double *so_buffer, int thread) {
+    dprintf("uish %d, ujsh %d, uksh %d, ulsh %d\n", uish, ujsh, uksh, ulsh);
+
+    mints_timer_on("TwoBodySOInt::compute_shell setup");
+
+    const double *aobuff = tb_[thread]->buffer();
+
+    const SOTransform &t1 = b1_->sotrans(uish);
+    const SOTransform &t2 = b2_->sotrans(ujsh);
+    const SOTransform &t3 = b3_->sotrans(uksh);
+    const SOTransform &t4 = b4_->sotrans(ulsh);
+
+    const int nso1 = b1_->nfunction(uish);
+    const int nso2 = b2_->nfunction(ujsh);
+    const int nso3 = b3_->nfunction(uksh);
+    const int nso4 = b4_->nfunction(ulsh);
+    const size_t nso = nso1 * nso2 * nso3 * nso4;
+
+    const int nao1 = b1_->naofunction(uish);
+    const int nao2 = b2_->naofunction(ujsh);
+    const int nao3 = b3_->naofunction(uksh);
+    const int nao4 = b4_->naofunction(ulsh);
+
+    const int iatom = tb_[thread]->basis1()->shell(t1.aoshell[0].aoshell).ncenter();
+    const int jatom = tb_[thread]->basis2()->shell(t2.aoshell[0].aoshell).ncenter();
+    const int katom = tb_[thread]->basis3()->shell(t3.aoshell[0].aoshell).ncenter();
+    const int latom = tb_[thread]->basis4()->shell(t4.aoshell[0].aoshell).ncenter();
+
+    mints_timer_on("TwoBodySOInt::compute_shell zero buffer");
+
+    ::memset(so_buffer, 0, nso * sizeof(double));
+
+    mints_timer_off("TwoBodySOInt::compute_shell zero buffer");
+    mints_timer_off("TwoBodySOInt::compute_shell setup");
+
+    mints_timer_on("TwoBodySOInt::compute_shell full shell transform");
+
+    // Get the atomic stablizer (the first symmetry operation that maps the atom
+    // onto itself.
+
+    // These 3 sections are not shell specific so we can just use petite1_
+    const unsigned short istablizer = petite1_->stablizer(iatom);
+    const unsigned short jstablizer = petite1_->stablizer(jatom);
+    const unsigned short kstablizer = petite1_->stablizer(katom);
+    const unsigned short lstablizer = petite1_->stablizer(latom);
+
+    const int istabdense = dcd_->bits_to_dense_numbering(istablizer);
+    const int jstabdense = dcd_->bits_to_dense_numbering(jstablizer);
+    const int kstabdense = dcd_->bits_to_dense_numbering(kstablizer);
+    const int lstabdense = dcd_->bits_to_dense_numbering(lstablizer);
+
+    const int ijstablizer = dcd_->intersection(istabdense, jstabdense);
+    const int klstablizer = dcd_->intersection(kstabdense, lstabdense);
+    const int ijklstablizer = dcd_->intersection(ijstablizer, klstablizer);
+
+    const int *R_list = dcd_->dcr(istabdense, jstabdense);
+    const int *S_list = dcd_->dcr(kstabdense, lstabdense);
+    const int *T_list = dcd_->dcr(ijstablizer, klstablizer);
+
+    const int R_size = R_list[0];
+    const int S_size = S_list[0];
+    const int T_size = T_list[0];
+
+    // Check with Andy on this:
+    int lambda_T = petite1_->nirrep() / dcd_->subgroup_dimensions(ijklstablizer);
+
+    std::vector<int> sj_arr, sk_arr, sl_arr;
+
+    int si = petite1_->unique_shell_map(uish, 0);
+    const int siatom = tb_[thread]->basis1()->shell(si).ncenter();
+
+    dprintf("dcd %d", petite1_->group());
+    dprintf("istab %d, jstab %d, kstab %d, lstab %d, ijstab %d, klstab %d\n", istabdense, jstabdense, kstabdense,
+            lstabdense, ijstablizer, klstablizer);
+    dprintf("R_size %d, S_size %d, T_size %d\n", R_size, S_size, T_size);
+
+    for (int ij = 1; ij <= R_size; ++ij) {
+        int sj = petite2_->unique_shell_map(ujsh, R_list[ij]);
+        const int sjatom = tb_[thread]->basis2()->shell(sj).ncenter();
+
+        for (int ijkl = 1; ijkl <= T_size; ++ijkl) {
+            int sk = petite3_->unique_shell_map(uksh, T_list[ijkl]);
+            int llsh = petite4_->unique_shell_map(ulsh, T_list[ijkl]);
+            const int skatom = tb_[thread]->basis3()->shell(sk).ncenter();
+
+            for (int kl = 1; kl <= S_size; ++kl) {
+                int sl = petite4_->shell_map(llsh, S_list[kl]);
+                const int slatom = tb_[thread]->basis4()->shell(sl).ncenter();
+
+                // Check AM
+                int total_am = tb_[thread]->basis1()->shell(si).am() + tb_[thread]->basis2()->shell(sj).am() +
+                               tb_[thread]->basis3()->shell(sk).am() + tb_[thread]->basis4()->shell(sl).am();
+
+                if (!(total_am % 2) || (siatom != sjatom) || (sjatom != skatom) || (skatom != slatom)) {
+                    sj_arr.push_back(sj);
+                    sk_arr.push_back(sk);
+                    sl_arr.push_back(sl);
+                }
+            }
+        }
+    }
+
+    // Loop over unique quartets; each AO block is carried into the SO block one index at a time
+    // (l, k, j, then i) with the dense per-shell AO->SO coefficients, so every step is a GEMM.
+    const int nso34 = nso3 * nso4;
+    const int nso234 = nso2 * nso34;
+    const double *U1 = aoso_[0][si].data();
+    double *T1 = stage1_[thread].data();
+    double *T2 = stage2_[thread].data();
+
+    for (size_t n = 0; n < sj_arr.size(); ++n) {
+        int sj = sj_arr[n];
+        int sk = sk_arr[n];
+        int sl = sl_arr[n];
+
+        const double *U2 = aoso_[1][sj].data();
+        const double *U3 = aoso_[2][sk].data();
+        const double *U4 = aoso_[3][sl].data();
+
+        // Compute this unique AO shell
+        tb_[thread]->compute_shell(si, sj, sk, sl);
+
+        mints_timer_on("TwoBodySOInt::compute_shell actual transform");
+
+        // (ijk|l) -> (ijk|L)
+        C_DGEMM('N', 'N', nao1 * nao2 * nao3, nso4, nao4, 1.0, const_cast<double *>(aobuff), nao4,
+                const_cast<double *>(U4), nso4, 0.0, T1, nso4);
+        // (ij|kL) -> (ij|KL)
+        for (int ij = 0; ij < nao1 * nao2; ++ij) {
+            C_DGEMM('T', 'N', nso3, nso4, nao3, 1.0, const_cast<double *>(U3), nso3, &T1[(size_t)ij * nao3 * nso4],
+                    nso4, 0.0, &T2[(size_t)ij * nso34], nso4);
+        }
+        // (i j|KL) -> (i J|KL)
+        for (int i = 0; i < nao1; ++i) {
+            C_DGEMM('T', 'N', nso2, nso34, nao2, 1.0, const_cast<double *>(U2), nso2, &T2[(size_t)i * nao2 * nso34],
+                    nso34, 0.0, &T1[(size_t)i * nso234], nso34);
+        }
+        // (iJ|KL) -> (IJ|KL), accumulated over the unique AO quartets
+        C_DGEMM('T', 'N', nso1, nso234, nao1, (double)lambda_T, const_cast<double *>(U1), nso1, T1, nso234, 1.0,
+                so_buffer, nso234);
+
+        mints_timer_off("TwoBodySOInt::compute_shell actual transform");
+    }
+
+    mints_timer_off("TwoBodySOInt::compute_shell full shell transform");
+}
+
 std::shared_ptr<SOBasisSet> TwoBodySOInt::basis() const { return b1_; }
 
 std::shared_ptr<SOBasisSet> TwoBodySOInt::basis1() const { return b1_; }
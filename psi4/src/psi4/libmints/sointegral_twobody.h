@@ -44,6 +44,8 @@
 
 #include "psi4/libqt/qt.h"
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 //#define DebugPrint 1
@@ -111,8 +113,18 @@ class PSI_API TwoBodySOInt {
 
     const CdSalcList *cdsalcs_;
 
+    /// Dense AO->SO coefficients, aoso_[x][aoshell] is a row-major (AO functions x SO shell functions) block for
+    /// the x'th basis (0-3)
+    std::vector<std::vector<double> > aoso_[4];
+    /// Per-thread scratch for the staged one-index transforms in compute_so_shell
+    std::vector<std::vector<double> > stage1_;
+    std::vector<std::vector<double> > stage2_;
+
+    /// Computes the SO integral block of the (uish ujsh | uksh ulsh) SO shell quartet into so_buffer
+    void compute_so_shell(int uish, int ujsh, int uksh, int ulsh, double *so_buffer, int thread);
+
     template <typename TwoBodySOIntFunctor>
-    void provide_IJKL(int, int, int, int, TwoBodySOIntFunctor &body);
+    void provide_IJKL(int, int, int, int, const double *so_buffer, TwoBodySOIntFunctor &body);
 
     template <typename TwoBodySOIntFunctor>
     void provide_IJKL_deriv1(int ish, int jsh, int ksh, int lsh, TwoBodySOIntFunctor &body);
@@ -201,230 +213,20 @@ class PSI_API TwoBodySOInt {
 
 template <typename TwoBodySOIntFunctor>
 void TwoBodySOInt::compute_shell(int uish, int ujsh, int uksh, int ulsh, TwoBodySOIntFunctor &body) {
-    dprintf("uish %d, ujsh %d, uksh %d, ulsh %d\n", uish, ujsh, uksh, ulsh);
-
     int thread = 0;
 #ifdef _OPENMP
     thread = omp_get_thread_num();
 #endif
-    // Old call WorldComm->thread_id(pthread_self());
 
-    // timer_on("TwoBodySOInt::compute_shell overall");
     mints_timer_on("TwoBodySOInt::compute_shell overall");
-    mints_timer_on("TwoBodySOInt::compute_shell setup");
-
-    const double *aobuff = tb_[thread]->buffer();
-
-    const SOTransform &t1 = b1_->sotrans(uish);
-    const SOTransform &t2 = b2_->sotrans(ujsh);
-    const SOTransform &t3 = b3_->sotrans(uksh);
-    const SOTransform &t4 = b4_->sotrans(ulsh);
-
-    const int nso1 = b1_->nfunction(uish);
-    const int nso2 = b2_->nfunction(ujsh);
-    const int nso3 = b3_->nfunction(uksh);
-    const int nso4 = b4_->nfunction(ulsh);
-    const size_t nso = nso1 * nso2 * nso3 * nso4;
-
-    const int nao2 = b2_->naofunction(ujsh);
-    const int nao3 = b3_->naofunction(uksh);
-    const int nao4 = b4_->naofunction(ulsh);
-
-    const int iatom = tb_[thread]->basis1()->shell(t1.aoshell[0].aoshell).ncenter();
-    const int jatom = tb_[thread]->basis2()->shell(t2.aoshell[0].aoshell).ncenter();
-    const int katom = tb_[thread]->basis3()->shell(t3.aoshell[0].aoshell).ncenter();
-    const int latom = tb_[thread]->basis4()->shell(t4.aoshell[0].aoshell).ncenter();
-
-    int nirrep = b1_->nirrep();
-
-    mints_timer_on("TwoBodySOInt::compute_shell zero buffer");
-
-    ::memset(buffer_[thread], 0, nso * sizeof(double));
-
-    mints_timer_off("TwoBodySOInt::compute_shell zero buffer");
-    mints_timer_off("TwoBodySOInt::compute_shell setup");
-
-    mints_timer_on("TwoBodySOInt::compute_shell full shell transform");
-
-    // Get the atomic stablizer (the first symmetry operation that maps the atom
-    // onto itself.
-
-    // These 3 sections are not shell specific so we can just use petite1_
-    const unsigned short istablizer = petite1_->stablizer(iatom);
-    const unsigned short jstablizer = petite1_->stablizer(jatom);
-    const unsigned short kstablizer = petite1_->stablizer(katom);
-    const unsigned short lstablizer = petite1_->stablizer(latom);
-
-    const int istabdense = dcd_->bits_to_dense_numbering(istablizer);
-    const int jstabdense = dcd_->bits_to_dense_numbering(jstablizer);
-    const int kstabdense = dcd_->bits_to_dense_numbering(kstablizer);
-    const int lstabdense = dcd_->bits_to_dense_numbering(lstablizer);
-
-    const int ijstablizer = dcd_->intersection(istabdense, jstabdense);
-    const int klstablizer = dcd_->intersection(kstabdense, lstabdense);
-    const int ijklstablizer = dcd_->intersection(ijstablizer, klstablizer);
-
-    const int *R_list = dcd_->dcr(istabdense, jstabdense);
-    const int *S_list = dcd_->dcr(kstabdense, lstabdense);
-    const int *T_list = dcd_->dcr(ijstablizer, klstablizer);
-
-    const int R_size = R_list[0];
-    const int S_size = S_list[0];
-    const int T_size = T_list[0];
-
-    // Check with Andy on this:
-    int lambda_T = petite1_->nirrep() / dcd_->subgroup_dimensions(ijklstablizer);
-
-    std::vector<int> sj_arr, sk_arr, sl_arr;
-
-    int si = petite1_->unique_shell_map(uish, 0);
-    const int siatom = tb_[thread]->basis1()->shell(si).ncenter();
-
-    dprintf("dcd %d", petite1_->group());
-    dprintf("istab %d, jstab %d, kstab %d, lstab %d, ijstab %d, klstab %d\n", istabdense, jstabdense, kstabdense,
-            lstabdense, ijstablizer, klstablizer);
-    dprintf("R_size %d, S_size %d, T_size %d\n", R_size, S_size, T_size);
-
-    for (int ij = 1; ij <= R_size; ++ij) {
-        int sj = petite2_->unique_shell_map(ujsh, R_list[ij]);
-        const int sjatom = tb_[thread]->basis2()->shell(sj).ncenter();
-
-        for (int ijkl = 1; ijkl <= T_size; ++ijkl) {
-            int sk = petite3_->unique_shell_map(uksh, T_list[ijkl]);
-            int llsh = petite4_->unique_shell_map(ulsh, T_list[ijkl]);
-            const int skatom = tb_[thread]->basis3()->shell(sk).ncenter();
-
-            for (int kl = 1; kl <= S_size; ++kl) {
-                int sl = petite4_->shell_map(llsh, S_list[kl]);
-                const int slatom = tb_[thread]->basis4()->shell(sl).ncenter();
-
-                // Check AM
-                int total_am = tb_[thread]->basis1()->shell(si).am() + tb_[thread]->basis2()->shell(sj).am() +
-                               tb_[thread]->basis3()->shell(sk).am() + tb_[thread]->basis4()->shell(sl).am();
-
-                if (!(total_am % 2) || (siatom != sjatom) || (sjatom != skatom) || (skatom != slatom)) {
-                    sj_arr.push_back(sj);
-                    sk_arr.push_back(sk);
-                    sl_arr.push_back(sl);
-                }
-            }
-        }
-    }
-
-    // Compute integral using si, sj_arr, sk_arr, sl_arr
-    // Loop over unique quartets
-    const AOTransform &s1 = b1_->aotrans(si);
-
-    const unsigned short *ifuncpi = s1.nfuncpi;
-
-    for (size_t n = 0; n < sj_arr.size(); ++n) {
-        int sj = sj_arr[n];
-        int sk = sk_arr[n];
-        int sl = sl_arr[n];
-
-        const AOTransform &s2 = b2_->aotrans(sj);
-        const AOTransform &s3 = b3_->aotrans(sk);
-        const AOTransform &s4 = b4_->aotrans(sl);
-
-        const unsigned short *jfuncpi = s2.nfuncpi;
-        const unsigned short *kfuncpi = s3.nfuncpi;
-        const unsigned short *lfuncpi = s4.nfuncpi;
-
-        // Compute this unique AO shell
-        // timer_on("Computing the AO shell");
-        tb_[thread]->compute_shell(si, sj, sk, sl);
-        // timer_off("Computing the AO shell");
-
-        mints_timer_on("TwoBodySOInt::compute_shell actual transform");
-
-        for (int isym = 0; isym < nirrep; ++isym) {
-            unsigned short nifunc = ifuncpi[isym];
-            for (int itr = 0; itr < nifunc; itr++) {
-                mints_timer_on("itr");
-
-                const AOTransformFunction &ifunc = s1.soshellpi[isym][itr];
-                double icoef = ifunc.coef;
-                int iaofunc = ifunc.aofunc;
-                int isofunc = ifunc.sofunc;
-                int iaooff = iaofunc;
-                int isooff = isofunc;
-
-                mints_timer_off("itr");
-
-                for (int jsym = 0; jsym < nirrep; ++jsym) {
-                    unsigned short njfunc = jfuncpi[jsym];
-                    for (int jtr = 0; jtr < njfunc; jtr++) {
-                        mints_timer_on("jtr");
-
-                        const AOTransformFunction &jfunc = s2.soshellpi[jsym][jtr];
-                        double jcoef = jfunc.coef * icoef;
-                        int jaofunc = jfunc.aofunc;
-                        int jsofunc = jfunc.sofunc;
-                        int jaooff = iaooff * nao2 + jaofunc;
-                        int jsooff = isooff * nso2 + jsofunc;
-
-                        mints_timer_off("jtr");
-
-                        for (int ksym = 0; ksym < nirrep; ++ksym) {
-                            unsigned short nkfunc = kfuncpi[ksym];
-                            for (int ktr = 0; ktr < nkfunc; ktr++) {
-                                mints_timer_on("ktr");
-
-                                const AOTransformFunction &kfunc = s3.soshellpi[ksym][ktr];
-                                double kcoef = kfunc.coef * jcoef;
-                                int kaofunc = kfunc.aofunc;
-                                int ksofunc = kfunc.sofunc;
-                                int kaooff = jaooff * nao3 + kaofunc;
-                                int ksooff = jsooff * nso3 + ksofunc;
-
-                                mints_timer_off("ktr");
-
-                                int lsym = isym ^ jsym ^ ksym;
-                                unsigned short nlfunc = lfuncpi[lsym];
-                                for (int ltr = 0; ltr < nlfunc; ltr++) {
-                                    mints_timer_on("ltr");
-
-                                    const AOTransformFunction &lfunc = s4.soshellpi[lsym][ltr];
-                                    double lcoef = lfunc.coef * kcoef;
-                                    int laofunc = lfunc.aofunc;
-                                    int lsofunc = lfunc.sofunc;
-                                    int laooff = kaooff * nao4 + laofunc;
-                                    int lsooff = ksooff * nso4 + lsofunc;
-
-                                    mints_timer_off("ltr");
-                                    mints_timer_on("transform");
-
-                                    dprintf("lambda_T %d, lcoef %lf, aobuff %lf\n", lambda_T, lcoef, aobuff[laooff]);
-                                    buffer_[thread][lsooff] += lambda_T * lcoef * aobuff[laooff];
-
-                                    mints_timer_off("transform");
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        mints_timer_off("TwoBodySOInt::compute_shell actual transform");
-    }
-
-    mints_timer_off("TwoBodySOInt::compute_shell full shell transform");
-
-    provide_IJKL(uish, ujsh, uksh, ulsh, body);
-
+    compute_so_shell(uish, ujsh, uksh, ulsh, buffer_[thread], thread);
+    provide_IJKL(uish, ujsh, uksh, ulsh, buffer_[thread], body);
     mints_timer_off("TwoBodySOInt::compute_shell overall");
-    // timer_off("TwoBodySOInt::compute_shell overall");
 }
 
 template <typename TwoBodySOIntFunctor>
-void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, TwoBodySOIntFunctor &body) {
-    int thread = 0;
-// Old call WorldComm->thread_id(pthread_self());
-#ifdef _OPENMP
-    thread = omp_get_thread_num();
-#endif
-
+void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, const double *so_buffer,
+                                TwoBodySOIntFunctor &body) {
     mints_timer_on("TwoBodySOInt::provide_IJKL overall");
     // timer_on("TwoBodySOInt::provide_IJKL overall");
 
@@ -485,7 +287,10 @@ void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, TwoBodySOInt
                     int kkrel = krel;
                     int llrel = lrel;
 
-                    if (std::fabs(buffer_[thread][lsooff]) > cutoff_) {
+                    // The staged transform leaves symmetry-forbidden entries unscreened; they are not integrals
+                    if (isym ^ jsym ^ ksym ^ lsym) continue;
+
+                    if (std::fabs(so_buffer[lsooff]) > cutoff_) {
                         if (ish == jsh) {
                             if (iabs < jabs) continue;
 
@@ -538,7 +343,7 @@ void TwoBodySOInt::provide_IJKL(int ish, int jsh, int ksh, int lsh, TwoBodySOInt
 
                         // func off/on
                         body(iiabs, jjabs, kkabs, llabs, iiirrep, iirel, jjirrep, jjrel, kkirrep, kkrel, llirrep, llrel,
-                             buffer_[thread][lsooff]);
+                             so_buffer[lsooff]);
 
                         mints_timer_off("TwoBodySOInt::provide_IJKL functor");
                     }
@@ -1081,9 +886,48 @@ void TwoBodySOInt::compute_integrals(TwoBodySOIntFunctor &functor) {
             "change your COMMUNICATOR "
             "environment variable to MPI or LOCAL.\n");
     } else {
-        std::shared_ptr<SOShellCombinationsIterator> shellIter =
-            std::make_shared<SOShellCombinationsIterator>(b1_, b2_, b3_, b4_);
-        this->compute_quartets(shellIter, functor);
+        // The functor is not required to be thread safe, so unique quartets are transformed in parallel batches
+        // and handed to it serially, in iterator order.
+        const int nthread = std::min<int>(nthread_, tb_.size());
+        const size_t max_batch = 64 * (size_t)nthread;
+        const size_t max_batch_doubles = std::max<size_t>(size_, 16 * 1024 * 1024);
+
+        std::vector<std::array<int, 4> > quartets;
+        std::vector<size_t> offsets;
+        std::vector<double> blocks;
+
+        SOShellCombinationsIterator shellIter(b1_, b2_, b3_, b4_);
+        shellIter.first();
+        while (!shellIter.is_done()) {
+            quartets.clear();
+            offsets.clear();
+            size_t total = 0;
+            for (; !shellIter.is_done() && quartets.size() < max_batch; shellIter.next()) {
+                size_t nso = (size_t)b1_->nfunction(shellIter.p()) * b2_->nfunction(shellIter.q()) *
+                             b3_->nfunction(shellIter.r()) * b4_->nfunction(shellIter.s());
+                if (!quartets.empty() && total + nso > max_batch_doubles) break;
+                quartets.push_back({{shellIter.p(), shellIter.q(), shellIter.r(), shellIter.s()}});
+                offsets.push_back(total);
+                total += nso;
+            }
+            if (blocks.size() < total) blocks.resize(total);
+
+            const long nquartet = quartets.size();
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+            for (long n = 0; n < nquartet; ++n) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                const std::array<int, 4> &q = quartets[n];
+                compute_so_shell(q[0], q[1], q[2], q[3], &blocks[offsets[n]], thread);
+            }
+
+            for (long n = 0; n < nquartet; ++n) {
+                const std::array<int, 4> &q = quartets[n];
+                provide_IJKL(q[0], q[1], q[2], q[3], &blocks[offsets[n]], functor);
+            }
+        }
     }
 }
 
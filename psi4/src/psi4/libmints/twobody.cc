@@ -26,6 +26,8 @@
  * @END LICENSE
  */
 
+#include <algorithm>
+#include <map>
 #include <stdexcept>
 #include "psi4/libqt/qt.h"
 #include "psi4/libmints/twobody.h"
@@ -168,6 +170,53 @@ void TwoBodyAOInt::compute_shell_blocks(int shellpair12, int shellpair34, int np
     }
 }
 
+std::vector<ShellPairBlock> TwoBodyAOInt::am_blocks(const ShellPairBlock &pairs, bool bra, size_t max_block) const {
+    const auto &bsA = (bra ? original_bs1_ : original_bs3_);
+    const auto &bsB = (bra ? original_bs2_ : original_bs4_);
+
+    // bucket by AM class, keeping the incoming order within a class
+    std::map<std::pair<int, int>, ShellPairBlock> classes;
+    for (const auto &pair : pairs) classes[{bsA->shell(pair.first).am(), bsB->shell(pair.second).am()}].push_back(pair);
+
+    std::vector<ShellPairBlock> blocks;
+    for (const auto &kv : classes) {
+        const ShellPairBlock &cls = kv.second;
+        size_t step = (max_block ? max_block : cls.size());
+        for (size_t start = 0; start < cls.size(); start += step) {
+            size_t stop = std::min(start + step, cls.size());
+            blocks.push_back(ShellPairBlock(cls.begin() + start, cls.begin() + stop));
+        }
+    }
+    return blocks;
+}
+
+size_t TwoBodyAOInt::compute_shell_blocks(const ShellPairBlock &bra, const ShellPairBlock &ket) {
+    // Default implementation - one quartet at a time, gathered into block_buffer_
+    auto nfun = [this](const GaussianShell &shell) { return (force_cartesian_ ? shell.ncartesian() : shell.nfunction()); };
+
+    size_t total = 0;
+    for (const auto &sh12 : bra) {
+        size_t n12 = nfun(original_bs1_->shell(sh12.first)) * nfun(original_bs2_->shell(sh12.second));
+        for (const auto &sh34 : ket)
+            total += n12 * nfun(original_bs3_->shell(sh34.first)) * nfun(original_bs4_->shell(sh34.second));
+    }
+    if (block_buffer_.size() < total) block_buffer_.resize(total);
+
+    double *out = block_buffer_.data();
+    for (const auto &sh12 : bra) {
+        size_t n12 = nfun(original_bs1_->shell(sh12.first)) * nfun(original_bs2_->shell(sh12.second));
+        for (const auto &sh34 : ket) {
+            size_t n1234 = n12 * nfun(original_bs3_->shell(sh34.first)) * nfun(original_bs4_->shell(sh34.second));
+            if (compute_shell(sh12.first, sh12.second, sh34.first, sh34.second))
+                std::copy(buffer(), buffer() + n1234, out);
+            else
+                std::fill(out, out + n1234, 0.0);
+            out += n1234;
+        }
+    }
+    return total;
+}
+
 void TwoBodyAOInt::normalize_am(std::shared_ptr<GaussianShell> s1, std::shared_ptr<GaussianShell> s2,
                                 std::shared_ptr<GaussianShell> s3, std::shared_ptr<GaussianShell> s4, int nchunk) {
     // Integrals assume this normalization is 1.0.
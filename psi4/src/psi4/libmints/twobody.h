@@ -33,6 +33,7 @@
 
 #include <memory>
 #include <vector>
+#include <utility>
 
 #ifdef _POSIX_C_SOURCE
 #undef _POSIX_C_SOURCE
@@ -98,6 +99,9 @@ class PSI_API TwoBodyAOInt {
     /// The blocking scheme used for the integrals
     std::vector<ShellPairBlock> blocks12_, blocks34_;
 
+    /// Integrals of the last compute_shell_blocks(bra, ket) call
+    std::vector<double> block_buffer_;
+
     /*! Create the optimal blocks of shell pairs
      *
      * Default implementation
@@ -175,6 +179,34 @@ class PSI_API TwoBodyAOInt {
      */
     virtual void compute_shell_blocks(int shellpair12, int shellpair34, int npair12 = -1, int npair34 = -1);
 
+    /*! Group shell pairs into blocks of a single angular momentum class
+     *
+     * \p pairs are shell indices on centers 1 & 2 (\p bra true) or 3 & 4.
+     * The blocks are ordered by AM class, keep the input order within a
+     * class and hold at most \p max_block pairs (0 means no limit). They
+     * can be passed straight to compute_shell_blocks(bra, ket).
+     */
+    std::vector<ShellPairBlock> am_blocks(const ShellPairBlock &pairs, bool bra, size_t max_block = 0) const;
+
+    /*! Compute all quartets of an arbitrary bra and ket block of shell pairs
+     *
+     * The integrals go to block_buffer(), one quartet after the other
+     * (bra pairs slowest), each in the layout compute_shell would give.
+     * Quartets that compute_shell reports as zero are zero-filled.
+     * Backends that vectorize over quartets (simint) do whole blocks at
+     * once when all pairs of the bra and of the ket share an AM class
+     * (see am_blocks) and bra.size() * ket.size() <= max_block_quartets().
+     *
+     * \returns the number of integrals in block_buffer()
+     */
+    virtual size_t compute_shell_blocks(const ShellPairBlock &bra, const ShellPairBlock &ket);
+
+    /// Largest number of quartets a backend batches in one compute_shell_blocks call (0 = no batching)
+    virtual size_t max_block_quartets() const { return 0; }
+
+    /// Buffer filled by compute_shell_blocks(bra, ket)
+    const double *block_buffer() const { return block_buffer_.data(); }
+
     /// Is the shell zero?
     virtual int shell_is_zero(int, int, int, int) { return 0; }
 
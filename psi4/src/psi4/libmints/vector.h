@@ -30,6 +30,7 @@
 #define _psi_src_lib_libmints_vector_h
 
 #include "psi4/libmints/dimension.h"
+#include "psi4/libmints/pool_allocator.h"
 #include "psi4/libmints/typedefs.h"
 
 #include <cstdlib>
@@ -47,8 +48,8 @@ class VectorIterator;
 /*! \ingroup MINTS */
 class PSI_API Vector {
    protected:
-    /// Actual data, of size dimpi_.sum()
-    std::vector<double> v_;
+    /// Actual data, of size dimpi_.sum(); aligned pool storage shared with Matrix
+    std::vector<double, pool::Allocator<double> > v_;
     /// Pointer offsets into v_, of size dimpi_.n()
     std::vector<double *> vector_;
     /// Number of irreps
@@ -237,8 +238,8 @@ class PSI_API Vector {
     /// Scale the elements of the vector
     void scale(const double &sc);
 
-    typedef std::vector<double>::iterator iterator;
-    typedef std::vector<double>::const_iterator const_iterator;
+    typedef std::vector<double, pool::Allocator<double> >::iterator iterator;
+    typedef std::vector<double, pool::Allocator<double> >::const_iterator const_iterator;
 
     /// @{
     /** Returns the starting iterator for the entire v_. */
@@ -0,0 +1,295 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "vibanal.h"
+
+#include "psi4/physconst.h"
+#include "psi4/psi4-dec.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/blas_backend.h"
+
+namespace psi {
+
+namespace {
+// Singular values of the translation/rotation vectors below this are linear dependencies (qcdb.vib LINEAR_A_TOL)
+const double tr_tolerance = 1.0E-2;
+// A mode whose component outside the translation/rotation space is below this lies in it
+const double tr_overlap_tolerance = 1.0E-4;
+}  // namespace
+
+BatchVibAnalysis::BatchVibAnalysis(double T, double P, bool project_trans, bool project_rot)
+    : T_(T), P_(P), project_trans_(project_trans), project_rot_(project_rot) {
+    if (T_ <= 0.0 || P_ <= 0.0) throw PSIEXCEPTION("BatchVibAnalysis: temperature and pressure must be positive.");
+}
+
+void BatchVibAnalysis::add_system(SharedMatrix hessian, std::shared_ptr<Molecule> mol, int sigma) {
+    if (!hessian || !mol) throw PSIEXCEPTION("BatchVibAnalysis: a system needs a Hessian and a molecule.");
+    int natom = mol->natom();
+    if (hessian->nirrep() != 1 || hessian->rowspi()[0] != 3 * natom || hessian->colspi()[0] != 3 * natom)
+        throw PSIEXCEPTION("BatchVibAnalysis: the Hessian must be a C1 (3 natom x 3 natom) matrix.");
+
+    VibAnalysisSystem system;
+    system.hessian = hessian;
+    Matrix geom = mol->geometry();
+    for (int A = 0; A < natom; A++) {
+        system.mass.push_back(mol->mass(A));
+        for (int x = 0; x < 3; x++) system.geometry.push_back(geom.get(A, x));
+    }
+    system.multiplicity = mol->multiplicity();
+    system.sigma = sigma > 0 ? sigma : mol->rotational_symmetry_number();
+    RotorType rotor = mol->rotor_type();
+    system.atom = rotor == RT_ATOM;
+    system.linear = rotor == RT_LINEAR;
+    Vector rot_const = mol->rotational_constants();
+    for (int i = 0; i < 3; i++) system.rot_const[i] = rot_const[i];
+    systems_.push_back(system);
+}
+
+std::vector<VibAnalysisResult> BatchVibAnalysis::compute() {
+    std::vector<VibAnalysisResult> results(systems_.size());
+    int nsystem = systems_.size();
+    int nthread = std::max(1, std::min(Process::environment.get_n_threads(), nsystem));
+
+#ifdef _OPENMP
+    // One system per thread: everything a system calls itself runs serially
+    int max_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthread)
+    for (int i = 0; i < nsystem; i++) {
+        blas::ThreadScope blas_threads(1, "Batch vibrational analysis");
+        try {
+            results[i] = compute_system(systems_[i]);
+        } catch (std::exception& e) {
+            results[i].error = e.what();
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_levels);
+#endif
+
+    outfile->Printf("\n  ==> Batch Vibrational Analysis: %d Systems on %d Threads <==\n\n", nsystem, nthread);
+    outfile->Printf("    T = %.2f [K], P = %.2f [Pa]\n\n", T_, P_);
+    outfile->Printf("    %6s %6s %6s %16s %16s  %s\n", "System", "Nvib", "Nimag", "ZPE [Eh]", "G corr [Eh]", "Status");
+    for (int i = 0; i < nsystem; i++) {
+        const VibAnalysisResult& result = results[i];
+        if (!result.error.empty()) {
+            outfile->Printf("    %6d %6s %6s %16s %16s  Error: %s\n", i, "", "", "", "", result.error.c_str());
+        } else {
+            outfile->Printf("    %6d %6d %6d %16.8f %16.8f  OK\n", i, result.frequencies->dim(), result.nimag,
+                            result.ZPE, result.G);
+        }
+    }
+    outfile->Printf("\n");
+
+    return results;
+}
+
+VibAnalysisResult BatchVibAnalysis::compute_system(const VibAnalysisSystem& system) const {
+    VibAnalysisResult result;
+
+    int natom = system.mass.size();
+    int n3 = 3 * natom;
+    const double* m = system.mass.data();
+    const double* xyz = system.geometry.data();
+
+    // Mass-weighted Hessian
+    auto mwhess = std::make_shared<Matrix>("Mass-weighted Hessian", n3, n3);
+    double** Hp = system.hessian->pointer();
+    double** MHp = mwhess->pointer();
+    for (int i = 0; i < n3; i++) {
+        for (int j = 0; j < n3; j++) MHp[i][j] = Hp[i][j] / std::sqrt(m[i / 3] * m[j / 3]);
+    }
+
+    // Idealized translations and rotations in mass-weighted coordinates, one per row
+    int ntr = (project_trans_ ? 3 : 0) + (project_rot_ ? 3 : 0);
+    SharedMatrix Q;
+    if (ntr) {
+        auto TR = std::make_shared<Matrix>("TR space", ntr, n3);
+        double** TRp = TR->pointer();
+        for (int A = 0; A < natom; A++) {
+            double sqrtm = std::sqrt(m[A]);
+            const double* r = xyz + 3 * A;
+            int row = 0;
+            if (project_trans_) {
+                for (int x = 0; x < 3; x++, row++) TRp[row][3 * A + x] = sqrtm;
+            }
+            if (project_rot_) {
+                // e_x cross r, e_y cross r, e_z cross r
+                for (int x = 0; x < 3; x++, row++) {
+                    int y = (x + 1) % 3;
+                    int z = (x + 2) % 3;
+                    TRp[row][3 * A + z] = sqrtm * r[y];
+                    TRp[row][3 * A + y] = -sqrtm * r[z];
+                }
+            }
+        }
+
+        // Orthonormal basis of their span, from the eigenvectors of their overlap
+        SharedMatrix S = Matrix::doublet(TR, TR, false, true);
+        auto U = std::make_shared<Matrix>("U", ntr, ntr);
+        auto lambda = std::make_shared<Vector>("lambda", ntr);
+        S->diagonalize(U, lambda, descending);
+        int nrt = 0;
+        while (nrt < ntr && lambda->get(nrt) > tr_tolerance * tr_tolerance) nrt++;
+        result.nrt = nrt;
+
+        if (nrt) {
+            Q = std::make_shared<Matrix>("Q", n3, nrt);
+            double** Qp = Q->pointer();
+            double** Up = U->pointer();
+            for (int i = 0; i < n3; i++) {
+                for (int k = 0; k < nrt; k++) {
+                    double value = 0.0;
+                    for (int t = 0; t < ntr; t++) value += TRp[t][i] * Up[t][k];
+                    Qp[i][k] = value / std::sqrt(lambda->get(k));
+                }
+            }
+
+            // P H P with P = 1 - Q Q^T, as rank-nrt updates
+            SharedMatrix HQ = Matrix::doublet(mwhess, Q);
+            SharedMatrix QHQ = Matrix::doublet(Q, HQ, true, false);
+            SharedMatrix QHQQ = Matrix::doublet(QHQ, Q, false, true);
+            mwhess->gemm(false, true, -1.0, HQ, Q, 1.0);
+            mwhess->gemm(false, true, -1.0, Q, HQ, 1.0);
+            mwhess->gemm(false, false, 1.0, Q, QHQQ, 1.0);
+        }
+    }
+
+    auto L = std::make_shared<Matrix>("Normal modes", n3, n3);
+    auto force_constants = std::make_shared<Vector>("Force constants", n3);
+    mwhess->diagonalize(L, force_constants, ascending);
+
+    // Keep the modes with a component outside the translation/rotation space
+    std::vector<int> vib;
+    SharedMatrix QL = Q ? Matrix::doublet(Q, L, true, false) : nullptr;
+    const double uconv_cm_1 = std::sqrt(pc_na * pc_hartree2J * 1.0E19) / (2.0 * pc_pi * pc_c * pc_bohr2angstroms);
+    for (int k = 0; k < n3; k++) {
+        if (QL) {
+            double overlap = 0.0;
+            for (int r = 0; r < result.nrt; r++) overlap += QL->get(r, k) * QL->get(r, k);
+            if (std::sqrt(std::max(0.0, 1.0 - overlap)) < tr_overlap_tolerance) continue;
+        }
+        // Modes of a partial Hessian
+        if (std::sqrt(std::fabs(force_constants->get(k))) * uconv_cm_1 < 1.0E-3) continue;
+        vib.push_back(k);
+    }
+
+    int nvib = vib.size();
+    result.frequencies = std::make_shared<Vector>("Frequencies", nvib);
+    if (normal_modes_) result.normal_modes = std::make_shared<Matrix>("Normal modes", n3, nvib);
+    for (int v = 0; v < nvib; v++) {
+        double fc = force_constants->get(vib[v]);
+        result.frequencies->set(v, std::copysign(std::sqrt(std::fabs(fc)) * uconv_cm_1, fc));
+        if (fc < 0.0) result.nimag++;
+        if (normal_modes_) {
+            for (int i = 0; i < n3; i++) result.normal_modes->set(i, v, L->get(i, vib[v]));
+        }
+    }
+
+    // Rigid-rotor/harmonic-oscillator thermochemistry, in units of R (S, Cv, Cp) and K (energies), as qcdb.vib.thermo
+    double T = T_;
+    double beta = 1.0 / (pc_kb * T);
+    double molecular_mass = 0.0;
+    for (int A = 0; A < natom; A++) molecular_mass += m[A];
+
+    result.lnq_elec = std::log((double)system.multiplicity);
+    double S = result.lnq_elec;
+
+    double q_trans = std::pow(2.0 * pc_pi * molecular_mass * pc_amu2kg / (beta * pc_h * pc_h), 1.5) / (beta * P_);
+    result.lnq_trans = std::log(q_trans);
+    S += 2.5 + result.lnq_trans;
+    double Cv = 1.5;
+    double Cp = 2.5;
+    double E = 1.5 * T;
+    double H = 2.5 * T;
+
+    if (system.linear) {
+        result.lnq_rot = -std::log(beta * system.sigma * 100 * pc_c * pc_h * system.rot_const[1]);
+        S += 1.0 + result.lnq_rot;
+        Cv += 1.0;
+        Cp += 1.0;
+        E += T;
+        H += T;
+    } else if (!system.atom) {
+        double phi = 1.0;
+        for (int i = 0; i < 3; i++) phi *= system.rot_const[i] * 100 * pc_c * pc_h / pc_kb;
+        result.lnq_rot = std::log(std::sqrt(pc_pi) * std::pow(T, 1.5) / (system.sigma * std::sqrt(phi)));
+        S += 1.5 + result.lnq_rot;
+        Cv += 1.5;
+        Cp += 1.5;
+        E += 1.5 * T;
+        H += 1.5 * T;
+    }
+
+    // Vibrations, imaginary ones excluded
+    const double uconv_K = 100 * pc_h * pc_c / pc_kb;
+    double ZPE = 0.0;
+    for (int v = 0; v < nvib; v++) {
+        double omega = result.frequencies->get(v);
+        if (omega < 0.0) continue;
+        double rT = omega * uconv_K / T;
+        double expm1 = std::expm1(rT);
+        result.lnq_vib -= std::log1p(-std::exp(-rT));
+        S += rT / expm1 - std::log1p(-std::exp(-rT));
+        Cv += std::exp(rT) * (rT / expm1) * (rT / expm1);
+        Cp += std::exp(rT) * (rT / expm1) * (rT / expm1);
+        ZPE += rT * T / 2.0;
+        E += rT * T / 2.0 + rT * T / expm1;
+        H += rT * T / 2.0 + rT * T / expm1;
+    }
+
+    // [mEh/K] <-- [] and [Eh] <-- [K]
+    const double uconv_R_EhK = pc_R / pc_hartree2kJmol;
+    result.S = S * uconv_R_EhK;
+    result.Cv = Cv * uconv_R_EhK;
+    result.Cp = Cp * uconv_R_EhK;
+    result.ZPE = ZPE * uconv_R_EhK * 0.001;
+    result.E = E * uconv_R_EhK * 0.001;
+    result.H = H * uconv_R_EhK * 0.001;
+    result.G = (H - T * S) * uconv_R_EhK * 0.001;
+
+    return result;
+}
+
+}  // namespace psi
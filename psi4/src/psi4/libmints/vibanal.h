@@ -0,0 +1,128 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libmints_vibanal_h_
+#define _psi_src_lib_libmints_vibanal_h_
+
+#include "psi4/libmints/typedefs.h"
+#include "psi4/pragma.h"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace psi {
+
+class Molecule;
+
+/// One Hessian of a BatchVibAnalysis run, with what the thermochemistry needs of its molecule
+struct VibAnalysisSystem {
+    /// Non-mass-weighted Cartesian Hessian (3 nat x 3 nat), Eh/a0^2
+    SharedMatrix hessian;
+    /// Geometry (nat x 3, bohr) and masses (u)
+    std::vector<double> geometry;
+    std::vector<double> mass;
+    int multiplicity;
+    int sigma;
+    bool atom;
+    bool linear;
+    /// Rotational constants A, B, C in cm^-1
+    std::array<double, 3> rot_const;
+};
+
+/// Harmonic frequencies and thermochemistry of one system of a BatchVibAnalysis run
+struct VibAnalysisResult {
+    /// Vibrational frequencies in cm^-1, ascending, imaginary ones as negative numbers
+    SharedVector frequencies;
+    /// Normalized mass-weighted normal modes (3 nat x nvib), if requested
+    SharedMatrix normal_modes;
+    /// Number of translations and rotations projected out, and of imaginary modes
+    int nrt = 0;
+    int nimag = 0;
+    /// Natural logs of the electronic, translational (per molecule), rotational and vibrational
+    /// partition functions; the vibrational one counts energies from the zero-point level
+    double lnq_elec = 0.0;
+    double lnq_trans = 0.0;
+    double lnq_rot = 0.0;
+    double lnq_vib = 0.0;
+    /// Zero-point, thermal energy, enthalpy and Gibbs free energy corrections (Eh)
+    double ZPE = 0.0;
+    double E = 0.0;
+    double H = 0.0;
+    double G = 0.0;
+    /// Total entropy and heat capacities (mEh/K)
+    double S = 0.0;
+    double Cv = 0.0;
+    double Cp = 0.0;
+    /// Set instead of the above if the system could not be analyzed
+    std::string error;
+};
+
+/*! \ingroup MINTS
+ *  \class BatchVibAnalysis
+ *  \brief Harmonic vibrational analysis and ideal-gas thermochemistry of many Hessians at once.
+ *
+ * This is the compiled counterpart of qcdb.vib.harmonic_analysis and qcdb.vib.thermo for
+ * conformer-sized workloads. Each Hessian is mass-weighted, has the idealized translations and
+ * rotations projected out as a rank-nrt update, and is diagonalized with LAPACK. Modes lying in
+ * the translation/rotation space are dropped, and the rigid-rotor/harmonic-oscillator partition
+ * functions are formed from the rest, with imaginary modes excluded as in thermo. Systems are
+ * spread over the job's threads with single-threaded BLAS each; a failure is recorded in its
+ * result rather than thrown.
+ */
+class PSI_API BatchVibAnalysis {
+   protected:
+    std::vector<VibAnalysisSystem> systems_;
+    /// Temperature (K) and pressure (Pa)
+    double T_;
+    double P_;
+    bool project_trans_;
+    bool project_rot_;
+    bool normal_modes_ = false;
+
+    /// Analyzes one system on the calling thread
+    VibAnalysisResult compute_system(const VibAnalysisSystem& system) const;
+
+   public:
+    BatchVibAnalysis(double T, double P, bool project_trans = true, bool project_rot = true);
+
+    /// Queues a Hessian of mol; sigma overrides the molecule's rotational symmetry number if positive
+    void add_system(SharedMatrix hessian, std::shared_ptr<Molecule> mol, int sigma = 0);
+    size_t nsystem() const { return systems_.size(); }
+
+    /// Also return the vibrational normal modes (off by default)
+    void set_normal_modes(bool normal_modes) { normal_modes_ = normal_modes; }
+
+    /// Analyzes every queued system, spread over the job's threads
+    std::vector<VibAnalysisResult> compute();
+};
+
+}  // namespace psi
+
+#endif
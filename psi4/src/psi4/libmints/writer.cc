@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <utility>
 #include <algorithm>
+#include <string>
 #include <vector>
 #include "psi4/libmints/writer.h"
 #include "psi4/psi4-dec.h"
@@ -43,7 +44,63 @@
 #include "psi4/libmints/mintshelper.h"
 
 using namespace psi;
-;
+
+namespace {
+
+std::string join_records(const std::vector<std::string> &records) {
+    size_t length = 0;
+    for (const std::string &record : records) length += record.size();
+    std::string text;
+    text.reserve(length);
+    for (const std::string &record : records) text += record;
+    return text;
+}
+
+int format_fchk_field(char *field, size_t size, double value) { return std::snprintf(field, size, "%16.8e", value); }
+int format_fchk_field(char *field, size_t size, int value) { return std::snprintf(field, size, "%12d", value); }
+
+/* Formats n values, perline to a line, in the fixed-width FCHK fields.
+ * Blocks of whole lines are formatted concurrently and joined in order,
+ * so the text is the same as formatting the values one at a time. */
+template <typename T>
+std::string format_fchk_values(const T *values, size_t n, size_t perline) {
+    const size_t lines_per_block = 2048;
+    size_t per_block = lines_per_block * perline;
+    long int nblock = (n + per_block - 1) / per_block;
+    std::vector<std::string> blocks(nblock);
+
+#pragma omp parallel for schedule(dynamic) if (nblock > 1)
+    for (long int b = 0; b < nblock; b++) {
+        size_t begin = b * per_block;
+        size_t end = std::min(n, begin + per_block);
+        std::string &block = blocks[b];
+        block.reserve((end - begin) * 17);
+        char field[32];
+        for (size_t i = begin; i < end; i++) {
+            block.append(field, format_fchk_field(field, sizeof(field), values[i]));
+            if (i % perline == perline - 1 || i == n - 1) block.push_back('\n');
+        }
+    }
+
+    return join_records(blocks);
+}
+
+/* The molden [MO] record of column n of irrep h of C */
+std::string format_molden_mo(const char *symbol, double energy, const char *spin, double occupation,
+                             const SharedMatrix &C, int h, int n, int nso) {
+    std::string record;
+    record.reserve(96 + 25 * nso);
+    char line[96];
+    record.append(line, std::snprintf(line, sizeof(line), " Sym= %s\n", symbol));
+    record.append(line, std::snprintf(line, sizeof(line), " Ene= %20.10f\n", energy));
+    record.append(line, std::snprintf(line, sizeof(line), " Spin= %s\n", spin));
+    record.append(line, std::snprintf(line, sizeof(line), " Occup= %7.4lf\n", occupation));
+    for (int so = 0; so < nso; ++so)
+        record.append(line, std::snprintf(line, sizeof(line), "%3d %20.12lf\n", so + 1, C->get(h, so, n)));
+    return record;
+}
+
+}  // namespace
 
 MoldenWriter::MoldenWriter(std::shared_ptr<Wavefunction> wavefunction) : wavefunction_(wavefunction) {}
 void MoldenWriter::write(const std::string &filename, std::shared_ptr<Matrix> Ca, std::shared_ptr<Matrix> Cb,
@@ -196,20 +253,18 @@ void MoldenWriter::write(const std::string &filename, std::shared_ptr<Matrix> Ca
     }
     std::sort(mos.begin(), mos.end());
 
+    // The records are formatted concurrently and written in one go
+    int nso = wavefunction_->nso();
+    std::vector<std::string> records(mos.size());
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < (int)mos.size(); ++i) {
         int h = mos[i].second.first;
         int n = mos[i].second.second;
-
-        printer->Printf(" Sym= %s\n", ct.gamma(h).symbol());
-        printer->Printf(" Ene= %20.10f\n", Ea->get(h, n));
-        printer->Printf(" Spin= Alpha\n");
-        if (Ca == Cb && Ea == Eb && SameOcc)
-            printer->Printf(" Occup= %7.4lf\n", OccA->get(h, n) + OccB->get(h, n));
-        else
-            printer->Printf(" Occup= %7.4lf\n", OccA->get(h, n));
-        for (int so = 0; so < wavefunction_->nso(); ++so)
-            printer->Printf("%3d %20.12lf\n", so + 1, Ca_ao_mo->get(h, so, n));
+        double occupation = OccA->get(h, n);
+        if (Ca == Cb && Ea == Eb && SameOcc) occupation += OccB->get(h, n);
+        records[i] = format_molden_mo(ct.gamma(h).symbol(), Ea->get(h, n), "Alpha", occupation, Ca_ao_mo, h, n, nso);
     }
+    printer->Printf(join_records(records));
 
     // do beta's
     mos.clear();
@@ -221,17 +276,15 @@ void MoldenWriter::write(const std::string &filename, std::shared_ptr<Matrix> Ca
         }
         std::sort(mos.begin(), mos.end());
 
+        records.assign(mos.size(), std::string());
+#pragma omp parallel for schedule(dynamic)
         for (int i = 0; i < (int)mos.size(); ++i) {
             int h = mos[i].second.first;
             int n = mos[i].second.second;
-
-            printer->Printf(" Sym= %s\n", ct.gamma(h).symbol());
-            printer->Printf(" Ene= %20.10lf\n", Eb->get(h, n));
-            printer->Printf(" Spin= Beta\n");
-            printer->Printf(" Occup= %7.4lf\n", OccB->get(h, n));
-            for (int so = 0; so < wavefunction_->nso(); ++so)
-                printer->Printf("%3d %20.12lf\n", so + 1, Cb_ao_mo->get(h, so, n));
+            records[i] = format_molden_mo(ct.gamma(h).symbol(), Eb->get(h, n), "Beta", OccB->get(h, n), Cb_ao_mo, h,
+                                          n, nso);
         }
+        printer->Printf(join_records(records));
     }
 }
 
@@ -246,72 +299,42 @@ void FCHKWriter::write_number(const char *label, int value) { fprintf(chk_, "%-4
 
 void FCHKWriter::write_sym_matrix(const char *label, const SharedMatrix &mat) {
     int dim = mat->rowdim();
-    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "R", (dim * dim + dim) / 2);
-
-    int count = 0;
+    std::vector<double> values;
+    values.reserve((dim * dim + dim) / 2);
     for (int i = 0; i < dim; ++i) {
-        for (int j = 0; j <= i; ++j) {
-            fprintf(chk_, "%16.8e", mat->get(i, j));
-            if (count % 5 == 4) fprintf(chk_, "\n");
-            ++count;
-        }
+        for (int j = 0; j <= i; ++j) values.push_back(mat->get(i, j));
     }
-    if (count % 5) fprintf(chk_, "\n");
+    write_matrix(label, values);
 }
 
 void FCHKWriter::write_matrix(const char *label, const SharedVector &mat) {
     int dim = mat->dim();
-    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "R", dim);
-
-    int count = 0;
-    for (int i = 0; i < dim; ++i) {
-        fprintf(chk_, "%16.8e", mat->get(count));
-        if (count % 5 == 4) fprintf(chk_, "\n");
-        ++count;
-    }
-    if (count % 5) fprintf(chk_, "\n");
+    std::vector<double> values(dim);
+    for (int i = 0; i < dim; ++i) values[i] = mat->get(i);
+    write_matrix(label, values);
 }
 
 void FCHKWriter::write_matrix(const char *label, const SharedMatrix &mat) {
     int rowdim = mat->rowdim();
     int coldim = mat->coldim();
-    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "R", rowdim * coldim);
-
-    int count = 0;
+    std::vector<double> values;
+    values.reserve((size_t)rowdim * coldim);
     for (int i = 0; i < rowdim; ++i) {
-        for (int j = 0; j < coldim; ++j) {
-            fprintf(chk_, "%16.8e", mat->get(i, j));
-            if (count % 5 == 4) fprintf(chk_, "\n");
-            ++count;
-        }
+        for (int j = 0; j < coldim; ++j) values.push_back(mat->get(i, j));
     }
-    if (count % 5) fprintf(chk_, "\n");
+    write_matrix(label, values);
 }
 
 void FCHKWriter::write_matrix(const char *label, const std::vector<double> &mat) {
-    int dim = mat.size();
-    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "R", dim);
-
-    int count = 0;
-    for (int i = 0; i < dim; ++i) {
-        fprintf(chk_, "%16.8e", mat[count]);
-        if (count % 5 == 4) fprintf(chk_, "\n");
-        ++count;
-    }
-    if (count % 5) fprintf(chk_, "\n");
+    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "R", (int)mat.size());
+    std::string text = format_fchk_values(mat.data(), mat.size(), 5);
+    fwrite(text.data(), 1, text.size(), chk_);
 }
 
 void FCHKWriter::write_matrix(const char *label, const std::vector<int> &mat) {
-    int dim = mat.size();
-    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "I", dim);
-
-    int count = 0;
-    for (int i = 0; i < dim; ++i) {
-        fprintf(chk_, "%12d", mat[count]);
-        if (count % 6 == 5) fprintf(chk_, "\n");
-        ++count;
-    }
-    if (count % 6) fprintf(chk_, "\n");
+    fprintf(chk_, "%-43s%-3s N=%12d\n", label, "I", (int)mat.size());
+    std::string text = format_fchk_values(mat.data(), mat.size(), 6);
+    fwrite(text.data(), 1, text.size(), chk_);
 }
 
 void FCHKWriter::write(const std::string &filename) {
@@ -26,6 +26,10 @@
  * @END LICENSE
  */
 
+#include <map>
+#include <mutex>
+#include <vector>
+
 #include "psi4/psifiles.h"
 #include "psi4/psi4-dec.h"
 #include "psi4/physconst.h"
@@ -33,6 +37,9 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
 #include "psi4/libmints/rel_potential.h"
+#include "psi4/libmints/potential.h"
+#include "psi4/libmints/petitelist.h"
+#include "psi4/libmints/molecule.h"
 #include "psi4/libmints/integral.h"
 #include "psi4/libmints/x2cint.h"
 #include "psi4/libmints/sointegral_onebody.h"
@@ -41,10 +48,92 @@
 #include "psi4/libmints/sobasis.h"
 #include "psi4/libmints/basisset.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace psi {
 
-X2CInt::X2CInt() {}
+namespace {
+
+/// The X and R blocks of a free atom, shared by every atom with the same key in this job
+struct AtomicBlocks {
+    SharedMatrix X;
+    SharedMatrix R;
+};
+
+std::mutex x2c_cache_lock;
+std::map<std::vector<double>, AtomicBlocks> x2c_atom_cache;
+
+/*
+ * Solve the modified Dirac equation of one atom in its own basis (C1 matrices of dimension n)
+ * and return the decoupling matrix X and the renormalization R. This is the molecular
+ * form_dirac_h() ... form_R() sequence on a single atom block.
+ */
+AtomicBlocks solve_free_atom(SharedMatrix S, SharedMatrix T, SharedMatrix V, SharedMatrix W) {
+    int n = S->rowdim();
+    double c2 = pc_c_au * pc_c_au;
+
+    auto D = std::make_shared<Matrix>("Atomic Dirac Hamiltonian", 2 * n, 2 * n);
+    auto SX = std::make_shared<Matrix>("Atomic SX Hamiltonian", 2 * n, 2 * n);
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            double Tpq = T->get(p, q);
+            SX->set(p, q, S->get(p, q));
+            SX->set(p + n, q + n, 0.5 * Tpq / c2);
+            D->set(p, q, V->get(p, q));
+            D->set(p + n, q, Tpq);
+            D->set(p, q + n, Tpq);
+            D->set(p + n, q + n, 0.25 * W->get(p, q) / c2 - Tpq);
+        }
+    }
+
+    auto Dvec = std::make_shared<Matrix>("Atomic Dirac tmp EigenVectors", 2 * n, 2 * n);
+    auto C = std::make_shared<Matrix>("Atomic Dirac EigenVectors", 2 * n, 2 * n);
+    auto E = std::make_shared<Vector>("Atomic Dirac EigenValues", 2 * n);
+    SX->power(-1.0 / 2.0);
+    D->transform(SX);
+    D->diagonalize(Dvec, E);
+    C->gemm(false, false, 1.0, SX, Dvec, 0.0);
+
+    // X = C_small (C_large)^{-1} over the positive energy states
+    auto cl = std::make_shared<Matrix>("Atomic Large EigenVectors", n, n);
+    auto cs = std::make_shared<Matrix>("Atomic Small EigenVectors", n, n);
+    for (int p = 0; p < n; ++p) {
+        for (int q = 0; q < n; ++q) {
+            cl->set(p, q, C->get(p, q + n));
+            cs->set(p, q, C->get(p + n, q + n));
+        }
+    }
+    cl->general_invert();
+    AtomicBlocks blocks;
+    blocks.X = std::make_shared<Matrix>("Atomic X matrix", n, n);
+    blocks.X->gemm(false, false, 1.0, cs, cl, 0.0);
+
+    // R = S^{-1/2} (S^{-1/2} S_tilde S^{-1/2})^{-1/2} S^{1/2}, S_tilde = S + X^ T X / 2c**2
+    auto S_tilde = std::make_shared<Matrix>("Atomic S tilde matrix", n, n);
+    S_tilde->transform(blocks.X, T, blocks.X);
+    S_tilde->scale(1.0 / (2.0 * c2));
+    S_tilde->add(S);
+
+    SharedMatrix S_inv_half = S->clone();
+    S_inv_half->power(-1.0 / 2.0);
+    auto sTmp1 = std::make_shared<Matrix>("Atomic S tmp1 matrix", n, n);
+    auto sTmp2 = std::make_shared<Matrix>("Atomic S tmp2 matrix", n, n);
+    sTmp1->transform(S_tilde, S_inv_half);
+    sTmp1->power(-1.0 / 2.0);
+    sTmp2->gemm(false, false, 1.0, S_inv_half, sTmp1, 0.0);
+    S_inv_half->general_invert();
+    blocks.R = std::make_shared<Matrix>("Atomic R matrix", n, n);
+    blocks.R->gemm(false, false, 1.0, sTmp2, S_inv_half, 0.0);
+    return blocks;
+}
+
+}  // namespace
+
+X2CInt::X2CInt() : do_dlu_(false), nthread_(Process::environment.get_n_threads()) {}
 
 X2CInt::~X2CInt() {}
 
@@ -53,17 +142,22 @@ void X2CInt::compute(std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet>
     // tstart();
     setup(basis, x2c_basis);
     compute_integrals();
-    form_dirac_h();
-    diagonalize_dirac_h();
-    form_X();
-    form_R();
+    if (do_dlu_) {
+        form_dlu_X_R();
+    } else {
+        form_dirac_h();
+        diagonalize_dirac_h();
+        form_X();
+        form_R();
+    }
     form_h_FW_plus();
 
     if (do_project_) {
         project();
     }
 
-    test_h_FW_plus();
+    // DLU never forms the molecular Dirac eigenvalues to compare against
+    if (!do_dlu_) test_h_FW_plus();
 
     S->copy(S_x2c_);
     T->copy(T_x2c_);
@@ -92,6 +186,7 @@ void X2CInt::setup(std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet> x2
     outfile->Printf("\n  ==> X2C Options <==\n");
     outfile->Printf("\n    Computational Basis: %s", basis_.c_str());
     outfile->Printf("\n    X2C Basis: %s", x2c_basis_.c_str());
+    outfile->Printf("\n    Decoupling: %s", (do_dlu_ ? "DLU (free-atom X and R blocks)" : "Full"));
     outfile->Printf("\n    The X2C Hamiltonian will be computed in the X2C Basis\n");
 
     // The integral factory oversees the creation of integral objects
@@ -105,6 +200,9 @@ void X2CInt::setup(std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet> x2
     nsopi_ = soBasis->dimension();
     nsopi_contracted_ = nsopi_;
 
+    // Integrals are built in the AO basis and symmetrized
+    aotoso_ = std::make_shared<PetiteList>(aoBasis_, integral_)->aotoso();
+
     // Create a Dimension object for the spinors
     Dimension nsspi = nsopi_ + nsopi_;
 
@@ -118,23 +216,55 @@ void X2CInt::setup(std::shared_ptr<BasisSet> basis, std::shared_ptr<BasisSet> x2
 }
 
 void X2CInt::compute_integrals() {
-    // Create the integral objects
-    std::shared_ptr<OneBodySOInt> sOBI(integral_->so_overlap());
-    std::shared_ptr<OneBodySOInt> tOBI(integral_->so_kinetic());
-    std::shared_ptr<OneBodySOInt> vOBI(integral_->so_potential());
-    std::shared_ptr<OneBodySOInt> wOBI(integral_->so_rel_potential());
+    // Create the integral objects, one set per thread
+    int nbf = aoBasis_->nbf();
+    std::vector<std::vector<std::shared_ptr<OneBodyAOInt>>> ints(4);
+    for (int t = 0; t < nthread_; ++t) {
+        ints[0].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_overlap()));
+        ints[1].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_kinetic()));
+        ints[2].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_potential()));
+        ints[3].push_back(std::shared_ptr<OneBodyAOInt>(integral_->ao_rel_potential()));
+    }
+    sAO_ = std::make_shared<Matrix>("AO Overlap", nbf, nbf);
+    tAO_ = std::make_shared<Matrix>("AO Kinetic", nbf, nbf);
+    auto vAO = std::make_shared<Matrix>("AO Potential", nbf, nbf);
+    auto wAO = std::make_shared<Matrix>("AO Relativistic Potential", nbf, nbf);
+    std::vector<double**> outp = {sAO_->pointer(), tAO_->pointer(), vAO->pointer(), wAO->pointer()};
+
+// Compute the one electron integrals over the unique shell pairs of the (large) decontracted basis
+#pragma omp parallel for schedule(guided) num_threads(nthread_)
+    for (int MU = 0; MU < aoBasis_->nshell(); ++MU) {
+        int rank = 0;
+#ifdef _OPENMP
+        rank = omp_get_thread_num();
+#endif
+        int num_mu = aoBasis_->shell(MU).nfunction();
+        int index_mu = aoBasis_->shell(MU).function_index();
+        for (int NU = 0; NU <= MU; ++NU) {
+            int num_nu = aoBasis_->shell(NU).nfunction();
+            int index_nu = aoBasis_->shell(NU).function_index();
+            for (size_t op = 0; op < ints.size(); ++op) {
+                ints[op][rank]->compute_shell(MU, NU);
+                const double* buff = ints[op][rank]->buffer();
+                double** matp = outp[op];
+                for (int mu = index_mu, index = 0; mu < index_mu + num_mu; ++mu) {
+                    for (int nu = index_nu; nu < index_nu + num_nu; ++nu, ++index) {
+                        matp[nu][mu] = matp[mu][nu] = buff[index];
+                    }
+                }
+            }
+        }
+    }
 
     // Form the one-electron integral matrices from the matrix factory
     sMat = SharedMatrix(soFactory_->create_matrix("Overlap"));
     tMat = SharedMatrix(soFactory_->create_matrix("Kinetic"));
     vMat = SharedMatrix(soFactory_->create_matrix("Potential"));
     wMat = SharedMatrix(soFactory_->create_matrix("Relativistic Potential"));
-
-    // Compute the one electron integrals, telling each object where to store the result
-    sOBI->compute(sMat);
-    tOBI->compute(tMat);
-    vOBI->compute(vMat);
-    wOBI->compute(wMat);
+    sMat->apply_symmetry(sAO_, aotoso_);
+    tMat->apply_symmetry(tAO_, aotoso_);
+    vMat->apply_symmetry(vAO, aotoso_);
+    wMat->apply_symmetry(wAO, aotoso_);
 
 #if X2CDEBUG
     sMat->print();
@@ -340,6 +470,146 @@ void X2CInt::form_R() {
 #endif
 }
 
+std::vector<double> X2CInt::atom_key(int atom) const {
+    std::vector<double> key;
+    key.push_back(aoBasis_->molecule()->Z(atom));
+    key.push_back(aoBasis_->nshell_on_center(atom));
+    for (int n = 0; n < aoBasis_->nshell_on_center(atom); ++n) {
+        const GaussianShell& shell = aoBasis_->shell(aoBasis_->shell_on_center(atom, n));
+        key.insert(key.end(), {(double)shell.am(), (double)shell.is_pure(), (double)shell.nprimitive()});
+        for (int K = 0; K < shell.nprimitive(); ++K) {
+            key.push_back(shell.exp(K));
+            key.push_back(shell.original_coef(K));
+        }
+    }
+    return key;
+}
+
+void X2CInt::form_dlu_X_R() {
+    /*
+     * Diagonal local unitary (DLU) approximation:
+     * X and R are block diagonal over atoms, each block taken from the free atom
+     * (its own nucleus only) in its own basis. The blocks do not depend on the
+     * geometry, so they are solved once per element and basis and cached for the job.
+     */
+    std::shared_ptr<Molecule> mol = aoBasis_->molecule();
+    int natom = mol->natom();
+    int nbf = aoBasis_->nbf();
+
+    // Pick up cached blocks and collect one representative atom per missing key
+    std::vector<std::vector<double>> keys(natom);
+    std::map<std::vector<double>, AtomicBlocks> blocks;
+    std::vector<int> todo;
+    {
+        std::lock_guard<std::mutex> lock(x2c_cache_lock);
+        for (int A = 0; A < natom; ++A) {
+            if (aoBasis_->nshell_on_center(A) == 0) continue;
+            keys[A] = atom_key(A);
+            if (blocks.count(keys[A])) continue;
+            auto it = x2c_atom_cache.find(keys[A]);
+            if (it != x2c_atom_cache.end()) {
+                blocks[keys[A]] = it->second;
+            } else {
+                blocks[keys[A]] = AtomicBlocks();
+                todo.push_back(A);
+            }
+        }
+    }
+    outfile->Printf("\n    DLU atomic blocks: %zu unique, %zu from cache\n", blocks.size(), blocks.size() - todo.size());
+
+    // Solve the missing free atoms, one per thread
+    std::vector<AtomicBlocks> solved(todo.size());
+#pragma omp parallel for schedule(dynamic) num_threads(nthread_)
+    for (size_t i = 0; i < todo.size(); ++i) {
+        int A = todo[i];
+        int first_shell = aoBasis_->shell_on_center(A, 0);
+        int nshell = aoBasis_->nshell_on_center(A);
+        int offset = aoBasis_->shell_to_basis_function(first_shell);
+        int n = 0;
+        for (int P = first_shell; P < first_shell + nshell; ++P) n += aoBasis_->shell(P).nfunction();
+
+        auto S = std::make_shared<Matrix>("Atomic Overlap", n, n);
+        auto T = std::make_shared<Matrix>("Atomic Kinetic", n, n);
+        auto V = std::make_shared<Matrix>("Atomic Potential", n, n);
+        auto W = std::make_shared<Matrix>("Atomic Relativistic Potential", n, n);
+        for (int p = 0; p < n; ++p) {
+            for (int q = 0; q < n; ++q) {
+                S->set(p, q, sAO_->get(p + offset, q + offset));
+                T->set(p, q, tAO_->get(p + offset, q + offset));
+            }
+        }
+
+        // V and W of the atom's own nucleus
+        auto Zxyz = std::make_shared<Matrix>("Atomic Charge Field (Z,x,y,z)", 1, 4);
+        Zxyz->set(0, 0, mol->Z(A));
+        Zxyz->set(0, 1, mol->x(A));
+        Zxyz->set(0, 2, mol->y(A));
+        Zxyz->set(0, 3, mol->z(A));
+        std::unique_ptr<PotentialInt> vint(static_cast<PotentialInt*>(integral_->ao_potential()));
+        std::unique_ptr<RelPotentialInt> wint(static_cast<RelPotentialInt*>(integral_->ao_rel_potential()));
+        vint->set_charge_field(Zxyz);
+        wint->set_charge_field(Zxyz);
+        for (int P = first_shell; P < first_shell + nshell; ++P) {
+            int np = aoBasis_->shell(P).nfunction();
+            int op = aoBasis_->shell(P).function_index() - offset;
+            for (int Q = first_shell; Q < first_shell + nshell; ++Q) {
+                int nq = aoBasis_->shell(Q).nfunction();
+                int oq = aoBasis_->shell(Q).function_index() - offset;
+                vint->compute_shell(P, Q);
+                wint->compute_shell(P, Q);
+                const double* vbuff = vint->buffer();
+                const double* wbuff = wint->buffer();
+                for (int p = 0, index = 0; p < np; ++p) {
+                    for (int q = 0; q < nq; ++q, ++index) {
+                        V->set(op + p, oq + q, vbuff[index]);
+                        W->set(op + p, oq + q, wbuff[index]);
+                    }
+                }
+            }
+        }
+        solved[i] = solve_free_atom(S, T, V, W);
+    }
+
+    if (!todo.empty()) {
+        std::lock_guard<std::mutex> lock(x2c_cache_lock);
+        for (size_t i = 0; i < todo.size(); ++i) {
+            blocks[keys[todo[i]]] = solved[i];
+            x2c_atom_cache[keys[todo[i]]] = solved[i];
+        }
+    }
+
+    // Assemble the block diagonal X and R and symmetrize them
+    auto xAO = std::make_shared<Matrix>("AO X matrix", nbf, nbf);
+    auto rAO = std::make_shared<Matrix>("AO R matrix", nbf, nbf);
+    for (int A = 0; A < natom; ++A) {
+        if (aoBasis_->nshell_on_center(A) == 0) continue;
+        const AtomicBlocks& block = blocks[keys[A]];
+        int offset = aoBasis_->shell_to_basis_function(aoBasis_->shell_on_center(A, 0));
+        int n = block.X->rowdim();
+        for (int p = 0; p < n; ++p) {
+            for (int q = 0; q < n; ++q) {
+                xAO->set(p + offset, q + offset, block.X->get(p, q));
+                rAO->set(p + offset, q + offset, block.R->get(p, q));
+            }
+        }
+    }
+    xMat = SharedMatrix(soFactory_->create_matrix("X matrix"));
+    rMat = SharedMatrix(soFactory_->create_matrix("R matrix"));
+    xMat->apply_symmetry(xAO, aotoso_);
+    rMat->apply_symmetry(rAO, aotoso_);
+
+    xrMat = SharedMatrix(soFactory_->create_matrix("XR matrix"));
+    xrMat->gemm(false, false, 1.0, xMat, rMat, 0.0);  // XR = X R matrix
+#if X2CDEBUG
+    xrMat->print();
+#endif
+}
+
+void X2CInt::clear_cache() {
+    std::lock_guard<std::mutex> lock(x2c_cache_lock);
+    x2c_atom_cache.clear();
+}
+
 void X2CInt::form_h_FW_plus() {
     // Check if the matrices are allocated and have the correct size
     S_x2c_ = SharedMatrix(soFactory_->create_matrix(PSIF_SO_S));
@@ -33,6 +33,7 @@
 #include "psi4/libmints/dimension.h"
 
 #include <string>
+#include <vector>
 
 #define X2CDEBUG 0
 
@@ -62,6 +63,14 @@ class X2CInt {
                  SharedMatrix V);
     /*! @} */
 
+    /// Use the diagonal local unitary (DLU) approximation: X and R are assembled from free-atom blocks
+    void set_dlu(bool dlu) { do_dlu_ = dlu; }
+    /// Number of threads for the one-electron builds and the atomic solves
+    void set_nthread(int nthread) { nthread_ = nthread; }
+
+    /// Drop the atomic X and R blocks cached across X2CInt objects
+    static void clear_cache();
+
    private:
     /// The name of the basis set
     std::string basis_;
@@ -69,6 +78,10 @@ class X2CInt {
     std::string x2c_basis_;
     /// Do basis set projection?
     bool do_project_;
+    /// Use atom-block (DLU) X and R instead of solving the molecular Dirac equation?
+    bool do_dlu_;
+    /// Number of threads
+    int nthread_;
 
     /// Integral factory
     std::shared_ptr<IntegralFactory> integral_;
@@ -83,11 +96,19 @@ class X2CInt {
     std::shared_ptr<MatrixFactory> ssFactory_;
     /// Matrix factory for matrices of dimension nbf x nbf
     std::shared_ptr<MatrixFactory> soFactory_;
+    /// AO to SO transformation of the X2C basis
+    SharedMatrix aotoso_;
     /// Dimension of the orbital basis
     Dimension nsopi_;
     /// Dimension of the constracted orbital basis
     Dimension nsopi_contracted_;
 
+    // Matrices in the AO basis, kept for the atom blocks of the DLU approximation
+    /// The overlap matrix in the AO basis
+    SharedMatrix sAO_;
+    /// The kinetic energy matrix in the AO basis
+    SharedMatrix tAO_;
+
     // Matrices in the orbital basis
     /// The overlap matrix in the orbital basis
     SharedMatrix sMat;
@@ -132,6 +153,10 @@ class X2CInt {
     void form_X();
     /// Form the matrices R and XR
     void form_R();
+    /// Form X, R and XR from the free-atom blocks of each atom (DLU approximation)
+    void form_dlu_X_R();
+    /// Key identifying the free-atom problem of an atom: its nuclear charge and shells, not its position
+    std::vector<double> atom_key(int atom) const;
     /// Form the FW Hamiltonian for positive energy states
     void form_h_FW_plus();
     /// Write the FW Hamiltonian for positive energy states
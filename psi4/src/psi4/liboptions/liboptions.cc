@@ -493,7 +493,11 @@ std::string MapType::to_string() const {
     return str;
 }
 
-Options::Options() : edit_globals_(false) {}
+Options::Options()
+    : edit_globals_(false),
+      global_block_begin_(-1),
+      global_block_end_(std::numeric_limits<int>::max()),
+      global_block_index_(-1) {}
 
 Options& Options::operator=(const Options& rhs) {
     // Don't self copy
@@ -505,9 +509,32 @@ Options& Options::operator=(const Options& rhs) {
     return *this;
 }
 
-bool Options::read_globals() const { return edit_globals_; }
+bool Options::read_globals() const {
+    if (!edit_globals_) return false;
+    // Each module block of read_options asks once, so this also counts the blocks
+    ++global_block_index_;
+    return global_block_active();
+}
+
+void Options::set_read_globals(bool _b) {
+    edit_globals_ = _b;
+    global_block_index_ = -1;
+}
+
+void Options::set_global_blocks(int begin, int end) {
+    global_block_begin_ = begin;
+    global_block_end_ = end;
+    global_block_index_ = -1;
+}
 
-void Options::set_read_globals(bool _b) { edit_globals_ = _b; }
+bool Options::global_block_active() const {
+    return global_block_index_ >= global_block_begin_ && global_block_index_ < global_block_end_;
+}
+
+void Options::load_globals(const std::string& key) {
+    if (edit_globals_ || !global_loader_) return;
+    global_loader_(key);
+}
 
 void Options::set_current_module(const std::string s) {
     current_module_ = s;
@@ -536,6 +563,8 @@ void Options::add(std::string key, DataType* data) {
     std::map<std::string, Data>& local = edit_globals_ ? globals_ : locals_[current_module_];
 
     Data val(data);
+    // Blocks outside the requested window (e.g. the prelude on a lazy pass) are already registered
+    if (edit_globals_ && !global_block_active()) return;
     all_local_options_[key] = val;
 
     // Make sure the key isn't already there
@@ -556,7 +585,7 @@ void Options::add(std::string key, double d) { add(key, new DoubleDataType(d));
 
 void Options::add(std::string key, std::string s, std::string c) {
     if (edit_globals_ && globals_.count(key)) {
-        globals_[key].add_choices(c);
+        if (global_block_active()) globals_[key].add_choices(c);
     } else {
         add(key, new StringDataType(s, c));
     }
@@ -564,7 +593,7 @@ void Options::add(std::string key, std::string s, std::string c) {
 
 void Options::add_i(std::string key, std::string s, std::string c) {
     if (edit_globals_ && globals_.count(key)) {
-        globals_[key].add_choices(c);
+        if (global_block_active()) globals_[key].add_choices(c);
     } else {
         add(key, new IStringDataType(s, c));
     }
@@ -701,7 +730,10 @@ bool Options::exists_in_global(std::string key) {
 
     iterator pos = globals_.find(key);
     if (pos != globals_.end()) return true;
-    return false;
+
+    // The key may belong to a module whose globals have not been registered yet
+    load_globals(key);
+    return globals_.count(key);
 }
 
 bool Options::exists(std::string key) { return exists_in_active(key) || exists_in_global(key); }
@@ -796,6 +828,7 @@ Data& Options::use(std::string& key) {
         }
         /// "Global" set of options
         {
+            load_globals("");
             std::map<std::string, Data>::iterator it = globals_.begin();
             std::map<std::string, Data>::iterator endit = globals_.end();
             for (; it != endit; ++it) {
@@ -39,6 +39,8 @@
 #include "psi4/libpsi4util/exception.h"
 #include "psi4/libpsi4util/libpsi4util.h"  // Needed for Ref counting, string splitting, and conversions
 
+#include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -353,6 +355,16 @@ class MapType : public DataType {
 class PSI_API Options {
     bool edit_globals_;
 
+    /// Window [begin, end) of read_options blocks registered while editing globals (-1 is the prelude)
+    int global_block_begin_;
+    int global_block_end_;
+    /// Index of the read_options block currently being registered
+    mutable int global_block_index_;
+    /// Registers a missing global key on demand ("" registers everything)
+    std::function<void(const std::string&)> global_loader_;
+
+    bool global_block_active() const;
+
     /// A temporary map used for validation of local options
     std::map<std::string, Data> all_local_options_;
     /// The module that's active right now
@@ -374,6 +386,12 @@ class PSI_API Options {
     Options& operator=(const Options& rhs);
     bool read_globals() const;
     void set_read_globals(bool _b);
+    /// Restricts the next global read_options pass to blocks [begin, end); the defaults register all of them
+    void set_global_blocks(int begin = -1, int end = std::numeric_limits<int>::max());
+    /// Installs the callback that registers global options lazily; see exists_in_global
+    void set_global_loader(std::function<void(const std::string&)> loader) { global_loader_ = loader; }
+    /// Registers the lazily held back global options needed for key, or all of them for ""
+    void load_globals(const std::string& key = "");
     void set_current_module(const std::string s);
     std::string get_current_module() const { return current_module_; }
 
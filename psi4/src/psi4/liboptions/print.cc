@@ -75,7 +75,7 @@ std::string Options::to_string() const {
             // Local option was set, use it
             value = local_iter->second.to_string();
             option_specified = true;
-        } else if (global_iter->second.has_changed()) {
+        } else if (global_iter != globals_.end() && global_iter->second.has_changed()) {
             // Global option was set, get that
             value = global_iter->second.to_string();
             option_specified = true;
@@ -149,6 +149,7 @@ std::string Options::globals_to_string() const {
 }
 
 void Options::print_globals() {
+    load_globals("");
     std::string list = globals_to_string();
     outfile->Printf("\n\n  Global Options:");
     outfile->Printf("\n  ----------------------------------------------------------------------------\n");
@@ -156,6 +157,7 @@ void Options::print_globals() {
 }
 
 std::vector<std::string> Options::list_globals() {
+    load_globals("");
     std::vector<std::string> glist(globals_.size());
     int ii = 0;
 
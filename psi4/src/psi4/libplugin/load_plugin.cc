@@ -80,7 +80,8 @@ plugin_info plugin_load(std::string &plugin_pathname) {
     // Store the name of the plugin for read_options
     to_upper(info.name);
 
-    // Get the plugin's options into the global space
+    // Get the plugin's options into the global space, after every module's so that shared keys keep their defaults
+    Process::environment.options.load_globals();
     Process::environment.options.set_read_globals(true);
     info.read_options(info.name, Process::environment.options);
     Process::environment.options.set_read_globals(false);
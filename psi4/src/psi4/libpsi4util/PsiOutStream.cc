@@ -30,59 +30,281 @@
 
 #include "psi4/libpsi4util/exception.h"
 
+#include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <fstream>
 #include <cstdarg>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
-PsiOutStream::PsiOutStream(std::string fname, std::ios_base::openmode mode) {
+PsiOutStream::PsiOutStream(std::string fname, std::ios_base::openmode mode)
+    : policy_(FlushPolicy::Immediate),
+      flush_interval_(250),
+      flush_bytes_(1048576),
+      owner_(std::this_thread::get_id()),
+      writing_(false),
+      flush_requested_(false),
+      stop_(false) {
     if (fname == "") {
         stream_ = &std::cout;
         is_cout_ = true;
     } else {
         std::ofstream* tmpf = new std::ofstream(fname, mode);
         if (!tmpf->is_open()) {
+            delete tmpf;
             throw PSIEXCEPTION("PsiOutStream: Failed to open file.");
         }
 
         stream_ = tmpf;
         is_cout_ = false;
-    }
 
-    // This is sort of big, but vsnprintf does not appear to work correctly on all OS's.
-    // Im looking at YOU CentOS
-    buffer_.resize(512000);
+        // Per-iteration tables would otherwise block on every line, which is slow on network filesystems
+        set_flush_policy(FlushPolicy::Buffered);
+    }
 }
 
 PsiOutStream::~PsiOutStream() {
+    stop_writer();
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        commit_staged(lock);
+        stream_->flush();
+    }
     if (!is_cout_) {
         delete stream_;
     }
 }
 
 void PsiOutStream::Printf(const char* format, ...) {
+    // This is sort of big, but vsnprintf does not appear to work correctly on all OS's.
+    // Im looking at YOU CentOS
+    thread_local std::vector<char> buffer(512000);
+
     // We can check if the buffer is large enough
-    va_list args;
+    va_list args, retry;
     va_start(args, format);
-    int left = vsnprintf(buffer_.data(), buffer_.size(), format, args);
+    va_copy(retry, args);
+    int left = vsnprintf(buffer.data(), buffer.size(), format, args);
+    va_end(args);
+
+    if (left >= 0 && (size_t)left >= buffer.size()) {
+        // Buffer was too small! Grow it and try again
+        buffer.resize(left + 1);
+        left = vsnprintf(buffer.data(), buffer.size(), format, retry);
+    }
+    va_end(retry);
 
     if (left < 0) {
         // Encoding error?!?
         throw PSIEXCEPTION("PsiOutStream: vsnprintf encoding error!");
-    } else if (left >= buffer_.size()) {
-        // Buffer was too small! Try again
-        std::vector<char> tmp_buffer(left + 1);
-        left = vsnprintf(tmp_buffer.data(), left + 1, format, args);
-        if (left < 0) {
-            throw PSIEXCEPTION("PsiOutStream: vsnprintf encoding error!");
-        }
     }
     // Everything is cool
 
-    va_end(args);
-    (*stream_) << buffer_.data() << std::flush;
+    write(buffer.data(), left);
+}
+void PsiOutStream::Printf(std::string fp) { write(fp.data(), fp.size()); }
+
+void PsiOutStream::write(const char* text, size_t length) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    bool staging = std::this_thread::get_id() != owner_;
+#ifdef _OPENMP
+    staging = staging || omp_in_parallel();
+#endif
+    if (!staging) {
+        output(lock, text, length);
+        return;
+    }
+
+    // Concurrent threads' text goes out a whole line at a time, so lines printed concurrently do not interleave
+    auto staged = staged_.find(std::this_thread::get_id());
+    if (staged == staged_.end()) staged = staged_.emplace(std::this_thread::get_id(), std::string()).first;
+    staged->second.append(text, length);
+    size_t end = staged->second.rfind('\n');
+    if (end == std::string::npos) return;
+    output(lock, staged->second.data(), end + 1);
+    staged->second.erase(0, end + 1);
+    if (staged->second.empty()) staged_.erase(staged);
+}
+
+void PsiOutStream::output(std::unique_lock<std::mutex>& lock, const char* text, size_t length) {
+    if (policy_ == FlushPolicy::Immediate) {
+        // A writer thread being shut down may still be writing its last batch
+        drained_.wait(lock, [this] { return !writing_; });
+        stream_->write(text, length);
+        stream_->flush();
+    } else {
+        bool was_empty = pending_.empty();
+        pending_.append(text, length);
+        if (was_empty || pending_.size() >= flush_bytes_) wake_.notify_one();
+    }
+}
+
+void PsiOutStream::commit_staged(std::unique_lock<std::mutex>& lock) {
+    for (const auto& staged : staged_) output(lock, staged.second.data(), staged.second.size());
+    staged_.clear();
+}
+
+void PsiOutStream::write_pending(std::unique_lock<std::mutex>& lock) {
+    if (!pending_.empty()) {
+        std::string batch;
+        batch.swap(pending_);
+        writing_ = true;
+        lock.unlock();
+        stream_->write(batch.data(), batch.size());
+        stream_->flush();
+        lock.lock();
+        writing_ = false;
+    }
+    if (pending_.empty()) flush_requested_ = false;
+    drained_.notify_all();
+}
+
+void PsiOutStream::writer_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        wake_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+        wake_.wait_for(lock, flush_interval_,
+                       [this] { return stop_ || flush_requested_ || pending_.size() >= flush_bytes_; });
+        write_pending(lock);
+    }
+    write_pending(lock);
+}
+
+void PsiOutStream::stop_writer() {
+    if (!writer_.joinable()) return;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        commit_staged(lock);
+        policy_ = FlushPolicy::Immediate;
+        stop_ = true;
+    }
+    wake_.notify_one();
+    writer_.join();
+    stop_ = false;
+}
+
+void PsiOutStream::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    commit_staged(lock);
+    if (policy_ == FlushPolicy::Buffered) {
+        if (pending_.empty() && !writing_) return;
+        flush_requested_ = true;
+        wake_.notify_one();
+        drained_.wait(lock, [this] { return pending_.empty() && !writing_; });
+    } else {
+        stream_->flush();
+    }
+}
+
+void PsiOutStream::set_flush_policy(FlushPolicy policy, std::chrono::milliseconds interval, size_t bytes) {
+    stop_writer();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    flush_interval_ = interval;
+    flush_bytes_ = bytes;
+    policy_ = policy;
+    if (policy_ == FlushPolicy::Buffered) writer_ = std::thread(&PsiOutStream::writer_loop, this);
+}
+
+namespace {
+
+std::mutex event_mutex;
+std::shared_ptr<PsiOutStream> event_stream;
+/// Lets emit_event return without locking while no event file is open
+std::atomic<bool> events_enabled(false);
+
+void append_json_string(std::string& line, const std::string& text) {
+    line += '"';
+    for (char c : text) {
+        switch (c) {
+            case '"':
+                line += "\\\"";
+                break;
+            case '\\':
+                line += "\\\\";
+                break;
+            case '\n':
+                line += "\\n";
+                break;
+            case '\t':
+                line += "\\t";
+                break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char escaped[8];
+                    snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char)c);
+                    line += escaped;
+                } else {
+                    line += c;
+                }
+        }
+    }
+    line += '"';
+}
+
+void append_json_number(std::string& line, double value) {
+    if (!std::isfinite(value)) {
+        line += "null";
+        return;
+    }
+    char number[32];
+    snprintf(number, sizeof(number), "%.17g", value);
+    line += number;
+}
+
+}  // namespace
+
+void open_event_file(const std::string& fname) {
+    auto stream = std::make_shared<PsiOutStream>(fname, std::ostream::trunc);
+    std::lock_guard<std::mutex> lock(event_mutex);
+    event_stream = stream;
+    events_enabled = true;
+}
+
+void close_event_file() {
+    std::shared_ptr<PsiOutStream> stream;
+    {
+        std::lock_guard<std::mutex> lock(event_mutex);
+        events_enabled = false;
+        stream.swap(event_stream);
+    }
+    // Writes out the remaining events as it goes
+    stream.reset();
+}
+
+bool event_file_open() { return events_enabled; }
+
+void emit_event(const std::string& name, const std::map<std::string, double>& values,
+                const std::map<std::string, std::string>& labels) {
+    if (!events_enabled.load(std::memory_order_relaxed)) return;
+
+    double now = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    std::string line = "{\"event\": ";
+    append_json_string(line, name);
+    line += ", \"time\": ";
+    append_json_number(line, now);
+    for (const auto& value : values) {
+        line += ", ";
+        append_json_string(line, value.first);
+        line += ": ";
+        append_json_number(line, value.second);
+    }
+    for (const auto& label : labels) {
+        line += ", ";
+        append_json_string(line, label.first);
+        line += ": ";
+        append_json_string(line, label.second);
+    }
+    line += "}\n";
+
+    std::lock_guard<std::mutex> lock(event_mutex);
+    if (event_stream) event_stream->Printf(line);
 }
-void PsiOutStream::Printf(std::string fp) { (*stream_) << fp << std::flush; }
 
 }  // End Psi Namespace
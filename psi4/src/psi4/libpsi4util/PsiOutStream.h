@@ -30,6 +30,12 @@
 #define _psi_src_lib_libpsi4util_psioutstream_h_
 
 #include "psi4/pragma.h"
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -37,13 +43,54 @@
 
 namespace psi {
 
+/*! How a PsiOutStream hands its text to the underlying stream.
+ *
+ *  Immediate: every Printf is written and flushed before it returns.
+ *  Buffered: text is collected in memory and a background thread writes it
+ *  out once per flush interval, once enough has gathered, or on flush().
+ */
+enum class FlushPolicy { Immediate, Buffered };
+
 class PSI_API PsiOutStream {
    private:
     std::ostream* stream_;
     bool is_cout_;
-    std::vector<char> buffer_;
+
+    /// Guards everything below and the writes to stream_
+    std::mutex mutex_;
+    FlushPolicy policy_;
+    std::chrono::milliseconds flush_interval_;
+    size_t flush_bytes_;
+
+    /// Text waiting for the writer thread (Buffered only)
+    std::string pending_;
+    /// Partial lines of threads other than owner_, or of any thread in a parallel region,
+    /// committed a whole line at a time
+    std::map<std::thread::id, std::string> staged_;
+    std::thread::id owner_;
+
+    std::thread writer_;
+    std::condition_variable wake_;
+    std::condition_variable drained_;
+    bool writing_;
+    bool flush_requested_;
+    bool stop_;
+
+    /// Hands formatted text to the stream according to the policy and calling thread
+    void write(const char* text, size_t length);
+    /// Sends whole text to the stream or pending_; lock must hold mutex_
+    void output(std::unique_lock<std::mutex>& lock, const char* text, size_t length);
+    /// Sends out the staged partial lines too
+    void commit_staged(std::unique_lock<std::mutex>& lock);
+    /// Writes out pending_; lock must hold mutex_, and is released around the write
+    void write_pending(std::unique_lock<std::mutex>& lock);
+    void writer_loop();
+    void stop_writer();
 
    public:
+    /*! Opens fname for writing, or standard output if fname is empty.
+     *  Files are Buffered with a 250 ms interval, standard output Immediate.
+     */
     PsiOutStream(std::string fname = "", std::ios_base::openmode mode = std::ostream::trunc);
     ~PsiOutStream();
 
@@ -51,7 +98,24 @@ class PSI_API PsiOutStream {
     void Printf(std::string fp);
     void MakeBanner(std::string header);
 
-    std::ostream* stream() { return stream_; }
+    /*! Writes out everything printed so far, from every thread, and flushes the stream.
+     *  Buffered text also goes out when the stream is destroyed, but not if the
+     *  process is killed, so run under Immediate when chasing a crash.
+     */
+    void flush();
+
+    /*! Switches policy; interval and bytes bound how long and how much text
+     *  a Buffered stream holds before writing it out
+     */
+    void set_flush_policy(FlushPolicy policy, std::chrono::milliseconds interval = std::chrono::milliseconds(250),
+                          size_t bytes = 1048576);
+    FlushPolicy flush_policy() const { return policy_; }
+
+    /// The underlying stream, after a flush(); text written to it directly bypasses the buffering
+    std::ostream* stream() {
+        flush();
+        return stream_;
+    }
 
     // Incase we want to overload << again
     // template <class T>
@@ -66,5 +130,23 @@ class PSI_API PsiOutStream {
     // }
 };
 
+/*! \name Structured events
+ *  A side channel of JSON lines, one object per event, for iteration data
+ *  and other progress that monitoring tools would otherwise scrape from the
+ *  output file. Each line reads {"event": name, "time": seconds since the
+ *  epoch, <values>..., <labels>...}. Nothing is written, and emit_event()
+ *  costs a single check, until open_event_file() is called.
+ */
+///@{
+/// Starts writing events to fname, truncating it; the file is Buffered like the output file
+PSI_API void open_event_file(const std::string& fname);
+/// Writes out and closes the event file, if open
+PSI_API void close_event_file();
+PSI_API bool event_file_open();
+/// Appends one event with numeric values and string labels; non-finite values are written as null
+PSI_API void emit_event(const std::string& name, const std::map<std::string, double>& values,
+                        const std::map<std::string, std::string>& labels = {});
+///@}
+
 }  // End Psi namespace
 #endif
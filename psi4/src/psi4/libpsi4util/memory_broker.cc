@@ -0,0 +1,208 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libpsi4util/memory_broker.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace psi {
+
+namespace {
+
+double to_mib(size_t bytes) { return bytes / (1024.0 * 1024.0); }
+
+}  // namespace
+
+MemoryBudget::~MemoryBudget() {
+    if (broker_) broker_->release(this);
+}
+
+void MemoryBudget::set_used(size_t bytes) { broker_->record_use(this, bytes); }
+
+void MemoryBudget::shrink_to(size_t bytes) {
+    if (bytes < granted_) broker_->regrant(this, bytes);
+}
+
+MemoryBroker::MemoryBroker(size_t total) : total_(total), strict_(false), granted_(0), peak_granted_(0) {}
+
+MemoryBroker::~MemoryBroker() {
+    // Budgets held past the broker must not call back into it
+    for (auto& entry : budgets_) entry.budget->broker_ = nullptr;
+}
+
+void MemoryBroker::set_total(size_t total) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    total_ = total;
+}
+
+void MemoryBroker::set_strict(bool strict) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    strict_ = strict;
+}
+
+size_t MemoryBroker::total() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return total_;
+}
+
+size_t MemoryBroker::granted() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return granted_;
+}
+size_t MemoryBroker::peak_granted() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return peak_granted_;
+}
+
+size_t MemoryBroker::available() const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    return (granted_ < total_ ? total_ - granted_ : 0);
+}
+
+std::shared_ptr<MemoryBudget> MemoryBroker::request(const std::string& name, size_t min_bytes, size_t max_bytes,
+                                                    MemoryPriority priority, MemoryShrinkCallback shrink) {
+    if (min_bytes > max_bytes) {
+        throw PSIEXCEPTION("MemoryBroker: " + name + " requested a minimum above its maximum.");
+    }
+    // Callbacks run under the (recursive) lock, so they may shrink or report use
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+    if (available() < max_bytes) {
+        std::vector<Entry> victims;
+        for (auto& entry : budgets_) {
+            if (entry.priority < priority && entry.shrink && entry.budget->granted_) victims.push_back(entry);
+        }
+        // Lowest priority first, most recent first within a priority
+        std::reverse(victims.begin(), victims.end());
+        std::stable_sort(victims.begin(), victims.end(),
+                         [](const Entry& a, const Entry& b) { return a.priority < b.priority; });
+
+        for (auto& victim : victims) {
+            size_t free = available();
+            if (free >= max_bytes) break;
+            MemoryBudget* budget = victim.budget;
+            size_t need = max_bytes - free;
+            size_t target = (budget->granted_ > need ? budget->granted_ - need : 0);
+            size_t held = victim.shrink(target);
+            if (held < budget->granted_) {
+                statistics_[budget->name_].shrunk++;
+                regrant(budget, held);
+            }
+        }
+    }
+
+    Statistics& stats = statistics_[name];
+    size_t grant = std::min(max_bytes, available());
+    if (grant < min_bytes) {
+        if (strict_) {
+            std::stringstream error;
+            error << "MemoryBroker: " << name << " needs at least " << to_mib(min_bytes) << " MiB, but only "
+                  << to_mib(available()) << " MiB of " << to_mib(total_) << " MiB is free.";
+            throw PSIEXCEPTION(error.str());
+        }
+        grant = min_bytes;
+        stats.overcommitted++;
+    }
+
+    std::shared_ptr<MemoryBudget> budget(new MemoryBudget(this, name, grant));
+    budgets_.push_back(Entry{budget.get(), priority, shrink});
+    granted_ += grant;
+    peak_granted_ = std::max(peak_granted_, granted_);
+
+    stats.requests++;
+    stats.granted += grant;
+    stats.peak_granted = std::max(stats.peak_granted, stats.granted);
+    return budget;
+}
+
+void MemoryBroker::release(MemoryBudget* budget) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    regrant(budget, 0);
+    record_use(budget, 0);
+    budgets_.remove_if([budget](const Entry& entry) { return entry.budget == budget; });
+}
+
+void MemoryBroker::regrant(MemoryBudget* budget, size_t bytes) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    if (bytes >= budget->granted_) return;
+    Statistics& stats = statistics_[budget->name_];
+    stats.granted -= budget->granted_ - bytes;
+    granted_ -= budget->granted_ - bytes;
+    budget->granted_ = bytes;
+    if (budget->used_ > bytes) record_use(budget, bytes);
+}
+
+void MemoryBroker::record_use(MemoryBudget* budget, size_t bytes) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    bytes = std::min(bytes, budget->granted_);
+    Statistics& stats = statistics_[budget->name_];
+    stats.used = stats.used - budget->used_ + bytes;
+    stats.peak_used = std::max(stats.peak_used, stats.used);
+    budget->used_ = bytes;
+}
+
+void MemoryBroker::print_report(std::shared_ptr<PsiOutStream> printer) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    printer->Printf("  ==> Memory Budgets <==\n\n");
+    printer->Printf("    Total: %11.2f MiB, granted %11.2f MiB, peak granted %11.2f MiB\n\n", to_mib(total_),
+                    to_mib(granted_), to_mib(peak_granted_));
+    printer->Printf("    %-24s %8s %8s %8s %12s %12s %12s %12s\n", "Module", "Requests", "Shrunk", "Over",
+                    "Granted", "Used", "Peak Grant", "Peak Used");
+    printer->Printf("    %-24s %8s %8s %8s %12s %12s %12s %12s\n", "", "", "", "", "[MiB]", "[MiB]", "[MiB]",
+                    "[MiB]");
+    for (const auto& kv : statistics_) {
+        const Statistics& stats = kv.second;
+        printer->Printf("    %-24s %8zu %8zu %8zu %12.2f %12.2f %12.2f %12.2f\n", kv.first.c_str(),
+                        stats.requests, stats.shrunk, stats.overcommitted, to_mib(stats.granted), to_mib(stats.used), to_mib(stats.peak_granted),
+                        to_mib(stats.peak_used));
+    }
+    printer->Printf("\n");
+}
+
+void MemoryBroker::reset_statistics() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    for (auto it = statistics_.begin(); it != statistics_.end();) {
+        if (it->second.granted == 0) {
+            it = statistics_.erase(it);
+        } else {
+            it->second.requests = 0;
+            it->second.shrunk = 0;
+            it->second.overcommitted = 0;
+            it->second.peak_granted = it->second.granted;
+            it->second.peak_used = it->second.used;
+            ++it;
+        }
+    }
+    peak_granted_ = granted_;
+}
+
+}  // namespace psi
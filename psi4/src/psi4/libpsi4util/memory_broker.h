@@ -0,0 +1,165 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsi4util_memory_broker_h_
+#define _psi_src_lib_libpsi4util_memory_broker_h_
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class PsiOutStream;
+class MemoryBroker;
+
+/// Who gives way when the job memory runs out: a request may shrink budgets of lower priority
+enum class MemoryPriority { Low = 0, Normal = 1, High = 2 };
+
+/**
+ * Called with a byte target when a higher-priority request needs memory back.
+ * Free down to (at most) the target and return the bytes still held; returning
+ * more than the target is fine when nothing more can be let go.
+ */
+typedef std::function<size_t(size_t)> MemoryShrinkCallback;
+
+/**
+ * A named share of the job memory, handed out by MemoryBroker::request.
+ * The share goes back to the broker when the budget is destroyed.
+ */
+class PSI_API MemoryBudget {
+    friend class MemoryBroker;
+
+    MemoryBroker* broker_;
+    std::string name_;
+    size_t granted_;
+    size_t used_;
+
+    MemoryBudget(MemoryBroker* broker, const std::string& name, size_t granted)
+        : broker_(broker), name_(name), granted_(granted), used_(0) {}
+
+   public:
+    ~MemoryBudget();
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    const std::string& name() const { return name_; }
+    /// Bytes this budget may use
+    size_t granted() const { return granted_; }
+    /// Bytes this budget reported in use
+    size_t used() const { return used_; }
+
+    /// Report how much of the grant is actually in use (capped at the grant), for the peak report
+    void set_used(size_t bytes);
+    /// Hand back everything above bytes
+    void shrink_to(size_t bytes);
+};
+
+/**
+ * Job-wide memory broker.
+ *
+ * Modules request named budgets between a minimum they cannot run without and
+ * a maximum they can make use of.  When the free memory is short of the
+ * maximum, budgets of lower priority that registered a shrink callback are
+ * asked to give memory back, lowest priority and most recent first.  A request
+ * whose minimum still cannot be met throws on a strict broker, and is granted
+ * its minimum anyway (and counted as overcommitted) otherwise.  Grants,
+ * reported use and their peaks are accumulated per name for print_report.
+ */
+class PSI_API MemoryBroker {
+    friend class MemoryBudget;
+
+    struct Entry {
+        MemoryBudget* budget;
+        MemoryPriority priority;
+        MemoryShrinkCallback shrink;
+    };
+
+    struct Statistics {
+        size_t requests = 0;
+        size_t granted = 0;
+        size_t used = 0;
+        size_t peak_granted = 0;
+        size_t peak_used = 0;
+        size_t shrunk = 0;
+        size_t overcommitted = 0;
+    };
+
+    mutable std::recursive_mutex mutex_;
+    size_t total_;
+    bool strict_;
+    size_t granted_;
+    size_t peak_granted_;
+    std::list<Entry> budgets_;
+    std::map<std::string, Statistics> statistics_;
+
+    void release(MemoryBudget* budget);
+    void regrant(MemoryBudget* budget, size_t bytes);
+    void record_use(MemoryBudget* budget, size_t bytes);
+
+   public:
+    explicit MemoryBroker(size_t total);
+    ~MemoryBroker();
+
+    /// Job memory in bytes; lowering it below what is granted only stops new grants
+    void set_total(size_t total);
+    size_t total() const;
+    /// Throw on requests that do not fit, rather than overcommit (defaults to false)
+    void set_strict(bool strict);
+    /// Bytes currently granted to all budgets
+    size_t granted() const;
+    /// Most bytes granted at once since construction or reset_statistics
+    size_t peak_granted() const;
+    /// Bytes free for new budgets
+    size_t available() const;
+
+    /**
+     * Request a budget of at least min_bytes and up to max_bytes.
+     * @param name      module the memory is accounted to
+     * @param priority  budgets of lower priority may be shrunk to satisfy this request
+     * @param shrink    optional callback through which this budget can later be shrunk
+     */
+    std::shared_ptr<MemoryBudget> request(const std::string& name, size_t min_bytes, size_t max_bytes,
+                                          MemoryPriority priority = MemoryPriority::Normal,
+                                          MemoryShrinkCallback shrink = nullptr);
+
+    /// Print current and peak grants and use per module
+    void print_report(std::shared_ptr<PsiOutStream> printer) const;
+    /// Drop the per-module statistics of modules that hold no memory
+    void reset_statistics();
+};
+
+}  // namespace psi
+
+#endif
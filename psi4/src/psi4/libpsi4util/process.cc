@@ -31,6 +31,7 @@
 #include "psi4/libmints/extern.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 #include "psi4/libpsi4util/process.h"
+#include "psi4/libpsi4util/memory_broker.h"
 
 // MKL Header
 #ifdef USING_LAPACK_MKL
@@ -93,7 +94,15 @@ Process::Environment Process::get_environment() { return environment; }
 
 size_t Process::Environment::get_memory() const { return memory_; }
 
-void Process::Environment::set_memory(size_t m) { memory_ = m; }
+void Process::Environment::set_memory(size_t m) {
+    memory_ = m;
+    memory_broker().set_total(m);
+}
+
+MemoryBroker &Process::Environment::memory_broker() {
+    if (!memory_broker_) memory_broker_ = std::make_shared<MemoryBroker>(memory_);
+    return *memory_broker_;
+}
 
 int Process::Environment::get_n_threads() const { return nthread_; }
 
@@ -46,12 +46,14 @@ class Wavefunction;
 class PointGroup;
 class Matrix;
 class Vector;
+class MemoryBroker;
 
 class PSI_API Process {
    public:
     class PSI_API Environment {
         std::map<std::string, std::string> environment_;
         size_t memory_;
+        std::shared_ptr<MemoryBroker> memory_broker_;
         int nthread_;
         std::string datadir_;
 
@@ -104,6 +106,8 @@ class PSI_API Process {
         /// Memory in bytes
         size_t get_memory() const;
         void set_memory(size_t m);
+        /// Hands out named budgets of the job memory to modules
+        MemoryBroker& memory_broker();
 
         /// PSIDATADIR
         std::string get_datadir() const { return datadir_; }
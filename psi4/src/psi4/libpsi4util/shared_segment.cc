@@ -0,0 +1,265 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "shared_segment.h"
+
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#ifndef _MSC_VER
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace psi {
+
+namespace {
+
+const uint64_t segment_magic = 0x31686d7334697370ULL;  // "psi4shm1"
+enum : uint32_t { SegmentBuilding = 1, SegmentReady = 2 };
+
+/// Start of every segment, followed by the key and, at data_offset, the data
+struct SegmentHeader {
+    uint64_t magic;
+    std::atomic<uint32_t> state;
+    int32_t pid;
+    uint64_t key_bytes;
+    uint64_t data_bytes;
+    uint64_t data_offset;
+};
+
+std::mutex session_lock;
+std::string session_name;
+bool session_set = false;
+
+/// Segment names start "psi4.<session>.", with the session reduced to characters safe in a name
+std::string segment_prefix(const std::string& session) {
+    std::string prefix = "psi4.";
+    for (char c : session.substr(0, 64)) prefix += (std::isalnum((unsigned char)c) || c == '-' || c == '_') ? c : '_';
+    return prefix + ".";
+}
+
+std::string segment_name(const std::string& key) {
+    // FNV-1a; the full key in the segment settles collisions
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : key) {
+        hash ^= (unsigned char)c;
+        hash *= 1099511628211ULL;
+    }
+    std::stringstream name;
+    name << "/" << segment_prefix(SharedSegment::session()) << std::hex << hash;
+    return name.str();
+}
+
+#ifndef _MSC_VER
+bool process_alive(int pid) { return ::kill(pid, 0) == 0 || errno == EPERM; }
+
+size_t page_round(size_t bytes) {
+    size_t page = ::sysconf(_SC_PAGESIZE);
+    return (bytes + page - 1) / page * page;
+}
+#endif
+
+}  // namespace
+
+SharedSegment::SharedSegment(const std::string& name, void* map, size_t map_bytes, size_t offset, size_t size,
+                             bool created)
+    : name_(name),
+      map_(map),
+      map_bytes_(map_bytes),
+      data_(static_cast<char*>(map) + offset),
+      size_(size),
+      created_(created) {}
+
+SharedSegment::~SharedSegment() {
+#ifndef _MSC_VER
+    ::munmap(map_, map_bytes_);
+#endif
+}
+
+void SharedSegment::set_session(const std::string& session) {
+    std::lock_guard<std::mutex> lock(session_lock);
+    session_name = session;
+    session_set = true;
+}
+
+std::string SharedSegment::session() {
+    std::lock_guard<std::mutex> lock(session_lock);
+    if (!session_set) {
+        const char* env = std::getenv("PSI_SHM_SESSION");
+        if (env) session_name = env;
+        session_set = true;
+    }
+    return session_name;
+}
+
+std::shared_ptr<SharedSegment> SharedSegment::attach(const std::string& key) {
+#ifdef _MSC_VER
+    return nullptr;
+#else
+    if (!enabled()) return nullptr;
+    std::string name = segment_name(key);
+    int fd = ::shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) return nullptr;
+
+    // The builder sizes the segment right after creating it
+    struct stat st;
+    auto start = std::chrono::steady_clock::now();
+    while (::fstat(fd, &st) == 0 && (size_t)st.st_size < sizeof(SegmentHeader)) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if ((size_t)st.st_size < sizeof(SegmentHeader)) {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t map_bytes = st.st_size;
+    void* map = ::mmap(nullptr, map_bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return nullptr;
+    const SegmentHeader* header = static_cast<const SegmentHeader*>(map);
+
+    // Wait for the builder as long as it lives
+    bool ready = false;
+    start = std::chrono::steady_clock::now();
+    while (true) {
+        uint32_t state = header->state.load(std::memory_order_acquire);
+        if (state == SegmentReady) {
+            ready = true;
+            break;
+        }
+        if (state == SegmentBuilding) {
+            if (!process_alive(header->pid)) break;
+        } else if (std::chrono::steady_clock::now() - start > std::chrono::seconds(10)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    bool valid = ready && header->magic == segment_magic && header->key_bytes == key.size() &&
+                 header->data_offset + header->data_bytes <= map_bytes &&
+                 !std::memcmp(static_cast<const char*>(map) + sizeof(SegmentHeader), key.data(), key.size());
+    if (!valid) {
+        // A builder that died leaves its segment half done; let the next caller start over
+        if (!ready && header->magic == segment_magic && !process_alive(header->pid)) ::shm_unlink(name.c_str());
+        ::munmap(map, map_bytes);
+        return nullptr;
+    }
+    return std::shared_ptr<SharedSegment>(
+        new SharedSegment(name, map, map_bytes, header->data_offset, header->data_bytes, false));
+#endif
+}
+
+std::shared_ptr<SharedSegment> SharedSegment::acquire(const std::string& key, size_t size,
+                                                      const std::function<void(void*)>& build) {
+#ifdef _MSC_VER
+    return nullptr;
+#else
+    if (!enabled()) return nullptr;
+    std::string name = segment_name(key);
+    size_t offset = page_round(sizeof(SegmentHeader) + key.size());
+    size_t map_bytes = offset + size;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            if (errno != EEXIST) return nullptr;
+            auto segment = attach(key);
+            if (segment) return segment->size() == size ? segment : nullptr;
+            // attach removed a dead builder's segment, or the key collided; try once to build it
+            continue;
+        }
+
+        if (::ftruncate(fd, map_bytes) != 0) {
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            return nullptr;
+        }
+        void* map = ::mmap(nullptr, map_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            ::shm_unlink(name.c_str());
+            return nullptr;
+        }
+
+        SegmentHeader* header = new (map) SegmentHeader;
+        header->magic = segment_magic;
+        header->pid = ::getpid();
+        header->key_bytes = key.size();
+        header->data_bytes = size;
+        header->data_offset = offset;
+        header->state.store(SegmentBuilding, std::memory_order_release);
+        std::memcpy(static_cast<char*>(map) + sizeof(SegmentHeader), key.data(), key.size());
+
+        try {
+            build(static_cast<char*>(map) + offset);
+        } catch (...) {
+            ::munmap(map, map_bytes);
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+        header->state.store(SegmentReady, std::memory_order_release);
+
+        // Siblings only ever read it; neither should this process from now on
+        if (size) ::mprotect(static_cast<char*>(map) + offset, size, PROT_READ);
+        return std::shared_ptr<SharedSegment>(new SharedSegment(name, map, map_bytes, offset, size, true));
+    }
+    return nullptr;
+#endif
+}
+
+size_t SharedSegment::unlink_session(const std::string& session) {
+    size_t count = 0;
+#ifndef _MSC_VER
+    if (session.empty()) return 0;
+    std::string prefix = segment_prefix(session);
+    DIR* dir = ::opendir("/dev/shm");
+    if (!dir) return 0;
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.compare(0, prefix.size(), prefix) == 0 && ::shm_unlink(("/" + name).c_str()) == 0) count++;
+    }
+    ::closedir(dir);
+#endif
+    return count;
+}
+
+}  // namespace psi
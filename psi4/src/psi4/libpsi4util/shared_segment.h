@@ -0,0 +1,106 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsi4util_shared_segment_h_
+#define _psi_src_lib_libpsi4util_shared_segment_h_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+/**
+ * A named POSIX shared-memory segment of read-only data that sibling psi4
+ * processes on one node would otherwise each build: n-body fragments or
+ * finite-difference displacements run as separate processes often need the
+ * same fitting metrics, DF integrals and DFT collocation.
+ *
+ * Processes share segments only within a session, named by the
+ * PSI_SHM_SESSION environment variable or set_session(); without one,
+ * acquire() always returns null and every caller builds its own data. A
+ * segment is found by a caller-supplied key that must describe its contents
+ * completely (basis sets, geometry, parameters); the key is stored in the
+ * segment and compared on every attach, so a hash collision is a miss, not
+ * wrong data.
+ *
+ * The first process to ask for a key builds the segment, its siblings wait
+ * for it (as long as the builder is alive) and then map it read-only.
+ * Segments outlive the processes that made them, so the launcher should
+ * call unlink_session() when the session is over; mappings already made
+ * stay valid.
+ */
+class PSI_API SharedSegment {
+    std::string name_;
+    void* map_;
+    size_t map_bytes_;
+    const void* data_;
+    size_t size_;
+    bool created_;
+
+    SharedSegment(const std::string& name, void* map, size_t map_bytes, size_t offset, size_t size, bool created);
+
+   public:
+    ~SharedSegment();
+    SharedSegment(const SharedSegment&) = delete;
+    SharedSegment& operator=(const SharedSegment&) = delete;
+
+    /// Share with processes of this session from now on; empty stops sharing
+    static void set_session(const std::string& session);
+    static std::string session();
+    static bool enabled() { return !session().empty(); }
+
+    /**
+     * The segment for key, of size bytes. If no process of the session has
+     * made it, this one does, calling build with the writable data to fill.
+     * Null when sharing is off or fails (no session, no space in /dev/shm, a
+     * builder that died, a key collision); the caller then builds privately.
+     * Exceptions from build propagate, and the half-built segment is removed.
+     */
+    static std::shared_ptr<SharedSegment> acquire(const std::string& key, size_t size,
+                                                  const std::function<void(void*)>& build);
+
+    /// The finished segment for key if a process of the session made (or is making) one, else null
+    static std::shared_ptr<SharedSegment> attach(const std::string& key);
+
+    /// Removes every segment of session, returning how many there were
+    static size_t unlink_session(const std::string& session);
+
+    const void* data() const { return data_; }
+    size_t size() const { return size_; }
+    /// Did this process build the segment?
+    bool created() const { return created_; }
+    const std::string& name() const { return name_; }
+};
+
+}  // namespace psi
+
+#endif
@@ -39,443 +39,214 @@
 #include <cstdio>
 #include <memory>
 #include <algorithm>
+#include <cstring>
 #include <functional>
 
 namespace psi {
 
-AIOHandler::AIOHandler(std::shared_ptr<PSIO> psio) : psio_(psio) {
-    locked_ = new std::mutex();
-    uniqueID_ = 0;
-}
+AIOHandler::AIOHandler(std::shared_ptr<PSIO> psio, size_t max_inflight)
+    : psio_(psio), max_inflight_(std::max<size_t>(1, max_inflight)), running_(0), uniqueID_(0), stop_(false) {}
 AIOHandler::~AIOHandler() {
     synchronize();
-    delete locked_;
+    {
+        std::unique_lock<std::mutex> lock(locked_);
+        stop_ = true;
+    }
+    work_.notify_all();
+    for (std::thread &thread : threads_) thread.join();
 }
 void AIOHandler::synchronize() {
-    // Joining a thread twice is an error. Thus, we check whether
-    // the thread is joinable before joining. Non-joinable threads
-    // have either been joined, detached (no synchronization possible)
-    // or have been moved from, and another thread object controls its execution.
-    //    std::unique_lock<std::mutex> lock(*locked_);
-    //    lock.unlock();
-    if (thread_)
-        if (thread_->joinable()) thread_->join();
+    std::unique_lock<std::mutex> lock(locked_);
+    idle_.wait(lock, [this]() { return pending_.empty() && running_ == 0; });
+    // Surface the first failure among the jobs nobody waited on
+    std::list<std::pair<size_t, std::shared_future<void> > > futures;
+    futures.swap(futures_);
+    lock.unlock();
+    for (auto &job : futures) job.second.get();
 }
-size_t AIOHandler::read(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
-                        psio_address *end) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(1);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    start_.push(start);
-    end_.push(end);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
+size_t AIOHandler::submit(size_t unit, const char *key, bool write, std::function<void()> work, bool shared) {
+    std::unique_lock<std::mutex> lock(locked_);
+
+    Job job;
+    size_t id = ++uniqueID_;
+    job.id = id;
+    job.unit = unit;
+    job.key = (key ? key : "");
+    job.write = write;
+    job.shared = shared;
+    job.work = std::move(work);
+    job.done = std::make_shared<std::promise<void> >();
+    futures_.emplace_back(job.id, job.done->get_future().share());
+    pending_.push_back(std::move(job));
+
+    // Start threads lazily, up to the number of jobs that are outstanding
+    if (threads_.size() < max_inflight_ && threads_.size() < pending_.size() + running_) {
+        threads_.emplace_back(&AIOHandler::serve, this);
+    }
+    lock.unlock();
+    work_.notify_one();
+    return id;
+}
+std::list<AIOHandler::Job>::iterator AIOHandler::next_job() {
+    if (running_ >= max_inflight_) return pending_.end();
+    auto eligible = [this](std::list<Job>::iterator job) {
+        if (busy_.count(job->unit)) return false;
+        if (!job->shared && shared_busy_.count(job->unit)) return false;
+        for (auto earlier = pending_.begin(); earlier != job; ++earlier) {
+            if (earlier->unit != job->unit) continue;
+            if (job->unit == no_unit) return false;
+            // Shared writes wait for everything before them except each other
+            if (job->shared && earlier->shared) continue;
+            if (job->shared && !earlier->write && earlier->key != job->key) continue;
+            if (earlier->write && job->write) return false;
+            if (earlier->key == job->key && (earlier->write || job->write)) return false;
+        }
+        return true;
+    };
+    // Reads first, so that prefetches are not stuck behind writes, then everything else in order
+    for (auto job = pending_.begin(); job != pending_.end(); ++job) {
+        if (!job->write && eligible(job)) return job;
+    }
+    for (auto job = pending_.begin(); job != pending_.end(); ++job) {
+        if (job->write && eligible(job)) return job;
+    }
+    return pending_.end();
+}
+void AIOHandler::serve() {
+    std::unique_lock<std::mutex> lock(locked_);
+    while (true) {
+        std::list<Job>::iterator it;
+        work_.wait(lock, [this, &it]() {
+            it = next_job();
+            return it != pending_.end() || (stop_ && pending_.empty());
+        });
+        if (it == pending_.end()) return;
+
+        Job job = std::move(*it);
+        pending_.erase(it);
+        (job.shared ? shared_busy_ : busy_).insert(job.unit);
+        running_++;
+        lock.unlock();
 
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
+        try {
+            job.work();
+            job.done->set_value();
+        } catch (...) {
+            job.done->set_exception(std::current_exception());
+        }
 
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+        lock.lock();
+        std::multiset<size_t> &busy = (job.shared ? shared_busy_ : busy_);
+        busy.erase(busy.find(job.unit));
+        running_--;
+        // Finishing a job may unblock others on the same unit, and synchronize()
+        work_.notify_all();
+        idle_.notify_all();
+    }
+}
+size_t AIOHandler::read(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
+                        psio_address *end) {
+    return submit(unit, key, false, [=]() { psio_->read(unit, key, buffer, size, start, end); });
 }
 size_t AIOHandler::write(size_t unit, const char *key, char *buffer, size_t size, psio_address start,
                          psio_address *end) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(2);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    start_.push(start);
-    end_.push(end);
-    jobID_.push_back(uniqueID_);
-
-    // printf("Adding a write to the queue\n");
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // fprintf(stderr,"Starting a thread\n");
-    // thread start
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, true, [=]() { psio_->write(unit, key, buffer, size, start, end); });
+}
+size_t AIOHandler::write_inplace(size_t unit, const char *key, char *buffer, size_t size, psio_address start) {
+    // The compressed page store is not safe to drive from several threads
+    bool shared = !psio_->compressed(unit);
+    return submit(unit, key, true,
+                  [=]() {
+                      psio_tocentry *entry = (psio_->open_check(unit) ? psio_->tocscan(unit, key) : nullptr);
+                      if (entry == nullptr)
+                          throw PsiException("Error in AIO: write_inplace to a missing entry", __FILE__, __LINE__);
+                      size_t header = sizeof(psio_tocentry) - 2 * sizeof(psio_tocentry *);
+                      size_t length = (entry->eadd.page * PSIO_PAGELEN + entry->eadd.offset) -
+                                      (entry->sadd.page * PSIO_PAGELEN + entry->sadd.offset) - header;
+                      if (start.page * PSIO_PAGELEN + start.offset + size > length)
+                          throw PsiException("Error in AIO: write_inplace past the end of the entry", __FILE__,
+                                             __LINE__);
+                      psio_address end;
+                      psio_->write(unit, key, buffer, size, start, &end);
+                  },
+                  shared);
 }
 size_t AIOHandler::read_entry(size_t unit, const char *key, char *buffer, size_t size) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(3);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, false, [=]() { psio_->read_entry(unit, key, buffer, size); });
 }
 size_t AIOHandler::write_entry(size_t unit, const char *key, char *buffer, size_t size) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(4);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(buffer);
-    size_.push(size);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, true, [=]() { psio_->write_entry(unit, key, buffer, size); });
 }
 size_t AIOHandler::read_discont(size_t unit, const char *key, double **matrix, size_t row_length, size_t col_length,
                                 size_t col_skip, psio_address start) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(5);
-    unit_.push(unit);
-    key_.push(key);
-    matrix_.push(matrix);
-    row_length_.push(row_length);
-    col_length_.push(col_length);
-    col_skip_.push(col_skip);
-    start_.push(start);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, false, [=]() {
+        psio_address next = start;
+        for (size_t i = 0; i < row_length; i++) {
+            psio_->read(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, next, &next);
+            next = psio_get_address(next, sizeof(double) * col_skip);
+        }
+    });
 }
 size_t AIOHandler::write_discont(size_t unit, const char *key, double **matrix, size_t row_length, size_t col_length,
                                  size_t col_skip, psio_address start) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(6);
-    unit_.push(unit);
-    key_.push(key);
-    matrix_.push(matrix);
-    row_length_.push(row_length);
-    col_length_.push(col_length);
-    col_skip_.push(col_skip);
-    start_.push(start);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, true, [=]() {
+        psio_address next = start;
+        for (size_t i = 0; i < row_length; i++) {
+            psio_->write(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, next, &next);
+            next = psio_get_address(next, sizeof(double) * col_skip);
+        }
+    });
 }
 size_t AIOHandler::zero_disk(size_t unit, const char *key, size_t rows, size_t cols) {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    ++uniqueID_;
-    job_.push(7);
-    unit_.push(unit);
-    key_.push(key);
-    row_length_.push(rows);
-    col_length_.push(cols);
-    jobID_.push_back(uniqueID_);
+    return submit(unit, key, true, [=]() {
+        double *buf = new double[cols];
+        memset(static_cast<void *>(buf), '\0', cols * sizeof(double));
 
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
+        psio_address next_psio = PSIO_ZERO;
+        for (size_t i = 0; i < rows; i++) {
+            psio_->write(unit, key, (char *)(buf), sizeof(double) * cols, next_psio, &next_psio);
+        }
 
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+        delete[] buf;
+    });
 }
 
 size_t AIOHandler::write_iwl(size_t unit, const char *key, size_t nints, int lastbuf, char *labels, char *values,
                              size_t labsize, size_t valsize, size_t *address) {
-    std::unique_lock<std::mutex> lock(*locked_);
-    ++uniqueID_;
-    job_.push(8);
-    unit_.push(unit);
-    key_.push(key);
-    buffer_.push(labels);
-    buffer_.push(values);
-    size_.push(labsize);
-    size_.push(valsize);
-    nints_.push(nints);
-    lastbuf_.push(lastbuf);
-    address_.push(address);
-    jobID_.push_back(uniqueID_);
-
-    if (job_.size() > 1) return uniqueID_;
-
-    // In C++11, destructors of threads that are still joinable call terminate()
-    // Make sure current thread is joined before proceeding with next thread.
-    synchronize();
-
-    // thread start
-    thread_ = std::make_shared<std::thread>(std::bind(&AIOHandler::call_aio, this));
-    return uniqueID_;
+    return submit(unit, key, true, [=]() {
+        // Writes to one entry run in submission order, so the running address stays consistent
+        psio_address start = psio_get_address(PSIO_ZERO, *address);
+        *address += valsize + labsize + 2 * sizeof(int);
+
+        int last = lastbuf;
+        int n = nints;
+        psio_->write(unit, key, (char *)&(last), sizeof(int), start, &start);
+        psio_->write(unit, key, (char *)&(n), sizeof(int), start, &start);
+        psio_->write(unit, key, labels, labsize, start, &start);
+        psio_->write(unit, key, values, valsize, start, &start);
+    });
 }
 
-void AIOHandler::call_aio() {
-    std::unique_lock<std::mutex> lock(*locked_);
-
-    while (job_.size() > 0) {
-        int jobtype = job_.front();
-        lock.unlock();
-
-        if (jobtype == 1) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-            psio_address start = start_.front();
-            psio_address *end = end_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            start_.pop();
-            end_.pop();
-
-            lock.unlock();
-
-            psio_->read(unit, key, buffer, size, start, end);
-        } else if (jobtype == 2) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-            psio_address start = start_.front();
-            psio_address *end = end_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            start_.pop();
-            end_.pop();
-
-            // printf("Actually doing the psio_write from thread\n");
-            // printf("Unit is %d, key is %s, size is %d\n", unit, key, size);
-            lock.unlock();
-
-            // printf("Printing number %d now\n", *((int *) buffer));
-            // std::stringstream ss;
-            // ss << thread_->get_id();
-            // fprintf(stderr,"Printing from thread %s\n", ss.str().c_str());
-            // fprintf(stderr,"Starting address is %lu, %lu\n",start.page, start.offset);
-            psio_->write(unit, key, buffer, size, start, end);
-            // fprintf(stderr,"End address is %lu, %lu\n",end->page, end->offset);
-        } else if (jobtype == 3) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-
-            lock.unlock();
-
-            psio_->read_entry(unit, key, buffer, size);
-        } else if (jobtype == 4) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *buffer = buffer_.front();
-            size_t size = size_.front();
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-
-            lock.unlock();
+size_t AIOHandler::call(std::function<void()> fn) { return submit(no_unit, nullptr, true, std::move(fn)); }
 
-            psio_->write_entry(unit, key, buffer, size);
-        } else if (jobtype == 5) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            double **matrix = matrix_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-            size_t col_skip = col_skip_.front();
-            psio_address start = start_.front();
-
-            unit_.pop();
-            key_.pop();
-            matrix_.pop();
-            row_length_.pop();
-            col_length_.pop();
-            col_skip_.pop();
-            start_.pop();
-
-            lock.unlock();
-
-            for (int i = 0; i < row_length; i++) {
-                psio_->read(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, start, &start);
-                start = psio_get_address(start, sizeof(double) * col_skip);
-            }
-        } else if (jobtype == 6) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            double **matrix = matrix_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-            size_t col_skip = col_skip_.front();
-            psio_address start = start_.front();
-
-            unit_.pop();
-            key_.pop();
-            matrix_.pop();
-            row_length_.pop();
-            col_length_.pop();
-            col_skip_.pop();
-            start_.pop();
-
-            lock.unlock();
-
-            for (int i = 0; i < row_length; i++) {
-                psio_->write(unit, key, (char *)&(matrix[i][0]), sizeof(double) * col_length, start, &start);
-                start = psio_get_address(start, sizeof(double) * col_skip);
-            }
-        } else if (jobtype == 7) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            size_t row_length = row_length_.front();
-            size_t col_length = col_length_.front();
-
-            unit_.pop();
-            key_.pop();
-            row_length_.pop();
-            col_length_.pop();
-
-            lock.unlock();
-
-            double *buf = new double[col_length];
-            memset(static_cast<void *>(buf), '\0', col_length * sizeof(double));
-
-            psio_address next_psio = PSIO_ZERO;
-            for (int i = 0; i < row_length; i++) {
-                psio_->write(unit, key, (char *)(buf), sizeof(double) * col_length, next_psio, &next_psio);
-            }
-
-            delete[] buf;
-        } else if (jobtype == 8) {
-            lock.lock();
-
-            size_t unit = unit_.front();
-            const char *key = key_.front();
-            char *labels = buffer_.front();
-            buffer_.pop();
-            char *values = buffer_.front();
-            size_t lab_size = size_.front();
-            size_.pop();
-            size_t val_size = size_.front();
-            int nints = nints_.front();
-            int lastbuf = lastbuf_.front();
-            size_t *address = address_.front();
-
-            psio_address start = psio_get_address(PSIO_ZERO, *address);
-            *address += val_size + lab_size + 2 * sizeof(int);
-
-            unit_.pop();
-            key_.pop();
-            buffer_.pop();
-            size_.pop();
-            nints_.pop();
-            lastbuf_.pop();
-            address_.pop();
-
-            lock.unlock();
-
-            psio_->write(unit, key, (char *)&(lastbuf), sizeof(int), start, &start);
-            psio_->write(unit, key, (char *)&(nints), sizeof(int), start, &start);
-            psio_->write(unit, key, labels, lab_size, start, &start);
-            psio_->write(unit, key, values, val_size, start, &start);
-
-        } else {
-            throw PsiException("Error in AIO: Unknown job type", __FILE__, __LINE__);
-        }
-
-        lock.lock();
-        // Only pop the job once the work is actually done and we are gonna leave the loop.
-        // This way, job_.size() == 0 indicates there is no active thread.
-        job_.pop();
-        // We also pop the jobID so that external threads may check that the job completed
-        jobID_.pop_front();
-        // Once it is popped, notify waiting threads to check again for their jobid.
-        condition_.notify_all();
+std::shared_future<void> AIOHandler::future(size_t jobid) {
+    std::unique_lock<std::mutex> lock(locked_);
+    for (auto &job : futures_) {
+        if (job.first == jobid) return job.second;
     }
-    // printf("End of function call_aio\n");
+    throw PsiException("Error in AIO: Unknown or already completed job", __FILE__, __LINE__);
 }
 
 void AIOHandler::wait_for_job(size_t jobid) {
-    std::deque<size_t>::iterator it;
-
-    std::unique_lock<std::mutex> lock(*locked_);
-    it = std::find(jobID_.begin(), jobID_.end(), jobid);
-    bool found = it != jobID_.end();
-    while (found) {
-        condition_.wait(lock);
-        it = std::find(jobID_.begin(), jobID_.end(), jobid);
-        found = it != jobID_.end();
-    }
-    return;
+    std::unique_lock<std::mutex> lock(locked_);
+    auto it = std::find_if(futures_.begin(), futures_.end(),
+                           [jobid](const std::pair<size_t, std::shared_future<void> > &job) { return job.first == jobid; });
+    // Jobs already waited on, or swept up by synchronize(), are complete
+    if (it == futures_.end()) return;
+    std::shared_future<void> done = it->second;
+    futures_.erase(it);
+    lock.unlock();
+    done.get();
 }
 
 }  // Namespace psi
@@ -29,58 +29,96 @@
 #ifndef AIOHANDLER_H
 #define AIOHANDLER_H
 
-#include <thread>
-#include <mutex>
 #include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "psi4/libpsio/config.h"
 
 namespace psi {
 
+class PSIO;
+
+/*! \ingroup PSIO
+ *  \class AIOHandler
+ *  \brief Queue of asynchronous PSIO requests served by a small pool of I/O threads.
+ *
+ * Requests are started oldest first, with reads taking precedence over writes so that
+ * prefetches do not sit behind large writes. Two requests never run at the same time on the
+ * same PSIO unit, since the unit's TOC is not thread-safe. On one unit, writes keep their
+ * submission order, and a read never overtakes a write to the same entry. Generic call()
+ * jobs run in submission order with respect to each other.
+ *
+ * The exception are write_inplace() requests, which only overwrite space an entry already
+ * covers and so leave the TOC alone: any number of them may run together on one unit, in any
+ * order, once the requests submitted before them have finished.
+ */
 class AIOHandler {
    private:
-    /// What is the job type?
-    std::queue<size_t> job_;
-    /// Unique job ID to check for job completion. Should NEVER be 0.
-    std::deque<size_t> jobID_;
-    /// Unit number argument
-    std::queue<size_t> unit_;
-    /// Entry Key (80-char) argument
-    std::queue<const char *> key_;
-    /// Memory buffer argument
-    std::queue<char *> buffer_;
-    /// Size argument
-    std::queue<size_t> size_;
-    /// Start address argument
-    std::queue<psio_address> start_;
-    /// End address pointer argument
-    std::queue<psio_address *> end_;
-    /// Matrix pointer for discontinuous I/O
-    std::queue<double **> matrix_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> row_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> col_length_;
-    /// Size argument for discontinuous I/O
-    std::queue<size_t> col_skip_;
-    /// For IWL: number of ints in the buffer
-    std::queue<int> nints_;
-    /// For IWL: is this the last buffer ?
-    std::queue<int> lastbuf_;
-    /// For IWL: pointer to current position in file
-    std::queue<size_t *> address_;
+    struct Job {
+        /// Unique job ID to check for job completion. Should NEVER be 0.
+        size_t id;
+        /// PSIO unit, or no_unit for generic jobs
+        size_t unit;
+        /// Entry key, used only to order requests on one unit
+        std::string key;
+        /// Does the job modify the unit?
+        bool write;
+        /// May the job run alongside other shared jobs on its unit?
+        bool shared;
+        /// The work itself
+        std::function<void()> work;
+        /// Fulfilled, or holding the exception, once work has run
+        std::shared_ptr<std::promise<void> > done;
+    };
+
+    static constexpr size_t no_unit = static_cast<size_t>(-1);
+
     /// PSIO object this AIO_Handler is built on
     std::shared_ptr<PSIO> psio_;
-    /// Thread this AIO_Handler is currently running on
-    std::shared_ptr<std::thread> thread_;
+    /// I/O threads, started on the first request
+    std::vector<std::thread> threads_;
+    /// Maximum number of requests in flight
+    size_t max_inflight_;
+    /// Jobs not yet started, in submission order
+    std::list<Job> pending_;
+    /// Futures of jobs submitted and not yet waited on, by ID
+    std::list<std::pair<size_t, std::shared_future<void> > > futures_;
+    /// Units with a request in flight (no_unit for a generic job)
+    std::multiset<size_t> busy_;
+    /// Units with shared requests in flight
+    std::multiset<size_t> shared_busy_;
+    /// Number of requests in flight
+    size_t running_;
     /// Lock variable
-    std::mutex *locked_;
+    std::mutex locked_;
+    /// Signals I/O threads that work is available or that they should stop
+    std::condition_variable work_;
+    /// Signals synchronize() that a job finished
+    std::condition_variable idle_;
     /// Latest unique job ID
     size_t uniqueID_;
-    /// condition variable to wait for a specific job to finish
-    std::condition_variable condition_;
+    /// Set by the destructor
+    bool stop_;
+
+    /// Queue a job and return its ID
+    size_t submit(size_t unit, const char* key, bool write, std::function<void()> work, bool shared = false);
+    /// Next job that may start now, or pending_.end(); caller holds the lock
+    std::list<Job>::iterator next_job();
+    /// Loop run by each I/O thread
+    void serve();
 
    public:
-    /// AIO_Handlers are constructed around a synchronous PSIO object
-    AIOHandler(std::shared_ptr<PSIO> psio);
+    /// AIO_Handlers are constructed around a synchronous PSIO object, with up to max_inflight
+    /// requests (on distinct units) in flight at once
+    AIOHandler(std::shared_ptr<PSIO> psio, size_t max_inflight = 2);
     /// Destructor
     ~AIOHandler();
     /// When called, synchronize will not return until all requested data has been read or written
@@ -89,6 +127,10 @@ class AIOHandler {
     size_t read(size_t unit, const char *key, char *buffer, size_t size, psio_address start, psio_address *end);
     /// Asynchronous write, same as PSIO::write, but nonblocking
     size_t write(size_t unit, const char *key, char *buffer, size_t size, psio_address start, psio_address *end);
+    /// Asynchronous write into space the entry already covers, e.g. after zero_disk. Several of
+    /// these may be in flight on one unit, so the caller must not let them overlap on disk.
+    /// Falls back to an ordinary write on compressed units.
+    size_t write_inplace(size_t unit, const char *key, char *buffer, size_t size, psio_address start);
     /// Asynchronous read_entry, same as PSIO::read_entry, but nonblocking
     size_t read_entry(size_t unit, const char *key, char *buffer, size_t size);
     /// Asynchronous read_entry, same as PSIO::write_entry, but nonblocking
@@ -128,11 +170,19 @@ class AIOHandler {
     /// counting the number of integrals in the current buffer
     size_t write_iwl(size_t unit, const char *key, size_t nints, int lastbuf, char *labels, char *values,
                      size_t labsize, size_t valsize, size_t *address);
-    /// Generic function bound to thread internally
-    void call_aio();
+
+    /// Generic job
+    /// Runs an arbitrary callable on an AIO thread, ordered with the other
+    /// generic jobs. Used for I/O that does not go through PSIO, e.g. the
+    /// FILE* streams of DFHelper.
+    size_t call(std::function<void()> fn);
+
+    /// Future for a job, ready once it has completed; get() rethrows anything the job threw.
+    /// Only valid until the job has been waited on.
+    std::shared_future<void> future(size_t jobid);
 
     /// Function that checks if a job has been completed using the JobID.
-    /// The function only returns when the job is completed.
+    /// The function only returns when the job is completed, and rethrows anything it threw.
     void wait_for_job(size_t jobid);
 };
 
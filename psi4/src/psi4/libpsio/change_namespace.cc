@@ -69,6 +69,7 @@ void PSIO::change_file_namespace(size_t unit, const std::string& ns1, const std:
     // printf("%s\n",old_fullpath);
     // printf("%s\n",new_fullpath);
 
+    _default_psio_lib_->spill(unit);
     PSIOManager::shared_object()->move_file(std::string(old_fullpath), std::string(new_fullpath));
     ::rename(old_fullpath, new_fullpath);
 
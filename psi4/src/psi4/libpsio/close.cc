@@ -44,31 +44,106 @@
 #endif
 #include <cstring>
 #include <cstdlib>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/compress.h"
+#include "psi4/libpsio/memstore.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
+std::array<long long, 3> PSIO::volume_stamp(int stream) {
+#ifdef _MSC_VER
+    struct _stat64 st;
+    if (_fstat64(stream, &st) == -1) return {{-1, -1, -1}};
+    return {{(long long)st.st_size, (long long)st.st_mtime, (long long)st.st_ino}};
+#else
+    struct stat st;
+    if (fstat(stream, &st) == -1) return {{-1, -1, -1}};
+#ifdef __linux__
+    long long mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+    long long mtime = (long long)st.st_mtime;
+#endif
+    return {{(long long)st.st_size, mtime, (long long)st.st_ino}};
+#endif
+}
+
+void PSIO::toc_free(psio_tocentry *toc) {
+    while (toc != nullptr) {
+        psio_tocentry *next_entry = toc->next;
+        free(toc);
+        toc = next_entry;
+    }
+}
+
+void PSIO::toc_cache_drop(size_t unit) {
+    auto cached = toc_cache_.find(unit);
+    if (cached == toc_cache_.end()) return;
+    toc_free(cached->second.toc);
+    toc_cache_.erase(cached);
+}
+
 void PSIO::close(size_t unit, int keep) {
     size_t i;
     psio_ud *this_unit;
-    psio_tocentry *this_entry, *next_entry;
 
     this_unit = &(psio_unit[unit]);
 
     /* First check to see if this unit is already closed */
     if (this_unit->vol[0].stream == -1) psio_error(unit, PSIO_ERROR_RECLOSE);
 
-    /* Dump the current TOC back out to disk */
-    tocwrite(unit);
+    /* Drop any map_entry() views before the files go away */
+    unmap_entries(unit);
+
+    /* Dump the current TOC back out to disk, if it changed */
+    if (toc_dirty_[unit]) tocwrite(unit);
+
+    /* Flush a compressed unit's pages and index, unless the file is about to go */
+    auto compressed = compressed_.find(unit);
+    if (compressed != compressed_.end()) {
+        if (keep) compressed->second->finish();
+        PSIOManager::shared_object()->record_compression(std::string(this_unit->vol[0].path),
+                                                         compressed->second->logical_size(),
+                                                         compressed->second->physical_size(),
+                                                         compressed->second->bytes_moved(), compressed->second->seconds());
+        compressed_.erase(compressed);
+    }
+
+    /* Park a kept in-memory unit for the next open, or write it out if it must outlive the run */
+    {
+        std::lock_guard<std::mutex> lock(memory_lock_);
+        auto store = memory_.find(unit);
+        if (store != memory_.end()) {
+            if (!keep) {
+                memory_.erase(store);
+            } else if (PSIOManager::shared_object()->get_specific_retention(unit)) {
+                memory_spill(store);
+            } else {
+                for (i = 0; i < this_unit->numvols; i++) {
+                    store->second.paths.push_back(this_unit->vol[i].path);
+                    store->second.stamps.push_back(volume_stamp(this_unit->vol[i].stream));
+                }
+            }
+        }
+    }
 
-    /* Free the TOC */
-    this_entry = this_unit->toc;
-    for (i = 0; i < this_unit->toclen; i++) {
-        next_entry = this_entry->next;
-        free(this_entry);
-        this_entry = next_entry;
+    /* Keep the TOC of a kept unit for the next open, else free it */
+    toc_cache_drop(unit);
+    if (keep) {
+        TOCCache& cached = toc_cache_[unit];
+        for (i = 0; i < this_unit->numvols; i++) {
+            cached.paths.push_back(this_unit->vol[i].path);
+            cached.stamps.push_back(volume_stamp(this_unit->vol[i].stream));
+        }
+        cached.toc = this_unit->toc;
+        cached.toclen = this_unit->toclen;
+    } else {
+        toc_free(this_unit->toc);
     }
+    toc_index_[unit].clear();
+    toc_last_[unit] = nullptr;
 
     /* Close each volume (remove if necessary) and free the path */
     for (i = 0; i < this_unit->numvols; i++) {
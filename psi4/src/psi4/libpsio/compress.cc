@@ -0,0 +1,303 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#ifdef _MSC_VER
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "psi4/libpsio/compress.h"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+namespace {
+
+const char psio_zip_magic[8] = {'P', 'S', 'I', 'O', 'Z', 'I', 'P', '1'};
+const size_t psio_zip_trailer = 8 + 2 * sizeof(uint64_t);
+/// Pages kept decompressed, so small TOC and header writes do not recompress a page each time
+const size_t psio_zip_cache = 8;
+/// 4-bit word code for an exactly zero word, next to the 0-8 significant-byte XOR codes
+const int psio_zip_zero_word = 15;
+
+#ifdef _MSC_VER
+bool psio_pread(int fd, void* buf, size_t n, uint64_t off) {
+    if (::_lseeki64(fd, off, SEEK_SET) == -1) return false;
+    return ::_read(fd, buf, (unsigned)n) == (int)n;
+}
+bool psio_pwrite(int fd, const void* buf, size_t n, uint64_t off) {
+    if (::_lseeki64(fd, off, SEEK_SET) == -1) return false;
+    return ::_write(fd, buf, (unsigned)n) == (int)n;
+}
+uint64_t psio_file_size(int fd) { return ::_filelengthi64(fd); }
+#else
+bool psio_pread(int fd, void* buf, size_t n, uint64_t off) {
+    char* p = static_cast<char*>(buf);
+    while (n) {
+        ssize_t done = ::pread(fd, p, n, off);
+        if (done <= 0) return false;
+        p += done;
+        n -= done;
+        off += done;
+    }
+    return true;
+}
+bool psio_pwrite(int fd, const void* buf, size_t n, uint64_t off) {
+    const char* p = static_cast<const char*>(buf);
+    while (n) {
+        ssize_t done = ::pwrite(fd, p, n, off);
+        if (done <= 0) return false;
+        p += done;
+        n -= done;
+        off += done;
+    }
+    return true;
+}
+uint64_t psio_file_size(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) == -1) return 0;
+    return st.st_size;
+}
+#endif
+
+}  // namespace
+
+PSIOCompressedUnit::Codec PSIOCompressedUnit::encode(const char* page, std::vector<char>& out) {
+    const size_t nword = PSIO_PAGELEN / sizeof(uint64_t);
+    out.resize(nword / 2 + PSIO_PAGELEN);
+
+    const uint64_t* words = reinterpret_cast<const uint64_t*>(page);
+    unsigned char* codes = reinterpret_cast<unsigned char*>(out.data());
+    unsigned char* bytes = codes + nword / 2;
+    memset(codes, 0, nword / 2);
+
+    bool zero = true;
+    uint64_t prev = 0;
+    for (size_t w = 0; w < nword; w++) {
+        uint64_t value = words[w];
+        uint64_t x = value ^ prev;
+        prev = value;
+        int code;
+        if (value == 0 && x != 0) {
+            code = psio_zip_zero_word;
+        } else {
+            code = 0;
+            for (uint64_t t = x; t; t >>= 8) code++;
+            for (int b = 0; b < code; b++) *bytes++ = (unsigned char)(x >> (8 * b));
+        }
+        zero = zero && (value == 0);
+        codes[w / 2] |= (unsigned char)(code << (4 * (w % 2)));
+    }
+
+    if (zero) {
+        out.clear();
+        return Zero;
+    }
+    size_t length = bytes - reinterpret_cast<unsigned char*>(out.data());
+    if (length >= (size_t)PSIO_PAGELEN) {
+        out.assign(page, page + PSIO_PAGELEN);
+        return Raw;
+    }
+    out.resize(length);
+    return XOR;
+}
+
+void PSIOCompressedUnit::decode(Codec codec, const char* in, size_t length, char* page) {
+    if (codec == Zero) {
+        memset(page, 0, PSIO_PAGELEN);
+        return;
+    }
+    if (codec == Raw) {
+        memcpy(page, in, PSIO_PAGELEN);
+        return;
+    }
+
+    const size_t nword = PSIO_PAGELEN / sizeof(uint64_t);
+    const unsigned char* codes = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* bytes = codes + nword / 2;
+    const unsigned char* last = reinterpret_cast<const unsigned char*>(in) + length;
+    uint64_t* words = reinterpret_cast<uint64_t*>(page);
+
+    uint64_t prev = 0;
+    for (size_t w = 0; w < nword; w++) {
+        int code = (codes[w / 2] >> (4 * (w % 2))) & 0xF;
+        if (code == psio_zip_zero_word) {
+            prev = 0;
+        } else {
+            if (code > 8 || bytes + code > last) throw PSIEXCEPTION("PSIO: corrupt compressed page");
+            uint64_t x = 0;
+            for (int b = 0; b < code; b++) x |= (uint64_t)(*bytes++) << (8 * b);
+            prev ^= x;
+        }
+        words[w] = prev;
+    }
+}
+
+bool PSIOCompressedUnit::is_compressed(int stream) {
+    uint64_t size = psio_file_size(stream);
+    if (size < psio_zip_trailer) return false;
+    char magic[8];
+    if (!psio_pread(stream, magic, 8, size - psio_zip_trailer)) return false;
+    return memcmp(magic, psio_zip_magic, 8) == 0;
+}
+
+PSIOCompressedUnit::PSIOCompressedUnit(int stream, bool old) : stream_(stream), end_(0) {
+    uint64_t size = psio_file_size(stream);
+    if (!old || size == 0) return;
+    if (!is_compressed(stream)) throw PSIEXCEPTION("PSIO: existing unit was not written compressed");
+
+    uint64_t trailer[2];
+    if (!psio_pread(stream, trailer, sizeof(trailer), size - 2 * sizeof(uint64_t)))
+        throw PSIEXCEPTION("PSIO: unable to read compressed unit trailer");
+    index_.resize(trailer[0]);
+    end_ = trailer[1];
+    for (size_t p = 0; p < index_.size(); p++) {
+        char entry[16];
+        if (!psio_pread(stream, entry, sizeof(entry), end_ + 16 * p))
+            throw PSIEXCEPTION("PSIO: unable to read compressed unit index");
+        memcpy(&index_[p].offset, entry, 8);
+        memcpy(&index_[p].length, entry + 8, 4);
+        memcpy(&index_[p].codec, entry + 12, 4);
+    }
+}
+
+PSIOCompressedUnit::CachedPage& PSIOCompressedUnit::fetch(size_t page) {
+    for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+        if (it->page == page) {
+            cache_.splice(cache_.begin(), cache_, it);
+            return cache_.front();
+        }
+    }
+
+    if (cache_.size() >= psio_zip_cache) {
+        if (cache_.back().dirty) store(cache_.back());
+        cache_.pop_back();
+    }
+    cache_.push_front(CachedPage{page, false, std::vector<char>(PSIO_PAGELEN)});
+    CachedPage& cached = cache_.front();
+
+    if (page < index_.size() && index_[page].codec != Zero) {
+        const Page& stored = index_[page];
+        std::vector<char> blob(stored.length);
+        if (!psio_pread(stream_, blob.data(), stored.length, stored.offset))
+            throw PSIEXCEPTION("PSIO: unable to read compressed page");
+        decode((Codec)stored.codec, blob.data(), stored.length, cached.data.data());
+    }
+    return cached;
+}
+
+void PSIOCompressedUnit::store(CachedPage& cached) {
+    std::vector<char> blob;
+    Codec codec = encode(cached.data.data(), blob);
+    if (cached.page >= index_.size()) index_.resize(cached.page + 1);
+    Page& stored = index_[cached.page];
+
+    // Reuse the old slot when the page still fits, otherwise append
+    if (blob.size() > stored.length || stored.codec == Zero) {
+        stored.offset = end_;
+        end_ += blob.size();
+    }
+    stored.length = blob.size();
+    stored.codec = codec;
+    if (blob.size()) {
+        if (!psio_pwrite(stream_, blob.data(), blob.size(), stored.offset))
+            throw PSIEXCEPTION("PSIO: unable to write compressed page");
+        physical_written_ += blob.size();
+    }
+    cached.dirty = false;
+}
+
+void PSIOCompressedUnit::rw(char* buffer, psio_address address, size_t size, int wrt) {
+    auto t0 = std::chrono::steady_clock::now();
+
+    size_t page = address.page;
+    size_t offset = address.offset;
+    size_t done = 0;
+    while (done < size) {
+        size_t chunk = std::min((size_t)PSIO_PAGELEN - offset, size - done);
+        if (wrt) {
+            CachedPage& cached = fetch(page);
+            memcpy(cached.data.data() + offset, buffer + done, chunk);
+            cached.dirty = true;
+        } else if (page >= index_.size() && std::none_of(cache_.begin(), cache_.end(), [page](const CachedPage& c) {
+                       return c.page == page;
+                   })) {
+            // Never written: reads as zeros without disturbing the cache
+            memset(buffer + done, 0, chunk);
+        } else {
+            CachedPage& cached = fetch(page);
+            memcpy(buffer + done, cached.data.data() + offset, chunk);
+        }
+        done += chunk;
+        offset = 0;
+        page++;
+    }
+
+    logical_bytes_ += size;
+    seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void PSIOCompressedUnit::finish() {
+    auto t0 = std::chrono::steady_clock::now();
+    for (CachedPage& cached : cache_) {
+        if (cached.dirty) store(cached);
+    }
+    cache_.clear();
+
+    std::vector<char> index(16 * index_.size() + psio_zip_trailer);
+    for (size_t p = 0; p < index_.size(); p++) {
+        memcpy(&index[16 * p], &index_[p].offset, 8);
+        memcpy(&index[16 * p + 8], &index_[p].length, 4);
+        memcpy(&index[16 * p + 12], &index_[p].codec, 4);
+    }
+    char* trailer = &index[16 * index_.size()];
+    uint64_t npage = index_.size();
+    memcpy(trailer, psio_zip_magic, 8);
+    memcpy(trailer + 8, &npage, 8);
+    memcpy(trailer + 16, &end_, 8);
+    if (!psio_pwrite(stream_, index.data(), index.size(), end_))
+        throw PSIEXCEPTION("PSIO: unable to write compressed unit index");
+#ifndef _MSC_VER
+    if (::ftruncate(stream_, end_ + index.size()) == -1) throw PSIEXCEPTION("PSIO: unable to truncate compressed unit");
+#else
+    ::_chsize_s(stream_, end_ + index.size());
+#endif
+    seconds_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}  // namespace psi
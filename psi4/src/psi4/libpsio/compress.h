@@ -0,0 +1,112 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_compress_h_
+#define _psi_src_lib_libpsio_compress_h_
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "psi4/libpsio/config.h"
+
+namespace psi {
+
+/*! \ingroup PSIO
+ *  \class PSIOCompressedUnit
+ *  \brief Page-granular compressed backing store for one single-volume PSIO unit.
+ *
+ * The logical address space of the unit is cut into PSIO_PAGELEN pages. Each page is compressed
+ * on its own and appended to the file, or rewritten in place if it still fits its old slot, so
+ * random access costs at most one page decompression. The page index lives in memory and is
+ * written behind the data, with a trailer, when the unit is closed:
+ *
+ *   [page blobs][npage x (uint64 offset, uint32 length, uint32 codec)][char[8] magic, uint64 npage, uint64 index]
+ *
+ * Pages are encoded with a lossless floating-point-aware codec: every 8-byte word is XORed with
+ * its predecessor and only the significant low bytes are kept (FPC-style), with a 4-bit code per
+ * word. Smooth double data, zeros and small integers shrink; incompressible pages are stored raw
+ * and never-written pages take no space at all.
+ */
+class PSIOCompressedUnit {
+   public:
+    enum Codec { Zero = 0, Raw = 1, XOR = 2 };
+
+   private:
+    struct Page {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint32_t codec = Zero;
+    };
+    struct CachedPage {
+        size_t page;
+        bool dirty;
+        std::vector<char> data;
+    };
+
+    int stream_;
+    std::vector<Page> index_;
+    /// Physical end of the page blobs
+    uint64_t end_;
+    /// Most recently used pages first
+    std::list<CachedPage> cache_;
+
+    size_t logical_bytes_ = 0;
+    size_t physical_written_ = 0;
+    double seconds_ = 0.0;
+
+    CachedPage& fetch(size_t page);
+    void store(CachedPage& page);
+
+   public:
+    /// Wrap an open file descriptor; old files must carry an index trailer unless empty
+    PSIOCompressedUnit(int stream, bool old);
+
+    /// Does the file behind stream end with a compressed-unit trailer?
+    static bool is_compressed(int stream);
+
+    /// Same contract as PSIO::rw on a single volume
+    void rw(char* buffer, psio_address address, size_t size, int wrt);
+    /// Write back cached pages, the index and the trailer
+    void finish();
+
+    /// Logical bytes held (index extent), physical bytes on disk, bytes moved and time spent in rw
+    size_t logical_size() const { return index_.size() * (size_t)PSIO_PAGELEN; }
+    size_t physical_size() const { return end_; }
+    size_t bytes_moved() const { return logical_bytes_; }
+    double seconds() const { return seconds_; }
+
+    /// Encode one page into out (resized), returning the codec used
+    static Codec encode(const char* page, std::vector<char>& out);
+    /// Decode length bytes of codec data into one page
+    static void decode(Codec codec, const char* in, size_t length, char* page);
+};
+
+}  // namespace psi
+
+#endif
@@ -74,6 +74,8 @@ PSIO::~PSIO() {
     free(psio_writlen);
 #endif
 
+    while (!entry_maps_.empty()) unmap_entries(entry_maps_.begin()->first);
+    while (!toc_cache_.empty()) toc_cache_drop(toc_cache_.begin()->first);
     free(psio_unit);
     state_ = 0;
     files_keywords_.clear();
@@ -45,7 +45,7 @@
 
 namespace psi {
 
-PSIOManager::PSIOManager() {
+PSIOManager::PSIOManager() : memory_limit_(0) {
     pid_ = psio_getpid();
 #ifdef _MSC_VER
     set_default_path("C:\\");
@@ -87,6 +87,40 @@ bool PSIOManager::get_specific_retention(int fileno) {
     return retaining;
 }
 
+void PSIOManager::set_specific_compression(int fileno, bool compress) {
+    if (compress) {
+        specific_compression_.insert(fileno);
+    } else {
+        specific_compression_.erase(fileno);
+    }
+}
+
+bool PSIOManager::get_specific_compression(int fileno) { return specific_compression_.count(fileno) > 0; }
+
+void PSIOManager::record_compression(const std::string& full_path, size_t logical, size_t physical, size_t moved,
+                                     double seconds) {
+    std::array<double, 4>& stats = compression_stats_[full_path];
+    stats[0] = logical;
+    stats[1] = physical;
+    stats[2] += moved;
+    stats[3] += seconds;
+}
+
+void PSIOManager::set_specific_storage(int fileno, const std::string& storage) {
+    if (storage == "DISK") {
+        specific_storage_.erase(fileno);
+    } else if (storage == "MEMORY" || storage == "SPILL") {
+        specific_storage_[fileno] = storage;
+    } else {
+        throw PSIEXCEPTION("PSIOManager: unknown storage '" + storage + "', use DISK, MEMORY or SPILL");
+    }
+}
+
+std::string PSIOManager::get_specific_storage(int fileno) {
+    auto it = specific_storage_.find(fileno);
+    return (it == specific_storage_.end() ? std::string("DISK") : it->second);
+}
+
 void PSIOManager::write_scratch_file(const std::string& full_path, const std::string& text) {
     files_[full_path] = true;
     FILE* fh = fopen(full_path.c_str(), "w");
@@ -156,6 +190,33 @@ void PSIOManager::print(std::string out) {
                         (retained_files_.count((*it).first) == 0 ? "DEREZZ" : "SAVE"));
     }
     printer->Printf("\n");
+
+    if (specific_storage_.size()) {
+        printer->Printf("  In-Memory File Numbers (SPILL limit: ");
+        if (memory_limit_)
+            printer->Printf("%.1f MB):\n\n", memory_limit_ / 1.0E6);
+        else
+            printer->Printf("none):\n\n");
+        printer->Printf("  %-6s %-8s\n", "FileNo", "Storage");
+        printer->Printf("  ---------------\n");
+        for (const auto& storage : specific_storage_) {
+            printer->Printf("  %-6d %-8s\n", storage.first, storage.second.c_str());
+        }
+        printer->Printf("\n");
+    }
+
+    if (compression_stats_.size()) {
+        printer->Printf("  Compressed Files (as of last close):\n\n");
+        printer->Printf("  %-44s%10s%10s%8s%10s\n", "Filename", "Data [MB]", "Disk [MB]", "Ratio", "[MB/s]");
+        printer->Printf("  ----------------------------------------------------------------------------------\n");
+        for (const auto& file : compression_stats_) {
+            const std::array<double, 4>& stats = file.second;
+            printer->Printf("  %-44s%10.1f%10.1f%8.2f%10.1f\n", file.first.c_str(), stats[0] / 1.0E6, stats[1] / 1.0E6,
+                            (stats[1] > 0.0 ? stats[0] / stats[1] : 0.0),
+                            (stats[3] > 0.0 ? stats[2] / stats[3] / 1.0E6 : 0.0));
+        }
+        printer->Printf("\n");
+    }
 }
 void PSIOManager::mirror_to_disk() {
     //      FILE* fh = fopen("psi.clean","w");
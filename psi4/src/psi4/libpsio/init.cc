@@ -63,6 +63,8 @@ PSIO::PSIO() {
     psio_writlen = (size_t *)malloc(sizeof(size_t) * PSIO_MAXUNIT);
 #endif
     state_ = 1;
+    bytes_read_ = 0;
+    bytes_written_ = 0;
 
     if (psio_unit == nullptr) {
         ::fprintf(stderr, "Error in PSIO_INIT()!\n");
@@ -81,6 +83,9 @@ PSIO::PSIO() {
         psio_unit[i].toclen = 0;
         psio_unit[i].toc = nullptr;
     }
+    toc_index_.resize(PSIO_MAXUNIT);
+    toc_last_.assign(PSIO_MAXUNIT, nullptr);
+    toc_dirty_.assign(PSIO_MAXUNIT, false);
 
     /* Open user's general .psirc file, if exists */
     //  char *userhome = getenv("HOME");
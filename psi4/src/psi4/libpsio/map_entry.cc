@@ -0,0 +1,108 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <cstdlib>
+#ifndef _MSC_VER
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+namespace {
+/// Byte offset of a global address within a single-volume unit
+size_t psio_address_bytes(psio_address address) { return address.page * PSIO_PAGELEN + address.offset; }
+}  // namespace
+
+void PSIO::set_entry_alignment(size_t unit, size_t alignment) {
+    if (alignment & (alignment - 1)) throw PSIEXCEPTION("PSIO: entry alignment must be a power of two");
+    entry_alignment_[unit] = alignment;
+}
+
+size_t PSIO::entry_alignment(size_t unit) const {
+    auto it = entry_alignment_.find(unit);
+    return (it == entry_alignment_.end() ? 0 : it->second);
+}
+
+psio_span PSIO::map_entry(size_t unit, const char *key) {
+#ifdef _MSC_VER
+    throw PSIEXCEPTION("PSIO::map_entry: memory-mapped entries are not supported on this platform");
+#else
+    psio_ud *this_unit = &(psio_unit[unit]);
+    if (this_unit->numvols != 1) throw PSIEXCEPTION("PSIO::map_entry: unit is striped over several volumes");
+    if (compressed(unit)) throw PSIEXCEPTION("PSIO::map_entry: unit is stored compressed");
+    /* A mapping needs the data in the file */
+    spill(unit);
+
+    psio_tocentry *this_entry = tocscan(unit, key);
+    if (this_entry == nullptr) psio_error(unit, PSIO_ERROR_NOTOCENT);
+
+    size_t tocentry_size = sizeof(psio_tocentry) - 2 * sizeof(psio_tocentry *);
+    size_t start = psio_address_bytes(psio_get_address(this_entry->sadd, tocentry_size));
+    size_t end = psio_address_bytes(this_entry->eadd);
+
+    psio_span span;
+    span.size = end - start;
+    if (span.size == 0) {
+        span.data = nullptr;
+        return span;
+    }
+
+    // Spans stay valid until the unit is closed, so a mapping is only ever added, never moved
+    std::vector<std::pair<void *, size_t>> &maps = entry_maps_[unit];
+    if (maps.empty() || maps.back().second < end) {
+        int stream = this_unit->vol[0].stream;
+        struct stat st;
+        if (fstat(stream, &st) == -1 || (size_t)st.st_size < end) psio_error(unit, PSIO_ERROR_READ);
+        void *base = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, stream, 0);
+        if (base == MAP_FAILED) psio_error(unit, PSIO_ERROR_READ);
+        maps.emplace_back(base, (size_t)st.st_size);
+    }
+    span.data = static_cast<const char *>(maps.back().first) + start;
+    return span;
+#endif
+}
+
+void PSIO::unmap_entries(size_t unit) {
+#ifndef _MSC_VER
+    auto it = entry_maps_.find(unit);
+    if (it == entry_maps_.end()) return;
+    for (auto &map : it->second) munmap(map.first, map.second);
+    entry_maps_.erase(it);
+#endif
+}
+
+}  // namespace psi
@@ -0,0 +1,93 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+ \file
+ \ingroup PSIO
+ */
+
+#include <algorithm>
+#include <cstring>
+#ifdef _MSC_VER
+#include <io.h>
+#define SYSTEM_WRITE ::_write
+#define SYSTEM_LSEEK ::_lseeki64
+#else
+#include <unistd.h>
+#define SYSTEM_WRITE ::write
+#define SYSTEM_LSEEK ::lseek
+#endif
+
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+void PSIOMemoryUnit::rw(char* buffer, psio_address address, size_t size, int wrt) {
+    size_t page = address.page;
+    size_t offset = address.offset;
+    size_t done = 0;
+    if (wrt) extent_ = std::max(extent_, page * (size_t)PSIO_PAGELEN + offset + size);
+    while (done < size) {
+        size_t chunk = std::min((size_t)PSIO_PAGELEN - offset, size - done);
+        if (wrt) {
+            if (page >= pages_.size()) pages_.resize(page + 1);
+            if (!pages_[page]) {
+                pages_[page].reset(new char[PSIO_PAGELEN]());
+                resident_++;
+            }
+            memcpy(pages_[page].get() + offset, buffer + done, chunk);
+        } else if (page < pages_.size() && pages_[page]) {
+            memcpy(buffer + done, pages_[page].get() + offset, chunk);
+        } else {
+            memset(buffer + done, 0, chunk);
+        }
+        done += chunk;
+        offset = 0;
+        page++;
+    }
+}
+
+void PSIOMemoryUnit::flush(const std::vector<int>& streams) const {
+    size_t numvols = streams.size();
+    std::vector<char> zeros;
+    for (size_t page = 0; page * PSIO_PAGELEN < extent_; page++) {
+        size_t length = std::min((size_t)PSIO_PAGELEN, extent_ - page * PSIO_PAGELEN);
+        const char* data = (page < pages_.size() ? pages_[page].get() : nullptr);
+        if (data == nullptr) {
+            zeros.resize(PSIO_PAGELEN);
+            data = zeros.data();
+        }
+        int stream = streams[page % numvols];
+        if (SYSTEM_LSEEK(stream, (page / numvols) * PSIO_PAGELEN, SEEK_SET) == -1 ||
+            SYSTEM_WRITE(stream, data, length) != (long)length)
+            throw PSIEXCEPTION("PSIO: unable to move in-memory unit to disk");
+    }
+}
+
+}  // namespace psi
@@ -0,0 +1,71 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef _psi_src_lib_libpsio_memstore_h_
+#define _psi_src_lib_libpsio_memstore_h_
+
+#include <memory>
+#include <vector>
+
+#include "psi4/libpsio/config.h"
+
+namespace psi {
+
+/*! \ingroup PSIO
+ *  \class PSIOMemoryUnit
+ *  \brief In-core page store standing in for the volumes of one PSIO unit.
+ *
+ * The logical address space of the unit is held as PSIO_PAGELEN pages, allocated on first write.
+ * Pages never written read as zeros. flush() lays the pages out over the volumes exactly as a
+ * disk-backed unit would (page p at byte (p / numvols) * PSIO_PAGELEN of volume p % numvols), so a
+ * unit can be moved to disk at any point and reopened there.
+ */
+class PSIOMemoryUnit {
+    std::vector<std::unique_ptr<char[]> > pages_;
+    /// Pages allocated
+    size_t resident_ = 0;
+    /// One past the last byte ever written
+    size_t extent_ = 0;
+
+   public:
+    /// May the unit be moved to disk when the memory tier is over its limit?
+    bool spill = false;
+    /// Access tick of the last rw(), for least-recently-used eviction
+    size_t last_use = 0;
+
+    /// Same contract as PSIO::rw, except that unwritten bytes read as zeros
+    void rw(char* buffer, psio_address address, size_t size, int wrt);
+    /// Write the pages out to the open volumes of the unit
+    void flush(const std::vector<int>& streams) const;
+    /// Bytes of memory held
+    size_t bytes() const { return resident_ * (size_t)PSIO_PAGELEN; }
+};
+
+}  // namespace psi
+
+#endif
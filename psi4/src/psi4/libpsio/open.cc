@@ -55,6 +55,8 @@
 #include <sstream>
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/compress.h"
+#include "psi4/libpsio/memstore.h"
 #include "psi4/psi4-dec.h"
 namespace psi {
 
@@ -129,15 +131,79 @@ void PSIO::open(size_t unit, int status) {
         free(path);
     }
 
-    if (status == PSIO_OPEN_OLD)
-        tocread(unit);
-    else if (status == PSIO_OPEN_NEW) {
-        /* Init the TOC stats and write them to disk */
-        this_unit->toclen = 0;
-        this_unit->toc = nullptr;
-        wt_toclen(unit, 0);
-    } else
-        psio_error(unit, PSIO_ERROR_OSTAT);
+    /* Units may be held in memory, see PSIOManager::set_specific_storage(); a kept store is
+       picked up again only if its files were not touched while the unit was closed */
+    {
+        std::lock_guard<std::mutex> lock(memory_lock_);
+        auto store = memory_.find(unit);
+        if (store != memory_.end()) {
+            bool reused = (status == PSIO_OPEN_OLD && store->second.paths.size() == this_unit->numvols);
+            for (i = 0; reused && i < this_unit->numvols; i++) {
+                reused = store->second.paths[i] == this_unit->vol[i].path &&
+                         store->second.stamps[i] == volume_stamp(this_unit->vol[i].stream);
+            }
+            if (reused) {
+                store->second.paths.clear();
+                store->second.stamps.clear();
+            } else {
+                memory_.erase(store);
+                store = memory_.end();
+            }
+        }
+
+        std::string storage = PSIOManager::shared_object()->get_specific_storage(unit);
+        bool empty = true;
+        for (i = 0; i < this_unit->numvols; i++) empty = empty && volume_stamp(this_unit->vol[i].stream)[0] == 0;
+        if (store == memory_.end() && storage != "DISK" && empty) {
+            std::shared_ptr<PSIOMemoryUnit> data = std::make_shared<PSIOMemoryUnit>();
+            data->spill = (storage == "SPILL");
+            data->last_use = ++memory_tick_;
+            memory_[unit].data = data;
+        }
+    }
+
+    /* Single-volume units may sit behind a compressed page store */
+    if (this_unit->numvols == 1 && !in_memory(unit)) {
+        int stream = this_unit->vol[0].stream;
+        bool old = (status == PSIO_OPEN_OLD);
+        if ((old && PSIOCompressedUnit::is_compressed(stream)) ||
+            PSIOManager::shared_object()->get_specific_compression(unit)) {
+            compressed_[unit] = std::make_shared<PSIOCompressedUnit>(stream, old);
+        }
+    }
+
+    /* Reuse the TOC kept from the last close if the volumes have not changed since */
+    bool reused = false;
+    auto cached = toc_cache_.find(unit);
+    if (status == PSIO_OPEN_OLD && cached != toc_cache_.end() && cached->second.paths.size() == this_unit->numvols) {
+        reused = true;
+        for (i = 0; i < this_unit->numvols; i++) {
+            reused = reused && cached->second.paths[i] == this_unit->vol[i].path &&
+                     cached->second.stamps[i] == volume_stamp(this_unit->vol[i].stream);
+        }
+        if (reused) {
+            this_unit->toc = cached->second.toc;
+            this_unit->toclen = cached->second.toclen;
+            toc_cache_.erase(cached);
+            toc_index_rebuild(unit);
+            toc_dirty_[unit] = false;
+        }
+    }
+
+    if (!reused) {
+        toc_cache_drop(unit);
+        if (status == PSIO_OPEN_OLD)
+            tocread(unit);
+        else if (status == PSIO_OPEN_NEW) {
+            /* Init the TOC stats and write them to disk */
+            this_unit->toclen = 0;
+            this_unit->toc = nullptr;
+            toc_index_rebuild(unit);
+            toc_dirty_[unit] = false;
+            wt_toclen(unit, 0);
+        } else
+            psio_error(unit, PSIO_ERROR_OSTAT);
+    }
 
     free(name);
 }
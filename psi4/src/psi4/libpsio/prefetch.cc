@@ -0,0 +1,88 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "psi4/libpsio/prefetch.h"
+
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/psi4-dec.h"
+
+#include <chrono>
+
+namespace psi {
+
+BlockPrefetcher::BlockPrefetcher(size_t unit, bool enabled)
+    : unit_(unit), enabled_(enabled), owns_psio_(true), read_time_(0.0), read_doubles_(0L), wait_time_(0.0) {
+    psio_ = std::make_shared<PSIO>();
+    psio_->open(unit_, PSIO_OPEN_OLD);
+}
+BlockPrefetcher::BlockPrefetcher(std::shared_ptr<PSIO> psio, size_t unit, bool enabled)
+    : unit_(unit),
+      enabled_(enabled),
+      owns_psio_(false),
+      psio_(psio),
+      read_time_(0.0),
+      read_doubles_(0L),
+      wait_time_(0.0) {}
+BlockPrefetcher::~BlockPrefetcher() { close(); }
+void BlockPrefetcher::post(std::function<size_t(std::shared_ptr<PSIO>)> job) {
+    wait();
+    auto run = [this, job]() {
+        auto start = std::chrono::steady_clock::now();
+        size_t doubles = job(psio_);
+        read_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        read_doubles_ += doubles;
+    };
+    if (enabled_) {
+        pending_ = std::async(std::launch::async, run);
+    } else {
+        run();
+    }
+}
+void BlockPrefetcher::wait() {
+    if (!pending_.valid()) return;
+    auto start = std::chrono::steady_clock::now();
+    pending_.get();
+    wait_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+void BlockPrefetcher::close() {
+    wait();
+    if (psio_) {
+        if (owns_psio_) psio_->close(unit_, 1);
+        psio_.reset();
+    }
+}
+void BlockPrefetcher::print_stats(const char* label) const {
+    double gb = read_doubles_ * 8.0 / 1.0E9;
+    outfile->Printf("\t %-12s reads: %9.3f GB at %9.1f MB/s, %8.3f s stalled%s\n", label, gb,
+                    (read_time_ > 0.0 ? 1.0E3 * gb / read_time_ : 0.0), wait_time_,
+                    (enabled_ ? "" : " (synchronous)"));
+}
+
+}  // namespace psi
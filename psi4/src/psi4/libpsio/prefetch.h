@@ -0,0 +1,88 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef PSIO_PREFETCH_H
+#define PSIO_PREFETCH_H
+
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace psi {
+
+class PSIO;
+
+/*! \ingroup PSIO
+ *  \class BlockPrefetcher
+ *  \brief Double-buffered block reader: one posted job reads block k+1 on a worker
+ *  thread while the caller works on block k.
+ *
+ * By default the reader owns a private PSIO handle on a unit the caller already has
+ * open. It must be opened after, and closed before, any writes the caller makes to
+ * that unit, so the caller's TOC is the one that ends up on disk. Alternatively the
+ * caller's own handle may be shared, e.g. when the unit's TOC has not been flushed;
+ * the caller must then leave that PSIO object alone while a job is posted.
+ */
+class BlockPrefetcher {
+   protected:
+    size_t unit_;
+    bool enabled_;
+    bool owns_psio_;
+    std::shared_ptr<PSIO> psio_;
+    std::future<void> pending_;
+
+    /// Seconds spent in the posted jobs, and doubles they report as read
+    double read_time_;
+    size_t read_doubles_;
+    /// Seconds the caller spent waiting in wait()
+    double wait_time_;
+
+   public:
+    /// If enabled is false, post() runs the job right away on the caller's thread
+    BlockPrefetcher(size_t unit, bool enabled);
+    /// Prefetch through the caller's handle instead of a private one
+    BlockPrefetcher(std::shared_ptr<PSIO> psio, size_t unit, bool enabled);
+    ~BlockPrefetcher();
+
+    /// Run job(psio) in the background; the job returns the number of doubles it read
+    void post(std::function<size_t(std::shared_ptr<PSIO>)> job);
+    /// Block until the posted job is done
+    void wait();
+    /// Wait, then release a private handle (keeps the file)
+    void close();
+
+    /// Is the reading done in the background?
+    bool enabled() const { return enabled_; }
+
+    /// Print the read bandwidth and the time the caller was stalled
+    void print_stats(const char* label) const;
+};
+
+}  // namespace psi
+
+#endif
@@ -32,8 +32,14 @@
 #include <string>
 #include <map>
 #include <set>
+#include <unordered_map>
 #include <queue>
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "psi4/libpsio/config.h"
 
@@ -41,6 +47,8 @@ namespace psi {
 
 class PSIO;
 class PSIOManager;
+class PSIOCompressedUnit;
+class PSIOMemoryUnit;
 extern PSI_API std::shared_ptr<PSIO> _default_psio_lib_;
 extern PSI_API std::shared_ptr<PSIOManager> _default_psio_manager_;
 
@@ -64,6 +72,14 @@ private:
     std::map<std::string, bool> files_;
     /// Set of files to retain after psiclean
     std::set<std::string> retained_files_;
+    /// File numbers stored compressed
+    std::set<int> specific_compression_;
+    /// Per closed compressed file: logical bytes, physical bytes, bytes moved, seconds in I/O
+    std::map<std::string, std::array<double, 4> > compression_stats_;
+    /// Storage tier per file number: "DISK" (the default), "MEMORY" or "SPILL"
+    std::map<int, std::string> specific_storage_;
+    /// Bytes the SPILL units may hold in memory before the least recently used go to disk, 0 for no limit
+    size_t memory_limit_;
 
     std::string pid_;
 public:
@@ -104,6 +120,36 @@ public:
             * \return keeping or not?
             */
     bool get_specific_retention(int fileno);
+    /**
+            * Store a specific file number compressed (see PSIOCompressedUnit). Takes effect
+            * the next time the unit is opened new; files written compressed are always
+            * recognized on open, whatever this setting.
+            * \param fileno  PSI4 file number
+            * \param compress true to compress, false to store plainly
+            **/
+    void set_specific_compression(int fileno, bool compress);
+    /// Is a specific file number stored compressed?
+    bool get_specific_compression(int fileno);
+    /// Record the compression achieved on a file, reported by print()
+    void record_compression(const std::string& full_path, size_t logical, size_t physical, size_t moved,
+                            double seconds);
+    /**
+            * Choose where a specific file number keeps its data (see PSIOMemoryUnit).
+            * "MEMORY" units live in core until closed without keep; "SPILL" units start in
+            * core but are moved to disk, least recently used first, once all SPILL units
+            * together exceed the memory limit; "DISK" units go straight to disk. Takes effect
+            * the next time the unit is opened new. Kept in-memory units stay in core for the
+            * next open unless they are retained, in which case they are written out on close.
+            * \param fileno  PSI4 file number
+            * \param storage "DISK", "MEMORY" or "SPILL"
+            **/
+    void set_specific_storage(int fileno, const std::string& storage);
+    /// Storage tier of a specific file number
+    std::string get_specific_storage(int fileno);
+    /// Set the bytes SPILL units may hold in memory, 0 for no limit
+    void set_memory_limit(size_t bytes) { memory_limit_ = bytes; }
+    /// Bytes SPILL units may hold in memory, 0 for no limit
+    size_t get_memory_limit() const { return memory_limit_; }
 
     /**
             * Get the path for a specific file number
@@ -181,6 +227,12 @@ public:
     static std::shared_ptr<PSIOManager> shared_object();
 };
 
+/// Read-only view of the data of a TOC entry, see PSIO::map_entry()
+struct psio_span {
+    const char *data;
+    size_t size;
+};
+
 /**
    PSIO is an instance of libpsio library. Multiple instances of PSIO are supported.
 
@@ -333,6 +385,29 @@ public:
     /// delete a specific TOC entry (only deletes entry, not data)
     bool tocdel(size_t unit, const char *key);
 
+    /** Start every new TOC entry of unit after the first one so that its data begins at a multiple
+       ** of alignment bytes (a power of two; 0, the default, packs entries). The gap is added to the
+       ** end of the preceding entry, so files stay readable by any PSIO. Aligning to 4 kB or 2 MB pages
+       ** keeps entries returned by map_entry() from straddling pages.
+       */
+    void set_entry_alignment(size_t unit, size_t alignment);
+    /// Entry alignment of unit, 0 if entries are packed
+    size_t entry_alignment(size_t unit) const;
+    /** Zero-copy, read-only view of a whole TOC entry through a shared mapping of the unit file.
+       ** Later writes to the entry show through; the view stays valid until the unit is closed.
+       ** Only single-volume units can be mapped; an in-memory unit is moved to disk first.
+       */
+    psio_span map_entry(size_t unit, const char *key);
+    /// Is unit open through a compressed page store?
+    bool compressed(size_t unit) const { return compressed_.count(unit) > 0; }
+    /// Is unit held in memory? Closed units kept in memory count too.
+    bool in_memory(size_t unit);
+    /// Move an in-memory unit, open or closed, to its files on disk
+    void spill(size_t unit);
+    /// Total bytes moved by read() and write() over all units since construction
+    size_t bytes_read() const { return bytes_read_; }
+    size_t bytes_written() const { return bytes_written_; }
+
 private:
     /// vector of units
     psio_ud *psio_unit;
@@ -352,6 +427,9 @@ private:
     size_t *psio_readlen;
     size_t *psio_writlen;
 #endif
+    /// Running I/O volume, kept atomic since AIOHandler reads and writes from its own thread
+    std::atomic<size_t> bytes_read_;
+    std::atomic<size_t> bytes_written_;
 
     /// Library state variable
     int state_;
@@ -373,6 +451,60 @@ private:
     /// Read the table of contents for file number 'unit'.
     void tocread(size_t unit);
 
+    /// Units stored through a compressed page store, see PSIOManager::set_specific_compression()
+    std::map<size_t, std::shared_ptr<PSIOCompressedUnit> > compressed_;
+
+    /// Hashed TOC keys per unit, kept in step with the linked TOC so tocscan() is O(1)
+    std::vector<std::unordered_map<std::string, psio_tocentry *> > toc_index_;
+    /// Last TOC entry per unit, nullptr if the TOC is empty
+    std::vector<psio_tocentry *> toc_last_;
+    /// Has the in-core TOC changed since it was last read or written? Clean TOCs are not rewritten on close.
+    std::vector<bool> toc_dirty_;
+    /// Rebuild toc_index_ and toc_last_ of unit from its linked TOC
+    void toc_index_rebuild(size_t unit);
+
+    /// In-core TOC of a closed unit, reused when the same, unmodified files are reopened
+    struct TOCCache {
+        std::vector<std::string> paths;
+        /// (size, mtime, inode) of each volume at close
+        std::vector<std::array<long long, 3> > stamps;
+        psio_tocentry *toc;
+        size_t toclen;
+    };
+    std::map<size_t, TOCCache> toc_cache_;
+    /// (size, mtime, inode) of an open volume
+    static std::array<long long, 3> volume_stamp(int stream);
+    /// Free a linked TOC
+    static void toc_free(psio_tocentry *toc);
+    /// Drop the cached TOC of unit, if any
+    void toc_cache_drop(size_t unit);
+
+    /// Units held in memory, see PSIOManager::set_specific_storage(); stores of kept units outlive close()
+    struct MemoryStore {
+        std::shared_ptr<PSIOMemoryUnit> data;
+        /// Volume paths and (size, mtime, inode) stamps at close, empty while open
+        std::vector<std::string> paths;
+        std::vector<std::array<long long, 3> > stamps;
+    };
+    std::map<size_t, MemoryStore> memory_;
+    /// Guards memory_, as AIO threads move units to disk under other units' feet
+    std::mutex memory_lock_;
+    /// Access counter behind PSIOMemoryUnit::last_use
+    size_t memory_tick_ = 0;
+    /// rw() on an in-memory unit; false if unit is on disk
+    bool memory_rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt);
+    /// Move the store of unit to disk; memory_lock_ must be held
+    void memory_spill(std::map<size_t, MemoryStore>::iterator store);
+    /// Move least recently used SPILL units to disk until the memory limit holds; memory_lock_ must be held
+    void memory_reclaim();
+
+    /// Per-unit entry alignment, see set_entry_alignment()
+    std::map<size_t, size_t> entry_alignment_;
+    /// Per-unit mappings handed out by map_entry(), (base, length), released on close()
+    std::map<size_t, std::vector<std::pair<void *, size_t>>> entry_maps_;
+    /// Release the mappings of unit
+    void unmap_entries(size_t unit);
+
     friend class AIO_Handler;
 
 public:
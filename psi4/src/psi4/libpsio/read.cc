@@ -88,6 +88,7 @@ void PSIO::read(size_t unit, const char *key, char *buffer, size_t size, psio_ad
 
     /* Now read the actual data from the unit */
     rw(unit, buffer, start_data, size, 0);
+    bytes_read_ += size;
 
 #ifdef PSIO_STATS
     psio_readlen[unit] += size;
@@ -42,6 +42,14 @@ namespace psi {
 
 void PSIO::rename_file(size_t old_unit, size_t new_unit) {
     char *old_name, *new_name;
+    toc_cache_drop(old_unit);
+    toc_cache_drop(new_unit);
+    /* The data of an in-memory unit has to be on disk to be moved */
+    spill(old_unit);
+    {
+        std::lock_guard<std::mutex> lock(memory_lock_);
+        memory_.erase(new_unit);
+    }
     /* Get the file name prefix */
     get_filename(old_unit, &old_name);
     get_filename(new_unit, &new_name);
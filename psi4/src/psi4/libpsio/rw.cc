@@ -37,17 +37,31 @@
 #define SYSTEM_READ ::_read
 #define SYSTEM_WRITE ::_write
 #else
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
-#define SYSTEM_READ ::read
-#define SYSTEM_WRITE ::write
+#include <thread>
+#include <vector>
 #endif
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/compress.h"
 #include "psi4/psi4-dec.h"
 
 namespace psi {
 
+#ifdef _MSC_VER
+
 void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    if (memory_rw(unit, buffer, address, size, wrt)) return;
+    if (!compressed_.empty()) {
+        auto compressed = compressed_.find(unit);
+        if (compressed != compressed_.end()) return compressed->second->rw(buffer, address, size, wrt);
+    }
+
     int errcod;
     size_t i;
     size_t errcod_uli;
@@ -123,6 +137,110 @@ void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int
     }
 }
 
+#else
+
+namespace {
+
+/// Smallest transfer, in pages, worth spreading over one thread per volume
+const size_t PSIO_THREADED_PAGES = 4;
+
+/*
+ * Transfer the buffer pieces in iov to or from fd starting at byte off. The pieces of one
+ * volume are contiguous on disk, so this is a single vectored positional call unless the
+ * kernel returns short, in which case the remainder is resubmitted.
+ */
+bool psio_transfer(int fd, std::vector<struct iovec> &iov, off_t off, int wrt) {
+#ifdef IOV_MAX
+    const size_t max_iov = IOV_MAX;
+#else
+    const size_t max_iov = 1024;
+#endif
+    size_t first = 0;
+    while (first < iov.size()) {
+        int niov = (int)std::min(max_iov, iov.size() - first);
+        ssize_t done = wrt ? ::pwritev(fd, &iov[first], niov, off) : ::preadv(fd, &iov[first], niov, off);
+        if (done < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        if (done == 0) return false;
+        off += done;
+        size_t left = done;
+        while (first < iov.size() && left >= iov[first].iov_len) {
+            left -= iov[first].iov_len;
+            first++;
+        }
+        if (left) {
+            iov[first].iov_base = (char *)iov[first].iov_base + left;
+            iov[first].iov_len -= left;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/*
+ * Pages are striped round-robin over the volumes, page p living at byte (p / numvols) * PSIO_PAGELEN
+ * of volume p % numvols. Every page a request touches on one volume is therefore one contiguous
+ * run of that file, so each volume gets a single positional transfer with no lseek(), and on
+ * multi-volume units the volumes are driven concurrently.
+ */
+void PSIO::rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    if (memory_rw(unit, buffer, address, size, wrt)) return;
+    if (!compressed_.empty()) {
+        auto compressed = compressed_.find(unit);
+        if (compressed != compressed_.end()) return compressed->second->rw(buffer, address, size, wrt);
+    }
+
+    psio_ud *this_unit = &(psio_unit[unit]);
+    size_t numvols = this_unit->numvols;
+    size_t page = address.page;
+    size_t offset = address.offset;
+
+    if (size == 0) return;
+
+    std::vector<std::vector<struct iovec>> iov(numvols);
+    std::vector<off_t> start(numvols, -1);
+
+    size_t buf_offset = 0;
+    for (size_t this_page = page; buf_offset < size; this_page++) {
+        size_t this_vol = this_page % numvols;
+        size_t page_offset = (this_page == page ? offset : 0);
+        size_t this_page_total = std::min(PSIO_PAGELEN - page_offset, size - buf_offset);
+        if (start[this_vol] < 0) start[this_vol] = (off_t)(this_page / numvols) * PSIO_PAGELEN + page_offset;
+        struct iovec piece;
+        piece.iov_base = &(buffer[buf_offset]);
+        piece.iov_len = this_page_total;
+        iov[this_vol].push_back(piece);
+        buf_offset += this_page_total;
+    }
+
+    std::vector<char> ok(numvols, 1);
+    size_t npages = (offset + size + PSIO_PAGELEN - 1) / PSIO_PAGELEN;
+    if (numvols > 1 && npages >= PSIO_THREADED_PAGES * numvols) {
+        std::vector<std::thread> workers;
+        for (size_t vol = 1; vol < numvols; vol++) {
+            if (iov[vol].empty()) continue;
+            workers.emplace_back(
+                [&, vol]() { ok[vol] = psio_transfer(this_unit->vol[vol].stream, iov[vol], start[vol], wrt); });
+        }
+        if (!iov[0].empty()) ok[0] = psio_transfer(this_unit->vol[0].stream, iov[0], start[0], wrt);
+        for (std::thread &worker : workers) worker.join();
+    } else {
+        for (size_t vol = 0; vol < numvols; vol++) {
+            if (iov[vol].empty()) continue;
+            ok[vol] = psio_transfer(this_unit->vol[vol].stream, iov[vol], start[vol], wrt);
+        }
+    }
+
+    for (size_t vol = 0; vol < numvols; vol++) {
+        if (!ok[vol]) psio_error(unit, wrt ? PSIO_ERROR_WRITE : PSIO_ERROR_READ);
+    }
+}
+
+#endif
+
 /*!
  ** PSIO_RW(): Central function for all reads and writes on a PSIO unit.
  **
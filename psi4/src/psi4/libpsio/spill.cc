@@ -0,0 +1,124 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+
+/*!
+ ** \file
+ ** \ingroup PSIO
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _MSC_VER
+#include <io.h>
+#define SYSTEM_OPEN ::_open
+#define SYSTEM_CLOSE ::_close
+#define PSIO_SPILL_FLAGS _O_BINARY | _O_CREAT | _O_RDWR
+#define PERMISSION_MODE _S_IWRITE
+#else
+#include <unistd.h>
+#define SYSTEM_OPEN ::open
+#define SYSTEM_CLOSE ::close
+#define PSIO_SPILL_FLAGS O_CREAT | O_RDWR
+#define PERMISSION_MODE S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH
+#endif
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libpsio/memstore.h"
+#include "psi4/libpsi4util/exception.h"
+
+namespace psi {
+
+bool PSIO::in_memory(size_t unit) {
+    std::lock_guard<std::mutex> lock(memory_lock_);
+    return memory_.count(unit) > 0;
+}
+
+void PSIO::spill(size_t unit) {
+    std::lock_guard<std::mutex> lock(memory_lock_);
+    auto store = memory_.find(unit);
+    if (store != memory_.end()) memory_spill(store);
+}
+
+bool PSIO::memory_rw(size_t unit, char *buffer, psio_address address, size_t size, int wrt) {
+    std::lock_guard<std::mutex> lock(memory_lock_);
+    auto store = memory_.find(unit);
+    if (store == memory_.end()) return false;
+
+    PSIOMemoryUnit &data = *store->second.data;
+    data.last_use = ++memory_tick_;
+    size_t resident = data.bytes();
+    data.rw(buffer, address, size, wrt);
+    if (data.spill && data.bytes() > resident) memory_reclaim();
+    return true;
+}
+
+void PSIO::memory_spill(std::map<size_t, MemoryStore>::iterator store) {
+    MemoryStore &memory = store->second;
+    std::vector<int> streams;
+    if (memory.paths.empty()) {
+        /* Open unit: write into its volumes, which it keeps using from here on */
+        psio_ud *this_unit = &(psio_unit[store->first]);
+        for (size_t i = 0; i < this_unit->numvols; i++) streams.push_back(this_unit->vol[i].stream);
+        memory.data->flush(streams);
+    } else {
+        /* Closed unit: its files sit empty on disk until now */
+        for (const std::string &path : memory.paths) {
+            int stream = SYSTEM_OPEN(path.c_str(), PSIO_SPILL_FLAGS, PERMISSION_MODE);
+            if (stream == -1) throw PSIEXCEPTION("PSIO: unable to open " + path + " to move in-memory unit to disk");
+            streams.push_back(stream);
+        }
+        memory.data->flush(streams);
+        for (int stream : streams) SYSTEM_CLOSE(stream);
+    }
+    memory_.erase(store);
+}
+
+void PSIO::memory_reclaim() {
+    size_t limit = PSIOManager::shared_object()->get_memory_limit();
+    if (!limit) return;
+
+    size_t resident = 0;
+    for (const auto &memory : memory_) {
+        if (memory.second.data->spill) resident += memory.second.data->bytes();
+    }
+
+    while (resident > limit) {
+        auto victim = memory_.end();
+        for (auto it = memory_.begin(); it != memory_.end(); ++it) {
+            if (it->second.data->spill &&
+                (victim == memory_.end() || it->second.data->last_use < victim->second.data->last_use))
+                victim = it;
+        }
+        if (victim == memory_.end()) break;
+        resident -= victim->second.data->bytes();
+        memory_spill(victim);
+    }
+}
+
+}  // namespace psi
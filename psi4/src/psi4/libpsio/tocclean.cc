@@ -69,6 +69,11 @@ void PSIO::tocclean(size_t unit, const char *key) {
         last_entry = prev_entry;
         this_unit->toclen--;
     }
+    if (last_entry != nullptr)
+        last_entry->next = nullptr;
+    else
+        this_unit->toc = nullptr;
+    toc_index_rebuild(unit);
 
     /* Update on disk */
     wt_toclen(unit, this_unit->toclen);
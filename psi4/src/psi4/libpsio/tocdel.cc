@@ -52,17 +52,18 @@ bool PSIO::tocdel(size_t unit, const char *key) {
 
     psio_tocentry *last_entry = this_entry->last;
     psio_tocentry *next_entry = this_entry->next;
+    psio_ud *this_unit = &(psio_unit[unit]);
 
-    if (next_entry == nullptr)
-        last_entry->next = nullptr;
-    else {
+    if (last_entry == nullptr)
+        this_unit->toc = next_entry;
+    else
         last_entry->next = next_entry;
-        next_entry->last = last_entry;
-    }
+    if (next_entry != nullptr) next_entry->last = last_entry;
 
     free(this_entry);
-    psio_ud *this_unit = &(psio_unit[unit]);
     this_unit->toclen--;
+    toc_index_rebuild(unit);
+    toc_dirty_[unit] = true;
 
     return true;
 }
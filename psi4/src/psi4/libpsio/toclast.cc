@@ -36,12 +36,6 @@
 
 namespace psi {
 
-psio_tocentry *PSIO::toclast(size_t unit) {
-    psio_tocentry *this_entry = psio_unit[unit].toc;
-
-    while (this_entry->next != nullptr) this_entry = this_entry->next;
-
-    return (this_entry);
-}
+psio_tocentry *PSIO::toclast(size_t unit) { return toc_last_[unit]; }
 
 }  // namespace psi
@@ -71,6 +71,12 @@ size_t PSIO::rd_toclen(size_t unit) {
 
     this_unit = &(psio_unit[unit]);
 
+    /* Compressed and in-memory units keep the value in their first logical page */
+    if (compressed(unit) || in_memory(unit)) {
+        rw(unit, (char *)&len, PSIO_ZERO, sizeof(size_t), 0);
+        return (len);
+    }
+
     /* Seek vol[0] to its beginning */
     stream = this_unit->vol[0].stream;
 
@@ -93,6 +99,11 @@ void PSIO::wt_toclen(size_t unit, size_t len) {
 
     this_unit = &(psio_unit[unit]);
 
+    if (compressed(unit) || in_memory(unit)) {
+        rw(unit, (char *)&len, PSIO_ZERO, sizeof(size_t), 1);
+        return;
+    }
+
     /* Seek vol[0] to its beginning */
     stream = this_unit->vol[0].stream;
 
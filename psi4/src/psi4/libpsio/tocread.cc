@@ -79,6 +79,9 @@ void PSIO::tocread(size_t unit) {
         address = this_entry->eadd;
         this_entry = this_entry->next;
     }
+
+    toc_index_rebuild(unit);
+    toc_dirty_[unit] = false;
 }
 
 }  // namespace psi
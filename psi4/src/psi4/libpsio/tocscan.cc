@@ -42,9 +42,18 @@ PRAGMA_WARNING_POP
 
 namespace psi {
 
-psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
-    psio_tocentry *this_entry;
+void PSIO::toc_index_rebuild(size_t unit) {
+    std::unordered_map<std::string, psio_tocentry *> &index = toc_index_[unit];
+    index.clear();
+    toc_last_[unit] = nullptr;
+    for (psio_tocentry *this_entry = psio_unit[unit].toc; this_entry != nullptr; this_entry = this_entry->next) {
+        // The first of duplicate keys wins, as in a scan of the list
+        index.emplace(this_entry->key, this_entry);
+        toc_last_[unit] = this_entry;
+    }
+}
 
+psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
     if (key == nullptr) return (nullptr);
 
     if ((strlen(key) + 1) > PSIO_KEYLEN) psio_error(unit, PSIO_ERROR_KEYLEN);
@@ -52,18 +61,12 @@ psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
     bool already_open = open_check(unit);
     if (!already_open) open(unit, PSIO_OPEN_OLD);
 
-    this_entry = psio_unit[unit].toc;
-
-    while (this_entry != nullptr) {
-        if (!strcmp(this_entry->key, key)) {
-            if (!already_open) close(unit, 1);  // keep
-            return (this_entry);
-        }
-        this_entry = this_entry->next;
-    }
+    const std::unordered_map<std::string, psio_tocentry *> &index = toc_index_[unit];
+    auto it = index.find(key);
+    psio_tocentry *this_entry = (it == index.end() ? nullptr : it->second);
 
     if (!already_open) close(unit, 1);  // keep
-    return (nullptr);
+    return (this_entry);
 }
 
 /*!
@@ -76,8 +79,6 @@ psio_tocentry *PSIO::tocscan(size_t unit, const char *key) {
 psio_tocentry *psio_tocscan(size_t unit, const char *key) { return _default_psio_lib_->tocscan(unit, key); }
 
 bool PSIO::tocentry_exists(size_t unit, const char *key) {
-    psio_tocentry *this_entry;
-
     if (key == nullptr) return (true);
 
     if ((strlen(key) + 1) > PSIO_KEYLEN) psio_error(unit, PSIO_ERROR_KEYLEN);
@@ -85,18 +86,10 @@ bool PSIO::tocentry_exists(size_t unit, const char *key) {
     bool already_open = open_check(unit);
     if (!already_open) open(unit, PSIO_OPEN_OLD);
 
-    this_entry = psio_unit[unit].toc;
-
-    while (this_entry != nullptr) {
-        if (!strcmp(this_entry->key, key)) {
-            if (!already_open) close(unit, 1);  // keep
-            return (true);
-        }
-        this_entry = this_entry->next;
-    }
+    bool found = toc_index_[unit].count(key) > 0;
 
     if (!already_open) close(unit, 1);  // keep
-    return (false);
+    return (found);
 }
 
 /*!
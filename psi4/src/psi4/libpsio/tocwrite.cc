@@ -63,6 +63,7 @@ void PSIO::tocwrite(size_t unit) {
         this_entry = this_entry->next;
         if (this_entry != nullptr) address = this_entry->sadd;
     }
+    toc_dirty_[unit] = false;
 }
 
 /*!
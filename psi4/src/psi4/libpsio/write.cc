@@ -75,6 +75,16 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size, psio_a
             this_unit->toc = this_entry;
         } else { /* Use ending address from last TOC entry */
             last_entry = toclast(unit);
+            size_t alignment = entry_alignment(unit);
+            if (alignment) {
+                /* Pad the previous entry so that this entry's data starts on an alignment boundary */
+                size_t data = last_entry->eadd.page * PSIO_PAGELEN + last_entry->eadd.offset + tocentry_size;
+                size_t pad = (alignment - data % alignment) % alignment;
+                if (pad) {
+                    last_entry->eadd = psio_get_address(last_entry->eadd, pad);
+                    rw(unit, (char *)last_entry, last_entry->sadd, tocentry_size, 1);
+                }
+            }
             this_entry->sadd = last_entry->eadd;
             last_entry->next = this_entry;
             this_entry->last = last_entry;
@@ -90,6 +100,8 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size, psio_a
         this_entry->eadd = end_data;
 
         /* Update the unit's TOC stats */
+        toc_index_[unit].emplace(this_entry->key, this_entry);
+        toc_last_[unit] = this_entry;
         this_unit->toclen++;
         wt_toclen(unit, this_unit->toclen);
 
@@ -130,11 +142,14 @@ void PSIO::write(size_t unit, const char *key, char *buffer, size_t size, psio_a
         *end = psio_get_address(start, size);
     }
 
-    if (dirty) /* Need to first write/update the TOC header for this record */
+    if (dirty) { /* Need to first write/update the TOC header for this record */
         rw(unit, (char *)this_entry, start_toc, tocentry_size, 1);
+        toc_dirty_[unit] = true;
+    }
 
     /* Now write the actual data to the unit */
     rw(unit, buffer, start_data, size, 1);
+    bytes_written_ += size;
 
 #ifdef PSIO_STATS
     psio_writlen[unit] += size;
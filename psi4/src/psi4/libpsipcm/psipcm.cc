@@ -40,11 +40,14 @@
 #include "psi4/libmints/potentialint.h"
 #include "psi4/libmints/vector.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 
 #include <PCMSolver/PCMInput.h>
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <list>
 #include <memory>
 #include <string>
 #include <utility>
@@ -52,6 +55,22 @@
 
 namespace psi {
 
+namespace {
+
+/// A PCMSolver context (cavity, response matrix and nuclear charges) for one molecule and input
+struct CachedCavity {
+    std::string fname;
+    std::vector<double> charges;
+    std::vector<double> coordinates;
+    std::shared_ptr<pcmsolver_context_t> context;
+};
+
+/// Most recent contexts first; each holds an ntess x ntess response matrix, so only a few are kept
+std::list<CachedCavity> cavity_cache;
+const size_t max_cached_cavities = 4;
+
+}  // namespace
+
 namespace detail {
 std::pair<std::vector<double>, std::vector<double>> collect_atoms(std::shared_ptr<Molecule> molecule) {
     int nat = molecule->natom();
@@ -151,9 +170,35 @@ PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared
 
     potential_int_ = static_cast<PCMPotentialInt *>(integrals->pcm_potentialint());
 
-    context_ = detail::init_PCMSolver(pcmsolver_parsed_fname_, molecule);
+    incremental_ = Process::environment.options.get_bool("PCM_INCREMENTAL");
+    full_every_ = Process::environment.options.get_int("PCM_INCREMENTAL_FULL_EVERY");
+    cutoff_ = Process::environment.options.get_double("INTS_TOLERANCE");
+
+    // The cavity and response matrix depend only on the nuclei and the PCMSolver input,
+    // so a context built for the same molecule earlier in the job is reused as is
+    std::vector<double> atom_charges, atom_coordinates;
+    std::tie(atom_charges, atom_coordinates) = detail::collect_atoms(molecule);
+    bool cached = false;
+    for (auto it = cavity_cache.begin(); it != cavity_cache.end(); ++it) {
+        if (it->fname == pcmsolver_parsed_fname_ && it->charges == atom_charges &&
+            it->coordinates == atom_coordinates) {
+            context_ = it->context;
+            cavity_cache.splice(cavity_cache.begin(), cavity_cache, it);
+            cached = true;
+            break;
+        }
+    }
+    if (!cached) {
+        context_ = detail::init_PCMSolver(pcmsolver_parsed_fname_, molecule);
+        cavity_cache.push_front(CachedCavity{pcmsolver_parsed_fname_, atom_charges, atom_coordinates, context_});
+        if (cavity_cache.size() > max_cached_cavities) cavity_cache.pop_back();
+    }
     outfile->Printf("  **PSI4:PCMSOLVER Interface Active**\n");
-    pcmsolver_print(context_.get());
+    if (cached) {
+        outfile->Printf("  Reusing the cavity and response matrix of an earlier PCM setup for this molecule.\n");
+    } else {
+        pcmsolver_print(context_.get());
+    }
     ntess_ = pcmsolver_get_cavity_size(context_.get());
     ntessirr_ = pcmsolver_get_irreducible_cavity_size(context_.get());
     std::vector<int> tmp(int(ntess_ / ntessirr_));
@@ -182,12 +227,14 @@ PCM::PCM(const std::string &pcmsolver_parsed_fname, int print_level, std::shared
         }
     }
 
-    // Compute the nuclear charges, since they don't change
+    // Compute the nuclear charges, since they don't change (a cached context already holds them)
     std::string MEP_n_label("NucMEP");
     std::string ASC_n_label("NucASC");
-    pcmsolver_set_surface_function(context_.get(), ntess_, MEP_n_->pointer(0), MEP_n_label.c_str());
-    int irrep = 0;
-    pcmsolver_compute_asc(context_.get(), MEP_n_label.c_str(), ASC_n_label.c_str(), irrep);
+    if (!cached) {
+        pcmsolver_set_surface_function(context_.get(), ntess_, MEP_n_->pointer(0), MEP_n_label.c_str());
+        int irrep = 0;
+        pcmsolver_compute_asc(context_.get(), MEP_n_label.c_str(), ASC_n_label.c_str(), irrep);
+    }
 
     if (pcm_print_ > 2) {
         auto tess_charges_n = std::make_shared<Vector>(tesspi_);
@@ -212,9 +259,31 @@ PCM::PCM(const PCM *other) {
     potential_int_ = other->potential_int_;
     context_ = detail::init_PCMSolver(other->pcmsolver_parsed_fname_, basisset_->molecule());
     pcm_print_ = other->pcm_print_;
+    incremental_ = other->incremental_;
+    full_every_ = other->full_every_;
+    cutoff_ = other->cutoff_;
 }
 
-SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D) const {
+void PCM::clear_cache() { cavity_cache.clear(); }
+
+std::vector<bool> PCM::screen_shell_pairs(const SharedMatrix &D_carts) const {
+    int nshell = basisset_->nshell();
+    double **Dp = D_carts->pointer();
+    std::vector<bool> skip(nshell * nshell);
+    for (int P = 0, p0 = 0; P < nshell; p0 += basisset_->shell(P).ncartesian(), ++P) {
+        int np = basisset_->shell(P).ncartesian();
+        for (int Q = 0, q0 = 0; Q < nshell; q0 += basisset_->shell(Q).ncartesian(), ++Q) {
+            int nq = basisset_->shell(Q).ncartesian();
+            double dmax = 0.0;
+            for (int p = p0; p < p0 + np; ++p)
+                for (int q = q0; q < q0 + nq; ++q) dmax = std::max(dmax, std::fabs(Dp[p][q]));
+            skip[P * nshell + Q] = (dmax < cutoff_);
+        }
+    }
+    return skip;
+}
+
+SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D, bool incremental) const {
     double **ptess_Zxyz = tess_Zxyz_->pointer();
     for (int tess = 0; tess < ntess_; ++tess) ptess_Zxyz[tess][0] = 1.0;
     potential_int_->set_charge_field(tess_Zxyz_);
@@ -224,13 +293,27 @@ SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D) const {
         D_carts = std::make_shared<Matrix>("D carts", basisset_->nao(), basisset_->nao());
         D_carts->back_transform(D, my_aotoso_);
     } else {
-        D_carts = D;
+        D_carts = D->clone();
     }
 
     auto MEP = std::make_shared<Vector>(tesspi_);
-    ContractOverDensityFunctor contract_density_functor(ntess_, MEP->pointer(0), D_carts);
-    // Add in the electronic contribution to the potential at each tessera
-    potential_int_->compute(contract_density_functor);
+    if (incremental) {
+        // The MEP is linear in the density: add the contribution of the change only,
+        // skipping the shell pairs where it has died out
+        MEP->copy(*MEP_e_prev_);
+        SharedMatrix dD = D_carts->clone();
+        dD->subtract(D_prev_);
+        ContractOverDensityFunctor contract_density_functor(ntess_, MEP->pointer(0), dD);
+        potential_int_->compute(contract_density_functor, screen_shell_pairs(dD));
+    } else {
+        ContractOverDensityFunctor contract_density_functor(ntess_, MEP->pointer(0), D_carts);
+        // Add in the electronic contribution to the potential at each tessera
+        potential_int_->compute(contract_density_functor);
+    }
+    if (incremental_) {
+        D_prev_ = D_carts;
+        MEP_e_prev_ = SharedVector(MEP->clone());
+    }
 
     // A little debug info
     if (pcm_print_ > 2) {
@@ -244,7 +327,10 @@ SharedVector PCM::compute_electronic_MEP(const SharedMatrix &D) const {
 
 std::pair<double, SharedMatrix> PCM::compute_PCM_terms(const SharedMatrix &D, CalcType type) const {
     double upcm = 0.0;
-    auto MEP_e = compute_electronic_MEP(D);
+    // Work from the changes since the previous call unless a full rebuild is due
+    bool incremental = incremental_ && D_prev_ && n_incremental_ < full_every_;
+    n_incremental_ = (incremental ? n_incremental_ + 1 : 0);
+    auto MEP_e = compute_electronic_MEP(D, incremental);
     auto ASC = std::make_shared<Vector>(tesspi_);
     switch (type) {
         case CalcType::Total:
@@ -261,7 +347,7 @@ std::pair<double, SharedMatrix> PCM::compute_PCM_terms(const SharedMatrix &D, Ca
         default:
             throw PSIEXCEPTION("Unknown PCM calculation type.");
     }
-    return std::make_pair(upcm, compute_V(ASC));
+    return std::make_pair(upcm, compute_V(ASC, incremental && ASC_prev_));
 }
 
 double PCM::compute_E_total(const SharedVector &MEP_e) const {
@@ -359,10 +445,40 @@ double PCM::compute_E_electronic(const SharedVector &MEP_e) const {
     return Epol;
 }
 
-SharedMatrix PCM::compute_V(const SharedVector &ASC) const {
+SharedMatrix PCM::compute_V(const SharedVector &ASC, bool incremental) const {
     auto V_pcm_cart = std::make_shared<Matrix>("PCM potential cart", basisset_->nao(), basisset_->nao());
-    ContractOverChargesFunctor contract_charges_functor(ASC->pointer(0), V_pcm_cart);
-    potential_int_->compute(contract_charges_functor);
+    if (incremental) {
+        // The potential is linear in the charges: only tesserae whose charge moved contribute
+        std::vector<int> moved;
+        for (int tess = 0; tess < ntess_; ++tess) {
+            if (std::fabs(ASC->get(0, tess) - ASC_prev_->get(0, tess)) >= cutoff_) moved.push_back(tess);
+        }
+        V_pcm_cart->copy(V_prev_);
+        if (!moved.empty()) {
+            auto moved_Zxyz = std::make_shared<Matrix>("Moved Tess Zxyz", (int)moved.size(), 4);
+            std::vector<double> dq(moved.size());
+            for (size_t k = 0; k < moved.size(); ++k) {
+                int tess = moved[k];
+                moved_Zxyz->set(k, 0, 1.0);
+                for (int x = 1; x < 4; ++x) moved_Zxyz->set(k, x, tess_Zxyz_->get(tess, x));
+                dq[k] = ASC->get(0, tess) - ASC_prev_->get(0, tess);
+            }
+            auto dV = std::make_shared<Matrix>("PCM potential change cart", basisset_->nao(), basisset_->nao());
+            ContractOverChargesFunctor contract_charges_functor(dq.data(), dV);
+            potential_int_->set_charge_field(moved_Zxyz);
+            potential_int_->compute(contract_charges_functor);
+            potential_int_->set_charge_field(tess_Zxyz_);
+            V_pcm_cart->add(dV);
+        }
+    } else {
+        potential_int_->set_charge_field(tess_Zxyz_);
+        ContractOverChargesFunctor contract_charges_functor(ASC->pointer(0), V_pcm_cart);
+        potential_int_->compute(contract_charges_functor);
+    }
+    if (incremental_) {
+        ASC_prev_ = SharedVector(ASC->clone());
+        V_prev_ = V_pcm_cart->clone();
+    }
     // The potential might need to be transformed to the spherical harmonic basis
     SharedMatrix V_pcm_pure;
     if (basisset_->has_puream()) {
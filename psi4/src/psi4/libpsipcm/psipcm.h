@@ -58,6 +58,9 @@ class PCM final {
      */
     std::pair<double, SharedMatrix> compute_PCM_terms(const SharedMatrix &D, CalcType type = CalcType::Total) const;
 
+    /// Drop the cavities (and PCMSolver response matrices) cached across PCM objects
+    static void clear_cache();
+
    private:
     /// The number of tesserae in PCMSolver.
     int ntess_;
@@ -68,8 +71,10 @@ class PCM final {
     SharedMatrix tess_Zxyz_;
     /// Nucler MEP at cavity points
     SharedVector MEP_n_;
-    /// Computes electronic MEP at cavity points
-    SharedVector compute_electronic_MEP(const SharedMatrix &D) const;
+    /*! \brief Computes electronic MEP at cavity points
+     *  \param[in] incremental build from the change in density since the previous call
+     */
+    SharedVector compute_electronic_MEP(const SharedMatrix &D, bool incremental) const;
     /// Calculate energy using total charges and potentials
     double compute_E_total(const SharedVector &MEP_e) const;
     /// Calculate energy separating between charges and potentials
@@ -79,8 +84,26 @@ class PCM final {
     /*! \brief Compute PCM potential
      *  \param[in] ASC the apparent surface charge to contract with
      *  charge-attraction integrals
+     *  \param[in] incremental build from the change in charges since the previous call
      */
-    SharedMatrix compute_V(const SharedVector &ASC) const;
+    SharedMatrix compute_V(const SharedVector &ASC, bool incremental) const;
+    /// Flags the (Cartesian) shell pairs whose density block is below cutoff_
+    std::vector<bool> screen_shell_pairs(const SharedMatrix &D_carts) const;
+
+    /// Build the MEP and PCM potential from changes between calls?
+    bool incremental_ = false;
+    /// Full rebuild after this many consecutive incremental builds
+    int full_every_ = 0;
+    /// Density elements and charges below this are dropped from incremental builds
+    double cutoff_ = 0.0;
+    /// Consecutive incremental builds so far
+    mutable int n_incremental_ = 0;
+    /// Cartesian density and electronic MEP of the previous call
+    mutable SharedMatrix D_prev_;
+    mutable SharedVector MEP_e_prev_;
+    /// Charges and Cartesian PCM potential of the previous call
+    mutable SharedVector ASC_prev_;
+    mutable SharedMatrix V_prev_;
 
     /// Current basis set (for puream and nao/nso info)
     std::shared_ptr<BasisSet> basisset_;
@@ -0,0 +1,201 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Thread control and call statistics for the BLAS behind libqt
+** \ingroup QT
+*/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <string>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
+
+#include "blas_backend.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#if !defined(USING_LAPACK_MKL) && defined(__GNUC__) && !defined(__APPLE__)
+// Resolved only when OpenBLAS is linked in
+extern "C" {
+void openblas_set_num_threads(int) __attribute__((weak));
+int openblas_get_num_threads() __attribute__((weak));
+}
+#define PSI_OPENBLAS_RUNTIME
+#endif
+
+namespace psi {
+namespace blas {
+
+std::atomic<bool> gemm_profiling(false);
+
+namespace {
+
+/// The innermost scope's count and region on this thread, 0 and null outside any scope
+thread_local int scope_threads = 0;
+thread_local const char* scope_region = nullptr;
+
+bool have_openblas() {
+#ifdef PSI_OPENBLAS_RUNTIME
+    return openblas_set_num_threads != nullptr && openblas_get_num_threads != nullptr;
+#else
+    return false;
+#endif
+}
+
+/// Histogram buckets are powers of two of the FLOPs per call
+const int nbucket = 64;
+struct GemmBucket {
+    size_t calls = 0;
+    double flops = 0.0;
+};
+typedef std::array<GemmBucket, nbucket> GemmHistogram;
+
+std::mutex histogram_mutex;
+/// Keyed by the region literal; literals with equal text are merged when printed
+std::map<const char*, GemmHistogram> histograms;
+
+}  // namespace
+
+std::string backend() {
+#ifdef USING_LAPACK_MKL
+    return "MKL";
+#else
+    return have_openblas() ? "OpenBLAS" : "generic";
+#endif
+}
+
+int default_threads() {
+    int nthread = std::max(1, Process::environment.get_n_threads());
+#ifdef _OPENMP
+    // Every enclosing team, nested or not, shares the job's threads
+    for (int level = 1; level <= omp_get_level(); level++) nthread /= std::max(1, omp_get_team_size(level));
+#endif
+    return std::max(1, nthread);
+}
+
+int max_threads() { return scope_threads > 0 ? scope_threads : default_threads(); }
+
+ThreadScope::ThreadScope(int nthread, const char* region)
+    : previous_(scope_threads), previous_backend_(-1), previous_region_(scope_region) {
+    int limit = std::max(1, Process::environment.get_n_threads());
+    threads_ = nthread > 0 ? std::min(nthread, limit) : default_threads();
+    scope_threads = threads_;
+    if (region) scope_region = region;
+
+#ifdef USING_LAPACK_MKL
+    previous_backend_ = mkl_set_num_threads_local(threads_);
+#elif defined(PSI_OPENBLAS_RUNTIME)
+    bool parallel = false;
+#ifdef _OPENMP
+    parallel = omp_in_parallel();
+#endif
+    if (have_openblas() && !parallel) {
+        previous_backend_ = openblas_get_num_threads();
+        openblas_set_num_threads(threads_);
+    }
+#endif
+}
+
+ThreadScope::~ThreadScope() {
+#ifdef USING_LAPACK_MKL
+    mkl_set_num_threads_local(previous_backend_);
+#elif defined(PSI_OPENBLAS_RUNTIME)
+    if (previous_backend_ > 0) openblas_set_num_threads(previous_backend_);
+#endif
+    scope_threads = previous_;
+    scope_region = previous_region_;
+}
+
+void set_gemm_profiling(bool on) { gemm_profiling = on; }
+
+void record_gemm(long int m, long int n, long int k) {
+    double flops = 2.0 * m * n * k;
+    if (flops <= 0.0) return;
+    int bucket = std::min(nbucket - 1, std::max(0, (int)std::log2(flops)));
+
+    std::lock_guard<std::mutex> lock(histogram_mutex);
+    GemmBucket& entry = histograms[scope_region][bucket];
+    entry.calls++;
+    entry.flops += flops;
+}
+
+void reset_gemm_histogram() {
+    std::lock_guard<std::mutex> lock(histogram_mutex);
+    histograms.clear();
+}
+
+void print_gemm_histogram(std::shared_ptr<PsiOutStream> printer) {
+    std::map<std::string, GemmHistogram> merged;
+    {
+        std::lock_guard<std::mutex> lock(histogram_mutex);
+        for (const auto& region : histograms) {
+            GemmHistogram& total = merged[region.first ? region.first : "(no region)"];
+            for (int b = 0; b < nbucket; b++) {
+                total[b].calls += region.second[b].calls;
+                total[b].flops += region.second[b].flops;
+            }
+        }
+    }
+
+    printer->Printf("\n  ==> GEMM Sizes (BLAS: %s) <==\n\n", backend().c_str());
+    if (merged.empty()) {
+        printer->Printf("    No GEMMs recorded.\n\n");
+        return;
+    }
+
+    for (const auto& region : merged) {
+        double region_flops = 0.0;
+        for (const GemmBucket& bucket : region.second) region_flops += bucket.flops;
+
+        printer->Printf("    %s\n", region.first.c_str());
+        printer->Printf("    %-20s %14s %14s %8s\n", "FLOPs per call", "Calls", "GFLOP", "Share");
+        for (int b = 0; b < nbucket; b++) {
+            const GemmBucket& bucket = region.second[b];
+            if (!bucket.calls) continue;
+            char range[32];
+            snprintf(range, sizeof(range), "2^%d - 2^%d", b, b + 1);
+            printer->Printf("    %-20s %14zu %14.6f %7.1f%%\n", range, bucket.calls, bucket.flops * 1.0E-9,
+                            100.0 * bucket.flops / region_flops);
+        }
+        printer->Printf("\n");
+    }
+}
+
+}  // namespace blas
+}  // namespace psi
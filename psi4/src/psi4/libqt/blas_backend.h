@@ -0,0 +1,114 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Thread control and call statistics for the BLAS behind libqt
+** \ingroup QT
+**
+** Modules mix OpenMP loops around BLAS calls with threaded BLAS calls of
+** their own.  A ThreadScope states, for the calling thread, how many
+** threads the BLAS calls in its block may use; scopes nest and restore the
+** previous count on exit.  By default a scope takes the calling thread's
+** share of the job: all of Process::environment's threads outside a
+** parallel region, and that divided by the team size inside one, so
+** BLAS-in-OpenMP code does not oversubscribe the machine:
+**
+**     #pragma omp parallel for
+**     for (...) {
+**         blas::ThreadScope blas_threads(0, "My kernel");
+**         C_DGEMM(...);
+**     }
+**
+** With MKL the count is set per thread (mkl_set_num_threads_local).  With
+** OpenBLAS, found at run time, it can only be set process-wide, so scopes
+** opened inside a parallel region leave it alone.  With other BLAS the
+** scopes only label regions.
+**
+** While GEMM profiling is on, every libqt and FNOCC GEMM is counted in a
+** histogram of its FLOPs, per scope region.
+*/
+
+#ifndef _psi_src_lib_libqt_blas_backend_h_
+#define _psi_src_lib_libqt_blas_backend_h_
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class PsiOutStream;
+
+namespace blas {
+
+/// The BLAS whose threads are controlled: "MKL", "OpenBLAS", or "generic"
+PSI_API std::string backend();
+
+/// Threads the calling thread's share of the job comes to, as a default scope would set
+PSI_API int default_threads();
+/// Threads BLAS calls from the calling thread may use: the innermost scope's, else default_threads()
+PSI_API int max_threads();
+
+/// Count GEMM sizes from now on, or stop
+PSI_API void set_gemm_profiling(bool on);
+/// Print the GEMM size histograms of every region
+PSI_API void print_gemm_histogram(std::shared_ptr<PsiOutStream> printer);
+PSI_API void reset_gemm_histogram();
+
+/// Whether GEMMs are being counted; checked by the wrappers before record_gemm
+extern PSI_API std::atomic<bool> gemm_profiling;
+/// Counts one m x n x k GEMM in the calling thread's region
+PSI_API void record_gemm(long int m, long int n, long int k);
+
+/// Sets the BLAS thread count of the calling thread for the enclosing block
+class PSI_API ThreadScope {
+    int threads_;
+    int previous_;
+    int previous_backend_;
+    const char* previous_region_;
+
+   public:
+    /*! nthread <= 0 takes default_threads(), and any count is capped at the
+     *  job's threads; region, a string literal, labels the GEMM histogram
+     *  (null keeps the enclosing scope's label)
+     */
+    explicit ThreadScope(int nthread = 0, const char* region = nullptr);
+    ~ThreadScope();
+    ThreadScope(const ThreadScope&) = delete;
+    ThreadScope& operator=(const ThreadScope&) = delete;
+
+    int threads() const { return threads_; }
+};
+
+}  // namespace blas
+}  // namespace psi
+
+#endif
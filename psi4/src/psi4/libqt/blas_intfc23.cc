@@ -35,10 +35,18 @@
 **
 */
 
+#include <algorithm>
+#include <functional>
 #include <stdexcept>
+#include <vector>
+
+#ifdef USING_LAPACK_MKL
+#include <mkl.h>
+#endif
 
 #include "psi4/pragma.h"
 #include "psi4/libqt/blas_intfc23_mangle.h"
+#include "psi4/libqt/blas_backend.h"
 #include "psi4/libqt/qt.h"
 
 extern "C" {
@@ -64,6 +72,8 @@ extern void F_DTRMM(char*, char*, char*, char*, int*, int*, double*, double*, in
 extern void F_DTRMV(char*, char*, char*, int*, double*, int*, double*, int*);
 extern void F_DTRSM(char*, char*, char*, char*, int*, int*, double*, double*, int*, double*, int*);
 extern void F_DTRSV(char*, char*, char*, int*, double*, int*, double*, int*);
+extern void F_SGEMM(char*, char*, int*, int*, int*, float*, float*, int*, float*, int*, float*, float*, int*);
+extern void F_SGEMV(char*, int*, int*, float*, float*, int*, float*, int*, float*, float*, int*);
 }
 
 namespace psi {
@@ -324,9 +334,125 @@ void C_DGBMV(char trans, int m, int n, int kl, int ku, double alpha, double* a,
 PSI_API void C_DGEMM(char transa, char transb, int m, int n, int k, double alpha, double* a, int lda, double* b,
                      int ldb, double beta, double* c, int ldc) {
     if (m == 0 || n == 0 || k == 0) return;
+    if (blas::gemm_profiling.load(std::memory_order_relaxed)) blas::record_gemm(m, n, k);
     ::F_DGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
 }
 
+// Below this many FLOPs per product a batch runs its GEMMs concurrently, one BLAS thread each
+static const double batch_concurrent_flops = 2.0 * 96 * 96 * 96;
+
+// Runs gemm(0..count-1), concurrently if the largest product is small
+static void gemm_batch_loop(size_t count, double max_flops, const std::function<void(size_t)>& gemm) {
+    int nthread = blas::default_threads();
+    if (count > 1 && nthread > 1 && max_flops < batch_concurrent_flops) {
+#pragma omp parallel for schedule(dynamic) num_threads(std::min<size_t>(nthread, count))
+        for (long int i = 0; i < (long int)count; i++) {
+            blas::ThreadScope blas_threads(1);
+            gemm(i);
+        }
+    } else {
+        for (size_t i = 0; i < count; i++) gemm(i);
+    }
+}
+
+/**
+ *  Independent GEMMs, each in C_DGEMM's (row-major) conventions, issued as
+ *  one call: a cblas_dgemm_batch with MKL; otherwise small products are run
+ *  concurrently with one BLAS thread each, large ones one after the other
+ *  with all threads. The C blocks must not overlap. GEMMs with an empty
+ *  dimension are skipped, as by C_DGEMM.
+ **/
+PSI_API void C_DGEMM_BATCH(size_t count, const char* transa, const char* transb, const int* m, const int* n,
+                           const int* k, const double* alpha, double* const* a, const int* lda, double* const* b,
+                           const int* ldb, const double* beta, double* const* c, const int* ldc) {
+    if (!count) return;
+    if (count == 1) {
+        C_DGEMM(transa[0], transb[0], m[0], n[0], k[0], alpha[0], a[0], lda[0], b[0], ldb[0], beta[0], c[0], ldc[0]);
+        return;
+    }
+
+    std::vector<size_t> work;
+    double max_flops = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        if (!m[i] || !n[i] || !k[i]) continue;
+        work.push_back(i);
+        max_flops = std::max(max_flops, 2.0 * m[i] * n[i] * k[i]);
+        if (blas::gemm_profiling.load(std::memory_order_relaxed)) blas::record_gemm(m[i], n[i], k[i]);
+    }
+    if (work.empty()) return;
+
+#ifdef USING_LAPACK_MKL
+    std::vector<CBLAS_TRANSPOSE> ta, tb;
+    std::vector<MKL_INT> mm, nn, kk, la, lb, lc, group_size(work.size(), 1);
+    std::vector<double> al, be;
+    std::vector<const double*> A, B;
+    std::vector<double*> C;
+    for (size_t i : work) {
+        ta.push_back(transa[i] == 't' || transa[i] == 'T' ? CblasTrans : CblasNoTrans);
+        tb.push_back(transb[i] == 't' || transb[i] == 'T' ? CblasTrans : CblasNoTrans);
+        mm.push_back(m[i]);
+        nn.push_back(n[i]);
+        kk.push_back(k[i]);
+        la.push_back(lda[i]);
+        lb.push_back(ldb[i]);
+        lc.push_back(ldc[i]);
+        al.push_back(alpha[i]);
+        be.push_back(beta[i]);
+        A.push_back(a[i]);
+        B.push_back(b[i]);
+        C.push_back(c[i]);
+    }
+    cblas_dgemm_batch(CblasRowMajor, ta.data(), tb.data(), mm.data(), nn.data(), kk.data(), al.data(), A.data(),
+                      la.data(), B.data(), lb.data(), be.data(), C.data(), lc.data(), (MKL_INT)group_size.size(),
+                      group_size.data());
+#else
+    gemm_batch_loop(work.size(), max_flops, [&](size_t w) {
+        size_t i = work[w];
+        char ta = transa[i], tb = transb[i];
+        int mi = m[i], ni = n[i], ki = k[i], la = lda[i], lb = ldb[i], lc = ldc[i];
+        double al = alpha[i], be = beta[i];
+        ::F_DGEMM(&tb, &ta, &ni, &mi, &ki, &al, b[i], &lb, a[i], &la, &be, c[i], &lc);
+    });
+#endif
+}
+
+/**
+ *  count GEMMs of one shape in C_DGEMM's conventions, the i-th on the blocks
+ *  at a + i * stride_a, b + i * stride_b and c + i * stride_c, issued as by
+ *  C_DGEMM_BATCH. A zero stride shares a block among all the products.
+ **/
+PSI_API void C_DGEMM_STRIDED_BATCH(size_t count, char transa, char transb, int m, int n, int k, double alpha, double* a,
+                                   int lda, size_t stride_a, double* b, int ldb, size_t stride_b, double beta,
+                                   double* c, int ldc, size_t stride_c) {
+    if (!count || m == 0 || n == 0 || k == 0) return;
+    if (blas::gemm_profiling.load(std::memory_order_relaxed)) {
+        for (size_t i = 0; i < count; i++) blas::record_gemm(m, n, k);
+    }
+
+#ifdef USING_LAPACK_MKL
+    CBLAS_TRANSPOSE ta = (transa == 't' || transa == 'T') ? CblasTrans : CblasNoTrans;
+    CBLAS_TRANSPOSE tb = (transb == 't' || transb == 'T') ? CblasTrans : CblasNoTrans;
+    MKL_INT mm = m, nn = n, kk = k, la = lda, lb = ldb, lc = ldc, group_size = count;
+    std::vector<const double*> A(count), B(count);
+    std::vector<double*> C(count);
+    for (size_t i = 0; i < count; i++) {
+        A[i] = a + i * stride_a;
+        B[i] = b + i * stride_b;
+        C[i] = c + i * stride_c;
+    }
+    cblas_dgemm_batch(CblasRowMajor, &ta, &tb, &mm, &nn, &kk, &alpha, A.data(), &la, B.data(), &lb, &beta, C.data(),
+                      &lc, 1, &group_size);
+#else
+    gemm_batch_loop(count, 2.0 * m * n * k, [&](size_t i) {
+        char ta = transa, tb = transb;
+        int mi = m, ni = n, ki = k, la = lda, lb = ldb, lc = ldc;
+        double al = alpha, be = beta;
+        ::F_DGEMM(&tb, &ta, &ni, &mi, &ki, &al, b + i * stride_b, &lb, a + i * stride_a, &la, &be, c + i * stride_c,
+                  &lc);
+    });
+#endif
+}
+
 /**
  *  Purpose
  *  =======
@@ -433,6 +559,32 @@ PSI_API void C_DGEMV(char trans, int m, int n, double alpha, double* a, int lda,
     ::F_DGEMV(&trans, &n, &m, &alpha, a, &lda, x, &incx, &beta, y, &incy);
 }
 
+/**
+ *  Single precision counterpart of C_DGEMM, same (row-major) conventions.
+ *  Used by the mixed-precision DF kernels.
+ **/
+PSI_API void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b,
+                     int ldb, float beta, float* c, int ldc) {
+    if (m == 0 || n == 0 || k == 0) return;
+    if (blas::gemm_profiling.load(std::memory_order_relaxed)) blas::record_gemm(m, n, k);
+    ::F_SGEMM(&transb, &transa, &n, &m, &k, &alpha, b, &ldb, a, &lda, &beta, c, &ldc);
+}
+
+/**
+ *  Single precision counterpart of C_DGEMV, same (row-major) conventions.
+ **/
+PSI_API void C_SGEMV(char trans, int m, int n, float alpha, float* a, int lda, float* x, int incx, float beta,
+                     float* y, int incy) {
+    if (m == 0 || n == 0) return;
+    if (trans == 'N' || trans == 'n')
+        trans = 'T';
+    else if (trans == 'T' || trans == 't')
+        trans = 'N';
+    else
+        throw std::invalid_argument("C_SGEMV trans argument is invalid.");
+    ::F_SGEMV(&trans, &n, &m, &alpha, a, &lda, x, &incx, &beta, y, &incy);
+}
+
 /**
  *  Purpose
  *  =======
@@ -45,6 +45,8 @@
 #define F_DGBMV FC_GLOBAL(dgbmv, DGBMV)
 #define F_DGEMM FC_GLOBAL(dgemm, DGEMM)
 #define F_DGEMV FC_GLOBAL(dgemv, DGEMV)
+#define F_SGEMM FC_GLOBAL(sgemm, SGEMM)
+#define F_SGEMV FC_GLOBAL(sgemv, SGEMV)
 #define F_DGER FC_GLOBAL(dger, DGER)
 #define F_DSBMV FC_GLOBAL(dsbmv, DSBMV)
 #define F_DSPMV FC_GLOBAL(dspmv, DSPMV)
@@ -69,6 +71,8 @@
 #define F_DGBMV dgbmv_
 #define F_DGEMM dgemm_
 #define F_DGEMV dgemv_
+#define F_SGEMM sgemm_
+#define F_SGEMV sgemv_
 #define F_DGER dger_
 #define F_DSBMV dsbmv_
 #define F_DSPMV dspmv_
@@ -92,6 +96,8 @@
 #define F_DGBMV dgbmv
 #define F_DGEMM dgemm
 #define F_DGEMV dgemv
+#define F_SGEMM sgemm
+#define F_SGEMV sgemv
 #define F_DGER dger
 #define F_DSBMV dsbmv
 #define F_DSPMV dspmv
@@ -115,6 +121,8 @@
 #define F_DGBMV DGBMV
 #define F_DGEMM DGEMM
 #define F_DGEMV DGEMV
+#define F_SGEMM SGEMM
+#define F_SGEMV SGEMV
 #define F_DGER DGER
 #define F_DSBMV DSBMV
 #define F_DSPMV DSPMV
@@ -138,6 +146,8 @@
 #define F_DGBMV DGBMV_
 #define F_DGEMM DGEMM_
 #define F_DGEMV DGEMV_
+#define F_SGEMM SGEMM_
+#define F_SGEMV SGEMV_
 #define F_DGER DGER_
 #define F_DSBMV DSBMV_
 #define F_DSPMV DSPMV_
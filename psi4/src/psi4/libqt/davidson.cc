@@ -0,0 +1,305 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+  \file
+  \brief Block Davidson-Liu eigensolver driven by sigma callbacks
+  \ingroup QT
+*/
+
+#include "davidson.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libqt/qt.h"
+
+namespace psi {
+
+BlockDavidson::BlockDavidson(size_t dim, int nroot, SigmaFunction sigma)
+    : dim_(dim),
+      nroot_(nroot),
+      sigma_(sigma),
+      max_subspace_(8 * nroot),
+      collapse_per_root_(2),
+      block_size_(nroot),
+      e_convergence_(1.0E-10),
+      r_convergence_(1.0E-5),
+      maxiter_(100),
+      print_(0),
+      iteration_(0),
+      unit_(-1),
+      nslots_(0) {
+    if (nroot < 1 || dim < (size_t)nroot) throw PSIEXCEPTION("BlockDavidson: invalid number of roots.");
+}
+BlockDavidson::~BlockDavidson() {
+    if (psio_ && psio_->open_check(unit_)) psio_->close(unit_, 0);
+}
+void BlockDavidson::set_diagonal(const double *diagonal) { diagonal_.assign(diagonal, diagonal + dim_); }
+void BlockDavidson::set_disk(std::shared_ptr<PSIO> psio, int unit) {
+    psio_ = psio;
+    unit_ = unit;
+}
+void BlockDavidson::add_guess(const double *guess) { guesses_.push_back(std::vector<double>(guess, guess + dim_)); }
+double *BlockDavidson::vector(int slot, bool sigma, double *scratch) {
+    if (!psio_) return &incore_[(2 * (size_t)slot + sigma) * dim_];
+    char key[32];
+    std::sprintf(key, "%s %d", sigma ? "Sigma" : "Vector", slot);
+    psio_->read_entry(unit_, key, (char *)scratch, dim_ * sizeof(double));
+    return scratch;
+}
+void BlockDavidson::store(int slot, bool sigma, const double *v) {
+    if (!psio_) {
+        std::copy(v, v + dim_, &incore_[(2 * (size_t)slot + sigma) * dim_]);
+        return;
+    }
+    char key[32];
+    std::sprintf(key, "%s %d", sigma ? "Sigma" : "Vector", slot);
+    psio_->write_entry(unit_, key, (char *)v, dim_ * sizeof(double));
+}
+int BlockDavidson::take_slot() {
+    int slot = free_slots_.back();
+    free_slots_.pop_back();
+    slots_.push_back(slot);
+    return slot;
+}
+bool BlockDavidson::orthonormalize(double *v, double *scratch) {
+    double norm = std::sqrt(C_DDOT(dim_, v, 1, v, 1));
+    if (norm < 1.0E-12) return false;
+    C_DSCAL(dim_, 1.0 / norm, v, 1);
+
+    // Classical Gram-Schmidt, twice
+    for (int pass = 0; pass < 2; pass++) {
+        for (int slot : slots_) {
+            double *b = vector(slot, false, scratch);
+            C_DAXPY(dim_, -C_DDOT(dim_, b, 1, v, 1), b, 1, v, 1);
+        }
+    }
+
+    norm = std::sqrt(C_DDOT(dim_, v, 1, v, 1));
+    if (norm < 1.0E-8) return false;
+    C_DSCAL(dim_, 1.0 / norm, v, 1);
+    return true;
+}
+void BlockDavidson::diagonalize() {
+    int L = slots_.size();
+    double **G = block_matrix(L, L);
+    double **alpha = block_matrix(L, L);
+    theta_.assign(L, 0.0);
+    for (int i = 0; i < L; i++) {
+        for (int j = 0; j < L; j++) G[i][j] = G_[i * (size_t)nslots_ + j];
+    }
+    sq_rsp(L, L, G, theta_.data(), 1, alpha, 1.0E-14);
+    alpha_.assign(alpha[0], alpha[0] + L * (size_t)L);
+    free_block(G);
+    free_block(alpha);
+}
+void BlockDavidson::collapse(int ncollapse, double *scratch) {
+    int L = slots_.size();
+    std::vector<int> old_slots = slots_;
+    std::vector<double> ritz(dim_);
+    slots_.clear();
+
+    // Ritz vectors and their sigma vectors, so nothing is recomputed
+    for (int k = 0; k < ncollapse; k++) {
+        int slot = take_slot();
+        for (int sigma = 0; sigma < 2; sigma++) {
+            std::fill(ritz.begin(), ritz.end(), 0.0);
+            for (int i = 0; i < L; i++) {
+                double *v = vector(old_slots[i], sigma, scratch);
+                C_DAXPY(dim_, alpha_[i * (size_t)L + k], v, 1, ritz.data(), 1);
+            }
+            store(slot, sigma, ritz.data());
+        }
+    }
+    free_slots_.insert(free_slots_.end(), old_slots.begin(), old_slots.end());
+
+    std::fill(G_.begin(), G_.end(), 0.0);
+    for (int k = 0; k < ncollapse; k++) G_[k * (size_t)nslots_ + k] = theta_[k];
+    theta_.resize(ncollapse);
+    alpha_.assign(ncollapse * (size_t)ncollapse, 0.0);
+    for (int k = 0; k < ncollapse; k++) alpha_[k * (size_t)ncollapse + k] = 1.0;
+
+    if (print_) outfile->Printf("    Subspace collapsed from %d to %d vectors.\n", L, ncollapse);
+}
+int BlockDavidson::solve() {
+    if (!precondition_) {
+        if (diagonal_.empty()) throw PSIEXCEPTION("BlockDavidson: a diagonal or a preconditioner is required.");
+        precondition_ = [this](double lambda, double *r) {
+            for (size_t I = 0; I < dim_; I++) {
+                double denom = lambda - diagonal_[I];
+                r[I] = (std::fabs(denom) > 1.0E-6) ? r[I] / denom : 0.0;
+            }
+        };
+    }
+    if (guesses_.empty()) {
+        if (diagonal_.empty()) throw PSIEXCEPTION("BlockDavidson: a diagonal or guess vectors are required.");
+        std::vector<size_t> order(dim_);
+        std::iota(order.begin(), order.end(), 0);
+        std::partial_sort(order.begin(), order.begin() + nroot_, order.end(),
+                          [this](size_t a, size_t b) { return diagonal_[a] < diagonal_[b]; });
+        for (int k = 0; k < nroot_; k++) {
+            std::vector<double> unit(dim_, 0.0);
+            unit[order[k]] = 1.0;
+            guesses_.push_back(unit);
+        }
+    }
+    int collapse_dim = std::max(nroot_, collapse_per_root_ * nroot_);
+    max_subspace_ = std::max(max_subspace_, std::max(collapse_dim + block_size_, (int)guesses_.size()));
+
+    // Slots for a full subspace plus the Ritz vectors written while collapsing it
+    nslots_ = max_subspace_ + collapse_dim;
+    slots_.clear();
+    free_slots_.resize(nslots_);
+    for (int s = 0; s < nslots_; s++) free_slots_[s] = nslots_ - 1 - s;
+    if (psio_) {
+        psio_->open(unit_, PSIO_OPEN_NEW);
+    } else {
+        incore_.assign(2 * (size_t)nslots_ * dim_, 0.0);
+    }
+    G_.assign(nslots_ * (size_t)nslots_, 0.0);
+
+    std::vector<double> scratch(dim_);
+    std::vector<double> R(nroot_ * dim_);
+    std::vector<double> lambda_old(nroot_, 1.0E100);
+    std::vector<double> rnorm(nroot_);
+    std::vector<bool> converged(nroot_, false);
+    lambda_.assign(nroot_, 0.0);
+
+    int nnew = 0;
+    for (auto &guess : guesses_) {
+        if (orthonormalize(guess.data(), scratch.data())) {
+            store(take_slot(), false, guess.data());
+            nnew++;
+        }
+    }
+    guesses_.clear();
+    if ((int)slots_.size() < nroot_) throw PSIEXCEPTION("BlockDavidson: fewer independent guesses than roots.");
+
+    int nconverged = 0;
+    for (iteration_ = 1; iteration_ <= maxiter_; iteration_++) {
+        // Sigma vectors of the vectors added last, in one batch
+        int L = slots_.size();
+        int first = L - nnew;
+        std::vector<double> xbuf, sbuf;
+        std::vector<double *> x(nnew), s(nnew);
+        if (psio_) {
+            xbuf.resize(nnew * dim_);
+            sbuf.resize(nnew * dim_);
+        }
+        for (int k = 0; k < nnew; k++) {
+            int slot = slots_[first + k];
+            x[k] = psio_ ? vector(slot, false, &xbuf[k * dim_]) : vector(slot, false, nullptr);
+            s[k] = psio_ ? &sbuf[k * dim_] : vector(slot, true, nullptr);
+        }
+        sigma_(nnew, x.data(), s.data());
+        if (psio_) {
+            for (int k = 0; k < nnew; k++) store(slots_[first + k], true, s[k]);
+        }
+
+        for (int i = 0; i < L; i++) {
+            double *b = vector(slots_[i], false, scratch.data());
+            for (int k = 0; k < nnew; k++) {
+                double value = C_DDOT(dim_, b, 1, s[k], 1);
+                G_[i * (size_t)nslots_ + first + k] = G_[(first + k) * (size_t)nslots_ + i] = value;
+            }
+        }
+        diagonalize();
+
+        // Residuals r_k = sum_i alpha_ik (s_i - theta_k b_i)
+        std::fill(R.begin(), R.end(), 0.0);
+        for (int i = 0; i < L; i++) {
+            double *b = vector(slots_[i], false, scratch.data());
+            for (int k = 0; k < nroot_; k++) {
+                C_DAXPY(dim_, -alpha_[i * (size_t)L + k] * theta_[k], b, 1, &R[k * dim_], 1);
+            }
+            double *sv = vector(slots_[i], true, scratch.data());
+            for (int k = 0; k < nroot_; k++) C_DAXPY(dim_, alpha_[i * (size_t)L + k], sv, 1, &R[k * dim_], 1);
+        }
+
+        if (print_) {
+            outfile->Printf("\n    Davidson iteration %3d, %3d vectors\n", iteration_, L);
+            outfile->Printf("    Root          Eigenvalue         Delta    Residual  Converged?\n");
+        }
+        nconverged = 0;
+        for (int k = 0; k < nroot_; k++) {
+            double delta = std::fabs(theta_[k] - lambda_old[k]);
+            rnorm[k] = std::sqrt(C_DDOT(dim_, &R[k * dim_], 1, &R[k * dim_], 1));
+            if (delta < e_convergence_ && rnorm[k] < r_convergence_) converged[k] = true;
+            if (converged[k]) nconverged++;
+            lambda_old[k] = theta_[k];
+            lambda_[k] = theta_[k];
+            if (print_) {
+                outfile->Printf("    %4d %20.14f %11.3E %11.3E  %s\n", k, theta_[k], delta, rnorm[k],
+                                converged[k] ? "Y" : "N");
+            }
+        }
+        if (nconverged == nroot_ || iteration_ == maxiter_) break;
+
+        // Thick restart when the next block might not fit
+        int nwant = std::min(block_size_, nroot_ - nconverged);
+        if (L + nwant > max_subspace_) collapse(std::min(L, collapse_dim), scratch.data());
+
+        // Locked roots get no correction vectors
+        nnew = 0;
+        for (int k = 0; k < nroot_ && nnew < nwant; k++) {
+            if (converged[k]) continue;
+            double *r = &R[k * dim_];
+            precondition_(theta_[k], r);
+            if (orthonormalize(r, scratch.data())) {
+                store(take_slot(), false, r);
+                nnew++;
+            }
+        }
+        if (!nnew) {
+            outfile->Printf("    Warning: Davidson subspace can not be extended, stopping.\n");
+            break;
+        }
+    }
+    iteration_ = std::min(iteration_, maxiter_);
+
+    return nconverged;
+}
+void BlockDavidson::eigenvector(int k, double *v) {
+    int L = slots_.size();
+    std::vector<double> scratch(dim_);
+    std::fill(v, v + dim_, 0.0);
+    for (int i = 0; i < L; i++) {
+        double *b = vector(slots_[i], false, scratch.data());
+        C_DAXPY(dim_, alpha_[i * (size_t)L + k], b, 1, v, 1);
+    }
+}
+
+}  // namespace psi
@@ -0,0 +1,142 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+  \file
+  \brief Block Davidson-Liu eigensolver driven by sigma callbacks
+  \ingroup QT
+*/
+
+#ifndef _psi_src_lib_libqt_davidson_h_
+#define _psi_src_lib_libqt_davidson_h_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class PSIO;
+
+/*!
+** BlockDavidson: Lowest roots of a symmetric operator that is only known
+** through its action on vectors.
+**
+** Each iteration hands all new subspace vectors to the sigma callback at
+** once, so the caller can batch its contractions.  Roots whose eigenvalue
+** and residual norm are converged are locked and get no further correction
+** vectors.  When the subspace would outgrow its maximum it is collapsed to
+** a few Ritz vectors per root (thick restart), together with their sigma
+** vectors, so no sigma is ever recomputed.  The subspace is held in core
+** or, after set_disk(), in a PSIO file one vector at a time.
+**
+** \ingroup QT
+*/
+class PSI_API BlockDavidson {
+   public:
+    /// sigma(n, x, s): s[k] = A x[k] for the n vectors x[k]
+    typedef std::function<void(int n, double **x, double **s)> SigmaFunction;
+    /// precondition(lambda, r): replaces the residual r of the root at lambda by the correction vector
+    typedef std::function<void(double lambda, double *r)> PreconditionFunction;
+
+    BlockDavidson(size_t dim, int nroot, SigmaFunction sigma);
+    ~BlockDavidson();
+
+    /// Diagonal of A, for the default (lambda - A_II)^-1 preconditioner and unit-vector guesses
+    void set_diagonal(const double *diagonal);
+    void set_preconditioner(PreconditionFunction precondition) { precondition_ = precondition; }
+    /// Largest subspace before a restart (default 8 vectors per root)
+    void set_max_subspace(int max_subspace) { max_subspace_ = max_subspace; }
+    /// Ritz vectors per root kept at a restart (default 2)
+    void set_collapse_per_root(int collapse) { collapse_per_root_ = collapse; }
+    /// Most correction vectors added per iteration (default one per root)
+    void set_block_size(int block_size) { block_size_ = block_size; }
+    void set_e_convergence(double e_convergence) { e_convergence_ = e_convergence; }
+    void set_r_convergence(double r_convergence) { r_convergence_ = r_convergence; }
+    void set_maxiter(int maxiter) { maxiter_ = maxiter; }
+    void set_print(int print) { print_ = print; }
+    /// Keep the subspace and sigma vectors in scratch file unit instead of in core
+    void set_disk(std::shared_ptr<PSIO> psio, int unit);
+
+    /// Adds a guess vector; without guesses, unit vectors on the lowest diagonal elements are used
+    void add_guess(const double *guess);
+
+    /// Runs the iterations; returns the number of converged roots
+    int solve();
+
+    const std::vector<double> &eigenvalues() const { return lambda_; }
+    /// Ritz vector of root k after solve()
+    void eigenvector(int k, double *v);
+    int iterations() const { return iteration_; }
+
+   private:
+    size_t dim_;
+    int nroot_;
+    SigmaFunction sigma_;
+    PreconditionFunction precondition_;
+    std::vector<double> diagonal_;
+    int max_subspace_;
+    int collapse_per_root_;
+    int block_size_;
+    double e_convergence_;
+    double r_convergence_;
+    int maxiter_;
+    int print_;
+    int iteration_;
+
+    std::vector<std::vector<double> > guesses_;
+
+    /// Storage slots of the subspace vectors b_i and their sigma vectors s_i
+    std::vector<int> slots_;
+    std::vector<int> free_slots_;
+    std::vector<double> incore_;
+    std::shared_ptr<PSIO> psio_;
+    int unit_;
+
+    /// Subspace matrix b_i . s_j (stride nslots_), its eigenvalues and eigenvectors alpha_[i * L + k]
+    int nslots_;
+    std::vector<double> G_;
+    std::vector<double> theta_;
+    std::vector<double> alpha_;
+    /// Converged (or last) eigenvalues of the nroot_ roots
+    std::vector<double> lambda_;
+
+    double *vector(int slot, bool sigma, double *scratch);
+    void store(int slot, bool sigma, const double *v);
+    int take_slot();
+    /// Orthonormalizes v against the subspace; false if nothing is left of it
+    bool orthonormalize(double *v, double *scratch);
+    void diagonalize();
+    void collapse(int ncollapse, double *scratch);
+};
+
+}  // namespace psi
+
+#endif
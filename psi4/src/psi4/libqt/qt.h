@@ -138,6 +138,12 @@ void C_DTRSM(char side, char uplo, char transa, char diag, int m, int n, double
 // BLAS 3 Double routines
 PSI_API void C_DGEMM(char transa, char transb, int m, int n, int k, double alpha, double* a, int lda, double* b,
                      int ldb, double beta, double* c, int ldc);
+PSI_API void C_DGEMM_BATCH(size_t count, const char* transa, const char* transb, const int* m, const int* n,
+                           const int* k, const double* alpha, double* const* a, const int* lda, double* const* b,
+                           const int* ldb, const double* beta, double* const* c, const int* ldc);
+PSI_API void C_DGEMM_STRIDED_BATCH(size_t count, char transa, char transb, int m, int n, int k, double alpha, double* a,
+                                   int lda, size_t stride_a, double* b, int ldb, size_t stride_b, double beta,
+                                   double* c, int ldc, size_t stride_c);
 void C_DSYMM(char side, char uplo, int m, int n, double alpha, double* a, int lda, double* b, int ldb, double beta,
              double* c, int ldc);
 void C_DTRMM(char side, char uplo, char transa, char diag, int m, int n, double alpha, double* a, int lda, double* b,
@@ -147,6 +153,12 @@ void C_DSYR2K(char uplo, char trans, int n, int k, double alpha, double* a, int
               double* c, int ldc);
 void C_DTRSV(char uplo, char trans, char diag, int n, double* a, int lda, double* x, int incx);
 
+// BLAS 2/3 Single routines (mixed-precision kernels)
+PSI_API void C_SGEMV(char trans, int m, int n, float alpha, float* a, int lda, float* x, int incx, float beta,
+                     float* y, int incy);
+PSI_API void C_SGEMM(char transa, char transb, int m, int n, int k, float alpha, float* a, int lda, float* b,
+                     int ldb, float beta, float* c, int ldc);
+
 // LAPACK 3.2 Double routines
 // Sorry guys, I know its rather epic
 int C_DBDSDC(char uplo, char compq, int n, double* d, double* e, double* u, int ldu, double* vt, int ldvt, double* q,
@@ -0,0 +1,409 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Hierarchical scoped timers with thread-local buffers
+** \ingroup QT
+*/
+
+#include "psi4/libqt/trace.h"
+#include "psi4/times.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/* guess for HZ, if missing */
+#ifndef HZ
+#define HZ 60
+#endif
+
+namespace psi {
+namespace trace {
+
+std::atomic<bool> skip(false);
+
+namespace {
+
+typedef std::chrono::steady_clock clock;
+
+struct Node {
+    Key key;
+    int parent;
+    /// For root scopes of worker threads, the main-thread node open when they started
+    int context;
+    std::vector<int> children;
+    size_t calls;
+    clock::duration wtime;
+    double utime;
+    double stime;
+    bool serial;
+};
+
+struct Frame {
+    int node;
+    clock::time_point start;
+    struct tms cpu_start;
+    bool serial;
+};
+
+struct Event {
+    Key key;
+    int depth;
+    clock::time_point start;
+    clock::duration duration;
+};
+
+/// Everything one thread has timed; only that thread writes to it
+struct ThreadBuffer {
+    int index;
+    std::vector<Node> nodes;
+    std::vector<Frame> stack;
+    std::vector<Event> events;
+
+    explicit ThreadBuffer(int i) : index(i) { clear(); }
+
+    void clear() {
+        nodes.assign(1, Node{-1, -1, -1, std::vector<int>(), 0, clock::duration::zero(), 0.0, 0.0, false});
+        stack.clear();
+        events.clear();
+    }
+
+    int child(int parent, Key key, int context) {
+        for (int c : nodes[parent].children) {
+            if (nodes[c].key == key && nodes[c].context == context) return c;
+        }
+        nodes.push_back(Node{key, parent, context, std::vector<int>(), 0, clock::duration::zero(), 0.0, 0.0, false});
+        nodes[parent].children.push_back(nodes.size() - 1);
+        return nodes.size() - 1;
+    }
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+
+std::mutex key_mutex;
+std::unordered_map<std::string, Key> key_map;
+std::deque<std::string> key_names;
+
+std::atomic<bool> recording(false);
+size_t max_events = 0;
+clock::time_point epoch = clock::now();
+
+/// The serial node open on the main thread, under which worker root scopes are filed
+std::atomic<int> main_context(0);
+
+thread_local ThreadBuffer *tls_buffer = nullptr;
+
+ThreadBuffer *local_buffer() {
+    if (!tls_buffer) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        registry.emplace_back(new ThreadBuffer(registry.size()));
+        tls_buffer = registry.back().get();
+    }
+    return tls_buffer;
+}
+
+void close_frame(ThreadBuffer *b, const Frame &f, int depth, clock::time_point now) {
+    Node &node = b->nodes[f.node];
+    node.wtime += now - f.start;
+    if (f.serial) {
+        struct tms cpu_end;
+        times(&cpu_end);
+        node.utime += ((double)(cpu_end.tms_utime - f.cpu_start.tms_utime)) / HZ;
+        node.stime += ((double)(cpu_end.tms_stime - f.cpu_start.tms_stime)) / HZ;
+    }
+    if (recording.load(std::memory_order_relaxed) && b->events.size() < max_events) {
+        b->events.push_back(Event{node.key, depth, f.start, now - f.start});
+    }
+}
+
+void open_frame(ThreadBuffer *b, Key key, bool serial, bool count, clock::time_point now) {
+    int parent = b->stack.empty() ? 0 : b->stack.back().node;
+    int context = (b->stack.empty() && b->index != 0) ? main_context.load(std::memory_order_relaxed) : -1;
+    int node = b->child(parent, key, context);
+    if (count || b->nodes[node].calls == 0) b->nodes[node].calls++;
+    b->nodes[node].serial = b->nodes[node].serial || serial;
+    Frame f;
+    f.node = node;
+    f.serial = serial;
+    if (serial) times(&f.cpu_start);
+    f.start = now;
+    b->stack.push_back(f);
+}
+
+void update_context(ThreadBuffer *b) {
+    if (b->index == 0) main_context.store(b->stack.empty() ? 0 : b->stack.back().node, std::memory_order_relaxed);
+}
+
+/// Timings of one key path, summed over threads
+struct MergedNode {
+    Key key;
+    std::vector<int> children;
+    size_t calls;
+    double wtime;
+    double utime;
+    double stime;
+    bool serial;
+};
+
+int merged_child(std::vector<MergedNode> &tree, int parent, Key key) {
+    for (int c : tree[parent].children) {
+        if (tree[c].key == key) return c;
+    }
+    tree.push_back(MergedNode{key, std::vector<int>(), 0, 0.0, 0.0, 0.0, false});
+    tree[parent].children.push_back(tree.size() - 1);
+    return tree.size() - 1;
+}
+
+void merge_subtree(std::vector<MergedNode> &tree, int target, const ThreadBuffer &b, int node,
+                   std::map<int, int> *main_map) {
+    const Node &n = b.nodes[node];
+    int m = merged_child(tree, target, n.key);
+    if (main_map) (*main_map)[node] = m;
+    tree[m].calls += n.calls;
+    tree[m].wtime += std::chrono::duration_cast<std::chrono::duration<double>>(n.wtime).count();
+    tree[m].utime += n.utime;
+    tree[m].stime += n.stime;
+    tree[m].serial = tree[m].serial || n.serial;
+    for (int c : n.children) merge_subtree(tree, m, b, c, main_map);
+}
+
+std::vector<MergedNode> merged_tree() {
+    std::vector<MergedNode> tree(1, MergedNode{-1, std::vector<int>(), 0, 0.0, 0.0, 0.0, false});
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    if (registry.empty()) return tree;
+
+    std::map<int, int> main_map;
+    main_map[0] = 0;
+    const ThreadBuffer &main_buffer = *registry[0];
+    for (int c : main_buffer.nodes[0].children) merge_subtree(tree, 0, main_buffer, c, &main_map);
+    for (size_t t = 1; t < registry.size(); t++) {
+        const ThreadBuffer &b = *registry[t];
+        for (int c : b.nodes[0].children) {
+            auto it = main_map.find(b.nodes[c].context);
+            merge_subtree(tree, it == main_map.end() ? 0 : it->second, b, c, nullptr);
+        }
+    }
+    return tree;
+}
+
+void print_line(std::shared_ptr<PsiOutStream> printer, const std::string &indent, const MergedNode &n) {
+    std::string key = indent + name(n.key);
+    if (key.length() < 36) key.resize(36, ' ');
+    if (n.serial) {
+        printer->Printf("%s: %10.3fu %10.3fs %10.3fw %6zu calls\n", key.c_str(), n.utime, n.stime, n.wtime, n.calls);
+    } else {
+        printer->Printf("%s: %10.3fp                         %6zu calls\n", key.c_str(), n.wtime, n.calls);
+    }
+}
+
+void print_nested(std::shared_ptr<PsiOutStream> printer, const std::vector<MergedNode> &tree, int node,
+                  const std::string &indent) {
+    for (int c : tree[node].children) {
+        print_line(printer, indent, tree[c]);
+        print_nested(printer, tree, c, indent + "| ");
+    }
+}
+
+std::string json_escape(const std::string &s) {
+    std::string out;
+    for (char ch : s) {
+        switch (ch) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            default:
+                if ((unsigned char)ch < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+    return out;
+}
+
+}  // namespace
+
+Key intern(const std::string &name) {
+    std::lock_guard<std::mutex> lock(key_mutex);
+    auto it = key_map.find(name);
+    if (it != key_map.end()) return it->second;
+    Key key = key_names.size();
+    key_names.push_back(name);
+    key_map[name] = key;
+    return key;
+}
+
+std::string name(Key key) {
+    std::lock_guard<std::mutex> lock(key_mutex);
+    if (key < 0 || key >= (Key)key_names.size()) return "";
+    return key_names[key];
+}
+
+void begin(Key key, bool serial) {
+    ThreadBuffer *b = local_buffer();
+    if (serial && !b->stack.empty() && b->nodes[b->stack.back().node].key == key) {
+        throw PsiException("Timer " + name(key) + " is already on.", __FILE__, __LINE__);
+    }
+    open_frame(b, key, serial, true, clock::now());
+    if (serial) update_context(b);
+}
+
+void end(Key key) {
+    clock::time_point now = clock::now();
+    ThreadBuffer *b = local_buffer();
+    int pos = b->stack.size() - 1;
+    while (pos >= 0 && b->nodes[b->stack[pos].node].key != key) pos--;
+    if (pos < 0) throw PsiException("Timer " + name(key) + " is not on.", __FILE__, __LINE__);
+
+    // Scopes opened after key stay on, now under key's parent
+    std::vector<Frame> above(b->stack.begin() + pos + 1, b->stack.end());
+    for (int i = b->stack.size() - 1; i >= pos; i--) close_frame(b, b->stack[i], i, now);
+    bool serial = b->stack[pos].serial;
+    b->stack.resize(pos);
+    for (const Frame &f : above) open_frame(b, b->nodes[f.node].key, f.serial, false, now);
+    if (serial) update_context(b);
+}
+
+void start_recording(size_t max) {
+    max_events = max;
+    recording.store(true);
+}
+
+void stop_recording() { recording.store(false); }
+
+void write_chrome_trace(const std::string &filename) {
+    std::ofstream out(filename);
+    if (!out) throw PSIEXCEPTION("Unable to write the trace to " + filename);
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+    bool first = true;
+    char buf[128];
+    for (const auto &b : registry) {
+        if (!first) out << ",\n";
+        first = false;
+        out << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << b->index
+            << ", \"args\": {\"name\": \"thread " << b->index << "\"}}";
+        for (const Event &e : b->events) {
+            double ts = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(e.start - epoch).count();
+            double dur = std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(e.duration).count();
+            snprintf(buf, sizeof(buf), "\"ts\": %.3f, \"dur\": %.3f, \"pid\": 0, \"tid\": %d", ts, dur, b->index);
+            out << ",\n{\"name\": \"" << json_escape(name(e.key)) << "\", \"cat\": \"psi4\", \"ph\": \"X\", " << buf
+                << ", \"args\": {\"depth\": " << e.depth << "}}";
+        }
+    }
+    out << "\n]}\n";
+}
+
+namespace {
+
+/// The node under which the report starts: the unnamed root scope opened by timer_init is not itself reported
+int report_top(const std::vector<MergedNode> &tree) {
+    if (tree[0].children.size() == 1 && name(tree[tree[0].children[0]].key).empty()) return tree[0].children[0];
+    return 0;
+}
+
+/// Totals per key below top, in first-seen order
+std::vector<MergedNode> flat_totals(const std::vector<MergedNode> &tree, int top) {
+    std::vector<MergedNode> flat;
+    std::map<Key, int> flat_index;
+    std::vector<int> todo(tree[top].children.rbegin(), tree[top].children.rend());
+    while (!todo.empty()) {
+        const MergedNode &n = tree[todo.back()];
+        todo.pop_back();
+        auto it = flat_index.find(n.key);
+        if (it == flat_index.end()) {
+            flat_index[n.key] = flat.size();
+            flat.push_back(MergedNode{n.key, std::vector<int>(), 0, 0.0, 0.0, 0.0, false});
+            it = flat_index.find(n.key);
+        }
+        MergedNode &f = flat[it->second];
+        f.calls += n.calls;
+        f.wtime += n.wtime;
+        f.utime += n.utime;
+        f.stime += n.stime;
+        f.serial = f.serial || n.serial;
+        todo.insert(todo.end(), n.children.rbegin(), n.children.rend());
+    }
+    return flat;
+}
+
+}  // namespace
+
+void print_report(std::shared_ptr<PsiOutStream> printer) {
+    std::vector<MergedNode> tree = merged_tree();
+    int top = report_top(tree);
+
+    for (const MergedNode &f : flat_totals(tree, top)) print_line(printer, "", f);
+
+    printer->Printf("\n--------------------------------------------------------------------------------------\n");
+
+    print_nested(printer, tree, top, "");
+}
+
+std::vector<Total> totals() {
+    std::vector<MergedNode> tree = merged_tree();
+    std::vector<Total> result;
+    for (const MergedNode &f : flat_totals(tree, report_top(tree)))
+        result.push_back(Total{name(f.key), f.calls, f.wtime, f.utime, f.stime, f.serial});
+    return result;
+}
+
+double root_wall_time() {
+    ThreadBuffer *b = local_buffer();
+    if (b->nodes[0].children.empty()) return 0.0;
+    const Node &root = b->nodes[b->nodes[0].children[0]];
+    clock::duration wtime = root.wtime;
+    if (!b->stack.empty() && b->stack[0].node == b->nodes[0].children[0]) wtime += clock::now() - b->stack[0].start;
+    return std::chrono::duration_cast<std::chrono::duration<double>>(wtime).count();
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto &b : registry) b->clear();
+    main_context.store(0);
+    epoch = clock::now();
+}
+
+}  // namespace trace
+}  // namespace psi
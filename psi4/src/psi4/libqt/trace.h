@@ -0,0 +1,134 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*!
+** \file
+** \brief Hierarchical scoped timers with thread-local buffers
+** \ingroup QT
+**
+** Every thread keeps its own call tree of (interned) keys with call counts and
+** wall times, so starting and stopping a timer takes no lock.  Trees of worker
+** threads hang under the serial timer that was running when they started, and
+** are merged for the timer.dat report.  While recording is on, every closed
+** scope is also kept as an event for export as Chrome-trace / Perfetto JSON.
+**
+** The libqt timer_on/timer_off and parallel_timer_on/parallel_timer_off calls
+** are thin wrappers over this.  Hot code should prefer PSI_TIMER_SCOPE, which
+** interns its key once per call site:
+**
+**     {
+**         PSI_TIMER_SCOPE("Kernel");
+**         ...
+**     }
+*/
+
+#ifndef _psi_src_lib_libqt_trace_h_
+#define _psi_src_lib_libqt_trace_h_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "psi4/pragma.h"
+
+namespace psi {
+
+class PsiOutStream;
+
+namespace trace {
+
+/// Interned timer key
+typedef int Key;
+
+/// The key for name, interning it on first use
+PSI_API Key intern(const std::string& name);
+/// The name an interned key stands for
+PSI_API std::string name(Key key);
+
+/// Start timing key on the calling thread, nested in whatever that thread has open
+PSI_API void begin(Key key, bool cpu_times = false);
+/// Stop timing key on the calling thread; scopes opened after it stay open under its parent
+PSI_API void end(Key key);
+
+/// Keep every closed scope (up to max_events per thread) for write_chrome_trace
+PSI_API void start_recording(size_t max_events = 1 << 20);
+PSI_API void stop_recording();
+/// Write the recorded events as Chrome-trace JSON (loads in chrome://tracing and Perfetto)
+PSI_API void write_chrome_trace(const std::string& filename);
+
+/// Print the merged call tree, and a flat total per key
+PSI_API void print_report(std::shared_ptr<PsiOutStream> printer);
+
+/// Calls and seconds of one key, summed over threads and call paths
+struct Total {
+    std::string name;
+    size_t calls;
+    double wtime;
+    double utime;
+    double stime;
+    /// Timed by serial timers; the times of parallel timers are summed over threads
+    bool serial;
+};
+/// The flat totals of print_report, in first-seen order; open scopes count only their closed calls
+PSI_API std::vector<Total> totals();
+/// Total wall seconds of the outermost scope of the calling thread
+PSI_API double root_wall_time();
+/// Drop all timings and events; no scope may be open
+PSI_API void reset();
+
+/// Serial timer calls that are currently being ignored (start_skip_timers)
+extern std::atomic<bool> skip;
+
+/// Times the enclosing block under key
+class Scope {
+    Key key_;
+    bool on_;
+
+   public:
+    explicit Scope(Key key) : key_(key), on_(!skip.load(std::memory_order_relaxed)) {
+        if (on_) begin(key_);
+    }
+    ~Scope() {
+        if (on_) end(key_);
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+}  // namespace trace
+}  // namespace psi
+
+#define PSI_TIMER_CAT_(a, b) a##b
+#define PSI_TIMER_CAT(a, b) PSI_TIMER_CAT_(a, b)
+/// Times the rest of the enclosing block; the key is interned once per call site
+#define PSI_TIMER_SCOPE(name)                                                                         \
+    static const psi::trace::Key PSI_TIMER_CAT(psi_timer_key_, __LINE__) = psi::trace::intern(name); \
+    psi::trace::Scope PSI_TIMER_CAT(psi_timer_scope_, __LINE__)(PSI_TIMER_CAT(psi_timer_key_, __LINE__))
+
+#endif
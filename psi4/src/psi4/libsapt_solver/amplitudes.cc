@@ -600,6 +600,63 @@ void SAPT2::symmetrize(double *tARAR, int nocc, int nvir) {
     }
 }
 
+/*
+ * Pin an amplitude entry in core for a span of terms that all read it.  The
+ * entry is only kept if it fits in half of the SAPT memory; otherwise readers
+ * fall back to reading it from disk each time.
+ */
+void SAPT2::pin_amplitudes(int ampfile, const char *label, int nrow, int ncol) {
+    auto it = amp_registry_.find(label);
+    if (it != amp_registry_.end()) {
+        it->second.refs++;
+        return;
+    }
+
+    long int size = (long int)nrow * ncol;
+    if (amp_registry_mem_ + size > mem_ / 2) return;
+
+    double **block = block_matrix(nrow, ncol);
+    psio_->read_entry(ampfile, label, (char *)block[0], sizeof(double) * size);
+    amp_registry_[label] = {block, size, 1};
+    amp_registry_mem_ += size;
+}
+
+void SAPT2::unpin_amplitudes(const char *label) {
+    auto it = amp_registry_.find(label);
+    if (it == amp_registry_.end()) return;
+
+    if (--it->second.refs == 0) {
+        free_block(it->second.block);
+        amp_registry_mem_ -= it->second.size;
+        amp_registry_.erase(it);
+    }
+}
+
+/*
+ * Returns a read-only view of an amplitude entry: the resident copy if it is
+ * registered, or a fresh read from disk.  Must be paired with release_amplitudes.
+ */
+double **SAPT2::get_amplitudes(int ampfile, const char *label, int nrow, int ncol) {
+    auto it = amp_registry_.find(label);
+    if (it != amp_registry_.end()) {
+        it->second.refs++;
+        return it->second.block;
+    }
+
+    double **block = block_matrix(nrow, ncol);
+    psio_->read_entry(ampfile, label, (char *)block[0], sizeof(double) * nrow * ncol);
+    return block;
+}
+
+void SAPT2::release_amplitudes(const char *label, double **block) {
+    auto it = amp_registry_.find(label);
+    if (it != amp_registry_.end() && it->second.block == block) {
+        unpin_amplitudes(label);
+    } else {
+        free_block(block);
+    }
+}
+
 void SAPT2p::amplitudes() {
     tOVOV(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", foccA_, noccA_, nvirA_, evalsA_, PSIF_SAPT_AA_DF_INTS,
           "AR RI Integrals", foccA_, noccA_, nvirA_, evalsA_, PSIF_SAPT_AMPS, "tARAR Amplitudes");
@@ -732,6 +789,10 @@ void SAPT2p3::amplitudes() {
     tOVOV(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", foccA_, noccA_, nvirA_, evalsA_, PSIF_SAPT_BB_DF_INTS,
           "BS RI Integrals", foccB_, noccB_, nvirB_, evalsB_, PSIF_SAPT_AMPS, "tARBS Amplitudes");
 
+    // tARBS is read by the IndDisp30 amplitudes and most of the dispersion terms;
+    // compute_energy() drops it after the last third-order term
+    pin_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
+
     pOOpVV(PSIF_SAPT_AMPS, "tARAR Amplitudes", "tARAR Amplitudes", aoccA_, nvirA_, PSIF_SAPT_AMPS, "pAA Density Matrix",
            "pRR Density Matrix");
     pOOpVV(PSIF_SAPT_AMPS, "tBSBS Amplitudes", "tBSBS Amplitudes", aoccB_, nvirB_, PSIF_SAPT_AMPS, "pBB Density Matrix",
@@ -1271,9 +1332,7 @@ void SAPT2p3::inddisp30_ovov() {
     free_block(B_p_AR);
     free_block(X_p_BS);
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     C_DGEMM('N', 'N', aoccA_, nvirA_ * aoccB_ * nvirB_, aoccA_, -1.0, &(wBAA_[foccA_][foccA_]), noccA_, tARBS[0],
             nvirA_ * aoccB_ * nvirB_, 1.0, uARBS[0], nvirA_ * aoccB_ * nvirB_);
@@ -1293,7 +1352,7 @@ void SAPT2p3::inddisp30_ovov() {
     C_DGEMM('N', 'N', aoccA_ * nvirA_ * aoccB_, nvirB_, nvirB_, 1.0, tARBS[0], nvirB_, wASS_[0], nvirB_, 1.0, uARBS[0],
             nvirB_);
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
     free_block(sAR);
     free_block(sBS);
 
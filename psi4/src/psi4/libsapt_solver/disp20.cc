@@ -29,67 +29,84 @@
 #include "sapt0.h"
 #include "sapt2.h"
 
+#include <cmath>
+
 namespace psi {
 namespace sapt {
 /*
  *
- * This dispersion evaluation will work with an arbitrary amount of memory,
- * however, it is not optimal if everything would fit in core.
+ * Denominator-factorized Disp20: with 1/(e_a+e_b-e_r-e_s) = -sum_w dAR_w[ar] dBS_w[bs]
+ * the energy is -4 sum_w sum_PQ X_w[PQ] Y_w[PQ], where X_w = B_AR^T dAR_w B_AR and
+ * Y_w = B_BS^T dBS_w B_BS.  The aux index is blocked on both sides and the
+ * denominator vectors are distributed over the threads, so this is O(N^4) and
+ * works with an arbitrary amount of memory.
  *
- * This exists only for debugging purposes to test the accuracy of Laplace
- * denominators.
+ * Used for SAPT0_DISP20_ALGORITHM DENOMINATOR, and to test the accuracy of the
+ * denominators in debug runs.
  *
  */
 void SAPT0::disp20() {
-    long int avail_mem = mem_ - (long int)ndf_ * ndf_;
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    if (nthreads > nvec_) nthreads = nvec_;
+    int rank = 0;
+
+    long int ovA = (long int)aoccA_ * nvirA_;
+    long int ovB = (long int)aoccB_ * nvirB_;
+
+    // One B block, one C block and a scaled copy of it per thread, plus the per-thread X and Y
+    double lin = (double)(nthreads + 2) * (ovA + ovB);
+    long int length = (long int)((std::sqrt(lin * lin + 8.0 * nthreads * mem_) - lin) / (4.0 * nthreads));
+    if (length > ndf_) length = ndf_;
 
     SAPTDFInts B_p_AR = set_act_C_AR();
     SAPTDFInts B_p_BS = set_act_C_BS();
-    Iterator B_ARBS_iter = get_iterator(avail_mem / 3, &B_p_AR, &B_p_BS);
+    Iterator B_ARBS_iter = set_iterator(length, &B_p_AR, &B_p_BS);
 
     SAPTDFInts C_p_AR = set_act_C_AR();
     SAPTDFInts C_p_BS = set_act_C_BS();
-    Iterator C_ARBS_iter = get_iterator(avail_mem / 3, &C_p_AR, &C_p_BS);
+    Iterator C_ARBS_iter = set_iterator(length, &C_p_AR, &C_p_BS);
 
-    double *xPQ = init_array((long int)B_ARBS_iter.block_size[0] * C_ARBS_iter.block_size[0]);
-    double *yPQ = init_array((long int)B_ARBS_iter.block_size[0] * C_ARBS_iter.block_size[0]);
+    long int B_max = B_ARBS_iter.block_size[0];
+    long int C_max = C_ARBS_iter.block_size[0];
 
-    double **T_p_AR = block_matrix(C_ARBS_iter.block_size[0], aoccA_ * nvirA_);
-    double **T_p_BS = block_matrix(C_ARBS_iter.block_size[0], aoccB_ * nvirB_);
+    double **xPQ = block_matrix(nthreads, B_max * C_max);
+    double **yPQ = block_matrix(nthreads, B_max * C_max);
+    double **T_p_AR = block_matrix(nthreads, C_max * ovA);
+    double **T_p_BS = block_matrix(nthreads, C_max * ovB);
+
+    double e_disp20 = 0.0;
 
-    e_disp20_ = 0.0;
     for (int j = 0; j < B_ARBS_iter.num_blocks; j++) {
         read_block(&B_ARBS_iter, &B_p_AR, &B_p_BS);
 
         for (int k = 0; k < C_ARBS_iter.num_blocks; k++) {
             read_block(&C_ARBS_iter, &C_p_AR, &C_p_BS);
 
-            for (int i = 0; i < nvec_; i++) {
-                C_DCOPY(C_ARBS_iter.block_size[k] * aoccA_ * nvirA_, C_p_AR.B_p_[0], 1, T_p_AR[0], 1);
-                C_DCOPY(C_ARBS_iter.block_size[k] * aoccB_ * nvirB_, C_p_BS.B_p_[0], 1, T_p_BS[0], 1);
-
-#pragma omp parallel
-                {
-#pragma omp for
-                    for (int ar = 0; ar < aoccA_ * nvirA_; ar++) {
-                        double scale = dAR_[i][ar];
-                        C_DSCAL(C_ARBS_iter.curr_size, scale, &(T_p_AR[0][ar]), aoccA_ * nvirA_);
-                    }
+            long int nB = B_ARBS_iter.curr_size;
+            long int nC = C_ARBS_iter.curr_size;
 
-#pragma omp for
-                    for (int bs = 0; bs < aoccB_ * nvirB_; bs++) {
-                        double scale = dBS_[i][bs];
-                        C_DSCAL(C_ARBS_iter.curr_size, scale, &(T_p_BS[0][bs]), aoccB_ * nvirB_);
-                    }
+#pragma omp parallel for num_threads(nthreads) private(rank) schedule(dynamic) reduction(+ : e_disp20)
+            for (int i = 0; i < nvec_; i++) {
+#ifdef _OPENMP
+                rank = omp_get_thread_num();
+#endif
+
+                for (long int Q = 0; Q < nC; Q++) {
+                    double *CA = C_p_AR.B_p_[Q];
+                    double *TA = &(T_p_AR[rank][Q * ovA]);
+                    for (long int ar = 0; ar < ovA; ar++) TA[ar] = dAR_[i][ar] * CA[ar];
+                    double *CB = C_p_BS.B_p_[Q];
+                    double *TB = &(T_p_BS[rank][Q * ovB]);
+                    for (long int bs = 0; bs < ovB; bs++) TB[bs] = dBS_[i][bs] * CB[bs];
                 }
 
-                C_DGEMM('N', 'T', B_ARBS_iter.curr_size, C_ARBS_iter.curr_size, aoccA_ * nvirA_, 2.0, B_p_AR.B_p_[0],
-                        aoccA_ * nvirA_, T_p_AR[0], aoccA_ * nvirA_, 0.0, xPQ, C_ARBS_iter.curr_size);
-
-                C_DGEMM('N', 'T', B_ARBS_iter.curr_size, C_ARBS_iter.curr_size, aoccB_ * nvirB_, 2.0, B_p_BS.B_p_[0],
-                        aoccB_ * nvirB_, T_p_BS[0], aoccB_ * nvirB_, 0.0, yPQ, C_ARBS_iter.curr_size);
+                C_DGEMM('N', 'T', nB, nC, ovA, 2.0, B_p_AR.B_p_[0], ovA, T_p_AR[rank], ovA, 0.0, xPQ[rank], nC);
+                C_DGEMM('N', 'T', nB, nC, ovB, 2.0, B_p_BS.B_p_[0], ovB, T_p_BS[rank], ovB, 0.0, yPQ[rank], nC);
 
-                e_disp20_ -= C_DDOT(B_ARBS_iter.curr_size * C_ARBS_iter.curr_size, xPQ, 1, yPQ, 1);
+                e_disp20 -= C_DDOT(nB * nC, xPQ[rank], 1, yPQ[rank], 1);
             }
         }
         C_p_AR.rewind();
@@ -102,12 +119,13 @@ void SAPT0::disp20() {
     B_p_BS.done();
     C_p_BS.done();
 
-    free(xPQ);
-    free(yPQ);
-
+    free_block(xPQ);
+    free_block(yPQ);
     free_block(T_p_AR);
     free_block(T_p_BS);
 
+    e_disp20_ = e_disp20;
+
     if (print_) {
         outfile->Printf("    Disp20              = %18.12lf [Eh]\n", e_disp20_);
     }
@@ -124,10 +142,7 @@ void SAPT2::disp20() {
     free_block(B_p_AR);
     free_block(B_p_BS);
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     e_disp20_ = 4.0 * C_DDOT((long int)aoccA_ * nvirA_ * aoccB_ * nvirB_, vARBS[0], 1, tARBS[0], 1);
 
@@ -135,7 +150,7 @@ void SAPT2::disp20() {
         outfile->Printf("    Disp20              = %18.12lf [Eh]\n", e_disp20_);
     }
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
     free_block(vARBS);
 
     if (nat_orbs_t3_) {
@@ -255,23 +255,36 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, co
 
     int aoccA = noccA - foccA;
     int aoccB = noccB - foccB;
-
-    double **wARAR = block_matrix(aoccA * nvirA, aoccA * nvirA);
-
-    double **vbsAA = block_matrix(aoccA, aoccA);
-    double **vbsRR = block_matrix(nvirA, nvirA);
+    long int ovA = (long int)aoccA * nvirA;
+
+    // Each thread handles whole bs pairs and carries its own W[AR,AR] and bs intermediates
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    if (nthreads > nvirB) nthreads = nvirB;
+    long int fixed = ovA * ovA + ovA * aoccA * aoccA + (long int)(aoccA * aoccA + ovA + nvirA * nvirA) * (ndf_ + 3) +
+                     (long int)nvirB * (ndf_ + 3);
+    long int per_thread = ovA * ovA + aoccA * aoccA + nvirA * nvirA + ovA + ovA * (ndf_ + 3);
+    while (nthreads > 1 && fixed + nthreads * per_thread > mem_) nthreads--;
+    int rank = 0;
+
+    double **wARAR = block_matrix(nthreads, ovA * ovA);
+
+    double **vbsAA = block_matrix(nthreads, aoccA * aoccA);
+    double **vbsRR = block_matrix(nthreads, nvirA * nvirA);
     double **vARAA = block_matrix(aoccA * nvirA, aoccA * aoccA);
 
     double **tARAR = block_matrix(aoccA * nvirA, aoccA * nvirA);
     psio_->read_entry(ampfile, tlabel, (char *)tARAR[0], sizeof(double) * aoccA * nvirA * aoccA * nvirA);
-    double **tbsAR = block_matrix(aoccA, nvirA);
+    double **tbsAR = block_matrix(nthreads, ovA);
 
     double **B_p_AA = get_DF_ints(AAfile, AAlabel, foccA, noccA, foccA, noccA);
     double **B_p_AR = get_DF_ints(AAfile, ARlabel, foccA, noccA, 0, nvirA);
     double **B_p_RR = get_DF_ints(AAfile, RRlabel, 0, nvirA, 0, nvirA);
-    double *B_p_bs = init_array(ndf_ + 3);
+    double **B_p_bS = block_matrix(nvirB, ndf_ + 3);
 
-    double **C_p_AR = block_matrix(aoccA * nvirA, ndf_ + 3);
+    double **C_p_AR = block_matrix(nthreads, ovA * (ndf_ + 3));
 
     C_DGEMM('N', 'T', aoccA * nvirA, aoccA * aoccA, ndf_ + 3, 1.0, &(B_p_AR[0][0]), ndf_ + 3, &(B_p_AA[0][0]), ndf_ + 3,
             0.0, &(vARAA[0][0]), aoccA * aoccA);
@@ -279,43 +292,51 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, co
     time_t start = time(nullptr);
     time_t stop;
 
-    for (int b = 0, bs = 0; b < aoccB; b++) {
-        for (int s = 0; s < nvirB; s++, bs++) {
-            psio_address next_DF_BS = psio_get_address(
-                PSIO_ZERO, sizeof(double) * (b + foccB) * nvirB * (ndf_ + 3) + sizeof(double) * s * (ndf_ + 3));
-            psio_->read(BBfile, BSlabel, (char *)&(B_p_bs[0]), sizeof(double) * (ndf_ + 3), next_DF_BS, &next_DF_BS);
+    for (int b = 0; b < aoccB; b++) {
+        psio_address next_DF_BS = psio_get_address(PSIO_ZERO, sizeof(double) * (b + foccB) * nvirB * (ndf_ + 3));
+        psio_->read(BBfile, BSlabel, (char *)&(B_p_bS[0][0]), sizeof(double) * nvirB * (ndf_ + 3), next_DF_BS,
+                    &next_DF_BS);
+
+#pragma omp parallel for num_threads(nthreads) private(rank) schedule(dynamic) reduction(+ : energy)
+        for (int s = 0; s < nvirB; s++) {
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            double *B_p_bs = B_p_bS[s];
+            double *tAR = tbsAR[rank];
+            double *W = wARAR[rank];
 
-            C_DGEMV('n', aoccA * nvirA, ndf_ + 3, 1.0, B_p_AR[0], ndf_ + 3, B_p_bs, 1, 0.0, tbsAR[0], 1);
+            C_DGEMV('n', aoccA * nvirA, ndf_ + 3, 1.0, B_p_AR[0], ndf_ + 3, B_p_bs, 1, 0.0, tAR, 1);
 
             for (int a = 0, ar = 0; a < aoccA; a++) {
                 for (int r = 0; r < nvirA; r++, ar++) {
                     double denom = evalsA[a + foccA] + evalsB[b + foccB] - evalsA[r + noccA] - evalsB[s + noccB];
-                    tbsAR[a][r] /= denom;
+                    tAR[ar] /= denom;
                 }
             }
 
-            C_DGEMV('n', aoccA * aoccA, ndf_ + 3, 1.0, B_p_AA[0], ndf_ + 3, B_p_bs, 1, 0.0, vbsAA[0], 1);
-            C_DGEMV('n', nvirA * nvirA, ndf_ + 3, 1.0, B_p_RR[0], ndf_ + 3, B_p_bs, 1, 0.0, vbsRR[0], 1);
+            C_DGEMV('n', aoccA * aoccA, ndf_ + 3, 1.0, B_p_AA[0], ndf_ + 3, B_p_bs, 1, 0.0, vbsAA[rank], 1);
+            C_DGEMV('n', nvirA * nvirA, ndf_ + 3, 1.0, B_p_RR[0], ndf_ + 3, B_p_bs, 1, 0.0, vbsRR[rank], 1);
 
-            C_DGEMM('N', 'N', aoccA * nvirA * aoccA, nvirA, nvirA, 1.0, &(tARAR[0][0]), nvirA, &(vbsRR[0][0]), nvirA,
-                    0.0, &(wARAR[0][0]), nvirA);
-            C_DGEMM('N', 'N', aoccA, nvirA * aoccA * nvirA, aoccA, -1.0, &(vbsAA[0][0]), aoccA, &(tARAR[0][0]),
-                    nvirA * aoccA * nvirA, 1.0, &(wARAR[0][0]), nvirA * aoccA * nvirA);
-            C_DGEMM('N', 'N', aoccA * nvirA * aoccA, nvirA, aoccA, -1.0, &(vARAA[0][0]), aoccA, &(tbsAR[0][0]), nvirA,
-                    1.0, &(wARAR[0][0]), nvirA);
-            C_DGEMM('N', 'N', aoccA, nvirA * (ndf_ + 3), nvirA, 1.0, &(tbsAR[0][0]), nvirA, &(B_p_RR[0][0]),
-                    nvirA * (ndf_ + 3), 0.0, &(C_p_AR[0][0]), nvirA * (ndf_ + 3));
-            C_DGEMM('N', 'T', aoccA * nvirA, aoccA * nvirA, ndf_ + 3, 1.0, &(B_p_AR[0][0]), ndf_ + 3, &(C_p_AR[0][0]),
-                    ndf_ + 3, 1.0, &(wARAR[0][0]), aoccA * nvirA);
+            C_DGEMM('N', 'N', aoccA * nvirA * aoccA, nvirA, nvirA, 1.0, &(tARAR[0][0]), nvirA, vbsRR[rank], nvirA, 0.0,
+                    W, nvirA);
+            C_DGEMM('N', 'N', aoccA, nvirA * aoccA * nvirA, aoccA, -1.0, vbsAA[rank], aoccA, &(tARAR[0][0]),
+                    nvirA * aoccA * nvirA, 1.0, W, nvirA * aoccA * nvirA);
+            C_DGEMM('N', 'N', aoccA * nvirA * aoccA, nvirA, aoccA, -1.0, &(vARAA[0][0]), aoccA, tAR, nvirA, 1.0, W,
+                    nvirA);
+            C_DGEMM('N', 'N', aoccA, nvirA * (ndf_ + 3), nvirA, 1.0, tAR, nvirA, &(B_p_RR[0][0]), nvirA * (ndf_ + 3),
+                    0.0, C_p_AR[rank], nvirA * (ndf_ + 3));
+            C_DGEMM('N', 'T', aoccA * nvirA, aoccA * nvirA, ndf_ + 3, 1.0, &(B_p_AR[0][0]), ndf_ + 3, C_p_AR[rank],
+                    ndf_ + 3, 1.0, W, aoccA * nvirA);
 
             for (int a = 0, ar = 0; a < aoccA; a++) {
                 for (int r = 0; r < nvirA; r++, ar++) {
                     for (int a1 = 0, a1r1 = 0; a1 < aoccA; a1++) {
                         for (int r1 = 0; r1 < nvirA; r1++, a1r1++) {
-                            int a1r = a1 * nvirA + r;
-                            int ar1 = a * nvirA + r1;
-                            double tval1 = wARAR[ar][a1r1] + wARAR[a1r1][ar];
-                            double tval2 = wARAR[a1r][ar1] + wARAR[ar1][a1r];
+                            long int a1r = a1 * nvirA + r;
+                            long int ar1 = a * nvirA + r1;
+                            double tval1 = W[ar * ovA + a1r1] + W[a1r1 * ovA + ar];
+                            double tval2 = W[a1r * ovA + ar1] + W[ar1 * ovA + a1r];
                             double denom = evalsA[a + foccA] + evalsA[a1 + foccA] + evalsB[b + foccB] -
                                            evalsA[r + noccA] - evalsA[r1 + noccA] - evalsB[s + noccB];
                             energy += ((4.0 * tval1 - 2.0 * tval2) * tval1) / denom;
@@ -330,7 +351,7 @@ double SAPT2p::disp220t(int AAfile, const char *AAlabel, const char *ARlabel, co
         }
     }
 
-    free(B_p_bs);
+    free_block(B_p_bS);
     free_block(wARAR);
     free_block(vbsAA);
     free_block(vbsRR);
@@ -353,19 +374,31 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
 
     noccA -= foccA;
     noccB -= foccB;
-
-    double **w_ARAR = block_matrix(noccA * nvirA, noccA * nvirA);
-
-    double **v_bsAA = block_matrix(noccA, noccA);
-    double **v_bsRR = block_matrix(nvirA, nvirA);
+    long int ovA = (long int)noccA * nvirA;
+
+    // Same threading over bs pairs as disp220t
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = Process::environment.get_n_threads();
+#endif
+    if (nthreads > nvirB) nthreads = nvirB;
+    long int fixed = ovA * ovA + ovA * noccA * noccA + (long int)(noccA * noccA + ovA + nvirA * nvirA) * ndf_ +
+                     (long int)nvirB * (ndf_ + 3 + (noccA + foccA) * nvirA);
+    long int per_thread = ovA * ovA + noccA * noccA + nvirA * nvirA + ovA + ovA * ndf_;
+    while (nthreads > 1 && fixed + nthreads * per_thread > mem_) nthreads--;
+    int rank = 0;
+
+    double **w_ARAR = block_matrix(nthreads, ovA * ovA);
+
+    double **v_bsAA = block_matrix(nthreads, noccA * noccA);
+    double **v_bsRR = block_matrix(nthreads, nvirA * nvirA);
     double **v_ARAA = block_matrix(noccA * nvirA, noccA * noccA);
 
     double **B_p_AA = get_DF_ints_nongimp(AAnum, AA_label, foccA, noccA + foccA, foccA, noccA + foccA);
     double **B_p_AR = get_DF_ints_nongimp(Rnum, AR_label, foccA, noccA + foccA, 0, nvirA);
     double **B_p_RR = get_DF_ints_nongimp(Rnum, RR_label, 0, nvirA, 0, nvirA);
-    double *B_p_bs = init_array(ndf_);
 
-    double **t_bsAR = block_matrix(noccA, nvirA);
+    double **t_bsAR = block_matrix(nthreads, ovA);
     double **t_ARAR;
 
     psio_address next_ARAR;
@@ -401,63 +434,88 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
         }
     }
 
-    double **C_p_AR = block_matrix(noccA * nvirA, ndf_);
+    double **C_p_AR = block_matrix(nthreads, ovA * ndf_);
 
     C_DGEMM('N', 'T', noccA * nvirA, noccA * noccA, ndf_, 1.0, &(B_p_AR[0][0]), ndf_, &(B_p_AA[0][0]), ndf_, 0.0,
             &(v_ARAA[0][0]), noccA * noccA);
 
+    // The bS integrals and, when stored, the bS amplitudes are read once per b
+    double **B_p_bS = block_matrix(nvirB, ndf_ + 3);
+    double **t_bSAR = nullptr;
+    if (ampnum == PSIF_SAPT_CCD) {
+        t_bSAR = block_matrix(nvirB, ovA);
+    } else if (ampnum) {
+        t_bSAR = block_matrix(nvirB, (long int)(noccA + foccA) * nvirA);
+    }
+
     psio_address next_BSAR;
 
     time_t start = time(nullptr);
     time_t stop;
 
-    for (int b = 0, bs = 0; b < noccB; b++) {
-        for (int s = 0; s < nvirB; s++, bs++) {
-            psio_address next_DF_BS =
-                psio_get_address(PSIO_ZERO, ((foccB + b) * nvirB + s) * (ndf_ + 3) * (size_t)sizeof(double));
-            psio_->read(BBnum, BS_label, (char *)&(B_p_bs[0]), sizeof(double) * ndf_, next_DF_BS, &next_DF_BS);
+    for (int b = 0; b < noccB; b++) {
+        psio_address next_DF_BS =
+            psio_get_address(PSIO_ZERO, (foccB + b) * nvirB * (ndf_ + 3) * (size_t)sizeof(double));
+        psio_->read(BBnum, BS_label, (char *)&(B_p_bS[0][0]), sizeof(double) * nvirB * (ndf_ + 3), next_DF_BS,
+                    &next_DF_BS);
+
+        if (ampnum == PSIF_SAPT_CCD) {
+            next_BSAR = psio_get_address(PSIO_ZERO, b * nvirB * ovA * sizeof(double));
+            psio_->read(ampnum, tbsar, (char *)t_bSAR[0], sizeof(double) * nvirB * ovA, next_BSAR, &next_BSAR);
+        } else if (ampnum) {
+            next_BSAR =
+                psio_get_address(PSIO_ZERO, (foccB * nvirB + b * nvirB) * (noccA + foccA) * nvirA * sizeof(double));
+            psio_->read(ampnum, tbsar, (char *)t_bSAR[0], sizeof(double) * nvirB * (noccA + foccA) * nvirA,
+                        next_BSAR, &next_BSAR);
+        }
+
+#pragma omp parallel for num_threads(nthreads) private(rank) schedule(dynamic) reduction(+ : energy)
+        for (int s = 0; s < nvirB; s++) {
+#ifdef _OPENMP
+            rank = omp_get_thread_num();
+#endif
+            double *B_p_bs = B_p_bS[s];
+            double *tAR = t_bsAR[rank];
+            double *W = w_ARAR[rank];
 
             if (ampnum == PSIF_SAPT_CCD) {
-                next_BSAR = psio_get_address(PSIO_ZERO, bs * noccA * nvirA * sizeof(double));
-                psio_->read(ampnum, tbsar, (char *)t_bsAR[0], sizeof(double) * noccA * nvirA, next_BSAR, &next_BSAR);
+                C_DCOPY(ovA, t_bSAR[s], 1, tAR, 1);
             } else if (ampnum) {
-                next_BSAR = psio_get_address(
-                    PSIO_ZERO, ((foccB * nvirB + bs) * (noccA + foccA) * nvirA + foccA * nvirA) * sizeof(double));
-                psio_->read(ampnum, tbsar, (char *)t_bsAR[0], sizeof(double) * noccA * nvirA, next_BSAR, &next_BSAR);
+                C_DCOPY(ovA, &(t_bSAR[s][foccA * nvirA]), 1, tAR, 1);
             } else {
-                C_DGEMV('n', noccA * nvirA, ndf_, 1.0, B_p_AR[0], ndf_, B_p_bs, 1, 0.0, t_bsAR[0], 1);
+                C_DGEMV('n', noccA * nvirA, ndf_, 1.0, B_p_AR[0], ndf_, B_p_bs, 1, 0.0, tAR, 1);
 
-                for (int a = 0; a < noccA; a++) {
-                    for (int r = 0; r < nvirA; r++) {
+                for (int a = 0, ar = 0; a < noccA; a++) {
+                    for (int r = 0; r < nvirA; r++, ar++) {
                         double denom = evalsA[a + foccA] + evalsB[b + foccB] - evalsA[r + noccA + foccA] -
                                        evalsB[s + noccB + foccB];
-                        t_bsAR[a][r] /= denom;
+                        tAR[ar] /= denom;
                     }
                 }
             }
 
-            C_DGEMV('n', noccA * noccA, ndf_, 1.0, B_p_AA[0], ndf_, B_p_bs, 1, 0.0, v_bsAA[0], 1);
-            C_DGEMV('n', nvirA * nvirA, ndf_, 1.0, B_p_RR[0], ndf_, B_p_bs, 1, 0.0, v_bsRR[0], 1);
+            C_DGEMV('n', noccA * noccA, ndf_, 1.0, B_p_AA[0], ndf_, B_p_bs, 1, 0.0, v_bsAA[rank], 1);
+            C_DGEMV('n', nvirA * nvirA, ndf_, 1.0, B_p_RR[0], ndf_, B_p_bs, 1, 0.0, v_bsRR[rank], 1);
 
-            C_DGEMM('N', 'N', noccA * nvirA * noccA, nvirA, nvirA, 1.0, &(t_ARAR[0][0]), nvirA, &(v_bsRR[0][0]), nvirA,
-                    0.0, &(w_ARAR[0][0]), nvirA);
-            C_DGEMM('N', 'N', noccA, nvirA * noccA * nvirA, noccA, -1.0, &(v_bsAA[0][0]), noccA, &(t_ARAR[0][0]),
-                    nvirA * noccA * nvirA, 1.0, &(w_ARAR[0][0]), nvirA * noccA * nvirA);
-            C_DGEMM('N', 'N', noccA * nvirA * noccA, nvirA, noccA, -1.0, &(v_ARAA[0][0]), noccA, &(t_bsAR[0][0]), nvirA,
-                    1.0, &(w_ARAR[0][0]), nvirA);
-            C_DGEMM('N', 'N', noccA, nvirA * ndf_, nvirA, 1.0, &(t_bsAR[0][0]), nvirA, &(B_p_RR[0][0]), nvirA * ndf_,
-                    0.0, &(C_p_AR[0][0]), nvirA * ndf_);
-            C_DGEMM('N', 'T', noccA * nvirA, noccA * nvirA, ndf_, 1.0, &(B_p_AR[0][0]), ndf_, &(C_p_AR[0][0]), ndf_,
-                    1.0, &(w_ARAR[0][0]), noccA * nvirA);
+            C_DGEMM('N', 'N', noccA * nvirA * noccA, nvirA, nvirA, 1.0, &(t_ARAR[0][0]), nvirA, v_bsRR[rank], nvirA,
+                    0.0, W, nvirA);
+            C_DGEMM('N', 'N', noccA, nvirA * noccA * nvirA, noccA, -1.0, v_bsAA[rank], noccA, &(t_ARAR[0][0]),
+                    nvirA * noccA * nvirA, 1.0, W, nvirA * noccA * nvirA);
+            C_DGEMM('N', 'N', noccA * nvirA * noccA, nvirA, noccA, -1.0, &(v_ARAA[0][0]), noccA, tAR, nvirA, 1.0, W,
+                    nvirA);
+            C_DGEMM('N', 'N', noccA, nvirA * ndf_, nvirA, 1.0, tAR, nvirA, &(B_p_RR[0][0]), nvirA * ndf_, 0.0,
+                    C_p_AR[rank], nvirA * ndf_);
+            C_DGEMM('N', 'T', noccA * nvirA, noccA * nvirA, ndf_, 1.0, &(B_p_AR[0][0]), ndf_, C_p_AR[rank], ndf_, 1.0,
+                    W, noccA * nvirA);
 
             for (int a = 0, ar = 0; a < noccA; a++) {
                 for (int r = 0; r < nvirA; r++, ar++) {
                     for (int a1 = 0, a1r1 = 0; a1 < noccA; a1++) {
                         for (int r1 = 0; r1 < nvirA; r1++, a1r1++) {
-                            int a1r = a1 * nvirA + r;
-                            int ar1 = a * nvirA + r1;
-                            double tval1 = w_ARAR[ar][a1r1] + w_ARAR[a1r1][ar];
-                            double tval2 = w_ARAR[a1r][ar1] + w_ARAR[ar1][a1r];
+                            long int a1r = a1 * nvirA + r;
+                            long int ar1 = a * nvirA + r1;
+                            double tval1 = W[ar * ovA + a1r1] + W[a1r1 * ovA + ar];
+                            double tval2 = W[a1r * ovA + ar1] + W[ar1 * ovA + a1r];
                             double denom = evalsA[a + foccA] + evalsA[a1 + foccA] + evalsB[b + foccB] -
                                            evalsA[r + noccA + foccA] - evalsA[r1 + noccA + foccA] -
                                            evalsB[s + noccB + foccB];
@@ -471,7 +529,8 @@ double SAPT2p::disp220tccd(int AAnum, const char *AA_label, int Rnum, const char
         outfile->Printf("    (i = %3d of %3d) %10ld seconds\n", b + 1, noccB, stop - start);
     }
 
-    free(B_p_bs);
+    free_block(B_p_bS);
+    if (t_bSAR != nullptr) free_block(t_bSAR);
     free_block(w_ARAR);
     free_block(v_bsAA);
     free_block(v_bsRR);
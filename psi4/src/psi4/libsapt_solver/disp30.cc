@@ -70,9 +70,7 @@ double SAPT2p3::disp30_1(int ampfile, const char *amplabel, int AAintfile, const
     int aoccA = noccA - foccA;
     int aoccB = noccB - foccB;
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
     double **tRSAB = block_matrix(nvirA * nvirB, aoccA * aoccB);
 
     for (int a = 0, ar = 0; a < aoccA; a++) {
@@ -88,7 +86,7 @@ double SAPT2p3::disp30_1(int ampfile, const char *amplabel, int AAintfile, const
         }
     }
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
 
     double energy = 0.0;
 
@@ -152,9 +150,7 @@ double SAPT2p3::disp30_2(int ampfile, const char *amplabel, int AAintfile, const
     int aoccA = noccA - foccA;
     int aoccB = noccB - foccB;
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
     double **tABRS = block_matrix(aoccA * aoccB, nvirA * nvirB);
 
     for (int a = 0, ar = 0; a < aoccA; a++) {
@@ -169,7 +165,7 @@ double SAPT2p3::disp30_2(int ampfile, const char *amplabel, int AAintfile, const
         }
     }
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
 
     double **t2ABRS = block_matrix(aoccA * aoccB, nvirA * nvirB);
 
@@ -217,7 +217,11 @@ void SAPT0::exch_disp20_n5() {
     free_block(Q_BR);
     free_block(Q_AS);
 
-    e_disp20_ = e_disp20;
+    if (denom_disp20_) {
+        if (debug_) outfile->Printf("    Disp20 (canonical)  = %18.12lf [Eh]\n", e_disp20);
+    } else {
+        e_disp20_ = e_disp20;
+    }
     e_disp20_os_ = 0.5 * e_disp20_;
     e_disp20_ss_ = 0.5 * e_disp20_;
     e_exch_disp20_ = -2.0 * (v_1 + q_12);
@@ -1906,10 +1910,7 @@ void SAPT2::exch_disp20() {
         }
     }
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     e_exch_disp20_ = 0.0;
 
@@ -1920,7 +1921,7 @@ void SAPT2::exch_disp20() {
         }
     }
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
     free_block(B_p_AA);
     free_block(B_p_BB);
     free_block(B_p_AB);
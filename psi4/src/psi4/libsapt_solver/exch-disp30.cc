@@ -328,9 +328,7 @@ double SAPT2p3::exch_disp30_02() {
 double SAPT2p3::exch_disp30_22() {
     double energy = 0.0;
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
@@ -450,7 +448,7 @@ double SAPT2p3::exch_disp30_22() {
         }
     }
 
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
 
     double **vABRS = block_matrix(aoccA_ * aoccB_, nvirA_ * nvirB_);
 
@@ -112,9 +112,7 @@ void SAPT2p3::exch_ind_disp30() {
 double SAPT2p3::exch_ind_disp30_21(double **sAR) {
     double energy = 0.0;
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
@@ -533,7 +531,7 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
     free_block(xAB);
     free_block(xBS);
     free_block(B_p_AR);
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
 
     return (2.0 * energy);
 }
@@ -541,9 +539,7 @@ double SAPT2p3::exch_ind_disp30_21(double **sAR) {
 double SAPT2p3::exch_ind_disp30_12(double **sBS) {
     double energy = 0.0;
 
-    double **tARBS = block_matrix(aoccA_ * nvirA_, aoccB_ * nvirB_);
-    psio_->read_entry(PSIF_SAPT_AMPS, "tARBS Amplitudes", (char *)tARBS[0],
-                      sizeof(double) * aoccA_ * nvirA_ * aoccB_ * nvirB_);
+    double **tARBS = get_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
 
     double **tAS_RB = block_matrix(nvirA_, aoccB_);
     double **tRB_AS = block_matrix(aoccA_, nvirB_);
@@ -967,7 +963,7 @@ double SAPT2p3::exch_ind_disp30_12(double **sBS) {
     free_block(xAB);
     free_block(xBS);
     free_block(B_p_BS);
-    free_block(tARBS);
+    release_amplitudes("tARBS Amplitudes", tARBS);
 
     return (2.0 * energy);
 }
@@ -481,5 +481,148 @@ SharedMatrix FDDS_Dispersion::form_unc_amplitude(std::string monomer, double ome
 
     return ret;
 }
+SharedMatrix FDDS_Dispersion::form_aux_compression(std::string monomer, double cutoff) {
+    // ==> Configuration <==
+    SharedVector eps_occ, eps_vir;
+    std::string ovQ_tensor_name;
+
+    if (monomer == "A") {
+        eps_occ = vector_cache_["eps_occ_A"];
+        eps_vir = vector_cache_["eps_vir_A"];
+        ovQ_tensor_name = "iaQ";
+    } else if (monomer == "B") {
+        eps_occ = vector_cache_["eps_occ_B"];
+        eps_vir = vector_cache_["eps_vir_B"];
+        ovQ_tensor_name = "jbQ";
+    } else {
+        throw PSIEXCEPTION("FDDS_Dispersion::form_aux_compression: Monomer must be A or B!");
+    }
+
+    // Sizes
+    size_t nocc = eps_occ->dim(0);
+    size_t nvir = eps_vir->dim(0);
+    size_t naux = auxiliary_->nbf();
+
+    // Check on memory real quick, the compressed tensor is at most nocc * nvir * naux
+    size_t doubles = Process::environment.get_memory() * 0.8 / sizeof(double);
+    size_t mem_size = naux * nvir + 2 * naux * naux + nocc * nvir * std::min(naux, nocc * nvir);
+    if (mem_size > doubles) {
+        std::stringstream message;
+        double mem_gb = ((double)(mem_size) / 0.8 * sizeof(double)) / 1.e9;
+        message << "FDDS Dispersion compression requires at least naux * nocc * nvir of memory." << std::endl;
+        message << "       After taxes this is " << std::setprecision(2) << mem_gb << " GB of memory.";
+        throw PSIEXCEPTION(message.str());
+    }
+
+    size_t dmem = doubles - 2 * naux * naux - nocc * nvir * std::min(naux, nocc * nvir);
+    size_t bsize = dmem / (naux * nvir);
+    if (bsize > nocc) {
+        bsize = nocc;
+    }
+
+    auto tmp = std::make_shared<Matrix>("iaQ tmp", bsize * nvir, naux);
+    double** tmpp = tmp->pointer();
+
+    // ==> Gram matrix (Q|ia)(ia|P) <==
+    auto gram = std::make_shared<Matrix>("Gram", naux, naux);
+    double** gramp = gram->pointer();
+
+    for (size_t bcount = 0; bcount < nocc; bcount += bsize) {
+        size_t osize = std::min(bsize, nocc - bcount);
+        dfh_->fill_tensor(ovQ_tensor_name, tmp, {bcount, bcount + osize});
+        C_DGEMM('T', 'N', naux, naux, osize * nvir, 1.0, tmpp[0], naux, tmpp[0], naux, 1.0, gramp[0], naux);
+    }
+
+    // ==> Truncated eigenbasis <==
+    auto evecs = std::make_shared<Matrix>("Gram eigenvectors", naux, naux);
+    auto evals = std::make_shared<Vector>("Gram eigenvalues", naux);
+    gram->diagonalize(evecs, evals, descending);
+    gram.reset();
+
+    double thresh = std::max(cutoff, 1.e-14) * evals->get(0);
+    size_t nkeep = 0;
+    while (nkeep < naux && evals->get(nkeep) > thresh) nkeep++;
+
+    auto U = std::make_shared<Matrix>("Aux compression " + monomer, naux, nkeep);
+    double** Up = U->pointer();
+    double** evecsp = evecs->pointer();
+    for (size_t Q = 0; Q < naux; Q++) {
+        for (size_t k = 0; k < nkeep; k++) {
+            Up[Q][k] = evecsp[Q][k];
+        }
+    }
+    evecs.reset();
+
+    outfile->Printf("   Monomer %s aux compression: %zu of %zu functions kept\n", monomer.c_str(), nkeep, naux);
+
+    // ==> Compressed tensor (ia|k) <==
+    auto Bc = std::make_shared<Matrix>("iak " + monomer, nocc * nvir, nkeep);
+    double** Bcp = Bc->pointer();
+
+    for (size_t bcount = 0; bcount < nocc; bcount += bsize) {
+        size_t osize = std::min(bsize, nocc - bcount);
+        dfh_->fill_tensor(ovQ_tensor_name, tmp, {bcount, bcount + osize});
+        C_DGEMM('N', 'N', osize * nvir, nkeep, naux, 1.0, tmpp[0], naux, Up[0], nkeep, 0.0, Bcp[bcount * nvir],
+                nkeep);
+    }
+
+    matrix_cache_["Bc_" + monomer] = Bc;
+    matrix_cache_["U_" + monomer] = U;
+
+    return U;
+}
+SharedMatrix FDDS_Dispersion::form_unc_amplitude_lr(std::string monomer, double omega) {
+    // ==> Configuration <==
+    SharedVector eps_occ, eps_vir;
+
+    if (monomer == "A") {
+        eps_occ = vector_cache_["eps_occ_A"];
+        eps_vir = vector_cache_["eps_vir_A"];
+    } else if (monomer == "B") {
+        eps_occ = vector_cache_["eps_occ_B"];
+        eps_vir = vector_cache_["eps_vir_B"];
+    } else {
+        throw PSIEXCEPTION("FDDS_Dispersion::form_unc_amplitude_lr: Monomer must be A or B!");
+    }
+
+    if (matrix_cache_.find("Bc_" + monomer) == matrix_cache_.end()) {
+        throw PSIEXCEPTION("FDDS_Dispersion::form_unc_amplitude_lr: Call form_aux_compression first!");
+    }
+
+    SharedMatrix Bc = matrix_cache_["Bc_" + monomer];
+    double** Bcp = Bc->pointer();
+
+    // Sizes
+    size_t nocc = eps_occ->dim(0);
+    size_t nvir = eps_vir->dim(0);
+    size_t nkeep = Bc->colspi()[0];
+
+    double* eoccp = eps_occ->pointer();
+    double* evirp = eps_vir->pointer();
+
+    // ==> Scaled tensor (ia|k) * Eia^(1/2) <==
+    auto tmp = std::make_shared<Matrix>("iak tmp", nocc * nvir, nkeep);
+    double** tmpp = tmp->pointer();
+
+#pragma omp parallel for collapse(2)
+    for (size_t i = 0; i < nocc; i++) {
+        for (size_t a = 0; a < nvir; a++) {
+            double val = -1.0 * (eoccp[i] - evirp[a]);
+            double amp = 4.0 * val / (val * val + omega * omega);
+            amp = (amp < 1.e-14 ? 0.0 : std::pow(amp, 0.5));
+            size_t ia = i * nvir + a;
+#pragma omp simd
+            for (size_t k = 0; k < nkeep; k++) {
+                tmpp[ia][k] = amp * Bcp[ia][k];
+            }
+        }
+    }
+
+    // ==> Contract <==
+    auto ret = std::make_shared<Matrix>("UNC Amplitude (compressed)", nkeep, nkeep);
+    ret->gemm(true, false, 1.0, tmp, tmp, 0.0);
+
+    return ret;
+}
 }
 }  // End namespace
@@ -88,6 +88,23 @@ class FDDS_Dispersion {
      */
     SharedMatrix form_unc_amplitude(std::string monomer, double omega);
 
+    /**
+     * Compresses the auxiliary space of a monomer: diagonalizes (Q|ia)(ia|P) once, keeps the
+     * eigenvectors U above cutoff * largest eigenvalue, and stores (ia|k) = (ia|Q) U_Qk
+     * @param  monomer Monomer "A" or "B"
+     * @param  cutoff  Relative eigenvalue cutoff, zero keeps the full numerical rank
+     * @return         "Qk" compression basis U
+     */
+    SharedMatrix form_aux_compression(std::string monomer, double cutoff);
+
+    /**
+     * Forms the uncoupled amplitude in the compressed space of form_aux_compression, kia,Eia,lia->kl
+     * @param  monomer Monomer "A" or "B"
+     * @param  omega   Time dependent value
+     * @return         "kl" amplitude tensor
+     */
+    SharedMatrix form_unc_amplitude_lr(std::string monomer, double omega);
+
     /**
      * Returns the metric matrix
      * @return Metric
@@ -34,7 +34,7 @@ PRAGMA_WARNING_PUSH
 PRAGMA_WARNING_IGNORE_DEPRECATED_DECLARATIONS
 #include <memory>
 PRAGMA_WARNING_POP
-#include "psi4/libpsio/aiohandler.h"
+#include "psi4/libpsio/prefetch.h"
 
 #include <cmath>
 
@@ -539,14 +539,9 @@ void SAPT0::ind20rA_B_aio() {
     int num_blocks = ndf_ / block_length;
     if (ndf_ % block_length) num_blocks++;
 
-    auto aio = std::make_shared<AIOHandler>(psio_);
-
     double **C_p_AA[2];
     double **C_p_RR[2];
 
-    psio_address next_C_p_AA;
-    psio_address next_C_p_RR;
-
     do {
         memset(&(Ax[0]), '\0', sizeof(double) * noccA_ * nvirA_);
         memset(&(tAR_dump[0][0]), '\0', sizeof(double) * nthreads * noccA_ * nvirA_);
@@ -585,23 +580,29 @@ void SAPT0::ind20rA_B_aio() {
         C_p_RR[0] = block_matrix(block_length, nvirA_ * (nvirA_ + 1) / 2);
         C_p_RR[1] = block_matrix(block_length, nvirA_ * (nvirA_ + 1) / 2);
 
-        next_C_p_AA = PSIO_ZERO;
-        next_C_p_RR = PSIO_ZERO;
-
-        psio_->read(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(C_p_AA[0][0][0]),
-                    sizeof(double) * block_length * noccA_ * noccA_, next_C_p_AA, &next_C_p_AA);
-        psio_->read(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(C_p_RR[0][0][0]),
-                    sizeof(double) * block_length * nvirA_ * (nvirA_ + 1) / 2, next_C_p_RR, &next_C_p_RR);
+        // The DF file is still open for writing, so the prefetcher shares our handle
+        BlockPrefetcher prefetch(psio_, PSIF_SAPT_AA_DF_INTS, true);
+
+        auto post_block = [&](int i) {
+            size_t start = (size_t)i * block_length;
+            size_t length = (i == num_blocks - 1 && ndf_ % block_length ? ndf_ % block_length : block_length);
+            size_t nOO = (size_t)noccA_ * noccA_;
+            size_t nVV = (size_t)nvirA_ * (nvirA_ + 1) / 2;
+            double *OO = C_p_AA[i % 2][0];
+            double *VV = C_p_RR[i % 2][0];
+            prefetch.post([=](std::shared_ptr<PSIO> psio) {
+                psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * start * nOO);
+                psio->read(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)OO, sizeof(double) * length * nOO, addr, &addr);
+                addr = psio_get_address(PSIO_ZERO, sizeof(double) * start * nVV);
+                psio->read(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)VV, sizeof(double) * length * nVV, addr, &addr);
+                return length * (nOO + nVV);
+            });
+        };
+        post_block(0);
 
         for (int i = 0; i < num_blocks; i++) {
-            if (i < num_blocks - 1) {
-                int read_length = block_length;
-                if (i == num_blocks - 2 && ndf_ % block_length) read_length = ndf_ % block_length;
-                aio->read(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", (char *)&(C_p_AA[(i + 1) % 2][0][0]),
-                          sizeof(double) * read_length * noccA_ * noccA_, next_C_p_AA, &next_C_p_AA);
-                aio->read(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", (char *)&(C_p_RR[(i + 1) % 2][0][0]),
-                          sizeof(double) * read_length * nvirA_ * (nvirA_ + 1) / 2, next_C_p_RR, &next_C_p_RR);
-            }
+            prefetch.wait();
+            if (i < num_blocks - 1) post_block(i + 1);
 
             int loopsize = block_length;
             if (i == num_blocks - 1 && ndf_ % block_length) loopsize = ndf_ % block_length;
@@ -627,8 +628,6 @@ void SAPT0::ind20rA_B_aio() {
                             1.0, tAR_dump[rank], nvirA_);
                 }
             }
-
-            if (i < num_blocks - 1) aio->synchronize();
         }
 
         free_block(C_p_AA[0]);
@@ -764,14 +763,9 @@ void SAPT0::ind20rB_A_aio() {
     int num_blocks = ndf_ / block_length;
     if (ndf_ % block_length) num_blocks++;
 
-    auto aio = std::make_shared<AIOHandler>(psio_);
-
     double **C_p_BB[2];
     double **C_p_SS[2];
 
-    psio_address next_C_p_BB;
-    psio_address next_C_p_SS;
-
     do {
         memset(&(Ax[0]), '\0', sizeof(double) * noccB_ * nvirB_);
         memset(&(tBS_dump[0][0]), '\0', sizeof(double) * nthreads * noccB_ * nvirB_);
@@ -810,23 +804,29 @@ void SAPT0::ind20rB_A_aio() {
         C_p_SS[0] = block_matrix(block_length, nvirB_ * (nvirB_ + 1) / 2);
         C_p_SS[1] = block_matrix(block_length, nvirB_ * (nvirB_ + 1) / 2);
 
-        next_C_p_BB = PSIO_ZERO;
-        next_C_p_SS = PSIO_ZERO;
-
-        psio_->read(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(C_p_BB[0][0][0]),
-                    sizeof(double) * block_length * noccB_ * noccB_, next_C_p_BB, &next_C_p_BB);
-        psio_->read(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(C_p_SS[0][0][0]),
-                    sizeof(double) * block_length * nvirB_ * (nvirB_ + 1) / 2, next_C_p_SS, &next_C_p_SS);
+        // The DF file is still open for writing, so the prefetcher shares our handle
+        BlockPrefetcher prefetch(psio_, PSIF_SAPT_BB_DF_INTS, true);
+
+        auto post_block = [&](int i) {
+            size_t start = (size_t)i * block_length;
+            size_t length = (i == num_blocks - 1 && ndf_ % block_length ? ndf_ % block_length : block_length);
+            size_t nOO = (size_t)noccB_ * noccB_;
+            size_t nVV = (size_t)nvirB_ * (nvirB_ + 1) / 2;
+            double *OO = C_p_BB[i % 2][0];
+            double *VV = C_p_SS[i % 2][0];
+            prefetch.post([=](std::shared_ptr<PSIO> psio) {
+                psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * start * nOO);
+                psio->read(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)OO, sizeof(double) * length * nOO, addr, &addr);
+                addr = psio_get_address(PSIO_ZERO, sizeof(double) * start * nVV);
+                psio->read(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)VV, sizeof(double) * length * nVV, addr, &addr);
+                return length * (nOO + nVV);
+            });
+        };
+        post_block(0);
 
         for (int i = 0; i < num_blocks; i++) {
-            if (i < num_blocks - 1) {
-                int read_length = block_length;
-                if (i == num_blocks - 2 && ndf_ % block_length) read_length = ndf_ % block_length;
-                aio->read(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", (char *)&(C_p_BB[(i + 1) % 2][0][0]),
-                          sizeof(double) * read_length * noccB_ * noccB_, next_C_p_BB, &next_C_p_BB);
-                aio->read(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", (char *)&(C_p_SS[(i + 1) % 2][0][0]),
-                          sizeof(double) * read_length * nvirB_ * (nvirB_ + 1) / 2, next_C_p_SS, &next_C_p_SS);
-            }
+            prefetch.wait();
+            if (i < num_blocks - 1) post_block(i + 1);
 
             int loopsize = block_length;
             if (i == num_blocks - 1 && ndf_ % block_length) loopsize = ndf_ % block_length;
@@ -852,8 +852,6 @@ void SAPT0::ind20rB_A_aio() {
                             1.0, tBS_dump[rank], nvirB_);
                 }
             }
-
-            if (i < num_blocks - 1) aio->synchronize();
         }
 
         free_block(C_p_BB[0]);
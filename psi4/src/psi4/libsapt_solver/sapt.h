@@ -42,6 +42,10 @@
 
 #define INDEX(i, j) ((i >= j) ? (ioff_[i] + j) : (ioff_[j] + i))
 
+#include <chrono>
+#include <string>
+#include <vector>
+
 #include "psi4/libpsio/psio.h"
 #include "psi4/libpsio/psio.hpp"
 #include "psi4/libpsio/aiohandler.h"
@@ -118,6 +122,29 @@ class SAPT : public Wavefunction {
 
     void zero_disk(int, const char *, int, int);
 
+    /// Cost of one SAPT term, see term_start() and term_stop()
+    struct TermCost {
+        std::string label;
+        double wall;
+        double flops;
+        double peak_mem;
+        size_t bytes_read;
+        size_t bytes_written;
+    };
+    std::vector<TermCost> term_costs_;
+    std::chrono::steady_clock::time_point term_t0_;
+    size_t term_read0_;
+    size_t term_written0_;
+
+    /// timer_on(label), and snapshot the clock and the PSIO byte counters
+    void term_start(const char *label);
+    /// timer_off(label), and record the wall time, FLOP estimate, memory high-water mark and I/O of the term
+    void term_stop(const char *label);
+    /// Leading-order FLOP count of a term from the orbital and auxiliary dimensions, 0 if there is no estimate
+    double term_flops(const std::string &label) const;
+    /// Store the recorded costs as "SAPT COST <TERM> ..." variables, here and in the global environment
+    void export_term_costs();
+
    public:
     SAPT(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefunction MonomerB, Options &options,
          std::shared_ptr<PSIO> psio);
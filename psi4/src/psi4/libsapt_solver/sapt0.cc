@@ -77,11 +77,16 @@ SAPT0::SAPT0(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefu
 
     wBAR_ = nullptr;
     wABS_ = nullptr;
+
+    df_store_frac_ = options_.get_double("SAPT0_DF_STORE");
+    denom_disp20_ = (options_.get_str("SAPT0_DISP20_ALGORITHM") == "DENOMINATOR");
+    df_store_size_ = 0L;
 }
 
 SAPT0::~SAPT0() {
     if (wBAR_ != nullptr) free_block(wBAR_);
     if (wABS_ != nullptr) free_block(wABS_);
+    clear_df_store();
     psio_->close(PSIF_SAPT_AA_DF_INTS, 1);
     psio_->close(PSIF_SAPT_BB_DF_INTS, 1);
     psio_->close(PSIF_SAPT_AB_DF_INTS, 1);
@@ -96,49 +101,54 @@ double SAPT0::compute_energy() {
     psio_->open(PSIF_SAPT_BB_DF_INTS, PSIO_OPEN_NEW);
     psio_->open(PSIF_SAPT_AB_DF_INTS, PSIO_OPEN_NEW);
 
-    timer_on("DF Integrals       ");
+    term_start("DF Integrals       ");
     if (aio_dfints_)
         df_integrals_aio();
     else
         df_integrals();
-    timer_off("DF Integrals       ");
-    timer_on("W Integrals        ");
+    term_stop("DF Integrals       ");
+    term_start("W Integrals        ");
     w_integrals();
-    timer_off("W Integrals        ");
+    term_stop("W Integrals        ");
     if (!elst_basis_) {
         if (do_e10_) {
-            timer_on("Elst10             ");
+            term_start("Elst10             ");
             elst10();
-            timer_off("Elst10             ");
-            timer_on("Exch10             ");
+            term_stop("Elst10             ");
+            term_start("Exch10             ");
             exch10();
-            timer_off("Exch10             ");
-            timer_on("Exch10 S^2         ");
+            term_stop("Exch10             ");
+            term_start("Exch10 S^2         ");
             exch10_s2();
-            timer_off("Exch10 S^2         ");
+            term_stop("Exch10 S^2         ");
         }
     }
     if (do_e20ind_) {
-        timer_on("Ind20              ");
+        term_start("Ind20              ");
         if (debug_ || no_response_) ind20();
         if (!no_response_) ind20r();
-        timer_off("Ind20              ");
-        timer_on("Exch-Ind20         ");
+        term_stop("Ind20              ");
+        term_start("Exch-Ind20         ");
         exch_ind20A_B();
         exch_ind20B_A();
-        timer_off("Exch-Ind20         ");
+        term_stop("Exch-Ind20         ");
     }
     if (do_e20disp_) {
-        if (debug_) disp20();
-        timer_on("Exch-Disp20 N^5    ");
+        if (debug_ || denom_disp20_) {
+            term_start("Disp20             ");
+            disp20();
+            term_stop("Disp20             ");
+        }
+        term_start("Exch-Disp20 N^5    ");
         psio_->open(PSIF_SAPT_TEMP, PSIO_OPEN_NEW);
         exch_disp20_n5();
-        timer_off("Exch-Disp20 N^5    ");
-        timer_on("Exch-Disp20 N^4    ");
+        term_stop("Exch-Disp20 N^5    ");
+        term_start("Exch-Disp20 N^4    ");
         exch_disp20_n4();
         psio_->close(PSIF_SAPT_TEMP, 0);
-        timer_off("Exch-Disp20 N^4    ");
+        term_stop("Exch-Disp20 N^4    ");
     }
+    clear_df_store();
 
     if (!options_.get_bool("SAPT_QUIET")) {
         print_results();
@@ -158,6 +168,8 @@ double SAPT0::compute_energy() {
     set_variable("E SAPT0", e_sapt0_);
     set_variable("E SCS-SAPT0", e_sapt0_scs_);
 
+    export_term_costs();
+
     return (e_sapt0_);
 }
 
@@ -373,18 +385,18 @@ void SAPT0::first_order_terms() {
     psio_->open(PSIF_SAPT_BB_DF_INTS, PSIO_OPEN_NEW);
     psio_->open(PSIF_SAPT_AB_DF_INTS, PSIO_OPEN_NEW);
 
-    timer_on("OO DF Integrals    ");
+    term_start("OO DF Integrals    ");
     oo_df_integrals();
-    timer_off("OO DF Integrals    ");
-    timer_on("Elst10             ");
+    term_stop("OO DF Integrals    ");
+    term_start("Elst10             ");
     elst10();
-    timer_off("Elst10             ");
-    timer_on("Exch10             ");
+    term_stop("Elst10             ");
+    term_start("Exch10             ");
     exch10();
-    timer_off("Exch10             ");
-    timer_on("Exch10 S^2         ");
+    term_stop("Exch10             ");
+    term_start("Exch10 S^2         ");
     exch10_s2();
-    timer_off("Exch10 S^2         ");
+    term_stop("Exch10 S^2         ");
 
     psio_->close(PSIF_SAPT_AA_DF_INTS, 1);
     psio_->close(PSIF_SAPT_BB_DF_INTS, 1);
@@ -670,6 +682,8 @@ void SAPT0::df_integrals() {
     free_block(AO_RI);
     free_block(J_AO_RI);
 
+    init_df_store();
+
     avail_mem = mem_;
     long int indices = nsotri_screened + noccA_ * noccA_ + noccA_ * nvirA_ + nvirA_ * (nvirA_ + 1) / 2 +
                        noccB_ * noccB_ + noccB_ * nvirB_ + nvirB_ * (nvirB_ + 1) / 2 + noccB_ * noccB_ +
@@ -836,6 +850,16 @@ void SAPT0::df_integrals() {
                      sizeof(double) * length * noccA_ * nvirB_, next_DF_AS, &next_DF_AS);
         psio_->write(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", (char *)&(B_p_RB[0][0]),
                      sizeof(double) * length * nvirA_ * noccB_, next_DF_RB, &next_DF_RB);
+
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", B_p_AA, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", B_p_AR, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", B_p_RR, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", B_p_BB, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", B_p_BS, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", B_p_SS, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", B_p_AB, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", B_p_AS, Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", B_p_RB, Pbl * max_size, length);
     }
 
     free_block(B_p_munu);
@@ -1148,6 +1172,8 @@ void SAPT0::df_integrals_aio() {
     free_block(AO_RI[1]);
     free_block(J_AO_RI[1]);
 
+    init_df_store();
+
     avail_mem = mem_;
     long int indices = nsotri_screened + noccA_ * noccA_ + noccA_ * nvirA_ + nvirA_ * (nvirA_ + 1) / 2 +
                        noccB_ * noccB_ + noccB_ * nvirB_ + nvirB_ * (nvirB_ + 1) / 2 + noccB_ * noccB_ +
@@ -1345,6 +1371,16 @@ void SAPT0::df_integrals_aio() {
                    sizeof(double) * length * noccA_ * nvirB_, next_DF_AS, &next_DF_AS);
         aio->write(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", (char *)&(B_p_RB[Pbl % 2][0][0]),
                    sizeof(double) * length * nvirA_ * noccB_, next_DF_RB, &next_DF_RB);
+
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "AA RI Integrals", B_p_AA[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "AR RI Integrals", B_p_AR[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AA_DF_INTS, "RR RI Integrals", B_p_RR[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "BB RI Integrals", B_p_BB[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "BS RI Integrals", B_p_BS[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_BB_DF_INTS, "SS RI Integrals", B_p_SS[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "AB RI Integrals", B_p_AB[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "AS RI Integrals", B_p_AS[Pbl % 2], Pbl * max_size, length);
+        store_df_block(PSIF_SAPT_AB_DF_INTS, "RB RI Integrals", B_p_RB[Pbl % 2], Pbl * max_size, length);
     }
 
     aio->synchronize();
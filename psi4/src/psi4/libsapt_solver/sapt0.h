@@ -31,6 +31,10 @@
 
 #include "sapt.h"
 
+#include <map>
+#include <string>
+#include <utility>
+
 namespace psi {
 namespace sapt {
 
@@ -94,6 +98,12 @@ class SAPT0 : public SAPT {
     void read_block(Iterator *, SAPTDFInts *);
     void read_block(Iterator *, SAPTDFInts *, SAPTDFInts *);
 
+    void init_df_store();
+    void clear_df_store();
+    void store_df_block(int, const char *, double **, long int, long int);
+    double **df_store_tensor(SAPTDFInts *);
+    void read_df_store(SAPTDFInts *, double **, long int);
+
     void ind20rA_B();
     void ind20rB_A();
     void ind20rA_B_aio();
@@ -125,6 +135,7 @@ class SAPT0 : public SAPT {
 
    protected:
     bool no_response_;
+    bool denom_disp20_;
     bool aio_cphf_;
     bool aio_dfints_;
     bool do_e10_;
@@ -154,6 +165,11 @@ class SAPT0 : public SAPT {
     double **wBAR_;
     double **wABS_;
 
+    // In-core copies of the DF integrals keyed by (file, label); each entry is (row length, ndf_ rows)
+    std::map<std::pair<int, std::string>, std::pair<long int, double **> > df_store_;
+    double df_store_frac_;
+    long int df_store_size_;
+
    public:
     SAPT0(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefunction MonomerB, Options &options,
           std::shared_ptr<PSIO> psio);
@@ -191,9 +207,11 @@ struct SAPTDFInts {
     const char *label_;
 
     psio_address next_DF_;
+    long int next_row_;
 
     SAPTDFInts() {
         next_DF_ = PSIO_ZERO;
+        next_row_ = 0;
         B_p_ = nullptr;
         B_d_ = nullptr;
     };
@@ -201,11 +219,15 @@ struct SAPTDFInts {
         if (B_p_ != nullptr) free_block(B_p_);
         if (B_d_ != nullptr) free_block(B_d_);
     };
-    void rewind() { next_DF_ = PSIO_ZERO; };
+    void rewind() {
+        next_DF_ = PSIO_ZERO;
+        next_row_ = 0;
+    };
     void clear() {
         free_block(B_p_);
         B_p_ = nullptr;
         next_DF_ = PSIO_ZERO;
+        next_row_ = 0;
     };
     void done() {
         free_block(B_p_);
@@ -53,7 +53,8 @@ SAPT2::SAPT2(SharedWavefunction Dimer, SharedWavefunction MonomerA, SharedWavefu
       e_no_disp20_(0.0),
       e_exch_disp20_(0.0),
       e_sapt0_(0.0),
-      e_sapt2_(0.0) {
+      e_sapt2_(0.0),
+      amp_registry_mem_(0L) {
     psio_->open(PSIF_SAPT_AA_DF_INTS, PSIO_OPEN_NEW);
     psio_->open(PSIF_SAPT_BB_DF_INTS, PSIO_OPEN_NEW);
     psio_->open(PSIF_SAPT_AB_DF_INTS, PSIO_OPEN_NEW);
@@ -113,6 +114,8 @@ SAPT2::~SAPT2() {
         if (no_CB_ != nullptr) free_block(no_CB_);
     }
 
+    for (auto &entry : amp_registry_) free_block(entry.second.block);
+
     free(ioff_);
     free(index2i_);
     free(index2j_);
@@ -126,51 +129,55 @@ SAPT2::~SAPT2() {
 double SAPT2::compute_energy() {
     print_header();
 
-    timer_on("DF Integrals       ");
+    term_start("DF Integrals       ");
     df_integrals();
-    timer_off("DF Integrals       ");
-    timer_on("Omega Integrals    ");
+    term_stop("DF Integrals       ");
+    term_start("Omega Integrals    ");
     w_integrals();
-    timer_off("Omega Integrals    ");
-    timer_on("Amplitudes         ");
+    term_stop("Omega Integrals    ");
+    term_start("Amplitudes         ");
     amplitudes();
-    timer_off("Amplitudes         ");
-    timer_on("Elst10             ");
+    term_stop("Amplitudes         ");
+    term_start("Elst10             ");
     elst10();
-    timer_off("Elst10             ");
-    timer_on("Exch10 S^2         ");
+    term_stop("Elst10             ");
+    term_start("Exch10 S^2         ");
     exch10_s2();
-    timer_off("Exch10 S^2         ");
-    timer_on("Exch10             ");
+    term_stop("Exch10 S^2         ");
+    term_start("Exch10             ");
     exch10();
-    timer_off("Exch10             ");
-    timer_on("Ind20,r            ");
+    term_stop("Exch10             ");
+    term_start("Ind20,r            ");
     ind20r();
-    timer_off("Ind20,r            ");
-    timer_on("Exch-Ind20,r       ");
+    term_stop("Ind20,r            ");
+    term_start("Exch-Ind20,r       ");
     exch_ind20r();
-    timer_off("Exch-Ind20,r       ");
-    timer_on("Disp20             ");
+    term_stop("Exch-Ind20,r       ");
+    pin_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
+    term_start("Disp20             ");
     disp20();
-    timer_off("Disp20             ");
-    timer_on("Exch-Disp20        ");
+    term_stop("Disp20             ");
+    term_start("Exch-Disp20        ");
     exch_disp20();
-    timer_off("Exch-Disp20        ");
-    timer_on("Elst12             ");
+    term_stop("Exch-Disp20        ");
+    unpin_amplitudes("tARBS Amplitudes");
+    term_start("Elst12             ");
     elst12();
-    timer_off("Elst12             ");
-    timer_on("Exch11             ");
+    term_stop("Elst12             ");
+    term_start("Exch11             ");
     exch11();
-    timer_off("Exch11             ");
-    timer_on("Exch12             ");
+    term_stop("Exch11             ");
+    term_start("Exch12             ");
     exch12();
-    timer_off("Exch12             ");
-    timer_on("Ind22              ");
+    term_stop("Exch12             ");
+    term_start("Ind22              ");
     ind22();
-    timer_off("Ind22              ");
+    term_stop("Ind22              ");
 
     print_results();
 
+    export_term_costs();
+
     return (e_sapt0_);
 }
 
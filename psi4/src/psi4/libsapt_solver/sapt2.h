@@ -31,6 +31,9 @@
 
 #include "sapt.h"
 
+#include <map>
+#include <string>
+
 namespace psi {
 namespace sapt {
 
@@ -103,6 +106,21 @@ class SAPT2 : public SAPT {
     void df_integrals();
     void w_integrals();
 
+    // In-core registry of whole amplitude entries.  An entry is read from disk once and
+    // stays resident while it is pinned or checked out; the last release frees it.
+    struct AmplitudeEntry {
+        double **block;
+        long int size;
+        int refs;
+    };
+    std::map<std::string, AmplitudeEntry> amp_registry_;
+    long int amp_registry_mem_;
+
+    void pin_amplitudes(int, const char *, int, int);
+    void unpin_amplitudes(const char *);
+    double **get_amplitudes(int, const char *, int, int);
+    void release_amplitudes(const char *, double **);
+
     double **get_DF_ints(int, const char *, int, int, int, int);
     double **get_DF_ints_nongimp(int, const char *, int, int, int, int);
     void antisym(double *, int, int);
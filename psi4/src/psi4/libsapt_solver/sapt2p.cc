@@ -68,72 +68,76 @@ SAPT2p::~SAPT2p() {
 double SAPT2p::compute_energy() {
     print_header();
 
-    timer_on("DF Integrals       ");
+    term_start("DF Integrals       ");
     df_integrals();
-    timer_off("DF Integrals       ");
-    timer_on("Omega Integrals    ");
+    term_stop("DF Integrals       ");
+    term_start("Omega Integrals    ");
     w_integrals();
-    timer_off("Omega Integrals    ");
-    timer_on("Amplitudes         ");
+    term_stop("Omega Integrals    ");
+    term_start("Amplitudes         ");
     amplitudes();
-    timer_off("Amplitudes         ");
-    timer_on("Elst10             ");
+    term_stop("Amplitudes         ");
+    term_start("Elst10             ");
     elst10();
-    timer_off("Elst10             ");
-    timer_on("Exch10 S^2         ");
+    term_stop("Elst10             ");
+    term_start("Exch10 S^2         ");
     exch10_s2();
-    timer_off("Exch10 S^2         ");
-    timer_on("Exch10             ");
+    term_stop("Exch10 S^2         ");
+    term_start("Exch10             ");
     exch10();
-    timer_off("Exch10             ");
-    timer_on("Ind20,r            ");
+    term_stop("Exch10             ");
+    term_start("Ind20,r            ");
     ind20r();
-    timer_off("Ind20,r            ");
-    timer_on("Exch-Ind20,r       ");
+    term_stop("Ind20,r            ");
+    term_start("Exch-Ind20,r       ");
     exch_ind20r();
-    timer_off("Exch-Ind20,r       ");
-    timer_on("Disp20             ");
+    term_stop("Exch-Ind20,r       ");
+    pin_amplitudes(PSIF_SAPT_AMPS, "tARBS Amplitudes", aoccA_ * nvirA_, aoccB_ * nvirB_);
+    term_start("Disp20             ");
     disp20();
-    timer_off("Disp20             ");
-    timer_on("Exch-Disp20        ");
+    term_stop("Disp20             ");
+    term_start("Exch-Disp20        ");
     exch_disp20();
-    timer_off("Exch-Disp20        ");
-    timer_on("Elst12             ");
+    term_stop("Exch-Disp20        ");
+    unpin_amplitudes("tARBS Amplitudes");
+    term_start("Elst12             ");
     elst12();
-    timer_off("Elst12             ");
-    timer_on("Exch11             ");
+    term_stop("Elst12             ");
+    term_start("Exch11             ");
     exch11();
-    timer_off("Exch11             ");
-    timer_on("Exch12             ");
+    term_stop("Exch11             ");
+    term_start("Exch12             ");
     exch12();
-    timer_off("Exch12             ");
-    timer_on("Ind22              ");
+    term_stop("Exch12             ");
+    term_start("Ind22              ");
     ind22();
-    timer_off("Ind22              ");
-    timer_on("Disp21             ");
+    term_stop("Ind22              ");
+    term_start("Disp21             ");
     disp21();
-    timer_off("Disp21             ");
+    term_stop("Disp21             ");
 
     if (mbpt_disp_) {
-        timer_on("Disp22 (SDQ)       ");
+        term_start("Disp22 (SDQ)       ");
         disp22sdq();
-        timer_off("Disp22 (SDQ)       ");
-        timer_on("Disp22 (T)         ");
+        term_stop("Disp22 (SDQ)       ");
+        term_start("Disp22 (T)         ");
         disp22t();
-        timer_off("Disp22 (T)         ");
+        term_stop("Disp22 (T)         ");
     }
 
     if (ccd_disp_) {
-        timer_on("Disp2(CCD)         ");
+        term_start("Disp2(CCD)         ");
         disp2ccd();
-        timer_off("Disp2(CCD)         ");
-        timer_on("Disp22 (T) (CCD)   ");
+        term_stop("Disp2(CCD)         ");
+        term_start("Disp22 (T) (CCD)   ");
         disp22tccd();
-        timer_off("Disp22 (T) (CCD)   ");
+        term_stop("Disp22 (T) (CCD)   ");
     }
 
     print_results();
 
+    export_term_costs();
+
     return (e_sapt0_);
 }
 
@@ -437,7 +437,8 @@ void USAPT0::fock_terms() {
     int nbB = Coccb_B_->ncol();
     int nso = Cocca_A_->nrow();
     long int jk_memory = (long int)memory_;
-    jk_memory -= 24 * nso * nso;
+    // 18 J and 18 K matrices from the single fused JK call
+    jk_memory -= 36 * nso * nso;
     // Not sure why it should be 4, just taken from DFTSAPT code.
     jk_memory -= 4 * naA * nso;
     jk_memory -= 4 * nbA * nso;
@@ -490,6 +491,15 @@ void USAPT0::fock_terms() {
     std::shared_ptr<Matrix> Cb_AB = Matrix::doublet(Db_B, S_CA);
     S_CA.reset();
 
+    //    ExchInd perturbation orbitals go into the same JK call as the Elst/Exch terms
+
+    std::shared_ptr<Matrix> C_Oa_B = Matrix::triplet(Da_A, S, Cocca_B_);
+    std::shared_ptr<Matrix> C_Ob_B = Matrix::triplet(Db_A, S, Coccb_B_);
+    std::shared_ptr<Matrix> C_Pa_B = Matrix::triplet(Matrix::triplet(Da_B, S, Da_A), S, Cocca_B_);
+    std::shared_ptr<Matrix> C_Pb_B = Matrix::triplet(Matrix::triplet(Db_B, S, Db_A), S, Coccb_B_);
+    std::shared_ptr<Matrix> C_Pa_A = Matrix::triplet(Matrix::triplet(Da_A, S, Da_B), S, Cocca_A_);
+    std::shared_ptr<Matrix> C_Pb_A = Matrix::triplet(Matrix::triplet(Db_A, S, Db_B), S, Coccb_A_);
+
     // => Load the JK Object <= //
 
     std::vector<SharedMatrix>& Cl = jk->C_left();
@@ -529,6 +539,21 @@ void USAPT0::fock_terms() {
     Cr.push_back(Cocca_B_);
     Cl.push_back(Coccb_B_);
     Cr.push_back(Coccb_B_);
+    // J/K[O]
+    Cl.push_back(C_Oa_B);
+    Cr.push_back(Cocca_B_);
+    Cl.push_back(C_Ob_B);
+    Cr.push_back(Coccb_B_);
+    // J/K[P_B]
+    Cl.push_back(C_Pa_B);
+    Cr.push_back(Cocca_B_);
+    Cl.push_back(C_Pb_B);
+    Cr.push_back(Coccb_B_);
+    // J/K[P_A]
+    Cl.push_back(C_Pa_A);
+    Cr.push_back(Cocca_A_);
+    Cl.push_back(C_Pb_A);
+    Cr.push_back(Coccb_A_);
 
     // => Initialize the JK object <= //
 
@@ -810,47 +835,16 @@ void USAPT0::fock_terms() {
 
     // => ExchInd perturbations <= //
 
-    std::shared_ptr<Matrix> C_Oa_B = Matrix::triplet(Da_A, S, Cocca_B_);
-    std::shared_ptr<Matrix> C_Ob_B = Matrix::triplet(Db_A, S, Coccb_B_);
-    std::shared_ptr<Matrix> C_Pa_B = Matrix::triplet(Matrix::triplet(Da_B, S, Da_A), S, Cocca_B_);
-    std::shared_ptr<Matrix> C_Pb_B = Matrix::triplet(Matrix::triplet(Db_B, S, Db_A), S, Coccb_B_);
-    std::shared_ptr<Matrix> C_Pa_A = Matrix::triplet(Matrix::triplet(Da_A, S, Da_B), S, Cocca_A_);
-    std::shared_ptr<Matrix> C_Pb_A = Matrix::triplet(Matrix::triplet(Db_A, S, Db_B), S, Coccb_A_);
-
-    Cl.clear();
-    Cr.clear();
-
-    // J/K[O]
-    Cl.push_back(C_Oa_B);
-    Cr.push_back(Cocca_B_);
-    Cl.push_back(C_Ob_B);
-    Cr.push_back(Coccb_B_);
-    // J/K[P_B]
-    Cl.push_back(C_Pa_B);
-    Cr.push_back(Cocca_B_);
-    Cl.push_back(C_Pb_B);
-    Cr.push_back(Coccb_B_);
-    // J/K[P_A]
-    Cl.push_back(C_Pa_A);
-    Cr.push_back(Cocca_A_);
-    Cl.push_back(C_Pb_A);
-    Cr.push_back(Coccb_A_);
-
-    // => Compute the JK matrices <= //
-
-    jk->compute();
-
-    // => Unload the JK Object <= //
-
-    std::shared_ptr<Matrix> Ja_O = J[0];
-    std::shared_ptr<Matrix> Jb_O = J[1];
-    std::shared_ptr<Matrix> J_Pa_B = J[2];
-    std::shared_ptr<Matrix> J_Pb_B = J[3];
-    std::shared_ptr<Matrix> J_Pa_A = J[4];
-    std::shared_ptr<Matrix> J_Pb_A = J[5];
+    // J/K[O], J/K[P_B] and J/K[P_A] were formed with the Elst/Exch densities above
+    std::shared_ptr<Matrix> Ja_O = J[12];
+    std::shared_ptr<Matrix> Jb_O = J[13];
+    std::shared_ptr<Matrix> J_Pa_B = J[14];
+    std::shared_ptr<Matrix> J_Pb_B = J[15];
+    std::shared_ptr<Matrix> J_Pa_A = J[16];
+    std::shared_ptr<Matrix> J_Pb_A = J[17];
 
-    std::shared_ptr<Matrix> Ka_O = K[0];
-    std::shared_ptr<Matrix> Kb_O = K[1];
+    std::shared_ptr<Matrix> Ka_O = K[12];
+    std::shared_ptr<Matrix> Kb_O = K[13];
 
     // ==> Generalized ESP (Flat and Exchange) <== //
 
@@ -30,8 +30,14 @@
 #include "sapt0.h"
 #include "sapt2.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cmath>
 
+#ifndef _MSC_VER
+#include <sys/resource.h>
+#endif
+
 namespace psi {
 namespace sapt {
 
@@ -45,6 +51,168 @@ void SAPT::zero_disk(int file, const char *array, int rows, int columns) {
     free(zero);
 }
 
+namespace {
+std::string trim_label(const char *label) {
+    std::string name(label);
+    name.erase(name.find_last_not_of(' ') + 1);
+    return name;
+}
+
+// Memory high-water mark of the process in MiB; ru_maxrss is in kB on Linux and in bytes on macOS
+double peak_memory_mib() {
+#ifndef _MSC_VER
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return (double)usage.ru_maxrss / 1024.0;
+#endif
+#else
+    return 0.0;
+#endif
+}
+}
+
+void SAPT::term_start(const char *label) {
+    timer_on(label);
+    term_t0_ = std::chrono::steady_clock::now();
+    term_read0_ = psio_->bytes_read();
+    term_written0_ = psio_->bytes_written();
+}
+
+void SAPT::term_stop(const char *label) {
+    timer_off(label);
+    std::chrono::duration<double> wall = std::chrono::steady_clock::now() - term_t0_;
+    size_t nread = psio_->bytes_read() - term_read0_;
+    size_t nwritten = psio_->bytes_written() - term_written0_;
+
+    std::string name = trim_label(label);
+    for (TermCost &cost : term_costs_) {
+        if (cost.label == name) {
+            cost.wall += wall.count();
+            cost.peak_mem = peak_memory_mib();
+            cost.bytes_read += nread;
+            cost.bytes_written += nwritten;
+            return;
+        }
+    }
+    term_costs_.push_back(TermCost{name, wall.count(), term_flops(name), peak_memory_mib(), nread, nwritten});
+}
+
+double SAPT::term_flops(const std::string &label) const {
+    // Dominant contraction of each term only; iterative terms (Ind20,r, Disp2(CCD)) count a single iteration
+    double o = aoccA_, O = aoccB_, v = nvirA_, V = nvirB_;
+    double no = noccA_, nO = noccB_;
+    double Q = ndf_ + 3, n = nso_;
+    double ovOV = o * v * O * V;
+
+    if (label == "DF Integrals" || label == "OO DF Integrals")
+        return 2.0 * Q * n * n * (nmoA_ + nmoB_);
+    if (label == "W Integrals" || label == "Omega Integrals") return 2.0 * Q * (no * v + nO * V) * n;
+    if (label == "Amplitudes") return 2.0 * Q * (o * o * v * v + O * O * V * V + ovOV);
+    if (label == "Elst10" || label == "Elst12" || label == "Elst13")
+        return 2.0 * Q * (no * no + nO * nO + o * v + O * V);
+    if (label == "Exch10") return 2.0 * Q * no * nO * (no + nO + v + V);
+    if (label == "Exch10 S^2") return 2.0 * Q * no * nO * (v + V);
+    if (label == "Ind20" || label == "Ind20,r") return 4.0 * Q * (no * v * (no + v) + nO * V * (nO + V));
+    if (label == "Exch-Ind20" || label == "Exch-Ind20,r") return 2.0 * Q * no * nO * (no + nO + v + V);
+    if (label == "Disp20") return 2.0 * Q * ovOV;
+    if (label == "Exch-Disp20" || label == "Exch-Disp20 N^5") return 6.0 * Q * ovOV;
+    if (label == "Exch-Disp20 N^4") return 2.0 * Q * (o * v * O + O * V * o) * (o + O);
+    if (label == "Exch11") return 2.0 * Q * o * O * (v + V) * (o + O);
+    if (label == "Exch12" || label == "Ind22") return 2.0 * (o * o * v * v * v + O * O * V * V * V);
+    if (label == "Disp21") return 2.0 * ovOV * (o + v + O + V);
+    if (label == "Disp22 (SDQ)" || label == "Disp2(CCD)") return 2.0 * (o * o * v * v * v * v + O * O * V * V * V * V);
+    if (label == "Disp22 (T)" || label == "Disp22 (T) (CCD)") return 2.0 * ovOV * (o * v * (o + v) + O * V * (O + V));
+    if (label == "Disp30" || label == "ExchDisp30") return 2.0 * ovOV * (o * v + O * V);
+    if (label == "Ind30" || label == "Ind30,r" || label == "Exch-Ind30")
+        return 2.0 * Q * (o * v * (o + v) + O * V * (O + V));
+    if (label == "IndDisp30" || label == "ExchIndDisp30") return 2.0 * ovOV * (o + v + O + V);
+    return 0.0;
+}
+
+void SAPT::export_term_costs() {
+    for (const TermCost &cost : term_costs_) {
+        std::string key = "SAPT COST " + cost.label;
+        std::transform(key.begin(), key.end(), key.begin(), ::toupper);
+        const std::pair<const char *, double> fields[] = {{" WALL TIME", cost.wall},
+                                                          {" FLOPS", cost.flops},
+                                                          {" PEAK MEMORY", cost.peak_mem},
+                                                          {" BYTES READ", (double)cost.bytes_read},
+                                                          {" BYTES WRITTEN", (double)cost.bytes_written}};
+        for (const auto &field : fields) {
+            set_variable(key + field.first, field.second);
+            Process::environment.globals[key + field.first] = field.second;
+        }
+    }
+}
+
+void SAPT0::init_df_store() {
+    clear_df_store();
+
+    long int avail = (long int)(df_store_frac_ * mem_);
+
+    // Reserve in order of how often the terms read each tensor; what does not fit stays on disk only
+    const int files[] = {PSIF_SAPT_AB_DF_INTS, PSIF_SAPT_AA_DF_INTS, PSIF_SAPT_BB_DF_INTS,
+                         PSIF_SAPT_AA_DF_INTS, PSIF_SAPT_BB_DF_INTS, PSIF_SAPT_AB_DF_INTS,
+                         PSIF_SAPT_AB_DF_INTS, PSIF_SAPT_AA_DF_INTS, PSIF_SAPT_BB_DF_INTS};
+    const char *labels[] = {"AB RI Integrals", "AA RI Integrals", "BB RI Integrals",
+                            "AR RI Integrals", "BS RI Integrals", "RB RI Integrals",
+                            "AS RI Integrals", "RR RI Integrals", "SS RI Integrals"};
+    const long int lengths[] = {(long int)(noccA_ * noccB_), (long int)(noccA_ * noccA_),
+                                (long int)(noccB_ * noccB_), (long int)(noccA_ * nvirA_),
+                                (long int)(noccB_ * nvirB_), (long int)(nvirA_ * noccB_),
+                                (long int)(noccA_ * nvirB_), (long int)(nvirA_ * (nvirA_ + 1) / 2),
+                                (long int)(nvirB_ * (nvirB_ + 1) / 2)};
+
+    for (int t = 0; t < 9; t++) {
+        long int size = ndf_ * lengths[t];
+        if (size == 0 || size > avail) continue;
+        df_store_[std::make_pair(files[t], std::string(labels[t]))] =
+            std::make_pair(lengths[t], block_matrix(ndf_, lengths[t]));
+        avail -= size;
+        df_store_size_ += size;
+    }
+    mem_ -= df_store_size_;
+
+    if (debug_) {
+        outfile->Printf("    Keeping %zu DF tensors in core (%8.1lf MB)\n\n", df_store_.size(),
+                        8.0 * df_store_size_ / 1000000.0);
+    }
+}
+
+void SAPT0::clear_df_store() {
+    for (auto &entry : df_store_) free_block(entry.second.second);
+    df_store_.clear();
+    mem_ += df_store_size_;
+    df_store_size_ = 0L;
+}
+
+void SAPT0::store_df_block(int filenum, const char *label, double **B, long int start, long int length) {
+    auto entry = df_store_.find(std::make_pair(filenum, std::string(label)));
+    if (entry == df_store_.end()) return;
+    long int ncol = entry->second.first;
+    C_DCOPY(length * ncol, &(B[0][0]), 1, &(entry->second.second[start][0]), 1);
+}
+
+double **SAPT0::df_store_tensor(SAPTDFInts *ints) {
+    if (ints->dress_disk_) return nullptr;
+    auto entry = df_store_.find(std::make_pair(ints->filenum_, std::string(ints->label_)));
+    if (entry == df_store_.end()) return nullptr;
+    long int ncol = ints->active_ ? (ints->i_start_ + ints->i_length_) * ints->j_length_ : ints->ij_length_;
+    if (entry->second.first != ncol) return nullptr;
+    return entry->second.second;
+}
+
+void SAPT0::read_df_store(SAPTDFInts *ints, double **T, long int length) {
+    long int offset = ints->active_ ? ints->i_start_ * ints->j_length_ : 0L;
+    for (long int p = 0; p < length; p++) {
+        C_DCOPY(ints->ij_length_, &(T[ints->next_row_ + p][offset]), 1, &(ints->B_p_[p][0]), 1);
+    }
+    ints->next_row_ += length;
+}
+
 void SAPT0::read_all(SAPTDFInts *ints) {
     long int nri = ndf_;
     if (ints->dress_) nri += 3L;
@@ -52,8 +220,12 @@ void SAPT0::read_all(SAPTDFInts *ints) {
     ints->B_p_ = block_matrix(nri, ints->ij_length_);
 
     long int tot_i = ints->i_length_ + ints->i_start_;
+    double **T = df_store_tensor(ints);
 
-    if (!ints->active_ && !ints->dress_disk_) {
+    if (T != nullptr) {
+        ints->next_row_ = 0;
+        read_df_store(ints, T, ndf_);
+    } else if (!ints->active_ && !ints->dress_disk_) {
         psio_->read_entry(ints->filenum_, ints->label_, (char *)&(ints->B_p_[0][0]),
                           sizeof(double) * ndf_ * ints->ij_length_);
     } else if (!ints->active_ && ints->dress_disk_) {
@@ -85,7 +257,11 @@ void SAPT0::read_block(Iterator *iter, SAPTDFInts *intA) {
     iter->curr_size = block_length;
     if (last_block && dress) block_length -= 3;
 
-    if (!intA->active_ && (!intA->dress_disk_ || !last_block)) {
+    double **TA = df_store_tensor(intA);
+
+    if (TA != nullptr) {
+        read_df_store(intA, TA, block_length);
+    } else if (!intA->active_ && (!intA->dress_disk_ || !last_block)) {
         psio_->read(intA->filenum_, intA->label_, (char *)&(intA->B_p_[0][0]),
                     sizeof(double) * block_length * intA->ij_length_, intA->next_DF_, &intA->next_DF_);
     } else if (!intA->active_) {
@@ -122,7 +298,11 @@ void SAPT0::read_block(Iterator *iter, SAPTDFInts *intA, SAPTDFInts *intB) {
     iter->curr_size = block_length;
     if (last_block && dress) block_length -= 3;
 
-    if (!intA->active_ && (!intA->dress_disk_ || !last_block)) {
+    double **TA = df_store_tensor(intA);
+
+    if (TA != nullptr) {
+        read_df_store(intA, TA, block_length);
+    } else if (!intA->active_ && (!intA->dress_disk_ || !last_block)) {
         psio_->read(intA->filenum_, intA->label_, (char *)&(intA->B_p_[0][0]),
                     sizeof(double) * block_length * intA->ij_length_, intA->next_DF_, &intA->next_DF_);
     } else if (!intA->active_) {
@@ -136,7 +316,11 @@ void SAPT0::read_block(Iterator *iter, SAPTDFInts *intA, SAPTDFInts *intB) {
         }
     }
 
-    if (!intB->active_ && (!intB->dress_disk_ || !last_block)) {
+    double **TB = df_store_tensor(intB);
+
+    if (TB != nullptr) {
+        read_df_store(intB, TB, block_length);
+    } else if (!intB->active_ && (!intB->dress_disk_ || !last_block)) {
         psio_->read(intB->filenum_, intB->label_, (char *)&(intB->B_p_[0][0]),
                     sizeof(double) * block_length * intB->ij_length_, intB->next_DF_, &intB->next_DF_);
     } else if (!intB->active_) {
@@ -0,0 +1,276 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "batch.h"
+
+#include "psi4/libfock/jk.h"
+#include "psi4/libfock/v.h"
+#include "psi4/libfunctional/superfunctional.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/onebody.h"
+#include "psi4/libmints/vector.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/blas_backend.h"
+#include "psi4/libqt/qt.h"
+
+namespace psi {
+namespace scf {
+
+BatchRHF::BatchRHF(Options& options) : options_(options) {
+    maxiter_ = options_.get_int("MAXITER");
+    e_convergence_ = options_.get_double("E_CONVERGENCE");
+    d_convergence_ = options_.get_double("D_CONVERGENCE");
+    diis_max_vecs_ = options_.get_int("DIIS_MAX_VECS");
+    ints_tolerance_ = options_.get_double("INTS_TOLERANCE");
+    s_tolerance_ = options_.get_double("S_TOLERANCE");
+}
+
+void BatchRHF::add_system(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
+                          std::shared_ptr<SuperFunctional> functional) {
+    if (!primary) throw PSIEXCEPTION("BatchRHF: a system needs a primary basis set.");
+    if (functional && !functional->is_unpolarized())
+        throw PSIEXCEPTION("BatchRHF: functionals must be unpolarized (restricted).");
+    systems_.push_back({primary, auxiliary, functional});
+}
+
+std::vector<BatchSCFResult> BatchRHF::compute() {
+    // From here on the options are only read, concurrently; register any lazily held back globals first
+    options_.load_globals();
+
+    std::vector<BatchSCFResult> results(systems_.size());
+    int nsystem = systems_.size();
+    int nthread = std::max(1, std::min(Process::environment.get_n_threads(), nsystem));
+    size_t memory = Process::environment.get_memory() / 8L / nthread;
+
+#ifdef _OPENMP
+    // One system per thread: everything a system calls itself runs serially
+    int max_levels = omp_get_max_active_levels();
+    omp_set_max_active_levels(1);
+#endif
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nthread)
+    for (int i = 0; i < nsystem; i++) {
+        blas::ThreadScope blas_threads(1, "Batch RHF");
+        try {
+            results[i] = compute_system(systems_[i], memory);
+        } catch (std::exception& e) {
+            results[i].error = e.what();
+        }
+    }
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_levels);
+#endif
+
+    outfile->Printf("\n  ==> Batch RHF: %d Systems on %d Threads <==\n\n", nsystem, nthread);
+    outfile->Printf("    %6s %20s %6s  %s\n", "System", "Energy", "Iter", "Status");
+    for (int i = 0; i < nsystem; i++) {
+        const BatchSCFResult& result = results[i];
+        if (!result.error.empty()) {
+            outfile->Printf("    %6d %20s %6s  Error: %s\n", i, "", "", result.error.c_str());
+        } else {
+            outfile->Printf("    %6d %20.12f %6d  %s\n", i, result.energy, result.iterations,
+                            result.converged ? "Converged" : "Not converged");
+        }
+    }
+    outfile->Printf("\n");
+
+    return results;
+}
+
+BatchSCFResult BatchRHF::compute_system(const BatchSCFSystem& system, size_t memory) const {
+    BatchSCFResult result;
+
+    std::shared_ptr<BasisSet> primary = system.primary;
+    std::shared_ptr<Molecule> mol = primary->molecule();
+    if (primary->has_ECP()) throw PSIEXCEPTION("BatchRHF: ECP basis sets are not supported.");
+
+    int nelectron = -mol->molecular_charge();
+    for (int A = 0; A < mol->natom(); A++) nelectron += (int)std::lround(mol->Z(A));
+    if (nelectron % 2 != 0 || mol->multiplicity() != 1) throw PSIEXCEPTION("BatchRHF: system is not closed shell.");
+    int nocc = nelectron / 2;
+    double nuclear_E = mol->nuclear_repulsion_energy({{0.0, 0.0, 0.0}});
+
+    // One-electron integrals in the C1 AO basis
+    int nbf = primary->nbf();
+    auto factory = std::make_shared<IntegralFactory>(primary, primary, primary, primary);
+    auto S = std::make_shared<Matrix>("S", nbf, nbf);
+    auto T = std::make_shared<Matrix>("T", nbf, nbf);
+    auto H = std::make_shared<Matrix>("H", nbf, nbf);
+    std::unique_ptr<OneBodyAOInt> Sint(factory->ao_overlap());
+    std::unique_ptr<OneBodyAOInt> Tint(factory->ao_kinetic());
+    std::unique_ptr<OneBodyAOInt> Vint(factory->ao_potential());
+    Sint->compute(S);
+    Tint->compute(T);
+    Vint->compute(H);
+    H->add(T);
+
+    SharedMatrix X = S->canonical_orthogonalization(s_tolerance_);
+    int nmo = X->colspi()[0];
+    if (nocc > nmo) throw PSIEXCEPTION("BatchRHF: more occupied orbitals than linearly independent functions.");
+
+    std::shared_ptr<SuperFunctional> functional = system.functional;
+    bool lrc = functional && functional->is_x_lrc();
+    double alpha = functional ? functional->x_alpha() : 1.0;
+    double beta = lrc ? functional->x_beta() : 0.0;
+
+    std::shared_ptr<JK> jk;
+    if (system.auxiliary) {
+        if (lrc) throw PSIEXCEPTION("BatchRHF: range-separated functionals need DirectJK (no auxiliary basis).");
+        jk = std::make_shared<MemDFJK>(primary, system.auxiliary);
+    } else {
+        auto direct = std::make_shared<DirectJK>(primary);
+        direct->set_df_ints_num_threads(1);
+        jk = direct;
+    }
+    jk->set_print(0);
+    jk->set_omp_nthread(1);
+    jk->set_memory(memory);
+    jk->set_cutoff(ints_tolerance_);
+    jk->set_do_K(alpha != 0.0);
+    if (lrc) {
+        jk->set_do_wK(true);
+        jk->set_omega(functional->x_omega());
+    }
+    jk->initialize();
+
+    std::shared_ptr<VBase> potential;
+    SharedMatrix Vxc;
+    if (functional && functional->needs_xc()) {
+        potential = VBase::build_V(primary, functional, options_, "RV");
+        potential->initialize();
+        Vxc = std::make_shared<Matrix>("Vxc", nbf, nbf);
+    }
+
+    // Orbitals and density from a Fock matrix
+    auto F = H->clone();
+    auto D = std::make_shared<Matrix>("D", nbf, nbf);
+    auto Cocc = std::make_shared<Matrix>("Cocc", nbf, nocc);
+    auto diagonalize = [&](const SharedMatrix& Fock) {
+        SharedMatrix Fp = Matrix::triplet(X, Fock, X, true, false, false);
+        auto Cp = std::make_shared<Matrix>("C'", nmo, nmo);
+        result.epsilon = std::make_shared<Vector>("epsilon", nmo);
+        Fp->diagonalize(Cp, result.epsilon);
+        result.Ca = Matrix::doublet(X, Cp);
+        double** Cap = result.Ca->pointer();
+        double** Coccp = Cocc->pointer();
+        for (int m = 0; m < nbf; m++) {
+            for (int i = 0; i < nocc; i++) Coccp[m][i] = Cap[m][i];
+        }
+        D->gemm(false, true, 1.0, Cocc, Cocc, 0.0);
+    };
+    diagonalize(H);
+
+    // Compact DIIS on the orthogonalized FDS - SDF
+    std::vector<SharedMatrix> diis_F;
+    std::vector<SharedMatrix> diis_error;
+    std::vector<int> ipiv(diis_max_vecs_ + 1);
+
+    double E = 0.0;
+    double Eold = 0.0;
+    for (result.iterations = 1; result.iterations <= maxiter_; result.iterations++) {
+        jk->C_left().clear();
+        jk->C_left().push_back(Cocc);
+        jk->compute();
+
+        F->copy(H);
+        F->axpy(2.0, jk->J()[0]);
+        if (alpha != 0.0) F->axpy(-alpha, jk->K()[0]);
+        if (lrc) F->axpy(-beta, jk->wK()[0]);
+
+        E = nuclear_E + D->vector_dot(H) + D->vector_dot(F);
+        if (potential) {
+            potential->set_D({D});
+            potential->compute_V({Vxc});
+            F->add(Vxc);
+            E += potential->quadrature_values()["FUNCTIONAL"];
+            if (functional->needs_vv10()) E += potential->quadrature_values()["VV10"];
+        }
+
+        SharedMatrix error = Matrix::triplet(F, D, S);
+        error->subtract(error->transpose());
+        error = Matrix::triplet(X, error, X, true, false, false);
+        double rms = error->rms();
+
+        if (std::fabs(E - Eold) < e_convergence_ && rms < d_convergence_) {
+            result.converged = true;
+            break;
+        }
+        Eold = E;
+
+        diis_F.push_back(F->clone());
+        diis_error.push_back(error);
+        if ((int)diis_F.size() > diis_max_vecs_) {
+            diis_F.erase(diis_F.begin());
+            diis_error.erase(diis_error.begin());
+        }
+
+        int n = diis_F.size();
+        if (n > 1) {
+            std::vector<double> B((n + 1) * (n + 1), -1.0);
+            std::vector<double> coef(n + 1, 0.0);
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j <= i; j++) {
+                    B[i * (n + 1) + j] = B[j * (n + 1) + i] = diis_error[i]->vector_dot(diis_error[j]);
+                }
+            }
+            B[n * (n + 1) + n] = 0.0;
+            coef[n] = -1.0;
+            if (C_DGESV(n + 1, 1, B.data(), n + 1, ipiv.data(), coef.data(), n + 1) == 0) {
+                F->zero();
+                for (int i = 0; i < n; i++) F->axpy(coef[i], diis_F[i]);
+            }
+        }
+
+        diagonalize(F);
+    }
+    result.iterations = std::min(result.iterations, maxiter_);
+    result.energy = E;
+
+    jk->finalize();
+    if (potential) potential->finalize();
+
+    return result;
+}
+
+}  // namespace scf
+}  // namespace psi
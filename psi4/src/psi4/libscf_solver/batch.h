@@ -0,0 +1,113 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#ifndef BATCH_SCF_H
+#define BATCH_SCF_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "psi4/pragma.h"
+#include "psi4/libmints/typedefs.h"
+
+namespace psi {
+
+class BasisSet;
+class Options;
+class SuperFunctional;
+
+namespace scf {
+
+/// One closed-shell system of a BatchRHF run
+struct BatchSCFSystem {
+    std::shared_ptr<BasisSet> primary;
+    /// JKFIT basis for a MemDFJK; null selects DirectJK
+    std::shared_ptr<BasisSet> auxiliary;
+    /// Null runs Hartree-Fock
+    std::shared_ptr<SuperFunctional> functional;
+};
+
+/// Final state of one system of a BatchRHF run
+struct BatchSCFResult {
+    double energy = 0.0;
+    int iterations = 0;
+    bool converged = false;
+    /// AO orbital coefficients (nbf x nmo) and energies
+    SharedMatrix Ca;
+    SharedVector epsilon;
+    /// Set instead of the above if the system could not be run
+    std::string error;
+};
+
+/*! \ingroup SCF
+ *  \class BatchRHF
+ *  \brief Runs many small independent RHF/RKS calculations concurrently, one per thread.
+ *
+ *  For molecules of a few atoms a full HF object spends more time on setup
+ *  and bookkeeping than on integrals, and its OpenMP loops are too short to
+ *  keep many threads busy. Here each thread instead owns whole systems, with
+ *  a single-threaded MemDFJK (or DirectJK) and V object, a core guess, and a
+ *  compact in-core DIIS, all in the C1 AO basis. Every system is
+ *  independent, so a failure is recorded in its result rather than thrown.
+ *
+ *  Convergence follows the SCF module's MAXITER, E_CONVERGENCE,
+ *  D_CONVERGENCE, DIIS_MAX_VECS, INTS_TOLERANCE and S_TOLERANCE, read when
+ *  the object is built.
+ */
+class PSI_API BatchRHF {
+   protected:
+    Options& options_;
+    std::vector<BatchSCFSystem> systems_;
+
+    int maxiter_;
+    double e_convergence_;
+    double d_convergence_;
+    int diis_max_vecs_;
+    double ints_tolerance_;
+    double s_tolerance_;
+
+    /// Runs one system on the calling thread with the given memory (doubles)
+    BatchSCFResult compute_system(const BatchSCFSystem& system, size_t memory) const;
+
+   public:
+    BatchRHF(Options& options);
+
+    /// Queues a system; its molecule must be closed shell
+    void add_system(std::shared_ptr<BasisSet> primary, std::shared_ptr<BasisSet> auxiliary,
+                    std::shared_ptr<SuperFunctional> functional);
+    size_t nsystem() const { return systems_.size(); }
+
+    /// Runs every queued system, spread over the job's threads
+    std::vector<BatchSCFResult> compute();
+};
+
+}  // namespace scf
+}  // namespace psi
+
+#endif
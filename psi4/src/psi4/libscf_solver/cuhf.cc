@@ -154,6 +154,7 @@ void CUHF::form_G() {
     C.clear();
     C.push_back(Ca_subset("SO", "OCC"));
     C.push_back(Cb_subset("SO", "OCC"));
+    form_sparse_D({Da_, Db_});
 
     // Run the JK object
     jk_->compute();
@@ -363,19 +364,23 @@ double CUHF::compute_orbital_gradient(bool save_diis, int max_diis_vectors) {
 
     if (save_diis) {
         if (initialized_diis_manager_ == false) {
-            diis_manager_ = std::make_shared<DIISManager>(max_diis_vectors, "HF DIIS vector", DIISManager::LargestError,
-                                                          DIISManager::OnDisk);
+            diis_manager_ = make_diis_manager(max_diis_vectors, false);
             diis_manager_->set_error_vector_size(2, DIISEntry::Matrix, grad_a.get(), DIISEntry::Matrix, grad_b.get());
             diis_manager_->set_vector_size(2, DIISEntry::Matrix, Fa_.get(), DIISEntry::Matrix, Fb_.get());
             initialized_diis_manager_ = true;
         }
 
         diis_manager_->add_entry(4, grad_a.get(), grad_b.get(), Fa_.get(), Fb_.get());
+        add_to_initial_accelerator({Da_, Db_}, {Fa_, Fb_}, 1.0, std::max(grad_a->absmax(), grad_b->absmax()),
+                                   max_diis_vectors);
     }
     return Drms;
 }
 
-bool CUHF::diis() { return diis_manager_->extrapolate(2, Fa_.get(), Fb_.get()); }
+bool CUHF::diis() {
+    return accelerated_extrapolate({Fa_, Fb_},
+                                   [this]() { return diis_manager_->extrapolate(2, Fa_.get(), Fb_.get()); });
+}
 
 bool CUHF::stability_analysis() {
     throw PSIEXCEPTION("CUHF stability analysis has not been implemented yet.  Sorry :(");
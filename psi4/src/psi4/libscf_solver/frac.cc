@@ -128,6 +128,7 @@ void HF::frac() {
             diis_manager_->delete_diis_file();
             diis_manager_.reset();
             initialized_diis_manager_ = false;
+            initial_accelerator_.reset();
             diis_start_ += iteration_ + 1;
         }
 
@@ -51,13 +51,16 @@
 #include "psi4/libfunctional/superfunctional.h"
 #include "psi4/libdiis/diismanager.h"
 #include "psi4/libdiis/diisentry.h"
+#include "psi4/libdiis/ediis.h"
 
 #ifdef USING_PCMSolver
 #include "psi4/libpsipcm/psipcm.h"
 #endif
 
 #include "psi4/libpsi4util/libpsi4util.h"
+#include "psi4/libpsi4util/memory_broker.h"
 #include "psi4/libmints/basisset.h"
+#include "psi4/libmints/blocksparse.h"
 #include "psi4/libmints/molecule.h"
 #include "psi4/libmints/mintshelper.h"
 #include "psi4/libmints/petitelist.h"
@@ -97,6 +100,7 @@ void HF::common_init() {
     integral_threshold_ = options_.get_double("INTS_TOLERANCE");
 
     scf_type_ = options_.get_str("SCF_TYPE");
+    Process::environment.memory_broker().set_strict(options_.get_bool("MEMORY_BROKER_STRICT"));
 
     H_.reset(factory_->create_matrix("One-electron Hamiltonian"));
     X_.reset(factory_->create_matrix("X"));
@@ -112,6 +116,8 @@ void HF::common_init() {
     }
 
     density_fitted_ = false;
+    v_time_ = 0.0;
+    last_diis_reset_ = 0;
 
     energies_["Total Energy"] = 0.0;
 
@@ -234,6 +240,29 @@ void HF::common_init() {
 
     MOM_performed_ = false;  // duplicated py-side (needed before iterate)
 
+    initial_accelerator_type_ = options_.get_str("SCF_INITIAL_ACCELERATOR");
+    accelerator_start_ = options_.get_double("SCF_INITIAL_START_DIIS_TRANSITION");
+    accelerator_finish_ = options_.get_double("SCF_INITIAL_FINISH_DIIS_TRANSITION");
+    accelerator_error_ = 0.0;
+    if (initial_accelerator_type_ != "NONE" && accelerator_start_ <= accelerator_finish_)
+        throw PSIEXCEPTION("SCF_INITIAL_START_DIIS_TRANSITION must exceed SCF_INITIAL_FINISH_DIIS_TRANSITION.");
+
+    sparse_threshold_ = options_.get_double("SPARSE_AO_THRESHOLD");
+    if (sparse_threshold_ > 0.0 && nirrep_ != 1) {
+        outfile->Printf("  SPARSE_AO_THRESHOLD needs C1 symmetry; keeping dense AO quantities only.\n\n");
+        sparse_threshold_ = 0.0;
+    }
+
+    purify_ = false;
+    if (options_.get_str("PURIFICATION") != "NONE") {
+        std::string reference = options_.get_str("REFERENCE");
+        if (reference != "RHF" && reference != "RKS")
+            throw PSIEXCEPTION("HF: PURIFICATION is only available for RHF and RKS references.");
+        if (options_.get_bool("SOSCF") || options_.get_int("MOM_START") != 0 || options_.get_int("FRAC_START") != 0)
+            throw PSIEXCEPTION("HF: PURIFICATION needs orbitals only at convergence; turn off SOSCF, MOM and FRAC.");
+        purify_ = true;
+    }
+
     if (print_) {
         print_header();
     }
@@ -286,6 +315,70 @@ int HF::soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter,
 }
 
 void HF::form_V() { throw PSIEXCEPTION("Sorry, DFT functionals are not supported for this type of SCF wavefunction."); }
+void HF::form_sparse_D(const std::vector<SharedMatrix>& D) {
+    if (sparse_threshold_ <= 0.0) return;
+    Da_sparse_ = BlockSparseMatrix::from_matrix(D[0], basisset_, basisset_, sparse_threshold_);
+    Db_sparse_ = (D.size() > 1 ? BlockSparseMatrix::from_matrix(D[1], basisset_, basisset_, sparse_threshold_)
+                               : Da_sparse_);
+    if (D.size() > 1) {
+        jk_->set_D_sparse({Da_sparse_, Db_sparse_});
+    } else {
+        jk_->set_D_sparse({Da_sparse_});
+    }
+    if (print_ > 2) {
+        outfile->Printf("    Sparse AO density: %zu of %d x %d shell blocks (%.1f%%)\n", Da_sparse_->nblocks(),
+                        basisset_->nshell(), basisset_->nshell(), 100.0 * Da_sparse_->fill());
+    }
+}
+void HF::form_sparse_F(const std::vector<SharedMatrix>& F) {
+    if (sparse_threshold_ <= 0.0) return;
+    Fa_sparse_ = BlockSparseMatrix::from_matrix(F[0], basisset_, basisset_, sparse_threshold_);
+    Fb_sparse_ = (F.size() > 1 ? BlockSparseMatrix::from_matrix(F[1], basisset_, basisset_, sparse_threshold_)
+                               : Fa_sparse_);
+}
+std::shared_ptr<DIISManager> HF::make_diis_manager(int max_diis_vectors, bool in_core_default) {
+    std::string storage = options_.get_str("DIIS_STORAGE");
+    DIISManager::StoragePolicy policy = in_core_default ? DIISManager::InCore : DIISManager::OnDisk;
+    if (storage == "DISK") {
+        policy = DIISManager::OnDisk;
+    } else if (storage == "CORE") {
+        policy = DIISManager::InCore;
+    } else if (storage == "CORE_SINGLE") {
+        policy = DIISManager::InCoreSingle;
+    }
+    return std::make_shared<DIISManager>(max_diis_vectors, "HF DIIS vector", DIISManager::LargestError, policy);
+}
+void HF::add_to_initial_accelerator(const std::vector<SharedMatrix>& D, const std::vector<SharedMatrix>& F,
+                                    double spin_factor, double error, int max_vecs) {
+    if (initial_accelerator_type_ == "NONE") return;
+    if (!initial_accelerator_) {
+        EnergyDIIS::Model model = (initial_accelerator_type_ == "EDIIS") ? EnergyDIIS::EDIIS : EnergyDIIS::ADIIS;
+        initial_accelerator_ = std::make_shared<EnergyDIIS>(std::max(max_vecs, 2), model, spin_factor);
+    }
+    initial_accelerator_->add_entry(get_energies("Total Energy"), D, F);
+    accelerator_error_ = error;
+}
+bool HF::accelerated_extrapolate(const std::vector<SharedMatrix>& F, const std::function<bool()>& pulay) {
+    if (!initial_accelerator_ || accelerator_error_ <= accelerator_finish_) return pulay();
+
+    std::vector<SharedMatrix> Faccel;
+    for (const auto& Fs : F) Faccel.push_back(Fs->clone());
+    if (!initial_accelerator_->extrapolate(Faccel)) return pulay();
+
+    // Linear blend in the gradient between the two transition thresholds (Garza & Scuseria)
+    double weight = 1.0;
+    if (accelerator_error_ < accelerator_start_) {
+        weight = (accelerator_error_ - accelerator_finish_) / (accelerator_start_ - accelerator_finish_);
+        if (!pulay()) weight = 1.0;
+    }
+    for (size_t s = 0; s < F.size(); s++) {
+        F[s]->scale(1.0 - weight);
+        F[s]->axpy(weight, Faccel[s]);
+    }
+    if (print_ > 1)
+        outfile->Printf("  %s weight in DIIS extrapolation: %8.5f\n", initial_accelerator_type_.c_str(), weight);
+    return true;
+}
 void HF::form_C() { throw PSIEXCEPTION("Sorry, the base HF wavefunction cannot construct orbitals."); }
 void HF::form_D() { throw PSIEXCEPTION("Sorry, the base HF wavefunction cannot construct densities."); }
 
@@ -393,6 +486,9 @@ void HF::initialize_jk(size_t effective_memory_doubles) {
 void HF::finalize() {
     // Clean memory off, handle diis closeout, etc
 
+    // Reprint the JK header, now with any screening statistics gathered in the iterations
+    if (print_ > 1 && jk_) jk_->print_header();
+
     // This will be the only one
     if (!options_.get_bool("SAVE_JK")) {
         jk_.reset();
@@ -402,6 +498,8 @@ void HF::finalize() {
     if (initialized_diis_manager_) diis_manager_->delete_diis_file();
     diis_manager_.reset();
     initialized_diis_manager_ = false;
+    initial_accelerator_.reset();
+    soscf_prev_step_.clear();
 
     // Figure out how many frozen virtual and frozen core per irrep
     compute_fcpi();
@@ -690,6 +788,8 @@ void HF::form_H() {
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY") == false && H_->nirrep() != 1)
             throw PSIEXCEPTION("SCF: External Fields are not consistent with symmetry. Set symmetry c1.");
 
+        external_pot_->set_far_field(options_.get_double("EXTERNAL_POTENTIAL_FAR_CUTOFF"),
+                                     options_.get_double("EXTERNAL_POTENTIAL_FAR_THETA"));
         SharedMatrix Vprime = external_pot_->computePotentialMatrix(basisset_);
 
         if (options_.get_bool("EXTERNAL_POTENTIAL_SYMMETRY")) {
@@ -1108,6 +1208,15 @@ void HF::guess() {
         compute_SAD_guess();
         guess_E = compute_initial_E();
 
+    } else if (guess_type == "FRAG") {
+        if (print_) outfile->Printf("  SCF Guess: Superposition of Fragment Densities via fragment UHF.\n\n");
+
+        // Same machinery as SAD, with fragments in place of atoms
+        iteration_ = -1;
+        reset_occ_ = true;
+        compute_SAD_guess();
+        guess_E = compute_initial_E();
+
     } else if (guess_type == "GWH") {
         // Generalized Wolfsberg Helmholtz (Sounds cool, easy to code)
         if (print_) outfile->Printf("  SCF Guess: Generalized Wolfsberg-Helmholtz.\n\n");
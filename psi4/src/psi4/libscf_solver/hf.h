@@ -29,6 +29,10 @@
 #ifndef HF_H
 #define HF_H
 
+#include <chrono>
+#include <functional>
+#include <string>
+#include <tuple>
 #include <vector>
 #include "psi4/libmints/wavefunction.h"
 #include "psi4/libmints/vector3.h"
@@ -42,9 +46,31 @@ class SuperFunctional;
 class VBase;
 class BasisSet;
 class DIISManager;
+class EnergyDIIS;
 class PSIO;
+class BlockSparseMatrix;
 namespace scf {
 
+/// Cost and convergence telemetry of one SCF iteration
+struct SCFIterationStats {
+    int iteration = 0;
+    double energy = 0.0;
+    double delta_e = 0.0;
+    double d_rms = 0.0;
+    /// Wall time (s) of the whole iteration, and of its J/K builds, XC potential and DIIS within it
+    double total_time = 0.0;
+    double jk_time = 0.0;
+    double v_time = 0.0;
+    double diis_time = 0.0;
+    /// Fraction of shell quartets skipped by screening, -1 if the J/K engine does not count them
+    double screened_fraction = -1.0;
+    /// Bytes read and written through PSIO
+    size_t io_bytes = 0;
+    /// SCF_TYPE of the J/K engine, and the iteration's status (DIIS, MOM, ...)
+    std::string scf_type;
+    std::string status;
+};
+
 class HF : public Wavefunction {
    protected:
     double Drms_;
@@ -70,6 +96,18 @@ class HF : public Wavefunction {
     /// e.g. PCM potential
     std::vector<SharedMatrix> external_potentials_;
 
+    /// Shell blocks of D and F above this Frobenius norm are kept in the *_sparse_ copies (0 = off, C1 only)
+    double sparse_threshold_;
+    /// Shell-block sparse AO densities and Fock matrices, refreshed by form_sparse_D()/form_sparse_F()
+    std::shared_ptr<BlockSparseMatrix> Da_sparse_;
+    std::shared_ptr<BlockSparseMatrix> Db_sparse_;
+    std::shared_ptr<BlockSparseMatrix> Fa_sparse_;
+    std::shared_ptr<BlockSparseMatrix> Fb_sparse_;
+    /// Rebuild Da_sparse_ (and Db_sparse_) from D and hand them to jk_; call right before jk_->compute()
+    void form_sparse_D(const std::vector<SharedMatrix>& D);
+    /// Rebuild Fa_sparse_ (and Fb_sparse_) from F
+    void form_sparse_F(const std::vector<SharedMatrix>& F);
+
     /// Old C Alpha matrix (if needed for MOM)
     SharedMatrix Ca_old_;
     /// Old C Beta matrix (if needed for MOM)
@@ -88,6 +126,10 @@ class HF : public Wavefunction {
     /// Basis list for SAD
     std::vector<std::shared_ptr<BasisSet>> sad_basissets_;
     std::vector<std::shared_ptr<BasisSet>> sad_fitting_basissets_;
+    /// Fragment bases and their atoms in the full molecule, for GUESS FRAG
+    std::vector<std::shared_ptr<BasisSet>> frag_basissets_;
+    std::vector<std::shared_ptr<BasisSet>> frag_fitting_basissets_;
+    std::vector<std::vector<int>> frag_atoms_;
 
     ///
     bool ref_C_;
@@ -141,6 +183,9 @@ class HF : public Wavefunction {
     /// Frac started? (Same thing as frac_performed_)
     bool frac_performed_;
 
+    /// Build the density by Fock-matrix purification instead of form_C()? (RHF only)
+    bool purify_;
+
     /// DIIS manager intiialized?
     bool initialized_diis_manager_;
     /// DIIS manager for all SCF wavefunctions
@@ -151,6 +196,42 @@ class HF : public Wavefunction {
     /// Are we even using DIIS?
     int diis_enabled_;
 
+    /// Called at the end of each iteration of iterate(), empty unless requested
+    std::function<void(int)> iteration_callback_;
+
+    /// Telemetry of every iteration so far, across engine switches
+    std::vector<SCFIterationStats> iteration_stats_;
+    /// Wall time (s) spent building the XC potential
+    double v_time_;
+    /// Clock and counters at the start of the current iteration
+    std::chrono::steady_clock::time_point stats_start_;
+    double stats_jk_time_;
+    double stats_v_time_;
+    size_t stats_io_bytes_;
+    size_t stats_quartets_computed_;
+    size_t stats_quartets_skipped_;
+    /// Iteration of the last stall-triggered DIIS reset
+    int last_diis_reset_;
+
+    /// Last truncated-Newton SOSCF step, reused as a trial vector in the next macroiteration
+    std::vector<SharedMatrix> soscf_prev_step_;
+
+    /// EDIIS/ADIIS accelerator blended into DIIS far from convergence (SCF_INITIAL_ACCELERATOR)
+    std::shared_ptr<EnergyDIIS> initial_accelerator_;
+    std::string initial_accelerator_type_;
+    /// Largest orbital-gradient element of the newest accelerator entry
+    double accelerator_error_;
+    /// Gradient window over which the accelerator is blended into DIIS
+    double accelerator_start_;
+    double accelerator_finish_;
+    /// New DIIS manager with the DIIS_STORAGE policy (in_core_default resolves AUTO)
+    std::shared_ptr<DIISManager> make_diis_manager(int max_diis_vectors, bool in_core_default);
+    /// Record this iteration's energy, densities and Fock matrices for the initial accelerator
+    void add_to_initial_accelerator(const std::vector<SharedMatrix>& D, const std::vector<SharedMatrix>& F,
+                                    double spin_factor, double error, int max_vecs);
+    /// Extrapolate F by DIIS (pulay), the initial accelerator, or a blend of the two
+    bool accelerated_extrapolate(const std::vector<SharedMatrix>& F, const std::function<bool()>& pulay);
+
     // parameters for hard-sphere potentials
     double radius_;     // radius of spherical potential
     double thickness_;  // thickness of spherical barrier
@@ -253,6 +334,10 @@ class HF : public Wavefunction {
     bool MOM_performed() const { return MOM_performed_; }
     void set_MOM_performed(bool tf) { MOM_performed_ = tf; }
 
+    /// Is the density built by purification? Turned off once converged, to form the orbitals
+    bool purify() const { return purify_; }
+    void set_purify(bool tf) { purify_ = tf; }
+
     // Q: MOM_started_ was ditched b/c same info as MOM_performed_
 
     /// Which set of iterations we're on in this computation, e.g., for stability
@@ -313,6 +398,12 @@ class HF : public Wavefunction {
 
     /** Applies second-order convergence acceleration */
     virtual int soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter, int soscf_print);
+    /// Truncated-Newton solve of cphf_Hx(x) = gradient in a subspace, one JK build per subspace step
+    std::vector<SharedMatrix> soscf_newton(const std::vector<SharedMatrix>& gradient,
+                                           const std::vector<SharedMatrix>& denominator, int min_iter, int max_iter,
+                                           bool print);
+    /// Occupied x virtual orbital energy differences, diagonal of the Fock matrix in the C basis
+    SharedMatrix soscf_denominator(SharedMatrix C, SharedMatrix F, const Dimension& noccpi) const;
 
     /// Figure out how to occupy the orbitals in the absence of DOCC and SOCC
     void find_occupation();
@@ -326,6 +417,31 @@ class HF : public Wavefunction {
     /** Applies damping to the density update */
     virtual void damping_update(double);
 
+    /**
+     * Native SCF iteration loop, the C++ counterpart of scf_iterate() in
+     * scf_iterator.py with the same DIIS, damping, MOM, FRAC and SOSCF logic
+     * and printout. EFP and PCM jobs must use the Python loop.
+     * @param e_conv energy convergence threshold
+     * @param d_conv orbital gradient convergence threshold
+     * @return (converged, last energy change, last orbital gradient RMS);
+     *         not converged means MAXITER was reached
+     */
+    std::tuple<bool, double, double> iterate(double e_conv, double d_conv);
+    /// Function called with the iteration number at the end of each iteration of iterate()
+    void set_iteration_callback(std::function<void(int)> callback) { iteration_callback_ = callback; }
+
+    /// Starts the telemetry of an iteration; call before form_G()
+    void begin_iteration_stats();
+    /// Records and returns the telemetry of the iteration begun last, with the DIIS time measured by the caller
+    SCFIterationStats end_iteration_stats(double energy, double delta_e, double d_rms, double diis_time,
+                                          const std::string& status);
+    /// Telemetry of every iteration so far
+    const std::vector<SCFIterationStats>& iteration_stats() const { return iteration_stats_; }
+    /// Prints the per-iteration telemetry table
+    void print_iteration_stats() const;
+    /// With SCF_ADAPTIVE, resets the DIIS subspace if the telemetry shows it has stalled; true if it did
+    bool reset_stalled_diis();
+
     /// Clears memory and closes files (Should they be open) prior to correlated code execution
     /// Derived classes override it for additional operations and then call HF::finalize()
     virtual void finalize();
@@ -388,6 +504,12 @@ class HF : public Wavefunction {
     SharedMatrix Va() { return Va_; }
     SharedMatrix Vb() { return Vb_; }
 
+    /// Shell-block sparse copies of D and F, null unless SPARSE_AO_THRESHOLD > 0 (see form_sparse_D())
+    std::shared_ptr<BlockSparseMatrix> Da_sparse() const { return Da_sparse_; }
+    std::shared_ptr<BlockSparseMatrix> Db_sparse() const { return Db_sparse_; }
+    std::shared_ptr<BlockSparseMatrix> Fa_sparse() const { return Fa_sparse_; }
+    std::shared_ptr<BlockSparseMatrix> Fb_sparse() const { return Fb_sparse_; }
+
     // Set guess occupied orbitals, nalpha and nbeta will be taken from the number of passed in eigenvectors
     void guess_Ca(SharedMatrix Ca) { guess_Ca_ = Ca; }
     void guess_Cb(SharedMatrix Cb) { guess_Cb_ = Cb; }
@@ -401,6 +523,13 @@ class HF : public Wavefunction {
     void set_sad_fitting_basissets(std::vector<std::shared_ptr<BasisSet>> basis_vec) {
         sad_fitting_basissets_ = basis_vec;
     }
+    void set_frag_basissets(std::vector<std::shared_ptr<BasisSet>> basis_vec, std::vector<std::vector<int>> atoms) {
+        frag_basissets_ = basis_vec;
+        frag_atoms_ = atoms;
+    }
+    void set_frag_fitting_basissets(std::vector<std::shared_ptr<BasisSet>> basis_vec) {
+        frag_fitting_basissets_ = basis_vec;
+    }
 
     // Energies data
     void set_energies(std::string key, double value) { energies_[key] = value; }
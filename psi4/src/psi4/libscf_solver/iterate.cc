@@ -0,0 +1,311 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*
+ * iterate.cc: the SCF iteration loop of scf_iterate() (driver/procrouting/scf_proc/scf_iterator.py)
+ * without the round trips through Python, for high-throughput runs of many small jobs.
+ * Both loops have to stay in step: same order of form_G/form_F/DIIS/SOSCF/form_C/form_D,
+ * the same MOM/FRAC/damping triggers and the same iteration printout.
+ * EFP and PCM only exist on the Python side, so the driver keeps those jobs on scf_iterate().
+ */
+
+#include "hf.h"
+
+#include "psi4/libdiis/diismanager.h"
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libfock/jk.h"
+#include "psi4/libfunctional/superfunctional.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace psi {
+namespace scf {
+
+void HF::begin_iteration_stats() {
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    stats_start_ = std::chrono::steady_clock::now();
+    stats_jk_time_ = jk_ ? jk_->compute_time() : 0.0;
+    stats_v_time_ = v_time_;
+    stats_io_bytes_ = psio->bytes_read() + psio->bytes_written();
+    stats_quartets_computed_ = jk_ ? jk_->quartets_computed() : 0;
+    stats_quartets_skipped_ = jk_ ? jk_->quartets_skipped() : 0;
+}
+
+SCFIterationStats HF::end_iteration_stats(double energy, double delta_e, double d_rms, double diis_time,
+                                          const std::string& status) {
+    std::shared_ptr<PSIO> psio = PSIO::shared_object();
+    SCFIterationStats stats;
+    stats.iteration = iteration_;
+    stats.energy = energy;
+    stats.delta_e = delta_e;
+    stats.d_rms = d_rms;
+    stats.total_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - stats_start_).count();
+    stats.jk_time = jk_ ? jk_->compute_time() - stats_jk_time_ : 0.0;
+    stats.v_time = v_time_ - stats_v_time_;
+    stats.diis_time = diis_time;
+    stats.io_bytes = psio->bytes_read() + psio->bytes_written() - stats_io_bytes_;
+
+    // The counters restart with each preiterations(), so only trust them if they grew
+    if (jk_ && jk_->quartets_computed() >= stats_quartets_computed_ &&
+        jk_->quartets_skipped() >= stats_quartets_skipped_) {
+        double computed = jk_->quartets_computed() - stats_quartets_computed_;
+        double skipped = jk_->quartets_skipped() - stats_quartets_skipped_;
+        if (computed + skipped > 0.0) stats.screened_fraction = skipped / (computed + skipped);
+    }
+
+    stats.scf_type = options_.get_str("SCF_TYPE");
+    stats.status = status;
+    iteration_stats_.push_back(stats);
+    return stats;
+}
+
+void HF::print_iteration_stats() const {
+    outfile->Printf("  ==> Iteration Telemetry <==\n\n");
+    outfile->Printf("    %4s %-8s %10s %10s %10s %10s %9s %12s  %s\n\n", "Iter", "SCF_TYPE", "Total [s]", "JK [s]",
+                    "V [s]", "DIIS [s]", "Screened", "I/O [MiB]", "Status");
+    for (const SCFIterationStats& stats : iteration_stats_) {
+        std::string screened = "-";
+        if (stats.screened_fraction >= 0.0) {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%.1f%%", 100.0 * stats.screened_fraction);
+            screened = buffer;
+        }
+        outfile->Printf("    %4d %-8s %10.3f %10.3f %10.3f %10.3f %9s %12.1f  %s\n", stats.iteration,
+                        stats.scf_type.c_str(), stats.total_time, stats.jk_time, stats.v_time, stats.diis_time,
+                        screened.c_str(), stats.io_bytes / 1048576.0, stats.status.c_str());
+    }
+    outfile->Printf("\n");
+}
+
+bool HF::reset_stalled_diis() {
+    if (!options_.get_bool("SCF_ADAPTIVE") || !initialized_diis_manager_) return false;
+
+    // The last few iterations must all be DIIS steps of the same engine since the last reset
+    const int window = 4;
+    int n = iteration_stats_.size();
+    if (n < window || iteration_ - last_diis_reset_ < window) return false;
+    const SCFIterationStats& first = iteration_stats_[n - window];
+    const SCFIterationStats& last = iteration_stats_[n - 1];
+    for (int i = n - window; i < n; i++) {
+        const SCFIterationStats& stats = iteration_stats_[i];
+        if (stats.scf_type != last.scf_type || stats.status.find("DIIS") == std::string::npos) return false;
+    }
+
+    // Stalled if the orbital gradient shrinks by less than 10% per iteration
+    if (first.d_rms <= 0.0) return false;
+    double rate = std::pow(last.d_rms / first.d_rms, 1.0 / (window - 1));
+    if (rate < 0.9) return false;
+
+    diis_manager_->reset_subspace();
+    last_diis_reset_ = iteration_;
+    outfile->Printf("   DIIS stalled (orbital gradient ratio %.2f per iteration), subspace reset.\n", rate);
+    return true;
+}
+
+std::tuple<bool, double, double> HF::iterate(double e_conv, double d_conv) {
+    bool is_dfjk = (scf_type_.size() >= 2 && scf_type_.compare(scf_type_.size() - 2, 2, "DF") == 0);
+    int verbose = options_.get_int("PRINT");
+    std::string reference = options_.get_str("REFERENCE");
+
+    // diis_enabled_, diis_start_ and MOM_excited_ were validated and set by the driver
+    bool damping_enabled = (options_.get_double("DAMPING_PERCENTAGE") > 0.0);
+    bool soscf_enabled = options_.get_bool("SOSCF");
+    bool frac_enabled = (options_.get_int("FRAC_START") != 0);
+    int diis_min_vecs = options_.get_int("DIIS_MIN_VECS");
+    int diis_max_vecs = options_.get_int("DIIS_MAX_VECS");
+    int maxiter = options_.get_int("MAXITER");
+
+    auto converged = [&](double e_delta, double d_rms) { return (std::fabs(e_delta) < e_conv && d_rms < d_conv); };
+
+    double SCFE_old = 0.0;
+    double SCFE = 0.0;
+    double Ediff = 0.0;
+    double Drms = 0.0;
+    while (true) {
+        iteration_++;
+
+        bool diis_performed = false;
+        bool soscf_performed = false;
+        frac_performed_ = false;
+
+        save_density_and_energy();
+        begin_iteration_stats();
+        double diis_time = 0.0;
+
+        clear_external_potentials();
+
+        timer_on("HF: Form G");
+        form_G();
+        timer_off("HF: Form G");
+
+        // reset fractional SAD occupation
+        if ((iteration_ == 0) && reset_occ_) reset_occupation();
+
+        set_variable("PCM POLARIZATION ENERGY", 0.0);
+        set_energies("PCM Polarization", 0.0);
+
+        timer_on("HF: Form F");
+        form_F();
+        timer_off("HF: Form F");
+
+        if (verbose > 3) {
+            Fa_->print();
+            Fb_->print();
+        }
+
+        SCFE = compute_E();
+        set_energies("Total Energy", SCFE);
+        Ediff = SCFE - SCFE_old;
+        SCFE_old = SCFE;
+
+        std::vector<std::string> status;
+
+        // We either do SOSCF or DIIS
+        if (soscf_enabled && (iteration_ > 3) && (Drms < options_.get_double("SOSCF_START_CONVERGENCE"))) {
+            Drms = compute_orbital_gradient(false, diis_max_vecs);
+            std::string base_name = (functional_->needs_xc() ? "SOKS, nmicro=" : "SOSCF, nmicro=");
+
+            if (!converged(Ediff, Drms)) {
+                int nmicro = soscf_update(options_.get_double("SOSCF_CONV"), options_.get_int("SOSCF_MIN_ITER"),
+                                          options_.get_int("SOSCF_MAX_ITER"), options_.get_bool("SOSCF_PRINT"));
+                if (nmicro > 0) {
+                    // if zero, the soscf call bounced for some reason
+                    find_occupation();
+                    status.push_back(base_name + std::to_string(nmicro));
+                    soscf_performed = true;  // Stops DIIS
+                } else {
+                    if (verbose > 0) {
+                        outfile->Printf("Did not take a SOSCF step, using normal convergence methods\n");
+                    }
+                    soscf_performed = false;  // Back to DIIS
+                }
+            } else {
+                // need to ensure orthogonal orbitals and set epsilon
+                status.push_back(base_name + "conv");
+                timer_on("HF: Form C");
+                form_C();
+                timer_off("HF: Form C");
+                soscf_performed = true;  // Stops DIIS
+            }
+        }
+
+        if (!soscf_performed) {
+            // Normal convergence procedures if we do not do SOSCF
+            timer_on("HF: DIIS");
+            auto diis_start = std::chrono::steady_clock::now();
+            bool add_to_diis_subspace = (diis_enabled_ && iteration_ >= diis_start_);
+
+            Drms = compute_orbital_gradient(add_to_diis_subspace, diis_max_vecs);
+
+            if (diis_enabled_ && iteration_ >= diis_start_ + diis_min_vecs - 1) {
+                diis_performed = diis();
+            }
+
+            if (diis_performed) status.push_back("DIIS");
+
+            diis_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - diis_start).count();
+            timer_off("HF: DIIS");
+
+            if (verbose > 4 && diis_performed) {
+                outfile->Printf("  After DIIS:\n");
+                Fa_->print();
+                Fb_->print();
+            }
+
+            // frac, MOM invoked here from HF::find_occupation
+            timer_on("HF: Form C");
+            form_C();
+            timer_off("HF: Form C");
+        }
+
+        if (MOM_performed_) status.push_back("MOM");
+
+        if (frac_performed_) status.push_back("FRAC");
+
+        timer_on("HF: Form D");
+        form_D();
+        timer_off("HF: Form D");
+
+        Process::environment.globals["SCF ITERATION ENERGY"] = SCFE;
+
+        // After we've built the new D, damp the update
+        if (damping_enabled && iteration_ > 1 && Drms > options_.get_double("DAMPING_CONVERGENCE")) {
+            double damping_percentage = options_.get_double("DAMPING_PERCENTAGE");
+            damping_update(damping_percentage * 0.01);
+            status.push_back("DAMP=" + std::to_string((int)std::round(damping_percentage)) + "%");
+        }
+
+        if (verbose > 3) {
+            Ca_->print();
+            Cb_->print();
+            Da_->print();
+            Db_->print();
+        }
+
+        // Print out the iteration
+        std::string status_line;
+        for (size_t i = 0; i < status.size(); i++) status_line += (i ? "/" : "") + status[i];
+        outfile->Printf("   @%s%s iter %3d: %20.14f   %12.5e   %-11.5e %s\n", (is_dfjk ? "DF-" : ""),
+                        reference.c_str(), iteration_, SCFE, Ediff, Drms, status_line.c_str());
+        end_iteration_stats(SCFE, Ediff, Drms, diis_time, status_line);
+        reset_stalled_diis();
+
+        // Only hop back to Python if someone asked for it
+        if (iteration_callback_) iteration_callback_(iteration_);
+
+        // if a an excited MOM is requested but not started, don't stop yet
+        if (MOM_excited_ && !MOM_performed_) continue;
+
+        // if a fractional occupation is requested but not started, don't stop yet
+        if (frac_enabled && !frac_performed_) continue;
+
+        if (converged(Ediff, Drms)) {
+            if (purify_) {
+                // Purification built D only; diagonalize the converged Fock matrix once for the orbitals
+                purify_ = false;
+                form_C();
+                form_D();
+            }
+            return std::make_tuple(true, Ediff, Drms);
+        }
+        if (iteration_ >= maxiter) return std::make_tuple(false, Ediff, Drms);
+    }
+}
+
+}  // namespace scf
+}  // namespace psi
@@ -92,6 +92,7 @@ void HF::MOM_start() {
         diis_manager_->delete_diis_file();
         diis_manager_.reset();
         initialized_diis_manager_ = false;
+        initial_accelerator_.reset();
     }
 
     // Find out which orbitals are where
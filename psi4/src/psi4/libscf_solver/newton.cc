@@ -0,0 +1,236 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/*
+ * newton.cc: truncated-Newton SOSCF step (SOSCF_SOLVER NEWTON).
+ * H x = g is solved in a growing subspace; every new batch of trial vectors
+ * goes through a single cphf_Hx(), i.e. one JK build. The first batch holds the
+ * preconditioned gradient and the previous macroiteration's step, later ones
+ * the preconditioned residual. The residual target is loose far from
+ * convergence and tightens to SOSCF_CONV as the orbital gradient falls, and
+ * the orbital-energy preconditioner is level shifted so near-degenerate
+ * occupied/virtual pairs (typical of transition-metal SCFs) cannot dominate the
+ * trial vectors.
+ */
+
+#include "hf.h"
+
+#include "psi4/liboptions/liboptions.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+namespace psi {
+namespace scf {
+
+namespace {
+
+typedef std::vector<SharedMatrix> Block;
+
+double block_dot(const Block& x, const Block& y) {
+    double value = 0.0;
+    for (size_t b = 0; b < x.size(); b++) value += x[b]->vector_dot(y[b]);
+    return value;
+}
+
+Block block_clone(const Block& x) {
+    Block y;
+    for (size_t b = 0; b < x.size(); b++) y.push_back(x[b]->clone());
+    return y;
+}
+
+void block_axpy(double alpha, const Block& x, Block& y) {
+    for (size_t b = 0; b < x.size(); b++) y[b]->axpy(alpha, x[b]);
+}
+
+}  // namespace
+
+SharedMatrix HF::soscf_denominator(SharedMatrix C, SharedMatrix F, const Dimension& noccpi) const {
+    SharedMatrix IFock = Matrix::triplet(C, F, C, true, false, false);
+    Dimension virpi = nmopi_ - noccpi;
+    auto denom = std::make_shared<Matrix>("SOSCF Denominator", nirrep_, noccpi, virpi);
+
+    for (int h = 0; h < nirrep_; h++) {
+        if (!noccpi[h] || !virpi[h]) continue;
+        double** dp = denom->pointer(h);
+        double** fp = IFock->pointer(h);
+        for (int i = 0; i < noccpi[h]; i++) {
+            for (int a = 0; a < virpi[h]; a++) {
+                dp[i][a] = fp[noccpi[h] + a][noccpi[h] + a] - fp[i][i];
+            }
+        }
+    }
+    return denom;
+}
+
+std::vector<SharedMatrix> HF::soscf_newton(const std::vector<SharedMatrix>& gradient,
+                                           const std::vector<SharedMatrix>& denominator, int min_iter, int max_iter,
+                                           bool print) {
+    time_t start = time(nullptr);
+    cphf_converged_ = false;
+    cphf_nfock_builds_ = 0;
+
+    size_t nblock = gradient.size();
+    double conv = options_.get_double("SOSCF_CONV");
+    double level_shift = options_.get_double("SOSCF_LEVEL_SHIFT");
+
+    // Level-shifted preconditioner
+    Block precon;
+    for (size_t b = 0; b < nblock; b++) {
+        SharedMatrix P = denominator[b]->clone();
+        for (int h = 0; h < P->nirrep(); h++) {
+            size_t size = (size_t)P->rowspi()[h] * P->colspi()[h];
+            double* pp = (size ? P->pointer(h)[0] : nullptr);
+            for (size_t ia = 0; ia < size; ia++) pp[ia] = std::max(std::max(pp[ia], 0.0) + level_shift, 1.0E-4);
+        }
+        precon.push_back(P);
+    }
+    auto precondition = [&](const Block& r) {
+        Block z = block_clone(r);
+        for (size_t b = 0; b < nblock; b++) z[b]->apply_denominator(precon[b]);
+        return z;
+    };
+
+    // Truncated Newton: loose far from convergence, SOSCF_CONV once the gradient is small
+    size_t nelem = 0;
+    for (size_t b = 0; b < nblock; b++) nelem += gradient[b]->size();
+    double gnorm = std::sqrt(block_dot(gradient, gradient));
+    double tol = std::min(0.1, std::max(conv, std::sqrt(gnorm / std::sqrt((double)std::max(nelem, (size_t)1)))));
+
+    if (print) {
+        outfile->Printf("\n");
+        outfile->Printf("   ==> Truncated-Newton SOSCF <==\n\n");
+        outfile->Printf("    Maxiter             = %11d\n", max_iter);
+        outfile->Printf("    Residual target     = %11.3E\n", tol);
+        outfile->Printf("    Level shift         = %11.3E\n", level_shift);
+        outfile->Printf("   -----------------------------------------------------\n");
+        outfile->Printf("     %4s %14s %8s %8s  %6s\n", "Iter", "Residual Rel", "Trials", "Subspace", "Time [s]");
+        outfile->Printf("   -----------------------------------------------------\n");
+    }
+
+    std::vector<Block> trials;
+    trials.push_back(precondition(gradient));
+    // The last step is usually close to the new one, evaluate it in the same JK build
+    bool prev_valid = (soscf_prev_step_.size() == nblock);
+    for (size_t b = 0; prev_valid && b < nblock; b++) {
+        prev_valid = (soscf_prev_step_[b]->rowspi() == gradient[b]->rowspi()) &&
+                     (soscf_prev_step_[b]->colspi() == gradient[b]->colspi());
+    }
+    if (prev_valid) trials.push_back(block_clone(soscf_prev_step_));
+
+    std::vector<Block> V, HV;
+    std::vector<double> c;
+    Block x;
+    for (int iter = 1; iter <= max_iter; iter++) {
+        // Orthonormalize the trials against the subspace and each other, twice for stability
+        std::vector<Block> accepted;
+        for (size_t t = 0; t < trials.size(); t++) {
+            Block& v = trials[t];
+            double norm0 = std::sqrt(block_dot(v, v));
+            if (norm0 == 0.0) continue;
+            for (int pass = 0; pass < 2; pass++) {
+                for (size_t k = 0; k < V.size(); k++) block_axpy(-block_dot(V[k], v), V[k], v);
+                for (size_t k = 0; k < accepted.size(); k++) block_axpy(-block_dot(accepted[k], v), accepted[k], v);
+            }
+            double norm = std::sqrt(block_dot(v, v));
+            if (norm < 1.0E-8 * norm0) continue;
+            for (size_t b = 0; b < nblock; b++) v[b]->scale(1.0 / norm);
+            accepted.push_back(v);
+        }
+        if (accepted.empty()) break;
+
+        // One Hessian-vector product call, one JK build, for the whole batch
+        Block flat;
+        for (size_t t = 0; t < accepted.size(); t++) flat.insert(flat.end(), accepted[t].begin(), accepted[t].end());
+        Block Hflat = cphf_Hx(flat);
+        for (size_t t = 0; t < accepted.size(); t++) {
+            V.push_back(accepted[t]);
+            HV.push_back(Block(Hflat.begin() + t * nblock, Hflat.begin() + (t + 1) * nblock));
+        }
+        cphf_nfock_builds_ += accepted.size();
+
+        // Reduced problem (V^T H V) c = V^T g
+        int nsub = V.size();
+        std::vector<double> A(nsub * (size_t)nsub);
+        c.assign(nsub, 0.0);
+        for (int i = 0; i < nsub; i++) {
+            c[i] = block_dot(V[i], gradient);
+            for (int j = 0; j <= i; j++) {
+                double Aij = 0.5 * (block_dot(V[i], HV[j]) + block_dot(V[j], HV[i]));
+                A[i * nsub + j] = A[j * nsub + i] = Aij;
+            }
+        }
+        std::vector<int> ipiv(nsub);
+        if (C_DGESV(nsub, 1, A.data(), nsub, ipiv.data(), c.data(), nsub)) {
+            throw PSIEXCEPTION("HF::soscf_newton: singular subspace Hessian.");
+        }
+
+        x = block_clone(gradient);
+        Block r = block_clone(gradient);
+        for (size_t b = 0; b < nblock; b++) x[b]->zero();
+        for (int k = 0; k < nsub; k++) {
+            block_axpy(c[k], V[k], x);
+            block_axpy(-c[k], HV[k], r);
+        }
+        double rel = (gnorm > 0.0 ? std::sqrt(block_dot(r, r)) / gnorm : 0.0);
+
+        if (print) {
+            outfile->Printf("    %5d %14.3e %8zu %8d %9ld\n", iter, rel, accepted.size(), nsub,
+                            (long)(time(nullptr) - start));
+        }
+
+        if (rel < tol && iter >= min_iter) {
+            cphf_converged_ = true;
+            break;
+        }
+        trials.clear();
+        trials.push_back(precondition(r));
+    }
+
+    if (print) {
+        outfile->Printf("   -----------------------------------------------------\n");
+        outfile->Printf("    %s after %d Hessian-vector products.\n\n", (cphf_converged_ ? "Converged" : "Truncated"),
+                        cphf_nfock_builds_);
+    }
+
+    if (x.empty()) {
+        x = block_clone(gradient);
+        for (size_t b = 0; b < nblock; b++) x[b]->zero();
+    }
+    soscf_prev_step_ = block_clone(x);
+    return x;
+}
+
+}  // namespace scf
+}  // namespace psi
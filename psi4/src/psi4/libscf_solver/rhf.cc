@@ -101,6 +101,7 @@ void RHF::common_init() {
 
     same_a_b_dens_ = true;
     same_a_b_orbs_ = true;
+    purified_ = false;
 }
 
 void RHF::finalize() {
@@ -162,8 +163,10 @@ void RHF::form_V() {
     // // Pull the V matrices off
     // const std::vector<SharedMatrix> & V = potential_->V();
     // Va_ = V[0];
+    auto start = std::chrono::steady_clock::now();
     potential_->set_D({D_});
     potential_->compute_V({Va_});
+    v_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     Vb_ = Va_;
 }
 void RHF::form_G() {
@@ -174,10 +177,15 @@ void RHF::form_G() {
         G_->zero();
     }
 
-    /// Push the C matrix on
+    /// Push the C matrix on; a purified D has no orbitals, so hand JK its Cholesky factor instead
     std::vector<SharedMatrix>& C = jk_->C_left();
     C.clear();
-    C.push_back(Ca_subset("SO", "OCC"));
+    if (purified_) {
+        C.push_back(D_->partial_cholesky_factorize(options_.get_double("PURIFICATION_CONVERGENCE")));
+    } else {
+        C.push_back(Ca_subset("SO", "OCC"));
+    }
+    form_sparse_D({D_});
 
     // Run the JK object
     jk_->compute();
@@ -218,23 +226,20 @@ double RHF::compute_orbital_gradient(bool save_fock, int max_diis_vectors) {
 
     if (save_fock) {
         if (initialized_diis_manager_ == false) {
-            if (scf_type_ == "DIRECT") {
-                diis_manager_ = std::make_shared<DIISManager>(max_diis_vectors, "HF DIIS vector",
-                                                              DIISManager::LargestError, DIISManager::InCore);
-            } else {
-                diis_manager_ = std::make_shared<DIISManager>(max_diis_vectors, "HF DIIS vector",
-                                                              DIISManager::LargestError, DIISManager::OnDisk);
-            }
+            diis_manager_ = make_diis_manager(max_diis_vectors, scf_type_ == "DIRECT");
             diis_manager_->set_error_vector_size(1, DIISEntry::Matrix, gradient.get());
             diis_manager_->set_vector_size(1, DIISEntry::Matrix, Fa_.get());
             initialized_diis_manager_ = true;
         }
         diis_manager_->add_entry(2, gradient.get(), Fa_.get());
+        add_to_initial_accelerator({Da_}, {Fa_}, 2.0, gradient->absmax(), max_diis_vectors);
     }
     return gradient->rms();
 }
 
-bool RHF::diis() { return diis_manager_->extrapolate(1, Fa_.get()); }
+bool RHF::diis() {
+    return accelerated_extrapolate({Fa_}, [this]() { return diis_manager_->extrapolate(1, Fa_.get()); });
+}
 
 void RHF::form_F() {
     Fa_->copy(H_);
@@ -242,6 +247,7 @@ void RHF::form_F() {
     for (const auto& Vext : external_potentials_) {
         Fa_->add(Vext);
     }
+    form_sparse_F({Fa_});
 
     if (debug_) {
         Fa_->print();
@@ -255,11 +261,109 @@ void RHF::form_F() {
 }
 
 void RHF::form_C() {
+    // The guess iteration still diagonalizes, fixing doccpi_ for purify_density()
+    if (purify_ && iteration_ > 0) return;
     diagonalize_F(Fa_, Ca_, epsilon_a_);
     find_occupation();
 }
 
+void RHF::purify_density() {
+    double conv = options_.get_double("PURIFICATION_CONVERGENCE");
+    int maxiter = options_.get_int("PURIFICATION_MAXITER");
+
+    // Fock matrix in the orthogonal basis, F' = X^T F X
+    SharedMatrix Fp = Matrix::triplet(X_, Fa_, X_, true, false, false);
+    auto P = std::make_shared<Matrix>("P", nmopi_, nmopi_);
+
+    for (int h = 0; h < nirrep_; ++h) {
+        int n = nmopi_[h];
+        int nocc = doccpi_[h];
+        if (n == 0 || nocc == 0) continue;
+
+        double** Pp = P->pointer(h);
+        if (nocc == n) {
+            for (int i = 0; i < n; i++) Pp[i][i] = 1.0;
+            continue;
+        }
+
+        // Gershgorin bounds on the spectrum of F', mapped onto [0, 1] with the occupied end at 1
+        double** Fhp = Fp->pointer(h);
+        double emin = Fhp[0][0];
+        double emax = Fhp[0][0];
+        for (int i = 0; i < n; i++) {
+            double radius = 0.0;
+            for (int j = 0; j < n; j++) {
+                if (j != i) radius += std::fabs(Fhp[i][j]);
+            }
+            emin = std::min(emin, Fhp[i][i] - radius);
+            emax = std::max(emax, Fhp[i][i] + radius);
+        }
+        double scale = 1.0 / (emax - emin);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++) Pp[i][j] = -scale * Fhp[i][j];
+            Pp[i][i] += scale * emax;
+        }
+
+        // TRS4: P <- F(P) + gamma G(P), F(x) = 4x^3 - 3x^4, G(x) = x^2 (1 - x)^2, with gamma fixing tr P = nocc.
+        // tr P^3 and tr P^4 follow from P^2 by dot products, so a step costs at most two GEMMs.
+        auto P2 = std::make_shared<Matrix>("P2", n, n);
+        auto M = std::make_shared<Matrix>("M", n, n);
+        double** P2p = P2->pointer();
+        double** Mp = M->pointer();
+        size_t nn = (size_t)n * n;
+        int iter = 0;
+        double idem = 0.0;
+        for (; iter < maxiter; iter++) {
+            C_DGEMM('N', 'N', n, n, n, 1.0, Pp[0], n, Pp[0], n, 0.0, P2p[0], n);
+            double tr2 = 0.0;
+            for (int i = 0; i < n; i++) tr2 += P2p[i][i];
+            double tr3 = C_DDOT(nn, P2p[0], 1, Pp[0], 1);
+            double tr4 = C_DDOT(nn, P2p[0], 1, P2p[0], 1);
+
+            double trF = 4.0 * tr3 - 3.0 * tr4;
+            idem = tr2 - 2.0 * tr3 + tr4;
+            if (idem < conv) break;
+
+            double gamma = (nocc - trF) / idem;
+            if (gamma > 6.0) {
+                // P <- 2P - P^2
+                C_DSCAL(nn, 2.0, Pp[0], 1);
+                C_DAXPY(nn, -1.0, P2p[0], 1, Pp[0], 1);
+            } else if (gamma < 0.0) {
+                // P <- P^2
+                C_DCOPY(nn, P2p[0], 1, Pp[0], 1);
+            } else {
+                // P <- P^2 [gamma + (4 - 2 gamma) P + (gamma - 3) P^2]
+                C_DCOPY(nn, Pp[0], 1, Mp[0], 1);
+                C_DSCAL(nn, 4.0 - 2.0 * gamma, Mp[0], 1);
+                C_DAXPY(nn, gamma - 3.0, P2p[0], 1, Mp[0], 1);
+                for (int i = 0; i < n; i++) Mp[i][i] += gamma;
+                C_DGEMM('N', 'N', n, n, n, 1.0, P2p[0], n, Mp[0], n, 0.0, Pp[0], n);
+            }
+        }
+        if (iter == maxiter) {
+            outfile->Printf("  Warning: TRS4 purification of irrep %d stopped after %d steps, tr[P^2(1-P)^2] = %.3e\n",
+                            h, maxiter, idem);
+        } else if (print_ > 2) {
+            outfile->Printf("  TRS4 purification of irrep %d converged in %d steps\n", h, iter);
+        }
+    }
+
+    // Back to the SO basis, D = X P X^T
+    D_->copy(Matrix::triplet(X_, P, X_, false, false, true));
+}
+
 void RHF::form_D() {
+    purified_ = purify_ && iteration_ > 0;
+    if (purified_) {
+        purify_density();
+        if (debug_) {
+            outfile->Printf("in RHF::form_D (purified):\n");
+            D_->print();
+        }
+        return;
+    }
+
     D_->zero();
 
     for (int h = 0; h < nirrep_; ++h) {
@@ -427,10 +531,8 @@ std::vector<SharedMatrix> RHF::twoel_Hx(std::vector<SharedMatrix> x_vec, bool co
 
     // Compute Ipqrs,K_rs -> J and IprqsK_rs -> K
     // K = Co x Cv.T
-    std::vector<SharedMatrix>& Cl = jk_->C_left();
-    std::vector<SharedMatrix>& Cr = jk_->C_right();
-    Cl.clear();
-    Cr.clear();
+    std::vector<SharedMatrix> Cl;
+    std::vector<SharedMatrix> Cr;
 
     SharedMatrix Co, Cv;
     for (size_t i = 0; i < x_vec.size(); i++) {
@@ -455,11 +557,8 @@ std::vector<SharedMatrix> RHF::twoel_Hx(std::vector<SharedMatrix> x_vec, bool co
     }
 
     // Compute JK
-    jk_->compute();
-
-    const std::vector<SharedMatrix>& J = jk_->J();
-    const std::vector<SharedMatrix>& K = jk_->K();
-    const std::vector<SharedMatrix>& wK = jk_->wK();
+    std::vector<SharedMatrix> J, K, wK;
+    jk_->compute_batch(Cl, Cr, J, K, wK);
 
     std::vector<SharedMatrix> Vx;
     if (functional_->needs_xc()) {
@@ -806,7 +905,13 @@ int RHF::soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter,
         return 0;
     }
 
-    std::vector<SharedMatrix> ret_x = cphf_solve({Gradient}, soscf_conv, soscf_max_iter, soscf_print ? 2 : 0);
+    std::vector<SharedMatrix> ret_x;
+    if (options_.get_str("SOSCF_SOLVER") == "NEWTON") {
+        SharedMatrix denom = soscf_denominator(Ca_, Fa_, nalphapi_);
+        ret_x = soscf_newton({Gradient}, {denom}, soscf_min_iter, soscf_max_iter, soscf_print);
+    } else {
+        ret_x = cphf_solve({Gradient}, soscf_conv, soscf_max_iter, soscf_print ? 2 : 0);
+    }
 
     // => Rotate orbitals <= //
     rotate_orbitals(Ca_, ret_x[0]);
@@ -46,7 +46,12 @@ class RHF : public HF {
     SharedMatrix K_;
     SharedMatrix wK_;
 
+    /// Was D_ last built by purify_density()? Then form_G() factors D_ for the JK object
+    bool purified_;
+
     double compute_initial_E();
+    /// TRS4 purification of X^T F X on each irrep; builds D_ without orbitals
+    void purify_density();
 
     void common_init();
 
@@ -38,12 +38,20 @@
 #include <cstdio>
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <vector>
 #include <utility>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
 
 #include "psi4/psifiles.h"
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libpsio/psio.h"
+#include "psi4/libpsio/psio.hpp"
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/libqt/qt.h"
 #include "psi4/psifiles.h"
@@ -64,11 +72,93 @@
 #include "hf.h"
 #include "sad.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace psi;
 
 namespace psi {
 namespace scf {
 
+namespace {
+
+// FNV-1a over the raw bytes of everything that determines an atomic SAD density
+class CacheHasher {
+   public:
+    template <typename T>
+    void add(const T& value) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            hash_ ^= bytes[i];
+            hash_ *= 1099511628211ULL;
+        }
+    }
+    void add(const std::string& value) {
+        for (char c : value) add(c);
+        add(value.size());
+    }
+    void add(const std::shared_ptr<BasisSet>& bas) {
+        add(bas->nshell());
+        for (int P = 0; P < bas->nshell(); P++) {
+            const GaussianShell& shell = bas->shell(P);
+            add(shell.am());
+            add(shell.is_pure());
+            add(shell.nprimitive());
+            for (int K = 0; K < shell.nprimitive(); K++) {
+                add(shell.exp(K));
+                add(shell.original_coef(K));
+            }
+        }
+    }
+    std::string hex() const {
+        std::stringstream ss;
+        ss << std::hex << std::setw(16) << std::setfill('0') << hash_;
+        return ss.str();
+    }
+
+   private:
+    uint64_t hash_ = 14695981039346656037ULL;
+};
+
+const int SAD_CACHE_VERSION = 1;
+
+bool read_cached_density(const std::string& file, SharedMatrix D) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) return false;
+    int version = 0, nbf = 0;
+    in.read(reinterpret_cast<char*>(&version), sizeof(int));
+    in.read(reinterpret_cast<char*>(&nbf), sizeof(int));
+    if (!in || version != SAD_CACHE_VERSION || nbf != D->rowspi()[0]) return false;
+    std::vector<double> buffer((size_t)nbf * nbf);
+    in.read(reinterpret_cast<char*>(buffer.data()), buffer.size() * sizeof(double));
+    if (!in) return false;
+    if (nbf) ::memcpy(D->pointer()[0], buffer.data(), buffer.size() * sizeof(double));
+    return true;
+}
+
+void write_cached_density(const std::string& file, SharedMatrix D) {
+    // Write under a private name, then rename, so concurrent jobs never see a partial file
+    std::string tmp = file + "." + psio_getpid() + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) return;
+        int version = SAD_CACHE_VERSION;
+        int nbf = D->rowspi()[0];
+        out.write(reinterpret_cast<const char*>(&version), sizeof(int));
+        out.write(reinterpret_cast<const char*>(&nbf), sizeof(int));
+        if (nbf) out.write(reinterpret_cast<const char*>(D->pointer()[0]), (size_t)nbf * nbf * sizeof(double));
+        if (!out) {
+            out.close();
+            std::remove(tmp.c_str());
+            return;
+        }
+    }
+    if (std::rename(tmp.c_str(), file.c_str())) std::remove(tmp.c_str());
+}
+
+}  // namespace
+
 SADGuess::SADGuess(std::shared_ptr<BasisSet> basis, std::vector<std::shared_ptr<BasisSet>> atomic_bases, int nalpha,
                    int nbeta, Options& options)
     : basis_(basis), atomic_bases_(atomic_bases), nalpha_(nalpha), nbeta_(nbeta), options_(options) {
@@ -97,7 +187,11 @@ void SADGuess::compute_guess() {
 }
 void SADGuess::form_D() {
     // Build Neutral D in AO basis (block diagonal)
-    SharedMatrix DAO = form_D_AO();
+    npair_ = 0.0;
+    for (int A = 0; A < molecule_->natom(); A++) {
+        npair_ += 0.5 * molecule_->Z(A);
+    }
+    SharedMatrix DAO = fragment_bases_.empty() ? form_D_AO() : form_D_fragments();
 
     // Transform Neutral D from AO to SO basis
     Da_ = std::make_shared<Matrix>("Da SAD", AO2SO_->colspi(), AO2SO_->colspi());
@@ -118,11 +212,7 @@ void SADGuess::form_D() {
     delete[] temp;
 
     // Scale Da to true electron count
-    double npair = 0.0;
-    for (int A = 0; A < molecule_->natom(); A++) {
-        npair += 0.5 * molecule_->Z(A);
-    }
-    Da_->scale(((double)nalpha_) / npair);
+    Da_->scale(((double)nalpha_) / npair_);
 
     // Build/Scale Db if needed
     if (nalpha_ == nbeta_) {
@@ -244,20 +334,55 @@ SharedMatrix SADGuess::form_D_AO() {
         atomic_D.push_back(dtmp);
     }
 
+    bool use_df = options_.get_str("SAD_SCF_TYPE") == "DF";
+    std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
+
+    // Pick up atomic densities computed by earlier jobs
+    std::vector<std::string> cache_files(nunique);
+    std::vector<int> todo;
+    if (options_.get_bool("SAD_CACHE")) {
+        std::string cache_dir = options_.get_str("SAD_CACHE_DIR");
+        if (cache_dir.empty()) cache_dir = PSIOManager::shared_object()->get_default_path();
+        if (cache_dir.back() != '/') cache_dir += "/";
+        for (int A = 0; A < nunique; A++) {
+            int index = atomic_indices[A];
+            cache_files[A] = cache_dir + "psi.sad." + sad_cache_key(index, use_df ? atomic_fit_bases_[index] : zbas,
+                                                                   nelec[index], nhigh[index]) + ".dat";
+            if (read_cached_density(cache_files[A], atomic_D[A])) {
+                if (print_ > 1) outfile->Printf("  Atomic density for Unique Atom %d read from SAD cache\n", A);
+            } else {
+                todo.push_back(A);
+            }
+        }
+    } else {
+        for (int A = 0; A < nunique; A++) todo.push_back(A);
+    }
+
+    // The remaining atomic UHFs are independent; run them side by side with single-threaded JK objects
+    int nconcurrent = 1;
+#ifdef _OPENMP
+    if (print_ <= 1) nconcurrent = std::max(1, std::min(Process::environment.get_n_threads(), (int)todo.size()));
+#endif
+
     if (print_ > 1) outfile->Printf("\n  Performing Atomic UHF Computations:\n");
-    for (int A = 0; A < nunique; A++) {
+    std::exception_ptr failure;
+#pragma omp parallel for schedule(dynamic) num_threads(nconcurrent)
+    for (int task = 0; task < (int)todo.size(); task++) {
+        int A = todo[task];
         int index = atomic_indices[A];
         if (print_ > 1) outfile->Printf("\n  UHF Computation for Unique Atom %d which is Atom %d:", A, index);
 
-        if (options_.get_str("SAD_SCF_TYPE") == "DF") {
-            get_uhf_atomic_density(atomic_bases_[index], atomic_fit_bases_[index], nelec[index], nhigh[index],
-                                   atomic_D[A]);
-        } else {
-            std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
-            get_uhf_atomic_density(atomic_bases_[index], zbas, nelec[index], nhigh[index], atomic_D[A]);
+        try {
+            get_uhf_atomic_density(atomic_bases_[index], use_df ? atomic_fit_bases_[index] : zbas, nelec[index],
+                                   nhigh[index], atomic_D[A], nconcurrent);
+            if (!cache_files[A].empty()) write_cached_density(cache_files[A], atomic_D[A]);
+        } catch (...) {
+#pragma omp critical
+            failure = std::current_exception();
         }
         if (print_ > 1) outfile->Printf("Finished UHF Computation!\n");
     }
+    if (failure) std::rethrow_exception(failure);
     if (print_) outfile->Printf("\n");
 
     // Add atomic_D into D (scale by 1/2, we like effective pairs)
@@ -277,8 +402,150 @@ SharedMatrix SADGuess::form_D_AO() {
 
     return DAO;
 }
+SharedMatrix SADGuess::form_D_fragments() {
+    int nfrag = fragment_bases_.size();
+    if (fragment_atoms_.size() != nfrag) throw PSIEXCEPTION("SAD: fragment bases and atom lists do not match.");
+    bool use_df = options_.get_str("SAD_SCF_TYPE") == "DF";
+    if (use_df && fragment_fit_bases_.size() != nfrag)
+        throw PSIEXCEPTION("SAD: fragment guess with SAD_SCF_TYPE DF needs a fitting basis per fragment.");
+    std::shared_ptr<BasisSet> zbas = BasisSet::zero_ao_basis_set();
+
+    // First basis function and count per atom, in the full and in each fragment basis
+    auto atom_functions = [](std::shared_ptr<BasisSet> bas) {
+        int natom = bas->molecule()->natom();
+        std::vector<int> first(natom, -1), count(natom, 0);
+        for (int s = 0; s < bas->nshell(); s++) {
+            int A = bas->shell_to_center(s);
+            if (first[A] < 0) first[A] = bas->shell_to_basis_function(s);
+            count[A] += bas->shell(s).nfunction();
+        }
+        return std::make_pair(first, count);
+    };
+    auto full = atom_functions(basis_);
+
+    std::vector<int> nelec(nfrag), nhigh(nfrag);
+    npair_ = 0.0;
+    for (int F = 0; F < nfrag; F++) {
+        std::shared_ptr<Molecule> fmol = fragment_bases_[F]->molecule();
+        if (fmol->natom() != fragment_atoms_[F].size())
+            throw PSIEXCEPTION("SAD: fragment molecule and atom list sizes differ.");
+        auto frag = atom_functions(fragment_bases_[F]);
+        double Z = 0.0;
+        for (int a = 0; a < fmol->natom(); a++) {
+            int A = fragment_atoms_[F][a];
+            if (A < 0 || A >= molecule_->natom()) throw PSIEXCEPTION("SAD: fragment atom out of range.");
+            if ((fmol->xyz(a) - molecule_->xyz(A)).norm() > 1.0E-6 || frag.second[a] != full.second[A])
+                throw PSIEXCEPTION("SAD: fragment atoms must match the full molecule in position and basis.");
+            Z += fmol->Z(a);
+        }
+        nelec[F] = (int)std::lround(Z) - fmol->molecular_charge();
+        nhigh[F] = fmol->multiplicity() - 1;
+        if (nelec[F] < 0 || (nelec[F] - nhigh[F]) % 2)
+            throw PSIEXCEPTION("SAD: fragment charge and multiplicity are inconsistent.");
+        npair_ += 0.5 * nelec[F];
+    }
+
+    // Largest fragments first, so the concurrent UHFs finish together
+    std::vector<int> todo(nfrag);
+    for (int F = 0; F < nfrag; F++) todo[F] = F;
+    std::sort(todo.begin(), todo.end(),
+              [&](int a, int b) { return fragment_bases_[a]->nbf() > fragment_bases_[b]->nbf(); });
+
+    std::vector<SharedMatrix> frag_D(nfrag);
+    for (int F = 0; F < nfrag; F++) {
+        int nbf = fragment_bases_[F]->nbf();
+        frag_D[F] = std::make_shared<Matrix>("Fragment D", nbf, nbf);
+    }
+
+    int nconcurrent = 1;
+#ifdef _OPENMP
+    if (print_ <= 1) nconcurrent = std::max(1, std::min(Process::environment.get_n_threads(), nfrag));
+#endif
+
+    if (print_) outfile->Printf("  Performing %d Fragment UHF Computations\n", nfrag);
+    std::exception_ptr failure;
+#pragma omp parallel for schedule(dynamic) num_threads(nconcurrent)
+    for (int task = 0; task < nfrag; task++) {
+        int F = todo[task];
+        if (print_ > 1) outfile->Printf("\n  UHF Computation for Fragment %d:", F + 1);
+        try {
+            if (nelec[F]) {
+                get_uhf_atomic_density(fragment_bases_[F], use_df ? fragment_fit_bases_[F] : zbas, nelec[F],
+                                       nhigh[F], frag_D[F], nconcurrent, false);
+            }
+        } catch (...) {
+#pragma omp critical
+            failure = std::current_exception();
+        }
+    }
+    if (failure) std::rethrow_exception(failure);
+
+    // Scatter the fragment blocks (scale by 1/2, effective pairs)
+    auto DAO = std::make_shared<Matrix>("D_FRAG (AO)", basis_->nbf(), basis_->nbf());
+    double** Dp = DAO->pointer();
+    for (int F = 0; F < nfrag; F++) {
+        auto frag = atom_functions(fragment_bases_[F]);
+        double** Fp = frag_D[F]->pointer();
+        for (int a = 0; a < fragment_atoms_[F].size(); a++) {
+            for (int b = 0; b < fragment_atoms_[F].size(); b++) {
+                int m0 = full.first[fragment_atoms_[F][a]], n0 = full.first[fragment_atoms_[F][b]];
+                int fm0 = frag.first[a], fn0 = frag.first[b];
+                for (int m = 0; m < frag.second[a]; m++)
+                    for (int n = 0; n < frag.second[b]; n++) Dp[m0 + m][n0 + n] = 0.5 * Fp[fm0 + m][fn0 + n];
+            }
+        }
+    }
+
+    // Neighboring fragments overlap, so the block-diagonal D is not idempotent in the full
+    // metric; McWeeny steps P <- 3 PSP - 2 PSPSP restore that while they keep improving it
+    int maxiter = options_.get_int("SAD_FRAG_PURIFY_MAXITER");
+    if (maxiter > 0) {
+        IntegralFactory integral(basis_, basis_, basis_, basis_);
+        std::unique_ptr<OneBodyAOInt> S_ints(integral.ao_overlap());
+        auto S = std::make_shared<Matrix>("S", basis_->nbf(), basis_->nbf());
+        S_ints->compute(S);
+        auto PS = DAO->clone();
+        auto PSP = DAO->clone();
+        double last = std::numeric_limits<double>::max();
+        for (int iter = 0; iter < maxiter; iter++) {
+            PS->gemm(false, false, 1.0, DAO, S, 0.0);
+            PSP->gemm(false, false, 1.0, PS, DAO, 0.0);
+            SharedMatrix err = PSP->clone();
+            err->subtract(DAO);
+            double rms = err->rms();
+            if (print_) outfile->Printf("  Fragment density purification %2d: |PSP - P| = %.3E\n", iter, rms);
+            if (rms > last || rms < 1.0E-10) break;
+            last = rms;
+            // P <- 3 PSP - 2 (PS)(PSP)
+            SharedMatrix next = PSP->clone();
+            next->scale(3.0);
+            next->gemm(false, false, -2.0, PS, PSP, 1.0);
+            DAO->copy(next);
+        }
+    }
+
+    if (debug_) {
+        DAO->print();
+    }
+    return DAO;
+}
+std::string SADGuess::sad_cache_key(int atom, std::shared_ptr<BasisSet> fit, int nelec, int nhigh) {
+    CacheHasher hasher;
+    hasher.add(SAD_CACHE_VERSION);
+    hasher.add(molecule_->Z(atom));
+    hasher.add(nelec);
+    hasher.add(nhigh);
+    hasher.add(atomic_bases_[atom]);
+    hasher.add(fit);
+    hasher.add(options_.get_str("SAD_SCF_TYPE"));
+    hasher.add(options_.get_bool("SAD_FRAC_OCC"));
+    hasher.add(options_.get_double("SAD_E_CONVERGENCE"));
+    hasher.add(options_.get_double("SAD_D_CONVERGENCE"));
+    hasher.add(options_.get_int("SAD_MAXITER"));
+    return hasher.hex();
+}
 void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared_ptr<BasisSet> fit, int nelec,
-                                      int nhigh, SharedMatrix D) {
+                                      int nhigh, SharedMatrix D, int nconcurrent, bool atomic) {
     std::shared_ptr<Molecule> mol = bas->molecule();
     mol->update_geometry();
     if (print_ > 1) {
@@ -301,7 +568,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         mol->print();
     }
 
-    if (natom != 1) {
+    if (atomic && natom != 1) {
         throw std::domain_error("SAD Atomic UHF has been given a molecule, not an atom");
     }
 
@@ -360,7 +627,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
 
     // Factional occupation
     SharedVector occ_a, occ_b;
-    if (options_.get_bool("SAD_FRAC_OCC")) {
+    if (atomic && options_.get_bool("SAD_FRAC_OCC")) {
         int nfzc = 0, nact = 0;
         if (Z <= 2) {
             nfzc = 0;
@@ -465,7 +732,11 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         throw PSIEXCEPTION(msg.str());
     }
 
-    jk->set_memory((size_t)(0.5 * (Process::environment.get_memory() / 8L)));
+    jk->set_memory((size_t)(0.5 * (Process::environment.get_memory() / 8L) / nconcurrent));
+    if (nconcurrent > 1) {
+        jk->set_omp_nthread(1);
+        if (options_.get_str("SAD_SCF_TYPE") == "DIRECT") static_cast<DirectJK*>(jk.get())->set_df_ints_num_threads(1);
+    }
     jk->initialize();
     if (print_ > 1) jk->print_header();
 
@@ -547,6 +818,7 @@ void SADGuess::get_uhf_atomic_density(std::shared_ptr<BasisSet> bas, std::shared
         if (iteration > 1 && deltaE < E_tol && Drms < D_tol) converged = true;
 
         if (iteration > sad_maxiter) {
+#pragma omp critical
             outfile->Printf(
                 "\n WARNING: Atomic UHF is not converging! Try casting from a smaller basis or call Rob at CCMST.\n");
             break;
@@ -594,21 +866,22 @@ void SADGuess::form_C_and_D(int nocc, int norbs, SharedMatrix X, SharedMatrix F,
     Scratch1->gemm(true, false, 1.0, X, F, 0.0);
     Scratch2->gemm(false, false, 1.0, Scratch1, X, 0.0);
 
-    auto eigvals = std::make_shared<Vector>("Eigenvalue scratch", norbs);
-    Scratch2->diagonalize(Scratch1, eigvals);
+    // Only the occupied eigenpairs are needed for the density
+    auto eigvals = std::make_shared<Vector>("Eigenvalue scratch", nocc);
+    auto Uocc = std::make_shared<Matrix>("Occupied eigenvectors", norbs, nocc);
+    Scratch2->diagonalize_lowest(Uocc, eigvals);
 
-    // Form C = XC'
-    C->gemm(false, false, 1.0, X, Scratch1, 0.0);
-
-    // Copy over Cocc
+    // Form Cocc = XC'; the virtual columns of C are never formed
+    Cocc->gemm(false, false, 1.0, X, Uocc, 0.0);
+    C->zero();
     double** Coccp = Cocc->pointer();
     double** Cp = C->pointer();
     for (int i = 0; i < norbs; i++) {
-        C_DCOPY(nocc, Cp[i], 1, Coccp[i], 1);
+        C_DCOPY(nocc, Coccp[i], 1, Cp[i], 1);
     }
     // Scale by occ
     for (int i = 0; i < nocc; i++) {
-        C_DSCAL(norbs, occ->get(i), &Cp[0][i], nocc);
+        C_DSCAL(norbs, occ->get(i), &Coccp[0][i], nocc);
     }
     // Form D = Cocc*Cocc'
     D->gemm(false, true, 1.0, Cocc, Cocc, 0.0);
@@ -629,6 +902,13 @@ void HF::compute_SAD_guess() {
     if (options_.get_str("SAD_SCF_TYPE") == "DF") {
         guess->set_atomic_fit_bases(sad_fitting_basissets_);
     }
+    if (options_.get_str("GUESS") == "FRAG") {
+        if (frag_basissets_.empty()) {
+            throw PSIEXCEPTION("  SCF guess was set to FRAG, but frag_basissets_ was empty!\n\n");
+        }
+        guess->set_fragments(frag_basissets_, frag_atoms_);
+        guess->set_fragment_fit_bases(frag_fitting_basissets_);
+    }
 
     guess->compute_guess();
 
@@ -45,8 +45,16 @@ class SADGuess {
     std::shared_ptr<BasisSet> basis_;
     std::vector<std::shared_ptr<BasisSet>> atomic_bases_;
     std::vector<std::shared_ptr<BasisSet>> atomic_fit_bases_;
+    /// Fragment guess: one basis per fragment, whose molecule carries its charge and multiplicity
+    std::vector<std::shared_ptr<BasisSet>> fragment_bases_;
+    std::vector<std::shared_ptr<BasisSet>> fragment_fit_bases_;
+    /// Full-molecule atom of each fragment atom, in fragment order
+    std::vector<std::vector<int>> fragment_atoms_;
     SharedMatrix AO2SO_;
 
+    /// Electron pairs the assembled density holds before it is scaled to nalpha
+    double npair_;
+
     int nalpha_;
     int nbeta_;
 
@@ -61,8 +69,13 @@ class SADGuess {
 
     SharedMatrix form_D_AO();
     void form_gradient(int norbs, SharedMatrix grad, SharedMatrix F, SharedMatrix D, SharedMatrix S, SharedMatrix X);
+    /// Hash naming the on-disk SAD_CACHE entry for an atom's density
+    std::string sad_cache_key(int atom, std::shared_ptr<BasisSet> fit_basis, int n_electrons, int multiplicity);
     void get_uhf_atomic_density(std::shared_ptr<BasisSet> atomic_basis, std::shared_ptr<BasisSet> fit_basis,
-                                int n_electrons, int multiplicity, SharedMatrix D);
+                                int n_electrons, int multiplicity, SharedMatrix D, int nconcurrent = 1,
+                                bool atomic = true);
+    /// Block-diagonal density from fragment UHFs, McWeeny-purified in the full AO basis
+    SharedMatrix form_D_fragments();
     void form_C_and_D(int nocc, int norbs, SharedMatrix X, SharedMatrix F, SharedMatrix C, SharedMatrix Cocc,
                       SharedVector occ, SharedMatrix D);
 
@@ -82,6 +95,12 @@ class SADGuess {
     SharedMatrix Cb() const { return Cb_; }
 
     void set_atomic_fit_bases(std::vector<std::shared_ptr<BasisSet>> fit_bases) { atomic_fit_bases_ = fit_bases; }
+    /// Assemble the guess from fragment SCFs instead of atoms
+    void set_fragments(std::vector<std::shared_ptr<BasisSet>> bases, std::vector<std::vector<int>> atoms) {
+        fragment_bases_ = bases;
+        fragment_atoms_ = atoms;
+    }
+    void set_fragment_fit_bases(std::vector<std::shared_ptr<BasisSet>> fit_bases) { fragment_fit_bases_ = fit_bases; }
     void set_print(int print) { print_ = print; }
     void set_debug(int debug) { debug_ = debug; }
 };
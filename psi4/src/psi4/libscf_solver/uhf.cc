@@ -162,8 +162,10 @@ void UHF::form_V() {
     // const std::vector<SharedMatrix> & V = potential_->V();
     // Va_ = V[0];
     // Vb_ = V[1];
+    auto start = std::chrono::steady_clock::now();
     potential_->set_D({Da_, Db_});
     potential_->compute_V({Va_, Vb_});
+    v_time_ += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
     // Vb_ = Va_;
 }
 void UHF::form_G() {
@@ -181,6 +183,7 @@ void UHF::form_G() {
     C.clear();
     C.push_back(Ca_subset("SO", "OCC"));
     C.push_back(Cb_subset("SO", "OCC"));
+    form_sparse_D({Da_, Db_});
 
     // Run the JK object
     jk_->compute();
@@ -246,6 +249,7 @@ void UHF::form_F() {
     for (const auto& Vext : external_potentials_) {
         Fb_->add(Vext);
     }
+    form_sparse_F({Fa_, Fb_});
 
     if (debug_) {
         Fa_->print("outfile");
@@ -422,10 +426,8 @@ std::vector<SharedMatrix> UHF::twoel_Hx(std::vector<SharedMatrix> x_vec, bool co
     SharedMatrix Cb_vir = Cb_subset("SO", "VIR");
 
     // Setup jk
-    std::vector<SharedMatrix>& Cl = jk_->C_left();
-    std::vector<SharedMatrix>& Cr = jk_->C_right();
-    Cl.clear();
-    Cr.clear();
+    std::vector<SharedMatrix> Cl;
+    std::vector<SharedMatrix> Cr;
 
     int nvecs = x_vec.size() / 2;
 
@@ -453,11 +455,8 @@ std::vector<SharedMatrix> UHF::twoel_Hx(std::vector<SharedMatrix> x_vec, bool co
     }
 
     // Compute JK
-    jk_->compute();
-
-    const std::vector<SharedMatrix>& J = jk_->J();
-    const std::vector<SharedMatrix>& K = jk_->K();
-    const std::vector<SharedMatrix>& wK = jk_->wK();
+    std::vector<SharedMatrix> J, K, wK;
+    jk_->compute_batch(Cl, Cr, J, K, wK);
 
     std::vector<SharedMatrix> Vx;
     if (functional_->needs_xc()) {
@@ -817,8 +816,15 @@ int UHF::soscf_update(double soscf_conv, int soscf_min_iter, int soscf_max_iter,
         }
         return 0;
     }
-    std::vector<SharedMatrix> ret_x =
-        cphf_solve({Gradient_a, Gradient_b}, soscf_conv, soscf_max_iter, soscf_print ? 2 : 0);
+    std::vector<SharedMatrix> ret_x;
+    if (options_.get_str("SOSCF_SOLVER") == "NEWTON") {
+        SharedMatrix denom_a = soscf_denominator(Ca_, Fa_, nalphapi_);
+        SharedMatrix denom_b = soscf_denominator(Cb_, Fb_, nbetapi_);
+        ret_x = soscf_newton({Gradient_a, Gradient_b}, {denom_a, denom_b}, soscf_min_iter, soscf_max_iter,
+                             soscf_print);
+    } else {
+        ret_x = cphf_solve({Gradient_a, Gradient_b}, soscf_conv, soscf_max_iter, soscf_print ? 2 : 0);
+    }
 
     // => Rotate orbitals <= //
     rotate_orbitals(Ca_, ret_x[0]);
@@ -834,8 +840,7 @@ double UHF::compute_orbital_gradient(bool save_fock, int max_diis_vectors) {
 
     if (save_fock) {
         if (initialized_diis_manager_ == false) {
-            diis_manager_ = std::make_shared<DIISManager>(max_diis_vectors, "HF DIIS vector", DIISManager::LargestError,
-                                                          DIISManager::OnDisk);
+            diis_manager_ = make_diis_manager(max_diis_vectors, false);
             diis_manager_->set_error_vector_size(2, DIISEntry::Matrix, gradient_a.get(), DIISEntry::Matrix,
                                                  gradient_b.get());
             diis_manager_->set_vector_size(2, DIISEntry::Matrix, Fa_.get(), DIISEntry::Matrix, Fb_.get());
@@ -843,18 +848,31 @@ double UHF::compute_orbital_gradient(bool save_fock, int max_diis_vectors) {
         }
 
         diis_manager_->add_entry(4, gradient_a.get(), gradient_b.get(), Fa_.get(), Fb_.get());
+        add_to_initial_accelerator({Da_, Db_}, {Fa_, Fb_}, 1.0,
+                                   std::max(gradient_a->absmax(), gradient_b->absmax()), max_diis_vectors);
     }
     return Drms;
 }
 
-bool UHF::diis() { return diis_manager_->extrapolate(2, Fa_.get(), Fb_.get()); }
+bool UHF::diis() {
+    return accelerated_extrapolate({Fa_, Fb_},
+                                   [this]() { return diis_manager_->extrapolate(2, Fa_.get(), Fb_.get()); });
+}
 
 bool UHF::stability_analysis() {
     if (functional_->needs_xc()) {
         throw PSIEXCEPTION("Stability analysis not yet supported for XC functionals.");
     }
     auto stab = std::make_shared<UStab>(shared_from_this(), options_);
+    // Lend our JK (integrals, sieve, DF tensors) to the stability Hamiltonian; a followed
+    // instability then goes back to iterations() on the very same object
+    if (jk_) {
+        jk_->reset_build_state();
+        stab->set_jk(jk_);
+        outfile->Printf("    Reusing JK object from SCF.\n\n");
+    }
     stab->compute_energy();
+    if (jk_) jk_->reset_build_state();
     SharedMatrix eval_sym = stab->analyze();
     outfile->Printf("    Lowest UHF->UHF stability eigenvalues: \n");
     std::vector<std::pair<double, int> > eval_print;
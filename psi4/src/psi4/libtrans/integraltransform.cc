@@ -89,6 +89,7 @@ IntegralTransform::IntegralTransform(std::shared_ptr<Wavefunction> wfn, SpaceVec
     // Implement set/get functions to customize any of this stuff.  Delayed initialization
     // is possible in case any of these variables need to be changed before setup.
     memory_ = Process::environment.get_memory();
+    directTei_ = Process::environment.options.get_str("SO_TEI_FORMAT") == "DIRECT";
 
     labels_ = wfn->molecule()->irrep_labels();
     nirreps_ = wfn->nirrep();
@@ -163,6 +164,7 @@ IntegralTransform::IntegralTransform(SharedMatrix H, SharedMatrix c, SharedMatri
       tpdmAlreadyPresorted_(false),
       soIntTEIFile_(PSIF_SO_TEI) {
     memory_ = Process::environment.get_memory();
+    directTei_ = Process::environment.options.get_str("SO_TEI_FORMAT") == "DIRECT";
 
     nirreps_ = c->nirrep();
     nmo_ = c->ncol() + i->ncol() + a->ncol() + v->ncol();
@@ -268,12 +270,16 @@ void IntegralTransform::initialize() {
 
     process_spaces();
 
-    // Set up the DPD library
-    // TODO implement caching of files
+    // Set up the DPD library; requested files are cached in full, and evicted LRU under memory pressure
     int numSpaces = spacesUsed_.size();
     int numIndexArrays = numSpaces * (numSpaces - 1) + 5 * numSpaces;
     cacheFiles_ = init_int_array(PSIO_MAXUNIT);
     cacheList_ = init_int_matrix(numIndexArrays, numIndexArrays);
+    if (!dpdCacheFiles_.empty()) {
+        for (int file : dpdCacheFiles_) cacheFiles_[file] = 1;
+        for (int pq = 0; pq < numIndexArrays; ++pq)
+            for (int rs = 0; rs < numIndexArrays; ++rs) cacheList_[pq][rs] = 1;
+    }
     int currentActiveDPD = psi::dpd_default;
     dpd_init(myDPDNum_, nirreps_, memory_, 0, cacheFiles_, cacheList_, nullptr, numSpaces, spaceArray_);
 
@@ -298,6 +304,13 @@ void IntegralTransform::set_psio(std::shared_ptr<PSIO> psio) { psio_ = psio; }
 
 IntegralTransform::~IntegralTransform() {
     if (initialized_) {
+        if (!dpdCacheFiles_.empty()) {
+            // Flush whatever is still cached back to disk
+            int currentActiveDPD = psi::dpd_default;
+            dpd_set_default(myDPDNum_);
+            global_dpd_->file4_cache_close();
+            dpd_set_default(currentActiveDPD);
+        }
         dpd_close(myDPDNum_);
         free_int_matrix(cacheList_);
         free(cacheFiles_);
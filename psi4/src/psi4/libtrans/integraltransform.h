@@ -31,6 +31,7 @@
 
 #include <array>
 #include <map>
+#include <utility>
 #include <vector>
 #include <string>
 #include "psi4/libmints/dimension.h"
@@ -48,8 +49,10 @@ class Matrix;
 class Dimension;
 class Wavefunction;
 class PSIO;
+class TwoBodySOInt;
 
 typedef std::vector<std::shared_ptr<MOSpace> > SpaceVec;
+typedef std::vector<std::pair<std::shared_ptr<MOSpace>, std::shared_ptr<MOSpace> > > SpacePairVec;
 
 /**
    The IntegralTransform class transforms one- and two-electron integrals
@@ -155,9 +158,14 @@ class PSI_API IntegralTransform {
     void transform_tei(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
                        const std::shared_ptr<MOSpace> s3, const std::shared_ptr<MOSpace> s4,
                        HalfTrans = HalfTrans::MakeAndNuke);
+    /// Transforms (S1S2| to every (S3S4) ket in kets, sharing one first half and one sweep over its result
+    void transform_tei(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2, const SpacePairVec &kets,
+                       HalfTrans = HalfTrans::MakeAndNuke);
     void transform_tei_first_half(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2);
     void transform_tei_second_half(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
                                    const std::shared_ptr<MOSpace> s3, const std::shared_ptr<MOSpace> s4);
+    void transform_tei_second_half(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                   const SpacePairVec &kets);
     void backtransform_density();
     void backtransform_tpdm_restricted();
     void backtransform_tpdm_unrestricted();
@@ -174,6 +182,11 @@ class PSI_API IntegralTransform {
 
     /// Sets the SO IWL file to read the TEIs from.
     void set_so_tei_file(int so_tei_file) { soIntTEIFile_ = so_tei_file; }
+    /// Set whether to compute the SO TEIs on the fly, instead of reading and presorting an IWL file.
+    /// Defaults to true when SO_TEI_FORMAT is DIRECT.  Requires the wavefunction constructor.
+    void set_direct_tei(bool val) { directTei_ = val; }
+    /// Whether the SO TEIs are computed on the fly
+    bool get_direct_tei() const { return directTei_; }
     /// Set whether to write a DPD formatted SO basis TPDM to disk after density transformations
     void set_write_dpd_so_tpdm(bool t_f) { write_dpd_so_tpdm_ = t_f; }
     /// Set the level of printing used during transformations (0 -> 6)
@@ -218,6 +231,8 @@ class PSI_API IntegralTransform {
     void set_dpd_id(int n) { myDPDNum_ = n; }
     /// The number of the DPD instance used in the transformation
     int get_dpd_id() const { return myDPDNum_; }
+    /// Files whose DPD buffers are held in libDPD's LRU cache (call before initialize)
+    void set_dpd_cache_files(const std::vector<int> &files) { dpdCacheFiles_ = files; }
 
     /// Get the psio object being used by this object
     std::shared_ptr<PSIO> get_psio() const;
@@ -263,6 +278,14 @@ class PSI_API IntegralTransform {
     void trans_one(int m, int n, double *input, double *output, double **C, int soOffset, int *order,
                    bool backtransform = false, double scale = 0.0);
 
+    std::shared_ptr<TwoBodySOInt> direct_so_eri();
+    void transform_tei_first_half_direct(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2);
+    void compute_fock_like_matrices_direct(const std::vector<SharedMatrix> &Dmats, std::vector<SharedMatrix> &Fmats);
+    void second_half_sweep(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                           const SpacePairVec &kets, SpinType braSpin, SpinType ketSpin);
+    void sort_half_transformed_tei(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                   SpinType spin);
+
     // Has this instance been initialized yet?
     bool initialized_;
 
@@ -306,6 +329,8 @@ class PSI_API IntegralTransform {
     std::map<std::string, int> dpdLookup_;
     // Whether the SO integrals have already been presorted
     bool alreadyPresorted_;
+    // Whether the SO integrals are computed on the fly, rather than read from an IWL file
+    bool directTei_;
     // Whether to also write DPD formatted SO TPDMs after density transformations
     bool write_dpd_so_tpdm_;
     // The file to which DPD formatted integrals are written
@@ -392,6 +417,8 @@ class PSI_API IntegralTransform {
     Dimension nbetapi_;
     // The cache files used by libDPD
     int *cacheFiles_, **cacheList_;
+    // The files to be cached by libDPD, if any
+    std::vector<int> dpdCacheFiles_;
     // The alpha MO coefficients for each irrep
     std::shared_ptr<Matrix> Ca_;
     // The alpha MO coefficients for each irrep
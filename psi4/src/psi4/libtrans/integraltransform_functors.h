@@ -538,6 +538,54 @@ class DPDFillerFunctor {
     }
 };
 
+class DirectSOFillerFunctor {
+   private:
+    /// The rows of the current bucket, by irrep, with the ket stored unpacked
+    double ***J_;
+    /// The [n>=n]+ pair parameters, used for the row indices
+    dpdparams4 *params_;
+    /// The bucket that each lower triangular SO pair belongs to
+    const int *pq_bucket_;
+    /// The first row of each irrep held in this bucket
+    const int *row_offset_;
+    /// The offset of each (Gr,Gs) block within an unpacked ket of irrep h, indexed [h][Gr]
+    const int (*col_offset_)[8];
+    /// The number of SOs per irrep
+    const int *sopi_;
+    int this_bucket_;
+
+    void fill(int p, int q, int rsym, int rrel, int ssym, int srel, double value) {
+        int h = rsym ^ ssym;
+        double *row = J_[h][params_->rowidx[p][q] - row_offset_[h]];
+        row[col_offset_[h][rsym] + rrel * sopi_[ssym] + srel] = value;
+        row[col_offset_[h][ssym] + srel * sopi_[rsym] + rrel] = value;
+    }
+
+   public:
+    /*
+     * Scatters the unique SO integrals computed for a bucket of [n>=n]+ rows into
+     * full (nn|n,n) rows, ready for the first half-transformation.  Each matrix element
+     * is written by exactly one unique integral, so shell quartets may be processed
+     * concurrently.
+     */
+    DirectSOFillerFunctor(double ***J, dpdparams4 *params, const int *pq_bucket, const int *row_offset,
+                          const int (*col_offset)[8], const int *sopi, int this_bucket)
+        : J_(J),
+          params_(params),
+          pq_bucket_(pq_bucket),
+          row_offset_(row_offset),
+          col_offset_(col_offset),
+          sopi_(sopi),
+          this_bucket_(this_bucket) {}
+
+    void operator()(int pabs, int qabs, int rabs, int sabs, int psym, int prel, int qsym, int qrel, int rsym, int rrel,
+                    int ssym, int srel, double value) {
+        if (pq_bucket_[INDEX(pabs, qabs)] == this_bucket_) fill(pabs, qabs, rsym, rrel, ssym, srel, value);
+        if ((pabs != rabs || qabs != sabs) && pq_bucket_[INDEX(rabs, sabs)] == this_bucket_)
+            fill(rabs, sabs, psym, prel, qsym, qrel, value);
+    }
+};
+
 class NullFunctor {
    public:
     /*
@@ -34,11 +34,14 @@
 #include "psi4/libciomr/libciomr.h"
 #include "psi4/libqt/qt.h"
 #include "psi4/libiwl/iwl.hpp"
+#include "psi4/libiwl/blocks.h"
 #include "psi4/libmints/matrix.h"
+#include "psi4/libmints/sointegral_twobody.h"
 #include "psi4/psifiles.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
 
 #include <cmath>
+#include <vector>
 
 using namespace psi;
 
@@ -78,6 +81,12 @@ std::vector<SharedMatrix> IntegralTransform::compute_fock_like_matrices(SharedMa
         Dmats.push_back(Dmat);
     }
 
+    if (directTei_) {
+        compute_fock_like_matrices_direct(Dmats, Fmats);
+        for (int N = 0; N < nmats; ++N) Fmats[N]->add(Hcore);
+        return Fmats;
+    }
+
     psio_->open(PSIF_SO_PRESORT, PSIO_OPEN_OLD);
 
     // Grab control of DPD for now, but store the active number to restore it later
@@ -248,134 +257,166 @@ void IntegralTransform::presort_so_tei() {
     int currentActiveDPD = psi::dpd_default;
     dpd_set_default(myDPDNum_);
 
-    if (print_) {
-        outfile->Printf("\tPresorting SO-basis two-electron integrals.\n");
-    }
-
     dpdfile4 I;
-    psio_->open(PSIF_SO_PRESORT, PSIO_OPEN_NEW);
-    global_dpd_->file4_init(&I, PSIF_SO_PRESORT, 0, DPD_ID("[n>=n]+"), DPD_ID("[n>=n]+"), "SO Ints (nn|nn)");
-
-    size_t memoryd = memory_ / sizeof(double);
+    if (directTei_) {
+        if (print_) {
+            outfile->Printf("\tComputing SO-basis two-electron integrals on the fly; no presort is needed.\n");
+        }
+        std::shared_ptr<TwoBodySOInt> eri = direct_so_eri();
+        if (transformationType_ == TransformationType::Restricted) {
+            FrozenCoreAndFockRestrictedFunctor fock(aD, aFzcD, aFock, aFzcOp);
+            eri->compute_integrals(fock);
+        } else {
+            FrozenCoreAndFockUnrestrictedFunctor fock(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
+            eri->compute_integrals(fock);
+        }
+    } else {
+        if (print_) {
+            outfile->Printf("\tPresorting SO-basis two-electron integrals.\n");
+        }
 
-    int nump = 0, numq = 0;
-    for (int h = 0; h < nirreps_; ++h) {
-        nump += I.params->ppi[h];
-        numq += I.params->qpi[h];
-    }
-    int **bucketMap = init_int_matrix(nump, numq);
-
-    /* Room for one bucket to begin with */
-    int **bucketOffset = (int **)malloc(sizeof(int *));
-    bucketOffset[0] = init_int_array(nirreps_);
-    int **bucketRowDim = (int **)malloc(sizeof(int *));
-    bucketRowDim[0] = init_int_array(nirreps_);
-    long int **bucketSize = (long int **)malloc(sizeof(long int *));
-    bucketSize[0] = init_long_int_array(nirreps_);
-
-    /* Figure out how many passes we need and where each p,q goes */
-    int nBuckets = 1;
-    size_t coreLeft = memoryd;
-    psio_address next;
-    for (int h = 0; h < nirreps_; ++h) {
-        size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
-        for (int row = 0; row < I.params->rowtot[h]; ++row) {
-            if (coreLeft >= rowLength) {
-                coreLeft -= rowLength;
-                bucketRowDim[nBuckets - 1][h]++;
-                bucketSize[nBuckets - 1][h] += rowLength;
-            } else {
-                nBuckets++;
-                coreLeft = memoryd - rowLength;
-                /* Make room for another bucket */
-                int **p;
-
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketOffset = p;
-                }
-                bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
-                bucketOffset[nBuckets - 1][h] = row;
+        psio_->open(PSIF_SO_PRESORT, PSIO_OPEN_NEW);
+        global_dpd_->file4_init(&I, PSIF_SO_PRESORT, 0, DPD_ID("[n>=n]+"), DPD_ID("[n>=n]+"), "SO Ints (nn|nn)");
 
-                p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
-                if (p == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
-                } else {
-                    bucketRowDim = p;
-                }
-                bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
-                bucketRowDim[nBuckets - 1][h] = 1;
+        size_t memoryd = memory_ / sizeof(double);
 
-                long int **pp;
-                pp = static_cast<long int **>(realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
-                if (pp == nullptr) {
-                    throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+        int nump = 0, numq = 0;
+        for (int h = 0; h < nirreps_; ++h) {
+            nump += I.params->ppi[h];
+            numq += I.params->qpi[h];
+        }
+        int **bucketMap = init_int_matrix(nump, numq);
+
+        /* Room for one bucket to begin with */
+        int **bucketOffset = (int **)malloc(sizeof(int *));
+        bucketOffset[0] = init_int_array(nirreps_);
+        int **bucketRowDim = (int **)malloc(sizeof(int *));
+        bucketRowDim[0] = init_int_array(nirreps_);
+        long int **bucketSize = (long int **)malloc(sizeof(long int *));
+        bucketSize[0] = init_long_int_array(nirreps_);
+
+        /* Figure out how many passes we need and where each p,q goes */
+        int nBuckets = 1;
+        size_t coreLeft = memoryd;
+        psio_address next;
+        for (int h = 0; h < nirreps_; ++h) {
+            size_t rowLength = (size_t)I.params->coltot[h ^ (I.my_irrep)];
+            for (int row = 0; row < I.params->rowtot[h]; ++row) {
+                if (coreLeft >= rowLength) {
+                    coreLeft -= rowLength;
+                    bucketRowDim[nBuckets - 1][h]++;
+                    bucketSize[nBuckets - 1][h] += rowLength;
                 } else {
-                    bucketSize = pp;
+                    nBuckets++;
+                    coreLeft = memoryd - rowLength;
+                    /* Make room for another bucket */
+                    int **p;
+
+                    p = static_cast<int **>(realloc(static_cast<void *>(bucketOffset), nBuckets * sizeof(int *)));
+                    if (p == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketOffset = p;
+                    }
+                    bucketOffset[nBuckets - 1] = init_int_array(nirreps_);
+                    bucketOffset[nBuckets - 1][h] = row;
+
+                    p = static_cast<int **>(realloc(static_cast<void *>(bucketRowDim), nBuckets * sizeof(int *)));
+                    if (p == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketRowDim = p;
+                    }
+                    bucketRowDim[nBuckets - 1] = init_int_array(nirreps_);
+                    bucketRowDim[nBuckets - 1][h] = 1;
+
+                    long int **pp;
+                    pp = static_cast<long int **>(
+                        realloc(static_cast<void *>(bucketSize), nBuckets * sizeof(long int *)));
+                    if (pp == nullptr) {
+                        throw PsiException("file_build: allocation error", __FILE__, __LINE__);
+                    } else {
+                        bucketSize = pp;
+                    }
+                    bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
+                    bucketSize[nBuckets - 1][h] = rowLength;
                 }
-                bucketSize[nBuckets - 1] = init_long_int_array(nirreps_);
-                bucketSize[nBuckets - 1][h] = rowLength;
+                int p = I.params->roworb[h][row][0];
+                int q = I.params->roworb[h][row][1];
+                bucketMap[p][q] = nBuckets - 1;
             }
-            int p = I.params->roworb[h][row][0];
-            int q = I.params->roworb[h][row][1];
-            bucketMap[p][q] = nBuckets - 1;
         }
-    }
-
-    if (print_) {
-        outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
-    }
 
-    next = PSIO_ZERO;
-    for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
-        /* Prepare target matrix */
-        for (int h = 0; h < nirreps_; h++) {
-            I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
+        if (print_) {
+            outfile->Printf("\tSorting File: %s nbuckets = %d\n", I.label, nBuckets);
         }
 
-        DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true);
-        NullFunctor null;
-        IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 1);
-        // In the functors below, we only want to build the Fock matrix on the first pass
-        if (transformationType_ == TransformationType::Restricted) {
-            FrozenCoreAndFockRestrictedFunctor fock(aD, aFzcD, aFock, aFzcOp);
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, fock);
-        } else {
-            FrozenCoreAndFockUnrestrictedFunctor fock(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
-            if (n)
-                iwl_integrals(iwl, dpdfiller, null);
-            else
-                iwl_integrals(iwl, dpdfiller, fock);
-        }
-        delete iwl;
+        /* Bucket of each canonical pq, for skipping integral blocks */
+        std::vector<int> pqBucket(nTriSo_);
+        std::vector<size_t> inBucket(nTriSo_ + 1, 0);
+        for (int p = 0; p < nso_; ++p)
+            for (int q = 0; q <= p; ++q) pqBucket[INDEX(p, q)] = bucketMap[p][q];
+
+        next = PSIO_ZERO;
+        for (int n = 0; n < nBuckets; ++n) { /* nbuckets = number of passes */
+            /* Prepare target matrix */
+            for (int h = 0; h < nirreps_; h++) {
+                I.matrix[h] = block_matrix(bucketRowDim[n][h], I.params->coltot[h]);
+            }
 
-        for (int h = 0; h < nirreps_; ++h) {
-            if (bucketSize[n][h])
-                psio_->write(I.filenum, I.label, (char *)I.matrix[h][0], bucketSize[n][h] * ((long int)sizeof(double)),
-                             next, &next);
-            free_block(I.matrix[h]);
-        }
-    } /* end loop over buckets/passes */
+            DPDFillerFunctor dpdfiller(&I, n, bucketMap, bucketOffset, false, true);
+            NullFunctor null;
+            IWL *iwl = new IWL(psio_.get(), soIntTEIFile_, tolerance_, 1, 0);
+            // Blocked integral files let the later passes skip blocks that touch none of their rows;
+            // the first pass reads everything, as it also builds the Fock matrices
+            if (n && iwl->blocked()) {
+                // inBucket[pq] counts the pairs below pq that belong to this pass
+                for (size_t pq = 0; pq < (size_t)nTriSo_; ++pq) inBucket[pq + 1] = inBucket[pq] + (pqBucket[pq] == n);
+                iwl->set_block_filter([&](const IWLBlockInfo &block) {
+                    return inBucket[block.pq_last + 1] > inBucket[block.pq_first] ||
+                           inBucket[block.rs_last + 1] > inBucket[block.rs_first];
+                });
+            }
+            iwl->fetch();
+            // In the functors below, we only want to build the Fock matrix on the first pass
+            if (transformationType_ == TransformationType::Restricted) {
+                FrozenCoreAndFockRestrictedFunctor fock(aD, aFzcD, aFock, aFzcOp);
+                if (n)
+                    iwl_integrals(iwl, dpdfiller, null);
+                else
+                    iwl_integrals(iwl, dpdfiller, fock);
+            } else {
+                FrozenCoreAndFockUnrestrictedFunctor fock(aD, bD, aFzcD, bFzcD, aFock, bFock, aFzcOp, bFzcOp);
+                if (n)
+                    iwl_integrals(iwl, dpdfiller, null);
+                else
+                    iwl_integrals(iwl, dpdfiller, fock);
+            }
+            delete iwl;
+
+            for (int h = 0; h < nirreps_; ++h) {
+                if (bucketSize[n][h])
+                    psio_->write(I.filenum, I.label, (char *)I.matrix[h][0],
+                                 bucketSize[n][h] * ((long int)sizeof(double)), next, &next);
+                free_block(I.matrix[h]);
+            }
+        } /* end loop over buckets/passes */
 
-    /* Get rid of the input integral file */
-    psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
-    psio_->close(soIntTEIFile_, keepIwlSoInts_);
+        /* Get rid of the input integral file */
+        psio_->open(soIntTEIFile_, PSIO_OPEN_OLD);
+        psio_->close(soIntTEIFile_, keepIwlSoInts_);
 
-    free_int_matrix(bucketMap);
+        free_int_matrix(bucketMap);
 
-    for (int n = 0; n < nBuckets; ++n) {
-        free(bucketOffset[n]);
-        free(bucketRowDim[n]);
-        free(bucketSize[n]);
+        for (int n = 0; n < nBuckets; ++n) {
+            free(bucketOffset[n]);
+            free(bucketRowDim[n]);
+            free(bucketSize[n]);
+        }
+        free(bucketOffset);
+        free(bucketRowDim);
+        free(bucketSize);
     }
-    free(bucketOffset);
-    free(bucketRowDim);
-    free(bucketSize);
 
     double *moInts = init_array(nTriMo_);
     int *order = init_int_array(nmo_);
@@ -531,6 +572,8 @@ void IntegralTransform::presort_so_tei() {
 
     alreadyPresorted_ = true;
 
-    global_dpd_->file4_close(&I);
-    psio_->close(PSIF_SO_PRESORT, 1);
+    if (!directTei_) {
+        global_dpd_->file4_close(&I);
+        psio_->close(PSIF_SO_PRESORT, 1);
+    }
 }
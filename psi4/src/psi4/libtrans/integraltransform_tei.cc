@@ -61,3 +61,21 @@ void IntegralTransform::transform_tei(const std::shared_ptr<MOSpace> s1, const s
     }
     transform_tei_second_half(s1, s2, s3, s4);
 }
+
+/**
+ * Transform the two-electron integrals from the SO to the MO basis for several ket spaces at once.
+ * The (S1S2|nn) half-transformed integrals are made (or read) once, and all of the kets are
+ * produced from a single pass over them.
+ *
+ * @param s1   - the MO space for the first index
+ * @param s2   - the MO space for the second index
+ * @param kets - the MO spaces for the third and fourth indices of each set of integrals
+ */
+void IntegralTransform::transform_tei(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                      const SpacePairVec &kets, HalfTrans ht) {
+    check_initialized();
+    if (ht == HalfTrans::MakeAndKeep || ht == HalfTrans::MakeAndNuke) transform_tei_first_half(s1, s2);
+
+    keepHtInts_ = !(ht == HalfTrans::ReadAndNuke || ht == HalfTrans::MakeAndNuke);
+    transform_tei_second_half(s1, s2, kets);
+}
@@ -50,6 +50,11 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
     // This can be safely called - it returns immediately if the SO ints are already sorted
     presort_so_tei();
 
+    if (directTei_) {
+        transform_tei_first_half_direct(s1, s2);
+        return;
+    }
+
     char *label = new char[100];
 
     // Grab the transformation coefficients
@@ -173,19 +178,7 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
         }
     }
 
-    psio_->open(aHtIntFile_, PSIO_OPEN_NEW);
-
-    braCore = braDisk = DPD_ID("[n>=n]+");
-    ketCore = ketDisk = DPD_ID(s1, s2, SpinType::Alpha, true);
-    sprintf(label, "Half-Transformed Ints (nn|%c%c)", toupper(s1->label()), toupper(s2->label()));
-    global_dpd_->buf4_init(&K, PSIF_HALFT0, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-    if (print_ > 5)
-        outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk, ketDisk);
-    sprintf(label, "Half-Transformed Ints (%c%c|nn)", toupper(s1->label()), toupper(s2->label()));
-    global_dpd_->buf4_sort(&K, aHtIntFile_, rspq, ketCore, braCore, label);
-    global_dpd_->buf4_close(&K);
-
-    psio_->close(aHtIntFile_, 1);
+    sort_half_transformed_tei(s1, s2, SpinType::Alpha);
     psio_->close(PSIF_HALFT0, 0);
 
     if (transformationType_ != TransformationType::Restricted) {
@@ -277,23 +270,7 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
             outfile->Printf("\tSorting BB half-transformed integrals.\n");
         }
 
-        psio_->open(bHtIntFile_, PSIO_OPEN_NEW);
-
-        braCore = DPD_ID("[n>=n]+");
-        ketCore = DPD_ID(s1, s2, SpinType::Beta, true);
-        braDisk = DPD_ID("[n>=n]+");
-        ketDisk = DPD_ID(s1, s2, SpinType::Beta, true);
-        sprintf(label, "Half-Transformed Ints (nn|%c%c)", tolower(s1->label()), tolower(s2->label()));
-        global_dpd_->buf4_init(&K, PSIF_HALFT0, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-        if (print_ > 5)
-            outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk,
-                            ketDisk);
-
-        sprintf(label, "Half-Transformed Ints (%c%c|nn)", tolower(s1->label()), tolower(s2->label()));
-        global_dpd_->buf4_sort(&K, bHtIntFile_, rspq, ketCore, braCore, label);
-        global_dpd_->buf4_close(&K);
-
-        psio_->close(bHtIntFile_, 1);
+        sort_half_transformed_tei(s1, s2, SpinType::Beta);
         psio_->close(PSIF_HALFT0, 0);
     }  // End "if not restricted transformation"
 
@@ -309,3 +286,33 @@ void IntegralTransform::transform_tei_first_half(const std::shared_ptr<MOSpace>
     // Hand DPD control back to the user
     dpd_set_default(currentActiveDPD);
 }
+
+/**
+ * Sorts the (nn|S1S2) half-transformed integrals in PSIF_HALFT0 into the (S1S2|nn) order
+ * expected by the second half-transformation.  PSIF_HALFT0 must be open.
+ */
+void IntegralTransform::sort_half_transformed_tei(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                                  SpinType spin) {
+    bool alpha = spin == SpinType::Alpha;
+    int htFile = alpha ? aHtIntFile_ : bHtIntFile_;
+    char c1 = alpha ? toupper(s1->label()) : tolower(s1->label());
+    char c2 = alpha ? toupper(s2->label()) : tolower(s2->label());
+    char label[100];
+
+    psio_->open(htFile, PSIO_OPEN_NEW);
+
+    dpdbuf4 K;
+    int braCore = DPD_ID("[n>=n]+");
+    int ketCore = DPD_ID(s1, s2, spin, true);
+    int braDisk = DPD_ID("[n>=n]+");
+    int ketDisk = DPD_ID(s1, s2, spin, true);
+    sprintf(label, "Half-Transformed Ints (nn|%c%c)", c1, c2);
+    global_dpd_->buf4_init(&K, PSIF_HALFT0, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
+    if (print_ > 5)
+        outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk, ketDisk);
+    sprintf(label, "Half-Transformed Ints (%c%c|nn)", c1, c2);
+    global_dpd_->buf4_sort(&K, htFile, rspq, ketCore, braCore, label);
+    global_dpd_->buf4_close(&K);
+
+    psio_->close(htFile, 1);
+}
@@ -25,7 +25,6 @@
  *
  * @END LICENSE
  */
-
 #include "integraltransform.h"
 #include "mospace.h"
 
@@ -35,436 +34,315 @@
 #include "psi4/libiwl/iwl.hpp"
 #include "psi4/libqt/qt.h"
 #include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
 #include "psi4/psifiles.h"
 #include "psi4/libdpd/dpd.h"
 
 #include <math.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <algorithm>
+#include <future>
+#include <utility>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 using namespace psi;
 
 void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
                                                   const std::shared_ptr<MOSpace> s3,
                                                   const std::shared_ptr<MOSpace> s4) {
-    check_initialized();
+    transform_tei_second_half(s1, s2, SpacePairVec{{s3, s4}});
+}
 
-    bool bra_sym = s1 == s2;
-    bool ket_sym = s3 == s4;
-    bool bra_ket_sym = (s1 == s3) && bra_sym && ket_sym;
-
-    char *label = new char[100];
-
-    // Grab the transformation coefficients
-    SharedMatrix c3a = aMOCoefficients_[s3->label()];
-    SharedMatrix c3b = bMOCoefficients_[s3->label()];
-    SharedMatrix c4a = aMOCoefficients_[s4->label()];
-    SharedMatrix c4b = bMOCoefficients_[s4->label()];
-    // And the number of orbitals per irrep
-    int *aOrbsPI3 = aOrbsPI_[s3->label()];
-    int *bOrbsPI3 = bOrbsPI_[s3->label()];
-    int *aOrbsPI4 = aOrbsPI_[s4->label()];
-    int *bOrbsPI4 = bOrbsPI_[s4->label()];
-    // The reindexing arrays
-    int *aIndex1 = aIndices_[s1->label()];
-    int *bIndex1 = bIndices_[s1->label()];
-    int *aIndex2 = aIndices_[s2->label()];
-    int *bIndex2 = bIndices_[s2->label()];
-    int *aIndex3 = aIndices_[s3->label()];
-    int *bIndex3 = bIndices_[s3->label()];
-    int *aIndex4 = aIndices_[s4->label()];
-    int *bIndex4 = bIndices_[s4->label()];
+/**
+ * Completes the transformation of the (S1S2|nn) half-transformed integrals to (S1S2|S3S4), for
+ * every (S3,S4) pair in kets, in a single sweep over the half-transformed integrals.
+ */
+void IntegralTransform::transform_tei_second_half(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                                  const SpacePairVec &kets) {
+    check_initialized();
 
     // Grab control of DPD for now, but store the active number to restore it later
     int currentActiveDPD = psi::dpd_default;
     dpd_set_default(myDPDNum_);
 
-    IWL *iwl;
-    if (useIWL_) iwl = new IWL;
-    int nBuckets;
-    int thisBucketRows;
-    size_t rowsPerBucket;
-    size_t rowsLeft;
-    size_t memFree;
-    dpdbuf4 J, K;
+    psio_->open(dpdIntFile_, PSIO_OPEN_OLD);
+    psio_->open(aHtIntFile_, PSIO_OPEN_OLD);
+
+    if (transformationType_ == TransformationType::Restricted) {
+        if (print_) outfile->Printf("\tStarting second half-transformation.\n");
+        second_half_sweep(s1, s2, kets, SpinType::Alpha, SpinType::Alpha);
+    } else {
+        if (print_) outfile->Printf("\tStarting AA second half-transformation.\n");
+        second_half_sweep(s1, s2, kets, SpinType::Alpha, SpinType::Alpha);
+        if (print_) outfile->Printf("\tStarting AB second half-transformation.\n");
+        second_half_sweep(s1, s2, kets, SpinType::Alpha, SpinType::Beta);
+        if (print_) outfile->Printf("\tStarting BB second half-transformation.\n");
+        psio_->open(bHtIntFile_, PSIO_OPEN_OLD);
+        second_half_sweep(s1, s2, kets, SpinType::Beta, SpinType::Beta);
+        psio_->close(bHtIntFile_, keepHtInts_);
+    }
 
-    double **TMP = block_matrix(nso_, nso_);
+    psio_->close(dpdIntFile_, 1);
+    psio_->close(aHtIntFile_, keepHtInts_);
 
     if (print_) {
-        if (transformationType_ == TransformationType::Restricted) {
-            outfile->Printf("\tStarting second half-transformation.\n");
-        } else {
-            outfile->Printf("\tStarting AA second half-transformation.\n");
-        }
+        outfile->Printf("\tTwo-electron integral transformation complete.\n");
     }
 
-    if (useIWL_) iwl = new IWL(psio_.get(), iwlAAIntFile_, tolerance_, 0, 0);
+    // Reset the integral file names, before the next transformation is called
+    aaIntName_ = "";
+    abIntName_ = "";
+    bbIntName_ = "";
 
-    psio_->open(dpdIntFile_, PSIO_OPEN_OLD);
-    psio_->open(aHtIntFile_, PSIO_OPEN_OLD);
+    // Hand DPD control back to the user
+    dpd_set_default(currentActiveDPD);
+}
 
-    int braCore = DPD_ID(s1, s2, SpinType::Alpha, true);
-    int braDisk = DPD_ID(s1, s2, SpinType::Alpha, true);
-    int ketCore = DPD_ID("[n,n]");
-    int ketDisk = DPD_ID("[n>=n]+");
-    sprintf(label, "Half-Transformed Ints (%c%c|nn)", toupper(s1->label()), toupper(s2->label()));
-    global_dpd_->buf4_init(&J, aHtIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-    if (print_ > 5)
-        outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk, ketDisk);
-
-    braCore = DPD_ID(s1, s2, SpinType::Alpha, true);
-    ketCore = DPD_ID(s3, s4, SpinType::Alpha, false);
-    braDisk = DPD_ID(s1, s2, SpinType::Alpha, true);
-    ketDisk = DPD_ID(s3, s4, SpinType::Alpha, true);
-    if (aaIntName_.length())
-        strcpy(label, aaIntName_.c_str());
-    else
-        sprintf(label, "MO Ints (%c%c|%c%c)", toupper(s1->label()), toupper(s2->label()), toupper(s3->label()),
-                toupper(s4->label()));
-    global_dpd_->buf4_init(&K, dpdIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-    if (print_ > 5)
-        outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk, ketDisk);
+/**
+ * One spin case of the second half-transformation.  The (S1S2|nn) rows are read in buckets, and
+ * while the rows of one bucket are transformed concurrently, the previous bucket's results are
+ * written and the next bucket is read on a background thread.  Both the half-transformed and the
+ * MO integrals are held with packed kets in core, as they are on disk, so every read and write is
+ * a single contiguous block; the kets are unpacked and packed row by row during the transformation.
+ */
+void IntegralTransform::second_half_sweep(const std::shared_ptr<MOSpace> s1, const std::shared_ptr<MOSpace> s2,
+                                          const SpacePairVec &kets, SpinType braSpin, SpinType ketSpin) {
+    bool braAlpha = braSpin == SpinType::Alpha;
+    bool ketAlpha = ketSpin == SpinType::Alpha;
+    bool mixedSpin = braAlpha != ketAlpha;
+    size_t nket = kets.size();
+
+    auto spaceLabel = [](const std::shared_ptr<MOSpace> &s, bool alpha) {
+        return alpha ? (char)toupper(s->label()) : (char)tolower(s->label());
+    };
+
+    int htFile = braAlpha ? aHtIntFile_ : bHtIntFile_;
+    int *index1 = braAlpha ? aIndices_[s1->label()] : bIndices_[s1->label()];
+    int *index2 = braAlpha ? aIndices_[s2->label()] : bIndices_[s2->label()];
+    const std::string &intName = mixedSpin ? abIntName_ : (ketAlpha ? aaIntName_ : bbIntName_);
+    int iwlFile = mixedSpin ? iwlABIntFile_ : (ketAlpha ? iwlAAIntFile_ : iwlBBIntFile_);
+
+    char label[100];
+    dpdbuf4 J;
+    int bra = DPD_ID(s1, s2, braSpin, true);
+    sprintf(label, "Half-Transformed Ints (%c%c|nn)", spaceLabel(s1, braAlpha), spaceLabel(s2, braAlpha));
+    global_dpd_->buf4_init(&J, htFile, 0, bra, DPD_ID("[n>=n]+"), bra, DPD_ID("[n>=n]+"), 0, label);
+    if (print_ > 5) outfile->Printf("Initializing %s, (%d|%d)\n", label, bra, DPD_ID("[n>=n]+"));
+
+    // The output buffers, with packed kets, and views of their unpacked layouts
+    std::vector<dpdbuf4> K(nket), Kunp(nket);
+    std::vector<bool> ketPacked(nket);
+    std::vector<SharedMatrix> c3(nket), c4(nket);
+    std::vector<int *> orbsPI3(nket), orbsPI4(nket), index3(nket), index4(nket);
+    for (size_t t = 0; t < nket; ++t) {
+        const std::shared_ptr<MOSpace> &s3 = kets[t].first;
+        const std::shared_ptr<MOSpace> &s4 = kets[t].second;
+        c3[t] = ketAlpha ? aMOCoefficients_[s3->label()] : bMOCoefficients_[s3->label()];
+        c4[t] = ketAlpha ? aMOCoefficients_[s4->label()] : bMOCoefficients_[s4->label()];
+        orbsPI3[t] = ketAlpha ? aOrbsPI_[s3->label()] : bOrbsPI_[s3->label()];
+        orbsPI4[t] = ketAlpha ? aOrbsPI_[s4->label()] : bOrbsPI_[s4->label()];
+        index3[t] = ketAlpha ? aIndices_[s3->label()] : bIndices_[s3->label()];
+        index4[t] = ketAlpha ? aIndices_[s4->label()] : bIndices_[s4->label()];
+        int ketPk = DPD_ID(s3, s4, ketSpin, true);
+        int ketUnp = DPD_ID(s3, s4, ketSpin, false);
+        ketPacked[t] = ketPk != ketUnp;
+        if (nket == 1 && intName.length())
+            strcpy(label, intName.c_str());
+        else
+            sprintf(label, "MO Ints (%c%c|%c%c)", spaceLabel(s1, braAlpha), spaceLabel(s2, braAlpha),
+                    spaceLabel(s3, ketAlpha), spaceLabel(s4, ketAlpha));
+        global_dpd_->buf4_init(&K[t], dpdIntFile_, 0, bra, ketPk, bra, ketPk, 0, label);
+        global_dpd_->buf4_init(&Kunp[t], dpdIntFile_, 0, bra, ketUnp, bra, ketPk, 0, label);
+        if (print_ > 5) outfile->Printf("Initializing %s, (%d|%d)\n", label, bra, ketPk);
+    }
 
-    for (int h = 0; h < nirreps_; h++) {
-        if (J.params->coltot[h] && J.params->rowtot[h]) {
-            memFree = static_cast<size_t>(dpd_memfree() - J.params->coltot[h] - K.params->coltot[h]);
-            rowsPerBucket = memFree / (2 * J.params->coltot[h]);
-            if (rowsPerBucket > J.params->rowtot[h]) rowsPerBucket = static_cast<size_t>(J.params->rowtot[h]);
-            nBuckets =
-                static_cast<int>(ceil(static_cast<double>(J.params->rowtot[h]) / static_cast<double>(rowsPerBucket)));
-            rowsLeft = static_cast<size_t>(J.params->rowtot[h] % rowsPerBucket);
-        } else {
-            nBuckets = 0;
-            rowsPerBucket = 0;
-            rowsLeft = 0;
+    // The unpacked (n,n) ket layout of each irrep, and where each of its elements sits in a packed row
+    std::vector<int> soOffset(nirreps_, 0);
+    for (int h = 1; h < nirreps_; ++h) soOffset[h] = soOffset[h - 1] + sopi_[h - 1];
+    std::vector<std::vector<int>> colOffset(nirreps_, std::vector<int>(nirreps_, 0));
+    std::vector<std::vector<int>> unpackJ(nirreps_);
+    for (int h = 0; h < nirreps_; ++h) {
+        for (int Gr = 0; Gr < nirreps_; ++Gr) {
+            int Gs = h ^ Gr;
+            colOffset[h][Gr] = unpackJ[h].size();
+            for (int r = 0; r < sopi_[Gr]; ++r)
+                for (int s = 0; s < sopi_[Gs]; ++s)
+                    unpackJ[h].push_back(J.params->colidx[r + soOffset[Gr]][s + soOffset[Gs]]);
         }
+    }
+    // Where each element of a packed MO ket comes from in the unpacked one
+    std::vector<std::vector<std::vector<int>>> packK(nket, std::vector<std::vector<int>>(nirreps_));
+    for (size_t t = 0; t < nket; ++t) {
+        if (!ketPacked[t]) continue;
+        for (int h = 0; h < nirreps_; ++h) {
+            for (int rs = 0; rs < K[t].params->coltot[h]; ++rs) {
+                int r = K[t].params->colorb[h][rs][0];
+                int s = K[t].params->colorb[h][rs][1];
+                packK[t][h].push_back(Kunp[t].params->colidx[r][s]);
+            }
+        }
+    }
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    // Per-thread unpacked half-transformed row, quarter-transformed block and unpacked MO row
+    size_t nso2 = (size_t)nso_ * nso_;
+    std::vector<std::vector<double>> scratch(nthread, std::vector<double>(3 * nso2));
+
+    IWL *iwl = nullptr;
+    if (useIWL_) iwl = new IWL(psio_.get(), iwlFile, tolerance_, 0, 0);
+
+    for (int h = 0; h < nirreps_; h++) {
+        int rowtot = J.params->rowtot[h];
+        size_t rowLength = J.params->coltot[h];
+        for (size_t t = 0; t < nket; ++t) rowLength += K[t].params->coltot[h];
+        if (!rowtot || !J.params->coltot[h] || rowLength == J.params->coltot[h]) continue;
+
+        // Two blocks of every buffer are held, one being transformed while the other is read or written
+        long int memFree = dpd_memfree() - (long int)nthread * 3 * nso2;
+        size_t rowsPerBucket = memFree > 0 ? memFree / (2 * rowLength) : 0;
+        if (rowsPerBucket == 0)
+            throw PSIEXCEPTION("IntegralTransform: not enough memory for the second half-transformation.");
+        if (rowsPerBucket > rowtot) rowsPerBucket = rowtot;
+        int nBuckets = static_cast<int>(ceil(static_cast<double>(rowtot) / static_cast<double>(rowsPerBucket)));
 
         if (print_ > 1) {
-            outfile->Printf("\th = %d; memfree         = %lu\n", h, memFree);
+            outfile->Printf("\th = %d; memfree         = %ld\n", h, memFree);
             outfile->Printf("\th = %d; rows_per_bucket = %lu\n", h, rowsPerBucket);
-            outfile->Printf("\th = %d; rows_left       = %lu\n", h, rowsLeft);
             outfile->Printf("\th = %d; nbuckets        = %d\n", h, nBuckets);
         }
 
-        global_dpd_->buf4_mat_irrep_init_block(&J, h, rowsPerBucket);
-        global_dpd_->buf4_mat_irrep_init_block(&K, h, rowsPerBucket);
-
-        for (int n = 0; n < nBuckets; n++) {
-            if (nBuckets == 1)
-                thisBucketRows = rowsPerBucket;
+        double **Jblock[2];
+        std::vector<double **> Kblock[2];
+        for (int b = 0; b < 2; ++b) {
+            Jblock[b] = global_dpd_->dpd_block_matrix(rowsPerBucket, J.params->coltot[h]);
+            for (size_t t = 0; t < nket; ++t) {
+                int coltot = K[t].params->coltot[h];
+                Kblock[b].push_back(coltot ? global_dpd_->dpd_block_matrix(rowsPerBucket, coltot) : nullptr);
+            }
+        }
+        auto bucketStart = [&](int n) { return n * (int)rowsPerBucket; };
+        auto bucketRows = [&](int n) { return std::min((int)rowsPerBucket, rowtot - bucketStart(n)); };
+
+        // The I/O below runs on the background thread, and only it touches the files during the sweep
+        auto io_rows = [&](dpdfile4 &source, double **block, int start, int nrows, bool write) {
+            dpdfile4 file = source;
+            std::vector<double **> matrix(source.matrix, source.matrix + nirreps_);
+            matrix[h] = block;
+            file.matrix = matrix.data();
+            if (write)
+                global_dpd_->file4_mat_irrep_wrt_block(&file, h, start, nrows);
             else
-                thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
-            global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
-            for (int pq = 0; pq < thisBucketRows; pq++) {
-                for (int Gr = 0; Gr < nirreps_; Gr++) {
-                    // Transform ( S1 S2 | n n ) -> ( S1 S2 | n S4 )
-                    int Gs = h ^ Gr;
-                    int nrows = sopi_[Gr];
-                    int ncols = aOrbsPI4[Gs];
-                    int nlinks = sopi_[Gs];
-                    int rs = J.col_offset[h][Gr];
-                    double **pc4a = c4a->pointer(Gs);
-                    if (nrows && ncols && nlinks)
-                        C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J.matrix[h][pq][rs], nlinks, pc4a[0], ncols, 0.0,
-                                TMP[0], nso_);
-                    // TODO else if s4->label() == MOSPACE_NIL, copy buffer...
-
-                    // Transform ( S1 S2 | n S4 ) -> ( S1 S2 | S3 S4 )
-                    nrows = aOrbsPI3[Gr];
-                    ncols = aOrbsPI4[Gs];
-                    nlinks = sopi_[Gr];
-                    rs = K.col_offset[h][Gr];
-                    double **pc3a = c3a->pointer(Gr);
-                    if (nrows && ncols && nlinks)
-                        C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc3a[0], nrows, TMP[0], nso_, 0.0,
-                                &K.matrix[h][pq][rs], ncols);
-                    // TODO else if s3->label() == MOSPACE_NIL, copy buffer...
-                } /* Gr */
-                if (useIWL_) {
-                    int P = aIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
-                    int Q = aIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
+                global_dpd_->file4_mat_irrep_rd_block(&file, h, start, nrows);
+        };
+        auto write_iwl = [&](int n) {
+            double **const *blocks = Kblock[n % 2].data();
+            for (size_t t = 0; t < nket; ++t) {
+                if (!blocks[t]) continue;
+                bool ket_sym = kets[t].first == kets[t].second;
+                bool bra_ket_sym = !mixedSpin && (s1 == kets[t].first) && (s1 == s2) && ket_sym;
+                for (int pq = 0; pq < bucketRows(n); ++pq) {
+                    // dpd is smart enough to index only unique pairs in the bra, so no pq pairs are skipped
+                    int P = index1[K[t].params->roworb[h][pq + bucketStart(n)][0]];
+                    int Q = index2[K[t].params->roworb[h][pq + bucketStart(n)][1]];
                     size_t PQ = INDEX(P, Q);
-                    // dpd is smart enough to index only unique pairs in the bra
-                    // ( K.params->roworb contains no redundancies ), so there is
-                    // no need to skip any pq pairs when writing IWL
-                    // if( (P < Q) && bra_sym) continue;
-                    for (int rs = 0; rs < K.params->coltot[h]; rs++) {
-                        int R = aIndex3[K.params->colorb[h][rs][0]];
-                        int S = aIndex4[K.params->colorb[h][rs][1]];
-                        if ((R < S) && ket_sym) continue;
+                    for (int rs = 0; rs < K[t].params->coltot[h]; rs++) {
+                        int R = index3[t][K[t].params->colorb[h][rs][0]];
+                        int S = index4[t][K[t].params->colorb[h][rs][1]];
+                        // Packed kets hold only one of each (rs) and (sr) pair
+                        if ((R < S) && ket_sym) std::swap(R, S);
                         size_t RS = INDEX(R, S);
                         if ((RS < PQ) && bra_ket_sym) continue;
-                        iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
-                    } /* rs */
-                }
-            } /* pq */
-            global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
-        }
-        global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
-        global_dpd_->buf4_mat_irrep_close_block(&K, h, rowsPerBucket);
-    }
-    global_dpd_->buf4_close(&K);
-    global_dpd_->buf4_close(&J);
-
-    if (useIWL_) {
-        iwl->flush(1);
-        iwl->set_keep_flag(1);
-        // This closes the file too
-        delete iwl;
-    }
-
-    if (transformationType_ != TransformationType::Restricted) {
-        if (print_) {
-            outfile->Printf("\tStarting AB second half-transformation.\n");
-        }
-        if (useIWL_) iwl = new IWL(psio_.get(), iwlABIntFile_, tolerance_, 0, 0);
-
-        braCore = braDisk = DPD_ID(s1, s2, SpinType::Alpha, true);
-        ketCore = DPD_ID("[n,n]");
-        ketDisk = DPD_ID("[n>=n]+");
-        sprintf(label, "Half-Transformed Ints (%c%c|nn)", toupper(s1->label()), toupper(s2->label()));
-        global_dpd_->buf4_init(&J, aHtIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-        if (print_ > 5)
-            outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk,
-                            ketDisk);
-
-        braCore = DPD_ID(s1, s2, SpinType::Alpha, true);
-        ketCore = DPD_ID(s3, s4, SpinType::Beta, false);
-        braDisk = DPD_ID(s1, s2, SpinType::Alpha, true);
-        ketDisk = DPD_ID(s3, s4, SpinType::Beta, true);
-        if (abIntName_.length())
-            strcpy(label, abIntName_.c_str());
-        else
-            sprintf(label, "MO Ints (%c%c|%c%c)", toupper(s1->label()), toupper(s2->label()), tolower(s3->label()),
-                    tolower(s4->label()));
-        global_dpd_->buf4_init(&K, dpdIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-        if (print_ > 5)
-            outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk,
-                            ketDisk);
-
-        for (int h = 0; h < nirreps_; h++) {
-            if (J.params->coltot[h] && J.params->rowtot[h]) {
-                memFree = static_cast<size_t>(dpd_memfree() - J.params->coltot[h] - K.params->coltot[h]);
-                rowsPerBucket = memFree / (2 * J.params->coltot[h]);
-                if (rowsPerBucket > J.params->rowtot[h]) rowsPerBucket = static_cast<size_t>(J.params->rowtot[h]);
-                nBuckets = static_cast<int>(
-                    ceil(static_cast<double>(J.params->rowtot[h]) / static_cast<double>(rowsPerBucket)));
-                rowsLeft = static_cast<size_t>(J.params->rowtot[h] % rowsPerBucket);
-            } else {
-                nBuckets = 0;
-                rowsPerBucket = 0;
-                rowsLeft = 0;
-            }
-
-            if (print_ > 1) {
-                outfile->Printf("\th = %d; memfree         = %lu\n", h, memFree);
-                outfile->Printf("\th = %d; rows_per_bucket = %lu\n", h, rowsPerBucket);
-                outfile->Printf("\th = %d; rows_left       = %lu\n", h, rowsLeft);
-                outfile->Printf("\th = %d; nbuckets        = %d\n", h, nBuckets);
-            }
-
-            global_dpd_->buf4_mat_irrep_init_block(&J, h, rowsPerBucket);
-            global_dpd_->buf4_mat_irrep_init_block(&K, h, rowsPerBucket);
-
-            for (int n = 0; n < nBuckets; n++) {
-                if (nBuckets == 1)
-                    thisBucketRows = rowsPerBucket;
-                else
-                    thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
-                global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
-                for (int pq = 0; pq < thisBucketRows; pq++) {
-                    for (int Gr = 0; Gr < nirreps_; Gr++) {
-                        // Transform ( S1 S2 | n n ) -> ( S1 S2 | n s4 )
-                        int Gs = h ^ Gr;
-                        int nrows = sopi_[Gr];
-                        int ncols = bOrbsPI4[Gs];
-                        int nlinks = sopi_[Gs];
-                        int rs = J.col_offset[h][Gr];
-                        double **pc4b = c4b->pointer(Gs);
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J.matrix[h][pq][rs], nlinks, pc4b[0], ncols,
-                                    0.0, TMP[0], nso_);
-                        // TODO else if s4->label() == MOSPACE_NIL, copy buffer...
-
-                        // Transform ( S1 S2 | n s4 ) -> ( S1 S2 | s3 s4 )
-                        nrows = bOrbsPI3[Gr];
-                        ncols = bOrbsPI4[Gs];
-                        nlinks = sopi_[Gr];
-                        rs = K.col_offset[h][Gr];
-                        double **pc3b = c3b->pointer(Gr);
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc3b[0], nrows, TMP[0], nso_, 0.0,
-                                    &K.matrix[h][pq][rs], ncols);
-                        // TODO else if s3->label() == MOSPACE_NIL, copy buffer...
-                    } /* Gr */
-                    if (useIWL_) {
-                        int P = aIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
-                        int Q = aIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
-                        // dpd is smart enough to index only unique pairs in the bra
-                        // ( K.params->roworb contains no redundancies ), so there is
-                        // no need to skip any pq pairs when writing IWL
-                        // if( (P < Q) && bra_sym) continue;
-                        for (int rs = 0; rs < K.params->coltot[h]; rs++) {
-                            int R = bIndex3[K.params->colorb[h][rs][0]];
-                            int S = bIndex4[K.params->colorb[h][rs][1]];
-                            if ((R < S) && ket_sym) continue;
-                            iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
-                        } /* rs */
+                        iwl->write_value(P, Q, R, S, blocks[t][pq][rs], printTei_, "outfile", 0);
                     }
-                } /* pq */
-                global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
-            }
-            global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
-            global_dpd_->buf4_mat_irrep_close_block(&K, h, rowsPerBucket);
-        }
-        global_dpd_->buf4_close(&K);
-        global_dpd_->buf4_close(&J);
-
-        if (useIWL_) {
-            iwl->flush(1);
-            iwl->set_keep_flag(1);
-            // This closes the file too
-            delete iwl;
-        }
-
-        /*** AA/AB two-electron integral transformation complete ***/
-
-        if (print_) {
-            outfile->Printf("\tStarting BB second half-transformation.\n");
-        }
-        if (useIWL_) iwl = new IWL(psio_.get(), iwlBBIntFile_, tolerance_, 0, 0);
-
-        psio_->open(bHtIntFile_, PSIO_OPEN_OLD);
-
-        braCore = DPD_ID(s1, s2, SpinType::Beta, true);
-        ketCore = DPD_ID("[n,n]");
-        braDisk = DPD_ID(s1, s2, SpinType::Beta, true);
-        ketDisk = DPD_ID("[n>=n]+");
-        sprintf(label, "Half-Transformed Ints (%c%c|nn)", tolower(s1->label()), tolower(s2->label()));
-        global_dpd_->buf4_init(&J, bHtIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-        if (print_ > 5)
-            outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk,
-                            ketDisk);
-
-        braCore = DPD_ID(s1, s2, SpinType::Beta, true);
-        ketCore = DPD_ID(s3, s4, SpinType::Beta, false);
-        braDisk = DPD_ID(s1, s2, SpinType::Beta, true);
-        ketDisk = DPD_ID(s3, s4, SpinType::Beta, true);
-        if (bbIntName_.length())
-            strcpy(label, bbIntName_.c_str());
-        else
-            sprintf(label, "MO Ints (%c%c|%c%c)", tolower(s1->label()), tolower(s2->label()), tolower(s3->label()),
-                    tolower(s4->label()));
-        global_dpd_->buf4_init(&K, dpdIntFile_, 0, braCore, ketCore, braDisk, ketDisk, 0, label);
-        if (print_ > 5)
-            outfile->Printf("Initializing %s, in core:(%d|%d) on disk(%d|%d)\n", label, braCore, ketCore, braDisk,
-                            ketDisk);
-
-        for (int h = 0; h < nirreps_; h++) {
-            if (J.params->coltot[h] && J.params->rowtot[h]) {
-                memFree = static_cast<size_t>(dpd_memfree() - J.params->coltot[h] - K.params->coltot[h]);
-                rowsPerBucket = memFree / (2 * J.params->coltot[h]);
-                if (rowsPerBucket > J.params->rowtot[h]) rowsPerBucket = static_cast<size_t>(J.params->rowtot[h]);
-                nBuckets = static_cast<int>(
-                    ceil(static_cast<double>(J.params->rowtot[h]) / static_cast<double>(rowsPerBucket)));
-                rowsLeft = static_cast<size_t>(J.params->rowtot[h] % rowsPerBucket);
-            } else {
-                nBuckets = 0;
-                rowsPerBucket = 0;
-                rowsLeft = 0;
-            }
-
-            if (print_ > 1) {
-                outfile->Printf("\th = %d; memfree         = %lu\n", h, memFree);
-                outfile->Printf("\th = %d; rows_per_bucket = %lu\n", h, rowsPerBucket);
-                outfile->Printf("\th = %d; rows_left       = %lu\n", h, rowsLeft);
-                outfile->Printf("\th = %d; nbuckets        = %d\n", h, nBuckets);
+                }
             }
+        };
 
-            global_dpd_->buf4_mat_irrep_init_block(&J, h, rowsPerBucket);
-            global_dpd_->buf4_mat_irrep_init_block(&K, h, rowsPerBucket);
+        io_rows(J.file, Jblock[0], bucketStart(0), bucketRows(0), false);
+        std::future<void> io;
+        if (nBuckets > 1)
+            io = std::async(std::launch::async,
+                            [&]() { io_rows(J.file, Jblock[1], bucketStart(1), bucketRows(1), false); });
 
-            for (int n = 0; n < nBuckets; n++) {
-                if (nBuckets == 1)
-                    thisBucketRows = rowsPerBucket;
-                else
-                    thisBucketRows = (n < nBuckets - 1) ? rowsPerBucket : rowsLeft;
-                global_dpd_->buf4_mat_irrep_rd_block(&J, h, n * rowsPerBucket, thisBucketRows);
-                for (int pq = 0; pq < thisBucketRows; pq++) {
+        for (int n = 0; n < nBuckets; n++) {
+            double **Jn = Jblock[n % 2];
+            std::vector<double **> &Kn = Kblock[n % 2];
+            int nrows = bucketRows(n);
+
+#pragma omp parallel for schedule(static) num_threads(nthread)
+            for (int pq = 0; pq < nrows; pq++) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                double *Ju = scratch[thread].data();
+                double *T = Ju + nso2;
+                double *Ku = T + nso2;
+                const std::vector<int> &unpack = unpackJ[h];
+                for (size_t u = 0; u < unpack.size(); ++u) Ju[u] = Jn[pq][unpack[u]];
+
+                for (size_t t = 0; t < nket; ++t) {
+                    if (!Kn[t]) continue;
+                    double *out = ketPacked[t] ? Ku : Kn[t][pq];
                     for (int Gr = 0; Gr < nirreps_; Gr++) {
-                        // Transform ( s1 s2 | n n ) -> ( s1 s2 | n s4 )
+                        // Transform ( S1 S2 | n n ) -> ( S1 S2 | n S4 )
                         int Gs = h ^ Gr;
-                        int nrows = sopi_[Gr];
-                        int ncols = bOrbsPI4[Gs];
-                        int nlinks = sopi_[Gs];
-                        int rs = J.col_offset[h][Gr];
-                        double **pc4b = c4b->pointer(Gs);
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J.matrix[h][pq][rs], nlinks, pc4b[0], ncols,
-                                    0.0, TMP[0], nso_);
-
-                        // Transform ( s1 s2 | n s4 ) -> ( s1 s2 | s3 s4 )
-                        nrows = bOrbsPI3[Gr];
-                        ncols = bOrbsPI4[Gs];
-                        nlinks = sopi_[Gr];
-                        rs = K.col_offset[h][Gr];
-                        double **pc3b = c3b->pointer(Gr);
-                        if (nrows && ncols && nlinks)
-                            C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, pc3b[0], nrows, TMP[0], nso_, 0.0,
-                                    &K.matrix[h][pq][rs], ncols);
+                        int nrow = sopi_[Gr];
+                        int ncol = orbsPI4[t][Gs];
+                        int nlink = sopi_[Gs];
+                        if (nrow && ncol && nlink)
+                            C_DGEMM('n', 'n', nrow, ncol, nlink, 1.0, &Ju[colOffset[h][Gr]], nlink,
+                                    c4[t]->pointer(Gs)[0], ncol, 0.0, T, nso_);
+
+                        // Transform ( S1 S2 | n S4 ) -> ( S1 S2 | S3 S4 )
+                        nrow = orbsPI3[t][Gr];
+                        nlink = sopi_[Gr];
+                        if (nrow && ncol && nlink)
+                            C_DGEMM('t', 'n', nrow, ncol, nlink, 1.0, c3[t]->pointer(Gr)[0], nrow, T, nso_, 0.0,
+                                    &out[Kunp[t].col_offset[h][Gr]], ncol);
                     } /* Gr */
-                    if (useIWL_) {
-                        int P = bIndex1[K.params->roworb[h][pq + n * rowsPerBucket][0]];
-                        int Q = bIndex2[K.params->roworb[h][pq + n * rowsPerBucket][1]];
-                        // dpd is smart enough to index only unique pairs in the bra
-                        // ( K.params->roworb contains no redundancies ), so there is
-                        // no need to skip any pq pairs when writing IWL
-                        // if( (P < Q) && bra_sym) continue;
-                        size_t PQ = INDEX(P, Q);
-                        for (int rs = 0; rs < K.params->coltot[h]; rs++) {
-                            int R = bIndex3[K.params->colorb[h][rs][0]];
-                            int S = bIndex4[K.params->colorb[h][rs][1]];
-                            if ((R < S) && ket_sym) continue;
-                            size_t RS = INDEX(R, S);
-                            if ((RS < PQ) && bra_ket_sym) continue;
-                            iwl->write_value(P, Q, R, S, K.matrix[h][pq][rs], printTei_, "outfile", 0);
-                        } /* rs */
+                    if (ketPacked[t]) {
+                        const std::vector<int> &pack = packK[t][h];
+                        for (size_t rs = 0; rs < pack.size(); ++rs) Kn[t][pq][rs] = Ku[pack[rs]];
                     }
-                } /* pq */
-                global_dpd_->buf4_mat_irrep_wrt_block(&K, h, n * rowsPerBucket, thisBucketRows);
-            }
-            global_dpd_->buf4_mat_irrep_close_block(&J, h, rowsPerBucket);
-            global_dpd_->buf4_mat_irrep_close_block(&K, h, rowsPerBucket);
+                } /* t */
+            }     /* pq */
+
+            // Write this bucket and read the one after next, into the half-transformed block just used
+            if (io.valid()) io.get();
+            io = std::async(std::launch::async, [&, n]() {
+                for (size_t t = 0; t < nket; ++t)
+                    if (Kblock[n % 2][t]) io_rows(K[t].file, Kblock[n % 2][t], bucketStart(n), bucketRows(n), true);
+                if (useIWL_) write_iwl(n);
+                if (n + 2 < nBuckets) io_rows(J.file, Jblock[n % 2], bucketStart(n + 2), bucketRows(n + 2), false);
+            });
         }
-        global_dpd_->buf4_close(&K);
-        global_dpd_->buf4_close(&J);
-
-        psio_->close(bHtIntFile_, keepHtInts_);
+        io.get();
 
-        if (useIWL_) {
-            iwl->flush(1);
-            iwl->set_keep_flag(1);
-            // This closes the file too
-            delete iwl;
+        for (int b = 0; b < 2; ++b) {
+            global_dpd_->free_dpd_block(Jblock[b], rowsPerBucket, J.params->coltot[h]);
+            for (size_t t = 0; t < nket; ++t)
+                if (Kblock[b][t]) global_dpd_->free_dpd_block(Kblock[b][t], rowsPerBucket, K[t].params->coltot[h]);
         }
-        /*** BB two-electron integral transformation complete ***/
-    }  // End "if not restricted transformation"
-
-    psio_->close(dpdIntFile_, 1);
-    psio_->close(aHtIntFile_, keepHtInts_);
-
-    free_block(TMP);
-    delete[] label;
-
-    if (print_) {
-        outfile->Printf("\tTwo-electron integral transformation complete.\n");
     }
 
-    // Reset the integral file names, before the next transformation is called
-    aaIntName_ = "";
-    abIntName_ = "";
-    bbIntName_ = "";
+    for (size_t t = 0; t < nket; ++t) {
+        global_dpd_->buf4_close(&Kunp[t]);
+        global_dpd_->buf4_close(&K[t]);
+    }
+    global_dpd_->buf4_close(&J);
 
-    // Hand DPD control back to the user
-    dpd_set_default(currentActiveDPD);
+    if (useIWL_) {
+        iwl->flush(1);
+        iwl->set_keep_flag(1);
+        // This closes the file too
+        delete iwl;
+    }
 }
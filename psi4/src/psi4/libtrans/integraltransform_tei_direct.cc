@@ -0,0 +1,312 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+#include "integraltransform_functors.h"
+#include "mospace.h"
+#include "integraltransform.h"
+
+#include "psi4/libpsio/psio.hpp"
+#include "psi4/libciomr/libciomr.h"
+#include "psi4/libqt/qt.h"
+#include "psi4/libmints/basisset.h"
+#include "psi4/libmints/integral.h"
+#include "psi4/libmints/matrix.h"
+#include "psi4/libmints/sobasis.h"
+#include "psi4/libmints/sointegral_twobody.h"
+#include "psi4/libmints/twobody.h"
+#include "psi4/libmints/wavefunction.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/psifiles.h"
+
+#include <array>
+#include <cctype>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace psi;
+
+/**
+ * Builds the (threaded) SO-basis ERI object used by the integral-direct transformation.
+ */
+std::shared_ptr<TwoBodySOInt> IntegralTransform::direct_so_eri() {
+    if (!wfn_)
+        throw PSIEXCEPTION(
+            "IntegralTransform: integral-direct transformations need the basis set, so this object must be "
+            "constructed from a wavefunction.  Set SO_TEI_FORMAT to IWL or BLOCKS instead.");
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+    std::shared_ptr<BasisSet> basis = wfn_->basisset();
+    auto integral = std::make_shared<IntegralFactory>(basis, basis, basis, basis);
+    std::vector<std::shared_ptr<TwoBodyAOInt>> tb;
+    for (int i = 0; i < nthread; ++i) tb.push_back(std::shared_ptr<TwoBodyAOInt>(integral->eri()));
+    auto eri = std::make_shared<TwoBodySOInt>(tb, integral);
+    eri->set_cutoff(Process::environment.options.get_double("INTS_TOLERANCE"));
+    return eri;
+}
+
+/**
+ * The integral-direct counterpart of transform_tei_first_half.  Rather than reading presorted
+ * SO integrals, the [n>=n]+ rows are split into buckets that fit in memory, and for each bucket
+ * every SO shell quartet touching its rows is computed, scattered into full (nn|n,n) rows and
+ * transformed to (nn|S1S2) in core.  The half-transformed rows are written straight into the
+ * usual DPD buffers, so the second half-transformation is unaffected.
+ */
+void IntegralTransform::transform_tei_first_half_direct(const std::shared_ptr<MOSpace> s1,
+                                                        const std::shared_ptr<MOSpace> s2) {
+    bool restricted = transformationType_ == TransformationType::Restricted;
+
+    SharedMatrix c1a = aMOCoefficients_[s1->label()];
+    SharedMatrix c1b = bMOCoefficients_[s1->label()];
+    SharedMatrix c2a = aMOCoefficients_[s2->label()];
+    SharedMatrix c2b = bMOCoefficients_[s2->label()];
+    int *aOrbsPI1 = aOrbsPI_[s1->label()];
+    int *bOrbsPI1 = bOrbsPI_[s1->label()];
+    int *aOrbsPI2 = aOrbsPI_[s2->label()];
+    int *bOrbsPI2 = bOrbsPI_[s2->label()];
+
+    int currentActiveDPD = psi::dpd_default;
+    dpd_set_default(myDPDNum_);
+
+    if (print_) {
+        if (restricted) {
+            outfile->Printf("\tStarting integral-direct first half-transformation.\n");
+        } else {
+            outfile->Printf("\tStarting integral-direct AA/AB and BB first half-transformation.\n");
+        }
+    }
+
+    psio_->open(PSIF_HALFT0, PSIO_OPEN_NEW);
+
+    char label[100];
+    dpdbuf4 Ka, Kb;
+    sprintf(label, "Half-Transformed Ints (nn|%c%c)", toupper(s1->label()), toupper(s2->label()));
+    global_dpd_->buf4_init(&Ka, PSIF_HALFT0, 0, DPD_ID("[n>=n]+"), DPD_ID(s1, s2, SpinType::Alpha, false),
+                           DPD_ID("[n>=n]+"), DPD_ID(s1, s2, SpinType::Alpha, true), 0, label);
+    if (!restricted) {
+        sprintf(label, "Half-Transformed Ints (nn|%c%c)", tolower(s1->label()), tolower(s2->label()));
+        global_dpd_->buf4_init(&Kb, PSIF_HALFT0, 0, DPD_ID("[n>=n]+"), DPD_ID(s1, s2, SpinType::Beta, false),
+                               DPD_ID("[n>=n]+"), DPD_ID(s1, s2, SpinType::Beta, true), 0, label);
+    }
+    dpdparams4 *params = Ka.params;
+
+    // The layout of an unpacked (n,n) ket of each irrep
+    int colOffset[8][8];
+    std::vector<size_t> colTot(nirreps_, 0);
+    for (int h = 0; h < nirreps_; ++h) {
+        for (int Gr = 0; Gr < nirreps_; ++Gr) {
+            colOffset[h][Gr] = colTot[h];
+            colTot[h] += (size_t)sopi_[Gr] * sopi_[h ^ Gr];
+        }
+    }
+
+    int nthread = 1;
+#ifdef _OPENMP
+    nthread = Process::environment.get_n_threads();
+#endif
+
+    // Split the rows of every irrep into buckets, holding the SO rows and their half-transformed images
+    long int scratch = (long int)nthread * nso_ * nso_;
+    long int memFree = dpd_memfree() - scratch;
+    std::vector<std::array<int, 8>> rowOffset(1, std::array<int, 8>{});
+    std::vector<std::array<int, 8>> rowDim(1, std::array<int, 8>{});
+    std::vector<int> pqBucket(nTriSo_);
+    long int coreLeft = memFree;
+    for (int h = 0; h < nirreps_; ++h) {
+        long int rowLength = colTot[h] + Ka.params->coltot[h] + (restricted ? 0 : Kb.params->coltot[h]);
+        if (params->rowtot[h] && rowLength > memFree)
+            throw PSIEXCEPTION(
+                "IntegralTransform: not enough memory for the integral-direct first half-transformation.");
+        for (int row = 0; row < params->rowtot[h]; ++row) {
+            if (coreLeft < rowLength) {
+                rowOffset.push_back(std::array<int, 8>{});
+                rowDim.push_back(std::array<int, 8>{});
+                rowOffset.back()[h] = row;
+                coreLeft = memFree;
+            }
+            coreLeft -= rowLength;
+            rowDim.back()[h]++;
+            pqBucket[INDEX(params->roworb[h][row][0], params->roworb[h][row][1])] = rowDim.size() - 1;
+        }
+    }
+    int nBuckets = rowDim.size();
+    if (print_) outfile->Printf("\tNumber of integral passes = %d\n", nBuckets);
+
+    // The absolute SO indices spanned by each SO shell
+    std::shared_ptr<TwoBodySOInt> eri = direct_so_eri();
+    std::shared_ptr<SOBasisSet> sobasis = eri->basis1();
+    int nshell = sobasis->nshell();
+    std::vector<std::vector<int>> shellSOs(nshell);
+    for (int P = 0; P < nshell; ++P) {
+        for (int i = 0; i < sobasis->nfunction(P); ++i) {
+            int f = sobasis->function(P) + i;
+            int irrep = sobasis->irrep(f);
+            shellSOs[P].push_back(sobasis->function_offset_for_irrep(irrep) + sobasis->function_within_irrep(f));
+        }
+    }
+
+    std::vector<double **> TMP(nthread);
+    for (int t = 0; t < nthread; ++t) TMP[t] = block_matrix(nso_, nso_);
+
+    for (int n = 0; n < nBuckets; ++n) {
+        // Flag the shell pairs that contribute a row to this bucket
+        std::vector<char> touches(nshell * (nshell + 1) / 2, 0);
+        for (int P = 0; P < nshell; ++P) {
+            for (int Q = 0; Q <= P; ++Q) {
+                char &t = touches[INDEX(P, Q)];
+                for (int p : shellSOs[P])
+                    for (int q : shellSOs[Q]) t |= pqBucket[INDEX(p, q)] == n;
+            }
+        }
+
+        std::vector<std::array<int, 4>> quartets;
+        SOShellCombinationsIterator shellIter(sobasis, sobasis, sobasis, sobasis);
+        for (shellIter.first(); !shellIter.is_done(); shellIter.next()) {
+            if (touches[INDEX(shellIter.p(), shellIter.q())] || touches[INDEX(shellIter.r(), shellIter.s())])
+                quartets.push_back({{shellIter.p(), shellIter.q(), shellIter.r(), shellIter.s()}});
+        }
+
+        std::vector<double **> J(nirreps_, nullptr);
+        for (int h = 0; h < nirreps_; ++h)
+            if (rowDim[n][h] && colTot[h]) J[h] = block_matrix(rowDim[n][h], colTot[h]);
+
+        DirectSOFillerFunctor filler(J.data(), params, pqBucket.data(), rowOffset[n].data(), colOffset, sopi_, n);
+        const long nquartet = quartets.size();
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+        for (long Q = 0; Q < nquartet; ++Q) {
+            const std::array<int, 4> &q = quartets[Q];
+            eri->compute_shell(q[0], q[1], q[2], q[3], filler);
+        }
+
+        // Transform ( n n | n n ) -> ( n n | n S2 ) -> ( n n | S1 S2 ), row by row
+        for (int spin = 0; spin < (restricted ? 1 : 2); ++spin) {
+            dpdbuf4 &K = spin ? Kb : Ka;
+            SharedMatrix c1 = spin ? c1b : c1a;
+            SharedMatrix c2 = spin ? c2b : c2a;
+            int *orbsPI1 = spin ? bOrbsPI1 : aOrbsPI1;
+            int *orbsPI2 = spin ? bOrbsPI2 : aOrbsPI2;
+            for (int h = 0; h < nirreps_; ++h) {
+                int nrow = rowDim[n][h];
+                if (!nrow || !K.params->coltot[h]) continue;
+                global_dpd_->buf4_mat_irrep_init_block(&K, h, nrow);
+#pragma omp parallel for schedule(dynamic) num_threads(nthread)
+                for (int pq = 0; pq < nrow; ++pq) {
+                    int thread = 0;
+#ifdef _OPENMP
+                    thread = omp_get_thread_num();
+#endif
+                    double **T = TMP[thread];
+                    for (int Gr = 0; Gr < nirreps_; ++Gr) {
+                        int Gs = h ^ Gr;
+                        int nrows = sopi_[Gr];
+                        int ncols = orbsPI2[Gs];
+                        int nlinks = sopi_[Gs];
+                        if (nrows && ncols && nlinks)
+                            C_DGEMM('n', 'n', nrows, ncols, nlinks, 1.0, &J[h][pq][colOffset[h][Gr]], nlinks,
+                                    c2->pointer(Gs)[0], ncols, 0.0, T[0], nso_);
+
+                        nrows = orbsPI1[Gr];
+                        nlinks = sopi_[Gr];
+                        if (nrows && ncols && nlinks)
+                            C_DGEMM('t', 'n', nrows, ncols, nlinks, 1.0, c1->pointer(Gr)[0], nrows, T[0], nso_, 0.0,
+                                    &K.matrix[h][pq][K.col_offset[h][Gr]], ncols);
+                    }
+                }
+                global_dpd_->buf4_mat_irrep_wrt_block(&K, h, rowOffset[n][h], nrow);
+                global_dpd_->buf4_mat_irrep_close_block(&K, h, nrow);
+            }
+        }
+
+        for (int h = 0; h < nirreps_; ++h)
+            if (J[h]) free_block(J[h]);
+    }
+
+    for (int t = 0; t < nthread; ++t) free_block(TMP[t]);
+    global_dpd_->buf4_close(&Ka);
+    if (!restricted) global_dpd_->buf4_close(&Kb);
+
+    if (print_) {
+        if (restricted) {
+            outfile->Printf("\tSorting half-transformed integrals.\n");
+        } else {
+            outfile->Printf("\tSorting AA/AB and BB half-transformed integrals.\n");
+        }
+    }
+    sort_half_transformed_tei(s1, s2, SpinType::Alpha);
+    if (!restricted) sort_half_transformed_tei(s1, s2, SpinType::Beta);
+    psio_->close(PSIF_HALFT0, 0);
+
+    if (print_) {
+        outfile->Printf("\tFirst half integral transformation complete.\n");
+    }
+
+    dpd_set_default(currentActiveDPD);
+}
+
+/**
+ * The integral-direct counterpart of the presorted Fock-like builds in compute_fock_like_matrices:
+ * adds J[D] - K[D]/2 for each totally symmetric density in Dmats to the matching matrix in Fmats.
+ */
+void IntegralTransform::compute_fock_like_matrices_direct(const std::vector<SharedMatrix> &Dmats,
+                                                          std::vector<SharedMatrix> &Fmats) {
+    int nmats = Dmats.size();
+
+    // The restricted Fock functor works on lower triangles over absolute SO indices, and builds 2J - K
+    std::vector<std::vector<double>> D(nmats, std::vector<double>(nTriSo_, 0.0));
+    std::vector<std::vector<double>> F(nmats, std::vector<double>(nTriSo_, 0.0));
+    std::vector<std::vector<double>> Fz(nmats, std::vector<double>(nTriSo_, 0.0));
+    for (int N = 0; N < nmats; ++N) {
+        for (int h = 0, soOffset = 0; h < nirreps_; ++h) {
+            for (int p = 0; p < sopi_[h]; ++p)
+                for (int q = 0; q <= p; ++q) D[N][INDEX(p + soOffset, q + soOffset)] = Dmats[N]->get(h, p, q);
+            soOffset += sopi_[h];
+        }
+    }
+    std::vector<FrozenCoreAndFockRestrictedFunctor> builds;
+    for (int N = 0; N < nmats; ++N) builds.emplace_back(D[N].data(), D[N].data(), F[N].data(), Fz[N].data());
+    auto fock = [&](int pabs, int qabs, int rabs, int sabs, int psym, int prel, int qsym, int qrel, int rsym, int rrel,
+                    int ssym, int srel, double value) {
+        for (auto &build : builds)
+            build(pabs, qabs, rabs, sabs, psym, prel, qsym, qrel, rsym, rrel, ssym, srel, value);
+    };
+    direct_so_eri()->compute_integrals(fock);
+
+    for (int N = 0; N < nmats; ++N) {
+        for (int h = 0, soOffset = 0; h < nirreps_; ++h) {
+            for (int p = 0; p < sopi_[h]; ++p)
+                for (int q = 0; q < sopi_[h]; ++q)
+                    Fmats[N]->add(h, p, q, 0.5 * F[N][INDEX(p + soOffset, q + soOffset)]);
+            soOffset += sopi_[h];
+        }
+    }
+}
@@ -46,6 +46,25 @@ using namespace psi;
 
 namespace psi { namespace occwave{
 
+namespace {
+// Rough number of doubles in the MO integral, amplitude and density files for one spin block (1,2):
+// each integral class is held as Mulliken and Dirac copies and once more as a density block,
+// and the oovv class carries the amplitudes besides.
+size_t dpd_block_doubles(int nirrep, const int *occ1, const int *vir1, const int *occ2, const int *vir2) {
+    size_t doubles = 0;
+    for (int h = 0; h < nirrep; h++) {
+        size_t oo = 0, ov = 0, vv = 0;
+        for (int h1 = 0; h1 < nirrep; h1++) {
+            oo += (size_t)occ1[h1] * occ2[h1 ^ h];
+            ov += (size_t)occ1[h1] * vir2[h1 ^ h];
+            vv += (size_t)vir1[h1] * vir2[h1 ^ h];
+        }
+        doubles += 3 * (oo * oo + oo * ov + oo * vv + ov * ov + ov * vv + vv * vv) + 4 * oo * vv;
+    }
+    return doubles;
+}
+}  // namespace
+
 OCCWave::OCCWave(SharedWavefunction ref_wfn, Options &options)
     : Wavefunction(options)
 {
@@ -232,11 +251,13 @@ if (reference_ == "RESTRICTED") {
         cost_iabc_ *= (size_t)sizeof(double);
         cost_abcd_ *= (size_t)sizeof(double);
 
+        memory = Process::environment.get_memory();
+        memory_mb_ = memory/1000000L;
+        cost_dpd_ = dpd_block_doubles(nirrep_, aoccpiA, avirtpiA, aoccpiA, avirtpiA) * sizeof(double) / 1000000L;
+
         // print
     if (wfn_type_ == "OMP2") {
         // Print memory
-        memory = Process::environment.get_memory();
-        memory_mb_ = memory/1000000L;
         outfile->Printf("\n\tMemory is %6lu MB \n", memory_mb_);
         outfile->Printf("\tCost of iabc is %6lu MB \n", cost_iabc_);
         outfile->Printf("\tCost of abcd is %6lu MB \n", cost_abcd_);
@@ -300,6 +321,7 @@ else {
         ints->set_keep_iwl_so_ints(false);
         ints->set_keep_dpd_so_ints(false);
     }
+    set_dpd_cache();
     ints->initialize();
     dpd_set_default(ints->get_dpd_id());
 
@@ -349,6 +371,12 @@ else if (reference_ == "UNRESTRICTED") {
         }
         outfile->Printf(     "\t==========================================\n");
 
+        memory = Process::environment.get_memory();
+        memory_mb_ = memory/1000000L;
+        cost_dpd_ = (dpd_block_doubles(nirrep_, aoccpiA, avirtpiA, aoccpiA, avirtpiA) +
+                     dpd_block_doubles(nirrep_, aoccpiB, avirtpiB, aoccpiB, avirtpiB) +
+                     dpd_block_doubles(nirrep_, aoccpiA, avirtpiA, aoccpiB, avirtpiB)) * sizeof(double) / 1000000L;
+
 
     // Alloc ints
     std::vector<std::shared_ptr<MOSpace> > spaces;
@@ -373,12 +401,26 @@ else if (reference_ == "UNRESTRICTED") {
         ints->set_keep_iwl_so_ints(false);
         ints->set_keep_dpd_so_ints(false);
     }
+    set_dpd_cache();
     ints->initialize();
     dpd_set_default(ints->get_dpd_id());
 
 }// end if (reference_ == "UNRESTRICTED")
 }// end common_init
 
+void OCCWave::set_dpd_cache()
+{
+    // Keep the integral, amplitude and density files in core when they fit; libdpd evicts to disk if they outgrow it
+    outfile->Printf("\n\tCost of the DPD files is %6lu MB \n", cost_dpd_);
+    if (cachelev > 0 && cost_dpd_ < memory_mb_) {
+        ints->set_dpd_cache_files({PSIF_LIBTRANS_DPD, PSIF_OCC_DPD, PSIF_OCC_DENSITY});
+        outfile->Printf("\tHolding the DPD files in core..\n");
+    }
+    else {
+        outfile->Printf("\tKeeping the DPD files on disk..\n");
+    }
+}
+
 void OCCWave::title()
 {
    outfile->Printf("\n");
@@ -46,6 +46,7 @@ class OCCWave : public Wavefunction
 {
 
     void common_init();
+    void set_dpd_cache();
 
 public:
     OCCWave(std::shared_ptr<Wavefunction> reference_wavefunction, Options &options);
@@ -229,6 +230,7 @@ protected:
      size_t memory_mb_;
      size_t cost_iabc_;            // Mem required for the <ia|bc> integrals
      size_t cost_abcd_;            // Mem required for the <ab|cd> integrals
+     size_t cost_dpd_;             // Mem required for the DPD integral, amplitude and density files
 
      // Common
      double Enuc;
@@ -83,6 +83,53 @@ bool COMBO_COORDINATES::DqDx(GeomType geom, int lookup, double *dqdx, int atom_o
   return true;
 }
 
+void COMBO_COORDINATES::sparse_B(GeomType geom, SPARSE_B &B) const {
+  B.offset.resize(simples.size());
+  int n = 0;
+  for (std::size_t s=0; s<simples.size(); ++s) {
+    B.offset[s] = n;
+    n += 3 * simples[s]->g_natom();
+  }
+  B.dqdx.resize(n);
+
+  for (std::size_t s=0; s<simples.size(); ++s) {
+    double **dqdx_simple = simples[s]->DqDx(geom);
+    for (int j=0; j < simples[s]->g_natom(); ++j)
+      for (int xyz=0; xyz<3; ++xyz)
+        B.dqdx[B.offset[s] + 3*j + xyz] = dqdx_simple[j][xyz];
+    free_matrix(dqdx_simple);
+  }
+}
+
+void COMBO_COORDINATES::B_product(const SPARSE_B &B, const double *x, double *y) const {
+  for (std::size_t cc=0; cc<index.size(); ++cc) {
+    double tval = 0.0;
+    for (std::size_t s=0; s<index[cc].size(); ++s) {
+      const SIMPLE_COORDINATE *q = simples[index[cc][s]];
+      const double *d = &B.dqdx[B.offset[index[cc][s]]];
+      double qx = 0.0;
+      for (int j=0; j < q->g_natom(); ++j)
+        for (int xyz=0; xyz<3; ++xyz)
+          qx += d[3*j + xyz] * x[3*q->g_atom(j) + xyz];
+      tval += coeff[cc][s] * qx;
+    }
+    y[cc] = tval;
+  }
+}
+
+void COMBO_COORDINATES::Bt_product(const SPARSE_B &B, const double *y, double *x) const {
+  for (std::size_t cc=0; cc<index.size(); ++cc) {
+    for (std::size_t s=0; s<index[cc].size(); ++s) {
+      const SIMPLE_COORDINATE *q = simples[index[cc][s]];
+      const double *d = &B.dqdx[B.offset[index[cc][s]]];
+      double c = coeff[cc][s] * y[cc];
+      for (int j=0; j < q->g_natom(); ++j)
+        for (int xyz=0; xyz<3; ++xyz)
+          x[3*q->g_atom(j) + xyz] += c * d[3*j + xyz];
+    }
+  }
+}
+
 // Fills in a B' derivative matrix for one coordinate.
 // If the desired cartesian indices/dimension spans more than just one fragment, provide the atom offset.
 
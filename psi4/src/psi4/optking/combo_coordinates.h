@@ -42,6 +42,14 @@ using std::string;
 
 namespace opt {
 
+// B matrix held as the dq/dx of each simple coordinate (3 entries per atom of the simple);
+// products with the combinations are formed on the fly, so storage and cost scale with the
+// number of simples instead of (number of coordinates) x (3 * number of atoms).
+struct SPARSE_B {
+  vector<int>    offset; // start of the derivatives of each simple in dqdx
+  vector<double> dqdx;
+};
+
 class COMBO_COORDINATES {
 
   private:
@@ -99,6 +107,15 @@ class COMBO_COORDINATES {
 
   int Nsimples(void) const { return simples.size(); }
 
+  // Compute the derivatives of all simples once for sparse B products.
+  void sparse_B(GeomType geom, SPARSE_B &B) const;
+
+  // y = B x for all combination coordinates.
+  void B_product(const SPARSE_B &B, const double *x, double *y) const;
+
+  // x += B^t y; x spans the cartesians of the fragment and must be zeroed by the caller.
+  void Bt_product(const SPARSE_B &B, const double *y, double *x) const;
+
 };
 
 }
@@ -52,6 +52,11 @@
  #include "qcmath.h"
 #endif
 #include "psi4/libpsi4util/PsiOutStream.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
 namespace opt {
 
 using namespace v3d;
@@ -103,32 +108,70 @@ void FRAG::set_masses(void) {
 
 // automatically determine bond connectivity by comparison of interatomic distance
 //with scale_connectivity * sum of covalent radii
+// Atoms are binned into cubic cells as large as the longest possible bond, so only
+// atoms in neighboring cells are compared and the cost grows linearly with natom.
 void FRAG::update_connectivity_by_distances(void) {
   int i, j, *Zint;
   double Rij;
   double scale = Opt_params.scale_connectivity;
 
   Zint = new int [natom];
+  double max_radius = 0.0;
   for (i=0; i<natom; ++i) {
     Zint[i] = (int) Z[i];
     if ( Zint[i] > LAST_COV_RADII_INDEX )
       throw(INTCO_EXCEPT("Warning: cannot automatically bond atom with strange atomic number"));
+    max_radius = std::max(max_radius, cov_radii[Zint[i]]);
   }
 
   for (i=0; i<natom; ++i)
     for (j=0; j<natom; ++j)
       connectivity[i][j] = false;
 
+  double cell = 2.0 * scale * max_radius / _bohr2angstroms;
+  if (natom < 2 || cell <= 0.0) {
+    delete [] Zint;
+    return;
+  }
+
+  auto cell_index = [&](int atom, int xyz) { return (long long) std::floor(geom[atom][xyz] / cell); };
+  auto cell_key = [](long long x, long long y, long long z) {
+    return ((x & 0x1FFFFF) << 42) | ((y & 0x1FFFFF) << 21) | (z & 0x1FFFFF);
+  };
+
+  std::unordered_map<long long, std::vector<int> > cells;
+  for (i=0; i<natom; ++i)
+    cells[cell_key(cell_index(i,0), cell_index(i,1), cell_index(i,2))].push_back(i);
+
   for (i=0; i<natom; ++i) {
-    for (j=0; j<i; ++j) {
-      Rij = v3d_dist(geom[i], geom[j]);
-      if (Rij < scale * (cov_radii[Zint[i]] + cov_radii[Zint[j]])/_bohr2angstroms)
-        connectivity[i][j] = connectivity[j][i] = true;
-    }
+    long long cx = cell_index(i,0), cy = cell_index(i,1), cz = cell_index(i,2);
+    for (long long dx=-1; dx<=1; ++dx)
+      for (long long dy=-1; dy<=1; ++dy)
+        for (long long dz=-1; dz<=1; ++dz) {
+          auto it = cells.find(cell_key(cx+dx, cy+dy, cz+dz));
+          if (it == cells.end()) continue;
+          for (int j : it->second) {
+            if (j >= i) continue;
+            Rij = v3d_dist(geom[i], geom[j]);
+            if (Rij < scale * (cov_radii[Zint[i]] + cov_radii[Zint[j]])/_bohr2angstroms)
+              connectivity[i][j] = connectivity[j][i] = true;
+          }
+        }
   }
   delete [] Zint;
 }
 
+// bonded neighbors of each atom in increasing order, so loops over bonded
+// partners need not scan full rows of the connectivity matrix
+std::vector<std::vector<int> > FRAG::bonded_neighbors(void) const {
+  std::vector<std::vector<int> > nbrs(natom);
+  for (int i=0; i<natom; ++i)
+    for (int j=0; j<natom; ++j)
+      if (connectivity[i][j])
+        nbrs[i].push_back(j);
+  return nbrs;
+}
+
 //build connectivity matrix from the current set of bonds
 void FRAG::update_connectivity_by_bonds(void) {
   for (int i=0; i<natom; ++i)
@@ -280,12 +323,12 @@ int FRAG::add_auxiliary_bonds(void) {
 int FRAG::add_bend_by_connectivity(void) {
   int nadded = 0;
   double phi;
+  std::vector<std::vector<int> > nbrs = bonded_neighbors();
 
   for (int i=0; i<natom; ++i)
-    for (int j=0; j<natom; ++j)
-      if (connectivity[i][j])
-        for (int k=i+1; k<natom; ++k)
-          if (connectivity[j][k]) {
+    for (int j : nbrs[i])
+      for (int k : nbrs[j])
+          if (k > i) {
             if (v3d_angle(geom[i], geom[j], geom[k], phi)) { // can be computed
 
               BEND *one_bend = new BEND(i,j,k);
@@ -367,11 +410,11 @@ int FRAG::add_tors_by_connectivity(void) {
 
   // bonding i-j-k-l but i-j-k && j-k-l are not collinear
   // use presence of linear bend coordinate to judge collinearity
+  std::vector<std::vector<int> > nbrs = bonded_neighbors();
   for (i=0; i<natom; ++i)
-    for (j=0; j<natom; ++j)
-      if (connectivity[i][j])
-        for (k=0; k<natom; ++k)
-          if ( connectivity[k][j] && k!=i ) {
+    for (int j : nbrs[i])
+        for (int k : nbrs[j])
+          if ( k!=i ) {
 
             // ensure i-j-k is not collinear
             BEND *one_bend = new BEND(i,j,k);
@@ -384,8 +427,8 @@ int FRAG::add_tors_by_connectivity(void) {
             //if (!v3d_angle(geom[i], geom[j], geom[k], phi)) continue;
             //if (phi > phi_lim) continue;
 
-            for (l=i+1; l<natom; ++l) {
-              if (connectivity[l][k] && l!=j) {
+            for (int l : nbrs[k]) {
+              if (l > i && l!=j) {
 
                 // ensure j-k-l is not collinear
                 BEND *one_bend = new BEND(j,k,l);
@@ -100,6 +100,8 @@ class FRAG {
 
   void update_connectivity_by_distances(void);
   void update_connectivity_by_bonds(void);
+  // bonded partners of each atom from the connectivity matrix
+  std::vector<std::vector<int> > bonded_neighbors(void) const;
 
   void print_connectivity(std::string psi_fp, FILE *qc_fp, const int id, const int offset = 0) const ;
 
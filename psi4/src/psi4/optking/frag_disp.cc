@@ -31,6 +31,8 @@
     \brief   displace fragment geometry only dq changes to values of coordinates
 */
 
+#include <vector>
+
 #include "frag.h"
 #include "linear_algebra.h"
 #include "opt_data.h"
@@ -47,6 +49,41 @@
 
 namespace opt {
 
+// Least-squares solution of B dx = dq by conjugate gradients on the normal equations (CGLS).
+// Started from zero it converges to the minimum-norm solution dx = B^t (B B^t)^-1 dq of the
+// direct path, using only sparse products with B and B^t.
+static void back_transform_cgls(const COMBO_COORDINATES &coords, const SPARSE_B &B,
+    int Nints, int Ncarts, const double *dq, double *dx) {
+  std::vector<double> r(dq, dq + Nints), q(Nints);
+  std::vector<double> s(Ncarts, 0.0), p(Ncarts);
+
+  for (int i=0; i<Ncarts; ++i)
+    dx[i] = 0.0;
+
+  coords.Bt_product(B, r.data(), s.data());
+  p = s;
+  double gamma = array_dot(s.data(), s.data(), Ncarts);
+  const double gamma_conv = 1.0e-20 * gamma;
+
+  for (int iter=0; iter < 2*Ncarts && gamma > gamma_conv; ++iter) {
+    coords.B_product(B, p.data(), q.data());
+    double qq = array_dot(q.data(), q.data(), Nints);
+    if (qq <= 0.0) break;
+
+    double alpha = gamma / qq;
+    for (int i=0; i<Ncarts; ++i) dx[i] += alpha * p[i];
+    for (int i=0; i<Nints; ++i)  r[i]  -= alpha * q[i];
+
+    for (int i=0; i<Ncarts; ++i) s[i] = 0.0;
+    coords.Bt_product(B, r.data(), s.data());
+    double gamma_new = array_dot(s.data(), s.data(), Ncarts);
+
+    double beta = gamma_new / gamma;
+    for (int i=0; i<Ncarts; ++i) p[i] = s[i] + beta * p[i];
+    gamma = gamma_new;
+  }
+}
+
 // dq - displacements in intrafragment internal coordinates to be performed; overridden
 //      to actual displacements performed
 // fq - internal coordinate forces (used for printing)
@@ -251,8 +288,18 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
   double * first_geom = init_array(Ncarts); // first try at back-transformation
   double * dx = init_array(Ncarts);
   double * tmp_v_Nints = init_array(Nints);
-  double **B = init_matrix(Nints, Ncarts);
-  double **G = init_matrix(Nints, Nints);
+
+  // large fragments avoid the dense B and the generalized inverse of G
+  bool iterative = (Opt_params.bt_solver == OPT_PARAMS::ITERATIVE) ||
+      (Opt_params.bt_solver == OPT_PARAMS::AUTO && natom >= Opt_params.bt_iterative_natom);
+  double **B = nullptr, **G = nullptr;
+  SPARSE_B sparse_B;
+  if (!iterative) {
+    B = init_matrix(Nints, Ncarts);
+    G = init_matrix(Nints, Nints);
+  }
+  else if (Opt_params.print_lvl >= 2)
+    oprintf_out("\tUsing iterative (CGLS) solver with sparse B.\n");
 
   bool bt_iter_done = false;
   bool bt_converged = true;
@@ -284,14 +331,20 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
     // B dx = B * (Bt (B Bt)^-1) dq
     //   dx = Bt (B Bt)^-1 dq
     //   dx = Bt G^-1 dq, where G = B B^t.
-    compute_B(B,0,0);
-    opt_matrix_mult(B, 0, B, 1, G, 0, Nints, Ncarts, Nints, 0);
-
-    // u B^t (G_inv dq) = dx
-    G_inv = symm_matrix_inv(G, Nints, true);
-    opt_matrix_mult(G_inv, 0, &dq, 1, &tmp_v_Nints, 1, Nints, Nints, 1, 0);
-    opt_matrix_mult(B, 1, &tmp_v_Nints, 1, &dx, 1, Ncarts, Nints, 1, 0);
-    free_matrix(G_inv);
+    if (iterative) {
+      coords.sparse_B(geom, sparse_B);
+      back_transform_cgls(coords, sparse_B, Nints, Ncarts, dq, dx);
+    }
+    else {
+      compute_B(B,0,0);
+      opt_matrix_mult(B, 0, B, 1, G, 0, Nints, Ncarts, Nints, 0);
+
+      // u B^t (G_inv dq) = dx
+      G_inv = symm_matrix_inv(G, Nints, true);
+      opt_matrix_mult(G_inv, 0, &dq, 1, &tmp_v_Nints, 1, Nints, Nints, 1, 0);
+      opt_matrix_mult(B, 1, &tmp_v_Nints, 1, &dx, 1, Ncarts, Nints, 1, 0);
+      free_matrix(G_inv);
+    }
 
     for (i=0; i<Ncarts; ++i)
       new_geom[i] += dx[i];
@@ -378,12 +431,12 @@ bool FRAG::displace_util(double *dq, bool focus_on_constraints) {
   }
   else rval = true; // not converged and only for constraint fixing
 
-  free_matrix(G);
+  if (G != nullptr) free_matrix(G);
   free_array(new_geom);
   free_array(first_geom);
   free_array(dx);
   free_array(tmp_v_Nints);
-  free_matrix(B);
+  if (B != nullptr) free_matrix(B);
 
   free_array(q_target);
   free_array(q_orig);
@@ -160,6 +160,11 @@ class OPT_DATA {
       else return 0.0;
     }
 
+    // return predicted energy change for the current step
+    double g_DE_predicted(void) const {
+      return steps[steps.size()-1]->g_DE_predicted();
+    }
+
     // return pointers to arbitrary-step data (pass in index starting at 0 ...)
     double g_energy(int i) const {
       return steps[i]->g_energy();
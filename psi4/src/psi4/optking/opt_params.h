@@ -174,6 +174,11 @@ struct OPT_PARAMS {
 
   // maximum number of allowed iterations in backtransformation to cartesian coordinates
   double bt_max_iter;
+
+  // solve B dx = dq of the backtransformation with a generalized inverse of G = B B^t,
+  // or iteratively with sparse B (AUTO: iterative from bt_iterative_natom atoms on)
+  enum BT_SOLVER {AUTO, DIRECT, ITERATIVE} bt_solver;
+  int bt_iterative_natom;
   bool ensure_bt_convergence;
 
   double geom_maxiter;
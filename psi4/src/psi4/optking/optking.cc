@@ -42,6 +42,7 @@
 
 #if defined(OPTKING_PACKAGE_PSI)
   #include "psi4/libpsi4util/exception.h"
+  #include "psi4/libpsi4util/process.h"
 #endif
 
 // Define the return types for optking.
@@ -348,6 +349,11 @@ OptReturnType optking(void) {
 
   bool converged = p_Opt_data->conv_check(*mol1);
 
+#if defined(OPTKING_PACKAGE_PSI)
+  // let the driver compare the quadratic model against the next energy (FULL_HESS_ADAPTIVE)
+  psi::Process::environment.globals["OPTKING PREDICTED ENERGY CHANGE"] = p_Opt_data->g_DE_predicted();
+#endif
+
 #if defined(OPTKING_PACKAGE_QCHEM)
   rem_write((int) converged, REM_GEOM_OPT_CONVERGED); // tell QChem if converged (return value ignored for now)
   rem_write(p_Opt_data->g_iteration(), REM_GEOM_OPT_CYCLE); // tell QChem current iteration number
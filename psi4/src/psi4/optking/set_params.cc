@@ -121,6 +121,12 @@ void set_params(void)
 // step to cartesians.
     Opt_params.ensure_bt_convergence = options.get_bool("ENSURE_BT_CONVERGENCE");
 
+// Linear solver of the back-transformation {AUTO, DIRECT, ITERATIVE}
+    s = options.get_str("BT_SOLVER");
+    if (s == "DIRECT")         Opt_params.bt_solver = OPT_PARAMS::DIRECT;
+    else if (s == "ITERATIVE") Opt_params.bt_solver = OPT_PARAMS::ITERATIVE;
+    else                       Opt_params.bt_solver = OPT_PARAMS::AUTO;
+
 // do stupid, linear scaling of internal coordinates to step limit (not RS-RFO);
     Opt_params.simple_step_scaling = options.get_bool("SIMPLE_STEP_SCALING");
 
@@ -516,6 +522,8 @@ void set_params(void)
   // step to cartesians.
   Opt_params.ensure_bt_convergence = rem_read("REM_GEOM_OPT2_ENSURE_BT_CONVERGENCE");
 
+  Opt_params.bt_solver = OPT_PARAMS::AUTO;
+
 // follow root   (default 0)
   Opt_params.rfo_follow_root = rem_read(REM_GEOM_OPT2_RFO_FOLLOW_ROOT);
 
@@ -758,6 +766,8 @@ void set_params(void)
   Opt_params.bt_max_iter = 25;
   Opt_params.bt_dx_conv = 1.0e-6;
   Opt_params.bt_dx_conv_rms_change = 1.0e-12;
+  // Fragment size from which BT_SOLVER AUTO switches to the iterative solver
+  Opt_params.bt_iterative_natom = 100;
   //Opt_params.bt_dx_conv = 1.0e-10;
   //Opt_params.bt_dx_conv_rms_change = 1.0e-14;
 
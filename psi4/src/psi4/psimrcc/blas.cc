@@ -45,7 +45,10 @@ namespace psimrcc {
 extern MOInfo* moinfo;
 extern MemoryManager* memory_manager;
 
-CCBLAS::CCBLAS(Options& options) : options_(options), full_in_core(false), work_size(0), buffer_size(0) { init(); }
+CCBLAS::CCBLAS(Options& options)
+    : options_(options), full_in_core(false), work_size(0), buffer_size(0), current_operation(nullptr) {
+    init();
+}
 
 CCBLAS::~CCBLAS() { cleanup(); }
 
@@ -60,6 +63,7 @@ void CCBLAS::cleanup() {
     free_buffer();
     free_work();
     free_matrices();
+    CCMatrix::release_block_pool();
     free_indices();
 }
 
@@ -35,6 +35,7 @@
 */
 
 #include <deque>
+#include <list>
 #include <string>
 #include <vector>
 #include <map>
@@ -66,6 +67,7 @@ class CCBLAS {
     typedef std::vector<int> intvec;
     typedef std::vector<std::pair<int, int> > intpairvec;
     typedef std::deque<CCOperation> OpDeque;
+    typedef std::pair<CCMatrix*, int> MatrixBlock;
 
     CCBLAS(Options& options);
     ~CCBLAS();
@@ -137,6 +139,10 @@ class CCBLAS {
     MatCnt matrices_in_deque_target;
     MatCnt matrices_in_deque_source;
     SortMap sortmap;
+    // Resident blocks loaded through CCBLAS, most recently used first
+    std::list<MatrixBlock> resident_blocks;
+    std::map<MatrixBlock, std::list<MatrixBlock>::iterator> resident_position;
+    CCOperation* current_operation;
 
    private:
     IndexMap& get_IndexMap() { return (indices); }
@@ -159,12 +165,15 @@ class CCBLAS {
     void solve_ref(std::string& str);
     int parse(std::string& str);
     void process_operations();
+    void compute_parallel(int nthreads);
     void process_reduce_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     void process_expand_spaces(CCMatrix* out_Matrix, CCMatrix* in_Matrix);
     bool get_factor(const std::string& str, double& factor);
     // General routines
 
     void make_space(size_t memory_required);
+    void touch(CCMatrix* Matrix, int h);
+    bool is_in_current_operation(CCMatrix* Matrix);
     // Low level memory routines
     void init();
     void cleanup();
@@ -38,6 +38,10 @@
 #include "debugging.h"
 #include "matrix.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace psi {
 
 namespace psimrcc {
@@ -221,6 +225,7 @@ void CCBLAS::load(CCMatrix* Matrix) {
         Matrix->load();
         DEBUGGING(2, outfile->Printf("\n] <- done."););
     }
+    for (int h = 0; h < moinfo->get_nirreps(); ++h) touch(Matrix, h);
 }
 
 void CCBLAS::load_irrep(CCMatrix* Matrix, int h) {
@@ -236,15 +241,60 @@ void CCBLAS::load_irrep(CCMatrix* Matrix, int h) {
         Matrix->load_irrep(h);
         DEBUGGING(2, outfile->Printf("\n] <- done.");)
     }
+    touch(Matrix, h);
 }
 
+/**
+ * Mark a block as the most recently used one
+ */
+void CCBLAS::touch(CCMatrix* Matrix, int h) {
+#ifdef _OPENMP
+    // Threaded operations only run fully in core, the order is irrelevant there
+    if (omp_in_parallel()) return;
+#endif
+    if (Matrix->get_memorypi2(h) == 0 || Matrix->is_fock()) return;
+    MatrixBlock block = std::make_pair(Matrix, h);
+    std::map<MatrixBlock, std::list<MatrixBlock>::iterator>::iterator it = resident_position.find(block);
+    if (it != resident_position.end()) resident_blocks.erase(it->second);
+    resident_blocks.push_front(block);
+    resident_position[block] = resident_blocks.begin();
+}
+
+bool CCBLAS::is_in_current_operation(CCMatrix* Matrix) {
+    if (current_operation == nullptr) return (false);
+    return (Matrix == current_operation->get_A_Matrix() || Matrix == current_operation->get_B_Matrix() ||
+            Matrix == current_operation->get_C_Matrix());
+}
+
+/**
+ * Free enough memory to load memory_required bytes.  The block pool is
+ * emptied first, then the least recently used blocks are written to disk.
+ * Blocks are evicted only while an operation is computed, and never the
+ * ones it works on, since outside of compute() a caller may still hold
+ * pointers to any matrix.
+ */
 void CCBLAS::make_space(size_t memory_required) {
-    if (memory_required < memory_manager->get_FreeMemory())
-        return;
-    else {
-        outfile->Printf("\nCCBLAS::make_space() not implemented yet!!!");
-        // Attempt #1
+    if (memory_required < memory_manager->get_FreeMemory()) return;
+    CCMatrix::release_block_pool();
+    if (current_operation == nullptr) return;
+
+    std::list<MatrixBlock>::iterator it = resident_blocks.end();
+    while ((memory_required >= memory_manager->get_FreeMemory()) && (it != resident_blocks.begin())) {
+        std::list<MatrixBlock>::iterator victim = --it;
+        CCMatrix* Matrix = victim->first;
+        int h = victim->second;
+        if (is_in_current_operation(Matrix)) continue;
+        if (Matrix->is_block_allocated(h)) {
+            DEBUGGING(2, outfile->Printf("\nCCBLAS::make_space(): writing %s irrep %d to disk",
+                                         Matrix->get_label().c_str(), h);)
+            Matrix->dump_block_to_disk(h);
+            CCMatrix::release_block_pool();
+        }
+        resident_position.erase(*victim);
+        it = resident_blocks.erase(victim);
     }
+    if (memory_required >= memory_manager->get_FreeMemory())
+        outfile->Printf("\nCCBLAS::make_space(): could not free %lu bytes", memory_required);
 }
 
 }  // namespace psimrcc
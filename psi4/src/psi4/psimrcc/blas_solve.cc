@@ -26,11 +26,20 @@
  * @END LICENSE
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <exception>
+#include <map>
+#include <vector>
 #include "psi4/libmoinfo/libmoinfo.h"
 
 #include "blas.h"
 #include "debugging.h"
+#include "matrix.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 extern FILE* outfile;
 
@@ -193,11 +202,23 @@ void CCBLAS::compute() {
             matrices_in_deque_source[it->get_C_Matrix()]++;
         }
     }
+    // Run independent operations concurrently when everything is in core
+    int nthreads = std::min(options_.get_int("CC_NUM_THREADS"), static_cast<int>(work.size()));
+    bool parallel = (nthreads > 1) && (operations.size() > 1) && !debugging->is_level(2);
+    for (OpDeque::iterator it = operations.begin(); parallel && it != operations.end(); ++it)
+        if (!it->is_in_core()) parallel = false;
+    if (parallel) compute_parallel(nthreads);
+
     while (!operations.empty()) {
         // Read the element
         CCOperation& op = operations.front();
         // Compute the operation
-        op.compute();
+        if (!parallel) {
+            current_operation = &op;
+            op.compute();
+            current_operation = nullptr;
+        }
+        DEBUGGING(3, outfile->Printf("\n  %10.6f s  ", op.get_timing()); op.print_operation(););
 
         // Decrease the counters for the matrices to be processed
         if (op.get_A_Matrix() != nullptr) {
@@ -217,6 +238,69 @@ void CCBLAS::compute() {
     }
 }
 
+/**
+ * Compute all the operations in the deque with nthreads threads.
+ * Each operation writes A and reads B and C (and A itself when it
+ * accumulates), so it is placed one level after the last operation that
+ * wrote any of its matrices or read its target.  Operations within a level
+ * are independent, e.g. the same equation for different references.
+ * All matrices must be in core.
+ * @param nthreads
+ */
+void CCBLAS::compute_parallel(int nthreads) {
+    std::map<CCMatrix*, int> last_write;
+    std::map<CCMatrix*, int> last_read;
+    std::vector<std::vector<int> > levels;
+
+    int nops = static_cast<int>(operations.size());
+    for (int n = 0; n < nops; ++n) {
+        CCMatrix* Matrix[3] = {operations[n].get_A_Matrix(), operations[n].get_B_Matrix(),
+                               operations[n].get_C_Matrix()};
+        int level = 0;
+        for (int m = 0; m < 3; ++m) {
+            if (Matrix[m] == nullptr) continue;
+            std::map<CCMatrix*, int>::iterator it = last_write.find(Matrix[m]);
+            if (it != last_write.end()) level = std::max(level, it->second + 1);
+        }
+        std::map<CCMatrix*, int>::iterator it = last_read.find(Matrix[0]);
+        if (it != last_read.end()) level = std::max(level, it->second + 1);
+
+        if (level == static_cast<int>(levels.size())) levels.push_back(std::vector<int>());
+        levels[level].push_back(n);
+
+        last_write[Matrix[0]] = level;
+        for (int m = 1; m < 3; ++m) {
+            if (Matrix[m] == nullptr) continue;
+            it = last_read.find(Matrix[m]);
+            if (it == last_read.end() || it->second < level) last_read[Matrix[m]] = level;
+        }
+    }
+    DEBUGGING(3, outfile->Printf("\n  CCBLAS::compute(): %d operations in %d levels", nops,
+                                 static_cast<int>(levels.size())););
+
+    for (size_t l = 0; l < levels.size(); ++l) {
+        std::vector<int>& level_ops = levels[l];
+        int nlevel_ops = static_cast<int>(level_ops.size());
+        std::exception_ptr error = nullptr;
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads)
+        for (int i = 0; i < nlevel_ops; ++i) {
+            int thread = 0;
+#ifdef _OPENMP
+            thread = omp_get_thread_num();
+#endif
+            CCOperation& op = operations[level_ops[i]];
+            op.set_scratch(work[thread], buffer[thread]);
+            try {
+                op.compute();
+            } catch (...) {
+#pragma omp critical
+                error = std::current_exception();
+            }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+}
+
 /**
  * store a zero_two_diagonal operation without executing it
  * @param cstr
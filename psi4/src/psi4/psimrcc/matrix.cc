@@ -44,6 +44,7 @@ extern MOInfo* moinfo;
 extern MemoryManager* memory_manager;
 
 double CCMatrix::fraction_of_memory_for_buffer = 0.05;
+double CCMatrix::fraction_of_memory_for_pool = 0.05;
 
 CCMatrix::CCMatrix(std::string& str, CCIndex* left_index, CCIndex* right_index)
     : label(str),
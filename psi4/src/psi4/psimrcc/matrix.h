@@ -35,6 +35,8 @@
  ***************************************************************************/
 
 #include "psi4/libpsi4util/memory_manager.h"
+#include <map>
+#include <utility>
 #include <vector>
 #include <string>
 
@@ -161,6 +163,8 @@ class CCMatrix {
     void free_memory();
     void free_block(int h);
     int get_naccess() { return (naccess); }
+    static void release_block_pool();
+    static size_t get_block_pool_memory() { return (block_pool_memory); }
 
     // IO
     void load();
@@ -179,6 +183,7 @@ class CCMatrix {
     // Class private functions
     ///////////////////////////////////////////////////////////////////////////////
     std::string compute_index_label();
+    bool take_pooled_block(int h);
     ///////////////////////////////////////////////////////////////////////////////
     // Class data
     ///////////////////////////////////////////////////////////////////////////////
@@ -202,8 +207,14 @@ class CCMatrix {
     Size_tVec memorypi2;      // Memory required for storage in bytes
     BoolVec out_of_core;      // Is this irrep stored on disk?
     int naccess;              // How many times you have called get_matrix();
+    // Freed blocks keyed by shape, still registered with the MemoryManager
+    typedef std::map<std::pair<size_t, size_t>, std::vector<double**> > BlockPool;
+    static BlockPool block_pool;
+    static size_t block_pool_memory;
+
    public:
     static double fraction_of_memory_for_buffer;
+    static double fraction_of_memory_for_pool;
 };
 
 }  // namespace psimrcc
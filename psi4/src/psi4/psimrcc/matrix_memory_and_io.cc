@@ -57,6 +57,9 @@ namespace psimrcc {
 extern MOInfo *moinfo;
 extern MemoryManager *memory_manager;
 
+CCMatrix::BlockPool CCMatrix::block_pool;
+size_t CCMatrix::block_pool_memory = 0;
+
 /*********************************************************
   Memory Allocation Routines
 *********************************************************/
@@ -96,6 +99,8 @@ void CCMatrix::allocate_memory() {
 void CCMatrix::allocate_block(int h) {
     if (block_sizepi[h] > 0) {
         if (!is_block_allocated(h)) {
+            if (take_pooled_block(h)) return;
+            if (memorypi2[h] >= memory_manager->get_FreeMemory()) release_block_pool();
             if (memorypi2[h] < memory_manager->get_FreeMemory()) {
                 allocate2(double, matrix[h], left_pairpi[h], right_pairpi[h]);
                 DEBUGGING(2, outfile->Printf("\n  %s[%s] <- allocated", label.c_str(), moinfo->get_irr_labs(h).c_str());
@@ -124,10 +129,25 @@ void CCMatrix::free_memory() {
     for (int h = 0; h < nirreps; h++) free_block(h);
 }
 
+/**
+ * Free an irrep block.  Up to fraction_of_memory_for_pool of the memory, the
+ * storage is parked in the block pool so that the next block of the same
+ * shape can reuse it; it is returned to the MemoryManager by
+ * release_block_pool().
+ * @param h irrep to free
+ */
 void CCMatrix::free_block(int h) {
     if (block_sizepi[h] > 0) {
         if (is_block_allocated(h)) {
-            release2(matrix[h]);
+            size_t max_pool_memory = static_cast<size_t>(
+                fraction_of_memory_for_pool * static_cast<double>(memory_manager->get_MaximumAllowedMemory()));
+            if (block_pool_memory + memorypi2[h] <= max_pool_memory) {
+                block_pool[std::make_pair(left_pairpi[h], right_pairpi[h])].push_back(matrix[h]);
+                block_pool_memory += memorypi2[h];
+                matrix[h] = nullptr;
+            } else {
+                release2(matrix[h]);
+            }
             DEBUGGING(2, outfile->Printf("\n  %s[%s] <- deallocated", label.c_str(), moinfo->get_irr_labs(h).c_str());
 
             )
@@ -135,6 +155,36 @@ void CCMatrix::free_block(int h) {
     }
 }
 
+/**
+ * Reuse a pooled block with the shape of irrep h, if there is one
+ * @param h irrep to allocate
+ * @return true if a block was taken from the pool
+ */
+bool CCMatrix::take_pooled_block(int h) {
+    BlockPool::iterator it = block_pool.find(std::make_pair(left_pairpi[h], right_pairpi[h]));
+    if (it == block_pool.end() || it->second.empty()) return (false);
+    matrix[h] = it->second.back();
+    it->second.pop_back();
+    block_pool_memory -= memorypi2[h];
+    std::fill(matrix[h][0], matrix[h][0] + block_sizepi[h], 0.0);
+    DEBUGGING(2, outfile->Printf("\n  %s[%s] <- allocated (pool)", label.c_str(), moinfo->get_irr_labs(h).c_str());)
+    return (true);
+}
+
+/**
+ * Return all the pooled blocks to the MemoryManager
+ */
+void CCMatrix::release_block_pool() {
+    for (BlockPool::iterator it = block_pool.begin(); it != block_pool.end(); ++it) {
+        for (size_t n = 0; n < it->second.size(); ++n) {
+            double** block = it->second[n];
+            release2(block);
+        }
+    }
+    block_pool.clear();
+    block_pool_memory = 0;
+}
+
 /*********************************************************
   I/O Routines
 *********************************************************/
@@ -32,6 +32,9 @@
  *  @brief Computes the (T) correction
  */
 
+#include "psi4/libmints/molecule.h"
+#include "psi4/libmints/wavefunction.h"
+#include "psi4/libmints/writer_file_prefix.h"
 #include "psi4/libmoinfo/libmoinfo.h"
 #include "psi4/libpsi4util/libpsi4util.h"
 #include "psi4/liboptions/liboptions.h"
@@ -64,7 +67,14 @@ void CCMRCC::compute_perturbative_triples() {
     h_eff.set_left_eigenvector(left_eigenvector, moinfo->get_nrefs());
     h_eff.set_zeroth_order_eigenvector(zeroth_order_eigenvector, moinfo->get_nrefs());
 
-    MRCCSD_T mrccsd_t(options_, &h_eff);
+    std::string checkpoint_file;
+    if (options_.get_bool("TRIPLES_CHECKPOINT")) {
+        checkpoint_file = options_.get_str("TRIPLES_CHECKPOINT_FILE");
+        if (checkpoint_file.empty())
+            checkpoint_file = get_writer_file_prefix(ref_wfn_->molecule()->name()) + ".mrccsd_t.snap";
+    }
+
+    MRCCSD_T mrccsd_t(options_, &h_eff, checkpoint_file);
 
     if (options_.get_bool("DIAGONALIZE_HEFF")) {
         outfile->Printf("\n\n  Diagonalizing Heff");
@@ -33,7 +33,8 @@
 namespace psi {
 namespace psimrcc {
 
-MRCCSD_T::MRCCSD_T(Options& options, Hamiltonian* h_eff_) : options_(options), h_eff(h_eff_) {
+MRCCSD_T::MRCCSD_T(Options& options, Hamiltonian* h_eff_, const std::string& checkpoint_file_)
+    : options_(options), checkpoint_file(checkpoint_file_), h_eff(h_eff_) {
     startup();
     check_intruders();
     if (triples_algorithm == SpinAdaptedTriples)
@@ -29,6 +29,9 @@
 #ifndef _psi_src_bin_psimrcc_mrccsd_t_h_
 #define _psi_src_bin_psimrcc_mrccsd_t_h_
 
+#include <functional>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace psi {
@@ -42,9 +45,23 @@ class Hamiltonian;
 class MRCCSD_T {
     enum TriplesAlgorithm { UnrestrictedTriples, RestrictedTriples, SpinAdaptedTriples };
 
+    /// Work space and partial sums of one thread in the restricted triples loops
+    struct TriplesThread {
+        BlockMatrix*** Z;
+        BlockMatrix*** W;
+        BlockMatrix*** T;
+        std::vector<double> e4T;
+        std::vector<double> e4ST;
+        std::vector<double> e4DT;
+        std::vector<double> E4T;
+        std::vector<double> E4ST;
+        std::vector<double> E4DT;
+        std::vector<std::vector<double> > d_h_eff;
+    };
+
    public:
     // Constructor and destructor
-    MRCCSD_T(Options& options, Hamiltonian* h_eff_);
+    MRCCSD_T(Options& options, Hamiltonian* h_eff_, const std::string& checkpoint_file_);
     ~MRCCSD_T();
 
    private:
@@ -62,6 +79,16 @@ class MRCCSD_T {
     void compute_oOO_triples_restricted();
     void compute_OOO_triples_restricted();
 
+    void startup_threads();
+    void cleanup_threads();
+    void compute_triples_tasks(const std::string& block, const std::vector<size_t>& ijk_tasks,
+                               std::vector<double>& E4T_block, std::vector<double>& E4ST_block,
+                               std::vector<double>& E4DT_block,
+                               const std::function<void(size_t, TriplesThread&)>& compute_ijk);
+    std::vector<std::vector<double>*> checkpoint_energies();
+    void read_triples_checkpoint();
+    void write_triples_checkpoint();
+
     void compute_spin_adapted();
     void compute_ooo_triples_spin_adapted();
     void compute_ooO_triples_spin_adapted();
@@ -92,10 +119,14 @@ class MRCCSD_T {
     double compute_AB_oOO_contribution_to_Heff(int u_abs, int V_abs, int x_abs, int Y_abs, int i_abs, int j_abs,
                                                int k_abs, int mu, BlockMatrix* T3);
 
-    void compute_ooo_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3);
-    void compute_ooO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3);
-    void compute_oOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3);
-    void compute_OOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3);
+    void compute_ooo_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                     std::vector<std::vector<double> >& d_h_eff_thread);
+    void compute_ooO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                     std::vector<std::vector<double> >& d_h_eff_thread);
+    void compute_oOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                     std::vector<std::vector<double> >& d_h_eff_thread);
+    void compute_OOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                     std::vector<std::vector<double> >& d_h_eff_thread);
 
     double compute_A_ooo_contribution_to_Heff_restricted(int u_abs, int x_abs, int i_abs, int j_abs, int k_abs, int mu,
                                                          BlockMatrix* T3);
@@ -133,6 +164,14 @@ class MRCCSD_T {
 
     TriplesAlgorithm triples_algorithm;
 
+    int nthreads;
+    std::vector<TriplesThread> threads;
+
+    /// Where the restricted loops save their progress ("" for nowhere)
+    std::string checkpoint_file;
+    /// ijk triples completed so far in each spin case ("aaa", "aab", "abb", "bbb")
+    std::map<std::string, size_t> triples_done;
+
     Hamiltonian* h_eff;
 
     std::vector<std::vector<bool> > is_aocc;
@@ -34,7 +34,8 @@ namespace psi {
 namespace psimrcc {
 extern MOInfo* moinfo;
 
-void MRCCSD_T::compute_ooo_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3) {
+void MRCCSD_T::compute_ooo_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                           std::vector<std::vector<double> >& d_h_eff_thread) {
     // Find the off_diagonal elements for reference mu
     // Loop over reference nu (in a safe way)
     for (int nu = 0; nu < nrefs; nu++) {
@@ -45,15 +46,17 @@ void MRCCSD_T::compute_ooo_contribution_to_Heff_restricted(int i, int j, int k,
 
             // Set (alpha)->(alpha) single excitations
             if ((alpha_internal_excitation.size() == 1) && (beta_internal_excitation.size() == 0)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_A_ooo_contribution_to_Heff_restricted(
-                                                                  alpha_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_A_ooo_contribution_to_Heff_restricted(alpha_internal_excitation[0].first,
                                                                   alpha_internal_excitation[0].second, i, j, k, mu, T3);
             }
         }
     }
 }
 
-void MRCCSD_T::compute_ooO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3) {
+void MRCCSD_T::compute_ooO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                           std::vector<std::vector<double> >& d_h_eff_thread) {
     // Find the off_diagonal elements for reference mu
     // Loop over reference nu (in a safe way)
     for (int nu = 0; nu < nrefs; nu++) {
@@ -64,29 +67,33 @@ void MRCCSD_T::compute_ooO_contribution_to_Heff_restricted(int i, int j, int k,
 
             // Set (alpha)->(alpha) single excitations
             if ((alpha_internal_excitation.size() == 1) && (beta_internal_excitation.size() == 0)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_A_ooO_contribution_to_Heff_restricted(
-                                                                  alpha_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_A_ooO_contribution_to_Heff_restricted(alpha_internal_excitation[0].first,
                                                                   alpha_internal_excitation[0].second, i, j, k, mu, T3);
             }
             // Set (beta)->(beta) single excitations
             if ((alpha_internal_excitation.size() == 0) && (beta_internal_excitation.size() == 1)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_B_ooO_contribution_to_Heff_restricted(
-                                                                  beta_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_B_ooO_contribution_to_Heff_restricted(beta_internal_excitation[0].first,
                                                                   beta_internal_excitation[0].second, i, j, k, mu, T3);
             }
             // Set (alpha,beta)->(alpha,beta) double excitations
             if ((alpha_internal_excitation.size() == 1) && (beta_internal_excitation.size() == 1)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_AB_ooO_contribution_to_Heff_restricted(
-                                                                  alpha_internal_excitation[0].first,
-                                                                  beta_internal_excitation[0].first,
-                                                                  alpha_internal_excitation[0].second,
-                                                                  beta_internal_excitation[0].second, i, j, k, mu, T3);
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_AB_ooO_contribution_to_Heff_restricted(alpha_internal_excitation[0].first,
+                                                                   beta_internal_excitation[0].first,
+                                                                   alpha_internal_excitation[0].second,
+                                                                   beta_internal_excitation[0].second, i, j, k, mu, T3);
             }
         }
     }
 }
 
-void MRCCSD_T::compute_oOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3) {
+void MRCCSD_T::compute_oOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                           std::vector<std::vector<double> >& d_h_eff_thread) {
     // Find the off_diagonal elements for reference mu
     // Loop over reference nu (in a safe way)
     for (int nu = 0; nu < nrefs; nu++) {
@@ -97,29 +104,33 @@ void MRCCSD_T::compute_oOO_contribution_to_Heff_restricted(int i, int j, int k,
 
             // Set (alpha)->(alpha) single excitations
             if ((alpha_internal_excitation.size() == 1) && (beta_internal_excitation.size() == 0)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_A_oOO_contribution_to_Heff_restricted(
-                                                                  alpha_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_A_oOO_contribution_to_Heff_restricted(alpha_internal_excitation[0].first,
                                                                   alpha_internal_excitation[0].second, i, j, k, mu, T3);
             }
             // Set (beta)->(beta) single excitations
             if ((alpha_internal_excitation.size() == 0) && (beta_internal_excitation.size() == 1)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_B_oOO_contribution_to_Heff_restricted(
-                                                                  beta_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_B_oOO_contribution_to_Heff_restricted(beta_internal_excitation[0].first,
                                                                   beta_internal_excitation[0].second, i, j, k, mu, T3);
             }
             // Set (alpha,beta)->(alpha,beta) double excitations
             if ((alpha_internal_excitation.size() == 1) && (beta_internal_excitation.size() == 1)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_AB_oOO_contribution_to_Heff_restricted(
-                                                                  alpha_internal_excitation[0].first,
-                                                                  beta_internal_excitation[0].first,
-                                                                  alpha_internal_excitation[0].second,
-                                                                  beta_internal_excitation[0].second, i, j, k, mu, T3);
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_AB_oOO_contribution_to_Heff_restricted(alpha_internal_excitation[0].first,
+                                                                   beta_internal_excitation[0].first,
+                                                                   alpha_internal_excitation[0].second,
+                                                                   beta_internal_excitation[0].second, i, j, k, mu, T3);
             }
         }
     }
 }
 
-void MRCCSD_T::compute_OOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3) {
+void MRCCSD_T::compute_OOO_contribution_to_Heff_restricted(int i, int j, int k, int mu, BlockMatrix* T3,
+                                                           std::vector<std::vector<double> >& d_h_eff_thread) {
     // Find the off_diagonal elements for reference mu
     // Loop over reference nu (in a safe way)
     for (int nu = 0; nu < nrefs; nu++) {
@@ -130,8 +141,9 @@ void MRCCSD_T::compute_OOO_contribution_to_Heff_restricted(int i, int j, int k,
 
             // Set (beta)->(beta) single excitations
             if ((alpha_internal_excitation.size() == 0) && (beta_internal_excitation.size() == 1)) {
-                d_h_eff[nu][mu] += sign_internal_excitation * compute_B_OOO_contribution_to_Heff_restricted(
-                                                                  beta_internal_excitation[0].first,
+                d_h_eff_thread[nu][mu] +=
+                    sign_internal_excitation *
+                    compute_B_OOO_contribution_to_Heff_restricted(beta_internal_excitation[0].first,
                                                                   beta_internal_excitation[0].second, i, j, k, mu, T3);
             }
         }
@@ -389,6 +389,8 @@ void MRCCSD_T::startup() {
     E4_ooO.assign(nrefs, 0.0);
     E4_oOO.assign(nrefs, 0.0);
     E4_OOO.assign(nrefs, 0.0);
+
+    if (triples_algorithm == RestrictedTriples) startup_threads();
 }
 
 void MRCCSD_T::check_intruders() {
@@ -621,6 +623,8 @@ void MRCCSD_T::build_W_intermediates() {
 }
 
 void MRCCSD_T::cleanup() {
+    if (triples_algorithm == RestrictedTriples) cleanup_threads();
+
     delete T2_ij_a_b;
     delete T2_iJ_a_B;
     delete T2_iJ_B_a;
@@ -0,0 +1,278 @@
+/*
+ * @BEGIN LICENSE
+ *
+ * Psi4: an open-source quantum chemistry software package
+ *
+ * Copyright (c) 2007-2018 The Psi4 Developers.
+ *
+ * The copyrights for code used from other parties are included in
+ * the corresponding files.
+ *
+ * This file is part of Psi4.
+ *
+ * Psi4 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * Psi4 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License along
+ * with Psi4; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * @END LICENSE
+ */
+
+/**
+ *  @file mrccsd_t_tasks.cc
+ *  @ingroup (PSIMRCC)
+ *  @brief Threaded and checkpointed loops over the ijk triples of the restricted (T) algorithm
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "psi4/libmoinfo/libmoinfo.h"
+#include "psi4/libpsi4util/PsiOutStream.h"
+#include "psi4/libpsi4util/exception.h"
+#include "psi4/libpsi4util/memory_manager.h"
+#include "psi4/libpsi4util/process.h"
+#include "psi4/libqt/blas_backend.h"
+
+#include "heff.h"
+#include "index.h"
+#include "mrccsd_t.h"
+#include "special_matrices.h"
+
+namespace psi {
+namespace psimrcc {
+extern MOInfo* moinfo;
+extern MemoryManager* memory_manager;
+
+namespace {
+
+const char* const spin_cases[] = {"aaa", "aab", "abb", "bbb"};
+const char checkpoint_magic[8] = {'M', 'R', 'C', 'C', 'S', 'D', 'T', '1'};
+
+/// Identifies the computation a checkpoint belongs to; it is only read back if every field matches
+struct CheckpointHeader {
+    char magic[8];
+    int nirreps;
+    int nrefs;
+    int nocc;
+    int nvir;
+    double energy;  // The Mk-MRCCSD energy, to tell geometries and states apart
+};
+
+}  // namespace
+
+void MRCCSD_T::startup_threads() {
+    // Each thread past the first needs its own Z, W, and T; take only as many as fit in memory
+    size_t thread_memory = 0;
+    for (int h = 0; h < nirreps; ++h) {
+        for (int h_row = 0; h_row < nirreps; ++h_row) {
+            thread_memory += v->get_tuplespi(h_row) * vv->get_tuplespi(h_row ^ h);
+        }
+    }
+    thread_memory *= 3 * nrefs * sizeof(double);
+    size_t max_threads = 1 + memory_manager->get_FreeMemory() / std::max<size_t>(thread_memory, 1);
+    nthreads = std::max(1, Process::environment.get_n_threads());
+    if (static_cast<size_t>(nthreads) > max_threads) {
+        outfile->Printf("\n  Running the triples on %d threads, as many as the memory allows.", (int)max_threads);
+        nthreads = static_cast<int>(max_threads);
+    }
+
+    threads.resize(nthreads);
+    for (int t = 0; t < nthreads; ++t) {
+        TriplesThread& thread = threads[t];
+        if (t == 0) {
+            thread.Z = Z;
+            thread.W = W;
+            thread.T = T;
+        } else {
+            allocate2(BlockMatrix**, thread.Z, nrefs, nirreps);
+            allocate2(BlockMatrix**, thread.W, nrefs, nirreps);
+            allocate2(BlockMatrix**, thread.T, nrefs, nirreps);
+            for (int mu = 0; mu < nrefs; ++mu) {
+                for (int h = 0; h < nirreps; ++h) {
+                    thread.Z[mu][h] = new BlockMatrix(nirreps, v->get_tuplespi(), vv->get_tuplespi(), h);
+                    thread.W[mu][h] = new BlockMatrix(nirreps, v->get_tuplespi(), vv->get_tuplespi(), h);
+                    thread.T[mu][h] = new BlockMatrix(nirreps, v->get_tuplespi(), vv->get_tuplespi(), h);
+                }
+            }
+        }
+        thread.e4T.assign(nrefs, 0.0);
+        thread.e4ST.assign(nrefs, 0.0);
+        thread.e4DT.assign(nrefs, 0.0);
+        thread.E4T.assign(nrefs, 0.0);
+        thread.E4ST.assign(nrefs, 0.0);
+        thread.E4DT.assign(nrefs, 0.0);
+        thread.d_h_eff.assign(nrefs, std::vector<double>(nrefs, 0.0));
+    }
+
+    for (const char* spin_case : spin_cases) triples_done[spin_case] = 0;
+    if (!checkpoint_file.empty()) read_triples_checkpoint();
+}
+
+void MRCCSD_T::cleanup_threads() {
+    for (int t = 1; t < nthreads; ++t) {
+        TriplesThread& thread = threads[t];
+        for (int mu = 0; mu < nrefs; ++mu) {
+            for (int h = 0; h < nirreps; ++h) {
+                delete thread.Z[mu][h];
+                delete thread.W[mu][h];
+                delete thread.T[mu][h];
+            }
+        }
+        release2(thread.Z);
+        release2(thread.W);
+        release2(thread.T);
+    }
+    threads.clear();
+}
+
+/*!
+ * Runs compute_ijk on every triple of ijk_tasks, each thread with its own work space, and adds the
+ * energies and Heff contributions the threads accumulate to E4*_block and d_h_eff.  With a
+ * checkpoint file the triples are run in batches, after each of which the sums are saved, and the
+ * triples a previous run completed are skipped.
+ */
+void MRCCSD_T::compute_triples_tasks(const std::string& block, const std::vector<size_t>& ijk_tasks,
+                                     std::vector<double>& E4T_block, std::vector<double>& E4ST_block,
+                                     std::vector<double>& E4DT_block,
+                                     const std::function<void(size_t, TriplesThread&)>& compute_ijk) {
+    size_t ntasks = ijk_tasks.size();
+    size_t& ndone = triples_done[block];
+    if (ndone > ntasks)
+        throw PSIEXCEPTION("MRCCSD_T: the checkpoint holds more " + block + " triples than there are.");
+    if (ndone > 0)
+        outfile->Printf("\n  Restarting the %s triples from the checkpoint: %zu of %zu done.", block.c_str(), ndone,
+                        ntasks);
+
+    size_t batch_size = checkpoint_file.empty() ? ntasks : 16 * static_cast<size_t>(nthreads);
+    while (ndone < ntasks) {
+        long int first = ndone;
+        long int last = std::min(ntasks, ndone + batch_size);
+
+        for (TriplesThread& thread : threads) {
+            std::fill(thread.E4T.begin(), thread.E4T.end(), 0.0);
+            std::fill(thread.E4ST.begin(), thread.E4ST.end(), 0.0);
+            std::fill(thread.E4DT.begin(), thread.E4DT.end(), 0.0);
+            for (std::vector<double>& row : thread.d_h_eff) std::fill(row.begin(), row.end(), 0.0);
+        }
+
+#pragma omp parallel num_threads(nthreads)
+        {
+            int t = 0;
+#ifdef _OPENMP
+            t = omp_get_thread_num();
+#endif
+            // One BLAS thread each when the triples are spread over threads
+            psi::blas::ThreadScope blas_threads(nthreads > 1 ? 1 : 0, "Mk-MRCCSD(T)");
+#pragma omp for schedule(dynamic, 1)
+            for (long int n = first; n < last; ++n) {
+                compute_ijk(ijk_tasks[n], threads[t]);
+            }
+        }
+
+        // Reduce in thread order
+        for (const TriplesThread& thread : threads) {
+            for (int mu = 0; mu < nrefs; ++mu) {
+                E4T_block[mu] += thread.E4T[mu];
+                E4ST_block[mu] += thread.E4ST[mu];
+                E4DT_block[mu] += thread.E4DT[mu];
+                for (int nu = 0; nu < nrefs; ++nu) {
+                    d_h_eff[mu][nu] += thread.d_h_eff[mu][nu];
+                }
+            }
+        }
+
+        ndone = last;
+        if (!checkpoint_file.empty()) write_triples_checkpoint();
+    }
+}
+
+/// The accumulated energies saved in a checkpoint, in file order
+std::vector<std::vector<double>*> MRCCSD_T::checkpoint_energies() {
+    return {&E4T_ooo, &E4T_ooO, &E4T_oOO, &E4T_OOO, &E4ST_ooo, &E4ST_ooO,
+            &E4ST_oOO, &E4ST_OOO, &E4DT_ooo, &E4DT_ooO, &E4DT_oOO, &E4DT_OOO};
+}
+
+/*!
+ * A checkpoint is the header, the number of completed triples of each spin case, the accumulated
+ * energies, and d_h_eff.  It is written under a temporary name and renamed into place, so a job
+ * killed while writing it leaves the previous one intact.
+ */
+void MRCCSD_T::write_triples_checkpoint() {
+    CheckpointHeader header;
+    std::memset(&header, 0, sizeof(CheckpointHeader));
+    std::memcpy(header.magic, checkpoint_magic, sizeof(header.magic));
+    header.nirreps = nirreps;
+    header.nrefs = nrefs;
+    header.nocc = o->get_ntuples();
+    header.nvir = v->get_ntuples();
+    header.energy = h_eff->get_eigenvalue();
+
+    std::string tmp = checkpoint_file + ".tmp";
+    std::FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (fp == nullptr) throw PSIEXCEPTION("MRCCSD_T: unable to open the triples checkpoint " + tmp);
+    bool written = std::fwrite(&header, sizeof(CheckpointHeader), 1, fp) == 1;
+    for (const char* spin_case : spin_cases) {
+        size_t ndone = triples_done[spin_case];
+        written = written && std::fwrite(&ndone, sizeof(size_t), 1, fp) == 1;
+    }
+    for (std::vector<double>* energy : checkpoint_energies()) {
+        written = written && std::fwrite(energy->data(), sizeof(double), nrefs, fp) == static_cast<size_t>(nrefs);
+    }
+    for (const std::vector<double>& row : d_h_eff) {
+        written = written && std::fwrite(row.data(), sizeof(double), nrefs, fp) == static_cast<size_t>(nrefs);
+    }
+    if (std::fclose(fp) || !written) throw PSIEXCEPTION("MRCCSD_T: unable to write the triples checkpoint " + tmp);
+
+    if (std::rename(tmp.c_str(), checkpoint_file.c_str()))
+        throw PSIEXCEPTION("MRCCSD_T: unable to move the triples checkpoint into place at " + checkpoint_file);
+}
+
+void MRCCSD_T::read_triples_checkpoint() {
+    std::FILE* fp = std::fopen(checkpoint_file.c_str(), "rb");
+    if (fp == nullptr) return;
+
+    CheckpointHeader header;
+    bool same = std::fread(&header, sizeof(CheckpointHeader), 1, fp) == 1 &&
+                std::memcmp(header.magic, checkpoint_magic, sizeof(header.magic)) == 0 &&
+                header.nirreps == nirreps && header.nrefs == nrefs && header.nocc == o->get_ntuples() &&
+                header.nvir == v->get_ntuples() && std::fabs(header.energy - h_eff->get_eigenvalue()) < 1.0e-10;
+    if (!same) {
+        outfile->Printf("\n  The triples checkpoint %s belongs to a different computation; ignoring it.",
+                        checkpoint_file.c_str());
+        std::fclose(fp);
+        return;
+    }
+
+    bool read = true;
+    for (const char* spin_case : spin_cases) {
+        read = read && std::fread(&triples_done[spin_case], sizeof(size_t), 1, fp) == 1;
+    }
+    for (std::vector<double>* energy : checkpoint_energies()) {
+        read = read && std::fread(energy->data(), sizeof(double), nrefs, fp) == static_cast<size_t>(nrefs);
+    }
+    for (std::vector<double>& row : d_h_eff) {
+        read = read && std::fread(row.data(), sizeof(double), nrefs, fp) == static_cast<size_t>(nrefs);
+    }
+    std::fclose(fp);
+    if (!read) throw PSIEXCEPTION("MRCCSD_T: the triples checkpoint " + checkpoint_file + " is truncated.");
+
+    outfile->Printf("\n  Read the triples completed so far from the checkpoint %s.", checkpoint_file.c_str());
+}
+
+}  // namespace psimrcc
+}  // namespace psi
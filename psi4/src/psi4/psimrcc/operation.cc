@@ -37,8 +37,6 @@ namespace psi {
 
 namespace psimrcc {
 
-double* CCOperation::local_work = nullptr;
-double* CCOperation::out_of_core_buffer = nullptr;
 double CCOperation::zero_timing = 0.0;
 double CCOperation::numerical_timing = 0.0;
 double CCOperation::contract_timing = 0.0;
@@ -64,10 +62,29 @@ CCOperation::CCOperation(double in_factor, std::string in_assignment, std::strin
       C_Matrix(in_C_Matrix) {
     local_work = work;
     out_of_core_buffer = buffer;
+    timing = 0.0;
 }
 
 CCOperation::~CCOperation() {}
 
+/**
+ * Point this operation to a different work/buffer pair (one per thread)
+ */
+void CCOperation::set_scratch(double* work, double* buffer) {
+    local_work = work;
+    out_of_core_buffer = buffer;
+}
+
+/**
+ * Are all the matrices touched by this operation fully in core?
+ */
+bool CCOperation::is_in_core() {
+    if (A_Matrix != nullptr && !A_Matrix->is_allocated()) return (false);
+    if (B_Matrix != nullptr && !B_Matrix->is_allocated()) return (false);
+    if (C_Matrix != nullptr && !C_Matrix->is_allocated()) return (false);
+    return (true);
+}
+
 void CCOperation::print() {
     if (reindexing.size()) outfile->Printf("\n\tReindexing = %s", reindexing.c_str());
     outfile->Printf("\n\tNumericalFactor = %lf", factor);
@@ -51,6 +51,9 @@ class CCOperation {
     CCMatrix* get_A_Matrix() { return (A_Matrix); }
     CCMatrix* get_B_Matrix() { return (B_Matrix); }
     CCMatrix* get_C_Matrix() { return (C_Matrix); }
+    double get_timing() { return (timing); }
+    void set_scratch(double* work, double* buffer);
+    bool is_in_core();
     void print();
     void print_operation();
     void compute();
@@ -62,8 +65,9 @@ class CCOperation {
     std::string assignment;  // = += >= +>=
     std::string reindexing;  // ## #pq# #pqrs#
     std::string operation;   // . @ / * X plus
-    static double* out_of_core_buffer;
-    static double* local_work;
+    double* out_of_core_buffer;
+    double* local_work;
+    double timing;  // wall time of the last compute()
     CCMatrix* A_Matrix;
     CCMatrix* B_Matrix;
     CCMatrix* C_Matrix;
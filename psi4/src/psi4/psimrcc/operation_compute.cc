@@ -56,51 +56,61 @@ void CCOperation::compute() {
     // Here we distinguis between all the possible cases
     DEBUGGING(2, outfile->Printf("\nPerforming "); print_operation(););
 
+    Timer op_timer;
     Timer numerical_timer;
     // (1) Assignment of a number
     //     Expression of the type A = - 1/2
     if (operation == "add_factor") add_numerical_factor();
+    #pragma omp atomic
     numerical_timing += numerical_timer.get();
 
     Timer dot_timer;
     // (2) Dot Product
     //     operation = .
     if (operation == ".") dot_product();
+    #pragma omp atomic
     dot_timing += dot_timer.get();
 
     Timer contract_timer;
     // (2) Contraction
     //     operation = i@j
     if (operation.substr(1, 1) == "@") contract();
+    #pragma omp atomic
     contract_timing += contract_timer.get();
 
     Timer plus_timer;
     // (4) Add a matrix
     //     operation = plus
     if (operation == "plus") element_by_element_addition();
+    #pragma omp atomic
     plus_timing += plus_timer.get();
 
     Timer tensor_timer;
     // (5) Tensor Product of two matrices
     //     operation = X
     if (operation == "X") tensor_product();
+    #pragma omp atomic
     tensor_timing += tensor_timer.get();
 
     Timer product_timer;
     // (6) Element by element product
     //     operation = *
     if (operation == "*") element_by_element_product();
+    #pragma omp atomic
     product_timing += product_timer.get();
 
     Timer division_timer;
     // (7) Element by element division
     //     operation = /
     if (operation == "/") element_by_element_division();
+    #pragma omp atomic
     division_timing += division_timer.get();
 
     // (8) Zero two diagonal
     //     operation = "zero_two_diagonal"
     if (operation == "zero_two_diagonal") zero_two_diagonal();
+
+    timing = op_timer.get();
 }
 
 /**
@@ -215,6 +225,7 @@ void CCOperation::zero_target() {
 void CCOperation::zero_target_block(int h) {
     Timer zero_timer;
     A_Matrix->zero_matrix_block(h);
+    #pragma omp atomic
     zero_timing += zero_timer.get();
 }
 
@@ -83,6 +83,7 @@ void CCOperation::setup_contractions() {
         if (T_matrix_offset > 0) zero_arr(&(local_work[0]), T_matrix_offset);
     }
 
+    #pragma omp atomic
     PartA_timing += PartA.get();
     Timer PartB;
 
@@ -218,6 +219,7 @@ void CCOperation::setup_contractions() {
         }
     }  // end of for loop over irreps
 
+    #pragma omp atomic
     PartB_timing += PartB.get();
     Timer PartC;
     if (need_sort) {
@@ -227,6 +229,7 @@ void CCOperation::setup_contractions() {
             delete[] T_matrix[h];
         delete[] T_matrix;
     }
+    #pragma omp atomic
     PartC_timing += PartC.get();
 }
 
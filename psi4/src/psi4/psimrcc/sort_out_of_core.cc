@@ -268,6 +268,7 @@ void CCSort::dump_integrals_to_disk(MatrixBlks& to_be_processed) {
         CCMatrix* Matrix = block_it->first;
         Matrix->dump_block_to_disk(block_it->second);
     }
+    CCMatrix::release_block_pool();
 }
 
 }  // namespace psimrcc
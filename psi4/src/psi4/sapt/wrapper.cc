@@ -82,12 +82,21 @@ PsiReturnType sapt(SharedWavefunction Dimer, SharedWavefunction MonomerA, Shared
     } else if (options.get_str("SAPT_LEVEL") == "SAPT2") {
         SAPT2 sapt(Dimer, MonomerA, MonomerB, options, psio);
         sapt.compute_energy();
+        for (const auto& kv : sapt.variables()) {
+            Dimer->set_variable(kv.first, kv.second);
+        }
     } else if (options.get_str("SAPT_LEVEL") == "SAPT2+") {
         SAPT2p sapt(Dimer, MonomerA, MonomerB, options, psio);
         sapt.compute_energy();
+        for (const auto& kv : sapt.variables()) {
+            Dimer->set_variable(kv.first, kv.second);
+        }
     } else if (options.get_str("SAPT_LEVEL") == "SAPT2+3") {
         SAPT2p3 sapt(Dimer, MonomerA, MonomerB, options, psio);
         sapt.compute_energy();
+        for (const auto& kv : sapt.variables()) {
+            Dimer->set_variable(kv.first, kv.second);
+        }
     } else {
         throw PSIEXCEPTION("Unrecognized SAPT type");
     }
@@ -42,6 +42,9 @@
 #include "psi4/liboptions/liboptions.h"
 #include "psi4/libpsi4util/process.h"
 
+#include <algorithm>
+#include <cmath>
+
 #ifdef _OPENMP
 #include <omp.h>
 #include "psi4/libpsi4util/process.h"
@@ -97,6 +100,12 @@ std::shared_ptr<JKGrad> JKGrad::build_JKGrad(int deriv, std::shared_ptr<BasisSet
         // TODO: rename every DF case
         if (options["DF_INTS_NUM_THREADS"].has_changed())
             jk->set_ints_num_threads(options.get_int("DF_INTS_NUM_THREADS"));
+        if (options["DENSITY_SCREENING"].has_changed())
+            jk->set_density_screening(options.get_bool("DENSITY_SCREENING"));
+        // The gradient sieve defaults to no cutoff, density screening falls back on INTS_TOLERANCE
+        jk->set_density_cutoff(options.get_double("DENSITY_SCREENING_TOLERANCE") > 0.0
+                                   ? options.get_double("DENSITY_SCREENING_TOLERANCE")
+                                   : options.get_double("INTS_TOLERANCE"));
 
         return std::shared_ptr<JKGrad>(jk);
 
@@ -142,6 +151,48 @@ void DFJKGrad::common_init()
     unit_b_ = 106;
     unit_c_ = 107;
     psio_ = PSIO::shared_object();
+    incore_ = false;
+    block_memory_ = 0L;
+}
+size_t DFJKGrad::incore_size() const
+{
+    if (!(do_K_ || do_wK_)) return 0L;
+
+    size_t naux = auxiliary_->nbf();
+    size_t na = Ca_->colspi()[0];
+    size_t nb = Cb_->colspi()[0];
+
+    size_t size = naux * na * na;
+    if (Ca_ != Cb_) size += naux * nb * nb;
+    if (do_wK_) size *= 2L;
+    return size;
+}
+bool DFJKGrad::incore_fits() const
+{
+    // Keep at least half of the memory for the blocked integral and contraction buffers
+    return (Ca_ && Cb_ && incore_size() <= memory_ / 2L);
+}
+void DFJKGrad::write_stripe(size_t unit, const std::string& label, double* buffer, size_t start, size_t size)
+{
+    if (incore_) {
+        std::vector<double>& tensor = incore_tensors_[std::make_pair(unit, label)];
+        if (tensor.size() < start + size) tensor.resize(start + size);
+        ::memcpy((void*) &tensor[start], (void*) buffer, sizeof(double) * size);
+    } else {
+        psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * start);
+        psio_->write(unit, label.c_str(), (char*) buffer, sizeof(double) * size, addr, &addr);
+    }
+}
+void DFJKGrad::read_stripe(size_t unit, const std::string& label, double* buffer, size_t start, size_t size)
+{
+    if (incore_) {
+        const std::vector<double>& tensor = incore_tensors_[std::make_pair(unit, label)];
+        if (tensor.size() < start + size) throw PSIEXCEPTION("DFJKGrad: read past the end of an in-core tensor.");
+        ::memcpy((void*) buffer, (void*) &tensor[start], sizeof(double) * size);
+    } else {
+        psio_address addr = psio_get_address(PSIO_ZERO, sizeof(double) * start);
+        psio_->read(unit, label.c_str(), (char*) buffer, sizeof(double) * size, addr, &addr);
+    }
 }
 void DFJKGrad::print_header() const
 {
@@ -157,6 +208,7 @@ void DFJKGrad::print_header() const
         outfile->Printf( "    OpenMP threads:    %11d\n", omp_num_threads_);
         outfile->Printf( "    Integrals threads: %11d\n", df_ints_num_threads_);
         outfile->Printf( "    Memory [MiB]:      %11ld\n", (memory_ *8L) / (1024L * 1024L));
+        outfile->Printf( "    Algorithm:         %11s\n", (incore_fits() ? "Core" : "Disk"));
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
         outfile->Printf( "    Fitting Condition: %11.0E\n\n", condition_);
 
@@ -189,6 +241,24 @@ void DFJKGrad::compute_gradient()
     // => Build ERI Sieve <= //
     sieve_ = std::make_shared<ERISieve>(primary_, cutoff_);
 
+    // => Storage for the (A|ij) and (A|w|ij) tensors <= //
+
+    // Held in core when they fit in half of the memory, the blocked buffers then work in what is left
+    incore_ = incore_fits();
+    block_memory_ = memory_ - (incore_ ? incore_size() : 0L);
+    incore_tensors_.clear();
+    if (incore_) {
+        size_t naux = auxiliary_->nbf();
+        size_t na = Ca_->colspi()[0];
+        size_t nb = Cb_->colspi()[0];
+        incore_tensors_[std::make_pair(unit_a_, std::string("(A|ij)"))].resize(naux * na * na);
+        if (Ca_ != Cb_) incore_tensors_[std::make_pair(unit_b_, std::string("(A|ij)"))].resize(naux * nb * nb);
+        if (do_wK_) {
+            incore_tensors_[std::make_pair(unit_a_, std::string("(A|w|ij)"))].resize(naux * na * na);
+            if (Ca_ != Cb_) incore_tensors_[std::make_pair(unit_b_, std::string("(A|w|ij)"))].resize(naux * nb * nb);
+        }
+    }
+
     // => Open temp files <= //
     psio_->open(unit_a_, PSIO_OPEN_NEW);
     psio_->open(unit_b_, PSIO_OPEN_NEW);
@@ -282,6 +352,7 @@ void DFJKGrad::compute_gradient()
     psio_->close(unit_a_, 0);
     psio_->close(unit_b_, 0);
     psio_->close(unit_c_, 0);
+    incore_tensors_.clear();
 }
 void DFJKGrad::build_Amn_terms()
 {
@@ -307,7 +378,7 @@ void DFJKGrad::build_Amn_terms()
         row_cost += nso * (size_t) na;
         row_cost += na * (size_t) na;
     }
-    size_t rows = memory_ / row_cost;
+    size_t rows = block_memory_ / row_cost;
     rows = (rows > naux ? naux : rows);
     rows = (rows < maxP ? maxP : rows);
     max_rows = (int) rows;
@@ -360,9 +431,6 @@ void DFJKGrad::build_Amn_terms()
     double** Cap = Ca_->pointer();
     double** Cbp = Cb_->pointer();
 
-    psio_address next_Aija = PSIO_ZERO;
-    psio_address next_Aijb = PSIO_ZERO;
-
     // => Integrals <= //
 
     auto rifactory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
@@ -445,7 +513,7 @@ void DFJKGrad::build_Amn_terms()
             }
 
             // > Stripe < //
-            psio_->write(unit_a_, "(A|ij)", (char*) Aijp[0], sizeof(double) * np * na * na, next_Aija, &next_Aija);
+            write_stripe(unit_a_, "(A|ij)", Aijp[0], pstart * (size_t) na * na, np * (size_t) na * na);
         }
 
         // > Beta < //
@@ -460,7 +528,7 @@ void DFJKGrad::build_Amn_terms()
             }
 
             // > Stripe < //
-            psio_->write(unit_b_, "(A|ij)", (char*) Aijp[0], sizeof(double) * np * nb * nb, next_Aijb, &next_Aijb);
+            write_stripe(unit_b_, "(A|ij)", Aijp[0], pstart * (size_t) nb * nb, np * (size_t) nb * nb);
         }
     }
 
@@ -492,7 +560,7 @@ void DFJKGrad::build_Amn_lr_terms()
     row_cost += nso * (size_t) nso;
     row_cost += nso * (size_t) na;
     row_cost += na * (size_t) na;
-    size_t rows = memory_ / row_cost;
+    size_t rows = block_memory_ / row_cost;
     rows = (rows > naux ? naux : rows);
     rows = (rows < maxP ? maxP : rows);
     max_rows = (int) rows;
@@ -533,9 +601,6 @@ void DFJKGrad::build_Amn_lr_terms()
     double** Cap = Ca_->pointer();
     double** Cbp = Cb_->pointer();
 
-    psio_address next_Aija = PSIO_ZERO;
-    psio_address next_Aijb = PSIO_ZERO;
-
     // => Integrals <= //
 
     auto rifactory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
@@ -613,7 +678,7 @@ void DFJKGrad::build_Amn_lr_terms()
             }
 
             // > Stripe < //
-            psio_->write(unit_a_, "(A|w|ij)", (char*) Aijp[0], sizeof(double) * np * na * na, next_Aija, &next_Aija);
+            write_stripe(unit_a_, "(A|w|ij)", Aijp[0], pstart * (size_t) na * na, np * (size_t) na * na);
         }
 
         // > Beta < //
@@ -628,7 +693,7 @@ void DFJKGrad::build_Amn_lr_terms()
             }
 
             // > Stripe < //
-            psio_->write(unit_b_, "(A|w|ij)", (char*) Aijp[0], sizeof(double) * np * nb * nb, next_Aijb, &next_Aijb);
+            write_stripe(unit_b_, "(A|w|ij)", Aijp[0], pstart * (size_t) nb * nb, np * (size_t) nb * nb);
         }
     }
 }
@@ -668,7 +733,7 @@ void DFJKGrad::build_AB_inv_terms()
         return;
 
     int max_cols;
-    size_t effective_memory = memory_ - 1L * naux * naux;
+    size_t effective_memory = block_memory_ - 1L * naux * naux;
     size_t col_cost = 2L * naux;
     size_t cols = effective_memory / col_cost;
     cols = (cols > na * (size_t) na ? na * (size_t) na : cols);
@@ -698,16 +763,12 @@ void DFJKGrad::build_AB_inv_terms()
             size_t nmo_size2 = nmo_size * nmo_size;
             // printf("%s | %zu %zu\n", buff_name.c_str(), unit_name, nmo_size);
 
-            psio_address next_Aija = PSIO_ZERO;
-
             for (long int ij = 0L; ij < nmo_size2; ij += max_cols) {
                 int ncols = (ij + max_cols >= nmo_size2 ? nmo_size2 - ij : max_cols);
 
                 // > Read < //
                 for (int Q = 0; Q < naux; Q++) {
-                    next_Aija = psio_get_address(PSIO_ZERO, sizeof(double) * (Q * (size_t)nmo_size2 + ij));
-                    psio_->read(unit_name, buff_name.c_str(), (char*)Aijp[Q], sizeof(double) * ncols, next_Aija,
-                                &next_Aija);
+                    read_stripe(unit_name, buff_name, Aijp[Q], Q * (size_t)nmo_size2 + ij, ncols);
                 }
 
                 // > GEMM <//
@@ -715,9 +776,7 @@ void DFJKGrad::build_AB_inv_terms()
 
                 // > Stripe < //
                 for (int Q = 0; Q < naux; Q++) {
-                    next_Aija = psio_get_address(PSIO_ZERO, sizeof(double) * (Q * (size_t)nmo_size2 + ij));
-                    psio_->write(unit_name, buff_name.c_str(), (char*)Bijp[Q], sizeof(double) * ncols, next_Aija,
-                                 &next_Aija);
+                    write_stripe(unit_name, buff_name, Bijp[Q], Q * (size_t)nmo_size2 + ij, ncols);
                 }
             }
         }
@@ -743,9 +802,9 @@ void DFJKGrad::build_UV_terms()
     // => Memory Constraints <= //
 
     int max_rows;
-    size_t effective_memory = memory_ - 1L * naux * naux;
+    size_t effective_memory = block_memory_ - 1L * naux * naux;
     size_t row_cost = 2L * na * (size_t) na;
-    size_t rows = memory_ / row_cost;
+    size_t rows = effective_memory / row_cost;
     rows = (rows > naux ? naux : rows);
     rows = (rows < 1L ? 1L : rows);
     max_rows = (int) rows;
@@ -761,14 +820,12 @@ void DFJKGrad::build_UV_terms()
 
     // > Alpha < //
     if (true) {
-        psio_address next_Aij = PSIO_ZERO;
         for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
             int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_a_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*na*na, next_Aij, &next_Aij);
+            read_stripe(unit_a_, "(A|ij)", Aijp[0], P * (size_t) na * na, nP * (size_t) na * na);
             for (int Q = 0; Q < naux; Q += max_rows) {
                 int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_a_,"(A|ij)",(char*) Bijp[0], sizeof(double)*nQ*na*na, next_Bij, &next_Bij);
+                read_stripe(unit_a_, "(A|ij)", Bijp[0], Q * (size_t) na * na, nQ * (size_t) na * na);
 
                 C_DGEMM('N','T',nP,nQ,na*(size_t)na,1.0,Aijp[0],na*(size_t)na,Bijp[0],na*(size_t)na,0.0,&Vp[P][Q],naux);
             }
@@ -776,14 +833,12 @@ void DFJKGrad::build_UV_terms()
     }
     // > Beta < //
     if (!restricted) {
-        psio_address next_Aij = PSIO_ZERO;
         for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
             int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_b_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*nb*nb, next_Aij, &next_Aij);
+            read_stripe(unit_b_, "(A|ij)", Aijp[0], P * (size_t) nb * nb, nP * (size_t) nb * nb);
             for (int Q = 0; Q < naux; Q += max_rows) {
                 int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_b_,"(A|ij)",(char*) Bijp[0], sizeof(double)*nQ*nb*nb, next_Bij, &next_Bij);
+                read_stripe(unit_b_, "(A|ij)", Bijp[0], Q * (size_t) nb * nb, nQ * (size_t) nb * nb);
 
                 C_DGEMM('N','T',nP,nQ,nb*(size_t)nb,1.0,Aijp[0],nb*(size_t)nb,Bijp[0],nb*(size_t)nb,1.0,&Vp[P][Q],naux);
             }
@@ -801,14 +856,12 @@ void DFJKGrad::build_UV_terms()
 
     // > Alpha < //
     if (true) {
-        psio_address next_Aij = PSIO_ZERO;
         for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
             int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_a_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*na*na, next_Aij, &next_Aij);
+            read_stripe(unit_a_, "(A|ij)", Aijp[0], P * (size_t) na * na, nP * (size_t) na * na);
             for (int Q = 0; Q < naux; Q += max_rows) {
                 int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_a_,"(A|w|ij)",(char*) Bijp[0], sizeof(double)*nQ*na*na, next_Bij, &next_Bij);
+                read_stripe(unit_a_, "(A|w|ij)", Bijp[0], Q * (size_t) na * na, nQ * (size_t) na * na);
 
                 C_DGEMM('N','T',nP,nQ,na*(size_t)na,1.0,Aijp[0],na*(size_t)na,Bijp[0],na*(size_t)na,0.0,&Vp[P][Q],naux);
             }
@@ -816,14 +869,12 @@ void DFJKGrad::build_UV_terms()
     }
     // > Beta < //
     if (!restricted) {
-        psio_address next_Aij = PSIO_ZERO;
         for (int P = 0; P < naux; P += max_rows) {
-            psio_address next_Bij = PSIO_ZERO;
             int nP = (P + max_rows >= naux ? naux - P : max_rows);
-            psio_->read(unit_b_,"(A|ij)",(char*) Aijp[0], sizeof(double)*nP*nb*nb, next_Aij, &next_Aij);
+            read_stripe(unit_b_, "(A|ij)", Aijp[0], P * (size_t) nb * nb, nP * (size_t) nb * nb);
             for (int Q = 0; Q < naux; Q += max_rows) {
                 int nQ = (Q + max_rows >= naux ? naux - Q : max_rows);
-                psio_->read(unit_b_,"(A|w|ij)",(char*) Bijp[0], sizeof(double)*nQ*nb*nb, next_Bij, &next_Bij);
+                read_stripe(unit_b_, "(A|w|ij)", Bijp[0], Q * (size_t) nb * nb, nQ * (size_t) nb * nb);
 
                 C_DGEMM('N','T',nP,nQ,nb*(size_t)nb,1.0,Aijp[0],nb*(size_t)nb,Bijp[0],nb*(size_t)nb,1.0,&Vp[P][Q],naux);
             }
@@ -1046,7 +1097,7 @@ void DFJKGrad::build_Amn_x_terms()
         }
         row_cost += nso * (size_t) na;
         row_cost += na * (size_t) na;
-        size_t rows = memory_ / row_cost;
+        size_t rows = block_memory_ / row_cost;
         rows = (rows > naux ? naux : rows);
         rows = (rows < maxP ? maxP : rows);
         max_rows = (int) rows;
@@ -1107,11 +1158,6 @@ void DFJKGrad::build_Amn_x_terms()
     double** Cap = Ca_->pointer();
     double** Cbp = Cb_->pointer();
 
-    psio_address next_Aija = PSIO_ZERO;
-    psio_address next_Aijb = PSIO_ZERO;
-    psio_address next_Awija = PSIO_ZERO;
-    psio_address next_Awijb = PSIO_ZERO;
-
     // => Integrals <= //
 
     auto rifactory = std::make_shared<IntegralFactory>(auxiliary_, BasisSet::zero_ao_basis_set(), primary_, primary_);
@@ -1148,18 +1194,18 @@ void DFJKGrad::build_Amn_x_terms()
 
     // => Figure out required transforms <= //
 
-    // unit, disk buffer name, nmo_size, psio_address, output_buffer
-    std::vector<std::tuple<size_t, std::string, double**, size_t, psio_address*, double**>> transforms;
+    // unit, buffer name, C, nmo_size, output_buffer
+    std::vector<std::tuple<size_t, std::string, double**, size_t, double**>> transforms;
     if (do_K_ || do_wK_) {
-        transforms.push_back(std::make_tuple(unit_a_, "(A|ij)", Cap, na, &next_Aija, Kmnp));
+        transforms.push_back(std::make_tuple(unit_a_, "(A|ij)", Cap, na, Kmnp));
         if (!restricted) {
-            transforms.push_back(std::make_tuple(unit_b_, "(A|ij)", Cbp, nb, &next_Aijb, Kmnp));
+            transforms.push_back(std::make_tuple(unit_b_, "(A|ij)", Cbp, nb, Kmnp));
         }
     }
     if (do_wK_) {
-        transforms.push_back(std::make_tuple(unit_a_, "(A|w|ij)", Cap, na, &next_Awija, wKmnp));
+        transforms.push_back(std::make_tuple(unit_a_, "(A|w|ij)", Cap, na, wKmnp));
         if (!restricted) {
-            transforms.push_back(std::make_tuple(unit_b_, "(A|w|ij)", Cbp, nb, &next_Awijb, wKmnp));
+            transforms.push_back(std::make_tuple(unit_b_, "(A|w|ij)", Cbp, nb, wKmnp));
         }
     }
 
@@ -1188,16 +1234,12 @@ void DFJKGrad::build_Amn_x_terms()
             std::string buffer = std::get<1>(trans);
             double** Cp = std::get<2>(trans);
             size_t nmo = std::get<3>(trans);
-            psio_address* address = std::get<4>(trans);
-            double** retp = std::get<5>(trans);
-            // printf("%4.2lf : %zu  %s %zu | %zu %zu\n", factor, unit, buffer.c_str(), nmo, address->page, address->offset);
+            double** retp = std::get<4>(trans);
 
             size_t nmo2 = nmo * nmo;
 
             // > Stripe < //
-            psio_->read(unit, buffer.c_str(), (char*)Aijp[0], sizeof(double) * np * nmo2, *address, address);
-            // printf("%4.2lf : %zu  %s %zu | %zu %zu\n", factor, unit, buffer.c_str(), nmo, address->page, address->offset);
-            // printf("\n");
+            read_stripe(unit, buffer, Aijp[0], pstart * nmo2, np * nmo2);
 
             // > (A|ij) C_mi -> (A|mj) < //
 #pragma omp parallel for
@@ -2159,6 +2201,8 @@ DirectJKGrad::~DirectJKGrad()
 void DirectJKGrad::common_init()
 {
     ints_num_threads_ = 1;
+    density_screening_ = false;
+    density_cutoff_ = 0.0;
 #ifdef _OPENMP
     ints_num_threads_ = Process::environment.get_n_threads();
 #endif
@@ -2176,6 +2220,9 @@ void DirectJKGrad::print_header() const
             outfile->Printf( "    Omega:             %11.3E\n", omega_);
         outfile->Printf( "    Integrals threads: %11d\n", ints_num_threads_);
         outfile->Printf( "    Schwarz Cutoff:    %11.0E\n", cutoff_);
+        outfile->Printf( "    Density Screening: %11s\n", (density_screening_ ? "Yes" : "No"));
+        if (density_screening_)
+            outfile->Printf( "    Density Cutoff:    %11.0E\n", density_cutoff_);
         outfile->Printf( "\n");
     }
 }
@@ -2205,59 +2252,123 @@ void DirectJKGrad::compute_gradient()
 
     auto factory = std::make_shared<IntegralFactory>(primary_,primary_,primary_,primary_);
 
-    if (do_J_ || do_K_) {
-        std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
-        for (int thread = 0; thread < ints_num_threads_; thread++) {
-            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri(1)));
-        }
-        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints);
-        if (do_J_) {
-            gradients_["Coulomb"]->copy(vals["J"]);
-            // gradients_["Coulomb"]->print();
-        }
-        if (do_K_) {
-            gradients_["Exchange"]->copy(vals["K"]);
-            // gradients_["Exchange"]->print();
-        }
+    // J, K and wK come out of one pass over the quartets, wK from its own erf integrals
+    std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
+    std::vector<std::shared_ptr<TwoBodyAOInt> > erf_ints;
+    for (int thread = 0; thread < ints_num_threads_; thread++) {
+        if (do_J_ || do_K_) ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->eri(1)));
+        if (do_wK_) erf_ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_,1)));
+    }
+    std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints, erf_ints);
+    if (do_J_) {
+        gradients_["Coulomb"]->copy(vals["J"]);
+    }
+    if (do_K_) {
+        gradients_["Exchange"]->copy(vals["K"]);
     }
     if (do_wK_) {
-        std::vector<std::shared_ptr<TwoBodyAOInt> > ints;
-        for (int thread = 0; thread < ints_num_threads_; thread++) {
-            ints.push_back(std::shared_ptr<TwoBodyAOInt>(factory->erf_eri(omega_,1)));
+        gradients_["Exchange,LR"]->copy(vals["wK"]);
+    }
+}
+std::vector<double> DirectJKGrad::shell_max_density(const std::vector<SharedMatrix>& D) const
+{
+    int nshell = primary_->nshell();
+    std::vector<double> shell_D(nshell * (size_t) nshell, 0.0);
+
+    for (size_t ind = 0; ind < D.size(); ind++) {
+        double** Dp = D[ind]->pointer();
+        for (int M = 0; M < nshell; M++) {
+            int Msize = primary_->shell(M).nfunction();
+            int Moff = primary_->shell(M).function_index();
+            for (int N = 0; N <= M; N++) {
+                int Nsize = primary_->shell(N).nfunction();
+                int Noff = primary_->shell(N).function_index();
+                double max_val = shell_D[M * (size_t) nshell + N];
+                for (int m = 0; m < Msize; m++) {
+                    for (int n = 0; n < Nsize; n++) {
+                        max_val = std::max(max_val, std::fabs(Dp[m + Moff][n + Noff]));
+                        max_val = std::max(max_val, std::fabs(Dp[n + Noff][m + Moff]));
+                    }
+                }
+                shell_D[M * (size_t) nshell + N] = max_val;
+                shell_D[N * (size_t) nshell + M] = max_val;
+            }
         }
-        std::map<std::string, std::shared_ptr<Matrix> > vals = compute1(ints);
-        gradients_["Exchange,LR"]->copy(vals["K"]);
-        // gradients_["Exchange,LR"]->print();
     }
+
+    return shell_D;
 }
-std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints)
+std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
+    std::vector<std::shared_ptr<TwoBodyAOInt> >& erf_ints)
 {
-    int nthreads = ints.size();
+    int nthreads = std::max(ints.size(), erf_ints.size());
 
     int natom = primary_->molecule()->natom();
+    int nshell = primary_->nshell();
+
+    bool do_J = do_J_ && ints.size();
+    bool do_K = do_K_ && ints.size();
+    bool do_wK = do_wK_ && erf_ints.size();
 
     std::vector<std::shared_ptr<Matrix> > Jgrad;
     std::vector<std::shared_ptr<Matrix> > Kgrad;
+    std::vector<std::shared_ptr<Matrix> > wKgrad;
     for (int thread = 0; thread < nthreads; thread++) {
         Jgrad.push_back(std::make_shared<Matrix>("JGrad",natom,3));
         Kgrad.push_back(std::make_shared<Matrix>("KGrad",natom,3));
+        wKgrad.push_back(std::make_shared<Matrix>("wKGrad",natom,3));
+    }
+
+    // => Task Ordering <= //
+
+    // Shell pairs by estimated cost (nfunction * nprimitive on both centers), heaviest first. Bra pair PQ
+    // takes the kets RS at or after it in this order, so the dynamic schedule starts with the high angular
+    // momentum quartets and ends on cheap ones that fill in the load imbalance, as in DirectJK.
+    std::vector<std::pair<int, int> > shell_pairs = sieve_->shell_pairs();
+    std::vector<double> pair_costs;
+    for (const auto& pair : shell_pairs) {
+        const GaussianShell& Pshell = primary_->shell(pair.first);
+        const GaussianShell& Qshell = primary_->shell(pair.second);
+        pair_costs.push_back((double) Pshell.nfunction() * Pshell.nprimitive() * Qshell.nfunction() *
+                             Qshell.nprimitive());
+    }
+    std::vector<size_t> pair_order(shell_pairs.size());
+    for (size_t PQ = 0; PQ < pair_order.size(); PQ++) pair_order[PQ] = PQ;
+    std::stable_sort(pair_order.begin(), pair_order.end(),
+                     [&pair_costs](size_t a, size_t b) { return pair_costs[a] > pair_costs[b]; });
+    {
+        std::vector<std::pair<int, int> > sorted_pairs;
+        for (size_t PQ : pair_order) sorted_pairs.push_back(shell_pairs[PQ]);
+        shell_pairs.swap(sorted_pairs);
     }
-
-    const std::vector<std::pair<int, int> >& shell_pairs = sieve_->shell_pairs();
     size_t npairs = shell_pairs.size();
     size_t npairs2 = npairs * npairs;
 
+    // => Density Screening <= //
+
+    // The Schwarz ceiling of the quartet, weighted by the largest density products each contraction
+    // touches: Dt_PQ Dt_RS for J, max(D_PR D_QS, D_PS D_QR) over alpha and beta for K and wK
+    std::vector<double> shell_Dt, shell_Dk;
+    double density_cutoff2 = density_cutoff_ * density_cutoff_;
+    if (density_screening_) {
+        shell_Dt = shell_max_density({Dt_});
+        shell_Dk = shell_max_density({Da_, Db_});
+    }
+
     double** Dtp = Dt_->pointer();
     double** Dap = Da_->pointer();
     double** Dbp = Db_->pointer();
 
-#pragma omp parallel for num_threads(nthreads) schedule(dynamic)
+    size_t computed_shells = 0L;
+    size_t density_skipped_shells = 0L;
+
+#pragma omp parallel for num_threads(nthreads) schedule(dynamic) reduction(+: computed_shells, density_skipped_shells)
     for (long int index = 0L; index < npairs2; index++) {
 
         size_t PQ = index / npairs;
         size_t RS = index % npairs;
 
-        if (RS > PQ) continue;
+        if (RS < PQ) continue;
 
         int P = shell_pairs[PQ].first;
         int Q = shell_pairs[PQ].second;
@@ -2266,20 +2377,25 @@ std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vect
 
         if (!sieve_->shell_significant(P,Q,R,S)) continue;
 
-        //outfile->Printf("(%d,%d,%d,%d)\n", P,Q,R,S);
+        if (density_screening_) {
+            double Dmax = 0.0;
+            if (do_J) Dmax = shell_Dt[P * (size_t) nshell + Q] * shell_Dt[R * (size_t) nshell + S];
+            if (do_K || do_wK) {
+                Dmax = std::max(Dmax, shell_Dk[P * (size_t) nshell + R] * shell_Dk[Q * (size_t) nshell + S]);
+                Dmax = std::max(Dmax, shell_Dk[P * (size_t) nshell + S] * shell_Dk[Q * (size_t) nshell + R]);
+            }
+            if (sieve_->shell_ceiling2(P,Q,R,S) * Dmax * Dmax < density_cutoff2) {
+                density_skipped_shells++;
+                continue;
+            }
+        }
+        computed_shells++;
 
         int thread = 0;
 #ifdef _OPENMP
         thread = omp_get_thread_num();
 #endif
 
-        ints[thread]->compute_shell_deriv1(P,Q,R,S);
-
-        const double* buffer = ints[thread]->buffer();
-
-        double** Jp = Jgrad[thread]->pointer();
-        double** Kp = Kgrad[thread]->pointer();
-
         int Psize = primary_->shell(P).nfunction();
         int Qsize = primary_->shell(Q).nfunction();
         int Rsize = primary_->shell(R).nfunction();
@@ -2307,128 +2423,103 @@ std::map<std::string, std::shared_ptr<Matrix> > DirectJKGrad::compute1(std::vect
 
         size_t stride = Pncart * Qncart * Rncart * Sncart;
 
-        double val;
-        double Dpq, Drs;
-        size_t delta;
-        double Ax, Ay, Az;
-        double Bx, By, Bz;
-        double Cx, Cy, Cz;
-        double Dx, Dy, Dz;
-
-        // => Coulomb Term <= //
-
-        Ax = 0.0; Ay = 0.0; Az = 0.0;
-        Bx = 0.0; By = 0.0; Bz = 0.0;
-        Cx = 0.0; Cy = 0.0; Cz = 0.0;
-        Dx = 0.0; Dy = 0.0; Dz = 0.0;
-        delta = 0L;
-        for (int p = 0; p < Psize; p++) {
-            for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                    for (int s = 0; s < Ssize; s++) {
-                        Dpq = Dtp[p + Poff][q + Qoff];
-                        Drs = Dtp[r + Roff][s + Soff];
-                        val = prefactor * Dpq * Drs;
-                        Ax += val * buffer[0 * stride + delta];
-                        Ay += val * buffer[1 * stride + delta];
-                        Az += val * buffer[2 * stride + delta];
-                        Cx += val * buffer[3 * stride + delta];
-                        Cy += val * buffer[4 * stride + delta];
-                        Cz += val * buffer[5 * stride + delta];
-                        Dx += val * buffer[6 * stride + delta];
-                        Dy += val * buffer[7 * stride + delta];
-                        Dz += val * buffer[8 * stride + delta];
-                        delta++;
+        // Contract one derivative buffer with the Coulomb (Dt Dt) or exchange (Da Da + Db Db) density
+        // products and add the four center contributions (translational invariance for Q) to Gp
+        auto contract = [&](const double* buffer, bool coulomb, double** Gp) {
+            double val;
+            double Dpq, Drs;
+            size_t delta = 0L;
+            double Ax = 0.0, Ay = 0.0, Az = 0.0;
+            double Cx = 0.0, Cy = 0.0, Cz = 0.0;
+            double Dx = 0.0, Dy = 0.0, Dz = 0.0;
+            for (int p = 0; p < Psize; p++) {
+                for (int q = 0; q < Qsize; q++) {
+                    for (int r = 0; r < Rsize; r++) {
+                        for (int s = 0; s < Ssize; s++) {
+                            if (coulomb) {
+                                Dpq = Dtp[p + Poff][q + Qoff];
+                                Drs = Dtp[r + Roff][s + Soff];
+                                val = prefactor * Dpq * Drs;
+                            } else {
+                                val = 0.0;
+                                Dpq = Dap[p + Poff][r + Roff];
+                                Drs = Dap[q + Qoff][s + Soff];
+                                val += prefactor * Dpq * Drs;
+                                Dpq = Dap[p + Poff][s + Soff];
+                                Drs = Dap[q + Qoff][r + Roff];
+                                val += prefactor * Dpq * Drs;
+                                Dpq = Dbp[p + Poff][r + Roff];
+                                Drs = Dbp[q + Qoff][s + Soff];
+                                val += prefactor * Dpq * Drs;
+                                Dpq = Dbp[p + Poff][s + Soff];
+                                Drs = Dbp[q + Qoff][r + Roff];
+                                val += prefactor * Dpq * Drs;
+                                val *= 0.5;
+                            }
+                            Ax += val * buffer[0 * stride + delta];
+                            Ay += val * buffer[1 * stride + delta];
+                            Az += val * buffer[2 * stride + delta];
+                            Cx += val * buffer[3 * stride + delta];
+                            Cy += val * buffer[4 * stride + delta];
+                            Cz += val * buffer[5 * stride + delta];
+                            Dx += val * buffer[6 * stride + delta];
+                            Dy += val * buffer[7 * stride + delta];
+                            Dz += val * buffer[8 * stride + delta];
+                            delta++;
+                        }
                     }
                 }
             }
+            double Bx = -(Ax + Cx + Dx);
+            double By = -(Ay + Cy + Dy);
+            double Bz = -(Az + Cz + Dz);
+
+            Gp[Pcenter][0] += Ax;
+            Gp[Pcenter][1] += Ay;
+            Gp[Pcenter][2] += Az;
+            Gp[Qcenter][0] += Bx;
+            Gp[Qcenter][1] += By;
+            Gp[Qcenter][2] += Bz;
+            Gp[Rcenter][0] += Cx;
+            Gp[Rcenter][1] += Cy;
+            Gp[Rcenter][2] += Cz;
+            Gp[Scenter][0] += Dx;
+            Gp[Scenter][1] += Dy;
+            Gp[Scenter][2] += Dz;
+        };
+
+        if (do_J || do_K) {
+            ints[thread]->compute_shell_deriv1(P,Q,R,S);
+            const double* buffer = ints[thread]->buffer();
+            if (do_J) contract(buffer, true, Jgrad[thread]->pointer());
+            if (do_K) contract(buffer, false, Kgrad[thread]->pointer());
         }
-        Bx = -(Ax + Cx + Dx);
-        By = -(Ay + Cy + Dy);
-        Bz = -(Az + Cz + Dz);
-
-        Jp[Pcenter][0] += Ax;
-        Jp[Pcenter][1] += Ay;
-        Jp[Pcenter][2] += Az;
-        Jp[Qcenter][0] += Bx;
-        Jp[Qcenter][1] += By;
-        Jp[Qcenter][2] += Bz;
-        Jp[Rcenter][0] += Cx;
-        Jp[Rcenter][1] += Cy;
-        Jp[Rcenter][2] += Cz;
-        Jp[Scenter][0] += Dx;
-        Jp[Scenter][1] += Dy;
-        Jp[Scenter][2] += Dz;
-
-        // => Exchange Term <= //
-
-        Ax = 0.0; Ay = 0.0; Az = 0.0;
-        Bx = 0.0; By = 0.0; Bz = 0.0;
-        Cx = 0.0; Cy = 0.0; Cz = 0.0;
-        Dx = 0.0; Dy = 0.0; Dz = 0.0;
-        delta = 0L;
-        for (int p = 0; p < Psize; p++) {
-            for (int q = 0; q < Qsize; q++) {
-                for (int r = 0; r < Rsize; r++) {
-                    for (int s = 0; s < Ssize; s++) {
-                        val = 0.0;
-                        Dpq = Dap[p + Poff][r + Roff];
-                        Drs = Dap[q + Qoff][s + Soff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dap[p + Poff][s + Soff];
-                        Drs = Dap[q + Qoff][r + Roff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dbp[p + Poff][r + Roff];
-                        Drs = Dbp[q + Qoff][s + Soff];
-                        val += prefactor * Dpq * Drs;
-                        Dpq = Dbp[p + Poff][s + Soff];
-                        Drs = Dbp[q + Qoff][r + Roff];
-                        val += prefactor * Dpq * Drs;
-                        val *= 0.5;
-                        Ax += val * buffer[0 * stride + delta];
-                        Ay += val * buffer[1 * stride + delta];
-                        Az += val * buffer[2 * stride + delta];
-                        Cx += val * buffer[3 * stride + delta];
-                        Cy += val * buffer[4 * stride + delta];
-                        Cz += val * buffer[5 * stride + delta];
-                        Dx += val * buffer[6 * stride + delta];
-                        Dy += val * buffer[7 * stride + delta];
-                        Dz += val * buffer[8 * stride + delta];
-                        delta++;
-                    }
-                }
-            }
+        if (do_wK) {
+            erf_ints[thread]->compute_shell_deriv1(P,Q,R,S);
+            contract(erf_ints[thread]->buffer(), false, wKgrad[thread]->pointer());
         }
-        Bx = -(Ax + Cx + Dx);
-        By = -(Ay + Cy + Dy);
-        Bz = -(Az + Cz + Dz);
-
-        Kp[Pcenter][0] += Ax;
-        Kp[Pcenter][1] += Ay;
-        Kp[Pcenter][2] += Az;
-        Kp[Qcenter][0] += Bx;
-        Kp[Qcenter][1] += By;
-        Kp[Qcenter][2] += Bz;
-        Kp[Rcenter][0] += Cx;
-        Kp[Rcenter][1] += Cy;
-        Kp[Rcenter][2] += Cz;
-        Kp[Scenter][0] += Dx;
-        Kp[Scenter][1] += Dy;
-        Kp[Scenter][2] += Dz;
-
     }
 
     for (int thread = 1; thread < nthreads; thread++) {
         Jgrad[0]->add(Jgrad[thread]);
         Kgrad[0]->add(Kgrad[thread]);
+        wKgrad[0]->add(wKgrad[thread]);
     }
 
     Jgrad[0]->scale(0.5);
     Kgrad[0]->scale(0.5);
+    wKgrad[0]->scale(0.5);
+
+    if (print_ > 1 && density_screening_) {
+        size_t total = computed_shells + density_skipped_shells;
+        outfile->Printf("  DirectJKGrad: %zu of %zu Schwarz-significant shell quartets skipped by density screening\n\n",
+                        density_skipped_shells, total);
+    }
 
     std::map<std::string, std::shared_ptr<Matrix> > val;
     val["J"] = Jgrad[0];
     val["K"] = Kgrad[0];
+    val["wK"] = wKgrad[0];
     return val;
 }
 void DirectJKGrad::compute_hessian()
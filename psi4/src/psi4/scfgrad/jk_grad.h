@@ -31,6 +31,8 @@
 
 #include "psi4/libmints/typedefs.h"
 #include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace psi {
@@ -186,6 +188,21 @@ protected:
     void build_AB_x_terms();
     void build_Amn_x_terms();
 
+    /// Are the (A|ij) and (A|w|ij) tensors held in core for this gradient?
+    bool incore_;
+    /// Doubles left for the blocked buffers once the in-core tensors are allocated
+    size_t block_memory_;
+    /// In-core (A|ij) and (A|w|ij) tensors, keyed by the unit and entry they would have on disk
+    std::map<std::pair<size_t, std::string>, std::vector<double> > incore_tensors_;
+    /// Number of doubles in the (A|ij) and (A|w|ij) tensors
+    size_t incore_size() const;
+    /// Do the (A|ij) and (A|w|ij) tensors fit in core?
+    bool incore_fits() const;
+    /// Write size doubles at offset start of a three-index tensor, in core or to disk
+    void write_stripe(size_t unit, const std::string& label, double* buffer, size_t start, size_t size);
+    /// Read size doubles at offset start of a three-index tensor, in core or from disk
+    void read_stripe(size_t unit, const std::string& label, double* buffer, size_t start, size_t size);
+
     /// File number for Alpha (Q|mn) tensor
     size_t unit_a_;
     /// File number for Beta (Q|mn) tensor
@@ -238,10 +255,17 @@ class DirectJKGrad : public JKGrad {
 protected:
     // Number of threads to use
     int ints_num_threads_;
+    // Skip quartets whose Schwarz ceiling times the largest density products falls below density_cutoff_?
+    bool density_screening_;
+    double density_cutoff_;
 
     void common_init();
 
-    std::map<std::string, std::shared_ptr<Matrix> > compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints);
+    /// Shell-pair maxima of |D_mn| over all densities (nshell x nshell, symmetrized)
+    std::vector<double> shell_max_density(const std::vector<SharedMatrix>& D) const;
+    /// J and K (ints) and wK (erf_ints) gradients in one pass, either list may be empty
+    std::map<std::string, std::shared_ptr<Matrix> > compute1(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints,
+                                                             std::vector<std::shared_ptr<TwoBodyAOInt> >& erf_ints);
     std::map<std::string, std::shared_ptr<Matrix> > compute2(std::vector<std::shared_ptr<TwoBodyAOInt> >& ints);
 public:
     DirectJKGrad(int deriv, std::shared_ptr<BasisSet> primary);
@@ -257,6 +281,16 @@ public:
      * @param val a positive integer
      */
     void set_ints_num_threads(int val) { ints_num_threads_ = val; }
+    /**
+     * Density-weighted screening of the derivative quartets
+     * @param val do density screening or not, defaults to false
+     */
+    void set_density_screening(bool val) { density_screening_ = val; }
+    /**
+     * Cutoff for density-weighted screening
+     * @param val cutoff, defaults to 0.0 (nothing skipped)
+     */
+    void set_density_cutoff(double val) { density_cutoff_ = val; }
 
 
 };
@@ -89,6 +89,14 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
     int nvir  = eps_vir->dimpi()[0];
     int nmo   = C->colspi()[0];
 
+    // => Kohn-Sham <= //
+
+    // Exact exchange fraction and, for KS references, the XC kernel on the SCF grid
+    bool needs_xc = functional_ && functional_->needs_xc();
+    double Kscale = (functional_ ? functional_->x_alpha() : 1.0);
+    bool do_K = (Kscale != 0.0);
+    if (needs_xc) potential_->set_D({Dt});
+
     // => Target <= //
 
     auto response = std::make_shared<Matrix>("RHF Response",3*natom,3*natom);
@@ -586,15 +594,15 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                             // Px
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+0*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Px][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Px][0], nso);
                             // Py
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+1*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Py][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Py][0], nso);
                             // Pz
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+2*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Pz][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Pz][0], nso);
 
                         }
                         if(pert_incore[Qcenter]){
@@ -613,15 +621,15 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                             // Qx
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+3*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qx][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qx][0], nso);
                             // Qy
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+4*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qy][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qy][0], nso);
                             // Qz
                             C_DGEMM('n', 'n', nP, nso*nso, nQ, 1.0, ptr+5*stride, nQ, pTmn[oQ], nso*nso, 0.0, pTmpPmn[0], nso*nso);
                             for(int p = 0; p < nP; ++p)
-                                C_DGEMM('N', 'N', nso, nso, nso, 1.0, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qz][0], nso);
+                                C_DGEMM('N', 'N', nso, nso, nso, Kscale, Bmnp[p+oP], nso, pTmpPmn[p], nso, 1.0, pdG[Qz][0], nso);
                         }
 
                     }
@@ -707,11 +715,11 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[2], 1, 1.0, pdG[Pz][0], 1);
                                 // K Terms
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+0*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Px][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+0*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Px][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+1*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Py][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+1*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Py][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+2*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Pz][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+2*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[Pz][oN], nso);
                             }
                             if(pert_incore[Mcenter]){
                                 // J Terms
@@ -731,11 +739,11 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[5], 1, 1.0, pdG[mz][0], 1);
                                 // K Terms
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+3*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mx][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+3*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mx][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+4*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[my][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+4*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[my][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+5*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mz][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+5*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[mz][oN], nso);
                             }
                             if(pert_incore[Ncenter]){
                                 // J Terms
@@ -755,20 +763,25 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                                 C_DGEMV('t', nP, nso*nso, 2.0, Bmnp[oP], nso*nso, pTempP[8], 1, 1.0, pdG[nz][0], 1);
                                 // K Terms
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+6*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nx][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+6*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nx][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+7*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[ny][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+7*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[ny][oN], nso);
                                 for(int p = 0; p < nP; ++p)
-                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0, ptr+8*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nz][oN], nso);
+                                    C_DGEMM('T', 'N', nN, nso, nM, -2.0 * Kscale, ptr+8*stride+p*nM*nN, nN, &pTmn[oP+p][oM*nso], nso, 1.0, pdG[nz][oN], nso);
                             }
 
                         }
                     }
                 }
 
+                // XC derivative contributions at fixed density, one grid pass for the whole batch
+                std::vector<SharedMatrix> dVmats;
+                if (needs_xc) dVmats = potential_->compute_fock_derivatives(A, nA);
+
                 for(int a = 0; a < nA; ++a){
                     // Symmetrize the derivative Fock contributions
                     SharedMatrix G = dGmats[a];
+                    if (needs_xc) G->add(dVmats[a]);
                     G->add(G->transpose());
                     Gpi->transform(C, G, Cocc);
                     Gpi->scale(0.5);
@@ -954,7 +967,7 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                     Cx = 0.0; Cy = 0.0; Cz = 0.0;
                     Dx = 0.0; Dy = 0.0; Dz = 0.0;
                     delta = 0L;
-                    prefactor *= -0.25;
+                    prefactor *= -0.25 * Kscale;
                     for (int p = Poff; p < Poff+Psize; p++) {
                         for (int q = Qoff; q < Qoff+Qsize; q++) {
                             for (int r = Roff; r < Roff+Rsize; r++) {
@@ -1039,9 +1052,14 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                     }
                 } // End shell loops
 
+                // XC derivative contributions at fixed density, one grid pass for the whole batch
+                std::vector<SharedMatrix> dVmats;
+                if (needs_xc) dVmats = potential_->compute_fock_derivatives(A, nA);
+
                 for(int a = 0; a < nA; ++a){
                     // Symmetrize the derivative Fock contributions
                     SharedMatrix G = dGmats[a];
+                    if (needs_xc) G->add(dVmats[a]);
                     G->add(G->transpose());
                     Gpi->transform(C, G, Cocc);
                     Gpi->scale(0.5);
@@ -1061,6 +1079,7 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
     jk = JK::build_JK(basisset_, get_basisset("DF_BASIS_SCF"), options_, false, mem);
 
     jk->set_memory(mem);
+    jk->set_do_K(do_K);
     jk->initialize();
 
 
@@ -1069,6 +1088,7 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
      * Py-side to make sure that doesn't get us in here.
      */
     bool ignore_symmetry = nirrep_ == 1 || jk->C1();
+    if (needs_xc && !ignore_symmetry) throw PSIEXCEPTION("SCFGrad: KS Hessians require C1 JK objects.");
 
     Dimension nvirpi = nmopi_ - doccpi_;
     CdSalcList SALCList(molecule_, 0xFF, false, false);
@@ -1234,6 +1254,17 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
 
             jk->compute();
 
+            // XC kernel on the same overlap densities, all perturbations of the batch in one grid pass
+            std::vector<SharedMatrix> Vx;
+            if (needs_xc) {
+                std::vector<SharedMatrix> Dx;
+                for (int a = 0; a < nA; a++) {
+                    Dx.push_back(Matrix::doublet(L[a], R[a], false, true));
+                    Vx.push_back(std::make_shared<Matrix>("Vx Temp", nso, nso));
+                }
+                potential_->compute_Vx(Dx, Vx);
+            }
+
             for (int a = 0; a < nA; a++) {
                 if(ignore_symmetry){
                     // Add the 2J contribution to G
@@ -1241,8 +1272,16 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                     C_DGEMM('T','N',nmo,nocc,nso,-2.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
 
                     // Subtract the K term from G
-                    C_DGEMM('N','N',nso,nocc,nso,1.0,K[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
-                    C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,1.0,Up[0],nocc);
+                    if (do_K) {
+                        C_DGEMM('N','N',nso,nocc,nso,1.0,K[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
+                        C_DGEMM('T','N',nmo,nocc,nso,Kscale,Cp[0],nmo,Tp[0],nocc,1.0,Up[0],nocc);
+                    }
+
+                    // Add the 2Vx contribution to G
+                    if (needs_xc) {
+                        C_DGEMM('N','N',nso,nocc,nso,1.0,Vx[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
+                        C_DGEMM('T','N',nmo,nocc,nso,-2.0,Cp[0],nmo,Tp[0],nocc,1.0,Up[0],nocc);
+                    }
 
                     psio_address next_Gpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * nocc * sizeof(double));
                     psio_->write(PSIF_HESS,"G2pi^A",(char*)Up[0],nmo*nocc*sizeof(double),next_Gpi,&next_Gpi);
@@ -1250,7 +1289,7 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
                     const CdSalc& thissalc = SALCList[a+A];
                     int salcirrep = thissalc.irrep();
                     J[a]->scale(-2.0);
-                    J[a]->add(K[a]);
+                    if (do_K) J[a]->axpy(Kscale, K[a]);
 
                     // Transform from SO to C1 MO basis
                     auto Fmat = std::make_shared<Matrix>("F derivative", nmo, nocc);
@@ -1338,7 +1377,15 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
         auto wfn = std::make_shared<Wavefunction>(options_);
         wfn->shallow_copy(this);
 
-        auto cphf = std::make_shared<RCPHF>(wfn, options_, !ignore_symmetry);
+        // KS references need the XC kernel in the orbital Hessian
+        std::shared_ptr<RCPHF> cphf;
+        if (needs_xc) {
+            auto cpks = std::make_shared<RCPKS>(wfn, options_, false);
+            cpks->set_v(potential_);
+            cphf = cpks;
+        } else {
+            cphf = std::make_shared<RCPHF>(wfn, options_, !ignore_symmetry);
+        }
         cphf->set_jk(jk);
 
         std::map<std::string, SharedMatrix>& b = cphf->b();
@@ -1518,10 +1565,26 @@ std::shared_ptr<Matrix> SCFGrad::rhf_hessian_response()
             }
 
             jk->compute();
+
+            std::vector<SharedMatrix> Vx;
+            if (needs_xc) {
+                std::vector<SharedMatrix> Dx;
+                for (int a = 0; a < nA; a++) {
+                    Dx.push_back(Matrix::doublet(L[a], R[a], false, true));
+                    Vx.push_back(std::make_shared<Matrix>("Vx Temp", nso, nso));
+                }
+                potential_->compute_Vx(Dx, Vx);
+            }
+
             for (int a = 0; a < nA; a++) {
                 C_DGEMM('N','N',nso,nocc,nso, 4.0,J[a]->pointer()[0],nso,Cop[0],nocc,0.0,Tp[0],nocc);
-                C_DGEMM('N','N',nso,nocc,nso,-1.0,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
-                C_DGEMM('T','N',nso,nocc,nso,-1.0,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                if (do_K) {
+                    C_DGEMM('N','N',nso,nocc,nso,-Kscale,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                    C_DGEMM('T','N',nso,nocc,nso,-Kscale,K[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                }
+                if (needs_xc) {
+                    C_DGEMM('N','N',nso,nocc,nso, 4.0,Vx[a]->pointer()[0],nso,Cop[0],nocc,1.0,Tp[0],nocc);
+                }
                 C_DGEMM('T','N',nmo,nocc,nso,1.0,Cp[0],nmo,Tp[0],nocc,0.0,Up[0],nocc);
                 psio_address next_Qpi = psio_get_address(PSIO_ZERO,(A + a) * (size_t) nmo * nocc * sizeof(double));
                 psio_->write(PSIF_HESS,"Qpi^A",(char*)Up[0],nmo*nocc*sizeof(double),next_Qpi,&next_Qpi);
@@ -184,6 +184,12 @@ SharedMatrix SCFGrad::compute_gradient()
         gradient_terms.push_back("External Potential");
         timer_on("Grad: External");
         gradients_["External Potential"] = external_pot_->computePotentialGradients(basisset_, Dt);
+        // The reaction on the external charges, for QM/MM drivers that move them
+        external_pot_->set_far_field(options_.get_double("EXTERNAL_POTENTIAL_FAR_CUTOFF"),
+                                     options_.get_double("EXTERNAL_POTENTIAL_FAR_THETA"));
+        /*- Process::environment.arrays["EXTERNAL POTENTIAL CHARGE GRADIENT"] -*/
+        Process::environment.arrays["EXTERNAL POTENTIAL CHARGE GRADIENT"] =
+            external_pot_->computeChargeGradients(basisset_, Dt);
         timer_off("Grad: External");
     }  // end external
 
@@ -362,12 +368,12 @@ SharedMatrix SCFGrad::compute_hessian()
     std::shared_ptr<VBase> potential;
 
     if (functional_->needs_xc()) {
-        throw PSIEXCEPTION("Missing XC derivates for Hessians");
-        // if (options_.get_str("REFERENCE") == "RKS") {
-        //     potential_->set_D({Da_});
-        // } else {
-        //     potential_->set_D({Da_, Db_});
-        // }
+        if (options_.get_str("REFERENCE") != "RKS") {
+            throw PSIEXCEPTION("SCFHessian: XC Hessians are only implemented for RKS references");
+        }
+        functional = functional_;
+        potential = potential_;
+        potential->set_D({Da});
     }
 
     // => Sizings <= //
@@ -1039,13 +1045,12 @@ SharedMatrix SCFGrad::compute_hessian()
     timer_on("Hess: XC");
     if (functional) {
         potential->print_header();
-        throw PSIEXCEPTION("KS Hessians not implemented");
-        //hessians_["XC"] = potential->compute_hessian();
+        hessians_["XC"] = potential->compute_hessian();
     }
     timer_off("Hess: XC");
 
     // => Response Terms (Brace Yourself) <= //
-    if (options_.get_str("REFERENCE") == "RHF") {
+    if (options_.get_str("REFERENCE") == "RHF" || options_.get_str("REFERENCE") == "RKS") {
         hessians_["Response"] = rhf_hessian_response();
     } else {
         throw PSIEXCEPTION("SCFHessian: Response not implemented for this reference");
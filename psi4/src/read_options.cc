@@ -136,11 +136,33 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- Either :ref:`a set of 3 coordinates or a string <table:oe_origin>`
   describing the origin about which one-electron properties are computed. -*/
   options.add("PROPERTIES_ORIGIN", new ArrayType());
+  /*- Evaluate GRID_ESP from the density fitted to the wavefunction's DF_BASIS_SCF, with far
+  atoms treated as multipoles (see CUBIC_ESP_TOLERANCE), instead of exact AO integrals. -*/
+  options.add_bool("PROPERTIES_ESP_FIT", false);
+  /*- Spacing [Angstrom] of the cubic grid for CHELPG_CHARGES. -*/
+  options.add_double("CHELPG_SPACING", 0.3);
+  /*- Largest distance [Angstrom] from the nearest atom of a CHELPG_CHARGES grid point. -*/
+  options.add_double("CHELPG_MAX_DISTANCE", 2.8);
+  /*- Points per square Angstrom on each Merz-Kollman shell, for MK_CHARGES and RESP_CHARGES. -*/
+  options.add_double("MK_POINT_DENSITY", 1.0);
+  /*- Strength [a.u.] of the hyperbolic restraint on non-hydrogen atoms in RESP_CHARGES. -*/
+  options.add_double("RESP_A", 0.0005);
+  /*- Width [e] of the hyperbolic restraint in RESP_CHARGES. -*/
+  options.add_double("RESP_B", 0.1);
 
   /*- Psi4 dies if energy does not converge. !expert -*/
   options.add_bool("DIE_IF_NOT_CONVERGED", true);
-  /*- Integral package to use. If compiled with ERD or Simint support, change this option to use them; LibInt is used otherwise. -*/
-  options.add_str("INTEGRAL_PACKAGE", "LIBINT", "ERD LIBINT SIMINT");
+  /*- Integral package to use. If compiled with ERD or Simint support, change this option to use them; LibInt is used otherwise.
+  HYBRID picks the fastest compiled-in package for each angular momentum class. The choice is
+  timed once per host and remembered in the scratch directory. -*/
+  options.add_str("INTEGRAL_PACKAGE", "LIBINT", "ERD LIBINT SIMINT HYBRID");
+  /*- Primitive quartets whose Gaussian prefactor bound falls below this are skipped in the LibInt
+  electron repulsion integrals. 0.0 keeps every primitive. !expert -*/
+  options.add_double("INTS_PRIMITIVE_TOLERANCE", 1.0E-20);
+  /*- Schwarz sieves built on a basis already sieved at another geometry (e.g. the previous step of
+  an optimization) reuse the (MN|MN) bounds of shell pairs whose centers moved relative to each other
+  by less than this many bohr, inflated to stay conservative. 0.0 recomputes every bound. !expert -*/
+  options.add_double("SIEVE_REUSE_TOLERANCE", 0.0);
 
   // Note that case-insensitive options are only functional as
   //   globals, not as module-level, and should be defined sparingly
@@ -153,6 +175,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add_str("DF_BASIS_CC", "");
   /*- Assume external fields are arranged so that they have symmetry. It is up to the user to know what to do here. The code does NOT help you out in any way! !expert -*/
   options.add_bool("EXTERNAL_POTENTIAL_SYMMETRY", false);
+  /*- Distance (bohr) from each shell pair beyond which external point charges enter through a multipole
+  expansion over an octree instead of exact integrals. Zero keeps every charge exact. -*/
+  options.add_double("EXTERNAL_POTENTIAL_FAR_CUTOFF", 0.0);
+  /*- Opening criterion for |globals__external_potential_far_cutoff|: an octree cell of external charges is
+  used as a whole when its radius plus the shell pair extent is below this fraction of their distance. -*/
+  options.add_double("EXTERNAL_POTENTIAL_FAR_THETA", 0.3);
+  /*- Fail a module that asks the memory broker for more than is left of |globals__memory|, rather than
+  let it overcommit. Lower-priority caches, such as the DFT collocation cache, are shrunk first either way. -*/
+  options.add_bool("MEMORY_BROKER_STRICT", false);
   /*- Text to be passed directly into CFOUR input files. May contain
   molecule, options, percent blocks, etc. Access through ``cfour {...}``
   block. -*/
@@ -164,7 +195,7 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- What algorithm to use for the SCF computation. See Table :ref:`SCF
   Convergence & Algorithm <table:conv_scf>` for default algorithm for
   different calculation types. -*/
-  options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK");
+  options.add_str("SCF_TYPE", "PK", "DIRECT DF MEM_DF DISK_DF PK OUT_OF_CORE CD GTFOCK COSX PS");
   /*- Algorithm to use for MP2 computation.
   See :ref:`Cross-module Redundancies <table:managedmethods>` for details. -*/
   options.add_str("MP2_TYPE", "DF", "DF CONV CD");
@@ -199,12 +230,21 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   /*- Auxiliary basis set for solving Dirac equation in X2C and DKH
       calculations. Defaults to decontracted orbital basis. -*/
   options.add_str("BASIS_RELATIVISTIC", "");
+  /*- How the X2C Hamiltonian decouples large and small components. ``FULL`` solves the
+  one-electron Dirac equation of the whole molecule. ``DLU`` (diagonal local unitary)
+  builds X and R from free-atom blocks, which are cached per element and basis for the
+  rest of the job and reused across geometries. !expert -*/
+  options.add_str("X2C_DECOUPLING", "FULL", "FULL DLU");
   /*- Order of Douglas-Kroll-Hess !expert -*/
   options.add_int("DKH_ORDER", 2);
 
   /*- Directory to which to write cube files. Default is the input file
   directory. -*/
   options.add_str_i("CUBEPROP_FILEPATH", ".");
+  /*- Format of the grid files. ``CUBE`` writes Gaussian text cubes; ``BCUBE``
+  writes a binary single-precision cube (``.bcube``) at about a third of the size,
+  whose layout is documented in ``CubicScalarGrid::write_bcube_file``. -*/
+  options.add_str("CUBEPROP_FILE_TYPE", "CUBE", "CUBE BCUBE");
 
   /*- Properties to compute. Valid tasks include:
       ``DENSITY`` - Da, Db, Dt, Ds;
@@ -227,6 +267,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add_double("CUBEPROP_ISOCONTOUR_THRESHOLD",0.85);
   /*- CubicScalarGrid basis cutoff. !expert -*/
   options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
+  /*- Gaussian tail below which an atom's fitted density enters the CubicScalarGrid ESP as a point
+  multipole rather than through analytic integrals. Zero integrates every atom exactly. !expert -*/
+  options.add_double("CUBIC_ESP_TOLERANCE", 1.0E-10);
   /*- CubicScalarGrid maximum number of grid points per evaluation block. !expert -*/
   options.add_int("CUBIC_BLOCK_MAX_POINTS",1000);
   /*- CubicScalarGrid spatial extent in bohr [O_X, O_Y, O_Z]. Defaults to 4.0 bohr each. -*/
@@ -235,6 +278,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
   options.add("CUBIC_GRID_SPACING", new ArrayType());
   /* How many NOONS to print -- used in libscf_solver/uhf.cc and libmints/oeprop.cc */
   options.add_str("PRINT_NOONS","3");
+  /*- Layout of the SO-basis two-electron integral files written for conventional computations.
+  ``BLOCKS`` stores sorted integral blocks with delta-encoded labels and a block index, decoded
+  transparently by every IWL reader; ``IWL`` stores the classic unsorted buffers. ``DIRECT`` writes no
+  file at all: integral transformations compute the SO integrals on the fly and write the
+  half-transformed integrals straight to DPD buffers. ``DIRECT`` is not supported by modules that
+  read the SO integral file themselves, such as ``SCF_TYPE OUT_OF_CORE``, the ``AO_BASIS DISK``
+  coupled-cluster algorithms, the DCT SCF step, MCSCF, PSIMRCC and MRCC. -*/
+  options.add_str("SO_TEI_FORMAT", "IWL", "IWL BLOCKS DIRECT");
+  /*- Do losslessly compress the integral values of ``BLOCKS`` integral files? -*/
+  options.add_bool("SO_TEI_COMPRESS", true);
 
   /*- PCM boolean for pcmsolver module -*/
   options.add_bool("PCM", false);
@@ -247,6 +300,14 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str_i("PCMSOLVER_PARSED_FNAME", "");
     /*- PCM-CCSD algorithm type. -*/
     options.add_str("PCM_CC_TYPE", "PTE", "PTE");
+    /*- Do build the electronic potential at the tesserae, and the PCM potential
+        matrix, from the change in density and charges since the previous SCF
+        iteration? Shell pairs and tesserae whose change is below |globals__ints_tolerance|
+        are skipped, so late iterations touch only a small part of the cavity. -*/
+    options.add_bool("PCM_INCREMENTAL", false);
+    /*- Maximum number of consecutive incremental PCM builds before a full
+        rebuild is forced, when |pcm__pcm_incremental| is on. !expert -*/
+    options.add_int("PCM_INCREMENTAL_FULL_EVERY", 20);
   }
 
   if (name == "DETCI" || options.read_globals()) {
@@ -321,9 +382,17 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     less core memory. -*/
     options.add_int("ICORE", 1);
 
-    /*- Number of threads for DETCI. !expert -*/
+    /*- Number of threads for the DETCI sigma build. Defaults to the Psi4
+    thread count when not set. Each thread holds its own sigma scratch. !expert -*/
     options.add_int("CI_NUM_THREADS", 1);
 
+    /*- Maximum number of new trial vectors whose sigma vectors are formed
+    together in one pass over the CI blocks during the Davidson-Liu
+    iterations. Only used with |detci__icore| = 1, and the batch is capped
+    so the held C and sigma vectors stay within 40% of memory. A value of 1
+    forms one sigma vector at a time. !expert -*/
+    options.add_int("CI_SIGMA_BATCH", 8);
+
     /*- Do print the sigma overlap matrix?  Not generally useful.  !expert -*/
     options.add_bool("SIGMA_OVERLAP", false);
 
@@ -603,6 +672,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     to a separate file on disk. !expert -*/
     options.add_bool("HD_OTF",true);
 
+    /*- Do keep a copy of the on-the-fly diagonal elements of the Hamiltonian
+    (|detci__hd_otf|) in core, so that they are computed only once per CI
+    diagonalization instead of once per root and iteration? Costs the
+    memory of one additional CI vector. !expert -*/
+    options.add_bool("HD_OTF_CACHE",true);
+
     /*- Do use the last vector space in the BVEC file to write
     scratch DVEC rather than using a separate DVEC file? (Only
     possible if |detci__num_roots| = 1.) !expert -*/
@@ -859,6 +934,18 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     additional thread. -*/
     options.add_bool("AIO_DF_INTS",false);
 
+    /*- Fraction of the SAPT memory that SAPT0 may use to keep the DF integrals
+    in core after they are formed. Terms then read the tensors that fit from
+    memory and only fall back to disk for the rest. Zero disables the
+    in-core store. -*/
+    options.add_double("SAPT0_DF_STORE",0.5);
+    /*- How to evaluate $E@@{disp}^{(20)}$ in SAPT0. CANONICAL takes it from
+    the amplitudes of the $E@@{exch-disp}^{(20)}$ computation; DENOMINATOR
+    uses the factorized energy denominators (see |sapt__denominator_algorithm|),
+    blocked over the auxiliary index and threaded over the denominator
+    vectors. The $E@@{exch-disp}^{(20)}$ terms themselves are unchanged. -*/
+    options.add_str("SAPT0_DISP20_ALGORITHM", "CANONICAL", "CANONICAL DENOMINATOR");
+
     /*- Maximum number of CPHF iterations -*/
     options.add_int("MAXITER",50);
     /*- Do CCD dispersion correction in SAPT2+, SAPT2+(3) or SAPT2+3? !expert -*/
@@ -952,10 +1039,19 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("SAPT_FDDS_DISP_LEG_LAMBDA", 0.3);
     /*- Minimum rho cutoff for the in the LDA response for FDDS !expert -*/
     options.add_double("SAPT_FDDS_V2_RHO_CUTOFF", 1.e-6);
+    /*- Compress the auxiliary space of each monomer's FDDS response to the eigenvectors of
+    $(Q|ia)(ia|P)$ above this fraction of the largest eigenvalue; the frequency integration then
+    runs in the compressed space. Zero keeps the full numerical rank (exact), a negative value
+    disables the compression. !expert -*/
+    options.add_double("SAPT_FDDS_AUX_CUTOFF", 0.0);
     /*- Which MP2 Exch-Disp module to use? !expert -*/
     options.add_str("SAPT_DFT_MP2_DISP_ALG", "SAPT", "FISAPT SAPT");
     /*- Interior option to clean up printing !expert -*/
     options.add_bool("SAPT_QUIET", false);
+    /*- Write the wall time, FLOP estimate, memory high-water mark (MiB) and PSIO bytes read and
+    written of every SAPT term to this JSON file. The same numbers are always available as
+    ``SAPT COST <TERM> ...`` variables. Empty skips the file. -*/
+    options.add_str_i("SAPT_COST_REPORT", "");
 
   }
 
@@ -992,6 +1088,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add_bool("FISAPT_DO_FSAPT", true);
       /*- Filepath to drop F-SAPT data within input file directory -*/
       options.add_str_i("FISAPT_FSAPT_FILEPATH", "fsapt/");
+      /*- Write the wall time, FLOP estimate, memory high-water mark (MiB) and PSIO bytes read and
+      written of every FISAPT term to this JSON file. Empty skips the file. -*/
+      options.add_str_i("FISAPT_COST_REPORT", "");
       /*- Do F-SAPT exchange scaling? (ratio of S^\infty to S^2) -*/
       options.add_bool("FISAPT_FSAPT_EXCH_SCALE", true);
       /*- Do F-SAPT induction scaling? (ratio of HF induction to F-SAPT induction) -*/
@@ -1011,6 +1110,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add("CUBIC_GRID_SPACING", new ArrayType());
       /*- CubicScalarGrid basis cutoff. !expert -*/
       options.add_double("CUBIC_BASIS_TOLERANCE", 1.0E-12);
+      /*- Gaussian tail below which an atom's fitted density enters the CubicScalarGrid ESP as a point
+      multipole rather than through analytic integrals. Zero integrates every atom exactly. !expert -*/
+      options.add_double("CUBIC_ESP_TOLERANCE", 1.0E-10);
       /*- CubicScalarGrid maximum number of grid points per evaluation block. !expert -*/
       options.add_int("CUBIC_BLOCK_MAX_POINTS",1000);
 
@@ -1179,6 +1281,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
         Pairs of primitives whose exponents sum is above this value will be treated using
         standard DMA.  Set to 0 to force all pairs to be treated with standard DMA. -*/
     options.add_double("GDMA_SWITCH", 4.0);
+    /*- Which DMA code to run. NATIVE is the built-in, threaded standard DMA (all pairs treated as
+        for GDMA_SWITCH 0, results in atomic units); it honors GDMA_LIMIT, GDMA_RADIUS and
+        GDMA_ORIGIN and does not accept a GDMA data file. -*/
+    options.add_str("GDMA_ENGINE", "EXTERNAL NATIVE", "EXTERNAL");
   }
 
   if (name == "MINTS"|| options.read_globals()) {
@@ -1213,6 +1319,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str("PK_ALGO", "REORDER", "REORDER YOSHIMINE");
     /*- Deactivate in core algorithm. For debug purposes. !expert -*/
     options.add_bool("PK_NO_INCORE", false);
+    /*- Number of disk writes allowed in flight while building a disk PK supermatrix. Writes of different
+    threads' buffers into the PK file, and of the J and K bucket files of the Yoshimine algorithm, run
+    concurrently; with several scratch volumes for the PK file they are also spread over disks. With more
+    than one writer, the Yoshimine sort writes each batch while sorting the next one. !expert -*/
+    options.add_int("PK_WRITERS", 2);
     /*- All densities are considered non symmetric, debug only. !expert -*/
     options.add_bool("PK_ALL_NONSYM", false);
     /*- Max memory per buf for PK algo REORDER, for debug and tuning -*/
@@ -1222,6 +1333,86 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- Use DF integrals tech to converge the SCF before switching to a conventional tech
         in a |scf__scf_type| ``DIRECT`` calculation -*/
     options.add_bool("DF_SCF_GUESS", true);
+    /*- Do let the per-iteration telemetry steer the SCF? With |scf__df_scf_guess|
+        in a |scf__scf_type| ``DIRECT`` calculation, the DF preiterations then stop
+        as soon as they are predicted to converge below the DF error (see
+        |scf__scf_adaptive_df_error|), or stall, instead of running to full
+        convergence, since the DIRECT iterations must remove that error anyway.
+        In any calculation, a DIIS subspace that has stopped reducing the
+        orbital gradient is reset. -*/
+    options.add_bool("SCF_ADAPTIVE", false);
+    /*- Orbital gradient RMS below which further DF preiterations are
+        considered wasted under |scf__scf_adaptive|, roughly the error of
+        density fitting in the orbital gradient. !expert -*/
+    options.add_double("SCF_ADAPTIVE_DF_ERROR", 1e-5);
+    /*- Do build J/K incrementally from the change in the density between
+        iterations in a |scf__scf_type| ``DIRECT`` calculation? Shell quartets
+        are then screened against that change, so late iterations compute
+        only a small fraction of the integrals. -*/
+    options.add_bool("INCFOCK", false);
+    /*- Maximum number of consecutive incremental Fock builds before a full
+        rebuild is forced, when |scf__incfock| is on. !expert -*/
+    options.add_int("INCFOCK_FULL_FOCK_EVERY", 100);
+    /*- Do skip shell quartets whose Schwarz bound, weighted by the largest
+        density element the quartet contracts with, falls below
+        |scf__density_screening_tolerance| in a |scf__scf_type| ``DIRECT``
+        calculation? Also applies to the J/K derivative integrals of ``DIRECT``
+        |scf__scf_type| gradients. -*/
+    options.add_bool("DENSITY_SCREENING", false);
+    /*- Cutoff for density-weighted screening of shell quartets. The default of
+        0.0 uses |scf__ints_tolerance|. !expert -*/
+    options.add_double("DENSITY_SCREENING_TOLERANCE", 0.0);
+    /*- Do build J with the continuous fast multipole method in a |scf__scf_type|
+        ``DIRECT`` calculation? Well separated shell pairs then interact through
+        multipoles, and only overlapping pairs are computed with explicit
+        integrals. Most useful for pure functionals, where no K is needed. -*/
+    options.add_bool("CFMM", false);
+    /*- Maximum total order of the multipole interactions, when |scf__cfmm|
+        is on. !expert -*/
+    options.add_int("CFMM_ORDER", 8);
+    /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>` number) of the
+        grid for seminumerical exchange in a |scf__scf_type| ``COSX`` calculation. -*/
+    options.add_int("COSX_SPHERICAL_POINTS", 50);
+    /*- Number of radial points of the grid for seminumerical exchange in a
+        |scf__scf_type| ``COSX`` calculation. -*/
+    options.add_int("COSX_RADIAL_POINTS", 35);
+    /*- Cutoff on the product of the potential integral bound and the
+        density-contracted basis functions below which a shell pair is skipped
+        at a grid block in a |scf__scf_type| ``COSX`` calculation. !expert -*/
+    options.add_double("COSX_INTS_TOLERANCE", 1.0E-11);
+    /*- Number of spherical points (A :ref:`Lebedev Points <table:lebedevorder>` number) of the
+        grid for pseudospectral exchange in a |scf__scf_type| ``PS`` calculation. -*/
+    options.add_int("PS_SPHERICAL_POINTS", 50);
+    /*- Number of radial points of the grid for pseudospectral exchange in a
+        |scf__scf_type| ``PS`` calculation. -*/
+    options.add_int("PS_RADIAL_POINTS", 35);
+    /*- Radial Scheme of the pseudospectral grid. !expert -*/
+    options.add_str("PS_RADIAL_SCHEME", "TREUTLER", "TREUTLER BECKE MULTIEXP EM MURA");
+    /*- Nuclear Scheme of the pseudospectral grid. !expert -*/
+    options.add_str("PS_NUCLEAR_SCHEME", "TREUTLER", "TREUTLER BECKE NAIVE STRATMANN");
+    /*- Pruning Scheme of the pseudospectral grid. !expert -*/
+    options.add_str("PS_PRUNING_SCHEME", "FLAT", "FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER");
+    /*- Spread alpha for logarithmic pruning of the pseudospectral grid. !expert -*/
+    options.add_double("PS_PRUNING_ALPHA", 1.0);
+    /*- Factor for effective BS radius in the pseudospectral radial grid. !expert -*/
+    options.add_double("PS_BS_RADIUS_ALPHA", 1.0);
+    /*- The pseudospectral grid specification, such as SG1. !expert -*/
+    options.add_str("PS_GRID_NAME", "", "SG0 SG1");
+    /*- The maximum number of pseudospectral grid points per evaluation block. !expert -*/
+    options.add_int("PS_BLOCK_MAX_POINTS", 256);
+    /*- The minimum number of pseudospectral grid points per evaluation block. !expert -*/
+    options.add_int("PS_BLOCK_MIN_POINTS", 100);
+    /*- The maximum radius to terminate subdivision of a pseudospectral octree block [au]. !expert -*/
+    options.add_double("PS_BLOCK_MAX_RADIUS", 3.0);
+    /*- Basis function cutoff on the pseudospectral grid. !expert -*/
+    options.add_double("PS_BASIS_TOLERANCE", 1.0E-12);
+    /*- Cutoff on the product of the potential integral bound and the
+        density-contracted basis functions below which a shell pair is skipped
+        at a grid block in a |scf__scf_type| ``PS`` calculation. !expert -*/
+    options.add_double("PS_INTS_TOLERANCE", 1.0E-11);
+    /*- Minimum relative eigenvalue of the numerical overlap kept when fitting
+        pseudospectral exchange against the analytic overlap. !expert -*/
+    options.add_double("PS_FITTING_CONDITION", 1.0E-10);
     /*- Keep JK object for later use? -*/
     options.add_bool("SAVE_JK", false);
     /*- Memory safety factor for allocating JK -*/
@@ -1234,9 +1425,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- Minimum absolute value below which TEI are neglected. -*/
     options.add_double("INTS_TOLERANCE", 0.0);
     /*- The type of guess orbitals.  Defaults to SAD for RHF, GWH for ROHF and UHF,
-    and READ for geometry optimizations after the first step. -*/
+    and READ for geometry optimizations after the first step. FRAG superimposes the densities of
+    separate fragment UHF computations, using the molecule's fragments or, when there is only one,
+    covalently bonded groups. -*/
 
-    options.add_str("GUESS", "AUTO", "AUTO CORE GWH SAD READ");
+    options.add_str("GUESS", "AUTO", "AUTO CORE GWH SAD FRAG READ");
     /*- Mix the HOMO/LUMO in UHF or UKS to break alpha/beta spatial symmetry.
     Useful to produce broken-symmetry unrestricted solutions.
     Notice that this procedure is defined only for calculations in C1 symmetry. -*/
@@ -1246,9 +1439,27 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     (if set), or else by the name of the output file plus the name of
     the current molecule. -*/
     options.add_bool("MOLDEN_WRITE", false);
+    /*- Do write a binary wavefunction checkpoint (orbitals, orbital energies,
+    densities, Fock matrices and the metadata to reuse them) at the end of
+    the SCF?  It is written in the background while the computation carries
+    on, to |scf__wfn_checkpoint_file|. -*/
+    options.add_bool("WFN_CHECKPOINT", false);
+    /*- File of the |scf__wfn_checkpoint| wavefunction checkpoint.  Defaults
+    to ``<prefix>.wfn.npz`` in the working directory, with the prefix of
+    |scf__molden_write|.  When set explicitly and the file exists, |scf__guess|
+    ``READ`` takes the guess orbitals from it, reading only the occupied
+    orbitals, so that a checkpoint can seed the SCF of a later job. -*/
+    options.add_str("WFN_CHECKPOINT_FILE", "");
     /*- If true, then repeat the specified guess procedure for the orbitals every time -
     even during a geometry optimization. -*/
     options.add_bool("GUESS_PERSIST", false);
+    /*- Extrapolate guess orbitals from the previous geometries of an optimization: ``ASPC`` aligns the
+        stored occupied orbitals, combines them with always-stable predictor-corrector weights and
+        orthonormalizes the result at the new geometry. -*/
+    options.add_str("GUESS_EXTRAPOLATION", "NONE", "NONE ASPC");
+    /*- Order :math:`k` of the |scf__guess_extrapolation| predictor, which uses the last :math:`k+2`
+        geometries. Lower orders are used until enough geometries are stored. -*/
+    options.add_int("GUESS_EXTRAPOLATION_ORDER", 2);
 
     /*- Flag to print the molecular orbitals. -*/
     options.add_bool("PRINT_MOS", false);
@@ -1264,6 +1475,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("MAXITER", 100);
     /*- Fail if we reach maxiter without converging? -*/
     options.add_bool("FAIL_ON_MAXITER",true);
+    /*- Do run the SCF iterations in the native (C++) loop instead of the Python
+    one? Same algorithm and printout, without the per-iteration Python overhead,
+    for high-throughput runs of many small jobs. Jobs with EFP or PCM always use
+    the Python loop. -*/
+    options.add_bool("SCF_NATIVE_ITERATIONS", false);
     /*- Convergence criterion for SCF energy. See Table :ref:`SCF
     Convergence & Algorithm <table:conv_scf>` for default convergence
     criteria for different calculation types. -*/
@@ -1302,6 +1518,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DIIS_MAX_VECS", 10);
     /*- Do use DIIS extrapolation to accelerate convergence? -*/
     options.add_bool("DIIS", true);
+    /*- Where DIIS vectors live. ``AUTO`` keeps them in core for DIRECT RHF and on disk otherwise;
+    ``CORE_SINGLE`` keeps them in core rounded to single precision. !expert -*/
+    options.add_str("DIIS_STORAGE", "AUTO", "AUTO DISK CORE CORE_SINGLE");
+    /*- Energy-based accelerator used far from convergence, blended into DIIS as the orbital
+    gradient falls (RHF, UHF and CUHF). -*/
+    options.add_str("SCF_INITIAL_ACCELERATOR", "NONE", "NONE EDIIS ADIIS");
+    /*- Largest orbital-gradient element above which |scf__scf_initial_accelerator| is used alone -*/
+    options.add_double("SCF_INITIAL_START_DIIS_TRANSITION", 1.0E-1);
+    /*- Largest orbital-gradient element below which plain DIIS is used alone -*/
+    options.add_double("SCF_INITIAL_FINISH_DIIS_TRANSITION", 1.0E-4);
     /*- The iteration to start MOM on (or 0 for no MOM) -*/
     options.add_int("MOM_START", 0);
     /*- The absolute indices of orbitals to excite from in MOM (+/- for alpha/beta) -*/
@@ -1320,6 +1546,28 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("SOSCF_CONV", 5.0E-3);
     /*- Do we print the SOSCF microiterations?. -*/
     options.add_bool("SOSCF_PRINT", false);
+    /*- Solver for the SOSCF Newton equations. ``CG`` runs preconditioned conjugate gradients to |scf__soscf_conv|.
+    ``NEWTON`` runs a truncated-Newton subspace solve that batches each step's Hessian-vector products into one JK
+    build, reuses the previous step as a trial vector, and loosens the residual target while the orbital gradient
+    is large. -*/
+    options.add_str("SOSCF_SOLVER", "CG", "CG NEWTON");
+    /*- Level shift [Eh] added to the orbital-energy preconditioner of |scf__soscf_solver| ``NEWTON``. -*/
+    options.add_double("SOSCF_LEVEL_SHIFT", 0.1);
+    /*- Build the RHF/RKS density by purifying the Fock matrix instead of diagonalizing it.
+        ``TRS4`` runs trace-resetting fourth-order purification on each symmetry block, so every
+        SCF iteration costs a handful of matrix multiplications rather than an eigensolve. Orbitals
+        and orbital energies are formed once, from the converged Fock matrix. Not available with
+        SOSCF, MOM or fractional occupation. -*/
+    options.add_str("PURIFICATION", "NONE", "NONE TRS4");
+    /*- Idempotency threshold $tr[P^2(1-P)^2]$ at which |scf__purification| stops. -*/
+    options.add_double("PURIFICATION_CONVERGENCE", 1.0E-10);
+    /*- Maximum number of |scf__purification| steps per SCF iteration. -*/
+    options.add_int("PURIFICATION_MAXITER", 100);
+    /*- Keep shell-block sparse copies (block-CSR with per-block norms) of the AO density and Fock
+        matrices, dropping shell blocks whose Frobenius norm is at or below this value. DirectJK
+        takes its density-screening maxima from the sparse density. C1 only; 0.0 keeps dense
+        matrices only. !expert -*/
+    options.add_double("SPARSE_AO_THRESHOLD", 0.0);
     /*- Whether to perform stability analysis after convergence.  NONE prevents analysis being
         performed. CHECK will print out the analysis of the wavefunction stability at the end of
         the computation.  FOLLOW will perform the analysis and, if a totally symmetric instability
@@ -1401,6 +1649,42 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DF_INTS_NUM_THREADS",0);
     /*- IO caching for CP corrections, etc !expert -*/
     options.add_str("DF_INTS_IO", "NONE", "NONE SAVE LOAD");
+    /*- Do read the next (Q|mn) slice in the background while the current one
+    is used, when DISK_DF falls back to its disk algorithm? This costs a second
+    slice buffer, so the slices are half as large for the same memory. !expert -*/
+    options.add_bool("DF_ASYNC_IO", true);
+    /*- Do build the range-separated exchange of LRC functionals in the same
+    pass as the full-range K, when DISK_DF keeps its integrals in core? The
+    half-transformed (Q|mn) of K is then shared, and a single metric-fitted
+    (Q|w|mn) tensor is stored instead of two. !expert -*/
+    options.add_bool("DF_FUSED_WK", true);
+    /*- Do keep the metric-contracted three-index integrals of MemDFJK in a
+    cache file in the scratch directory, and reuse them in later jobs with the
+    same basis sets, geometry and fitting parameters (e.g., CBS legs and scans
+    that revisit a geometry)? Cache files are not removed by psi4 clean. !expert -*/
+    options.add_bool("DF_INTS_CACHE", false);
+    /*- Do run the early MemDFJK J/K builds from single precision three-index
+    integrals, switching to double precision once the RMS density change drops
+    below |scf__df_mixed_precision_convergence|? !expert -*/
+    options.add_bool("DF_MIXED_PRECISION", false);
+    /*- RMS density change between SCF iterations below which the mixed-precision
+    MemDFJK builds switch to double precision. !expert -*/
+    options.add_double("DF_MIXED_PRECISION_CONVERGENCE", 1.0E-4);
+    /*- Do keep the three-index integrals of MemDFJK resident on a CUDA device and
+    build K there? Requires a build with ENABLE_CUDA; without a device, or when the
+    integrals do not fit in device memory, the host code is used. !expert -*/
+    options.add_bool("DF_DEVICE_OFFLOAD", false);
+    /*- Do fit each AO pair in MemDFJK only against the auxiliary functions on its
+    two atoms (pair-atomic RI)? Only the compact pair coefficients are stored, so
+    the memory for the three-index quantities grows linearly for extended
+    systems, at the price of a small, systematic fitting error. !expert -*/
+    options.add_bool("DF_LOCAL_FITTING", false);
+    /*- Relative cutoff for truncating the rank of each density handed to the
+    DISK_DF, MEM_DF and CD exchange builds. The orbital factor of a density
+    (e.g., fractionally occupied or natural orbitals) is rotated to its
+    eigenbasis and directions contributing less than this fraction of the
+    largest one are dropped before the K contraction. 0.0 turns this off. !expert -*/
+    options.add_double("DF_DENSITY_RANK_CUTOFF", 1.0E-12);
     /*- Fitting Condition !expert -*/
     options.add_double("DF_FITTING_CONDITION", 1.0E-12);
     /*- FastDF Fitting Metric -*/
@@ -1432,6 +1716,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("SAD_FRAC_OCC", false);
     /*- Auxiliary basis for the SAD guess !expert -*/
     options.add_double("SAD_CHOL_TOLERANCE", 1E-7);
+    /*- Do store converged atomic SAD densities on disk and reuse them in later jobs? Entries are keyed
+        by a hash of the element, occupation, atomic basis, fitting basis and SAD settings. -*/
+    options.add_bool("SAD_CACHE", false);
+    /*- Directory holding the |scf__sad_cache| files. Defaults to the scratch directory. -*/
+    options.add_str_i("SAD_CACHE_DIR", "");
+    /*- Maximum number of McWeeny purification steps applied to the assembled FRAG guess density. -*/
+    options.add_int("SAD_FRAG_PURIFY_MAXITER", 5);
 
     /*- SUBSECTION DFT -*/
 
@@ -1445,6 +1736,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DFT_ALPHA_C", 0.0);
     /*- Minima rho cutoff for the second derivative -*/
     options.add_double("DFT_V2_RHO_CUTOFF", 1.e-6);
+    /*- RKS potential builds skip grid blocks whose density is bounded below this everywhere.
+    Set to 0.0 to integrate every block. !expert -*/
+    options.add_double("DFT_BLOCK_DENSITY_TOLERANCE", 1.e-14);
     /*- The gradient regularized asymptotic correction shift value -*/
     options.add_double("DFT_GRAC_SHIFT", 0.0);
     /*- The gradient regularized asymptotic correction alpha value -*/
@@ -1469,12 +1763,25 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DFT_BS_RADIUS_ALPHA",1.0);
     /*- DFT basis cutoff. -*/
     options.add_double("DFT_BASIS_TOLERANCE", 1.0E-12);
+    /*- Reuse the previous DFT grid (points, weights and block screening) when the geometry, basis
+    and grid options are unchanged, e.g. for TDDFT, response or gradients after an SCF. -*/
+    options.add_bool("DFT_GRID_REUSE", true);
+    /*- Write the DFT collocation blocks that do not fit in the in-core cache to a memory-mapped
+    scratch file instead of recomputing them in every iteration and in Vx and gradient builds. -*/
+    options.add_bool("DFT_COLLOCATION_SPILL", false);
+    /*- Evaluate the closed-shell energy and potential of B3LYP, PBE0 and their LibXC components
+    with the native fused kernels instead of calling LibXC. -*/
+    options.add_bool("DFT_NATIVE_KERNELS", true);
     /*- The DFT grid specification, such as SG1.!expert -*/
     options.add_str("DFT_GRID_NAME","","SG0 SG1");
     /*- Pruning Scheme. !expert -*/
-    options.add_str("DFT_PRUNING_SCHEME", "FLAT", "FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER");
+    options.add_str("DFT_PRUNING_SCHEME", "FLAT", "FLAT P_GAUSSIAN D_GAUSSIAN P_SLATER D_SLATER LOG_GAUSSIAN LOG_SLATER ADAPTIVE");
     /*- Spread alpha for logarithmic pruning. !expert -*/
     options.add_double("DFT_PRUNING_ALPHA",1.0);
+    /*- Error in the integrated model density, in electrons per atom, that ADAPTIVE pruning may
+    introduce relative to the unpruned grid. Each radial shell gets the lowest Lebedev order,
+    up to |scf__dft_spherical_points|, that meets its share of this budget. !expert -*/
+    options.add_double("DFT_PRUNING_TOLERANCE", 1.0E-6);
     /*- The maximum number of grid points per evaluation block. !expert -*/
     options.add_int("DFT_BLOCK_MAX_POINTS",256);
     /*- The minimum number of grid points per evaluation block. !expert -*/
@@ -1496,6 +1803,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("DFT_VV10_RADIAL_POINTS", 50);
     /*- Rho cutoff for VV10 NL integration. !expert -*/
     options.add_double("DFT_VV10_RHO_CUTOFF", 1.e-8);
+    /*- Screening threshold for VV10 NL integration. Pairs of grid blocks whose kernel is bounded
+    below this value, from their distance and densities, are not integrated. A value of zero
+    integrates all pairs. !expert -*/
+    options.add_double("DFT_VV10_KERNEL_TOLERANCE", 1.e-10);
     /*- Define VV10 parameter b -*/
     options.add_double("DFT_VV10_B", 0.0);
     /*- Define VV10 parameter C -*/
@@ -1618,6 +1929,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- DL Solver minimum corrector norm to add to subspace
      -*/
     options.add_double("SOLVER_NORM",1.0E-6);
+    /*- DL Solver maximum number of new subspace vectors per iteration, 0 for one per unconverged root.
+    Above this many unconverged roots, those with the largest residuals are expanded first. -*/
+    options.add_int("SOLVER_MAX_BLOCK", 0);
+    /*- DL Solver: stop expanding roots once they have converged, even if a later residual drifts
+    above |cphf__solver_convergence| -*/
+    options.add_bool("SOLVER_LOCK_ROOTS", true);
+    /*- DL Solver (RTDA, RTDDFT): pass trial vectors to JK as truncated natural-transition-orbital factors,
+    discarding at most this fraction of each trial's norm (never more than the current residual), so K
+    costs follow the retained rank rather than the number of occupied orbitals. 0.0 keeps dense trials. -*/
+    options.add_double("SOLVER_NTO_TOLERANCE", 0.0);
     /*- Solver precondition type
      -*/
     options.add_str("SOLVER_PRECONDITION","JACOBI","SUBSPACE JACOBI NONE");
@@ -1652,6 +1973,12 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("CACHELEVEL", 2);
     /*- Force conversion of ROHF MOs to semicanonical MOs to run UHF-based energies -*/
     options.add_bool("SEMICANONICAL", false);
+    /*- Do skip the transformation and sort if the CC files already hold a
+    complete sort for the same reference (same orbital spaces, SCF and
+    nuclear repulsion energies)?  Meant for resuming CC computations from
+    restart snapshots (see |ccenergy__checkpoint_interval|) with the
+    scratch files of the interrupted run still in place. -*/
+    options.add_bool("REUSE_SORTED_INTS", false);
     /*- Use cctransort module NOTE: Turning this option off requires separate
      * installation of  ccsort and transqt2 modules, see http://github.com/psi4/psi4pasture -*/
     options.add_bool("RUN_CCTRANSORT", true);
@@ -1713,6 +2040,14 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("WRITE_NOS",false);
     /* Reproducing energies from densities ? */
     options.add_int("DEBUG", 0);
+    /*- Do leave the $\Gamma_{abcd}$ block of the RHF ground-state two-particle
+    density implicit, as the product of the $\lambda@@2$ and $\tau@@2$
+    amplitudes it is built from?  It is then contracted with the $\langle
+    ab|cd\rangle$ and $\langle ia|bc\rangle$ integrals and written for the
+    backtransformation a block at a time, instead of being stored and re-read
+    as a $v^4$ file.  Ignored for other references, excited states, |ccdensity__ao_basis|
+    and |ccdensity__debug|. -*/
+    options.add_bool("STREAM_GABCD", false);
   }
   if(name == "CCLAMBDA"|| options.read_globals()) {
      /*- MODULEDESCRIPTION Solves for the Lagrange multipliers, which are needed whenever coupled cluster properties
@@ -1724,6 +2059,23 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     /*- Do restart the coupled-cluster iterations from old $\lambda@@1$ and $\lambda@@2$
     amplitudes? -*/
     options.add_bool("RESTART",false);
+    /*- Number of iterations between restart snapshots of the $\lambda$
+    amplitudes and the DIIS history, written to |cclambda__checkpoint_file|.
+    A run that finds a snapshot of the same computation there resumes from
+    it instead of starting over; the snapshot is removed once the
+    iterations converge.  0 (the default) takes no snapshots. -*/
+    options.add_int("CHECKPOINT_INTERVAL", 0);
+    /*- File for the restart snapshots of |cclambda__checkpoint_interval|,
+    suffixed with the index of each left-hand state solved for.  Defaults
+    to ``<output prefix>.cclambda.snap`` in the working directory. -*/
+    options.add_str("CHECKPOINT_FILE", "");
+    /*- Do record the floating-point operations, disk traffic, cache hits and
+    wall time of each DPD contraction, sort, and buffer read and write, and
+    print them as a table at the end of the module? -*/
+    options.add_bool("DPD_PROFILE", false);
+    /*- File to write the |cclambda__dpd_profile| counters to as JSON. No file is
+    written if empty. -*/
+    options.add_str("DPD_PROFILE_JSON", "");
     /*- Caching level for libdpd governing the storage of amplitudes,
     integrals, and intermediates in the CC procedure. A value of 0 retains
     no quantities in cache, while a level of 6 attempts to store all
@@ -1800,6 +2152,13 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("PR", false);
     /*- Number of components of transition amplitudes printed -*/
     options.add_int("NUM_AMPS_PRINT", 5);
+    /*- Algorithm for the ADC(2) integrals. ``DF`` builds the doubles contribution
+    to the sigma vectors on the fly from three-index integrals, so the (OV|VV)
+    integrals and the 2h-2p intermediates are never written to disk. -*/
+    options.add_str("ADC_TYPE", "CONV", "CONV DF");
+    /*- Auxiliary basis set for ADC density fitting computations.
+    :ref:`Defaults <apdx:basisFamily>` to a RI basis. -*/
+    options.add_str("DF_BASIS_ADC", "");
   }
   if(name == "CCHBAR"|| options.read_globals()) {
      /*- MODULEDESCRIPTION Assembles the coupled cluster effective Hamiltonian. Called whenever CC
@@ -1841,11 +2200,20 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("CACHELEVEL",2);
     /*- The criterion used to retain/release cached data -*/
     options.add_str("CACHETYPE", "LRU", "LOW LRU");
+    /*- Do record the floating-point operations, disk traffic, cache hits and
+    wall time of each DPD contraction, sort, and buffer read and write, and
+    print them as a table at the end of the module? -*/
+    options.add_bool("DPD_PROFILE", false);
+    /*- File to write the |cceom__dpd_profile| counters to as JSON. No file is
+    written if empty. -*/
+    options.add_str("DPD_PROFILE_JSON", "");
     /*- Number of threads -*/
     options.add_int("CC_NUM_THREADS", 1);
     /*- Type of ABCD algorithm will be used -*/
     options.add_str("ABCD", "NEW", "NEW OLD");
-    /*- Do build W intermediates required for eom_cc3 in core memory? -*/
+    /*- Do build W intermediates required for eom_cc3 in core memory? In core, the
+    triples are built by several threads at once. If not set, the Ws are held in
+    core whenever they fit in memory. -*/
     options.add_bool("T3_WS_INCORE", false);
     /*- Do simulate the effects of local correlation techniques? -*/
     options.add_bool("LOCAL", false);
@@ -1855,9 +2223,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     and H.-J. Werner, J. Chem. Phys. 104, 6286-6297 (1996). -*/
     options.add_double("LOCAL_CUTOFF", 0.02);
     /*- Type of local-CCSD scheme to be simulated. ``WERNER`` selects the method
-    developed by H.-J. Werner and co-workers, and ``AOBASIS`` selects the method
-    developed by G.E. Scuseria and co-workers (currently inoperative). -*/
-    options.add_str("LOCAL_METHOD", "WERNER", "WERNER AOBASIS");
+    developed by H.-J. Werner and co-workers, ``AOBASIS`` selects the method
+    developed by G.E. Scuseria and co-workers (currently inoperative), and
+    ``PNO`` truncates each pair's virtual space to its MP2 pair natural
+    orbitals (C1 RHF only). -*/
+    options.add_str("LOCAL_METHOD", "WERNER", "WERNER AOBASIS PNO");
+    /*- Occupation-number threshold for keeping a pair natural orbital when
+    |ccenergy__local_method| is ``PNO``. Pairs with no PNO above the threshold
+    are treated as weak pairs according to |ccenergy__local_weakp|. -*/
+    options.add_double("LOCAL_PNO_CUTOFF", 1.0e-7);
     /*- Desired treatment of "weak pairs" in the local-CCSD method. A value of
     ``NEGLECT`` ignores weak pairs entirely. A value of ``NONE`` treats weak pairs in
     the same manner as strong pairs. A value of MP2 uses second-order perturbation
@@ -2111,13 +2485,24 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("RESTART",1);
     /*- Do restart the coupled-cluster iterations even if MO phases are screwed up? !expert -*/
     options.add_bool("FORCE_RESTART", 0);
+    /*- Number of iterations between restart snapshots of the $t$ amplitudes
+    and the DIIS history, written to |ccenergy__checkpoint_file|.  With
+    |ccenergy__restart| on, a run that finds a snapshot of the same
+    computation there resumes from it instead of starting over; the
+    snapshot is removed once the iterations converge.  0 (the default)
+    takes no snapshots. -*/
+    options.add_int("CHECKPOINT_INTERVAL", 0);
+    /*- File for the restart snapshots of |ccenergy__checkpoint_interval|.
+    Defaults to ``<output prefix>.ccenergy.snap`` in the working directory,
+    so that it outlives the scratch files of a job that is killed. -*/
+    options.add_str("CHECKPOINT_FILE", "");
 //#warning CCEnergy ao_basis keyword type was changed.
     /*- The algorithm to use for the $\left\langle VV||VV\right\rangle$ terms
     If AO_BASIS is ``NONE``, the MO-basis integrals will be used;
     if AO_BASIS is ``DISK``, the AO-basis integrals stored on disk will
     be used; if AO_BASIS is ``DIRECT``, the AO-basis integrals will be computed
-    on the fly as necessary.  NB: The ``DIRECT`` option is not fully
-    implemented and should only be used by experts.  Default is NONE.
+    on the fly, with Schwarz screening, and never stored.  ``DIRECT`` is
+    only available for RHF references.  Default is NONE.
     Note: The developers recommend use of this keyword only as a last
     resort because it significantly slows the calculation. The current
     algorithms for handling the MO-basis four-virtual-index integrals have
@@ -2136,8 +2521,21 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     cache used by the libdpd codes. A value of ``LOW`` selects a "low priority"
     scheme in which the deletion of items from the cache is based on
     pre-programmed priorities. A value of LRU selects a "least recently used"
-    scheme in which the oldest item in the cache will be the first one deleted. -*/
-    options.add_str("CACHETYPE", "LOW", "LOW LRU");
+    scheme in which the oldest item in the cache will be the first one deleted.
+    A value of ``COST`` learns during the first iteration how often each item
+    is used and how long it takes to read back from disk, and deletes the
+    item with the smallest product of the two first. -*/
+    options.add_str("CACHETYPE", "LOW", "LOW LRU COST");
+    /*- Do read the next block of an out-of-core contraction on a background
+    thread while the current one is multiplied? Halves the block size. -*/
+    options.add_bool("DPD_PREFETCH", true);
+    /*- Do record the floating-point operations, disk traffic, cache hits and
+    wall time of each DPD contraction, sort, and buffer read and write, and
+    print them as a table at the end of the module? -*/
+    options.add_bool("DPD_PROFILE", false);
+    /*- File to write the |ccenergy__dpd_profile| counters to as JSON. No file is
+    written if empty. -*/
+    options.add_str("DPD_PROFILE_JSON", "");
     /*- Number of threads -*/
     options.add_int("CC_NUM_THREADS",1);
     /*- Do use DIIS extrapolation to accelerate convergence? -*/
@@ -2183,7 +2581,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_bool("PAIR_ENERGIES_PRINT", 0);
     /*- Do print spin-adapted pair energies? -*/
     options.add_bool("SPINADAPT_ENERGIES", false);
-    /*- Do build W intermediates required for cc3 in core memory? -*/
+    /*- Do build W intermediates required for cc3 in core memory? In core, the
+    triples are built by several threads at once. If not set, the Ws are held in
+    core whenever they fit in memory. -*/
     options.add_bool("T3_WS_INCORE", 0);
     /*- Do SCS-MP2 with parameters optimized for nucleic acids? -*/
     options.add_bool("SCSN_MP2", 0);
@@ -2220,6 +2620,35 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("MP2_SS_SCALE", 1.0/3.0);
     /*- \% of memory for DF-MP2 three-index buffers -*/
     options.add_double("DFMP2_MEM_FACTOR", 0.9);
+    /*- Do form the (ia|jb) integrals of the DF-MP2 energy with single precision
+    GEMMs? The pair energies are still accumulated in double precision; errors are
+    typically below a microhartree for small and medium systems. -*/
+    options.add_bool("DFMP2_MIXED_PRECISION", false);
+    /*- Do compute the RHF opposite-spin energy with a Laplace-factorized
+    denominator? The cost drops from ${\cal O}(o^2v^2N_{aux})$ to
+    ${\cal O}(n_w o v N_{aux}^2)$, but the same-spin term gains nothing, so
+    this path is only taken for SOS-MP2 (|dfmp2__mp2_ss_scale| = 0).
+    Gradients always use the canonical algorithm. -*/
+    options.add_bool("DFMP2_LAPLACE", false);
+    /*- Do read the next $(Q|ia)$ block on a background thread while the
+    current block pair is contracted, in the RHF energy and the Pab/Pij
+    gradient loops? This costs one extra block buffer, so the blocks are
+    somewhat smaller for the same memory. Read bandwidth and stall times are
+    printed for |dfmp2__print| > 1. -*/
+    options.add_bool("DFMP2_ASYNC_IO", true);
+    /*- Maximum error allowed (Max error norm in Delta tensor) in the
+    Laplace quadrature of the energy denominators, see |dfmp2__dfmp2_laplace|. -*/
+    options.add_double("DENOMINATOR_DELTA", 1.0E-6);
+    /*- Complementary auxiliary basis set (CABS) for the RI of MP2-F12
+    computations. :ref:`Defaults <apdx:basisFamily>` to the OptRI basis of
+    the orbital basis. -*/
+    options.add_str("CABS_BASIS", "");
+    /*- Exponent $\beta$ of the Slater-type geminal $-e^{-\beta r_{12}}/\beta$
+    in MP2-F12 computations. -*/
+    options.add_double("F12_BETA", 1.0);
+    /*- Eigenvalues of the overlap of the orbital + CABS basis below this
+    fraction of the largest one are dropped before the CABS are formed. !expert -*/
+    options.add_double("CABS_SINGULAR_TOLERANCE", 1.0E-8);
     /*- Minimum absolute value below which integrals are neglected. -*/
     options.add_double("INTS_TOLERANCE", 0.0);
     /*- Minimum error in the 2-norm of the P(2) matrix for corrections to Lia and P. -*/
@@ -2270,7 +2699,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_double("DAMPING_PERCENTAGE",0.0);
     /*- Maximum number of error vectors stored for DIIS extrapolation -*/
     options.add_int("DIIS_MAX_VECS",7);
-    /*- Number of threads -*/
+    /*- Number of threads. When all matrices fit in core, independent CCBLAS
+    operations (e.g., the amplitude equations of different references) are
+    evaluated concurrently. -*/
     options.add_int("CC_NUM_THREADS",1);
     /*- Which root of the effective hamiltonian is the target state? -*/
     options.add_int("FOLLOW_ROOT",1);
@@ -2335,6 +2766,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str("WFN_SYM","1","A AG AU AP APP A1 A2 B BG BU B1 B2 B3 B1G B2G B3G B1U B2U B3U 0 1 2 3 4 5 6 7 8");
     /*- The type of algorithm to use for (T) computations -*/
     options.add_str("TRIPLES_ALGORITHM","RESTRICTED","SPIN_ADAPTED RESTRICTED UNRESTRICTED");
+    /*- Do save the (T) contributions of each completed batch of $ijk$
+    triples to |psimrcc__triples_checkpoint_file|, and skip the triples
+    found there from an interrupted run of the same computation?  The
+    checkpoint is removed once the triples complete.  Used by the
+    ``RESTRICTED`` |psimrcc__triples_algorithm|. -*/
+    options.add_bool("TRIPLES_CHECKPOINT",false);
+    /*- File of the |psimrcc__triples_checkpoint| checkpoint.  Defaults to
+    ``<output prefix>.mrccsd_t.snap`` in the working directory; since that
+    name holds the process id, set it explicitly to restart in a new job. -*/
+    options.add_str("TRIPLES_CHECKPOINT_FILE","");
     /*- How to perform MP2_CCSD computations -*/
     options.add_str("MP2_CCSD_METHOD","II","I IA II");
     /*- Whether to use spin symmetry to map equivalent configurations onto each other, for efficiency !expert -*/
@@ -2395,6 +2836,11 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       /*- Reduce step size as necessary to ensure back-transformation of internal
           coordinate step to cartesian coordinates. -*/
       options.add_bool("ENSURE_BT_CONVERGENCE", false);
+      /*- Linear solver for the back-transformation of internal coordinate steps. ``DIRECT``
+          forms and inverts $G = B B^t$; ``ITERATIVE`` solves with conjugate gradients on a
+          sparse $B$ matrix, bounding memory and cost for large fragments. ``AUTO`` uses
+          ``ITERATIVE`` for fragments of 100 atoms or more. -*/
+      options.add_str("BT_SOLVER", "AUTO", "AUTO DIRECT ITERATIVE");
       /*= Do stupid, linear scaling of internal coordinates to step limit (not RS-RFO) -*/
       options.add_bool("SIMPLE_STEP_SCALING", false);
       /*- Set number of consecutive backward steps allowed in optimization -*/
@@ -2472,6 +2918,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       means recompute every step, and N means recompute every N steps. The
       default (-1) is to never compute the full Hessian. -*/
       options.add_int("FULL_HESS_EVERY", -1);
+      /*- Do recompute the full Hessian whenever the updated Hessian stops describing the surface?
+      After the initial full Hessian, a new one (with the ``hessian_with`` method of optimize())
+      is computed only when the actual energy change of a step differs from the change
+      projected by the quadratic model by more than |optking__full_hess_degrade_tolerance|
+      (relative). Implies |optking__full_hess_every| of at least 0. -*/
+      options.add_bool("FULL_HESS_ADAPTIVE", false);
+      /*- Largest relative deviation of the actual from the projected energy change tolerated
+      before |optking__full_hess_adaptive| recomputes the Hessian. -*/
+      options.add_double("FULL_HESS_DEGRADE_TOLERANCE", 0.5);
       /*- Model Hessian to guess intrafragment force constants -*/
       options.add_str("INTRAFRAG_HESS", "SCHLEGEL", "FISCHER SCHLEGEL SIMPLE LINDH LINDH_SIMPLE");
 
@@ -2566,6 +3021,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       frequency calculation. Turned off at non-stationary geometries and
       in the presence of external perturbations. -*/
       options.add_bool("FD_PROJECT", true);
+      /*- Do start the SCF at each displaced geometry from the orbitals of the
+      reference geometry? Applies to single-job (``mode='continuous'``) finite
+      differences, for displacements that keep the point group of the reference. -*/
+      options.add_bool("FD_REFERENCE_GUESS", true);
+      /*- Do save the result of each completed displacement of a single-job
+      finite difference computation, so an interrupted job restarts without
+      recomputing them? The file name ends in .findif.json and is removed
+      once the derivative is assembled. -*/
+      options.add_bool("FD_CHECKPOINT", false);
   }
   if (name == "OCC"|| options.read_globals()) {
     /*- MODULEDESCRIPTION Performs orbital-optimized MPn and CC computations and conventional MPn computations. -*/
@@ -2574,13 +3038,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_int("CC_MAXITER",50);
     /*- Maximum number of iterations to determine the orbitals -*/
     options.add_int("MO_MAXITER",50);
-    /*- Caching level for libdpd governing the storage of amplitudes,
-    integrals, and intermediates in the CC procedure. A value of 0 retains
-    no quantities in cache, while a level of 6 attempts to store all
-    quantities in cache.  For particularly large calculations, a value of
-    0 may help with certain types of memory problems.  The default is 2,
-    which means that all four-index quantities with up to two virtual-orbital
-    indices (e.g., $\langle ij | ab \rangle$ integrals) may be held in the cache. -*/
+    /*- Caching level for libdpd. Any nonzero value holds the MO integrals,
+    amplitudes, and densities in the libdpd cache whenever their estimated
+    size fits in memory, evicting the least recently used blocks to disk
+    should memory run short. A value of 0 keeps all of them on disk. -*/
     options.add_int("CACHELEVEL",2);
     /*- Number of vectors used in orbital DIIS -*/
     options.add_int("MO_DIIS_NUM_VECS",6);
@@ -2789,6 +3250,10 @@ int read_options(const std::string &name, Options & options, bool suppress_print
     options.add_str("MP2_AMP_TYPE","DIRECT","DIRECT CONV");
     /*- Type of the CCSD PPL term. -*/
     options.add_str("PPL_TYPE","AUTO","LOW_MEM HIGH_MEM CD AUTO");
+    /*- Memory (in MB) per row block when a three-index tensor is streamed
+        from disk, with the next block read in the background, instead of
+        being held in core. -*/
+    options.add_int("STREAM_BLOCK_SIZE",256);
     /*- The algorithm to handle (ia|bc) type integrals that used for (T) correction. -*/
     options.add_str("TRIPLES_IABC_TYPE","DISK","INCORE AUTO DIRECT DISK");
 
@@ -2894,7 +3359,9 @@ int read_options(const std::string &name, Options & options, bool suppress_print
       options.add_int("MRCC_METHOD", 1);
   }
   if (name == "FNOCC"|| options.read_globals()) {
-      /*- Do time each cc diagram? -*/
+      /*- Do time each cc diagram? Prints the wall time, dgemm GFLOP and
+      GFLOP/s of every diagram each iteration, and a summary over all
+      iterations. -*/
       options.add_bool("CC_TIMINGS",false);
       /*- Convergence criterion for CC energy. See Table :ref:`Post-SCF
       Convergence <table:conv_corl>` for default convergence criteria for
@@ -2916,6 +3383,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
           option is enabled automatically if the memory requirements of the
           conventional algorithm would exceed the available resources -*/
       options.add_bool("TRIPLES_LOW_MEMORY",false);
+      /*- Do assemble the (ov|vv) integrals for the low-memory triples
+          algorithm from the three-index integrals, in blocks of virtual
+          orbitals, rather than writing them to disk? Only used for DF-CCSD(T).
+          Implies |fnocc__triples_low_memory|. -*/
+      options.add_bool("TRIPLES_DF_DIRECT",false);
+      /*- Maximum memory (in MB) for the blocks of (ov|vv) integrals held by
+          the |fnocc__triples_df_direct| algorithm. Zero uses all memory left
+          over after the low-memory triples intermediates. -*/
+      options.add_int("TRIPLES_DF_DIRECT_MEMORY",0);
       /*- Do compute triples contribution? !expert -*/
       options.add_bool("COMPUTE_TRIPLES", true);
       /*- Do compute MP4 triples contribution? !expert -*/
@@ -2927,6 +3403,16 @@ int read_options(const std::string &name, Options & options, bool suppress_print
           will be discarded. This option is only used if |fnocc__nat_orbs| =
           true. -*/
       options.add_double("OCC_TOLERANCE", 1.0e-6);
+      /*- Do cache the MP2 virtual natural orbitals and occupations in the
+          scratch directory, keyed on basis, reference, frozen orbitals, and
+          geometry, and reuse them in later FNO computations? -*/
+      options.add_bool("FNO_CACHE", false);
+      /*- Largest Cartesian displacement (in bohr) from the cached geometry for
+          which |fnocc__fno_cache| natural orbitals are reused. The cached
+          orbitals are projected onto the new virtual space and
+          orthonormalized. The default reuses them only at the same geometry.
+          !expert -*/
+      options.add_double("FNO_CACHE_DISPLACEMENT", 0.0);
       /*- Cutoff for occupation of MP2 virtual NOs in FNO-QCISD/CCSD(T).
           The number of virtual NOs is chosen so the occupation of the
           truncated virtual space is |fnocc__occ_percentage| percent of
@@ -4517,6 +5003,15 @@ int read_options(const std::string &name, Options & options, bool suppress_print
         /*- Maximum number of DMRG iterations -*/
         options.add_int("DMRG_SCF_MAX_ITER", 100);
 
+        /*- Algorithm for the two-electron integrals in the rotated orbital basis. DF builds them (and the
+            Coulomb and exchange matrices) from three-index integrals in |scf__df_basis_scf| instead of
+            transforming the four-index AO integrals every macro-iteration. -*/
+        options.add_str("DMRG_SCF_TYPE", "CONV", "CONV DF");
+
+        /*- Whether to start the DMRG sweeps of each DMRG-SCF iteration from the MPS of the previous
+            iteration. Unless |dmrg__dmrg_mps_write| is set, the MPS files are removed afterwards. -*/
+        options.add_bool("DMRG_SCF_WARM_START", true);
+
         /*- Which root is targeted: 0 means ground state, 1 first excited state, etc. -*/
         options.add_int("DMRG_EXCITATION", 0);
 
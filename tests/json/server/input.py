@@ -0,0 +1,45 @@
+#! JSON server answers back-to-back requests without leaking state between them
+
+import io
+import json
+import psi4
+
+water = {
+    "geometry": [0.0, 0.0, -0.1294769411935893, 0.0, -1.494187339479985, 1.0274465079245698,
+                 0.0, 1.494187339479985, 1.0274465079245698],
+    "symbols": ["O", "H", "H"]
+}
+
+
+def request(basis, keywords):
+    return json.dumps({
+        "schema_name": "qc_schema_input",
+        "schema_version": 1,
+        "molecule": water,
+        "driver": "energy",
+        "model": {"method": "SCF", "basis": basis},
+        "keywords": keywords
+    })
+
+
+requests = [
+    request("cc-pVDZ", {"scf_type": "df"}),
+    request("cc-pVDZ", {"scf_type": "pk", "reference": "uhf"}),
+    "not json at all",
+    request("cc-pVDZ", {"scf_type": "df"}),
+    json.dumps({"shutdown": True}),
+    request("cc-pVDZ", {"scf_type": "df"}),
+]
+
+server = psi4.json_server.JSONServer()
+outstream = io.StringIO()
+server.serve_stream(io.StringIO("\n".join(requests) + "\n"), outstream)
+responses = [json.loads(line) for line in outstream.getvalue().splitlines()]
+
+psi4.compare_integers(4, len(responses), "Stops at shutdown")                                      #TEST
+psi4.compare_integers(3, server.nrequests, "Requests run")                                         #TEST
+psi4.compare_integers(True, all(responses[i]["success"] for i in [0, 1, 3]), "JSON Success")       #TEST
+psi4.compare_integers(False, responses[2]["success"], "Malformed request reported")               #TEST
+psi4.compare_values(-76.0213974, responses[0]["return_result"], 5, "DF energy")                    #TEST
+psi4.compare_values(-76.0214184, responses[1]["return_result"], 5, "PK energy")                    #TEST
+psi4.compare_values(responses[0]["return_result"], responses[3]["return_result"], 8, "Repeat unaffected by previous request")  #TEST
@@ -0,0 +1,11 @@
+#! Performance: B3LYP V build on benzene, per-phase time and memory in perf.json and the event file
+
+import psi4
+
+psi4.set_output_file("output.dat", False)
+psi4.core.open_event_file("events.jsonl")
+
+result = psi4.perf_benchmark("dft-v", filename="perf.json")
+psi4.compare_integers(1, result["wall"] > 0.0 and len(result["phases"]) > 0, "phases timed")
+
+psi4.core.close_event_file()
@@ -134,7 +134,17 @@ for method in methods:
                         else:
                             psi4.compare_arrays(np.asarray(dfh_Qmo[i]), Qmo[i], 9, test_string)
 
-                    del dfh
+                    # in-core tensors are also available as views, which keep dfh alive
+                    if MO_core:
+                        for ind, i in enumerate(transformations):
+                            view = dfh.get_tensor_view(i)
+                            psi4.compare_arrays(view.reshape(dfh_Qmo[ind].shape), dfh_Qmo[ind], 12, test_string + ' (view)')
+                        view = dfh.get_tensor_view(transformation_names[0])
+                        del dfh
+                        psi4.compare_arrays(view.reshape(dfh_Qmo[0].shape), dfh_Qmo[0], 12, test_string + ' (view lifetime)')
+                        del view
+                    else:
+                        del dfh
 
 # TODO:
 # test tensor slicing grabs
@@ -0,0 +1,31 @@
+#! GEMM size histograms and BLAS thread control leave results unchanged
+
+import psi4
+
+psi4.set_output_file("output.dat", False)
+
+h2o = psi4.geometry("""
+O
+H 1 0.96
+H 1 0.96 2 104.5
+""")
+
+psi4.set_options({"basis": "cc-pvdz", "scf_type": "pk", "freeze_core": True})
+psi4.set_num_threads(2)
+
+psi4.compare_integers(1, psi4.core.blas_backend() in ["MKL", "OpenBLAS", "generic"], "BLAS backend")
+
+E_plain = psi4.energy("fno-ccsd(t)")
+
+psi4.core.set_gemm_profiling(True)
+E = psi4.energy("fno-ccsd(t)")
+psi4.core.set_gemm_profiling(False)
+psi4.core.print_gemm_histogram()
+psi4.core.reset_gemm_histogram()
+
+psi4.compare_values(E_plain, E, 8, "FNO-CCSD(T) energy unchanged by profiling")
+
+psi4.core.flush_outfile()
+with open("output.dat") as f:
+    output = f.read()
+psi4.compare_integers(1, "GEMM Sizes" in output and "FNOCC (T)" in output, "histogram per region")
@@ -0,0 +1,51 @@
+#! JK.compute_batch split into several passes by memory reproduces one single compute()
+
+import psi4
+import numpy as np
+
+psi4.set_output_file("output.dat", False)
+
+mol = psi4.geometry("""
+O
+H 1 1.00
+H 1 1.00 2 103.1
+""")
+
+primary = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ")
+aux = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ-jkfit")
+nbf = primary.nbf()
+
+np.random.seed(0)
+sizes = [5, 5, 8, 8, 12]
+C_left = [psi4.core.Matrix.from_array(np.random.rand(nbf, size)) for size in sizes]
+C_right = [psi4.core.Matrix.from_array(np.random.rand(nbf, size)) for size in sizes]
+
+psi4.set_options({"SCF_TYPE": "DIRECT"})
+jk = psi4.core.JK.build_JK(primary, aux)
+jk.initialize()
+psi4.compare(True, jk.single_pass_densities(), 'DirectJK single pass')
+psi4.compare(True, jk.shared_pair_screening(), 'DirectJK shared screening')
+
+# Reference: all pairs in one compute()
+for Cl, Cr in zip(C_left, C_right):
+    jk.C_left_add(Cl)
+    jk.C_right_add(Cr)
+jk.compute()
+J_ref = [np.array(J) for J in jk.J()]
+K_ref = [np.array(K) for K in jk.K()]
+jk.C_clear()
+
+# Room for two pairs at a time
+jk.set_memory(9 * nbf * nbf)
+psi4.compare_integers(2, jk.batch_densities(C_left, C_right), 'Densities per batch')
+J, K, wK = jk.compute_batch(C_left, C_right)
+psi4.compare_integers(len(sizes), len(J), 'Number of J')
+psi4.compare_integers(0, len(wK), 'Number of wK')
+for i in range(len(sizes)):
+    psi4.compare_arrays(J_ref[i], np.array(J[i]), 9, 'J' + str(i))
+    psi4.compare_arrays(K_ref[i], np.array(K[i]), 9, 'K' + str(i))
+
+# Symmetric pairs through the same path
+J, K, wK = jk.compute_batch(C_left)
+for i in range(len(sizes)):
+    psi4.compare_arrays(np.array(J[i]), np.array(J[i]).T, 9, 'J symmetric' + str(i))
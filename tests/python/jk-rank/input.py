@@ -0,0 +1,48 @@
+#! DF K builds from rank-deficient orbital factors match the untruncated builds
+
+import psi4
+import numpy as np
+
+psi4.set_output_file("output.dat", False)
+
+mol = psi4.geometry("""
+O
+H 1 1.00
+H 1 1.00 2 103.1
+""")
+
+primary = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ")
+aux = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ-jkfit")
+nbf = primary.nbf()
+
+np.random.seed(0)
+# Six columns spanning only four directions, as for vanishing fractional occupations
+C = np.random.rand(nbf, 4)
+C = np.hstack((C, np.zeros((nbf, 1)), np.dot(C, np.random.rand(4, 1))))
+C_sym = psi4.core.Matrix.from_array(C)
+C_left = psi4.core.Matrix.from_array(np.dot(C, np.diag([1.0, 0.5, 0.0, 0.0, 0.3, 0.0])))
+C_right = psi4.core.Matrix.from_array(np.random.rand(nbf, 6))
+
+for scf_type in ["MEM_DF", "DISK_DF"]:
+    psi4.set_options({"SCF_TYPE": scf_type})
+    jk = psi4.core.JK.build_JK(primary, aux)
+    jk.initialize()
+
+    results = []
+    for cutoff in [0.0, 1.0e-12]:
+        jk.set_rank_cutoff(cutoff)
+        jk.C_clear()
+        jk.C_left_add(C_sym)
+        jk.C_left_add(C_left)
+        jk.C_right_add(C_sym)
+        jk.C_right_add(C_right)
+        jk.compute()
+        results.append(([np.array(J) for J in jk.J()], [np.array(K) for K in jk.K()], list(jk.C_ranks())))
+    jk.C_clear()
+
+    psi4.compare_integers(6, results[0][2][0], scf_type + ' untruncated rank')
+    psi4.compare_integers(4, results[1][2][0], scf_type + ' symmetric rank')
+    psi4.compare_integers(2, results[1][2][1], scf_type + ' nonsymmetric rank')
+    for i in range(2):
+        psi4.compare_arrays(results[0][0][i], results[1][0][i], 9, scf_type + ' J' + str(i))
+        psi4.compare_arrays(results[0][1][i], results[1][1][i], 9, scf_type + ' K' + str(i))
@@ -0,0 +1,41 @@
+#! Buffered output reaches the file on flush, and SCF iterations are written as JSON-line events
+
+import json
+
+import psi4
+
+psi4.set_output_file("output.dat", False)
+
+h2o = psi4.geometry("""
+O
+H 1 0.96
+H 1 0.96 2 104.5
+""")
+
+psi4.set_options({"basis": "sto-3g", "scf_type": "pk"})
+
+psi4.core.open_event_file("events.jsonl")
+psi4.compare_integers(1, psi4.core.event_file_open(), "event file open")
+E = psi4.energy("scf")
+psi4.core.emit_event("custom", {"answer": 42}, {"note": "say \"hi\""})
+psi4.core.close_event_file()
+
+with open("events.jsonl") as f:
+    events = [json.loads(line) for line in f]
+iterations = [event for event in events if event["event"] == "scf_iteration"]
+psi4.compare_integers(1, len(iterations) > 3, "one event per SCF iteration")
+psi4.compare_values(E, iterations[-1]["energy"], 10, "last iteration energy")
+psi4.compare_strings("RHF", iterations[-1]["reference"], "iteration label")
+psi4.compare_strings('say "hi"', events[-1]["note"], "escaped label")
+
+# Buffered text is all in the file once flushed
+psi4.core.print_out("\n  Output flush marker\n")
+psi4.core.flush_outfile()
+with open("output.dat") as f:
+    psi4.compare_integers(1, "Output flush marker" in f.read(), "flush writes buffered output")
+
+psi4.core.set_output_flush_policy("immediate")
+psi4.core.print_out("\n  Immediate marker\n")
+with open("output.dat") as f:
+    psi4.compare_integers(1, "Immediate marker" in f.read(), "immediate policy writes at once")
+psi4.core.set_output_flush_policy("buffered")
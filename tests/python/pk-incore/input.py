@@ -0,0 +1,44 @@
+#! In-core PK J/K with threaded contractions matches DirectJK for symmetric and non-symmetric densities
+
+import psi4
+import numpy as np
+
+psi4.set_output_file("output.dat", False)
+psi4.set_num_threads(4)
+
+mol = psi4.geometry("""
+O
+H 1 1.00
+H 1 1.00 2 103.1
+""")
+
+primary = psi4.core.BasisSet.build(mol, "ORBITAL", "cc-pVDZ")
+nbf = primary.nbf()
+
+np.random.seed(0)
+C_left = [psi4.core.Matrix.from_array(np.random.rand(nbf, size)) for size in [5, 8]]
+C_right = [psi4.core.Matrix.from_array(np.random.rand(nbf, size)) for size in [5, 8]]
+
+
+def build_JK(scf_type, symmetric):
+    psi4.set_options({"SCF_TYPE": scf_type})
+    jk = psi4.core.JK.build_JK(primary, primary)
+    jk.initialize()
+    for i, Cl in enumerate(C_left):
+        jk.C_left_add(Cl)
+        if not symmetric:
+            jk.C_right_add(C_right[i])
+    jk.compute()
+    J = [np.array(m) for m in jk.J()]
+    K = [np.array(m) for m in jk.K()]
+    jk.finalize()
+    return J, K
+
+
+for symmetric in [True, False]:
+    label = "symmetric" if symmetric else "non-symmetric"
+    J_ref, K_ref = build_JK("DIRECT", symmetric)
+    J_pk, K_pk = build_JK("PK", symmetric)
+    for i in range(len(C_left)):
+        psi4.compare_arrays(J_ref[i], J_pk[i], 9, "PK J %s %d" % (label, i))  #TEST
+        psi4.compare_arrays(K_ref[i], K_pk[i], 9, "PK K %s %d" % (label, i))  #TEST
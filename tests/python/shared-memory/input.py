@@ -0,0 +1,36 @@
+#! DF integrals, fitting metrics and DFT collocation shared through a shared-memory session
+
+import os
+import psi4
+
+psi4.set_output_file("output.dat", False)
+
+h2o = psi4.geometry("""
+O
+H 1 0.96
+H 1 0.96 2 104.5
+""")
+
+psi4.set_options({"basis": "cc-pvdz", "scf_type": "mem_df", "dft_spherical_points": 110, "dft_radial_points": 50})
+
+E_private = psi4.energy("b3lyp")
+
+# The first run builds the segments, the second maps them as a sibling process would
+session = "psi4-test-%d" % os.getpid()
+psi4.core.set_shared_memory_session(session)
+psi4.compare_strings(session, psi4.core.shared_memory_session(), "session set")
+E_built = psi4.energy("b3lyp")
+E_mapped = psi4.energy("b3lyp")
+psi4.core.set_shared_memory_session("")
+
+psi4.compare_values(E_private, E_built, 8, "B3LYP energy, building shared data")
+psi4.compare_values(E_private, E_mapped, 8, "B3LYP energy, mapping shared data")
+
+psi4.core.flush_outfile()
+with open("output.dat") as f:
+    output = f.read()
+psi4.compare_integers(1, "in-core AOs in shared memory" in output, "AOs shared")
+psi4.compare_integers(1, "Mapped" in output and "DFT collocation blocks in shared memory" in output, "collocation shared")
+
+psi4.compare_integers(1, psi4.core.unlink_shared_memory_session(session) >= 2, "segments removed")
+psi4.compare_integers(0, psi4.core.unlink_shared_memory_session(session), "nothing left behind")
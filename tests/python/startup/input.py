@@ -0,0 +1,38 @@
+#! Startup benchmark: time of a bare psi4 import, and lazily registered module options behave as eager ones
+
+import subprocess
+import sys
+import time
+
+import psi4
+
+psi4.set_output_file("output.dat", False)
+
+# Wall time of fresh interpreters importing psi4
+nrep = 3
+start = time.time()
+for _ in range(nrep):
+    subprocess.check_call([sys.executable, "-c", "import psi4"])
+psi4.core.print_out("\n  Average `import psi4` time: %.3f s over %d runs\n" % ((time.time() - start) / nrep, nrep))
+
+# Prelude, early, and late module blocks resolve on first use
+psi4.set_options({"basis": "cc-pvdz", "scf_type": "df", "cfour_calc_level": "ccsd"})
+psi4.compare_strings("CC-PVDZ", psi4.core.get_global_option("BASIS"), "prelude option")
+psi4.compare_strings("DF", psi4.core.get_global_option("SCF_TYPE"), "SCF block option")
+psi4.compare_strings("CCSD", psi4.core.get_global_option("CFOUR_CALC_LEVEL"), "CFOUR block option")
+
+# Choices merged across blocks are all accepted, e.g. the CPHF-only PS for SCF_TYPE
+psi4.set_options({"scf_type": "ps"})
+psi4.compare_strings("PS", psi4.core.get_global_option("SCF_TYPE"), "merged string choices")
+
+# Defaults are untouched by registration order
+psi4.core.clean_options()
+psi4.compare_integers(1, psi4.core.get_global_option("PRINT"), "global default")
+psi4.compare_values(1.e-6, psi4.core.get_global_option("E_CONVERGENCE"), 12, "first declaration wins")
+psi4.compare_integers(1, len(psi4.core.get_global_option_list()) > 1000, "full option list on request")
+
+try:
+    psi4.set_options({"not_an_option_anywhere": 1})
+    psi4.compare_integers(0, 1, "unknown options raise")
+except Exception:
+    psi4.compare_integers(1, 1, "unknown options raise")